@@ -0,0 +1,146 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+// Compress and decompress throughput of the block compression codecs over synthetic
+// pages. "ratio" is the size of the input over the size of the compressed output.
+//
+//   ./block_compression_benchmark --benchmark_filter=ZSTD
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gen_cpp/segment_v2.pb.h"
+#include "util/block_compression.h"
+#include "util/slice.h"
+
+namespace doris {
+
+// the default size of a data page
+static const size_t kInputSize = 64 * 1024;
+
+enum InputKind { RANDOM_BYTES = 0, TEXT, SMALL_INTS };
+static const char* kInputKindNames[] = {"random_bytes", "text", "small_ints"};
+
+static std::string generate_input(int kind) {
+    std::mt19937 rng(42);
+    std::string input;
+    input.reserve(kInputSize);
+    switch (kind) {
+    case RANDOM_BYTES: {
+        std::uniform_int_distribution<int> byte(0, 255);
+        while (input.size() < kInputSize) {
+            input.push_back(static_cast<char>(byte(rng)));
+        }
+        break;
+    }
+    case TEXT: {
+        static const std::vector<std::string> words = {
+                "select", "from", "where", "group", "order", "by", "the", "doris",
+                "segment", "page", "column", "value", "tablet", "rowset", "and", "or"};
+        std::uniform_int_distribution<size_t> word(0, words.size() - 1);
+        while (input.size() < kInputSize) {
+            input.append(words[word(rng)]).push_back(' ');
+        }
+        break;
+    }
+    case SMALL_INTS: {
+        std::uniform_int_distribution<int32_t> value(0, 1000);
+        while (input.size() < kInputSize) {
+            int32_t v = value(rng);
+            input.append(reinterpret_cast<const char*>(&v), sizeof(v));
+        }
+        break;
+    }
+    }
+    input.resize(kInputSize);
+    return input;
+}
+
+static const BlockCompressionCodec* get_codec(benchmark::State& state) {
+    auto type = static_cast<segment_v2::CompressionTypePB>(state.range(0));
+    state.SetLabel(segment_v2::CompressionTypePB_Name(type) + "/" +
+                   kInputKindNames[state.range(1)]);
+    const BlockCompressionCodec* codec = nullptr;
+    if (!get_block_compression_codec(type, &codec).ok() || codec == nullptr) {
+        state.SkipWithError("failed to get compression codec");
+    }
+    return codec;
+}
+
+static void BM_Compress(benchmark::State& state) {
+    const BlockCompressionCodec* codec = get_codec(state);
+    if (codec == nullptr) {
+        return;
+    }
+    std::string input = generate_input(state.range(1));
+    std::string output(codec->max_compressed_len(input.size()), '\0');
+    size_t compressed_size = 0;
+    for (auto _ : state) {
+        Slice compressed(&output[0], output.size());
+        if (!codec->compress(Slice(input), &compressed).ok()) {
+            state.SkipWithError("failed to compress");
+            return;
+        }
+        compressed_size = compressed.size;
+    }
+    state.SetBytesProcessed(state.iterations() * input.size());
+    state.counters["ratio"] = static_cast<double>(input.size()) / compressed_size;
+}
+
+static void BM_Decompress(benchmark::State& state) {
+    const BlockCompressionCodec* codec = get_codec(state);
+    if (codec == nullptr) {
+        return;
+    }
+    std::string input = generate_input(state.range(1));
+    std::string compressed(codec->max_compressed_len(input.size()), '\0');
+    Slice compressed_slice(&compressed[0], compressed.size());
+    if (!codec->compress(Slice(input), &compressed_slice).ok()) {
+        state.SkipWithError("failed to compress");
+        return;
+    }
+    std::string output(input.size(), '\0');
+    for (auto _ : state) {
+        Slice decompressed(&output[0], output.size());
+        if (!codec->decompress(compressed_slice, &decompressed).ok()) {
+            state.SkipWithError("failed to decompress");
+            return;
+        }
+        benchmark::DoNotOptimize(decompressed.data);
+    }
+    state.SetBytesProcessed(state.iterations() * input.size());
+}
+
+// every codec over every kind of input
+static void codecs_and_inputs(benchmark::internal::Benchmark* b) {
+    for (int type : {segment_v2::SNAPPY, segment_v2::LZ4, segment_v2::LZ4F, segment_v2::ZLIB,
+                     segment_v2::ZSTD}) {
+        for (int kind = RANDOM_BYTES; kind <= SMALL_INTS; ++kind) {
+            b->Args({type, kind});
+        }
+    }
+}
+
+BENCHMARK(BM_Compress)->Apply(codecs_and_inputs);
+BENCHMARK(BM_Decompress)->Apply(codecs_and_inputs);
+
+} // namespace doris
+
+BENCHMARK_MAIN();
@@ -0,0 +1,484 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+// Throughput and peak memory of single exec nodes over synthetic input, without a cluster.
+// The node under test reads rows of (k BIGINT, v BIGINT, payload VARCHAR) from synthetic
+// source nodes. The arguments of every benchmark are the knobs of the input:
+//   cardinality: the number of distinct keys
+//   skew:        the zipf exponent of the keys in hundredths, 0 means uniform
+//   width:       the length of the payload in bytes
+// "items_per_second" counts the input rows, "peak_mem" is the peak consumption of the mem
+// tracker of the node under test.
+//
+//   ./exec_node_benchmark --benchmark_filter=HashJoin
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "common/config.h"
+#include "common/logging.h"
+#include "common/object_pool.h"
+#include "exec/exec_node.h"
+#include "exec/hash_join_node.h"
+#include "exec/partitioned_aggregation_node.h"
+#include "exec/spill_sort_node.h"
+#include "exec/topn_node.h"
+#include "gen_cpp/Exprs_types.h"
+#include "gen_cpp/PlanNodes_types.h"
+#include "runtime/descriptors.h"
+#include "runtime/disk_io_mgr.h"
+#include "runtime/exec_env.h"
+#include "runtime/mem_tracker.h"
+#include "runtime/memory/chunk_allocator.h"
+#include "runtime/row_batch.h"
+#include "runtime/runtime_state.h"
+#include "runtime/string_value.h"
+#include "runtime/thread_resource_mgr.h"
+#include "runtime/tmp_file_mgr.h"
+#include "runtime/tuple.h"
+#include "runtime/tuple_row.h"
+#include "runtime/user_function_cache.h"
+#include "testutil/desc_tbl_builder.h"
+#include "util/bit_util.h"
+#include "util/cpu_info.h"
+#include "util/disk_info.h"
+#include "util/mem_info.h"
+#include "util/parse_util.h"
+
+namespace doris {
+
+static const int64_t kNumRows = 1 << 20;
+static const int64_t kTopNLimit = 100;
+static const int kMaxPayloadLen = 1024;
+static const char* kUdfDir = "./exec_node_benchmark_udf";
+
+// The tuples of the descriptor table, each of them has 3 slots, see build_desc_tbl().
+enum TupleId { PROBE_TUPLE = 0, BUILD_TUPLE, AGG_TUPLE, SORT_TUPLE };
+
+static ObjectPool g_desc_pool;
+static DescriptorTbl* g_desc_tbl = nullptr;
+
+// The part of a backend the exec nodes need: mem trackers, the buffer pool and the block
+// manager of the spill sorter. There are no scratch directories, nothing spills.
+static void init_exec_env() {
+    CpuInfo::init();
+    DiskInfo::init();
+    MemInfo::init();
+    ChunkAllocator::init_instance(config::chunk_reserved_bytes_limit);
+    // the builtin aggregate functions are looked up in the current process
+    Status st = UserFunctionCache::instance()->init(kUdfDir);
+    CHECK(st.ok()) << st.get_error_msg();
+
+    ExecEnv* env = ExecEnv::GetInstance();
+    env->_mem_tracker =
+            MemTracker::CreateTracker(-1, "ExecEnv root", MemTracker::GetRootTracker());
+    env->_thread_mgr = new ThreadResourceMgr();
+    env->_disk_io_mgr = new DiskIoMgr();
+    st = env->_disk_io_mgr->init(env->_mem_tracker);
+    CHECK(st.ok()) << st.get_error_msg();
+    env->_tmp_file_mgr = new TmpFileMgr(env);
+    st = env->_tmp_file_mgr->init_custom(std::vector<std::string>(), true);
+    CHECK(st.ok()) << st.get_error_msg();
+
+    bool is_percent = false;
+    int64_t buffer_pool_limit = ParseUtil::parse_mem_spec(config::buffer_pool_limit, &is_percent);
+    CHECK_GT(buffer_pool_limit, 0);
+    buffer_pool_limit = BitUtil::RoundDown(buffer_pool_limit, config::min_buffer_size);
+    env->_init_buffer_pool(config::min_buffer_size, buffer_pool_limit, buffer_pool_limit);
+}
+
+// PROBE_TUPLE and BUILD_TUPLE are the rows of the sources, (k, v, payload).
+// AGG_TUPLE is the intermediate and output tuple of the aggregation, (k, count, sum).
+// SORT_TUPLE is the tuple materialized by the sorts, (k, v, payload).
+static void build_desc_tbl() {
+    DescriptorTblBuilder builder(&g_desc_pool);
+    TypeDescriptor payload_type = TypeDescriptor::create_varchar_type(kMaxPayloadLen);
+    builder.declare_tuple() << TYPE_BIGINT << TYPE_BIGINT << payload_type;
+    builder.declare_tuple() << TYPE_BIGINT << TYPE_BIGINT << payload_type;
+    builder.declare_tuple() << TYPE_BIGINT << TYPE_BIGINT << TYPE_BIGINT;
+    builder.declare_tuple() << TYPE_BIGINT << TYPE_BIGINT << payload_type;
+    g_desc_tbl = builder.build();
+}
+
+static SlotDescriptor* get_slot(int tuple_id, int idx) {
+    return g_desc_tbl->get_tuple_descriptor(tuple_id)->slots()[idx];
+}
+
+// The rows of a source, the keys are scattered over the int64 range so that they aren't
+// dense or in order.
+struct SyntheticInput {
+    std::vector<int64_t> keys;
+    std::string payload;
+};
+
+static int64_t scatter(int64_t i) {
+    return static_cast<int64_t>(static_cast<uint64_t>(i) * 0x9E3779B97F4A7C15ULL);
+}
+
+// 'num_rows' keys out of 'cardinality' ones, the i-th most frequent key has a weight of
+// 1 / (i + 1)^(skew / 100).
+static std::vector<int64_t> generate_keys(int64_t num_rows, int64_t cardinality, int skew) {
+    std::mt19937_64 rng(42);
+    std::vector<int64_t> keys(num_rows);
+    if (skew == 0) {
+        std::uniform_int_distribution<int64_t> dist(0, cardinality - 1);
+        for (auto& key : keys) {
+            key = scatter(dist(rng));
+        }
+    } else {
+        std::vector<double> weights(cardinality);
+        for (int64_t i = 0; i < cardinality; ++i) {
+            weights[i] = 1.0 / std::pow(i + 1, skew / 100.0);
+        }
+        std::discrete_distribution<int64_t> dist(weights.begin(), weights.end());
+        for (auto& key : keys) {
+            key = scatter(dist(rng));
+        }
+    }
+    return keys;
+}
+
+// Every one of the 'cardinality' keys once, in random order.
+static std::vector<int64_t> generate_unique_keys(int64_t cardinality) {
+    std::vector<int64_t> keys(cardinality);
+    for (int64_t i = 0; i < cardinality; ++i) {
+        keys[i] = scatter(i);
+    }
+    std::shuffle(keys.begin(), keys.end(), std::mt19937_64(42));
+    return keys;
+}
+
+// Stands in for an exchange node, produces the rows of 'input' in batches. All the rows
+// share the payload of 'input', which must outlive the node.
+class SyntheticSourceNode : public ExecNode {
+public:
+    SyntheticSourceNode(ObjectPool* pool, const TPlanNode& tnode, const DescriptorTbl& descs,
+                        const SyntheticInput* input)
+            : ExecNode(pool, tnode, descs), _input(input) {}
+
+    Status open(RuntimeState* state) override {
+        RETURN_IF_ERROR(ExecNode::open(state));
+        _next_row = 0;
+        return Status::OK();
+    }
+
+    Status get_next(RuntimeState* state, RowBatch* row_batch, bool* eos) override {
+        RETURN_IF_CANCELLED(state);
+        const TupleDescriptor* tuple_desc = _row_descriptor.tuple_descriptors()[0];
+        const std::vector<SlotDescriptor*>& slots = tuple_desc->slots();
+        StringValue payload(const_cast<char*>(_input->payload.data()), _input->payload.size());
+        int64_t num_rows = _input->keys.size();
+        while (!row_batch->at_capacity() && _next_row < num_rows) {
+            Tuple* tuple = Tuple::create(tuple_desc->byte_size(), row_batch->tuple_data_pool());
+            *reinterpret_cast<int64_t*>(tuple->get_slot(slots[0]->tuple_offset())) =
+                    _input->keys[_next_row];
+            *reinterpret_cast<int64_t*>(tuple->get_slot(slots[1]->tuple_offset())) = _next_row;
+            *reinterpret_cast<StringValue*>(tuple->get_slot(slots[2]->tuple_offset())) = payload;
+            int row_idx = row_batch->add_row();
+            row_batch->get_row(row_idx)->set_tuple(0, tuple);
+            row_batch->commit_last_row();
+            ++_next_row;
+        }
+        _num_rows_returned = _next_row;
+        *eos = _next_row == num_rows;
+        return Status::OK();
+    }
+
+private:
+    const SyntheticInput* _input;
+    int64_t _next_row = 0;
+};
+
+static TPlanNode make_plan_node(int node_id, TPlanNodeType::type type, int num_children,
+                                int tuple_id) {
+    TPlanNode tnode;
+    tnode.node_id = node_id;
+    tnode.node_type = type;
+    tnode.num_children = num_children;
+    tnode.limit = -1;
+    tnode.row_tuples.push_back(tuple_id);
+    tnode.nullable_tuples.push_back(false);
+    tnode.compact_data = false;
+    return tnode;
+}
+
+static TExprNode make_slot_ref_node(const SlotDescriptor* slot) {
+    TExprNode node;
+    node.node_type = TExprNodeType::SLOT_REF;
+    node.type = slot->type().to_thrift();
+    node.num_children = 0;
+    TSlotRef slot_ref;
+    slot_ref.slot_id = slot->id();
+    slot_ref.tuple_id = slot->parent();
+    node.__set_slot_ref(slot_ref);
+    return node;
+}
+
+static TExpr make_slot_ref(const SlotDescriptor* slot) {
+    TExpr expr;
+    expr.nodes.push_back(make_slot_ref_node(slot));
+    return expr;
+}
+
+// A builtin aggregate function of bigint over 'arg', or over no argument if 'arg' is
+// null. The symbols are the ones FunctionSet gives the function in fe.
+static TExpr make_agg_fn(const std::string& name, const SlotDescriptor* arg,
+                         const std::string& init_fn, const std::string& update_fn,
+                         const std::string& merge_fn) {
+    static const std::string prefix = "_ZN5doris18AggregateFunctions";
+    TTypeDesc bigint_type = TypeDescriptor(TYPE_BIGINT).to_thrift();
+
+    TAggregateFunction agg_fn;
+    agg_fn.intermediate_type = bigint_type;
+    agg_fn.__set_init_fn_symbol(prefix + init_fn);
+    agg_fn.__set_update_fn_symbol(prefix + update_fn);
+    agg_fn.__set_merge_fn_symbol(prefix + merge_fn);
+
+    TFunction fn;
+    fn.name.function_name = name;
+    fn.binary_type = TFunctionBinaryType::BUILTIN;
+    if (arg != nullptr) {
+        fn.arg_types.push_back(bigint_type);
+    }
+    fn.ret_type = bigint_type;
+    fn.has_var_args = false;
+    fn.__set_aggregate_fn(agg_fn);
+
+    TExprNode node;
+    node.node_type = TExprNodeType::AGG_EXPR;
+    node.type = bigint_type;
+    node.num_children = arg != nullptr ? 1 : 0;
+    TAggregateExpr agg_expr;
+    agg_expr.is_merge_agg = false;
+    node.__set_agg_expr(agg_expr);
+    node.__set_fn(fn);
+
+    TExpr expr;
+    expr.nodes.push_back(node);
+    if (arg != nullptr) {
+        expr.nodes.push_back(make_slot_ref_node(arg));
+    }
+    return expr;
+}
+
+// select * from probe join build on probe.k = build.k
+static TPlanNode make_hash_join_node() {
+    TPlanNode tnode = make_plan_node(0, TPlanNodeType::HASH_JOIN_NODE, 2, PROBE_TUPLE);
+    tnode.row_tuples.push_back(BUILD_TUPLE);
+    tnode.nullable_tuples.push_back(false);
+    TEqJoinCondition eq_join_conjunct;
+    eq_join_conjunct.left = make_slot_ref(get_slot(PROBE_TUPLE, 0));
+    eq_join_conjunct.right = make_slot_ref(get_slot(BUILD_TUPLE, 0));
+    tnode.hash_join_node.join_op = TJoinOp::INNER_JOIN;
+    tnode.hash_join_node.eq_join_conjuncts.push_back(eq_join_conjunct);
+    tnode.__isset.hash_join_node = true;
+    return tnode;
+}
+
+// select k, count(*), sum(v) from probe group by k
+static TPlanNode make_aggregation_node() {
+    TPlanNode tnode = make_plan_node(0, TPlanNodeType::AGGREGATION_NODE, 1, AGG_TUPLE);
+    TAggregationNode& agg_node = tnode.agg_node;
+    agg_node.__set_grouping_exprs({make_slot_ref(get_slot(PROBE_TUPLE, 0))});
+    agg_node.aggregate_functions.push_back(make_agg_fn(
+            "count", nullptr, "9init_zeroIN9doris_udf9BigIntValEEEvPNS2_15FunctionContextEPT_",
+            "17count_star_updateEPN9doris_udf15FunctionContextEPNS1_9BigIntValE",
+            "11count_mergeEPN9doris_udf15FunctionContextERKNS1_9BigIntValEPS4_"));
+    agg_node.aggregate_functions.push_back(make_agg_fn(
+            "sum", get_slot(PROBE_TUPLE, 1),
+            "9init_nullEPN9doris_udf15FunctionContextEPNS1_6AnyValE",
+            "3sumIN9doris_udf9BigIntValES3_EEvPNS2_15FunctionContextERKT_PT0_",
+            "3sumIN9doris_udf9BigIntValES3_EEvPNS2_15FunctionContextERKT_PT0_"));
+    agg_node.intermediate_tuple_id = AGG_TUPLE;
+    agg_node.output_tuple_id = AGG_TUPLE;
+    agg_node.need_finalize = true;
+    tnode.__isset.agg_node = true;
+    return tnode;
+}
+
+// select * from probe order by k [limit kTopNLimit]
+static TPlanNode make_sort_node(bool use_top_n) {
+    TPlanNode tnode = make_plan_node(0, TPlanNodeType::SORT_NODE, 1, SORT_TUPLE);
+    TSortInfo& sort_info = tnode.sort_node.sort_info;
+    sort_info.ordering_exprs.push_back(make_slot_ref(get_slot(SORT_TUPLE, 0)));
+    sort_info.is_asc_order.push_back(true);
+    sort_info.nulls_first.push_back(false);
+    std::vector<TExpr> sort_tuple_slot_exprs;
+    for (int i = 0; i < 3; ++i) {
+        sort_tuple_slot_exprs.push_back(make_slot_ref(get_slot(PROBE_TUPLE, i)));
+    }
+    sort_info.__set_sort_tuple_slot_exprs(sort_tuple_slot_exprs);
+    tnode.sort_node.use_top_n = use_top_n;
+    if (use_top_n) {
+        tnode.limit = kTopNLimit;
+    }
+    tnode.__isset.sort_node = true;
+    return tnode;
+}
+
+static ExecNode* create_node(ObjectPool* pool, const TPlanNode& tnode) {
+    switch (tnode.node_type) {
+    case TPlanNodeType::HASH_JOIN_NODE:
+        return pool->add(new HashJoinNode(pool, tnode, *g_desc_tbl));
+    case TPlanNodeType::AGGREGATION_NODE:
+        return pool->add(new PartitionedAggregationNode(pool, tnode, *g_desc_tbl));
+    case TPlanNodeType::SORT_NODE:
+        if (tnode.sort_node.use_top_n) {
+            return pool->add(new TopNNode(pool, tnode, *g_desc_tbl));
+        }
+        return pool->add(new SpillSortNode(pool, tnode, *g_desc_tbl));
+    default:
+        LOG(FATAL) << "unexpected node type " << tnode.node_type;
+        return nullptr;
+    }
+}
+
+static Status create_runtime_state(int64_t query_seq, std::unique_ptr<RuntimeState>* state) {
+    TUniqueId query_id;
+    query_id.hi = 0;
+    query_id.lo = query_seq;
+    state->reset(new RuntimeState(query_id, TQueryOptions(), TQueryGlobals(),
+                                  ExecEnv::GetInstance()));
+    RETURN_IF_ERROR((*state)->init_mem_trackers(query_id));
+    RETURN_IF_ERROR((*state)->create_block_mgr());
+    (*state)->set_desc_tbl(g_desc_tbl);
+    return Status::OK();
+}
+
+// Runs the node of 'tnode' once over a source of each of 'inputs', the first one is the
+// probe side of a join. Returns the peak consumption of the mem tracker of the node in
+// 'peak_mem'. Only open() and get_next() are timed, the timer must be paused on entry.
+static Status run_node(benchmark::State& state, const TPlanNode& tnode,
+                       const std::vector<const SyntheticInput*>& inputs, int64_t* peak_mem) {
+    static int64_t query_seq = 0;
+    std::unique_ptr<RuntimeState> runtime_state;
+    RETURN_IF_ERROR(create_runtime_state(++query_seq, &runtime_state));
+
+    ObjectPool pool;
+    ExecNode* node = create_node(&pool, tnode);
+    for (int i = 0; i < inputs.size(); ++i) {
+        TPlanNode source = make_plan_node(i + 1, TPlanNodeType::EXCHANGE_NODE, 0,
+                                          i == 0 ? PROBE_TUPLE : BUILD_TUPLE);
+        node->_children.push_back(
+                pool.add(new SyntheticSourceNode(&pool, source, *g_desc_tbl, inputs[i])));
+    }
+    RETURN_IF_ERROR(node->init(tnode, runtime_state.get()));
+    RETURN_IF_ERROR(node->prepare(runtime_state.get()));
+
+    RowBatch batch(node->row_desc(), runtime_state->batch_size(),
+                   runtime_state->instance_mem_tracker().get());
+    Status st;
+    state.ResumeTiming();
+    st = node->open(runtime_state.get());
+    bool eos = false;
+    while (st.ok() && !eos) {
+        batch.reset();
+        st = node->get_next(runtime_state.get(), &batch, &eos);
+    }
+    state.PauseTiming();
+
+    *peak_mem = node->mem_tracker()->peak_consumption();
+    batch.reset();
+    node->close(runtime_state.get());
+    return st;
+}
+
+static void run_benchmark(benchmark::State& state, const TPlanNode& tnode, bool with_build) {
+    int64_t cardinality = state.range(0);
+    int skew = state.range(1);
+    int width = state.range(2);
+
+    SyntheticInput probe;
+    probe.keys = generate_keys(kNumRows, cardinality, skew);
+    probe.payload.assign(width, 'x');
+    SyntheticInput build;
+    build.keys = generate_unique_keys(cardinality);
+    build.payload.assign(width, 'y');
+    std::vector<const SyntheticInput*> inputs = {&probe};
+    if (with_build) {
+        inputs.push_back(&build);
+    }
+
+    int64_t peak_mem = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        int64_t run_peak_mem = 0;
+        Status st = run_node(state, tnode, inputs, &run_peak_mem);
+        state.ResumeTiming();
+        if (!st.ok()) {
+            state.SkipWithError(st.get_error_msg().c_str());
+            return;
+        }
+        peak_mem = std::max(peak_mem, run_peak_mem);
+    }
+    int64_t rows = probe.keys.size() + (with_build ? build.keys.size() : 0);
+    state.SetItemsProcessed(state.iterations() * rows);
+    state.counters["peak_mem"] = benchmark::Counter(
+            peak_mem, benchmark::Counter::kDefaults, benchmark::Counter::OneK::kIs1024);
+}
+
+static void BM_HashJoin(benchmark::State& state) {
+    run_benchmark(state, make_hash_join_node(), true);
+}
+
+static void BM_Aggregation(benchmark::State& state) {
+    run_benchmark(state, make_aggregation_node(), false);
+}
+
+static void BM_SpillSort(benchmark::State& state) {
+    run_benchmark(state, make_sort_node(false), false);
+}
+
+static void BM_TopN(benchmark::State& state) {
+    run_benchmark(state, make_sort_node(true), false);
+}
+
+// cardinality x skew x width
+static void input_knobs(benchmark::internal::Benchmark* b) {
+    b->ArgNames({"cardinality", "skew", "width"});
+    for (int64_t cardinality : {1 << 10, 1 << 16, 1 << 20}) {
+        for (int skew : {0, 120}) {
+            for (int width : {8, 128}) {
+                b->Args({cardinality, skew, width});
+            }
+        }
+    }
+}
+
+BENCHMARK(BM_HashJoin)->Apply(input_knobs)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Aggregation)->Apply(input_knobs)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_SpillSort)->Apply(input_knobs)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_TopN)->Apply(input_knobs)->Unit(benchmark::kMillisecond);
+
+} // namespace doris
+
+int main(int argc, char** argv) {
+    doris::init_exec_env();
+    doris::build_desc_tbl();
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    return 0;
+}
@@ -0,0 +1,301 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+// Encode and decode throughput of the page encodings of segment v2 over synthetic
+// distributions of values. "ratio" is the size of the values over the size of the page.
+//
+//   ./page_encoding_benchmark --benchmark_filter=Dict
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <limits>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "olap/column_block.h"
+#include "olap/column_vector.h"
+#include "olap/rowset/segment_v2/binary_dict_page.h"
+#include "olap/rowset/segment_v2/binary_plain_page.h"
+#include "olap/rowset/segment_v2/binary_prefix_page.h"
+#include "olap/rowset/segment_v2/bitshuffle_page.h"
+#include "olap/rowset/segment_v2/frame_of_reference_page.h"
+#include "olap/rowset/segment_v2/options.h"
+#include "olap/rowset/segment_v2/rle_page.h"
+#include "olap/types.h"
+#include "runtime/mem_pool.h"
+#include "runtime/mem_tracker.h"
+#include "util/slice.h"
+
+namespace doris {
+namespace segment_v2 {
+
+static const size_t kNumInts = 64 * 1024;
+static const size_t kNumStrings = 16 * 1024;
+// large enough for all values to be in one page
+static const size_t kPageSize = 4 * 1024 * 1024;
+static const size_t kBatchSize = 1024;
+
+enum IntDistribution { RANDOM_INTS = 0, SMALL_INTS, SORTED_INTS, RUNS_OF_INTS };
+static const char* kIntDistributionNames[] = {"random", "small", "sorted", "runs"};
+
+enum StringDistribution { LOW_CARDINALITY = 0, HIGH_CARDINALITY, SORTED_URLS };
+static const char* kStringDistributionNames[] = {"low_cardinality", "high_cardinality",
+                                                 "sorted_urls"};
+
+static std::vector<int32_t> generate_ints(int distribution) {
+    std::mt19937 rng(42);
+    std::vector<int32_t> values(kNumInts);
+    switch (distribution) {
+    case RANDOM_INTS: {
+        std::uniform_int_distribution<int32_t> dist(std::numeric_limits<int32_t>::min(),
+                                                    std::numeric_limits<int32_t>::max());
+        for (auto& value : values) {
+            value = dist(rng);
+        }
+        break;
+    }
+    case SMALL_INTS: {
+        std::uniform_int_distribution<int32_t> dist(0, 1000);
+        for (auto& value : values) {
+            value = dist(rng);
+        }
+        break;
+    }
+    case SORTED_INTS: {
+        std::uniform_int_distribution<int32_t> gap(0, 16);
+        int32_t last = 0;
+        for (auto& value : values) {
+            last += gap(rng);
+            value = last;
+        }
+        break;
+    }
+    case RUNS_OF_INTS: {
+        std::uniform_int_distribution<int32_t> dist(0, 1000);
+        for (size_t i = 0; i < kNumInts; i += 64) {
+            std::fill(values.begin() + i, values.begin() + std::min(i + 64, kNumInts), dist(rng));
+        }
+        break;
+    }
+    }
+    return values;
+}
+
+static std::string random_string(std::mt19937* rng) {
+    std::uniform_int_distribution<int> length(8, 24);
+    std::uniform_int_distribution<int> letter('a', 'z');
+    std::string s(length(*rng), ' ');
+    for (auto& c : s) {
+        c = letter(*rng);
+    }
+    return s;
+}
+
+// The strings are kept in `data`, `slices` refers to them.
+struct Strings {
+    std::vector<std::string> data;
+    std::vector<Slice> slices;
+    size_t bytes = 0;
+};
+
+static void generate_strings(int distribution, Strings* strings) {
+    std::mt19937 rng(42);
+    strings->data.resize(kNumStrings);
+    switch (distribution) {
+    case LOW_CARDINALITY: {
+        std::vector<std::string> words(100);
+        for (auto& word : words) {
+            word = random_string(&rng);
+        }
+        std::uniform_int_distribution<size_t> dist(0, words.size() - 1);
+        for (auto& s : strings->data) {
+            s = words[dist(rng)];
+        }
+        break;
+    }
+    case HIGH_CARDINALITY:
+        for (auto& s : strings->data) {
+            s = random_string(&rng);
+        }
+        break;
+    case SORTED_URLS:
+        for (size_t i = 0; i < kNumStrings; ++i) {
+            char buf[64];
+            snprintf(buf, sizeof(buf), "https://www.example.com/items/%08zu", i * 7);
+            strings->data[i] = buf;
+        }
+        break;
+    }
+    for (auto& s : strings->data) {
+        strings->slices.emplace_back(s);
+        strings->bytes += s.size();
+    }
+}
+
+static PageBuilderOptions builder_options() {
+    PageBuilderOptions options;
+    options.data_page_size = kPageSize;
+    options.dict_page_size = kPageSize;
+    return options;
+}
+
+// Encode `num_values` values at `values` into a page in every iteration.
+template <class PageBuilderType>
+static void run_encode(benchmark::State& state, const uint8_t* values, size_t num_values,
+                       size_t bytes) {
+    uint64_t page_size = 0;
+    for (auto _ : state) {
+        PageBuilderType builder(builder_options());
+        size_t n = num_values;
+        builder.add(values, &n);
+        OwnedSlice page = builder.finish();
+        page_size = page.slice().size;
+        benchmark::DoNotOptimize(page_size);
+    }
+    state.SetBytesProcessed(state.iterations() * bytes);
+    state.counters["ratio"] = static_cast<double>(bytes) / page_size;
+}
+
+template <class PageDecoderType>
+static Status init_decoder(PageDecoderType* decoder, PageDecoder* dict_decoder) {
+    return decoder->init();
+}
+
+static Status init_decoder(BinaryDictPageDecoder* decoder, PageDecoder* dict_decoder) {
+    decoder->set_dict_decoder(dict_decoder);
+    return decoder->init();
+}
+
+// Decode all values of `page` in batches in every iteration.
+template <class PageDecoderType>
+static void run_decode(benchmark::State& state, const Slice& page, FieldType type,
+                       PageDecoder* dict_decoder, size_t bytes) {
+    auto tracker = std::make_shared<MemTracker>();
+    MemPool pool(tracker.get());
+    std::unique_ptr<ColumnVectorBatch> cvb;
+    ColumnVectorBatch::create(kBatchSize, false, get_scalar_type_info(type), nullptr, &cvb);
+    ColumnBlock block(cvb.get(), &pool);
+    for (auto _ : state) {
+        PageDecoderType decoder(page, PageDecoderOptions());
+        if (!init_decoder(&decoder, dict_decoder).ok()) {
+            state.SkipWithError("failed to init page decoder");
+            break;
+        }
+        size_t remaining = decoder.count();
+        while (remaining > 0) {
+            size_t n = std::min(kBatchSize, remaining);
+            ColumnBlockView view(&block);
+            if (!decoder.next_batch(&n, &view).ok() || n == 0) {
+                state.SkipWithError("failed to decode page");
+                return;
+            }
+            remaining -= n;
+            pool.clear();
+        }
+        benchmark::DoNotOptimize(block.data());
+    }
+    state.SetBytesProcessed(state.iterations() * bytes);
+}
+
+template <class PageBuilderType>
+static void BM_EncodeInts(benchmark::State& state) {
+    std::vector<int32_t> values = generate_ints(state.range(0));
+    state.SetLabel(kIntDistributionNames[state.range(0)]);
+    run_encode<PageBuilderType>(state, reinterpret_cast<const uint8_t*>(values.data()),
+                                values.size(), values.size() * sizeof(int32_t));
+}
+
+template <class PageBuilderType, class PageDecoderType>
+static void BM_DecodeInts(benchmark::State& state) {
+    std::vector<int32_t> values = generate_ints(state.range(0));
+    state.SetLabel(kIntDistributionNames[state.range(0)]);
+    PageBuilderType builder(builder_options());
+    size_t n = values.size();
+    builder.add(reinterpret_cast<const uint8_t*>(values.data()), &n);
+    OwnedSlice page = builder.finish();
+    run_decode<PageDecoderType>(state, page.slice(), OLAP_FIELD_TYPE_INT, nullptr,
+                                n * sizeof(int32_t));
+}
+
+template <class PageBuilderType>
+static void BM_EncodeStrings(benchmark::State& state) {
+    Strings strings;
+    generate_strings(state.range(0), &strings);
+    state.SetLabel(kStringDistributionNames[state.range(0)]);
+    run_encode<PageBuilderType>(state, reinterpret_cast<const uint8_t*>(strings.slices.data()),
+                                strings.slices.size(), strings.bytes);
+}
+
+template <class PageBuilderType, class PageDecoderType>
+static void BM_DecodeStrings(benchmark::State& state) {
+    Strings strings;
+    generate_strings(state.range(0), &strings);
+    state.SetLabel(kStringDistributionNames[state.range(0)]);
+    PageBuilderType builder(builder_options());
+    size_t n = strings.slices.size();
+    builder.add(reinterpret_cast<const uint8_t*>(strings.slices.data()), &n);
+    OwnedSlice page = builder.finish();
+
+    // only dictionary encoding has a dictionary page
+    OwnedSlice dict_page;
+    std::unique_ptr<BinaryPlainPageDecoder> dict_decoder;
+    if (builder.get_dictionary_page(&dict_page).ok()) {
+        dict_decoder.reset(new BinaryPlainPageDecoder(dict_page.slice()));
+        if (!dict_decoder->init().ok()) {
+            state.SkipWithError("failed to init dictionary page decoder");
+            return;
+        }
+    }
+    run_decode<PageDecoderType>(state, page.slice(), OLAP_FIELD_TYPE_VARCHAR,
+                                dict_decoder.get(), strings.bytes);
+}
+
+#define INT_DISTRIBUTIONS DenseRange(RANDOM_INTS, RUNS_OF_INTS)
+#define STRING_DISTRIBUTIONS DenseRange(LOW_CARDINALITY, SORTED_URLS)
+
+BENCHMARK_TEMPLATE(BM_EncodeInts, BitshufflePageBuilder<OLAP_FIELD_TYPE_INT>)->INT_DISTRIBUTIONS;
+BENCHMARK_TEMPLATE(BM_DecodeInts, BitshufflePageBuilder<OLAP_FIELD_TYPE_INT>,
+                   BitShufflePageDecoder<OLAP_FIELD_TYPE_INT>)
+        ->INT_DISTRIBUTIONS;
+BENCHMARK_TEMPLATE(BM_EncodeInts, RlePageBuilder<OLAP_FIELD_TYPE_INT>)->INT_DISTRIBUTIONS;
+BENCHMARK_TEMPLATE(BM_DecodeInts, RlePageBuilder<OLAP_FIELD_TYPE_INT>,
+                   RlePageDecoder<OLAP_FIELD_TYPE_INT>)
+        ->INT_DISTRIBUTIONS;
+BENCHMARK_TEMPLATE(BM_EncodeInts, FrameOfReferencePageBuilder<OLAP_FIELD_TYPE_INT>)
+        ->INT_DISTRIBUTIONS;
+BENCHMARK_TEMPLATE(BM_DecodeInts, FrameOfReferencePageBuilder<OLAP_FIELD_TYPE_INT>,
+                   FrameOfReferencePageDecoder<OLAP_FIELD_TYPE_INT>)
+        ->INT_DISTRIBUTIONS;
+
+BENCHMARK_TEMPLATE(BM_EncodeStrings, BinaryPlainPageBuilder)->STRING_DISTRIBUTIONS;
+BENCHMARK_TEMPLATE(BM_DecodeStrings, BinaryPlainPageBuilder, BinaryPlainPageDecoder)
+        ->STRING_DISTRIBUTIONS;
+BENCHMARK_TEMPLATE(BM_EncodeStrings, BinaryDictPageBuilder)->STRING_DISTRIBUTIONS;
+BENCHMARK_TEMPLATE(BM_DecodeStrings, BinaryDictPageBuilder, BinaryDictPageDecoder)
+        ->STRING_DISTRIBUTIONS;
+BENCHMARK_TEMPLATE(BM_EncodeStrings, BinaryPrefixPageBuilder)->STRING_DISTRIBUTIONS;
+BENCHMARK_TEMPLATE(BM_DecodeStrings, BinaryPrefixPageBuilder, BinaryPrefixPageDecoder)
+        ->STRING_DISTRIBUTIONS;
+
+} // namespace segment_v2
+} // namespace doris
+
+BENCHMARK_MAIN();
@@ -20,10 +20,13 @@
 #include <pthread.h>
 #include <sys/stat.h>
 
+#include <algorithm>
 #include <boost/lexical_cast.hpp>
 #include <chrono>
 #include <csignal>
 #include <ctime>
+#include <map>
+#include <set>
 #include <sstream>
 #include <string>
 
@@ -53,6 +56,7 @@
 #include "util/monotime.h"
 #include "util/stopwatch.hpp"
 #include "util/threadpool.h"
+#include "util/time.h"
 
 using std::deque;
 using std::list;
@@ -77,6 +81,9 @@ Mutex TaskWorkerPool::_s_task_signatures_lock;
 map<TTaskType::type, set<int64_t>> TaskWorkerPool::_s_task_signatures;
 FrontendServiceClientCache TaskWorkerPool::_master_service_client_cache;
 
+DEFINE_GAUGE_METRIC_PROTOTYPE_2ARG(agent_task_queue_size, MetricUnit::NOUNIT);
+DEFINE_HISTOGRAM_METRIC_PROTOTYPE_2ARG(agent_task_queue_latency_us, MetricUnit::MICROSECONDS);
+
 TaskWorkerPool::TaskWorkerPool(const TaskWorkerType task_worker_type, ExecEnv* env,
                                const TMasterInfo& master_info)
         : _name(strings::Substitute("TaskWorkerPool.$0", TYPE_STRING(_task_worker_type))),
@@ -91,11 +98,18 @@ TaskWorkerPool::TaskWorkerPool(const TaskWorkerType task_worker_type, ExecEnv* e
     _backend.__set_host(BackendOptions::get_localhost());
     _backend.__set_be_port(config::be_port);
     _backend.__set_http_port(config::webserver_port);
+
+    std::string type = TYPE_STRING(task_worker_type);
+    _metric_entity = DorisMetrics::instance()->metric_registry()->register_entity(
+            "task_worker_pool." + type, {{"type", type}});
+    INT_GAUGE_METRIC_REGISTER(_metric_entity, agent_task_queue_size);
+    HISTOGRAM_METRIC_REGISTER(_metric_entity, agent_task_queue_latency_us);
 }
 
 TaskWorkerPool::~TaskWorkerPool() {
     _stop_background_threads_latch.count_down();
     stop();
+    DorisMetrics::instance()->metric_registry()->deregister_entity(_metric_entity);
 }
 
 void TaskWorkerPool::start() {
@@ -223,7 +237,9 @@ void TaskWorkerPool::submit_task(const TAgentTaskRequest& task) {
         {
             lock_guard<Mutex> worker_thread_lock(_worker_thread_lock);
             _tasks.push_back(task);
+            _task_queue_times_us.push_back(MonotonicMicros());
             task_count_in_queue = _tasks.size();
+            agent_task_queue_size->set_value(task_count_in_queue);
             _worker_thread_condition_variable.notify_one();
         }
         LOG(INFO) << "success to submit task. type=" << type_str << ", signature=" << signature
@@ -306,6 +322,15 @@ uint32_t TaskWorkerPool::_get_next_task_index(int32_t thread_count,
     return index;
 }
 
+TAgentTaskRequest TaskWorkerPool::_pop_task(size_t index) {
+    TAgentTaskRequest task = std::move(_tasks[index]);
+    _tasks.erase(_tasks.begin() + index);
+    agent_task_queue_latency_us->add(MonotonicMicros() - _task_queue_times_us[index]);
+    _task_queue_times_us.erase(_task_queue_times_us.begin() + index);
+    agent_task_queue_size->set_value(_tasks.size());
+    return task;
+}
+
 void TaskWorkerPool::_create_tablet_worker_thread_callback() {
     while (_is_work) {
         TAgentTaskRequest agent_task_req;
@@ -319,9 +344,8 @@ void TaskWorkerPool::_create_tablet_worker_thread_callback() {
                 return;
             }
 
-            agent_task_req = _tasks.front();
+            agent_task_req = _pop_task();
             create_tablet_req = agent_task_req.create_tablet_req;
-            _tasks.pop_front();
         }
 
         TStatusCode::type status_code = TStatusCode::OK;
@@ -381,9 +405,8 @@ void TaskWorkerPool::_drop_tablet_worker_thread_callback() {
                 return;
             }
 
-            agent_task_req = _tasks.front();
+            agent_task_req = _pop_task();
             drop_tablet_req = agent_task_req.drop_tablet_req;
-            _tasks.pop_front();
         }
 
         TStatusCode::type status_code = TStatusCode::OK;
@@ -430,8 +453,7 @@ void TaskWorkerPool::_alter_tablet_worker_thread_callback() {
                 return;
             }
 
-            agent_task_req = _tasks.front();
-            _tasks.pop_front();
+            agent_task_req = _pop_task();
         }
         int64_t signature = agent_task_req.signature;
         LOG(INFO) << "get alter table task, signature: " << agent_task_req.signature;
@@ -586,9 +608,8 @@ void TaskWorkerPool::_push_worker_thread_callback() {
                 break;
             }
 
-            agent_task_req = _tasks[index];
+            agent_task_req = _pop_task(index);
             push_req = agent_task_req.push_req;
-            _tasks.erase(_tasks.begin() + index);
         } while (0);
 
         if (index < 0) {
@@ -653,8 +674,9 @@ void TaskWorkerPool::_push_worker_thread_callback() {
 
 void TaskWorkerPool::_publish_version_worker_thread_callback() {
     while (_is_work) {
-        TAgentTaskRequest agent_task_req;
-        TPublishVersionRequest publish_version_req;
+        // the publish tasks queued are done in one batch, whose tablets are published
+        // concurrently and whose partitions are looked up once
+        std::vector<TAgentTaskRequest> agent_task_reqs;
         {
             lock_guard<Mutex> worker_thread_lock(_worker_thread_lock);
             while (_is_work && _tasks.empty()) {
@@ -664,61 +686,94 @@ void TaskWorkerPool::_publish_version_worker_thread_callback() {
                 return;
             }
 
-            agent_task_req = _tasks.front();
-            publish_version_req = agent_task_req.publish_version_req;
-            _tasks.pop_front();
+            size_t batch_size = std::max(config::publish_version_batch_size, 1);
+            while (!_tasks.empty() && agent_task_reqs.size() < batch_size) {
+                agent_task_reqs.push_back(_pop_task());
+            }
         }
 
-        DorisMetrics::instance()->publish_task_request_total->increment(1);
-        LOG(INFO) << "get publish version task, signature:" << agent_task_req.signature;
+        size_t num_tasks = agent_task_reqs.size();
+        DorisMetrics::instance()->publish_task_request_total->increment(num_tasks);
+        for (auto& agent_task_req : agent_task_reqs) {
+            LOG(INFO) << "get publish version task, signature:" << agent_task_req.signature
+                      << ", transaction_id: " << agent_task_req.publish_version_req.transaction_id;
+        }
 
-        Status st;
-        std::vector<TTabletId> error_tablet_ids;
+        std::vector<std::vector<TTabletId>> error_tablet_ids(num_tasks);
+        std::vector<OLAPStatus> results(num_tasks, OLAP_SUCCESS);
+        // indexes of the tasks to publish in the next try
+        std::vector<size_t> pending(num_tasks);
+        for (size_t i = 0; i < num_tasks; ++i) {
+            pending[i] = i;
+        }
         uint32_t retry_time = 0;
-        OLAPStatus res = OLAP_SUCCESS;
-        while (retry_time < PUBLISH_VERSION_MAX_RETRY) {
-            error_tablet_ids.clear();
-            EnginePublishVersionTask engine_task(publish_version_req, &error_tablet_ids);
-            res = _env->storage_engine()->execute_task(&engine_task);
-            if (res == OLAP_SUCCESS) {
-                break;
-            } else {
-                LOG(WARNING) << "publish version error, retry. [transaction_id="
-                             << publish_version_req.transaction_id
-                             << ", error_tablets_size=" << error_tablet_ids.size() << "]";
+        MonotonicStopWatch publish_watch;
+        publish_watch.start();
+        while (!pending.empty() && retry_time < PUBLISH_VERSION_MAX_RETRY) {
+            std::vector<const TPublishVersionRequest*> publish_version_reqs;
+            std::vector<std::vector<TTabletId>*> pending_error_tablet_ids;
+            for (size_t i : pending) {
+                error_tablet_ids[i].clear();
+                publish_version_reqs.push_back(&agent_task_reqs[i].publish_version_req);
+                pending_error_tablet_ids.push_back(&error_tablet_ids[i]);
+            }
+            EnginePublishVersionTask engine_task(publish_version_reqs, pending_error_tablet_ids);
+            OLAPStatus res = _env->storage_engine()->execute_task(&engine_task);
+
+            std::vector<size_t> failed;
+            for (size_t j = 0; j < pending.size(); ++j) {
+                size_t i = pending[j];
+                // a batch failed before finish() has no result of each request
+                results[i] = engine_task.results().empty() ? res : engine_task.results()[j];
+                if (results[i] != OLAP_SUCCESS) {
+                    LOG(WARNING) << "publish version error, retry. [transaction_id="
+                                 << agent_task_reqs[i].publish_version_req.transaction_id
+                                 << ", error_tablets_size=" << error_tablet_ids[i].size() << "]";
+                    failed.push_back(i);
+                }
+            }
+            pending.swap(failed);
+            if (!pending.empty()) {
                 ++retry_time;
                 SleepFor(MonoDelta::FromSeconds(1));
             }
         }
+        int64_t publish_latency_us = publish_watch.elapsed_time() / 1000;
 
-        TFinishTaskRequest finish_task_request;
-        if (res != OLAP_SUCCESS) {
-            DorisMetrics::instance()->publish_task_failed_total->increment(1);
-            // if publish failed, return failed, FE will ignore this error and
-            // check error tablet ids and FE will also republish this task
-            LOG(WARNING) << "publish version failed. signature:" << agent_task_req.signature
-                         << ", error_code=" << res;
-            st = Status::RuntimeError(strings::Substitute("publish version failed. error=$0", res));
-            finish_task_request.__set_error_tablet_ids(error_tablet_ids);
-        } else {
-            LOG(INFO) << "publish_version success. signature:" << agent_task_req.signature;
-        }
+        for (size_t i = 0; i < num_tasks; ++i) {
+            const TAgentTaskRequest& agent_task_req = agent_task_reqs[i];
+            DorisMetrics::instance()->publish_latency_us->add(publish_latency_us);
 
-        st.to_thrift(&finish_task_request.task_status);
-        finish_task_request.__set_backend(_backend);
-        finish_task_request.__set_task_type(agent_task_req.task_type);
-        finish_task_request.__set_signature(agent_task_req.signature);
-        finish_task_request.__set_report_version(_s_report_version);
+            Status st;
+            TFinishTaskRequest finish_task_request;
+            if (results[i] != OLAP_SUCCESS) {
+                DorisMetrics::instance()->publish_task_failed_total->increment(1);
+                // if publish failed, return failed, FE will ignore this error and
+                // check error tablet ids and FE will also republish this task
+                LOG(WARNING) << "publish version failed. signature:" << agent_task_req.signature
+                             << ", error_code=" << results[i];
+                st = Status::RuntimeError(
+                        strings::Substitute("publish version failed. error=$0", results[i]));
+                finish_task_request.__set_error_tablet_ids(error_tablet_ids[i]);
+            } else {
+                LOG(INFO) << "publish_version success. signature:" << agent_task_req.signature;
+            }
 
-        _finish_task(finish_task_request);
-        _remove_task_info(agent_task_req.task_type, agent_task_req.signature);
+            st.to_thrift(&finish_task_request.task_status);
+            finish_task_request.__set_backend(_backend);
+            finish_task_request.__set_task_type(agent_task_req.task_type);
+            finish_task_request.__set_signature(agent_task_req.signature);
+            finish_task_request.__set_report_version(_s_report_version);
+
+            _finish_task(finish_task_request);
+            _remove_task_info(agent_task_req.task_type, agent_task_req.signature);
+        }
     }
 }
 
 void TaskWorkerPool::_clear_transaction_task_worker_thread_callback() {
     while (_is_work) {
-        TAgentTaskRequest agent_task_req;
-        TClearTransactionTaskRequest clear_transaction_task_req;
+        std::vector<TAgentTaskRequest> agent_task_reqs;
         {
             lock_guard<Mutex> worker_thread_lock(_worker_thread_lock);
             while (_is_work && _tasks.empty()) {
@@ -728,48 +783,72 @@ void TaskWorkerPool::_clear_transaction_task_worker_thread_callback() {
                 return;
             }
 
-            agent_task_req = _tasks.front();
-            clear_transaction_task_req = agent_task_req.clear_transaction_task_req;
-            _tasks.pop_front();
+            size_t batch_size = std::max(config::clear_transaction_task_batch_size, 1);
+            while (!_tasks.empty() && agent_task_reqs.size() < batch_size) {
+                agent_task_reqs.push_back(_pop_task());
+            }
         }
-        LOG(INFO) << "get clear transaction task task, signature:" << agent_task_req.signature
-                  << ", transaction_id: " << clear_transaction_task_req.transaction_id
-                  << ", partition id size: " << clear_transaction_task_req.partition_id.size();
 
-        TStatusCode::type status_code = TStatusCode::OK;
-        std::vector<string> error_msgs;
-        TStatus task_status;
+        // FE may send the clear task of a transaction more than once, so the partitions of
+        // the tasks of a transaction are merged and the transaction is cleared only once.
+        // An empty partition list means all the partitions of the transaction.
+        std::map<TTransactionId, std::set<TPartitionId>> txn_partitions;
+        std::set<TTransactionId> txns_of_all_partitions;
+        for (auto& agent_task_req : agent_task_reqs) {
+            const TClearTransactionTaskRequest& clear_transaction_task_req =
+                    agent_task_req.clear_transaction_task_req;
+            LOG(INFO) << "get clear transaction task task, signature:" << agent_task_req.signature
+                      << ", transaction_id: " << clear_transaction_task_req.transaction_id
+                      << ", partition id size: " << clear_transaction_task_req.partition_id.size();
+            if (clear_transaction_task_req.transaction_id <= 0) {
+                // transaction_id should be greater than zero.
+                // If it is not greater than zero, no need to execute
+                // the following clear_transaction_task() function.
+                LOG(WARNING) << "invalid transaction id: "
+                             << clear_transaction_task_req.transaction_id
+                             << ", signature: " << agent_task_req.signature;
+                continue;
+            }
+            auto& partitions = txn_partitions[clear_transaction_task_req.transaction_id];
+            if (clear_transaction_task_req.partition_id.empty()) {
+                txns_of_all_partitions.insert(clear_transaction_task_req.transaction_id);
+            } else {
+                partitions.insert(clear_transaction_task_req.partition_id.begin(),
+                                  clear_transaction_task_req.partition_id.end());
+            }
+        }
 
-        if (clear_transaction_task_req.transaction_id > 0) {
-            // transaction_id should be greater than zero.
-            // If it is not greater than zero, no need to execute
-            // the following clear_transaction_task() function.
-            if (!clear_transaction_task_req.partition_id.empty()) {
-                _env->storage_engine()->clear_transaction_task(
-                        clear_transaction_task_req.transaction_id,
-                        clear_transaction_task_req.partition_id);
+        for (auto& it : txn_partitions) {
+            if (txns_of_all_partitions.count(it.first) == 0) {
+                std::vector<TPartitionId> partition_ids(it.second.begin(), it.second.end());
+                _env->storage_engine()->clear_transaction_task(it.first, partition_ids);
             } else {
-                _env->storage_engine()->clear_transaction_task(
-                        clear_transaction_task_req.transaction_id);
+                _env->storage_engine()->clear_transaction_task(it.first);
             }
-            LOG(INFO) << "finish to clear transaction task. signature:" << agent_task_req.signature
-                      << ", transaction_id: " << clear_transaction_task_req.transaction_id;
-        } else {
-            LOG(WARNING) << "invalid transaction id: " << clear_transaction_task_req.transaction_id
-                         << ", signature: " << agent_task_req.signature;
         }
 
-        task_status.__set_status_code(status_code);
-        task_status.__set_error_msgs(error_msgs);
+        for (auto& agent_task_req : agent_task_reqs) {
+            const TClearTransactionTaskRequest& clear_transaction_task_req =
+                    agent_task_req.clear_transaction_task_req;
+            if (clear_transaction_task_req.transaction_id > 0) {
+                LOG(INFO) << "finish to clear transaction task. signature:"
+                          << agent_task_req.signature
+                          << ", transaction_id: " << clear_transaction_task_req.transaction_id;
+            }
 
-        TFinishTaskRequest finish_task_request;
-        finish_task_request.__set_task_status(task_status);
-        finish_task_request.__set_backend(_backend);
-        finish_task_request.__set_task_type(agent_task_req.task_type);
-        finish_task_request.__set_signature(agent_task_req.signature);
+            TStatus task_status;
+            task_status.__set_status_code(TStatusCode::OK);
+            task_status.__set_error_msgs(std::vector<string>());
 
-        _finish_task(finish_task_request);
-        _remove_task_info(agent_task_req.task_type, agent_task_req.signature);
+            TFinishTaskRequest finish_task_request;
+            finish_task_request.__set_task_status(task_status);
+            finish_task_request.__set_backend(_backend);
+            finish_task_request.__set_task_type(agent_task_req.task_type);
+            finish_task_request.__set_signature(agent_task_req.signature);
+
+            _finish_task(finish_task_request);
+            _remove_task_info(agent_task_req.task_type, agent_task_req.signature);
+        }
     }
 }
 
@@ -786,9 +865,8 @@ void TaskWorkerPool::_update_tablet_meta_worker_thread_callback() {
                 return;
             }
 
-            agent_task_req = _tasks.front();
+            agent_task_req = _pop_task();
             update_tablet_meta_req = agent_task_req.update_tablet_meta_info_req;
-            _tasks.pop_front();
         }
         LOG(INFO) << "get update tablet meta task, signature:" << agent_task_req.signature;
 
@@ -854,9 +932,8 @@ void TaskWorkerPool::_clone_worker_thread_callback() {
                 return;
             }
 
-            agent_task_req = _tasks.front();
+            agent_task_req = _pop_task();
             clone_req = agent_task_req.clone_req;
-            _tasks.pop_front();
         }
 
         DorisMetrics::instance()->clone_requests_total->increment(1);
@@ -907,9 +984,8 @@ void TaskWorkerPool::_storage_medium_migrate_worker_thread_callback() {
                 return;
             }
 
-            agent_task_req = _tasks.front();
+            agent_task_req = _pop_task();
             storage_medium_migrate_req = agent_task_req.storage_medium_migrate_req;
-            _tasks.pop_front();
         }
 
         TStatusCode::type status_code = TStatusCode::OK;
@@ -1019,9 +1095,8 @@ void TaskWorkerPool::_check_consistency_worker_thread_callback() {
                 return;
             }
 
-            agent_task_req = _tasks.front();
+            agent_task_req = _pop_task();
             check_consistency_req = agent_task_req.check_consistency_req;
-            _tasks.pop_front();
         }
 
         TStatusCode::type status_code = TStatusCode::OK;
@@ -1151,6 +1226,10 @@ void TaskWorkerPool::_report_tablet_worker_thread_callback() {
     TReportRequest request;
     request.__set_backend(_backend);
     request.__isset.tablets = true;
+    // whether the master accepts incremental tablet reports, known from its last reply
+    bool master_support_incremental = false;
+    int64_t last_full_report_sec = 0;
+    TNetworkAddress last_master_address;
 
     while (_is_work) {
         if (_master_info.network_address.port == 0) {
@@ -1169,9 +1248,18 @@ void TaskWorkerPool::_report_tablet_worker_thread_callback() {
         }
 
         request.tablets.clear();
+        if (!(_master_info.network_address == last_master_address)) {
+            // a new master has not seen the base of incremental reports
+            master_support_incremental = false;
+            last_master_address = _master_info.network_address;
+        }
+        bool incremental =
+                config::enable_incremental_tablet_report && master_support_incremental &&
+                MonotonicSeconds() - last_full_report_sec <
+                        config::full_tablet_report_interval_seconds;
+        TabletManager* tablet_manager = StorageEngine::instance()->tablet_manager();
         OLAPStatus report_all_tablets_info_status =
-                StorageEngine::instance()->tablet_manager()->report_all_tablets_info(
-                        &request.tablets);
+                tablet_manager->report_all_tablets_info(&request.tablets, &incremental);
         if (report_all_tablets_info_status != OLAP_SUCCESS) {
             LOG(WARNING) << "report get all tablets info failed. status: "
                          << report_all_tablets_info_status;
@@ -1182,9 +1270,19 @@ void TaskWorkerPool::_report_tablet_worker_thread_callback() {
                          DorisMetrics::instance()->tablet_base_max_compaction_score->value());
         request.__set_tablet_max_compaction_score(max_compaction_score);
         request.__set_report_version(_s_report_version);
+        request.__set_is_incremental_tablet_report(incremental);
 
         TMasterResult result;
         AgentStatus status = _master_client->report(request, &result);
+        bool accepted = status == DORIS_SUCCESS && result.status.status_code == TStatusCode::OK;
+        tablet_manager->finish_tablets_report(accepted);
+        if (accepted) {
+            master_support_incremental = result.__isset.support_incremental_tablet_report &&
+                                         result.support_incremental_tablet_report;
+            if (!incremental) {
+                last_full_report_sec = MonotonicSeconds();
+            }
+        }
         if (status != DORIS_SUCCESS) {
             DorisMetrics::instance()->report_all_tablets_requests_failed->increment(1);
             LOG(WARNING) << "report tablets failed. status: " << status
@@ -1212,9 +1310,8 @@ void TaskWorkerPool::_upload_worker_thread_callback() {
                 return;
             }
 
-            agent_task_req = _tasks.front();
+            agent_task_req = _pop_task();
             upload_request = agent_task_req.upload_req;
-            _tasks.pop_front();
         }
 
         LOG(INFO) << "get upload task, signature:" << agent_task_req.signature
@@ -1266,9 +1363,8 @@ void TaskWorkerPool::_download_worker_thread_callback() {
                 return;
             }
 
-            agent_task_req = _tasks.front();
+            agent_task_req = _pop_task();
             download_request = agent_task_req.download_req;
-            _tasks.pop_front();
         }
         LOG(INFO) << "get download task, signature: " << agent_task_req.signature
                   << ", job id:" << download_request.job_id;
@@ -1321,9 +1417,8 @@ void TaskWorkerPool::_make_snapshot_thread_callback() {
                 return;
             }
 
-            agent_task_req = _tasks.front();
+            agent_task_req = _pop_task();
             snapshot_request = agent_task_req.snapshot_req;
-            _tasks.pop_front();
         }
         LOG(INFO) << "get snapshot task, signature:" << agent_task_req.signature;
 
@@ -1402,9 +1497,8 @@ void TaskWorkerPool::_release_snapshot_thread_callback() {
                 return;
             }
 
-            agent_task_req = _tasks.front();
+            agent_task_req = _pop_task();
             release_snapshot_request = agent_task_req.release_snapshot_req;
-            _tasks.pop_front();
         }
         LOG(INFO) << "get release snapshot task, signature:" << agent_task_req.signature;
 
@@ -1470,9 +1564,8 @@ void TaskWorkerPool::_move_dir_thread_callback() {
                 return;
             }
 
-            agent_task_req = _tasks.front();
+            agent_task_req = _pop_task();
             move_dir_req = agent_task_req.move_dir_req;
-            _tasks.pop_front();
         }
         LOG(INFO) << "get move dir task, signature:" << agent_task_req.signature
                   << ", job id:" << move_dir_req.job_id;
@@ -33,6 +33,7 @@
 #include "olap/storage_engine.h"
 #include "util/condition_variable.h"
 #include "util/countdown_latch.h"
+#include "util/metrics.h"
 #include "util/mutex.h"
 #include "util/thread.h"
 
@@ -150,6 +151,8 @@ private:
     void _finish_task(const TFinishTaskRequest& finish_task_request);
     uint32_t _get_next_task_index(int32_t thread_count, std::deque<TAgentTaskRequest>& tasks,
                                   TPriority::type priority);
+    // Remove the task at 'index' of the queue and return it, with _worker_thread_lock held
+    TAgentTaskRequest _pop_task(size_t index = 0);
 
     void _create_tablet_worker_thread_callback();
     void _drop_tablet_worker_thread_callback();
@@ -200,6 +203,13 @@ private:
     bool _is_work;
     std::unique_ptr<ThreadPool> _thread_pool;
     std::deque<TAgentTaskRequest> _tasks;
+    // monotonic time in us when each of _tasks was queued
+    std::deque<int64_t> _task_queue_times_us;
+
+    std::shared_ptr<MetricEntity> _metric_entity;
+    IntGauge* agent_task_queue_size = nullptr;
+    // the time tasks wait in the queue until a worker takes them
+    HistogramMetric* agent_task_queue_latency_us = nullptr;
 
     uint32_t _worker_count;
     TaskWorkerType _task_worker_type;
@@ -82,8 +82,17 @@ CONF_Int32(push_worker_count_normal_priority, "3");
 CONF_Int32(push_worker_count_high_priority, "3");
 // the count of thread to publish version
 CONF_Int32(publish_version_worker_count, "8");
+// the count of thread to publish version on the tablets of one publish version task
+// concurrently, 0 means publish them one by one in the task worker
+CONF_Int32(publish_version_tablet_thread_num, "16");
+// the max count of queued publish version tasks a worker takes at a time, whose tablets are
+// published concurrently and the related tablets of whose partitions are looked up once
+CONF_mInt32(publish_version_batch_size, "32");
 // the count of thread to clear transaction task
 CONF_Int32(clear_transaction_task_worker_count, "1");
+// the max count of queued clear transaction tasks a worker takes at a time, of which the
+// tasks of the same transaction are cleared once
+CONF_mInt32(clear_transaction_task_batch_size, "32");
 // the count of thread to delete
 CONF_Int32(delete_worker_count, "3");
 // the count of thread to alter table
@@ -92,6 +101,10 @@ CONF_Int32(alter_tablet_worker_count, "3");
 CONF_Int32(clone_worker_count, "3");
 // the count of thread to clone
 CONF_Int32(storage_medium_migrate_count, "1");
+// the count of thread to copy the files of storage medium migrations in parallel
+CONF_Int32(storage_migration_copy_thread_num, "8");
+// the total rate in MB/s to copy the files of storage medium migrations, 0 means unlimited
+CONF_mInt32(storage_migration_mbytes_per_sec, "100");
 // the count of thread to check consistency
 CONF_Int32(check_consistency_worker_count, "1");
 // the count of thread to upload
@@ -108,6 +121,10 @@ CONF_mInt32(report_task_interval_seconds, "10");
 CONF_mInt32(report_disk_state_interval_seconds, "60");
 // the interval time(seconds) for agent report olap table to FE
 CONF_mInt32(report_tablet_interval_seconds, "60");
+// whether to report only the tablets changed since last tablet report, when FE supports it
+CONF_mBool(enable_incremental_tablet_report, "true");
+// the interval time(seconds) of full tablet reports when incremental tablet report is enabled
+CONF_mInt32(full_tablet_report_interval_seconds, "1800");
 // the interval time(seconds) for agent report plugin status to FE
 // CONF_Int32(report_plugin_interval_seconds, "120");
 // the timeout(seconds) for alter table
@@ -122,6 +139,16 @@ CONF_mInt32(max_download_speed_kbps, "50000");
 CONF_mInt32(download_low_speed_limit_kbps, "50");
 // download low speed time(seconds)
 CONF_mInt32(download_low_speed_time, "300");
+// the max total download speed(KB/s) of all clone downloads on one node, shared by the
+// concurrent download streams. 0 means only max_download_speed_kbps per stream applies.
+CONF_mInt32(clone_max_download_speed_kbps, "0");
+// the count of threads to download files of one tablet concurrently in clone
+CONF_mInt32(clone_download_threads, "4");
+// files larger than this are downloaded in ranges of this size concurrently in clone
+CONF_mInt64(clone_download_range_bytes, "67108864");
+// whether a full clone keeps the local rowsets of the same versions as the source rather
+// than downloading them
+CONF_mBool(clone_reuse_local_rowsets, "true");
 // curl verbose mode
 // CONF_Int64(curl_verbose_mode, "1");
 // seconds to sleep for each time check table status
@@ -169,6 +196,21 @@ CONF_String(doris_cgroups, "");
 CONF_Int32(num_threads_per_core, "3");
 // if true, compresses tuple data in Serialize
 CONF_Bool(compress_rowbatches, "true");
+// codec to compress the row batches sent by load sinks, one of NO_COMPRESSION, SNAPPY, LZ4,
+// LZ4F, ZLIB and ZSTD. Empty means following compress_rowbatches. Codecs other than SNAPPY
+// can only be used if all Backends support them.
+CONF_String(load_rowbatch_compress_type, "");
+// if true, row batches sent to an exchange node on the same Backend are handed to its
+// receiver directly instead of being serialized and sent by brpc
+CONF_mBool(enable_local_exchange, "true");
+// if true, the tuple data of row batches sent by exchange is carried by the brpc attachment
+// instead of the protobuf request, which saves a copy on both sides. Only enable it if all
+// Backends support it.
+CONF_mBool(transfer_row_batch_by_brpc_attachment, "false");
+// if true, the tuples of an uncompressed row batch received in a brpc attachment point into the
+// received buffer, which the batch keeps, instead of a copy of it. The buffer is not counted by
+// the mem trackers of the query
+CONF_mBool(deserialize_row_batch_in_place, "false");
 // serialize and deserialize each returned row batch
 CONF_Bool(serialize_batch, "false");
 // interval between profile reports; in seconds
@@ -179,6 +221,25 @@ CONF_String(local_library_dir, "${UDF_RUNTIME_DIR}");
 CONF_Int32(doris_scanner_thread_pool_thread_num, "48");
 // number of olap scanner thread pool queue size
 CONF_Int32(doris_scanner_thread_pool_queue_size, "102400");
+// number of threads shared by the scanners of the broker files of all loads, which are served
+// fairly among the loads. 0 runs the scanners of each load on threads of its own.
+CONF_Int32(broker_scanner_thread_pool_thread_num, "16");
+// max number of the scanner tasks of broker loads waiting for a thread
+CONF_Int32(broker_scanner_thread_pool_queue_size, "102400");
+// max number of scanners of a broker scan node which run in the broker scanner thread pool
+CONF_mInt32(broker_scan_node_max_scanners, "4");
+// the splittable plain csv files of a broker load are split into ranges of this size, which the
+// scanners of the scan node take in turn. 0 doesn't split the files.
+CONF_mInt64(broker_scan_split_bytes, "134217728");
+// resource groups that queries select by the session variable exec_resource_group, separated
+// by ';'. Each one is 'name:key=value,...' with the keys
+//   scan_threads: size of its own scanner thread pool, 0 to use the global one
+//   cpu_shares: cpu.shares of its cgroup under doris_cgroups, 0 for none
+//   mem_limit: memory limit of its queries on this Backend, e.g. 20G or 30%
+//   max_queries: number of its queries running at the same time on this Backend, 0 for no
+//   limit, the others wait up to fragment_admission_timeout_ms
+// e.g. "etl:scan_threads=8,cpu_shares=256,mem_limit=30%,max_queries=2;dashboard:cpu_shares=2048"
+CONF_String(resource_groups, "");
 // number of etl thread pool size
 CONF_Int32(etl_thread_pool_size, "8");
 // number of etl thread pool size
@@ -195,6 +256,16 @@ CONF_mInt32(doris_scan_range_row_count, "524288");
 CONF_mInt32(doris_scanner_queue_size, "1024");
 // single read execute fragment row size
 CONF_mInt32(doris_scanner_row_num, "16384");
+// max bytes of a batch of an olap scanner, the batches of wide rows have less rows than
+// batch_size. The batches a scan node queues are bounded by the share of the memory limit
+// of the fragment the batches of the observed size fit in, and by doris_scanner_queue_size.
+CONF_mInt64(doris_scanner_batch_max_bytes, "8388608");
+// max number of distinct values of a string column unified into a dictionary by the scanners of
+// a scan, whose rows share the values instead of copying them. The values of the columns of more
+// distinct values are copied per row. 0 disables the dictionaries
+CONF_mInt32(doris_scanner_string_dict_max_size, "1024");
+// max time a scanner runs before it yields its scan thread to other scanners
+CONF_mInt32(doris_scanner_max_run_time_ms, "100");
 // number of max scan keys
 CONF_mInt32(doris_max_scan_key_num, "1024");
 // the max number of push down values of a single column.
@@ -202,8 +273,28 @@ CONF_mInt32(doris_max_scan_key_num, "1024");
 CONF_mInt32(max_pushdown_conditions_per_column, "1024");
 // return_row / total_row
 CONF_mInt32(doris_max_pushdown_conjuncts_return_rate, "90");
+// if true, the conjuncts of an olap scan node on a duplicate keys table are evaluated by
+// the storage before the columns they don't reference are read
+CONF_mBool(enable_storage_conjunct_filter, "true");
+// if true, a TOP-N ordered by a slot of its child olap scan node passes the worst value
+// of its full priority queue to the scanners, which drop the rows that can't enter it
+CONF_mBool(enable_topn_threshold_filter, "true");
+// max number of build side keys of hash join to push down as an IN predicate
+CONF_mInt32(join_push_down_in_max_num, "1024");
+// if true, hash join pushes down the min/max of build side keys when
+// there are too many keys for an IN predicate
+CONF_mBool(enable_join_minmax_push_down, "true");
+// if true, INTERSECT and EXCEPT push the keys left in their hash table down to the
+// scan of each later child before it's opened, limited like the keys of a hash join
+CONF_mBool(enable_set_operation_push_down, "true");
+// if true, the instances of a fragment on one backend build the hash table of a
+// broadcast join once and share it
+CONF_mBool(enable_shared_broadcast_hash_table, "true");
 // (Advanced) Maximum size of per-query receive-side buffer
 CONF_mInt32(exchg_node_buffer_size_bytes, "10485760");
+// max bytes a receive-side buffer feeding a hash join build or a sort spills to the tmp dirs once
+// it exceeds exchg_node_buffer_size_bytes, rather than blocking the senders. 0 disables spill
+CONF_mInt64(data_stream_receiver_spill_max_bytes, "10737418240");
 // insert sort threshold for sorter
 // CONF_Int32(insertion_threshold, "16");
 // the block_size every block allocate for sorter
@@ -260,8 +351,67 @@ CONF_Int64(index_stream_cache_capacity, "10737418240");
 
 // Cache for storage page size
 CONF_String(storage_page_cache_limit, "20G");
+// Percentage of storage_page_cache_limit used to cache index, dictionary and short key
+// pages, the rest is used to cache data pages
+CONF_Int32(index_page_cache_percentage, "10");
+// If true, a data page is only cached when it's read the second time within a while,
+// so that pages read once by large scans don't evict frequently accessed pages
+CONF_mBool(storage_page_cache_admit_on_second_access, "true");
 // whether to disable page cache feature in storage
 CONF_Bool(disable_storage_page_cache, "false");
+// Memory limit of the cache of opened segments, including their footers and column readers
+CONF_String(segment_cache_limit, "2G");
+// Memory limit of the cache of decoded data pages of in_memory tables, whose reads
+// then skip page decoding, 0 disables the cache
+CONF_String(decoded_page_cache_limit, "0");
+// Memory limit of the cache of the output of the aggregations reading an olap scan directly,
+// reused by the fragments that read the same tablet versions again. 0 disables the cache
+CONF_String(agg_result_cache_limit, "0");
+// The output of an aggregation is only cached if its serialized size is at most this
+CONF_mInt64(agg_result_cache_max_entry_bytes, "16777216");
+// Range predicates on a column with bitmap index are served by the index only if the share
+// of the distinct values of a segment in their range doesn't exceed this ratio
+CONF_mDouble(bitmap_index_range_max_selectivity, "0.2");
+// Number of bytes of each gram in the n-gram indexes of newly written segments. Only
+// patterns with a literal of at least this many bytes can use the index.
+CONF_Int32(ngram_index_gram_size, "3");
+// Level of the S2 cells of the points in the S2 indexes of newly written segments. A cell
+// of level 16 is about 150m wide, a higher level prunes more precisely with more cells.
+CONF_Int32(s2_index_cell_level, "16");
+// Max number of cells covering the region of a geo predicate when the S2 index is probed
+CONF_mInt32(s2_index_max_covering_cells, "32");
+// Whether the short key index of newly written segments encodes all the key columns
+// instead of the short key columns only, which narrows down the rows searched by point
+// lookups on long keys at the cost of larger index pages.
+CONF_mBool(short_key_index_all_key_columns, "false");
+// number of data pages of each column a segment iterator reads ahead of the page it is
+// decoding, 0 disables read ahead
+CONF_mInt32(segment_read_ahead_pages, "0");
+// number of threads to read segment pages ahead
+CONF_Int32(segment_read_ahead_thread_num, "16");
+// Directory on a local SSD used to cache the segment files of data dirs on HDD,
+// empty means the cache is disabled. Content of the directory is removed on start.
+CONF_String(ssd_cache_path, "");
+// capacity of the ssd cache
+CONF_Int64(ssd_cache_capacity_bytes, "107374182400");
+// files are cached in blocks of this size
+CONF_Int32(ssd_cache_block_size, "1048576");
+// If true, a block is only cached when it's read the second time within a while
+CONF_mBool(ssd_cache_admit_on_second_access, "true");
+// whether to write newly written segment files into the ssd cache
+CONF_mBool(ssd_cache_write_through, "true");
+// if true, RandomAccessFile::read_batch() submits the reads at once by io_uring when the
+// kernel supports it, otherwise it reads them one by one
+CONF_Bool(enable_io_uring, "false");
+// if true, the segments of flushed memtables and of compaction outputs are written with
+// O_DIRECT, so that writing them doesn't evict the pages queries read from the page cache
+CONF_mBool(segment_write_direct_io, "false");
+// if true, the pages of the input rowsets of a compaction are dropped from the page cache
+// once the compaction has rewritten them
+CONF_mBool(compaction_drop_input_page_cache, "true");
+// if true, segment v2 writer encodes the first rows of each column with every encoding of
+// its type and keeps the smallest one, weighted by decode cost, instead of the default one
+CONF_mBool(enable_adaptive_encoding, "false");
 
 // be policy
 // whether disable automatic compaction task
@@ -275,12 +425,21 @@ CONF_mInt64(base_compaction_num_cumulative_deltas, "5");
 CONF_mDouble(base_cumulative_delta_ratio, "0.3");
 CONF_mInt64(base_compaction_interval_seconds_since_last_operation, "86400");
 CONF_mInt32(base_compaction_write_mbytes_per_sec, "5");
+// the max number of key ranges, split by the short key index, that the rowsets of a base
+// compaction are merged in parallel, 1 means merging them in one range
+CONF_mInt32(base_compaction_parallel_key_ranges, "1");
+// the min number of input rows of a key range of a parallel base compaction
+CONF_mInt64(base_compaction_min_rows_per_key_range, "10000000");
+// the count of thread to merge the key ranges of base compactions
+CONF_Int32(base_compaction_key_range_thread_num, "8");
 
 // config the cumulative compaction policy
-// Valid configs: num_base, size_based
+// Valid configs: num_base, size_based, time_series
 // num_based policy, the original version of cumulative compaction, cumulative version compaction once.
 // size_based policy, a optimization version of cumulative compaction, targeting the use cases requiring
 // lower write amplification, trading off read amplification and space amplification.
+// time_series policy, for append-only time series data, compacts the rowsets of a window once
+// and never compacts its output again.
 CONF_String(cumulative_compaction_policy, "size_based");
 
 // In size_based policy, output rowset of cumulative compaction total disk size exceed this config size,
@@ -296,6 +455,15 @@ CONF_mInt64(cumulative_size_based_promotion_min_size_mbytes, "64");
 // The lower bound size to do cumulative compaction. When total disk size of candidate rowsets is less than
 // this size, size_based policy may not do to cumulative compaction. The unit is m byte.
 CONF_mInt64(cumulative_size_based_compaction_lower_size_mbytes, "64");
+// In time_series policy, the rowsets after the cumulative point are compacted once their total disk
+// size reaches this config size, and the output is never compacted again. The unit is m byte.
+CONF_mInt64(time_series_compaction_goal_size_mbytes, "1024");
+// In time_series policy, the rowsets after the cumulative point are compacted once there are this
+// many of them, even if their total disk size is less than time_series_compaction_goal_size_mbytes.
+CONF_mInt64(time_series_compaction_file_count_threshold, "2000");
+// In time_series policy, the rowsets after the cumulative point are compacted once the oldest of
+// them was created this many seconds ago.
+CONF_mInt64(time_series_compaction_time_threshold_seconds, "3600");
 
 // cumulative compaction policy: min and max delta file's number
 CONF_mInt64(min_cumulative_compaction_num_singleton_deltas, "5");
@@ -321,15 +489,80 @@ CONF_mInt64(total_permits_for_compaction_score, "10000");
 // Compaction task number per disk.
 CONF_mInt32(compaction_task_num_per_disk, "2");
 
+// When the I/O utilization (percent) of the disk of a data dir exceeds this share, only one
+// compaction task is allowed to run on it. 0 or 100 means no limit. The utilization is
+// sampled from system metrics every "compaction_disk_io_stat_interval_sec" seconds.
+CONF_mInt32(compaction_disk_io_util_share, "80");
+CONF_mInt32(compaction_disk_io_stat_interval_sec, "30");
+
+// Whether to convert the alpha rowsets of tablets to beta rowsets in background, under the
+// permits and the disk I/O share of compaction.
+CONF_mBool(enable_rowset_conversion, "false");
+// the count of thread to convert rowsets
+CONF_Int32(rowset_conversion_thread_num, "4");
+// rowset conversion task number per disk
+CONF_mInt32(rowset_conversion_task_num_per_disk, "1");
+// the interval in seconds to look for alpha rowsets to convert
+CONF_mInt32(rowset_conversion_check_interval_sec, "60");
+
+// Whether a schema change which only adds bitmap or bloom filter indexes links the rowsets,
+// whose indexes are built in background into the index files beside their segments,
+// instead of rewriting all the data.
+CONF_mBool(enable_index_build, "false");
+// the count of thread to build the indexes of rowsets
+CONF_Int32(index_build_thread_num, "2");
+// index build task number per disk
+CONF_mInt32(index_build_task_num_per_disk, "1");
+// the interval in seconds to look for rowsets missing indexes
+CONF_mInt32(index_build_check_interval_sec, "60");
+
+// whether to write the statistics index of the columns of new segments, whose numbers of
+// nulls and distinct values are reported to FE with the tablet stats
+CONF_mBool(enable_column_statistics, "false");
+// the interval in seconds to collect the column statistics of the tablets with new versions
+CONF_mInt32(column_statistics_collect_interval_sec, "300");
+// max number of tablets to collect the column statistics of in a round
+CONF_mInt32(column_statistics_collect_tablet_num_per_round, "1000");
+// max number of buckets of the histogram of a column
+CONF_mInt32(column_statistics_histogram_buckets, "64");
+
 // How many rounds of cumulative compaction for each round of base compaction when compaction tasks generation.
 CONF_mInt32(cumulative_compaction_rounds_for_each_base_compaction_round, "9");
 
 // Merge log will be printed for each "row_step_for_compaction_merge_log" rows merged during compaction
 CONF_mInt64(row_step_for_compaction_merge_log, "0");
 
+// Compact the rowsets of duplicate key tablets column group by column group: key columns
+// are merged first to decide the order of rows, then value columns are copied in that
+// order, at most "vertical_compaction_num_columns_per_group" columns at a time. This
+// bounds the memory of compacting wide tables.
+CONF_mBool(enable_vertical_compaction, "true");
+CONF_mInt32(vertical_compaction_num_columns_per_group, "5");
+
+// Link the segments of input rowsets into the output rowset instead of rewriting them,
+// if their key ranges don't overlap, e.g. the rowsets of append-only time series.
+CONF_mBool(enable_ordered_data_compaction, "true");
+
+// Merge beta rowsets in column blocks instead of row by row in compaction, if none of
+// them has delete predicate.
+CONF_mBool(enable_block_compaction, "true");
+
+// Compaction of a clustered duplicate key tablet sorts its output rows by Z-order in runs
+// of this many bytes of rows in memory.
+CONF_mInt64(clustering_compaction_sort_bytes, "67108864");
+
+// Resolve DELETE on tablets of beta rowsets into the rows deleted when it's published and
+// mark them in the delete bitmap of the tablet, so that reads of older data skip them by
+// row id instead of evaluating the delete predicate on every row.
+CONF_mBool(enable_delete_by_bitmap, "false");
+
 // Threshold to logging compaction trace, in seconds.
 CONF_mInt32(base_compaction_trace_threshold, "10");
 CONF_mInt32(cumulative_compaction_trace_threshold, "2");
+// Threshold to logging the trace of an olap scanner, in milliseconds. The trace records when
+// the scanner and its segments load indexes and read batches, and is dumped only if the
+// scanner runs longer than this from open to close. Scanners aren't traced if it's not positive.
+CONF_mInt32(olap_scanner_trace_threshold_ms, "10000");
 
 // time interval to record tablet scan count in second for the purpose of calculating tablet scan frequency
 CONF_mInt64(tablet_scan_frequency_time_node_interval_second, "300");
@@ -341,6 +574,13 @@ CONF_mInt32(compaction_tablet_compaction_score_factor, "1");
 CONF_Int32(webserver_port, "8040");
 // Number of webserver workers
 CONF_Int32(webserver_num_workers, "48");
+// Max number of webserver threads running the handlers which block for long, e.g. stream load
+// waiting for the load to finish, so that they don't hold the event loop threads. 0 runs them in
+// the event loop threads
+CONF_Int32(webserver_handler_thread_num, "64");
+// Max number of requests waiting for the webserver handler threads, the more are handled in the
+// event loop threads
+CONF_Int32(webserver_handler_queue_size, "1024");
 // Period to update rate counters and sampling counters in ms.
 CONF_mInt32(periodic_counter_update_period_ms, "500");
 
@@ -349,6 +589,9 @@ CONF_Int64(load_data_reserve_hours, "4");
 // log error log will be removed after this time
 CONF_mInt64(load_error_log_reserve_hours, "48");
 CONF_Int32(number_tablet_writer_threads, "16");
+// number of threads serving the external scan rpcs over brpc, which block until the next batch
+// of the scan is ready
+CONF_Int32(external_scan_rpc_threads, "64");
 
 // The maximum amount of data that can be processed by a stream load
 CONF_mInt64(streaming_load_max_mb, "10240");
@@ -356,6 +599,34 @@ CONF_mInt64(streaming_load_max_mb, "10240");
 // Therefore, it is necessary to limit the maximum number of
 // such data when using stream load to prevent excessive memory consumption.
 CONF_mInt64(streaming_load_json_max_mb, "100");
+// Decompress the compressed csv files of a broker load on a helper thread, so that the
+// scanner thread only splits and converts the lines.
+CONF_mBool(enable_async_decompress, "true");
+// Skip the row groups of the parquet files of a broker load whose column statistics show
+// that none of their rows matches the filter of the load.
+CONF_mBool(enable_parquet_row_group_filter, "true");
+// Skip the stripes of the orc files of a broker load whose column statistics show that
+// none of their rows matches the filter of the load.
+CONF_mBool(enable_orc_stripe_filter, "true");
+// Read the next block of a broker file ahead on a helper thread when the file is read
+// sequentially through a BufferedReader.
+CONF_mBool(enable_buffered_reader_read_ahead, "true");
+// max bytes of the body of a stream load buffered in its pipe before the receiving of it waits
+// for the scanner to read them
+CONF_mInt64(stream_load_pipe_buffer_bytes, "4194304");
+// number of scanner threads that parse the plain csv stream of a stream load in parallel, each
+// taking chunks of complete lines of the stream in turn. The rows are still sent to the table
+// sink in the order of the stream. 1 parses the stream on one thread.
+CONF_mInt32(stream_load_parse_threads, "1");
+// size of the chunks of lines that the scanners of a stream load take in turn
+CONF_mInt64(stream_load_parse_chunk_bytes, "8388608");
+// the small csv stream loads sent with the header "group_commit: true" are loaded together in
+// one transaction per table, once their group has been open for group_commit_interval_ms or
+// their bodies reach group_commit_max_bytes. A load can't be larger than group_commit_max_bytes.
+CONF_mInt32(group_commit_interval_ms, "1000");
+CONF_mInt64(group_commit_max_bytes, "67108864");
+// number of threads that load the groups of group commit loads
+CONF_Int32(group_commit_threads, "8");
 // the alive time of a TabletsChannel.
 // If the channel does not receive any data till this time,
 // the channel will be removed.
@@ -370,11 +641,24 @@ CONF_Int32(tablet_writer_open_rpc_timeout_sec, "60");
 // CONF_Int32(tablet_writer_rpc_timeout_sec, "600");
 // OlapTableSink sender's send interval, should be less than the real response time of a tablet writer rpc.
 CONF_mInt32(olap_table_sink_send_interval_ms, "10");
+// max number of batches queued for a node channel of OlapTableSink, the sink blocks when
+// a queue is full until its rpcs catch up. 0 means unlimited.
+CONF_mInt32(olap_table_sink_max_pending_batches_per_channel, "16");
 
 // Fragment thread pool
 CONF_Int32(fragment_pool_thread_num_min, "64");
 CONF_Int32(fragment_pool_thread_num_max, "512");
 CONF_Int32(fragment_pool_queue_size, "2048");
+// if true, fragment instances run as bthreads on the brpc workers instead of on the fragment
+// thread pool. An instance waiting for the batches of an exchange or an olap scan is then
+// suspended and its worker runs other bthreads, so a few threads serve many instances. The
+// other waits of an instance, e.g. disk io, still hold the worker, set brpc_num_threads
+// large enough that they don't starve the rpcs.
+// The state kept per thread doesn't follow a bthread to another worker, so the cpu time
+// counters of the profiles are not collected in this mode, and it can't be combined with
+// mem_tracker_consumption_cache_bytes or continuous_cpu_profiler_interval_ms, the BE
+// refuses to start then.
+CONF_Bool(fragment_exec_in_bthread, "false");
 
 //for cast
 // CONF_Bool(cast, "true");
@@ -413,12 +697,41 @@ CONF_Bool(use_mmap_allocate_chunk, "false");
 // acquire more free memory which can not be used by other modules
 CONF_Int64(chunk_reserved_bytes_limit, "2147483648");
 
+// If positive, MemTracker::Consume() and Release() accumulate small changes of consumption
+// in a cache of each thread and apply them to the tracker and its ancestors once they add
+// up to this many bytes, which saves updating the shared query and process trackers on
+// every chunk allocation. The consumption of a tracker may then be off by this much for
+// each thread using it, limit checks apply the cache of the checking thread first and
+// closing a tracker applies the caches of all threads
+CONF_Int64(mem_tracker_consumption_cache_bytes, "0");
+
+// Whether to bind the memory of the chunks allocated via mmap to the NUMA node of the
+// allocating core, so that the chunks cached by a node are local to its cores
+CONF_Bool(chunk_allocator_bind_numa_node, "true");
+
 // The probing algorithm of partitioned hash table.
 // Enable quadratic probing hash table
 CONF_Bool(enable_quadratic_probing, "false");
 
+// A partition of a streaming pre-aggregation stops aggregating and passes its rows
+// through once it has aggregated this many rows with a reduction factor (input rows
+// divided by groups) below streaming_preagg_min_reduction. 0 means never.
+CONF_mInt64(streaming_preagg_passthrough_sample_rows, "65536");
+CONF_mDouble(streaming_preagg_min_reduction, "1.5");
+
+// If true, the intermediate states of count/sum(DISTINCT) on 32 and 64 bits integers are
+// sent as sorted delta varints, which older BEs can't read. Set it to false while a
+// cluster is upgraded from such BEs.
+CONF_mBool(enable_compact_distinct_state, "true");
+
 // for pprof
 CONF_String(pprof_profile_dir, "${DORIS_HOME}/log");
+// The continuous cpu profiler takes a sample every so many milliseconds of the CPU time of
+// the process, tagged with the query and the role of the thread, see /pprof/continuous.
+// 0 to disable it.
+CONF_Int32(continuous_cpu_profiler_interval_ms, "100");
+// The number of the latest samples kept by the continuous cpu profiler, about 300 bytes each
+CONF_Int32(continuous_cpu_profiler_max_samples, "65536");
 
 // for partition
 // CONF_Bool(enable_partitioned_hash_join, "false")
@@ -449,13 +762,23 @@ CONF_Bool(ignore_broken_disk, "false");
 // Writable scratch directories
 CONF_String(scratch_dirs, "/tmp");
 
+// Whether the blocks spilled to the scratch directories are compressed with LZ4. Blocks
+// that don't get smaller are written as is
+CONF_mBool(compress_spilled_blocks, "true");
+
 // If false and --scratch_dirs contains multiple directories on the same device,
 // then only the first writable directory is used
 // CONF_Bool(allow_multiple_scratch_dirs_per_device, "false");
 
-// linux transparent huge page
+// linux transparent huge page, the buffers of the buffer pool and the chunks of the mem pools
+// whose size is a multiple of 2MB are aligned to it and advised to be backed by huge pages
 CONF_Bool(madvise_huge_pages, "false");
 
+// If madvise_huge_pages is set, whether the huge page backed buffers and chunks allocated via
+// mmap take the huge pages reserved by hugetlbfs (vm.nr_hugepages) first. Allocations fall
+// back to transparent huge pages when the reserved ones run out
+CONF_Bool(use_hugetlb_pages, "false");
+
 // whether use mmap to allocate memory
 CONF_Bool(mmap_buffers, "false");
 
@@ -465,6 +788,11 @@ CONF_String(buffer_pool_limit, "80G");
 // clean page can be hold by buffer pool
 CONF_String(buffer_pool_clean_pages_limit, "20G");
 
+// How long a fragment instance waits for the initial buffer reservation of its query to fit
+// into the process memory before it fails. The waiting instances are admitted in arrival
+// order. 0 means failing right away
+CONF_mInt64(fragment_admission_timeout_ms, "60000");
+
 // Sleep time in seconds between memory maintenance iterations
 CONF_mInt64(memory_maintenance_sleep_time_s, "10");
 
@@ -474,6 +802,11 @@ CONF_Int32(memory_max_alignment, "16");
 // write buffer size before flush
 CONF_mInt64(write_buffer_size, "104857600");
 
+// If true, memtables append rows and sort and aggregate them once on flush, instead of
+// keeping them sorted in a skiplist. Aggregate and unique key memtables hold the rows
+// with duplicate keys until flush, so they fill faster when keys repeat a lot.
+CONF_mBool(memtable_sort_on_flush, "false");
+
 // following 2 configs limit the memory consumption of load process on a Backend.
 // eg: memory limit to 80% of mem limit config but up to 100GB(default)
 // NOTICE(cmy): set these default values very large because we don't want to
@@ -481,6 +814,9 @@ CONF_mInt64(write_buffer_size, "104857600");
 // user should set these configs properly if necessary.
 CONF_Int64(load_process_max_memory_limit_bytes, "107374182400"); // 100GB
 CONF_Int32(load_process_max_memory_limit_percent, "80");         // 80%
+// when the load memory of a Backend exceeds its limit, the largest memtables are flushed
+// until the load memory falls to this percent of the limit.
+CONF_mInt32(load_process_low_water_percent, "50");
 
 // update interval of tablet stat cache
 CONF_mInt32(tablet_stat_cache_update_interval_second, "300");
@@ -493,6 +829,8 @@ CONF_mInt32(priority_queue_remaining_tasks_increased_frequency, "512");
 
 // sync tablet_meta when modifying meta
 CONF_mBool(sync_tablet_meta, "false");
+// the max number of concurrent meta write requests merged into one rocksdb write batch
+CONF_mInt32(meta_group_commit_max_requests, "128");
 
 // default thrift rpc timeout ms
 CONF_mInt32(thrift_rpc_timeout_ms, "5000");
@@ -502,9 +840,16 @@ CONF_mInt32(txn_commit_rpc_timeout_ms, "10000");
 
 // If set to true, metric calculator will run
 CONF_Bool(enable_metric_calculator, "true");
+// The output of the metrics http api is rendered at most once in this interval and is served
+// from the last rendering meanwhile, so concurrent or frequent scrapes don't walk all the
+// metrics each. 0 renders for each request.
+CONF_mInt32(metrics_snapshot_interval_ms, "1000");
 
 // max consumer num in one data consumer group, for routine load
 CONF_mInt32(max_consumer_num_per_group, "3");
+// min size of the chunks that the csv messages of a routine load are appended to, the scanner
+// reads a chunk at a time
+CONF_mInt64(routine_load_pipe_chunk_bytes, "1048576");
 
 // the size of thread pool for routine load task.
 // this should be larger than FE config 'max_concurrent_task_num_per_be' (default 5)
@@ -528,6 +873,14 @@ CONF_String(es_scroll_keepalive, "5m");
 // HTTP connection timeout for es
 CONF_Int32(es_http_timeout_ms, "5000");
 
+// The number of sliced scrolls a shard of an es index is read with in parallel. Each slice
+// holds a scroll context on es, raise it for large shards.
+CONF_mInt32(es_scroll_slices_per_shard, "1");
+
+// The max number of rows an odbc scanner fetches at a time, the column buffers of a fetch are
+// also limited to about 8MB.
+CONF_mInt32(odbc_scan_batch_size, "1024");
+
 // the max client cache number per each host
 // There are variety of client cache in BE, but currently we use the
 // same cache size configuration.
@@ -549,8 +902,21 @@ CONF_mInt32(path_scan_interval_second, "86400");
 CONF_mInt32(storage_flood_stage_usage_percent, "95"); // 95%
 // The min bytes that should be left of a data dir
 CONF_mInt64(storage_flood_stage_left_capacity_bytes, "1073741824"); // 1GB
+// A data dir is slow if the p99 latency of its reads or writes during the last
+// disk_stat_monitor_interval exceeds this, and no new tablets are created on it unless all
+// the data dirs are slow. 0 to disable.
+CONF_mInt32(slow_disk_latency_threshold_ms, "1000");
+// The min number of the reads or writes of a data dir during the interval to judge it slow
+CONF_mInt32(slow_disk_min_latency_samples, "10");
 // number of thread for flushing memtable per store
 CONF_Int32(flush_thread_num_per_store, "2");
+// number of threads to encode and compress the columns of a segment in parallel when a
+// memtable is flushed, shared by all flush threads. 0 to encode them one by one.
+CONF_Int32(flush_column_encode_thread_num, "16");
+// Max number of memtables of a tablet writer being flushed at the same time, each to its
+// own segment. Writes wait when reaching it. If it's 1, memtables are queued and flushed
+// one by one. Only beta rowsets support concurrent flush.
+CONF_mInt32(max_flushing_memtables_per_writer, "1");
 
 // config for tablet meta checkpoint
 CONF_mInt32(tablet_meta_checkpoint_min_new_rowsets_num, "10");
@@ -564,6 +930,12 @@ CONF_String(default_rowset_type, "BETA");
 CONF_Int64(brpc_max_body_size, "209715200");
 // Max unwritten bytes in each socket, if the limit is reached, Socket.Write fails with EOVERCROWDED
 CONF_Int64(brpc_socket_max_unwritten_bytes, "67108864");
+// connection type of the brpc channels to the other Backends, one of single, pooled and short.
+// All the rpcs to a peer share one connection if single, pooled gives each concurrent rpc a
+// connection of its own, so heavy exchanges aren't limited by the throughput of one connection.
+CONF_String(brpc_connection_type, "single");
+// max number of idle connections kept for each peer if brpc_connection_type is pooled
+CONF_Int32(brpc_max_connections_per_peer, "32");
 
 // max number of txns for every txn_partition_map in txn manager
 // this is a self protection to avoid too many txns saving in manager
@@ -586,6 +958,9 @@ CONF_Int32(txn_shard_size, "1024");
 // Whether to continue to start be when load tablet from header failed.
 CONF_Bool(ignore_load_tablet_failure, "false");
 
+// number of threads to load tablets and rowsets from meta of each data dir on start
+CONF_Int32(load_tablet_thread_num_per_data_dir, "8");
+
 // Whether to continue to start be when load tablet from header failed.
 CONF_Bool(ignore_rowset_stale_unconsistent_delete, "false");
 
@@ -601,6 +976,10 @@ CONF_Int32(query_cache_elasticity_size_mb, "128");
 // Maximum number of cache partitions corresponding to a SQL
 CONF_Int32(query_cache_max_partition_count, "1024");
 
+// The number of shards of the query cache, each has its own lock and LRU list. The cache size
+// limits are divided evenly among the shards.
+CONF_Int32(query_cache_shard_num, "16");
+
 // Maximum number of version of a tablet. If the version num of a tablet exceed limit,
 // the load process will reject new incoming load job of this tablet.
 // This is to avoid too many version num.
@@ -49,6 +49,7 @@
 #include "runtime/mem_tracker.h"
 #include "runtime/memory/chunk_allocator.h"
 #include "runtime/user_function_cache.h"
+#include "util/continuous_cpu_profiler.h"
 #include "util/cpu_info.h"
 #include "util/debug_util.h"
 #include "util/disk_info.h"
@@ -279,6 +280,13 @@ void Daemon::start() {
             "Daemon", "tcmalloc_gc_thread", [this]() { this->tcmalloc_gc_thread(); },
             &_tcmalloc_gc_thread);
     CHECK(st.ok()) << st.to_string();
+
+    if (config::continuous_cpu_profiler_interval_ms > 0) {
+        st = ContinuousCpuProfiler::instance()->start(
+                config::continuous_cpu_profiler_interval_ms,
+                config::continuous_cpu_profiler_max_samples);
+        LOG_IF(WARNING, !st.ok()) << st.to_string();
+    }
 #endif
     st = Thread::create(
             "Daemon", "memory_maintenance_thread", [this]() { this->memory_maintenance_thread(); },
@@ -166,6 +166,9 @@ public:
 
     // create a hard-link
     virtual Status link_file(const std::string& /*old_path*/, const std::string& /*new_path*/) = 0;
+
+    // Drop the pages of the file from the OS page cache, because it won't be read soon.
+    virtual Status drop_page_cache(const std::string& fname) = 0;
 };
 
 struct RandomAccessFileOptions {
@@ -178,6 +181,9 @@ struct WritableFileOptions {
     bool sync_on_close = false;
     // See OpenMode for details.
     Env::OpenMode mode = Env::CREATE_OR_OPEN_WITH_TRUNCATE;
+    // Write with O_DIRECT, bypassing the OS page cache, if the file system supports it.
+    // Ignored for MUST_EXIST.
+    bool direct_io = false;
 };
 
 // Creation-time options for RWFile
@@ -218,6 +224,12 @@ public:
 
 class RandomAccessFile {
 public:
+    // A range of the file to read by read_batch()
+    struct ReadRequest {
+        uint64_t offset = 0;
+        Slice result;
+    };
+
     RandomAccessFile() {}
     virtual ~RandomAccessFile() {}
 
@@ -246,6 +258,24 @@ public:
     // Safe for concurrent use by multiple threads.
     virtual Status readv_at(uint64_t offset, const Slice* res, size_t res_cnt) const = 0;
 
+    // Read "reqs[i].result.size" bytes starting at "reqs[i].offset" into
+    // "reqs[i].result.data" for each of the 'num' requests, which needn't be
+    // contiguous, e.g. the pages of a segment to read.
+    //
+    // Short reads are retried as in read_at(). If an error was encountered,
+    // returns a non-OK status and the content of all buffers is undefined.
+    //
+    // The default implementation reads them one after another, implementations
+    // may issue them at once.
+    //
+    // Safe for concurrent use by multiple threads.
+    virtual Status read_batch(const ReadRequest* reqs, size_t num) const {
+        for (size_t i = 0; i < num; ++i) {
+            RETURN_IF_ERROR(read_at(reqs[i].offset, reqs[i].result));
+        }
+        return Status::OK();
+    }
+
     // Return the size of this file
     virtual Status size(uint64_t* size) const = 0;
 
@@ -10,15 +10,20 @@
 #include <dirent.h>
 #include <fcntl.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <sys/uio.h>
 #include <unistd.h>
 
 #include <memory>
+#include <vector>
 
+#include "common/config.h"
 #include "common/logging.h"
 #include "env/env.h"
+#include "env/io_uring_reader.h"
 #include "gutil/gscoped_ptr.h"
 #include "gutil/macros.h"
 #include "gutil/port.h"
@@ -273,6 +278,23 @@ public:
     Status readv_at(uint64_t offset, const Slice* res, size_t res_cnt) const override {
         return do_readv_at(_fd, _filename, offset, res, res_cnt);
     }
+
+    Status read_batch(const ReadRequest* reqs, size_t num) const override {
+        if (num > 1 && config::enable_io_uring && IoUringReader::is_supported()) {
+            std::vector<int64_t> results(num);
+            Status st = IoUringReader::read(_fd, reqs, num, results.data());
+            if (st.ok()) {
+                for (size_t i = 0; i < num; ++i) {
+                    RETURN_IF_ERROR(_finish_read(reqs[i], results[i]));
+                }
+                return Status::OK();
+            }
+            LOG(WARNING) << "failed to read by io_uring, fall back to pread. file=" << _filename
+                         << ", st=" << st.to_string();
+        }
+        return RandomAccessFile::read_batch(reqs, num);
+    }
+
     Status size(uint64_t* size) const override {
         struct stat st;
         auto res = fstat(_fd, &st);
@@ -286,6 +308,20 @@ public:
     const std::string& file_name() const override { return _filename; }
 
 private:
+    // Complete 'req' of which 'result' bytes have been read, or which failed
+    // with -errno 'result'.
+    Status _finish_read(const ReadRequest& req, int64_t result) const {
+        if (result < 0 && result != -EINTR && result != -EAGAIN) {
+            return io_error(_filename, -result);
+        }
+        size_t bytes_read = std::max<int64_t>(result, 0);
+        if (bytes_read >= req.result.size) {
+            return Status::OK();
+        }
+        Slice rest(req.result.data + bytes_read, req.result.size - bytes_read);
+        return do_readv_at(_fd, _filename, req.offset + bytes_read, &rest, 1);
+    }
+
     std::string _filename;
     int _fd;
 };
@@ -406,6 +442,144 @@ private:
     uint64_t _pre_allocated_size = 0;
 };
 
+// Writes with O_DIRECT, so that the data doesn't go through the OS page cache. Appends
+// are buffered in an aligned buffer which is written block by block. The last partial
+// block is written padded with zeros by sync() and close(), and the padding is truncated
+// when the file is closed.
+class PosixDirectWritableFile : public WritableFile {
+public:
+    static const size_t ALIGNMENT = 4096;
+    static const size_t BUFFER_SIZE = 1024 * 1024;
+
+    // 'buf' of BUFFER_SIZE bytes is aligned to ALIGNMENT, and owned by this file
+    PosixDirectWritableFile(std::string filename, int fd, bool sync_on_close, uint8_t* buf)
+            : _filename(std::move(filename)), _fd(fd), _sync_on_close(sync_on_close), _buf(buf) {}
+
+    ~PosixDirectWritableFile() override {
+        WARN_IF_ERROR(close(), "Failed to close file, file=" + _filename);
+        free(_buf);
+    }
+
+    Status append(const Slice& data) override { return appendv(&data, 1); }
+
+    Status appendv(const Slice* data, size_t cnt) override {
+        for (size_t i = 0; i < cnt; ++i) {
+            const uint8_t* src = reinterpret_cast<const uint8_t*>(data[i].data);
+            size_t left = data[i].size;
+            while (left > 0) {
+                size_t n = std::min(left, BUFFER_SIZE - _buf_len);
+                memcpy(_buf + _buf_len, src, n);
+                _buf_len += n;
+                src += n;
+                left -= n;
+                if (_buf_len == BUFFER_SIZE) {
+                    RETURN_IF_ERROR(_write_buffer(false));
+                }
+            }
+        }
+        return Status::OK();
+    }
+
+    Status pre_allocate(uint64_t size) override {
+        uint64_t offset = std::max<uint64_t>(_buf_offset + _buf_len, _pre_allocated_size);
+        int ret;
+        RETRY_ON_EINTR(ret, fallocate(_fd, 0, offset, size));
+        if (ret != 0) {
+            if (errno == EOPNOTSUPP) {
+                LOG(WARNING) << "The filesystem does not support fallocate().";
+            } else if (errno == ENOSYS) {
+                LOG(WARNING) << "The kernel does not implement fallocate().";
+            } else {
+                return io_error(_filename, errno);
+            }
+        }
+        _pre_allocated_size = offset + size;
+        return Status::OK();
+    }
+
+    Status close() override {
+        if (_closed) {
+            return Status::OK();
+        }
+        Status s = _write_buffer(true);
+        // drop the padding of the last block and the space allocated but not used
+        if (s.ok()) {
+            int ret;
+            RETRY_ON_EINTR(ret, ftruncate(_fd, size()));
+            if (ret != 0) {
+                s = io_error(_filename, errno);
+            }
+        }
+        if (s.ok() && _sync_on_close) {
+            s = do_sync(_fd, _filename);
+            if (!s.ok()) {
+                LOG(ERROR) << "Unable to Sync " << _filename << ": " << s.to_string();
+            }
+        }
+        int ret;
+        RETRY_ON_EINTR(ret, ::close(_fd));
+        if (ret < 0 && s.ok()) {
+            s = io_error(_filename, errno);
+        }
+        _closed = true;
+        return s;
+    }
+
+    Status flush(FlushMode mode) override {
+        RETURN_IF_ERROR(_write_buffer(mode == FLUSH_SYNC));
+        return mode == FLUSH_SYNC ? sync() : Status::OK();
+    }
+
+    Status sync() override {
+        RETURN_IF_ERROR(_write_buffer(true));
+        if (_pending_sync) {
+            _pending_sync = false;
+            RETURN_IF_ERROR(do_sync(_fd, _filename));
+        }
+        return Status::OK();
+    }
+
+    uint64_t size() const override { return _buf_offset + _buf_len; }
+    const string& filename() const override { return _filename; }
+
+private:
+    // Writes the whole blocks of the buffer and drops them from it, and the last partial
+    // block too if 'pad' is true, which stays in the buffer to be written again.
+    Status _write_buffer(bool pad) {
+        size_t whole_len = _buf_len & ~(ALIGNMENT - 1);
+        size_t len = pad ? (_buf_len + ALIGNMENT - 1) & ~(ALIGNMENT - 1) : whole_len;
+        if (len == 0) {
+            return Status::OK();
+        }
+        memset(_buf + _buf_len, 0, len - std::min(len, _buf_len));
+        size_t written = 0;
+        while (written < len) {
+            ssize_t res;
+            RETRY_ON_EINTR(res, pwrite(_fd, _buf + written, len - written, _buf_offset + written));
+            if (res < 0) {
+                return io_error(_filename, errno);
+            }
+            written += res;
+        }
+        memmove(_buf, _buf + whole_len, _buf_len - whole_len);
+        _buf_offset += whole_len;
+        _buf_len -= whole_len;
+        _pending_sync = true;
+        return Status::OK();
+    }
+
+    std::string _filename;
+    int _fd;
+    const bool _sync_on_close = false;
+    bool _pending_sync = false;
+    bool _closed = false;
+    uint8_t* _buf;
+    size_t _buf_len = 0;
+    // the offset of the buffer in the file, always aligned
+    uint64_t _buf_offset = 0;
+    uint64_t _pre_allocated_size = 0;
+};
+
 class PosixRandomRWFile : public RandomRWFile {
 public:
     PosixRandomRWFile(string fname, int fd, bool sync_on_close)
@@ -536,6 +710,19 @@ public:
         if (opts.mode == MUST_EXIST) {
             RETURN_IF_ERROR(get_file_size(fname, &file_size));
         }
+#if defined(__linux__)
+        // Some file systems, e.g. tmpfs, don't support O_DIRECT, and the file is written
+        // through the page cache then.
+        void* buf = nullptr;
+        if (opts.direct_io && opts.mode != MUST_EXIST &&
+            fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_DIRECT) == 0 &&
+            posix_memalign(&buf, PosixDirectWritableFile::ALIGNMENT,
+                           PosixDirectWritableFile::BUFFER_SIZE) == 0) {
+            result->reset(new PosixDirectWritableFile(fname, fd, opts.sync_on_close,
+                                                      static_cast<uint8_t*>(buf)));
+            return Status::OK();
+        }
+#endif
         result->reset(new PosixWritableFile(fname, fd, file_size, opts.sync_on_close));
         return Status::OK();
     }
@@ -698,6 +885,22 @@ public:
         }
         return Status::OK();
     }
+
+    Status drop_page_cache(const std::string& fname) override {
+#if defined(__linux__)
+        int fd;
+        RETRY_ON_EINTR(fd, open(fname.c_str(), O_RDONLY));
+        if (fd < 0) {
+            return io_error(fname, errno);
+        }
+        ScopedFdCloser fd_closer(fd);
+        int err = posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        if (err != 0) {
+            return io_error(fname, err);
+        }
+#endif
+        return Status::OK();
+    }
 };
 
 // Default Posix Env
@@ -0,0 +1,271 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "env/io_uring_reader.h"
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter)
+#define DORIS_HAVE_IO_URING 1
+#endif
+#endif
+#endif
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "common/logging.h"
+#include "gutil/strings/substitute.h"
+#include "util/errno.h"
+
+namespace doris {
+
+#ifdef DORIS_HAVE_IO_URING
+
+namespace {
+
+// number of submission queue entries of each ring
+const unsigned kRingEntries = 64;
+
+std::atomic<bool> s_io_uring_disabled{false};
+
+class Ring {
+public:
+    Ring() {}
+    ~Ring();
+
+    // Returns 0 on success, -errno otherwise.
+    int init(unsigned entries);
+
+    Status read(int fd, const RandomAccessFile::ReadRequest* reqs, size_t num, int64_t* results);
+
+private:
+    // Submit 'to_submit' entries and wait for at least 'min_complete' completions.
+    // Returns the number of submitted entries or -errno.
+    int _enter(unsigned to_submit, unsigned min_complete);
+    // Move the finished reads to 'results', returns the number of them.
+    size_t _reap(int64_t* results);
+
+    int _fd = -1;
+    unsigned _entries = 0;
+
+    void* _sq_ptr = MAP_FAILED;
+    size_t _sq_size = 0;
+    void* _cq_ptr = MAP_FAILED;
+    size_t _cq_size = 0;
+    io_uring_sqe* _sqes = static_cast<io_uring_sqe*>(MAP_FAILED);
+    size_t _sqes_size = 0;
+
+    unsigned* _sq_tail = nullptr;
+    unsigned _sq_mask = 0;
+    unsigned* _sq_array = nullptr;
+    unsigned* _cq_head = nullptr;
+    unsigned* _cq_tail = nullptr;
+    unsigned _cq_mask = 0;
+    io_uring_cqe* _cqes = nullptr;
+};
+
+Ring::~Ring() {
+    if (_sqes != MAP_FAILED) {
+        munmap(_sqes, _sqes_size);
+    }
+    if (_cq_ptr != MAP_FAILED && _cq_ptr != _sq_ptr) {
+        munmap(_cq_ptr, _cq_size);
+    }
+    if (_sq_ptr != MAP_FAILED) {
+        munmap(_sq_ptr, _sq_size);
+    }
+    if (_fd >= 0) {
+        close(_fd);
+    }
+}
+
+int Ring::init(unsigned entries) {
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    int fd = syscall(__NR_io_uring_setup, entries, &params);
+    if (fd < 0) {
+        return -errno;
+    }
+    _fd = fd;
+    _entries = params.sq_entries;
+
+    _sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    _cq_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single_mmap) {
+        _sq_size = std::max(_sq_size, _cq_size);
+    }
+    _sq_ptr = mmap(nullptr, _sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _fd,
+                   IORING_OFF_SQ_RING);
+    if (_sq_ptr == MAP_FAILED) {
+        return -errno;
+    }
+    if (single_mmap) {
+        _cq_ptr = _sq_ptr;
+    } else {
+        _cq_ptr = mmap(nullptr, _cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _fd,
+                       IORING_OFF_CQ_RING);
+        if (_cq_ptr == MAP_FAILED) {
+            return -errno;
+        }
+    }
+    _sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+    _sqes = static_cast<io_uring_sqe*>(mmap(nullptr, _sqes_size, PROT_READ | PROT_WRITE,
+                                            MAP_SHARED | MAP_POPULATE, _fd, IORING_OFF_SQES));
+    if (_sqes == MAP_FAILED) {
+        return -errno;
+    }
+
+    char* sq = static_cast<char*>(_sq_ptr);
+    _sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    _sq_mask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    _sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    char* cq = static_cast<char*>(_cq_ptr);
+    _cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    _cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    _cq_mask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    _cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+    return 0;
+}
+
+int Ring::_enter(unsigned to_submit, unsigned min_complete) {
+    int ret = syscall(__NR_io_uring_enter, _fd, to_submit, min_complete, IORING_ENTER_GETEVENTS,
+                      nullptr, 0);
+    return ret < 0 ? -errno : ret;
+}
+
+size_t Ring::_reap(int64_t* results) {
+    unsigned head = *_cq_head;
+    unsigned tail = __atomic_load_n(_cq_tail, __ATOMIC_ACQUIRE);
+    size_t num = 0;
+    for (; head != tail; ++head, ++num) {
+        const io_uring_cqe& cqe = _cqes[head & _cq_mask];
+        results[cqe.user_data] = cqe.res;
+    }
+    __atomic_store_n(_cq_head, head, __ATOMIC_RELEASE);
+    return num;
+}
+
+Status Ring::read(int fd, const RandomAccessFile::ReadRequest* reqs, size_t num,
+                  int64_t* results) {
+    // must stay valid until the kernel has read them
+    std::vector<struct iovec> iovs(num);
+    size_t num_queued = 0;   // put to the submission queue
+    size_t num_pending = 0;  // queued but not consumed by the kernel yet
+    size_t num_inflight = 0; // consumed but not finished
+    size_t num_finished = 0;
+    while (num_finished < num) {
+        // the completion queue has twice as many entries, it never overflows
+        unsigned tail = *_sq_tail;
+        while (num_queued < num && num_pending + num_inflight < _entries) {
+            unsigned index = tail & _sq_mask;
+            io_uring_sqe* sqe = &_sqes[index];
+            memset(sqe, 0, sizeof(*sqe));
+            iovs[num_queued].iov_base = reqs[num_queued].result.data;
+            iovs[num_queued].iov_len = reqs[num_queued].result.size;
+            sqe->opcode = IORING_OP_READV;
+            sqe->fd = fd;
+            sqe->off = reqs[num_queued].offset;
+            sqe->addr = reinterpret_cast<uint64_t>(&iovs[num_queued]);
+            sqe->len = 1;
+            sqe->user_data = num_queued;
+            _sq_array[index] = index;
+            ++tail;
+            ++num_queued;
+            ++num_pending;
+        }
+        __atomic_store_n(_sq_tail, tail, __ATOMIC_RELEASE);
+
+        int ret = _enter(num_pending, 1);
+        if (ret < 0 && ret != -EINTR && ret != -EAGAIN) {
+            // wait for the reads the kernel has consumed, they write to the buffers
+            while (num_inflight > 0) {
+                int wait_ret = _enter(0, 1);
+                if (wait_ret < 0 && wait_ret != -EINTR) {
+                    LOG(FATAL) << "failed to wait io_uring reads: " << errno_to_string(-wait_ret);
+                }
+                num_inflight -= _reap(results);
+            }
+            return Status::IOError(strings::Substitute("io_uring_enter failed: $0",
+                                                       errno_to_string(-ret)));
+        }
+        if (ret > 0) {
+            num_pending -= ret;
+            num_inflight += ret;
+        }
+        size_t num_reaped = _reap(results);
+        num_inflight -= num_reaped;
+        num_finished += num_reaped;
+    }
+    return Status::OK();
+}
+
+Ring* thread_ring() {
+    static thread_local std::unique_ptr<Ring> ring;
+    if (ring == nullptr && !s_io_uring_disabled.load(std::memory_order_relaxed)) {
+        std::unique_ptr<Ring> new_ring(new Ring());
+        int ret = new_ring->init(kRingEntries);
+        if (ret != 0) {
+            if (!s_io_uring_disabled.exchange(true)) {
+                LOG(WARNING) << "io_uring is disabled, failed to set up a ring: "
+                             << errno_to_string(-ret);
+            }
+            return nullptr;
+        }
+        ring = std::move(new_ring);
+    }
+    return ring.get();
+}
+
+} // namespace
+
+bool IoUringReader::is_supported() {
+    return !s_io_uring_disabled.load(std::memory_order_relaxed);
+}
+
+Status IoUringReader::read(int fd, const RandomAccessFile::ReadRequest* reqs, size_t num,
+                           int64_t* results) {
+    Ring* ring = thread_ring();
+    if (ring == nullptr) {
+        return Status::NotSupported("io_uring is not supported");
+    }
+    return ring->read(fd, reqs, num, results);
+}
+
+#else
+
+bool IoUringReader::is_supported() {
+    return false;
+}
+
+Status IoUringReader::read(int fd, const RandomAccessFile::ReadRequest* reqs, size_t num,
+                           int64_t* results) {
+    return Status::NotSupported("io_uring is not supported");
+}
+
+#endif
+
+} // namespace doris
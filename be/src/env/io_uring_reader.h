@@ -0,0 +1,47 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "common/status.h"
+#include "env/env.h"
+
+namespace doris {
+
+// Reads many ranges of a file with one io_uring_enter(2) call, using a ring
+// owned by the calling thread.
+//
+// The ring is set up by raw syscalls, so no library is needed. It's compiled
+// in only when the kernel headers define io_uring, and it's disabled for the
+// whole process if a ring can't be set up, e.g. on kernels older than 5.1.
+class IoUringReader {
+public:
+    // Whether io_uring can be used in this process.
+    static bool is_supported();
+
+    // Read reqs[i] of 'fd' for all i < 'num' and wait until all reads finish.
+    // results[i] is set to the number of bytes read, which may be short, or to
+    // -errno. Returns non-OK if the reads couldn't be submitted, in which case
+    // the content of the buffers is undefined.
+    static Status read(int fd, const RandomAccessFile::ReadRequest* reqs, size_t num,
+                       int64_t* results);
+};
+
+} // namespace doris
@@ -0,0 +1,68 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "exec/agg_result_cache.h"
+
+#include "exprs/scalar_fn_call.h"
+#include "gen_cpp/Exprs_types.h"
+
+namespace doris {
+
+AggResultCache* AggResultCache::_s_instance = nullptr;
+
+void AggResultCache::create_global_cache(size_t capacity) {
+    DCHECK(_s_instance == nullptr);
+    static AggResultCache instance(capacity);
+    _s_instance = &instance;
+}
+
+bool AggResultCache::has_volatile_fn(const std::vector<TExpr>& exprs) {
+    for (auto& expr : exprs) {
+        for (auto& node : expr.nodes) {
+            if (node.__isset.fn && ScalarFnCall::is_volatile_fn(node.fn.name.function_name)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+AggResultCache::AggResultCache(size_t capacity) {
+    _cache.reset(new_lru_cache("AggResultCache", capacity));
+}
+
+bool AggResultCache::lookup(const std::string& key, std::shared_ptr<const Batches>* batches) {
+    auto handle = _cache->lookup(CacheKey(key));
+    if (handle == nullptr) {
+        return false;
+    }
+    *batches = *reinterpret_cast<std::shared_ptr<const Batches>*>(_cache->value(handle));
+    _cache->release(handle);
+    return true;
+}
+
+void AggResultCache::insert(const std::string& key, const std::shared_ptr<const Batches>& batches,
+                            size_t bytes) {
+    auto deleter = [](const doris::CacheKey& key, void* value) {
+        delete reinterpret_cast<std::shared_ptr<const Batches>*>(value);
+    };
+    auto handle = _cache->insert(CacheKey(key), new std::shared_ptr<const Batches>(batches),
+                                 bytes + key.size(), deleter);
+    _cache->release(handle);
+}
+
+} // namespace doris
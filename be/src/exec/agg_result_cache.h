@@ -0,0 +1,74 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gen_cpp/data.pb.h"
+#include "gutil/macros.h" // for DISALLOW_COPY_AND_ASSIGN
+#include "olap/lru_cache.h"
+
+namespace doris {
+
+class TExpr;
+
+// Cache of the output of the aggregations reading an olap scan directly, e.g. the first
+// phase of 'select k1, sum(v1) from t group by k1' in each fragment instance. Dashboards
+// repeat such queries over tablets whose data mostly doesn't change, so an instance whose
+// tablets are at the same versions as last time returns the cached rows instead of
+// scanning and aggregating them again.
+//
+// The key is made by the nodes, see PartitionedAggregationNode::make_cache_key(): it
+// covers the plan of the aggregation and of the scan, the layout of their tuples and the
+// (tablet id, version) of the scan ranges, so a load into a tablet makes its old entries
+// unreachable and they're evicted over time. The value is the output batches serialized
+// as PRowBatch, charged by their serialized size.
+class AggResultCache {
+public:
+    using Batches = std::vector<PRowBatch>;
+
+    // Create global instance of this class.
+    static void create_global_cache(size_t capacity);
+
+    // Return global instance, nullptr if the cache is not created.
+    static AggResultCache* instance() { return _s_instance; }
+
+    // Returns true if 'exprs' call a function whose result isn't determined by its
+    // arguments, the output of such plans is never cached.
+    static bool has_volatile_fn(const std::vector<TExpr>& exprs);
+
+    explicit AggResultCache(size_t capacity);
+
+    // Return true and set 'batches' if the output for 'key' is cached.
+    bool lookup(const std::string& key, std::shared_ptr<const Batches>* batches);
+
+    // Cache the output for 'key', 'bytes' is the serialized size of the batches.
+    void insert(const std::string& key, const std::shared_ptr<const Batches>& batches,
+                size_t bytes);
+
+private:
+    static AggResultCache* _s_instance;
+
+    std::unique_ptr<Cache> _cache;
+
+    DISALLOW_COPY_AND_ASSIGN(AggResultCache);
+};
+
+} // namespace doris
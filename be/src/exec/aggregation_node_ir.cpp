@@ -17,6 +17,7 @@
 
 #include "exec/aggregation_node.h"
 #include "exec/hash_table.hpp"
+#include "exprs/agg_fn_evaluator.h"
 #include "runtime/row_batch.h"
 #include "runtime/runtime_state.h"
 #include "runtime/tuple.h"
@@ -25,9 +26,9 @@
 namespace doris {
 
 void AggregationNode::process_row_batch_no_grouping(RowBatch* batch, MemPool* pool) {
-    for (int i = 0; i < batch->num_rows(); ++i) {
-        update_tuple(_singleton_output_tuple, batch->get_row(i));
-    }
+    // all the rows update the same tuple, so a UDA with a batch form takes them in one call
+    AggFnEvaluator::add_batch(_aggregate_evaluators, _agg_fn_ctxs, batch,
+                              _singleton_output_tuple);
 }
 
 void AggregationNode::process_row_batch_with_grouping(RowBatch* batch, MemPool* pool) {
@@ -19,6 +19,7 @@
 
 #include "exprs/agg_fn_evaluator.h"
 #include "exprs/anyval_util.h"
+#include "runtime/raw_value.h"
 #include "runtime/descriptors.h"
 #include "runtime/row_batch.h"
 #include "runtime/runtime_state.h"
@@ -139,6 +140,7 @@ Status AnalyticEvalNode::init(const TPlanNode& tnode, RuntimeState* state) {
 
 Status AnalyticEvalNode::prepare(RuntimeState* state) {
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_CPU_TIMER(_cpu_timer);
     RETURN_IF_ERROR(ExecNode::prepare(state));
     DCHECK(child(0)->row_desc().is_prefix_of(row_desc()));
     _child_tuple_desc = child(0)->row_desc().tuple_descriptors()[0];
@@ -184,6 +186,7 @@ Status AnalyticEvalNode::prepare(RuntimeState* state) {
 
 Status AnalyticEvalNode::open(RuntimeState* state) {
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_CPU_TIMER(_cpu_timer);
     RETURN_IF_ERROR(ExecNode::open(state));
     RETURN_IF_CANCELLED(state);
     //RETURN_IF_ERROR(QueryMaintenance(state));
@@ -217,7 +220,17 @@ Status AnalyticEvalNode::open(RuntimeState* state) {
             VLOG_FILE << id() << " FIRST_VAL rewrite null offset: " << _first_val_null_offset;
             _has_first_val_null_offset = true;
         }
+
+        const AggFnEvaluator* evaluator = _evaluators[i];
+        _reset_on_remove.push_back(!evaluator->has_remove_fn());
+        _has_min_max_window.push_back(
+                _reset_on_remove.back() &&
+                (evaluator->agg_op() == AggFnEvaluator::MIN ||
+                 evaluator->agg_op() == AggFnEvaluator::MAX) &&
+                evaluator->input_expr_ctxs().size() == 1 &&
+                evaluator->input_expr_ctxs()[0]->root()->is_slotref());
     }
+    _min_max_windows.resize(_evaluators.size());
 
     if (_partition_by_eq_expr_ctx != NULL) {
         RETURN_IF_ERROR(_partition_by_eq_expr_ctx->open(state));
@@ -437,11 +450,71 @@ inline void AnalyticEvalNode::try_remove_rows_before_window(int64_t stream_idx)
     DCHECK(!_window_tuples.empty()) << debug_state_string(true);
     DCHECK_EQ(remove_idx + std::max(_rows_start_offset, 0L), _window_tuples.front().first)
             << debug_state_string(true);
+    remove_window_front();
+}
+
+void AnalyticEvalNode::remove_window_front() {
+    DCHECK(!_window_tuples.empty());
+    int64_t remove_idx = _window_tuples.front().first;
     TupleRow* remove_row = reinterpret_cast<TupleRow*>(&_window_tuples.front().second);
-    AggFnEvaluator::remove(_evaluators, _fn_ctxs, remove_row, _curr_tuple);
+
+    for (int i = 0; i < _evaluators.size(); ++i) {
+        if (!_reset_on_remove[i]) {
+            _evaluators[i]->remove(_fn_ctxs[i], remove_row, _curr_tuple);
+            continue;
+        }
+        // Call finalize to release resources, as in init_next_partition().
+        _evaluators[i]->finalize(_fn_ctxs[i], _curr_tuple, _dummy_result_tuple);
+        _evaluators[i]->init(_fn_ctxs[i], _curr_tuple);
+        if (_has_min_max_window[i]) {
+            std::deque<std::pair<int64_t, Tuple*>>& window = _min_max_windows[i];
+            if (!window.empty() && window.front().first == remove_idx) {
+                window.pop_front();
+            }
+            if (!window.empty()) {
+                _evaluators[i]->add(_fn_ctxs[i],
+                                    reinterpret_cast<TupleRow*>(&window.front().second),
+                                    _curr_tuple);
+            }
+        } else {
+            std::list<std::pair<int64_t, Tuple*>>::iterator it = _window_tuples.begin();
+            for (++it; it != _window_tuples.end(); ++it) {
+                _evaluators[i]->add(_fn_ctxs[i], reinterpret_cast<TupleRow*>(&it->second),
+                                    _curr_tuple);
+            }
+        }
+    }
     _window_tuples.pop_front();
 }
 
+void AnalyticEvalNode::add_to_min_max_windows(int64_t stream_idx, Tuple* tuple) {
+    for (int i = 0; i < _evaluators.size(); ++i) {
+        if (!_has_min_max_window[i]) {
+            continue;
+        }
+        // the input is a slot, so values point into the window tuples and stay valid
+        ExprContext* input_ctx = _evaluators[i]->input_expr_ctxs()[0];
+        const TypeDescriptor& type = input_ctx->root()->type();
+        void* value = input_ctx->get_value(reinterpret_cast<TupleRow*>(&tuple));
+        if (value == NULL) {
+            continue;
+        }
+        // Tuples before this one which are not better can never be the result again.
+        bool is_min = _evaluators[i]->agg_op() == AggFnEvaluator::MIN;
+        std::deque<std::pair<int64_t, Tuple*>>& window = _min_max_windows[i];
+        while (!window.empty()) {
+            void* back_value =
+                    input_ctx->get_value(reinterpret_cast<TupleRow*>(&window.back().second));
+            int cmp = RawValue::compare(back_value, value, type);
+            if (is_min ? cmp < 0 : cmp > 0) {
+                break;
+            }
+            window.pop_back();
+        }
+        window.push_back(std::pair<int64_t, Tuple*>(stream_idx, tuple));
+    }
+}
+
 inline void AnalyticEvalNode::try_add_remaining_results(int64_t partition_idx,
                                                         int64_t prev_partition_idx) {
     DCHECK_LT(prev_partition_idx, partition_idx);
@@ -483,9 +556,7 @@ inline void AnalyticEvalNode::try_add_remaining_results(int64_t partition_idx,
             // and add the result tuple at the next index.
             VLOG_ROW << id() << " Remove window_row_idx=" << _window_tuples.front().first
                      << " for result row at idx=" << next_result_idx;
-            TupleRow* remove_row = reinterpret_cast<TupleRow*>(&_window_tuples.front().second);
-            AggFnEvaluator::remove(_evaluators, _fn_ctxs, remove_row, _curr_tuple);
-            _window_tuples.pop_front();
+            remove_window_front();
         }
 
         add_result_tuple(_last_result_idx + 1);
@@ -545,6 +616,9 @@ inline void AnalyticEvalNode::init_next_partition(int64_t stream_idx) {
     }
 
     _window_tuples.clear();
+    for (int i = 0; i < _min_max_windows.size(); ++i) {
+        _min_max_windows[i].clear();
+    }
 
     // Re-initialize _curr_tuple.
     VLOG_ROW << id() << " Reset curr_tuple";
@@ -669,6 +743,7 @@ Status AnalyticEvalNode::process_child_batch(RuntimeState* state) {
                 Tuple* tuple =
                         row->get_tuple(0)->deep_copy(*_child_tuple_desc, _curr_tuple_pool.get());
                 _window_tuples.push_back(std::pair<int64_t, Tuple*>(stream_idx, tuple));
+                add_to_min_max_windows(stream_idx, tuple);
                 last_window_tuple_idx = stream_idx;
             }
         }
@@ -806,6 +881,7 @@ inline int64_t AnalyticEvalNode::num_output_rows_ready() const {
 
 Status AnalyticEvalNode::get_next(RuntimeState* state, RowBatch* row_batch, bool* eos) {
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_CPU_TIMER(_cpu_timer);
     RETURN_IF_ERROR(exec_debug_action(TExecNodePhase::GETNEXT));
     RETURN_IF_CANCELLED(state);
     //RETURN_IF_ERROR(QueryMaintenance(state));
@@ -18,6 +18,8 @@
 #ifndef INF_DORIS_BE_SRC_EXEC_ANALYTIC_EVAL_NODE_H
 #define INF_DORIS_BE_SRC_EXEC_ANALYTIC_EVAL_NODE_H
 
+#include <deque>
+
 #include "exec/exec_node.h"
 #include "exprs/expr.h"
 //#include "exprs/expr_context.h"
@@ -151,6 +153,15 @@ private:
     // process_child_batch().
     void try_remove_rows_before_window(int64_t stream_idx);
 
+    // Removes the first tuple of _window_tuples from _curr_tuple. Evaluators without a
+    // remove fn are reset to the rest of the window: min() and max() of a slot to the
+    // front of their monotonic queue in _min_max_windows, the others by adding the
+    // remaining window tuples again.
+    void remove_window_front();
+
+    // Adds the window tuple at stream_idx to the monotonic queues of _min_max_windows.
+    void add_to_min_max_windows(int64_t stream_idx, Tuple* tuple);
+
     // Initializes state at the start of a new partition. stream_idx is the index of the
     // current input row from _input_stream.
     void init_next_partition(int64_t stream_idx);
@@ -258,6 +269,20 @@ private:
     std::list<std::pair<int64_t, Tuple*>> _window_tuples;
     TupleDescriptor* _child_tuple_desc;
 
+    // Indicates if each evaluator has no remove fn, and is reset by remove_window_front()
+    // when a tuple leaves the window.
+    std::vector<bool> _reset_on_remove;
+
+    // Indicates if each evaluator is min() or max() of a slot, whose window is kept in
+    // its queue of _min_max_windows.
+    std::vector<bool> _has_min_max_window;
+
+    // For each min() or max() evaluator, the window tuples whose input value is better
+    // than that of all later ones in the window, in the order of _window_tuples. So the
+    // front holds the result of the window and is the only one that may be removed, each
+    // tuple is added and removed at most once. Non null values only.
+    std::vector<std::deque<std::pair<int64_t, Tuple*>>> _min_max_windows;
+
     // Pools used to allocate result tuples (added to _result_tuples and later returned)
     // and window tuples (added to _window_tuples to buffer the current window). Resources
     // are transferred from _curr_tuple_pool to _prev_tuple_pool once it is at least
@@ -0,0 +1,174 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "exec/async_decompress_reader.h"
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+
+#include "exec/decompressor.h"
+
+namespace doris {
+
+// the size of the data read from the file at a time
+static const size_t INPUT_CHUNK = 2 * 1024 * 1024;
+// the size of the decompressed chunks
+static const size_t OUTPUT_CHUNK = 1024 * 1024;
+// the number of decompressed chunks that can be ahead of the reader
+static const size_t MAX_QUEUED_CHUNKS = 4;
+
+AsyncDecompressReader::AsyncDecompressReader(RuntimeProfile* profile, FileReader* file_reader,
+                                             Decompressor* decompressor)
+        : _file_reader(file_reader), _decompressor(decompressor), _chunks(MAX_QUEUED_CHUNKS) {
+    _bytes_decompress_counter = ADD_COUNTER(profile, "BytesDecompressed", TUnit::BYTES);
+    _decompress_timer = ADD_TIMER(profile, "DecompressTime");
+}
+
+AsyncDecompressReader::~AsyncDecompressReader() {
+    close();
+}
+
+Status AsyncDecompressReader::open() {
+    _thread = std::thread(&AsyncDecompressReader::_decompress, this);
+    return Status::OK();
+}
+
+void AsyncDecompressReader::close() {
+    if (_closed) {
+        return;
+    }
+    _chunks.shutdown();
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+    _closed = true;
+}
+
+Status AsyncDecompressReader::read(uint8_t* buf, size_t* buf_len, bool* eof) {
+    size_t len = 0;
+    while (len < *buf_len) {
+        if (_chunk == nullptr || _chunk_pos == _chunk->data.size()) {
+            if (_chunk != nullptr && _chunk->eof) {
+                break;
+            }
+            if (len > 0) {
+                // return what is decompressed instead of waiting for more
+                break;
+            }
+            if (!_chunks.blocking_get(&_chunk)) {
+                return Status::Cancelled("decompress reader is closed");
+            }
+            _chunk_pos = 0;
+            if (_chunk->eof) {
+                RETURN_IF_ERROR(_chunk->status);
+            }
+            continue;
+        }
+        size_t n = std::min(*buf_len - len, _chunk->data.size() - _chunk_pos);
+        memcpy(buf + len, _chunk->data.data() + _chunk_pos, n);
+        _chunk_pos += n;
+        len += n;
+    }
+    *buf_len = len;
+    *eof = len == 0;
+    return Status::OK();
+}
+
+void AsyncDecompressReader::_decompress() {
+    Status status = _decompress_chunks();
+    std::shared_ptr<Chunk> chunk(new Chunk());
+    chunk->eof = true;
+    chunk->status = status;
+    _chunks.blocking_put(chunk);
+}
+
+// like PlainTextLineReader::read_line(), which reads the compressed data this way when it
+// decompresses the data itself.
+Status AsyncDecompressReader::_decompress_chunks() {
+    std::vector<uint8_t> input(INPUT_CHUNK);
+    size_t input_pos = 0;
+    size_t input_limit = 0;
+    size_t output_size = OUTPUT_CHUNK;
+    bool stream_end = true;
+    size_t more_input_bytes = 0;
+    size_t more_output_bytes = 0;
+    while (true) {
+        if (input_pos == input_limit || more_input_bytes > 0) {
+            // keep the data that is not decompressed yet at the beginning of the input
+            memmove(input.data(), input.data() + input_pos, input_limit - input_pos);
+            input_limit -= input_pos;
+            input_pos = 0;
+            if (input.size() - input_limit < more_input_bytes) {
+                input.resize(input_limit + more_input_bytes);
+            }
+            size_t read_len = input.size() - input_limit;
+            bool file_eof = false;
+            RETURN_IF_ERROR(_file_reader->read(input.data() + input_limit, &read_len, &file_eof));
+            if (file_eof || read_len == 0) {
+                if (!stream_end) {
+                    return Status::InternalError(
+                            "Compressed file has been truncated, which is not allowed");
+                }
+                return Status::OK();
+            }
+            input_limit += read_len;
+            if (read_len < more_input_bytes) {
+                more_input_bytes -= read_len;
+                continue;
+            }
+        }
+
+        std::shared_ptr<Chunk> chunk(new Chunk());
+        if (more_output_bytes > 0) {
+            output_size += more_output_bytes;
+        }
+        chunk->data.resize(output_size);
+        size_t input_read_bytes = 0;
+        size_t decompressed_len = 0;
+        more_input_bytes = 0;
+        more_output_bytes = 0;
+        {
+            SCOPED_TIMER(_decompress_timer);
+            RETURN_IF_ERROR(_decompressor->decompress(
+                    input.data() + input_pos, input_limit - input_pos, &input_read_bytes,
+                    chunk->data.data(), output_size, &decompressed_len, &stream_end,
+                    &more_input_bytes, &more_output_bytes));
+        }
+        input_pos += input_read_bytes;
+        COUNTER_UPDATE(_bytes_decompress_counter, decompressed_len);
+
+        if (input_read_bytes == 0 && more_input_bytes == 0 && more_output_bytes == 0) {
+            std::stringstream ss;
+            ss << "decompress made no progress."
+               << " input_read_bytes: " << input_read_bytes
+               << " decompressed_len: " << decompressed_len;
+            LOG(WARNING) << ss.str();
+            return Status::InternalError(ss.str());
+        }
+        if (decompressed_len > 0) {
+            chunk->data.resize(decompressed_len);
+            if (!_chunks.blocking_put(chunk)) {
+                // closed by the reader
+                return Status::OK();
+            }
+        }
+    }
+}
+
+} // namespace doris
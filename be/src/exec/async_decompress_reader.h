@@ -0,0 +1,92 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#pragma once
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "common/status.h"
+#include "exec/file_reader.h"
+#include "util/blocking_queue.hpp"
+#include "util/runtime_profile.h"
+
+namespace doris {
+
+class Decompressor;
+
+// Reads the data decompressed from 'file_reader' by 'decompressor', which are decompressed
+// ahead on a helper thread. The decompressed data is read in order, it's passed to read()
+// in chunks through a bounded queue, so decompressing a chunk overlaps with the caller
+// consuming the previous ones. Doesn't own 'file_reader' and 'decompressor', which are
+// only used by the helper thread until close().
+class AsyncDecompressReader : public FileReader {
+public:
+    AsyncDecompressReader(RuntimeProfile* profile, FileReader* file_reader,
+                          Decompressor* decompressor);
+    ~AsyncDecompressReader() override;
+
+    // Starts the helper thread.
+    Status open() override;
+
+    Status read(uint8_t* buf, size_t* buf_len, bool* eof) override;
+
+    Status readat(int64_t position, int64_t nbytes, int64_t* bytes_read, void* out) override {
+        return Status::NotSupported("Not supported readat");
+    }
+    Status read_one_message(uint8_t** buf, size_t* length) override {
+        return Status::NotSupported("Not supported read_one_message");
+    }
+    int64_t size() override { return -1; }
+    Status seek(int64_t position) override { return Status::NotSupported("Not supported seek"); }
+    Status tell(int64_t* position) override { return Status::NotSupported("Not supported tell"); }
+
+    // Stops and joins the helper thread.
+    void close() override;
+    bool closed() override { return _closed; }
+
+private:
+    // Decompressed data, or the status that ended the decompression if 'eof'.
+    struct Chunk {
+        std::vector<uint8_t> data;
+        bool eof = false;
+        Status status;
+    };
+
+    // run by the helper thread
+    void _decompress();
+    Status _decompress_chunks();
+
+    FileReader* _file_reader;
+    Decompressor* _decompressor;
+    bool _closed = false;
+
+    BlockingQueue<std::shared_ptr<Chunk>> _chunks;
+    std::thread _thread;
+
+    // the chunk being read and the read position in it
+    std::shared_ptr<Chunk> _chunk;
+    size_t _chunk_pos = 0;
+
+    // the time the caller waits for the decompressed data is the read time of the caller
+    RuntimeProfile::Counter* _bytes_decompress_counter;
+    RuntimeProfile::Counter* _decompress_timer;
+};
+
+} // namespace doris
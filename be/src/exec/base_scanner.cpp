@@ -17,7 +17,13 @@
 
 #include "base_scanner.h"
 
+#include <algorithm>
+#include <map>
+
 #include "common/logging.h"
+#include "exprs/expr_context.h"
+#include "exprs/slot_ref.h"
+#include "exprs/subexpr_cache.h"
 #include "runtime/descriptors.h"
 #include "runtime/mem_tracker.h"
 #include "runtime/raw_value.h"
@@ -41,6 +47,7 @@ BaseScanner::BaseScanner(RuntimeState* state, RuntimeProfile* profile,
 #endif
           _mem_pool(_mem_tracker.get()),
           _dest_tuple_desc(nullptr),
+          _subexpr_cache(nullptr),
           _strict_mode(false),
           _profile(profile),
           _rows_read_counter(nullptr),
@@ -102,6 +109,7 @@ Status BaseScanner::init_expr_ctxes() {
     }
 
     bool has_slot_id_map = _params.__isset.dest_sid_to_src_sid_without_trans;
+    std::vector<TExpr> dest_texprs;
     for (auto slot_desc : _dest_tuple_desc->slots()) {
         if (!slot_desc->is_materialized()) {
             continue;
@@ -118,6 +126,7 @@ Status BaseScanner::init_expr_ctxes() {
         RETURN_IF_ERROR(ctx->prepare(_state, *_row_desc.get(), _mem_tracker));
         RETURN_IF_ERROR(ctx->open(_state));
         _dest_expr_ctx.emplace_back(ctx);
+        dest_texprs.push_back(it->second);
         if (has_slot_id_map) {
             auto it = _params.dest_sid_to_src_sid_without_trans.find(slot_desc->id());
             if (it == std::end(_params.dest_sid_to_src_sid_without_trans)) {
@@ -133,10 +142,123 @@ Status BaseScanner::init_expr_ctxes() {
             }
         }
     }
+    _subexpr_cache = SubexprCache::create(_state->obj_pool(), dest_texprs, _dest_expr_ctx);
     return Status::OK();
 }
 
+void BaseScanner::init_file_column_predicates(const std::vector<ExprContext*>& conjunct_ctxs,
+                                              std::vector<FileColumnPredicate>* predicates) {
+    // the src slot each dest slot is loaded from without a transformation
+    std::map<SlotId, std::pair<SlotDescriptor*, SlotDescriptor*>> dest_to_src;
+    int dest_index = 0;
+    for (auto slot_desc : _dest_tuple_desc->slots()) {
+        if (!slot_desc->is_materialized()) {
+            continue;
+        }
+        if (dest_index < _src_slot_descs_order_by_dest.size() &&
+            _src_slot_descs_order_by_dest[dest_index] != nullptr) {
+            dest_to_src[slot_desc->id()] =
+                    std::make_pair(slot_desc, _src_slot_descs_order_by_dest[dest_index]);
+        }
+        ++dest_index;
+    }
+    for (auto ctx : conjunct_ctxs) {
+        Expr* expr = ctx->root();
+        if (expr->node_type() != TExprNodeType::BINARY_PRED || expr->get_num_children() != 2) {
+            continue;
+        }
+        FileColumnPredicate pred;
+        pred.op = expr->op();
+        Expr* slot_ref = expr->get_child(0);
+        Expr* value = expr->get_child(1);
+        if (!slot_ref->is_slotref()) {
+            std::swap(slot_ref, value);
+            if (pred.op == TExprOpcode::LT) {
+                pred.op = TExprOpcode::GT;
+            } else if (pred.op == TExprOpcode::LE) {
+                pred.op = TExprOpcode::GE;
+            } else if (pred.op == TExprOpcode::GT) {
+                pred.op = TExprOpcode::LT;
+            } else if (pred.op == TExprOpcode::GE) {
+                pred.op = TExprOpcode::LE;
+            }
+        }
+        if (pred.op != TExprOpcode::EQ && pred.op != TExprOpcode::NE &&
+            pred.op != TExprOpcode::LT && pred.op != TExprOpcode::LE &&
+            pred.op != TExprOpcode::GT && pred.op != TExprOpcode::GE) {
+            continue;
+        }
+        if (!slot_ref->is_slotref() || !value->is_constant()) {
+            continue;
+        }
+        auto it = dest_to_src.find(static_cast<SlotRef*>(slot_ref)->slot_id());
+        if (it == dest_to_src.end()) {
+            continue;
+        }
+        SlotDescriptor* dest_slot = it->second.first;
+        auto src_it = std::find(_src_slot_descs.begin(), _src_slot_descs.end(), it->second.second);
+        pred.type = dest_slot->type().type;
+        if (src_it == _src_slot_descs.end() || slot_ref->type().type != pred.type ||
+            value->type().type != pred.type) {
+            continue;
+        }
+        pred.column = src_it - _src_slot_descs.begin();
+        pred.nullable = dest_slot->is_nullable();
+
+        bool is_null = false;
+        switch (pred.type) {
+        case TYPE_TINYINT: {
+            TinyIntVal val = value->get_tiny_int_val(ctx, nullptr);
+            is_null = val.is_null;
+            pred.int_value = val.val;
+            break;
+        }
+        case TYPE_SMALLINT: {
+            SmallIntVal val = value->get_small_int_val(ctx, nullptr);
+            is_null = val.is_null;
+            pred.int_value = val.val;
+            break;
+        }
+        case TYPE_INT: {
+            IntVal val = value->get_int_val(ctx, nullptr);
+            is_null = val.is_null;
+            pred.int_value = val.val;
+            break;
+        }
+        case TYPE_BIGINT: {
+            BigIntVal val = value->get_big_int_val(ctx, nullptr);
+            is_null = val.is_null;
+            pred.int_value = val.val;
+            break;
+        }
+        case TYPE_DATE:
+        case TYPE_DATETIME: {
+            DateTimeVal val = value->get_datetime_val(ctx, nullptr);
+            is_null = val.is_null;
+            pred.date_value = DateTimeValue::from_datetime_val(val);
+            break;
+        }
+        case TYPE_VARCHAR: {
+            StringVal val = value->get_string_val(ctx, nullptr);
+            is_null = val.is_null;
+            if (!is_null) {
+                pred.string_value.assign(reinterpret_cast<char*>(val.ptr), val.len);
+            }
+            break;
+        }
+        default:
+            continue;
+        }
+        if (!is_null) {
+            predicates->push_back(pred);
+        }
+    }
+}
+
 bool BaseScanner::fill_dest_tuple(Tuple* dest_tuple, MemPool* mem_pool) {
+    if (_subexpr_cache != nullptr) {
+        _subexpr_cache->next_row();
+    }
     int ctx_idx = 0;
     for (auto slot_desc : _dest_tuple_desc->slots()) {
         if (!slot_desc->is_materialized()) {
@@ -18,8 +18,14 @@
 #ifndef BE_SRC_EXEC_BASE_SCANNER_H_
 #define BE_SRC_EXEC_BASE_SCANNER_H_
 
+#include <string>
+#include <vector>
+
 #include "common/status.h"
 #include "exprs/expr.h"
+#include "gen_cpp/Opcodes_types.h"
+#include "runtime/datetime_value.h"
+#include "runtime/primitive_type.h"
 #include "runtime/tuple.h"
 #include "util/runtime_profile.h"
 
@@ -32,6 +38,7 @@ class RowDescriptor;
 class MemTracker;
 class RuntimeState;
 class ExprContext;
+class SubexprCache;
 
 struct ScannerCounter {
     ScannerCounter() : num_rows_filtered(0), num_rows_unselected(0) {}
@@ -40,6 +47,45 @@ struct ScannerCounter {
     int64_t num_rows_unselected; // rows filtered by predicates
 };
 
+// A conjunct of the scan that compares a column read from the file with a constant,
+// e.g. 'k1 >= 10'. The readers of the columnar formats skip the row groups or stripes
+// whose statistics show that none of their rows matches it.
+struct FileColumnPredicate {
+    // the index of the column in the columns read from the file
+    int column = 0;
+    // EQ, NE, LT, LE, GT or GE, the column is on the left side
+    TExprOpcode::type op = TExprOpcode::EQ;
+    // the type of the dest slot the column is loaded into, which is the type of the value
+    PrimitiveType type = INVALID_TYPE;
+    // whether the dest slot is nullable, the nulls in a not nullable slot are errors
+    bool nullable = true;
+    int64_t int_value = 0;    // TYPE_TINYINT to TYPE_BIGINT
+    DateTimeValue date_value; // TYPE_DATE and TYPE_DATETIME
+    std::string string_value; // TYPE_VARCHAR
+
+    // Whether a column whose values are within [min, max] may have a value v for which
+    // 'v op value' holds. 'cmp_min' and 'cmp_max' are the results of comparing min and
+    // max with the value.
+    bool may_match(int cmp_min, int cmp_max) const {
+        switch (op) {
+        case TExprOpcode::EQ:
+            return cmp_min <= 0 && cmp_max >= 0;
+        case TExprOpcode::NE:
+            return cmp_min != 0 || cmp_max != 0;
+        case TExprOpcode::LT:
+            return cmp_min < 0;
+        case TExprOpcode::LE:
+            return cmp_min <= 0;
+        case TExprOpcode::GT:
+            return cmp_max > 0;
+        case TExprOpcode::GE:
+            return cmp_max >= 0;
+        default:
+            return true;
+        }
+    }
+};
+
 class BaseScanner {
 public:
     BaseScanner(RuntimeState* state, RuntimeProfile* profile, const TBrokerScanRangeParams& params,
@@ -61,6 +107,11 @@ public:
                                          const std::vector<std::string>& columns_from_path);
 
 protected:
+    // Collects the conjuncts that compare a dest slot loaded as is from a column of the
+    // file with a constant. Must be called after open().
+    void init_file_column_predicates(const std::vector<ExprContext*>& conjunct_ctxs,
+                                     std::vector<FileColumnPredicate>* predicates);
+
     RuntimeState* _state;
     const TBrokerScanRangeParams& _params;
     // used for process stat
@@ -80,6 +131,8 @@ protected:
     // Dest tuple descriptor and dest expr context
     const TupleDescriptor* _dest_tuple_desc;
     std::vector<ExprContext*> _dest_expr_ctx;
+    // shares the function calls common to the dest exprs, nullptr if there are none
+    SubexprCache* _subexpr_cache;
     // the map values of dest slot id to src slot desc
     // if there is not key of dest slot id in dest_sid_to_src_sid_without_trans, it will be set to nullptr
     std::vector<SlotDescriptor*> _src_slot_descs_order_by_dest;
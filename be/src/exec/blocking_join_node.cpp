@@ -43,6 +43,7 @@ BlockingJoinNode::~BlockingJoinNode() {
 
 Status BlockingJoinNode::prepare(RuntimeState* state) {
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_CPU_TIMER(_cpu_timer);
     RETURN_IF_ERROR(ExecNode::prepare(state));
 
     _build_pool.reset(new MemPool(mem_tracker().get()));
@@ -91,6 +92,7 @@ void BlockingJoinNode::build_side_thread(RuntimeState* state, boost::promise<Sta
 Status BlockingJoinNode::open(RuntimeState* state) {
     RETURN_IF_ERROR(ExecNode::open(state));
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_CPU_TIMER(_cpu_timer);
     // RETURN_IF_ERROR(Expr::open(_conjuncts, state));
 
     RETURN_IF_CANCELLED(state);
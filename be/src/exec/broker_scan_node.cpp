@@ -17,9 +17,12 @@
 
 #include "exec/broker_scan_node.h"
 
+#include <algorithm>
 #include <chrono>
+#include <functional>
 #include <sstream>
 
+#include "common/config.h"
 #include "common/object_pool.h"
 #include "exec/broker_scanner.h"
 #include "exec/json_scanner.h"
@@ -27,8 +30,12 @@
 #include "exec/parquet_scanner.h"
 #include "exprs/expr.h"
 #include "runtime/dpp_sink_internal.h"
+#include "runtime/exec_env.h"
 #include "runtime/row_batch.h"
 #include "runtime/runtime_state.h"
+#include "runtime/stream_load/load_stream_mgr.h"
+#include "runtime/stream_load/stream_load_pipe.h"
+#include "util/fair_thread_pool.h"
 #include "util/runtime_profile.h"
 
 namespace doris {
@@ -40,8 +47,12 @@ BrokerScanNode::BrokerScanNode(ObjectPool* pool, const TPlanNode& tnode, const D
           _tuple_desc(nullptr),
           _num_running_scanners(0),
           _scan_finished(false),
+          _next_scan_unit(0),
+          _scan_thread_pool(nullptr),
           _max_buffered_batches(32),
-          _wait_scanner_timer(nullptr) {}
+          _next_chunk_seq(0),
+          _wait_scanner_timer(nullptr),
+          _scanner_queue_wait_timer(nullptr) {}
 
 BrokerScanNode::~BrokerScanNode() {}
 
@@ -101,12 +112,14 @@ Status BrokerScanNode::prepare(RuntimeState* state) {
 
     // Profile
     _wait_scanner_timer = ADD_TIMER(runtime_profile(), "WaitScannerTime");
+    _scanner_queue_wait_timer = ADD_TIMER(runtime_profile(), "ScannerQueueWaitTime");
 
     return Status::OK();
 }
 
 Status BrokerScanNode::open(RuntimeState* state) {
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_CPU_TIMER(_cpu_timer);
     RETURN_IF_ERROR(ExecNode::open(state));
     RETURN_IF_ERROR(exec_debug_action(TExecNodePhase::OPEN));
     RETURN_IF_CANCELLED(state);
@@ -125,16 +138,95 @@ Status BrokerScanNode::open(RuntimeState* state) {
 }
 
 Status BrokerScanNode::start_scanners() {
+    std::shared_ptr<StreamLoadPipe> stream = get_parallel_stream();
+    int num_scanners = 1;
+    if (stream != nullptr) {
+        num_scanners = config::stream_load_parse_threads;
+    } else {
+        split_scan_ranges();
+        _scan_thread_pool = get_scan_thread_pool();
+        if (_scan_thread_pool != nullptr) {
+            num_scanners = std::max<int64_t>(
+                    1, std::min<int64_t>(config::broker_scan_node_max_scanners,
+                                         _scan_units.size()));
+        }
+    }
     {
         std::unique_lock<std::mutex> l(_batch_queue_lock);
-        _num_running_scanners = 1;
+        _num_running_scanners = num_scanners;
+    }
+    for (int i = 0; i < num_scanners; ++i) {
+        _scanner_slots.emplace_back(new ScannerSlot());
+        ScannerSlot* slot = _scanner_slots.back().get();
+        if (_scan_thread_pool == nullptr) {
+            _scanner_threads.emplace_back(&BrokerScanNode::scanner_worker, this, slot, stream);
+        } else if (!offer_scanner_task(slot)) {
+            finish_scanner(slot, Status::InternalError("broker scanner thread pool is shut down"));
+        }
     }
-    _scanner_threads.emplace_back(&BrokerScanNode::scanner_worker, this, 0, _scan_ranges.size());
     return Status::OK();
 }
 
+void BrokerScanNode::split_scan_ranges() {
+    int64_t split_bytes = config::broker_scan_split_bytes;
+    for (const auto& scan_range_params : _scan_ranges) {
+        const TBrokerScanRange& scan_range = scan_range_params.scan_range.broker_scan_range;
+        for (const auto& range : scan_range.ranges) {
+            int64_t size = range.size;
+            if (size < 0 && range.__isset.file_size) {
+                size = range.file_size - range.start_offset;
+            }
+            // a range is read from the line after its start to the line across its end, so
+            // a split doesn't lose or repeat any line
+            bool splittable = split_bytes > 0 && size > split_bytes && range.splittable &&
+                              range.format_type == TFileFormatType::FORMAT_CSV_PLAIN &&
+                              range.file_type != TFileType::FILE_STREAM;
+            int64_t offset = 0;
+            do {
+                TBrokerScanRange unit;
+                unit.__set_params(scan_range.params);
+                unit.__set_broker_addresses(scan_range.broker_addresses);
+                unit.ranges.push_back(range);
+                if (splittable) {
+                    unit.ranges[0].start_offset = range.start_offset + offset;
+                    unit.ranges[0].size = std::min(split_bytes, size - offset);
+                    offset += split_bytes;
+                }
+                _scan_units.push_back(std::move(unit));
+            } while (splittable && offset < size);
+        }
+    }
+}
+
+FairThreadPool* BrokerScanNode::get_scan_thread_pool() {
+    if (_runtime_state->exec_env() == nullptr) {
+        return nullptr;
+    }
+    for (const auto& unit : _scan_units) {
+        if (unit.ranges[0].file_type == TFileType::FILE_STREAM) {
+            return nullptr;
+        }
+    }
+    return _runtime_state->exec_env()->broker_scan_thread_pool();
+}
+
+std::shared_ptr<StreamLoadPipe> BrokerScanNode::get_parallel_stream() {
+    if (config::stream_load_parse_threads <= 1 || _scan_ranges.size() != 1) {
+        return nullptr;
+    }
+    const TBrokerScanRange& scan_range = _scan_ranges[0].scan_range.broker_scan_range;
+    // a compressed stream can't be split at the lines
+    if (scan_range.ranges.size() != 1 ||
+        scan_range.ranges[0].file_type != TFileType::FILE_STREAM ||
+        scan_range.ranges[0].format_type != TFileFormatType::FORMAT_CSV_PLAIN) {
+        return nullptr;
+    }
+    return _runtime_state->exec_env()->load_stream_mgr()->get(scan_range.ranges[0].load_id);
+}
+
 Status BrokerScanNode::get_next(RuntimeState* state, RowBatch* row_batch, bool* eos) {
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_CPU_TIMER(_cpu_timer);
     // check if CANCELLED.
     if (state->is_cancelled()) {
         std::unique_lock<std::mutex> l(_batch_queue_lock);
@@ -220,12 +312,20 @@ Status BrokerScanNode::close(RuntimeState* state) {
     }
     RETURN_IF_ERROR(exec_debug_action(TExecNodePhase::CLOSE));
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_CPU_TIMER(_cpu_timer);
     _scan_finished.store(true);
     _queue_writer_cond.notify_all();
     _queue_reader_cond.notify_all();
     for (int i = 0; i < _scanner_threads.size(); ++i) {
         _scanner_threads[i].join();
     }
+    {
+        // wait for the scanners in the shared thread pool
+        std::unique_lock<std::mutex> l(_batch_queue_lock);
+        while (_num_running_scanners > 0) {
+            _queue_reader_cond.wait(l);
+        }
+    }
 
     // Close partition
     if (_partition_expr_ctxs.size() > 0) {
@@ -262,17 +362,20 @@ void BrokerScanNode::debug_string(int ident_level, std::stringstream* out) const
     (*out) << "BrokerScanNode";
 }
 
-std::unique_ptr<BaseScanner> BrokerScanNode::create_scanner(const TBrokerScanRange& scan_range,
-                                                            ScannerCounter* counter) {
+std::unique_ptr<BaseScanner> BrokerScanNode::create_scanner(
+        const TBrokerScanRange& scan_range, const std::vector<ExprContext*>& conjunct_ctxs,
+        ScannerCounter* counter) {
     BaseScanner* scan = nullptr;
     switch (scan_range.ranges[0].format_type) {
     case TFileFormatType::FORMAT_PARQUET:
         scan = new ParquetScanner(_runtime_state, runtime_profile(), scan_range.params,
-                                  scan_range.ranges, scan_range.broker_addresses, counter);
+                                  scan_range.ranges, scan_range.broker_addresses, counter,
+                                  conjunct_ctxs);
         break;
     case TFileFormatType::FORMAT_ORC:
         scan = new ORCScanner(_runtime_state, runtime_profile(), scan_range.params,
-                              scan_range.ranges, scan_range.broker_addresses, counter);
+                              scan_range.ranges, scan_range.broker_addresses, counter,
+                              conjunct_ctxs);
         break;
     case TFileFormatType::FORMAT_JSON:
         scan = new JsonScanner(_runtime_state, runtime_profile(), scan_range.params,
@@ -289,11 +392,17 @@ std::unique_ptr<BaseScanner> BrokerScanNode::create_scanner(const TBrokerScanRan
 Status BrokerScanNode::scanner_scan(const TBrokerScanRange& scan_range,
                                     const std::vector<ExprContext*>& conjunct_ctxs,
                                     const std::vector<ExprContext*>& partition_expr_ctxs,
-                                    ScannerCounter* counter) {
+                                    ScannerCounter* counter, const StreamChunk* chunk) {
     //create scanner object and open
-    std::unique_ptr<BaseScanner> scanner = create_scanner(scan_range, counter);
+    std::unique_ptr<BaseScanner> scanner = create_scanner(scan_range, conjunct_ctxs, counter);
+    if (chunk != nullptr) {
+        static_cast<BrokerScanner*>(scanner.get())->set_stream_load_pipe(chunk->pipe);
+    }
     RETURN_IF_ERROR(scanner->open());
     bool scanner_eof = false;
+    // the batches not queued yet
+    std::vector<std::shared_ptr<RowBatch>> batches;
+    bool stopped = false;
 
     while (!scanner_eof) {
         // Fill one row batch
@@ -347,86 +456,198 @@ Status BrokerScanNode::scanner_scan(const TBrokerScanRange& scan_range,
 
         // Row batch has been filled, push this to the queue
         if (row_batch->num_rows() > 0) {
+            batches.push_back(row_batch);
+            if (chunk == nullptr || chunk->seq == _next_chunk_seq.load()) {
+                RETURN_IF_ERROR(push_batches(&batches, &stopped));
+                if (stopped) {
+                    return Status::OK();
+                }
+            }
+        }
+    }
+
+    if (chunk != nullptr) {
+        // wait for the chunks before this one
+        {
             std::unique_lock<std::mutex> l(_batch_queue_lock);
             while (_process_status.ok() && !_scan_finished.load() &&
-                   !_runtime_state->is_cancelled() &&
-                   // stop pushing more batch if
-                   // 1. too many batches in queue, or
-                   // 2. at least one batch in queue and memory exceed limit.
-                   (_batch_queue.size() >= _max_buffered_batches ||
-                    (mem_tracker()->AnyLimitExceeded(MemLimit::HARD) && !_batch_queue.empty()))) {
+                   !_runtime_state->is_cancelled() && chunk->seq != _next_chunk_seq.load()) {
                 _queue_writer_cond.wait_for(l, std::chrono::seconds(1));
             }
-            // Process already set failed, so we just return OK
-            if (!_process_status.ok()) {
-                return Status::OK();
-            }
-            // Scan already finished, just return
-            if (_scan_finished.load()) {
-                return Status::OK();
-            }
-            // Runtime state is canceled, just return cancel
-            if (_runtime_state->is_cancelled()) {
-                return Status::Cancelled("Cancelled");
-            }
-            // Queue size Must be smaller than _max_buffered_batches
-            _batch_queue.push_back(row_batch);
-
-            // Notify reader to
-            _queue_reader_cond.notify_one();
         }
+        RETURN_IF_ERROR(push_batches(&batches, &stopped));
+        if (stopped) {
+            return Status::OK();
+        }
+        {
+            std::lock_guard<std::mutex> l(_batch_queue_lock);
+            _next_chunk_seq++;
+        }
+        _queue_writer_cond.notify_all();
     }
 
     return Status::OK();
 }
 
-void BrokerScanNode::scanner_worker(int start_idx, int length) {
-    // Clone expr context
-    std::vector<ExprContext*> scanner_expr_ctxs;
-    auto status = Expr::clone_if_not_exists(_conjunct_ctxs, _runtime_state, &scanner_expr_ctxs);
+Status BrokerScanNode::push_batches(std::vector<std::shared_ptr<RowBatch>>* batches,
+                                    bool* stopped) {
+    std::unique_lock<std::mutex> l(_batch_queue_lock);
+    for (auto& row_batch : *batches) {
+        while (_process_status.ok() && !_scan_finished.load() &&
+               !_runtime_state->is_cancelled() &&
+               // stop pushing more batch if
+               // 1. too many batches in queue, or
+               // 2. at least one batch in queue and memory exceed limit.
+               (_batch_queue.size() >= _max_buffered_batches ||
+                (mem_tracker()->AnyLimitExceeded(MemLimit::HARD) && !_batch_queue.empty()))) {
+            _queue_writer_cond.wait_for(l, std::chrono::seconds(1));
+        }
+        // Process already set failed, so we just return OK
+        if (!_process_status.ok()) {
+            *stopped = true;
+            return Status::OK();
+        }
+        // Scan already finished, just return
+        if (_scan_finished.load()) {
+            *stopped = true;
+            return Status::OK();
+        }
+        // Runtime state is canceled, just return cancel
+        if (_runtime_state->is_cancelled()) {
+            return Status::Cancelled("Cancelled");
+        }
+        // Queue size Must be smaller than _max_buffered_batches
+        _batch_queue.push_back(row_batch);
+
+        // Notify reader to
+        _queue_reader_cond.notify_one();
+    }
+    batches->clear();
+    return Status::OK();
+}
+
+Status BrokerScanNode::scan_stream_chunks(const std::shared_ptr<StreamLoadPipe>& stream,
+                                          const std::vector<ExprContext*>& conjunct_ctxs,
+                                          const std::vector<ExprContext*>& partition_expr_ctxs,
+                                          ScannerCounter* counter) {
+    const TBrokerScanRange& scan_range = _scan_ranges[0].scan_range.broker_scan_range;
+    char line_delimiter = static_cast<char>(scan_range.params.line_delimiter);
+    while (true) {
+        RETURN_IF_CANCELLED(_runtime_state);
+        {
+            std::lock_guard<std::mutex> l(_batch_queue_lock);
+            if (!_process_status.ok() || _scan_finished.load()) {
+                return Status::OK();
+            }
+        }
+        StreamChunk chunk;
+        ByteBufferPtr buf;
+        RETURN_IF_ERROR(stream->read_line_chunk(
+                line_delimiter, config::stream_load_parse_chunk_bytes, &chunk.seq, &buf));
+        if (buf == nullptr) {
+            return Status::OK();
+        }
+        chunk.pipe = std::make_shared<StreamLoadPipe>();
+        RETURN_IF_ERROR(chunk.pipe->append(buf));
+        RETURN_IF_ERROR(chunk.pipe->finish());
+        RETURN_IF_ERROR(
+                scanner_scan(scan_range, conjunct_ctxs, partition_expr_ctxs, counter, &chunk));
+    }
+}
+
+Status BrokerScanNode::init_scanner_slot(ScannerSlot* slot) {
+    if (slot->initialized) {
+        return Status::OK();
+    }
+    slot->initialized = true;
+    auto status = Expr::clone_if_not_exists(_conjunct_ctxs, _runtime_state, &slot->conjunct_ctxs);
     if (!status.ok()) {
         LOG(WARNING) << "Clone conjuncts failed.";
+        return status;
     }
-    std::vector<ExprContext*> partition_expr_ctxs;
-    ;
-    if (status.ok()) {
-        status = Expr::clone_if_not_exists(_partition_expr_ctxs, _runtime_state,
-                                           &partition_expr_ctxs);
-        if (!status.ok()) {
-            LOG(WARNING) << "Clone conjuncts failed.";
+    status = Expr::clone_if_not_exists(_partition_expr_ctxs, _runtime_state,
+                                       &slot->partition_expr_ctxs);
+    if (!status.ok()) {
+        LOG(WARNING) << "Clone conjuncts failed.";
+    }
+    return status;
+}
+
+bool BrokerScanNode::scan_next_unit(ScannerSlot* slot, Status* status) {
+    if (_scan_finished.load()) {
+        return false;
+    }
+    size_t unit = _next_scan_unit++;
+    if (unit >= _scan_units.size()) {
+        return false;
+    }
+    *status = scanner_scan(_scan_units[unit], slot->conjunct_ctxs, slot->partition_expr_ctxs,
+                           &slot->counter);
+    if (!status->ok()) {
+        LOG(WARNING) << "Scanner[" << unit
+                     << "] process failed. status=" << status->get_error_msg();
+        return false;
+    }
+    return true;
+}
+
+bool BrokerScanNode::offer_scanner_task(ScannerSlot* slot) {
+    FairThreadPool::Task task;
+    task.work_function = std::bind(&BrokerScanNode::scanner_task, this, slot);
+    task.queue_wait_timer = _scanner_queue_wait_timer;
+    // the tasks are grouped by load, so the loads share the threads fairly
+    return _scan_thread_pool->offer(_runtime_state->query_id(), task);
+}
+
+void BrokerScanNode::scanner_task(ScannerSlot* slot) {
+    Status status = init_scanner_slot(slot);
+    if (status.ok() && scan_next_unit(slot, &status) &&
+        _next_scan_unit.load() < _scan_units.size()) {
+        if (offer_scanner_task(slot)) {
+            return;
         }
+        status = Status::InternalError("broker scanner thread pool is shut down");
     }
-    ScannerCounter counter;
-    for (int i = 0; i < length && status.ok(); ++i) {
-        const TBrokerScanRange& scan_range =
-                _scan_ranges[start_idx + i].scan_range.broker_scan_range;
-        status = scanner_scan(scan_range, scanner_expr_ctxs, partition_expr_ctxs, &counter);
-        if (!status.ok()) {
-            LOG(WARNING) << "Scanner[" << start_idx + i
-                         << "] process failed. status=" << status.get_error_msg();
+    finish_scanner(slot, status);
+}
+
+void BrokerScanNode::scanner_worker(ScannerSlot* slot, std::shared_ptr<StreamLoadPipe> stream) {
+    Status status = init_scanner_slot(slot);
+    if (status.ok()) {
+        if (stream != nullptr) {
+            status = scan_stream_chunks(stream, slot->conjunct_ctxs, slot->partition_expr_ctxs,
+                                        &slot->counter);
+            if (!status.ok()) {
+                LOG(WARNING) << "Stream scanner process failed. status=" << status.get_error_msg();
+            }
+        } else {
+            while (scan_next_unit(slot, &status)) {
+            }
         }
     }
+    finish_scanner(slot, status);
+}
 
+void BrokerScanNode::finish_scanner(ScannerSlot* slot, const Status& status) {
+    Expr::close(slot->conjunct_ctxs, _runtime_state);
+    Expr::close(slot->partition_expr_ctxs, _runtime_state);
     // Update stats
-    _runtime_state->update_num_rows_load_filtered(counter.num_rows_filtered);
-    _runtime_state->update_num_rows_load_unselected(counter.num_rows_unselected);
+    _runtime_state->update_num_rows_load_filtered(slot->counter.num_rows_filtered);
+    _runtime_state->update_num_rows_load_unselected(slot->counter.num_rows_unselected);
 
-    // scanner is going to finish
-    {
-        std::lock_guard<std::mutex> l(_batch_queue_lock);
-        if (!status.ok()) {
-            update_status(status);
-        }
-        // This scanner will finish
-        _num_running_scanners--;
+    // scanner is going to finish, notify under the lock since this node may be closed as
+    // soon as it's released
+    std::lock_guard<std::mutex> l(_batch_queue_lock);
+    if (!status.ok()) {
+        update_status(status);
     }
+    // This scanner will finish
+    _num_running_scanners--;
     _queue_reader_cond.notify_all();
     // If one scanner failed, others don't need scan any more
     if (!status.ok()) {
         _queue_writer_cond.notify_all();
     }
-    Expr::close(scanner_expr_ctxs, _runtime_state);
-    Expr::close(partition_expr_ctxs, _runtime_state);
 }
 
 int64_t BrokerScanNode::binary_find_partition_id(const PartRangeKey& key) const {
@@ -20,6 +20,7 @@
 #include <atomic>
 #include <condition_variable>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <thread>
@@ -32,9 +33,11 @@
 
 namespace doris {
 
+class FairThreadPool;
 class RuntimeState;
 class PartRangeKey;
 class PartitionInfo;
+class StreamLoadPipe;
 struct ScannerCounter;
 
 class BrokerScanNode : public ScanNode {
@@ -84,19 +87,76 @@ private:
     // Create scanners to do scan job
     Status start_scanners();
 
-    // One scanner worker, This scanner will handle 'length' ranges start from start_idx
-    void scanner_worker(int start_idx, int length);
-
-    // Scan one range
+    // The expr contexts and the counter of one scanner
+    struct ScannerSlot {
+        bool initialized = false;
+        std::vector<ExprContext*> conjunct_ctxs;
+        std::vector<ExprContext*> partition_expr_ctxs;
+        ScannerCounter counter;
+    };
+
+    // Split the scan ranges into the units the scanners take in turn: each file is a unit,
+    // and the splittable plain csv files are split into ranges of broker_scan_split_bytes.
+    void split_scan_ranges();
+
+    // Returns the shared thread pool to run the scanners in, nullptr if they need threads of
+    // their own, which is the case for the streams of loads: reading them waits for their
+    // clients and would hold the shared threads.
+    FairThreadPool* get_scan_thread_pool();
+
+    // Clone the expr contexts of 'slot' for its first scan.
+    Status init_scanner_slot(ScannerSlot* slot);
+
+    // Scan the next unit by 'slot'. Returns false if there is no unit left, the scan stopped
+    // or it failed, which is set to 'status'.
+    bool scan_next_unit(ScannerSlot* slot, Status* status);
+
+    // Offer the task of 'slot' to the shared thread pool.
+    bool offer_scanner_task(ScannerSlot* slot);
+
+    // The task of a scanner in the shared thread pool, which scans one unit and offers itself
+    // again if there are more, so that the threads are shared fairly with the other loads.
+    void scanner_task(ScannerSlot* slot);
+
+    // Release 'slot' and count its scanner as finished with 'status'.
+    void finish_scanner(ScannerSlot* slot, const Status& status);
+
+    // A chunk of the lines of a stream, parsed by one of the scanners of the stream.
+    struct StreamChunk {
+        int64_t seq;
+        std::shared_ptr<StreamLoadPipe> pipe;
+    };
+
+    // Returns the pipe of the stream load if the scan ranges are the single plain csv stream
+    // of it, which the scanners can parse in parallel, nullptr otherwise.
+    std::shared_ptr<StreamLoadPipe> get_parallel_stream();
+
+    // One scanner worker on a thread of its own, which scans the units in turn with the
+    // other workers, or the chunks of 'stream' if it's not nullptr.
+    void scanner_worker(ScannerSlot* slot, std::shared_ptr<StreamLoadPipe> stream);
+
+    // Scan the chunks of 'stream' until its end.
+    Status scan_stream_chunks(const std::shared_ptr<StreamLoadPipe>& stream,
+                              const std::vector<ExprContext*>& conjunct_ctxs,
+                              const std::vector<ExprContext*>& partition_expr_ctxs,
+                              ScannerCounter* counter);
+
+    // Scan one range, or the chunk 'chunk' of it. The batches of a chunk are queued after
+    // those of the chunks before it.
     Status scanner_scan(const TBrokerScanRange& scan_range,
                         const std::vector<ExprContext*>& conjunct_ctxs,
                         const std::vector<ExprContext*>& partition_expr_ctxs,
-                        ScannerCounter* counter);
+                        ScannerCounter* counter, const StreamChunk* chunk = nullptr);
+
+    // Push 'batches' to the queue in order, waiting while it's full, and clear them. Sets
+    // 'stopped' if the scan stopped before they are pushed.
+    Status push_batches(std::vector<std::shared_ptr<RowBatch>>* batches, bool* stopped);
 
     // Find partition id with PartRangeKey
     int64_t binary_find_partition_id(const PartRangeKey& key) const;
 
     std::unique_ptr<BaseScanner> create_scanner(const TBrokerScanRange& scan_range,
+                                                const std::vector<ExprContext*>& conjunct_ctxs,
                                                 ScannerCounter* counter);
 
 private:
@@ -121,8 +181,19 @@ private:
 
     std::vector<std::thread> _scanner_threads;
 
+    // the units of the scan ranges, and the next one to be scanned
+    std::vector<TBrokerScanRange> _scan_units;
+    std::atomic<size_t> _next_scan_unit;
+    std::vector<std::unique_ptr<ScannerSlot>> _scanner_slots;
+    // nullptr if the scanners run on threads of their own
+    FairThreadPool* _scan_thread_pool;
+
     int _max_buffered_batches;
 
+    // The chunk of the stream whose batches are queued now, the scanners of the chunks after
+    // it keep their batches until their turn.
+    std::atomic<int64_t> _next_chunk_seq;
+
     // Partition information
     std::vector<ExprContext*> _partition_expr_ctxs;
     std::vector<PartitionInfo*> _partition_infos;
@@ -130,6 +201,7 @@ private:
     // Profile information
     //
     RuntimeProfile::Counter* _wait_scanner_timer;
+    RuntimeProfile::Counter* _scanner_queue_wait_timer;
 };
 
 } // namespace doris
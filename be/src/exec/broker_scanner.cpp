@@ -17,9 +17,15 @@
 
 #include "exec/broker_scanner.h"
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 #include <iostream>
 #include <sstream>
 
+#include "common/config.h"
+#include "exec/async_decompress_reader.h"
 #include "exec/broker_reader.h"
 #include "exec/decompressor.h"
 #include "exec/local_file_reader.h"
@@ -122,6 +128,8 @@ Status BrokerScanner::open_next_reader() {
 }
 
 Status BrokerScanner::open_file_reader() {
+    // stop reading the current file
+    _cur_async_reader.reset();
     if (_cur_file_reader != nullptr) {
         if (_stream_load_pipe != nullptr) {
             _stream_load_pipe.reset();
@@ -153,7 +161,9 @@ Status BrokerScanner::open_file_reader() {
         break;
     }
     case TFileType::FILE_STREAM: {
-        _stream_load_pipe = _state->exec_env()->load_stream_mgr()->get(range.load_id);
+        if (_stream_load_pipe == nullptr) {
+            _stream_load_pipe = _state->exec_env()->load_stream_mgr()->get(range.load_id);
+        }
         if (_stream_load_pipe == nullptr) {
             VLOG(3) << "unknown stream load id: " << UniqueId(range.load_id);
             return Status::InternalError("unknown stream load id");
@@ -209,6 +219,7 @@ Status BrokerScanner::create_decompressor(TFileFormatType::type type) {
 }
 
 Status BrokerScanner::open_line_reader() {
+    _cur_async_reader.reset();
     if (_cur_decompressor != nullptr) {
         delete _cur_decompressor;
         _cur_decompressor = nullptr;
@@ -245,8 +256,19 @@ Status BrokerScanner::open_line_reader() {
     case TFileFormatType::FORMAT_CSV_LZ4FRAME:
     case TFileFormatType::FORMAT_CSV_LZOP:
     case TFileFormatType::FORMAT_CSV_DEFLATE:
-        _cur_line_reader = new PlainTextLineReader(_profile, _cur_file_reader, _cur_decompressor,
-                                                   size, _line_delimiter);
+        if (_cur_decompressor != nullptr && config::enable_async_decompress &&
+            range.file_type != TFileType::FILE_STREAM) {
+            // the whole file is read, a compressed file isn't split. The pipe of a stream load
+            // isn't read on a helper thread, which could block on it when the load stops.
+            _cur_async_reader.reset(
+                    new AsyncDecompressReader(_profile, _cur_file_reader, _cur_decompressor));
+            RETURN_IF_ERROR(_cur_async_reader->open());
+            _cur_line_reader = new PlainTextLineReader(_profile, _cur_async_reader.get(), nullptr,
+                                                       -1, _line_delimiter);
+        } else {
+            _cur_line_reader = new PlainTextLineReader(_profile, _cur_file_reader,
+                                                       _cur_decompressor, size, _line_delimiter);
+        }
         break;
     default: {
         std::stringstream ss;
@@ -261,6 +283,7 @@ Status BrokerScanner::open_line_reader() {
 }
 
 void BrokerScanner::close() {
+    _cur_async_reader.reset();
     if (_cur_decompressor != nullptr) {
         delete _cur_decompressor;
         _cur_decompressor = nullptr;
@@ -286,7 +309,22 @@ void BrokerScanner::split_line(const Slice& line, std::vector<Slice>* values) {
     // line-begin char and line-end char are considered to be 'delimiter'
     const char* value = line.data;
     const char* ptr = line.data;
-    for (size_t i = 0; i < line.size; ++i, ++ptr) {
+    const char* end = line.data + line.size;
+#ifdef __SSE2__
+    // find the separators of 16 chars at a time
+    const __m128i separator = _mm_set1_epi8(_value_separator);
+    for (; end - ptr >= 16; ptr += 16) {
+        __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+        int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(chars, separator));
+        while (mask != 0) {
+            const char* pos = ptr + __builtin_ctz(mask);
+            values->emplace_back(value, pos - value);
+            value = pos + 1;
+            mask &= mask - 1;
+        }
+    }
+#endif
+    for (; ptr < end; ++ptr) {
         if (*ptr == _value_separator) {
             values->emplace_back(value, ptr - value);
             value = ptr + 1;
@@ -394,8 +432,9 @@ bool BrokerScanner::line_to_src_tuple(const Slice& line) {
         return false;
     }
 
-    std::vector<Slice> values;
-    { split_line(line, &values); }
+    std::vector<Slice>& values = _split_values;
+    values.clear();
+    split_line(line, &values);
 
     // range of current file
     const TBrokerRangeDesc& range = _ranges.at(_next_range - 1);
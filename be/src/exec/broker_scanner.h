@@ -40,6 +40,7 @@ class TextConverter;
 class FileReader;
 class LineReader;
 class Decompressor;
+class AsyncDecompressReader;
 class RuntimeState;
 class ExprContext;
 class TupleDescriptor;
@@ -66,6 +67,12 @@ public:
     // Close this scanner
     void close() override;
 
+    // Reads the stream of the range from 'pipe' instead of the pipe of its load, used to
+    // parse a chunk of the stream, see BrokerScanNode. Must be called before open().
+    void set_stream_load_pipe(const std::shared_ptr<StreamLoadPipe>& pipe) {
+        _stream_load_pipe = pipe;
+    }
+
 private:
     Status open_file_reader();
     Status create_decompressor(TFileFormatType::type type);
@@ -106,6 +113,9 @@ private:
     FileReader* _cur_file_reader;
     LineReader* _cur_line_reader;
     Decompressor* _cur_decompressor;
+    // decompresses the current file for the line reader on a helper thread,
+    // see config::enable_async_decompress
+    std::unique_ptr<AsyncDecompressReader> _cur_async_reader;
     int _next_range;
     bool _cur_line_reader_eof;
 
@@ -117,6 +127,9 @@ private:
 
     // used to hold current StreamLoadPipe
     std::shared_ptr<StreamLoadPipe> _stream_load_pipe;
+
+    // the values of the current line, reused across lines
+    std::vector<Slice> _split_values;
 };
 
 } // namespace doris
@@ -20,18 +20,21 @@
 #include <algorithm>
 #include <sstream>
 
+#include "common/config.h"
 #include "common/logging.h"
 
 namespace doris {
 
 // buffered reader
-BufferedReader::BufferedReader(FileReader* reader, int64_t buffer_size)
+BufferedReader::BufferedReader(FileReader* reader, int64_t buffer_size, int num_buffers)
         : _reader(reader),
           _buffer_size(buffer_size),
-          _buffer_offset(0),
-          _buffer_limit(0),
+          _buffers(std::max(num_buffers, 1)),
           _cur_offset(0) {
-    _buffer = new char[_buffer_size];
+    for (auto& buffer : _buffers) {
+        buffer.data = new char[_buffer_size];
+    }
+    _read_ahead.offset = -1;
 }
 
 BufferedReader::~BufferedReader() {
@@ -45,7 +48,7 @@ Status BufferedReader::open() {
         return Status::InternalError(ss.str());
     }
     RETURN_IF_ERROR(_reader->open());
-    RETURN_IF_ERROR(_fill());
+    RETURN_IF_ERROR(_fill(&_buffers[0], 0, false));
     return Status::OK();
 }
 
@@ -71,6 +74,7 @@ Status BufferedReader::readat(int64_t position, int64_t nbytes, int64_t* bytes_r
         *bytes_read = 0;
         return Status::OK();
     }
+    position = std::max<int64_t>(position, 0);
     RETURN_IF_ERROR(_read_once(position, nbytes, bytes_read, out));
     //EOF
     if (*bytes_read <= 0) {
@@ -91,43 +95,97 @@ Status BufferedReader::readat(int64_t position, int64_t nbytes, int64_t* bytes_r
 
 Status BufferedReader::_read_once(int64_t position, int64_t nbytes, int64_t* bytes_read,
                                   void* out) {
-    // requested bytes missed the local buffer
-    if (position >= _buffer_limit || position < _buffer_offset) {
+    Buffer* hit = nullptr;
+    Buffer* victim = &_buffers[0];
+    bool sequential = false;
+    for (auto& buffer : _buffers) {
+        if (position >= buffer.offset && position < buffer.limit) {
+            hit = &buffer;
+            break;
+        }
+        if (sequential) {
+            continue;
+        }
+        // a read that continues a buffer refills it, other misses refill the least
+        // recently used buffer
+        if (position == buffer.limit && buffer.limit > buffer.offset) {
+            victim = &buffer;
+            sequential = true;
+        } else if (buffer.last_access < victim->last_access) {
+            victim = &buffer;
+        }
+    }
+    // requested bytes missed the local buffers
+    if (hit == nullptr) {
         // if requested length is larger than the capacity of buffer, do not
         // need to copy the character into local buffer.
         if (nbytes > _buffer_size) {
-            return _reader->readat(position, nbytes, bytes_read, out);
+            _wait_read_ahead();
+            RETURN_IF_ERROR(_reader->readat(position, nbytes, bytes_read, out));
+            _cur_offset = position + *bytes_read;
+            return Status::OK();
         }
-        _buffer_offset = position;
-        RETURN_IF_ERROR(_fill());
-        if (position >= _buffer_limit) {
+        RETURN_IF_ERROR(_fill(victim, position, sequential));
+        if (position >= victim->limit) {
             *bytes_read = 0;
             return Status::OK();
         }
+        hit = victim;
     }
-    int64_t len = std::min(_buffer_limit - position, nbytes);
-    int64_t off = position - _buffer_offset;
-    memcpy(out, _buffer + off, len);
+    hit->last_access = ++_access_count;
+    int64_t len = std::min(hit->limit - position, nbytes);
+    int64_t off = position - hit->offset;
+    memcpy(out, hit->data + off, len);
     *bytes_read = len;
     _cur_offset = position + *bytes_read;
     return Status::OK();
 }
 
-Status BufferedReader::_fill() {
-    if (_buffer_offset >= 0) {
-        int64_t bytes_read;
-        // retry for new content
-        int retry_times = 1;
-        do {
-            // fill the buffer
-            RETURN_IF_ERROR(_reader->readat(_buffer_offset, _buffer_size, &bytes_read, _buffer));
-        } while (bytes_read == 0 && retry_times++ < 2);
-        _buffer_limit = _buffer_offset + bytes_read;
+Status BufferedReader::_fill(Buffer* buffer, int64_t offset, bool sequential) {
+    _wait_read_ahead();
+    int64_t bytes_read = 0;
+    if (offset == _read_ahead.offset && _read_ahead_status.ok()) {
+        std::swap(buffer->data, _read_ahead.data);
+        bytes_read = _read_ahead.limit - _read_ahead.offset;
+        _read_ahead.offset = -1;
+    } else {
+        RETURN_IF_ERROR(_read_block(offset, buffer->data, &bytes_read));
+    }
+    buffer->offset = offset;
+    buffer->limit = offset + bytes_read;
+
+    if (sequential && bytes_read == _buffer_size && config::enable_buffered_reader_read_ahead) {
+        if (_read_ahead.data == nullptr) {
+            _read_ahead.data = new char[_buffer_size];
+        }
+        _read_ahead.offset = buffer->limit;
+        _read_ahead_thread = std::thread([this] {
+            int64_t len = 0;
+            _read_ahead_status = _read_block(_read_ahead.offset, _read_ahead.data, &len);
+            _read_ahead.limit = _read_ahead.offset + len;
+        });
     }
     return Status::OK();
 }
 
+Status BufferedReader::_read_block(int64_t offset, char* data, int64_t* bytes_read) {
+    // retry for new content
+    int retry_times = 1;
+    do {
+        // fill the buffer
+        RETURN_IF_ERROR(_reader->readat(offset, _buffer_size, bytes_read, data));
+    } while (*bytes_read == 0 && retry_times++ < 2);
+    return Status::OK();
+}
+
+void BufferedReader::_wait_read_ahead() {
+    if (_read_ahead_thread.joinable()) {
+        _read_ahead_thread.join();
+    }
+}
+
 int64_t BufferedReader::size() {
+    _wait_read_ahead();
     return _reader->size();
 }
 
@@ -142,11 +200,16 @@ Status BufferedReader::tell(int64_t* position) {
 }
 
 void BufferedReader::close() {
+    _wait_read_ahead();
     _reader->close();
-    SAFE_DELETE_ARRAY(_buffer);
+    for (auto& buffer : _buffers) {
+        SAFE_DELETE_ARRAY(buffer.data);
+    }
+    SAFE_DELETE_ARRAY(_read_ahead.data);
 }
 
 bool BufferedReader::closed() {
+    _wait_read_ahead();
     return _reader->closed();
 }
 
@@ -19,6 +19,9 @@
 
 #include <stdint.h>
 
+#include <thread>
+#include <vector>
+
 #include "common/status.h"
 #include "exec/file_reader.h"
 #include "olap/olap_define.h"
@@ -28,11 +31,18 @@ namespace doris {
 // Buffered Reader
 // Add a cache layer between the caller and the file reader to reduce the
 // times of calls to the read function to speed up.
+//
+// There are a few buffers, so that interleaved sequential reads at different places of
+// the file, like the reads of the column chunks of a parquet row group, each keep their
+// own buffer instead of evicting each other's. When a read continues right after the end
+// of a buffer, the block after the one it refills the buffer with is read ahead on a
+// helper thread while the caller consumes the buffer. The wrapped reader is only used by
+// one thread at a time.
 class BufferedReader : public FileReader {
 public:
     // If the reader need the file size, set it when construct FileReader.
     // There is no other way to set the file size.
-    BufferedReader(FileReader* reader, int64_t = 1024 * 1024);
+    BufferedReader(FileReader* reader, int64_t = 1024 * 1024, int num_buffers = 4);
     virtual ~BufferedReader();
 
     virtual Status open() override;
@@ -49,16 +59,35 @@ public:
     virtual bool closed() override;
 
 private:
-    Status _fill();
+    // The bytes of the file in [offset, limit).
+    struct Buffer {
+        char* data = nullptr;
+        int64_t offset = 0;
+        int64_t limit = 0;
+        // the order of the last access, the least recently used buffer is refilled
+        int64_t last_access = 0;
+    };
+
     Status _read_once(int64_t position, int64_t nbytes, int64_t* bytes_read, void* out);
+    // Fills 'buffer' with the block at 'offset'. If 'sequential', reads the block after it
+    // ahead.
+    Status _fill(Buffer* buffer, int64_t offset, bool sequential);
+    Status _read_block(int64_t offset, char* data, int64_t* bytes_read);
+    // Waits for the read ahead, so that the caller can use _reader.
+    void _wait_read_ahead();
 
 private:
     FileReader* _reader;
-    char* _buffer;
     int64_t _buffer_size;
-    int64_t _buffer_offset;
-    int64_t _buffer_limit;
+    std::vector<Buffer> _buffers;
+    int64_t _access_count = 0;
     int64_t _cur_offset;
+
+    // The block read ahead, its offset is -1 if there is none. Only used by the helper
+    // thread until it's joined.
+    Buffer _read_ahead;
+    Status _read_ahead_status;
+    std::thread _read_ahead_thread;
 };
 
 } // namespace doris
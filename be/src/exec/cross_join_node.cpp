@@ -17,10 +17,14 @@
 
 #include "exec/cross_join_node.h"
 
+#include <algorithm>
 #include <sstream>
 
 #include "exprs/expr.h"
+#include "exprs/expr_context.h"
+#include "exprs/slot_ref.h"
 #include "gen_cpp/PlanNodes_types.h"
+#include "runtime/raw_value.h"
 #include "runtime/row_batch.h"
 #include "runtime/runtime_state.h"
 #include "util/debug_util.h"
@@ -35,9 +39,75 @@ Status CrossJoinNode::prepare(RuntimeState* state) {
     DCHECK(_join_op == TJoinOp::CROSS_JOIN);
     RETURN_IF_ERROR(BlockingJoinNode::prepare(state));
     _build_batch_pool.reset(new ObjectPool());
+
+    for (int i = 0; i < _conjunct_ctxs.size() && !_is_range_join; ++i) {
+        _is_range_join = get_range_bound(_conjunct_ctxs[i], true, &_lower_bound);
+    }
+    if (_is_range_join) {
+        for (int i = 0; i < _conjunct_ctxs.size(); ++i) {
+            if (_conjunct_ctxs[i] != _lower_bound.ctx &&
+                get_range_bound(_conjunct_ctxs[i], false, &_upper_bound)) {
+                break;
+            }
+        }
+        _range_eval_row.resize(_row_descriptor.tuple_descriptors().size());
+        _lower_probe_value.resize(_lower_bound.build_slot->type().get_slot_size());
+        if (_upper_bound.ctx != NULL) {
+            _upper_probe_value.resize(_upper_bound.build_slot->type().get_slot_size());
+        }
+        add_runtime_exec_option("Range Join");
+    }
     return Status::OK();
 }
 
+bool CrossJoinNode::get_range_bound(ExprContext* conjunct, bool lower, RangeBound* bound) {
+    Expr* root = conjunct->root();
+    if (root->node_type() != TExprNodeType::BINARY_PRED) {
+        return false;
+    }
+    // 'less' if the predicate is 'child(0) < child(1)' or with <=
+    bool less = false;
+    bool inclusive = false;
+    switch (root->op()) {
+    case TExprOpcode::LT:
+        less = true;
+        break;
+    case TExprOpcode::LE:
+        less = true;
+        inclusive = true;
+        break;
+    case TExprOpcode::GT:
+        break;
+    case TExprOpcode::GE:
+        inclusive = true;
+        break;
+    default:
+        return false;
+    }
+    // the child on the smaller side is the build slot of a lower bound
+    Expr* build_slot = root->get_child(less == lower ? 0 : 1);
+    Expr* probe_expr = root->get_child(less == lower ? 1 : 0);
+    if (!build_slot->is_slotref() || build_slot->type() != probe_expr->type()) {
+        return false;
+    }
+    std::vector<TupleId> left_tuple_ids;
+    for (TupleDescriptor* desc : child(0)->row_desc().tuple_descriptors()) {
+        left_tuple_ids.push_back(desc->id());
+    }
+    std::vector<TupleId> build_tuple_ids;
+    for (TupleDescriptor* desc : child(1)->row_desc().tuple_descriptors()) {
+        build_tuple_ids.push_back(desc->id());
+    }
+    if (!build_slot->is_bound(&build_tuple_ids) || !probe_expr->is_bound(&left_tuple_ids)) {
+        return false;
+    }
+    bound->ctx = conjunct;
+    bound->probe_expr = probe_expr;
+    bound->build_slot = build_slot;
+    bound->inclusive = inclusive;
+    return true;
+}
+
 Status CrossJoinNode::close(RuntimeState* state) {
     // avoid double close
     if (is_closed()) {
@@ -76,11 +146,120 @@ Status CrossJoinNode::construct_build_side(RuntimeState* state) {
         }
     }
 
+    if (_is_range_join) {
+        SCOPED_TIMER(_build_timer);
+        construct_range_build_rows();
+    }
     return Status::OK();
 }
 
+void CrossJoinNode::construct_range_build_rows() {
+    TupleRow* eval_row = reinterpret_cast<TupleRow*>(&_range_eval_row[0]);
+    const TypeDescriptor& type = _lower_bound.build_slot->type();
+    _range_build_rows.reserve(_build_batches.total_num_rows());
+    for (RowBatchList::TupleRowIterator it = _build_batches.iterator(); !it.at_end(); it.next()) {
+        create_output_row(eval_row, NULL, it.get_row());
+        // the slots of the build tuples stay valid as long as _build_batches
+        const void* lower = SlotRef::get_value(_lower_bound.build_slot, eval_row);
+        if (lower == NULL) {
+            // the lower bound is never satisfied
+            continue;
+        }
+        RangeBuildRow build_row;
+        build_row.row = it.get_row();
+        build_row.lower = lower;
+        build_row.upper_max = NULL;
+        if (_upper_bound.ctx != NULL) {
+            build_row.upper_max = SlotRef::get_value(_upper_bound.build_slot, eval_row);
+        }
+        _range_build_rows.push_back(build_row);
+    }
+    std::stable_sort(_range_build_rows.begin(), _range_build_rows.end(),
+                     [&type](const RangeBuildRow& lhs, const RangeBuildRow& rhs) {
+                         return RawValue::compare(lhs.lower, rhs.lower, type) < 0;
+                     });
+    if (_upper_bound.ctx == NULL) {
+        return;
+    }
+    const TypeDescriptor& upper_type = _upper_bound.build_slot->type();
+    const void* upper_max = NULL;
+    for (RangeBuildRow& build_row : _range_build_rows) {
+        if (build_row.upper_max != NULL &&
+            (upper_max == NULL ||
+             RawValue::compare(build_row.upper_max, upper_max, upper_type) > 0)) {
+            upper_max = build_row.upper_max;
+        }
+        build_row.upper_max = upper_max;
+    }
+}
+
+const void* CrossJoinNode::eval_probe_value(const RangeBound& bound, TupleRow* eval_row,
+                                            std::vector<uint8_t>* value) {
+    // the result of get_value() is overwritten by the next evaluation of the context
+    const void* result = bound.ctx->get_value(bound.probe_expr, eval_row);
+    if (result == NULL) {
+        return NULL;
+    }
+    RawValue::write(result, value->data(), bound.build_slot->type(), NULL);
+    return value->data();
+}
+
 void CrossJoinNode::init_get_next(TupleRow* first_left_row) {
-    _current_build_row = _build_batches.iterator();
+    reset_build_rows(first_left_row);
+}
+
+void CrossJoinNode::reset_build_rows(TupleRow* left_row) {
+    if (!_is_range_join) {
+        _current_build_row = _build_batches.iterator();
+        return;
+    }
+    _range_pos = 0;
+    _range_end = 0;
+    if (left_row == NULL) {
+        return;
+    }
+    TupleRow* eval_row = reinterpret_cast<TupleRow*>(&_range_eval_row[0]);
+    create_output_row(eval_row, left_row, NULL);
+
+    // the rows whose lower bound is below the value, or equal if inclusive
+    const TypeDescriptor& type = _lower_bound.build_slot->type();
+    const void* value = eval_probe_value(_lower_bound, eval_row, &_lower_probe_value);
+    if (value == NULL) {
+        return;
+    }
+    bool inclusive = _lower_bound.inclusive;
+    _range_end = std::partition_point(_range_build_rows.begin(), _range_build_rows.end(),
+                                      [&](const RangeBuildRow& build_row) {
+                                          int cmp = RawValue::compare(build_row.lower, value,
+                                                                      type);
+                                          return inclusive ? cmp <= 0 : cmp < 0;
+                                      }) -
+                 _range_build_rows.begin();
+    if (_upper_bound.ctx == NULL) {
+        return;
+    }
+
+    // Cut the rows before the first one with an upper bound above the value, or equal if
+    // inclusive, in the rows up to it. No upper bound of those rows is.
+    const TypeDescriptor& upper_type = _upper_bound.build_slot->type();
+    const void* upper_value = eval_probe_value(_upper_bound, eval_row, &_upper_probe_value);
+    if (upper_value == NULL) {
+        _range_end = 0;
+        return;
+    }
+    bool upper_inclusive = _upper_bound.inclusive;
+    _range_pos = std::partition_point(_range_build_rows.begin(),
+                                      _range_build_rows.begin() + _range_end,
+                                      [&](const RangeBuildRow& build_row) {
+                                          if (build_row.upper_max == NULL) {
+                                              return true;
+                                          }
+                                          int cmp = RawValue::compare(upper_value,
+                                                                      build_row.upper_max,
+                                                                      upper_type);
+                                          return upper_inclusive ? cmp > 0 : cmp >= 0;
+                                      }) -
+                 _range_build_rows.begin();
 }
 
 Status CrossJoinNode::get_next(RuntimeState* state, RowBatch* output_batch, bool* eos) {
@@ -90,6 +269,7 @@ Status CrossJoinNode::get_next(RuntimeState* state, RowBatch* output_batch, bool
     // TOOD(zhaochun)
     // RETURN_IF_ERROR(state->check_query_state());
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_CPU_TIMER(_cpu_timer);
 
     if (reached_limit() || _eos) {
         *eos = true;
@@ -117,7 +297,7 @@ Status CrossJoinNode::get_next(RuntimeState* state, RowBatch* output_batch, bool
         }
 
         // Check to see if we're done processing the current left child batch
-        if (_current_build_row.at_end() && _left_batch_pos == _left_batch->num_rows()) {
+        if (build_rows_at_end() && _left_batch_pos == _left_batch->num_rows()) {
             _left_batch->transfer_resource_ownership(output_batch);
             _left_batch_pos = 0;
 
@@ -161,9 +341,8 @@ int CrossJoinNode::process_left_child_batch(RowBatch* output_batch, RowBatch* ba
     int ctx_size = _conjunct_ctxs.size();
 
     while (true) {
-        while (!_current_build_row.at_end()) {
-            create_output_row(output_row, _current_left_child_row, _current_build_row.get_row());
-            _current_build_row.next();
+        while (!build_rows_at_end()) {
+            create_output_row(output_row, _current_left_child_row, next_build_row());
 
             if (!eval_conjuncts(ctxs, ctx_size, output_row)) {
                 continue;
@@ -182,7 +361,7 @@ int CrossJoinNode::process_left_child_batch(RowBatch* output_batch, RowBatch* ba
             output_row = reinterpret_cast<TupleRow*>(output_row_mem);
         }
 
-        DCHECK(_current_build_row.at_end());
+        DCHECK(build_rows_at_end());
 
         // Advance to the next row in the left child batch
         if (UNLIKELY(_left_batch_pos == batch->num_rows())) {
@@ -191,7 +370,7 @@ int CrossJoinNode::process_left_child_batch(RowBatch* output_batch, RowBatch* ba
         }
 
         _current_left_child_row = batch->get_row(_left_batch_pos++);
-        _current_build_row = _build_batches.iterator();
+        reset_build_rows(_current_left_child_row);
     }
 
     output_batch->commit_rows(rows_returned);
@@ -22,6 +22,7 @@
 #include <boost/thread.hpp>
 #include <boost/unordered_set.hpp>
 #include <string>
+#include <vector>
 
 #include "exec/blocking_join_node.h"
 #include "exec/exec_node.h"
@@ -32,6 +33,8 @@
 
 namespace doris {
 
+class Expr;
+class ExprContext;
 class RowBatch;
 class TupleRow;
 
@@ -41,6 +44,13 @@ class TupleRow;
 // build batches are kept in a list that is fully constructed from the right child in
 // construct_build_side() (called by BlockingJoinNode::open()) while rows are fetched from
 // the left child as necessary in get_next().
+//
+// Range joins: if a conjunct bounds a slot of the build side from below by an expr of
+// the left side, e.g. 'b.start <= a.ts', the build rows are sorted by that slot, so each
+// left row only visits the rows whose bound is not above its value. If another conjunct
+// bounds a slot of the build side from above, e.g. 'a.ts <= b.end', the visited rows are
+// also cut where the running max of that slot over the sorted rows is below the value.
+// The rows visited are still checked by all conjuncts.
 class CrossJoinNode : public BlockingJoinNode {
 public:
     CrossJoinNode(ObjectPool* pool, const TPlanNode& tnode, const DescriptorTbl& descs);
@@ -60,6 +70,69 @@ private:
     RowBatchList _build_batches;
     RowBatchList::TupleRowIterator _current_build_row;
 
+    // A conjunct 'build_slot < probe_expr' (lower bound) or 'probe_expr < build_slot'
+    // (upper bound), or with <=.
+    struct RangeBound {
+        ExprContext* ctx = NULL;
+        // bound by the tuples of the left child
+        Expr* probe_expr = NULL;
+        // a slot of the right child
+        Expr* build_slot = NULL;
+        bool inclusive = false;
+    };
+
+    struct RangeBuildRow {
+        TupleRow* row;
+        // value of the lower bound slot in the build tuple, not null
+        const void* lower;
+        // max value of the upper bound slot in the build tuples of the rows up to this one,
+        // NULL if all null
+        const void* upper_max;
+    };
+
+    bool _is_range_join = false;
+    RangeBound _lower_bound;
+    RangeBound _upper_bound;
+    // rows of _build_batches with a non null lower bound, sorted by it
+    std::vector<RangeBuildRow> _range_build_rows;
+    // the build rows left to join with _current_left_child_row are
+    // _range_build_rows[_range_pos, _range_end)
+    int64_t _range_pos = 0;
+    int64_t _range_end = 0;
+    // a row with left tuples only, to evaluate the exprs of either side on
+    std::vector<Tuple*> _range_eval_row;
+    // the values of the probe exprs of the bounds for _current_left_child_row
+    std::vector<uint8_t> _lower_probe_value;
+    std::vector<uint8_t> _upper_probe_value;
+
+    // Sets 'bound' to 'conjunct' if it's a lower bound of a build slot when 'lower',
+    // otherwise an upper bound.
+    bool get_range_bound(ExprContext* conjunct, bool lower, RangeBound* bound);
+
+    // Evaluates the probe expr of 'bound' on 'eval_row' into 'value', returns NULL if
+    // it's null.
+    const void* eval_probe_value(const RangeBound& bound, TupleRow* eval_row,
+                                 std::vector<uint8_t>* value);
+
+    // Builds _range_build_rows from _build_batches.
+    void construct_range_build_rows();
+
+    // Starts joining 'left_row' with the build rows, NULL at eos.
+    void reset_build_rows(TupleRow* left_row);
+
+    bool build_rows_at_end() {
+        return _is_range_join ? _range_pos >= _range_end : _current_build_row.at_end();
+    }
+
+    TupleRow* next_build_row() {
+        if (_is_range_join) {
+            return _range_build_rows[_range_pos++].row;
+        }
+        TupleRow* row = _current_build_row.get_row();
+        _current_build_row.next();
+        return row;
+    }
+
     // Processes a batch from the left child.
     //  output_batch: the batch for resulting tuple rows
     //  batch: the batch from the left child to process.  This function can be called to
@@ -151,9 +151,7 @@ static Status get_int_value(const rapidjson::Value& col, PrimitiveType type, voi
     RETURN_ERROR_IF_COL_IS_NOT_STRING(col, type);
 
     StringParser::ParseResult result;
-    const std::string& val = col.GetString();
-    size_t len = col.GetStringLength();
-    T v = StringParser::string_to_int<T>(val.c_str(), len, &result);
+    T v = StringParser::string_to_int<T>(col.GetString(), col.GetStringLength(), &result);
     RETURN_ERROR_IF_PARSING_FAILED(result, col, type);
 
     if (sizeof(T) < 16) {
@@ -184,17 +182,33 @@ static Status get_float_value(const rapidjson::Value& col, PrimitiveType type, v
     RETURN_ERROR_IF_COL_IS_NOT_STRING(col, type);
 
     StringParser::ParseResult result;
-    const std::string& val = col.GetString();
-    size_t len = col.GetStringLength();
-    T v = StringParser::string_to_float<T>(val.c_str(), len, &result);
+    T v = StringParser::string_to_float<T>(col.GetString(), col.GetStringLength(), &result);
     RETURN_ERROR_IF_PARSING_FAILED(result, col, type);
     *reinterpret_cast<T*>(slot) = v;
 
     return Status::OK();
 }
 
+// Copies the string into the string slot.
+static Status fill_string_slot(void* slot, const char* data, size_t len, MemPool* tuple_pool) {
+    char* buffer = reinterpret_cast<char*>(tuple_pool->try_allocate_unaligned(len));
+    if (UNLIKELY(buffer == NULL)) {
+        std::string details = strings::Substitute(ERROR_MEM_LIMIT_EXCEEDED, "MaterializeNextRow",
+                                                  len, "string slot");
+        return tuple_pool->mem_tracker()->MemLimitExceeded(NULL, details, len);
+    }
+    memcpy(buffer, data, len);
+    reinterpret_cast<StringValue*>(slot)->ptr = buffer;
+    reinterpret_cast<StringValue*>(slot)->len = len;
+    return Status::OK();
+}
+
 ScrollParser::ScrollParser(bool doc_value_mode)
-        : _scroll_id(""), _size(0), _line_index(0), _doc_value_mode(doc_value_mode) {}
+        : _scroll_id(""),
+          _size(0),
+          _line_index(0),
+          _inner_hits_node(nullptr),
+          _doc_value_mode(doc_value_mode) {}
 
 ScrollParser::~ScrollParser() {}
 
@@ -228,9 +242,9 @@ Status ScrollParser::parse(const std::string& scroll_result, bool exactly_once)
     if (!inner_hits_node.IsArray()) {
         return Status::OK();
     }
-    _inner_hits_node.CopyFrom(inner_hits_node, _document_node.GetAllocator());
+    _inner_hits_node = &inner_hits_node;
     // how many documents contains in this batch
-    _size = _inner_hits_node.Size();
+    _size = _inner_hits_node->Size();
     return Status::OK();
 }
 
@@ -251,7 +265,7 @@ Status ScrollParser::fill_tuple(const TupleDescriptor* tuple_desc, Tuple* tuple,
         return Status::OK();
     }
 
-    const rapidjson::Value& obj = _inner_hits_node[_line_index++];
+    const rapidjson::Value& obj = (*_inner_hits_node)[_line_index++];
     bool pure_doc_value = false;
     if (obj.HasMember("fields")) {
         pure_doc_value = true;
@@ -288,34 +302,35 @@ Status ScrollParser::fill_tuple(const TupleDescriptor* tuple_desc, Tuple* tuple,
             tuple->set_not_null(slot_desc->null_indicator_offset());
             void* slot = tuple->get_slot(slot_desc->tuple_offset());
             // obj[FIELD_ID] must not be NULL
-            std::string _id = obj[FIELD_ID].GetString();
-            size_t len = _id.length();
-            char* buffer = reinterpret_cast<char*>(tuple_pool->try_allocate_unaligned(len));
-            if (UNLIKELY(buffer == NULL)) {
-                std::string details = strings::Substitute(ERROR_MEM_LIMIT_EXCEEDED,
-                                                          "MaterializeNextRow", len, "string slot");
-                return tuple_pool->mem_tracker()->MemLimitExceeded(NULL, details, len);
-            }
-            memcpy(buffer, _id.data(), len);
-            reinterpret_cast<StringValue*>(slot)->ptr = buffer;
-            reinterpret_cast<StringValue*>(slot)->len = len;
+            const rapidjson::Value& id = obj[FIELD_ID];
+            RETURN_IF_ERROR(
+                    fill_string_slot(slot, id.GetString(), id.GetStringLength(), tuple_pool));
             continue;
         }
 
         // if pure_doc_value enabled, docvalue_context must contains the key
         // todo: need move all `pure_docvalue` for every tuple outside fill_tuple
         //  should check pure_docvalue for one table scan not every tuple
-        const char* col_name = pure_doc_value ? docvalue_context.at(slot_desc->col_name()).c_str()
-                                              : slot_desc->col_name().c_str();
+        const std::string* col_name = &slot_desc->col_name();
+        if (pure_doc_value) {
+            if (_docvalue_names.empty()) {
+                _docvalue_names.resize(tuple_desc->slots().size());
+            }
+            if (_docvalue_names[i] == nullptr) {
+                _docvalue_names[i] = &docvalue_context.at(*col_name);
+            }
+            col_name = _docvalue_names[i];
+        }
 
-        rapidjson::Value::ConstMemberIterator itr = line.FindMember(col_name);
+        rapidjson::Value::ConstMemberIterator itr = line.FindMember(
+                rapidjson::StringRef(col_name->data(), col_name->size()));
         if (itr == line.MemberEnd()) {
             tuple->set_null(slot_desc->null_indicator_offset());
             continue;
         }
 
         tuple->set_not_null(slot_desc->null_indicator_offset());
-        const rapidjson::Value& col = line[col_name];
+        const rapidjson::Value& col = itr->value;
 
         void* slot = tuple->get_slot(slot_desc->tuple_offset());
         PrimitiveType type = slot_desc->type().type;
@@ -325,31 +340,17 @@ Status ScrollParser::fill_tuple(const TupleDescriptor* tuple_desc, Tuple* tuple,
             // sometimes elasticsearch user post some not-string value to Elasticsearch Index.
             // because of reading value from _source, we can not process all json type and then just transfer the value to original string representation
             // this may be a tricky, but we can workaround this issue
-            std::string val;
-            if (pure_doc_value) {
-                if (!col[0].IsString()) {
-                    val = json_value_to_string(col[0]);
-                } else {
-                    val = col[0].GetString();
-                }
-            } else {
+            if (!pure_doc_value) {
                 RETURN_ERROR_IF_COL_IS_ARRAY(col, type);
-                if (!col.IsString()) {
-                    val = json_value_to_string(col);
-                } else {
-                    val = col.GetString();
-                }
             }
-            size_t val_size = val.length();
-            char* buffer = reinterpret_cast<char*>(tuple_pool->try_allocate_unaligned(val_size));
-            if (UNLIKELY(buffer == NULL)) {
-                std::string details = strings::Substitute(
-                        ERROR_MEM_LIMIT_EXCEEDED, "MaterializeNextRow", val_size, "string slot");
-                return tuple_pool->mem_tracker()->MemLimitExceeded(NULL, details, val_size);
+            const rapidjson::Value& str = pure_doc_value ? col[0] : col;
+            if (str.IsString()) {
+                RETURN_IF_ERROR(
+                        fill_string_slot(slot, str.GetString(), str.GetStringLength(), tuple_pool));
+            } else {
+                std::string val = json_value_to_string(str);
+                RETURN_IF_ERROR(fill_string_slot(slot, val.data(), val.size(), tuple_pool));
             }
-            memcpy(buffer, val.data(), val_size);
-            reinterpret_cast<StringValue*>(slot)->ptr = buffer;
-            reinterpret_cast<StringValue*>(slot)->len = val_size;
             break;
         }
 
@@ -427,10 +428,8 @@ Status ScrollParser::fill_tuple(const TupleDescriptor* tuple_desc, Tuple* tuple,
             RETURN_ERROR_IF_COL_IS_ARRAY(col, type);
             RETURN_ERROR_IF_COL_IS_NOT_STRING(col, type);
 
-            const std::string& val = col.GetString();
-            size_t val_size = col.GetStringLength();
             StringParser::ParseResult result;
-            bool b = StringParser::string_to_bool(val.c_str(), val_size, &result);
+            bool b = StringParser::string_to_bool(col.GetString(), col.GetStringLength(), &result);
             RETURN_ERROR_IF_PARSING_FAILED(result, col, type);
             *reinterpret_cast<int8_t*>(slot) = b;
             break;
@@ -478,9 +477,7 @@ Status ScrollParser::fill_tuple(const TupleDescriptor* tuple_desc, Tuple* tuple,
 Status ScrollParser::fill_date_slot_with_strval(void* slot, const rapidjson::Value& col,
                                                 PrimitiveType type) {
     DateTimeValue* ts_slot = reinterpret_cast<DateTimeValue*>(slot);
-    const std::string& val = col.GetString();
-    size_t val_size = col.GetStringLength();
-    if (!ts_slot->from_date_str(val.c_str(), val_size)) {
+    if (!ts_slot->from_date_str(col.GetString(), col.GetStringLength())) {
         RETURN_ERROR_IF_CAST_FORMAT_ERROR(col, type);
     }
     if (type == TYPE_DATE) {
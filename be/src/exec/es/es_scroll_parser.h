@@ -18,6 +18,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include "rapidjson/document.h"
 #include "runtime/descriptors.h"
@@ -54,7 +55,10 @@ private:
     rapidjson::SizeType _line_index;
 
     rapidjson::Document _document_node;
-    rapidjson::Value _inner_hits_node;
+    // the hits in _document_node
+    const rapidjson::Value* _inner_hits_node;
+    // the docvalue field of each slot, looked up on the first row that needs it
+    std::vector<const std::string*> _docvalue_names;
 
     // todo(milimin): ScrollParser should be divided into two classes: SourceParser and DocValueParser,
     // including remove some variables in the current implementation, e.g. pure_doc_value.
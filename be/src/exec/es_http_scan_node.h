@@ -73,8 +73,14 @@ private:
     // Collect all scanners 's status
     Status collect_scanners_status();
 
+    // Whether the limit is pushed down to es.
+    bool push_down_limit() const;
+
     // One scanner worker, This scanner will handle 'length' ranges start from start_idx
-    void scanner_worker(int start_idx, int length, std::promise<Status>& p_status);
+    // 'slice_id' is the slice of the range it scrolls when the ranges are read with
+    // 'num_slices' sliced scrolls
+    void scanner_worker(int start_idx, int length, int slice_id, int num_slices,
+                        std::promise<Status>& p_status);
 
     // Scan one range
     Status scanner_scan(std::unique_ptr<EsHttpScanner> scanner,
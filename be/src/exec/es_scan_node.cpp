@@ -81,6 +81,7 @@ Status EsScanNode::open(RuntimeState* state) {
     RETURN_IF_ERROR(exec_debug_action(TExecNodePhase::OPEN));
     RETURN_IF_CANCELLED(state);
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_CPU_TIMER(_cpu_timer);
     RETURN_IF_ERROR(ExecNode::open(state));
 
     // TExtOpenParams.row_schema
@@ -201,6 +202,7 @@ Status EsScanNode::get_next(RuntimeState* state, RowBatch* row_batch, bool* eos)
     RETURN_IF_ERROR(exec_debug_action(TExecNodePhase::GETNEXT));
     RETURN_IF_CANCELLED(state);
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_CPU_TIMER(_cpu_timer);
 
     // create tuple
     MemPool* tuple_pool = row_batch->tuple_data_pool();
@@ -255,6 +257,7 @@ Status EsScanNode::close(RuntimeState* state) {
     VLOG(1) << "EsScanNode::Close";
     RETURN_IF_ERROR(exec_debug_action(TExecNodePhase::CLOSE));
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_CPU_TIMER(_cpu_timer);
     Expr::close(_pushdown_conjunct_ctxs, state);
     RETURN_IF_ERROR(ExecNode::close(state));
     for (int i = 0; i < _addresses.size(); ++i) {
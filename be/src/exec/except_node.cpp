@@ -49,25 +49,19 @@ Status ExceptNode::open(RuntimeState* state) {
     bool eos = false;
 
     for (int i = 1; i < _children.size(); ++i) {
-        // rebuild hash table, for first time will rebuild with the no duplicated _hash_tbl,
         if (i > 1) {
             SCOPED_TIMER(_build_timer);
-            std::unique_ptr<HashTable> temp_tbl(
-                    new HashTable(_child_expr_lists[0], _child_expr_lists[i], _build_tuple_size,
-                                  true, _find_nulls, id(), mem_tracker(), 1024));
-            _hash_tbl_iterator = _hash_tbl->begin();
-            while (_hash_tbl_iterator.has_next()) {
-                if (!_hash_tbl_iterator.matched()) {
-                    VLOG_ROW << "rebuild row: "
-                             << get_row_output_string(_hash_tbl_iterator.get_row(),
-                                                      child(0)->row_desc());
-                    temp_tbl->insert(_hash_tbl_iterator.get_row());
-                }
-                _hash_tbl_iterator.next<false>();
+            // keep only the rows the last child didn't match, in place
+            _hash_tbl->retain(false);
+            _hash_tbl->set_probe_exprs(_child_expr_lists[i]);
+            VLOG_ROW << "hash table content: "
+                     << _hash_tbl->debug_string(true, &child(0)->row_desc());
+            // if a table is empty, the result must be empty
+            if (_hash_tbl->size() == 0) {
+                break;
             }
-            _hash_tbl.swap(temp_tbl);
-            temp_tbl->close();
         }
+        RETURN_IF_ERROR(push_down_hash_table_keys(state, i));
         // probe
         _probe_batch.reset(
                 new RowBatch(child(i)->row_desc(), state->batch_size(), mem_tracker().get()));
@@ -104,6 +98,7 @@ Status ExceptNode::get_next(RuntimeState* state, RowBatch* out_batch, bool* eos)
     RETURN_IF_ERROR(exec_debug_action(TExecNodePhase::GETNEXT));
     RETURN_IF_CANCELLED(state);
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_CPU_TIMER(_cpu_timer);
     *eos = true;
     if (reached_limit()) {
         return Status::OK();
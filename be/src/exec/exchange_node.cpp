@@ -66,7 +66,7 @@ Status ExchangeNode::prepare(RuntimeState* state) {
     _stream_recvr = state->exec_env()->stream_mgr()->create_recvr(
             state, _input_row_desc, state->fragment_instance_id(), _id, _num_senders,
             config::exchg_node_buffer_size_bytes, _runtime_profile.get(), _is_merging,
-            _sub_plan_query_statistics_recvr);
+            _sub_plan_query_statistics_recvr, _can_spill);
     if (_is_merging) {
         RETURN_IF_ERROR(_sort_exec_exprs.prepare(state, _row_descriptor, _row_descriptor,
                                                  expr_mem_tracker()));
@@ -77,6 +77,7 @@ Status ExchangeNode::prepare(RuntimeState* state) {
 
 Status ExchangeNode::open(RuntimeState* state) {
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_CPU_TIMER(_cpu_timer);
     RETURN_IF_ERROR(ExecNode::open(state));
     if (_is_merging) {
         RETURN_IF_ERROR(_sort_exec_exprs.open(state));
@@ -127,9 +128,11 @@ Status ExchangeNode::fill_input_row_batch(RuntimeState* state) {
 Status ExchangeNode::get_next(RuntimeState* state, RowBatch* output_batch, bool* eos) {
     RETURN_IF_ERROR(exec_debug_action(TExecNodePhase::GETNEXT));
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_CPU_TIMER(_cpu_timer);
 
     if (reached_limit()) {
         _stream_recvr->transfer_all_resources(output_batch);
+        _stream_recvr->finish();
         *eos = true;
         return Status::OK();
     } else {
@@ -176,6 +179,8 @@ Status ExchangeNode::get_next(RuntimeState* state, RowBatch* output_batch, bool*
 
             if (reached_limit()) {
                 _stream_recvr->transfer_all_resources(output_batch);
+                // tell the senders to stop, so their fragments stop scanning early
+                _stream_recvr->finish();
                 *eos = true;
                 return Status::OK();
             }
@@ -225,7 +230,8 @@ Status ExchangeNode::get_next_merging(RuntimeState* state, RowBatch* output_batc
     }
 
     _num_rows_returned += output_batch->num_rows();
-    if (reached_limit()) {
+    bool limit_reached = reached_limit();
+    if (limit_reached) {
         output_batch->set_num_rows(output_batch->num_rows() - (_num_rows_returned - _limit));
         *eos = true;
     }
@@ -235,6 +241,9 @@ Status ExchangeNode::get_next_merging(RuntimeState* state, RowBatch* output_batc
     if (*eos) {
         _stream_recvr->transfer_all_resources(output_batch);
     }
+    if (limit_reached) {
+        _stream_recvr->finish();
+    }
 
     COUNTER_SET(_rows_returned_counter, _num_rows_returned);
     return Status::OK();
@@ -57,6 +57,11 @@ public:
     // recorded in TPlanNode, and before calling prepare()
     void set_num_senders(int num_senders) { _num_senders = num_senders; }
 
+    // Called by the parent before prepare() if it consumes all the rows of this node before
+    // returning any, e.g. the build side of a hash join, so that the receiver may spill
+    // rather than blocking the senders.
+    void set_can_spill() { _can_spill = true; }
+
 protected:
     virtual void debug_string(int indentation_level, std::stringstream* out) const;
 
@@ -70,6 +75,7 @@ private:
     Status fill_input_row_batch(RuntimeState* state);
 
     int _num_senders; // needed for _stream_recvr construction
+    bool _can_spill = false;
 
     // created in prepare() and owned by the RuntimeState
     boost::shared_ptr<DataStreamRecvr> _stream_recvr;
@@ -50,6 +50,7 @@
 #include "exec/spill_sort_node.h"
 #include "exec/topn_node.h"
 #include "exec/union_node.h"
+#include "exprs/expr_column.h"
 #include "exprs/expr_context.h"
 #include "odbc_scan_node.h"
 #include "runtime/descriptors.h"
@@ -167,6 +168,9 @@ Status ExecNode::prepare(RuntimeState* state) {
     RETURN_IF_ERROR(exec_debug_action(TExecNodePhase::PREPARE));
     DCHECK(_runtime_profile.get() != NULL);
     _rows_returned_counter = ADD_COUNTER(_runtime_profile, "RowsReturned", TUnit::UNIT);
+    if (!config::fragment_exec_in_bthread) {
+        _cpu_timer = ADD_TIMER(_runtime_profile, "CpuTime");
+    }
     _rows_returned_rate = runtime_profile()->add_derived_counter(
             ROW_THROUGHPUT_COUNTER, TUnit::UNIT_PER_SECOND,
             boost::bind<int64_t>(&RuntimeProfile::units_per_second, _rows_returned_counter,
@@ -500,6 +504,24 @@ bool ExecNode::eval_conjuncts(ExprContext* const* ctxs, int num_ctxs, TupleRow*
     return true;
 }
 
+int ExecNode::eval_conjuncts(ExprContext* const* ctxs, int num_ctxs, RowBatch* batch, int* sel,
+                             int num_sel) {
+    ExprColumn column;
+    for (int i = 0; i < num_ctxs && num_sel > 0; ++i) {
+        ctxs[i]->evaluate_batch(batch, sel, num_sel, &column);
+        const BooleanVal* values = column.values<BooleanVal>();
+        int num_passed = 0;
+        for (int j = 0; j < num_sel; ++j) {
+            // compact without branching on the result
+            int idx = sel[j];
+            sel[num_passed] = idx;
+            num_passed += !values[idx].is_null & values[idx].val;
+        }
+        num_sel = num_passed;
+    }
+    return num_sel;
+}
+
 void ExecNode::collect_nodes(TPlanNodeType::type node_type, std::vector<ExecNode*>* nodes) {
     if (_type == node_type) {
         nodes->push_back(this);
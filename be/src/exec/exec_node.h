@@ -159,6 +159,12 @@ public:
     // out how to deal with declaring a templated std:vector type in IR
     static bool eval_conjuncts(ExprContext* const* ctxs, int num_ctxs, TupleRow* row);
 
+    // Batch version of eval_conjuncts(): evaluate exprs a batch at a time over the rows
+    // 'sel[0, num_sel)' of 'batch', and keep in 'sel', in order, the rows all of them
+    // return true for. Returns the number of rows kept.
+    static int eval_conjuncts(ExprContext* const* ctxs, int num_ctxs, RowBatch* batch, int* sel,
+                              int num_sel);
+
     // Returns a string representation in DFS order of the plan rooted at this.
     std::string debug_string() const;
 
@@ -300,6 +306,10 @@ protected:
     RuntimeProfile::Counter* _rows_returned_rate;
     // Account for peak memory used by this node
     RuntimeProfile::Counter* _memory_used_counter;
+    // Thread cpu time spent in this node, including the children it calls on the same
+    // thread. Unlike the total time it doesn't count the time waiting for io or rpc.
+    // Null if the fragments run as bthreads, the cpu time of a thread is meaningless then.
+    RuntimeProfile::Counter* _cpu_timer = nullptr;
 
     // Execution options that are determined at runtime.  This is added to the
     // runtime profile at close().  Examples for options logged here would be
@@ -20,6 +20,7 @@
 #include <stdint.h>
 
 #include "common/status.h"
+#include "util/byte_buffer.h"
 
 namespace doris {
 
@@ -45,6 +46,17 @@ public:
      * !! Important !!
      */
     virtual Status read_one_message(uint8_t** buf, size_t* length) = 0;
+
+    // Whether the content can be taken by read_buffer(), i.e. the reader keeps it in
+    // refcounted buffers.
+    virtual bool supports_read_buffer() const { return false; }
+
+    // Takes the next buffer of the content, so that the caller reads it without copying.
+    // 'buf' is set to nullptr at the end of the content.
+    virtual Status read_buffer(ByteBufferPtr* buf) {
+        return Status::NotSupported("read_buffer is not supported");
+    }
+
     virtual int64_t size() = 0;
     virtual Status seek(int64_t position) = 0;
     virtual Status tell(int64_t* position) = 0;
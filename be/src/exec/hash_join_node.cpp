@@ -17,15 +17,26 @@
 
 #include "exec/hash_join_node.h"
 
+#include <chrono>
+#include <memory>
+#include <mutex>
 #include <sstream>
 
+#include "common/config.h"
+#include "exec/exchange_node.h"
 #include "exec/hash_table.hpp"
 #include "exprs/expr.h"
 #include "exprs/in_predicate.h"
+#include "exprs/minmax_filter.h"
 #include "exprs/slot_ref.h"
 #include "gen_cpp/PlanNodes_types.h"
+#include "runtime/buffered_tuple_stream3.inline.h"
+#include "runtime/exec_env.h"
+#include "runtime/raw_value.h"
 #include "runtime/row_batch.h"
 #include "runtime/runtime_state.h"
+#include "runtime/shared_hash_table_mgr.h"
+#include "util/hash_util.hpp"
 #include "util/runtime_profile.h"
 
 namespace doris {
@@ -36,7 +47,10 @@ HashJoinNode::HashJoinNode(ObjectPool* pool, const TPlanNode& tnode, const Descr
           _probe_eos(false),
           _process_build_batch_fn(NULL),
           _process_probe_batch_fn(NULL),
-          _anti_join_last_pos(NULL) {
+          _anti_join_last_pos(NULL),
+          _stores_nulls(false),
+          _spilled(false),
+          _input_partition_eos(false) {
     _match_all_probe =
             (_join_op == TJoinOp::LEFT_OUTER_JOIN || _join_op == TJoinOp::FULL_OUTER_JOIN);
     _match_one_build = (_join_op == TJoinOp::LEFT_SEMI_JOIN);
@@ -44,6 +58,8 @@ HashJoinNode::HashJoinNode(ObjectPool* pool, const TPlanNode& tnode, const Descr
             (_join_op == TJoinOp::RIGHT_OUTER_JOIN || _join_op == TJoinOp::FULL_OUTER_JOIN);
     _is_push_down = tnode.hash_join_node.is_push_down;
     _build_unique = _join_op == TJoinOp::LEFT_ANTI_JOIN || _join_op == TJoinOp::LEFT_SEMI_JOIN;
+    _is_broadcast_join = tnode.hash_join_node.__isset.is_broadcast_join &&
+                         tnode.hash_join_node.is_broadcast_join;
 }
 
 HashJoinNode::~HashJoinNode() {
@@ -83,6 +99,9 @@ Status HashJoinNode::init(const TPlanNode& tnode, RuntimeState* state) {
 }
 
 Status HashJoinNode::prepare(RuntimeState* state) {
+    if (child(1)->type() == TPlanNodeType::EXCHANGE_NODE) {
+        static_cast<ExchangeNode*>(child(1))->set_can_spill();
+    }
     RETURN_IF_ERROR(ExecNode::prepare(state));
 
     _build_pool.reset(new MemPool(mem_tracker().get()));
@@ -95,6 +114,8 @@ Status HashJoinNode::prepare(RuntimeState* state) {
     _probe_rows_counter = ADD_COUNTER(runtime_profile(), "ProbeRows", TUnit::UNIT);
     _hash_tbl_load_factor_counter =
             ADD_COUNTER(runtime_profile(), "LoadFactor", TUnit::DOUBLE_VALUE);
+    _spilled_partitions_counter = ADD_COUNTER(runtime_profile(), "SpilledPartitions", TUnit::UNIT);
+    _num_repartitions_counter = ADD_COUNTER(runtime_profile(), "NumRepartitions", TUnit::UNIT);
 
     // build and probe exprs are evaluated in the context of the rows produced by our
     // right and left children, respectively
@@ -126,13 +147,16 @@ Status HashJoinNode::prepare(RuntimeState* state) {
     _build_tuple_row_size = num_build_tuples * sizeof(Tuple*);
 
     // TODO: default buckets
-    const bool stores_nulls =
+    _stores_nulls =
             _join_op == TJoinOp::RIGHT_OUTER_JOIN || _join_op == TJoinOp::FULL_OUTER_JOIN ||
             _join_op == TJoinOp::RIGHT_ANTI_JOIN || _join_op == TJoinOp::RIGHT_SEMI_JOIN ||
             (std::find(_is_null_safe_eq_join.begin(), _is_null_safe_eq_join.end(), true) !=
              _is_null_safe_eq_join.end());
-    _hash_tbl.reset(new HashTable(_build_expr_ctxs, _probe_expr_ctxs, _build_tuple_size,
-                                  stores_nulls, _is_null_safe_eq_join, id(), mem_tracker(), 1024));
+    _hash_tbl.reset(_create_hash_table());
+    if (_can_share_hash_table(state)) {
+        _shared_hash_table =
+                state->exec_env()->shared_hash_table_mgr()->get(state->query_id(), id());
+    }
 
     _probe_batch.reset(
             new RowBatch(child(0)->row_desc(), state->batch_size(), mem_tracker().get()));
@@ -149,12 +173,30 @@ Status HashJoinNode::close(RuntimeState* state) {
     // Must reset _probe_batch in close() to release resources
     _probe_batch.reset(NULL);
 
+    if (_input_partition != nullptr) {
+        _close_partition(_input_partition.get(), nullptr);
+        _input_partition.reset();
+    }
+    for (auto& partition : _hash_partitions) {
+        _close_partition(partition.get(), nullptr);
+    }
+    _hash_partitions.clear();
+    for (auto& partition : _spilled_partitions) {
+        _close_partition(partition.get(), nullptr);
+    }
+    _spilled_partitions.clear();
+
     if (_hash_tbl.get() != NULL) {
         _hash_tbl->close();
     }
-    if (_build_pool.get() != NULL) {
+    // A shared build pool is freed with the last instance holding it
+    if (_build_pool.get() != NULL && _shared_hash_table == nullptr) {
         _build_pool->free_all();
     }
+    if (_shared_hash_table != nullptr) {
+        state->exec_env()->shared_hash_table_mgr()->release(state->query_id(), id(),
+                                                            &_shared_hash_table);
+    }
 
     Expr::close(_build_expr_ctxs, state);
     Expr::close(_probe_expr_ctxs, state);
@@ -177,6 +219,58 @@ void HashJoinNode::build_side_thread(RuntimeState* state, boost::promise<Status>
 }
 
 Status HashJoinNode::construct_hash_table(RuntimeState* state) {
+    if (_shared_hash_table == nullptr) {
+        return _build_hash_table(state);
+    }
+
+    SharedHashTable* shared = _shared_hash_table.get();
+    bool build = false;
+    {
+        std::lock_guard<std::mutex> l(shared->lock);
+        build = !shared->building;
+        shared->building = true;
+    }
+
+    if (!build) {
+        // The build rows sent to this instance aren't needed. The build side is closed
+        // before waiting, so that its receiver drops them as they arrive. Otherwise its
+        // full queue would block the broadcast sender, which the builder waits for.
+        RETURN_IF_ERROR(child(1)->close(state));
+        {
+            std::unique_lock<std::mutex> l(shared->lock);
+            while (!shared->done) {
+                shared->cv.wait_for(l, std::chrono::milliseconds(100));
+                RETURN_IF_CANCELLED(state);
+            }
+        }
+        RETURN_IF_ERROR(shared->status);
+        _hash_tbl->share_build(shared->table);
+        add_runtime_exec_option("Shared Broadcast Hash Table");
+        COUNTER_SET(_build_rows_counter, _hash_tbl->size());
+        COUNTER_SET(_build_buckets_counter, _hash_tbl->num_buckets());
+        COUNTER_SET(_hash_tbl_load_factor_counter, _hash_tbl->load_factor());
+        return Status::OK();
+    }
+
+    Status status = _build_hash_table(state);
+    if (status.ok()) {
+        _hash_tbl->set_build_shared();
+    }
+    {
+        std::lock_guard<std::mutex> l(shared->lock);
+        shared->status = status;
+        if (status.ok()) {
+            shared->mem_tracker = mem_tracker();
+            shared->build_pool = _build_pool;
+            shared->table = _hash_tbl;
+        }
+        shared->done = true;
+    }
+    shared->cv.notify_all();
+    return status;
+}
+
+Status HashJoinNode::_build_hash_table(RuntimeState* state) {
     // Do a full scan of child(1) and store everything in _hash_tbl
     // The hash join node needs to keep in memory all build tuples, including the tuple
     // row ptrs.  The row ptrs are copied into the hash table's internal structure so they
@@ -189,8 +283,28 @@ Status HashJoinNode::construct_hash_table(RuntimeState* state) {
         bool eos = true;
         RETURN_IF_ERROR(child(1)->get_next(state, &build_batch, &eos));
         SCOPED_TIMER(_build_timer);
+        if (_spilled) {
+            COUNTER_UPDATE(_build_rows_counter, build_batch.num_rows());
+            RETURN_IF_ERROR(_partition_batch(&build_batch, true));
+            build_batch.reset();
+            if (eos) {
+                break;
+            }
+            continue;
+        }
+
         // take ownership of tuple data of build_batch
         _build_pool->acquire_data(build_batch.tuple_data_pool(), false);
+        if (_can_spill(state) &&
+            state->instance_mem_tracker()->find_limit_exceeded_tracker() != nullptr) {
+            COUNTER_UPDATE(_build_rows_counter, build_batch.num_rows());
+            RETURN_IF_ERROR(_spill_build_side(state, &build_batch));
+            build_batch.reset();
+            if (eos) {
+                break;
+            }
+            continue;
+        }
         RETURN_IF_LIMIT_EXCEEDED(state, "Hash join, while constructing the hash table.");
 
         // Call codegen version if possible
@@ -212,6 +326,10 @@ Status HashJoinNode::construct_hash_table(RuntimeState* state) {
         }
     }
 
+    if (!_spilled && _hash_tbl->build_direct_map()) {
+        add_runtime_exec_option("Direct Mapped Join Keys");
+    }
+
     return Status::OK();
 }
 
@@ -219,6 +337,7 @@ Status HashJoinNode::open(RuntimeState* state) {
     RETURN_IF_ERROR(ExecNode::open(state));
     RETURN_IF_ERROR(exec_debug_action(TExecNodePhase::OPEN));
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_CPU_TIMER(_cpu_timer);
     RETURN_IF_CANCELLED(state);
     RETURN_IF_ERROR(Expr::open(_build_expr_ctxs, state));
     RETURN_IF_ERROR(Expr::open(_probe_expr_ctxs, state));
@@ -260,64 +379,38 @@ Status HashJoinNode::open(RuntimeState* state) {
         // phase.
         RETURN_IF_ERROR(thread_status.get_future().get());
 
-        if (_hash_tbl->size() == 0 && _join_op == TJoinOp::INNER_JOIN) {
-            // Hash table size is zero
-            LOG(INFO) << "No element need to push down, no need to read probe table";
-            RETURN_IF_ERROR(child(0)->open(state));
-            _probe_batch_pos = 0;
-            _hash_tbl_iterator = _hash_tbl->begin();
-            _eos = true;
-            return Status::OK();
-        }
-
-        if (_hash_tbl->size() > 1024) {
+        if (_spilled) {
+            // The build rows are partitioned on disk, there are no keys in the hash
+            // table to create the predicates from.
             _is_push_down = false;
-        }
-
-        // TODO: this is used for Code Check, Remove this later
-        if (_is_push_down || 0 != child(1)->conjunct_ctxs().size()) {
-            for (int i = 0; i < _probe_expr_ctxs.size(); ++i) {
-                TExprNode node;
-                node.__set_node_type(TExprNodeType::IN_PRED);
-                TScalarType tscalar_type;
-                tscalar_type.__set_type(TPrimitiveType::BOOLEAN);
-                TTypeNode ttype_node;
-                ttype_node.__set_type(TTypeNodeType::SCALAR);
-                ttype_node.__set_scalar_type(tscalar_type);
-                TTypeDesc t_type_desc;
-                t_type_desc.types.push_back(ttype_node);
-                node.__set_type(t_type_desc);
-                node.in_predicate.__set_is_not_in(false);
-                node.__set_opcode(TExprOpcode::FILTER_IN);
-                node.__isset.vector_opcode = true;
-                node.__set_vector_opcode(to_in_opcode(_probe_expr_ctxs[i]->root()->type().type));
-                // NOTE(zc): in predicate only used here, no need prepare.
-                InPredicate* in_pred = _pool->add(new InPredicate(node));
-                RETURN_IF_ERROR(in_pred->prepare(state, _probe_expr_ctxs[i]->root()->type()));
-                in_pred->add_child(Expr::copy(_pool, _probe_expr_ctxs[i]->root()));
-                ExprContext* ctx = _pool->add(new ExprContext(in_pred));
-                _push_down_expr_ctxs.push_back(ctx);
+        } else {
+            if (_hash_tbl->size() == 0 && (_join_op == TJoinOp::INNER_JOIN ||
+                                           _join_op == TJoinOp::LEFT_SEMI_JOIN)) {
+                // Hash table size is zero
+                LOG(INFO) << "No element need to push down, no need to read probe table";
+                RETURN_IF_ERROR(child(0)->open(state));
+                _probe_batch_pos = 0;
+                _probe_prefetch_end = 0;
+                _hash_tbl_iterator = _hash_tbl->begin();
+                _eos = true;
+                return Status::OK();
             }
 
-            {
-                SCOPED_TIMER(_push_compute_timer);
-                HashTable::Iterator iter = _hash_tbl->begin();
-
-                while (iter.has_next()) {
-                    TupleRow* row = iter.get_row();
-                    std::list<ExprContext*>::iterator ctx_iter = _push_down_expr_ctxs.begin();
-
-                    for (int i = 0; i < _build_expr_ctxs.size(); ++i, ++ctx_iter) {
-                        void* val = _build_expr_ctxs[i]->get_value(row);
-                        InPredicate* in_pre = (InPredicate*)((*ctx_iter)->root());
-                        in_pre->insert(val);
-                    }
+            if (_hash_tbl->size() > config::join_push_down_in_max_num) {
+                _is_push_down = false;
+            }
 
-                    SCOPED_TIMER(_build_timer);
-                    iter.next<false>();
-                }
+            // TODO: this is used for Code Check, Remove this later
+            if (_is_push_down || 0 != child(1)->conjunct_ctxs().size()) {
+                RETURN_IF_ERROR(_create_in_push_down_exprs(state));
+            } else if (config::enable_join_minmax_push_down) {
+                // Too many distinct keys for an IN predicate, push down the range of
+                // the build keys instead, so the scan node can still prune with it.
+                RETURN_IF_ERROR(_create_minmax_push_down_exprs(state));
             }
+        }
 
+        if (!_push_down_expr_ctxs.empty()) {
             SCOPED_TIMER(_push_down_timer);
             push_down_predicate(state, &_push_down_expr_ctxs);
         }
@@ -344,11 +437,25 @@ Status HashJoinNode::open(RuntimeState* state) {
         RETURN_IF_ERROR(open_status);
     }
 
+    if (_spilled) {
+        RETURN_IF_ERROR(_partition_probe_side(state));
+        RETURN_IF_ERROR(_next_spilled_partition(state));
+        // Start with an empty probe batch, left_join_get_next() gets the probe rows
+        // of the partitions.
+        _probe_batch_pos = 0;
+        _probe_prefetch_end = 0;
+        _matched_probe = true;
+        _hash_tbl_iterator = _hash_tbl->end();
+        _probe_eos = _input_partition == nullptr;
+        return Status::OK();
+    }
+
     // seed probe batch and _current_probe_row, etc.
     while (true) {
         RETURN_IF_ERROR(child(0)->get_next(state, _probe_batch.get(), &_probe_eos));
         COUNTER_UPDATE(_probe_rows_counter, _probe_batch->num_rows());
         _probe_batch_pos = 0;
+        _probe_prefetch_end = 0;
 
         if (_probe_batch->num_rows() == 0) {
             if (_probe_eos) {
@@ -371,10 +478,94 @@ Status HashJoinNode::open(RuntimeState* state) {
     return Status::OK();
 }
 
+Status HashJoinNode::_create_in_push_down_exprs(RuntimeState* state) {
+    for (int i = 0; i < _probe_expr_ctxs.size(); ++i) {
+        TExprNode node;
+        node.__set_node_type(TExprNodeType::IN_PRED);
+        TScalarType tscalar_type;
+        tscalar_type.__set_type(TPrimitiveType::BOOLEAN);
+        TTypeNode ttype_node;
+        ttype_node.__set_type(TTypeNodeType::SCALAR);
+        ttype_node.__set_scalar_type(tscalar_type);
+        TTypeDesc t_type_desc;
+        t_type_desc.types.push_back(ttype_node);
+        node.__set_type(t_type_desc);
+        node.in_predicate.__set_is_not_in(false);
+        node.__set_opcode(TExprOpcode::FILTER_IN);
+        node.__isset.vector_opcode = true;
+        node.__set_vector_opcode(to_in_opcode(_probe_expr_ctxs[i]->root()->type().type));
+        // NOTE(zc): in predicate only used here, no need prepare.
+        InPredicate* in_pred = _pool->add(new InPredicate(node));
+        RETURN_IF_ERROR(in_pred->prepare(state, _probe_expr_ctxs[i]->root()->type()));
+        in_pred->add_child(Expr::copy(_pool, _probe_expr_ctxs[i]->root()));
+        ExprContext* ctx = _pool->add(new ExprContext(in_pred));
+        _push_down_expr_ctxs.push_back(ctx);
+    }
+
+    SCOPED_TIMER(_push_compute_timer);
+    HashTable::Iterator iter = _hash_tbl->begin();
+
+    while (iter.has_next()) {
+        TupleRow* row = iter.get_row();
+        std::list<ExprContext*>::iterator ctx_iter = _push_down_expr_ctxs.begin();
+
+        for (int i = 0; i < _build_expr_ctxs.size(); ++i, ++ctx_iter) {
+            void* val = _build_expr_ctxs[i]->get_value(row);
+            InPredicate* in_pre = (InPredicate*)((*ctx_iter)->root());
+            in_pre->insert(val);
+        }
+
+        SCOPED_TIMER(_build_timer);
+        iter.next<false>();
+    }
+    return Status::OK();
+}
+
+Status HashJoinNode::_create_minmax_push_down_exprs(RuntimeState* state) {
+    SCOPED_TIMER(_push_compute_timer);
+    // Only keys of supported types get a filter, others are skipped
+    std::vector<int> key_idxs;
+    std::vector<std::unique_ptr<MinMaxFilter>> filters;
+    for (int i = 0; i < _build_expr_ctxs.size(); ++i) {
+        const TypeDescriptor& type = _probe_expr_ctxs[i]->root()->type();
+        if (!MinMaxFilter::is_supported(type) || type != _build_expr_ctxs[i]->root()->type()) {
+            continue;
+        }
+        key_idxs.push_back(i);
+        filters.emplace_back(new MinMaxFilter(type));
+    }
+    if (key_idxs.empty()) {
+        return Status::OK();
+    }
+
+    HashTable::Iterator iter = _hash_tbl->begin();
+    while (iter.has_next()) {
+        TupleRow* row = iter.get_row();
+        for (int i = 0; i < key_idxs.size(); ++i) {
+            void* val = _build_expr_ctxs[key_idxs[i]]->get_value(row);
+            // NULL never matches an equal join key
+            if (val != nullptr) {
+                filters[i]->insert(val);
+            }
+        }
+        iter.next<false>();
+    }
+
+    for (int i = 0; i < key_idxs.size(); ++i) {
+        if (filters[i]->empty()) {
+            continue;
+        }
+        RETURN_IF_ERROR(filters[i]->create_predicates(
+                _pool, _probe_expr_ctxs[key_idxs[i]]->root(), &_push_down_expr_ctxs));
+    }
+    return Status::OK();
+}
+
 Status HashJoinNode::get_next(RuntimeState* state, RowBatch* out_batch, bool* eos) {
     RETURN_IF_ERROR(exec_debug_action(TExecNodePhase::GETNEXT));
     RETURN_IF_CANCELLED(state);
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_CPU_TIMER(_cpu_timer);
 
     if (reached_limit()) {
         *eos = true;
@@ -509,6 +700,7 @@ Status HashJoinNode::get_next(RuntimeState* state, RowBatch* out_batch, bool* eo
             // pass on resources, out_batch might still need them
             _probe_batch->transfer_resource_ownership(out_batch);
             _probe_batch_pos = 0;
+            _probe_prefetch_end = 0;
 
             if (out_batch->is_full() || out_batch->at_resource_limit()) {
                 return Status::OK();
@@ -648,6 +840,7 @@ Status HashJoinNode::left_join_get_next(RuntimeState* state, RowBatch* out_batch
         if (!_hash_tbl_iterator.has_next() && _probe_batch_pos == _probe_batch->num_rows()) {
             _probe_batch->transfer_resource_ownership(out_batch);
             _probe_batch_pos = 0;
+            _probe_prefetch_end = 0;
 
             if (out_batch->is_full() || out_batch->at_resource_limit()) {
                 break;
@@ -658,9 +851,18 @@ Status HashJoinNode::left_join_get_next(RuntimeState* state, RowBatch* out_batch
                 break;
             } else {
                 probe_timer.stop();
-                RETURN_IF_ERROR(child(0)->get_next(state, _probe_batch.get(), &_probe_eos));
+                if (_spilled) {
+                    RETURN_IF_ERROR(_get_next_spilled_probe_batch(state, out_batch));
+                } else {
+                    RETURN_IF_ERROR(child(0)->get_next(state, _probe_batch.get(), &_probe_eos));
+                    COUNTER_UPDATE(_probe_rows_counter, _probe_batch->num_rows());
+                }
                 probe_timer.start();
-                COUNTER_UPDATE(_probe_rows_counter, _probe_batch->num_rows());
+                // Buffers of a finished partition have been attached to out_batch,
+                // it must be returned before adding more rows.
+                if (out_batch->is_full()) {
+                    break;
+                }
             }
         }
     }
@@ -668,6 +870,290 @@ Status HashJoinNode::left_join_get_next(RuntimeState* state, RowBatch* out_batch
     return Status::OK();
 }
 
+HashTable* HashJoinNode::_create_hash_table() {
+    return new HashTable(_build_expr_ctxs, _probe_expr_ctxs, _build_tuple_size, _stores_nulls,
+                         _is_null_safe_eq_join, id(), mem_tracker(), 1024);
+}
+
+bool HashJoinNode::_can_spill(RuntimeState* state) const {
+    return state->enable_spill() && !_match_all_build && _join_op != TJoinOp::RIGHT_SEMI_JOIN &&
+           _join_op != TJoinOp::RIGHT_ANTI_JOIN && _shared_hash_table == nullptr;
+}
+
+bool HashJoinNode::_can_share_hash_table(RuntimeState* state) const {
+    if (!_is_broadcast_join || !config::enable_shared_broadcast_hash_table) {
+        return false;
+    }
+    // Joins marking the build rows they matched can't share them
+    if (_join_op != TJoinOp::INNER_JOIN && _join_op != TJoinOp::LEFT_OUTER_JOIN &&
+        _join_op != TJoinOp::LEFT_SEMI_JOIN && _join_op != TJoinOp::LEFT_ANTI_JOIN) {
+        return false;
+    }
+    // Only the rows received from the broadcast are the same in all the instances
+    if (child(1)->type() != TPlanNodeType::EXCHANGE_NODE) {
+        return false;
+    }
+    return state->exec_env() != nullptr &&
+           state->exec_env()->shared_hash_table_mgr() != nullptr;
+}
+
+Status HashJoinNode::_spill_error(const std::string& msg) {
+    std::stringstream ss;
+    ss << "Hash join node " << id() << " " << msg << ", " << _buffer_pool_client.DebugString();
+    return Status::MemoryLimitExceeded(ss.str());
+}
+
+Status HashJoinNode::_spill_build_side(RuntimeState* state, RowBatch* build_batch) {
+    LOG(INFO) << "Hash join node " << id() << " exceeds memory limit with " << _hash_tbl->size()
+              << " build rows, switch to grace hash join";
+    add_runtime_exec_option("Spilled");
+    if (!_buffer_pool_client.is_registered()) {
+        RETURN_IF_ERROR(claim_buffer_reservation(state));
+    }
+    RETURN_IF_ERROR(_create_hash_partitions(state, 0));
+    _spilled = true;
+
+    HashTable::Iterator iter = _hash_tbl->begin();
+    while (iter.has_next()) {
+        RETURN_IF_ERROR(_add_to_partition(iter.get_row(), true));
+        iter.next<false>();
+    }
+    RETURN_IF_ERROR(_partition_batch(build_batch, true));
+
+    // All the rows referencing _build_pool have been copied to the streams
+    _hash_tbl->close();
+    _hash_tbl.reset(_create_hash_table());
+    _build_pool->free_all();
+    return Status::OK();
+}
+
+Status HashJoinNode::_create_hash_partitions(RuntimeState* state, int level) {
+    DCHECK(_hash_partitions.empty());
+    for (int i = 0; i < PARTITION_FANOUT; ++i) {
+        std::unique_ptr<Partition> partition(new Partition());
+        partition->level = level;
+        partition->build_rows.reset(new BufferedTupleStream3(
+                state, &child(1)->row_desc(), &_buffer_pool_client,
+                _resource_profile.spillable_buffer_size, _resource_profile.max_row_buffer_size));
+        _hash_partitions.push_back(std::move(partition));
+
+        BufferedTupleStream3* stream = _hash_partitions.back()->build_rows.get();
+        RETURN_IF_ERROR(stream->Init(id(), false));
+        bool got_buffer = false;
+        RETURN_IF_ERROR(stream->PrepareForWrite(&got_buffer));
+        if (!got_buffer) {
+            return _spill_error("failed to get buffers to partition the build rows");
+        }
+    }
+    return Status::OK();
+}
+
+Status HashJoinNode::_prepare_probe_partitions(RuntimeState* state) {
+    for (auto& partition : _hash_partitions) {
+        partition->build_rows->UnpinStream(BufferedTupleStream3::UNPIN_ALL);
+    }
+    for (auto& partition : _hash_partitions) {
+        partition->probe_rows.reset(new BufferedTupleStream3(
+                state, &child(0)->row_desc(), &_buffer_pool_client,
+                _resource_profile.spillable_buffer_size, _resource_profile.max_row_buffer_size));
+        RETURN_IF_ERROR(partition->probe_rows->Init(id(), false));
+        bool got_buffer = false;
+        RETURN_IF_ERROR(partition->probe_rows->PrepareForWrite(&got_buffer));
+        if (!got_buffer) {
+            return _spill_error("failed to get buffers to partition the probe rows");
+        }
+    }
+    return Status::OK();
+}
+
+uint32_t HashJoinNode::_partition_hash(TupleRow* row, const std::vector<ExprContext*>& exprs,
+                                       int level) const {
+    // A different seed on each level, so that the rows of a partition are spread
+    // when it's partitioned again.
+    uint32_t hash = HashUtil::hash(&level, sizeof(level), HashUtil::FNV_SEED);
+    for (int i = 0; i < exprs.size(); ++i) {
+        hash = RawValue::get_hash_value(exprs[i]->get_value(row), exprs[i]->root()->type().type,
+                                        hash);
+    }
+    // The hash table of the partition hashes the same keys, mix the bits so that
+    // the rows of a partition don't crowd in a part of its buckets.
+    return HashUtil::fmix32(hash);
+}
+
+Status HashJoinNode::_add_to_partition(TupleRow* row, bool is_build) {
+    DCHECK_EQ(PARTITION_FANOUT, _hash_partitions.size());
+    const std::vector<ExprContext*>& exprs = is_build ? _build_expr_ctxs : _probe_expr_ctxs;
+    uint32_t hash = _partition_hash(row, exprs, _hash_partitions[0]->level);
+    Partition* partition = _hash_partitions[hash % PARTITION_FANOUT].get();
+    BufferedTupleStream3* stream =
+            is_build ? partition->build_rows.get() : partition->probe_rows.get();
+    Status status;
+    if (UNLIKELY(!stream->AddRow(row, &status))) {
+        RETURN_IF_ERROR(status);
+        return _spill_error("failed to get a buffer to spill a row");
+    }
+    return Status::OK();
+}
+
+Status HashJoinNode::_partition_batch(RowBatch* batch, bool is_build) {
+    for (int i = 0; i < batch->num_rows(); ++i) {
+        RETURN_IF_ERROR(_add_to_partition(batch->get_row(i), is_build));
+    }
+    return Status::OK();
+}
+
+void HashJoinNode::_finish_hash_partitions() {
+    COUNTER_UPDATE(_spilled_partitions_counter, _hash_partitions.size());
+    // Partitions of the deepest level are joined first, to free disk space early
+    for (auto it = _hash_partitions.rbegin(); it != _hash_partitions.rend(); ++it) {
+        (*it)->probe_rows->UnpinStream(BufferedTupleStream3::UNPIN_ALL);
+        _spilled_partitions.push_front(std::move(*it));
+    }
+    _hash_partitions.clear();
+}
+
+Status HashJoinNode::_partition_probe_side(RuntimeState* state) {
+    RETURN_IF_ERROR(_prepare_probe_partitions(state));
+    RowBatch probe_batch(child(0)->row_desc(), state->batch_size(), mem_tracker().get());
+    bool eos = false;
+    while (!eos) {
+        RETURN_IF_CANCELLED(state);
+        RETURN_IF_ERROR(child(0)->get_next(state, &probe_batch, &eos));
+        COUNTER_UPDATE(_probe_rows_counter, probe_batch.num_rows());
+        RETURN_IF_ERROR(_partition_batch(&probe_batch, false));
+        probe_batch.reset();
+    }
+    _finish_hash_partitions();
+    return Status::OK();
+}
+
+Status HashJoinNode::_repartition(RuntimeState* state, Partition* partition) {
+    if (partition->level + 1 >= MAX_PARTITION_DEPTH) {
+        return _spill_error("can't fit the build rows of a partition in memory after "
+                            "partitioning it " + std::to_string(partition->level) + " times");
+    }
+    COUNTER_UPDATE(_num_repartitions_counter, 1);
+
+    auto read_stream = [&](BufferedTupleStream3* stream, const RowDescriptor& row_desc,
+                           bool is_build) -> Status {
+        bool got_buffer = false;
+        RETURN_IF_ERROR(stream->PrepareForRead(true, &got_buffer));
+        if (!got_buffer) {
+            return _spill_error("failed to get a buffer to read a spilled partition");
+        }
+        RowBatch batch(row_desc, state->batch_size(), mem_tracker().get());
+        bool eos = false;
+        while (!eos) {
+            RETURN_IF_CANCELLED(state);
+            RETURN_IF_ERROR(stream->GetNext(&batch, &eos));
+            RETURN_IF_ERROR(_partition_batch(&batch, is_build));
+            batch.reset();
+        }
+        stream->Close(nullptr, RowBatch::FlushMode::NO_FLUSH_RESOURCES);
+        return Status::OK();
+    };
+
+    RETURN_IF_ERROR(_create_hash_partitions(state, partition->level + 1));
+    RETURN_IF_ERROR(read_stream(partition->build_rows.get(), child(1)->row_desc(), true));
+    RETURN_IF_ERROR(_prepare_probe_partitions(state));
+    RETURN_IF_ERROR(read_stream(partition->probe_rows.get(), child(0)->row_desc(), false));
+    _finish_hash_partitions();
+    return Status::OK();
+}
+
+Status HashJoinNode::_next_spilled_partition(RuntimeState* state) {
+    DCHECK(_input_partition == nullptr);
+    while (!_spilled_partitions.empty()) {
+        _input_partition = std::move(_spilled_partitions.front());
+        _spilled_partitions.pop_front();
+        Partition* partition = _input_partition.get();
+        if (partition->probe_rows->num_rows() == 0 ||
+            (partition->build_rows->num_rows() == 0 && !_match_all_probe &&
+             _join_op != TJoinOp::LEFT_ANTI_JOIN)) {
+            // No row of the partition can be returned
+            _close_partition(partition, nullptr);
+            _input_partition.reset();
+            continue;
+        }
+
+        bool pinned = false;
+        RETURN_IF_ERROR(partition->build_rows->PinStream(&pinned));
+        if (!pinned) {
+            RETURN_IF_ERROR(_repartition(state, partition));
+            _close_partition(partition, nullptr);
+            _input_partition.reset();
+            continue;
+        }
+
+        // The build rows stay in the pinned pages of the stream until the partition
+        // is closed, so the hash table can point to them.
+        bool got_buffer = false;
+        RETURN_IF_ERROR(partition->build_rows->PrepareForRead(false, &got_buffer));
+        DCHECK(got_buffer);
+        _hash_tbl->close();
+        _hash_tbl.reset(_create_hash_table());
+        RowBatch build_batch(child(1)->row_desc(), state->batch_size(), mem_tracker().get());
+        bool eos = false;
+        while (!eos) {
+            RETURN_IF_CANCELLED(state);
+            RETURN_IF_ERROR(partition->build_rows->GetNext(&build_batch, &eos));
+            RETURN_IF_LIMIT_EXCEEDED(state, "Hash join, while constructing the hash table.");
+            process_build_batch(&build_batch);
+            build_batch.reset();
+        }
+        _hash_tbl->build_direct_map();
+        COUNTER_SET(_build_buckets_counter, _hash_tbl->num_buckets());
+        COUNTER_SET(_hash_tbl_load_factor_counter, _hash_tbl->load_factor());
+
+        RETURN_IF_ERROR(partition->probe_rows->PrepareForRead(true, &got_buffer));
+        if (!got_buffer) {
+            return _spill_error("failed to get a buffer to read a spilled partition");
+        }
+        _input_partition_eos = false;
+        return Status::OK();
+    }
+    return Status::OK();
+}
+
+Status HashJoinNode::_get_next_spilled_probe_batch(RuntimeState* state, RowBatch* out_batch) {
+    while (true) {
+        if (_input_partition == nullptr) {
+            RETURN_IF_ERROR(_next_spilled_partition(state));
+            if (_input_partition == nullptr) {
+                _probe_eos = true;
+                return Status::OK();
+            }
+        }
+        if (!_input_partition_eos) {
+            RETURN_IF_ERROR(_input_partition->probe_rows->GetNext(_probe_batch.get(),
+                                                                  &_input_partition_eos));
+            if (_probe_batch->num_rows() > 0) {
+                return Status::OK();
+            }
+            continue;
+        }
+        // Rows in out_batch may reference the build rows and the last probe rows of the
+        // partition, their buffers are freed after out_batch is consumed.
+        _close_partition(_input_partition.get(), out_batch);
+        _input_partition.reset();
+        if (out_batch->is_full()) {
+            // Return out_batch to free the buffers before pinning the next partition
+            return Status::OK();
+        }
+    }
+}
+
+void HashJoinNode::_close_partition(Partition* partition, RowBatch* batch) {
+    if (partition->build_rows != nullptr) {
+        partition->build_rows->Close(batch, RowBatch::FlushMode::FLUSH_RESOURCES);
+        partition->build_rows.reset();
+    }
+    if (partition->probe_rows != nullptr) {
+        partition->probe_rows->Close(batch, RowBatch::FlushMode::FLUSH_RESOURCES);
+        partition->probe_rows.reset();
+    }
+}
+
 std::string HashJoinNode::get_probe_row_output_string(TupleRow* probe_row) {
     std::stringstream out;
     out << "[";
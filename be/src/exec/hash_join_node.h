@@ -21,6 +21,8 @@
 #include <boost/scoped_ptr.hpp>
 #include <boost/thread.hpp>
 #include <boost/unordered_set.hpp>
+#include <deque>
+#include <memory>
 #include <string>
 
 #include "exec/exec_node.h"
@@ -29,8 +31,10 @@
 
 namespace doris {
 
+class BufferedTupleStream3;
 class MemPool;
 class RowBatch;
+struct SharedHashTable;
 class TupleRow;
 
 // Node for in-memory hash joins:
@@ -45,6 +49,21 @@ class TupleRow;
 //   multiple rows per left input row
 // - TODO: fix this, so in the case of 1x1/nx1 joins (for instance, fact to dimension tbl)
 //   we don't do these extra copies
+//
+// Spilling:
+// - If spilling is enabled and the memory limit is exceeded while building the hash
+//   table of an inner, left outer, left semi or left anti join, the node switches to
+//   a grace hash join: the build rows so far and all the rows left on both sides are
+//   hash partitioned into spillable streams, then the partitions are joined one by
+//   one, each with a hash table of its own build rows.
+// - A partition whose build rows still don't fit in memory is partitioned again with
+//   a different hash seed, up to MAX_PARTITION_DEPTH levels.
+//
+// Broadcast joins:
+// - All the instances of a broadcast join get the same build rows, so the instances
+//   on one backend share a hash table: the first one builds it, the others wait for
+//   it, probe it read-only and close their build side without reading it. Such joins
+//   don't spill.
 class HashJoinNode : public ExecNode {
 public:
     HashJoinNode(ObjectPool* pool, const TPlanNode& tnode, const DescriptorTbl& descs);
@@ -62,7 +81,8 @@ protected:
     void debug_string(int indentation_level, std::stringstream* out) const;
 
 private:
-    boost::scoped_ptr<HashTable> _hash_tbl;
+    // Shared with other instances of this join if _shared_hash_table is set
+    std::shared_ptr<HashTable> _hash_tbl;
     HashTable::Iterator _hash_tbl_iterator;
     bool _is_push_down;
 
@@ -92,7 +112,13 @@ private:
 
     bool _matched_probe;                    // if true, we have matched the current probe row
     bool _eos;                              // if true, nothing left to return in get_next()
-    boost::scoped_ptr<MemPool> _build_pool; // holds everything referenced in _hash_tbl
+    std::shared_ptr<MemPool> _build_pool; // holds everything referenced in _hash_tbl
+
+    // True if the build side is broadcast to all the instances of this join
+    bool _is_broadcast_join;
+    // The hash table shared with the other instances of this join on this backend,
+    // null if the hash table isn't shared
+    std::shared_ptr<SharedHashTable> _shared_hash_table;
 
     // Size of the TupleRow (just the Tuple ptrs) from the build (right) and probe (left)
     // sides. Set to zero if the build/probe tuples are not returned, e.g., for semi joins.
@@ -105,6 +131,10 @@ private:
     // is responsible for.
     boost::scoped_ptr<RowBatch> _probe_batch;
     int _probe_batch_pos; // current scan pos in _probe_batch
+    // The rows [_probe_prefetch_begin, _probe_prefetch_end) of _probe_batch are cached
+    // by _hash_tbl->prefetch_probe_rows(), reset to 0 with _probe_batch_pos
+    int _probe_prefetch_begin = 0;
+    int _probe_prefetch_end = 0;
     bool _probe_eos;      // if true, probe child has no more rows to process
     TupleRow* _current_probe_row;
 
@@ -137,6 +167,37 @@ private:
     RuntimeProfile::Counter* _probe_rows_counter;    // num probe rows
     RuntimeProfile::Counter* _build_buckets_counter; // num buckets in hash table
     RuntimeProfile::Counter* _hash_tbl_load_factor_counter;
+    RuntimeProfile::Counter* _spilled_partitions_counter;
+    RuntimeProfile::Counter* _num_repartitions_counter;
+
+    // Number of partitions the rows are split into each time the node partitions.
+    static const int PARTITION_FANOUT = 16;
+    // Maximum times a partition is partitioned again.
+    static const int MAX_PARTITION_DEPTH = 4;
+    // Number of probe rows process_probe_batch() evaluates and prefetches at once
+    static const int PROBE_PREFETCH_ROWS = 64;
+
+    // The build and probe rows with the same partition hash.
+    struct Partition {
+        // how many times the rows have been partitioned, decides the hash seed
+        int level;
+        std::unique_ptr<BufferedTupleStream3> build_rows;
+        std::unique_ptr<BufferedTupleStream3> probe_rows;
+    };
+
+    // Whether stores NULL keys in hash table
+    bool _stores_nulls;
+    // If true, the build side didn't fit in memory and is hash partitioned
+    bool _spilled;
+    // Partitions which rows are being added to
+    std::vector<std::unique_ptr<Partition>> _hash_partitions;
+    // Partitions both sides of which are written, to be joined in order
+    std::deque<std::unique_ptr<Partition>> _spilled_partitions;
+    // The partition whose build rows are in _hash_tbl and whose probe rows are
+    // being joined
+    std::unique_ptr<Partition> _input_partition;
+    // If true, all the probe rows of _input_partition have been read
+    bool _input_partition_eos;
 
     // Supervises ConstructHashTable in a separate thread, and
     // returns its status in the promise parameter.
@@ -146,6 +207,8 @@ private:
     // probe-side. If, for example, the probe-side child is another
     // hash-join node, it can start to build its own build-side at the
     // same time.
+    // If the hash table is shared, only the first instance builds it and the others
+    // wait for it.
     Status construct_hash_table(RuntimeState* state);
 
     // GetNext helper function for the common join cases: Inner join, left semi and left
@@ -160,6 +223,14 @@ private:
     // return the number of rows added to out_batch
     int process_probe_batch(RowBatch* out_batch, RowBatch* probe_batch, int max_added_rows);
 
+    // Create one IN predicate per probe expr from the keys in the hash table,
+    // and append them to _push_down_expr_ctxs.
+    Status _create_in_push_down_exprs(RuntimeState* state);
+
+    // Create "probe_expr >= min AND probe_expr <= max" from the keys in the
+    // hash table, and append them to _push_down_expr_ctxs.
+    Status _create_minmax_push_down_exprs(RuntimeState* state);
+
     // Construct the build hash table, adding all the rows in 'build_batch'
     void process_build_batch(RowBatch* build_batch);
 
@@ -174,6 +245,63 @@ private:
     // This is only used for debugging and outputting the left child rows before
     // doing the join.
     std::string get_probe_row_output_string(TupleRow* probe_row);
+
+    // Only the joins handled by left_join_get_next() spill, they never need to go
+    // back to the build rows once all the probe rows of their partition are joined.
+    bool _can_spill(RuntimeState* state) const;
+
+    // Switch to the grace hash join: partition the rows in _hash_tbl and in
+    // 'build_batch', which are referenced by _build_pool, and free them.
+    Status _spill_build_side(RuntimeState* state, RowBatch* build_batch);
+
+    // Create PARTITION_FANOUT partitions of 'level' in _hash_partitions, ready to add
+    // build rows to.
+    Status _create_hash_partitions(RuntimeState* state, int level);
+
+    // Unpin the build streams of _hash_partitions, no more build rows can be added,
+    // and create the probe streams.
+    Status _prepare_probe_partitions(RuntimeState* state);
+
+    // Add 'row' or the rows of 'batch' to the build or probe streams of _hash_partitions.
+    Status _add_to_partition(TupleRow* row, bool is_build);
+    Status _partition_batch(RowBatch* batch, bool is_build);
+
+    // Unpin the probe streams of _hash_partitions and put the partitions in front of
+    // _spilled_partitions.
+    void _finish_hash_partitions();
+
+    // Read all rows of the probe child into _hash_partitions.
+    Status _partition_probe_side(RuntimeState* state);
+
+    // Read both sides of 'partition' into new partitions of the next level.
+    Status _repartition(RuntimeState* state, Partition* partition);
+
+    // Pop partitions from _spilled_partitions until one whose build rows can be
+    // pinned is found, build _hash_tbl with its build rows and make it
+    // _input_partition. _input_partition is nullptr if no partition is left.
+    Status _next_spilled_partition(RuntimeState* state);
+
+    // Get the next batch of probe rows of _input_partition into _probe_batch,
+    // switching to the next partition when it runs out of rows. Resources
+    // which rows in 'out_batch' may reference are attached to it.
+    Status _get_next_spilled_probe_batch(RuntimeState* state, RowBatch* out_batch);
+
+    // Close the streams of 'partition', attaching the buffers rows returned from them
+    // may reference to 'batch' if it's not nullptr.
+    void _close_partition(Partition* partition, RowBatch* batch);
+
+    Status _spill_error(const std::string& msg);
+
+    uint32_t _partition_hash(TupleRow* row, const std::vector<ExprContext*>& exprs,
+                             int level) const;
+
+    HashTable* _create_hash_table();
+
+    // Whether the hash table can be shared with the other instances of this join
+    bool _can_share_hash_table(RuntimeState* state) const;
+
+    // Fill _hash_tbl with the rows of child(1)
+    Status _build_hash_table(RuntimeState* state);
 };
 
 } // namespace doris
@@ -15,6 +15,7 @@
 // specific language governing permissions and limitations
 // under the License.
 
+#include "common/config.h"
 #include "exec/hash_join_node.h"
 #include "exec/hash_table.hpp"
 #include "runtime/row_batch.h"
@@ -119,8 +120,24 @@ int HashJoinNode::process_probe_batch(RowBatch* out_batch, RowBatch* probe_batch
                 goto end;
             }
 
-            _current_probe_row = probe_batch->get_row(_probe_batch_pos++);
-            _hash_tbl_iterator = _hash_tbl->find(_current_probe_row);
+            if (config::enable_prefetch) {
+                // Evaluate and prefetch the next rows together, so that their cache
+                // misses in the hash table overlap
+                if (_probe_batch_pos >= _probe_prefetch_end) {
+                    _probe_prefetch_begin = _probe_batch_pos;
+                    _probe_prefetch_end =
+                            std::min(probe_rows, _probe_batch_pos + PROBE_PREFETCH_ROWS);
+                    _hash_tbl->prefetch_probe_rows(probe_batch, _probe_prefetch_begin,
+                                                   _probe_prefetch_end - _probe_prefetch_begin);
+                }
+                _current_probe_row = probe_batch->get_row(_probe_batch_pos);
+                _hash_tbl_iterator =
+                        _hash_tbl->find_cached(_probe_batch_pos - _probe_prefetch_begin);
+                ++_probe_batch_pos;
+            } else {
+                _current_probe_row = probe_batch->get_row(_probe_batch_pos++);
+                _hash_tbl_iterator = _hash_tbl->find(_current_probe_row);
+            }
             _matched_probe = false;
         }
     }
@@ -136,7 +153,8 @@ end:
 }
 
 // when build table has too many duplicated rows, the collisions will be very serious,
-// so in some case will don't need to store duplicated value in hash table, we can build an unique one
+// so in some case will don't need to store duplicated value in hash table, we can build an unique one.
+// A probe row of a left semi/anti join then stops at its only match.
 void HashJoinNode::process_build_batch(RowBatch* build_batch) {
     // insert build row into our hash table
     if (_build_unique) {
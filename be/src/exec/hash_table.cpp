@@ -17,9 +17,13 @@
 
 #include "exec/hash_table.hpp"
 
+#include <algorithm>
+#include <limits>
+
 #include "exprs/expr.h"
 #include "runtime/mem_tracker.h"
 #include "runtime/raw_value.h"
+#include "runtime/row_batch.h"
 #include "runtime/runtime_state.h"
 #include "runtime/string_value.hpp"
 #include "util/doris_metrics.h"
@@ -27,13 +31,17 @@
 namespace doris {
 
 const float HashTable::MAX_BUCKET_OCCUPANCY_FRACTION = 0.75f;
+const float HashTable::DIRECT_MAP_MIN_DENSITY = 0.5f;
+const int HashTable::GROUP_SIZE;
+const uint8_t HashTable::EMPTY_SLOT;
+const int64_t HashTable::SCAN_BUCKET_IDX;
 
 HashTable::HashTable(const std::vector<ExprContext*>& build_expr_ctxs,
                      const std::vector<ExprContext*>& probe_expr_ctxs, int num_build_tuples,
                      bool stores_nulls, const std::vector<bool>& finds_nulls, int32_t initial_seed,
                      const std::shared_ptr<MemTracker>& mem_tracker, int64_t num_buckets)
         : _build_expr_ctxs(build_expr_ctxs),
-          _probe_expr_ctxs(probe_expr_ctxs),
+          _probe_expr_ctxs(&probe_expr_ctxs),
           _num_build_tuples(num_build_tuples),
           _stores_nulls(stores_nulls),
           _finds_nulls(finds_nulls),
@@ -44,15 +52,19 @@ HashTable::HashTable(const std::vector<ExprContext*>& build_expr_ctxs,
           _num_nodes(0),
           _exceeded_limit(false),
           _mem_tracker(mem_tracker),
-          _mem_limit_exceeded(false) {
+          _mem_limit_exceeded(false),
+          _int_key_type(INVALID_TYPE),
+          _min_int_key(std::numeric_limits<int64_t>::max()),
+          _max_int_key(std::numeric_limits<int64_t>::min()),
+          _direct_map(NULL),
+          _direct_map_size(0),
+          _build_shared(false) {
     DCHECK(_mem_tracker);
-    DCHECK_EQ(_build_expr_ctxs.size(), _probe_expr_ctxs.size());
+    DCHECK_EQ(_build_expr_ctxs.size(), _probe_expr_ctxs->size());
 
     DCHECK_EQ((num_buckets & (num_buckets - 1)), 0) << "num_buckets must be a power of 2";
-    _buckets.resize(num_buckets);
-    _num_buckets = num_buckets;
-    _num_buckets_till_resize = MAX_BUCKET_OCCUPANCY_FRACTION * _num_buckets;
-    _mem_tracker->Consume(_buckets.capacity() * sizeof(Bucket));
+    allocate_buckets(num_buckets);
+    _mem_tracker->Consume(buckets_byte_size(_num_buckets));
 
     // Compute the layout and buffer size to store the evaluated expr results
     _results_buffer_size = Expr::compute_results_layout(
@@ -61,6 +73,14 @@ HashTable::HashTable(const std::vector<ExprContext*>& build_expr_ctxs,
     memset(_expr_values_buffer, 0, sizeof(uint8_t) * _results_buffer_size);
     _expr_value_null_bits = new uint8_t[_build_expr_ctxs.size()];
 
+    if (_build_expr_ctxs.size() == 1) {
+        PrimitiveType type = _build_expr_ctxs[0]->root()->type().type;
+        if ((type == TYPE_INT || type == TYPE_BIGINT) &&
+            (*_probe_expr_ctxs)[0]->root()->type().type == type) {
+            _int_key_type = type;
+        }
+    }
+
     _nodes_capacity = 1024;
     _nodes = reinterpret_cast<uint8_t*>(malloc(_nodes_capacity * _node_byte_size));
     memset(_nodes, 0, _nodes_capacity * _node_byte_size);
@@ -71,15 +91,96 @@ HashTable::HashTable(const std::vector<ExprContext*>& build_expr_ctxs,
     }
 }
 
-HashTable::~HashTable() {}
+HashTable::~HashTable() {
+    // Tables created by share_build() may probe the rows until they are destroyed
+    if (_build_shared) {
+        free_build();
+    }
+}
 
 void HashTable::close() {
     // TODO: use tr1::array?
     delete[] _expr_values_buffer;
     delete[] _expr_value_null_bits;
+    if (_shared_build != nullptr) {
+        _shared_build.reset();
+    } else if (!_build_shared) {
+        free_build();
+    }
+}
+
+void HashTable::free_build() {
     free(_nodes);
+    free(_ctrl);
+    free(_buckets);
+    release_direct_map();
     _mem_tracker->Release(_nodes_capacity * _node_byte_size);
-    _mem_tracker->Release(_buckets.size() * sizeof(Bucket));
+    _mem_tracker->Release(buckets_byte_size(_num_buckets));
+}
+
+void HashTable::allocate_buckets(int64_t num_buckets) {
+    _ctrl = reinterpret_cast<uint8_t*>(malloc(num_buckets + GROUP_SIZE - 1));
+    memset(_ctrl, EMPTY_SLOT, num_buckets + GROUP_SIZE - 1);
+    _buckets = reinterpret_cast<int64_t*>(malloc(num_buckets * sizeof(int64_t)));
+    std::fill(_buckets, _buckets + num_buckets, -1);
+    _num_buckets = num_buckets;
+    _num_buckets_till_resize = MAX_BUCKET_OCCUPANCY_FRACTION * _num_buckets;
+}
+
+void HashTable::share_build(const std::shared_ptr<HashTable>& table) {
+    DCHECK(table->_build_shared);
+    DCHECK_EQ(_num_nodes, 0);
+    DCHECK_EQ(_int_key_type, table->_int_key_type);
+    free_build();
+
+    _nodes = table->_nodes;
+    _num_nodes = table->_num_nodes;
+    _nodes_capacity = table->_nodes_capacity;
+    _num_filled_buckets = table->_num_filled_buckets;
+    _ctrl = table->_ctrl;
+    _buckets = table->_buckets;
+    _num_buckets = table->_num_buckets;
+    _num_buckets_till_resize = table->_num_buckets_till_resize;
+    _min_int_key = table->_min_int_key;
+    _max_int_key = table->_max_int_key;
+    _direct_map = table->_direct_map;
+    _direct_map_size = table->_direct_map_size;
+    _shared_build = table;
+}
+
+void HashTable::prefetch_probe_rows(RowBatch* batch, int start, int num_rows) {
+    int num_exprs = _build_expr_ctxs.size();
+    _probe_cache_skip.resize(num_rows);
+    _probe_cache_hashes.resize(num_rows);
+    _probe_cache_values.resize(num_rows * _results_buffer_size);
+    _probe_cache_null_bits.resize(num_rows * num_exprs);
+
+    for (int i = 0; i < num_rows; ++i) {
+        bool has_nulls = eval_probe_row(batch->get_row(start + i));
+        _probe_cache_skip[i] = !_stores_nulls && has_nulls;
+
+        if (_probe_cache_skip[i]) {
+            continue;
+        }
+
+        memcpy(&_probe_cache_values[i * _results_buffer_size], _expr_values_buffer,
+               _results_buffer_size);
+        memcpy(&_probe_cache_null_bits[i * num_exprs], _expr_value_null_bits, num_exprs);
+
+        if (_direct_map != NULL && !_expr_value_null_bits[0]) {
+            int64_t key = int_key_value();
+            if (key >= _min_int_key && key <= _max_int_key) {
+                __builtin_prefetch(&_direct_map[key - _min_int_key]);
+            }
+            continue;
+        }
+
+        uint32_t hash = hash_current_row();
+        _probe_cache_hashes[i] = hash;
+        int64_t bucket_idx = hash & (_num_buckets - 1);
+        __builtin_prefetch(&_ctrl[bucket_idx]);
+        __builtin_prefetch(&_buckets[bucket_idx]);
+    }
 }
 
 bool HashTable::eval_row(TupleRow* row, const std::vector<ExprContext*>& ctxs) {
@@ -151,12 +252,32 @@ uint32_t HashTable::hash_variable_len_row() {
     return hash;
 }
 
-bool HashTable::equals(TupleRow* build_row) {
+template <typename T>
+bool HashTable::int_key_equals(TupleRow* build_row, bool force_null_equality) {
+    void* val = _build_expr_ctxs[0]->get_value(build_row);
+
+    if (val == NULL) {
+        return (force_null_equality || (_stores_nulls && _finds_nulls[0])) &&
+               _expr_value_null_bits[0];
+    }
+
+    return !_expr_value_null_bits[0] &&
+           *reinterpret_cast<T*>(val) ==
+                   *reinterpret_cast<T*>(_expr_values_buffer + _expr_values_buffer_offsets[0]);
+}
+
+bool HashTable::equals(TupleRow* build_row, bool force_null_equality) {
+    if (_int_key_type == TYPE_INT) {
+        return int_key_equals<int32_t>(build_row, force_null_equality);
+    } else if (_int_key_type == TYPE_BIGINT) {
+        return int_key_equals<int64_t>(build_row, force_null_equality);
+    }
+
     for (int i = 0; i < _build_expr_ctxs.size(); ++i) {
         void* val = _build_expr_ctxs[i]->get_value(build_row);
 
         if (val == NULL) {
-            if (!(_stores_nulls && _finds_nulls[i])) {
+            if (!force_null_equality && !(_stores_nulls && _finds_nulls[i])) {
                 return false;
             }
 
@@ -167,6 +288,10 @@ bool HashTable::equals(TupleRow* build_row) {
             continue;
         }
 
+        if (_expr_value_null_bits[i]) {
+            return false;
+        }
+
         void* loc = _expr_values_buffer + _expr_values_buffer_offsets[i];
 
         if (!RawValue::eq(loc, val, _build_expr_ctxs[i]->root()->type())) {
@@ -180,56 +305,166 @@ bool HashTable::equals(TupleRow* build_row) {
 void HashTable::resize_buckets(int64_t num_buckets) {
     DCHECK_EQ((num_buckets & (num_buckets - 1)), 0) << "num_buckets must be a power of 2";
 
+    // Every key needs its own slot and there must be an empty slot to end a probe
+    while (_num_filled_buckets > MAX_BUCKET_OCCUPANCY_FRACTION * num_buckets) {
+        num_buckets *= 2;
+    }
+
     int64_t old_num_buckets = _num_buckets;
-    int64_t delta_bytes = (num_buckets - old_num_buckets) * sizeof(Bucket);
-    if (!_mem_tracker->TryConsume(delta_bytes)) {
+    int64_t delta_bytes = buckets_byte_size(num_buckets) - buckets_byte_size(old_num_buckets);
+    // Unlike the nodes, slots can't be given up if the limit is exceeded since the
+    // table must not be full.
+    _mem_tracker->Consume(delta_bytes);
+    if (_mem_tracker->limit_exceeded()) {
         mem_limit_exceeded(delta_bytes);
-        return;
     }
 
-    _buckets.resize(num_buckets);
+    uint8_t* old_ctrl = _ctrl;
+    int64_t* old_buckets = _buckets;
+    allocate_buckets(num_buckets);
 
-    // If we're doubling the number of buckets, all nodes in a particular bucket
-    // either remain there, or move down to an analogous bucket in the other half.
-    // In order to efficiently check which of the two buckets a node belongs in, the number
-    // of buckets must be a power of 2.
-    bool doubled_buckets = (num_buckets == old_num_buckets * 2);
+    // The keys are distinct, so a slot is moved to the first empty slot of its
+    // new probe sequence without comparing rows. Nodes don't move.
+    for (int64_t i = 0; i < old_num_buckets; ++i) {
+        if (old_ctrl[i] == EMPTY_SLOT) {
+            continue;
+        }
 
-    for (int i = 0; i < _num_buckets; ++i) {
-        Bucket* bucket = &_buckets[i];
-        Bucket* sister_bucket = &_buckets[i + old_num_buckets];
-        Node* last_node = NULL;
-        int node_idx = bucket->_node_idx;
+        uint32_t hash = get_node(old_buckets[i])->_hash;
+        int64_t bucket_idx = find_empty_bucket(hash);
+        set_ctrl(bucket_idx, old_ctrl[i]);
+        _buckets[bucket_idx] = old_buckets[i];
+    }
 
-        while (node_idx != -1) {
-            Node* node = get_node(node_idx);
-            int64_t next_idx = node->_next_idx;
-            uint32_t hash = node->_hash;
+    free(old_ctrl);
+    free(old_buckets);
+}
 
-            bool node_must_move = true;
-            Bucket* move_to = NULL;
+void HashTable::set_probe_exprs(const std::vector<ExprContext*>& probe_exprs) {
+    DCHECK_EQ(_build_expr_ctxs.size(), probe_exprs.size());
+    _probe_expr_ctxs = &probe_exprs;
+    if (_int_key_type != INVALID_TYPE && probe_exprs[0]->root()->type().type != _int_key_type) {
+        _int_key_type = INVALID_TYPE;
+        release_direct_map();
+    }
+}
 
-            if (doubled_buckets) {
-                node_must_move = ((hash & old_num_buckets) != 0);
-                move_to = sister_bucket;
-            } else {
-                int64_t bucket_idx = hash & (num_buckets - 1);
-                node_must_move = (bucket_idx != i);
-                move_to = &_buckets[bucket_idx];
-            }
+void HashTable::retain(bool matched) {
+    DCHECK(!_build_shared);
+    DCHECK(_shared_build == nullptr);
+    release_direct_map();
+
+    // Nodes kept are moved to the front in their order, so new_idx[i] <= i
+    std::vector<int64_t> new_idx(_num_nodes, -1);
+    int64_t num_nodes = 0;
+    for (int64_t i = 0; i < _num_nodes; ++i) {
+        if (get_node(i)->matched == matched) {
+            new_idx[i] = num_nodes++;
+        }
+    }
 
-            if (node_must_move) {
-                move_node(bucket, move_to, node_idx, node, last_node);
-            } else {
-                last_node = node;
+    // Unlink the dropped nodes from the chains of their keys while the nodes are still
+    // in place, linking the kept ones by their new indexes.
+    std::vector<int64_t> heads;
+    for (int64_t i = 0; i < _num_buckets; ++i) {
+        if (_ctrl[i] == EMPTY_SLOT) {
+            continue;
+        }
+        Node* last = NULL;
+        for (int64_t idx = _buckets[i]; idx != -1;) {
+            Node* node = get_node(idx);
+            int64_t next_idx = node->_next_idx;
+            if (new_idx[idx] != -1) {
+                if (last == NULL) {
+                    heads.push_back(new_idx[idx]);
+                } else {
+                    last->_next_idx = new_idx[idx];
+                }
+                last = node;
             }
+            idx = next_idx;
+        }
+        if (last != NULL) {
+            last->_next_idx = -1;
+        }
+    }
 
-            node_idx = next_idx;
+    for (int64_t i = 0; i < _num_nodes; ++i) {
+        if (new_idx[i] == -1) {
+            continue;
         }
+        if (new_idx[i] != i) {
+            memcpy(get_node(new_idx[i]), get_node(i), _node_byte_size);
+        }
+        get_node(new_idx[i])->matched = false;
     }
+    _num_nodes = num_nodes;
+    _num_filled_buckets = heads.size();
 
-    _num_buckets = num_buckets;
-    _num_buckets_till_resize = MAX_BUCKET_OCCUPANCY_FRACTION * _num_buckets;
+    int64_t num_buckets = 1024;
+    while (_num_filled_buckets > MAX_BUCKET_OCCUPANCY_FRACTION * num_buckets) {
+        num_buckets *= 2;
+    }
+    num_buckets = std::min(num_buckets, _num_buckets);
+    _mem_tracker->Release(buckets_byte_size(_num_buckets) - buckets_byte_size(num_buckets));
+    free(_ctrl);
+    free(_buckets);
+    allocate_buckets(num_buckets);
+
+    // The keys are distinct, see resize_buckets()
+    for (int64_t idx : heads) {
+        uint32_t hash = get_node(idx)->_hash;
+        int64_t bucket_idx = find_empty_bucket(hash);
+        set_ctrl(bucket_idx, hash_tag(hash));
+        _buckets[bucket_idx] = idx;
+    }
+}
+
+bool HashTable::build_direct_map() {
+    if (_int_key_type == INVALID_TYPE || _min_int_key > _max_int_key) {
+        return false;
+    }
+
+    // Computed unsigned, the range of keys can overflow int64_t
+    uint64_t range = static_cast<uint64_t>(_max_int_key) - static_cast<uint64_t>(_min_int_key) + 1;
+    if (range == 0 || range > static_cast<uint64_t>(_num_filled_buckets / DIRECT_MAP_MIN_DENSITY)) {
+        return false;
+    }
+
+    int64_t bytes = range * sizeof(int64_t);
+    if (!_mem_tracker->TryConsume(bytes)) {
+        return false;
+    }
+
+    _direct_map = reinterpret_cast<int64_t*>(malloc(bytes));
+    _direct_map_size = range;
+    std::fill(_direct_map, _direct_map + range, -1);
+
+    for (int64_t i = 0; i < _num_buckets; ++i) {
+        if (_ctrl[i] == EMPTY_SLOT) {
+            continue;
+        }
+
+        void* val = _build_expr_ctxs[0]->get_value(get_node(_buckets[i])->data());
+
+        // NULL keys are still found by hashing
+        if (val == NULL) {
+            continue;
+        }
+
+        int64_t key = _int_key_type == TYPE_INT ? *reinterpret_cast<int32_t*>(val)
+                                                : *reinterpret_cast<int64_t*>(val);
+        _direct_map[key - _min_int_key] = i;
+    }
+
+    return true;
+}
+
+void HashTable::release_direct_map() {
+    _mem_tracker->Release(_direct_map_size * sizeof(int64_t));
+    free(_direct_map);
+    _direct_map = NULL;
+    _direct_map_size = 0;
 }
 
 void HashTable::grow_node_array() {
@@ -261,8 +496,8 @@ std::string HashTable::debug_string(bool skip_empty, const RowDescriptor* desc)
     std::stringstream ss;
     ss << std::endl;
 
-    for (int i = 0; i < _buckets.size(); ++i) {
-        int64_t node_idx = _buckets[i]._node_idx;
+    for (int64_t i = 0; i < _num_buckets; ++i) {
+        int64_t node_idx = _buckets[i];
         bool first = true;
 
         if (skip_empty && node_idx == -1) {
@@ -19,16 +19,19 @@
 #define DORIS_BE_SRC_QUERY_EXEC_HASH_TABLE_H
 
 #include <boost/cstdint.hpp>
+#include <memory>
 #include <vector>
 
 #include "codegen/doris_ir.h"
 #include "common/logging.h"
+#include "runtime/primitive_type.h"
 #include "util/hash_util.hpp"
 
 namespace doris {
 
 class Expr;
 class ExprContext;
+class RowBatch;
 class RowDescriptor;
 class Tuple;
 class TupleRow;
@@ -53,22 +56,25 @@ using std::vector;
 //
 // The hash table does not support removes. The hash table is not thread safe.
 //
-// The implementation is based on the boost multiset.  The hashtable is implemented by
-// two data structures: a vector of buckets and a vector of nodes.  Inserted values
-// are stored as nodes (in the order they are inserted).  The buckets (indexed by the
-// mod of the hash) contain pointers to the node vector.  Nodes that fall in the same
-// bucket are linked together (the bucket pointer gets you the head of that linked list).
-// When growing the hash table, the number of buckets is doubled, and nodes from a
-// particular bucket either stay in place or move to an analogous bucket in the second
-// half of buckets. This behavior allows us to avoid moving about half the nodes each
-// time, and maintains good cache properties by only accessing 2 buckets at a time.
-// The node vector is modified in place.
-// Due to the doubling nature of the buckets, we require that the number of buckets is a
-// power of 2. This allows us to determine if a node needs to move by simply checking a
-// single bit, and further allows us to initially hash nodes using a bitmask.
+// The hashtable is implemented by open addressing over two data structures: an array
+// of slots and a vector of nodes.  Inserted values are stored as nodes, densely and in
+// the order they are inserted, so a full table scan walks the node vector.  Every key
+// owns one slot (indexed by the hash and probed linearly) pointing to the head of a
+// linked list of the nodes having that key, so a find() compares one node per key and
+// the duplicates of a key are returned without comparing them again.
+// Next to the slots is an array of control bytes, one per slot: either EMPTY or a 7 bit
+// tag of the hash of the key of the slot.  Probing loads a group of control bytes and
+// compares all of them to the tag at once (with SSE2 when available), so only slots
+// whose tags match are compared with the row.  The control bytes of the first group are
+// cloned after the last slot so that a group can start at any slot.
+// The number of slots is a power of 2 and is doubled when the load factor exceeds
+// MAX_BUCKET_OCCUPANCY_FRACTION, which rehashes the slots but never moves the nodes.
 //
-// TODO: this is not a fancy hash table in terms of memory access patterns (cuckoo-hashing
-// or something that spills to disk). We will likely want to invest more time into this.
+// Tables of a single INT or BIGINT key compare keys as integers instead of through the
+// exprs. If such a build's keys are dense, build_direct_map() maps every key of the
+// range of keys to its slot, and find() looks the probe key up without hashing it.
+//
+// TODO: this does not spill to disk. We will likely want to invest more time into this.
 // TODO: hash-join and aggregation have very different access patterns.  Joins insert
 // all the rows and then calls scan to find them.  Aggregation interleaves find() and
 // inserts().  We can want to optimize joins more heavily for inserts() (in particular
@@ -102,21 +108,52 @@ public:
     // Insert row into the hash table.  Row will be evaluated over _build_expr_ctxs
     // This will grow the hash table if necessary
     void IR_ALWAYS_INLINE insert(TupleRow* row) {
-        if (_num_filled_buckets > _num_buckets_till_resize) {
+        if (_num_filled_buckets >= _num_buckets_till_resize) {
             // TODO: next prime instead of double?
             resize_buckets(_num_buckets * 2);
         }
 
-        insert_impl(row);
+        insert_impl(row, false);
     }
 
-    // Insert row into the hash table. if the row is already exist will not insert
+    // Insert row into the hash table unless a row with the same key, NULL equal to
+    // NULL, is already in it.  This probes the table once.
     void IR_ALWAYS_INLINE insert_unique(TupleRow* row) {
-        if (find(row, false) == end()) {
-            insert(row);
+        if (_num_filled_buckets >= _num_buckets_till_resize) {
+            resize_buckets(_num_buckets * 2);
         }
+
+        insert_impl(row, true);
     }
 
+    // Called after the last insert() of a build. Maps the keys to their slots by an
+    // array indexed by the key if the table has a single INT or BIGINT key and its
+    // non-null keys fill at least DIRECT_MAP_MIN_DENSITY of their range.  Inserting
+    // again drops the array.  Returns whether the array is built.
+    bool build_direct_map();
+
+    // Make this table, which must be empty, probe the rows and slots of 'table' instead
+    // of its own.  'table' must be built by the same plan node in another fragment
+    // instance and marked by set_build_shared().  The exprs and the buffer of the
+    // evaluated exprs stay this table's own, so the tables can be probed concurrently.
+    // This table can't be inserted into.
+    void share_build(const std::shared_ptr<HashTable>& table);
+
+    // Marks the rows and slots of this table to be probed by other tables, see
+    // share_build().  They are freed by the destructor instead of close() and can't be
+    // inserted into anymore.
+    void set_build_shared() { _build_shared = true; }
+
+    // Probe with 'probe_exprs' from now on, which must be as many as the build exprs.
+    // The direct map is dropped if the single key isn't of the build type anymore.
+    void set_probe_exprs(const std::vector<ExprContext*>& probe_exprs);
+
+    // Keep only the rows whose matched flag equals 'matched', and clear the flag of the
+    // rows kept.  The rows are compacted in the node array and the slots rebuilt from
+    // the cached hashes, shrinking them to fit the keys left, so no expr is evaluated.
+    // Iterators of the table are invalidated.  Not for tables sharing a build.
+    void retain(bool matched);
+
     // Returns the start iterator for all rows that match 'probe_row'.  'probe_row' is
     // evaluated with _probe_expr_ctxs.  The iterator can be iterated until HashTable::end()
     // to find all the matching rows.
@@ -128,21 +165,32 @@ public:
     // Returns HashTable::end() if there is no match.
     Iterator IR_ALWAYS_INLINE find(TupleRow* probe_row, bool probe = true);
 
+    // Evaluates the rows [start, start + num_rows) of 'batch' over the probe exprs,
+    // caching the results and hashes, and prefetches the slots the rows probe, so that
+    // the cache misses of probing the rows overlap.  find_cached(i) then finds the row
+    // start + i.
+    void prefetch_probe_rows(RowBatch* batch, int start, int num_rows);
+
+    // find() of the 'idx'-th row of the last prefetch_probe_rows(), which is not
+    // evaluated again.
+    Iterator IR_ALWAYS_INLINE find_cached(int idx);
+
     // Returns number of elements in the hash table
     int64_t size() { return _num_nodes; }
 
-    // Returns the number of buckets
-    int64_t num_buckets() { return _buckets.size(); }
+    // Returns the number of buckets (slots)
+    int64_t num_buckets() { return _num_buckets; }
 
     // true if any of the MemTrackers was exceeded
     bool exceeded_limit() const { return _exceeded_limit; }
 
     // Returns the load factor (the number of non-empty buckets)
-    float load_factor() { return _num_filled_buckets / static_cast<float>(_buckets.size()); }
+    float load_factor() { return _num_filled_buckets / static_cast<float>(_num_buckets); }
 
     // Returns the number of bytes allocated to the hash table
     int64_t byte_size() const {
-        return _node_byte_size * _nodes_capacity + sizeof(Bucket) * _buckets.size();
+        return _node_byte_size * _nodes_capacity + buckets_byte_size(_num_buckets) +
+               _direct_map_size * sizeof(int64_t);
     }
 
     // Returns the results of the exprs at 'expr_idx' evaluated over the last row
@@ -175,8 +223,7 @@ public:
         Iterator() : _table(NULL), _bucket_idx(-1), _node_idx(-1) {}
 
         // Iterates to the next element.  In the case where the iterator was
-        // from a Find, this will lazily evaluate that bucket, only returning
-        // TupleRows that match the current scan row.
+        // from a Find, this will only return TupleRows that match the current scan row.
         template <bool check_match>
         void IR_ALWAYS_INLINE next();
 
@@ -222,16 +269,14 @@ public:
     private:
         friend class HashTable;
 
-        Iterator(HashTable* table, int bucket_idx, int64_t node, uint32_t hash)
-                : _table(table), _bucket_idx(bucket_idx), _node_idx(node), _scan_hash(hash) {}
+        Iterator(HashTable* table, int64_t bucket_idx, int64_t node)
+                : _table(table), _bucket_idx(bucket_idx), _node_idx(node) {}
 
         HashTable* _table;
-        // Current bucket idx
+        // Slot of the key returned by find(), or SCAN_BUCKET_IDX for a full table scan
         int64_t _bucket_idx;
-        // Current node idx (within current bucket)
+        // Current node idx
         int64_t _node_idx;
-        // cached hash value for the row passed to find()()
-        uint32_t _scan_hash;
     };
 
 private:
@@ -241,7 +286,7 @@ private:
     // Header portion of a Node.  The node data (TupleRow) is right after the
     // node memory to maximize cache hits.
     struct Node {
-        int64_t _next_idx; // chain to next node for collisions
+        int64_t _next_idx; // chain to next node with the same key
         uint32_t _hash;    // Cache of the hash for _data
         bool matched;
 
@@ -254,15 +299,61 @@ private:
         }
     };
 
-    struct Bucket {
-        int64_t _node_idx;
+    // Number of control bytes probed at once
+    static const int GROUP_SIZE = 16;
+    // Control byte of an empty slot. Tags of filled slots never have the high bit set.
+    static const uint8_t EMPTY_SLOT = 0x80;
+    // _bucket_idx of an Iterator of a full table scan
+    static const int64_t SCAN_BUCKET_IDX = -2;
 
-        Bucket() { _node_idx = -1; }
-    };
+    // Returns the tag of 'hash' stored in the control byte of its slot.  The low bits
+    // of the hash pick the slot so the tag is taken from the high bits.
+    static uint8_t hash_tag(uint32_t hash) { return hash >> 25; }
+
+    // Bytes of the slots and control bytes of a table of 'num_buckets' slots
+    static int64_t buckets_byte_size(int64_t num_buckets) {
+        return num_buckets * (sizeof(int64_t) + sizeof(uint8_t)) + GROUP_SIZE - 1;
+    }
+
+    // Returns the bitmask of the control bytes equal to 'ctrl' in the group starting
+    // at slot 'bucket_idx'.  Only slots of the table are in the mask, so that a slot
+    // is not visited twice when there are less than GROUP_SIZE slots.
+    uint32_t match_group(int64_t bucket_idx, uint8_t ctrl) const;
+
+    // Sets the control byte of slot 'bucket_idx' and its clones
+    void set_ctrl(int64_t bucket_idx, uint8_t ctrl);
+
+    // Returns the slot of the key cached in '_expr_values_buffer' whose hash is 'hash'
+    // and sets *found to true.  If the key is not in the table, returns the empty slot
+    // it should be put in and sets *found to false.  If 'force_null_equality', NULL
+    // values equal each other regardless of '_finds_nulls'.
+    int64_t IR_ALWAYS_INLINE find_bucket(uint32_t hash, bool force_null_equality, bool* found);
 
-    // Returns the next non-empty bucket and updates idx to be the index of that bucket.
-    // If there are no more buckets, returns NULL and sets idx to -1
-    Bucket* next_bucket(int64_t* bucket_idx);
+    // Returns the first empty slot in the probe sequence of 'hash'
+    int64_t find_empty_bucket(uint32_t hash) const;
+
+    // Returns the single integer key cached in '_expr_values_buffer'
+    int64_t int_key_value() const {
+        const void* loc = _expr_values_buffer + _expr_values_buffer_offsets[0];
+        return _int_key_type == TYPE_INT ? *reinterpret_cast<const int32_t*>(loc)
+                                         : *reinterpret_cast<const int64_t*>(loc);
+    }
+
+    // find() of the non-null key cached in '_expr_values_buffer' by the direct map
+    Iterator IR_ALWAYS_INLINE find_in_direct_map();
+
+    // equals() of a single integer key of type T
+    template <typename T>
+    bool int_key_equals(TupleRow* build_row, bool force_null_equality);
+
+    // Drops the array of build_direct_map()
+    void release_direct_map();
+
+    // Allocates 'num_buckets' empty slots
+    void allocate_buckets(int64_t num_buckets);
+
+    // Frees the rows and slots
+    void free_build();
 
     // Returns node at idx.  Tracking structures do not use pointers since they will
     // change as the HashTable grows.
@@ -271,20 +362,12 @@ private:
         return reinterpret_cast<Node*>(_nodes + _node_byte_size * idx);
     }
 
-    // Resize the hash table to 'num_buckets'
+    // Resize the hash table to 'num_buckets', or more if the keys don't fit in it
     void resize_buckets(int64_t num_buckets);
 
-    // Insert row into the hash table
-    void IR_ALWAYS_INLINE insert_impl(TupleRow* row);
-
-    // Chains the node at 'node_idx' to 'bucket'.  Nodes in a bucket are chained
-    // as a linked list; this places the new node at the beginning of the list.
-    void add_to_bucket(Bucket* bucket, int64_t node_idx, Node* node);
-
-    // Moves a node from one bucket to another. 'previous_node' refers to the
-    // node (if any) that's chained before this node in from_bucket's linked list.
-    void move_node(Bucket* from_bucket, Bucket* to_bucket, int64_t node_idx, Node* node,
-                   Node* previous_node);
+    // Insert row into the hash table. If 'unique', the row is dropped if its key is
+    // already in the table.
+    void IR_ALWAYS_INLINE insert_impl(TupleRow* row, bool unique);
 
     // Evaluate the exprs over row and cache the results in '_expr_values_buffer'.
     // Returns whether any expr evaluated to NULL
@@ -300,7 +383,7 @@ private:
 
     // Evaluate 'row' over _probe_expr_ctxs caching the results in '_expr_values_buffer'
     // This will be replaced by codegen.
-    bool IR_NO_INLINE eval_probe_row(TupleRow* row) { return eval_row(row, _probe_expr_ctxs); }
+    bool IR_NO_INLINE eval_probe_row(TupleRow* row) { return eval_row(row, *_probe_expr_ctxs); }
 
     // Compute the hash of the values in _expr_values_buffer.
     // This will be replaced by codegen.  We don't want this inlined for replacing
@@ -320,9 +403,10 @@ private:
     uint32_t hash_variable_len_row();
 
     // Returns true if the values of build_exprs evaluated over 'build_row' equal
-    // the values cached in _expr_values_buffer
+    // the values cached in _expr_values_buffer.  If 'force_null_equality', NULL equals
+    // NULL for all exprs, which is used to put the rows of the same key in one slot.
     // This will be replaced by codegen.
-    bool equals(TupleRow* build_row);
+    bool equals(TupleRow* build_row, bool force_null_equality = false);
 
     // Grow the node array.
     void grow_node_array();
@@ -333,11 +417,16 @@ private:
     void mem_limit_exceeded(int64_t allocation_size);
 
     // Load factor that will trigger growing the hash table on insert.  This is
-    // defined as the number of non-empty buckets / total_buckets
+    // defined as the number of non-empty buckets / total_buckets.  It must be less than
+    // 1 so that there is always an empty slot to end a probe.
     static const float MAX_BUCKET_OCCUPANCY_FRACTION;
 
+    // Minimum number of keys / size of the range of keys to build a direct map
+    static const float DIRECT_MAP_MIN_DENSITY;
+
     const std::vector<ExprContext*>& _build_expr_ctxs;
-    const std::vector<ExprContext*>& _probe_expr_ctxs;
+    // not owned, replaced by set_probe_exprs()
+    const std::vector<ExprContext*>* _probe_expr_ctxs;
 
     // Number of Tuple* in the build tuple row
     const int _num_build_tuples;
@@ -352,7 +441,8 @@ private:
     // Size of hash table nodes.  This includes a fixed size header and the Tuple*'s that
     // follow.
     const int _node_byte_size;
-    // Number of non-empty buckets.  Used to determine when to grow and rehash
+    // Number of non-empty buckets, i.e. number of distinct keys.  Used to determine when
+    // to grow and rehash
     int64_t _num_filled_buckets;
     // Memory to store node data.  This is not allocated from a pool to take advantage
     // of realloc.
@@ -370,14 +460,48 @@ private:
     // subsequent calls to Insert() will be ignored.
     bool _mem_limit_exceeded;
 
-    std::vector<Bucket> _buckets;
+    // Control bytes of the slots, EMPTY_SLOT or the tag of the hash of the key in the
+    // slot, _num_buckets + GROUP_SIZE - 1 bytes.  The first GROUP_SIZE - 1 bytes are
+    // cloned at the end.
+    uint8_t* _ctrl;
+
+    // Index of the first node of the key in each slot, -1 if the slot is empty
+    int64_t* _buckets;
 
-    // equal to _buckets.size() but more efficient than the size function
+    // Number of slots
     int64_t _num_buckets;
 
     // The number of filled buckets to trigger a resize.  This is cached for efficiency
     int64_t _num_buckets_till_resize;
 
+    // TYPE_INT or TYPE_BIGINT if the table has a single key of that type, on both the
+    // build and probe side, otherwise INVALID_TYPE
+    PrimitiveType _int_key_type;
+
+    // Range of the non-null integer keys inserted, valid if _int_key_type is set and
+    // _min_int_key <= _max_int_key
+    int64_t _min_int_key;
+    int64_t _max_int_key;
+
+    // Slot of each key in [_min_int_key, _max_int_key], -1 if the key is not in the
+    // table.  NULL if there is no direct map.
+    int64_t* _direct_map;
+    int64_t _direct_map_size;
+
+    // The table whose rows and slots this table probes, see share_build()
+    std::shared_ptr<HashTable> _shared_build;
+
+    // Whether the rows and slots are probed by other tables, see set_build_shared()
+    bool _build_shared;
+
+    // Cache of prefetch_probe_rows(): for each row, whether it can't match because of a
+    // NULL, its hash, and the contents of '_expr_values_buffer' and
+    // '_expr_value_null_bits' after evaluating it
+    std::vector<uint8_t> _probe_cache_skip;
+    std::vector<uint32_t> _probe_cache_hashes;
+    std::vector<uint8_t> _probe_cache_values;
+    std::vector<uint8_t> _probe_cache_null_bits;
+
     // Cache of exprs values for the current row being evaluated.  This can either
     // be a build row (during insert()) or probe row (during find()).
     std::vector<int> _expr_values_buffer_offsets;
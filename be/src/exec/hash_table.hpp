@@ -18,6 +18,13 @@
 #ifndef DORIS_BE_SRC_QUERY_EXEC_HASH_TABLE_HPP
 #define DORIS_BE_SRC_QUERY_EXEC_HASH_TABLE_HPP
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include <algorithm>
+
+#include "common/compiler_util.h"
 #include "exec/hash_table.h"
 
 namespace doris {
@@ -29,58 +36,166 @@ inline HashTable::Iterator HashTable::find(TupleRow* probe_row, bool probe) {
         return end();
     }
 
+    if (_direct_map != NULL && !_expr_value_null_bits[0]) {
+        return find_in_direct_map();
+    }
+
     uint32_t hash = hash_current_row();
-    int64_t bucket_idx = hash & (_num_buckets - 1);
+    bool found = false;
+    int64_t bucket_idx = find_bucket(hash, false, &found);
 
-    Bucket* bucket = &_buckets[bucket_idx];
-    int64_t node_idx = bucket->_node_idx;
+    if (!found) {
+        return end();
+    }
 
-    while (node_idx != -1) {
-        Node* node = get_node(node_idx);
+    return Iterator(this, bucket_idx, _buckets[bucket_idx]);
+}
 
-        if (node->_hash == hash && equals(node->data())) {
-            return Iterator(this, bucket_idx, node_idx, hash);
-        }
+inline HashTable::Iterator HashTable::find_in_direct_map() {
+    int64_t key = int_key_value();
 
-        node_idx = node->_next_idx;
+    if (key < _min_int_key || key > _max_int_key) {
+        return end();
     }
 
-    return end();
+    int64_t bucket_idx = _direct_map[key - _min_int_key];
+
+    if (bucket_idx == -1) {
+        return end();
+    }
+
+    return Iterator(this, bucket_idx, _buckets[bucket_idx]);
+}
+
+inline HashTable::Iterator HashTable::find_cached(int idx) {
+    DCHECK_LT(idx, _probe_cache_skip.size());
+
+    if (_probe_cache_skip[idx]) {
+        return end();
+    }
+
+    memcpy(_expr_values_buffer, &_probe_cache_values[idx * _results_buffer_size],
+           _results_buffer_size);
+    memcpy(_expr_value_null_bits, &_probe_cache_null_bits[idx * _build_expr_ctxs.size()],
+           _build_expr_ctxs.size());
+
+    if (_direct_map != NULL && !_expr_value_null_bits[0]) {
+        return find_in_direct_map();
+    }
+
+    bool found = false;
+    int64_t bucket_idx = find_bucket(_probe_cache_hashes[idx], false, &found);
+
+    if (!found) {
+        return end();
+    }
+
+    return Iterator(this, bucket_idx, _buckets[bucket_idx]);
 }
 
 inline HashTable::Iterator HashTable::begin() {
-    int64_t bucket_idx = -1;
-    Bucket* bucket = next_bucket(&bucket_idx);
+    if (_num_nodes == 0) {
+        return end();
+    }
+
+    return Iterator(this, SCAN_BUCKET_IDX, 0);
+}
 
-    if (bucket != NULL) {
-        return Iterator(this, bucket_idx, bucket->_node_idx, 0);
+inline uint32_t HashTable::match_group(int64_t bucket_idx, uint8_t ctrl) const {
+    const uint8_t* group = &_ctrl[bucket_idx];
+#ifdef __SSE2__
+    auto ctrls = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+    auto tests = _mm_set1_epi8(static_cast<char>(ctrl));
+    uint32_t mask = _mm_movemask_epi8(_mm_cmpeq_epi8(ctrls, tests));
+#else
+    uint32_t mask = 0;
+    for (int i = 0; i < GROUP_SIZE; ++i) {
+        mask |= static_cast<uint32_t>(group[i] == ctrl) << i;
+    }
+#endif
+    if (_num_buckets < GROUP_SIZE) {
+        mask &= (1U << _num_buckets) - 1;
     }
+    return mask;
+}
+
+inline int64_t HashTable::find_bucket(uint32_t hash, bool force_null_equality, bool* found) {
+    uint8_t tag = hash_tag(hash);
+    int64_t bucket_idx = hash & (_num_buckets - 1);
+
+    while (true) {
+        uint32_t mask = match_group(bucket_idx, tag);
+
+        while (mask != 0) {
+            int64_t idx = (bucket_idx + __builtin_ctz(mask)) & (_num_buckets - 1);
+            Node* node = get_node(_buckets[idx]);
+
+            if (node->_hash == hash && equals(node->data(), force_null_equality)) {
+                *found = true;
+                return idx;
+            }
 
-    return end();
+            mask &= (mask - 1);
+        }
+
+        // The key would have been put in the first empty slot of its probe sequence
+        mask = match_group(bucket_idx, EMPTY_SLOT);
+
+        if (mask != 0) {
+            *found = false;
+            return (bucket_idx + __builtin_ctz(mask)) & (_num_buckets - 1);
+        }
+
+        bucket_idx = (bucket_idx + GROUP_SIZE) & (_num_buckets - 1);
+    }
 }
 
-inline HashTable::Bucket* HashTable::next_bucket(int64_t* bucket_idx) {
-    ++*bucket_idx;
+inline int64_t HashTable::find_empty_bucket(uint32_t hash) const {
+    int64_t bucket_idx = hash & (_num_buckets - 1);
+
+    while (true) {
+        uint32_t mask = match_group(bucket_idx, EMPTY_SLOT);
 
-    for (; *bucket_idx < _num_buckets; ++*bucket_idx) {
-        if (_buckets[*bucket_idx]._node_idx != -1) {
-            return &_buckets[*bucket_idx];
+        if (mask != 0) {
+            return (bucket_idx + __builtin_ctz(mask)) & (_num_buckets - 1);
         }
+
+        bucket_idx = (bucket_idx + GROUP_SIZE) & (_num_buckets - 1);
     }
+}
 
-    *bucket_idx = -1;
-    return NULL;
+inline void HashTable::set_ctrl(int64_t bucket_idx, uint8_t ctrl) {
+    for (int64_t i = bucket_idx; i < _num_buckets + GROUP_SIZE - 1; i += _num_buckets) {
+        _ctrl[i] = ctrl;
+    }
 }
 
-inline void HashTable::insert_impl(TupleRow* row) {
+inline void HashTable::insert_impl(TupleRow* row, bool unique) {
     bool has_null = eval_build_row(row);
 
     if (!_stores_nulls && has_null) {
         return;
     }
 
+    DCHECK(_shared_build == nullptr && !_build_shared) << "a shared build can't be inserted into";
+
+    if (UNLIKELY(_direct_map != NULL)) {
+        release_direct_map();
+    }
+
+    if (_int_key_type != INVALID_TYPE && !has_null) {
+        int64_t key = int_key_value();
+        _min_int_key = std::min(_min_int_key, key);
+        _max_int_key = std::max(_max_int_key, key);
+    }
+
     uint32_t hash = hash_current_row();
-    int64_t bucket_idx = hash & (_num_buckets - 1);
+    bool found = false;
+    int64_t bucket_idx = find_bucket(hash, true, &found);
+
+    if (found && unique) {
+        return;
+    }
 
     if (_num_nodes == _nodes_capacity) {
         grow_node_array();
@@ -90,81 +205,46 @@ inline void HashTable::insert_impl(TupleRow* row) {
     TupleRow* data = node->data();
     node->_hash = hash;
     memcpy(data, row, sizeof(Tuple*) * _num_build_tuples);
-    add_to_bucket(&_buckets[bucket_idx], _num_nodes, node);
-    ++_num_nodes;
-}
-
-inline void HashTable::add_to_bucket(Bucket* bucket, int64_t node_idx, Node* node) {
-    if (bucket->_node_idx == -1) {
-        ++_num_filled_buckets;
-    }
 
-    node->_next_idx = bucket->_node_idx;
-    bucket->_node_idx = node_idx;
-}
-
-inline void HashTable::move_node(Bucket* from_bucket, Bucket* to_bucket,
-                                int64_t node_idx, Node* node, Node* previous_node) {
-    int64_t next_idx = node->_next_idx;
-
-    if (previous_node != NULL) {
-        previous_node->_next_idx = next_idx;
+    if (found) {
+        // Chain the node to the front of the nodes with the same key
+        node->_next_idx = _buckets[bucket_idx];
     } else {
-        // Update bucket directly
-        from_bucket->_node_idx = next_idx;
-
-        if (next_idx == -1) {
-            --_num_filled_buckets;
-        }
+        node->_next_idx = -1;
+        set_ctrl(bucket_idx, hash_tag(hash));
+        ++_num_filled_buckets;
     }
 
-    add_to_bucket(to_bucket, node_idx, node);
+    _buckets[bucket_idx] = _num_nodes;
+    ++_num_nodes;
 }
 
 template<bool check_match>
 inline void HashTable::Iterator::next() {
-    if (_bucket_idx == -1) {
+    if (_node_idx == -1) {
         return;
     }
 
-    // TODO: this should prefetch the next tuplerow
-    Node* node = _table->get_node(_node_idx);
-
-    // Iterator is not from a full table scan, evaluate equality now.  Only the current
-    // bucket needs to be scanned. '_expr_values_buffer' contains the results
-    // for the current probe row.
     if (check_match) {
+        // Iterator is from a find().  The nodes chained to the slot all have the key
+        // of the probe row, so they are returned without evaluating equality again.
         // TODO: this should prefetch the next node
-        int64_t next_idx = node->_next_idx;
-
-        while (next_idx != -1) {
-            node = _table->get_node(next_idx);
-
-            if (node->_hash == _scan_hash && _table->equals(node->data())) {
-                _node_idx = next_idx;
-                return;
-            }
+        int64_t next_idx = _table->get_node(_node_idx)->_next_idx;
 
-            next_idx = node->_next_idx;
+        if (next_idx != -1) {
+            _node_idx = next_idx;
+            return;
         }
 
         *this = _table->end();
     } else {
-        // Move onto the next chained node
-        if (node->_next_idx != -1) {
-            _node_idx = node->_next_idx;
+        // Full table scan, the nodes are stored densely
+        if (_node_idx + 1 < _table->_num_nodes) {
+            ++_node_idx;
             return;
         }
 
-        // Move onto the next bucket
-        Bucket* bucket = _table->next_bucket(&_bucket_idx);
-
-        if (bucket == NULL) {
-            _bucket_idx = -1;
-            _node_idx = -1;
-        } else {
-            _node_idx = bucket->_node_idx;
-        }
+        *this = _table->end();
     }
 }
 
@@ -40,7 +40,7 @@ Status IntersectNode::init(const TPlanNode& tnode, RuntimeState* state) {
 
 // the actual intersect operation is in this function,
 // 1  build a hash table from child(0)
-// 2 probe with child(1), then filter the hash table and find the matched item, use them to rebuild a hash table
+// 2 probe with child(1), then drop the items not matched from the hash table in place
 // repeat [2] this for all the rest child
 Status IntersectNode::open(RuntimeState* state) {
     RETURN_IF_ERROR(SetOperationNode::open(state));
@@ -54,21 +54,9 @@ Status IntersectNode::open(RuntimeState* state) {
     for (int i = 1; i < _children.size(); ++i) {
         if (i > 1) {
             SCOPED_TIMER(_build_timer);
-            std::unique_ptr<HashTable> temp_tbl(
-                    new HashTable(_child_expr_lists[0], _child_expr_lists[i], _build_tuple_size,
-                                  true, _find_nulls, id(), mem_tracker(), 1024));
-            _hash_tbl_iterator = _hash_tbl->begin();
-            while (_hash_tbl_iterator.has_next()) {
-                if (_hash_tbl_iterator.matched()) {
-                    VLOG_ROW << "rebuild row: "
-                             << get_row_output_string(_hash_tbl_iterator.get_row(),
-                                                      child(0)->row_desc());
-                    temp_tbl->insert(_hash_tbl_iterator.get_row());
-                }
-                _hash_tbl_iterator.next<false>();
-            }
-            _hash_tbl.swap(temp_tbl);
-            temp_tbl->close();
+            // keep only the rows the last child matched, in place
+            _hash_tbl->retain(true);
+            _hash_tbl->set_probe_exprs(_child_expr_lists[i]);
             VLOG_ROW << "hash table content: "
                      << _hash_tbl->debug_string(true, &child(0)->row_desc());
             // if a table is empty, the result must be empty
@@ -76,6 +64,7 @@ Status IntersectNode::open(RuntimeState* state) {
                 break;
             }
         }
+        RETURN_IF_ERROR(push_down_hash_table_keys(state, i));
         // probe
         _probe_batch.reset(
                 new RowBatch(child(i)->row_desc(), state->batch_size(), mem_tracker().get()));
@@ -108,6 +97,7 @@ Status IntersectNode::get_next(RuntimeState* state, RowBatch* out_batch, bool* e
     RETURN_IF_ERROR(exec_debug_action(TExecNodePhase::GETNEXT));
     RETURN_IF_CANCELLED(state);
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_CPU_TIMER(_cpu_timer);
     *eos = true;
     if (reached_limit()) {
         return Status::OK();
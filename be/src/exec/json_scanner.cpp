@@ -24,6 +24,7 @@
 #include "exec/local_file_reader.h"
 #include "exprs/expr.h"
 #include "exprs/json_functions.h"
+#include "exprs/json_walker.h"
 #include "gutil/strings/split.h"
 #include "runtime/exec_env.h"
 #include "runtime/mem_tracker.h"
@@ -189,7 +190,8 @@ JsonReader::JsonReader(RuntimeState* state, ScannerCounter* counter, RuntimeProf
           _file_reader(file_reader),
           _closed(false),
           _strip_outer_array(strip_outer_array),
-          _json_doc(nullptr) {
+          _json_doc(nullptr),
+          _walk_simple_json(false) {
     _bytes_read_counter = ADD_COUNTER(_profile, "BytesRead", TUnit::BYTES);
     _read_timer = ADD_TIMER(_profile, "FileReadTime");
 }
@@ -211,6 +213,7 @@ Status JsonReader::init(const std::string& jsonpath, const std::string& json_roo
     //improve performance
     if (_parsed_jsonpaths.empty()) { // input is a simple json-string
         _handle_json_callback = &JsonReader::_handle_simple_json;
+        _walk_simple_json = _parsed_json_root.empty();
     } else { // input is a complex json-string and a json-path
         if (_strip_outer_array) {
             _handle_json_callback = &JsonReader::_handle_flat_array_complex_json;
@@ -270,6 +273,13 @@ Status JsonReader::_parse_json_doc(bool* eof) {
         *eof = true;
         return Status::OK();
     }
+    if (_walk_simple_json) {
+        _json_str.reset(json_str);
+        if (_walk_json_doc((char*)json_str, length)) {
+            return Status::OK();
+        }
+        json_str = _json_str.release();
+    }
     // parse jsondata to JsonDoc
     if (_origin_json_doc.Parse((char*)json_str, length).HasParseError()) {
         std::stringstream str_error;
@@ -317,6 +327,50 @@ Status JsonReader::_parse_json_doc(bool* eof) {
     return Status::OK();
 }
 
+static const char* skip_json_whitespace(const char* p, const char* end) {
+    while (p < end && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t')) {
+        ++p;
+    }
+    return p;
+}
+
+// Only walks the message to find the text of its objects, which is much cheaper than
+// parsing it into a document. The values are parsed when they can't be written from their
+// text, see _write_text_to_tuple().
+// return false if the message must be parsed instead, e.g. to report its errors.
+bool JsonReader::_walk_json_doc(const char* json, size_t length) {
+    _json_rows.clear();
+    if (JsonWalker(json, length).validate() != JsonWalker::FOUND) {
+        return false;
+    }
+    const char* begin = skip_json_whitespace(json, json + length);
+    if ((*begin == '[') != _strip_outer_array) {
+        return false;
+    }
+    if (!_strip_outer_array) {
+        _json_rows.emplace_back(begin, json + length);
+        return true;
+    }
+    JsonWalker walker(json, length);
+    walker.enter();
+    const char* value = nullptr;
+    const char* value_end = nullptr;
+    while (walker.next_element(&value, &value_end) == JsonWalker::FOUND) {
+        _json_rows.emplace_back(value, value_end);
+    }
+    // an empty array is reported by the parsed document
+    return !_json_rows.empty();
+}
+
+// parse the text of a value of the walked message, which is valid json.
+rapidjson::Value& JsonReader::_parse_json_text(const char* begin, const char* end) {
+    _text_doc.SetNull();
+    _text_doc.GetAllocator().Clear();
+    _text_doc.Parse(begin, end - begin);
+    DCHECK(!_text_doc.HasParseError());
+    return _text_doc;
+}
+
 std::string JsonReader::_print_json_value(const rapidjson::Value& value) {
     rapidjson::StringBuffer buffer;
     buffer.Clear();
@@ -451,6 +505,120 @@ void JsonReader::_set_tuple_value(rapidjson::Value& objectValue, Tuple* tuple,
     return;
 }
 
+// whether the text of a number is an integer printed the way _write_data_to_tuple() prints
+// it, i.e. without leading zeros, and is in the range of int64
+static bool is_printed_integer(const char* begin, const char* end) {
+    if (*begin == '-') {
+        // rapidjson may parse -0 as a double
+        if (++begin == end || *begin == '0') {
+            return false;
+        }
+    }
+    if (end - begin > 18) {
+        return false;
+    }
+    for (const char* p = begin; p < end; ++p) {
+        if (*p < '0' || *p > '9') {
+            return false;
+        }
+    }
+    return true;
+}
+
+// write the text of a value like _write_data_to_tuple(), the value is only parsed when
+// its text isn't what is written.
+void JsonReader::_write_text_to_tuple(const char* begin, const char* end, SlotDescriptor* desc,
+                                      Tuple* tuple, MemPool* tuple_pool, bool* valid) {
+    *valid = true;
+    switch (*begin) {
+    case '"':
+        if (memchr(begin + 1, '\\', end - begin - 2) == nullptr) {
+            _fill_slot(tuple, desc, tuple_pool, (uint8_t*)begin + 1, end - begin - 2);
+            return;
+        }
+        break;
+    case 't':
+        _fill_slot(tuple, desc, tuple_pool, (uint8_t*)"1", 1);
+        return;
+    case 'f':
+        _fill_slot(tuple, desc, tuple_pool, (uint8_t*)"0", 1);
+        return;
+    case 'n':
+        if (desc->is_nullable()) {
+            tuple->set_null(desc->null_indicator_offset());
+            return;
+        }
+        break;
+    case '{':
+    case '[':
+        break;
+    default:
+        if (is_printed_integer(begin, end)) {
+            _fill_slot(tuple, desc, tuple_pool, (uint8_t*)begin, end - begin);
+            return;
+        }
+        break;
+    }
+    _write_data_to_tuple(&_parse_json_text(begin, end), desc, tuple, tuple_pool, valid);
+}
+
+// for the text of an object of a simple json, like _set_tuple_value(objectValue, ...).
+// The rows that are invalid or have escaped keys are parsed to be set by the former.
+void JsonReader::_set_tuple_value(const char* begin, const char* end, Tuple* tuple,
+                                  const std::vector<SlotDescriptor*>& slot_descs,
+                                  MemPool* tuple_pool, bool* valid) {
+    JsonWalker walker(begin, end - begin);
+    if (*begin != '{' || walker.enter() != JsonWalker::FOUND) {
+        _set_tuple_value(_parse_json_text(begin, end), tuple, slot_descs, tuple_pool, valid);
+        return;
+    }
+    // like rapidjson, the first member of a name is the value of a column
+    _slot_values.assign(slot_descs.size(), std::make_pair(nullptr, nullptr));
+    const char* name = nullptr;
+    size_t name_len = 0;
+    bool escaped = false;
+    const char* value = nullptr;
+    const char* value_end = nullptr;
+    while (walker.next_member(&name, &name_len, &escaped, &value, &value_end) ==
+           JsonWalker::FOUND) {
+        if (escaped) {
+            _set_tuple_value(_parse_json_text(begin, end), tuple, slot_descs, tuple_pool, valid);
+            return;
+        }
+        for (int i = 0; i < slot_descs.size(); ++i) {
+            const std::string& col_name = slot_descs[i]->col_name();
+            if (_slot_values[i].first == nullptr && col_name.size() == name_len &&
+                memcmp(col_name.data(), name, name_len) == 0) {
+                _slot_values[i] = std::make_pair(value, value_end);
+            }
+        }
+    }
+
+    int nullcount = 0;
+    for (int i = 0; i < slot_descs.size(); ++i) {
+        SlotDescriptor* desc = slot_descs[i];
+        if (_slot_values[i].first != nullptr) {
+            _write_text_to_tuple(_slot_values[i].first, _slot_values[i].second, desc, tuple,
+                                 tuple_pool, valid);
+            if (!(*valid)) {
+                return;
+            }
+        } else if (desc->is_nullable()) {
+            tuple->set_null(desc->null_indicator_offset());
+            nullcount++;
+        } else {
+            // parsed to report the row
+            _set_tuple_value(_parse_json_text(begin, end), tuple, slot_descs, tuple_pool, valid);
+            return;
+        }
+    }
+    if (nullcount == slot_descs.size()) {
+        _set_tuple_value(_parse_json_text(begin, end), tuple, slot_descs, tuple_pool, valid);
+        return;
+    }
+    *valid = true;
+}
+
 /**
  * handle input a simple json.
  * A json is a simple json only when user not specifying the json path.
@@ -472,7 +640,9 @@ Status JsonReader::_handle_simple_json(Tuple* tuple, const std::vector<SlotDescr
             if (*eof) {          // read all data, then return
                 return Status::OK();
             }
-            if (_json_doc->IsArray()) {
+            if (!_json_rows.empty()) {
+                _total_lines = _json_rows.size();
+            } else if (_json_doc->IsArray()) {
                 _total_lines = _json_doc->Size();
                 if (_total_lines == 0) {
                     // may be passing an empty json, such as "[]"
@@ -490,7 +660,10 @@ Status JsonReader::_handle_simple_json(Tuple* tuple, const std::vector<SlotDescr
             _next_line = 0;
         }
 
-        if (_json_doc->IsArray()) {                                   // handle case 1
+        if (!_json_rows.empty()) { // handle the walked case 1 or 2
+            const std::pair<const char*, const char*>& row = _json_rows[_next_line];
+            _set_tuple_value(row.first, row.second, tuple, slot_descs, tuple_pool, &valid);
+        } else if (_json_doc->IsArray()) { // handle case 1
             rapidjson::Value& objectValue = (*_json_doc)[_next_line]; // json object
             _set_tuple_value(objectValue, tuple, slot_descs, tuple_pool, &valid);
         } else { // handle case 2
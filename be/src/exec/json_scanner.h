@@ -27,6 +27,7 @@
 #include <memory>
 #include <sstream>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "common/status.h"
@@ -127,9 +128,16 @@ private:
     void _fill_slot(Tuple* tuple, SlotDescriptor* slot_desc, MemPool* mem_pool,
                     const uint8_t* value, int32_t len);
     Status _parse_json_doc(bool* eof);
+    bool _walk_json_doc(const char* json, size_t length);
+    rapidjson::Value& _parse_json_text(const char* begin, const char* end);
     void _set_tuple_value(rapidjson::Value& objectValue, Tuple* tuple,
                           const std::vector<SlotDescriptor*>& slot_descs, MemPool* tuple_pool,
                           bool* valid);
+    void _set_tuple_value(const char* begin, const char* end, Tuple* tuple,
+                          const std::vector<SlotDescriptor*>& slot_descs, MemPool* tuple_pool,
+                          bool* valid);
+    void _write_text_to_tuple(const char* begin, const char* end, SlotDescriptor* desc,
+                              Tuple* tuple, MemPool* tuple_pool, bool* valid);
     void _write_data_to_tuple(rapidjson::Value::ConstValueIterator value, SlotDescriptor* desc,
                               Tuple* tuple, MemPool* tuple_pool, bool* valid);
     bool _write_values_by_jsonpath(rapidjson::Value& objectValue, MemPool* tuple_pool, Tuple* tuple,
@@ -158,6 +166,16 @@ private:
 
     rapidjson::Document _origin_json_doc; // origin json document object from parsed json string
     rapidjson::Value* _json_doc; // _json_doc equals _final_json_doc iff not set `json_root`
+
+    // A simple json without `json_root` is walked instead of parsed into _origin_json_doc,
+    // see _walk_json_doc().
+    bool _walk_simple_json;
+    std::unique_ptr<uint8_t[]> _json_str; // the walked message
+    // the text of the objects of the walked message, empty if it's parsed
+    std::vector<std::pair<const char*, const char*>> _json_rows;
+    // the text of the value of each slot in the current object
+    std::vector<std::pair<const char*, const char*>> _slot_values;
+    rapidjson::Document _text_doc; // parsed from the text of a row or a value
 };
 
 } // namespace doris
@@ -17,11 +17,13 @@
 
 #include "exec/merge_join_node.h"
 
+#include <algorithm>
 #include <sstream>
 
 #include "exprs/expr.h"
-#include "exprs/in_predicate.h"
+#include "exprs/expr_context.h"
 #include "gen_cpp/PlanNodes_types.h"
+#include "runtime/raw_value.h"
 #include "runtime/row_batch.h"
 #include "runtime/runtime_state.h"
 #include "util/debug_util.h"
@@ -29,24 +31,8 @@
 
 namespace doris {
 
-template <class T>
-int compare_value(const void* left_value, const void* right_value) {
-    if (*(T*)left_value < *(T*)right_value) {
-        return -1;
-    } else if (*(T*)left_value == *(T*)right_value) {
-        return 0;
-    } else {
-        return 1;
-    }
-}
-
-template <class T>
-int compare_value(const StringValue* left_value, const StringValue* right_value) {
-    return left_value->compare(*right_value);
-}
-
 MergeJoinNode::MergeJoinNode(ObjectPool* pool, const TPlanNode& tnode, const DescriptorTbl& descs)
-        : ExecNode(pool, tnode, descs), _out_batch(NULL) {}
+        : ExecNode(pool, tnode, descs), _eos(false), _right_group_idx(-1) {}
 
 MergeJoinNode::~MergeJoinNode() {}
 
@@ -71,43 +57,17 @@ Status MergeJoinNode::init(const TPlanNode& tnode, RuntimeState* state) {
 Status MergeJoinNode::prepare(RuntimeState* state) {
     RETURN_IF_ERROR(ExecNode::prepare(state));
 
-    // build and probe exprs are evaluated in the context of the rows produced by our
-    // right and left children, respectively
+    // the keys are evaluated in the context of the rows produced by our
+    // left and right children, respectively
     RETURN_IF_ERROR(
             Expr::prepare(_left_expr_ctxs, state, child(0)->row_desc(), expr_mem_tracker()));
     RETURN_IF_ERROR(
             Expr::prepare(_right_expr_ctxs, state, child(1)->row_desc(), expr_mem_tracker()));
 
-    for (int i = 0; i < _left_expr_ctxs.size(); ++i) {
-        switch (_left_expr_ctxs[i]->root()->type().type) {
-        case TYPE_TINYINT:
-            _cmp_func.push_back(compare_value<int8_t>);
-            break;
-
-        case TYPE_SMALLINT:
-            _cmp_func.push_back(compare_value<int16_t>);
-            break;
-
-        case TYPE_INT:
-            _cmp_func.push_back(compare_value<int32_t>);
-            break;
-
-        case TYPE_BIGINT:
-            _cmp_func.push_back(compare_value<int64_t>);
-            break;
-
-        case TYPE_LARGEINT:
-            _cmp_func.push_back(compare_value<__int128>);
-            break;
-
-        case TYPE_CHAR:
-        case TYPE_VARCHAR:
-            _cmp_func.push_back(compare_value<StringValue>);
-            break;
-
-        default:
-            return Status::InternalError("unsupported compare type.");
-            break;
+    // two right rows are compared by the same exprs, whose values must not share a buffer
+    for (int i = 0; i < _right_expr_ctxs.size(); ++i) {
+        if (_right_expr_ctxs[i]->root()->node_type() != TExprNodeType::SLOT_REF) {
+            return Status::InternalError("merge join keys must be slots.");
         }
     }
 
@@ -115,9 +75,7 @@ Status MergeJoinNode::prepare(RuntimeState* state) {
     RETURN_IF_ERROR(
             Expr::prepare(_other_join_conjunct_ctxs, state, _row_descriptor, expr_mem_tracker()));
 
-    _result_tuple_row_size = _row_descriptor.tuple_descriptors().size() * sizeof(Tuple*);
     // pre-compute the tuple index of build tuples in the output row
-
     _left_tuple_size = child(0)->row_desc().tuple_descriptors().size();
     _right_tuple_size = child(1)->row_desc().tuple_descriptors().size();
     _right_tuple_idx.reserve(_right_tuple_size);
@@ -127,10 +85,10 @@ Status MergeJoinNode::prepare(RuntimeState* state) {
         _right_tuple_idx.push_back(_row_descriptor.get_tuple_idx(right_tuple_desc->id()));
     }
 
-    _left_child_ctx.reset(
-            new ChildReaderContext(row_desc(), state->batch_size(), state->instance_mem_tracker()));
-    _right_child_ctx.reset(
-            new ChildReaderContext(row_desc(), state->batch_size(), state->instance_mem_tracker()));
+    _left_child_ctx.reset(new ChildReaderContext(child(0)->row_desc(), state->batch_size(),
+                                                 mem_tracker().get()));
+    _right_child_ctx.reset(new ChildReaderContext(child(1)->row_desc(), state->batch_size(),
+                                                  mem_tracker().get()));
 
     return Status::OK();
 }
@@ -140,6 +98,10 @@ Status MergeJoinNode::close(RuntimeState* state) {
         return Status::OK();
     }
     RETURN_IF_ERROR(exec_debug_action(TExecNodePhase::CLOSE));
+    _right_group.clear();
+    _right_group_batches.clear();
+    _left_child_ctx.reset();
+    _right_child_ctx.reset();
     Expr::close(_left_expr_ctxs, state);
     Expr::close(_right_expr_ctxs, state);
     Expr::close(_other_join_conjunct_ctxs, state);
@@ -148,6 +110,7 @@ Status MergeJoinNode::close(RuntimeState* state) {
 
 Status MergeJoinNode::open(RuntimeState* state) {
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_CPU_TIMER(_cpu_timer);
     RETURN_IF_CANCELLED(state);
     RETURN_IF_ERROR(ExecNode::open(state));
     RETURN_IF_ERROR(Expr::open(_left_expr_ctxs, state));
@@ -155,14 +118,12 @@ Status MergeJoinNode::open(RuntimeState* state) {
     RETURN_IF_ERROR(Expr::open(_other_join_conjunct_ctxs, state));
 
     _eos = false;
-    // Open the probe-side child so that it may perform any initialisation in parallel.
-    // Don't exit even if we see an error, we still need to wait for the build thread
-    // to finish.
     RETURN_IF_ERROR(child(0)->open(state));
     RETURN_IF_ERROR(child(1)->open(state));
 
-    RETURN_IF_ERROR(get_input_row(state, 0));
-    RETURN_IF_ERROR(get_input_row(state, 1));
+    // no row is returned yet, so there is no batch to pass resources on to
+    RETURN_IF_ERROR(get_input_row(state, 0, NULL));
+    RETURN_IF_ERROR(get_input_row(state, 1, NULL));
 
     return Status::OK();
 }
@@ -171,149 +132,175 @@ Status MergeJoinNode::get_next(RuntimeState* state, RowBatch* out_batch, bool* e
     RETURN_IF_ERROR(exec_debug_action(TExecNodePhase::GETNEXT));
     RETURN_IF_CANCELLED(state);
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_CPU_TIMER(_cpu_timer);
 
     if (reached_limit() || _eos) {
         *eos = true;
         return Status::OK();
     }
 
-    while (true) {
-        int row_idx = out_batch->add_row();
-        DCHECK(row_idx != RowBatch::INVALID_ROW_INDEX);
-        TupleRow* row = out_batch->get_row(row_idx);
-
-        _out_batch = out_batch;
-        RETURN_IF_ERROR(get_next_row(state, row, eos));
+    ExprContext* const* other_conjunct_ctxs = _other_join_conjunct_ctxs.data();
+    int num_other_conjunct_ctxs = _other_join_conjunct_ctxs.size();
+    ExprContext* const* conjunct_ctxs = _conjunct_ctxs.data();
+    int num_conjunct_ctxs = _conjunct_ctxs.size();
+
+    while (!out_batch->is_full() && !out_batch->at_resource_limit()) {
+        TupleRow* left_row = _left_child_ctx->current_row;
+
+        if (_right_group_idx >= 0) {
+            // join the current left row with the rest of the right group
+            int num_group_rows = num_right_group_rows();
+            while (_right_group_idx < num_group_rows && !out_batch->is_full()) {
+                int row_idx = out_batch->add_row();
+                TupleRow* out_row = out_batch->get_row(row_idx);
+                create_output_row(out_row, left_row, right_group_row(_right_group_idx++));
+                if (eval_conjuncts(other_conjunct_ctxs, num_other_conjunct_ctxs, out_row) &&
+                    eval_conjuncts(conjunct_ctxs, num_conjunct_ctxs, out_row)) {
+                    out_batch->commit_last_row();
+                    ++_num_rows_returned;
+                    if (reached_limit()) {
+                        break;
+                    }
+                }
+            }
+            if (reached_limit()) {
+                _eos = true;
+                break;
+            }
+            if (_right_group_idx < num_group_rows) {
+                break;
+            }
+            _right_group_idx = -1;
+            RETURN_IF_ERROR(get_input_row(state, 0, out_batch));
+            continue;
+        }
 
-        if (*eos) {
+        if (left_row == NULL) {
             _eos = true;
-            return Status::OK();
+            break;
         }
 
-        if (eval_conjuncts(&_other_join_conjunct_ctxs[0], _other_join_conjunct_ctxs.size(), row)) {
-            out_batch->commit_last_row();
-            ++_num_rows_returned;
-            COUNTER_SET(_rows_returned_counter, _num_rows_returned);
+        if (!_right_group.empty()) {
+            int cmp = compare_keys(_left_expr_ctxs, left_row, _right_expr_ctxs,
+                                   right_group_row(0));
+            if (cmp == 0) {
+                _right_group_idx = 0;
+                continue;
+            } else if (cmp < 0) {
+                RETURN_IF_ERROR(get_input_row(state, 0, out_batch));
+                continue;
+            }
+            // the following left rows are greater than the group as well
+            clear_right_group(out_batch);
         }
 
-        if (out_batch->is_full() || out_batch->at_resource_limit() || reached_limit()) {
+        TupleRow* right_row = _right_child_ctx->current_row;
+        if (right_row == NULL) {
+            _eos = true;
             break;
         }
+        int cmp = compare_keys(_left_expr_ctxs, left_row, _right_expr_ctxs, right_row);
+        if (cmp < 0) {
+            RETURN_IF_ERROR(get_input_row(state, 0, out_batch));
+        } else if (cmp > 0) {
+            RETURN_IF_ERROR(get_input_row(state, 1, out_batch));
+        } else {
+            RETURN_IF_ERROR(build_right_group(state, out_batch));
+        }
     }
 
+    if (_eos) {
+        // pass on all resources, rows of out_batch might still need them
+        clear_right_group(out_batch);
+        _left_child_ctx->batch->transfer_resource_ownership(out_batch);
+        _right_child_ctx->batch->transfer_resource_ownership(out_batch);
+    }
+    *eos = _eos;
+    COUNTER_SET(_rows_returned_counter, _num_rows_returned);
     return Status::OK();
 }
 
 void MergeJoinNode::create_output_row(TupleRow* out, TupleRow* left, TupleRow* right) {
-    if (left == NULL) {
-        memset(out, 0, _left_tuple_size);
-    } else {
-        memcpy(out, left, _left_tuple_size);
+    memcpy(out, left, _left_tuple_size * sizeof(Tuple*));
+    for (int i = 0; i < _right_tuple_size; ++i) {
+        out->set_tuple(_right_tuple_idx[i], right->get_tuple(i));
     }
+}
 
-    if (right != NULL) {
-        for (int i = 0; i < _right_tuple_size; ++i) {
-            out->set_tuple(_right_tuple_idx[i], right->get_tuple(i));
-        }
-    } else {
-        for (int i = 0; i < _right_tuple_size; ++i) {
-            out->set_tuple(_right_tuple_idx[i], NULL);
+int MergeJoinNode::compare_keys(const std::vector<ExprContext*>& lhs_ctxs, TupleRow* lhs,
+                                const std::vector<ExprContext*>& rhs_ctxs, TupleRow* rhs) {
+    for (int i = 0; i < lhs_ctxs.size(); ++i) {
+        void* lhs_value = lhs_ctxs[i]->get_value(lhs);
+        void* rhs_value = rhs_ctxs[i]->get_value(rhs);
+        int cmp = RawValue::compare(lhs_value, rhs_value, lhs_ctxs[i]->root()->type());
+        if (cmp != 0) {
+            return cmp;
         }
     }
+    return 0;
 }
 
-Status MergeJoinNode::compare_row(TupleRow* left_row, TupleRow* right_row, bool* is_lt) {
-    if (left_row == NULL) {
-        *is_lt = false;
-        return Status::OK();
-    } else if (right_row == NULL) {
-        *is_lt = true;
-        return Status::OK();
-    }
+Status MergeJoinNode::get_input_row(RuntimeState* state, int child_idx, RowBatch* out_batch) {
+    ChildReaderContext* ctx = child_idx == 0 ? _left_child_ctx.get() : _right_child_ctx.get();
+    const std::vector<ExprContext*>& key_ctxs = child_idx == 0 ? _left_expr_ctxs
+                                                               : _right_expr_ctxs;
 
-    for (int i = 0; i < _left_expr_ctxs.size(); ++i) {
-        void* left_value = _left_expr_ctxs[i]->get_value(left_row);
-        void* right_value = _right_expr_ctxs[i]->get_value(right_row);
-        int cmp_val = _cmp_func[i](left_value, right_value);
+    while (true) {
+        // loop util read a row or the child is exhausted
+        while (ctx->row_idx >= ctx->batch->num_rows()) {
+            if (child_idx == 1 && !_right_group.empty()) {
+                // the rows of the group may still be joined with following left rows
+                _right_group_batches.push_back(std::move(ctx->batch));
+                ctx->batch.reset(new RowBatch(child(1)->row_desc(), state->batch_size(),
+                                              mem_tracker().get()));
+            } else if (out_batch != NULL) {
+                // pass on resources, out_batch might still need them
+                ctx->batch->transfer_resource_ownership(out_batch);
+            } else {
+                ctx->batch->reset();
+            }
+            ctx->row_idx = 0;
+            if (ctx->is_eos) {
+                ctx->current_row = NULL;
+                return Status::OK();
+            }
+            RETURN_IF_ERROR(child(child_idx)->get_next(state, ctx->batch.get(), &ctx->is_eos));
+        }
 
-        if (cmp_val < 0) {
-            *is_lt = true;
-            return Status::OK();
-        } else if (cmp_val == 0) {
-            // do nothing
-        } else {
-            *is_lt = false;
+        ctx->current_row = ctx->batch->get_row(ctx->row_idx++);
+        bool has_null_key = false;
+        for (int i = 0; i < key_ctxs.size() && !has_null_key; ++i) {
+            has_null_key = key_ctxs[i]->get_value(ctx->current_row) == NULL;
+        }
+        if (!has_null_key) {
             return Status::OK();
         }
     }
-
-    // equal
-    *is_lt = false;
-
-    return Status::OK();
 }
 
-Status MergeJoinNode::get_next_row(RuntimeState* state, TupleRow* out_row, bool* eos) {
-    TupleRow* left_row = _left_child_ctx->current_row;
+Status MergeJoinNode::build_right_group(RuntimeState* state, RowBatch* out_batch) {
+    DCHECK(_right_group.empty());
     TupleRow* right_row = _right_child_ctx->current_row;
-
-    if (left_row == NULL && right_row == NULL) {
-        *eos = true;
-        return Status::OK();
-    }
-
-    bool is_lt = true;
-    RETURN_IF_ERROR(compare_row(left_row, right_row, &is_lt));
-
-    if (is_lt) {
-        create_output_row(out_row, left_row, NULL);
-        RETURN_IF_ERROR(get_input_row(state, 0));
-    } else {
-        create_output_row(out_row, NULL, right_row);
-        RETURN_IF_ERROR(get_input_row(state, 1));
-    }
-
-    return Status::OK();
-}
-
-Status MergeJoinNode::get_input_row(RuntimeState* state, int child_idx) {
-    ChildReaderContext* ctx = NULL;
-
-    if (child_idx == 0) {
-        ctx = _left_child_ctx.get();
-    } else {
-        ctx = _right_child_ctx.get();
-    }
-
-    // loop util read a valid data
-    while (!ctx->is_eos && ctx->row_idx >= ctx->batch.num_rows()) {
-        // transfer ownership before get new batch
-        if (NULL != _out_batch) {
-            ctx->batch.transfer_resource_ownership(_out_batch);
+    while (right_row != NULL) {
+        if (!_right_group.empty() && compare_keys(_right_expr_ctxs, right_group_row(0),
+                                                  _right_expr_ctxs, right_row) != 0) {
+            break;
         }
-
-        if (child_idx == 0) {
-            _left_child_ctx.reset(new ChildReaderContext(child(child_idx)->row_desc(),
-                                                         state->batch_size(),
-                                                         state->instance_mem_tracker()));
-            ctx = _left_child_ctx.get();
-        } else {
-            _right_child_ctx.reset(new ChildReaderContext(child(child_idx)->row_desc(),
-                                                          state->batch_size(),
-                                                          state->instance_mem_tracker()));
-            ctx = _right_child_ctx.get();
+        for (int i = 0; i < _right_tuple_size; ++i) {
+            _right_group.push_back(right_row->get_tuple(i));
         }
-
-        RETURN_IF_ERROR(child(child_idx)->get_next(state, &ctx->batch, &ctx->is_eos));
+        RETURN_IF_ERROR(get_input_row(state, 1, out_batch));
+        right_row = _right_child_ctx->current_row;
     }
+    return Status::OK();
+}
 
-    if (ctx->row_idx >= ctx->batch.num_rows()) {
-        ctx->current_row = NULL;
-        return Status::OK();
+void MergeJoinNode::clear_right_group(RowBatch* out_batch) {
+    _right_group.clear();
+    for (int i = 0; i < _right_group_batches.size(); ++i) {
+        _right_group_batches[i]->transfer_resource_ownership(out_batch);
     }
-
-    ctx->current_row = ctx->batch.get_row(ctx->row_idx++);
-    return Status::OK();
+    _right_group_batches.clear();
 }
 
 void MergeJoinNode::debug_string(int indentation_level, std::stringstream* out) const {
@@ -321,10 +308,11 @@ void MergeJoinNode::debug_string(int indentation_level, std::stringstream* out)
     *out << "MergeJoin(eos=" << (_eos ? "true" : "false")
          << " _left_child_pos=" << (_left_child_ctx.get() ? _left_child_ctx->row_idx : -1)
          << " _right_child_pos=" << (_right_child_ctx.get() ? _right_child_ctx->row_idx : -1)
+         << " _right_group_rows=" << _right_group.size() / std::max(_right_tuple_size, 1)
          << " join_conjuncts=";
     *out << "Conjunct(";
-    // << " left_exprs=" << Expr::debug_string(_left_exprs)
-    // << " right_exprs=" << Expr::debug_string(_right_exprs);
+    *out << " left_exprs=" << Expr::debug_string(_left_expr_ctxs)
+         << " right_exprs=" << Expr::debug_string(_right_expr_ctxs);
     *out << ")";
     ExecNode::debug_string(indentation_level, out);
     *out << ")";
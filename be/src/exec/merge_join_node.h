@@ -18,10 +18,9 @@
 #ifndef DORIS_BE_SRC_QUERY_EXEC_MERGE_JOIN_NODE_H
 #define DORIS_BE_SRC_QUERY_EXEC_MERGE_JOIN_NODE_H
 
-#include <boost/scoped_ptr.hpp>
-#include <boost/thread.hpp>
-#include <boost/unordered_set.hpp>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "exec/exec_node.h"
 #include "gen_cpp/PlanNodes_types.h" // for TJoinOp
@@ -29,11 +28,13 @@
 
 namespace doris {
 
-class MemPool;
+class Tuple;
 class TupleRow;
 
-// Node for in-memory merge joins:
-// find the minimal tuple and output
+// Node for inner merge joins of children returning rows ordered ascending by their
+// equi-join exprs, compared in the order of the exprs:
+// the left rows are joined with the group of right rows of their keys, which is
+// buffered until a left row of greater keys arrives. Rows with null keys never match.
 class MergeJoinNode : public ExecNode {
 public:
     MergeJoinNode(ObjectPool* pool, const TPlanNode& tnode, const DescriptorTbl& descs);
@@ -52,7 +53,6 @@ protected:
 private:
     // our equi-join predicates "<lhs> = <rhs>" are separated into
     // _left_exprs (over child(0)) and _right_exprs (over child(1))
-    // check which expr is min
     std::vector<ExprContext*> _left_expr_ctxs;
     std::vector<ExprContext*> _right_expr_ctxs;
 
@@ -61,41 +61,52 @@ private:
 
     bool _eos; // if true, nothing left to return in get_next()
 
+    // The rows of one child are read from 'batch', 'current_row' is the row at
+    // 'row_idx' - 1 or null once the child is exhausted.
     struct ChildReaderContext {
-        RowBatch batch;
+        std::unique_ptr<RowBatch> batch;
         int row_idx;
         bool is_eos;
         TupleRow* current_row;
-        ChildReaderContext(const RowDescriptor& desc, int batch_size,
-                           const std::shared_ptr<MemTracker>& mem_tracker)
-                : batch(desc, batch_size, mem_tracker.get()),
+        ChildReaderContext(const RowDescriptor& desc, int batch_size, MemTracker* mem_tracker)
+                : batch(new RowBatch(desc, batch_size, mem_tracker)),
                   row_idx(0),
                   is_eos(false),
                   current_row(NULL) {}
     };
-    // _left_batch must be cleared before calling get_next().  used cache child(0)'s data
-    // _right_batch must be cleared before calling get_next().  used cache child(1)'s data
-    // does not initialize all tuple ptrs in the row, only the ones that it
-    // is responsible for.
-    boost::scoped_ptr<ChildReaderContext> _left_child_ctx;
-    boost::scoped_ptr<ChildReaderContext> _right_child_ctx;
+    std::unique_ptr<ChildReaderContext> _left_child_ctx;
+    std::unique_ptr<ChildReaderContext> _right_child_ctx;
+
+    // The tuples of the right rows of equal keys the current left row is joined with,
+    // '_right_tuple_size' per row, and the index of the next one to join, or -1 if the
+    // current left row isn't matched against the group yet.
+    std::vector<Tuple*> _right_group;
+    int _right_group_idx;
+    // Exhausted right batches whose memory may be referenced by _right_group, they're
+    // passed on to the output once the group is dropped.
+    std::vector<std::unique_ptr<RowBatch>> _right_group_batches;
+
     // _build_tuple_idx[i] is the tuple index of child(1)'s tuple[i] in the output row
     std::vector<int> _right_tuple_idx;
     int _right_tuple_size;
     int _left_tuple_size;
-    RowBatch* _out_batch;
-
-    typedef int (*CompareFn)(const void*, const void*);
-    std::vector<CompareFn> _cmp_func;
 
-    // byte size of result tuple row (sum of the tuple ptrs, not the tuple data).
-    // This should be the same size as the probe tuple row.
-    int _result_tuple_row_size;
+    int num_right_group_rows() const { return _right_group.size() / _right_tuple_size; }
+    TupleRow* right_group_row(int idx) {
+        return reinterpret_cast<TupleRow*>(&_right_group[idx * _right_tuple_size]);
+    }
 
     void create_output_row(TupleRow* out, TupleRow* left, TupleRow* right);
-    Status compare_row(TupleRow* left_row, TupleRow* right_row, bool* is_lt);
-    Status get_next_row(RuntimeState* state, TupleRow* out_row, bool* eos);
-    Status get_input_row(RuntimeState* state, int child_idx);
+    // Compare the keys of 'lhs' evaluated by 'lhs_ctxs' with those of 'rhs'.
+    int compare_keys(const std::vector<ExprContext*>& lhs_ctxs, TupleRow* lhs,
+                     const std::vector<ExprContext*>& rhs_ctxs, TupleRow* rhs);
+    // Move to the next row of child 'child_idx' with no null key. The resources of
+    // exhausted left batches are passed on to 'out_batch'.
+    Status get_input_row(RuntimeState* state, int child_idx, RowBatch* out_batch);
+    // Collect the group of right rows of the keys of the current right row.
+    Status build_right_group(RuntimeState* state, RowBatch* out_batch);
+    // Drop the right group and pass the resources it referenced on to 'out_batch'.
+    void clear_right_group(RowBatch* out_batch);
 };
 
 } // namespace doris
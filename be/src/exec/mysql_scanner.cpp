@@ -78,6 +78,13 @@ Status MysqlScanner::query(const std::string& query) {
         return Status::InternalError("Query before open.");
     }
 
+    // clean the last query result, the rows of a streamed result must be consumed before
+    // the next query
+    if (_my_result) {
+        mysql_free_result(_my_result);
+        _my_result = NULL;
+    }
+
     int sql_result = mysql_query(_my_conn, query.c_str());
 
     if (0 != sql_result) {
@@ -87,16 +94,12 @@ Status MysqlScanner::query(const std::string& query) {
         LOG(INFO) << "mysql query success. query =" << query;
     }
 
-    // clean the last query result
-    if (_my_result) {
-        mysql_free_result(_my_result);
-    }
-
-    // use store result because mysql table is small, can load in memory avoid of many RPC
-    _my_result = mysql_store_result(_my_conn);
+    // stream the rows instead of storing the whole result, they're converted as they arrive
+    // and a large table doesn't have to fit in memory
+    _my_result = mysql_use_result(_my_conn);
 
     if (NULL == _my_result) {
-        return _error_status("mysql store result failed.");
+        return _error_status("mysql use result failed.");
     }
 
     _field_num = mysql_num_fields(_my_result);
@@ -157,6 +160,10 @@ Status MysqlScanner::get_next_row(char*** buf, unsigned long** lengths, bool* eo
     *buf = mysql_fetch_row(_my_result);
 
     if (NULL == *buf) {
+        // a streamed result also ends on a network error
+        if (0 != mysql_errno(_my_conn)) {
+            return _error_status("mysql fetch row failed.");
+        }
         *eos = true;
         return Status::OK();
     }
@@ -103,6 +103,7 @@ Status OdbcScanNode::open(RuntimeState* state) {
     RETURN_IF_ERROR(exec_debug_action(TExecNodePhase::OPEN));
     RETURN_IF_CANCELLED(state);
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_CPU_TIMER(_cpu_timer);
     RETURN_IF_ERROR(_odbc_scanner->open());
     RETURN_IF_ERROR(_odbc_scanner->query());
     // check materialize slot num
@@ -136,6 +137,7 @@ Status OdbcScanNode::get_next(RuntimeState* state, RowBatch* row_batch, bool* eo
     RETURN_IF_ERROR(exec_debug_action(TExecNodePhase::GETNEXT));
     RETURN_IF_CANCELLED(state);
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_CPU_TIMER(_cpu_timer);
 
     if (reached_limit()) {
         *eos = true;
@@ -179,6 +181,7 @@ Status OdbcScanNode::get_next(RuntimeState* state, RowBatch* row_batch, bool* eo
         row->set_tuple(0, _tuple);
         memset(_tuple, 0, _tuple_desc->num_null_bytes());
         int j = 0;
+        int odbc_row = _odbc_scanner->current_row();
 
         for (int i = 0; i < _slot_num; ++i) {
             auto slot_desc = _tuple_desc->slots()[i];
@@ -188,7 +191,8 @@ Status OdbcScanNode::get_next(RuntimeState* state, RowBatch* row_batch, bool* eo
             }
 
             const auto& column_data = _odbc_scanner->get_column_data(j);
-            if (column_data.strlen_or_ind == SQL_NULL_DATA) {
+            SQLLEN length = column_data.length(odbc_row);
+            if (length == SQL_NULL_DATA) {
                 if (slot_desc->is_nullable()) {
                     _tuple->set_null(slot_desc->null_indicator_offset());
                 } else {
@@ -197,14 +201,14 @@ Status OdbcScanNode::get_next(RuntimeState* state, RowBatch* row_batch, bool* eo
                        << ", column=" << slot_desc->col_name();
                     return Status::InternalError(ss.str());
                 }
-            } else if (column_data.strlen_or_ind > column_data.buffer_length) {
+            } else if (length > column_data.buffer_length) {
                 std::stringstream ss;
                 ss << "nonnull column contains NULL. table=" << _table_name
                    << ", column=" << slot_desc->col_name();
                 return Status::InternalError(ss.str());
             } else {
-                RETURN_IF_ERROR(write_text_slot(static_cast<char*>(column_data.target_value_ptr),
-                                                column_data.strlen_or_ind, slot_desc, state));
+                RETURN_IF_ERROR(write_text_slot(column_data.value(odbc_row), length, slot_desc,
+                                                state));
             }
             j++;
         }
@@ -230,6 +234,7 @@ Status OdbcScanNode::close(RuntimeState* state) {
     }
     RETURN_IF_ERROR(exec_debug_action(TExecNodePhase::CLOSE));
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_CPU_TIMER(_cpu_timer);
 
     _tuple_pool.reset();
 
@@ -19,9 +19,11 @@
 
 #include <sqlext.h>
 
+#include <algorithm>
 #include <boost/algorithm/string.hpp>
 #include <codecvt>
 
+#include "common/config.h"
 #include "common/logging.h"
 #include "runtime/primitive_type.h"
 
@@ -40,6 +42,8 @@
 static constexpr uint32_t SMALL_COLUMN_SIZE_BUFFER = 100;
 // Now we only treat HLL, CHAR, VARCHAR as big column
 static constexpr uint32_t BIG_COLUMN_SIZE_BUFFER = 65535;
+// The column buffers of a fetched block are limited to about this size
+static constexpr uint32_t FETCH_BUFFER_SIZE = 8 * 1024 * 1024;
 
 static std::u16string utf8_to_wstring(const std::string& str) {
     std::wstring_convert<std::codecvt_utf8<char16_t>, char16_t> utf8_ucs2_cvt;
@@ -55,6 +59,8 @@ ODBCScanner::ODBCScanner(const ODBCScannerParam& param)
           _is_open(false),
           _field_num(0),
           _row_count(0),
+          _rows_fetched(0),
+          _current_row(0),
           _env(nullptr),
           _dbc(nullptr),
           _stmt(nullptr) {}
@@ -132,6 +138,32 @@ Status ODBCScanner::query() {
         return Status::InternalError("input and output not equal.");
     }
 
+    uint64_t row_size = 0;
+    for (int i = 0; i < _field_num; i++) {
+        auto type = _tuple_desc->slots()[i]->type().type;
+        row_size += (type == TYPE_HLL || type == TYPE_CHAR || type == TYPE_VARCHAR)
+                            ? BIG_COLUMN_SIZE_BUFFER
+                            : SMALL_COLUMN_SIZE_BUFFER;
+    }
+    // fetch a block of rows at a time instead of a round trip for each row
+    SQLULEN row_array_size = std::max<int64_t>(
+            1, std::min<int64_t>(config::odbc_scan_batch_size,
+                                 FETCH_BUFFER_SIZE / std::max<uint64_t>(row_size, 1)));
+    auto ret = SQLSetStmtAttr(_stmt, SQL_ATTR_ROW_ARRAY_SIZE, (SQLPOINTER)row_array_size, 0);
+    if (ret == SQL_SUCCESS_WITH_INFO) {
+        // the driver changed the size
+        ODBC_DISPOSE(_stmt, SQL_HANDLE_STMT,
+                     SQLGetStmtAttr(_stmt, SQL_ATTR_ROW_ARRAY_SIZE, &row_array_size, 0, NULL),
+                     "get row array size");
+    } else if (ret != SQL_SUCCESS) {
+        LOG(WARNING) << "odbc driver doesn't fetch blocks of rows: "
+                     << handle_diagnostic_record(_stmt, SQL_HANDLE_STMT, ret);
+        row_array_size = 1;
+    }
+    ODBC_DISPOSE(_stmt, SQL_HANDLE_STMT,
+                 SQLSetStmtAttr(_stmt, SQL_ATTR_ROWS_FETCHED_PTR, &_rows_fetched, 0),
+                 "set rows fetched ptr");
+
     // allocate memory for the binding
     for (int i = 0; i < _field_num; i++) {
         DataBinding* column_data = new DataBinding;
@@ -140,7 +172,9 @@ Status ODBCScanner::query() {
         column_data->buffer_length = (type == TYPE_HLL || type == TYPE_CHAR || type == TYPE_VARCHAR)
                                              ? BIG_COLUMN_SIZE_BUFFER
                                              : SMALL_COLUMN_SIZE_BUFFER;
-        column_data->target_value_ptr = malloc(sizeof(char) * column_data->buffer_length);
+        column_data->strlen_or_ind.resize(row_array_size);
+        column_data->target_value_ptr =
+                malloc(sizeof(char) * column_data->buffer_length * row_array_size);
         _columns_data.push_back(column_data);
     }
 
@@ -149,7 +183,7 @@ Status ODBCScanner::query() {
         ODBC_DISPOSE(_stmt, SQL_HANDLE_STMT,
                      SQLBindCol(_stmt, (SQLUSMALLINT)i + 1, _columns_data[i].target_type,
                                 _columns_data[i].target_value_ptr, _columns_data[i].buffer_length,
-                                &(_columns_data[i].strlen_or_ind)),
+                                _columns_data[i].strlen_or_ind.data()),
                      "bind col");
     }
 
@@ -161,9 +195,17 @@ Status ODBCScanner::get_next_row(bool* eos) {
         return Status::InternalError("GetNextRow before open.");
     }
 
+    if (++_current_row < _rows_fetched) {
+        return Status::OK();
+    }
+
+    _current_row = 0;
+    _rows_fetched = 0;
     auto ret = SQLFetch(_stmt);
     if (ret == SQL_SUCCESS || ret == SQL_SUCCESS_WITH_INFO) {
-        return Status::OK();
+        if (_rows_fetched > 0) {
+            return Status::OK();
+        }
     } else if (ret != SQL_NO_DATA_FOUND) {
         return error_status("result fetch", handle_diagnostic_record(_stmt, SQL_HANDLE_STMT, ret));
     }
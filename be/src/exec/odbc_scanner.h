@@ -41,15 +41,24 @@ struct ODBCScannerParam {
 
 // Because the DataBinding have the mem alloc, so
 // this class should not be copyable
+// The column is bound to an array of values, one for each row of a fetched block.
 struct DataBinding : public boost::noncopyable {
     SQLSMALLINT target_type;
     SQLINTEGER buffer_length;
-    SQLLEN strlen_or_ind;
+    // length or SQL_NULL_DATA of each row
+    std::vector<SQLLEN> strlen_or_ind;
+    // buffer_length bytes for each row
     SQLPOINTER target_value_ptr;
 
     DataBinding() = default;
 
     ~DataBinding() { free(target_value_ptr); }
+
+    SQLLEN length(int row) const { return strlen_or_ind[row]; }
+
+    char* value(int row) const {
+        return static_cast<char*>(target_value_ptr) + static_cast<size_t>(row) * buffer_length;
+    }
 };
 
 // ODBC Scanner for scan data from ODBC
@@ -63,10 +72,14 @@ public:
     // query for ODBC table
     Status query();
 
+    // Moves to the next row, the rows are fetched a block at a time.
     Status get_next_row(bool* eos);
 
     const DataBinding& get_column_data(int i) const { return _columns_data.at(i); }
 
+    // The index of the current row in the columns of DataBinding.
+    int current_row() const { return _current_row; }
+
 private:
     static Status error_status(const std::string& prefix, const std::string& error_msg);
 
@@ -80,6 +93,9 @@ private:
     bool _is_open;
     SQLSMALLINT _field_num;
     uint64_t _row_count;
+    // the rows of the fetched block, set by the driver
+    SQLULEN _rows_fetched;
+    SQLULEN _current_row;
 
     SQLHENV _env;
     SQLHDBC _dbc;
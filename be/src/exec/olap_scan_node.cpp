@@ -18,6 +18,7 @@
 #include "exec/olap_scan_node.h"
 
 #include <algorithm>
+#include <boost/algorithm/string.hpp>
 #include <boost/foreach.hpp>
 #include <boost/variant.hpp>
 #include <iostream>
@@ -28,18 +29,26 @@
 #include "agent/cgroups_mgr.h"
 #include "common/logging.h"
 #include "common/resource_tls.h"
+#include "exec/agg_result_cache.h"
 #include "exprs/binary_predicate.h"
 #include "exprs/expr.h"
 #include "exprs/in_predicate.h"
+#include "exprs/slot_ref.h"
 #include "gen_cpp/PlanNodes_types.h"
+#include "geo/geo_types.h"
 #include "runtime/exec_env.h"
+#include "runtime/resource_group_mgr.h"
 #include "runtime/row_batch.h"
 #include "runtime/runtime_state.h"
 #include "runtime/string_value.h"
 #include "runtime/tuple_row.h"
+#include "util/continuous_cpu_profiler.h"
 #include "util/debug_util.h"
-#include "util/priority_thread_pool.hpp"
+#include "util/fair_thread_pool.h"
 #include "util/runtime_profile.h"
+#include "util/stopwatch.hpp"
+#include "util/thrift_util.h"
+#include "util/trace.h"
 
 namespace doris {
 
@@ -82,6 +91,12 @@ Status OlapScanNode::init(const TPlanNode& tnode, RuntimeState* state) {
         _max_pushdown_conditions_per_column = config::max_pushdown_conditions_per_column;
     }
 
+    if (AggResultCache::instance() != nullptr &&
+        !AggResultCache::has_volatile_fn(tnode.conjuncts)) {
+        ThriftSerializer serializer(false, 1024);
+        RETURN_IF_ERROR(serializer.serialize(&tnode, &_cache_plan));
+    }
+
     return Status::OK();
 }
 
@@ -110,6 +125,11 @@ void OlapScanNode::_init_counter(RuntimeState* state) {
 
     _rows_vec_cond_counter = ADD_COUNTER(_segment_profile, "RowsVectorPredFiltered", TUnit::UNIT);
     _vec_cond_timer = ADD_TIMER(_segment_profile, "VectorPredEvalTime");
+    _rows_block_filter_counter =
+            ADD_COUNTER(_segment_profile, "RowsBlockFilterFiltered", TUnit::UNIT);
+    _block_filter_timer = ADD_TIMER(_segment_profile, "BlockFilterEvalTime");
+    _read_ahead_pages_counter = ADD_COUNTER(_segment_profile, "ReadAheadPagesNum", TUnit::UNIT);
+    _read_ahead_wait_timer = ADD_TIMER(_segment_profile, "ReadAheadWaitTime");
 
     _stats_filtered_counter = ADD_COUNTER(_segment_profile, "RowsStatsFiltered", TUnit::UNIT);
     _bf_filtered_counter = ADD_COUNTER(_segment_profile, "RowsBloomFilterFiltered", TUnit::UNIT);
@@ -127,17 +147,45 @@ void OlapScanNode::_init_counter(RuntimeState* state) {
 
     _total_pages_num_counter = ADD_COUNTER(_segment_profile, "TotalPagesNum", TUnit::UNIT);
     _cached_pages_num_counter = ADD_COUNTER(_segment_profile, "CachedPagesNum", TUnit::UNIT);
+    _cached_bytes_read_counter = ADD_COUNTER(_segment_profile, "CachedBytesRead", TUnit::BYTES);
+    _file_open_counter = ADD_COUNTER(_segment_profile, "FileOpenNum", TUnit::UNIT);
 
     _bitmap_index_filter_counter =
             ADD_COUNTER(_segment_profile, "RowsBitmapIndexFiltered", TUnit::UNIT);
     _bitmap_index_filter_timer = ADD_TIMER(_segment_profile, "BitmapIndexFilterTimer");
+    _ngram_index_filter_counter =
+            ADD_COUNTER(_segment_profile, "RowsNGramIndexFiltered", TUnit::UNIT);
+    _ngram_index_filter_timer = ADD_TIMER(_segment_profile, "NGramIndexFilterTimer");
+    _s2_index_filter_counter = ADD_COUNTER(_segment_profile, "RowsS2IndexFiltered", TUnit::UNIT);
+    _s2_index_filter_timer = ADD_TIMER(_segment_profile, "S2IndexFilterTimer");
 
     _num_scanners = ADD_COUNTER(_runtime_profile, "NumScanners", TUnit::UNIT);
+    _scanner_concurrency_counter = ADD_COUNTER(_runtime_profile, "ScannerConcurrency", TUnit::UNIT);
+    _peak_scanner_concurrency_counter =
+            ADD_COUNTER(_runtime_profile, "PeakScannerConcurrency", TUnit::UNIT);
+    _scanner_queue_wait_timer = ADD_TIMER(_runtime_profile, "ScannerQueueWaitTime");
+    _scanner_cpu_timer = ADD_TIMER(_runtime_profile, "ScannerCpuTime");
+    _wait_scanner_timer = ADD_TIMER(_runtime_profile, "WaitScannerTime");
 
     _filtered_segment_counter = ADD_COUNTER(_segment_profile, "NumSegmentFiltered", TUnit::UNIT);
     _total_segment_counter = ADD_COUNTER(_segment_profile, "NumSegmentTotal", TUnit::UNIT);
 }
 
+OlapScanNode::DataDirCounters* OlapScanNode::_data_dir_counters(const std::string& path) {
+    std::lock_guard<SpinLock> l(_data_dir_counters_lock);
+    auto it = _data_dir_counters_map.find(path);
+    if (it != _data_dir_counters_map.end()) {
+        return &it->second;
+    }
+    RuntimeProfile* profile = _scanner_profile->create_child("DataDir " + path);
+    DataDirCounters& counters = _data_dir_counters_map[path];
+    counters.compressed_bytes_read = ADD_COUNTER(profile, "CompressedBytesRead", TUnit::BYTES);
+    counters.pages_read = ADD_COUNTER(profile, "PagesRead", TUnit::UNIT);
+    counters.io_timer = ADD_TIMER(profile, "IOTimer");
+    counters.file_opens = ADD_COUNTER(profile, "FileOpenNum", TUnit::UNIT);
+    return &counters;
+}
+
 Status OlapScanNode::prepare(RuntimeState* state) {
     init_scan_profile();
     RETURN_IF_ERROR(ScanNode::prepare(state));
@@ -146,7 +194,11 @@ Status OlapScanNode::prepare(RuntimeState* state) {
     _tablet_counter = ADD_COUNTER(runtime_profile(), "TabletCount ", TUnit::UNIT);
     _rows_pushed_cond_filtered_counter =
             ADD_COUNTER(_scanner_profile, "RowsPushedCondFiltered", TUnit::UNIT);
+    _rows_topn_filtered_counter = ADD_COUNTER(_scanner_profile, "RowsTopNFiltered", TUnit::UNIT);
     _init_counter(state);
+    if (state->query_options().enable_perf_counters) {
+        _scanner_perf_counters.reset(new ThreadPerfCounters(_runtime_profile.get(), "Scanner"));
+    }
     _tuple_desc = state->desc_tbl().get_tuple_descriptor(_tuple_id);
     if (_tuple_desc == NULL) {
         // TODO: make sure we print all available diagnostic output to our error log
@@ -165,15 +217,32 @@ Status OlapScanNode::prepare(RuntimeState* state) {
         }
 
         _string_slots.push_back(slots[i]);
+        if (config::doris_scanner_string_dict_max_size > 0) {
+            _string_dicts.emplace_back(new ScanStringDict(
+                    config::doris_scanner_string_dict_max_size, mem_tracker().get()));
+        }
+    }
+
+    if (_olap_scan_node.__isset.sort_limit) {
+        add_runtime_exec_option("Sort Limit Pushed Down");
+    }
+    if (_olap_scan_node.__isset.num_ordered_keys) {
+        add_runtime_exec_option("Ordered By Keys");
     }
 
     _runtime_state = state;
     return Status::OK();
 }
 
+void OlapScanNode::set_topn_threshold(TopNThreshold* threshold) {
+    _topn_threshold = threshold;
+    add_runtime_exec_option("TopN Threshold Filter");
+}
+
 Status OlapScanNode::open(RuntimeState* state) {
     VLOG(1) << "OlapScanNode::Open";
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_CPU_TIMER(_cpu_timer);
     RETURN_IF_CANCELLED(state);
     RETURN_IF_ERROR(ExecNode::open(state));
 
@@ -196,10 +265,11 @@ Status OlapScanNode::open(RuntimeState* state) {
 Status OlapScanNode::get_next(RuntimeState* state, RowBatch* row_batch, bool* eos) {
     RETURN_IF_ERROR(exec_debug_action(TExecNodePhase::GETNEXT));
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_CPU_TIMER(_cpu_timer);
 
     // check if Canceled.
     if (state->is_cancelled()) {
-        std::unique_lock<std::mutex> l(_row_batches_lock);
+        std::unique_lock<bthread::Mutex> l(_row_batches_lock);
         _transfer_done = true;
         std::lock_guard<SpinLock> guard(_status_mutex);
         if (LIKELY(_status.ok())) {
@@ -226,17 +296,22 @@ Status OlapScanNode::get_next(RuntimeState* state, RowBatch* row_batch, bool* eo
         _start = true;
     }
 
+    if (_olap_scan_node.__isset.num_ordered_keys) {
+        return get_next_ordered(state, row_batch, eos);
+    }
+
     // wait for batch from queue
     RowBatch* materialized_batch = NULL;
     {
-        std::unique_lock<std::mutex> l(_row_batches_lock);
+        std::unique_lock<bthread::Mutex> l(_row_batches_lock);
+        SCOPED_TIMER(_wait_scanner_timer);
         while (_materialized_row_batches.empty() && !_transfer_done) {
             if (state->is_cancelled()) {
                 _transfer_done = true;
             }
 
             // use wait_for, not wait, in case to capture the state->is_cancelled()
-            _row_batch_added_cv.wait_for(l, std::chrono::seconds(1));
+            _row_batch_added_cv.wait_for(l, 1000000);
         }
 
         if (!_materialized_row_batches.empty()) {
@@ -248,8 +323,8 @@ Status OlapScanNode::get_next(RuntimeState* state, RowBatch* row_batch, bool* eo
 
     // return batch
     if (NULL != materialized_batch) {
-        // notify scanner
-        _row_batch_consumed_cv.notify_one();
+        // scanners may have paused for the queue or the memory
+        schedule_scanners();
         // get scanner's batch memory
         row_batch->acquire_state(materialized_batch);
         _num_rows_returned += row_batch->num_rows();
@@ -263,11 +338,10 @@ Status OlapScanNode::get_next(RuntimeState* state, RowBatch* row_batch, bool* eo
             COUNTER_SET(_rows_returned_counter, _num_rows_returned);
 
             {
-                std::unique_lock<std::mutex> l(_row_batches_lock);
+                std::unique_lock<bthread::Mutex> l(_row_batches_lock);
                 _transfer_done = true;
             }
 
-            _row_batch_consumed_cv.notify_all();
             *eos = true;
             LOG(INFO) << "OlapScanNode ReachedLimit.";
         } else {
@@ -284,7 +358,7 @@ Status OlapScanNode::get_next(RuntimeState* state, RowBatch* row_batch, bool* eo
         __sync_fetch_and_sub(&_buffered_bytes,
                              row_batch->tuple_data_pool()->total_reserved_bytes());
 
-        delete materialized_batch;
+        return_free_row_batch(materialized_batch);
         return Status::OK();
     }
 
@@ -298,6 +372,9 @@ Status OlapScanNode::collect_query_statistics(QueryStatistics* statistics) {
     RETURN_IF_ERROR(ExecNode::collect_query_statistics(statistics));
     statistics->add_scan_bytes(_read_compressed_counter->value());
     statistics->add_scan_rows(_raw_rows_counter->value());
+    statistics->add_scan_cached_bytes(_cached_bytes_read_counter->value());
+    statistics->add_scan_io_ns(_io_timer->value());
+    statistics->add_scan_file_opens(_file_open_counter->value());
     return Status::OK();
 }
 
@@ -309,16 +386,22 @@ Status OlapScanNode::close(RuntimeState* state) {
 
     // change done status
     {
-        std::unique_lock<std::mutex> l(_row_batches_lock);
+        std::unique_lock<bthread::Mutex> l(_row_batches_lock);
         _transfer_done = true;
     }
-    // notify all scanner thread
-    _row_batch_consumed_cv.notify_all();
     _row_batch_added_cv.notify_all();
-    _scan_batch_added_cv.notify_all();
 
-    // join transfer thread
-    _transfer_thread.join_all();
+    // wait for the scanners in the scan thread pool, they stop at _transfer_done
+    {
+        std::unique_lock<bthread::Mutex> l(_scan_batches_lock);
+        while (_running_thread > 0) {
+            _scan_batch_added_cv.wait(l);
+        }
+    }
+
+    _ordered_merger.reset();
+    _ordered_batches.clear();
+    Expr::close(_ordered_key_ctxs, state);
 
     // clear some row batch in queue
     for (auto row_batch : _materialized_row_batches) {
@@ -327,11 +410,10 @@ Status OlapScanNode::close(RuntimeState* state) {
 
     _materialized_row_batches.clear();
 
-    for (auto row_batch : _scan_row_batches) {
+    for (auto row_batch : _free_row_batches) {
         delete row_batch;
     }
-
-    _scan_row_batches.clear();
+    _free_row_batches.clear();
 
     // OlapScanNode terminate by exception
     // so that initiative close the Scanner
@@ -367,6 +449,29 @@ Status OlapScanNode::set_scan_ranges(const std::vector<TScanRangeParams>& scan_r
     return Status::OK();
 }
 
+bool OlapScanNode::append_cache_key(std::string* key) const {
+    if (_cache_plan.empty()) {
+        return false;
+    }
+    key->append(_cache_plan);
+    key->append(_need_agg_finalize ? "finalize" : "no_finalize");
+    for (auto slot : _tuple_desc->slots()) {
+        key->append(slot->col_name()).append(slot->debug_string());
+    }
+    // the same tablets may come in any order
+    std::vector<std::string> tablet_versions;
+    for (auto& scan_range : _scan_ranges) {
+        tablet_versions.emplace_back(std::to_string(scan_range->tablet_id) + "." +
+                                     scan_range->schema_hash + "@" + scan_range->version +
+                                     "." + scan_range->version_hash + ";");
+    }
+    std::sort(tablet_versions.begin(), tablet_versions.end());
+    for (auto& tablet_version : tablet_versions) {
+        key->append(tablet_version);
+    }
+    return true;
+}
+
 Status OlapScanNode::start_scan(RuntimeState* state) {
     RETURN_IF_CANCELLED(state);
 
@@ -446,6 +551,9 @@ Status OlapScanNode::normalize_conjuncts() {
                     slots[slot_idx]->col_name(), slots[slot_idx]->type().type,
                     StringValue(&min_char, 0), StringValue(&max_char, 1));
             normalize_predicate(range, slots[slot_idx]);
+            if (slots[slot_idx]->type().type != TYPE_HLL) {
+                normalize_like_predicate(slots[slot_idx]);
+            }
             break;
         }
 
@@ -491,6 +599,7 @@ Status OlapScanNode::normalize_conjuncts() {
         }
         }
     }
+    normalize_geo_predicates();
 
     return Status::OK();
 }
@@ -512,6 +621,8 @@ Status OlapScanNode::build_olap_filters() {
             _olap_filter.push_back(filter);
         }
     }
+    _olap_filter.insert(_olap_filter.end(), _like_conditions.begin(), _like_conditions.end());
+    _olap_filter.insert(_olap_filter.end(), _geo_conditions.begin(), _geo_conditions.end());
 
     return Status::OK();
 }
@@ -617,6 +728,15 @@ static Status get_hints(const TPaloScanRange& scan_range, int block_row_count,
     return Status::OK();
 }
 
+// False if the tablet is not found, then the prepare of its scanner fails
+static bool is_clustered_tablet(const TPaloScanRange& scan_range) {
+    int32_t schema_hash = strtoul(scan_range.schema_hash.c_str(), nullptr, 10);
+    std::string err;
+    TabletSharedPtr tablet = StorageEngine::instance()->tablet_manager()->get_tablet(
+            scan_range.tablet_id, schema_hash, true, &err);
+    return tablet != nullptr && tablet->tablet_schema().is_clustered();
+}
+
 Status OlapScanNode::start_scan_thread(RuntimeState* state) {
     if (_scan_ranges.empty()) {
         _transfer_done = true;
@@ -637,11 +757,38 @@ Status OlapScanNode::start_scan_thread(RuntimeState* state) {
     if (limit() != -1 || cond_ranges.size() > 64) {
         need_split = false;
     }
+    // Each scanner of a sort limit merges the rows of its tablet in the order of
+    // keys, splitting the ranges only makes more scanners read up to the limit
+    if (_olap_scan_node.__isset.sort_limit) {
+        need_split = false;
+    }
 
     int scanners_per_tablet = std::max(1, 64 / (int)_scan_ranges.size());
 
     std::unordered_set<std::string> disk_set;
+    auto add_scanner = [&](const TPaloScanRange& scan_range,
+                           const std::vector<OlapScanRange*>& scanner_ranges) -> Status {
+        OlapScanner* scanner = new OlapScanner(state, this, _olap_scan_node.is_preaggregation,
+                                               _need_agg_finalize, scan_range, scanner_ranges);
+        // add scanner to pool before doing prepare.
+        // so that scanner can be automatically deconstructed if prepare failed.
+        _scanner_pool->add(scanner);
+        RETURN_IF_ERROR(
+                scanner->prepare(scan_range, scanner_ranges, _olap_filter, _is_null_vector));
+
+        _olap_scanners.push_back(scanner);
+        disk_set.insert(scanner->scan_disk());
+        return Status::OK();
+    };
+    OlapScanRange full_range;
     for (auto& scan_range : _scan_ranges) {
+        if (is_clustered_tablet(*scan_range)) {
+            // The segments of a clustered tablet ignore key ranges, since its rows are not
+            // ordered by keys, so all its rows are read by one scanner and selected by the
+            // conditions on keys instead.
+            RETURN_IF_ERROR(add_scanner(*scan_range, {&full_range}));
+            continue;
+        }
         std::vector<std::unique_ptr<OlapScanRange>>* ranges = &cond_ranges;
         std::vector<std::unique_ptr<OlapScanRange>> split_ranges;
         if (need_split) {
@@ -664,16 +811,7 @@ Status OlapScanNode::start_scan_thread(RuntimeState* state) {
                  ++j, ++i) {
                 scanner_ranges.push_back((*ranges)[i].get());
             }
-            OlapScanner* scanner = new OlapScanner(state, this, _olap_scan_node.is_preaggregation,
-                                                   _need_agg_finalize, *scan_range, scanner_ranges);
-            // add scanner to pool before doing prepare.
-            // so that scanner can be automatically deconstructed if prepare failed.
-            _scanner_pool->add(scanner);
-            RETURN_IF_ERROR(
-                    scanner->prepare(*scan_range, scanner_ranges, _olap_filter, _is_null_vector));
-
-            _olap_scanners.push_back(scanner);
-            disk_set.insert(scanner->scan_disk());
+            RETURN_IF_ERROR(add_scanner(*scan_range, scanner_ranges));
         }
     }
     COUNTER_SET(_num_disks_accessed_counter, static_cast<int64_t>(disk_set.size()));
@@ -685,8 +823,127 @@ Status OlapScanNode::start_scan_thread(RuntimeState* state) {
     _progress = ProgressUpdater(ss.str(), _olap_scanners.size(), 1);
     _progress.set_logging_level(1);
 
-    _transfer_thread.add_thread(new boost::thread(&OlapScanNode::transfer_thread, this, state));
+    if (_olap_scan_node.__isset.num_ordered_keys) {
+        return start_ordered_merge(state);
+    }
+    for (auto scanner : _olap_scanners) {
+        RETURN_IF_ERROR(
+                Expr::clone_if_not_exists(_conjunct_ctxs, state, scanner->conjunct_ctxs()));
+    }
+
+    // Scanners run in the scan thread pool, which serves queries round robin, so a
+    // query with many scanners can't starve the others. A scanner yields after it
+    // has read doris_scanner_row_num rows or run doris_scanner_max_run_time_ms. There
+    // is no thread of this node waiting for them: a scanner yielding and get_next()
+    // taking a batch offer the idle scanners to the pool as long as the queued batches
+    // and the memory of the fragment are within their limits.
+    _mem_limit = 512 * 1024 * 1024;
+    // TODO(zc): use memory limit
+    if (state->fragment_mem_tracker() != nullptr) {
+        _mem_limit = state->fragment_mem_tracker()->limit();
+    }
+    // The concurrency starts from what the queue holds, and changes with the demand of the
+    // consumer and the load of the pool, up to a scanner per thread of the pool.
+    _max_running_scanners = _max_materialized_row_batches;
+    if (config::doris_scanner_row_num > state->batch_size()) {
+        _max_running_scanners /= config::doris_scanner_row_num / state->batch_size();
+    }
+    _running_scanners_limit = std::min<int64_t>(_olap_scanners.size(),
+                                                scan_thread_pool()->num_threads());
+    _running_scanners_limit = std::max<int64_t>(_running_scanners_limit, 1);
+    _max_running_scanners =
+            std::max<int64_t>(std::min(_max_running_scanners, _running_scanners_limit), 1);
+    COUNTER_SET(_scanner_concurrency_counter, _max_running_scanners);
+    COUNTER_SET(_peak_scanner_concurrency_counter, _max_running_scanners);
+    schedule_scanners();
+
+    return Status::OK();
+}
+
+Status OlapScanNode::start_ordered_merge(RuntimeState* state) {
+    const std::vector<std::string>& key_column_names = _olap_scan_node.key_column_name;
+    int num_ordered_keys = _olap_scan_node.num_ordered_keys;
+    if (num_ordered_keys <= 0 || num_ordered_keys > (int)key_column_names.size()) {
+        return Status::InternalError("invalid number of ordered keys.");
+    }
+    for (int i = 0; i < num_ordered_keys; ++i) {
+        const SlotDescriptor* key_slot = nullptr;
+        for (const SlotDescriptor* slot : _tuple_desc->slots()) {
+            if (slot->is_materialized() && slot->col_name() == key_column_names[i]) {
+                key_slot = slot;
+                break;
+            }
+        }
+        if (key_slot == nullptr) {
+            return Status::InternalError("ordered key column " + key_column_names[i] +
+                                         " is not scanned.");
+        }
+        // slots are evaluated in place, so the ctxs can compare both rows of the merger
+        Expr* key_expr = _pool->add(new SlotRef(key_slot));
+        _ordered_key_ctxs.push_back(_pool->add(new ExprContext(key_expr)));
+    }
+    RETURN_IF_ERROR(Expr::prepare(_ordered_key_ctxs, state, row_desc(), expr_mem_tracker()));
+    RETURN_IF_ERROR(Expr::open(_ordered_key_ctxs, state));
+    _ordered_key_comparator.reset(
+            new TupleRowComparator(_ordered_key_ctxs, _ordered_key_ctxs, true, true));
+
+    std::vector<SortedRunMerger::RunBatchSupplier> runs;
+    for (auto scanner : _olap_scanners) {
+        RETURN_IF_ERROR(
+                Expr::clone_if_not_exists(_conjunct_ctxs, state, scanner->conjunct_ctxs()));
+        _ordered_batches.emplace_back(new RowBatch(row_desc(), state->batch_size(),
+                                                   state->fragment_mem_tracker().get()));
+        runs.push_back(boost::bind<Status>(&OlapScanNode::get_ordered_batch, this, scanner,
+                                           _ordered_batches.back().get(), _1));
+    }
+    _ordered_merger.reset(new SortedRunMerger(*_ordered_key_comparator, &_row_descriptor,
+                                              runtime_profile(), false));
+    return _ordered_merger->prepare(runs);
+}
+
+Status OlapScanNode::get_ordered_batch(OlapScanner* scanner, RowBatch* scanner_batch,
+                                       RowBatch** batch) {
+    RETURN_IF_CANCELLED(_runtime_state);
+    if (scanner->is_closed()) {
+        // the scanner returned its last rows with eos
+        *batch = nullptr;
+        return Status::OK();
+    }
+    if (!scanner->is_open()) {
+        RETURN_IF_ERROR(scanner->open());
+        scanner->set_opened();
+    }
+    // the batch is reset by the merger once it has passed on its rows
+    bool eos = false;
+    while (scanner_batch->num_rows() == 0 && !eos) {
+        scanner_batch->reset();
+        RETURN_IF_ERROR(
+                scanner->get_batch(_runtime_state, scanner_batch, _runtime_state->batch_size(),
+                                   &eos));
+    }
+    if (eos) {
+        RETURN_IF_ERROR(scanner->close(_runtime_state));
+    }
+    *batch = scanner_batch->num_rows() == 0 ? nullptr : scanner_batch;
+    return Status::OK();
+}
 
+Status OlapScanNode::get_next_ordered(RuntimeState* state, RowBatch* row_batch, bool* eos) {
+    if (_ordered_merger == nullptr) {
+        // no scan range
+        *eos = true;
+        return Status::OK();
+    }
+    RETURN_IF_ERROR(_ordered_merger->get_next(row_batch, eos));
+    _num_rows_returned += row_batch->num_rows();
+    if (reached_limit()) {
+        int num_rows_over = _num_rows_returned - _limit;
+        row_batch->set_num_rows(row_batch->num_rows() - num_rows_over);
+        _num_rows_returned -= num_rows_over;
+        *eos = true;
+    }
+    COUNTER_SET(_rows_returned_counter, _num_rows_returned);
+    _eos = *eos;
     return Status::OK();
 }
 
@@ -958,6 +1215,134 @@ void OlapScanNode::construct_is_null_pred_in_where_pred(Expr* expr, SlotDescript
     return;
 }
 
+void OlapScanNode::normalize_like_predicate(SlotDescriptor* slot) {
+    for (int conj_idx = 0; conj_idx < _conjunct_ctxs.size(); ++conj_idx) {
+        Expr* root_expr = _conjunct_ctxs[conj_idx]->root();
+        if (TExprNodeType::FUNCTION_CALL != root_expr->node_type() ||
+            !boost::iequals(root_expr->fn().name.function_name, "like") ||
+            root_expr->get_num_children() != 2) {
+            continue;
+        }
+        Expr* slot_expr = root_expr->get_child(0);
+        if (slot_expr->node_type() != TExprNodeType::SLOT_REF) {
+            continue;
+        }
+        std::vector<SlotId> slot_ids;
+        if (1 != slot_expr->get_slot_ids(&slot_ids) || slot_ids[0] != slot->id()) {
+            continue;
+        }
+        Expr* pattern_expr = root_expr->get_child(1);
+        if (!pattern_expr->is_constant()) {
+            continue;
+        }
+        void* value = _conjunct_ctxs[conj_idx]->get_value(pattern_expr, NULL);
+        // for case: where col like null
+        if (value == NULL) {
+            continue;
+        }
+        const StringValue* pattern = reinterpret_cast<StringValue*>(value);
+        TCondition like;
+        like.column_name = slot->col_name();
+        like.condition_op = "like";
+        like.condition_values.push_back(std::string(pattern->ptr, pattern->len));
+        _like_conditions.push_back(like);
+    }
+}
+
+SlotDescriptor* OlapScanNode::_double_slot(Expr* expr) {
+    std::vector<SlotId> slot_ids;
+    if (expr->node_type() != TExprNodeType::SLOT_REF || expr->type().type != TYPE_DOUBLE ||
+        1 != expr->get_slot_ids(&slot_ids)) {
+        return nullptr;
+    }
+    for (SlotDescriptor* slot : _tuple_desc->slots()) {
+        if (slot->id() == slot_ids[0]) {
+            return slot;
+        }
+    }
+    return nullptr;
+}
+
+// Slack in meters added to the radius of st_distance_sphere, so that the rounding of the
+// distance and of the circle doesn't skip a point on the boundary
+static const double kGeoDistanceSlackMeters = 1.0;
+
+void OlapScanNode::normalize_geo_predicates() {
+    for (int conj_idx = 0; conj_idx < _conjunct_ctxs.size(); ++conj_idx) {
+        ExprContext* ctx = _conjunct_ctxs[conj_idx];
+        Expr* root_expr = ctx->root();
+        Expr* point_expr = nullptr;
+        std::string encoded_shape;
+        if (TExprNodeType::FUNCTION_CALL == root_expr->node_type() &&
+            boost::iequals(root_expr->fn().name.function_name, "st_contains") &&
+            root_expr->get_num_children() == 2) {
+            // st_contains(shape, st_point(lng, lat))
+            Expr* shape_expr = root_expr->get_child(0);
+            point_expr = root_expr->get_child(1);
+            if (!shape_expr->is_constant() ||
+                TExprNodeType::FUNCTION_CALL != point_expr->node_type() ||
+                !boost::iequals(point_expr->fn().name.function_name, "st_point") ||
+                point_expr->get_num_children() != 2) {
+                continue;
+            }
+            void* value = ctx->get_value(shape_expr, nullptr);
+            if (value == nullptr) {
+                continue;
+            }
+            const StringValue* shape = reinterpret_cast<StringValue*>(value);
+            encoded_shape.assign(shape->ptr, shape->len);
+        } else if (TExprNodeType::BINARY_PRED == root_expr->node_type() &&
+                   root_expr->get_num_children() == 2) {
+            // st_distance_sphere(lng, lat, x, y) < radius, or radius > it
+            TExprOpcode::type op = root_expr->op();
+            int dist_idx = 0;
+            if (op == TExprOpcode::LT || op == TExprOpcode::LE) {
+                dist_idx = 0;
+            } else if (op == TExprOpcode::GT || op == TExprOpcode::GE) {
+                dist_idx = 1;
+            } else {
+                continue;
+            }
+            point_expr = root_expr->get_child(dist_idx);
+            Expr* radius_expr = root_expr->get_child(1 - dist_idx);
+            if (TExprNodeType::FUNCTION_CALL != point_expr->node_type() ||
+                !boost::iequals(point_expr->fn().name.function_name, "st_distance_sphere") ||
+                point_expr->get_num_children() != 4 || !radius_expr->is_constant() ||
+                radius_expr->type().type != TYPE_DOUBLE ||
+                !point_expr->get_child(2)->is_constant() ||
+                !point_expr->get_child(3)->is_constant()) {
+                continue;
+            }
+            void* x = ctx->get_value(point_expr->get_child(2), nullptr);
+            void* y = ctx->get_value(point_expr->get_child(3), nullptr);
+            void* radius = ctx->get_value(radius_expr, nullptr);
+            if (x == nullptr || y == nullptr || radius == nullptr) {
+                continue;
+            }
+            GeoCircle circle;
+            if (circle.init(*reinterpret_cast<double*>(x), *reinterpret_cast<double*>(y),
+                            *reinterpret_cast<double*>(radius) + kGeoDistanceSlackMeters) !=
+                GEO_PARSE_OK) {
+                continue;
+            }
+            circle.encode_to(&encoded_shape);
+        } else {
+            continue;
+        }
+        SlotDescriptor* lng_slot = _double_slot(point_expr->get_child(0));
+        SlotDescriptor* lat_slot = _double_slot(point_expr->get_child(1));
+        if (lng_slot == nullptr || lat_slot == nullptr) {
+            continue;
+        }
+        TCondition geo;
+        geo.column_name = lng_slot->col_name();
+        geo.condition_op = "s2";
+        geo.condition_values.push_back(lat_slot->col_name());
+        geo.condition_values.push_back(encoded_shape);
+        _geo_conditions.push_back(geo);
+    }
+}
+
 template <class T>
 Status OlapScanNode::normalize_noneq_binary_predicate(SlotDescriptor* slot,
                                                       ColumnValueRange<T>* range) {
@@ -1063,152 +1448,147 @@ Status OlapScanNode::normalize_noneq_binary_predicate(SlotDescriptor* slot,
     return Status::OK();
 }
 
-void OlapScanNode::transfer_thread(RuntimeState* state) {
-    // scanner open pushdown to scanThread
-    state->resource_pool()->acquire_thread_token();
-    Status status = Status::OK();
-    for (auto scanner : _olap_scanners) {
-        status = Expr::clone_if_not_exists(_conjunct_ctxs, state, scanner->conjunct_ctxs());
-        if (!status.ok()) {
-            std::lock_guard<SpinLock> guard(_status_mutex);
-            _status = status;
-            break;
-        }
+void OlapScanNode::pick_scanners(std::list<OlapScanner*>* scanners) {
+    if (_transfer_done || _olap_scanners.empty()) {
+        return;
+    }
+    size_t num_batches = 0;
+    {
+        std::unique_lock<bthread::Mutex> l(_row_batches_lock);
+        num_batches = _materialized_row_batches.size();
     }
-
-    /*********************************
-     * 优先级调度基本策略:
-     * 1. 通过查询拆分的Range个数来确定初始nice值
-     *    Range个数越多，越倾向于认定为大查询，nice值越小
-     * 2. 通过查询累计读取的数据量来调整nice值
-     *    读取的数据越多，越倾向于认定为大查询，nice值越小
-     * 3. 通过nice值来判断查询的优先级
-     *    nice值越大的，越优先获得的查询资源
-     * 4. 定期提高队列内残留任务的优先级，避免大查询完全饿死
-     *********************************/
-    PriorityThreadPool* thread_pool = state->exec_env()->thread_pool();
-    _total_assign_num = 0;
-    _nice = 18 + std::max(0, 2 - (int)_olap_scanners.size() / 5);
-    std::list<OlapScanner*> olap_scanners;
-
-    int64_t mem_limit = 512 * 1024 * 1024;
-    // TODO(zc): use memory limit
     int64_t mem_consume = __sync_fetch_and_add(&_buffered_bytes, 0);
-    if (state->fragment_mem_tracker() != nullptr) {
-        mem_limit = state->fragment_mem_tracker()->limit();
-        mem_consume = state->fragment_mem_tracker()->consumption();
+    if (_runtime_state->fragment_mem_tracker() != nullptr) {
+        mem_consume = _runtime_state->fragment_mem_tracker()->consumption();
     }
-    int max_thread = _max_materialized_row_batches;
-    if (config::doris_scanner_row_num > state->batch_size()) {
-        max_thread /= config::doris_scanner_row_num / state->batch_size();
-    }
-    // read from scanner
-    while (LIKELY(status.ok())) {
-        int assigned_thread_num = 0;
-        // copy to local
-        {
-            std::unique_lock<std::mutex> l(_scan_batches_lock);
-            assigned_thread_num = _running_thread;
-            // int64_t buf_bytes = __sync_fetch_and_add(&_buffered_bytes, 0);
-            // How many thread can apply to this query
-            size_t thread_slot_num = 0;
-            mem_consume = __sync_fetch_and_add(&_buffered_bytes, 0);
-            if (state->fragment_mem_tracker() != nullptr) {
-                mem_consume = state->fragment_mem_tracker()->consumption();
-            }
-            if (mem_consume < (mem_limit * 6) / 10) {
-                thread_slot_num = max_thread - assigned_thread_num;
-            } else {
-                // Memory already exceed
-                if (_scan_row_batches.empty()) {
-                    // NOTE(zc): here need to lock row_batches_lock_
-                    //  be worried about dead lock, so don't check here
-                    // if (materialized_row_batches_.empty()) {
-                    //     LOG(FATAL) << "Scan_row_batches_ and materialized_row_batches_"
-                    //         " are empty when memory exceed";
-                    // }
-                    // Just for notify if scan_row_batches_ is empty and no running thread
-                    if (assigned_thread_num == 0) {
-                        thread_slot_num = 1;
-                        // NOTE: if olap_scanners_ is empty, scanner_done_ should be true
-                    }
-                }
-            }
-            thread_slot_num = std::min(thread_slot_num, _olap_scanners.size());
-            for (int i = 0; i < thread_slot_num; ++i) {
-                olap_scanners.push_back(_olap_scanners.front());
-                _olap_scanners.pop_front();
-                _running_thread++;
-                assigned_thread_num++;
-            }
-        }
 
-        auto iter = olap_scanners.begin();
-        while (iter != olap_scanners.end()) {
-            PriorityThreadPool::Task task;
-            task.work_function = boost::bind(&OlapScanNode::scanner_thread, this, *iter);
-            task.priority = _nice;
-            if (thread_pool->offer(task)) {
-                olap_scanners.erase(iter++);
-            } else {
-                LOG(FATAL) << "Failed to assign scanner task to thread pool!";
-            }
-            ++_total_assign_num;
-        }
+    adjust_running_scanners(num_batches);
+    size_t num_scanners = 0;
+    if (num_batches < max_queued_batches() && mem_consume < (_mem_limit * 6) / 10) {
+        num_scanners = std::max<int64_t>(_max_running_scanners - _running_thread, 0);
+    } else if (num_batches == 0 && _running_thread == 0) {
+        // nothing would wake the consumer up otherwise
+        num_scanners = 1;
+    }
+    num_scanners = std::min(num_scanners, _olap_scanners.size());
+    for (int i = 0; i < num_scanners; ++i) {
+        scanners->push_back(_olap_scanners.front());
+        _olap_scanners.pop_front();
+        _running_thread++;
+    }
+}
 
-        RowBatchInterface* scan_batch = NULL;
-        {
-            // 1 scanner idle task not empty, assign new scanner task
-            std::unique_lock<std::mutex> l(_scan_batches_lock);
+void OlapScanNode::adjust_running_scanners(size_t num_batches) {
+    FairThreadPool* thread_pool = scan_thread_pool();
+    // the scanners of all queries waiting for a thread
+    int64_t backlog = thread_pool->get_queue_size();
+    int64_t num_threads = thread_pool->num_threads();
+    if (num_batches == 0 && !_olap_scanners.empty() && backlog < num_threads) {
+        _max_running_scanners = std::min(_max_running_scanners + 1, _running_scanners_limit);
+    } else if (num_batches * 2 > max_queued_batches() || backlog > num_threads) {
+        _max_running_scanners = std::max<int64_t>(_max_running_scanners - 1, 1);
+    } else {
+        return;
+    }
+    COUNTER_SET(_scanner_concurrency_counter, _max_running_scanners);
+    if (_max_running_scanners > _peak_scanner_concurrency_counter->value()) {
+        COUNTER_SET(_peak_scanner_concurrency_counter, _max_running_scanners);
+    }
+}
 
-            // scanner_row_num = 16k
-            // 16k * 10 * 12 * 8 = 15M(>2s)  --> nice=10
-            // 16k * 20 * 22 * 8 = 55M(>6s)  --> nice=0
-            while (_nice > 0 && _total_assign_num > (22 - _nice) * (20 - _nice) * 6) {
-                --_nice;
-            }
+FairThreadPool* OlapScanNode::scan_thread_pool() {
+    ResourceGroup* resource_group = _runtime_state->resource_group();
+    if (resource_group != nullptr && resource_group->scan_thread_pool() != nullptr) {
+        return resource_group->scan_thread_pool();
+    }
+    return _runtime_state->exec_env()->scan_thread_pool();
+}
 
-            // 2 wait when all scanner are running & no result in queue
-            while (UNLIKELY(_running_thread == assigned_thread_num && _scan_row_batches.empty() &&
-                            !_scanner_done)) {
-                _scan_batch_added_cv.wait(l);
-            }
+void OlapScanNode::submit_scanners(const std::list<OlapScanner*>& scanners) {
+    FairThreadPool* thread_pool = scan_thread_pool();
+    for (auto scanner : scanners) {
+        FairThreadPool::Task task;
+        task.work_function = boost::bind(&OlapScanNode::scanner_thread, this, scanner);
+        task.queue_wait_timer = _scanner_queue_wait_timer;
+        if (!thread_pool->offer(_runtime_state->query_id(), task)) {
+            LOG(FATAL) << "Failed to assign scanner task to thread pool!";
+        }
+    }
+}
 
-            // 3 transfer result row batch when queue is not empty
-            if (LIKELY(!_scan_row_batches.empty())) {
-                scan_batch = _scan_row_batches.front();
-                _scan_row_batches.pop_front();
+void OlapScanNode::schedule_scanners() {
+    std::list<OlapScanner*> scanners;
+    {
+        std::unique_lock<bthread::Mutex> l(_scan_batches_lock);
+        pick_scanners(&scanners);
+    }
+    // the scanners picked are counted as running, so this node can't be closed under them
+    submit_scanners(scanners);
+}
 
-                // delete scan_batch if transfer thread should be stopped
-                // because scan_batch wouldn't be useful anymore
-                if (UNLIKELY(_transfer_done)) {
-                    delete scan_batch;
-                    scan_batch = NULL;
-                }
-            } else {
-                if (_scanner_done) {
-                    break;
-                }
-            }
+int OlapScanNode::max_batch_rows() {
+    int64_t max_rows = _runtime_state->batch_size();
+    if (_limit != -1) {
+        int64_t missing_rows = _limit - __sync_fetch_and_add(&_scanned_rows, 0);
+        if (missing_rows > 0) {
+            max_rows = std::min(max_rows, missing_rows);
         }
+    }
+    int64_t rows = __sync_fetch_and_add(&_scanned_rows, 0);
+    if (rows > 0) {
+        int64_t row_bytes = std::max<int64_t>(__sync_fetch_and_add(&_scanned_bytes, 0) / rows, 1);
+        max_rows = std::min(max_rows, config::doris_scanner_batch_max_bytes / row_bytes);
+    }
+    return std::max<int64_t>(max_rows, 1);
+}
+
+int64_t OlapScanNode::max_queued_batches() {
+    int64_t batches = __sync_fetch_and_add(&_scanned_batches, 0);
+    if (batches == 0) {
+        return _max_materialized_row_batches;
+    }
+    int64_t batch_bytes = std::max<int64_t>(__sync_fetch_and_add(&_scanned_bytes, 0) / batches, 1);
+    int64_t max_batches = (_mem_limit * 6) / 10 / batch_bytes;
+    return std::max<int64_t>(std::min<int64_t>(max_batches, _max_materialized_row_batches), 1);
+}
 
-        if (NULL != scan_batch) {
-            add_one_batch(scan_batch);
+RowBatch* OlapScanNode::get_free_row_batch() {
+    {
+        std::lock_guard<SpinLock> l(_free_row_batches_lock);
+        if (!_free_row_batches.empty()) {
+            RowBatch* row_batch = _free_row_batches.back();
+            _free_row_batches.pop_back();
+            return row_batch;
         }
     }
+    return new RowBatch(row_desc(), _runtime_state->batch_size(),
+                        _runtime_state->fragment_mem_tracker().get());
+}
 
-    state->resource_pool()->release_thread_token(true);
-    VLOG(1) << "TransferThread finish.";
-    std::unique_lock<std::mutex> l(_row_batches_lock);
-    _transfer_done = true;
-    _row_batch_added_cv.notify_all();
+void OlapScanNode::return_free_row_batch(RowBatch* row_batch) {
+    row_batch->reset();
+    {
+        std::lock_guard<SpinLock> l(_free_row_batches_lock);
+        if (_free_row_batches.size() < _max_materialized_row_batches) {
+            _free_row_batches.push_back(row_batch);
+            return;
+        }
+    }
+    delete row_batch;
 }
 
 void OlapScanNode::scanner_thread(OlapScanner* scanner) {
+    ThreadCpuStopWatch cpu_watch;
+    cpu_watch.start();
+    bool perf_started =
+            _scanner_perf_counters != nullptr && ThreadPerfCounters::start_thread_events();
+    ADOPT_TRACE(scanner->trace());
+    TRACE("scanner $0 scheduled", scanner->id());
     Status status = Status::OK();
     bool eos = false;
     RuntimeState* state = scanner->runtime_state();
     DCHECK(NULL != state);
+    ScopedCpuProfilerTag profiler_tag(state->query_id(), ContinuousCpuProfiler::SCANNER);
     if (!scanner->is_open()) {
         status = scanner->open();
         if (!status.ok()) {
@@ -1219,8 +1599,11 @@ void OlapScanNode::scanner_thread(OlapScanner* scanner) {
         scanner->set_opened();
     }
 
-    // apply to cgroup
-    if (_resource_info != nullptr) {
+    // apply to cgroup, the one of the resource group takes precedence over the user's
+    ResourceGroup* resource_group = _runtime_state->resource_group();
+    if (resource_group != nullptr && !resource_group->cgroup().empty()) {
+        CgroupsMgr::apply_cgroup(resource_group->cgroup(), "");
+    } else if (_resource_info != nullptr) {
         CgroupsMgr::apply_cgroup(_resource_info->user, _resource_info->group);
     }
 
@@ -1231,100 +1614,133 @@ void OlapScanNode::scanner_thread(OlapScanner* scanner) {
     // need yield this thread when we do enough work. However, OlapStorage read
     // data in pre-aggregate mode, then we can't use storage returned data to
     // judge if we need to yield. So we record all raw data read in this round
-    // scan, if this exceed threshold, we yield this thread.
+    // scan, if this exceed threshold, or this round has run too long, we yield this
+    // thread.
     int64_t raw_rows_read = scanner->raw_rows_read();
     int64_t raw_rows_threshold = raw_rows_read + config::doris_scanner_row_num;
-    while (!eos && raw_rows_read < raw_rows_threshold) {
+    int64_t max_run_time_ns = config::doris_scanner_max_run_time_ms * 1000L * 1000L;
+    // A round doesn't read more than the share of a scanner of the memory the scanners may
+    // use either, which wide rows would exceed before doris_scanner_row_num rows.
+    int64_t max_running_scanners = 1;
+    {
+        std::unique_lock<bthread::Mutex> l(_scan_batches_lock);
+        max_running_scanners = _max_running_scanners;
+    }
+    int64_t max_round_bytes = (_mem_limit * 6) / 10 / max_running_scanners;
+    int64_t round_bytes = 0;
+    MonotonicStopWatch watch;
+    watch.start();
+    while (!eos && raw_rows_read < raw_rows_threshold && watch.elapsed_time() < max_run_time_ns &&
+           round_bytes < max_round_bytes) {
         if (UNLIKELY(_transfer_done)) {
             eos = true;
             status = Status::Cancelled("Cancelled");
             LOG(INFO) << "Scan thread cancelled, cause query done, maybe reach limit.";
             break;
         }
-        RowBatch* row_batch = new RowBatch(this->row_desc(), state->batch_size(),
-                                           _runtime_state->fragment_mem_tracker().get());
+        RowBatch* row_batch = get_free_row_batch();
         row_batch->set_scanner_id(scanner->id());
-        status = scanner->get_batch(_runtime_state, row_batch, &eos);
+        int max_rows = max_batch_rows();
+        status = scanner->get_batch(_runtime_state, row_batch, max_rows, &eos);
         if (!status.ok()) {
             LOG(WARNING) << "Scan thread read OlapScanner failed: " << status.to_string();
+            return_free_row_batch(row_batch);
             eos = true;
             break;
         }
         // 4. if status not ok, change status_.
         if (UNLIKELY(row_batch->num_rows() == 0)) {
             // may be failed, push already, scan node delete this batch.
-            delete row_batch;
+            return_free_row_batch(row_batch);
             row_batch = NULL;
         } else {
             row_batchs.push_back(row_batch);
             __sync_fetch_and_add(&_buffered_bytes,
                                  row_batch->tuple_data_pool()->total_reserved_bytes());
+            // without the tuples of the rows filtered out
+            int64_t bytes = row_batch->tuple_data_pool()->total_allocated_bytes() -
+                            (max_rows - row_batch->num_rows()) * _tuple_desc->byte_size();
+            bytes = std::max<int64_t>(bytes, 0);
+            round_bytes += bytes;
+            __sync_fetch_and_add(&_scanned_bytes, bytes);
+            __sync_fetch_and_add(&_scanned_batches, 1);
+            int64_t scanned_rows = __sync_add_and_fetch(&_scanned_rows, row_batch->num_rows());
+            if (_limit != -1 && scanned_rows >= _limit) {
+                // the rows read may already be all the consumer needs, let them reach it
+                break;
+            }
         }
         raw_rows_read = scanner->raw_rows_read();
     }
+    TRACE("scanner $0 yields, $1 batches read, eos=$2", scanner->id(), row_batchs.size(), eos);
 
-    {
-        std::unique_lock<std::mutex> l(_scan_batches_lock);
-        // if we failed, check status.
-        if (UNLIKELY(!status.ok())) {
-            _transfer_done = true;
-            std::lock_guard<SpinLock> guard(_status_mutex);
-            if (LIKELY(_status.ok())) {
-                _status = status;
-            }
-        }
-
-        bool global_status_ok = false;
-        {
-            std::lock_guard<SpinLock> guard(_status_mutex);
-            global_status_ok = _status.ok();
+    // if we failed, check status.
+    if (UNLIKELY(!status.ok())) {
+        std::lock_guard<SpinLock> guard(_status_mutex);
+        if (LIKELY(_status.ok())) {
+            _status = status;
         }
+    }
+    bool global_status_ok = false;
+    {
+        std::lock_guard<SpinLock> guard(_status_mutex);
+        global_status_ok = _status.ok();
+    }
+    {
+        // The batches go to the consumer directly, there's no thread in between which
+        // waits for them.
+        std::unique_lock<bthread::Mutex> l(_row_batches_lock);
         if (UNLIKELY(!global_status_ok)) {
             eos = true;
+            _transfer_done = true;
             for (auto rb : row_batchs) {
                 delete rb;
             }
         } else {
             for (auto rb : row_batchs) {
-                _scan_row_batches.push_back(rb);
+                _materialized_row_batches.push_back(rb);
             }
         }
-        // If eos is true, we will process out of this lock block.
-        if (!eos) {
-            _olap_scanners.push_front(scanner);
-        }
-        _running_thread--;
     }
+    _row_batch_added_cv.notify_one();
+
     if (eos) {
         // close out of batches lock. we do this before _progress update
         // that can assure this object can keep live before we finish.
         scanner->close(_runtime_state);
-
-        std::unique_lock<std::mutex> l(_scan_batches_lock);
-        _progress.update(1);
-        if (_progress.done()) {
-            // this is the right out
-            _scanner_done = true;
-        }
     }
-    _scan_batch_added_cv.notify_one();
-}
 
-Status OlapScanNode::add_one_batch(RowBatchInterface* row_batch) {
+    std::list<OlapScanner*> scanners;
     {
-        std::unique_lock<std::mutex> l(_row_batches_lock);
-
-        while (UNLIKELY(_materialized_row_batches.size() >= _max_materialized_row_batches &&
-                        !_transfer_done)) {
-            _row_batch_consumed_cv.wait(l);
+        std::unique_lock<bthread::Mutex> l(_scan_batches_lock);
+        COUNTER_UPDATE(_scanner_cpu_timer, cpu_watch.elapsed_time());
+        if (perf_started) {
+            _scanner_perf_counters->stop_thread_events();
+        }
+        if (!eos) {
+            _olap_scanners.push_front(scanner);
+        } else {
+            _progress.update(1);
+            if (_progress.done()) {
+                // this is the right out
+                _scanner_done = true;
+                std::unique_lock<bthread::Mutex> row_batches_l(_row_batches_lock);
+                _transfer_done = true;
+                _row_batch_added_cv.notify_all();
+            }
+        }
+        _running_thread--;
+        // offer the next scanners, maybe this one again, before this task ends
+        pick_scanners(&scanners);
+        if (_running_thread == 0) {
+            // close() may be waiting for the last scanner. Nothing of this node is
+            // touched after the lock is released then.
+            _scan_batch_added_cv.notify_all();
         }
-
-        VLOG(2) << "Push row_batch to materialized_row_batches";
-        _materialized_row_batches.push_back(row_batch);
     }
-    // remove one batch, notify main thread
-    _row_batch_added_cv.notify_one();
-    return Status::OK();
+    if (!scanners.empty()) {
+        submit_scanners(scanners);
+    }
 }
 
 void OlapScanNode::debug_string(int /* indentation_level */, std::stringstream* /* out */) const {}
@@ -18,22 +18,32 @@
 #ifndef DORIS_BE_SRC_QUERY_EXEC_OLAP_SCAN_NODE_H
 #define DORIS_BE_SRC_QUERY_EXEC_OLAP_SCAN_NODE_H
 
+#include "service/brpc.h"
+
+#include <atomic>
 #include <boost/thread.hpp>
 #include <boost/variant/static_visitor.hpp>
-#include <condition_variable>
+#include <map>
+#include <mutex>
 #include <queue>
 
 #include "exec/olap_common.h"
 #include "exec/olap_scanner.h"
 #include "exec/scan_node.h"
+#include "exec/scan_string_dict.h"
 #include "runtime/descriptors.h"
 #include "runtime/row_batch_interface.hpp"
+#include "runtime/sorted_run_merger.h"
 #include "runtime/vectorized_row_batch.h"
 #include "util/progress_updater.h"
 #include "util/spinlock.h"
+#include "util/thread_perf_counters.h"
+#include "util/tuple_row_compare.h"
 
 namespace doris {
 
+class FairThreadPool;
+
 enum TransferStatus {
     READ_ROWBATCH = 1,
     INIT_HEAP = 2,
@@ -56,6 +66,12 @@ public:
     virtual Status close(RuntimeState* state);
     virtual Status set_scan_ranges(const std::vector<TScanRangeParams>& scan_ranges);
     inline void set_no_agg_finalize() { _need_agg_finalize = false; }
+    // Set by the parent TopNNode before open(), the scanners drop rows worse than it.
+    void set_topn_threshold(TopNThreshold* threshold);
+    // Appends what determines the rows of this scan to the AggResultCache key of the
+    // parent: its plan, the columns it reads and the tablet versions of its scan ranges.
+    // Returns false if its rows can't be cached. Called after prepare().
+    bool append_cache_key(std::string* key) const;
 
 protected:
     typedef struct {
@@ -148,10 +164,43 @@ protected:
     template <class T>
     Status normalize_noneq_binary_predicate(SlotDescriptor* slot, ColumnValueRange<T>* range);
 
-    void transfer_thread(RuntimeState* state);
+    // Runs 'scanner' for a while in the scan thread pool, queueing its batches for
+    // get_next(), then offers the idle scanners to the pool again.
     void scanner_thread(OlapScanner* scanner);
 
-    Status add_one_batch(RowBatchInterface* row_batch);
+    // Moves the idle scanners that may run now to 'scanners' and counts them as
+    // running. Must hold _scan_batches_lock.
+    void pick_scanners(std::list<OlapScanner*>* scanners);
+    // Scales _max_running_scanners up while the consumer waits for batches and the scan
+    // thread pool has idle threads, and down while batches pile up or the pool has a backlog.
+    // Must hold _scan_batches_lock.
+    void adjust_running_scanners(size_t num_batches);
+    // the scan thread pool of the resource group of the query, or the global one
+    FairThreadPool* scan_thread_pool();
+    // Offers 'scanners', picked by pick_scanners(), to the scan thread pool.
+    void submit_scanners(const std::list<OlapScanner*>& scanners);
+    void schedule_scanners();
+
+    // The rows a scanner fills a batch with at most, less than batch_size for wide rows, and
+    // for a LIMIT only the rows still missing, so that the first rows reach the consumer soon.
+    int max_batch_rows();
+    // The batches queued at most, as many as the memory the scanners may use holds.
+    int64_t max_queued_batches();
+
+    // Returns a row batch for a scanner to fill, reusing a consumed one if there is any.
+    RowBatch* get_free_row_batch();
+    // Resets 'row_batch' and keeps it for get_free_row_batch(), or deletes it if enough
+    // batches are kept already.
+    void return_free_row_batch(RowBatch* row_batch);
+
+    // With num_ordered_keys, get_next() returns the rows of all scanners merged in the
+    // order of the first num_ordered_keys key columns instead of scanning them in the
+    // scan thread pool, so a merge join above sees rows in the order of its keys.
+    Status start_ordered_merge(RuntimeState* state);
+    Status get_next_ordered(RuntimeState* state, RowBatch* row_batch, bool* eos);
+    // The RunBatchSupplier of 'scanner' for _ordered_merger, 'scanner_batch' is reused
+    // for each batch of the scanner.
+    Status get_ordered_batch(OlapScanner* scanner, RowBatch* scanner_batch, RowBatch** batch);
 
     // Write debug string of this into out.
     virtual void debug_string(int indentation_level, std::stringstream* out) const;
@@ -165,19 +214,49 @@ private:
     void construct_is_null_pred_in_where_pred(Expr* expr, SlotDescriptor* slot,
                                               const std::string& is_null_str);
 
+    // push "slot LIKE constant" down to storage engine, which may skip rows by n-gram
+    // index, the conjunct is kept as LIKE is not evaluated by segment v1
+    void normalize_like_predicate(SlotDescriptor* slot);
+
+    // push "st_contains(shape, st_point(lng, lat))" and "st_distance_sphere(lng, lat, x, y)
+    // < radius" with constant shape, x, y and radius down to storage engine, which may skip
+    // rows by the S2 index of lng, the conjuncts are kept as the index is not exact
+    void normalize_geo_predicates();
+    // the DOUBLE slot of this tuple 'expr' refers to, nullptr if it isn't one
+    SlotDescriptor* _double_slot(Expr* expr);
+
+    // Counters of the reads of the scanners from a data dir, in the child profile
+    // "DataDir <path>" of the scanner profile
+    struct DataDirCounters {
+        RuntimeProfile::Counter* compressed_bytes_read = nullptr;
+        // pages read from the files, i.e. not found in the page cache
+        RuntimeProfile::Counter* pages_read = nullptr;
+        RuntimeProfile::Counter* io_timer = nullptr;
+        RuntimeProfile::Counter* file_opens = nullptr;
+    };
+    // Returns the counters of the data dir at 'path', created on its first read.
+    DataDirCounters* _data_dir_counters(const std::string& path);
+
     friend class OlapScanner;
 
     std::vector<TCondition> _is_null_vector;
+    std::vector<TCondition> _like_conditions;
+    std::vector<TCondition> _geo_conditions;
     // Tuple id resolved in prepare() to set _tuple_desc;
     TupleId _tuple_id;
     // doris scan node used to scan doris
     TOlapScanNode _olap_scan_node;
+    // The serialized plan of this node for append_cache_key(), empty if its rows aren't
+    // cached
+    std::string _cache_plan;
     // tuple descriptors
     const TupleDescriptor* _tuple_desc;
     // tuple index
     int _tuple_idx;
     // string slots
     std::vector<SlotDescriptor*> _string_slots;
+    // one for each of _string_slots, empty if disabled
+    std::vector<std::unique_ptr<ScanStringDict>> _string_dicts;
 
     bool _eos;
 
@@ -195,8 +274,6 @@ private:
     // object is.
     std::unique_ptr<ObjectPool> _scanner_pool;
 
-    boost::thread_group _transfer_thread;
-
     // Keeps track of total splits and the number finished.
     ProgressUpdater _progress;
 
@@ -205,30 +282,42 @@ private:
     // GetNext.  Row batches must be processed by the main thread in the order they are
     // queued to avoid freeing attached resources prematurely (row batches will never depend
     // on resources attached to earlier batches in the queue).
-    // This lock cannot be taken together with any other locks except _lock.
-    std::mutex _row_batches_lock;
-    std::condition_variable _row_batch_added_cv;
-    std::condition_variable _row_batch_consumed_cv;
+    // This lock cannot be taken together with any other locks except _scan_batches_lock.
+    // The bthread primitives suspend get_next() instead of blocking the worker if the
+    // fragment runs in a bthread, see config::fragment_exec_in_bthread.
+    bthread::Mutex _row_batches_lock;
+    bthread::ConditionVariable _row_batch_added_cv;
 
     std::list<RowBatchInterface*> _materialized_row_batches;
 
-    std::mutex _scan_batches_lock;
-    std::condition_variable _scan_batch_added_cv;
+    // The batches whose rows get_next() has passed on, with their tuple pointers and
+    // MemPools, which the scanners fill again instead of constructing new batches. At most
+    // _max_materialized_row_batches are kept.
+    SpinLock _free_row_batches_lock;
+    std::vector<RowBatch*> _free_row_batches;
+
+    // protects the idle scanners, _running_thread and _progress, taken before
+    // _row_batches_lock if both are. _scan_batch_added_cv is notified when no scanner
+    // is running anymore.
+    bthread::Mutex _scan_batches_lock;
+    bthread::ConditionVariable _scan_batch_added_cv;
     int32_t _scanner_task_finish_count;
 
-    std::list<RowBatchInterface*> _scan_row_batches;
-
+    // idle scanners
     std::list<OlapScanner*> _olap_scanners;
 
     int _max_materialized_row_batches;
+    // [1, _running_scanners_limit], protected by _scan_batches_lock once scanners run
+    int64_t _max_running_scanners = 1;
+    int64_t _running_scanners_limit = 1;
+    // scanners pause when the fragment uses 60% of it
+    int64_t _mem_limit = 0;
     bool _start;
     bool _scanner_done;
-    bool _transfer_done;
+    // read by pick_scanners() and the scanners without holding _row_batches_lock
+    std::atomic<bool> _transfer_done;
     size_t _direct_conjunct_size;
 
-    int _total_assign_num;
-    int _nice;
-
     // protect _status, for many thread may change _status
     SpinLock _status_mutex;
     Status _status;
@@ -236,11 +325,25 @@ private:
     RuntimeProfile::Counter* _scan_timer;
     RuntimeProfile::Counter* _tablet_counter;
     RuntimeProfile::Counter* _rows_pushed_cond_filtered_counter = nullptr;
+    RuntimeProfile::Counter* _rows_topn_filtered_counter = nullptr;
     RuntimeProfile::Counter* _reader_init_timer = nullptr;
 
+    TopNThreshold* _topn_threshold = nullptr;
+
+    // slots of the ordered keys, and the merger of scanners with num_ordered_keys
+    std::vector<ExprContext*> _ordered_key_ctxs;
+    std::unique_ptr<TupleRowComparator> _ordered_key_comparator;
+    std::unique_ptr<SortedRunMerger> _ordered_merger;
+    std::vector<std::unique_ptr<RowBatch>> _ordered_batches;
+
     TResourceInfo* _resource_info;
 
     int64_t _buffered_bytes;
+    // the rows, tuple data bytes and batches the scanners have read, which tell the
+    // width of the rows
+    int64_t _scanned_rows = 0;
+    int64_t _scanned_bytes = 0;
+    int64_t _scanned_batches = 0;
     int64_t _running_thread;
     EvalConjunctsFn _eval_conjuncts_fn;
 
@@ -260,6 +363,9 @@ private:
 
     std::unique_ptr<RuntimeProfile> _scanner_profile;
     std::unique_ptr<RuntimeProfile> _segment_profile;
+    // by the path of the data dir, the scanners of different dirs close concurrently
+    SpinLock _data_dir_counters_lock;
+    std::map<std::string, DataDirCounters> _data_dir_counters_map;
 
     // Counters
     RuntimeProfile::Counter* _io_timer = nullptr;
@@ -270,6 +376,10 @@ private:
 
     RuntimeProfile::Counter* _rows_vec_cond_counter = nullptr;
     RuntimeProfile::Counter* _vec_cond_timer = nullptr;
+    RuntimeProfile::Counter* _rows_block_filter_counter = nullptr;
+    RuntimeProfile::Counter* _block_filter_timer = nullptr;
+    RuntimeProfile::Counter* _read_ahead_pages_counter = nullptr;
+    RuntimeProfile::Counter* _read_ahead_wait_timer = nullptr;
 
     RuntimeProfile::Counter* _stats_filtered_counter = nullptr;
     RuntimeProfile::Counter* _bf_filtered_counter = nullptr;
@@ -292,13 +402,35 @@ private:
     // page read from cache
     // used by segment v2
     RuntimeProfile::Counter* _cached_pages_num_counter = nullptr;
+    // compressed bytes of the pages found in the page cache
+    RuntimeProfile::Counter* _cached_bytes_read_counter = nullptr;
+    // segment files opened, rather than found in the file cache
+    RuntimeProfile::Counter* _file_open_counter = nullptr;
 
     // row count filtered by bitmap inverted index
     RuntimeProfile::Counter* _bitmap_index_filter_counter = nullptr;
     // time fro bitmap inverted index read and filter
     RuntimeProfile::Counter* _bitmap_index_filter_timer = nullptr;
+    // row count filtered by n-gram index, and time for reading it
+    RuntimeProfile::Counter* _ngram_index_filter_counter = nullptr;
+    RuntimeProfile::Counter* _ngram_index_filter_timer = nullptr;
+    // row count filtered by S2 index, and time for reading it
+    RuntimeProfile::Counter* _s2_index_filter_counter = nullptr;
+    RuntimeProfile::Counter* _s2_index_filter_timer = nullptr;
     // number of created olap scanners
     RuntimeProfile::Counter* _num_scanners = nullptr;
+    // the last and the largest _max_running_scanners
+    RuntimeProfile::Counter* _scanner_concurrency_counter = nullptr;
+    RuntimeProfile::Counter* _peak_scanner_concurrency_counter = nullptr;
+    // time scanners wait in the scan thread pool
+    RuntimeProfile::Counter* _scanner_queue_wait_timer = nullptr;
+    // cpu time of the scanner threads, which isn't part of the cpu time of the node
+    RuntimeProfile::Counter* _scanner_cpu_timer = nullptr;
+    // hardware events of the scanner threads, only if the query option
+    // enable_perf_counters is set
+    std::unique_ptr<ThreadPerfCounters> _scanner_perf_counters;
+    // time get_next() waits for the scanners to materialize a batch
+    RuntimeProfile::Counter* _wait_scanner_timer = nullptr;
 
     // number of segment filtered by column stat when creating seg iterator
     RuntimeProfile::Counter* _filtered_segment_counter = nullptr;
@@ -17,11 +17,18 @@
 
 #include "olap_scanner.h"
 
+#include <algorithm>
 #include <cstring>
+#include <set>
 #include <string>
 
+#include "common/config.h"
 #include "gen_cpp/PaloInternalService_types.h"
+#include "olap/data_dir.h"
 #include "olap/field.h"
+#include "olap/row_block2.h"
+#include "olap/rowset/beta_rowset.h"
+#include "olap/wrapper_field.h"
 #include "olap_scan_node.h"
 #include "olap_utils.h"
 #include "runtime/descriptors.h"
@@ -32,6 +39,7 @@
 #include "util/doris_metrics.h"
 #include "util/mem_util.hpp"
 #include "util/network_util.h"
+#include "util/uid_util.h"
 
 namespace doris {
 
@@ -53,6 +61,21 @@ OlapScanner::OlapScanner(RuntimeState* runtime_state, OlapScanNode* parent, bool
 
     _rows_read_counter = parent->rows_read_counter();
     _rows_pushed_cond_filtered_counter = parent->_rows_pushed_cond_filtered_counter;
+    _rows_topn_filtered_counter = parent->_rows_topn_filtered_counter;
+    _topn_threshold = parent->_topn_threshold;
+    if (parent->_olap_scan_node.__isset.push_down_agg_type_opt) {
+        _push_down_agg_type = parent->_olap_scan_node.push_down_agg_type_opt;
+    }
+    if (parent->_olap_scan_node.__isset.sort_limit) {
+        _sort_limit = parent->_olap_scan_node.sort_limit;
+    }
+    if (config::olap_scanner_trace_threshold_ms > 0) {
+        _trace = new Trace;
+    }
+    for (auto& dict : parent->_string_dicts) {
+        _string_dict_caches.emplace_back(new ScanStringDictCache(dict.get()));
+    }
+    _string_copied.resize(_string_slots.size());
 }
 
 OlapScanner::~OlapScanner() {}
@@ -113,10 +136,19 @@ Status OlapScanner::prepare(const TPaloScanRange& scan_range,
 
 Status OlapScanner::open() {
     SCOPED_TIMER(_parent->_reader_init_timer);
+    _trace_watch.start();
+    TRACE("open scanner of tablet $0", _tablet->full_name());
 
     if (_conjunct_ctxs.size() > _direct_conjunct_size) {
         _use_pushdown_conjuncts = true;
     }
+    _init_topn_filter();
+    _init_conjunct_block_filter();
+
+    RETURN_IF_ERROR(_init_push_down_agg());
+    if (_push_down_agg) {
+        return Status::OK();
+    }
 
     auto res = _reader->init(_params);
     if (res != OLAP_SUCCESS) {
@@ -126,6 +158,239 @@ Status OlapScanner::open() {
            << ", res=" << res << ", backend=" << BackendOptions::get_localhost();
         return Status::InternalError(ss.str().c_str());
     }
+    _direct_conjuncts_in_storage =
+            _conjunct_block_filter != nullptr && _reader->block_filters_applied();
+    _topn_in_storage = _topn_block_filter != nullptr && _reader->block_filters_applied();
+    TRACE("storage reader initialized");
+    return Status::OK();
+}
+
+Status OlapScanner::_init_push_down_agg() {
+    // FE has checked the aggregation and the table, but not the conditions added by BE
+    // and the versions to read
+    if (_push_down_agg_type == TPushAggOp::NONE || !_conjunct_ctxs.empty() ||
+        _parent->limit() != -1 || !_params.conditions.empty() || !_params.start_key.empty() ||
+        _tablet->tablet_schema().keys_type() != DUP_KEYS) {
+        return Status::OK();
+    }
+    for (auto& delete_predicate : _tablet->delete_predicates()) {
+        if (delete_predicate.version() <= _version) {
+            return Status::OK();
+        }
+    }
+
+    bool need_min_max = _push_down_agg_type != TPushAggOp::COUNT;
+    std::vector<std::unique_ptr<WrapperField>> min_values;
+    std::vector<std::unique_ptr<WrapperField>> max_values;
+    if (need_min_max) {
+        _agg_mem_tracker = MemTracker::CreateTracker(-1, "OlapScanner:PushDownAgg",
+                                                     _parent->mem_tracker());
+        _agg_pool.reset(new MemPool(_agg_mem_tracker.get()));
+        for (auto& converter : _slot_converters) {
+            const TabletColumn& column = _tablet->tablet_schema().column(converter.cid);
+            min_values.emplace_back(WrapperField::create(column));
+            max_values.emplace_back(WrapperField::create(column));
+            if (min_values.back() == nullptr || max_values.back() == nullptr) {
+                return Status::OK();
+            }
+        }
+    }
+
+    std::vector<SegmentAggRows> agg_segments;
+    for (auto& rs_reader : _params.rs_readers) {
+        RowsetSharedPtr rowset = rs_reader->rowset();
+        if (rowset->rowset_meta()->num_rows() == 0) {
+            continue;
+        }
+        std::vector<segment_v2::SegmentSharedPtr> segments;
+        if (rowset->rowset_meta()->rowset_type() != BETA_ROWSET ||
+            std::static_pointer_cast<BetaRowset>(rowset)->load_segments(&segments) !=
+                    OLAP_SUCCESS) {
+            return Status::OK();
+        }
+        for (auto& segment : segments) {
+            SegmentAggRows rows;
+            rows.num_rows = segment->num_rows();
+            if (rows.num_rows == 0) {
+                continue;
+            }
+            if (need_min_max) {
+                for (int i = 0; i < _slot_converters.size(); ++i) {
+                    uint32_t cid = _slot_converters[i].cid;
+                    if (!segment->get_min_max(cid, min_values[i].get(), max_values[i].get())
+                                 .ok()) {
+                        return Status::OK();
+                    }
+                }
+                rows.min_tuple = _zone_map_to_tuple(min_values);
+                rows.max_tuple = _zone_map_to_tuple(max_values);
+            }
+            agg_segments.push_back(rows);
+        }
+    }
+    _agg_segments = std::move(agg_segments);
+    _push_down_agg = true;
+    VLOG(2) << "push down aggregation to storage, tablet=" << _tablet->full_name()
+            << ", type=" << _TPushAggOp_VALUES_TO_NAMES.at(_push_down_agg_type)
+            << ", segments=" << _agg_segments.size();
+    return Status::OK();
+}
+
+Tuple* OlapScanner::_zone_map_to_tuple(const std::vector<std::unique_ptr<WrapperField>>& values) {
+    for (int i = 0; i < _slot_converters.size(); ++i) {
+        uint32_t cid = _slot_converters[i].cid;
+        RowCursorCell cell = _read_row_cursor.cell(cid);
+        _read_row_cursor.column_schema(cid)->direct_copy(&cell, *values[i]);
+    }
+    Tuple* tuple = reinterpret_cast<Tuple*>(_agg_pool->allocate(_tuple_desc->byte_size()));
+    tuple->init(_tuple_desc->byte_size());
+    _convert_row_to_tuple(tuple);
+    // strings still point to _read_row_cursor
+    return tuple->deep_copy(*_tuple_desc, _agg_pool.get());
+}
+
+void OlapScanner::_init_conjunct_block_filter() {
+    if (!config::enable_storage_conjunct_filter || _direct_conjunct_size == 0 ||
+        _tablet->tablet_schema().keys_type() != DUP_KEYS) {
+        return;
+    }
+    std::vector<SlotId> slot_ids;
+    for (int i = 0; i < _direct_conjunct_size; ++i) {
+        _conjunct_ctxs[i]->root()->get_slot_ids(&slot_ids);
+    }
+    std::set<SlotId> referenced(slot_ids.begin(), slot_ids.end());
+    std::vector<SlotConverter> converters;
+    for (int i = 0; i < _query_slots.size(); ++i) {
+        if (referenced.erase(_query_slots[i]->id()) > 0) {
+            converters.push_back(_slot_converters[i]);
+        }
+    }
+    // nothing is saved if the conjuncts reference all read columns
+    if (!referenced.empty() || converters.empty() ||
+        converters.size() >= _params.return_columns.size()) {
+        return;
+    }
+    _conjunct_block_filter.reset(new ConjunctBlockFilter(this, std::move(converters)));
+    _params.block_filters.push_back(_conjunct_block_filter.get());
+}
+
+void OlapScanner::_init_topn_filter() {
+    if (_topn_threshold == nullptr) {
+        return;
+    }
+    for (int i = 0; i < _query_slots.size(); ++i) {
+        if (_query_slots[i]->id() != _topn_threshold->slot_id()) {
+            continue;
+        }
+        if (_query_slots[i]->type() != _topn_threshold->type()) {
+            return;
+        }
+        _topn_slot = _query_slots[i];
+        if (_tablet->tablet_schema().keys_type() == DUP_KEYS) {
+            _topn_block_filter.reset(new TopNBlockFilter(this, _slot_converters[i]));
+            _params.block_filters.push_back(_topn_block_filter.get());
+        }
+        return;
+    }
+}
+
+OlapScanner::TopNBlockFilter::TopNBlockFilter(OlapScanner* scanner,
+                                              const SlotConverter& converter)
+        : _scanner(scanner),
+          _converter(converter),
+          _column_ids({converter.cid}),
+          _tuple_buf(new uint8_t[scanner->_tuple_desc->byte_size()]) {
+    _conditions.set_tablet_schema(&scanner->_tablet->tablet_schema());
+}
+
+void OlapScanner::TopNBlockFilter::_refresh_snapshot() {
+    if (_scanner->_topn_threshold->version() != _snapshot.version()) {
+        _scanner->_topn_threshold->get(&_snapshot);
+    }
+}
+
+Status OlapScanner::TopNBlockFilter::evaluate(const RowBlockV2& block, uint16_t* sel,
+                                              uint16_t* size) {
+    _refresh_snapshot();
+    if (_snapshot.version() == 0) {
+        return Status::OK();
+    }
+    ColumnBlock column = block.column_block(_converter.cid);
+    Tuple* tuple = reinterpret_cast<Tuple*>(_tuple_buf.get());
+    const void* value = tuple->get_slot(_converter.tuple_offset);
+    uint16_t new_size = 0;
+    for (uint16_t i = 0; i < *size; ++i) {
+        uint16_t idx = sel[i];
+        sel[new_size] = idx;
+        if (column.is_null(idx)) {
+            new_size += _snapshot.pass(nullptr);
+            continue;
+        }
+        _convert_cell(_converter, (char*)column.cell_ptr(idx), tuple);
+        new_size += _snapshot.pass(value);
+    }
+    *size = new_size;
+    return Status::OK();
+}
+
+const Conditions* OlapScanner::TopNBlockFilter::zone_map_conditions() {
+    _refresh_snapshot();
+    if (_snapshot.version() == 0) {
+        return nullptr;
+    }
+    if (_conditions_version != _snapshot.version()) {
+        _conditions.finalize();
+        TCondition condition;
+        const TabletColumn& column = _scanner->_tablet->tablet_schema().column(_converter.cid);
+        if (_snapshot.to_condition(column.name(), &condition)) {
+            // the threshold is pruned by zone maps only, it's ignored if it can't be parsed
+            _conditions.append_condition(condition);
+        }
+        _conditions_version = _snapshot.version();
+    }
+    return _conditions.columns().empty() ? nullptr : &_conditions;
+}
+
+OlapScanner::ConjunctBlockFilter::ConjunctBlockFilter(OlapScanner* scanner,
+                                                      std::vector<SlotConverter> converters)
+        : _scanner(scanner),
+          _converters(std::move(converters)),
+          _tuple_buf(new uint8_t[scanner->_tuple_desc->byte_size()]),
+          _row(scanner->_tuple_idx + 1, nullptr) {
+    for (auto& converter : _converters) {
+        _column_ids.push_back(converter.cid);
+    }
+    Tuple* tuple = reinterpret_cast<Tuple*>(_tuple_buf.get());
+    tuple->init(scanner->_tuple_desc->byte_size());
+    _row[scanner->_tuple_idx] = tuple;
+}
+
+Status OlapScanner::ConjunctBlockFilter::evaluate(const RowBlockV2& block, uint16_t* sel,
+                                                  uint16_t* size) {
+    std::vector<ColumnBlock> columns;
+    columns.reserve(_converters.size());
+    for (auto& converter : _converters) {
+        columns.push_back(block.column_block(converter.cid));
+    }
+    Tuple* tuple = _row[_scanner->_tuple_idx];
+    TupleRow* row = reinterpret_cast<TupleRow*>(_row.data());
+    ExprContext* const* ctxs = &_scanner->_conjunct_ctxs[0];
+    int num_ctxs = _scanner->_direct_conjunct_size;
+    uint16_t new_size = 0;
+    for (uint16_t i = 0; i < *size; ++i) {
+        uint16_t idx = sel[i];
+        for (int j = 0; j < _converters.size(); ++j) {
+            if (columns[j].is_null(idx)) {
+                tuple->set_null(_converters[j].null_offset);
+                continue;
+            }
+            tuple->set_not_null(_converters[j].null_offset);
+            _convert_cell(_converters[j], (char*)columns[j].cell_ptr(idx), tuple);
+        }
+        sel[new_size] = idx;
+        new_size += ExecNode::eval_conjuncts(ctxs, num_ctxs, row);
+    }
+    *size = new_size;
     return Status::OK();
 }
 
@@ -138,6 +403,10 @@ Status OlapScanner::_init_params(const std::vector<OlapScanRange*>& key_ranges,
     _params.tablet = _tablet;
     _params.reader_type = READER_QUERY;
     _params.aggregation = _aggregation;
+    // rowsets are merged in the order of keys for a sort limit, or for the merge of
+    // scanners of OlapScanNode with ordered keys
+    _params.read_orderby_key =
+            _sort_limit != -1 || _parent->_olap_scan_node.__isset.num_ordered_keys;
     _params.version = Version(0, _version);
 
     // Condition
@@ -187,6 +456,7 @@ Status OlapScanner::_init_params(const std::vector<OlapScanRange*>& key_ranges,
         return Status::InternalError("failed to initialize storage read row cursor");
     }
     _read_row_cursor.allocate_memory_for_string_type(_tablet->tablet_schema());
+    _init_slot_converters();
 
     // If a agg node is this scan node direct parent
     // we will not call agg object finalize method in scan node,
@@ -236,13 +506,21 @@ Status OlapScanner::_init_return_columns() {
     return Status::OK();
 }
 
-Status OlapScanner::get_batch(RuntimeState* state, RowBatch* batch, bool* eof) {
+Status OlapScanner::get_batch(RuntimeState* state, RowBatch* batch, int max_rows, bool* eof) {
+    if (_push_down_agg) {
+        return _get_push_down_agg_batch(batch, eof);
+    }
+    max_rows = std::max(std::min(max_rows, batch->capacity()), 1);
     // 2. Allocate Row's Tuple buf
-    uint8_t* tuple_buf =
-            batch->tuple_data_pool()->allocate(state->batch_size() * _tuple_desc->byte_size());
-    bzero(tuple_buf, state->batch_size() * _tuple_desc->byte_size());
+    uint8_t* tuple_buf = batch->tuple_data_pool()->allocate(max_rows * _tuple_desc->byte_size());
+    bzero(tuple_buf, max_rows * _tuple_desc->byte_size());
     Tuple* tuple = reinterpret_cast<Tuple*>(tuple_buf);
 
+    if (_topn_slot != nullptr && !_topn_in_storage &&
+        _topn_threshold->version() != _topn_snapshot.version()) {
+        _topn_threshold->get(&_topn_snapshot);
+    }
+
     auto tracker = MemTracker::CreateTracker(state->fragment_mem_tracker()->limit(), "OlapScanner");
     std::unique_ptr<MemPool> mem_pool(new MemPool(tracker.get()));
 
@@ -251,10 +529,15 @@ Status OlapScanner::get_batch(RuntimeState* state, RowBatch* batch, bool* eof) {
         SCOPED_TIMER(_parent->_scan_timer);
         while (true) {
             // Batch is full, break
-            if (batch->is_full()) {
+            if (batch->num_rows() >= max_rows) {
                 _update_realtime_counter();
                 break;
             }
+            // The rows after the first _sort_limit ones in the order of keys are not needed
+            if (_sort_limit != -1 && _num_rows_returned >= _sort_limit) {
+                *eof = true;
+                break;
+            }
             // Read one row from reader
             auto res = _reader->next_row_with_aggregation(&_read_row_cursor, mem_pool.get(),
                                                           batch->agg_object_pool(), eof);
@@ -283,8 +566,23 @@ Status OlapScanner::get_batch(RuntimeState* state, RowBatch* batch, bool* eof) {
             row->set_tuple(_tuple_idx, tuple);
 
             do {
-                // 3.5.1 Using direct conjuncts to filter data
-                if (_eval_conjuncts_fn != nullptr) {
+                // 3.5.0 Drop rows which can't enter the TopN above, if the storage hasn't
+                if (_topn_slot != nullptr && !_topn_in_storage) {
+                    const void* value =
+                            tuple->is_null(_topn_slot->null_indicator_offset())
+                                    ? nullptr
+                                    : tuple->get_slot(_topn_slot->tuple_offset());
+                    if (!_topn_snapshot.pass(value)) {
+                        tuple->init(_tuple_desc->byte_size());
+                        _num_rows_topn_filtered++;
+                        break;
+                    }
+                }
+
+                // 3.5.1 Using direct conjuncts to filter data, if the storage hasn't
+                if (_direct_conjuncts_in_storage) {
+                    // all rows returned by the reader have passed the direct conjuncts
+                } else if (_eval_conjuncts_fn != nullptr) {
                     if (!_eval_conjuncts_fn(&_conjunct_ctxs[0], _direct_conjunct_size, row)) {
                         // check direct conjuncts fail then clear tuple for reuse
                         // make sure to reset null indicators since we're overwriting
@@ -316,13 +614,29 @@ Status OlapScanner::get_batch(RuntimeState* state, RowBatch* batch, bool* eof) {
                     }
                 }
 
-                // Copy string slot
-                for (auto desc : _string_slots) {
-                    StringValue* slot = tuple->get_string_slot(desc->tuple_offset());
-                    if (slot->len != 0) {
-                        uint8_t* v = batch->tuple_data_pool()->allocate(slot->len);
-                        memory_copy(v, slot->ptr, slot->len);
-                        slot->ptr = reinterpret_cast<char*>(v);
+                // Copy string slot, allocate once for all strings of this row. The values
+                // unified by the dictionaries of the scan are not copied.
+                if (!_string_slots.empty()) {
+                    size_t total_len = 0;
+                    for (size_t i = 0; i < _string_slots.size(); ++i) {
+                        StringValue* slot =
+                                tuple->get_string_slot(_string_slots[i]->tuple_offset());
+                        _string_copied[i] = slot->len != 0 && !_unify_string(i, slot);
+                        if (_string_copied[i]) {
+                            total_len += slot->len;
+                        }
+                    }
+                    if (total_len != 0) {
+                        uint8_t* v = batch->tuple_data_pool()->allocate(total_len);
+                        for (size_t i = 0; i < _string_slots.size(); ++i) {
+                            StringValue* slot =
+                                    tuple->get_string_slot(_string_slots[i]->tuple_offset());
+                            if (_string_copied[i]) {
+                                memory_copy(v, slot->ptr, slot->len);
+                                slot->ptr = reinterpret_cast<char*>(v);
+                                v += slot->len;
+                            }
+                        }
                     }
                 }
 
@@ -336,6 +650,7 @@ Status OlapScanner::get_batch(RuntimeState* state, RowBatch* batch, bool* eof) {
 
                 // check direct && pushdown conjuncts success then commit tuple
                 batch->commit_last_row();
+                _num_rows_returned++;
                 char* new_tuple = reinterpret_cast<char*>(tuple);
                 new_tuple += _tuple_desc->byte_size();
                 tuple = reinterpret_cast<Tuple*>(new_tuple);
@@ -368,80 +683,170 @@ Status OlapScanner::get_batch(RuntimeState* state, RowBatch* batch, bool* eof) {
     return Status::OK();
 }
 
-void OlapScanner::_convert_row_to_tuple(Tuple* tuple) {
-    size_t slots_size = _query_slots.size();
-    for (int i = 0; i < slots_size; ++i) {
-        SlotDescriptor* slot_desc = _query_slots[i];
-        auto cid = _return_columns[i];
-        if (_read_row_cursor.is_null(cid)) {
-            tuple->set_null(slot_desc->null_indicator_offset());
-            continue;
-        }
-        char* ptr = (char*)_read_row_cursor.cell_ptr(cid);
-        size_t len = _read_row_cursor.column_size(cid);
-        switch (slot_desc->type().type) {
-        case TYPE_CHAR: {
-            Slice* slice = reinterpret_cast<Slice*>(ptr);
-            StringValue* slot = tuple->get_string_slot(slot_desc->tuple_offset());
-            slot->ptr = slice->data;
-            slot->len = strnlen(slot->ptr, slice->size);
+bool OlapScanner::_unify_string(size_t i, StringValue* value) {
+    if (_string_dict_caches.empty() || !_string_dict_caches[i]->enabled()) {
+        return false;
+    }
+    return _string_dict_caches[i]->unify(value);
+}
+
+Status OlapScanner::_get_push_down_agg_batch(RowBatch* batch, bool* eof) {
+    SCOPED_TIMER(_parent->_scan_timer);
+    // tuples are shared by the rows of a batch and copied to its pool
+    Tuple* zeroed_tuple = nullptr;
+    Tuple* min_tuple = nullptr;
+    Tuple* max_tuple = nullptr;
+    while (!batch->is_full()) {
+        if (_agg_segment_idx >= _agg_segments.size()) {
+            *eof = true;
             break;
         }
-        case TYPE_VARCHAR:
-        case TYPE_OBJECT:
-        case TYPE_HLL: {
-            Slice* slice = reinterpret_cast<Slice*>(ptr);
-            StringValue* slot = tuple->get_string_slot(slot_desc->tuple_offset());
-            slot->ptr = slice->data;
-            slot->len = slice->size;
-            break;
+        const SegmentAggRows& segment = _agg_segments[_agg_segment_idx];
+        int64_t num_rows = segment.num_rows;
+        if (_push_down_agg_type == TPushAggOp::MINMAX) {
+            num_rows = std::min<int64_t>(num_rows, 2);
         }
-        case TYPE_DECIMAL: {
-            DecimalValue* slot = tuple->get_decimal_slot(slot_desc->tuple_offset());
-
-            // TODO(lingbin): should remove this assign, use set member function
-            int64_t int_value = *(int64_t*)(ptr);
-            int32_t frac_value = *(int32_t*)(ptr + sizeof(int64_t));
-            *slot = DecimalValue(int_value, frac_value);
-            break;
+        if (_agg_rows_returned >= num_rows) {
+            ++_agg_segment_idx;
+            _agg_rows_returned = 0;
+            min_tuple = nullptr;
+            max_tuple = nullptr;
+            continue;
         }
-        case TYPE_DECIMALV2: {
-            DecimalV2Value* slot = tuple->get_decimalv2_slot(slot_desc->tuple_offset());
 
-            int64_t int_value = *(int64_t*)(ptr);
-            int32_t frac_value = *(int32_t*)(ptr + sizeof(int64_t));
-            if (!slot->from_olap_decimal(int_value, frac_value)) {
-                tuple->set_null(slot_desc->null_indicator_offset());
+        Tuple* tuple = nullptr;
+        if (segment.min_tuple == nullptr) {
+            if (zeroed_tuple == nullptr) {
+                zeroed_tuple = reinterpret_cast<Tuple*>(
+                        batch->tuple_data_pool()->allocate(_tuple_desc->byte_size()));
+                zeroed_tuple->init(_tuple_desc->byte_size());
             }
-            break;
-        }
-        case TYPE_DATETIME: {
-            DateTimeValue* slot = tuple->get_datetime_slot(slot_desc->tuple_offset());
-            uint64_t value = *reinterpret_cast<uint64_t*>(ptr);
-            if (!slot->from_olap_datetime(value)) {
-                tuple->set_null(slot_desc->null_indicator_offset());
+            tuple = zeroed_tuple;
+        } else if (_agg_rows_returned == 1) {
+            if (max_tuple == nullptr) {
+                max_tuple = segment.max_tuple->deep_copy(*_tuple_desc, batch->tuple_data_pool());
             }
-            break;
-        }
-        case TYPE_DATE: {
-            DateTimeValue* slot = tuple->get_datetime_slot(slot_desc->tuple_offset());
-            uint64_t value = 0;
-            value = *(unsigned char*)(ptr + 2);
-            value <<= 8;
-            value |= *(unsigned char*)(ptr + 1);
-            value <<= 8;
-            value |= *(unsigned char*)(ptr);
-            if (!slot->from_olap_date(value)) {
-                tuple->set_null(slot_desc->null_indicator_offset());
+            tuple = max_tuple;
+        } else {
+            if (min_tuple == nullptr) {
+                min_tuple = segment.min_tuple->deep_copy(*_tuple_desc, batch->tuple_data_pool());
             }
-            break;
+            tuple = min_tuple;
         }
-        default: {
-            void* slot = tuple->get_slot(slot_desc->tuple_offset());
-            memory_copy(slot, ptr, len);
-            break;
+        int row_idx = batch->add_row();
+        batch->get_row(row_idx)->set_tuple(_tuple_idx, tuple);
+        batch->commit_last_row();
+        ++_agg_rows_returned;
+        ++_num_rows_read;
+    }
+    return Status::OK();
+}
+
+void OlapScanner::_init_slot_converters() {
+    _slot_converters.clear();
+    _slot_converters.reserve(_query_slots.size());
+    for (int i = 0; i < _query_slots.size(); ++i) {
+        SlotDescriptor* slot_desc = _query_slots[i];
+        SlotConverter converter;
+        converter.cid = _return_columns[i];
+        converter.type = slot_desc->type().type;
+        converter.tuple_offset = slot_desc->tuple_offset();
+        converter.null_offset = slot_desc->null_indicator_offset();
+        converter.len = _read_row_cursor.column_size(converter.cid);
+        _slot_converters.push_back(converter);
+    }
+}
+
+void OlapScanner::_convert_cell(const SlotConverter& converter, char* ptr, Tuple* tuple) {
+    switch (converter.type) {
+    case TYPE_CHAR: {
+        Slice* slice = reinterpret_cast<Slice*>(ptr);
+        StringValue* slot = tuple->get_string_slot(converter.tuple_offset);
+        slot->ptr = slice->data;
+        slot->len = strnlen(slot->ptr, slice->size);
+        break;
+    }
+    case TYPE_VARCHAR:
+    case TYPE_OBJECT:
+    case TYPE_HLL: {
+        Slice* slice = reinterpret_cast<Slice*>(ptr);
+        StringValue* slot = tuple->get_string_slot(converter.tuple_offset);
+        slot->ptr = slice->data;
+        slot->len = slice->size;
+        break;
+    }
+    case TYPE_DECIMAL: {
+        DecimalValue* slot = tuple->get_decimal_slot(converter.tuple_offset);
+
+        // TODO(lingbin): should remove this assign, use set member function
+        int64_t int_value = *(int64_t*)(ptr);
+        int32_t frac_value = *(int32_t*)(ptr + sizeof(int64_t));
+        *slot = DecimalValue(int_value, frac_value);
+        break;
+    }
+    case TYPE_DECIMALV2: {
+        DecimalV2Value* slot = tuple->get_decimalv2_slot(converter.tuple_offset);
+
+        int64_t int_value = *(int64_t*)(ptr);
+        int32_t frac_value = *(int32_t*)(ptr + sizeof(int64_t));
+        if (!slot->from_olap_decimal(int_value, frac_value)) {
+            tuple->set_null(converter.null_offset);
         }
+        break;
+    }
+    case TYPE_DATETIME: {
+        DateTimeValue* slot = tuple->get_datetime_slot(converter.tuple_offset);
+        uint64_t value = *reinterpret_cast<uint64_t*>(ptr);
+        if (!slot->from_olap_datetime(value)) {
+            tuple->set_null(converter.null_offset);
         }
+        break;
+    }
+    case TYPE_DATE: {
+        DateTimeValue* slot = tuple->get_datetime_slot(converter.tuple_offset);
+        uint64_t value = 0;
+        value = *(unsigned char*)(ptr + 2);
+        value <<= 8;
+        value |= *(unsigned char*)(ptr + 1);
+        value <<= 8;
+        value |= *(unsigned char*)(ptr);
+        if (!slot->from_olap_date(value)) {
+            tuple->set_null(converter.null_offset);
+        }
+        break;
+    }
+    case TYPE_TINYINT:
+    case TYPE_BOOLEAN:
+        *reinterpret_cast<int8_t*>(tuple->get_slot(converter.tuple_offset)) =
+                *reinterpret_cast<int8_t*>(ptr);
+        break;
+    case TYPE_SMALLINT:
+        *reinterpret_cast<int16_t*>(tuple->get_slot(converter.tuple_offset)) =
+                *reinterpret_cast<int16_t*>(ptr);
+        break;
+    case TYPE_INT:
+        *reinterpret_cast<int32_t*>(tuple->get_slot(converter.tuple_offset)) =
+                *reinterpret_cast<int32_t*>(ptr);
+        break;
+    case TYPE_BIGINT:
+        *reinterpret_cast<int64_t*>(tuple->get_slot(converter.tuple_offset)) =
+                *reinterpret_cast<int64_t*>(ptr);
+        break;
+    default: {
+        void* slot = tuple->get_slot(converter.tuple_offset);
+        memory_copy(slot, ptr, converter.len);
+        break;
+    }
+    }
+}
+
+void OlapScanner::_convert_row_to_tuple(Tuple* tuple) {
+    for (const SlotConverter& converter : _slot_converters) {
+        if (_read_row_cursor.is_null(converter.cid)) {
+            tuple->set_null(converter.null_offset);
+            continue;
+        }
+        _convert_cell(converter, (char*)_read_row_cursor.cell_ptr(converter.cid), tuple);
     }
 }
 
@@ -451,6 +856,7 @@ void OlapScanner::update_counter() {
     }
     COUNTER_UPDATE(_rows_read_counter, _num_rows_read);
     COUNTER_UPDATE(_rows_pushed_cond_filtered_counter, _num_rows_pushed_cond_filtered);
+    COUNTER_UPDATE(_rows_topn_filtered_counter, _num_rows_topn_filtered);
 
     COUNTER_UPDATE(_parent->_io_timer, _reader->stats().io_ns);
     COUNTER_UPDATE(_parent->_read_compressed_counter, _reader->stats().compressed_bytes_read);
@@ -471,6 +877,9 @@ void OlapScanner::update_counter() {
     // COUNTER_UPDATE(_parent->_filtered_rows_counter, _reader->stats().num_rows_filtered);
     COUNTER_UPDATE(_parent->_vec_cond_timer, _reader->stats().vec_cond_ns);
     COUNTER_UPDATE(_parent->_rows_vec_cond_counter, _reader->stats().rows_vec_cond_filtered);
+    COUNTER_UPDATE(_parent->_block_filter_timer, _reader->stats().block_filter_ns);
+    COUNTER_UPDATE(_parent->_rows_block_filter_counter,
+                   _reader->stats().rows_block_filter_filtered);
 
     COUNTER_UPDATE(_parent->_stats_filtered_counter, _reader->stats().rows_stats_filtered);
     COUNTER_UPDATE(_parent->_bf_filtered_counter, _reader->stats().rows_bf_filtered);
@@ -484,15 +893,38 @@ void OlapScanner::update_counter() {
 
     COUNTER_UPDATE(_parent->_total_pages_num_counter, _reader->stats().total_pages_num);
     COUNTER_UPDATE(_parent->_cached_pages_num_counter, _reader->stats().cached_pages_num);
+    COUNTER_UPDATE(_parent->_read_ahead_pages_counter, _reader->stats().read_ahead_pages_num);
+    COUNTER_UPDATE(_parent->_read_ahead_wait_timer, _reader->stats().read_ahead_wait_ns);
 
     COUNTER_UPDATE(_parent->_bitmap_index_filter_counter,
                    _reader->stats().rows_bitmap_index_filtered);
     COUNTER_UPDATE(_parent->_bitmap_index_filter_timer, _reader->stats().bitmap_index_filter_timer);
+    COUNTER_UPDATE(_parent->_ngram_index_filter_counter,
+                   _reader->stats().rows_ngram_index_filtered);
+    COUNTER_UPDATE(_parent->_ngram_index_filter_timer, _reader->stats().ngram_index_filter_timer);
+    COUNTER_UPDATE(_parent->_s2_index_filter_counter, _reader->stats().rows_s2_index_filtered);
+    COUNTER_UPDATE(_parent->_s2_index_filter_timer, _reader->stats().s2_index_filter_timer);
     COUNTER_UPDATE(_parent->_block_seek_counter, _reader->stats().block_seek_num);
 
     COUNTER_UPDATE(_parent->_filtered_segment_counter, _reader->stats().filtered_segment_number);
     COUNTER_UPDATE(_parent->_total_segment_counter, _reader->stats().total_segment_number);
 
+    const OlapReaderStatistics& stats = _reader->stats();
+    COUNTER_UPDATE(_parent->_cached_bytes_read_counter, stats.cached_bytes_read);
+    COUNTER_UPDATE(_parent->_file_open_counter, stats.file_open_num);
+    OlapScanNode::DataDirCounters* data_dir_counters =
+            _parent->_data_dir_counters(_tablet->data_dir()->path());
+    COUNTER_UPDATE(data_dir_counters->compressed_bytes_read, _compressed_bytes_read);
+    COUNTER_UPDATE(data_dir_counters->pages_read,
+                   stats.total_pages_num - stats.cached_pages_num);
+    COUNTER_UPDATE(data_dir_counters->io_timer, stats.io_ns);
+    COUNTER_UPDATE(data_dir_counters->file_opens, stats.file_open_num);
+    int64_t pages_read_from_disk = stats.total_pages_num - stats.cached_pages_num;
+    if (pages_read_from_disk > 0) {
+        // the average latency of the reads of the pages
+        _tablet->data_dir()->add_read_latency(stats.io_ns / 1000 / pages_read_from_disk);
+    }
+
     DorisMetrics::instance()->query_scan_bytes->increment(_compressed_bytes_read);
     DorisMetrics::instance()->query_scan_rows->increment(_raw_rows_read);
 
@@ -514,6 +946,34 @@ void OlapScanner::_update_realtime_counter() {
     _reader->mutable_stats()->raw_rows_read = 0;
 }
 
+void OlapScanner::_dump_slow_trace() {
+    int64_t elapsed_ms = _trace_watch.elapsed_time() / 1000 / 1000;
+    if (elapsed_ms <= config::olap_scanner_trace_threshold_ms) {
+        return;
+    }
+    // the page reads and the predicates are counted by the storage, they're added to the
+    // trace only when it's dumped to keep the tracing cheap
+    const OlapReaderStatistics& stats = _reader->stats();
+    TraceMetrics* metrics = _trace->metrics();
+    metrics->Increment("raw_rows_read", _raw_rows_read);
+    metrics->Increment("rows_returned", _num_rows_read);
+    metrics->Increment("compressed_bytes_read", _compressed_bytes_read);
+    metrics->Increment("io_ns", stats.io_ns);
+    metrics->Increment("decompress_ns", stats.decompress_ns);
+    metrics->Increment("total_pages_num", stats.total_pages_num);
+    metrics->Increment("page_cache_miss_num", stats.total_pages_num - stats.cached_pages_num);
+    metrics->Increment("index_load_ns", stats.index_load_ns);
+    metrics->Increment("vec_cond_ns", stats.vec_cond_ns);
+    metrics->Increment("block_filter_ns", stats.block_filter_ns);
+    metrics->Increment("rows_vec_cond_filtered", stats.rows_vec_cond_filtered);
+    metrics->Increment("total_segment_number", stats.total_segment_number);
+    TRACE_TO(_trace, "scanner closed");
+    LOG(WARNING) << "slow olap scanner of tablet " << _tablet->full_name() << ", query "
+                 << print_id(_runtime_state->query_id()) << ", cost " << elapsed_ms
+                 << "ms, trace:" << std::endl
+                 << _trace->DumpToString(Trace::INCLUDE_ALL);
+}
+
 Status OlapScanner::close(RuntimeState* state) {
     if (_is_closed) {
         return Status::OK();
@@ -526,6 +986,9 @@ Status OlapScanner::close(RuntimeState* state) {
     // so that it will core
     _params.rs_readers.clear();
     update_counter();
+    if (_trace != nullptr) {
+        _dump_slow_trace();
+    }
     _reader.reset();
     Expr::close(_conjunct_ctxs, state);
     _is_closed = true;
@@ -27,7 +27,10 @@
 #include "common/status.h"
 #include "exec/exec_node.h"
 #include "exec/olap_common.h"
+#include "exec/scan_string_dict.h"
+#include "exec/topn_threshold.h"
 #include "exprs/expr.h"
+#include "olap/block_filter.h"
 #include "gen_cpp/PaloInternalService_types.h"
 #include "gen_cpp/PlanNodes_types.h"
 #include "olap/delete_handler.h"
@@ -38,6 +41,8 @@
 #include "runtime/descriptors.h"
 #include "runtime/tuple.h"
 #include "runtime/vectorized_row_batch.h"
+#include "util/stopwatch.hpp"
+#include "util/trace.h"
 
 namespace doris {
 
@@ -45,6 +50,7 @@ class OlapScanNode;
 class OLAPReader;
 class RuntimeProfile;
 class Field;
+class WrapperField;
 
 class OlapScanner {
 public:
@@ -59,7 +65,8 @@ public:
 
     Status open();
 
-    Status get_batch(RuntimeState* state, RowBatch* batch, bool* eof);
+    // Fills 'batch' with at most 'max_rows' rows
+    Status get_batch(RuntimeState* state, RowBatch* batch, int max_rows, bool* eof);
 
     Status close(RuntimeState* state);
 
@@ -71,6 +78,7 @@ public:
     void set_id(int id) { _id = id; }
     bool is_open() const { return _is_open; }
     void set_opened() { _is_open = true; }
+    bool is_closed() const { return _is_closed; }
 
     int64_t raw_rows_read() const { return _raw_rows_read; }
 
@@ -78,21 +86,47 @@ public:
 
     const std::string& scan_disk() const { return _tablet->data_dir()->path(); }
 
+    // The trace to adopt while running the scanner, nullptr if it's not traced.
+    Trace* trace() { return _trace.get(); }
+
 private:
     Status _init_params(const std::vector<OlapScanRange*>& key_ranges,
                         const std::vector<TCondition>& filters,
                         const std::vector<TCondition>& is_nulls);
     Status _init_return_columns();
+    // must be called after _read_row_cursor is initialized
+    void _init_slot_converters();
     void _convert_row_to_tuple(Tuple* tuple);
+    // Hand the direct conjuncts to the storage as a block filter if they only
+    // reference a part of the read columns.
+    void _init_conjunct_block_filter();
+    // Resolve the slot of the TopN threshold of _parent, and hand the threshold to the
+    // storage as a block filter on a duplicate keys table.
+    void _init_topn_filter();
+    // Prepare the rows of the aggregation pushed down by FE from the row counts and
+    // zone maps of segments, if all rowsets of the tablet support it.
+    Status _init_push_down_agg();
+    Status _get_push_down_agg_batch(RowBatch* batch, bool* eof);
+    // Unify 'value' of the i-th of _string_slots by the dictionary of the scan, return false
+    // if it needs to be copied.
+    bool _unify_string(size_t i, StringValue* value);
+    // Convert zone map `values' of _slot_converters, return a tuple in _agg_pool.
+    Tuple* _zone_map_to_tuple(const std::vector<std::unique_ptr<WrapperField>>& values);
 
     // Update profile that need to be reported in realtime.
     void _update_realtime_counter();
+    // Log _trace if the scanner has run longer than the threshold.
+    void _dump_slow_trace();
 
     RuntimeState* _runtime_state;
     OlapScanNode* _parent;
     const TupleDescriptor* _tuple_desc; /**< tuple descriptor */
     RuntimeProfile* _profile;
     const std::vector<SlotDescriptor*>& _string_slots;
+    // one for each of _string_slots, empty if the dictionaries of the scan are disabled
+    std::vector<std::unique_ptr<ScanStringDictCache>> _string_dict_caches;
+    // whether the values of _string_slots of the current row are copied
+    std::vector<bool> _string_copied;
 
     std::vector<ExprContext*> _conjunct_ctxs;
 
@@ -119,6 +153,99 @@ private:
 
     std::vector<SlotDescriptor*> _query_slots;
 
+    // Everything _convert_row_to_tuple() needs to know about a query slot,
+    // resolved once instead of for every row.
+    struct SlotConverter {
+        uint32_t cid = 0;
+        PrimitiveType type = INVALID_TYPE;
+        int tuple_offset = 0;
+        NullIndicatorOffset null_offset = NullIndicatorOffset(0, -1);
+        size_t len = 0;
+    };
+    // one for each of _query_slots
+    std::vector<SlotConverter> _slot_converters;
+
+    // Convert the cell at 'ptr', which is not null, to the slot of 'tuple'.
+    static void _convert_cell(const SlotConverter& converter, char* ptr, Tuple* tuple);
+
+    // Evaluates the direct conjuncts on the row blocks read by the storage. The
+    // slots they reference are converted to a scratch tuple, one row at a time.
+    class ConjunctBlockFilter : public BlockFilter {
+    public:
+        ConjunctBlockFilter(OlapScanner* scanner, std::vector<SlotConverter> converters);
+
+        const std::vector<ColumnId>& column_ids() const override { return _column_ids; }
+
+        Status evaluate(const RowBlockV2& block, uint16_t* sel, uint16_t* size) override;
+
+    private:
+        OlapScanner* _scanner;
+        std::vector<SlotConverter> _converters;
+        std::vector<ColumnId> _column_ids;
+        std::unique_ptr<uint8_t[]> _tuple_buf;
+        std::vector<Tuple*> _row;
+    };
+    std::unique_ptr<ConjunctBlockFilter> _conjunct_block_filter;
+    // whether the storage has evaluated the direct conjuncts on all rows it returns
+    bool _direct_conjuncts_in_storage = false;
+
+    // Evaluates the TopN threshold on the row blocks read by the storage, and turns it
+    // into a zone map condition for each segment opened.
+    class TopNBlockFilter : public BlockFilter {
+    public:
+        TopNBlockFilter(OlapScanner* scanner, const SlotConverter& converter);
+
+        const std::vector<ColumnId>& column_ids() const override { return _column_ids; }
+
+        Status evaluate(const RowBlockV2& block, uint16_t* sel, uint16_t* size) override;
+
+        const Conditions* zone_map_conditions() override;
+
+    private:
+        void _refresh_snapshot();
+
+        OlapScanner* _scanner;
+        SlotConverter _converter;
+        std::vector<ColumnId> _column_ids;
+        TopNThreshold::Snapshot _snapshot;
+        std::unique_ptr<uint8_t[]> _tuple_buf;
+        Conditions _conditions;
+        // the version of the threshold _conditions are built from
+        int64_t _conditions_version = 0;
+    };
+    // the threshold of the parent TopNNode of _parent, nullptr if there's none
+    TopNThreshold* _topn_threshold = nullptr;
+    TopNThreshold::Snapshot _topn_snapshot;
+    // the slot the threshold is on, nullptr if the threshold isn't used
+    const SlotDescriptor* _topn_slot = nullptr;
+    std::unique_ptr<TopNBlockFilter> _topn_block_filter;
+    // whether the storage has evaluated the threshold on all rows it returns
+    bool _topn_in_storage = false;
+
+    // Rows are read in the order of keys and the scanner stops after returning
+    // _sort_limit rows, for a TOP-N on a key prefix. -1 if there's no such limit.
+    int64_t _sort_limit = -1;
+    int64_t _num_rows_returned = 0;
+
+    TPushAggOp::type _push_down_agg_type = TPushAggOp::NONE;
+    // whether the rows are answered by _agg_segments instead of _reader
+    bool _push_down_agg = false;
+    // A segment read with pushed down aggregation returns its min tuple, its max tuple,
+    // then the min tuple again until it has returned num_rows rows, or only the first two
+    // for MINMAX. Min and max tuples are nullptr for COUNT, a zeroed tuple is used then.
+    struct SegmentAggRows {
+        int64_t num_rows = 0;
+        Tuple* min_tuple = nullptr;
+        Tuple* max_tuple = nullptr;
+    };
+    std::vector<SegmentAggRows> _agg_segments;
+    size_t _agg_segment_idx = 0;
+    // number of rows of _agg_segments[_agg_segment_idx] returned
+    int64_t _agg_rows_returned = 0;
+    std::shared_ptr<MemTracker> _agg_mem_tracker;
+    // holds min and max tuples of _agg_segments
+    std::unique_ptr<MemPool> _agg_pool;
+
     // time costed and row returned statistics
     ExecNode::EvalConjunctsFn _eval_conjuncts_fn = nullptr;
 
@@ -131,7 +258,16 @@ private:
     // number rows filtered by pushed condition
     int64_t _num_rows_pushed_cond_filtered = 0;
 
+    RuntimeProfile::Counter* _rows_topn_filtered_counter = nullptr;
+    // number rows filtered by the TopN threshold, not counting those of the storage
+    int64_t _num_rows_topn_filtered = 0;
+
     bool _is_closed = false;
+
+    // dumped to the log on close if the scanner runs longer than
+    // config::olap_scanner_trace_threshold_ms since open
+    scoped_refptr<Trace> _trace;
+    MonotonicStopWatch _trace_watch;
 };
 
 } // namespace doris
@@ -17,6 +17,7 @@
 
 #include "exec/orc_scanner.h"
 
+#include "common/config.h"
 #include "exec/broker_reader.h"
 #include "exec/local_file_reader.h"
 #include "exprs/expr.h"
@@ -43,6 +44,15 @@ public:
 
 namespace doris {
 
+namespace {
+
+template <class T>
+int compare(const T& a, const T& b) {
+    return a < b ? -1 : (b < a ? 1 : 0);
+}
+
+} // namespace
+
 class ORCFileStream : public orc::InputStream {
 public:
     ORCFileStream(FileReader* file, std::string filename)
@@ -114,7 +124,7 @@ ORCScanner::ORCScanner(RuntimeState* state, RuntimeProfile* profile,
                        const TBrokerScanRangeParams& params,
                        const std::vector<TBrokerRangeDesc>& ranges,
                        const std::vector<TNetworkAddress>& broker_addresses,
-                       ScannerCounter* counter)
+                       ScannerCounter* counter, const std::vector<ExprContext*>& conjunct_ctxs)
         : BaseScanner(state, profile, params, counter),
           _ranges(ranges),
           _broker_addresses(broker_addresses),
@@ -125,7 +135,8 @@ ORCScanner::ORCScanner(RuntimeState* state, RuntimeProfile* profile,
           _total_groups(0),
           _current_group(0),
           _rows_of_group(0),
-          _current_line_of_group(0) {}
+          _current_line_of_group(0),
+          _conjunct_ctxs(conjunct_ctxs) {}
 
 ORCScanner::~ORCScanner() {
     close();
@@ -145,6 +156,10 @@ Status ORCScanner::open() {
         }
         _row_reader_options.include(include_cols);
     }
+    _stripes_skipped_counter = ADD_COUNTER(_profile, "StripesSkipped", TUnit::UNIT);
+    if (config::enable_orc_stripe_filter) {
+        init_file_column_predicates(_conjunct_ctxs, &_predicates);
+    }
 
     return Status::OK();
 }
@@ -164,10 +179,22 @@ Status ORCScanner::get_next(Tuple* tuple, MemPool* tuple_pool, bool* eof) {
                 }
             }
             if (_current_line_of_group >= _rows_of_group) { // read next stripe
-                if (_current_group >= _total_groups) {
+                int next_group = _current_group;
+                while (next_group < _total_groups && stripe_filtered(next_group)) {
+                    // the rows of the skipped stripes don't match the conjuncts
+                    COUNTER_UPDATE(_stripes_skipped_counter, 1);
+                    _counter->num_rows_unselected +=
+                            _reader->getStripe(next_group)->getNumberOfRows();
+                    ++next_group;
+                }
+                if (next_group >= _total_groups) {
                     _cur_file_eof = true;
                     continue;
                 }
+                if (next_group != _current_group) {
+                    _row_reader->seekToRow(_first_row_of_group[next_group]);
+                    _current_group = next_group;
+                }
                 _rows_of_group = _reader->getStripe(_current_group)->getNumberOfRows();
                 _batch = _row_reader->createRowBatch(_rows_of_group);
                 _row_reader->next(*_batch.get());
@@ -431,10 +458,95 @@ Status ORCScanner::open_next_reader() {
                                  _row_reader->getSelectedType().getFieldName(i));
             _position_in_orc_original.at(std::distance(include_cols.begin(), pos)) = orc_index++;
         }
+
+        _orc_column_ids.assign(_num_of_columns_from_file, 0);
+        _orc_column_kinds.assign(_num_of_columns_from_file, orc::STRUCT);
+        const orc::Type& type = _reader->getType();
+        for (int i = 0; i < type.getSubtypeCount(); ++i) {
+            auto pos = std::find(include_cols.begin(), include_cols.end(), type.getFieldName(i));
+            if (pos != include_cols.end()) {
+                int index = std::distance(include_cols.begin(), pos);
+                _orc_column_ids[index] = type.getSubtype(i)->getColumnId();
+                _orc_column_kinds[index] = type.getSubtype(i)->getKind();
+            }
+        }
+        _first_row_of_group.clear();
+        uint64_t first_row = 0;
+        for (int i = 0; i < _total_groups; ++i) {
+            _first_row_of_group.push_back(first_row);
+            first_row += _reader->getStripe(i)->getNumberOfRows();
+        }
         return Status::OK();
     }
 }
 
+bool ORCScanner::stripe_filtered(int stripe) {
+    if (_predicates.empty() || stripe >= _reader->getNumberOfStripeStatistics()) {
+        return false;
+    }
+    std::unique_ptr<orc::StripeStatistics> stripe_stats = _reader->getStripeStatistics(stripe);
+    for (auto& pred : _predicates) {
+        if (pred.column >= _num_of_columns_from_file) {
+            continue;
+        }
+        const orc::ColumnStatistics* stats =
+                stripe_stats->getColumnStatistics(_orc_column_ids[pred.column]);
+        if (stats == nullptr || (stats->hasNull() && !pred.nullable)) {
+            continue;
+        }
+        if (stats->getNumberOfValues() == 0) {
+            // a comparison with a null doesn't match
+            if (stats->hasNull()) {
+                return true;
+            }
+            continue;
+        }
+        // Only the columns whose values keep their order when they're converted to the dest
+        // type are compared, see get_next().
+        int cmp_min = 0;
+        int cmp_max = 0;
+        auto int_stats = dynamic_cast<const orc::IntegerColumnStatistics*>(stats);
+        auto date_stats = dynamic_cast<const orc::DateColumnStatistics*>(stats);
+        auto string_stats = dynamic_cast<const orc::StringColumnStatistics*>(stats);
+        if (int_stats != nullptr && pred.type != TYPE_DATE && pred.type != TYPE_DATETIME &&
+            pred.type != TYPE_VARCHAR) {
+            if (!int_stats->hasMinimum() || !int_stats->hasMaximum()) {
+                continue;
+            }
+            cmp_min = compare(int_stats->getMinimum(), pred.int_value);
+            cmp_max = compare(int_stats->getMaximum(), pred.int_value);
+        } else if (date_stats != nullptr &&
+                   (pred.type == TYPE_DATE || pred.type == TYPE_DATETIME)) {
+            DateTimeValue min_value;
+            DateTimeValue max_value;
+            if (!date_stats->hasMinimum() || !date_stats->hasMaximum() ||
+                !min_value.from_unixtime((int64_t)date_stats->getMinimum() * 24 * 60 * 60,
+                                         "UTC") ||
+                !max_value.from_unixtime((int64_t)date_stats->getMaximum() * 24 * 60 * 60,
+                                         "UTC")) {
+                continue;
+            }
+            min_value.cast_to_date();
+            max_value.cast_to_date();
+            cmp_min = compare(min_value, pred.date_value);
+            cmp_max = compare(max_value, pred.date_value);
+        } else if (string_stats != nullptr && pred.type == TYPE_VARCHAR &&
+                   _orc_column_kinds[pred.column] != orc::CHAR) { // char values are padded
+            if (!string_stats->hasMinimum() || !string_stats->hasMaximum()) {
+                continue;
+            }
+            cmp_min = string_stats->getMinimum().compare(pred.string_value);
+            cmp_max = string_stats->getMaximum().compare(pred.string_value);
+        } else {
+            continue;
+        }
+        if (!pred.may_match(cmp_min, cmp_max)) {
+            return true;
+        }
+    }
+    return false;
+}
+
 void ORCScanner::close() {
     _batch = nullptr;
     _reader.reset(nullptr);
@@ -29,7 +29,8 @@ class ORCScanner : public BaseScanner {
 public:
     ORCScanner(RuntimeState* state, RuntimeProfile* profile, const TBrokerScanRangeParams& params,
                const std::vector<TBrokerRangeDesc>& ranges,
-               const std::vector<TNetworkAddress>& broker_addresses, ScannerCounter* counter);
+               const std::vector<TNetworkAddress>& broker_addresses, ScannerCounter* counter,
+               const std::vector<ExprContext*>& conjunct_ctxs = std::vector<ExprContext*>());
 
     ~ORCScanner() override;
 
@@ -46,6 +47,10 @@ private:
     // Read next buffer from reader
     Status open_next_reader();
 
+    // Whether the statistics of stripe 'stripe' show that none of its rows matches one of
+    // the predicates.
+    bool stripe_filtered(int stripe);
+
 private:
     const std::vector<TBrokerRangeDesc>& _ranges;
     const std::vector<TNetworkAddress>& _broker_addresses;
@@ -65,6 +70,16 @@ private:
     // so we need to record the index in the original order to correspond the column names to the order
     std::vector<int> _position_in_orc_original;
     int _num_of_columns_from_file;
+    // the column id and kind in the orc file of each column read from it
+    std::vector<uint64_t> _orc_column_ids;
+    std::vector<orc::TypeKind> _orc_column_kinds;
+    // the first row of each stripe
+    std::vector<uint64_t> _first_row_of_group;
+
+    // the conjuncts of the scan node, evaluated on the dest tuples
+    std::vector<ExprContext*> _conjunct_ctxs;
+    std::vector<FileColumnPredicate> _predicates;
+    RuntimeProfile::Counter* _stripes_skipped_counter = nullptr;
 
     int _total_groups; // groups in a orc file
     int _current_group;
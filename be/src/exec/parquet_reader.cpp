@@ -20,7 +20,10 @@
 #include <arrow/status.h>
 #include <time.h>
 
+#include <algorithm>
+
 #include "common/logging.h"
+#include "exec/base_scanner.h"
 #include "exec/file_reader.h"
 #include "gen_cpp/PaloBrokerService_types.h"
 #include "gen_cpp/TPaloBrokerService.h"
@@ -36,13 +39,42 @@ namespace doris {
 
 // Broker
 
-ParquetReaderWrap::ParquetReaderWrap(FileReader* file_reader, int32_t num_of_columns_from_file)
+namespace {
+
+// Writes a DATE32 value, the days since the epoch, as a date string and returns its length.
+int32_t format_date32(int32_t days, uint8_t* buf) {
+    time_t timestamp = (time_t)((int64_t)days * 24 * 60 * 60);
+    struct tm local;
+    localtime_r(&timestamp, &local);
+    return (int32_t)strftime(reinterpret_cast<char*>(buf), 64, "%Y-%m-%d", &local);
+}
+
+template <class T>
+int compare(const T& a, const T& b) {
+    return a < b ? -1 : (b < a ? 1 : 0);
+}
+
+int compare(const parquet::ByteArray& a, const std::string& b) {
+    int ret = memcmp(a.ptr, b.data(), std::min<size_t>(a.len, b.size()));
+    return ret != 0 ? ret : compare<size_t>(a.len, b.size());
+}
+
+bool is_int_type(PrimitiveType type) {
+    return type == TYPE_TINYINT || type == TYPE_SMALLINT || type == TYPE_INT ||
+           type == TYPE_BIGINT;
+}
+
+} // namespace
+
+ParquetReaderWrap::ParquetReaderWrap(FileReader* file_reader, int32_t num_of_columns_from_file,
+                                     const std::vector<FileColumnPredicate>* predicates)
         : _num_of_columns_from_file(num_of_columns_from_file),
           _total_groups(0),
           _current_group(0),
           _rows_of_group(0),
           _current_line_of_group(0),
-          _current_line_of_batch(0) {
+          _current_line_of_batch(0),
+          _predicates(predicates) {
     _parquet = std::shared_ptr<ParquetFile>(new ParquetFile(file_reader));
     _properties = parquet::ReaderProperties();
     _properties.enable_buffered_stream();
@@ -70,7 +102,6 @@ Status ParquetReaderWrap::init_parquet_reader(const std::vector<SlotDescriptor*>
         if (_total_groups == 0) {
             return Status::EndOfFile("Empty Parquet File");
         }
-        _rows_of_group = _file_metadata->RowGroup(0)->num_rows();
 
         // map
         auto* schemaDescriptor = _file_metadata->schema();
@@ -87,6 +118,11 @@ Status ParquetReaderWrap::init_parquet_reader(const std::vector<SlotDescriptor*>
 
         if (_current_line_of_group == 0) { // the first read
             RETURN_IF_ERROR(column_indices(tuple_slot_descs));
+            _current_group = next_row_group(0);
+            if (_current_group >= _total_groups) {
+                return Status::EndOfFile("All row groups are skipped");
+            }
+            _rows_of_group = _file_metadata->RowGroup(_current_group)->num_rows();
             // read batch
             arrow::Status status = _reader->GetRecordBatchReader({_current_group},
                                                                  _parquet_column_ids, &_rb_batch);
@@ -177,7 +213,7 @@ Status ParquetReaderWrap::read_record_batch(const std::vector<SlotDescriptor*>&
                 << " current line of group:" << _current_line_of_group
                 << " is larger than rows group size:" << _rows_of_group
                 << ". start to read next row group";
-        _current_group++;
+        _current_group = next_row_group(_current_group + 1);
         if (_current_group >= _total_groups) { // read completed.
             _parquet_column_ids.clear();
             *eof = true;
@@ -211,6 +247,97 @@ Status ParquetReaderWrap::read_record_batch(const std::vector<SlotDescriptor*>&
     return Status::OK();
 }
 
+int ParquetReaderWrap::next_row_group(int group) {
+    while (group < _total_groups && row_group_filtered(group)) {
+        ++_row_groups_skipped;
+        _rows_skipped += _file_metadata->RowGroup(group)->num_rows();
+        ++group;
+    }
+    return group;
+}
+
+bool ParquetReaderWrap::row_group_filtered(int group) {
+    if (_predicates == nullptr || _predicates->empty()) {
+        return false;
+    }
+    try {
+        auto group_meta = _file_metadata->RowGroup(group);
+        for (auto& pred : *_predicates) {
+            if (pred.column >= _parquet_column_ids.size()) {
+                continue;
+            }
+            auto column_meta = group_meta->ColumnChunk(_parquet_column_ids[pred.column]);
+            if (!column_meta->is_stats_set()) {
+                continue;
+            }
+            auto stats = column_meta->statistics();
+            if (stats == nullptr || (stats->null_count() > 0 && !pred.nullable)) {
+                continue;
+            }
+            if (!stats->HasMinMax()) {
+                // a comparison with a null doesn't match
+                if (stats->null_count() == group_meta->num_rows()) {
+                    return true;
+                }
+                continue;
+            }
+            // Only the columns whose values keep their order when they're converted to the
+            // dest type are compared, see read().
+            const parquet::ColumnDescriptor* column = column_meta->descr();
+            parquet::ConvertedType::type converted_type = column->converted_type();
+            int cmp_min = 0;
+            int cmp_max = 0;
+            if (column->physical_type() == parquet::Type::INT32 && is_int_type(pred.type) &&
+                (converted_type == parquet::ConvertedType::NONE ||
+                 converted_type == parquet::ConvertedType::INT_8 ||
+                 converted_type == parquet::ConvertedType::INT_16 ||
+                 converted_type == parquet::ConvertedType::INT_32)) {
+                auto typed_stats = std::static_pointer_cast<parquet::Int32Statistics>(stats);
+                cmp_min = compare<int64_t>(typed_stats->min(), pred.int_value);
+                cmp_max = compare<int64_t>(typed_stats->max(), pred.int_value);
+            } else if (column->physical_type() == parquet::Type::INT64 &&
+                       is_int_type(pred.type) &&
+                       (converted_type == parquet::ConvertedType::NONE ||
+                        converted_type == parquet::ConvertedType::INT_64)) {
+                auto typed_stats = std::static_pointer_cast<parquet::Int64Statistics>(stats);
+                cmp_min = compare<int64_t>(typed_stats->min(), pred.int_value);
+                cmp_max = compare<int64_t>(typed_stats->max(), pred.int_value);
+            } else if (column->physical_type() == parquet::Type::INT32 &&
+                       converted_type == parquet::ConvertedType::DATE &&
+                       (pred.type == TYPE_DATE || pred.type == TYPE_DATETIME)) {
+                auto typed_stats = std::static_pointer_cast<parquet::Int32Statistics>(stats);
+                uint8_t buf[64];
+                DateTimeValue min_value;
+                DateTimeValue max_value;
+                if (!min_value.from_date_str(reinterpret_cast<char*>(buf),
+                                             format_date32(typed_stats->min(), buf)) ||
+                    !max_value.from_date_str(reinterpret_cast<char*>(buf),
+                                             format_date32(typed_stats->max(), buf))) {
+                    continue;
+                }
+                cmp_min = compare(min_value, pred.date_value);
+                cmp_max = compare(max_value, pred.date_value);
+            } else if (column->physical_type() == parquet::Type::BYTE_ARRAY &&
+                       pred.type == TYPE_VARCHAR &&
+                       (converted_type == parquet::ConvertedType::NONE ||
+                        converted_type == parquet::ConvertedType::UTF8)) {
+                auto typed_stats = std::static_pointer_cast<parquet::ByteArrayStatistics>(stats);
+                cmp_min = compare(typed_stats->min(), pred.string_value);
+                cmp_max = compare(typed_stats->max(), pred.string_value);
+            } else {
+                continue;
+            }
+            if (!pred.may_match(cmp_min, cmp_max)) {
+                return true;
+            }
+        }
+    } catch (parquet::ParquetException& e) {
+        LOG(WARNING) << "Failed to read the statistics of row group " << group << ": "
+                     << e.what();
+    }
+    return false;
+}
+
 Status ParquetReaderWrap::handle_timestamp(const std::shared_ptr<arrow::TimestampArray>& ts_array,
                                            uint8_t* buf, int32_t* wbytes) {
     const auto type = std::dynamic_pointer_cast<arrow::TimestampType>(ts_array->type());
@@ -472,12 +599,7 @@ Status ParquetReaderWrap::read(Tuple* tuple, const std::vector<SlotDescriptor*>&
                 if (ts_array->IsNull(_current_line_of_batch)) {
                     RETURN_IF_ERROR(set_field_null(tuple, slot_desc));
                 } else {
-                    time_t timestamp = (time_t)((int64_t)ts_array->Value(_current_line_of_batch) *
-                                                24 * 60 * 60);
-                    struct tm local;
-                    localtime_r(&timestamp, &local);
-                    char* to = reinterpret_cast<char*>(&tmp_buf);
-                    wbytes = (uint32_t)strftime(to, 64, "%Y-%m-%d", &local);
+                    wbytes = format_date32(ts_array->Value(_current_line_of_batch), tmp_buf);
                     fill_slot(tuple, slot_desc, mem_pool, tmp_buf, wbytes);
                 }
                 break;
@@ -31,6 +31,7 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
 #include "common/status.h"
 #include "gen_cpp/PaloBrokerService_types.h"
@@ -47,6 +48,7 @@ class Tuple;
 class SlotDescriptor;
 class MemPool;
 class FileReader;
+struct FileColumnPredicate;
 
 class ParquetFile : public arrow::io::RandomAccessFile {
 public:
@@ -69,7 +71,8 @@ private:
 // Reader of broker parquet file
 class ParquetReaderWrap {
 public:
-    ParquetReaderWrap(FileReader* file_reader, int32_t num_of_columns_from_file);
+    ParquetReaderWrap(FileReader* file_reader, int32_t num_of_columns_from_file,
+                      const std::vector<FileColumnPredicate>* predicates = nullptr);
     virtual ~ParquetReaderWrap();
 
     // Read
@@ -80,6 +83,10 @@ public:
     Status init_parquet_reader(const std::vector<SlotDescriptor*>& tuple_slot_descs,
                                const std::string& timezone);
 
+    // The row groups skipped by the predicates and their rows.
+    int row_groups_skipped() const { return _row_groups_skipped; }
+    int64_t rows_skipped() const { return _rows_skipped; }
+
 private:
     void fill_slot(Tuple* tuple, SlotDescriptor* slot_desc, MemPool* mem_pool, const uint8_t* value,
                    int32_t len);
@@ -88,6 +95,11 @@ private:
     Status read_record_batch(const std::vector<SlotDescriptor*>& tuple_slot_descs, bool* eof);
     Status handle_timestamp(const std::shared_ptr<arrow::TimestampArray>& ts_array, uint8_t* buf,
                             int32_t* wbtyes);
+    // The first row group from 'group' on that isn't skipped, _total_groups if there is none.
+    int next_row_group(int group);
+    // Whether the statistics of row group 'group' show that none of its rows matches one
+    // of the predicates.
+    bool row_group_filtered(int group);
 
 private:
     const int32_t _num_of_columns_from_file;
@@ -110,6 +122,11 @@ private:
     int _current_line_of_batch;
 
     std::string _timezone;
+
+    // Not owned, nullptr if there are none.
+    const std::vector<FileColumnPredicate>* _predicates;
+    int _row_groups_skipped = 0;
+    int64_t _rows_skipped = 0;
 };
 
 } // namespace doris
@@ -17,6 +17,7 @@
 
 #include "exec/parquet_scanner.h"
 
+#include "common/config.h"
 #include "exec/broker_reader.h"
 #include "exec/buffered_reader.h"
 #include "exec/decompressor.h"
@@ -38,7 +39,8 @@ ParquetScanner::ParquetScanner(RuntimeState* state, RuntimeProfile* profile,
                                const TBrokerScanRangeParams& params,
                                const std::vector<TBrokerRangeDesc>& ranges,
                                const std::vector<TNetworkAddress>& broker_addresses,
-                               ScannerCounter* counter)
+                               ScannerCounter* counter,
+                               const std::vector<ExprContext*>& conjunct_ctxs)
         : BaseScanner(state, profile, params, counter),
           _ranges(ranges),
           _broker_addresses(broker_addresses),
@@ -46,14 +48,20 @@ ParquetScanner::ParquetScanner(RuntimeState* state, RuntimeProfile* profile,
           _cur_file_reader(nullptr),
           _next_range(0),
           _cur_file_eof(false),
-          _scanner_eof(false) {}
+          _scanner_eof(false),
+          _conjunct_ctxs(conjunct_ctxs) {}
 
 ParquetScanner::~ParquetScanner() {
     close();
 }
 
 Status ParquetScanner::open() {
-    return BaseScanner::open();
+    RETURN_IF_ERROR(BaseScanner::open());
+    _row_groups_skipped_counter = ADD_COUNTER(_profile, "RowGroupsSkipped", TUnit::UNIT);
+    if (config::enable_parquet_row_group_filter) {
+        init_file_column_predicates(_conjunct_ctxs, &_predicates);
+    }
+    return Status::OK();
 }
 
 Status ParquetScanner::get_next(Tuple* tuple, MemPool* tuple_pool, bool* eof) {
@@ -93,15 +101,7 @@ Status ParquetScanner::get_next(Tuple* tuple, MemPool* tuple_pool, bool* eof) {
 
 Status ParquetScanner::open_next_reader() {
     // open_file_reader
-    if (_cur_file_reader != nullptr) {
-        if (_stream_load_pipe != nullptr) {
-            _stream_load_pipe.reset();
-            _cur_file_reader = nullptr;
-        } else {
-            delete _cur_file_reader;
-            _cur_file_reader = nullptr;
-        }
-    }
+    close_reader();
 
     while (true) {
         if (_next_range >= _ranges.size()) {
@@ -149,15 +149,17 @@ Status ParquetScanner::open_next_reader() {
             continue;
         }
         if (range.__isset.num_of_columns_from_file) {
-            _cur_file_reader =
-                    new ParquetReaderWrap(file_reader.release(), range.num_of_columns_from_file);
+            _cur_file_reader = new ParquetReaderWrap(
+                    file_reader.release(), range.num_of_columns_from_file, &_predicates);
         } else {
-            _cur_file_reader = new ParquetReaderWrap(file_reader.release(), _src_slot_descs.size());
+            _cur_file_reader = new ParquetReaderWrap(file_reader.release(),
+                                                     _src_slot_descs.size(), &_predicates);
         }
 
         Status status = _cur_file_reader->init_parquet_reader(_src_slot_descs, _state->timezone());
 
         if (status.is_end_of_file()) {
+            close_reader();
             continue;
         } else {
             if (!status.ok()) {
@@ -172,7 +174,14 @@ Status ParquetScanner::open_next_reader() {
 }
 
 void ParquetScanner::close() {
+    close_reader();
+}
+
+void ParquetScanner::close_reader() {
     if (_cur_file_reader != nullptr) {
+        // the rows of the skipped row groups don't match the conjuncts
+        COUNTER_UPDATE(_row_groups_skipped_counter, _cur_file_reader->row_groups_skipped());
+        _counter->num_rows_unselected += _cur_file_reader->rows_skipped();
         if (_stream_load_pipe != nullptr) {
             _stream_load_pipe.reset();
             _cur_file_reader = nullptr;
@@ -25,6 +25,7 @@
 
 #include "common/status.h"
 #include "exec/base_scanner.h"
+#include "exec/parquet_reader.h"
 #include "gen_cpp/PlanNodes_types.h"
 #include "gen_cpp/Types_types.h"
 #include "runtime/mem_pool.h"
@@ -36,7 +37,6 @@ namespace doris {
 class Tuple;
 class SlotDescriptor;
 class Slice;
-class ParquetReaderWrap;
 class RuntimeState;
 class ExprContext;
 class TupleDescriptor;
@@ -51,7 +51,8 @@ public:
     ParquetScanner(RuntimeState* state, RuntimeProfile* profile,
                    const TBrokerScanRangeParams& params,
                    const std::vector<TBrokerRangeDesc>& ranges,
-                   const std::vector<TNetworkAddress>& broker_addresses, ScannerCounter* counter);
+                   const std::vector<TNetworkAddress>& broker_addresses, ScannerCounter* counter,
+                   const std::vector<ExprContext*>& conjunct_ctxs = std::vector<ExprContext*>());
     ~ParquetScanner();
 
     // Open this scanner, will initialize information need to
@@ -67,6 +68,9 @@ private:
     // Read next buffer from reader
     Status open_next_reader();
 
+    // Closes the current reader and counts the rows it skipped.
+    void close_reader();
+
 private:
     //const TBrokerScanRangeParams& _params;
     const std::vector<TBrokerRangeDesc>& _ranges;
@@ -78,6 +82,11 @@ private:
     bool _cur_file_eof; // is read over?
     bool _scanner_eof;
 
+    // the conjuncts of the scan node, evaluated on the dest tuples
+    std::vector<ExprContext*> _conjunct_ctxs;
+    std::vector<FileColumnPredicate> _predicates;
+    RuntimeProfile::Counter* _row_groups_skipped_counter = nullptr;
+
     // used to hold current StreamLoadPipe
     std::shared_ptr<StreamLoadPipe> _stream_load_pipe;
 };
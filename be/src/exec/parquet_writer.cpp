@@ -23,15 +23,25 @@
 
 #include "common/logging.h"
 #include "exec/file_writer.h"
+#include "exprs/expr.h"
+#include "exprs/expr_context.h"
 #include "gen_cpp/PaloBrokerService_types.h"
 #include "gen_cpp/TPaloBrokerService.h"
 #include "runtime/broker_mgr.h"
 #include "runtime/client_cache.h"
+#include "runtime/datetime_value.h"
+#include "runtime/decimal_value.h"
+#include "runtime/decimalv2_value.h"
 #include "runtime/descriptors.h"
 #include "runtime/exec_env.h"
+#include "runtime/large_int_value.h"
 #include "runtime/mem_pool.h"
+#include "runtime/row_batch.h"
+#include "runtime/string_value.h"
 #include "runtime/tuple.h"
+#include "runtime/tuple_row.h"
 #include "util/thrift_util.h"
+#include "util/types.h"
 
 namespace doris {
 
@@ -60,6 +70,9 @@ arrow::Status ParquetOutputStream::Tell(int64_t* position) const {
 }
 
 arrow::Status ParquetOutputStream::Close() {
+    if (_is_closed) {
+        return arrow::Status::OK();
+    }
     Status st = _file_writer->close();
     if (!st.ok()) {
         return arrow::Status::IOError(st.get_error_msg());
@@ -68,21 +81,219 @@ arrow::Status ParquetOutputStream::Close() {
     return arrow::Status::OK();
 }
 
+#define RETURN_IF_ARROW_ERROR(stmt, msg)                        \
+    do {                                                        \
+        arrow::Status _status_ = (stmt);                        \
+        if (UNLIKELY(!_status_.ok())) {                         \
+            LOG(WARNING) << msg << ": " << _status_.ToString(); \
+            return Status::InternalError(_status_.ToString());  \
+        }                                                       \
+    } while (false)
+
+// The buffered rows are written as a row group once they reach this size
+static const int64_t ROW_GROUP_BUFFER_BYTES = 64 * 1024 * 1024;
+
 /// ParquetWriterWrapper
 ParquetWriterWrapper::ParquetWriterWrapper(FileWriter* file_writer,
                                            const std::vector<ExprContext*>& output_expr_ctxs)
-        : _output_expr_ctxs(output_expr_ctxs) {
-    // TODO(cmy): implement
-    _outstream = new ParquetOutputStream(file_writer);
+        : _outstream(new ParquetOutputStream(file_writer)), _output_expr_ctxs(output_expr_ctxs) {}
+
+Status ParquetWriterWrapper::init() {
+    std::vector<std::shared_ptr<arrow::Field>> fields;
+    arrow::MemoryPool* pool = arrow::default_memory_pool();
+    for (int i = 0; i < _output_expr_ctxs.size(); ++i) {
+        std::shared_ptr<arrow::DataType> type;
+        switch (_output_expr_ctxs[i]->root()->type().type) {
+        case TYPE_BOOLEAN:
+            type = arrow::boolean();
+            _builders.emplace_back(new arrow::BooleanBuilder(pool));
+            break;
+        case TYPE_TINYINT:
+            type = arrow::int8();
+            _builders.emplace_back(new arrow::Int8Builder(pool));
+            break;
+        case TYPE_SMALLINT:
+            type = arrow::int16();
+            _builders.emplace_back(new arrow::Int16Builder(pool));
+            break;
+        case TYPE_INT:
+            type = arrow::int32();
+            _builders.emplace_back(new arrow::Int32Builder(pool));
+            break;
+        case TYPE_BIGINT:
+            type = arrow::int64();
+            _builders.emplace_back(new arrow::Int64Builder(pool));
+            break;
+        case TYPE_FLOAT:
+            type = arrow::float32();
+            _builders.emplace_back(new arrow::FloatBuilder(pool));
+            break;
+        case TYPE_DOUBLE:
+            type = arrow::float64();
+            _builders.emplace_back(new arrow::DoubleBuilder(pool));
+            break;
+        default:
+            type = arrow::utf8();
+            _builders.emplace_back(new arrow::StringBuilder(pool));
+            break;
+        }
+        fields.push_back(arrow::field("col" + std::to_string(i), type, true));
+    }
+    _schema = arrow::schema(fields);
+
+    std::shared_ptr<parquet::WriterProperties> properties =
+            parquet::WriterProperties::Builder().compression(parquet::Compression::SNAPPY)->build();
+    RETURN_IF_ARROW_ERROR(
+            parquet::arrow::FileWriter::Open(*_schema, pool, _outstream, properties, &_writer),
+            "open parquet writer failed");
+    return Status::OK();
 }
 
 Status ParquetWriterWrapper::write(const RowBatch& row_batch) {
-    // TODO(cmy): implement
+    int num_rows = row_batch.num_rows();
+    for (int row_idx = 0; row_idx < num_rows; ++row_idx) {
+        TupleRow* row = row_batch.get_row(row_idx);
+        for (int i = 0; i < _output_expr_ctxs.size(); ++i) {
+            RETURN_IF_ERROR(_append_value(i, _output_expr_ctxs[i]->get_value(row)));
+        }
+    }
+    _buffered_rows += num_rows;
+    if (_buffered_bytes >= ROW_GROUP_BUFFER_BYTES) {
+        RETURN_IF_ERROR(_flush());
+    }
+    return Status::OK();
+}
+
+Status ParquetWriterWrapper::_append_value(int i, void* item) {
+    arrow::ArrayBuilder* builder = _builders[i].get();
+    if (item == nullptr) {
+        RETURN_IF_ARROW_ERROR(builder->AppendNull(), "append parquet value failed");
+        return Status::OK();
+    }
+
+    const Expr* expr = _output_expr_ctxs[i]->root();
+    arrow::Status st;
+    switch (expr->type().type) {
+    case TYPE_BOOLEAN:
+        st = static_cast<arrow::BooleanBuilder*>(builder)->Append(*static_cast<bool*>(item));
+        _buffered_bytes += 1;
+        break;
+    case TYPE_TINYINT:
+        st = static_cast<arrow::Int8Builder*>(builder)->Append(*static_cast<int8_t*>(item));
+        _buffered_bytes += 1;
+        break;
+    case TYPE_SMALLINT:
+        st = static_cast<arrow::Int16Builder*>(builder)->Append(*static_cast<int16_t*>(item));
+        _buffered_bytes += 2;
+        break;
+    case TYPE_INT:
+        st = static_cast<arrow::Int32Builder*>(builder)->Append(*static_cast<int32_t*>(item));
+        _buffered_bytes += 4;
+        break;
+    case TYPE_BIGINT:
+        st = static_cast<arrow::Int64Builder*>(builder)->Append(*static_cast<int64_t*>(item));
+        _buffered_bytes += 8;
+        break;
+    case TYPE_FLOAT:
+        st = static_cast<arrow::FloatBuilder*>(builder)->Append(*static_cast<float*>(item));
+        _buffered_bytes += 4;
+        break;
+    case TYPE_DOUBLE:
+        st = static_cast<arrow::DoubleBuilder*>(builder)->Append(*static_cast<double*>(item));
+        _buffered_bytes += 8;
+        break;
+    default: {
+        arrow::StringBuilder* string_builder = static_cast<arrow::StringBuilder*>(builder);
+        char buf[64];
+        const char* ptr = buf;
+        int len = 0;
+        std::string str;
+        switch (expr->type().type) {
+        case TYPE_LARGEINT:
+            len = sizeof(buf);
+            ptr = LargeIntValue::to_string(reinterpret_cast<PackedInt128*>(item)->value, buf,
+                                           &len);
+            break;
+        case TYPE_DATE:
+        case TYPE_DATETIME:
+            len = static_cast<const DateTimeValue*>(item)->to_string(buf) - buf - 1;
+            break;
+        case TYPE_VARCHAR:
+        case TYPE_CHAR: {
+            const StringValue* string_val = static_cast<const StringValue*>(item);
+            ptr = string_val->ptr;
+            len = string_val->len;
+            break;
+        }
+        case TYPE_DECIMAL: {
+            const DecimalValue* decimal_val = static_cast<const DecimalValue*>(item);
+            int output_scale = expr->output_scale();
+            str = output_scale > 0 && output_scale <= 30 ? decimal_val->to_string(output_scale)
+                                                         : decimal_val->to_string();
+            break;
+        }
+        case TYPE_DECIMALV2: {
+            const DecimalV2Value decimal_val(reinterpret_cast<const PackedInt128*>(item)->value);
+            int output_scale = expr->output_scale();
+            str = output_scale > 0 && output_scale <= 30 ? decimal_val.to_string(output_scale)
+                                                         : decimal_val.to_string();
+            break;
+        }
+        default:
+            // not supported type, like BITMAP, HLL, just export null
+            st = string_builder->AppendNull();
+            ptr = nullptr;
+            break;
+        }
+        if (!str.empty()) {
+            ptr = str.data();
+            len = str.size();
+        }
+        if (ptr != nullptr) {
+            st = string_builder->Append(ptr, len);
+            _buffered_bytes += len + 4;
+        }
+        break;
+    }
+    }
+    RETURN_IF_ARROW_ERROR(st, "append parquet value failed");
+    return Status::OK();
+}
+
+Status ParquetWriterWrapper::_flush() {
+    if (_buffered_rows == 0) {
+        return Status::OK();
+    }
+    std::vector<std::shared_ptr<arrow::Array>> arrays(_builders.size());
+    for (int i = 0; i < _builders.size(); ++i) {
+        RETURN_IF_ARROW_ERROR(_builders[i]->Finish(&arrays[i]), "finish parquet column failed");
+    }
+    std::shared_ptr<arrow::Table> table = arrow::Table::Make(_schema, arrays, _buffered_rows);
+    // the buffered rows make one row group
+    RETURN_IF_ARROW_ERROR(_writer->WriteTable(*table, _buffered_rows),
+                          "write parquet row group failed");
+    _buffered_rows = 0;
+    _buffered_bytes = 0;
+    return Status::OK();
+}
+
+Status ParquetWriterWrapper::close() {
+    if (_is_closed) {
+        return Status::OK();
+    }
+    _is_closed = true;
+    if (_writer != nullptr) {
+        RETURN_IF_ERROR(_flush());
+        RETURN_IF_ARROW_ERROR(_writer->Close(), "close parquet writer failed");
+    }
+    RETURN_IF_ARROW_ERROR(_outstream->Close(), "close parquet file failed");
     return Status::OK();
 }
 
-void ParquetWriterWrapper::close() {
-    // TODO(cmy): implement
+int64_t ParquetWriterWrapper::written_len() const {
+    int64_t position = 0;
+    _outstream->Tell(&position);
+    return position;
 }
 
 ParquetWriterWrapper::~ParquetWriterWrapper() {
@@ -30,7 +30,9 @@
 #include <stdint.h>
 
 #include <map>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "common/status.h"
 #include "gen_cpp/PaloBrokerService_types.h"
@@ -57,24 +59,43 @@ public:
 
 private:
     FileWriter* _file_writer; // not owned
-    int64_t _cur_pos;         // current write position
+    int64_t _cur_pos = 0;     // current write position
     bool _is_closed = false;
 };
 
-// a wrapper of parquet output stream
+// Writes the results of the output exprs as a snappy compressed parquet file. The rows are
+// buffered in arrow builders and written as a row group once the buffer is large enough.
+// Column i is named "col<i>", types without a parquet counterpart (LARGEINT, DATE, DATETIME,
+// DECIMAL) are written as their text, the same as in a csv file.
 class ParquetWriterWrapper {
 public:
     ParquetWriterWrapper(FileWriter* file_writer,
                          const std::vector<ExprContext*>& output_expr_ctxs);
     virtual ~ParquetWriterWrapper();
 
+    Status init();
+
     Status write(const RowBatch& row_batch);
 
-    void close();
+    // Writes the buffered rows and the footer. The file writer is closed but not deleted.
+    Status close();
+
+    // Bytes written to the file, not counting the buffered rows.
+    int64_t written_len() const;
 
 private:
-    ParquetOutputStream* _outstream;
+    Status _append_value(int i, void* item);
+    Status _flush();
+
+    std::shared_ptr<ParquetOutputStream> _outstream;
     const std::vector<ExprContext*>& _output_expr_ctxs;
+    std::shared_ptr<arrow::Schema> _schema;
+    std::unique_ptr<parquet::arrow::FileWriter> _writer;
+    std::vector<std::unique_ptr<arrow::ArrayBuilder>> _builders;
+    // number and approximate size of the buffered rows
+    int64_t _buffered_rows = 0;
+    int64_t _buffered_bytes = 0;
+    bool _is_closed = false;
 };
 
 } // namespace doris
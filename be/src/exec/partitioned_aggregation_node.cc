@@ -23,6 +23,8 @@
 #include <set>
 #include <sstream>
 
+#include "common/config.h"
+#include "exec/olap_scan_node.h"
 #include "exec/partitioned_hash_table.h"
 #include "exec/partitioned_hash_table.inline.h"
 #include "exprs/anyval_util.h"
@@ -45,6 +47,7 @@
 #include "runtime/tuple.h"
 #include "runtime/tuple_row.h"
 #include "udf/udf_internal.h"
+#include "util/thrift_util.h"
 
 using namespace strings;
 
@@ -126,6 +129,7 @@ PartitionedAggregationNode::PartitionedAggregationNode(ObjectPool* pool, const T
           num_passthrough_rows_(NULL),
           preagg_estimated_reduction_(NULL),
           preagg_streaming_ht_min_reduction_(NULL),
+          num_passthrough_partitions_(NULL),
           //    estimated_input_cardinality_(tnode.agg_node.estimated_input_cardinality),
           singleton_output_tuple_(NULL),
           singleton_output_tuple_returned_(true),
@@ -179,11 +183,21 @@ Status PartitionedAggregationNode::init(const TPlanNode& tnode, RuntimeState* st
         agg_fns_.push_back(agg_fn);
         needs_serialize_ |= agg_fn->SupportsSerialize();
     }
+
+    if (AggResultCache::instance() != nullptr &&
+        child(0)->type() == TPlanNodeType::OLAP_SCAN_NODE && _limit == -1 &&
+        !AggResultCache::has_volatile_fn(tnode.conjuncts) &&
+        !AggResultCache::has_volatile_fn(tnode.agg_node.grouping_exprs) &&
+        !AggResultCache::has_volatile_fn(tnode.agg_node.aggregate_functions)) {
+        ThriftSerializer serializer(false, 1024);
+        RETURN_IF_ERROR(serializer.serialize(&tnode, &cache_plan_));
+    }
     return Status::OK();
 }
 
 Status PartitionedAggregationNode::prepare(RuntimeState* state) {
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_CPU_TIMER(_cpu_timer);
 
     RETURN_IF_ERROR(ExecNode::prepare(state));
     state_ = state;
@@ -219,6 +233,8 @@ Status PartitionedAggregationNode::prepare(RuntimeState* state) {
                 ADD_COUNTER(runtime_profile(), "ReductionFactorEstimate", TUnit::DOUBLE_VALUE);
         preagg_streaming_ht_min_reduction_ = ADD_COUNTER(
                 runtime_profile(), "ReductionFactorThresholdToExpand", TUnit::DOUBLE_VALUE);
+        num_passthrough_partitions_ =
+                ADD_COUNTER(runtime_profile(), "PassThroughPartitions", TUnit::UNIT);
     } else {
         build_timer_ = ADD_TIMER(runtime_profile(), "BuildTime");
         num_row_repartitioned_ = ADD_COUNTER(runtime_profile(), "RowsRepartitioned", TUnit::UNIT);
@@ -240,6 +256,9 @@ Status PartitionedAggregationNode::prepare(RuntimeState* state) {
                 vector<bool>(build_exprs_.size(), true), state->fragment_hash_seed(),
                 MAX_PARTITION_DEPTH, 1, expr_mem_pool(), expr_results_pool_.get(),
                 expr_mem_tracker(), build_row_desc, row_desc, &ht_ctx_));
+        if (ht_ctx_->expr_values_cache()->packed_key_words() > 0) {
+            runtime_profile()->append_exec_option("Packed Grouping Keys");
+        }
     }
     // AddCodegenDisabledMessage(state);
     return Status::OK();
@@ -247,8 +266,11 @@ Status PartitionedAggregationNode::prepare(RuntimeState* state) {
 
 Status PartitionedAggregationNode::open(RuntimeState* state) {
     SCOPED_TIMER(_runtime_profile->total_time_counter());
-    // Open the child before consuming resources in this node.
-    RETURN_IF_ERROR(child(0)->open(state));
+    SCOPED_CPU_TIMER(_cpu_timer);
+    if (!cache_plan_.empty()) RETURN_IF_ERROR(LookupCachedOutput(state));
+    // Open the child before consuming resources in this node. It's not read at all if the
+    // output is cached.
+    if (cached_output_ == nullptr) RETURN_IF_ERROR(child(0)->open(state));
     RETURN_IF_ERROR(ExecNode::open(state));
 
     // Claim reservation after the child has been opened to reduce the peak reservation
@@ -293,7 +315,7 @@ Status PartitionedAggregationNode::open(RuntimeState* state) {
     }
 
     // Streaming preaggregations do all processing in GetNext().
-    if (is_streaming_preagg_) return Status::OK();
+    if (is_streaming_preagg_ || cached_output_ != nullptr) return Status::OK();
 
     RowBatch batch(child(0)->row_desc(), state->batch_size(), mem_tracker().get());
     // Read all the rows from the child and process them.
@@ -345,12 +367,91 @@ Status PartitionedAggregationNode::open(RuntimeState* state) {
 }
 
 Status PartitionedAggregationNode::get_next(RuntimeState* state, RowBatch* row_batch, bool* eos) {
+    if (cached_output_ != nullptr) return GetNextCached(state, row_batch, eos);
     int first_row_idx = row_batch->num_rows();
     RETURN_IF_ERROR(GetNextInternal(state, row_batch, eos));
     RETURN_IF_ERROR(HandleOutputStrings(row_batch, first_row_idx));
+    if (output_to_cache_ != nullptr) CacheOutput(row_batch, first_row_idx, *eos);
+    return Status::OK();
+}
+
+Status PartitionedAggregationNode::LookupCachedOutput(RuntimeState* state) {
+    cache_key_ = cache_plan_;
+    cache_key_.append(state->timezone()).append(std::to_string(state->batch_size()));
+    // the cached batches are deserialized into the tuples of this instance
+    cache_key_.append(intermediate_tuple_desc_->debug_string());
+    cache_key_.append(output_tuple_desc_->debug_string());
+    if (!static_cast<OlapScanNode*>(child(0))->append_cache_key(&cache_key_)) {
+        return Status::OK();
+    }
+    if (AggResultCache::instance()->lookup(cache_key_, &cached_output_)) {
+        add_runtime_exec_option("Result Cache Hit");
+    } else {
+        output_to_cache_.reset(new AggResultCache::Batches());
+        output_to_cache_bytes_ = 0;
+    }
     return Status::OK();
 }
 
+Status PartitionedAggregationNode::GetNextCached(RuntimeState* state, RowBatch* row_batch,
+                                                 bool* eos) {
+    SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_CPU_TIMER(_cpu_timer);
+    RETURN_IF_CANCELLED(state);
+    int first_row_idx = row_batch->num_rows();
+    while (!row_batch->at_capacity()) {
+        if (cached_batch_ != nullptr && cached_row_idx_ < cached_batch_->num_rows()) {
+            int num_rows = std::min(row_batch->capacity() - row_batch->num_rows(),
+                                    cached_batch_->num_rows() - cached_row_idx_);
+            int dest_row_idx = row_batch->add_rows(num_rows);
+            for (int i = 0; i < num_rows; ++i) {
+                cached_batch_->copy_row(cached_batch_->get_row(cached_row_idx_ + i),
+                                        row_batch->get_row(dest_row_idx + i));
+            }
+            row_batch->commit_rows(num_rows);
+            cached_row_idx_ += num_rows;
+            continue;
+        }
+        if (cached_batch_ != nullptr) {
+            cached_batch_->transfer_resource_ownership(row_batch);
+            cached_batch_.reset();
+        }
+        if (next_cached_batch_ == cached_output_->size()) break;
+        cached_batch_.reset(new RowBatch(row_desc(), (*cached_output_)[next_cached_batch_++],
+                                         mem_tracker().get()));
+        cached_row_idx_ = 0;
+    }
+    // the rest of the rows of 'cached_batch_' are returned by the next call
+    if (cached_batch_ != nullptr && row_batch->num_rows() > first_row_idx) {
+        row_batch->mark_needs_deep_copy();
+    }
+    *eos = cached_batch_ == nullptr && next_cached_batch_ == cached_output_->size();
+    _num_rows_returned += row_batch->num_rows() - first_row_idx;
+    COUNTER_SET(_rows_returned_counter, _num_rows_returned);
+    return Status::OK();
+}
+
+void PartitionedAggregationNode::CacheOutput(RowBatch* row_batch, int first_row_idx, bool eos) {
+    // the batch is cached as a whole
+    if (first_row_idx != 0) {
+        output_to_cache_.reset();
+        return;
+    }
+    if (row_batch->num_rows() > 0) {
+        output_to_cache_->emplace_back();
+        row_batch->serialize(&output_to_cache_->back());
+        output_to_cache_bytes_ += output_to_cache_->back().ByteSizeLong();
+        if (output_to_cache_bytes_ > config::agg_result_cache_max_entry_bytes) {
+            output_to_cache_.reset();
+            return;
+        }
+    }
+    if (eos) {
+        AggResultCache::instance()->insert(cache_key_, output_to_cache_, output_to_cache_bytes_);
+        output_to_cache_.reset();
+    }
+}
+
 Status PartitionedAggregationNode::HandleOutputStrings(RowBatch* row_batch, int first_row_idx) {
     if (!needs_finalize_ && !needs_serialize_) return Status::OK();
     // String data returned by Serialize() or Finalize() is from local expr allocations in
@@ -401,6 +502,7 @@ Status PartitionedAggregationNode::CopyStringData(const SlotDescriptor& slot_des
 Status PartitionedAggregationNode::GetNextInternal(RuntimeState* state, RowBatch* row_batch,
                                                    bool* eos) {
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_CPU_TIMER(_cpu_timer);
     RETURN_IF_ERROR(exec_debug_action(TExecNodePhase::GETNEXT));
     RETURN_IF_CANCELLED(state);
     RETURN_IF_ERROR(state->check_query_state("New partitioned aggregation, while getting next."));
@@ -533,7 +635,8 @@ Status PartitionedAggregationNode::GetRowsStreaming(RuntimeState* state, RowBatc
         for (int i = 0; i < PARTITION_FANOUT; ++i) {
             PartitionedHashTable* hash_tbl = GetHashTable(i);
             remaining_capacity[i] = hash_tbl->NumInsertsBeforeResize();
-            ht_needs_expansion |= remaining_capacity[i] < child_batch_->num_rows();
+            ht_needs_expansion |= remaining_capacity[i] < child_batch_->num_rows() &&
+                                  !hash_partitions_[i]->streaming_passthrough;
         }
 
         // Stop expanding hash tables if we're not reducing the input sufficiently. As our
@@ -544,7 +647,8 @@ Status PartitionedAggregationNode::GetRowsStreaming(RuntimeState* state, RowBatc
         if (ht_needs_expansion && ShouldExpandPreaggHashTables()) {
             for (int i = 0; i < PARTITION_FANOUT; ++i) {
                 PartitionedHashTable* ht = GetHashTable(i);
-                if (remaining_capacity[i] < child_batch_->num_rows()) {
+                if (remaining_capacity[i] < child_batch_->num_rows() &&
+                    !hash_partitions_[i]->streaming_passthrough) {
                     SCOPED_TIMER(ht_resize_timer_);
                     bool resized;
                     RETURN_IF_ERROR(
@@ -564,6 +668,7 @@ Status PartitionedAggregationNode::GetRowsStreaming(RuntimeState* state, RowBatc
             RETURN_IF_ERROR(ProcessBatchStreaming(needs_serialize_, child_batch_.get(), out_batch,
                                                   ht_ctx_.get(), remaining_capacity));
         }
+        UpdateStreamingPassthrough();
 
         child_batch_->reset(); // All rows from child_batch_ were processed.
     } while (out_batch->num_rows() == 0 && !child_eos_);
@@ -628,6 +733,28 @@ bool PartitionedAggregationNode::ShouldExpandPreaggHashTables() const {
     return current_reduction > min_reduction;
 }
 
+void PartitionedAggregationNode::UpdateStreamingPassthrough() {
+    const int64_t sample_rows = config::streaming_preagg_passthrough_sample_rows;
+    if (sample_rows <= 0) return;
+    for (int i = 0; i < PARTITION_FANOUT; ++i) {
+        Partition* partition = hash_partitions_[i];
+        if (partition->streaming_passthrough ||
+            partition->num_streaming_aggregated_rows < sample_rows) {
+            continue;
+        }
+        // The reduction achieved so far underestimates the final one if the input is in a
+        // random order, but a partition that aggregated this many rows into nearly as many
+        // groups is unlikely to catch up.
+        const int64_t ht_rows = partition->hash_tbl->size();
+        double reduction = static_cast<double>(partition->num_streaming_aggregated_rows) /
+                           std::max<int64_t>(ht_rows, 1);
+        if (reduction < config::streaming_preagg_min_reduction) {
+            partition->streaming_passthrough = true;
+            COUNTER_UPDATE(num_passthrough_partitions_, 1);
+        }
+    }
+}
+
 void PartitionedAggregationNode::CleanupHashTbl(const vector<NewAggFnEvaluator*>& agg_fn_evals,
                                                 PartitionedHashTable::Iterator it) {
     if (!needs_finalize_ && !needs_serialize_) return;
@@ -755,9 +882,10 @@ Status PartitionedAggregationNode::Partition::InitHashTable(bool* got_memory) {
     // TODO: we could switch to 64 bit hashes and then we don't need a max size.
     // It might be reasonable to limit individual hash table size for other reasons
     // though. Always start with small buffers.
-    hash_tbl.reset(PartitionedHashTable::Create(parent->ht_allocator_.get(), false, 1, nullptr,
-                                                1L << (32 - NUM_PARTITIONING_BITS),
-                                                PAGG_DEFAULT_HASH_TABLE_SZ));
+    hash_tbl.reset(PartitionedHashTable::Create(
+            parent->ht_allocator_.get(), false, 1, nullptr, 1L << (32 - NUM_PARTITIONING_BITS),
+            PAGG_DEFAULT_HASH_TABLE_SZ,
+            parent->ht_ctx_->expr_values_cache()->packed_key_words()));
     // Please update the error message in CreateHashPartitions() if initial size of
     // hash table changes.
     return hash_tbl->Init(got_memory);
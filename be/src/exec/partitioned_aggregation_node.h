@@ -21,6 +21,7 @@
 #include <boost/scoped_ptr.hpp>
 #include <deque>
 
+#include "exec/agg_result_cache.h"
 #include "exec/exec_node.h"
 #include "exec/partitioned_hash_table.h"
 #include "runtime/buffered_tuple_stream3.h"
@@ -324,9 +325,31 @@ private:
     /// Expose the minimum reduction factor to continue growing the hash tables.
     RuntimeProfile::Counter* preagg_streaming_ht_min_reduction_;
 
+    /// Number of partitions passing all their rows through for low reduction.
+    RuntimeProfile::Counter* num_passthrough_partitions_;
+
     /// The estimated number of input rows from the planner.
     int64_t estimated_input_cardinality_;
 
+    /// The serialized plan of this node for the key of AggResultCache, empty if the output
+    /// isn't cached. Only the output of an aggregation reading an olap scan is cached.
+    std::string cache_plan_;
+
+    /// The AggResultCache key of this instance, made in Open().
+    std::string cache_key_;
+
+    /// The output read from AggResultCache on a hit, NULL otherwise. The batch being
+    /// returned is deserialized into 'cached_batch_', 'cached_row_idx_' is its next row.
+    std::shared_ptr<const AggResultCache::Batches> cached_output_;
+    size_t next_cached_batch_ = 0;
+    std::unique_ptr<RowBatch> cached_batch_;
+    int cached_row_idx_ = 0;
+
+    /// The output serialized so far on a miss, inserted into AggResultCache at eos. NULL if
+    /// it's not cached, e.g. it's too large.
+    std::shared_ptr<AggResultCache::Batches> output_to_cache_;
+    size_t output_to_cache_bytes_ = 0;
+
     /////////////////////////////////////////
     /// BEGIN: Members that must be Reset()
 
@@ -381,7 +404,12 @@ private:
     /// require an unaggregated stream.
     struct Partition {
         Partition(PartitionedAggregationNode* parent, int level, int idx)
-                : parent(parent), is_closed(false), level(level), idx(idx) {}
+                : parent(parent),
+                  is_closed(false),
+                  level(level),
+                  idx(idx),
+                  num_streaming_aggregated_rows(0),
+                  streaming_passthrough(false) {}
 
         ~Partition();
 
@@ -452,6 +480,14 @@ private:
         /// Always unpinned. Has a write buffer allocated when the partition is spilled and
         /// unaggregated rows are being processed.
         boost::scoped_ptr<BufferedTupleStream3> unaggregated_row_stream;
+
+        /// Number of input rows aggregated into 'hash_tbl' by a streaming preaggregation.
+        int64_t num_streaming_aggregated_rows;
+
+        /// If true, the streaming preaggregation passes all further input rows of this
+        /// partition through without looking them up in 'hash_tbl', because the rows
+        /// aggregated so far were barely reduced. Set by UpdateStreamingPassthrough().
+        bool streaming_passthrough;
     };
 
     /// Stream used to store serialized spilled rows. Only used if needs_serialize_
@@ -469,6 +505,17 @@ private:
     /// Materializes 'row_batch' in either grouping or non-grouping case.
     Status GetNextInternal(RuntimeState* state, RowBatch* row_batch, bool* eos);
 
+    /// Makes 'cache_key_' and looks it up in AggResultCache, sets 'cached_output_' on a hit
+    /// and starts collecting 'output_to_cache_' on a miss.
+    Status LookupCachedOutput(RuntimeState* state);
+
+    /// Returns the rows of 'cached_output_' instead of aggregating the child's.
+    Status GetNextCached(RuntimeState* state, RowBatch* row_batch, bool* eos);
+
+    /// Appends the rows of 'row_batch' from 'first_row_idx' onwards to 'output_to_cache_'
+    /// and inserts it into AggResultCache at eos.
+    void CacheOutput(RowBatch* row_batch, int first_row_idx, bool eos);
+
     /// Helper function called by GetNextInternal() to ensure that string data referenced in
     /// 'row_batch' will live as long as 'row_batch's tuples. 'first_row_idx' indexes the
     /// first row that should be processed in 'row_batch'.
@@ -606,6 +653,11 @@ private:
     /// the preagg should pass through any rows it can't fit in its tables.
     bool ShouldExpandPreaggHashTables() const;
 
+    /// Switch partitions of a streaming preaggregation to pass their rows through once
+    /// they have aggregated enough rows to measure their reduction, and the reduction is
+    /// too low to be worth the hash table lookups.
+    void UpdateStreamingPassthrough();
+
     /// Streaming processing of in_batch from child. Rows from child are either aggregated
     /// into the hash table or added to 'out_batch' in the intermediate tuple format.
     /// 'in_batch' is processed entirely, and 'out_batch' must have enough capacity to
@@ -27,8 +27,13 @@ using namespace doris;
 
 Status PartitionedAggregationNode::ProcessBatchNoGrouping(RowBatch* batch) {
     Tuple* output_tuple = singleton_output_tuple_;
-    FOREACH_ROW(batch, 0, batch_iter) {
-        UpdateTuple(agg_fn_evals_.data(), output_tuple, batch_iter.get());
+    // The evaluators with a batch update function consume the whole batch at once, the
+    // others are updated row by row.
+    for (NewAggFnEvaluator* eval : agg_fn_evals_) {
+        if (eval->AddBatch(batch, output_tuple)) continue;
+        FOREACH_ROW(batch, 0, batch_iter) {
+            eval->Add(batch_iter.get(), output_tuple);
+        }
     }
     return Status::OK();
 }
@@ -180,10 +185,12 @@ Status PartitionedAggregationNode::ProcessBatchStreaming(bool needs_serialize, R
             TupleRow* in_row = in_batch_iter.get();
             const uint32_t hash = expr_vals_cache->CurExprValuesHash();
             const uint32_t partition_idx = hash >> (32 - NUM_PARTITIONING_BITS);
+            Partition* partition = hash_partitions_[partition_idx];
             if (!expr_vals_cache->IsRowNull() &&
-                !TryAddToHashTable(ht_ctx, hash_partitions_[partition_idx],
-                                   GetHashTable(partition_idx), in_row, hash,
-                                   &remaining_capacity[partition_idx], &process_batch_status_)) {
+                (partition->streaming_passthrough ||
+                 !TryAddToHashTable(ht_ctx, partition, GetHashTable(partition_idx), in_row, hash,
+                                    &remaining_capacity[partition_idx],
+                                    &process_batch_status_))) {
                 RETURN_IF_ERROR(std::move(process_batch_status_));
                 // Tuple is not going into hash table, add it to the output batch.
                 Tuple* intermediate_tuple = ConstructIntermediateTuple(
@@ -241,6 +248,7 @@ bool PartitionedAggregationNode::TryAddToHashTable(PartitionedHashTableCtx* ht_c
         }
     }
     UpdateTuple(partition->agg_fn_evals.data(), intermediate_tuple, in_row);
+    ++partition->num_streaming_aggregated_rows;
     return true;
 }
 
@@ -294,7 +294,10 @@ PartitionedHashTableCtx::ExprValuesCache::ExprValuesCache()
           expr_values_array_(NULL),
           expr_values_null_array_(NULL),
           expr_values_hash_array_(NULL),
-          null_bitmap_(0) {}
+          null_bitmap_(0),
+          packed_key_words_(0),
+          cur_packed_key_(NULL),
+          packed_keys_array_(NULL) {}
 
 Status PartitionedHashTableCtx::ExprValuesCache::Init(RuntimeState* state,
                                                       const std::shared_ptr<MemTracker>& tracker,
@@ -309,13 +312,20 @@ Status PartitionedHashTableCtx::ExprValuesCache::Init(RuntimeState* state,
         return Status::OK();
     }
     DCHECK_GT(expr_values_bytes_per_row_, 0);
+    // Pack the keys if they are fixed width and small enough, see 'packed_keys_array_'.
+    const int word_bytes = sizeof(uint64_t);
+    int packed_key_bytes = expr_values_bytes_per_row_ + num_exprs_;
+    if (var_result_offset_ == -1 && packed_key_bytes <= MAX_PACKED_KEY_WORDS * word_bytes) {
+        packed_key_words_ =
+                BitUtil::next_power_of_two(BitUtil::ceil(packed_key_bytes, word_bytes));
+    }
     // Compute the maximum number of cached rows which can fit in the memory budget.
     // TODO: Find the optimal prefetch batch size. This may be something
     // processor dependent so we may need calibration at Impala startup time.
     capacity_ = std::max(1, std::min(state->batch_size(),
                                      MAX_EXPR_VALUES_ARRAY_SIZE / expr_values_bytes_per_row_));
 
-    int mem_usage = MemUsage(capacity_, expr_values_bytes_per_row_, num_exprs_);
+    int mem_usage = MemUsage(capacity_, expr_values_bytes_per_row_, num_exprs_, packed_key_words_);
     if (UNLIKELY(!tracker->TryConsume(mem_usage))) {
         capacity_ = 0;
         string details = Substitute(
@@ -338,6 +348,11 @@ Status PartitionedHashTableCtx::ExprValuesCache::Init(RuntimeState* state,
     cur_expr_values_hash_end_ = cur_expr_values_hash_;
     memset(cur_expr_values_hash_, 0, sizeof(uint32) * capacity_);
 
+    if (packed_key_words_ > 0) {
+        packed_keys_array_.reset(new uint64_t[packed_key_words_ * capacity_]);
+        cur_packed_key_ = packed_keys_array_.get();
+    }
+
     null_bitmap_.Reset(capacity_);
     return Status::OK();
 }
@@ -351,23 +366,27 @@ void PartitionedHashTableCtx::ExprValuesCache::Close(const std::shared_ptr<MemTr
     expr_values_array_.reset();
     expr_values_null_array_.reset();
     expr_values_hash_array_.reset();
+    cur_packed_key_ = NULL;
+    packed_keys_array_.reset();
     null_bitmap_.Reset(0);
-    int mem_usage = MemUsage(capacity_, expr_values_bytes_per_row_, num_exprs_);
+    int mem_usage = MemUsage(capacity_, expr_values_bytes_per_row_, num_exprs_, packed_key_words_);
     tracker->Release(mem_usage);
 }
 
 int PartitionedHashTableCtx::ExprValuesCache::MemUsage(int capacity, int expr_values_bytes_per_row,
-                                                       int num_exprs) {
-    return expr_values_bytes_per_row * capacity + // expr_values_array_
-           num_exprs * capacity +                 // expr_values_null_array_
-           sizeof(uint32) * capacity +            // expr_values_hash_array_
-           Bitmap::MemUsage(capacity);            // null_bitmap_
+                                                       int num_exprs, int packed_key_words) {
+    return expr_values_bytes_per_row * capacity +           // expr_values_array_
+           num_exprs * capacity +                           // expr_values_null_array_
+           sizeof(uint32) * capacity +                      // expr_values_hash_array_
+           Bitmap::MemUsage(capacity) +                     // null_bitmap_
+           packed_key_words * sizeof(uint64_t) * capacity; // packed_keys_array_
 }
 
 void PartitionedHashTableCtx::ExprValuesCache::ResetIterators() {
     cur_expr_values_ = expr_values_array_.get();
     cur_expr_values_null_ = expr_values_null_array_.get();
     cur_expr_values_hash_ = expr_values_hash_array_.get();
+    cur_packed_key_ = packed_keys_array_.get();
 }
 
 void PartitionedHashTableCtx::ExprValuesCache::Reset() noexcept {
@@ -392,16 +411,17 @@ PartitionedHashTable* PartitionedHashTable::Create(Suballocator* allocator, bool
                                                    int num_build_tuples,
                                                    BufferedTupleStream3* tuple_stream,
                                                    int64_t max_num_buckets,
-                                                   int64_t initial_num_buckets) {
+                                                   int64_t initial_num_buckets,
+                                                   int packed_key_words) {
     return new PartitionedHashTable(config::enable_quadratic_probing, allocator, stores_duplicates,
                                     num_build_tuples, tuple_stream, max_num_buckets,
-                                    initial_num_buckets);
+                                    initial_num_buckets, packed_key_words);
 }
 
 PartitionedHashTable::PartitionedHashTable(bool quadratic_probing, Suballocator* allocator,
                                            bool stores_duplicates, int num_build_tuples,
                                            BufferedTupleStream3* stream, int64_t max_num_buckets,
-                                           int64_t num_buckets)
+                                           int64_t num_buckets, int packed_key_words)
         : allocator_(allocator),
           tuple_stream_(stream),
           stores_tuples_(num_build_tuples == 1),
@@ -413,6 +433,8 @@ PartitionedHashTable::PartitionedHashTable(bool quadratic_probing, Suballocator*
           num_duplicate_nodes_(0),
           max_num_buckets_(max_num_buckets),
           buckets_(NULL),
+          packed_key_words_(packed_key_words),
+          packed_keys_(NULL),
           num_buckets_(num_buckets),
           num_filled_buckets_(0),
           num_buckets_with_duplicates_(0),
@@ -438,6 +460,18 @@ Status PartitionedHashTable::Init(bool* got_memory) {
     }
     buckets_ = reinterpret_cast<Bucket*>(bucket_allocation_->data());
     memset(buckets_, 0, buckets_byte_size);
+    if (packed_key_words_ > 0) {
+        RETURN_IF_ERROR(allocator_->Allocate(num_buckets_ * packed_key_words_ * sizeof(uint64_t),
+                                             &packed_key_allocation_));
+        if (packed_key_allocation_ == nullptr) {
+            allocator_->Free(move(bucket_allocation_));
+            buckets_ = NULL;
+            num_buckets_ = 0;
+            *got_memory = false;
+            return Status::OK();
+        }
+        packed_keys_ = reinterpret_cast<uint64_t*>(packed_key_allocation_->data());
+    }
     *got_memory = true;
     return Status::OK();
 }
@@ -452,6 +486,7 @@ void PartitionedHashTable::Close() {
     for (auto& data_page : data_pages_) allocator_->Free(move(data_page));
     data_pages_.clear();
     if (bucket_allocation_ != nullptr) allocator_->Free(move(bucket_allocation_));
+    if (packed_key_allocation_ != nullptr) allocator_->Free(move(packed_key_allocation_));
 }
 
 Status PartitionedHashTable::CheckAndResize(uint64_t buckets_to_fill,
@@ -498,6 +533,19 @@ Status PartitionedHashTable::ResizeBuckets(int64_t num_buckets,
     Bucket* new_buckets = reinterpret_cast<Bucket*>(new_allocation->data());
     memset(new_buckets, 0, new_size);
 
+    std::unique_ptr<Suballocation> new_packed_key_allocation;
+    uint64_t* new_packed_keys = NULL;
+    if (packed_key_words_ > 0) {
+        RETURN_IF_ERROR(allocator_->Allocate(num_buckets * packed_key_words_ * sizeof(uint64_t),
+                                             &new_packed_key_allocation));
+        if (new_packed_key_allocation == NULL) {
+            allocator_->Free(move(new_allocation));
+            *got_memory = false;
+            return Status::OK();
+        }
+        new_packed_keys = reinterpret_cast<uint64_t*>(new_packed_key_allocation->data());
+    }
+
     // Walk the old table and copy all the filled buckets to the new (resized) table.
     // We do not have to do anything with the duplicate nodes. This operation is expected
     // to succeed.
@@ -514,12 +562,22 @@ Status PartitionedHashTable::ResizeBuckets(int64_t num_buckets,
                 << num_buckets << " " << num_filled_buckets_;
         Bucket* dst_bucket = &new_buckets[bucket_idx];
         *dst_bucket = *bucket_to_copy;
+        if (packed_key_words_ > 0) {
+            memcpy(new_packed_keys + bucket_idx * packed_key_words_,
+                   packed_keys_ + iter.bucket_idx_ * packed_key_words_,
+                   packed_key_words_ * sizeof(uint64_t));
+        }
     }
 
     num_buckets_ = num_buckets;
     allocator_->Free(move(bucket_allocation_));
     bucket_allocation_ = std::move(new_allocation);
     buckets_ = reinterpret_cast<Bucket*>(bucket_allocation_->data());
+    if (packed_key_words_ > 0) {
+        allocator_->Free(move(packed_key_allocation_));
+        packed_key_allocation_ = std::move(new_packed_key_allocation);
+        packed_keys_ = new_packed_keys;
+    }
     *got_memory = true;
     return Status::OK();
 }
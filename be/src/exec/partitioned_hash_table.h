@@ -230,7 +230,8 @@ public:
         void ALWAYS_INLINE NextRow();
 
         /// Compute the total memory usage of this ExprValuesCache.
-        static int MemUsage(int capacity, int results_buffer_size, int num_build_exprs);
+        static int MemUsage(int capacity, int results_buffer_size, int num_build_exprs,
+                            int packed_key_words);
 
         /// Returns the maximum number rows of expression values states which can be cached.
         int ALWAYS_INLINE capacity() const { return capacity_; }
@@ -283,6 +284,13 @@ public:
             return expr_values_offsets_[expr_idx];
         }
 
+        /// Returns the number of 64-bit words of a packed key, or 0 if the keys are not
+        /// packed. See 'packed_keys_array_'.
+        int ALWAYS_INLINE packed_key_words() const { return packed_key_words_; }
+
+        /// Returns the packed key of the current row. Only valid if packed_key_words() > 0.
+        uint64_t* ALWAYS_INLINE cur_packed_key() const { return cur_packed_key_; }
+
     private:
         friend class PartitionedHashTableCtx;
 
@@ -350,8 +358,25 @@ public:
         /// a row. If -1, there are no variable length slots. Never changes once set, can be
         /// constant substituted with codegen.
         int var_result_offset_;
+
+        /// Number of 64-bit words of a packed key: 1, 2 or 4, or 0 if the keys are not
+        /// packed. Never changes once set.
+        int packed_key_words_;
+
+        /// Pointer into 'packed_keys_array_' for the current row's packed key.
+        uint64_t* cur_packed_key_;
+
+        /// If all expressions are fixed width and a row of their values and null bytes
+        /// fits in MAX_PACKED_KEY_WORDS words, the values followed by the null bytes are
+        /// packed into 'packed_key_words_' zero padded words per row. The hash table then
+        /// hashes and compares keys as a few integers, without evaluating the build
+        /// expressions over its rows.
+        boost::scoped_array<uint64_t> packed_keys_array_;
     };
 
+    /// The maximum number of 64-bit words of a packed key.
+    static const int MAX_PACKED_KEY_WORDS = 4;
+
     ExprValuesCache* ALWAYS_INLINE expr_values_cache() { return &expr_values_cache_; }
 
 private:
@@ -399,6 +424,12 @@ private:
     /// Wrapper function for calling correct HashUtil function in non-codegen'd case.
     uint32_t Hash(const void* input, int len, uint32_t hash) const;
 
+    /// Compute the hash of the current row, whose values are in 'expr_values' with
+    /// nullness 'expr_values_null'. If the keys are packed, packs the row into the
+    /// current packed key first and hashes that.
+    uint32_t IR_ALWAYS_INLINE HashCurRow(const uint8_t* expr_values,
+                                         const uint8_t* expr_values_null);
+
     /// Evaluate 'row' over build exprs, storing values into 'expr_values' and nullness into
     /// 'expr_values_null'. This will be replaced by codegen. We do not want this function
     /// inlined when cross compiled because we need to be able to differentiate between
@@ -562,9 +593,13 @@ public:
     ///    -1, if it unlimited.
     ///  - initial_num_buckets: number of buckets that the hash table should be initialized
     ///    with.
+    ///  - packed_key_words: the packed_key_words() of the ExprValuesCache of the contexts
+    ///    the table is used with. If not 0, the packed key of each bucket is kept next to
+    ///    the buckets and compared instead of the build row when NULLs are equal.
     static PartitionedHashTable* Create(Suballocator* allocator, bool stores_duplicates,
                                         int num_build_tuples, BufferedTupleStream3* tuple_stream,
-                                        int64_t max_num_buckets, int64_t initial_num_buckets);
+                                        int64_t max_num_buckets, int64_t initial_num_buckets,
+                                        int packed_key_words);
 
     /// Allocates the initial bucket structure. Returns a non-OK status if an error is
     /// encountered. If an OK status is returned , 'got_memory' is set to indicate whether
@@ -677,7 +712,10 @@ public:
                           bool* got_memory);
 
     /// Returns the number of bytes allocated to the hash table from the block manager.
-    int64_t ByteSize() const { return num_buckets_ * sizeof(Bucket) + total_data_page_size_; }
+    int64_t ByteSize() const {
+        return num_buckets_ * (sizeof(Bucket) + packed_key_words_ * sizeof(uint64_t)) +
+               total_data_page_size_;
+    }
 
     /// Returns an iterator at the beginning of the hash table.  Advancing this iterator
     /// will traverse all elements.
@@ -792,7 +830,8 @@ private:
     ///    opposed to linear.
     PartitionedHashTable(bool quadratic_probing, Suballocator* allocator, bool stores_duplicates,
                          int num_build_tuples, BufferedTupleStream3* tuple_stream,
-                         int64_t max_num_buckets, int64_t initial_num_buckets);
+                         int64_t max_num_buckets, int64_t initial_num_buckets,
+                         int packed_key_words);
 
     /// Performs the probing operation according to the probing algorithm (linear or
     /// quadratic. Returns one of the following:
@@ -857,6 +896,15 @@ private:
     /// an insert. Sets all the fields of the bucket other than 'data'.
     void IR_ALWAYS_INLINE PrepareBucketForInsert(int64_t bucket_idx, uint32_t hash);
 
+    /// Copies the current packed key of 'ht_ctx' to the bucket with index 'bucket_idx', if
+    /// the keys are packed.
+    void IR_ALWAYS_INLINE SetPackedKey(int64_t bucket_idx, const PartitionedHashTableCtx* ht_ctx);
+
+    /// Returns true if the packed key of the bucket with index 'bucket_idx' equals the
+    /// current packed key of 'ht_ctx'. NULLs are equal to each other.
+    bool IR_ALWAYS_INLINE PackedKeyEquals(int64_t bucket_idx,
+                                          const PartitionedHashTableCtx* ht_ctx) const;
+
     /// Return the TupleRow pointed by 'htdata'.
     TupleRow* GetRow(HtData& htdata, TupleRow* row) const;
 
@@ -928,6 +976,16 @@ private:
     /// Pointer to the 'buckets_' array from 'bucket_allocation_'.
     Bucket* buckets_;
 
+    /// Number of 64-bit words of the packed key of a bucket, 0 if keys are not packed.
+    const int packed_key_words_;
+
+    /// Allocation containing the packed keys of all buckets. NULL if keys are not packed.
+    std::unique_ptr<Suballocation> packed_key_allocation_;
+
+    /// The packed key of bucket i is at 'packed_keys_' + i * 'packed_key_words_'. Only
+    /// valid for filled buckets.
+    uint64_t* packed_keys_;
+
     /// Total number of buckets (filled and empty).
     int64_t num_buckets_;
 
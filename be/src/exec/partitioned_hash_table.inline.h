@@ -29,7 +29,7 @@ inline bool PartitionedHashTableCtx::EvalAndHashBuild(TupleRow* row) {
     uint8_t* expr_values_null = expr_values_cache_.cur_expr_values_null();
     bool has_null = EvalBuildRow(row, expr_values, expr_values_null);
     if (!stores_nulls() && has_null) return false;
-    expr_values_cache_.SetCurExprValuesHash(HashRow(expr_values, expr_values_null));
+    expr_values_cache_.SetCurExprValuesHash(HashCurRow(expr_values, expr_values_null));
     return true;
 }
 
@@ -38,13 +38,29 @@ inline bool PartitionedHashTableCtx::EvalAndHashProbe(TupleRow* row) {
     uint8_t* expr_values_null = expr_values_cache_.cur_expr_values_null();
     bool has_null = EvalProbeRow(row, expr_values, expr_values_null);
     if (has_null && !(stores_nulls() && finds_some_nulls())) return false;
-    expr_values_cache_.SetCurExprValuesHash(HashRow(expr_values, expr_values_null));
+    expr_values_cache_.SetCurExprValuesHash(HashCurRow(expr_values, expr_values_null));
     return true;
 }
 
+inline uint32_t PartitionedHashTableCtx::HashCurRow(const uint8_t* expr_values,
+                                                    const uint8_t* expr_values_null) {
+    const int packed_key_words = expr_values_cache_.packed_key_words();
+    if (packed_key_words == 0) return HashRow(expr_values, expr_values_null);
+    // The values of NULLs are a constant, so the null bytes are needed to tell them apart
+    // from equal values.
+    uint64_t* packed_key = expr_values_cache_.cur_packed_key();
+    const int values_bytes = expr_values_cache_.expr_values_bytes_per_row();
+    memset(packed_key, 0, packed_key_words * sizeof(uint64_t));
+    memcpy(packed_key, expr_values, values_bytes);
+    memcpy(reinterpret_cast<uint8_t*>(packed_key) + values_bytes, expr_values_null,
+           expr_values_cache_.num_exprs_);
+    return Hash(packed_key, packed_key_words * sizeof(uint64_t), seeds_[level_]);
+}
+
 inline void PartitionedHashTableCtx::ExprValuesCache::NextRow() {
     cur_expr_values_ += expr_values_bytes_per_row_;
     cur_expr_values_null_ += num_exprs_;
+    cur_packed_key_ += packed_key_words_;
     ++cur_expr_values_hash_;
     DCHECK_LE(cur_expr_values_hash_ - expr_values_hash_array_.get(), capacity_);
 }
@@ -66,8 +82,13 @@ inline int64_t PartitionedHashTable::Probe(Bucket* buckets, int64_t num_buckets,
         Bucket* bucket = &buckets[bucket_idx];
         if (LIKELY(!bucket->filled)) return bucket_idx;
         if (hash == bucket->hash) {
+            // Packed keys compare NULLs as equal, so they can only be used if NULLs are
+            // forced to be equal.
             if (ht_ctx != NULL &&
-                ht_ctx->Equals<FORCE_NULL_EQUALITY>(GetRow(bucket, ht_ctx->scratch_row_))) {
+                (FORCE_NULL_EQUALITY && packed_key_words_ > 0
+                         ? PackedKeyEquals(bucket_idx, ht_ctx)
+                         : ht_ctx->Equals<FORCE_NULL_EQUALITY>(
+                                   GetRow(bucket, ht_ctx->scratch_row_)))) {
                 *found = true;
                 return bucket_idx;
             }
@@ -106,6 +127,7 @@ inline PartitionedHashTable::HtData* PartitionedHashTable::InsertInternal(
         return &new_node->htdata;
     } else {
         PrepareBucketForInsert(bucket_idx, hash);
+        SetPackedKey(bucket_idx, ht_ctx);
         return &buckets_[bucket_idx].bucketData.htdata;
     }
 }
@@ -135,6 +157,9 @@ inline void PartitionedHashTable::PrefetchBucket(uint32_t hash) {
     // On x86, they map to instructions prefetchnta and prefetch{2-0} respectively.
     // TODO: Reconsider the locality level with smaller prefetch batch size.
     __builtin_prefetch(&buckets_[bucket_idx], READ ? 0 : 1, 1);
+    if (packed_key_words_ > 0) {
+        __builtin_prefetch(packed_keys_ + bucket_idx * packed_key_words_, READ ? 0 : 1, 1);
+    }
 }
 
 inline PartitionedHashTable::Iterator PartitionedHashTable::FindProbeRow(
@@ -156,6 +181,10 @@ inline PartitionedHashTable::Iterator PartitionedHashTable::FindBuildRowBucket(
     ++num_probes_;
     uint32_t hash = ht_ctx->expr_values_cache()->CurExprValuesHash();
     int64_t bucket_idx = Probe<true>(buckets_, num_buckets_, ht_ctx, hash, found);
+    if (!*found && LIKELY(bucket_idx != Iterator::BUCKET_NOT_FOUND)) {
+        // The caller fills the bucket with SetTuple() if it inserts the key.
+        SetPackedKey(bucket_idx, ht_ctx);
+    }
     DuplicateNode* duplicates = NULL;
     if (stores_duplicates() && LIKELY(bucket_idx != Iterator::BUCKET_NOT_FOUND)) {
         duplicates = buckets_[bucket_idx].bucketData.duplicates;
@@ -212,6 +241,31 @@ inline void PartitionedHashTable::PrepareBucketForInsert(int64_t bucket_idx, uin
     bucket->hash = hash;
 }
 
+inline void PartitionedHashTable::SetPackedKey(int64_t bucket_idx,
+                                               const PartitionedHashTableCtx* ht_ctx) {
+    if (packed_key_words_ == 0) return;
+    DCHECK_EQ(packed_key_words_, ht_ctx->expr_values_cache_.packed_key_words());
+    memcpy(packed_keys_ + bucket_idx * packed_key_words_,
+           ht_ctx->expr_values_cache_.cur_packed_key(), packed_key_words_ * sizeof(uint64_t));
+}
+
+inline bool PartitionedHashTable::PackedKeyEquals(int64_t bucket_idx,
+                                                  const PartitionedHashTableCtx* ht_ctx) const {
+    DCHECK_EQ(packed_key_words_, ht_ctx->expr_values_cache_.packed_key_words());
+    const uint64_t* key = packed_keys_ + bucket_idx * packed_key_words_;
+    const uint64_t* cur_key = ht_ctx->expr_values_cache_.cur_packed_key();
+    switch (packed_key_words_) {
+    case 1:
+        return key[0] == cur_key[0];
+    case 2:
+        return ((key[0] ^ cur_key[0]) | (key[1] ^ cur_key[1])) == 0;
+    default:
+        DCHECK_EQ(packed_key_words_, 4);
+        return ((key[0] ^ cur_key[0]) | (key[1] ^ cur_key[1]) | (key[2] ^ cur_key[2]) |
+                (key[3] ^ cur_key[3])) == 0;
+    }
+}
+
 inline PartitionedHashTable::DuplicateNode* PartitionedHashTable::AppendNextNode(Bucket* bucket) {
     DCHECK_GT(node_remaining_current_page_, 0);
     bucket->bucketData.duplicates = next_node_;
@@ -397,7 +451,8 @@ inline void PartitionedHashTableCtx::set_level(int level) {
 }
 
 inline int64_t PartitionedHashTable::CurrentMemSize() const {
-    return num_buckets_ * sizeof(Bucket) + num_duplicate_nodes_ * sizeof(DuplicateNode);
+    return num_buckets_ * (sizeof(Bucket) + packed_key_words_ * sizeof(uint64_t)) +
+           num_duplicate_nodes_ * sizeof(DuplicateNode);
 }
 
 inline int64_t PartitionedHashTable::NumInsertsBeforeResize() const {
@@ -49,6 +49,7 @@ PlainTextLineReader::PlainTextLineReader(RuntimeProfile* profile, FileReader* fi
           _output_buf_size(OUTPUT_CHUNK),
           _output_buf_pos(0),
           _output_buf_limit(0),
+          _read_buffers(decompressor == nullptr && file_reader->supports_read_buffer()),
           _file_eof(false),
           _eof(false),
           _stream_end(true),
@@ -92,7 +93,8 @@ inline bool PlainTextLineReader::update_eof() {
 uint8_t* PlainTextLineReader::update_field_pos_and_find_line_delimiter(const uint8_t* start,
                                                                        size_t len) {
     // TODO: meanwhile find and save field pos
-    return (uint8_t*)memmem(start, len, &_line_delimiter, 1);
+    // memchr() compares a vector of chars at a time, unlike memmem() with a one char needle
+    return (uint8_t*)memchr(start, _line_delimiter, len);
 }
 
 // extend input buf if necessary only when _more_input_bytes > 0
@@ -179,8 +181,77 @@ void PlainTextLineReader::extend_output_buf() {
     //           << " output_buf_limit: " << _output_buf_limit;
 }
 
+void PlainTextLineReader::append_to_output_buf(const uint8_t* data, size_t len) {
+    if (_output_buf_size - _output_buf_limit < len) {
+        while (_output_buf_size - _output_buf_limit < len) {
+            _output_buf_size = _output_buf_size * 2;
+        }
+        uint8_t* new_output_buf = new uint8_t[_output_buf_size];
+        memcpy(new_output_buf, _output_buf, _output_buf_limit);
+        delete[] _output_buf;
+        _output_buf = new_output_buf;
+    }
+    memcpy(_output_buf + _output_buf_limit, data, len);
+    _output_buf_limit += len;
+}
+
+Status PlainTextLineReader::read_line_from_buffers(const uint8_t** ptr, size_t* size,
+                                                   bool* eof) {
+    // the output buf holds the part of the line in the buffers before the current one
+    _output_buf_pos = 0;
+    _output_buf_limit = 0;
+    while (true) {
+        if (_cur_buffer == nullptr || !_cur_buffer->has_remaining()) {
+            {
+                SCOPED_TIMER(_read_timer);
+                RETURN_IF_ERROR(_file_reader->read_buffer(&_cur_buffer));
+            }
+            if (_cur_buffer == nullptr) {
+                // the last line may have no line delimiter
+                _file_eof = true;
+                _eof = true;
+                *ptr = _output_buf;
+                *size = _output_buf_limit;
+                *eof = _output_buf_limit == 0;
+                return Status::OK();
+            }
+            COUNTER_UPDATE(_bytes_read_counter, _cur_buffer->remaining());
+            _total_read_bytes += _cur_buffer->remaining();
+        }
+        const uint8_t* start = (const uint8_t*)_cur_buffer->ptr + _cur_buffer->pos;
+        size_t len = _cur_buffer->remaining();
+        const uint8_t* pos = update_field_pos_and_find_line_delimiter(start, len);
+        if (pos == nullptr) {
+            append_to_output_buf(start, len);
+            _cur_buffer->pos += len;
+            continue;
+        }
+        size_t line_len = pos - start;
+        _cur_buffer->pos += line_len + 1;
+        if (_output_buf_limit == 0) {
+            // the whole line is in the current buffer
+            *ptr = start;
+            *size = line_len;
+        } else {
+            append_to_output_buf(start, line_len);
+            *ptr = _output_buf;
+            *size = _output_buf_limit;
+        }
+        *eof = false;
+        return Status::OK();
+    }
+}
+
 Status PlainTextLineReader::read_line(const uint8_t** ptr, size_t* size, bool* eof) {
-    if (_eof || update_eof()) {
+    if (_eof) {
+        *size = 0;
+        *eof = true;
+        return Status::OK();
+    }
+    if (_read_buffers) {
+        return read_line_from_buffers(ptr, size, eof);
+    }
+    if (update_eof()) {
         *size = 0;
         *eof = true;
         return Status::OK();
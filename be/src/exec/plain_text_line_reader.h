@@ -18,6 +18,7 @@
 #pragma once
 
 #include "exec/line_reader.h"
+#include "util/byte_buffer.h"
 #include "util/runtime_profile.h"
 
 namespace doris {
@@ -55,6 +56,12 @@ private:
     void extend_input_buf();
     void extend_output_buf();
 
+    // Reads the lines of an uncompressed content out of the buffers taken from the file
+    // reader, see FileReader::read_buffer(). Only the lines that span two buffers are
+    // copied, to the output buf.
+    Status read_line_from_buffers(const uint8_t** ptr, size_t* size, bool* eof);
+    void append_to_output_buf(const uint8_t* data, size_t len);
+
 private:
     RuntimeProfile* _profile;
     FileReader* _file_reader;
@@ -75,6 +82,11 @@ private:
     size_t _output_buf_pos;
     size_t _output_buf_limit;
 
+    // set if the content is read by read_line_from_buffers()
+    bool _read_buffers;
+    // the buffer taken from the file reader whose lines are read now
+    ByteBufferPtr _cur_buffer;
+
     bool _file_eof;
     bool _eof;
     bool _stream_end;
@@ -43,6 +43,7 @@ RepeatNode::~RepeatNode() {}
 
 Status RepeatNode::prepare(RuntimeState* state) {
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_CPU_TIMER(_cpu_timer);
     RETURN_IF_ERROR(ExecNode::prepare(state));
     _runtime_state = state;
     _tuple_desc = state->desc_tbl().get_tuple_descriptor(_output_tuple_id);
@@ -50,11 +51,26 @@ Status RepeatNode::prepare(RuntimeState* state) {
         return Status::InternalError("Failed to get tuple descriptor.");
     }
 
+    const std::vector<TupleDescriptor*>& src_tuple_descs = child(0)->row_desc().tuple_descriptors();
+    _null_slots.resize(_repeat_id_list.size());
+    for (int i = 0; i < _repeat_id_list.size(); ++i) {
+        _null_slots[i].resize(src_tuple_descs.size());
+        for (int j = 0; j < src_tuple_descs.size(); ++j) {
+            for (const SlotDescriptor* slot_desc : src_tuple_descs[j]->slots()) {
+                if (_all_slot_ids.find(slot_desc->id()) != _all_slot_ids.end() &&
+                    _slot_id_set_list[i].find(slot_desc->id()) == _slot_id_set_list[i].end()) {
+                    _null_slots[i][j].push_back(slot_desc->null_indicator_offset());
+                }
+            }
+        }
+    }
+
     return Status::OK();
 }
 
 Status RepeatNode::open(RuntimeState* state) {
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_CPU_TIMER(_cpu_timer);
     RETURN_IF_ERROR(ExecNode::open(state));
     RETURN_IF_CANCELLED(state);
     RETURN_IF_ERROR(child(0)->open(state));
@@ -66,6 +82,8 @@ Status RepeatNode::open(RuntimeState* state) {
  *  and then set grouping_id and other grouping function slot in child_row_batch
  *  e.g. _repeat_id_list = [0, 3, 1, 2], _repeat_id_idx = 2, _grouping_list [[0, 3, 1, 2], [0, 1, 1, 0]],
  *  row_batch tuple 0 ['a', 'b', 1] -> [['a', null, 1] tuple 1 [1, 1]]
+ * Child tuples with no slot set to null are not copied, the others are copied shallowly, so
+ * all rows reference the memory of child_row_batch.
  */
 Status RepeatNode::get_repeated_batch(RowBatch* child_row_batch, int repeat_id_idx,
                                       RowBatch* row_batch) {
@@ -76,75 +94,48 @@ Status RepeatNode::get_repeated_batch(RowBatch* child_row_batch, int repeat_id_i
     MemPool* tuple_pool = row_batch->tuple_data_pool();
     const std::vector<TupleDescriptor*>& src_tuple_descs =
             child_row_batch->row_desc().tuple_descriptors();
-    const std::vector<TupleDescriptor*>& dst_tuple_descs =
-            row_batch->row_desc().tuple_descriptors();
-    std::vector<Tuple*> dst_tuples(src_tuple_descs.size(), nullptr);
-    for (int i = 0; i < child_row_batch->num_rows(); ++i) {
+    const std::vector<std::vector<NullIndicatorOffset>>& null_slots = _null_slots[repeat_id_idx];
+    int num_rows = child_row_batch->num_rows();
+    std::vector<char*> dst_tuples(src_tuple_descs.size(), nullptr);
+    for (int j = 0; j < src_tuple_descs.size(); ++j) {
+        if (!null_slots[j].empty()) {
+            int size = num_rows * src_tuple_descs[j]->byte_size();
+            dst_tuples[j] = reinterpret_cast<char*>(tuple_pool->allocate(size));
+            if (dst_tuples[j] == nullptr) {
+                return Status::InternalError("Allocate memory for row batch failed.");
+            }
+        }
+    }
+    int size = num_rows * _tuple_desc->byte_size();
+    char* grouping_tuples = reinterpret_cast<char*>(tuple_pool->allocate(size));
+    if (grouping_tuples == nullptr) {
+        return Status::InternalError("Allocate memory for row batch failed.");
+    }
+
+    for (int i = 0; i < num_rows; ++i) {
         int row_idx = row_batch->add_row();
         TupleRow* dst_row = row_batch->get_row(row_idx);
         TupleRow* src_row = child_row_batch->get_row(i);
 
-        auto src_it = src_tuple_descs.begin();
-        auto dst_it = dst_tuple_descs.begin();
-        for (int j = 0; src_it != src_tuple_descs.end() && dst_it != dst_tuple_descs.end();
-             ++src_it, ++dst_it, ++j) {
+        for (int j = 0; j < src_tuple_descs.size(); ++j) {
             Tuple* src_tuple = src_row->get_tuple(j);
-            if (src_tuple == NULL) {
+            if (src_tuple == NULL || null_slots[j].empty()) {
+                dst_row->set_tuple(j, src_tuple);
                 continue;
             }
-
-            if (dst_tuples[j] == nullptr) {
-                int size = row_batch->capacity() * (*dst_it)->byte_size();
-                void* tuple_buffer = tuple_pool->allocate(size);
-                if (tuple_buffer == nullptr) {
-                    return Status::InternalError("Allocate memory for row batch failed.");
-                }
-                dst_tuples[j] = reinterpret_cast<Tuple*>(tuple_buffer);
-            } else {
-                char* new_tuple = reinterpret_cast<char*>(dst_tuples[j]);
-                new_tuple += (*dst_it)->byte_size();
-                dst_tuples[j] = reinterpret_cast<Tuple*>(new_tuple);
-            }
-            dst_row->set_tuple(j, dst_tuples[j]);
-            memset(dst_tuples[j], 0, (*dst_it)->num_null_bytes());
-            src_tuple->deep_copy(dst_tuples[j], **dst_it, tuple_pool);
-            for (int k = 0; k < (*src_it)->slots().size(); k++) {
-                SlotDescriptor* src_slot_desc = (*src_it)->slots()[k];
-                SlotDescriptor* dst_slot_desc = (*dst_it)->slots()[k];
-                DCHECK_EQ(src_slot_desc->type().type, dst_slot_desc->type().type);
-                DCHECK_EQ(src_slot_desc->col_name(), dst_slot_desc->col_name());
-                // set null base on repeated list
-                if (_all_slot_ids.find(src_slot_desc->id()) != _all_slot_ids.end()) {
-                    std::set<SlotId>& repeat_ids = _slot_id_set_list[repeat_id_idx];
-                    if (repeat_ids.find(src_slot_desc->id()) == repeat_ids.end()) {
-                        dst_tuples[j]->set_null(dst_slot_desc->null_indicator_offset());
-                        continue;
-                    }
-                }
+            int byte_size = src_tuple_descs[j]->byte_size();
+            Tuple* dst_tuple = reinterpret_cast<Tuple*>(dst_tuples[j] + i * byte_size);
+            memcpy(dst_tuple, src_tuple, byte_size);
+            // set null base on repeated list
+            for (const NullIndicatorOffset& null_indicator : null_slots[j]) {
+                dst_tuple->set_null(null_indicator);
             }
-        }
-        row_batch->commit_last_row();
-    }
-    Tuple* tuple = nullptr;
-    // Fill grouping ID to tuple
-    for (int i = 0; i < child_row_batch->num_rows(); ++i) {
-        int row_idx = i;
-        TupleRow* row = row_batch->get_row(row_idx);
-
-        if (tuple == nullptr) {
-            int size = row_batch->capacity() * _tuple_desc->byte_size();
-            void* tuple_buffer = tuple_pool->allocate(size);
-            if (tuple_buffer == nullptr) {
-                return Status::InternalError("Allocate memory for row batch failed.");
-            }
-            tuple = reinterpret_cast<Tuple*>(tuple_buffer);
-        } else {
-            char* new_tuple = reinterpret_cast<char*>(tuple);
-            new_tuple += _tuple_desc->byte_size();
-            tuple = reinterpret_cast<Tuple*>(new_tuple);
+            dst_row->set_tuple(j, dst_tuple);
         }
 
-        row->set_tuple(src_tuple_descs.size(), tuple);
+        // Fill grouping ID to tuple
+        Tuple* tuple = reinterpret_cast<Tuple*>(grouping_tuples + i * _tuple_desc->byte_size());
+        dst_row->set_tuple(src_tuple_descs.size(), tuple);
         memset(tuple, 0, _tuple_desc->num_null_bytes());
 
         for (size_t slot_idx = 0; slot_idx < _grouping_list.size(); ++slot_idx) {
@@ -155,6 +146,7 @@ Status RepeatNode::get_repeated_batch(RowBatch* child_row_batch, int repeat_id_i
             tuple->set_not_null(slot_desc->null_indicator_offset());
             RawValue::write(&val, tuple, slot_desc, tuple_pool);
         }
+        row_batch->commit_last_row();
     }
 
     return Status::OK();
@@ -162,6 +154,7 @@ Status RepeatNode::get_repeated_batch(RowBatch* child_row_batch, int repeat_id_i
 
 Status RepeatNode::get_next(RuntimeState* state, RowBatch* row_batch, bool* eos) {
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_CPU_TIMER(_cpu_timer);
     RETURN_IF_CANCELLED(state);
     DCHECK(_repeat_id_idx >= 0);
     for (const std::vector<int64_t>& v : _grouping_list) {
@@ -191,6 +184,8 @@ Status RepeatNode::get_next(RuntimeState* state, RowBatch* row_batch, bool* eos)
 
     int size = _repeat_id_list.size();
     if (_repeat_id_idx >= size) {
+        // the rows of all repeats reference the child batch, it's passed on to the last
+        _child_row_batch->transfer_resource_ownership(row_batch);
         _child_row_batch.reset(nullptr);
         _repeat_id_idx = 0;
     }
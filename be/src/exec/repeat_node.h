@@ -18,6 +18,7 @@
 #pragma once
 
 #include "exec/exec_node.h"
+#include "runtime/descriptors.h"
 
 namespace doris {
 
@@ -54,6 +55,11 @@ private:
     TupleId _output_tuple_id;
     const TupleDescriptor* _tuple_desc;
 
+    // _null_slots[i][j] are the null indicators of the slots of the j-th child tuple set to
+    // null by the i-th repeat. The child tuple is passed through if there are none, and is
+    // copied shallowly otherwise, the child batch is passed on with its last repeat.
+    std::vector<std::vector<std::vector<NullIndicatorOffset>>> _null_slots;
+
     std::unique_ptr<RowBatch> _child_row_batch;
     bool _child_eos;
     int _repeat_id_idx;
@@ -0,0 +1,50 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "exec/scan_string_dict.h"
+
+#include <cstring>
+
+namespace doris {
+
+ScanStringDict::ScanStringDict(size_t max_size, MemTracker* tracker)
+        : _max_size(max_size), _pool(tracker) {}
+
+bool ScanStringDict::unify(StringValue* value) {
+    std::lock_guard<std::mutex> l(_lock);
+    auto it = _values.find(*value);
+    if (it != _values.end()) {
+        *value = *it;
+        return true;
+    }
+    if (_values.size() >= _max_size) {
+        _full.store(true, std::memory_order_relaxed);
+        return false;
+    }
+    char* ptr = reinterpret_cast<char*>(_pool.allocate(value->len));
+    memcpy(ptr, value->ptr, value->len);
+    value->ptr = ptr;
+    _values.insert(*value);
+    return true;
+}
+
+size_t ScanStringDict::size() {
+    std::lock_guard<std::mutex> l(_lock);
+    return _values.size();
+}
+
+} // namespace doris
@@ -0,0 +1,98 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_set>
+
+#include "runtime/mem_pool.h"
+#include "runtime/string_value.h"
+#include "util/hash_util.hpp"
+
+namespace doris {
+
+class MemTracker;
+
+struct StringValueHash {
+    size_t operator()(const StringValue& value) const {
+        return HashUtil::hash(value.ptr, value.len, 0);
+    }
+};
+
+// The global dictionary of a string slot of an OlapScanNode, which unifies the values read by
+// all its scanners from the dictionaries of the segments. Each distinct value is stored once,
+// and the rows of the scan carry the unified value instead of a copy of it in the pools of
+// their row batches. So the rows of a low cardinality column take little memory, and equal
+// values share a pointer, which string comparisons of aggregations and joins shortcut on.
+//
+// A column turns out not of low cardinality once the dictionary is full, then its values are
+// copied per row as before. The unified values are valid until the dictionary is destroyed with
+// the scan node, i.e. as long as the row batches of the fragment instance.
+class ScanStringDict {
+public:
+    ScanStringDict(size_t max_size, MemTracker* tracker);
+
+    // Set 'value' to its unified value. Return false if it's not in the dictionary, which is
+    // full.
+    bool unify(StringValue* value);
+
+    bool is_full() const { return _full.load(std::memory_order_relaxed); }
+
+    size_t size();
+
+private:
+    const size_t _max_size;
+    std::atomic<bool> _full {false};
+
+    std::mutex _lock;
+    std::unordered_set<StringValue, StringValueHash> _values;
+    // holds the unified values
+    MemPool _pool;
+};
+
+// The unified values of a ScanStringDict a scanner has seen, looked up without the lock of the
+// dictionary. Not thread safe.
+class ScanStringDictCache {
+public:
+    explicit ScanStringDictCache(ScanStringDict* dict) : _dict(dict) {}
+
+    // Same as ScanStringDict::unify()
+    bool unify(StringValue* value) {
+        auto it = _values.find(*value);
+        if (it != _values.end()) {
+            *value = *it;
+            return true;
+        }
+        if (_dict->is_full() || !_dict->unify(value)) {
+            return false;
+        }
+        _values.insert(*value);
+        return true;
+    }
+
+    // Once false, the values of the slot are not worth looking up anymore
+    bool enabled() const { return !_dict->is_full(); }
+
+private:
+    ScanStringDict* _dict;
+    std::unordered_set<StringValue, StringValueHash> _values;
+};
+
+} // namespace doris
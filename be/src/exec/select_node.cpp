@@ -28,6 +28,7 @@ namespace doris {
 SelectNode::SelectNode(ObjectPool* pool, const TPlanNode& tnode, const DescriptorTbl& descs)
         : ExecNode(pool, tnode, descs),
           _child_row_batch(NULL),
+          _num_selected(0),
           _child_row_idx(0),
           _child_eos(false) {}
 
@@ -49,8 +50,9 @@ Status SelectNode::get_next(RuntimeState* state, RowBatch* row_batch, bool* eos)
     RETURN_IF_ERROR(exec_debug_action(TExecNodePhase::GETNEXT));
     RETURN_IF_CANCELLED(state);
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_CPU_TIMER(_cpu_timer);
 
-    if (reached_limit() || (_child_row_idx == _child_row_batch->num_rows() && _child_eos)) {
+    if (reached_limit() || (_child_row_idx == _num_selected && _child_eos)) {
         // we're already done or we exhausted the last child batch and there won't be any
         // new ones
         _child_row_batch->transfer_resource_ownership(row_batch);
@@ -62,20 +64,21 @@ Status SelectNode::get_next(RuntimeState* state, RowBatch* row_batch, bool* eos)
     // start (or continue) consuming row batches from child
     while (true) {
         RETURN_IF_CANCELLED(state);
-        if (_child_row_idx == _child_row_batch->num_rows()) {
+        if (_child_row_idx == _num_selected) {
             // fetch next batch
             _child_row_idx = 0;
+            _num_selected = 0;
             _child_row_batch->transfer_resource_ownership(row_batch);
             _child_row_batch->reset();
             if (row_batch->at_capacity()) {
                 return Status::OK();
             }
             RETURN_IF_ERROR(child(0)->get_next(state, _child_row_batch.get(), &_child_eos));
+            select_rows();
         }
 
         if (copy_rows(row_batch)) {
-            *eos = reached_limit() ||
-                   (_child_row_idx == _child_row_batch->num_rows() && _child_eos);
+            *eos = reached_limit() || (_child_row_idx == _num_selected && _child_eos);
             if (*eos) {
                 _child_row_batch->transfer_resource_ownership(row_batch);
             }
@@ -93,11 +96,19 @@ Status SelectNode::get_next(RuntimeState* state, RowBatch* row_batch, bool* eos)
     return Status::OK();
 }
 
-bool SelectNode::copy_rows(RowBatch* output_batch) {
-    ExprContext** ctxs = &_conjunct_ctxs[0];
-    int num_ctxs = _conjunct_ctxs.size();
+void SelectNode::select_rows() {
+    int num_rows = _child_row_batch->num_rows();
+    _selection.resize(num_rows);
+    for (int i = 0; i < num_rows; ++i) {
+        _selection[i] = i;
+    }
+    _num_selected = ExecNode::eval_conjuncts(_conjunct_ctxs.data(), _conjunct_ctxs.size(),
+                                             _child_row_batch.get(), _selection.data(),
+                                             num_rows);
+}
 
-    for (; _child_row_idx < _child_row_batch->num_rows(); ++_child_row_idx) {
+bool SelectNode::copy_rows(RowBatch* output_batch) {
+    for (; _child_row_idx < _num_selected; ++_child_row_idx) {
         // Add a new row to output_batch
         int dst_row_idx = output_batch->add_row();
 
@@ -106,17 +117,15 @@ bool SelectNode::copy_rows(RowBatch* output_batch) {
         }
 
         TupleRow* dst_row = output_batch->get_row(dst_row_idx);
-        TupleRow* src_row = _child_row_batch->get_row(_child_row_idx);
+        TupleRow* src_row = _child_row_batch->get_row(_selection[_child_row_idx]);
 
-        if (ExecNode::eval_conjuncts(ctxs, num_ctxs, src_row)) {
-            output_batch->copy_row(src_row, dst_row);
-            output_batch->commit_last_row();
-            ++_num_rows_returned;
-            COUNTER_SET(_rows_returned_counter, _num_rows_returned);
+        output_batch->copy_row(src_row, dst_row);
+        output_batch->commit_last_row();
+        ++_num_rows_returned;
+        COUNTER_SET(_rows_returned_counter, _num_rows_returned);
 
-            if (reached_limit()) {
-                return true;
-            }
+        if (reached_limit()) {
+            return true;
         }
     }
 
@@ -19,6 +19,7 @@
 #define DORIS_BE_SRC_QUERY_EXEC_SELECT_NODE_H
 
 #include <boost/scoped_ptr.hpp>
+#include <vector>
 
 #include "exec/exec_node.h"
 #include "runtime/mem_pool.h"
@@ -43,14 +44,20 @@ private:
     // current row batch of child
     boost::scoped_ptr<RowBatch> _child_row_batch;
 
-    // index of current row in _child_row_batch
+    // rows of _child_row_batch that pass the conjuncts, evaluated a batch at a time
+    std::vector<int> _selection;
+    int _num_selected;
+
+    // index of current row in _selection
     int _child_row_idx;
 
     // true if last get_next() call on child signalled eos
     bool _child_eos;
 
-    // Copy rows from _child_row_batch for which _conjuncts evaluate to true to
-    // output_batch, up to _limit.
+    // Select the rows of _child_row_batch the conjuncts evaluate to true for.
+    void select_rows();
+
+    // Copy the selected rows from _child_row_batch to output_batch, up to _limit.
     // Return true if limit was hit or output_batch should be returned, otherwise false.
     bool copy_rows(RowBatch* output_batch);
 };
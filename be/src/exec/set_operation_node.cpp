@@ -17,8 +17,12 @@
 
 #include "exec/set_operation_node.h"
 
+#include "common/config.h"
 #include "exec/hash_table.hpp"
+#include "exec/scan_node.h"
 #include "exprs/expr.h"
+#include "exprs/in_predicate.h"
+#include "exprs/minmax_filter.h"
 #include "runtime/raw_value.h"
 #include "runtime/row_batch.h"
 #include "runtime/runtime_state.h"
@@ -42,7 +46,9 @@ Status SetOperationNode::prepare(RuntimeState* state) {
     _build_pool.reset(new MemPool(mem_tracker().get()));
     _build_timer = ADD_TIMER(runtime_profile(), "BuildTime");
     _probe_timer = ADD_TIMER(runtime_profile(), "ProbeTime");
+    _push_down_timer = ADD_TIMER(runtime_profile(), "PushDownTime");
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_CPU_TIMER(_cpu_timer);
     for (size_t i = 0; i < _child_expr_lists.size(); ++i) {
         RETURN_IF_ERROR(Expr::prepare(_child_expr_lists[i], state, child(i)->row_desc(),
                                       expr_mem_tracker()));
@@ -134,6 +140,7 @@ Status SetOperationNode::open(RuntimeState* state) {
     RETURN_IF_ERROR(ExecNode::open(state));
     RETURN_IF_ERROR(exec_debug_action(TExecNodePhase::OPEN));
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_CPU_TIMER(_cpu_timer);
     RETURN_IF_CANCELLED(state);
     // open result expr lists.
     for (const std::vector<ExprContext*>& exprs : _child_expr_lists) {
@@ -164,4 +171,93 @@ Status SetOperationNode::open(RuntimeState* state) {
     }
     return Status::OK();
 }
+
+Status SetOperationNode::push_down_hash_table_keys(RuntimeState* state, int child_idx) {
+    // Below other nodes, e.g. an analytic one, a predicate could change the values of
+    // the rows left, so only scans of the child itself are filtered.
+    if (!config::enable_set_operation_push_down || _hash_tbl->size() == 0 ||
+        dynamic_cast<ScanNode*>(child(child_idx)) == nullptr) {
+        return Status::OK();
+    }
+    bool use_in = _hash_tbl->size() <= config::join_push_down_in_max_num;
+    if (!use_in && !config::enable_join_minmax_push_down) {
+        return Status::OK();
+    }
+    SCOPED_TIMER(_push_down_timer);
+    const std::vector<ExprContext*>& build_exprs = _child_expr_lists[0];
+    const std::vector<ExprContext*>& probe_exprs = _child_expr_lists[child_idx];
+
+    // Only keys of the same type on both sides get a predicate
+    std::vector<int> key_idxs;
+    std::vector<InPredicate*> in_preds;
+    std::vector<std::unique_ptr<MinMaxFilter>> filters;
+    for (int i = 0; i < build_exprs.size(); ++i) {
+        const TypeDescriptor& type = probe_exprs[i]->root()->type();
+        if (type != build_exprs[i]->root()->type()) {
+            continue;
+        }
+        if (use_in) {
+            TExprNode node;
+            node.__set_node_type(TExprNodeType::IN_PRED);
+            TScalarType tscalar_type;
+            tscalar_type.__set_type(TPrimitiveType::BOOLEAN);
+            TTypeNode ttype_node;
+            ttype_node.__set_type(TTypeNodeType::SCALAR);
+            ttype_node.__set_scalar_type(tscalar_type);
+            TTypeDesc t_type_desc;
+            t_type_desc.types.push_back(ttype_node);
+            node.__set_type(t_type_desc);
+            node.in_predicate.__set_is_not_in(false);
+            node.__set_opcode(TExprOpcode::FILTER_IN);
+            node.__isset.vector_opcode = true;
+            node.__set_vector_opcode(to_in_opcode(type.type));
+            InPredicate* in_pred = _pool->add(new InPredicate(node));
+            RETURN_IF_ERROR(in_pred->prepare(state, type));
+            in_pred->add_child(Expr::copy(_pool, probe_exprs[i]->root()));
+            in_preds.push_back(in_pred);
+        } else if (MinMaxFilter::is_supported(type)) {
+            filters.emplace_back(new MinMaxFilter(type));
+        } else {
+            continue;
+        }
+        key_idxs.push_back(i);
+    }
+
+    // NULL equals NULL here while the predicates drop NULL, so a key with a NULL in
+    // the table gets no predicate.
+    std::vector<bool> has_null(key_idxs.size(), false);
+    HashTable::Iterator iter = _hash_tbl->begin();
+    while (iter.has_next()) {
+        TupleRow* row = iter.get_row();
+        for (int i = 0; i < key_idxs.size(); ++i) {
+            void* val = build_exprs[key_idxs[i]]->get_value(row);
+            if (val == nullptr) {
+                has_null[i] = true;
+            } else if (use_in) {
+                in_preds[i]->insert(val);
+            } else {
+                filters[i]->insert(val);
+            }
+        }
+        iter.next<false>();
+    }
+
+    std::list<ExprContext*> expr_ctxs;
+    for (int i = 0; i < key_idxs.size(); ++i) {
+        if (has_null[i]) {
+            continue;
+        }
+        if (use_in) {
+            expr_ctxs.push_back(_pool->add(new ExprContext(in_preds[i])));
+        } else if (!filters[i]->empty()) {
+            RETURN_IF_ERROR(filters[i]->create_predicates(
+                    _pool, probe_exprs[key_idxs[i]]->root(), &expr_ctxs));
+        }
+    }
+    if (!expr_ctxs.empty()) {
+        child(child_idx)->push_down_predicate(state, &expr_ctxs);
+    }
+    return Status::OK();
+}
+
 } // namespace doris
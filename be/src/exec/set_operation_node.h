@@ -49,6 +49,11 @@ protected:
     // Returns true if the values of row and other are equal
     bool equals(TupleRow* row, TupleRow* other);
 
+    // Push the keys left in _hash_tbl down to child 'child_idx', a scan, before it's
+    // opened as IN predicates or min/max ranges, since only its rows of these keys can
+    // match.
+    Status push_down_hash_table_keys(RuntimeState* state, int child_idx);
+
     /// Tuple id resolved in Prepare() to set tuple_desc_;
     const int _tuple_id;
     /// Descriptor for tuples this union node constructs.
@@ -67,8 +72,9 @@ protected:
     int _build_tuple_row_size;
     std::vector<bool> _find_nulls;
 
-    RuntimeProfile::Counter* _build_timer; // time to build hash table
-    RuntimeProfile::Counter* _probe_timer; // time to probe
+    RuntimeProfile::Counter* _build_timer;     // time to build hash table
+    RuntimeProfile::Counter* _probe_timer;     // time to probe
+    RuntimeProfile::Counter* _push_down_timer; // time to push down the keys
 };
 
 }; // namespace doris
\ No newline at end of file
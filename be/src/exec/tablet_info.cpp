@@ -17,6 +17,9 @@
 
 #include "exec/tablet_info.h"
 
+#include <algorithm>
+#include <cstring>
+
 #include "runtime/mem_pool.h"
 #include "runtime/mem_tracker.h"
 #include "runtime/row_batch.h"
@@ -148,6 +151,7 @@ OlapTablePartitionParam::OlapTablePartitionParam(std::shared_ptr<OlapTableSchema
                                                  const TOlapTablePartitionParam& t_param)
         : _schema(schema),
           _t_param(t_param),
+          _part_key_comparator(_partition_slot_descs),
           _mem_tracker(MemTracker::CreateTracker(-1, "OlapTablePartitionParam")),
           _mem_pool(new MemPool(_mem_tracker.get())) {}
 
@@ -178,8 +182,9 @@ Status OlapTablePartitionParam::init() {
         }
     }
 
+    _part_key_comparator = OlapTablePartKeyComparator(_partition_slot_descs);
     _partitions_map.reset(new std::map<Tuple*, OlapTablePartition*, OlapTablePartKeyComparator>(
-            OlapTablePartKeyComparator(_partition_slot_descs)));
+            _part_key_comparator));
     if (_t_param.__isset.distributed_columns) {
         for (auto& col : _t_param.distributed_columns) {
             auto it = slots_map.find(col);
@@ -239,6 +244,9 @@ Status OlapTablePartitionParam::init() {
         _partitions.emplace_back(part);
         _partitions_map->emplace(part->end_key, part);
     }
+    for (auto& it : *_partitions_map) {
+        _sorted_partitions.push_back(it.second);
+    }
     return Status::OK();
 }
 
@@ -256,6 +264,48 @@ bool OlapTablePartitionParam::find_tablet(Tuple* tuple, const OlapTablePartition
     return false;
 }
 
+void OlapTablePartitionParam::find_tablets(Tuple* const* tuples, int num_tuples,
+                                           const OlapTablePartition** partitions,
+                                           uint32_t* dist_hashes) const {
+    OlapTablePartition* last_partition = nullptr;
+    for (int i = 0; i < num_tuples; ++i) {
+        Tuple* tuple = tuples[i];
+        // the end key is exclusive
+        if (last_partition == nullptr || !_part_key_comparator(tuple, last_partition->end_key) ||
+            !_part_contains(last_partition, tuple)) {
+            auto it = std::upper_bound(_sorted_partitions.begin(), _sorted_partitions.end(),
+                                       tuple, [this](Tuple* key, OlapTablePartition* part) {
+                                           return _part_key_comparator(key, part->end_key);
+                                       });
+            if (it == _sorted_partitions.end() || !_part_contains(*it, tuple)) {
+                partitions[i] = nullptr;
+                continue;
+            }
+            last_partition = *it;
+        }
+        partitions[i] = last_partition;
+    }
+
+    memset(dist_hashes, 0, num_tuples * sizeof(uint32_t));
+    for (auto slot_desc : _distributed_slot_descs) {
+        //NULL is treat as 0 when hash
+        static const int INT_VALUE = 0;
+        static const TypeDescriptor INT_TYPE(TYPE_INT);
+        for (int i = 0; i < num_tuples; ++i) {
+            if (partitions[i] == nullptr) {
+                continue;
+            }
+            Tuple* tuple = tuples[i];
+            if (tuple->is_null(slot_desc->null_indicator_offset())) {
+                dist_hashes[i] = RawValue::zlib_crc32(&INT_VALUE, INT_TYPE, dist_hashes[i]);
+            } else {
+                dist_hashes[i] = RawValue::zlib_crc32(tuple->get_slot(slot_desc->tuple_offset()),
+                                                      slot_desc->type(), dist_hashes[i]);
+            }
+        }
+    }
+}
+
 Status OlapTablePartitionParam::_create_partition_keys(const std::vector<TExprNode>& t_exprs,
                                                        Tuple** part_key) {
     Tuple* tuple = (Tuple*)_mem_pool->allocate(_schema->tuple_desc()->byte_size());
@@ -156,6 +156,12 @@ public:
     bool find_tablet(Tuple* tuple, const OlapTablePartition** partitions,
                      uint32_t* dist_hash) const;
 
+    // Same as find_tablet() for 'num_tuples' tuples, the partition is nullptr if not found.
+    // The partition of the previous tuple is checked first, so a run of the tuples of a
+    // partition doesn't search the partitions. The hash values are computed a column at a time.
+    void find_tablets(Tuple* const* tuples, int num_tuples, const OlapTablePartition** partitions,
+                      uint32_t* dist_hashes) const;
+
     const std::vector<OlapTablePartition*>& get_partitions() const { return _partitions; }
     std::string debug_string() const;
 
@@ -172,8 +178,7 @@ private:
             // start_key is nullptr means the lower bound is boundless
             return true;
         }
-        OlapTablePartKeyComparator comparator(_partition_slot_descs);
-        return !comparator(key, part->start_key);
+        return !_part_key_comparator(key, part->start_key);
     }
 
 private:
@@ -183,6 +188,7 @@ private:
 
     std::vector<SlotDescriptor*> _partition_slot_descs;
     std::vector<SlotDescriptor*> _distributed_slot_descs;
+    OlapTablePartKeyComparator _part_key_comparator;
 
     ObjectPool _obj_pool;
     std::shared_ptr<MemTracker> _mem_tracker;
@@ -190,6 +196,8 @@ private:
     std::vector<OlapTablePartition*> _partitions;
     std::unique_ptr<std::map<Tuple*, OlapTablePartition*, OlapTablePartKeyComparator>>
             _partitions_map;
+    // the values of _partitions_map, in the order of the end keys
+    std::vector<OlapTablePartition*> _sorted_partitions;
 };
 
 using TabletLocation = TTabletLocation;
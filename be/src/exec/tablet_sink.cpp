@@ -103,6 +103,7 @@ void NodeChannel::open() {
     request.set_need_gen_rollup(_parent->_need_gen_rollup);
     request.set_load_mem_limit(_parent->_load_mem_limit);
     request.set_load_channel_timeout_s(_parent->_load_channel_timeout_s);
+    request.set_partial_columns(_parent->_partial_columns);
 
     _open_closure = new RefCountClosure<PTabletWriterOpenResult>();
     _open_closure->ref();
@@ -142,6 +143,7 @@ Status NodeChannel::open_wait() {
         _cancelled = true;
         LOG(WARNING) << name() << " add batch req rpc failed, " << print_load_info()
                      << ", node=" << node_info()->host << ":" << node_info()->brpc_port;
+        _parent->_notify_sender();
     });
 
     _add_batch_closure->addSuccessHandler(
@@ -178,6 +180,8 @@ Status NodeChannel::open_wait() {
                     _add_batch_counter.add_batch_wait_lock_time_us += result.wait_lock_time_us();
                     _add_batch_counter.add_batch_num++;
                 }
+                // the next pending batch can be sent now
+                _parent->_notify_sender();
             });
 
     return status;
@@ -203,6 +207,17 @@ Status NodeChannel::add_row(Tuple* input_tuple, int64_t tablet_id) {
 
     auto row_no = _cur_batch->add_row();
     if (row_no == RowBatch::INVALID_ROW_INDEX) {
+        // Back pressure, don't run too far ahead of the rpcs of this node. Other channels
+        // still have their own queued batches to send meanwhile.
+        int max_pending_batches = config::olap_table_sink_max_pending_batches_per_channel;
+        if (max_pending_batches > 0 && _pending_batches_num >= max_pending_batches) {
+            SCOPED_RAW_TIMER(&_queue_full_block_ns);
+            std::unique_lock<std::mutex> l(_pending_batches_lock);
+            while (!_cancelled && _pending_batches_num >= max_pending_batches) {
+                // _cancelled is set without the lock, so don't wait forever
+                _pending_batches_cv.wait_for(l, std::chrono::milliseconds(10));
+            }
+        }
         {
             SCOPED_RAW_TIMER(&_queue_push_lock_ns);
             std::lock_guard<std::mutex> l(_pending_batches_lock);
@@ -211,6 +226,8 @@ Status NodeChannel::add_row(Tuple* input_tuple, int64_t tablet_id) {
             _pending_batches_num++;
         }
 
+        _parent->_notify_sender();
+
         _cur_batch.reset(new RowBatch(*_row_desc, _batch_size, _parent->_mem_tracker.get()));
         _cur_add_batch_request.clear_tablet_ids();
 
@@ -237,6 +254,7 @@ Status NodeChannel::mark_close() {
         _pending_batches_num++;
         DCHECK(_pending_batches.back().second.eos());
     }
+    _parent->_notify_sender();
 
     _eos_is_produced = true;
     return Status::OK();
@@ -314,6 +332,7 @@ int NodeChannel::try_send_and_fetch_status() {
             _pending_batches.pop();
             _pending_batches_num--;
         }
+        _pending_batches_cv.notify_one();
 
         auto row_batch = std::move(send_batch.first);
         auto request = std::move(send_batch.second); // doesn't need to be saved in heap
@@ -322,7 +341,7 @@ int NodeChannel::try_send_and_fetch_status() {
         request.set_packet_seq(_next_packet_seq);
         if (row_batch->num_rows() > 0) {
             SCOPED_RAW_TIMER(&_serialize_batch_ns);
-            row_batch->serialize(request.mutable_row_batch());
+            row_batch->serialize(request.mutable_row_batch(), _parent->_compress_type);
         }
 
         _add_batch_closure->reset();
@@ -470,6 +489,7 @@ Status OlapTableSink::init(const TDataSink& t_sink) {
     } else {
         _load_channel_timeout_s = config::streaming_load_rpc_max_alive_time_sec;
     }
+    _partial_columns = table_sink.__isset.partial_columns && table_sink.partial_columns;
 
     return Status::OK();
 }
@@ -484,6 +504,15 @@ Status OlapTableSink::prepare(RuntimeState* state) {
     _profile = state->obj_pool()->add(new RuntimeProfile("OlapTableSink"));
     _mem_tracker = MemTracker::CreateTracker(-1, "OlapTableSink", state->instance_mem_tracker());
 
+    _compress_type = config::compress_rowbatches ? segment_v2::CompressionTypePB::SNAPPY
+                                                 : segment_v2::CompressionTypePB::NO_COMPRESSION;
+    if (!config::load_rowbatch_compress_type.empty() &&
+        !segment_v2::CompressionTypePB_Parse(config::load_rowbatch_compress_type,
+                                             &_compress_type)) {
+        LOG(WARNING) << "unknown load_rowbatch_compress_type "
+                     << config::load_rowbatch_compress_type << ", use the default one";
+    }
+
     SCOPED_TIMER(_profile->total_time_counter());
 
     // Prepare the exprs to run.
@@ -522,27 +551,30 @@ Status OlapTableSink::prepare(RuntimeState* state) {
 
     _max_decimalv2_val.resize(_output_tuple_desc->slots().size());
     _min_decimalv2_val.resize(_output_tuple_desc->slots().size());
-    // check if need validate batch
+    // the columns to validate
     for (int i = 0; i < _output_tuple_desc->slots().size(); ++i) {
         auto slot = _output_tuple_desc->slots()[i];
         switch (slot->type().type) {
         case TYPE_DECIMAL:
             _max_decimal_val[i].to_max_decimal(slot->type().precision, slot->type().scale);
             _min_decimal_val[i].to_min_decimal(slot->type().precision, slot->type().scale);
-            _need_validate_data = true;
+            _validate_slot_idxs.push_back(i);
             break;
         case TYPE_DECIMALV2:
             _max_decimalv2_val[i].to_max_decimal(slot->type().precision, slot->type().scale);
             _min_decimalv2_val[i].to_min_decimal(slot->type().precision, slot->type().scale);
-            _need_validate_data = true;
+            _validate_slot_idxs.push_back(i);
             break;
         case TYPE_CHAR:
         case TYPE_VARCHAR:
-        case TYPE_DATE:
-        case TYPE_DATETIME:
         case TYPE_HLL:
+            _validate_slot_idxs.push_back(i);
+            break;
         case TYPE_OBJECT:
-            _need_validate_data = true;
+            // only null is invalid
+            if (slot->is_nullable()) {
+                _validate_slot_idxs.push_back(i);
+            }
             break;
         default:
             break;
@@ -560,6 +592,8 @@ Status OlapTableSink::prepare(RuntimeState* state) {
     _close_timer = ADD_TIMER(_profile, "CloseWaitTime");
     _non_blocking_send_timer = ADD_TIMER(_profile, "NonBlockingSendTime");
     _serialize_batch_timer = ADD_TIMER(_profile, "SerializeBatchTime");
+    _mem_exceeded_block_timer = ADD_TIMER(_profile, "MemExceededBlockTime");
+    _queue_full_block_timer = ADD_TIMER(_profile, "QueueFullBlockTime");
     _load_mem_limit = state->get_load_mem_limit();
 
     // open all channels
@@ -636,21 +670,30 @@ Status OlapTableSink::send(RuntimeState* state, RowBatch* input_batch) {
     }
 
     int num_invalid_rows = 0;
-    if (_need_validate_data) {
+    if (!_validate_slot_idxs.empty()) {
         SCOPED_RAW_TIMER(&_validate_data_ns);
         _filter_bitmap.Reset(batch->num_rows());
         num_invalid_rows = _validate_data(state, batch, &_filter_bitmap);
         _number_filtered_rows += num_invalid_rows;
     }
     SCOPED_RAW_TIMER(&_send_data_ns);
+    _tuples.clear();
     for (int i = 0; i < batch->num_rows(); ++i) {
-        Tuple* tuple = batch->get_row(i)->get_tuple(0);
         if (num_invalid_rows > 0 && _filter_bitmap.Get(i)) {
             continue;
         }
-        const OlapTablePartition* partition = nullptr;
-        uint32_t dist_hash = 0;
-        if (!_partition->find_tablet(tuple, &partition, &dist_hash)) {
+        _tuples.push_back(batch->get_row(i)->get_tuple(0));
+    }
+    int num_tuples = _tuples.size();
+    _tuple_partitions.resize(num_tuples);
+    _tuple_dist_hashes.resize(num_tuples);
+    _partition->find_tablets(_tuples.data(), num_tuples, _tuple_partitions.data(),
+                             _tuple_dist_hashes.data());
+    const OlapTablePartition* last_partition = nullptr;
+    for (int i = 0; i < num_tuples; ++i) {
+        Tuple* tuple = _tuples[i];
+        const OlapTablePartition* partition = _tuple_partitions[i];
+        if (partition == nullptr) {
             std::stringstream ss;
             ss << "no partition for this tuple. tuple="
                << Tuple::to_string(tuple, *_output_tuple_desc);
@@ -662,8 +705,11 @@ Status OlapTableSink::send(RuntimeState* state, RowBatch* input_batch) {
             _number_filtered_rows++;
             continue;
         }
-        _partition_ids.emplace(partition->id);
-        uint32_t tablet_index = dist_hash % partition->num_buckets;
+        if (partition != last_partition) {
+            _partition_ids.emplace(partition->id);
+            last_partition = partition;
+        }
+        uint32_t tablet_index = _tuple_dist_hashes[i] % partition->num_buckets;
         for (int j = 0; j < partition->indexes.size(); ++j) {
             int64_t tablet_id = partition->indexes[j].tablets[tablet_index];
             RETURN_IF_ERROR(_channels[j]->add_row(tuple, tablet_id));
@@ -681,8 +727,8 @@ Status OlapTableSink::close(RuntimeState* state, Status close_status) {
         SCOPED_TIMER(_profile->total_time_counter());
         // BE id -> add_batch method counter
         std::unordered_map<int64_t, AddBatchCounter> node_add_batch_counter_map;
-        int64_t serialize_batch_ns = 0, mem_exceeded_block_ns = 0, queue_push_lock_ns = 0,
-                actual_consume_ns = 0;
+        int64_t serialize_batch_ns = 0, mem_exceeded_block_ns = 0, queue_full_block_ns = 0,
+                queue_push_lock_ns = 0, actual_consume_ns = 0;
         {
             SCOPED_TIMER(_close_timer);
             for (auto index_channel : _channels) {
@@ -692,7 +738,7 @@ Status OlapTableSink::close(RuntimeState* state, Status close_status) {
             for (auto index_channel : _channels) {
                 index_channel->for_each_node_channel([&status, &state, &node_add_batch_counter_map,
                                                       &serialize_batch_ns, &mem_exceeded_block_ns,
-                                                      &queue_push_lock_ns,
+                                                      &queue_full_block_ns, &queue_push_lock_ns,
                                                       &actual_consume_ns](NodeChannel* ch) {
                     status = ch->close_wait(state);
                     if (!status.ok()) {
@@ -701,13 +747,14 @@ Status OlapTableSink::close(RuntimeState* state, Status close_status) {
                                 << ". error_msg=" << status.get_error_msg();
                     }
                     ch->time_report(&node_add_batch_counter_map, &serialize_batch_ns,
-                                    &mem_exceeded_block_ns, &queue_push_lock_ns,
-                                    &actual_consume_ns);
+                                    &mem_exceeded_block_ns, &queue_full_block_ns,
+                                    &queue_push_lock_ns, &actual_consume_ns);
                 });
             }
         }
         // TODO need to be improved
         LOG(INFO) << "total mem_exceeded_block_ns=" << mem_exceeded_block_ns
+                  << ", total queue_full_block_ns=" << queue_full_block_ns
                   << ", total queue_push_lock_ns=" << queue_push_lock_ns
                   << ", total actual_consume_ns=" << actual_consume_ns;
 
@@ -719,6 +766,8 @@ Status OlapTableSink::close(RuntimeState* state, Status close_status) {
         COUNTER_SET(_validate_data_timer, _validate_data_ns);
         COUNTER_SET(_non_blocking_send_timer, _non_blocking_send_ns);
         COUNTER_SET(_serialize_batch_timer, serialize_batch_ns);
+        COUNTER_SET(_mem_exceeded_block_timer, mem_exceeded_block_ns);
+        COUNTER_SET(_queue_full_block_timer, queue_full_block_ns);
         // _number_input_rows don't contain num_rows_load_filtered and num_rows_load_unselected in scan node
         int64_t num_rows_load_total = _number_input_rows + state->num_rows_load_filtered() +
                                       state->num_rows_load_unselected();
@@ -744,6 +793,7 @@ Status OlapTableSink::close(RuntimeState* state, Status close_status) {
     // Sender join() must put after node channels mark_close/cancel.
     // But there is no specific sequence required between sender join() & close_wait().
     _stop_background_threads_latch.count_down();
+    _notify_sender();
     if (_sender_thread) {
         _sender_thread->join();
     }
@@ -756,27 +806,35 @@ Status OlapTableSink::close(RuntimeState* state, Status close_status) {
 void OlapTableSink::_convert_batch(RuntimeState* state, RowBatch* input_batch,
                                    RowBatch* output_batch) {
     DCHECK_GE(output_batch->capacity(), input_batch->num_rows());
-    int commit_rows = 0;
-    for (int i = 0; i < input_batch->num_rows(); ++i) {
-        auto src_row = input_batch->get_row(i);
-        Tuple* dst_tuple =
-                (Tuple*)output_batch->tuple_data_pool()->allocate(_output_tuple_desc->byte_size());
-        bool ignore_this_row = false;
-        for (int j = 0; j < _output_expr_ctxs.size(); ++j) {
-            auto src_val = _output_expr_ctxs[j]->get_value(src_row);
-            auto slot_desc = _output_tuple_desc->slots()[j];
+    int num_rows = input_batch->num_rows();
+    if (num_rows == 0) {
+        return;
+    }
+    int tuple_size = _output_tuple_desc->byte_size();
+    uint8_t* tuple_buf = output_batch->tuple_data_pool()->allocate(num_rows * tuple_size);
+    _ignored_rows.assign(num_rows, 0);
+    // an expr at a time
+    for (int j = 0; j < _output_expr_ctxs.size(); ++j) {
+        ExprContext* ctx = _output_expr_ctxs[j];
+        auto slot_desc = _output_tuple_desc->slots()[j];
+        for (int i = 0; i < num_rows; ++i) {
+            if (_ignored_rows[i]) {
+                continue;
+            }
+            Tuple* dst_tuple = reinterpret_cast<Tuple*>(tuple_buf + i * tuple_size);
+            auto src_val = ctx->get_value(input_batch->get_row(i));
             // The following logic is similar to BaseScanner::fill_dest_tuple
             // Todo(kks): we should unify it
             if (src_val == nullptr) {
                 // Only when the expr return value is null, we will check the error message.
-                std::string expr_error = _output_expr_ctxs[j]->get_error_msg();
+                std::string expr_error = ctx->get_error_msg();
                 if (!expr_error.empty()) {
                     state->append_error_msg_to_file(slot_desc->col_name(), expr_error);
                     _number_filtered_rows++;
-                    ignore_this_row = true;
+                    _ignored_rows[i] = 1;
                     // The ctx is reused, so must clear the error state and message.
-                    _output_expr_ctxs[j]->clear_error_msg();
-                    break;
+                    ctx->clear_error_msg();
+                    continue;
                 }
                 if (!slot_desc->is_nullable()) {
                     std::stringstream ss;
@@ -787,8 +845,8 @@ void OlapTableSink::_convert_batch(RuntimeState* state, RowBatch* input_batch,
                     state->append_error_msg_to_file("", ss.str());
 #endif
                     _number_filtered_rows++;
-                    ignore_this_row = true;
-                    break;
+                    _ignored_rows[i] = 1;
+                    continue;
                 }
                 dst_tuple->set_null(slot_desc->null_indicator_offset());
                 continue;
@@ -799,8 +857,12 @@ void OlapTableSink::_convert_batch(RuntimeState* state, RowBatch* input_batch,
             void* slot = dst_tuple->get_slot(slot_desc->tuple_offset());
             RawValue::write(src_val, slot, slot_desc->type(), _output_batch->tuple_data_pool());
         }
+    }
 
-        if (!ignore_this_row) {
+    int commit_rows = 0;
+    for (int i = 0; i < num_rows; ++i) {
+        if (!_ignored_rows[i]) {
+            Tuple* dst_tuple = reinterpret_cast<Tuple*>(tuple_buf + i * tuple_size);
             output_batch->get_row(commit_rows)->set_tuple(0, dst_tuple);
             commit_rows++;
         }
@@ -810,115 +872,120 @@ void OlapTableSink::_convert_batch(RuntimeState* state, RowBatch* input_batch,
 
 int OlapTableSink::_validate_data(RuntimeState* state, RowBatch* batch, Bitmap* filter_bitmap) {
     int filtered_rows = 0;
-    for (int row_no = 0; row_no < batch->num_rows(); ++row_no) {
-        Tuple* tuple = batch->get_row(row_no)->get_tuple(0);
-        bool row_valid = true;
-        std::stringstream ss; // error message
-        for (int i = 0; row_valid && i < _output_tuple_desc->slots().size(); ++i) {
-            SlotDescriptor* desc = _output_tuple_desc->slots()[i];
-            if (desc->is_nullable() && tuple->is_null(desc->null_indicator_offset())) {
-                if (desc->type().type == TYPE_OBJECT) {
-                    ss << "null is not allowed for bitmap column, column_name: "
-                       << desc->col_name();
-                    row_valid = false;
-                }
+    // a column at a time, and a row is filtered by its first invalid value
+    for (int slot_idx : _validate_slot_idxs) {
+        SlotDescriptor* desc = _output_tuple_desc->slots()[slot_idx];
+        for (int row_no = 0; row_no < batch->num_rows(); ++row_no) {
+            if (filter_bitmap->Get(row_no)) {
                 continue;
             }
-            void* slot = tuple->get_slot(desc->tuple_offset());
-            switch (desc->type().type) {
-            case TYPE_CHAR:
-            case TYPE_VARCHAR: {
-                // Fixed length string
-                StringValue* str_val = (StringValue*)slot;
-                if (str_val->len > desc->type().len) {
-                    ss << "the length of input is too long than schema. "
-                       << "column_name: " << desc->col_name() << "; "
-                       << "input_str: [" << std::string(str_val->ptr, str_val->len) << "] "
-                       << "schema length: " << desc->type().len << "; "
-                       << "actual length: " << str_val->len << "; ";
-                    row_valid = false;
-                    continue;
-                }
-                // padding 0 to CHAR field
-                if (desc->type().type == TYPE_CHAR && str_val->len < desc->type().len) {
-                    auto new_ptr = (char*)batch->tuple_data_pool()->allocate(desc->type().len);
-                    memcpy(new_ptr, str_val->ptr, str_val->len);
-                    memset(new_ptr + str_val->len, 0, desc->type().len - str_val->len);
-
-                    str_val->ptr = new_ptr;
-                    str_val->len = desc->type().len;
-                }
-                break;
-            }
-            case TYPE_DECIMAL: {
-                DecimalValue* dec_val = (DecimalValue*)slot;
-                if (dec_val->scale() > desc->type().scale) {
-                    int code = dec_val->round(dec_val, desc->type().scale, HALF_UP);
-                    if (code != E_DEC_OK) {
-                        ss << "round one decimal failed.value=" << dec_val->to_string();
-                        row_valid = false;
-                        continue;
-                    }
-                }
-                if (*dec_val > _max_decimal_val[i] || *dec_val < _min_decimal_val[i]) {
-                    ss << "decimal value is not valid for definition, column=" << desc->col_name()
-                       << ", value=" << dec_val->to_string()
-                       << ", precision=" << desc->type().precision
-                       << ", scale=" << desc->type().scale;
-                    row_valid = false;
-                    continue;
-                }
-                break;
-            }
-            case TYPE_DECIMALV2: {
-                DecimalV2Value dec_val(reinterpret_cast<const PackedInt128*>(slot)->value);
-                if (dec_val.greater_than_scale(desc->type().scale)) {
-                    int code = dec_val.round(&dec_val, desc->type().scale, HALF_UP);
-                    reinterpret_cast<PackedInt128*>(slot)->value = dec_val.value();
-                    if (code != E_DEC_OK) {
-                        ss << "round one decimal failed.value=" << dec_val.to_string();
-                        row_valid = false;
-                        continue;
-                    }
-                }
-                if (dec_val > _max_decimalv2_val[i] || dec_val < _min_decimalv2_val[i]) {
-                    ss << "decimal value is not valid for definition, column=" << desc->col_name()
-                       << ", value=" << dec_val.to_string()
-                       << ", precision=" << desc->type().precision
-                       << ", scale=" << desc->type().scale;
-                    row_valid = false;
-                    continue;
-                }
-                break;
-            }
-            case TYPE_HLL: {
-                Slice* hll_val = (Slice*)slot;
-                if (!HyperLogLog::is_valid(*hll_val)) {
-                    ss << "Content of HLL type column is invalid"
-                       << "column_name: " << desc->col_name() << "; ";
-                    row_valid = false;
-                    continue;
-                }
-                break;
-            }
-            default:
-                break;
+            Tuple* tuple = batch->get_row(row_no)->get_tuple(0);
+            std::string error_msg;
+            if (_validate_value(slot_idx, desc, tuple, batch->tuple_data_pool(), &error_msg)) {
+                continue;
             }
-        }
-
-        if (!row_valid) {
             filtered_rows++;
             filter_bitmap->Set(row_no, true);
 #if BE_TEST
-            LOG(INFO) << ss.str();
+            LOG(INFO) << error_msg;
 #else
-            state->append_error_msg_to_file("", ss.str());
+            state->append_error_msg_to_file("", error_msg);
 #endif
         }
     }
     return filtered_rows;
 }
 
+bool OlapTableSink::_validate_value(int slot_idx, SlotDescriptor* desc, Tuple* tuple,
+                                    MemPool* pool, std::string* error_msg) {
+    if (desc->is_nullable() && tuple->is_null(desc->null_indicator_offset())) {
+        if (desc->type().type == TYPE_OBJECT) {
+            *error_msg = "null is not allowed for bitmap column, column_name: " + desc->col_name();
+            return false;
+        }
+        return true;
+    }
+    void* slot = tuple->get_slot(desc->tuple_offset());
+    switch (desc->type().type) {
+    case TYPE_CHAR:
+    case TYPE_VARCHAR: {
+        // Fixed length string
+        StringValue* str_val = (StringValue*)slot;
+        if (str_val->len > desc->type().len) {
+            std::stringstream ss;
+            ss << "the length of input is too long than schema. "
+               << "column_name: " << desc->col_name() << "; "
+               << "input_str: [" << std::string(str_val->ptr, str_val->len) << "] "
+               << "schema length: " << desc->type().len << "; "
+               << "actual length: " << str_val->len << "; ";
+            *error_msg = ss.str();
+            return false;
+        }
+        // padding 0 to CHAR field
+        if (desc->type().type == TYPE_CHAR && str_val->len < desc->type().len) {
+            auto new_ptr = (char*)pool->allocate(desc->type().len);
+            memcpy(new_ptr, str_val->ptr, str_val->len);
+            memset(new_ptr + str_val->len, 0, desc->type().len - str_val->len);
+
+            str_val->ptr = new_ptr;
+            str_val->len = desc->type().len;
+        }
+        break;
+    }
+    case TYPE_DECIMAL: {
+        DecimalValue* dec_val = (DecimalValue*)slot;
+        if (dec_val->scale() > desc->type().scale) {
+            int code = dec_val->round(dec_val, desc->type().scale, HALF_UP);
+            if (code != E_DEC_OK) {
+                *error_msg = "round one decimal failed.value=" + dec_val->to_string();
+                return false;
+            }
+        }
+        if (*dec_val > _max_decimal_val[slot_idx] || *dec_val < _min_decimal_val[slot_idx]) {
+            std::stringstream ss;
+            ss << "decimal value is not valid for definition, column=" << desc->col_name()
+               << ", value=" << dec_val->to_string() << ", precision=" << desc->type().precision
+               << ", scale=" << desc->type().scale;
+            *error_msg = ss.str();
+            return false;
+        }
+        break;
+    }
+    case TYPE_DECIMALV2: {
+        DecimalV2Value dec_val(reinterpret_cast<const PackedInt128*>(slot)->value);
+        if (dec_val.greater_than_scale(desc->type().scale)) {
+            int code = dec_val.round(&dec_val, desc->type().scale, HALF_UP);
+            reinterpret_cast<PackedInt128*>(slot)->value = dec_val.value();
+            if (code != E_DEC_OK) {
+                *error_msg = "round one decimal failed.value=" + dec_val.to_string();
+                return false;
+            }
+        }
+        if (dec_val > _max_decimalv2_val[slot_idx] || dec_val < _min_decimalv2_val[slot_idx]) {
+            std::stringstream ss;
+            ss << "decimal value is not valid for definition, column=" << desc->col_name()
+               << ", value=" << dec_val.to_string() << ", precision=" << desc->type().precision
+               << ", scale=" << desc->type().scale;
+            *error_msg = ss.str();
+            return false;
+        }
+        break;
+    }
+    case TYPE_HLL: {
+        Slice* hll_val = (Slice*)slot;
+        if (!HyperLogLog::is_valid(*hll_val)) {
+            *error_msg = "Content of HLL type column is invalid, column_name: " +
+                         desc->col_name() + "; ";
+            return false;
+        }
+        break;
+    }
+    default:
+        break;
+    }
+    return true;
+}
+
 void OlapTableSink::_send_batch_process() {
     SCOPED_RAW_TIMER(&_non_blocking_send_ns);
     do {
@@ -934,8 +1001,19 @@ void OlapTableSink::_send_batch_process() {
                          "consumer thread exit.";
             return;
         }
-    } while (!_stop_background_threads_latch.wait_for(
-            MonoDelta::FromMilliseconds(config::olap_table_sink_send_interval_ms)));
+        std::unique_lock<std::mutex> l(_send_lock);
+        _send_cv.wait_for(l, std::chrono::milliseconds(config::olap_table_sink_send_interval_ms),
+                          [this]() { return _need_send; });
+        _need_send = false;
+    } while (_stop_background_threads_latch.count() > 0);
+}
+
+void OlapTableSink::_notify_sender() {
+    {
+        std::lock_guard<std::mutex> l(_send_lock);
+        _need_send = true;
+    }
+    _send_cv.notify_one();
 }
 
 } // namespace stream_load
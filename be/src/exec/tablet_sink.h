@@ -17,7 +17,9 @@
 
 #pragma once
 
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 #include <queue>
 #include <set>
 #include <string>
@@ -31,6 +33,7 @@
 #include "exec/tablet_info.h"
 #include "gen_cpp/Types_types.h"
 #include "gen_cpp/internal_service.pb.h"
+#include "gen_cpp/segment_v2.pb.h"
 #include "util/bitmap.h"
 #include "util/countdown_latch.h"
 #include "util/ref_count_closure.h"
@@ -173,10 +176,12 @@ public:
 
     void time_report(std::unordered_map<int64_t, AddBatchCounter>* add_batch_counter_map,
                      int64_t* serialize_batch_ns, int64_t* mem_exceeded_block_ns,
-                     int64_t* queue_push_lock_ns, int64_t* actual_consume_ns) {
+                     int64_t* queue_full_block_ns, int64_t* queue_push_lock_ns,
+                     int64_t* actual_consume_ns) {
         (*add_batch_counter_map)[_node_id] += _add_batch_counter;
         *serialize_batch_ns += _serialize_batch_ns;
         *mem_exceeded_block_ns += _mem_exceeded_block_ns;
+        *queue_full_block_ns += _queue_full_block_ns;
         *queue_push_lock_ns += _queue_push_lock_ns;
         *actual_consume_ns += _actual_consume_ns;
     }
@@ -228,6 +233,8 @@ private:
     using AddBatchReq = std::pair<std::unique_ptr<RowBatch>, PTabletWriterAddBatchRequest>;
     std::queue<AddBatchReq> _pending_batches;
     std::atomic<int> _pending_batches_num{0};
+    // notified when a pending batch is taken by the sender thread
+    std::condition_variable _pending_batches_cv;
 
     PBackendService_Stub* _stub = nullptr;
     RefCountClosure<PTabletWriterOpenResult>* _open_closure = nullptr;
@@ -240,6 +247,7 @@ private:
     int64_t _serialize_batch_ns = 0;
 
     int64_t _mem_exceeded_block_ns = 0;
+    int64_t _queue_full_block_ns = 0;
     int64_t _queue_push_lock_ns = 0;
     int64_t _actual_consume_ns = 0;
 };
@@ -311,11 +319,19 @@ private:
     // invalid row number is set in Bitmap
     int _validate_data(RuntimeState* state, RowBatch* batch, Bitmap* filter_bitmap);
 
+    // Validates the value of the slot 'slot_idx' of 'tuple', and pads it if it's a CHAR.
+    // Returns false with the error message if it's invalid.
+    bool _validate_value(int slot_idx, SlotDescriptor* desc, Tuple* tuple, MemPool* pool,
+                         std::string* error_msg);
+
     // the consumer func of sending pending batches in every NodeChannel.
     // use polling & NodeChannel::try_send_and_fetch_status() to achieve nonblocking sending.
     // only focus on pending batches and channel status, the internal errors of NodeChannels will be handled by the producer
     void _send_batch_process();
 
+    // wake up the sender thread to send pending batches
+    void _notify_sender();
+
 private:
     friend class NodeChannel;
     friend class IndexChannel;
@@ -342,7 +358,8 @@ private:
     std::vector<ExprContext*> _output_expr_ctxs;
     std::unique_ptr<RowBatch> _output_batch;
 
-    bool _need_validate_data = false;
+    // the indexes of the slots whose values can be invalid, see _validate_data()
+    std::vector<int> _validate_slot_idxs;
 
     // number of senders used to insert into OlapTable, if we only support single node insert,
     // all data from select should collectted and then send to OlapTable.
@@ -361,12 +378,23 @@ private:
     std::set<int64_t> _partition_ids;
 
     Bitmap _filter_bitmap;
+    // buffers of send(): the rows dropped by _convert_batch(), and the tuples to send with
+    // their partitions and distribution hash values
+    std::vector<uint8_t> _ignored_rows;
+    std::vector<Tuple*> _tuples;
+    std::vector<const OlapTablePartition*> _tuple_partitions;
+    std::vector<uint32_t> _tuple_dist_hashes;
 
     // index_channel
     std::vector<IndexChannel*> _channels;
 
     CountDownLatch _stop_background_threads_latch;
     scoped_refptr<Thread> _sender_thread;
+    // The sender thread waits on _send_cv between rounds, it's woken up when a batch is
+    // queued or an add batch rpc finishes, instead of waiting the whole send interval.
+    std::mutex _send_lock;
+    std::condition_variable _send_cv;
+    bool _need_send = false;
 
     std::vector<DecimalValue> _max_decimal_val;
     std::vector<DecimalValue> _min_decimal_val;
@@ -394,12 +422,20 @@ private:
     RuntimeProfile::Counter* _close_timer = nullptr;
     RuntimeProfile::Counter* _non_blocking_send_timer = nullptr;
     RuntimeProfile::Counter* _serialize_batch_timer = nullptr;
+    RuntimeProfile::Counter* _mem_exceeded_block_timer = nullptr;
+    RuntimeProfile::Counter* _queue_full_block_timer = nullptr;
 
     // load mem limit is for remote load channel
     int64_t _load_mem_limit = -1;
 
     // the timeout of load channels opened by this tablet sink. in second
     int64_t _load_channel_timeout_s = 0;
+
+    // the rows only update the loaded columns of a unique key table
+    bool _partial_columns = false;
+
+    // codec of the tuple data of row batches sent to load channels
+    segment_v2::CompressionTypePB _compress_type = segment_v2::CompressionTypePB::SNAPPY;
 };
 
 } // namespace stream_load
@@ -21,7 +21,11 @@
 
 #include <sstream>
 
+#include "common/config.h"
+#include "exec/olap_scan_node.h"
+#include "exec/topn_threshold.h"
 #include "exprs/expr.h"
+#include "exprs/slot_ref.h"
 #include "gen_cpp/Exprs_types.h"
 #include "gen_cpp/PlanNodes_types.h"
 #include "runtime/descriptors.h"
@@ -42,6 +46,8 @@ TopNNode::TopNNode(ObjectPool* pool, const TPlanNode& tnode, const DescriptorTbl
           _materialized_tuple_desc(NULL),
           _tuple_row_less_than(NULL),
           _tuple_pool(NULL),
+          _threshold(nullptr),
+          _threshold_slot(nullptr),
           _num_rows_skipped(0),
           _priority_queue(NULL) {}
 
@@ -60,6 +66,7 @@ Status TopNNode::init(const TPlanNode& tnode, RuntimeState* state) {
 
 Status TopNNode::prepare(RuntimeState* state) {
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_CPU_TIMER(_cpu_timer);
     RETURN_IF_ERROR(ExecNode::prepare(state));
     _tuple_pool.reset(new MemPool(mem_tracker().get()));
     RETURN_IF_ERROR(_sort_exec_exprs.prepare(state, child(0)->row_desc(), _row_descriptor,
@@ -72,11 +79,13 @@ Status TopNNode::prepare(RuntimeState* state) {
     _abort_on_default_limit_exceeded =
             _abort_on_default_limit_exceeded && state->abort_on_default_limit_exceeded();
     _materialized_tuple_desc = _row_descriptor.tuple_descriptors()[0];
+    init_threshold();
     return Status::OK();
 }
 
 Status TopNNode::open(RuntimeState* state) {
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_CPU_TIMER(_cpu_timer);
     RETURN_IF_ERROR(ExecNode::open(state));
     RETURN_IF_CANCELLED(state);
     RETURN_IF_ERROR(state->check_query_state("Top n, before open."));
@@ -112,6 +121,7 @@ Status TopNNode::open(RuntimeState* state) {
             for (int i = 0; i < batch.num_rows(); ++i) {
                 insert_tuple_row(batch.get_row(i));
             }
+            update_threshold();
             RETURN_IF_CANCELLED(state);
             RETURN_IF_ERROR(state->check_query_state("Top n, while getting next from child 0."));
         } while (!eos);
@@ -130,6 +140,7 @@ Status TopNNode::open(RuntimeState* state) {
 
 Status TopNNode::get_next(RuntimeState* state, RowBatch* row_batch, bool* eos) {
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_CPU_TIMER(_cpu_timer);
     RETURN_IF_ERROR(exec_debug_action(TExecNodePhase::GETNEXT));
     RETURN_IF_CANCELLED(state);
     RETURN_IF_ERROR(state->check_query_state("Top n, before moving result to row_batch."));
@@ -224,6 +235,52 @@ void TopNNode::prepare_for_output() {
     _get_next_iter = _sorted_top_n.begin();
 }
 
+void TopNNode::init_threshold() {
+    if (!config::enable_topn_threshold_filter || _limit <= 0 ||
+        child(0)->type() != TPlanNodeType::OLAP_SCAN_NODE) {
+        return;
+    }
+    Expr* ordering_expr = _sort_exec_exprs.lhs_ordering_expr_ctxs()[0]->root();
+    if (!ordering_expr->is_slotref()) {
+        return;
+    }
+    SlotId sort_slot_id = static_cast<SlotRef*>(ordering_expr)->slot_id();
+    // one materialization expr for each materialized slot of the sort tuple
+    int expr_idx = 0;
+    for (auto slot : _materialized_tuple_desc->slots()) {
+        if (!slot->is_materialized()) {
+            continue;
+        }
+        if (slot->id() != sort_slot_id) {
+            ++expr_idx;
+            continue;
+        }
+        Expr* slot_expr = _sort_exec_exprs.sort_tuple_slot_expr_ctxs()[expr_idx]->root();
+        if (!slot_expr->is_slotref() || !TopNThreshold::is_supported(slot->type()) ||
+            slot_expr->type() != slot->type()) {
+            return;
+        }
+        _threshold = _pool->add(new TopNThreshold(static_cast<SlotRef*>(slot_expr)->slot_id(),
+                                                  slot->type(), _is_asc_order[0],
+                                                  _nulls_first[0]));
+        _threshold_slot = slot;
+        static_cast<OlapScanNode*>(child(0))->set_topn_threshold(_threshold);
+        return;
+    }
+}
+
+void TopNNode::update_threshold() {
+    if (_threshold == nullptr || _priority_queue->size() < _offset + _limit) {
+        return;
+    }
+    Tuple* worst = _priority_queue->top();
+    // a null threshold can't be pushed down, the one published before still holds
+    if (worst->is_null(_threshold_slot->null_indicator_offset())) {
+        return;
+    }
+    _threshold->update(worst->get_slot(_threshold_slot->tuple_offset()));
+}
+
 void TopNNode::debug_string(int indentation_level, std::stringstream* out) const {
     *out << std::string(indentation_level * 2, ' ');
     *out << "TopNNode("
@@ -29,6 +29,7 @@ namespace doris {
 
 class MemPool;
 class RuntimeState;
+class TopNThreshold;
 class Tuple;
 
 // Node for in-memory TopN (ORDER BY ... LIMIT)
@@ -61,6 +62,13 @@ private:
     // Flatten and reverse the priority queue.
     void prepare_for_output();
 
+    // Create _threshold and hand it to the child if the child is an OlapScanNode and
+    // the first ordering expr is one of its slots.
+    void init_threshold();
+
+    // Publish the first ordering slot of the worst row of the full priority queue.
+    void update_threshold();
+
     // number rows to skipped
     int64_t _offset;
 
@@ -91,6 +99,12 @@ private:
     std::vector<Tuple*>::iterator _get_next_iter;
     // std::vector<TupleRow*>::iterator _get_next_iter;
 
+    // Rows of the child worse than it can't enter the TopN, nullptr if the child
+    // can't make use of it.
+    TopNThreshold* _threshold;
+    // The slot of the materialized tuple _threshold is taken from.
+    const SlotDescriptor* _threshold_slot;
+
     // True if the _limit comes from DEFAULT_ORDER_BY_LIMIT and the query option
     // ABORT_ON_DEFAULT_LIMIT_EXCEEDED is set.
     bool _abort_on_default_limit_exceeded;
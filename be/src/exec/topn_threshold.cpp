@@ -0,0 +1,140 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "exec/topn_threshold.h"
+
+#include <cstring>
+#include <sstream>
+
+#include "runtime/decimalv2_value.h"
+#include "runtime/raw_value.h"
+
+namespace doris {
+
+TopNThreshold::TopNThreshold(SlotId slot_id, const TypeDescriptor& type, bool is_asc,
+                             bool nulls_first)
+        : _slot_id(slot_id), _type(type), _is_asc(is_asc), _nulls_first(nulls_first) {
+    DCHECK(is_supported(type));
+}
+
+bool TopNThreshold::is_supported(const TypeDescriptor& type) {
+    switch (type.type) {
+    case TYPE_TINYINT:
+    case TYPE_SMALLINT:
+    case TYPE_INT:
+    case TYPE_BIGINT:
+    case TYPE_LARGEINT:
+    case TYPE_FLOAT:
+    case TYPE_DOUBLE:
+    case TYPE_DATE:
+    case TYPE_DATETIME:
+    case TYPE_DECIMALV2:
+    case TYPE_CHAR:
+    case TYPE_VARCHAR:
+        return true;
+    default:
+        return false;
+    }
+}
+
+void TopNThreshold::update(const void* value) {
+    DCHECK(value != nullptr);
+    std::lock_guard<std::mutex> l(_lock);
+    if (_type.is_string_type()) {
+        const StringValue* string_value = reinterpret_cast<const StringValue*>(value);
+        StringValue current(_string_data);
+        if (_version.load(std::memory_order_relaxed) > 0 && *string_value == current) {
+            return;
+        }
+        _string_data.assign(string_value->ptr, string_value->len);
+    } else {
+        if (_version.load(std::memory_order_relaxed) > 0 &&
+            memcmp(_fixed, value, _type.get_slot_size()) == 0) {
+            return;
+        }
+        memcpy(_fixed, value, _type.get_slot_size());
+    }
+    // readers only refresh their snapshots when the version changes
+    _version.fetch_add(1, std::memory_order_release);
+}
+
+void TopNThreshold::get(Snapshot* snapshot) const {
+    std::lock_guard<std::mutex> l(_lock);
+    snapshot->_version = _version.load(std::memory_order_relaxed);
+    snapshot->_type = _type;
+    snapshot->_is_asc = _is_asc;
+    snapshot->_nulls_first = _nulls_first;
+    if (_type.is_string_type()) {
+        snapshot->_string_data = _string_data;
+        snapshot->_string_value = StringValue(const_cast<char*>(snapshot->_string_data.data()),
+                                              snapshot->_string_data.size());
+    } else {
+        memcpy(snapshot->_fixed, _fixed, sizeof(_fixed));
+    }
+}
+
+bool TopNThreshold::Snapshot::pass(const void* value) const {
+    if (_version == 0) {
+        return true;
+    }
+    if (value == nullptr) {
+        return _nulls_first;
+    }
+    // ties pass, they may still be ordered before the threshold by later ordering exprs
+    int cmp = RawValue::compare(value, _value(), _type);
+    return _is_asc ? cmp <= 0 : cmp >= 0;
+}
+
+bool TopNThreshold::Snapshot::to_condition(const std::string& column_name,
+                                           TCondition* condition) const {
+    if (_version == 0) {
+        return false;
+    }
+    std::string value;
+    switch (_type.type) {
+    case TYPE_TINYINT:
+    case TYPE_SMALLINT:
+    case TYPE_INT:
+    case TYPE_BIGINT:
+    case TYPE_LARGEINT:
+    case TYPE_DATE:
+    case TYPE_DATETIME: {
+        std::stringstream ss;
+        RawValue::print_value(_value(), _type, -1, &ss);
+        value = ss.str();
+        break;
+    }
+    case TYPE_DECIMALV2:
+        value = reinterpret_cast<const DecimalV2Value*>(_fixed)->to_string();
+        break;
+    case TYPE_VARCHAR:
+        value = _string_data;
+        break;
+    default:
+        // a printed float may be rounded beyond the threshold, and char columns
+        // are padded in the storage
+        return false;
+    }
+    condition->__set_column_name(column_name);
+    // null is taken as the min value of a zone, such zones are never skipped
+    condition->__set_condition_op(_is_asc ? "<=" : ">=");
+    condition->condition_values.clear();
+    condition->condition_values.push_back(value);
+    return true;
+}
+
+} // namespace doris
@@ -0,0 +1,103 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#ifndef DORIS_BE_SRC_QUERY_EXEC_TOPN_THRESHOLD_H
+#define DORIS_BE_SRC_QUERY_EXEC_TOPN_THRESHOLD_H
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+#include "common/global_types.h"
+#include "gen_cpp/PaloInternalService_types.h"
+#include "runtime/string_value.h"
+#include "runtime/types.h"
+
+namespace doris {
+
+// The worst value of the first ordering expr of a TOP-N among the rows in its priority
+// queue once the queue is full. A row whose value is worse can't enter the TOP-N.
+//
+// TopNNode tightens it as better rows replace the worst one of its queue, and the
+// scanners of its child OlapScanNode use it to drop rows before they are returned,
+// in the storage where they can. The first ordering expr must be a slot of the scan.
+// Thread safe, readers work on a Snapshot they refresh when version() changes.
+class TopNThreshold {
+public:
+    TopNThreshold(SlotId slot_id, const TypeDescriptor& type, bool is_asc, bool nulls_first);
+
+    // Return true if the threshold can be kept for values of 'type'.
+    static bool is_supported(const TypeDescriptor& type);
+
+    SlotId slot_id() const { return _slot_id; }
+    const TypeDescriptor& type() const { return _type; }
+
+    // Set the threshold to 'value', which is not null and not worse than the current one.
+    void update(const void* value);
+
+    // Number of updates so far, 0 until there's a threshold.
+    int64_t version() const { return _version.load(std::memory_order_acquire); }
+
+    // A copy of the threshold owned by one reader.
+    class Snapshot {
+    public:
+        int64_t version() const { return _version; }
+
+        // Return false if a row of 'value', nullptr for null, can't enter the TOP-N.
+        bool pass(const void* value) const;
+
+        // Fill 'condition' on 'column_name' with a condition the values passing this
+        // snapshot satisfy, to skip pages by zone maps. Return false if there is none.
+        bool to_condition(const std::string& column_name, TCondition* condition) const;
+
+    private:
+        friend class TopNThreshold;
+
+        const void* _value() const {
+            return _type.is_string_type() ? static_cast<const void*>(&_string_value)
+                                          : static_cast<const void*>(_fixed);
+        }
+
+        int64_t _version = 0;
+        TypeDescriptor _type;
+        bool _is_asc = true;
+        bool _nulls_first = true;
+        alignas(16) uint8_t _fixed[16];
+        std::string _string_data;
+        StringValue _string_value;
+    };
+
+    // Refresh 'snapshot' to the current threshold.
+    void get(Snapshot* snapshot) const;
+
+private:
+    const SlotId _slot_id;
+    const TypeDescriptor _type;
+    const bool _is_asc;
+    const bool _nulls_first;
+
+    mutable std::mutex _lock;
+    std::atomic<int64_t> _version{0};
+    // protected by _lock
+    alignas(16) uint8_t _fixed[16];
+    std::string _string_data;
+};
+
+} // namespace doris
+
+#endif
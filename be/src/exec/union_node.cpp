@@ -19,6 +19,7 @@
 
 #include "exprs/expr.h"
 #include "exprs/expr_context.h"
+#include "exprs/slot_ref.h"
 #include "runtime/row_batch.h"
 #include "runtime/runtime_state.h"
 #include "runtime/tuple.h"
@@ -68,6 +69,7 @@ Status UnionNode::init(const TPlanNode& tnode, RuntimeState* state) {
 
 Status UnionNode::prepare(RuntimeState* state) {
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_CPU_TIMER(_cpu_timer);
     RETURN_IF_ERROR(ExecNode::prepare(state));
     _tuple_desc = state->desc_tbl().get_tuple_descriptor(_tuple_id);
     DCHECK(_tuple_desc != nullptr);
@@ -90,11 +92,34 @@ Status UnionNode::prepare(RuntimeState* state) {
         // AddExprCtxsToFree(_child_expr_lists[i]);
         DCHECK_EQ(_child_expr_lists[i].size(), _tuple_desc->slots().size());
     }
+
+    // Children whose result exprs are plain slots are materialized by copying the slots.
+    _child_slot_copies.resize(_child_expr_lists.size());
+    for (int i = _first_materialized_child_idx; i < _child_expr_lists.size(); ++i) {
+        std::vector<SlotCopy> slot_copies;
+        int mat_expr_idx = 0;
+        for (const SlotDescriptor* slot_desc : _tuple_desc->slots()) {
+            if (!slot_desc->is_materialized()) {
+                continue;
+            }
+            Expr* expr = _child_expr_lists[i][mat_expr_idx++]->root();
+            bool same_type = expr->type().type == slot_desc->type().type ||
+                             (expr->type().is_string_type() && slot_desc->type().is_string_type());
+            if (expr->node_type() != TExprNodeType::SLOT_REF || !same_type) {
+                slot_copies.clear();
+                break;
+            }
+            slot_copies.push_back({expr, slot_desc->tuple_offset(),
+                                   slot_desc->null_indicator_offset(), slot_desc->slot_size()});
+        }
+        _child_slot_copies[i] = std::move(slot_copies);
+    }
     return Status::OK();
 }
 
 Status UnionNode::open(RuntimeState* state) {
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_CPU_TIMER(_cpu_timer);
     RETURN_IF_ERROR(ExecNode::open(state));
     // open const expr lists.
     for (const std::vector<ExprContext*>& exprs : _const_expr_lists) {
@@ -167,8 +192,13 @@ Status UnionNode::get_next_materialized(RuntimeState* state, RowBatch* row_batch
             if (_child_row_idx == _child_batch->num_rows()) {
                 // Move on to the next child if it is at eos.
                 if (_child_eos) break;
-                // Fetch more rows from the child.
-                _child_batch->reset();
+                // Fetch more rows from the child, passing on the resources rows copied
+                // shallowly still reference.
+                if (is_child_shallow_copied(_child_idx)) {
+                    _child_batch->transfer_resource_ownership(row_batch);
+                } else {
+                    _child_batch->reset();
+                }
                 _child_row_idx = 0;
                 // All batches except the first batch from each child are fetched here.
                 RETURN_IF_ERROR(
@@ -190,6 +220,16 @@ Status UnionNode::get_next_materialized(RuntimeState* state, RowBatch* row_batch
         DCHECK(!reached_limit());
 
         if (_child_eos && _child_row_idx == _child_batch->num_rows()) {
+            if (is_child_shallow_copied(_child_idx) && !is_in_subplan()) {
+                // As for passthrough children, the child can't be closed before the rows
+                // of 'row_batch' are consumed, it's closed in the next get_next() call.
+                _child_batch->transfer_resource_ownership(row_batch);
+                _child_batch.reset();
+                row_batch->mark_needs_deep_copy();
+                _to_close_child_idx = _child_idx;
+                ++_child_idx;
+                break;
+            }
             // Unless we are inside a subplan expecting to call open()/get_next() on the child
             // again, the child can be closed at this point.
             _child_batch.reset();
@@ -228,15 +268,17 @@ Status UnionNode::get_next_const(RuntimeState* state, RowBatch* row_batch) {
 
 Status UnionNode::get_next(RuntimeState* state, RowBatch* row_batch, bool* eos) {
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_CPU_TIMER(_cpu_timer);
     RETURN_IF_ERROR(exec_debug_action(TExecNodePhase::GETNEXT));
     RETURN_IF_CANCELLED(state);
     // TODO(zc)
     // RETURN_IF_ERROR(QueryMaintenance(state));
 
     if (_to_close_child_idx != -1) {
-        // The previous child needs to be closed if passthrough was enabled for it. In the non
-        // passthrough case, the child was already closed in the previous call to get_next().
-        DCHECK(is_child_passthrough(_to_close_child_idx));
+        // The previous child needs to be closed if passthrough or shallow copy was enabled for
+        // it. Otherwise the child was already closed in the previous call to get_next().
+        DCHECK(is_child_passthrough(_to_close_child_idx) ||
+               is_child_shallow_copied(_to_close_child_idx));
         DCHECK(!is_in_subplan());
         child(_to_close_child_idx)->close(state);
         _to_close_child_idx = -1;
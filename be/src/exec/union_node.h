@@ -21,12 +21,14 @@
 
 #include "codegen/doris_ir.h"
 #include "exec/exec_node.h"
+#include "runtime/descriptors.h"
 #include "runtime/row_batch.h"
 #include "runtime/runtime_state.h"
 
 namespace doris {
 
 class DescriptorTbl;
+class Expr;
 class ExprContext;
 class Tuple;
 class TupleRow;
@@ -72,6 +74,19 @@ private:
     /// Exprs materialized by this node. The i-th result expr list refers to the i-th child.
     std::vector<std::vector<ExprContext*>> _child_expr_lists;
 
+    /// A slot of the output tuple copied from a slot of a child row.
+    struct SlotCopy {
+        Expr* src_slot_ref;
+        int dst_offset;
+        NullIndicatorOffset dst_null_indicator_offset;
+        int size;
+    };
+    /// The i-th list copies the slots of rows of the i-th child if all its result exprs
+    /// are slots of the same types as the output, and is empty otherwise. Such children
+    /// are materialized by a shallow copy of the slots: their string data are not copied
+    /// but passed on with the resources of the child batches.
+    std::vector<std::vector<SlotCopy>> _child_slot_copies;
+
     /////////////////////////////////////////
     /// BEGIN: Members that must be Reset()
 
@@ -98,7 +113,8 @@ private:
     /// Index of current const result expr list.
     int _const_expr_list_idx;
 
-    /// Index of the child that needs to be closed on the next GetNext() call. Should be set
+    /// Index of the child that needs to be closed on the next GetNext() call, a passthrough
+    /// or shallow copied child whose last batch may reference its memory. Should be set
     /// to -1 if no child needs to be closed.
     int _to_close_child_idx;
 
@@ -132,6 +148,16 @@ private:
     void materialize_exprs(const std::vector<ExprContext*>& exprs, TupleRow* row,
                            uint8_t* tuple_buf, RowBatch* dst_batch);
 
+    /// Copies the slots of 'row' by 'slot_copies' into 'tuple_buf' and appends the new
+    /// tuple to 'dst_batch'.
+    void copy_slots(const std::vector<SlotCopy>& slot_copies, TupleRow* row, uint8_t* tuple_buf,
+                    RowBatch* dst_batch);
+
+    /// Returns true if rows of the child at 'child_idx' are materialized by a shallow copy.
+    bool is_child_shallow_copied(int child_idx) const {
+        return !_child_slot_copies[child_idx].empty();
+    }
+
     Status get_error_msg(const std::vector<ExprContext*>& exprs);
 
     /// Returns true if the child at 'child_idx' can be passed through.
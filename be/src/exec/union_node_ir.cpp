@@ -17,6 +17,7 @@
 
 #include "exec/union_node.h"
 #include "exprs/expr_context.h"
+#include "exprs/slot_ref.h"
 #include "runtime/tuple_row.h"
 
 namespace doris {
@@ -34,6 +35,25 @@ void IR_ALWAYS_INLINE UnionNode::materialize_exprs(const std::vector<ExprContext
     dst_batch->commit_last_row();
 }
 
+void IR_ALWAYS_INLINE UnionNode::copy_slots(const std::vector<SlotCopy>& slot_copies,
+                                            TupleRow* row, uint8_t* tuple_buf,
+                                            RowBatch* dst_batch) {
+    DCHECK(!dst_batch->at_capacity());
+    Tuple* dst_tuple = reinterpret_cast<Tuple*>(tuple_buf);
+    TupleRow* dst_row = dst_batch->get_row(dst_batch->add_row());
+    memset(dst_tuple, 0, _tuple_desc->num_null_bytes());
+    for (const SlotCopy& slot_copy : slot_copies) {
+        void* src = SlotRef::get_value(slot_copy.src_slot_ref, row);
+        if (src == nullptr) {
+            dst_tuple->set_null(slot_copy.dst_null_indicator_offset);
+        } else {
+            memcpy(dst_tuple->get_slot(slot_copy.dst_offset), src, slot_copy.size);
+        }
+    }
+    dst_row->set_tuple(0, dst_tuple);
+    dst_batch->commit_last_row();
+}
+
 void UnionNode::materialize_batch(RowBatch* dst_batch, uint8_t** tuple_buf) {
     // Take all references to member variables out of the loop to reduce the number of
     // loads and stores.
@@ -44,10 +64,18 @@ void UnionNode::materialize_batch(RowBatch* dst_batch, uint8_t** tuple_buf) {
 
     int num_rows_to_process = std::min(child_batch->num_rows() - _child_row_idx,
                                        dst_batch->capacity() - dst_batch->num_rows());
-    FOREACH_ROW_LIMIT(child_batch, _child_row_idx, num_rows_to_process, batch_iter) {
-        TupleRow* child_row = batch_iter.get();
-        materialize_exprs(child_exprs, child_row, cur_tuple, dst_batch);
-        cur_tuple += tuple_byte_size;
+    const std::vector<SlotCopy>& slot_copies = _child_slot_copies[_child_idx];
+    if (!slot_copies.empty()) {
+        FOREACH_ROW_LIMIT(child_batch, _child_row_idx, num_rows_to_process, batch_iter) {
+            copy_slots(slot_copies, batch_iter.get(), cur_tuple, dst_batch);
+            cur_tuple += tuple_byte_size;
+        }
+    } else {
+        FOREACH_ROW_LIMIT(child_batch, _child_row_idx, num_rows_to_process, batch_iter) {
+            TupleRow* child_row = batch_iter.get();
+            materialize_exprs(child_exprs, child_row, cur_tuple, dst_batch);
+            cur_tuple += tuple_byte_size;
+        }
     }
 
     _child_row_idx += num_rows_to_process;
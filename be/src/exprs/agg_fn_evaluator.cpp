@@ -17,15 +17,18 @@
 
 #include "exprs/agg_fn_evaluator.h"
 
+#include <numeric>
 #include <sstream>
 
 #include "common/logging.h"
 #include "exec/aggregation_node.h"
 #include "exprs/aggregate_functions.h"
 #include "exprs/anyval_util.h"
+#include "exprs/expr_column.h"
 #include "runtime/datetime_value.h"
 #include "runtime/mem_tracker.h"
 #include "runtime/raw_value.h"
+#include "runtime/row_batch.h"
 #include "runtime/user_function_cache.h"
 #include "thrift/protocol/TDebugProtocol.h"
 #include "udf/udf_internal.h"
@@ -104,6 +107,7 @@ AggFnEvaluator::AggFnEvaluator(const TExprNode& desc, bool is_analytic_fn)
           _output_slot_desc(NULL),
           _init_fn(NULL),
           _update_fn(NULL),
+          _update_batch_fn(NULL),
           _remove_fn(NULL),
           _merge_fn(NULL),
           _serialize_fn(NULL),
@@ -200,6 +204,12 @@ Status AggFnEvaluator::prepare(RuntimeState* state, const RowDescriptor& desc, M
             _fn.id, _fn.aggregate_fn.update_fn_symbol, _fn.hdfs_location, _fn.checksum, &_update_fn,
             NULL));
 
+    if (!_fn.aggregate_fn.update_batch_fn_symbol.empty() && !_is_analytic_fn) {
+        RETURN_IF_ERROR(UserFunctionCache::instance()->get_function_ptr(
+                _fn.id, _fn.aggregate_fn.update_batch_fn_symbol, _fn.hdfs_location,
+                _fn.checksum, &_update_batch_fn, NULL));
+    }
+
     // Merge() is not loaded if evaluating the agg fn as an analytic function.
     if (!_is_analytic_fn) {
         RETURN_IF_ERROR(UserFunctionCache::instance()->get_function_ptr(
@@ -789,6 +799,38 @@ void AggFnEvaluator::update_or_merge(FunctionContext* agg_fn_ctx, TupleRow* row,
     set_output_slot(_staging_intermediate_val, _intermediate_slot_desc, dst);
 }
 
+void AggFnEvaluator::add_batch(FunctionContext* agg_fn_ctx, RowBatch* batch, Tuple* dst) {
+    int num_rows = batch->num_rows();
+    if (_update_batch_fn == NULL || _is_merge || _is_multi_distinct) {
+        for (int i = 0; i < num_rows; ++i) {
+            add(agg_fn_ctx, batch->get_row(i), dst);
+        }
+        return;
+    }
+    if (num_rows == 0) {
+        return;
+    }
+
+    std::vector<int> rows(num_rows);
+    std::iota(rows.begin(), rows.end(), 0);
+    std::vector<ExprColumn> input_columns(_input_exprs_ctxs.size());
+    std::vector<const AnyVal*> input_vals(_input_exprs_ctxs.size());
+    for (int i = 0; i < _input_exprs_ctxs.size(); ++i) {
+        _input_exprs_ctxs[i]->evaluate_batch(batch, rows.data(), num_rows, &input_columns[i]);
+        input_vals[i] = input_columns[i].any_val(0);
+    }
+
+    void* dst_slot = NULL;
+    if (!dst->is_null(_intermediate_slot_desc->null_indicator_offset())) {
+        dst_slot = dst->get_slot(_intermediate_slot_desc->tuple_offset());
+    }
+    set_any_val(dst_slot, _intermediate_slot_desc->type(), _staging_intermediate_val);
+    reinterpret_cast<doris_udf::UdaUpdateBatch>(_update_batch_fn)(
+            agg_fn_ctx, num_rows, rows.data(), input_vals.data(), _staging_intermediate_val);
+    agg_fn_ctx->impl()->increment_num_updates(num_rows);
+    set_output_slot(_staging_intermediate_val, _intermediate_slot_desc, dst);
+}
+
 void AggFnEvaluator::update(FunctionContext* agg_fn_ctx, TupleRow* row, Tuple* dst, void* fn,
                             MemPool* pool) {
     return update_or_merge(agg_fn_ctx, row, dst, fn);
@@ -36,6 +36,7 @@
 namespace doris {
 
 class AggregationNode;
+class RowBatch;
 class TExprNode;
 
 // This class evaluates aggregate functions. Aggregate functions can either be
@@ -94,6 +95,8 @@ public:
     AggregationOp agg_op() const { return _agg_op; }
     const std::vector<ExprContext*>& input_expr_ctxs() const { return _input_exprs_ctxs; }
     bool is_merge() const { return _is_merge; }
+    // Whether remove() is supported, valid after prepare().
+    bool has_remove_fn() const { return _remove_fn != NULL; }
     bool is_count_star() const {
         return _agg_op == AggregationOp::COUNT && _input_exprs_ctxs.empty();
     }
@@ -108,6 +111,11 @@ public:
     // is_merge_. That is, from the caller, it doesn't mater.
     void add(doris_udf::FunctionContext* agg_fn_ctx, TupleRow* src, Tuple* dst);
 
+    // Adds all the rows of 'batch' to dst. The inputs are evaluated a batch at a time and
+    // the batch form of the update function is called once if the UDA has one, otherwise
+    // the rows are added one by one.
+    void add_batch(doris_udf::FunctionContext* agg_fn_ctx, RowBatch* batch, Tuple* dst);
+
     // Updates the intermediate state dst to remove the input src row, i.e. undoes
     // add(src, dst). Only used internally for analytic fn builtins.
     void remove(doris_udf::FunctionContext* agg_fn_ctx, TupleRow* src, Tuple* dst);
@@ -162,6 +170,9 @@ public:
     static void add(const std::vector<AggFnEvaluator*>& evaluators,
                     const std::vector<doris_udf::FunctionContext*>& fn_ctxs, TupleRow* src,
                     Tuple* dst);
+    static void add_batch(const std::vector<AggFnEvaluator*>& evaluators,
+                          const std::vector<doris_udf::FunctionContext*>& fn_ctxs,
+                          RowBatch* batch, Tuple* dst);
     static void remove(const std::vector<AggFnEvaluator*>& evaluators,
                        const std::vector<doris_udf::FunctionContext*>& fn_ctxs, TupleRow* src,
                        Tuple* dst);
@@ -230,6 +241,8 @@ private:
 
     void* _init_fn;
     void* _update_fn;
+    // The batch form of _update_fn, optional
+    void* _update_batch_fn;
     void* _remove_fn;
     void* _merge_fn;
     void* _serialize_fn;
@@ -309,6 +322,15 @@ inline void AggFnEvaluator::add(const std::vector<AggFnEvaluator*>& evaluators,
         evaluators[i]->add(fn_ctxs[i], src, dst);
     }
 }
+inline void AggFnEvaluator::add_batch(const std::vector<AggFnEvaluator*>& evaluators,
+                                      const std::vector<doris_udf::FunctionContext*>& fn_ctxs,
+                                      RowBatch* batch, Tuple* dst) {
+    DCHECK_EQ(evaluators.size(), fn_ctxs.size());
+
+    for (int i = 0; i < evaluators.size(); ++i) {
+        evaluators[i]->add_batch(fn_ctxs[i], batch, dst);
+    }
+}
 inline void AggFnEvaluator::remove(const std::vector<AggFnEvaluator*>& evaluators,
                                    const std::vector<doris_udf::FunctionContext*>& fn_ctxs,
                                    TupleRow* src, Tuple* dst) {
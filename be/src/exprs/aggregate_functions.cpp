@@ -20,15 +20,21 @@
 
 #include <math.h>
 
+#include <algorithm>
+#include <limits>
 #include <sstream>
+#include <type_traits>
 #include <unordered_set>
+#include <vector>
 
+#include "common/config.h"
 #include "common/logging.h"
 #include "exprs/anyval_util.h"
 #include "exprs/hybrid_set.h"
 #include "runtime/datetime_value.h"
 #include "runtime/runtime_state.h"
 #include "runtime/string_value.h"
+#include "util/coding.h"
 #include "util/debug_util.h"
 #include "util/tdigest.h"
 
@@ -54,6 +60,46 @@ using doris_udf::AnyVal;
 // Delimiter to use if the separator is NULL.
 static const StringVal DEFAULT_STRING_CONCAT_DELIM((uint8_t*)", ", 2);
 
+// Adds 'val' to the raw value of a decimalv2 sum, saturating at +/-MAX_DECIMAL_VALUE like
+// DecimalV2Value's operator+ does, without the conversions to DecimalV2Value. The
+// operands are far below the int128 limits, e.g. the sum of a batch of values.
+static inline void add_decimalv2(__int128 val, __int128* sum) {
+    *sum += val;
+    if (UNLIKELY(*sum > DecimalV2Value::MAX_DECIMAL_VALUE)) {
+        *sum = DecimalV2Value::MAX_DECIMAL_VALUE;
+    } else if (UNLIKELY(*sum < -DecimalV2Value::MAX_DECIMAL_VALUE)) {
+        *sum = -DecimalV2Value::MAX_DECIMAL_VALUE;
+    }
+}
+
+// Adds the non null values of 'vals' to '*sum' with the same result as add_decimalv2() on
+// every value in turn, and returns their number. Each value is at most MAX_DECIMAL_VALUE
+// (< 2^93), so the sums of a batch can't overflow the int128. If the absolute values can't
+// take the running sum out of the decimal range, they're added at once without saturating,
+// otherwise the values are added one by one.
+static int add_decimalv2_vals(const DecimalV2Val* vals, int num_vals, __int128* sum) {
+    __int128 batch_sum = 0;
+    __int128 batch_abs_sum = 0;
+    int num_non_null = 0;
+    for (int i = 0; i < num_vals; ++i) {
+        __int128 val = vals[i].is_null ? 0 : vals[i].val;
+        batch_sum += val;
+        batch_abs_sum += val < 0 ? -val : val;
+        num_non_null += !vals[i].is_null;
+    }
+    __int128 abs_sum = *sum < 0 ? -*sum : *sum;
+    if (LIKELY(abs_sum + batch_abs_sum <= DecimalV2Value::MAX_DECIMAL_VALUE)) {
+        *sum += batch_sum;
+        return num_non_null;
+    }
+    for (int i = 0; i < num_vals; ++i) {
+        if (!vals[i].is_null) {
+            add_decimalv2(vals[i].val, sum);
+        }
+    }
+    return num_non_null;
+}
+
 void AggregateFunctions::init_null(FunctionContext*, AnyVal* dst) {
     dst->is_null = true;
 }
@@ -227,6 +273,27 @@ void AggregateFunctions::percentile_approx_update(FunctionContext* ctx, const T&
     percentile->targetQuantile = quantile.val;
 }
 
+void AggregateFunctions::percentile_approx_update_batch(FunctionContext* ctx,
+                                                        const DoubleVal* vals, int num_vals,
+                                                        StringVal* dst) {
+    DCHECK(dst->ptr != NULL);
+    DCHECK_EQ(sizeof(PercentileApproxState), dst->len);
+    DCHECK(ctx->is_arg_constant(1));
+
+    std::vector<float> values(num_vals);
+    int num_values = 0;
+    for (int i = 0; i < num_vals; ++i) {
+        values[num_values] = vals[i].val;
+        num_values += !vals[i].is_null;
+    }
+    if (num_values == 0) {
+        return;
+    }
+    PercentileApproxState* percentile = reinterpret_cast<PercentileApproxState*>(dst->ptr);
+    percentile->digest->add(values.data(), num_values);
+    percentile->targetQuantile = reinterpret_cast<const DoubleVal*>(ctx->get_constant_arg(1))->val;
+}
+
 StringVal AggregateFunctions::percentile_approx_serialize(FunctionContext* ctx,
                                                           const StringVal& src) {
     DCHECK(!src.is_null);
@@ -249,15 +316,33 @@ void AggregateFunctions::percentile_approx_merge(FunctionContext* ctx, const Str
     double quantile;
     memcpy(&quantile, src.ptr, sizeof(double));
 
-    PercentileApproxState* src_percentile = new PercentileApproxState();
-    src_percentile->targetQuantile = quantile;
-    src_percentile->digest->unserialize(src.ptr + sizeof(double));
-
     PercentileApproxState* dst_percentile = reinterpret_cast<PercentileApproxState*>(dst->ptr);
-    dst_percentile->digest->merge(src_percentile->digest);
+    dst_percentile->digest->merge(std::vector<const uint8_t*>{src.ptr + sizeof(double)});
     dst_percentile->targetQuantile = quantile;
+}
 
-    delete src_percentile;
+void AggregateFunctions::percentile_approx_merge_batch(FunctionContext* ctx,
+                                                       const StringVal* vals, int num_vals,
+                                                       StringVal* dst) {
+    DCHECK(dst->ptr != NULL);
+    DCHECK_EQ(sizeof(PercentileApproxState), dst->len);
+
+    std::vector<const uint8_t*> digests;
+    digests.reserve(num_vals);
+    double quantile = 0;
+    for (int i = 0; i < num_vals; ++i) {
+        if (vals[i].is_null) {
+            continue;
+        }
+        memcpy(&quantile, vals[i].ptr, sizeof(double));
+        digests.push_back(vals[i].ptr + sizeof(double));
+    }
+    if (digests.empty()) {
+        return;
+    }
+    PercentileApproxState* dst_percentile = reinterpret_cast<PercentileApproxState*>(dst->ptr);
+    dst_percentile->digest->merge(digests);
+    dst_percentile->targetQuantile = quantile;
 }
 
 DoubleVal AggregateFunctions::percentile_approx_finalize(FunctionContext* ctx,
@@ -350,15 +435,19 @@ void AggregateFunctions::decimalv2_avg_update(FunctionContext* ctx, const Decima
     DCHECK(dst->ptr != NULL);
     DCHECK_EQ(sizeof(DecimalV2AvgState), dst->len);
     DecimalV2AvgState* avg = reinterpret_cast<DecimalV2AvgState*>(dst->ptr);
-
-    DecimalV2Value v1 = DecimalV2Value::from_decimal_val(avg->sum);
-    DecimalV2Value v2 = DecimalV2Value::from_decimal_val(src);
-    DecimalV2Value v = v1 + v2;
-    v.to_decimal_val(&avg->sum);
-
+    add_decimalv2(src.val, &avg->sum.val);
     ++avg->count;
 }
 
+void AggregateFunctions::decimalv2_avg_update_batch(FunctionContext* ctx,
+                                                    const DecimalV2Val* vals, int num_vals,
+                                                    StringVal* dst) {
+    DCHECK(dst->ptr != NULL);
+    DCHECK_EQ(sizeof(DecimalV2AvgState), dst->len);
+    DecimalV2AvgState* avg = reinterpret_cast<DecimalV2AvgState*>(dst->ptr);
+    avg->count += add_decimalv2_vals(vals, num_vals, &avg->sum.val);
+}
+
 StringVal AggregateFunctions::decimalv2_avg_serialize(FunctionContext* ctx, const StringVal& src) {
     DCHECK(!src.is_null);
     StringVal result(ctx, src.len);
@@ -452,11 +541,7 @@ void AggregateFunctions::decimalv2_avg_merge(FunctionContext* ctx, const StringV
     DCHECK(dst->ptr != NULL);
     DCHECK_EQ(sizeof(DecimalV2AvgState), dst->len);
     DecimalV2AvgState* dst_struct = reinterpret_cast<DecimalV2AvgState*>(dst->ptr);
-
-    DecimalV2Value v1 = DecimalV2Value::from_decimal_val(dst_struct->sum);
-    DecimalV2Value v2 = DecimalV2Value::from_decimal_val(src_struct.sum);
-    DecimalV2Value v = v1 + v2;
-    v.to_decimal_val(&dst_struct->sum);
+    add_decimalv2(src_struct.sum.val, &dst_struct->sum.val);
     dst_struct->count += src_struct.count;
 }
 
@@ -619,11 +704,17 @@ void AggregateFunctions::sum(FunctionContext* ctx, const DecimalV2Val& src, Deci
         dst->is_null = false;
         dst->set_to_zero();
     }
+    add_decimalv2(src.val, &dst->val);
+}
 
-    DecimalV2Value new_src = DecimalV2Value::from_decimal_val(src);
-    DecimalV2Value new_dst = DecimalV2Value::from_decimal_val(*dst);
-    new_dst = new_dst + new_src;
-    new_dst.to_decimal_val(dst);
+void AggregateFunctions::sum_decimalv2_batch(FunctionContext* ctx, const DecimalV2Val* vals,
+                                             int num_vals, DecimalV2Val* dst) {
+    __int128 sum = dst->is_null ? 0 : dst->val;
+    if (add_decimalv2_vals(vals, num_vals, &sum) == 0) {
+        return;
+    }
+    dst->is_null = false;
+    dst->val = sum;
 }
 
 template <>
@@ -1170,10 +1261,7 @@ void AggregateFunctions::hll_merge(FunctionContext* ctx, const StringVal& src, S
     DCHECK(!src.is_null);
     DCHECK_EQ(dst->len, std::pow(2, HLL_COLUMN_PRECISION));
     DCHECK_EQ(src.len, std::pow(2, HLL_COLUMN_PRECISION));
-
-    for (int i = 0; i < src.len; ++i) {
-        dst->ptr[i] = std::max(dst->ptr[i], src.ptr[i]);
-    }
+    HyperLogLog::merge_registers(dst->ptr, src.ptr);
 }
 
 StringVal AggregateFunctions::hll_finalize(FunctionContext* ctx, const StringVal& src) {
@@ -1220,52 +1308,7 @@ doris_udf::BigIntVal AggregateFunctions::hll_union_agg_finalize(doris_udf::Funct
 
 int64_t AggregateFunctions::hll_algorithm(uint8_t* pdata, int data_len) {
     DCHECK_EQ(data_len, HLL_REGISTERS_COUNT);
-
-    const int num_streams = HLL_REGISTERS_COUNT;
-    // Empirical constants for the algorithm.
-    float alpha = 0;
-
-    if (num_streams == 16) {
-        alpha = 0.673f;
-    } else if (num_streams == 32) {
-        alpha = 0.697f;
-    } else if (num_streams == 64) {
-        alpha = 0.709f;
-    } else {
-        alpha = 0.7213f / (1 + 1.079f / num_streams);
-    }
-
-    float harmonic_mean = 0;
-    int num_zero_registers = 0;
-
-    for (int i = 0; i < data_len; ++i) {
-        harmonic_mean += powf(2.0f, -pdata[i]);
-
-        if (pdata[i] == 0) {
-            ++num_zero_registers;
-        }
-    }
-
-    harmonic_mean = 1.0f / harmonic_mean;
-    double estimate = alpha * num_streams * num_streams * harmonic_mean;
-    // according to HyperLogLog current correction, if E is cardinal
-    // E =< num_streams * 2.5 , LC has higher accuracy.
-    // num_streams * 2.5 < E , HyperLogLog has higher accuracy.
-    // Generally , we can use HyperLogLog to produce value as E.
-    if (estimate <= num_streams * 2.5 && num_zero_registers != 0) {
-        // Estimated cardinality is too low. Hll is too inaccurate here, instead use
-        // linear counting.
-        estimate = num_streams * log(static_cast<float>(num_streams) / num_zero_registers);
-    } else if (num_streams == 16384 && estimate < 72000) {
-        // when Linear Count change to HyperLoglog according to HyperLogLog Correction,
-        // there are relatively large fluctuations, we fixed the problem refer to redis.
-        double bias = 5.9119 * 1.0e-18 * (estimate * estimate * estimate * estimate) -
-                      1.4253 * 1.0e-12 * (estimate * estimate * estimate) +
-                      1.2940 * 1.0e-7 * (estimate * estimate) - 5.2921 * 1.0e-3 * estimate +
-                      83.3216;
-        estimate -= estimate * (bias / 100);
-    }
-    return (int64_t)(estimate + 0.5);
+    return HyperLogLog::estimate_registers(pdata);
 }
 
 void AggregateFunctions::hll_raw_agg_init(FunctionContext* ctx, HllVal* dst) {
@@ -1294,9 +1337,15 @@ doris_udf::HllVal AggregateFunctions::hll_raw_agg_finalize(doris_udf::FunctionCo
 // TODO chenhao , reduce memory copy
 // multi distinct state for numeric
 // serialize order type:value:value:value ...
+// For the 32 and 64 bits integers the compact order is
+// (type | COMPACT_FORMAT):delta:delta:delta ...
+// where the values are sorted and each delta is the varint of the difference with the
+// previous value, or with the min value of the type for the first one.
 template <typename T>
 class MultiDistinctNumericState {
 public:
+    typedef decltype(T::val) ValueType;
+
     static void create(StringVal* dst) {
         dst->is_null = false;
         const int state_size = sizeof(MultiDistinctNumericState<T>);
@@ -1324,11 +1373,15 @@ public:
 
     static void destroy(const StringVal& dst) { delete (MultiDistinctNumericState<T>*)dst.ptr; }
 
-    void update(T& t) { _set.insert(t); }
+    void update(T& t) { _set.insert(t.val); }
 
     // type:one byte  value:sizeof(T)
     StringVal serialize(FunctionContext* ctx) {
-        size_t type_size = sizeof(((T*)0)->val);
+        if (config::enable_compact_distinct_state && std::is_integral<ValueType>::value &&
+            sizeof(ValueType) >= sizeof(int32_t) && sizeof(ValueType) <= sizeof(int64_t)) {
+            return serialize_compact(ctx);
+        }
+        size_t type_size = sizeof(ValueType);
         const size_t serialized_set_length = sizeof(uint8_t) + type_size * _set.size();
         StringVal result(ctx, serialized_set_length);
         uint8_t* type_writer = result.ptr;
@@ -1337,34 +1390,44 @@ public:
         type_writer++;
         // value
         for (auto& value : _set) {
-            memcpy(type_writer, &value.val, type_size);
+            memcpy(type_writer, &value, type_size);
             type_writer += type_size;
         }
         return result;
     }
 
+    // Adds the values of a serialized state to this one.
     void unserialize(StringVal& src) {
-        size_t type_size = sizeof(((T*)0)->val);
         const uint8_t* type_reader = src.ptr;
         const uint8_t* end = src.ptr + src.len;
         // type
-        _type = (FunctionContext::Type)*type_reader;
+        uint8_t type = *type_reader;
+        _type = (FunctionContext::Type)(type & ~COMPACT_FORMAT);
         type_reader++;
+        if (type & COMPACT_FORMAT) {
+            uint64_t value = static_cast<int64_t>(std::numeric_limits<ValueType>::min());
+            while (type_reader < end) {
+                uint64_t delta = 0;
+                type_reader = decode_varint64_ptr(type_reader, end, &delta);
+                DCHECK(type_reader != nullptr);
+                if (type_reader == nullptr) {
+                    break;
+                }
+                value += delta;
+                _set.insert(static_cast<ValueType>(static_cast<int64_t>(value)));
+            }
+            return;
+        }
+        size_t type_size = sizeof(ValueType);
         // value
         while (type_reader < end) {
-            T value;
-            value.is_null = false;
-            memcpy(&value.val, type_reader, type_size);
+            ValueType value;
+            memcpy(&value, type_reader, type_size);
             _set.insert(value);
             type_reader += type_size;
         }
     }
 
-    // merge set
-    void merge(MultiDistinctNumericState& state) {
-        _set.insert(state._set.begin(), state._set.end());
-    }
-
     // count
     BigIntVal count_finalize() { return BigIntVal(_set.size()); }
 
@@ -1372,7 +1435,7 @@ public:
     DoubleVal sum_finalize_double() {
         double sum = 0;
         for (auto& value : _set) {
-            sum += value.val;
+            sum += value;
         }
         return DoubleVal(sum);
     }
@@ -1381,7 +1444,7 @@ public:
     LargeIntVal sum_finalize_largeint() {
         __int128 sum = 0;
         for (auto& value : _set) {
-            sum += value.val;
+            sum += value;
         }
         return LargeIntVal(sum);
     }
@@ -1390,7 +1453,7 @@ public:
     BigIntVal sum_finalize_bigint() {
         int64_t sum = 0;
         for (auto& value : _set) {
-            sum += value.val;
+            sum += value;
         }
         return BigIntVal(sum);
     }
@@ -1398,18 +1461,28 @@ public:
     FunctionContext::Type set_type() { return _type; }
 
 private:
-    class NumericHashHelper {
-    public:
-        size_t operator()(const T& obj) const {
-            size_t result = AnyValUtil::hash64_murmur(obj, HashUtil::MURMUR_SEED);
-            return result;
+    // set in the type byte of the compact format
+    static const uint8_t COMPACT_FORMAT = 0x80;
+
+    StringVal serialize_compact(FunctionContext* ctx) {
+        std::vector<ValueType> values(_set.begin(), _set.end());
+        std::sort(values.begin(), values.end());
+        // at most 10 bytes per varint64
+        StringVal result(ctx, sizeof(uint8_t) + 10 * values.size());
+        uint8_t* writer = result.ptr;
+        *writer++ = (uint8_t)_type | COMPACT_FORMAT;
+        uint64_t prev = static_cast<int64_t>(std::numeric_limits<ValueType>::min());
+        for (ValueType value : values) {
+            uint64_t cur = static_cast<int64_t>(value);
+            writer = encode_varint64(writer, cur - prev);
+            prev = cur;
         }
-    };
+        result.resize(ctx, writer - result.ptr);
+        return result;
+    }
 
-    std::unordered_set<T, NumericHashHelper> _set;
-    // Because Anyval does not provide the hash function, in order
-    // to adopt the type different from the template, the pointer is used
-    // HybridSetBase* _set;
+    // the raw values, which are hashed with their identity
+    FlatSet<ValueType> _set;
     // _type is serialized into buffer by one byte
     FunctionContext::Type _type;
 };
@@ -1478,9 +1551,6 @@ public:
         DCHECK(reader == end);
     }
 
-    // merge set
-    void merge(MultiDistinctStringCountState& state) { _set.insert(&(state._set)); }
-
     BigIntVal finalize() { return BigIntVal(_set.size()); }
 
     FunctionContext::Type set_type() { return _type; }
@@ -1558,11 +1628,6 @@ public:
 
     FunctionContext::Type set_type() { return _type; }
 
-    // merge set
-    void merge(MultiDistinctDecimalState& state) {
-        _set.insert(state._set.begin(), state._set.end());
-    }
-
     // count
     BigIntVal count_finalize() { return BigIntVal(_set.size()); }
 
@@ -1599,7 +1664,7 @@ public:
 
     static void destroy(const StringVal& dst) { delete (MultiDistinctDecimalV2State*)dst.ptr; }
 
-    void update(DecimalV2Val& t) { _set.insert(DecimalV2Value::from_decimal_val(t)); }
+    void update(DecimalV2Val& t) { _set.insert(t.val); }
 
     // type:one byte  value:sizeof(T)
     StringVal serialize(FunctionContext* ctx) {
@@ -1610,8 +1675,7 @@ public:
         writer++;
         // for int_length and frac_length, uint8_t will not overflow.
         for (auto& value : _set) {
-            __int128 v = value.value();
-            memcpy(writer, &v, DECIMAL_BYTE_SIZE);
+            memcpy(writer, &value, DECIMAL_BYTE_SIZE);
             writer += DECIMAL_BYTE_SIZE;
         }
         return result;
@@ -1627,26 +1691,20 @@ public:
         while (reader < end) {
             __int128 v = 0;
             memcpy(&v, reader, DECIMAL_BYTE_SIZE);
-            DecimalV2Value value(v);
             reader += DECIMAL_BYTE_SIZE;
-            _set.insert(value);
+            _set.insert(v);
         }
     }
 
     FunctionContext::Type set_type() { return _type; }
 
-    // merge set
-    void merge(MultiDistinctDecimalV2State& state) {
-        _set.insert(state._set.begin(), state._set.end());
-    }
-
     // count
     BigIntVal count_finalize() { return BigIntVal(_set.size()); }
 
     DecimalV2Val sum_finalize() {
         DecimalV2Value sum;
         for (auto& value : _set) {
-            sum += value;
+            sum += DecimalV2Value(value);
         }
         DecimalV2Val result;
         sum.to_decimal_val(&result);
@@ -1656,7 +1714,8 @@ public:
 private:
     const int DECIMAL_BYTE_SIZE = 16;
 
-    std::unordered_set<DecimalV2Value> _set;
+    // the raw values of the DecimalV2Values
+    FlatSet<__int128> _set;
     FunctionContext::Type _type;
 };
 
@@ -1719,11 +1778,6 @@ public:
         }
     }
 
-    // merge set
-    void merge(MultiDistinctCountDateState& state) {
-        _set.insert(state._set.begin(), state._set.end());
-    }
-
     // count
     BigIntVal count_finalize() { return BigIntVal(_set.size()); }
 
@@ -1741,7 +1795,7 @@ private:
     const int DATETIME_PACKED_TIME_BYTE_SIZE = 8;
     const int DATETIME_TYPE_BYTE_SIZE = 4;
 
-    std::unordered_set<DateTimeVal, DateTimeHashHelper> _set;
+    FlatSet<DateTimeVal, DateTimeHashHelper> _set;
     FunctionContext::Type _type;
 };
 
@@ -1817,15 +1871,8 @@ void AggregateFunctions::count_or_sum_distinct_numeric_merge(FunctionContext* ct
     DCHECK(!src.is_null);
     MultiDistinctNumericState<T>* dst_state =
             reinterpret_cast<MultiDistinctNumericState<T>*>(dst->ptr);
-    // unserialize src
-    StringVal src_state_val;
-    MultiDistinctNumericState<T>::create(&src_state_val);
-    MultiDistinctNumericState<T>* src_state =
-            reinterpret_cast<MultiDistinctNumericState<T>*>(src_state_val.ptr);
-    src_state->unserialize(src);
-    DCHECK(dst_state->set_type() == src_state->set_type());
-    dst_state->merge(*src_state);
-    MultiDistinctNumericState<T>::destroy(src_state_val);
+    // the values of src are added to dst without building a state for src
+    dst_state->unserialize(src);
 }
 
 void AggregateFunctions::count_distinct_string_merge(FunctionContext* ctx, StringVal& src,
@@ -1834,15 +1881,8 @@ void AggregateFunctions::count_distinct_string_merge(FunctionContext* ctx, Strin
     DCHECK(!src.is_null);
     MultiDistinctStringCountState* dst_state =
             reinterpret_cast<MultiDistinctStringCountState*>(dst->ptr);
-    // unserialize src
-    StringVal src_state_val;
-    MultiDistinctStringCountState::create(&src_state_val);
-    MultiDistinctStringCountState* src_state =
-            reinterpret_cast<MultiDistinctStringCountState*>(src_state_val.ptr);
-    src_state->unserialize(src);
-    DCHECK(dst_state->set_type() == src_state->set_type());
-    dst_state->merge(*src_state);
-    MultiDistinctStringCountState::destroy(src_state_val);
+    // the values of src are added to dst without building a state for src
+    dst_state->unserialize(src);
 }
 
 void AggregateFunctions::count_or_sum_distinct_decimal_merge(FunctionContext* ctx, StringVal& src,
@@ -1850,15 +1890,8 @@ void AggregateFunctions::count_or_sum_distinct_decimal_merge(FunctionContext* ct
     DCHECK(!dst->is_null);
     DCHECK(!src.is_null);
     MultiDistinctDecimalState* dst_state = reinterpret_cast<MultiDistinctDecimalState*>(dst->ptr);
-    // unserialize src
-    StringVal src_state_val;
-    MultiDistinctDecimalState::create(&src_state_val);
-    MultiDistinctDecimalState* src_state =
-            reinterpret_cast<MultiDistinctDecimalState*>(src_state_val.ptr);
-    src_state->unserialize(src);
-    DCHECK(dst_state->set_type() == src_state->set_type());
-    dst_state->merge(*src_state);
-    MultiDistinctDecimalState::destroy(src_state_val);
+    // the values of src are added to dst without building a state for src
+    dst_state->unserialize(src);
 }
 
 void AggregateFunctions::count_or_sum_distinct_decimalv2_merge(FunctionContext* ctx, StringVal& src,
@@ -1867,15 +1900,8 @@ void AggregateFunctions::count_or_sum_distinct_decimalv2_merge(FunctionContext*
     DCHECK(!src.is_null);
     MultiDistinctDecimalV2State* dst_state =
             reinterpret_cast<MultiDistinctDecimalV2State*>(dst->ptr);
-    // unserialize src
-    StringVal src_state_val;
-    MultiDistinctDecimalV2State::create(&src_state_val);
-    MultiDistinctDecimalV2State* src_state =
-            reinterpret_cast<MultiDistinctDecimalV2State*>(src_state_val.ptr);
-    src_state->unserialize(src);
-    DCHECK(dst_state->set_type() == src_state->set_type());
-    dst_state->merge(*src_state);
-    MultiDistinctDecimalV2State::destroy(src_state_val);
+    // the values of src are added to dst without building a state for src
+    dst_state->unserialize(src);
 }
 
 void AggregateFunctions::count_distinct_date_merge(FunctionContext* ctx, StringVal& src,
@@ -1884,15 +1910,8 @@ void AggregateFunctions::count_distinct_date_merge(FunctionContext* ctx, StringV
     DCHECK(!src.is_null);
     MultiDistinctCountDateState* dst_state =
             reinterpret_cast<MultiDistinctCountDateState*>(dst->ptr);
-    // unserialize src
-    StringVal src_state_val;
-    MultiDistinctCountDateState::create(&src_state_val);
-    MultiDistinctCountDateState* src_state =
-            reinterpret_cast<MultiDistinctCountDateState*>(src_state_val.ptr);
-    src_state->unserialize(src);
-    DCHECK(dst_state->set_type() == src_state->set_type());
-    dst_state->merge(*src_state);
-    MultiDistinctCountDateState::destroy(src_state_val);
+    // the values of src are added to dst without building a state for src
+    dst_state->unserialize(src);
 }
 
 template <typename T>
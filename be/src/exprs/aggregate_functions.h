@@ -77,8 +77,18 @@ public:
                                          const DoubleVal& quantile,
                                          const DoubleVal& digest_compression, StringVal* dst);
 
+    // percentile_approx_update() on 'num_vals' values at once, the quantile is the constant
+    // argument of 'ctx'.
+    static void percentile_approx_update_batch(FunctionContext* ctx, const DoubleVal* vals,
+                                               int num_vals, StringVal* dst);
+
     static void percentile_approx_merge(FunctionContext* ctx, const StringVal& src, StringVal* dst);
 
+    // percentile_approx_merge() on 'num_vals' values at once, their t-digests are merged
+    // in one pass.
+    static void percentile_approx_merge_batch(FunctionContext* ctx, const StringVal* vals,
+                                              int num_vals, StringVal* dst);
+
     static DoubleVal percentile_approx_finalize(FunctionContext* ctx, const StringVal& src);
 
     static StringVal percentile_approx_serialize(FunctionContext* ctx, const StringVal& state_sv);
@@ -115,6 +125,10 @@ public:
                                    const doris_udf::DecimalVal& src, doris_udf::StringVal* dst);
     static void decimalv2_avg_update(doris_udf::FunctionContext* ctx,
                                      const doris_udf::DecimalV2Val& src, doris_udf::StringVal* dst);
+    // decimalv2_avg_update() on 'num_vals' values at once.
+    static void decimalv2_avg_update_batch(doris_udf::FunctionContext* ctx,
+                                           const doris_udf::DecimalV2Val* vals, int num_vals,
+                                           doris_udf::StringVal* dst);
     static void decimal_avg_merge(FunctionContext* ctx, const doris_udf::StringVal& src,
                                   doris_udf::StringVal* dst);
     static void decimalv2_avg_merge(FunctionContext* ctx, const doris_udf::StringVal& src,
@@ -137,6 +151,12 @@ public:
     // SumUpdate, SumMerge
     template <typename SRC_VAL, typename DST_VAL>
     static void sum(doris_udf::FunctionContext*, const SRC_VAL& src, DST_VAL* dst);
+    // sum() of decimalv2 on 'num_vals' values at once. The raw values are accumulated
+    // and checked for overflow once per call when no running sum can overflow, the
+    // result is the same as sum() on every value.
+    static void sum_decimalv2_batch(doris_udf::FunctionContext*,
+                                    const doris_udf::DecimalV2Val* vals, int num_vals,
+                                    doris_udf::DecimalV2Val* dst);
 
     // MinUpdate/MinMerge
     template <typename T>
@@ -360,6 +380,11 @@ public:
                                                   const doris_udf::HllVal& src);
 };
 
+// Referred to by NewAggFnEvaluator::AddBatch().
+template <>
+void AggregateFunctions::sum(doris_udf::FunctionContext*, const doris_udf::DecimalV2Val& src,
+                             doris_udf::DecimalV2Val* dst);
+
 } // namespace doris
 
 #endif
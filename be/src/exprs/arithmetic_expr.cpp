@@ -17,6 +17,7 @@
 
 #include "exprs/arithmetic_expr.h"
 
+#include "runtime/row_batch.h"
 #include "runtime/runtime_state.h"
 
 namespace doris {
@@ -159,4 +160,199 @@ BINARY_BIT_FNS(BitXorExpr, ^)
     BITNOT_OP_FN(LargeIntVal, get_large_int_val)
 
 BITNOT_FNS()
+
+// The operations of the batch evaluation. null_on() returns true for a right operand
+// that makes the result null, like the division by zero of the Get*Val() functions.
+struct AddOp {
+    template <class T>
+    static bool null_on(T v2) { return false; }
+    template <class T>
+    static T apply(T v1, T v2) { return v1 + v2; }
+};
+
+struct SubOp {
+    template <class T>
+    static bool null_on(T v2) { return false; }
+    template <class T>
+    static T apply(T v1, T v2) { return v1 - v2; }
+};
+
+struct MulOp {
+    template <class T>
+    static bool null_on(T v2) { return false; }
+    template <class T>
+    static T apply(T v1, T v2) { return v1 * v2; }
+};
+
+struct DivOp {
+    template <class T>
+    static bool null_on(T v2) { return v2 == 0; }
+    template <class T>
+    static T apply(T v1, T v2) { return v1 / v2; }
+};
+
+struct ModOp {
+    template <class T>
+    static bool null_on(T v2) { return v2 == 0; }
+    static bool null_on(float v2) { return false; }
+    static bool null_on(double v2) { return false; }
+    template <class T>
+    static T apply(T v1, T v2) { return v1 % v2; }
+    static float apply(float v1, float v2) { return fmod(v1, v2); }
+    static double apply(double v1, double v2) { return fmod(v1, v2); }
+};
+
+struct BitAndOp {
+    template <class T>
+    static bool null_on(T v2) { return false; }
+    template <class T>
+    static T apply(T v1, T v2) { return v1 & v2; }
+};
+
+struct BitOrOp {
+    template <class T>
+    static bool null_on(T v2) { return false; }
+    template <class T>
+    static T apply(T v1, T v2) { return v1 | v2; }
+};
+
+struct BitXorOp {
+    template <class T>
+    static bool null_on(T v2) { return false; }
+    template <class T>
+    static T apply(T v1, T v2) { return v1 ^ v2; }
+};
+
+template <class T, class Op>
+static void binary_op_batch(ExprContext* ctx, Expr* left, Expr* right, RowBatch* batch,
+                            const int* sel, int num_sel, ExprColumn* column) {
+    ExprColumn left_column;
+    ExprColumn right_column;
+    left->evaluate_batch(ctx, batch, sel, num_sel, &left_column);
+    right->evaluate_batch(ctx, batch, sel, num_sel, &right_column);
+    const T* v1 = left_column.values<T>();
+    const T* v2 = right_column.values<T>();
+    T* result = column->reset<T>(batch->num_rows());
+    for (int i = 0; i < num_sel; ++i) {
+        int idx = sel[i];
+        if (v1[idx].is_null || v2[idx].is_null || Op::null_on(v2[idx].val)) {
+            result[idx] = T::null();
+        } else {
+            result[idx] = T(Op::apply(v1[idx].val, v2[idx].val));
+        }
+    }
+}
+
+template <class Op>
+void ArithmeticExpr::evaluate_integer_batch(ExprContext* ctx, RowBatch* batch, const int* sel,
+                                            int num_sel, ExprColumn* column) {
+    if (has_null_type_child()) {
+        Expr::evaluate_batch(ctx, batch, sel, num_sel, column);
+        return;
+    }
+    switch (_type.type) {
+    case TYPE_TINYINT:
+        binary_op_batch<TinyIntVal, Op>(ctx, _children[0], _children[1], batch, sel, num_sel,
+                                        column);
+        break;
+    case TYPE_SMALLINT:
+        binary_op_batch<SmallIntVal, Op>(ctx, _children[0], _children[1], batch, sel, num_sel,
+                                         column);
+        break;
+    case TYPE_INT:
+        binary_op_batch<IntVal, Op>(ctx, _children[0], _children[1], batch, sel, num_sel,
+                                    column);
+        break;
+    case TYPE_BIGINT:
+        binary_op_batch<BigIntVal, Op>(ctx, _children[0], _children[1], batch, sel, num_sel,
+                                       column);
+        break;
+    case TYPE_LARGEINT:
+        binary_op_batch<LargeIntVal, Op>(ctx, _children[0], _children[1], batch, sel, num_sel,
+                                         column);
+        break;
+    default:
+        Expr::evaluate_batch(ctx, batch, sel, num_sel, column);
+        break;
+    }
+}
+
+template <class Op>
+void ArithmeticExpr::evaluate_binary_batch(ExprContext* ctx, RowBatch* batch, const int* sel,
+                                           int num_sel, ExprColumn* column) {
+    if (has_null_type_child()) {
+        Expr::evaluate_batch(ctx, batch, sel, num_sel, column);
+        return;
+    }
+    switch (_type.type) {
+    case TYPE_FLOAT:
+        binary_op_batch<FloatVal, Op>(ctx, _children[0], _children[1], batch, sel, num_sel,
+                                      column);
+        break;
+    case TYPE_DOUBLE:
+        binary_op_batch<DoubleVal, Op>(ctx, _children[0], _children[1], batch, sel, num_sel,
+                                       column);
+        break;
+    default:
+        evaluate_integer_batch<Op>(ctx, batch, sel, num_sel, column);
+        break;
+    }
+}
+
+#define BINARY_BATCH_FN(CLASS, OP, EVALUATE)                                                   \
+    void CLASS::evaluate_batch(ExprContext* ctx, RowBatch* batch, const int* sel, int num_sel, \
+                               ExprColumn* column) {                                           \
+        EVALUATE<OP>(ctx, batch, sel, num_sel, column);                                        \
+    }
+
+BINARY_BATCH_FN(AddExpr, AddOp, evaluate_binary_batch)
+BINARY_BATCH_FN(SubExpr, SubOp, evaluate_binary_batch)
+BINARY_BATCH_FN(MulExpr, MulOp, evaluate_binary_batch)
+BINARY_BATCH_FN(DivExpr, DivOp, evaluate_binary_batch)
+BINARY_BATCH_FN(ModExpr, ModOp, evaluate_binary_batch)
+BINARY_BATCH_FN(BitAndExpr, BitAndOp, evaluate_integer_batch)
+BINARY_BATCH_FN(BitOrExpr, BitOrOp, evaluate_integer_batch)
+BINARY_BATCH_FN(BitXorExpr, BitXorOp, evaluate_integer_batch)
+
+template <class T>
+static void bit_not_batch(ExprContext* ctx, Expr* child, RowBatch* batch, const int* sel,
+                          int num_sel, ExprColumn* column) {
+    ExprColumn child_column;
+    child->evaluate_batch(ctx, batch, sel, num_sel, &child_column);
+    const T* v = child_column.values<T>();
+    T* result = column->reset<T>(batch->num_rows());
+    for (int i = 0; i < num_sel; ++i) {
+        int idx = sel[i];
+        result[idx] = v[idx].is_null ? T::null() : T(~v[idx].val);
+    }
+}
+
+void BitNotExpr::evaluate_batch(ExprContext* ctx, RowBatch* batch, const int* sel, int num_sel,
+                                ExprColumn* column) {
+    if (has_null_type_child()) {
+        Expr::evaluate_batch(ctx, batch, sel, num_sel, column);
+        return;
+    }
+    switch (_type.type) {
+    case TYPE_TINYINT:
+        bit_not_batch<TinyIntVal>(ctx, _children[0], batch, sel, num_sel, column);
+        break;
+    case TYPE_SMALLINT:
+        bit_not_batch<SmallIntVal>(ctx, _children[0], batch, sel, num_sel, column);
+        break;
+    case TYPE_INT:
+        bit_not_batch<IntVal>(ctx, _children[0], batch, sel, num_sel, column);
+        break;
+    case TYPE_BIGINT:
+        bit_not_batch<BigIntVal>(ctx, _children[0], batch, sel, num_sel, column);
+        break;
+    case TYPE_LARGEINT:
+        bit_not_batch<LargeIntVal>(ctx, _children[0], batch, sel, num_sel, column);
+        break;
+    default:
+        Expr::evaluate_batch(ctx, batch, sel, num_sel, column);
+        break;
+    }
+}
+
 } // namespace doris
@@ -42,6 +42,16 @@ protected:
 
     ArithmeticExpr(const TExprNode& node) : Expr(node) {}
     virtual ~ArithmeticExpr() {}
+
+    // Evaluate both children for the selected rows of 'batch' and apply Op to them into
+    // 'column'. evaluate_integer_batch() only handles the integer types, for the bit
+    // operations. Other types are evaluated a row at a time.
+    template <class Op>
+    void evaluate_binary_batch(ExprContext* context, RowBatch* batch, const int* sel,
+                               int num_sel, ExprColumn* column);
+    template <class Op>
+    void evaluate_integer_batch(ExprContext* context, RowBatch* batch, const int* sel,
+                                int num_sel, ExprColumn* column);
 };
 
 class AddExpr : public ArithmeticExpr {
@@ -56,6 +66,8 @@ public:
     virtual LargeIntVal get_large_int_val(ExprContext* context, TupleRow*);
     virtual FloatVal get_float_val(ExprContext* context, TupleRow*);
     virtual DoubleVal get_double_val(ExprContext* context, TupleRow*);
+    virtual void evaluate_batch(ExprContext* context, RowBatch* batch, const int* sel,
+                                int num_sel, ExprColumn* column) override;
 };
 
 class SubExpr : public ArithmeticExpr {
@@ -70,6 +82,8 @@ public:
     virtual LargeIntVal get_large_int_val(ExprContext* context, TupleRow*);
     virtual FloatVal get_float_val(ExprContext* context, TupleRow*);
     virtual DoubleVal get_double_val(ExprContext* context, TupleRow*);
+    virtual void evaluate_batch(ExprContext* context, RowBatch* batch, const int* sel,
+                                int num_sel, ExprColumn* column) override;
 };
 
 class MulExpr : public ArithmeticExpr {
@@ -84,6 +98,8 @@ public:
     virtual LargeIntVal get_large_int_val(ExprContext* context, TupleRow*);
     virtual FloatVal get_float_val(ExprContext* context, TupleRow*);
     virtual DoubleVal get_double_val(ExprContext* context, TupleRow*);
+    virtual void evaluate_batch(ExprContext* context, RowBatch* batch, const int* sel,
+                                int num_sel, ExprColumn* column) override;
 };
 
 class DivExpr : public ArithmeticExpr {
@@ -98,6 +114,8 @@ public:
     virtual LargeIntVal get_large_int_val(ExprContext* context, TupleRow*);
     virtual FloatVal get_float_val(ExprContext* context, TupleRow*);
     virtual DoubleVal get_double_val(ExprContext* context, TupleRow*);
+    virtual void evaluate_batch(ExprContext* context, RowBatch* batch, const int* sel,
+                                int num_sel, ExprColumn* column) override;
 };
 
 class ModExpr : public ArithmeticExpr {
@@ -112,6 +130,8 @@ public:
     virtual LargeIntVal get_large_int_val(ExprContext* context, TupleRow*);
     virtual FloatVal get_float_val(ExprContext* context, TupleRow*);
     virtual DoubleVal get_double_val(ExprContext* context, TupleRow*);
+    virtual void evaluate_batch(ExprContext* context, RowBatch* batch, const int* sel,
+                                int num_sel, ExprColumn* column) override;
 };
 
 class BitAndExpr : public ArithmeticExpr {
@@ -126,6 +146,8 @@ public:
     virtual IntVal get_int_val(ExprContext* context, TupleRow*);
     virtual BigIntVal get_big_int_val(ExprContext* context, TupleRow*);
     virtual LargeIntVal get_large_int_val(ExprContext* context, TupleRow*);
+    virtual void evaluate_batch(ExprContext* context, RowBatch* batch, const int* sel,
+                                int num_sel, ExprColumn* column) override;
 };
 
 class BitOrExpr : public ArithmeticExpr {
@@ -138,6 +160,8 @@ public:
     virtual IntVal get_int_val(ExprContext* context, TupleRow*);
     virtual BigIntVal get_big_int_val(ExprContext* context, TupleRow*);
     virtual LargeIntVal get_large_int_val(ExprContext* context, TupleRow*);
+    virtual void evaluate_batch(ExprContext* context, RowBatch* batch, const int* sel,
+                                int num_sel, ExprColumn* column) override;
 };
 
 class BitXorExpr : public ArithmeticExpr {
@@ -152,6 +176,8 @@ public:
     virtual IntVal get_int_val(ExprContext* context, TupleRow*);
     virtual BigIntVal get_big_int_val(ExprContext* context, TupleRow*);
     virtual LargeIntVal get_large_int_val(ExprContext* context, TupleRow*);
+    virtual void evaluate_batch(ExprContext* context, RowBatch* batch, const int* sel,
+                                int num_sel, ExprColumn* column) override;
 };
 
 class BitNotExpr : public ArithmeticExpr {
@@ -166,6 +192,8 @@ public:
     virtual IntVal get_int_val(ExprContext* context, TupleRow*);
     virtual BigIntVal get_big_int_val(ExprContext* context, TupleRow*);
     virtual LargeIntVal get_large_int_val(ExprContext* context, TupleRow*);
+    virtual void evaluate_batch(ExprContext* context, RowBatch* batch, const int* sel,
+                                int num_sel, ExprColumn* column) override;
 };
 
 } // namespace doris
@@ -23,6 +23,7 @@
 #include "runtime/datetime_value.h"
 #include "runtime/decimal_value.h"
 #include "runtime/decimalv2_value.h"
+#include "runtime/row_batch.h"
 #include "runtime/runtime_state.h"
 #include "runtime/string_value.h"
 #include "util/debug_util.h"
@@ -267,17 +268,62 @@ std::string BinaryPredicate::debug_string() const {
     return out.str();
 }
 
-#define BINARY_PRED_FN(CLASS, TYPE, FN, OP, LLVM_PRED)                   \
-    BooleanVal CLASS::get_boolean_val(ExprContext* ctx, TupleRow* row) { \
-        TYPE v1 = _children[0]->FN(ctx, row);                            \
-        if (v1.is_null) {                                                \
-            return BooleanVal::null();                                   \
-        }                                                                \
-        TYPE v2 = _children[1]->FN(ctx, row);                            \
-        if (v2.is_null) {                                                \
-            return BooleanVal::null();                                   \
-        }                                                                \
-        return BooleanVal(v1.val OP v2.val);                             \
+template <class T, class Cmp>
+void BinaryPredicate::compare_batch(ExprContext* ctx, RowBatch* batch, const int* sel,
+                                    int num_sel, ExprColumn* column, Cmp cmp) {
+    if (has_null_type_child()) {
+        Expr::evaluate_batch(ctx, batch, sel, num_sel, column);
+        return;
+    }
+    BooleanVal* result = column->reset<BooleanVal>(batch->num_rows());
+    if (num_sel == 0) {
+        return;
+    }
+    ExprColumn left;
+    ExprColumn right;
+    _children[0]->evaluate_batch(ctx, batch, sel, num_sel, &left);
+    const T* v1 = left.values<T>();
+    if (_children[1]->is_constant()) {
+        _children[1]->evaluate_batch(ctx, batch, sel, 1, &right);
+        const T& v2 = right.values<T>()[sel[0]];
+        for (int i = 0; i < num_sel; ++i) {
+            int idx = sel[i];
+            if (v1[idx].is_null || v2.is_null) {
+                result[idx] = BooleanVal::null();
+            } else {
+                result[idx] = BooleanVal(cmp(v1[idx], v2));
+            }
+        }
+        return;
+    }
+    _children[1]->evaluate_batch(ctx, batch, sel, num_sel, &right);
+    const T* v2 = right.values<T>();
+    for (int i = 0; i < num_sel; ++i) {
+        int idx = sel[i];
+        if (v1[idx].is_null || v2[idx].is_null) {
+            result[idx] = BooleanVal::null();
+        } else {
+            result[idx] = BooleanVal(cmp(v1[idx], v2[idx]));
+        }
+    }
+}
+
+#define BINARY_PRED_FN(CLASS, TYPE, FN, OP, LLVM_PRED)                                        \
+    BooleanVal CLASS::get_boolean_val(ExprContext* ctx, TupleRow* row) {                      \
+        TYPE v1 = _children[0]->FN(ctx, row);                                                 \
+        if (v1.is_null) {                                                                     \
+            return BooleanVal::null();                                                        \
+        }                                                                                     \
+        TYPE v2 = _children[1]->FN(ctx, row);                                                 \
+        if (v2.is_null) {                                                                     \
+            return BooleanVal::null();                                                        \
+        }                                                                                     \
+        return BooleanVal(v1.val OP v2.val);                                                  \
+    }                                                                                         \
+    void CLASS::evaluate_batch(ExprContext* ctx, RowBatch* batch, const int* sel,             \
+                               int num_sel, ExprColumn* column) {                             \
+        compare_batch<TYPE>(ctx, batch, sel, num_sel, column,                                 \
+                            [](const TYPE& v1, const TYPE& v2) { return v1.val OP v2.val; }); \
     }
 
 // add '/**/' to pass code style check of cooder
@@ -307,19 +353,26 @@ BINARY_PRED_INT_FNS(LargeIntVal, get_large_int_val);
 BINARY_PRED_FLOAT_FNS(FloatVal, get_float_val);
 BINARY_PRED_FLOAT_FNS(DoubleVal, get_double_val);
 
-#define COMPLICATE_BINARY_PRED_FN(CLASS, TYPE, FN, DORIS_TYPE, FROM_FUNC, OP) \
-    BooleanVal CLASS::get_boolean_val(ExprContext* ctx, TupleRow* row) {      \
-        TYPE v1 = _children[0]->FN(ctx, row);                                 \
-        if (v1.is_null) {                                                     \
-            return BooleanVal::null();                                        \
-        }                                                                     \
-        TYPE v2 = _children[1]->FN(ctx, row);                                 \
-        if (v2.is_null) {                                                     \
-            return BooleanVal::null();                                        \
-        }                                                                     \
-        DORIS_TYPE pv1 = DORIS_TYPE::FROM_FUNC(v1);                           \
-        DORIS_TYPE pv2 = DORIS_TYPE::FROM_FUNC(v2);                           \
-        return BooleanVal(pv1 OP pv2);                                        \
+#define COMPLICATE_BINARY_PRED_FN(CLASS, TYPE, FN, DORIS_TYPE, FROM_FUNC, OP)                  \
+    BooleanVal CLASS::get_boolean_val(ExprContext* ctx, TupleRow* row) {                       \
+        TYPE v1 = _children[0]->FN(ctx, row);                                                  \
+        if (v1.is_null) {                                                                      \
+            return BooleanVal::null();                                                         \
+        }                                                                                      \
+        TYPE v2 = _children[1]->FN(ctx, row);                                                  \
+        if (v2.is_null) {                                                                      \
+            return BooleanVal::null();                                                         \
+        }                                                                                      \
+        DORIS_TYPE pv1 = DORIS_TYPE::FROM_FUNC(v1);                                            \
+        DORIS_TYPE pv2 = DORIS_TYPE::FROM_FUNC(v2);                                            \
+        return BooleanVal(pv1 OP pv2);                                                         \
+    }                                                                                          \
+    void CLASS::evaluate_batch(ExprContext* ctx, RowBatch* batch, const int* sel,              \
+                               int num_sel, ExprColumn* column) {                              \
+        compare_batch<TYPE>(ctx, batch, sel, num_sel, column,                                  \
+                            [](const TYPE& v1, const TYPE& v2) {                               \
+                                return DORIS_TYPE::FROM_FUNC(v1) OP DORIS_TYPE::FROM_FUNC(v2); \
+                            });                                                                \
     }
 
 #define COMPLICATE_BINARY_PRED_FNS(TYPE, FN, DORIS_TYPE, FROM_FUNC)                \
@@ -333,17 +386,24 @@ BINARY_PRED_FLOAT_FNS(DoubleVal, get_double_val);
 COMPLICATE_BINARY_PRED_FNS(DecimalVal, get_decimal_val, DecimalValue, from_decimal_val)
 COMPLICATE_BINARY_PRED_FNS(DecimalV2Val, get_decimalv2_val, DecimalV2Value, from_decimal_val)
 
-#define DATETIME_BINARY_PRED_FN(CLASS, OP, LLVM_PRED)                    \
-    BooleanVal CLASS::get_boolean_val(ExprContext* ctx, TupleRow* row) { \
-        DateTimeVal v1 = _children[0]->get_datetime_val(ctx, row);       \
-        if (v1.is_null) {                                                \
-            return BooleanVal::null();                                   \
-        }                                                                \
-        DateTimeVal v2 = _children[1]->get_datetime_val(ctx, row);       \
-        if (v2.is_null) {                                                \
-            return BooleanVal::null();                                   \
-        }                                                                \
-        return BooleanVal(v1.packed_time OP v2.packed_time);             \
+#define DATETIME_BINARY_PRED_FN(CLASS, OP, LLVM_PRED)                                 \
+    BooleanVal CLASS::get_boolean_val(ExprContext* ctx, TupleRow* row) {              \
+        DateTimeVal v1 = _children[0]->get_datetime_val(ctx, row);                    \
+        if (v1.is_null) {                                                             \
+            return BooleanVal::null();                                                \
+        }                                                                             \
+        DateTimeVal v2 = _children[1]->get_datetime_val(ctx, row);                    \
+        if (v2.is_null) {                                                             \
+            return BooleanVal::null();                                                \
+        }                                                                             \
+        return BooleanVal(v1.packed_time OP v2.packed_time);                          \
+    }                                                                                 \
+    void CLASS::evaluate_batch(ExprContext* ctx, RowBatch* batch, const int* sel,     \
+                               int num_sel, ExprColumn* column) {                     \
+        compare_batch<DateTimeVal>(ctx, batch, sel, num_sel, column,                  \
+                                   [](const DateTimeVal& v1, const DateTimeVal& v2) { \
+                                       return v1.packed_time OP v2.packed_time;       \
+                                   });                                                \
     }
 
 #define DATETIME_BINARY_PRED_FNS()                                        \
@@ -356,19 +416,27 @@ COMPLICATE_BINARY_PRED_FNS(DecimalV2Val, get_decimalv2_val, DecimalV2Value, from
 
 DATETIME_BINARY_PRED_FNS()
 
-#define STRING_BINARY_PRED_FN(CLASS, OP)                                 \
-    BooleanVal CLASS::get_boolean_val(ExprContext* ctx, TupleRow* row) { \
-        StringVal v1 = _children[0]->get_string_val(ctx, row);           \
-        if (v1.is_null) {                                                \
-            return BooleanVal::null();                                   \
-        }                                                                \
-        StringVal v2 = _children[1]->get_string_val(ctx, row);           \
-        if (v2.is_null) {                                                \
-            return BooleanVal::null();                                   \
-        }                                                                \
-        StringValue pv1 = StringValue::from_string_val(v1);              \
-        StringValue pv2 = StringValue::from_string_val(v2);              \
-        return BooleanVal(pv1 OP pv2);                                   \
+#define STRING_BINARY_PRED_FN(CLASS, OP)                                          \
+    BooleanVal CLASS::get_boolean_val(ExprContext* ctx, TupleRow* row) {          \
+        StringVal v1 = _children[0]->get_string_val(ctx, row);                    \
+        if (v1.is_null) {                                                         \
+            return BooleanVal::null();                                            \
+        }                                                                         \
+        StringVal v2 = _children[1]->get_string_val(ctx, row);                    \
+        if (v2.is_null) {                                                         \
+            return BooleanVal::null();                                            \
+        }                                                                         \
+        StringValue pv1 = StringValue::from_string_val(v1);                       \
+        StringValue pv2 = StringValue::from_string_val(v2);                       \
+        return BooleanVal(pv1 OP pv2);                                            \
+    }                                                                             \
+    void CLASS::evaluate_batch(ExprContext* ctx, RowBatch* batch, const int* sel, \
+                               int num_sel, ExprColumn* column) {                 \
+        compare_batch<StringVal>(ctx, batch, sel, num_sel, column,                \
+                                 [](const StringVal& v1, const StringVal& v2) {   \
+                                     return StringValue::from_string_val(v1) OP   \
+                                            StringValue::from_string_val(v2);     \
+                                 });                                              \
     }
 
 #define STRING_BINARY_PRED_FNS()                   \
@@ -395,6 +463,16 @@ BooleanVal EqStringValPred::get_boolean_val(ExprContext* ctx, TupleRow* row) {
     return BooleanVal(string_compare((char*)v1.ptr, v1.len, (char*)v2.ptr, v2.len, v1.len) == 0);
 }
 
+void EqStringValPred::evaluate_batch(ExprContext* ctx, RowBatch* batch, const int* sel,
+                                     int num_sel, ExprColumn* column) {
+    compare_batch<StringVal>(ctx, batch, sel, num_sel, column,
+                             [](const StringVal& v1, const StringVal& v2) {
+                                 return v1.len == v2.len &&
+                                        string_compare((char*)v1.ptr, v1.len, (char*)v2.ptr,
+                                                       v2.len, v1.len) == 0;
+                             });
+}
+
 #define BINARY_PRED_FOR_NULL_FN(CLASS, TYPE, FN, OP, LLVM_PRED)          \
     BooleanVal CLASS::get_boolean_val(ExprContext* ctx, TupleRow* row) { \
         TYPE v1 = _children[0]->FN(ctx, row);                            \
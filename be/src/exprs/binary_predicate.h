@@ -38,6 +38,12 @@ protected:
 
     // virtual Status prepare(RuntimeState* state, const RowDescriptor& desc);
     virtual std::string debug_string() const;
+
+    // Evaluate the children for the selected rows of 'batch' as *Val type T and compare
+    // them with 'cmp' into 'column'. A constant right child is only evaluated once.
+    template <class T, class Cmp>
+    void compare_batch(ExprContext* context, RowBatch* batch, const int* sel, int num_sel,
+                       ExprColumn* column, Cmp cmp);
 };
 
 #define BIN_PRED_CLASS_DEFINE(CLASS)                                             \
@@ -50,6 +56,9 @@ protected:
         }                                                                        \
                                                                                  \
         virtual BooleanVal get_boolean_val(ExprContext* context, TupleRow* row); \
+        virtual void evaluate_batch(ExprContext* context, RowBatch* batch,       \
+                                    const int* sel, int num_sel,                 \
+                                    ExprColumn* column) override;                \
     };
 
 #define BIN_PRED_CLASSES_DEFINE(TYPE)     \
@@ -301,6 +301,29 @@ void BitmapFunctions::bitmap_union(FunctionContext* ctx, const StringVal& src, S
     }
 }
 
+void BitmapFunctions::bitmap_union_batch(FunctionContext* ctx, const StringVal* srcs,
+                                         int num_srcs, StringVal* dst) {
+    // reserved so that the pointers to the deserialized bitmaps stay valid
+    std::vector<BitmapValue> deserialized;
+    deserialized.reserve(num_srcs);
+    std::vector<const BitmapValue*> bitmaps;
+    bitmaps.reserve(num_srcs);
+    for (int i = 0; i < num_srcs; ++i) {
+        const StringVal& src = srcs[i];
+        if (src.is_null) {
+            continue;
+        }
+        // zero size means the src input is a agg object
+        if (src.len == 0) {
+            bitmaps.push_back(reinterpret_cast<const BitmapValue*>(src.ptr));
+        } else {
+            deserialized.emplace_back((char*)src.ptr);
+            bitmaps.push_back(&deserialized.back());
+        }
+    }
+    reinterpret_cast<BitmapValue*>(dst->ptr)->fastunion(bitmaps);
+}
+
 // the dst value could be null
 void BitmapFunctions::nullable_bitmap_init(FunctionContext* ctx, StringVal* dst) {
     dst->is_null = true;
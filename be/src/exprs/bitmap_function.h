@@ -51,6 +51,10 @@ public:
     static BigIntVal bitmap_get_value(FunctionContext* ctx, const StringVal& src);
 
     static void bitmap_union(FunctionContext* ctx, const StringVal& src, StringVal* dst);
+    // bitmap_union() on 'num_srcs' values at once, all the bitmaps are unioned together
+    // with BitmapValue::fastunion().
+    static void bitmap_union_batch(FunctionContext* ctx, const StringVal* srcs, int num_srcs,
+                                   StringVal* dst);
     // the dst value could be null
     static void nullable_bitmap_init(FunctionContext* ctx, StringVal* dst);
     static void bitmap_intersect(FunctionContext* ctx, const StringVal& src, StringVal* dst);
@@ -17,6 +17,7 @@
 
 #include "exprs/cast_expr.h"
 
+#include "runtime/row_batch.h"
 #include "runtime/runtime_state.h"
 
 namespace doris {
@@ -152,4 +153,84 @@ CAST_FROM_DOUBLE(IntVal, get_int_val)
 CAST_FROM_DOUBLE(BigIntVal, get_big_int_val)
 CAST_FROM_DOUBLE(LargeIntVal, get_large_int_val)
 CAST_FROM_DOUBLE(FloatVal, get_float_val)
+
+template <class FROM, class TO>
+static void cast_values(const FROM* from, const int* sel, int num_sel, TO* to) {
+    for (int i = 0; i < num_sel; ++i) {
+        int idx = sel[i];
+        to[idx] = from[idx].is_null ? TO::null() : TO(from[idx].val);
+    }
+}
+
+template <class FROM>
+void CastExpr::cast_batch(ExprContext* context, RowBatch* batch, const int* sel, int num_sel,
+                          ExprColumn* column) {
+    if (has_null_type_child()) {
+        Expr::evaluate_batch(context, batch, sel, num_sel, column);
+        return;
+    }
+    ExprColumn child;
+    switch (_type.type) {
+    case TYPE_BOOLEAN:
+    case TYPE_TINYINT:
+    case TYPE_SMALLINT:
+    case TYPE_INT:
+    case TYPE_BIGINT:
+    case TYPE_LARGEINT:
+    case TYPE_FLOAT:
+    case TYPE_DOUBLE:
+        _children[0]->evaluate_batch(context, batch, sel, num_sel, &child);
+        break;
+    default:
+        Expr::evaluate_batch(context, batch, sel, num_sel, column);
+        return;
+    }
+    const FROM* from = child.values<FROM>();
+    int num_rows = batch->num_rows();
+    switch (_type.type) {
+    case TYPE_BOOLEAN:
+        cast_values(from, sel, num_sel, column->reset<BooleanVal>(num_rows));
+        break;
+    case TYPE_TINYINT:
+        cast_values(from, sel, num_sel, column->reset<TinyIntVal>(num_rows));
+        break;
+    case TYPE_SMALLINT:
+        cast_values(from, sel, num_sel, column->reset<SmallIntVal>(num_rows));
+        break;
+    case TYPE_INT:
+        cast_values(from, sel, num_sel, column->reset<IntVal>(num_rows));
+        break;
+    case TYPE_BIGINT:
+        cast_values(from, sel, num_sel, column->reset<BigIntVal>(num_rows));
+        break;
+    case TYPE_LARGEINT:
+        cast_values(from, sel, num_sel, column->reset<LargeIntVal>(num_rows));
+        break;
+    case TYPE_FLOAT:
+        cast_values(from, sel, num_sel, column->reset<FloatVal>(num_rows));
+        break;
+    case TYPE_DOUBLE:
+        cast_values(from, sel, num_sel, column->reset<DoubleVal>(num_rows));
+        break;
+    default:
+        DCHECK(false);
+        break;
+    }
+}
+
+#define CAST_BATCH(CLASS, FROM_TYPE)                                                  \
+    void CLASS::evaluate_batch(ExprContext* context, RowBatch* batch, const int* sel, \
+                               int num_sel, ExprColumn* column) {                     \
+        cast_batch<FROM_TYPE>(context, batch, sel, num_sel, column);                  \
+    }
+
+CAST_BATCH(CastBooleanExpr, BooleanVal)
+CAST_BATCH(CastTinyIntExpr, TinyIntVal)
+CAST_BATCH(CastSmallIntExpr, SmallIntVal)
+CAST_BATCH(CastIntExpr, IntVal)
+CAST_BATCH(CastBigIntExpr, BigIntVal)
+CAST_BATCH(CastLargeIntExpr, LargeIntVal)
+CAST_BATCH(CastFloatExpr, FloatVal)
+CAST_BATCH(CastDoubleExpr, DoubleVal)
+
 } // namespace doris
@@ -28,6 +28,13 @@ public:
     CastExpr(const TExprNode& node) : Expr(node) {}
     virtual ~CastExpr() {}
     static Expr* from_thrift(const TExprNode& node);
+
+protected:
+    // Evaluate the child for the selected rows of 'batch' as *Val type FROM and cast the
+    // values to the type of this expr into 'column'.
+    template <class FROM>
+    void cast_batch(ExprContext* context, RowBatch* batch, const int* sel, int num_sel,
+                    ExprColumn* column);
 };
 
 #define CAST_EXPR_DEFINE(CLASS)                                                 \
@@ -46,6 +53,9 @@ public:
         virtual LargeIntVal get_large_int_val(ExprContext* context, TupleRow*); \
         virtual FloatVal get_float_val(ExprContext* context, TupleRow*);        \
         virtual DoubleVal get_double_val(ExprContext* context, TupleRow*);      \
+        virtual void evaluate_batch(ExprContext* context, RowBatch* batch,      \
+                                    const int* sel, int num_sel,                \
+                                    ExprColumn* column) override;               \
     };
 
 CAST_EXPR_DEFINE(CastBooleanExpr);
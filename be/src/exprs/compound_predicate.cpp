@@ -19,6 +19,7 @@
 
 #include <sstream>
 
+#include "runtime/row_batch.h"
 #include "runtime/runtime_state.h"
 #include "util/debug_util.h"
 
@@ -81,6 +82,54 @@ BooleanVal NotPredicate::get_boolean_val(ExprContext* context, TupleRow* row) {
     return BooleanVal(!val.val);
 }
 
+void CompoundPredicate::evaluate_short_circuit_batch(ExprContext* context, RowBatch* batch,
+                                                     const int* sel, int num_sel,
+                                                     bool short_circuit_val, ExprColumn* column) {
+    DCHECK_EQ(_children.size(), 2);
+    ExprColumn left;
+    _children[0]->evaluate_batch(context, batch, sel, num_sel, &left);
+    const BooleanVal* v1 = left.values<BooleanVal>();
+    BooleanVal* result = column->reset<BooleanVal>(batch->num_rows());
+    std::vector<int> undecided(num_sel);
+    int num_undecided = 0;
+    for (int i = 0; i < num_sel; ++i) {
+        int idx = sel[i];
+        if (!v1[idx].is_null && v1[idx].val == short_circuit_val) {
+            result[idx] = BooleanVal(short_circuit_val);
+        } else {
+            undecided[num_undecided++] = idx;
+        }
+    }
+    if (num_undecided == 0) {
+        return;
+    }
+    ExprColumn right;
+    _children[1]->evaluate_batch(context, batch, undecided.data(), num_undecided, &right);
+    const BooleanVal* v2 = right.values<BooleanVal>();
+    for (int i = 0; i < num_undecided; ++i) {
+        int idx = undecided[i];
+        if (!v2[idx].is_null && v2[idx].val == short_circuit_val) {
+            result[idx] = BooleanVal(short_circuit_val);
+        } else if (v1[idx].is_null || v2[idx].is_null) {
+            result[idx] = BooleanVal::null();
+        } else {
+            result[idx] = BooleanVal(!short_circuit_val);
+        }
+    }
+}
+
+void NotPredicate::evaluate_batch(ExprContext* context, RowBatch* batch, const int* sel,
+                                  int num_sel, ExprColumn* column) {
+    ExprColumn child;
+    _children[0]->evaluate_batch(context, batch, sel, num_sel, &child);
+    const BooleanVal* v = child.values<BooleanVal>();
+    BooleanVal* result = column->reset<BooleanVal>(batch->num_rows());
+    for (int i = 0; i < num_sel; ++i) {
+        int idx = sel[i];
+        result[idx] = v[idx].is_null ? BooleanVal::null() : BooleanVal(!v[idx].val);
+    }
+}
+
 std::string CompoundPredicate::debug_string() const {
     std::stringstream out;
     out << "CompoundPredicate(" << Expr::debug_string() << ")";
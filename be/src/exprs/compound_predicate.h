@@ -41,6 +41,11 @@ protected:
 
     virtual bool is_vectorized() const { return false; }
 
+    // Batch evaluation of AND (short_circuit_val false) and OR (short_circuit_val true).
+    // The right child is only evaluated for the rows the left one doesn't decide.
+    void evaluate_short_circuit_batch(ExprContext* context, RowBatch* batch, const int* sel,
+                                      int num_sel, bool short_circuit_val, ExprColumn* column);
+
 private:
     friend class OpcodeRegistry;
 };
@@ -52,6 +57,10 @@ public:
         return pool->add(new AndPredicate(*this));
     }
     virtual doris_udf::BooleanVal get_boolean_val(ExprContext* context, TupleRow*);
+    virtual void evaluate_batch(ExprContext* context, RowBatch* batch, const int* sel,
+                                int num_sel, ExprColumn* column) override {
+        evaluate_short_circuit_batch(context, batch, sel, num_sel, false, column);
+    }
 
 protected:
     friend class Expr;
@@ -74,6 +83,10 @@ public:
         return pool->add(new OrPredicate(*this));
     }
     virtual doris_udf::BooleanVal get_boolean_val(ExprContext* context, TupleRow*);
+    virtual void evaluate_batch(ExprContext* context, RowBatch* batch, const int* sel,
+                                int num_sel, ExprColumn* column) override {
+        evaluate_short_circuit_batch(context, batch, sel, num_sel, true, column);
+    }
 
 protected:
     friend class Expr;
@@ -96,6 +109,8 @@ public:
         return pool->add(new NotPredicate(*this));
     }
     virtual doris_udf::BooleanVal get_boolean_val(ExprContext* context, TupleRow*);
+    virtual void evaluate_batch(ExprContext* context, RowBatch* batch, const int* sel,
+                                int num_sel, ExprColumn* column) override;
 
 protected:
     friend class Expr;
@@ -44,6 +44,7 @@
 #include "gen_cpp/Exprs_types.h"
 #include "gen_cpp/PaloService_types.h"
 #include "runtime/raw_value.h"
+#include "runtime/row_batch.h"
 #include "runtime/runtime_state.h"
 #include "runtime/user_function_cache.h"
 #include "util/debug_util.h"
@@ -815,6 +816,101 @@ DecimalV2Val Expr::get_decimalv2_val(ExprContext* context, TupleRow* row) {
     return val;
 }
 
+template <class T>
+static void evaluate_typed_rows(Expr* expr, T (Expr::*get_val)(ExprContext*, TupleRow*),
+                                ExprContext* context, RowBatch* batch, const int* sel,
+                                int num_sel, bool is_constant, ExprColumn* column) {
+    T* values = column->reset<T>(batch->num_rows());
+    if (is_constant) {
+        if (num_sel > 0) {
+            T value = (expr->*get_val)(context, NULL);
+            for (int i = 0; i < num_sel; ++i) {
+                values[sel[i]] = value;
+            }
+        }
+        return;
+    }
+    for (int i = 0; i < num_sel; ++i) {
+        values[sel[i]] = (expr->*get_val)(context, batch->get_row(sel[i]));
+    }
+}
+
+void Expr::evaluate_rows(ExprContext* context, RowBatch* batch, const int* sel, int num_sel,
+                         bool is_constant, ExprColumn* column) {
+    switch (_type.type) {
+    case TYPE_NULL:
+    case TYPE_BOOLEAN:
+        evaluate_typed_rows<BooleanVal>(this, &Expr::get_boolean_val, context, batch, sel, num_sel,
+                                        is_constant, column);
+        break;
+    case TYPE_TINYINT:
+        evaluate_typed_rows<TinyIntVal>(this, &Expr::get_tiny_int_val, context, batch, sel, num_sel,
+                                        is_constant, column);
+        break;
+    case TYPE_SMALLINT:
+        evaluate_typed_rows<SmallIntVal>(this, &Expr::get_small_int_val, context, batch, sel,
+                                         num_sel, is_constant, column);
+        break;
+    case TYPE_INT:
+        evaluate_typed_rows<IntVal>(this, &Expr::get_int_val, context, batch, sel, num_sel,
+                                    is_constant, column);
+        break;
+    case TYPE_BIGINT:
+        evaluate_typed_rows<BigIntVal>(this, &Expr::get_big_int_val, context, batch, sel, num_sel,
+                                       is_constant, column);
+        break;
+    case TYPE_LARGEINT:
+        evaluate_typed_rows<LargeIntVal>(this, &Expr::get_large_int_val, context, batch, sel,
+                                         num_sel, is_constant, column);
+        break;
+    case TYPE_FLOAT:
+        evaluate_typed_rows<FloatVal>(this, &Expr::get_float_val, context, batch, sel, num_sel,
+                                      is_constant, column);
+        break;
+    case TYPE_DOUBLE:
+        evaluate_typed_rows<DoubleVal>(this, &Expr::get_double_val, context, batch, sel, num_sel,
+                                       is_constant, column);
+        break;
+    case TYPE_CHAR:
+    case TYPE_VARCHAR:
+    case TYPE_HLL:
+    case TYPE_OBJECT:
+        evaluate_typed_rows<StringVal>(this, &Expr::get_string_val, context, batch, sel, num_sel,
+                                       is_constant, column);
+        break;
+    case TYPE_DATE:
+    case TYPE_DATETIME:
+        evaluate_typed_rows<DateTimeVal>(this, &Expr::get_datetime_val, context, batch, sel,
+                                         num_sel, is_constant, column);
+        break;
+    case TYPE_DECIMAL:
+        evaluate_typed_rows<DecimalVal>(this, &Expr::get_decimal_val, context, batch, sel, num_sel,
+                                        is_constant, column);
+        break;
+    case TYPE_DECIMALV2:
+        evaluate_typed_rows<DecimalV2Val>(this, &Expr::get_decimalv2_val, context, batch, sel,
+                                          num_sel, is_constant, column);
+        break;
+    default:
+        DCHECK(false) << "Type not implemented: " << _type;
+        break;
+    }
+}
+
+void Expr::evaluate_batch(ExprContext* context, RowBatch* batch, const int* sel, int num_sel,
+                          ExprColumn* column) {
+    evaluate_rows(context, batch, sel, num_sel, false, column);
+}
+
+bool Expr::has_null_type_child() const {
+    for (int i = 0; i < _children.size(); ++i) {
+        if (_children[i]->type().type == TYPE_NULL) {
+            return true;
+        }
+    }
+    return false;
+}
+
 Status Expr::get_fn_context_error(ExprContext* ctx) {
     if (_fn_context_index != -1) {
         FunctionContext* fn_ctx = ctx->fn_context(_fn_context_index);
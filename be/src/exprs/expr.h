@@ -23,6 +23,7 @@
 #include <vector>
 
 #include "common/status.h"
+#include "exprs/expr_column.h"
 #include "exprs/expr_context.h"
 #include "exprs/expr_value.h"
 #include "gen_cpp/Opcodes_types.h"
@@ -47,6 +48,7 @@ namespace doris {
 
 class Expr;
 class ObjectPool;
+class RowBatch;
 class RowDescriptor;
 class RuntimeState;
 class TColumnValue;
@@ -115,6 +117,13 @@ public:
     virtual DecimalVal get_decimal_val(ExprContext* context, TupleRow*);
     virtual DecimalV2Val get_decimalv2_val(ExprContext* context, TupleRow*);
 
+    /// Batch evaluation: evaluates this expr for the rows 'sel[0, num_sel)' of 'batch' into
+    /// 'column', an array of the *Val type of this expr indexed by row (see ExprColumn).
+    /// The default calls the Get*Val() function of the type for each row. Exprs overriding
+    /// it evaluate their children a batch at a time and loop over the child columns.
+    virtual void evaluate_batch(ExprContext* context, RowBatch* batch, const int* sel,
+                                int num_sel, ExprColumn* column);
+
     // Get the number of digits after the decimal that should be displayed for this
     // value. Returns -1 if no scale has been specified (currently the scale is only set for
     // doubles set by RoundUpTo). get_value() must have already been called.
@@ -282,6 +291,7 @@ protected:
     friend class InfoFunc;
     friend class FunctionCall;
     friend class HashJoinNode;
+    friend class MinMaxFilter;
     friend class ExecNode;
     friend class OlapScanNode;
     friend class SetVar;
@@ -348,6 +358,16 @@ protected:
     FunctionContext* register_function_context(ExprContext* ctx, RuntimeState* state,
                                                int varargs_buffer_size);
 
+    /// Evaluates this expr for the rows 'sel[0, num_sel)' of 'batch' into 'column' with the
+    /// Get*Val() function of its type, a row at a time. If 'is_constant', it's evaluated
+    /// once with no input row and the result is copied to all the rows.
+    void evaluate_rows(ExprContext* context, RowBatch* batch, const int* sel, int num_sel,
+                       bool is_constant, ExprColumn* column);
+
+    /// Returns true if a child is of TYPE_NULL. Its batch results are BooleanVals rather
+    /// than the *Val type this expr reads, so this expr is evaluated a row at a time.
+    bool has_null_type_child() const;
+
     /// Cache entry for the library implementing this function.
     UserFunctionCacheEntry* _cache_entry = nullptr;
 
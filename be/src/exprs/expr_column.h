@@ -0,0 +1,69 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#ifndef DORIS_BE_SRC_QUERY_EXPRS_EXPR_COLUMN_H
+#define DORIS_BE_SRC_QUERY_EXPRS_EXPR_COLUMN_H
+
+#include <cstdint>
+#include <vector>
+
+#include "common/logging.h"
+#include "udf/udf.h"
+
+namespace doris {
+
+// The results of an expr for the rows of a RowBatch, filled by Expr::evaluate_batch().
+// It's an array of the *Val type of the expr (IntVal for an INT expr, etc.) indexed by
+// the row in the batch, only the rows selected for the evaluation are set. Variable
+// length results point to the batch or to the local allocations of the ExprContext.
+class ExprColumn {
+public:
+    // Make room for the values of 'num_rows' rows of *Val type T and return them.
+    // The values are left uninitialized, the buffer is reused across calls.
+    template <class T>
+    T* reset(int num_rows) {
+        _val_size = sizeof(T);
+        _data.resize(num_rows * sizeof(T));
+        return values<T>();
+    }
+
+    template <class T>
+    T* values() {
+        DCHECK_EQ(_val_size, sizeof(T));
+        return reinterpret_cast<T*>(_data.data());
+    }
+
+    template <class T>
+    const T* values() const {
+        DCHECK_EQ(_val_size, sizeof(T));
+        return reinterpret_cast<const T*>(_data.data());
+    }
+
+    // The value of row 'idx', for callers that only know the type at runtime.
+    const doris_udf::AnyVal* any_val(int idx) const {
+        return reinterpret_cast<const doris_udf::AnyVal*>(_data.data() + idx * _val_size);
+    }
+
+private:
+    int _val_size = 0;
+    // operator new aligns it for __int128, the widest member of the *Val types
+    std::vector<uint8_t> _data;
+};
+
+} // namespace doris
+
+#endif
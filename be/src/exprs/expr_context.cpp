@@ -38,6 +38,7 @@ ExprContext::ExprContext(Expr* root)
         : _fn_contexts_ptr(NULL),
           _root(root),
           _is_clone(false),
+          _subexpr_cache(NULL),
           _prepared(false),
           _opened(false),
           _closed(false) {}
@@ -461,6 +462,15 @@ DecimalV2Val ExprContext::get_decimalv2_val(TupleRow* row) {
     return _root->get_decimalv2_val(this, row);
 }
 
+void ExprContext::evaluate_batch(RowBatch* batch, const int* sel, int num_sel,
+                                 ExprColumn* column) {
+    // the shared results are of a single row, they aren't used by the batch evaluation
+    SubexprCache* subexpr_cache = _subexpr_cache;
+    _subexpr_cache = NULL;
+    _root->evaluate_batch(this, batch, sel, num_sel, column);
+    _subexpr_cache = subexpr_cache;
+}
+
 Status ExprContext::get_const_value(RuntimeState* state, Expr& expr, AnyVal** const_val) {
     DCHECK(_opened);
     if (!expr.is_constant()) {
@@ -33,10 +33,13 @@ USING_DORIS_UDF;
 namespace doris {
 
 class Expr;
+class ExprColumn;
 class MemPool;
 class MemTracker;
 class RuntimeState;
+class RowBatch;
 class RowDescriptor;
+class SubexprCache;
 class TColumnValue;
 class TupleRow;
 
@@ -139,6 +142,10 @@ public:
     DecimalVal get_decimal_val(TupleRow* row);
     DecimalV2Val get_decimalv2_val(TupleRow* row);
 
+    /// Evaluates _root for the rows 'sel[0, num_sel)' of 'batch' into 'column', see
+    /// Expr::evaluate_batch().
+    void evaluate_batch(RowBatch* batch, const int* sel, int num_sel, ExprColumn* column);
+
     /// Frees all local allocations made by fn_contexts_. This can be called when result
     /// data from this context is no longer needed.
     void free_local_allocations();
@@ -171,8 +178,10 @@ private:
     friend class ScalarFnCall;
     friend class InPredicate;
     friend class OlapScanNode;
+    friend class CrossJoinNode;
     friend class EsScanNode;
     friend class EsPredicate;
+    friend class SubexprCache;
 
     /// FunctionContexts for each registered expression. The FunctionContexts are created
     /// and owned by this ExprContext.
@@ -196,6 +205,10 @@ private:
     /// True if this context came from a Clone() call. Used to manage FunctionStateScope.
     bool _is_clone;
 
+    /// Shares the results of the common subexprs with the other ctxs of the owner, see
+    /// SubexprCache. Not owned, NULL if nothing is shared.
+    SubexprCache* _subexpr_cache;
+
     /// Variables keeping track of current state.
     bool _prepared;
     bool _opened;
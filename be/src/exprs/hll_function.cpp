@@ -17,6 +17,8 @@
 
 #include "exprs/hll_function.h"
 
+#include <vector>
+
 #include "exprs/anyval_util.h"
 #include "util/hash_util.hpp"
 #include "util/slice.h"
@@ -71,7 +73,32 @@ void HllFunctions::hll_merge(FunctionContext*, const StringVal& src, StringVal*
     if (src.len == 0) {
         dst_hll->merge(*reinterpret_cast<HyperLogLog*>(src.ptr));
     } else {
-        dst_hll->merge(HyperLogLog(Slice(src.ptr, src.len)));
+        dst_hll->merge(Slice(src.ptr, src.len));
+    }
+}
+
+template <typename T>
+void HllFunctions::hll_update_batch(FunctionContext*, const T* srcs, int num_srcs,
+                                    StringVal* dst) {
+    std::vector<uint64_t> hash_values;
+    hash_values.reserve(num_srcs);
+    for (int i = 0; i < num_srcs; ++i) {
+        if (srcs[i].is_null) {
+            continue;
+        }
+        uint64_t hash_value = AnyValUtil::hash64_murmur(srcs[i], HashUtil::MURMUR_SEED);
+        if (hash_value != 0) {
+            hash_values.push_back(hash_value);
+        }
+    }
+    auto* dst_hll = reinterpret_cast<HyperLogLog*>(dst->ptr);
+    dst_hll->update(hash_values.data(), hash_values.size());
+}
+
+void HllFunctions::hll_merge_batch(FunctionContext* ctx, const StringVal* srcs, int num_srcs,
+                                   StringVal* dst) {
+    for (int i = 0; i < num_srcs; ++i) {
+        hll_merge(ctx, srcs[i], dst);
     }
 }
 
@@ -122,4 +149,18 @@ template void HllFunctions::hll_update(FunctionContext*, const DateTimeVal&, Str
 template void HllFunctions::hll_update(FunctionContext*, const LargeIntVal&, StringVal*);
 template void HllFunctions::hll_update(FunctionContext*, const DecimalVal&, StringVal*);
 template void HllFunctions::hll_update(FunctionContext*, const DecimalV2Val&, StringVal*);
+
+template void HllFunctions::hll_update_batch(FunctionContext*, const BooleanVal*, int, StringVal*);
+template void HllFunctions::hll_update_batch(FunctionContext*, const TinyIntVal*, int, StringVal*);
+template void HllFunctions::hll_update_batch(FunctionContext*, const SmallIntVal*, int, StringVal*);
+template void HllFunctions::hll_update_batch(FunctionContext*, const IntVal*, int, StringVal*);
+template void HllFunctions::hll_update_batch(FunctionContext*, const BigIntVal*, int, StringVal*);
+template void HllFunctions::hll_update_batch(FunctionContext*, const FloatVal*, int, StringVal*);
+template void HllFunctions::hll_update_batch(FunctionContext*, const DoubleVal*, int, StringVal*);
+template void HllFunctions::hll_update_batch(FunctionContext*, const StringVal*, int, StringVal*);
+template void HllFunctions::hll_update_batch(FunctionContext*, const DateTimeVal*, int, StringVal*);
+template void HllFunctions::hll_update_batch(FunctionContext*, const LargeIntVal*, int, StringVal*);
+template void HllFunctions::hll_update_batch(FunctionContext*, const DecimalVal*, int, StringVal*);
+template void HllFunctions::hll_update_batch(FunctionContext*, const DecimalV2Val*, int,
+                                             StringVal*);
 } // namespace doris
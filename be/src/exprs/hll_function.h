@@ -31,8 +31,15 @@ public:
 
     template <typename T>
     static void hll_update(FunctionContext*, const T& src, StringVal* dst);
+    // hll_update() on 'num_srcs' values at once.
+    template <typename T>
+    static void hll_update_batch(FunctionContext*, const T* srcs, int num_srcs,
+                                 StringVal* dst);
 
     static void hll_merge(FunctionContext*, const StringVal& src, StringVal* dst);
+    // hll_merge() on 'num_srcs' values at once.
+    static void hll_merge_batch(FunctionContext*, const StringVal* srcs, int num_srcs,
+                                StringVal* dst);
 
     static BigIntVal hll_finalize(FunctionContext*, const StringVal& src);
 
@@ -19,7 +19,9 @@
 #define DORIS_BE_SRC_QUERY_EXPRS_HYBRID_SET_H
 
 #include <cstring>
-#include <unordered_set>
+#include <functional>
+#include <string>
+#include <vector>
 
 #include "common/object_pool.h"
 #include "common/status.h"
@@ -28,9 +30,115 @@
 #include "runtime/decimalv2_value.h"
 #include "runtime/primitive_type.h"
 #include "runtime/string_value.h"
+#include "util/hash_util.hpp"
 
 namespace doris {
 
+// The layout shared by FlatSet and StringValueSet.
+class FlatSetBase {
+protected:
+    // The sets of at most this many values are searched with a branch free scan of the
+    // values, which the compiler vectorizes for the arithmetic types. Beyond that they're
+    // searched in an open addressing table with linear probing.
+    static const int SMALL_SET_SIZE = 16;
+
+    // Returns the number of slots of a table of 'size' values, at most half full.
+    static size_t table_capacity(size_t size) {
+        size_t capacity = 2 * SMALL_SET_SIZE;
+        while (capacity < 2 * size) {
+            capacity *= 2;
+        }
+        return capacity;
+    }
+
+    // Fibonacci hashing spreads the identity hash of the integers over the table.
+    static size_t slot_of(uint64_t hash, int shift) {
+        return (hash * 0x9E3779B97F4A7C15ULL) >> shift;
+    }
+
+    static int table_shift(size_t capacity) { return 64 - __builtin_ctzll(capacity); }
+};
+
+// A set of values of type T kept in a vector in the order of insertion, see FlatSetBase
+// for how they're searched. T must be copyable and comparable with ==.
+template <class T, class Hash = std::hash<T>>
+class FlatSet : private FlatSetBase {
+public:
+    typedef typename std::vector<T>::const_iterator const_iterator;
+
+    // Returns false if 'value' is already in the set.
+    bool insert(const T& value) {
+        if (contains(value)) {
+            return false;
+        }
+        _values.push_back(value);
+        if (_values.size() <= SMALL_SET_SIZE) {
+            return true;
+        }
+        if (2 * _values.size() > _slots.size()) {
+            _slots.assign(table_capacity(_values.size()), Slot());
+            _shift = table_shift(_slots.size());
+            for (const T& v : _values) {
+                insert_slot(v);
+            }
+        } else {
+            insert_slot(value);
+        }
+        return true;
+    }
+
+    bool contains(const T& value) const {
+        if (_slots.empty()) {
+            bool found = false;
+            for (int i = 0; i < _values.size(); ++i) {
+                found |= _values[i] == value;
+            }
+            return found;
+        }
+        size_t mask = _slots.size() - 1;
+        for (size_t i = slot_of(Hash()(value), _shift);; i = (i + 1) & mask) {
+            const Slot& slot = _slots[i];
+            if (!slot.used) {
+                return false;
+            }
+            if (slot.value == value) {
+                return true;
+            }
+        }
+    }
+
+    size_t size() const { return _values.size(); }
+    bool empty() const { return _values.empty(); }
+
+    // In the order of insertion.
+    const std::vector<T>& values() const { return _values; }
+    const_iterator begin() const { return _values.begin(); }
+    const_iterator end() const { return _values.end(); }
+
+    void reserve(size_t size) { _values.reserve(size); }
+
+private:
+    struct Slot {
+        T value;
+        bool used = false;
+    };
+
+    void insert_slot(const T& value) {
+        size_t mask = _slots.size() - 1;
+        size_t i = slot_of(Hash()(value), _shift);
+        while (_slots[i].used) {
+            i = (i + 1) & mask;
+        }
+        _slots[i].value = value;
+        _slots[i].used = true;
+    }
+
+    std::vector<T> _values;
+    // empty while the set is small
+    std::vector<Slot> _slots;
+    int _shift = 0;
+};
+
 class HybridSetBase {
 public:
     HybridSetBase() {}
@@ -42,6 +150,12 @@ public:
     virtual int size() = 0;
     virtual bool find(void* data) = 0;
 
+    // Batch version of find(), the value of row i is at 'values + i * stride' in the
+    // format of the slots. Writes the rows of 'sel[0, num_sel)' whose values are in the
+    // set to 'found', which may be 'sel', and returns their number.
+    virtual int find_batch(const void* values, int stride, const int* sel, int num_sel,
+                           int* found) = 0;
+
     static HybridSetBase* create_set(PrimitiveType type);
     class IteratorBase {
     public:
@@ -53,6 +167,7 @@ public:
     };
 
     virtual IteratorBase* begin() = 0;
+
 };
 
 template <class T>
@@ -62,40 +177,35 @@ public:
 
     virtual ~HybridSet() {}
 
-    virtual void insert(void* data) {
-        if (sizeof(T) >= 16) {
-            // for largeint, it will core dump with no memcpy
-            T value;
-            memcpy(&value, data, sizeof(T));
-            _set.insert(value);
-        } else {
-            _set.insert(*reinterpret_cast<T*>(data));
-        }
-    }
+    virtual void insert(void* data) { _set.insert(load(data)); }
 
     virtual void insert(HybridSetBase* set) {
         HybridSet<T>* hybrid_set = reinterpret_cast<HybridSet<T>*>(set);
-        _set.insert(hybrid_set->_set.begin(), hybrid_set->_set.end());
+        for (const T& value : hybrid_set->_set) {
+            _set.insert(value);
+        }
     }
 
     virtual int size() { return _set.size(); }
-    virtual bool find(void* data) {
-        typename std::unordered_set<T>::const_iterator it = _set.find(*reinterpret_cast<T*>(data));
-
-        if (it == _set.end()) {
-            return false;
-        } else {
-            return true;
+    virtual bool find(void* data) { return _set.contains(load(data)); }
+
+    virtual int find_batch(const void* values, int stride, const int* sel, int num_sel,
+                           int* found) {
+        const char* data = reinterpret_cast<const char*>(values);
+        int num_found = 0;
+        for (int i = 0; i < num_sel; ++i) {
+            int idx = sel[i];
+            found[num_found] = idx;
+            num_found += _set.contains(load(data + idx * stride));
         }
-
-        return false;
+        return num_found;
     }
 
     template <class _iT>
     class Iterator : public IteratorBase {
     public:
-        Iterator(typename std::unordered_set<_iT>::iterator begin,
-                 typename std::unordered_set<_iT>::iterator end)
+        Iterator(typename std::vector<_iT>::const_iterator begin,
+                 typename std::vector<_iT>::const_iterator end)
                 : _begin(begin), _end(end) {}
         virtual ~Iterator() {}
         virtual bool has_next() const { return !(_begin == _end); }
@@ -103,8 +213,8 @@ public:
         virtual void next() { ++_begin; }
 
     private:
-        typename std::unordered_set<_iT>::iterator _begin;
-        typename std::unordered_set<_iT>::iterator _end;
+        typename std::vector<_iT>::const_iterator _begin;
+        typename std::vector<_iT>::const_iterator _end;
     };
 
     IteratorBase* begin() {
@@ -112,46 +222,57 @@ public:
     }
 
 private:
-    std::unordered_set<T> _set;
+    static T load(const void* data) {
+        if (sizeof(T) >= 16) {
+            // for largeint, it will core dump with no memcpy
+            T value;
+            memcpy(&value, data, sizeof(T));
+            return value;
+        }
+        return *reinterpret_cast<const T*>(data);
+    }
+
+    FlatSet<T> _set;
     ObjectPool _pool;
 };
 
-class StringValueSet : public HybridSetBase {
+class StringValueSet : public HybridSetBase, private FlatSetBase {
 public:
-    StringValueSet() {}
+    StringValueSet() : _shift(0) {}
 
     virtual ~StringValueSet() {}
 
-    virtual void insert(void* data) {
-        StringValue* value = reinterpret_cast<StringValue*>(data);
-        std::string str_value(value->ptr, value->len);
-        _set.insert(str_value);
-    }
+    virtual void insert(void* data) { insert_value(*reinterpret_cast<StringValue*>(data)); }
 
     void insert(HybridSetBase* set) {
         StringValueSet* string_set = reinterpret_cast<StringValueSet*>(set);
-        _set.insert(string_set->_set.begin(), string_set->_set.end());
+        for (const std::string& value : string_set->_values) {
+            insert_value(StringValue(value));
+        }
     }
 
-    virtual int size() { return _set.size(); }
+    virtual int size() { return _values.size(); }
     virtual bool find(void* data) {
-        StringValue* value = reinterpret_cast<StringValue*>(data);
-        std::string str_value(value->ptr, value->len);
-        typename std::unordered_set<std::string>::iterator it = _set.find(str_value);
+        const StringValue* value = reinterpret_cast<const StringValue*>(data);
+        return find_value(*value, hash(*value)) != -1;
+    }
 
-        if (it == _set.end()) {
-            return false;
-        } else {
-            return true;
+    virtual int find_batch(const void* values, int stride, const int* sel, int num_sel,
+                           int* found) {
+        const char* data = reinterpret_cast<const char*>(values);
+        int num_found = 0;
+        for (int i = 0; i < num_sel; ++i) {
+            int idx = sel[i];
+            const StringValue* value = reinterpret_cast<const StringValue*>(data + idx * stride);
+            found[num_found] = idx;
+            num_found += find_value(*value, hash(*value)) != -1;
         }
-
-        return false;
+        return num_found;
     }
 
     class Iterator : public IteratorBase {
     public:
-        Iterator(std::unordered_set<std::string>::iterator begin,
-                 std::unordered_set<std::string>::iterator end)
+        Iterator(std::vector<std::string>::iterator begin, std::vector<std::string>::iterator end)
                 : _begin(begin), _end(end) {}
         virtual ~Iterator() {}
         virtual bool has_next() const { return !(_begin == _end); }
@@ -163,17 +284,88 @@ public:
         virtual void next() { ++_begin; }
 
     private:
-        typename std::unordered_set<std::string>::iterator _begin;
-        typename std::unordered_set<std::string>::iterator _end;
+        typename std::vector<std::string>::iterator _begin;
+        typename std::vector<std::string>::iterator _end;
         StringValue _value;
     };
 
     IteratorBase* begin() {
-        return _pool.add(new (std::nothrow) Iterator(_set.begin(), _set.end()));
+        return _pool.add(new (std::nothrow) Iterator(_values.begin(), _values.end()));
     }
 
 private:
-    std::unordered_set<std::string> _set;
+    // A value of the table, the hash saves the comparisons of most of the other values.
+    struct Slot {
+        uint32_t hash;
+        // into _values, -1 if the slot is empty
+        int32_t idx;
+    };
+
+    static uint32_t hash(const StringValue& value) {
+        return HashUtil::hash(value.ptr, value.len, 0);
+    }
+
+    bool equals(const StringValue& value, int idx) const {
+        const std::string& str = _values[idx];
+        return value.len == str.size() && memcmp(value.ptr, str.data(), value.len) == 0;
+    }
+
+    // Returns the index of 'value' in _values, or -1 if it's not in the set.
+    int find_value(const StringValue& value, uint32_t hash) const {
+        if (_slots.empty()) {
+            for (int i = 0; i < _values.size(); ++i) {
+                if (equals(value, i)) {
+                    return i;
+                }
+            }
+            return -1;
+        }
+        size_t mask = _slots.size() - 1;
+        for (size_t i = slot_of(hash, _shift);; i = (i + 1) & mask) {
+            const Slot& slot = _slots[i];
+            if (slot.idx == -1) {
+                return -1;
+            }
+            if (slot.hash == hash && equals(value, slot.idx)) {
+                return slot.idx;
+            }
+        }
+    }
+
+    void insert_value(const StringValue& value) {
+        uint32_t value_hash = hash(value);
+        if (find_value(value, value_hash) != -1) {
+            return;
+        }
+        _values.emplace_back(value.ptr, value.len);
+        if (_values.size() <= SMALL_SET_SIZE) {
+            return;
+        }
+        if (2 * _values.size() > _slots.size()) {
+            _slots.assign(table_capacity(_values.size()), Slot{0, -1});
+            _shift = table_shift(_slots.size());
+            for (int i = 0; i < _values.size(); ++i) {
+                insert_slot(hash(StringValue(_values[i])), i);
+            }
+        } else {
+            insert_slot(value_hash, _values.size() - 1);
+        }
+    }
+
+    void insert_slot(uint32_t hash, int idx) {
+        size_t mask = _slots.size() - 1;
+        size_t i = slot_of(hash, _shift);
+        while (_slots[i].idx != -1) {
+            i = (i + 1) & mask;
+        }
+        _slots[i] = Slot{hash, idx};
+    }
+
+    // the values in the order of insertion
+    std::vector<std::string> _values;
+    // empty while the set is small
+    std::vector<Slot> _slots;
+    int _shift;
     ObjectPool _pool;
 };
 
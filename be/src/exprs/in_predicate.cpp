@@ -18,9 +18,11 @@
 #include "exprs/in_predicate.h"
 
 #include <sstream>
+#include <vector>
 
 #include "exprs/anyval_util.h"
 #include "runtime/raw_value.h"
+#include "runtime/row_batch.h"
 #include "runtime/runtime_state.h"
 #include "runtime/string_value.hpp"
 
@@ -133,4 +135,145 @@ BooleanVal InPredicate::get_boolean_val(ExprContext* ctx, TupleRow* row) {
     return BooleanVal(_is_not_in);
 }
 
+// Look a *Val up in the set, which holds the values in their slot format.
+template <class T>
+static bool find_val(HybridSetBase* set, const T& val) {
+    return set->find(const_cast<decltype(val.val)*>(&val.val));
+}
+
+static bool find_val(HybridSetBase* set, const StringVal& val) {
+    StringValue value = StringValue::from_string_val(val);
+    return set->find(&value);
+}
+
+static bool find_val(HybridSetBase* set, const DateTimeVal& val) {
+    DateTimeValue value = DateTimeValue::from_datetime_val(val);
+    return set->find(&value);
+}
+
+static bool find_val(HybridSetBase* set, const DecimalVal& val) {
+    DecimalValue value = DecimalValue::from_decimal_val(val);
+    return set->find(&value);
+}
+
+static bool find_val(HybridSetBase* set, const DecimalV2Val& val) {
+    DecimalV2Value value = DecimalV2Value::from_decimal_val(val);
+    return set->find(&value);
+}
+
+// Writes the rows of 'sel' whose *Val is in the set to 'found' and returns their number.
+template <class T>
+static int find_rows(HybridSetBase* set, const T* values, const int* sel, int num_sel,
+                     int* found) {
+    // the *Vals of the fixed length types hold the values in their slot format
+    return set->find_batch(&values[0].val, sizeof(T), sel, num_sel, found);
+}
+
+template <class T>
+static int find_converted_rows(HybridSetBase* set, const T* values, const int* sel,
+                               int num_sel, int* found) {
+    int num_found = 0;
+    for (int i = 0; i < num_sel; ++i) {
+        found[num_found] = sel[i];
+        num_found += find_val(set, values[sel[i]]);
+    }
+    return num_found;
+}
+
+static int find_rows(HybridSetBase* set, const StringVal* values, const int* sel, int num_sel,
+                     int* found) {
+    return find_converted_rows(set, values, sel, num_sel, found);
+}
+
+static int find_rows(HybridSetBase* set, const DateTimeVal* values, const int* sel,
+                     int num_sel, int* found) {
+    return find_converted_rows(set, values, sel, num_sel, found);
+}
+
+static int find_rows(HybridSetBase* set, const DecimalVal* values, const int* sel, int num_sel,
+                     int* found) {
+    return find_converted_rows(set, values, sel, num_sel, found);
+}
+
+static int find_rows(HybridSetBase* set, const DecimalV2Val* values, const int* sel,
+                     int num_sel, int* found) {
+    return find_converted_rows(set, values, sel, num_sel, found);
+}
+
+template <class T>
+void InPredicate::find_batch(ExprContext* ctx, RowBatch* batch, const int* sel, int num_sel,
+                             ExprColumn* column) {
+    ExprColumn child;
+    _children[0]->evaluate_batch(ctx, batch, sel, num_sel, &child);
+    const T* values = child.values<T>();
+    BooleanVal* result = column->reset<BooleanVal>(batch->num_rows());
+    if (num_sel == 0) {
+        return;
+    }
+    // the rows not found are set first, the rows found are overwritten after the lookup
+    BooleanVal not_found = _null_in_set ? BooleanVal::null() : BooleanVal(_is_not_in);
+    std::vector<int> rows(num_sel);
+    int num_rows = 0;
+    for (int i = 0; i < num_sel; ++i) {
+        int idx = sel[i];
+        if (values[idx].is_null) {
+            result[idx] = BooleanVal::null();
+        } else {
+            result[idx] = not_found;
+            rows[num_rows++] = idx;
+        }
+    }
+    int num_found = find_rows(_hybrid_set.get(), values, rows.data(), num_rows, rows.data());
+    for (int i = 0; i < num_found; ++i) {
+        result[rows[i]] = BooleanVal(!_is_not_in);
+    }
+}
+
+void InPredicate::evaluate_batch(ExprContext* ctx, RowBatch* batch, const int* sel, int num_sel,
+                                 ExprColumn* column) {
+    switch (_children[0]->type().type) {
+    case TYPE_BOOLEAN:
+        find_batch<BooleanVal>(ctx, batch, sel, num_sel, column);
+        break;
+    case TYPE_TINYINT:
+        find_batch<TinyIntVal>(ctx, batch, sel, num_sel, column);
+        break;
+    case TYPE_SMALLINT:
+        find_batch<SmallIntVal>(ctx, batch, sel, num_sel, column);
+        break;
+    case TYPE_INT:
+        find_batch<IntVal>(ctx, batch, sel, num_sel, column);
+        break;
+    case TYPE_BIGINT:
+        find_batch<BigIntVal>(ctx, batch, sel, num_sel, column);
+        break;
+    case TYPE_LARGEINT:
+        find_batch<LargeIntVal>(ctx, batch, sel, num_sel, column);
+        break;
+    case TYPE_FLOAT:
+        find_batch<FloatVal>(ctx, batch, sel, num_sel, column);
+        break;
+    case TYPE_DOUBLE:
+        find_batch<DoubleVal>(ctx, batch, sel, num_sel, column);
+        break;
+    case TYPE_CHAR:
+    case TYPE_VARCHAR:
+        find_batch<StringVal>(ctx, batch, sel, num_sel, column);
+        break;
+    case TYPE_DATE:
+    case TYPE_DATETIME:
+        find_batch<DateTimeVal>(ctx, batch, sel, num_sel, column);
+        break;
+    case TYPE_DECIMAL:
+        find_batch<DecimalVal>(ctx, batch, sel, num_sel, column);
+        break;
+    case TYPE_DECIMALV2:
+        find_batch<DecimalV2Val>(ctx, batch, sel, num_sel, column);
+        break;
+    default:
+        Expr::evaluate_batch(ctx, batch, sel, num_sel, column);
+        break;
+    }
+}
+
 } // namespace doris
@@ -45,6 +45,8 @@ public:
                            ExprContext* context);
 
     virtual BooleanVal get_boolean_val(ExprContext* context, TupleRow* row);
+    virtual void evaluate_batch(ExprContext* context, RowBatch* batch, const int* sel,
+                                int num_sel, ExprColumn* column) override;
 
     // this function add one item in hashset, not add to children.
     // if add to children, when List is long, copy is a expensive op.
@@ -64,6 +66,12 @@ protected:
     virtual std::string debug_string() const;
 
 private:
+    // Evaluate the first child for the selected rows of 'batch' as *Val type T and look
+    // the values up in the set.
+    template <class T>
+    void find_batch(ExprContext* context, RowBatch* batch, const int* sel, int num_sel,
+                    ExprColumn* column);
+
     const bool _is_not_in;
     bool _is_prepare;
     bool _null_in_set;
@@ -22,6 +22,7 @@
 #include <rapidjson/writer.h>
 #include <re2/re2.h>
 #include <stdlib.h>
+#include <string.h>
 #include <sys/time.h>
 
 #include <boost/algorithm/string.hpp>
@@ -33,6 +34,7 @@
 #include "common/logging.h"
 #include "exprs/anyval_util.h"
 #include "exprs/expr.h"
+#include "exprs/json_walker.h"
 #include "olap/olap_define.h"
 #include "rapidjson/error/en.h"
 #include "runtime/string_value.h"
@@ -51,11 +53,8 @@ IntVal JsonFunctions::get_json_int(FunctionContext* context, const StringVal& js
     if (json_str.is_null || path.is_null) {
         return IntVal::null();
     }
-    std::string json_string((char*)json_str.ptr, json_str.len);
-    std::string path_string((char*)path.ptr, path.len);
     rapidjson::Document document;
-    rapidjson::Value* root =
-            get_json_object(context, json_string, path_string, JSON_FUN_INT, &document);
+    rapidjson::Value* root = get_json_object(context, json_str, path, JSON_FUN_INT, &document);
     if (root != nullptr && root->IsInt()) {
         return IntVal(root->GetInt());
     } else {
@@ -69,11 +68,8 @@ StringVal JsonFunctions::get_json_string(FunctionContext* context, const StringV
         return StringVal::null();
     }
 
-    std::string json_string((char*)json_str.ptr, json_str.len);
-    std::string path_string((char*)path.ptr, path.len);
     rapidjson::Document document;
-    rapidjson::Value* root =
-            get_json_object(context, json_string, path_string, JSON_FUN_STRING, &document);
+    rapidjson::Value* root = get_json_object(context, json_str, path, JSON_FUN_STRING, &document);
     if (root == nullptr || root->IsNull()) {
         return StringVal::null();
     } else if (root->IsString()) {
@@ -91,11 +87,8 @@ DoubleVal JsonFunctions::get_json_double(FunctionContext* context, const StringV
     if (json_str.is_null || path.is_null) {
         return DoubleVal::null();
     }
-    std::string json_string((char*)json_str.ptr, json_str.len);
-    std::string path_string((char*)path.ptr, path.len);
     rapidjson::Document document;
-    rapidjson::Value* root =
-            get_json_object(context, json_string, path_string, JSON_FUN_DOUBLE, &document);
+    rapidjson::Value* root = get_json_object(context, json_str, path, JSON_FUN_DOUBLE, &document);
     if (root == nullptr || root->IsNull()) {
         return DoubleVal::null();
     } else if (root->IsInt()) {
@@ -213,30 +206,32 @@ rapidjson::Value* JsonFunctions::get_json_object(FunctionContext* context,
                                                  const std::string& path_string,
                                                  const JsonFunctionType& fntype,
                                                  rapidjson::Document* document) {
+    return get_json_object(context,
+                           StringVal((uint8_t*)json_string.c_str(), json_string.size()),
+                           StringVal((uint8_t*)path_string.c_str(), path_string.size()), fntype,
+                           document);
+}
+
+rapidjson::Value* JsonFunctions::get_json_object(FunctionContext* context,
+                                                 const StringVal& json_str,
+                                                 const StringVal& path,
+                                                 const JsonFunctionType& fntype,
+                                                 rapidjson::Document* document) {
     // split path by ".", and escape quota by "\"
     // eg:
     //    '$.text#abc.xyz'  ->  [$, text#abc, xyz]
     //    '$."text.abc".xyz'  ->  [$, text.abc, xyz]
     //    '$."text.abc"[1].xyz'  ->  [$, text.abc[1], xyz]
-    std::vector<JsonPath>* parsed_paths;
+    std::vector<JsonPath>* parsed_paths = nullptr;
     std::vector<JsonPath> tmp_parsed_paths;
 #ifndef BE_TEST
     parsed_paths = reinterpret_cast<std::vector<JsonPath>*>(
             context->get_function_state(FunctionContext::FRAGMENT_LOCAL));
+#endif
     if (parsed_paths == nullptr) {
-        boost::tokenizer<boost::escaped_list_separator<char>> tok(
-                path_string, boost::escaped_list_separator<char>("\\", ".", "\""));
-        std::vector<std::string> paths(tok.begin(), tok.end());
-        get_parsed_paths(paths, &tmp_parsed_paths);
+        parse_json_paths(std::string((char*)path.ptr, path.len), &tmp_parsed_paths);
         parsed_paths = &tmp_parsed_paths;
     }
-#else
-    boost::tokenizer<boost::escaped_list_separator<char>> tok(
-            path_string, boost::escaped_list_separator<char>("\\", ".", "\""));
-    std::vector<std::string> paths(tok.begin(), tok.end());
-    get_parsed_paths(paths, &tmp_parsed_paths);
-    parsed_paths = &tmp_parsed_paths;
-#endif
 
     VLOG(10) << "first parsed path: " << (*parsed_paths)[0].debug_string();
 
@@ -244,6 +239,28 @@ rapidjson::Value* JsonFunctions::get_json_object(FunctionContext* context,
         return document;
     }
 
+    // like rapidjson::Document::Parse(const char*), the document ends at the first '\0'
+    const char* json = reinterpret_cast<const char*>(json_str.ptr);
+    const size_t json_len = strnlen(json, json_str.len);
+    if (LIKELY((*parsed_paths).size() > 1)) {
+        // only the value at the path is parsed
+        const char* begin = nullptr;
+        const char* end = nullptr;
+        switch (JsonWalker(json, json_len).find(*parsed_paths, &begin, &end)) {
+        case JsonWalker::FOUND:
+            document->Parse(begin, end - begin);
+            if (UNLIKELY(document->HasParseError())) {
+                document->SetNull();
+            }
+            return document;
+        case JsonWalker::MISSING:
+            return nullptr;
+        case JsonWalker::UNSUPPORTED:
+            break;
+        }
+    }
+
+    std::string json_string(json, json_len);
     if (UNLIKELY((*parsed_paths).size() == 1)) {
         if (fntype == JSON_FUN_STRING) {
             document->SetString(json_string.c_str(), document->GetAllocator());
@@ -86,6 +86,14 @@ public:
                                              const JsonFunctionType& fntype,
                                              rapidjson::Document* document);
 
+    // Only the value at 'path' is parsed into 'document' when the path is made of object
+    // keys and array indexes, the rest of 'json_str' is only validated.
+    static rapidjson::Value* get_json_object(FunctionContext* context,
+                                             const doris_udf::StringVal& json_str,
+                                             const doris_udf::StringVal& path,
+                                             const JsonFunctionType& fntype,
+                                             rapidjson::Document* document);
+
     /**
      * The `document` parameter must be has parsed.
      * return Value Is Array object
@@ -0,0 +1,432 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "exprs/json_walker.h"
+
+#include <string.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "common/logging.h"
+#include "exprs/json_functions.h"
+
+namespace doris {
+
+static int hex_digit(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+JsonWalker::Result JsonWalker::find(const std::vector<JsonPath>& paths, const char** begin,
+                                    const char** end) {
+    // the containers around the value, '{' or '['
+    char containers[MAX_DEPTH];
+    int depth = 0;
+    skip_whitespace();
+    for (int i = 1; i < paths.size(); ++i) {
+        const JsonPath& path = paths[i];
+        // like JsonFunctions::match_value(), nothing matches in a null
+        if (_p == _end || *_p == 'n' || !path.is_valid) {
+            return MISSING;
+        }
+        if (path.idx == -2 || depth + 2 > MAX_DEPTH) {
+            return UNSUPPORTED;
+        }
+        if (!path.key.empty()) {
+            if (*_p == '[') {
+                // the key is looked up in the objects of the array
+                return UNSUPPORTED;
+            } else if (*_p != '{') {
+                return MISSING;
+            }
+            containers[depth++] = '{';
+            Result result = find_member(path.key, depth);
+            if (result != FOUND) {
+                return result;
+            }
+        }
+        if (path.idx != -1) {
+            if (_p == _end || *_p != '[') {
+                return MISSING;
+            }
+            containers[depth++] = '[';
+            Result result = find_element(path.idx, depth);
+            if (result != FOUND) {
+                return result;
+            }
+        }
+    }
+    *begin = _p;
+    Result result = skip_value(depth);
+    if (result != FOUND) {
+        return result;
+    }
+    *end = _p;
+    // the rest of the document must be valid too
+    while (depth > 0) {
+        result = containers[--depth] == '{' ? skip_members(depth) : skip_elements(depth);
+        if (result != FOUND) {
+            return result;
+        }
+    }
+    skip_whitespace();
+    return _p == _end ? FOUND : MISSING;
+}
+
+JsonWalker::Result JsonWalker::validate() {
+    skip_whitespace();
+    if (_p == _end) {
+        return MISSING;
+    }
+    Result result = skip_value(0);
+    if (result != FOUND) {
+        return result;
+    }
+    skip_whitespace();
+    return _p == _end ? FOUND : MISSING;
+}
+
+JsonWalker::Result JsonWalker::enter() {
+    skip_whitespace();
+    if (_p == _end || (*_p != '{' && *_p != '[')) {
+        return MISSING;
+    }
+    ++_p;
+    _first = true;
+    return FOUND;
+}
+
+JsonWalker::Result JsonWalker::next(char close) {
+    if (consume(close)) {
+        return MISSING;
+    }
+    if (!_first && !consume(',')) {
+        return MISSING;
+    }
+    _first = false;
+    skip_whitespace();
+    return _p == _end ? MISSING : FOUND;
+}
+
+JsonWalker::Result JsonWalker::next_member(const char** name, size_t* name_len, bool* escaped,
+                                           const char** value, const char** value_end) {
+    Result result = next('}');
+    if (result != FOUND) {
+        return result;
+    }
+    if (*_p != '"') {
+        return MISSING;
+    }
+    *name = _p + 1;
+    result = skip_string(escaped);
+    if (result != FOUND) {
+        return result;
+    }
+    *name_len = _p - 1 - *name;
+    if (!consume(':')) {
+        return MISSING;
+    }
+    skip_whitespace();
+    *value = _p;
+    result = skip_value(1);
+    *value_end = _p;
+    return result;
+}
+
+JsonWalker::Result JsonWalker::next_element(const char** value, const char** value_end) {
+    Result result = next(']');
+    if (result != FOUND) {
+        return result;
+    }
+    *value = _p;
+    result = skip_value(1);
+    *value_end = _p;
+    return result;
+}
+
+void JsonWalker::find_string_special() {
+#ifdef __SSE2__
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i control = _mm_set1_epi8(0x1F);
+    while (_end - _p >= 16) {
+        __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(_p));
+        __m128i special = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(chars, quote), _mm_cmpeq_epi8(chars, backslash)),
+                _mm_cmpeq_epi8(_mm_max_epu8(chars, control), control));
+        int mask = _mm_movemask_epi8(special);
+        if (mask != 0) {
+            _p += __builtin_ctz(mask);
+            return;
+        }
+        _p += 16;
+    }
+#endif
+    while (_p < _end && *_p != '"' && *_p != '\\' && static_cast<uint8_t>(*_p) >= 0x20) {
+        ++_p;
+    }
+}
+
+JsonWalker::Result JsonWalker::skip_string(bool* escaped) {
+    DCHECK_EQ('"', *_p);
+    ++_p;
+    *escaped = false;
+    while (true) {
+        find_string_special();
+        if (_p == _end || (*_p != '\\' && *_p != '"')) {
+            // unterminated or with a control character
+            return MISSING;
+        }
+        if (*_p == '"') {
+            ++_p;
+            return FOUND;
+        }
+        *escaped = true;
+        if (_end - _p < 2) {
+            return MISSING;
+        }
+        char c = _p[1];
+        if (c == 'u') {
+            if (_end - _p < 6) {
+                return MISSING;
+            }
+            int code = 0;
+            for (int i = 2; i < 6; ++i) {
+                int digit = hex_digit(_p[i]);
+                if (digit < 0) {
+                    return MISSING;
+                }
+                code = code * 16 + digit;
+            }
+            if (code >= 0xD800 && code <= 0xDFFF) {
+                // surrogates, whose validation is left to rapidjson
+                return UNSUPPORTED;
+            }
+            _p += 6;
+        } else if (c == '"' || c == '\\' || c == '/' || c == 'b' || c == 'f' || c == 'n' ||
+                   c == 'r' || c == 't') {
+            _p += 2;
+        } else {
+            return MISSING;
+        }
+    }
+}
+
+int JsonWalker::skip_digits() {
+    const char* start = _p;
+    while (_p < _end && *_p >= '0' && *_p <= '9') {
+        ++_p;
+    }
+    return _p - start;
+}
+
+JsonWalker::Result JsonWalker::skip_number() {
+    if (*_p == '-') {
+        ++_p;
+    }
+    if (_p < _end && *_p == '0') {
+        ++_p;
+    } else {
+        int digits = skip_digits();
+        if (digits == 0) {
+            return MISSING;
+        }
+        // rapidjson fails on the numbers beyond the range of double
+        if (digits > 300) {
+            return UNSUPPORTED;
+        }
+    }
+    if (_p < _end && *_p == '.') {
+        ++_p;
+        if (skip_digits() == 0) {
+            return MISSING;
+        }
+    }
+    if (_p < _end && (*_p == 'e' || *_p == 'E')) {
+        ++_p;
+        if (_p < _end && (*_p == '+' || *_p == '-')) {
+            ++_p;
+        }
+        int digits = skip_digits();
+        if (digits == 0) {
+            return MISSING;
+        }
+        if (digits > 2) {
+            return UNSUPPORTED;
+        }
+    }
+    return FOUND;
+}
+
+JsonWalker::Result JsonWalker::skip_literal(const char* literal, size_t len) {
+    if (_end - _p < len || memcmp(_p, literal, len) != 0) {
+        return MISSING;
+    }
+    _p += len;
+    return FOUND;
+}
+
+JsonWalker::Result JsonWalker::skip_value(int depth) {
+    skip_whitespace();
+    if (_p == _end) {
+        return MISSING;
+    }
+    switch (*_p) {
+    case '{':
+        if (depth == MAX_DEPTH) {
+            return UNSUPPORTED;
+        }
+        ++_p;
+        return consume('}') ? FOUND : skip_members(depth + 1, false);
+    case '[':
+        if (depth == MAX_DEPTH) {
+            return UNSUPPORTED;
+        }
+        ++_p;
+        return consume(']') ? FOUND : skip_elements(depth + 1, false);
+    case '"': {
+        bool escaped;
+        return skip_string(&escaped);
+    }
+    case 't':
+        return skip_literal("true", 4);
+    case 'f':
+        return skip_literal("false", 5);
+    case 'n':
+        return skip_literal("null", 4);
+    default:
+        if (*_p == '-' || (*_p >= '0' && *_p <= '9')) {
+            return skip_number();
+        }
+        return MISSING;
+    }
+}
+
+JsonWalker::Result JsonWalker::skip_members(int depth, bool after_value) {
+    if (after_value) {
+        if (consume('}')) {
+            return FOUND;
+        } else if (!consume(',')) {
+            return MISSING;
+        }
+    }
+    while (true) {
+        skip_whitespace();
+        bool escaped;
+        if (_p == _end || *_p != '"') {
+            return MISSING;
+        }
+        Result result = skip_string(&escaped);
+        if (result != FOUND) {
+            return result;
+        }
+        if (!consume(':')) {
+            return MISSING;
+        }
+        result = skip_value(depth);
+        if (result != FOUND) {
+            return result;
+        }
+        if (consume('}')) {
+            return FOUND;
+        } else if (!consume(',')) {
+            return MISSING;
+        }
+    }
+}
+
+JsonWalker::Result JsonWalker::skip_elements(int depth, bool after_value) {
+    while (true) {
+        if (after_value) {
+            if (consume(']')) {
+                return FOUND;
+            } else if (!consume(',')) {
+                return MISSING;
+            }
+        }
+        after_value = true;
+        Result result = skip_value(depth);
+        if (result != FOUND) {
+            return result;
+        }
+    }
+}
+
+JsonWalker::Result JsonWalker::find_member(const std::string& key, int depth) {
+    ++_p;
+    if (consume('}')) {
+        return MISSING;
+    }
+    while (true) {
+        skip_whitespace();
+        if (_p == _end || *_p != '"') {
+            return MISSING;
+        }
+        const char* name = _p + 1;
+        bool escaped;
+        Result result = skip_string(&escaped);
+        if (result != FOUND) {
+            return result;
+        }
+        if (escaped) {
+            // rapidjson compares the unescaped names
+            return UNSUPPORTED;
+        }
+        const size_t name_len = _p - 1 - name;
+        if (!consume(':')) {
+            return MISSING;
+        }
+        skip_whitespace();
+        if (name_len == key.size() && memcmp(name, key.data(), name_len) == 0) {
+            return FOUND;
+        }
+        result = skip_value(depth);
+        if (result != FOUND) {
+            return result;
+        }
+        if (consume('}') || !consume(',')) {
+            return MISSING;
+        }
+    }
+}
+
+JsonWalker::Result JsonWalker::find_element(int idx, int depth) {
+    ++_p;
+    if (consume(']')) {
+        return MISSING;
+    }
+    for (int i = 0;; ++i) {
+        skip_whitespace();
+        if (i == idx) {
+            return FOUND;
+        }
+        Result result = skip_value(depth);
+        if (result != FOUND) {
+            return result;
+        }
+        if (consume(']') || !consume(',')) {
+            return MISSING;
+        }
+    }
+}
+
+} // namespace doris
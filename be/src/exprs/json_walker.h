@@ -0,0 +1,114 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#ifndef DORIS_BE_SRC_QUERY_EXPRS_JSON_WALKER_H
+#define DORIS_BE_SRC_QUERY_EXPRS_JSON_WALKER_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace doris {
+
+struct JsonPath;
+
+// Walks a json document without parsing it into a DOM: finds the value at a simple json
+// path, one made of object keys and array indexes, or iterates the members of an object
+// and the elements of an array. The values are returned as the ranges of their text,
+// which can be parsed with rapidjson.
+//
+// The skipped values are validated the way rapidjson parses them, so that the results
+// are the same as those of the parsed document. The cases where rapidjson could behave
+// differently are UNSUPPORTED and left to rapidjson.
+class JsonWalker {
+public:
+    enum Result { FOUND, MISSING, UNSUPPORTED };
+
+    JsonWalker(const char* json, size_t len) : _p(json), _end(json + len) {}
+
+    // Sets [*begin, *end) to the value at 'paths' if FOUND, like
+    // JsonFunctions::match_value(). The path must not match the objects of an array
+    // with a key, which is UNSUPPORTED. An invalid document is MISSING, as the paths of
+    // an invalid document match nothing.
+    Result find(const std::vector<JsonPath>& paths, const char** begin, const char** end);
+
+    // Validates the document, FOUND if it's valid.
+    Result validate();
+
+    // Enters the object or array of the document, FOUND if it's one.
+    Result enter();
+
+    // Sets the name and the value of the next member of the entered object, MISSING
+    // after the last one. '*escaped' is set if the name has escaped characters.
+    Result next_member(const char** name, size_t* name_len, bool* escaped,
+                       const char** value, const char** value_end);
+
+    // Sets the next element of the entered array, like next_member().
+    Result next_element(const char** value, const char** value_end);
+
+private:
+    static const int MAX_DEPTH = 256;
+
+    void skip_whitespace() {
+        while (_p < _end && (*_p == ' ' || *_p == '\n' || *_p == '\r' || *_p == '\t')) {
+            ++_p;
+        }
+    }
+
+    bool consume(char c) {
+        skip_whitespace();
+        if (_p < _end && *_p == c) {
+            ++_p;
+            return true;
+        }
+        return false;
+    }
+
+    // Moves to the next '"', '\\' or control character of a string.
+    void find_string_special();
+    // Skips the string at _p, '*escaped' is set if it has escaped characters.
+    Result skip_string(bool* escaped);
+    // Skips the digits at _p and returns their number.
+    int skip_digits();
+    Result skip_number();
+    Result skip_literal(const char* literal, size_t len);
+    // Skips the value at _p, which is nested in 'depth' containers.
+    Result skip_value(int depth);
+    // Skips the members of an object up to its '}'. If 'after_value', _p is after the
+    // value of a member, otherwise it's at the key of the first member.
+    Result skip_members(int depth, bool after_value = true);
+    // Skips the elements of an array up to its ']', like skip_members().
+    Result skip_elements(int depth, bool after_value = true);
+    // Moves _p from the '{' of an object, which is nested in 'depth' containers, to the
+    // value of its first member named 'key'.
+    Result find_member(const std::string& key, int depth);
+    // Moves _p from the '[' of an array to its element 'idx', like find_member().
+    Result find_element(int idx, int depth);
+    // Moves _p to the next member or element of the entered container, whose end is
+    // 'close', MISSING at its end.
+    Result next(char close);
+
+    const char* _p;
+    const char* _end;
+    // if no member or element of the entered container has been returned yet
+    bool _first = true;
+};
+
+} // namespace doris
+
+#endif
@@ -64,6 +64,7 @@ void LikePredicate::like_prepare(FunctionContext* context,
         StringValue pattern = StringValue::from_string_val(pattern_val);
         std::string pattern_str(pattern.ptr, pattern.len);
         std::string search_string;
+        std::vector<std::string> segments;
         if (RE2::FullMatch(pattern_str, LIKE_ENDS_WITH_RE, &search_string)) {
             remove_escape_character(&search_string);
             state->set_search_string(search_string);
@@ -80,6 +81,9 @@ void LikePredicate::like_prepare(FunctionContext* context,
             remove_escape_character(&search_string);
             state->set_search_string(search_string);
             state->function = constant_starts_with_fn;
+        } else if (split_like_pattern(pattern_str, &segments)) {
+            state->set_segments(&segments);
+            state->function = constant_segments_fn;
         } else {
             std::string re_pattern;
             convert_like_pattern(context,
@@ -315,6 +319,36 @@ BooleanVal LikePredicate::constant_equals_fn(FunctionContext* context, const Str
     return BooleanVal(state->search_string_sv.eq(StringValue::from_string_val(val)));
 }
 
+BooleanVal LikePredicate::constant_segments_fn(FunctionContext* context, const StringVal& val,
+                                               const StringVal& pattern) {
+    if (val.is_null) {
+        return BooleanVal::null();
+    }
+    LikePredicateState* state = reinterpret_cast<LikePredicateState*>(
+            context->get_function_state(FunctionContext::THREAD_LOCAL));
+    const std::vector<StringValue>& segments = state->segment_svs;
+    const StringValue& first = segments.front();
+    const StringValue& last = segments.back();
+    char* ptr = reinterpret_cast<char*>(val.ptr);
+    if (val.len < first.len + last.len ||
+        (first.len > 0 && memcmp(ptr, first.ptr, first.len) != 0) ||
+        (last.len > 0 && memcmp(ptr + val.len - last.len, last.ptr, last.len) != 0)) {
+        return BooleanVal(false);
+    }
+    // the leftmost match of each segment leaves the most room for the next ones
+    int begin = first.len;
+    int end = val.len - last.len;
+    for (int i = 1; i + 1 < segments.size(); ++i) {
+        StringValue rest(ptr + begin, end - begin);
+        int pos = state->segment_patterns[i].search(&rest);
+        if (pos == -1) {
+            return BooleanVal(false);
+        }
+        begin += pos + segments[i].len;
+    }
+    return BooleanVal(true);
+}
+
 BooleanVal LikePredicate::constant_regex_fn_partial(FunctionContext* context, const StringVal& val,
                                                     const StringVal& pattern) {
     if (val.is_null) {
@@ -417,6 +451,28 @@ void LikePredicate::convert_like_pattern(FunctionContext* context, const StringV
     }
 }
 
+bool LikePredicate::split_like_pattern(const std::string& pattern,
+                                       std::vector<std::string>* segments) {
+    segments->assign(1, std::string());
+    for (int i = 0; i < pattern.size(); ++i) {
+        char c = pattern[i];
+        if (c == '\\') {
+            if (i + 1 == pattern.size() || (pattern[i + 1] != '%' && pattern[i + 1] != '_')) {
+                return false;
+            }
+            segments->back().push_back(pattern[++i]);
+        } else if (c == '_') {
+            return false;
+        } else if (c != '%') {
+            segments->back().push_back(c);
+        } else if (segments->size() == 1 || !segments->back().empty()) {
+            // '%%' is the same as '%'
+            segments->emplace_back();
+        }
+    }
+    return segments->size() > 1;
+}
+
 void LikePredicate::remove_escape_character(std::string* search_string) {
     std::string tmp_search_string;
     tmp_search_string.swap(*search_string);
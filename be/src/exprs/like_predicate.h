@@ -22,6 +22,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "exprs/predicate.h"
 #include "gen_cpp/Exprs_types.h"
@@ -68,6 +69,14 @@ private:
         /// Used for RLIKE and REGEXP predicates if the pattern is a constant argument.
         std::unique_ptr<re2::RE2> regex;
 
+        /// Used for LIKE predicates if the pattern is a constant argument made of several
+        /// constant strings separated by '%', e.g. 'a%b%c' or '%a%b%'. The value must start
+        /// with the first one and end with the last one, which are empty if the pattern
+        /// starts or ends with '%', and contain the others in order in between.
+        std::vector<std::string> segments;
+        std::vector<StringValue> segment_svs;
+        std::vector<StringSearch> segment_patterns;
+
         LikePredicateState() : escape_char('\\') {}
 
         void set_search_string(const std::string& search_string_arg) {
@@ -75,6 +84,17 @@ private:
             search_string_sv = StringValue(search_string);
             substring_pattern = StringSearch(&search_string_sv);
         }
+
+        void set_segments(std::vector<std::string>* segments_arg) {
+            segments.swap(*segments_arg);
+            for (const std::string& segment : segments) {
+                segment_svs.push_back(StringValue(segment));
+            }
+            // the searches point to the values, which don't move from now on
+            for (const StringValue& segment_sv : segment_svs) {
+                segment_patterns.push_back(StringSearch(&segment_sv));
+            }
+        }
     };
 
     friend class OpcodeRegistry;
@@ -137,6 +157,11 @@ private:
                                                     const doris_udf::StringVal& val,
                                                     const doris_udf::StringVal& pattern);
 
+    /// Handling of like predicates that are constant strings separated by '%'
+    static doris_udf::BooleanVal constant_segments_fn(doris_udf::FunctionContext* context,
+                                                      const doris_udf::StringVal& val,
+                                                      const doris_udf::StringVal& pattern);
+
     static doris_udf::BooleanVal constant_regex_fn_partial(doris_udf::FunctionContext* context,
                                                            const doris_udf::StringVal& val,
                                                            const doris_udf::StringVal& pattern);
@@ -156,6 +181,11 @@ private:
                                      const doris_udf::StringVal& pattern, std::string* re_pattern);
 
     static void remove_escape_character(std::string* search_string);
+
+    /// Splits a LIKE pattern at its '%'s into 'segments', see LikePredicateState::segments.
+    /// Returns false if the pattern has a '_' or an escape other than '\%' and '\_'.
+    static bool split_like_pattern(const std::string& pattern,
+                                   std::vector<std::string>* segments);
 };
 
 } // namespace doris
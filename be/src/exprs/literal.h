@@ -44,6 +44,11 @@ public:
     virtual DateTimeVal get_datetime_val(ExprContext* context, TupleRow*);
     virtual StringVal get_string_val(ExprContext* context, TupleRow* row);
 
+    virtual void evaluate_batch(ExprContext* context, RowBatch* batch, const int* sel,
+                                int num_sel, ExprColumn* column) override {
+        evaluate_rows(context, batch, sel, num_sel, true, column);
+    }
+
 protected:
     friend class Expr;
     Literal(const TExprNode& node);
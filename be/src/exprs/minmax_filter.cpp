@@ -0,0 +1,240 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "exprs/minmax_filter.h"
+
+#include "exprs/expr.h"
+#include "exprs/expr_context.h"
+#include "gen_cpp/Exprs_types.h"
+#include "runtime/large_int_value.h"
+#include "runtime/raw_value.h"
+
+namespace doris {
+
+MinMaxFilter::MinMaxFilter(const TypeDescriptor& type)
+        : _type(type), _empty(true), _min_addr(nullptr), _max_addr(nullptr) {}
+
+bool MinMaxFilter::is_supported(const TypeDescriptor& type) {
+    switch (type.type) {
+    case TYPE_BOOLEAN:
+    case TYPE_TINYINT:
+    case TYPE_SMALLINT:
+    case TYPE_INT:
+    case TYPE_BIGINT:
+    case TYPE_LARGEINT:
+    case TYPE_FLOAT:
+    case TYPE_DOUBLE:
+    case TYPE_DATE:
+    case TYPE_DATETIME:
+    case TYPE_DECIMALV2:
+    case TYPE_CHAR:
+    case TYPE_VARCHAR:
+        return true;
+    default:
+        return false;
+    }
+}
+
+void* MinMaxFilter::_assign(ExprValue* dst, const void* value) {
+    switch (_type.type) {
+    case TYPE_BOOLEAN:
+        dst->bool_val = *reinterpret_cast<const bool*>(value);
+        return &dst->bool_val;
+    case TYPE_TINYINT:
+        dst->tinyint_val = *reinterpret_cast<const int8_t*>(value);
+        return &dst->tinyint_val;
+    case TYPE_SMALLINT:
+        dst->smallint_val = *reinterpret_cast<const int16_t*>(value);
+        return &dst->smallint_val;
+    case TYPE_INT:
+        dst->int_val = *reinterpret_cast<const int32_t*>(value);
+        return &dst->int_val;
+    case TYPE_BIGINT:
+        dst->bigint_val = *reinterpret_cast<const int64_t*>(value);
+        return &dst->bigint_val;
+    case TYPE_LARGEINT:
+        // value may be unaligned
+        memcpy(&dst->large_int_val, value, sizeof(__int128));
+        return &dst->large_int_val;
+    case TYPE_FLOAT:
+        dst->float_val = *reinterpret_cast<const float*>(value);
+        return &dst->float_val;
+    case TYPE_DOUBLE:
+        dst->double_val = *reinterpret_cast<const double*>(value);
+        return &dst->double_val;
+    case TYPE_DATE:
+    case TYPE_DATETIME:
+        dst->datetime_val = *reinterpret_cast<const DateTimeValue*>(value);
+        return &dst->datetime_val;
+    case TYPE_DECIMALV2:
+        memcpy(&dst->decimalv2_val, value, sizeof(DecimalV2Value));
+        return &dst->decimalv2_val;
+    case TYPE_CHAR:
+    case TYPE_VARCHAR:
+        dst->set_string_val(*reinterpret_cast<const StringValue*>(value));
+        return &dst->string_val;
+    default:
+        DCHECK(false) << "unsupported type: " << _type;
+        return nullptr;
+    }
+}
+
+void MinMaxFilter::insert(const void* value) {
+    DCHECK(value != nullptr);
+    if (_empty) {
+        _min_addr = _assign(&_min, value);
+        _max_addr = _assign(&_max, value);
+        _empty = false;
+        return;
+    }
+    if (RawValue::compare(value, _min_addr, _type) < 0) {
+        _assign(&_min, value);
+    } else if (RawValue::compare(value, _max_addr, _type) > 0) {
+        _assign(&_max, value);
+    }
+}
+
+Status MinMaxFilter::create_predicates(ObjectPool* pool, Expr* probe_expr,
+                                       std::list<ExprContext*>* expr_ctxs) const {
+    DCHECK(!_empty);
+    ExprContext* ge_ctx = nullptr;
+    RETURN_IF_ERROR(
+            create_binary_predicate(pool, TExprOpcode::GE, probe_expr, _min_addr, &ge_ctx));
+    ExprContext* le_ctx = nullptr;
+    RETURN_IF_ERROR(
+            create_binary_predicate(pool, TExprOpcode::LE, probe_expr, _max_addr, &le_ctx));
+    expr_ctxs->push_back(ge_ctx);
+    expr_ctxs->push_back(le_ctx);
+    return Status::OK();
+}
+
+static Status create_literal_node(const TypeDescriptor& type, const void* value,
+                                  TExprNode* node) {
+    node->__set_type(type.to_thrift());
+    node->__set_num_children(0);
+    node->__set_output_scale(-1);
+    switch (type.type) {
+    case TYPE_BOOLEAN: {
+        TBoolLiteral literal;
+        literal.__set_value(*reinterpret_cast<const bool*>(value));
+        node->__set_node_type(TExprNodeType::BOOL_LITERAL);
+        node->__set_bool_literal(literal);
+        break;
+    }
+    case TYPE_TINYINT:
+    case TYPE_SMALLINT:
+    case TYPE_INT:
+    case TYPE_BIGINT: {
+        int64_t int_value = 0;
+        if (type.type == TYPE_TINYINT) {
+            int_value = *reinterpret_cast<const int8_t*>(value);
+        } else if (type.type == TYPE_SMALLINT) {
+            int_value = *reinterpret_cast<const int16_t*>(value);
+        } else if (type.type == TYPE_INT) {
+            int_value = *reinterpret_cast<const int32_t*>(value);
+        } else {
+            int_value = *reinterpret_cast<const int64_t*>(value);
+        }
+        TIntLiteral literal;
+        literal.__set_value(int_value);
+        node->__set_node_type(TExprNodeType::INT_LITERAL);
+        node->__set_int_literal(literal);
+        break;
+    }
+    case TYPE_LARGEINT: {
+        __int128 large_int_value;
+        memcpy(&large_int_value, value, sizeof(__int128));
+        TLargeIntLiteral literal;
+        literal.__set_value(LargeIntValue::to_string(large_int_value));
+        node->__set_node_type(TExprNodeType::LARGE_INT_LITERAL);
+        node->__set_large_int_literal(literal);
+        break;
+    }
+    case TYPE_FLOAT:
+    case TYPE_DOUBLE: {
+        TFloatLiteral literal;
+        if (type.type == TYPE_FLOAT) {
+            literal.__set_value(*reinterpret_cast<const float*>(value));
+        } else {
+            literal.__set_value(*reinterpret_cast<const double*>(value));
+        }
+        node->__set_node_type(TExprNodeType::FLOAT_LITERAL);
+        node->__set_float_literal(literal);
+        break;
+    }
+    case TYPE_DATE:
+    case TYPE_DATETIME: {
+        char buf[64];
+        reinterpret_cast<const DateTimeValue*>(value)->to_string(buf);
+        TDateLiteral literal;
+        literal.__set_value(buf);
+        node->__set_node_type(TExprNodeType::DATE_LITERAL);
+        node->__set_date_literal(literal);
+        break;
+    }
+    case TYPE_DECIMALV2: {
+        DecimalV2Value decimal_value;
+        memcpy(&decimal_value, value, sizeof(DecimalV2Value));
+        TDecimalLiteral literal;
+        literal.__set_value(decimal_value.to_string());
+        node->__set_node_type(TExprNodeType::DECIMAL_LITERAL);
+        node->__set_decimal_literal(literal);
+        break;
+    }
+    case TYPE_CHAR:
+    case TYPE_VARCHAR: {
+        TStringLiteral literal;
+        literal.__set_value(reinterpret_cast<const StringValue*>(value)->to_string());
+        node->__set_node_type(TExprNodeType::STRING_LITERAL);
+        node->__set_string_literal(literal);
+        break;
+    }
+    default:
+        return Status::InternalError("unsupported literal type: " + type.debug_string());
+    }
+    return Status::OK();
+}
+
+Status MinMaxFilter::create_binary_predicate(ObjectPool* pool, TExprOpcode::type op, Expr* expr,
+                                             const void* value, ExprContext** ctx) {
+    const TypeDescriptor& type = expr->type();
+    if (!is_supported(type)) {
+        return Status::InternalError("unsupported predicate type: " + type.debug_string());
+    }
+
+    TExprNode literal_node;
+    RETURN_IF_ERROR(create_literal_node(type, value, &literal_node));
+    Expr* literal = nullptr;
+    RETURN_IF_ERROR(Expr::create_expr(pool, literal_node, &literal));
+
+    TExprNode pred_node;
+    pred_node.__set_node_type(TExprNodeType::BINARY_PRED);
+    pred_node.__set_type(TypeDescriptor(TYPE_BOOLEAN).to_thrift());
+    pred_node.__set_opcode(op);
+    pred_node.__set_child_type(to_thrift(type.type));
+    pred_node.__set_num_children(2);
+    pred_node.__set_output_scale(-1);
+    Expr* pred = nullptr;
+    RETURN_IF_ERROR(Expr::create_expr(pool, pred_node, &pred));
+    pred->add_child(Expr::copy(pool, expr));
+    pred->add_child(literal);
+
+    *ctx = pool->add(new ExprContext(pred));
+    return Status::OK();
+}
+
+} // namespace doris
@@ -0,0 +1,77 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#ifndef DORIS_BE_SRC_QUERY_EXPRS_MINMAX_FILTER_H
+#define DORIS_BE_SRC_QUERY_EXPRS_MINMAX_FILTER_H
+
+#include <list>
+
+#include "common/object_pool.h"
+#include "common/status.h"
+#include "exprs/expr_value.h"
+#include "gen_cpp/Opcodes_types.h"
+#include "runtime/types.h"
+
+namespace doris {
+
+class Expr;
+class ExprContext;
+
+// Tracks the min and max of the values inserted into it, and turns them into
+// "expr >= min" and "expr <= max" predicates.
+// HashJoinNode uses it to push a range filter built from its hash table down to
+// the probe side when the build side is too large for an IN predicate. The scan
+// node normalizes the predicates into column value ranges like any other conjunct.
+class MinMaxFilter {
+public:
+    MinMaxFilter(const TypeDescriptor& type);
+
+    // Return true if values of 'type' can be turned into a literal.
+    static bool is_supported(const TypeDescriptor& type);
+
+    // NULL values must be skipped by caller.
+    void insert(const void* value);
+
+    bool empty() const { return _empty; }
+
+    const void* min_value() const { return _min_addr; }
+    const void* max_value() const { return _max_addr; }
+
+    // Append "probe_expr >= min" and "probe_expr <= max" to expr_ctxs.
+    // Contexts are not prepared, caller should prepare them against the
+    // descriptor of the node which evaluates them.
+    Status create_predicates(ObjectPool* pool, Expr* probe_expr,
+                             std::list<ExprContext*>* expr_ctxs) const;
+
+    // Create "<expr> <op> <value>" where value is of expr's type.
+    static Status create_binary_predicate(ObjectPool* pool, TExprOpcode::type op, Expr* expr,
+                                          const void* value, ExprContext** ctx);
+
+private:
+    void* _assign(ExprValue* dst, const void* value);
+
+    TypeDescriptor _type;
+    bool _empty;
+    ExprValue _min;
+    ExprValue _max;
+    void* _min_addr;
+    void* _max_addr;
+};
+
+} // namespace doris
+
+#endif
@@ -20,17 +20,22 @@
 #include <thrift/protocol/TDebugProtocol.h>
 
 #include <sstream>
+#include <utility>
+#include <vector>
 
 #include "common/logging.h"
 #include "exprs/agg_fn.h"
 #include "exprs/aggregate_functions.h"
 #include "exprs/anyval_util.h"
+#include "exprs/bitmap_function.h"
 #include "exprs/expr.h"
 #include "exprs/expr_context.h"
+#include "exprs/hll_function.h"
 #include "exprs/scalar_fn_call.h"
 #include "gutil/strings/substitute.h"
 #include "runtime/mem_tracker.h"
 #include "runtime/raw_value.h"
+#include "runtime/row_batch.h"
 #include "runtime/runtime_state.h"
 #include "runtime/string_value.h"
 #include "udf/udf_internal.h"
@@ -395,6 +400,102 @@ inline void NewAggFnEvaluator::set_any_val(const void* slot, const TypeDescripto
     }
 }
 
+namespace {
+
+// Updates 'dst' with the values of the first 'num_rows' rows of 'column'.
+typedef void (*BatchUpdateFn)(FunctionContext*, const ExprColumn& column, int num_rows,
+                              AnyVal* dst);
+
+template <typename SRC_VAL, typename DST_VAL,
+          void (*FN)(FunctionContext*, const SRC_VAL*, int, DST_VAL*)>
+void batch_update(FunctionContext* ctx, const ExprColumn& column, int num_rows, AnyVal* dst) {
+    FN(ctx, column.values<SRC_VAL>(), num_rows, static_cast<DST_VAL*>(dst));
+}
+
+template <typename T>
+std::pair<void*, BatchUpdateFn> hll_update_fns() {
+    return {reinterpret_cast<void*>(&HllFunctions::hll_update<T>),
+            &batch_update<T, StringVal, &HllFunctions::hll_update_batch<T>>};
+}
+
+// The overloads of percentile_approx_update() without and with the compression.
+typedef void (*PercentileApproxUpdateFn)(FunctionContext*, const DoubleVal&, const DoubleVal&,
+                                         StringVal*);
+typedef void (*PercentileApproxCompressionUpdateFn)(FunctionContext*, const DoubleVal&,
+                                                    const DoubleVal&, const DoubleVal&,
+                                                    StringVal*);
+
+// The batch version of the update or merge function 'fn' of a builtin, nullptr if it
+// has none.
+BatchUpdateFn get_batch_update_fn(void* fn) {
+    static const std::vector<std::pair<void*, BatchUpdateFn>> batch_update_fns = {
+            {reinterpret_cast<void*>(&AggregateFunctions::sum<DecimalV2Val, DecimalV2Val>),
+             &batch_update<DecimalV2Val, DecimalV2Val,
+                           &AggregateFunctions::sum_decimalv2_batch>},
+            {reinterpret_cast<void*>(&AggregateFunctions::decimalv2_avg_update),
+             &batch_update<DecimalV2Val, StringVal,
+                           &AggregateFunctions::decimalv2_avg_update_batch>},
+            {reinterpret_cast<void*>(&BitmapFunctions::bitmap_union),
+             &batch_update<StringVal, StringVal, &BitmapFunctions::bitmap_union_batch>},
+            {reinterpret_cast<void*>(&HllFunctions::hll_merge),
+             &batch_update<StringVal, StringVal, &HllFunctions::hll_merge_batch>},
+            hll_update_fns<BooleanVal>(),
+            hll_update_fns<TinyIntVal>(),
+            hll_update_fns<SmallIntVal>(),
+            hll_update_fns<IntVal>(),
+            hll_update_fns<BigIntVal>(),
+            hll_update_fns<FloatVal>(),
+            hll_update_fns<DoubleVal>(),
+            hll_update_fns<StringVal>(),
+            hll_update_fns<DateTimeVal>(),
+            hll_update_fns<LargeIntVal>(),
+            hll_update_fns<DecimalVal>(),
+            hll_update_fns<DecimalV2Val>(),
+            {reinterpret_cast<void*>(static_cast<PercentileApproxUpdateFn>(
+                     &AggregateFunctions::percentile_approx_update<DoubleVal>)),
+             &batch_update<DoubleVal, StringVal,
+                           &AggregateFunctions::percentile_approx_update_batch>},
+            {reinterpret_cast<void*>(static_cast<PercentileApproxCompressionUpdateFn>(
+                     &AggregateFunctions::percentile_approx_update<DoubleVal>)),
+             &batch_update<DoubleVal, StringVal,
+                           &AggregateFunctions::percentile_approx_update_batch>},
+            {reinterpret_cast<void*>(&AggregateFunctions::percentile_approx_merge),
+             &batch_update<StringVal, StringVal,
+                           &AggregateFunctions::percentile_approx_merge_batch>},
+    };
+    for (const auto& entry : batch_update_fns) {
+        if (entry.first == fn) return entry.second;
+    }
+    return nullptr;
+}
+
+} // namespace
+
+bool NewAggFnEvaluator::AddBatch(RowBatch* batch, Tuple* dst) {
+    if (!agg_fn_.is_builtin()) return false;
+    BatchUpdateFn batch_update_fn = get_batch_update_fn(agg_fn_.merge_or_update_fn());
+    if (batch_update_fn == nullptr) return false;
+    // only the first argument is evaluated, the batch fns get the others from the context
+    for (int i = 1; i < input_evals_.size(); ++i) {
+        if (!agg_fn_ctx_->is_arg_constant(i)) return false;
+    }
+
+    const int num_rows = batch->num_rows();
+    if (batch_sel_.size() < num_rows) {
+        int old_size = batch_sel_.size();
+        batch_sel_.resize(num_rows);
+        for (int i = old_size; i < num_rows; ++i) batch_sel_[i] = i;
+    }
+    input_evals_[0]->evaluate_batch(batch, batch_sel_.data(), num_rows, &batch_input_column_);
+
+    const SlotDescriptor& slot_desc = intermediate_slot_desc();
+    SetAnyVal(slot_desc, dst, staging_intermediate_val_);
+    batch_update_fn(agg_fn_ctx_.get(), batch_input_column_, num_rows, staging_intermediate_val_);
+    SetDstSlot(staging_intermediate_val_, slot_desc, dst);
+    agg_fn_ctx_->impl()->increment_num_updates(num_rows);
+    return true;
+}
+
 void NewAggFnEvaluator::Update(const TupleRow* row, Tuple* dst, void* fn) {
     if (fn == nullptr) return;
 
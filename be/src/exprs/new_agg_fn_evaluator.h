@@ -26,6 +26,7 @@
 #include "common/compiler_util.h"
 #include "common/status.h"
 #include "exprs/agg_fn.h"
+#include "exprs/expr_column.h"
 #include "exprs/hybrid_map.h"
 #include "gen_cpp/Exprs_types.h"
 #include "gen_cpp/PlanNodes_types.h"
@@ -41,6 +42,7 @@ namespace doris {
 class MemPool;
 class MemTracker;
 class ObjectPool;
+class RowBatch;
 class RowDescriptor;
 class RuntimeState;
 class SlotDescriptor;
@@ -122,6 +124,14 @@ public:
     /// the AggFn is a merging aggregation.
     void Add(const TupleRow* src, Tuple* dst);
 
+    /// Updates the aggregation intermediate value 'dst' with all the rows of 'batch' at
+    /// once, evaluating the input expression with Expr::evaluate_batch(). Only some
+    /// builtins have a batch update function: SUM() and AVG() of decimalv2, the
+    /// BITMAP_UNION() family which unions the bitmaps of the batch at once, and the
+    /// HLL_UNION() and NDV() families. Returns
+    /// false without doing anything for the others, which must be updated with Add().
+    bool AddBatch(RowBatch* batch, Tuple* dst);
+
     /// Updates the intermediate state dst to remove the input src row, i.e. undo
     /// Add(src, dst). Only used internally for analytic fn builtins.
     void Remove(const TupleRow* src, Tuple* dst);
@@ -235,6 +245,10 @@ private:
     doris_udf::AnyVal* staging_intermediate_val_ = nullptr;
     doris_udf::AnyVal* staging_merge_input_val_ = nullptr;
 
+    /// The input values and selection of AddBatch(), reused across batches.
+    ExprColumn batch_input_column_;
+    std::vector<int> batch_sel_;
+
     /// Use Create() instead.
     NewAggFnEvaluator(const AggFn& agg_fn, MemPool* mem_pool,
                       const std::shared_ptr<MemTracker>& tracker, bool is_clone);
@@ -43,6 +43,11 @@ public:
     virtual doris_udf::DecimalVal get_decimal_val(ExprContext*, TupleRow*);
     virtual doris_udf::DecimalV2Val get_decimalv2_val(ExprContext*, TupleRow*);
 
+    virtual void evaluate_batch(ExprContext* context, RowBatch* batch, const int* sel,
+                                int num_sel, ExprColumn* column) override {
+        evaluate_rows(context, batch, sel, num_sel, true, column);
+    }
+
 protected:
     friend class Expr;
 
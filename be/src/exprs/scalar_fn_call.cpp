@@ -21,6 +21,8 @@
 
 #include "exprs/anyval_util.h"
 #include "exprs/expr_context.h"
+#include "exprs/subexpr_cache.h"
+#include "runtime/row_batch.h"
 #include "runtime/runtime_state.h"
 #include "runtime/user_function_cache.h"
 #include "udf/udf_internal.h"
@@ -35,7 +37,10 @@ ScalarFnCall::ScalarFnCall(const TExprNode& node)
           _scalar_fn_wrapper(NULL),
           _prepare_fn(NULL),
           _close_fn(NULL),
-          _scalar_fn(NULL) {
+          _batch_fn(NULL),
+          _scalar_fn(NULL),
+          _subexpr_idx(-1),
+          _is_folded(false) {
     DCHECK_NE(_fn.binary_type, TFunctionBinaryType::HIVE);
 }
 
@@ -151,6 +156,10 @@ Status ScalarFnCall::prepare(RuntimeState* state, const RowDescriptor& desc, Exp
         RETURN_IF_ERROR(get_function(state, _fn.scalar_fn.close_fn_symbol,
                                      reinterpret_cast<void**>(&_close_fn)));
     }
+    if (_fn.scalar_fn.__isset.batch_fn_symbol && _vararg_start_idx == -1) {
+        RETURN_IF_ERROR(get_function(state, _fn.scalar_fn.batch_fn_symbol,
+                                     reinterpret_cast<void**>(&_batch_fn)));
+    }
 
     return status;
 }
@@ -198,6 +207,30 @@ Status ScalarFnCall::open(RuntimeState* state, ExprContext* ctx,
         }
     }
 
+    // Fold the calls on constant arguments, they're evaluated once per fragment instead of
+    // once per row
+    if (scope == FunctionContext::FRAGMENT_LOCAL && !_children.empty() && !is_volatile()) {
+        bool all_args_constant = true;
+        for (int i = 0; i < _children.size(); ++i) {
+            all_args_constant &= fn_ctx->is_arg_constant(i);
+        }
+        if (all_args_constant) {
+            AnyVal* val = get_const_val(ctx);
+            RETURN_IF_ERROR(get_fn_context_error(ctx));
+            if (_type.is_string_type()) {
+                // the result may be allocated by the FunctionContext, which frees it with
+                // the local allocations
+                StringVal* string_val = reinterpret_cast<StringVal*>(val);
+                if (!string_val->is_null) {
+                    _folded_string.assign(reinterpret_cast<char*>(string_val->ptr),
+                                          string_val->len);
+                    string_val->ptr = reinterpret_cast<uint8_t*>(&_folded_string[0]);
+                }
+            }
+            _is_folded = true;
+        }
+    }
+
     // If we're calling MathFunctions::RoundUpTo(), we need to set _output_scale, which
     // determines how many decimal places are printed.
     // TODO: revisit this. We should be able to do this if the scale argument is
@@ -226,12 +259,20 @@ void ScalarFnCall::close(RuntimeState* state, ExprContext* context,
 }
 
 bool ScalarFnCall::is_constant() const {
-    if (_fn.name.function_name == "rand") {
+    if (is_volatile()) {
         return false;
     }
     return Expr::is_constant();
 }
 
+bool ScalarFnCall::is_volatile() const {
+    return is_volatile_fn(_fn.name.function_name);
+}
+
+bool ScalarFnCall::is_volatile_fn(const std::string& fn_name) {
+    return fn_name == "rand" || fn_name == "random" || fn_name == "sleep";
+}
+
 Status ScalarFnCall::get_function(RuntimeState* state, const std::string& symbol, void** fn) {
     if (_fn.binary_type == TFunctionBinaryType::NATIVE ||
         _fn.binary_type == TFunctionBinaryType::BUILTIN ||
@@ -277,6 +318,27 @@ void ScalarFnCall::evaluate_children(ExprContext* context, TupleRow* row,
 
 template <typename RETURN_TYPE>
 RETURN_TYPE ScalarFnCall::interpret_eval(ExprContext* context, TupleRow* row) {
+    if (_is_folded) {
+        return *reinterpret_cast<RETURN_TYPE*>(_constant_val.get());
+    }
+    SubexprCache* cache = context->_subexpr_cache;
+    if (_subexpr_idx == -1 || cache == NULL) {
+        return call_scalar_fn<RETURN_TYPE>(context, row);
+    }
+    const AnyVal* cached = cache->get(_subexpr_idx);
+    if (cached != NULL) {
+        return *reinterpret_cast<const RETURN_TYPE*>(cached);
+    }
+    RETURN_TYPE val = call_scalar_fn<RETURN_TYPE>(context, row);
+    // a failed call isn't shared, the other calls report their own errors
+    if (!context->fn_context(_fn_context_index)->has_error()) {
+        cache->put(_subexpr_idx, val);
+    }
+    return val;
+}
+
+template <typename RETURN_TYPE>
+RETURN_TYPE ScalarFnCall::call_scalar_fn(ExprContext* context, TupleRow* row) {
     DCHECK(_scalar_fn != NULL);
     FunctionContext* fn_ctx = context->fn_context(_fn_context_index);
     std::vector<AnyVal*>* input_vals = fn_ctx->impl()->staging_input_vals();
@@ -546,6 +608,120 @@ DecimalV2Val ScalarFnCall::get_decimalv2_val(ExprContext* context, TupleRow* row
     return fn(context, row);
 }
 
+template <typename RETURN_TYPE>
+void ScalarFnCall::interpret_eval_batch(ExprContext* context, RowBatch* batch, const int* sel,
+                                        int num_sel, ExprColumn* column) {
+    FunctionContext* fn_ctx = context->fn_context(_fn_context_index);
+    if (_batch_fn != NULL) {
+        std::vector<ExprColumn> arg_columns(_children.size());
+        std::vector<const AnyVal*> arg_vals(_children.size());
+        for (int i = 0; i < _children.size(); ++i) {
+            _children[i]->evaluate_batch(context, batch, sel, num_sel, &arg_columns[i]);
+            arg_vals[i] = arg_columns[i].any_val(0);
+        }
+        RETURN_TYPE* result = column->reset<RETURN_TYPE>(batch->num_rows());
+        _batch_fn(fn_ctx, num_sel, sel, arg_vals.data(), result);
+        return;
+    }
+    ExprColumn args[3];
+    for (int i = 0; i < _children.size(); ++i) {
+        _children[i]->evaluate_batch(context, batch, sel, num_sel, &args[i]);
+    }
+    RETURN_TYPE* result = column->reset<RETURN_TYPE>(batch->num_rows());
+    switch (_children.size()) {
+    case 1: {
+        typedef RETURN_TYPE (*ScalarFn1)(FunctionContext*, const AnyVal& a1);
+        ScalarFn1 fn = reinterpret_cast<ScalarFn1>(_scalar_fn);
+        for (int i = 0; i < num_sel; ++i) {
+            int idx = sel[i];
+            result[idx] = fn(fn_ctx, *args[0].any_val(idx));
+        }
+        break;
+    }
+    case 2: {
+        typedef RETURN_TYPE (*ScalarFn2)(FunctionContext*, const AnyVal& a1, const AnyVal& a2);
+        ScalarFn2 fn = reinterpret_cast<ScalarFn2>(_scalar_fn);
+        for (int i = 0; i < num_sel; ++i) {
+            int idx = sel[i];
+            result[idx] = fn(fn_ctx, *args[0].any_val(idx), *args[1].any_val(idx));
+        }
+        break;
+    }
+    case 3: {
+        typedef RETURN_TYPE (*ScalarFn3)(FunctionContext*, const AnyVal& a1, const AnyVal& a2,
+                                         const AnyVal& a3);
+        ScalarFn3 fn = reinterpret_cast<ScalarFn3>(_scalar_fn);
+        for (int i = 0; i < num_sel; ++i) {
+            int idx = sel[i];
+            result[idx] = fn(fn_ctx, *args[0].any_val(idx), *args[1].any_val(idx),
+                             *args[2].any_val(idx));
+        }
+        break;
+    }
+    default:
+        DCHECK(false);
+        break;
+    }
+}
+
+void ScalarFnCall::evaluate_batch(ExprContext* context, RowBatch* batch, const int* sel,
+                                  int num_sel, ExprColumn* column) {
+    if (_is_folded) {
+        evaluate_rows(context, batch, sel, num_sel, true, column);
+        return;
+    }
+    if (_scalar_fn_wrapper != NULL || _vararg_start_idx != -1 || has_null_type_child() ||
+        (_batch_fn == NULL && (_children.empty() || _children.size() > 3))) {
+        Expr::evaluate_batch(context, batch, sel, num_sel, column);
+        return;
+    }
+    switch (_type.type) {
+    case TYPE_BOOLEAN:
+        interpret_eval_batch<BooleanVal>(context, batch, sel, num_sel, column);
+        break;
+    case TYPE_TINYINT:
+        interpret_eval_batch<TinyIntVal>(context, batch, sel, num_sel, column);
+        break;
+    case TYPE_SMALLINT:
+        interpret_eval_batch<SmallIntVal>(context, batch, sel, num_sel, column);
+        break;
+    case TYPE_INT:
+        interpret_eval_batch<IntVal>(context, batch, sel, num_sel, column);
+        break;
+    case TYPE_BIGINT:
+        interpret_eval_batch<BigIntVal>(context, batch, sel, num_sel, column);
+        break;
+    case TYPE_LARGEINT:
+        interpret_eval_batch<LargeIntVal>(context, batch, sel, num_sel, column);
+        break;
+    case TYPE_FLOAT:
+        interpret_eval_batch<FloatVal>(context, batch, sel, num_sel, column);
+        break;
+    case TYPE_DOUBLE:
+        interpret_eval_batch<DoubleVal>(context, batch, sel, num_sel, column);
+        break;
+    case TYPE_CHAR:
+    case TYPE_VARCHAR:
+    case TYPE_HLL:
+    case TYPE_OBJECT:
+        interpret_eval_batch<StringVal>(context, batch, sel, num_sel, column);
+        break;
+    case TYPE_DATE:
+    case TYPE_DATETIME:
+        interpret_eval_batch<DateTimeVal>(context, batch, sel, num_sel, column);
+        break;
+    case TYPE_DECIMAL:
+        interpret_eval_batch<DecimalVal>(context, batch, sel, num_sel, column);
+        break;
+    case TYPE_DECIMALV2:
+        interpret_eval_batch<DecimalV2Val>(context, batch, sel, num_sel, column);
+        break;
+    default:
+        Expr::evaluate_batch(context, batch, sel, num_sel, column);
+        break;
+    }
+}
+
 std::string ScalarFnCall::debug_string() const {
     std::stringstream out;
     out << "ScalarFnCall(udf_type=" << _fn.binary_type << " location=" << _fn.hdfs_location
@@ -54,8 +54,13 @@ public:
         return pool->add(new ScalarFnCall(*this));
     }
 
+    /// Returns true if the function 'fn_name' may return different results for the same
+    /// arguments or is called for its side effects, see is_volatile().
+    static bool is_volatile_fn(const std::string& fn_name);
+
 protected:
     friend class Expr;
+    friend class SubexprCache;
 
     ScalarFnCall(const TExprNode& node);
     virtual Status prepare(RuntimeState* state, const RowDescriptor& desc, ExprContext* context);
@@ -78,6 +83,9 @@ protected:
     virtual doris_udf::DateTimeVal get_datetime_val(ExprContext* context, TupleRow*);
     virtual doris_udf::DecimalVal get_decimal_val(ExprContext* context, TupleRow*);
     virtual doris_udf::DecimalV2Val get_decimalv2_val(ExprContext* context, TupleRow*);
+
+    virtual void evaluate_batch(ExprContext* context, RowBatch* batch, const int* sel,
+                                int num_sel, ExprColumn* column) override;
     // virtual doris_udf::ArrayVal GetArrayVal(ExprContext* context, TupleRow*);
 
 private:
@@ -100,10 +108,29 @@ private:
     /// in Close().
     UdfClose _close_fn;
 
+    /// The UDF's batch form, if specified. This is initialized in Prepare() and called by
+    /// evaluate_batch() instead of the UDF for each row.
+    UdfBatch _batch_fn;
+
     /// If running with codegen disabled, _scalar_fn will be a pointer to the non-JIT'd
     /// scalar function.
     void* _scalar_fn;
 
+    /// The index of the result of this call in the SubexprCache of the ExprContext, the
+    /// calls of the same function on the same arguments share it. -1 if not shared.
+    int _subexpr_idx;
+
+    /// True if all the arguments are constant, the result is computed once in Open() and
+    /// kept in _constant_val.
+    bool _is_folded;
+
+    /// Backs the folded result of a string function.
+    std::string _folded_string;
+
+    /// Returns true if the calls may return different results for the same arguments or
+    /// are made for their side effects, such calls are neither folded nor shared.
+    bool is_volatile() const;
+
     /// Returns the number of non-vararg arguments
     int num_fixed_args() const {
         return _vararg_start_idx >= 0 ? _vararg_start_idx : _children.size();
@@ -119,9 +146,22 @@ private:
     void evaluate_children(ExprContext* context, TupleRow* row,
                            std::vector<doris_udf::AnyVal*>* input_vals);
 
-    /// Function to call _scalar_fn. Used in the interpreted path.
+    /// Returns the folded or cached result if there is one, otherwise calls
+    /// call_scalar_fn(). Used in the interpreted path.
     template <typename RETURN_TYPE>
     RETURN_TYPE interpret_eval(ExprContext* context, TupleRow* row);
+
+    /// Function to call _scalar_fn. Used in the interpreted path.
+    template <typename RETURN_TYPE>
+    RETURN_TYPE call_scalar_fn(ExprContext* context, TupleRow* row);
+
+    /// Batch version of interpret_eval() for the functions of 1 to 3 fixed arguments, or
+    /// of any number of them with a batch form: the children are evaluated a batch at a
+    /// time and the batch form is called once for the rows, or else the function is
+    /// called for each row with its arguments read from their columns.
+    template <typename RETURN_TYPE>
+    void interpret_eval_batch(ExprContext* context, RowBatch* batch, const int* sel,
+                              int num_sel, ExprColumn* column);
 };
 
 } // namespace doris
@@ -20,6 +20,7 @@
 #include <sstream>
 
 #include "gen_cpp/Exprs_types.h"
+#include "runtime/row_batch.h"
 #include "runtime/runtime_state.h"
 #include "util/types.h"
 
@@ -245,4 +246,118 @@ DecimalV2Val SlotRef::get_decimalv2_val(ExprContext* context, TupleRow* row) {
     return DecimalV2Val(reinterpret_cast<PackedInt128*>(t->get_slot(_slot_offset))->value);
 }
 
+// Convert a slot to its *Val, the same way as the Get*Val() functions above.
+static void slot_to_val(const void* slot, BooleanVal* val) {
+    *val = BooleanVal(*reinterpret_cast<const bool*>(slot));
+}
+
+static void slot_to_val(const void* slot, TinyIntVal* val) {
+    *val = TinyIntVal(*reinterpret_cast<const int8_t*>(slot));
+}
+
+static void slot_to_val(const void* slot, SmallIntVal* val) {
+    *val = SmallIntVal(*reinterpret_cast<const int16_t*>(slot));
+}
+
+static void slot_to_val(const void* slot, IntVal* val) {
+    *val = IntVal(*reinterpret_cast<const int32_t*>(slot));
+}
+
+static void slot_to_val(const void* slot, BigIntVal* val) {
+    *val = BigIntVal(*reinterpret_cast<const int64_t*>(slot));
+}
+
+static void slot_to_val(const void* slot, LargeIntVal* val) {
+    *val = LargeIntVal(reinterpret_cast<const PackedInt128*>(slot)->value);
+}
+
+static void slot_to_val(const void* slot, FloatVal* val) {
+    *val = FloatVal(*reinterpret_cast<const float*>(slot));
+}
+
+static void slot_to_val(const void* slot, DoubleVal* val) {
+    *val = DoubleVal(*reinterpret_cast<const double*>(slot));
+}
+
+static void slot_to_val(const void* slot, StringVal* val) {
+    *val = StringVal();
+    reinterpret_cast<const StringValue*>(slot)->to_string_val(val);
+}
+
+static void slot_to_val(const void* slot, DateTimeVal* val) {
+    *val = DateTimeVal();
+    reinterpret_cast<const DateTimeValue*>(slot)->to_datetime_val(val);
+}
+
+static void slot_to_val(const void* slot, DecimalVal* val) {
+    *val = DecimalVal();
+    reinterpret_cast<const DecimalValue*>(slot)->to_decimal_val(val);
+}
+
+static void slot_to_val(const void* slot, DecimalV2Val* val) {
+    *val = DecimalV2Val(reinterpret_cast<const PackedInt128*>(slot)->value);
+}
+
+template <class T>
+void SlotRef::read_slots(RowBatch* batch, const int* sel, int num_sel, ExprColumn* column) {
+    T* values = column->reset<T>(batch->num_rows());
+    for (int i = 0; i < num_sel; ++i) {
+        Tuple* t = batch->get_row(sel[i])->get_tuple(_tuple_idx);
+        if (t == NULL || t->is_null(_null_indicator_offset)) {
+            values[sel[i]] = T::null();
+        } else {
+            slot_to_val(t->get_slot(_slot_offset), &values[sel[i]]);
+        }
+    }
+}
+
+void SlotRef::evaluate_batch(ExprContext* context, RowBatch* batch, const int* sel, int num_sel,
+                             ExprColumn* column) {
+    switch (_type.type) {
+    case TYPE_BOOLEAN:
+        read_slots<BooleanVal>(batch, sel, num_sel, column);
+        break;
+    case TYPE_TINYINT:
+        read_slots<TinyIntVal>(batch, sel, num_sel, column);
+        break;
+    case TYPE_SMALLINT:
+        read_slots<SmallIntVal>(batch, sel, num_sel, column);
+        break;
+    case TYPE_INT:
+        read_slots<IntVal>(batch, sel, num_sel, column);
+        break;
+    case TYPE_BIGINT:
+        read_slots<BigIntVal>(batch, sel, num_sel, column);
+        break;
+    case TYPE_LARGEINT:
+        read_slots<LargeIntVal>(batch, sel, num_sel, column);
+        break;
+    case TYPE_FLOAT:
+        read_slots<FloatVal>(batch, sel, num_sel, column);
+        break;
+    case TYPE_DOUBLE:
+        read_slots<DoubleVal>(batch, sel, num_sel, column);
+        break;
+    case TYPE_CHAR:
+    case TYPE_VARCHAR:
+    case TYPE_HLL:
+    case TYPE_OBJECT:
+        read_slots<StringVal>(batch, sel, num_sel, column);
+        break;
+    case TYPE_DATE:
+    case TYPE_DATETIME:
+        read_slots<DateTimeVal>(batch, sel, num_sel, column);
+        break;
+    case TYPE_DECIMAL:
+        read_slots<DecimalVal>(batch, sel, num_sel, column);
+        break;
+    case TYPE_DECIMALV2:
+        read_slots<DecimalV2Val>(batch, sel, num_sel, column);
+        break;
+    default:
+        Expr::evaluate_batch(context, batch, sel, num_sel, column);
+        break;
+    }
+}
+
 } // namespace doris
@@ -71,7 +71,14 @@ public:
     virtual doris_udf::DecimalV2Val get_decimalv2_val(ExprContext* context, TupleRow*);
     // virtual doris_udf::ArrayVal GetArrayVal(ExprContext* context, TupleRow*);
 
+    virtual void evaluate_batch(ExprContext* context, RowBatch* batch, const int* sel,
+                                int num_sel, ExprColumn* column) override;
+
 private:
+    // Read the slot of the selected rows of 'batch' into 'column' as *Val type T.
+    template <class T>
+    void read_slots(RowBatch* batch, const int* sel, int num_sel, ExprColumn* column);
+
     int _tuple_idx;                             // within row
     int _slot_offset;                           // within tuple
     NullIndicatorOffset _null_indicator_offset; // within tuple
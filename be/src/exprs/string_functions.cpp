@@ -19,6 +19,10 @@
 
 #include <re2/re2.h>
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 #include <algorithm>
 
 #include "exprs/anyval_util.h"
@@ -27,6 +31,7 @@
 #include "runtime/string_value.hpp"
 #include "runtime/tuple_row.h"
 #include "util/url_parser.h"
+#include "util/utf8_check.h"
 
 // NOTE: be careful not to use string::append.  It is not performant.
 namespace doris {
@@ -60,6 +65,61 @@ size_t get_char_len(const StringVal& str, std::vector<size_t>* str_index) {
     return char_len;
 }
 
+static inline bool is_ascii(const uint8_t* ptr, size_t len) {
+    return validate_ascii(reinterpret_cast<const char*>(ptr), len);
+}
+
+// Like get_char_len(), but the chars of an ascii string are its bytes, so its index is
+// left empty, see char_offset().
+static size_t get_char_index(const StringVal& str, std::vector<size_t>* str_index) {
+    if (is_ascii(str.ptr, str.len)) {
+        return str.len;
+    }
+    return get_char_len(str, str_index);
+}
+
+// The byte offset of char 'i' of a string indexed by get_char_index().
+static inline size_t char_offset(const std::vector<size_t>& str_index, size_t i) {
+    return str_index.empty() ? i : str_index[i];
+}
+
+// The number of chars in the first 'len' bytes of 'ptr'.
+static size_t count_chars(const uint8_t* ptr, size_t len) {
+    if (is_ascii(ptr, len)) {
+        return len;
+    }
+    size_t char_len = 0;
+    for (size_t i = 0, char_size = 0; i < len; i += char_size) {
+        char_size = get_utf8_byte_length(ptr[i]);
+        ++char_len;
+    }
+    return char_len;
+}
+
+// Adds 'delta' to the bytes of 'src' in ['first', 'last'], a range of ascii letters, e.g.
+// 'A'..'Z' and 'a' - 'A' for lower(). Other bytes, including the ones of multi byte utf8
+// chars, are copied as they are, like ::tolower() and ::toupper() do in the C locale.
+static void convert_case(const uint8_t* src, int len, char first, char last, char delta,
+                         uint8_t* dst) {
+    int i = 0;
+#ifdef __SSE2__
+    // the comparisons are signed, the bytes >= 0x80 are negative and out of the range
+    const __m128i before_first = _mm_set1_epi8(first - 1);
+    const __m128i after_last = _mm_set1_epi8(last + 1);
+    const __m128i deltas = _mm_set1_epi8(delta);
+    for (; i + 16 <= len; i += 16) {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m128i in_range = _mm_and_si128(_mm_cmpgt_epi8(bytes, before_first),
+                                         _mm_cmplt_epi8(bytes, after_last));
+        bytes = _mm_add_epi8(bytes, _mm_and_si128(in_range, deltas));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), bytes);
+    }
+#endif
+    for (; i < len; ++i) {
+        dst[i] = src[i] >= first && src[i] <= last ? src[i] + delta : src[i];
+    }
+}
+
 // This behaves identically to the mysql implementation, namely:
 //  - 1-indexed positions
 //  - supported negative positions (count from the end of the string)
@@ -73,6 +133,16 @@ StringVal StringFunctions::substring(FunctionContext* context, const StringVal&
         return StringVal();
     }
 
+    if (is_ascii(str.ptr, str.len)) {
+        // the chars are the bytes
+        int64_t fixed_pos = pos.val < 0 ? str.len + pos.val + 1 : pos.val;
+        if (fixed_pos < 1) {
+            return StringVal();
+        }
+        int64_t fixed_len = std::min<int64_t>(len.val, str.len - fixed_pos + 1);
+        return StringVal(str.ptr + fixed_pos - 1, fixed_len);
+    }
+
     // create index indicate every char start byte
     // e.g.  "hello word 你好" => [0,1,2,3,4,5,6,7,8,9,10,11,14] 你 and 好 are 3 bytes
     // why use a vector as index? It is unnecessary if there is no negative pos val,
@@ -202,21 +272,21 @@ StringVal StringFunctions::lpad(FunctionContext* context, const StringVal& str,
     }
 
     std::vector<size_t> str_index;
-    size_t str_char_size = get_char_len(str, &str_index);
+    size_t str_char_size = get_char_index(str, &str_index);
     std::vector<size_t> pad_index;
-    size_t pad_char_size = get_char_len(pad, &pad_index);
+    size_t pad_char_size = get_char_index(pad, &pad_index);
 
     // Corner cases: Shrink the original string, or leave it alone.
     // TODO: Hive seems to go into an infinite loop if pad.len == 0,
     // so we should pay attention to Hive's future solution to be compatible.
     if (len.val <= str_char_size || pad.len == 0) {
-        if (len.val > str_index.size()) {
+        if (len.val > str_char_size) {
             return StringVal::null();
         }
-        if (len.val == str_index.size()) {
-            return StringVal(str.ptr, len.val);
+        if (len.val == str_char_size) {
+            return StringVal(str.ptr, str.len);
         }
-        return StringVal(str.ptr, str_index[len.val]);
+        return StringVal(str.ptr, char_offset(str_index, len.val));
     }
 
     // TODO pengyubing
@@ -225,7 +295,7 @@ StringVal StringFunctions::lpad(FunctionContext* context, const StringVal& str,
     int32_t pad_times = (len.val - str_char_size) / pad_char_size;
     int32_t pad_remainder = (len.val - str_char_size) % pad_char_size;
     pad_byte_len = pad_times * pad.len;
-    pad_byte_len += pad_index[pad_remainder];
+    pad_byte_len += char_offset(pad_index, pad_remainder);
     int32_t byte_len = str.len + pad_byte_len;
     StringVal result(context, byte_len);
     if (result.is_null) {
@@ -253,21 +323,21 @@ StringVal StringFunctions::rpad(FunctionContext* context, const StringVal& str,
     }
 
     std::vector<size_t> str_index;
-    size_t str_char_size = get_char_len(str, &str_index);
+    size_t str_char_size = get_char_index(str, &str_index);
     std::vector<size_t> pad_index;
-    size_t pad_char_size = get_char_len(pad, &pad_index);
+    size_t pad_char_size = get_char_index(pad, &pad_index);
 
     // Corner cases: Shrink the original string, or leave it alone.
     // TODO: Hive seems to go into an infinite loop if pad->len == 0,
     // so we should pay attention to Hive's future solution to be compatible.
     if (len.val <= str_char_size || pad.len == 0) {
-        if (len.val > str_index.size()) {
+        if (len.val > str_char_size) {
             return StringVal::null();
         }
-        if (len.val == str_index.size()) {
-            return StringVal(str.ptr, len.val);
+        if (len.val == str_char_size) {
+            return StringVal(str.ptr, str.len);
         }
-        return StringVal(str.ptr, str_index[len.val]);
+        return StringVal(str.ptr, char_offset(str_index, len.val));
     }
 
     // TODO pengyubing
@@ -276,7 +346,7 @@ StringVal StringFunctions::rpad(FunctionContext* context, const StringVal& str,
     int32_t pad_times = (len.val - str_char_size) / pad_char_size;
     int32_t pad_remainder = (len.val - str_char_size) % pad_char_size;
     pad_byte_len = pad_times * pad.len;
-    pad_byte_len += pad_index[pad_remainder];
+    pad_byte_len += char_offset(pad_index, pad_remainder);
     int32_t byte_len = str.len + pad_byte_len;
     StringVal result(context, byte_len);
     if (UNLIKELY(result.is_null)) {
@@ -333,12 +403,7 @@ IntVal StringFunctions::char_utf8_length(FunctionContext* context, const StringV
     if (str.is_null) {
         return IntVal::null();
     }
-    size_t char_len = 0;
-    for (size_t i = 0, char_size = 0; i < str.len; i += char_size) {
-        char_size = get_utf8_byte_length((unsigned)(str.ptr)[i]);
-        ++char_len;
-    }
-    return IntVal(char_len);
+    return IntVal(count_chars(str.ptr, str.len));
 }
 
 StringVal StringFunctions::lower(FunctionContext* context, const StringVal& str) {
@@ -351,9 +416,7 @@ StringVal StringFunctions::lower(FunctionContext* context, const StringVal& str)
     if (UNLIKELY(result.is_null)) {
         return result;
     }
-    for (int i = 0; i < str.len; ++i) {
-        result.ptr[i] = ::tolower(str.ptr[i]);
-    }
+    convert_case(str.ptr, str.len, 'A', 'Z', 'a' - 'A', result.ptr);
     return result;
 }
 
@@ -367,9 +430,7 @@ StringVal StringFunctions::upper(FunctionContext* context, const StringVal& str)
     if (UNLIKELY(result.is_null)) {
         return result;
     }
-    for (int i = 0; i < str.len; ++i) {
-        result.ptr[i] = ::toupper(str.ptr[i]);
-    }
+    convert_case(str.ptr, str.len, 'a', 'z', 'A' - 'a', result.ptr);
     return result;
 }
 
@@ -458,12 +519,7 @@ IntVal StringFunctions::instr(FunctionContext* context, const StringVal& str,
     // Hive returns positions starting from 1.
     int loc = search.search(&str_sv);
     if (loc > 0) {
-        size_t char_len = 0;
-        for (size_t i = 0, char_size = 0; i < loc; i += char_size) {
-            char_size = get_utf8_byte_length((unsigned)(str.ptr)[i]);
-            ++char_len;
-        }
-        loc = char_len;
+        loc = count_chars(str.ptr, loc);
     }
 
     return IntVal(loc + 1);
@@ -494,24 +550,20 @@ IntVal StringFunctions::locate_pos(FunctionContext* context, const StringVal& su
     // but throws an exception for *start_pos > str->len.
     // Since returning 0 seems to be Hive's error condition, return 0.
     std::vector<size_t> index;
-    size_t char_len = get_char_len(str, &index);
+    size_t char_len = get_char_index(str, &index);
     if (start_pos.val <= 0 || start_pos.val > str.len || start_pos.val > char_len) {
         return IntVal(0);
     }
     StringValue substr_sv = StringValue::from_string_val(substr);
     StringSearch search(&substr_sv);
     // Input start_pos.val starts from 1.
-    StringValue adjusted_str(reinterpret_cast<char*>(str.ptr) + index[start_pos.val - 1],
-                             str.len - index[start_pos.val - 1]);
+    size_t start_offset = char_offset(index, start_pos.val - 1);
+    StringValue adjusted_str(reinterpret_cast<char*>(str.ptr) + start_offset,
+                             str.len - start_offset);
     int32_t match_pos = search.search(&adjusted_str);
     if (match_pos >= 0) {
         // Hive returns the position in the original string starting from 1.
-        size_t char_len = 0;
-        for (size_t i = 0, char_size = 0; i < match_pos; i += char_size) {
-            char_size = get_utf8_byte_length((unsigned)(adjusted_str.ptr)[i]);
-            ++char_len;
-        }
-        match_pos = char_len;
+        match_pos = count_chars(reinterpret_cast<uint8_t*>(adjusted_str.ptr), match_pos);
         return IntVal(start_pos.val + match_pos);
     } else {
         return IntVal(0);
@@ -0,0 +1,108 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "exprs/subexpr_cache.h"
+
+#include <algorithm>
+
+#include "common/object_pool.h"
+#include "exprs/anyval_util.h"
+#include "exprs/expr_context.h"
+#include "exprs/scalar_fn_call.h"
+#include "gen_cpp/Exprs_types.h"
+
+namespace doris {
+
+namespace {
+
+// A function call and the thrift nodes of its subtree.
+struct FnCall {
+    ScalarFnCall* expr;
+    const TExprNode* nodes;
+    int num_nodes;
+};
+
+// Collects the function calls in the tree of 'expr', which is created from the nodes
+// starting at nodes[*node_idx]. On return *node_idx is the last node of the tree.
+// Returns false if the tree doesn't match the nodes.
+bool collect_fn_calls(const std::vector<TExprNode>& nodes, Expr* expr, int* node_idx,
+                      std::vector<FnCall>* fn_calls) {
+    if (*node_idx >= nodes.size() || nodes[*node_idx].num_children != expr->get_num_children()) {
+        return false;
+    }
+    int first = *node_idx;
+    for (int i = 0; i < expr->get_num_children(); ++i) {
+        ++*node_idx;
+        if (!collect_fn_calls(nodes, expr->get_child(i), node_idx, fn_calls)) {
+            return false;
+        }
+    }
+    ScalarFnCall* fn_call = dynamic_cast<ScalarFnCall*>(expr);
+    if (fn_call != nullptr) {
+        fn_calls->push_back({fn_call, &nodes[first], *node_idx - first + 1});
+    }
+    return true;
+}
+
+bool same_subtree(const FnCall& a, const FnCall& b) {
+    return a.num_nodes == b.num_nodes && std::equal(a.nodes, a.nodes + a.num_nodes, b.nodes);
+}
+
+} // namespace
+
+SubexprCache* SubexprCache::create(ObjectPool* pool, const std::vector<TExpr>& texprs,
+                                   const std::vector<ExprContext*>& ctxs) {
+    DCHECK_EQ(texprs.size(), ctxs.size());
+    std::vector<FnCall> fn_calls;
+    for (int i = 0; i < ctxs.size(); ++i) {
+        DCHECK(!ctxs[i]->_is_clone);
+        int node_idx = 0;
+        if (!collect_fn_calls(texprs[i].nodes, ctxs[i]->root(), &node_idx, &fn_calls)) {
+            return nullptr;
+        }
+    }
+
+    SubexprCache* cache = nullptr;
+    for (int i = 0; i < fn_calls.size(); ++i) {
+        ScalarFnCall* expr = fn_calls[i].expr;
+        if (expr->_subexpr_idx != -1 || expr->is_constant() || expr->is_volatile()) {
+            continue;
+        }
+        for (int j = i + 1; j < fn_calls.size(); ++j) {
+            if (fn_calls[j].expr->_subexpr_idx != -1 || !same_subtree(fn_calls[i], fn_calls[j])) {
+                continue;
+            }
+            if (expr->_subexpr_idx == -1) {
+                if (cache == nullptr) {
+                    cache = pool->add(new SubexprCache());
+                }
+                expr->_subexpr_idx = cache->_entries.size();
+                cache->_entries.emplace_back();
+                cache->_entries.back().val = create_any_val(pool, expr->type());
+            }
+            fn_calls[j].expr->_subexpr_idx = expr->_subexpr_idx;
+        }
+    }
+    if (cache != nullptr) {
+        for (auto ctx : ctxs) {
+            ctx->_subexpr_cache = cache;
+        }
+    }
+    return cache;
+}
+
+} // namespace doris
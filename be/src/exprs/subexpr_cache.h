@@ -0,0 +1,82 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#ifndef DORIS_BE_SRC_QUERY_EXPRS_SUBEXPR_CACHE_H
+#define DORIS_BE_SRC_QUERY_EXPRS_SUBEXPR_CACHE_H
+
+#include <cstdint>
+#include <vector>
+
+#include "udf/udf.h"
+
+namespace doris {
+
+class ExprContext;
+class ObjectPool;
+class TExpr;
+
+// Shares the results of the function calls that occur more than once in a set of
+// ExprContexts evaluated over the same rows, e.g. the exprs of the columns of a load:
+// for 'instr(url, "?")' and 'substr(url, 1, instr(url, "?"))', instr() is only called
+// once per row. The results are cached for the current row, the owner of the ctxs calls
+// next_row() before evaluating them over another row.
+//
+// Only deterministic function calls with a non constant argument are shared, constant
+// ones are folded when they're opened, see ScalarFnCall::open(). A cache isn't thread
+// safe, the clones of the ctxs don't use it.
+class SubexprCache {
+public:
+    // Finds the function calls shared by 'ctxs', which are created from 'texprs', and
+    // sets the returned cache on 'ctxs'. Must be called before the ctxs are cloned.
+    // Returns nullptr if the ctxs share nothing.
+    static SubexprCache* create(ObjectPool* pool, const std::vector<TExpr>& texprs,
+                                const std::vector<ExprContext*>& ctxs);
+
+    // Forgets the results of the current row.
+    void next_row() { ++_row_id; }
+
+    int num_subexprs() const { return _entries.size(); }
+
+private:
+    friend class ScalarFnCall;
+
+    struct Entry {
+        int64_t row_id = -1;
+        // of the *Val type of the subexpr
+        doris_udf::AnyVal* val = nullptr;
+    };
+
+    // The result of subexpr 'idx' for the current row, nullptr if it isn't evaluated yet.
+    const doris_udf::AnyVal* get(int idx) const {
+        const Entry& entry = _entries[idx];
+        return entry.row_id == _row_id ? entry.val : nullptr;
+    }
+
+    template <class T>
+    void put(int idx, const T& val) {
+        Entry& entry = _entries[idx];
+        entry.row_id = _row_id;
+        *reinterpret_cast<T*>(entry.val) = val;
+    }
+
+    int64_t _row_id = 0;
+    std::vector<Entry> _entries;
+};
+
+} // namespace doris
+
+#endif
@@ -454,6 +454,13 @@ BigIntVal TimestampFunctions::timestamp_diff(FunctionContext* ctx, const DateTim
 
 void TimestampFunctions::format_prepare(doris_udf::FunctionContext* context,
                                         doris_udf::FunctionContext::FunctionStateScope scope) {
+    if (scope == FunctionContext::THREAD_LOCAL) {
+        // the format is constant
+        if (context->get_function_state(FunctionContext::FRAGMENT_LOCAL) != nullptr) {
+            context->set_function_state(scope, new FormatCache());
+        }
+        return;
+    }
     if (scope != FunctionContext::FRAGMENT_LOCAL || context->get_num_args() < 2 ||
         context->get_arg_type(1)->type != doris_udf::FunctionContext::Type::TYPE_VARCHAR ||
         !context->is_arg_constant(1)) {
@@ -483,6 +490,10 @@ void TimestampFunctions::format_prepare(doris_udf::FunctionContext* context,
 
 void TimestampFunctions::format_close(doris_udf::FunctionContext* context,
                                       doris_udf::FunctionContext::FunctionStateScope scope) {
+    if (scope == FunctionContext::THREAD_LOCAL) {
+        delete reinterpret_cast<FormatCache*>(context->get_function_state(scope));
+        return;
+    }
     if (scope != FunctionContext::FRAGMENT_LOCAL) {
         return;
     }
@@ -634,10 +645,22 @@ StringVal TimestampFunctions::date_format(FunctionContext* ctx, const DateTimeVa
         return StringVal::null();
     }
 
+    FormatCache* cache =
+            reinterpret_cast<FormatCache*>(ctx->get_function_state(FunctionContext::THREAD_LOCAL));
+    if (cache != nullptr && cache->is_set && cache->packed_time == ts_val.packed_time &&
+        cache->type == ts_val.type) {
+        return AnyValUtil::from_string_temp(ctx, cache->buf);
+    }
     char buf[128];
     if (!ts_value.to_format_string((const char*)fc->fmt.ptr, fc->fmt.len, buf)) {
         return StringVal::null();
     }
+    if (cache != nullptr) {
+        cache->is_set = true;
+        cache->packed_time = ts_val.packed_time;
+        cache->type = ts_val.type;
+        memcpy(cache->buf, buf, sizeof(buf));
+    }
     return AnyValUtil::from_string_temp(ctx, buf);
 }
 
@@ -42,6 +42,16 @@ struct FormatCtx {
     StringVal fmt;
 };
 
+// The last value formatted by date_format() with a constant format in a thread, which is
+// reused for the following rows of the same value, e.g. the rows of an hour formatted
+// with '%Y-%m-%d %H:00'.
+struct FormatCache {
+    bool is_set = false;
+    int64_t packed_time = 0;
+    int type = 0;
+    char buf[128];
+};
+
 // The context used for convert tz
 struct ConvertTzCtx {
     // false means the format is invalid, and the function always return null
@@ -52,6 +52,9 @@ public:
     virtual bool contains(const GeoShape* rhs) const { return false; }
     virtual std::string to_string() const { return ""; };
 
+    // The region contains() tests points against, nullptr if there isn't one.
+    virtual const S2Region* region() const { return nullptr; }
+
 protected:
     virtual void encode(std::string* buf) = 0;
     virtual bool decode(const void* data, size_t size) = 0;
@@ -112,6 +115,7 @@ public:
 
     GeoShapeType type() const override { return GEO_SHAPE_POLYGON; }
     const S2Polygon* polygon() const { return _polygon.get(); }
+    const S2Region* region() const override { return _polygon.get(); }
 
     bool contains(const GeoShape* rhs) const override;
     std::string as_wkt() const override;
@@ -135,6 +139,7 @@ public:
 
     bool contains(const GeoShape* rhs) const override;
     std::string as_wkt() const override;
+    const S2Region* region() const override { return _cap.get(); }
 
 protected:
     void encode(std::string* buf) override;
@@ -24,29 +24,65 @@
 
 #include <string>
 
+#include "common/config.h"
 #include "http/http_channel.h"
 #include "http/http_headers.h"
 #include "http/http_request.h"
 #include "http/http_response.h"
 #include "runtime/exec_env.h"
 #include "util/metrics.h"
+#include "util/time.h"
 
 namespace doris {
 
 void MetricsAction::handle(HttpRequest* req) {
-    const std::string& type = req->param("type");
-    const std::string& with_tablet = req->param("with_tablet");
-    std::string str;
-    if (type == "core") {
-        str = _metric_registry->to_core_string();
-    } else if (type == "json") {
-        str = _metric_registry->to_json(with_tablet == "true");
+    // other types are rendered as prometheus
+    std::string type = req->param("type");
+    if (type != "core" && type != "json") {
+        type = "prometheus";
+    }
+    bool with_tablet = req->param("with_tablet") == "true";
+    std::shared_ptr<const std::string> str;
+    if (config::metrics_snapshot_interval_ms > 0) {
+        str = _get_snapshot(type, with_tablet);
     } else {
-        str = _metric_registry->to_prometheus(with_tablet == "true");
+        str = std::make_shared<const std::string>(_render(type, with_tablet));
     }
 
     req->add_output_header(HttpHeaders::CONTENT_TYPE, "text/plain; version=0.0.4");
-    HttpChannel::send_reply(req, str);
+    HttpChannel::send_reply(req, *str);
+}
+
+std::shared_ptr<const std::string> MetricsAction::_get_snapshot(const std::string& type,
+                                                                bool with_tablet) {
+    std::string key = type + (with_tablet ? ":true" : ":false");
+    {
+        std::lock_guard<std::mutex> l(_snapshots_lock);
+        Snapshot& snapshot = _snapshots[key];
+        if (snapshot.content != nullptr &&
+            (snapshot.rendering ||
+             MonotonicMillis() - snapshot.render_ms < config::metrics_snapshot_interval_ms)) {
+            return snapshot.content;
+        }
+        snapshot.rendering = true;
+    }
+    // render without the lock, the others are served by the stale snapshot meanwhile
+    auto content = std::make_shared<const std::string>(_render(type, with_tablet));
+    std::lock_guard<std::mutex> l(_snapshots_lock);
+    Snapshot& snapshot = _snapshots[key];
+    snapshot.render_ms = MonotonicMillis();
+    snapshot.rendering = false;
+    snapshot.content = content;
+    return content;
+}
+
+std::string MetricsAction::_render(const std::string& type, bool with_tablet) {
+    if (type == "core") {
+        return _metric_registry->to_core_string();
+    } else if (type == "json") {
+        return _metric_registry->to_json(with_tablet);
+    }
+    return _metric_registry->to_prometheus(with_tablet);
 }
 
 } // namespace doris
@@ -17,6 +17,11 @@
 
 #pragma once
 
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
 #include "http/http_handler.h"
 
 namespace doris {
@@ -34,7 +39,24 @@ public:
     void handle(HttpRequest* req) override;
 
 private:
+    // The last rendering of a form of the output
+    struct Snapshot {
+        int64_t render_ms = 0;
+        bool rendering = false;
+        std::shared_ptr<const std::string> content;
+    };
+
+    // Return the snapshot of the output if it's fresh, or render a new one. A stale
+    // snapshot is returned if it's being rendered by another request.
+    std::shared_ptr<const std::string> _get_snapshot(const std::string& type, bool with_tablet);
+
+    std::string _render(const std::string& type, bool with_tablet);
+
     MetricRegistry* _metric_registry;
+
+    std::mutex _snapshots_lock;
+    // "<type>:<with_tablet>" -> snapshot
+    std::map<std::string, Snapshot> _snapshots;
 };
 
 } // namespace doris
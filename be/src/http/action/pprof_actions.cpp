@@ -23,8 +23,10 @@
 
 #include <fstream>
 #include <iostream>
+#include <map>
 #include <mutex>
 #include <sstream>
+#include <unordered_map>
 
 #include "agent/utils.h"
 #include "common/config.h"
@@ -37,8 +39,12 @@
 #include "http/http_response.h"
 #include "runtime/exec_env.h"
 #include "util/bfd_parser.h"
+#include "util/continuous_cpu_profiler.h"
 #include "util/file_utils.h"
 #include "util/pprof_utils.h"
+#include "util/symbols_util.h"
+#include "util/time.h"
+#include "util/uid_util.h"
 
 namespace doris {
 
@@ -194,6 +200,119 @@ void ProfileAction::handle(HttpRequest* req) {
 #endif
 }
 
+// Returns the samples of the continuous cpu profiler as folded stacks, one
+// "role;outermost frame;...;innermost frame count" per line, or a flamegraph of them.
+// Params: start and end in unix seconds (the last minute by default), query_id, role
+// (fragment, scanner, compaction, flush or other), and type=flamegraph.
+class ContinuousProfileAction : public HttpHandler {
+public:
+    ContinuousProfileAction(BfdParser* parser) : _parser(parser) {}
+    virtual ~ContinuousProfileAction() {}
+
+    virtual void handle(HttpRequest* req) override;
+
+private:
+    // Returns the function name of 'address', or the address if it's not found
+    std::string _symbol(void* address);
+
+    BfdParser* _parser;
+    // guarded by kPprofActionMutex
+    std::unordered_map<void*, std::string> _symbols;
+};
+
+void ContinuousProfileAction::handle(HttpRequest* req) {
+#if defined(ADDRESS_SANITIZER) || defined(LEAK_SANITIZER) || defined(THREAD_SANITIZER)
+    std::string str = "CPU profiling is not available with address sanitizer builds.";
+    HttpChannel::send_reply(req, str);
+#else
+    ContinuousCpuProfiler* profiler = ContinuousCpuProfiler::instance();
+    if (!profiler->started()) {
+        HttpChannel::send_reply(req, "Continuous cpu profiler is not started, see "
+                                     "continuous_cpu_profiler_interval_ms in be.conf");
+        return;
+    }
+    int64_t end_ms = UnixMillis();
+    const std::string& end_str = req->param("end");
+    if (!end_str.empty()) {
+        end_ms = std::atol(end_str.c_str()) * 1000;
+    }
+    int64_t start_ms = end_ms - 60 * 1000;
+    const std::string& start_str = req->param("start");
+    if (!start_str.empty()) {
+        start_ms = std::atol(start_str.c_str()) * 1000;
+    }
+    TUniqueId query_id;
+    const std::string& query_id_str = req->param("query_id");
+    if (!query_id_str.empty() && !parse_id(query_id_str, &query_id)) {
+        HttpChannel::send_reply(req, HttpStatus::BAD_REQUEST, "invalid query_id " + query_id_str);
+        return;
+    }
+    std::vector<ContinuousCpuProfiler::Sample> samples;
+    profiler->get_samples(start_ms, end_ms, query_id_str.empty() ? nullptr : &query_id,
+                          req->param("role"), &samples);
+
+    std::lock_guard<std::mutex> lock(kPprofActionMutex);
+    std::map<std::string, int64_t> folded_stacks;
+    for (const auto& sample : samples) {
+        std::string stack = sample.tag.role;
+        for (int i = sample.depth - 1; i >= 0; --i) {
+            stack.push_back(';');
+            // the return addresses are after the calls, except the innermost one
+            void* address = (char*)sample.frames[i] - (i > 0 ? 1 : 0);
+            stack.append(_symbol(address));
+        }
+        ++folded_stacks[stack];
+    }
+    std::stringstream folded;
+    for (const auto& it : folded_stacks) {
+        folded << it.first << " " << it.second << "\n";
+    }
+
+    if (req->param("type") != "flamegraph") {
+        HttpChannel::send_reply(req, folded.str());
+        return;
+    }
+    std::stringstream folded_file;
+    folded_file << config::pprof_profile_dir << "/continuous_cpu_profile." << getpid() << "."
+                << rand();
+    {
+        std::ofstream out(folded_file.str());
+        out << folded.str();
+    }
+    std::string svg_content;
+    Status st = PprofUtils::generate_flamegraph_from_folded(
+            folded_file.str(), std::string(std::getenv("DORIS_HOME")) + "/tools/FlameGraph/",
+            &svg_content);
+    FileUtils::remove(folded_file.str());
+    if (!st.ok()) {
+        HttpChannel::send_reply(req, st.to_string());
+    } else {
+        HttpChannel::send_reply(req, svg_content);
+    }
+#endif
+}
+
+std::string ContinuousProfileAction::_symbol(void* address) {
+    auto it = _symbols.find(address);
+    if (it != _symbols.end()) {
+        return it->second;
+    }
+    std::stringstream hex;
+    hex << address;
+    std::string hex_str = hex.str();
+    std::string file_name;
+    std::string func_name;
+    unsigned int lineno = 0;
+    const char* end = nullptr;
+    std::string symbol = hex_str;
+    if (_parser->decode_address(hex_str.c_str(), &end, &file_name, &func_name, &lineno) == 0 &&
+        !func_name.empty()) {
+        symbol = SymbolsUtil::demangle_no_args(func_name);
+    }
+    _symbols.emplace(address, symbol);
+    return symbol;
+}
+
 class PmuProfileAction : public HttpHandler {
 public:
     PmuProfileAction() {}
@@ -289,6 +408,8 @@ Status PprofActions::setup(ExecEnv* exec_env, EvHttpServer* http_server) {
     http_server->register_handler(HttpMethod::GET, "/pprof/heap", new HeapAction());
     http_server->register_handler(HttpMethod::GET, "/pprof/growth", new GrowthAction());
     http_server->register_handler(HttpMethod::GET, "/pprof/profile", new ProfileAction());
+    http_server->register_handler(HttpMethod::GET, "/pprof/continuous",
+                                  new ContinuousProfileAction(exec_env->bfd_parser()));
     http_server->register_handler(HttpMethod::GET, "/pprof/pmuprofile", new PmuProfileAction());
     http_server->register_handler(HttpMethod::GET, "/pprof/contention", new ContentionAction());
     http_server->register_handler(HttpMethod::GET, "/pprof/cmdline", new CmdlineAction());
@@ -44,6 +44,7 @@
 #include "runtime/fragment_mgr.h"
 #include "runtime/load_path_mgr.h"
 #include "runtime/plan_fragment_executor.h"
+#include "runtime/stream_load/group_commit_mgr.h"
 #include "runtime/stream_load/load_stream_mgr.h"
 #include "runtime/stream_load/stream_load_context.h"
 #include "runtime/stream_load/stream_load_executor.h"
@@ -143,6 +144,10 @@ Status StreamLoadAction::_handle(StreamLoadContext* ctx) {
                      << ", receive_bytes=" << ctx->receive_bytes << ", id=" << ctx->id;
         return Status::InternalError("receive body don't equal with body bytes");
     }
+    if (ctx->group_commit) {
+        RETURN_IF_ERROR(ctx->body_sink->finish());
+        return _exec_env->group_commit_mgr()->commit(ctx);
+    }
     if (!ctx->use_streaming) {
         // if we use non-streaming, we need to close file first,
         // then execute_plan_fragment here
@@ -258,6 +263,13 @@ Status StreamLoadAction::_on_header(HttpRequest* http_req, StreamLoadContext* ct
         }
     }
 
+    if (boost::iequals(http_req->header(HTTP_GROUP_COMMIT), "true")) {
+        // the transaction is begun for the group of the load
+        RETURN_IF_ERROR(_check_group_commit(http_req, ctx));
+        ctx->group_commit = true;
+        return _process_put(http_req, ctx);
+    }
+
     // begin transaction
     int64_t begin_txn_start_time = MonotonicNanos();
     RETURN_IF_ERROR(_exec_env->stream_load_executor()->begin_txn(ctx));
@@ -278,7 +290,8 @@ void StreamLoadAction::on_chunk_data(HttpRequest* req) {
 
     int64_t start_read_data_time = MonotonicNanos();
     while (evbuffer_get_length(evbuf) > 0) {
-        auto bb = ByteBuffer::allocate(4096);
+        // the pipe keeps the buffer as it is, the line reader reads the lines out of it
+        auto bb = ByteBuffer::allocate(evbuffer_get_length(evbuf));
         auto remove_bytes = evbuffer_remove(evbuf, bb->ptr, bb->capacity);
         bb->pos = remove_bytes;
         bb->flip();
@@ -321,7 +334,10 @@ Status StreamLoadAction::_process_put(HttpRequest* http_req, StreamLoadContext*
     request.formatType = ctx->format;
     request.__set_loadId(ctx->id.to_thrift());
     if (ctx->use_streaming) {
-        auto pipe = std::make_shared<StreamLoadPipe>(1024 * 1024 /* max_buffered_bytes */,
+        // the body of a group commit load is kept in its pipe until its group is loaded
+        size_t max_buffered_bytes =
+                ctx->group_commit ? ctx->body_bytes : config::stream_load_pipe_buffer_bytes;
+        auto pipe = std::make_shared<StreamLoadPipe>(max_buffered_bytes,
                                                      64 * 1024 /* min_chunk_size */,
                                                      ctx->body_bytes /* total_length */);
         RETURN_IF_ERROR(_exec_env->load_stream_mgr()->put(ctx->id, pipe));
@@ -403,6 +419,9 @@ Status StreamLoadAction::_process_put(HttpRequest* http_req, StreamLoadContext*
         request.__set_sequence_col(
                 http_req->header(HTTP_FUNCTION_COLUMN + "." + HTTP_SEQUENCE_COL));
     }
+    if (boost::iequals(http_req->header(HTTP_PARTIAL_COLUMNS), "true")) {
+        request.__set_partial_columns(true);
+    }
 
     if (ctx->timeout_second != -1) {
         request.__set_timeout(ctx->timeout_second);
@@ -431,6 +450,11 @@ Status StreamLoadAction::_process_put(HttpRequest* http_req, StreamLoadContext*
     if (!http_req->header(HTTP_DELETE_CONDITION).empty()) {
         request.__set_delete_condition(http_req->header(HTTP_DELETE_CONDITION));
     }
+    if (ctx->group_commit) {
+        // planned with the other loads of its group once its body is received
+        ctx->group_commit_request = request;
+        return Status::OK();
+    }
     // plan this load
     TNetworkAddress master_addr = _exec_env->master_info()->network_address;
 #ifndef BE_TEST
@@ -464,6 +488,31 @@ Status StreamLoadAction::_process_put(HttpRequest* http_req, StreamLoadContext*
     return _exec_env->stream_load_executor()->execute_plan_fragment(ctx);
 }
 
+Status StreamLoadAction::_check_group_commit(HttpRequest* http_req, StreamLoadContext* ctx) {
+    if (ctx->format != TFileFormatType::FORMAT_CSV_PLAIN) {
+        return Status::InvalidArgument("group commit only supports csv format");
+    }
+    if (http_req->header(HttpHeaders::CONTENT_LENGTH).empty()) {
+        return Status::InvalidArgument("group commit requires the content length");
+    }
+    if (ctx->body_bytes > config::group_commit_max_bytes) {
+        std::stringstream ss;
+        ss << "body exceed max size of group commit: " << config::group_commit_max_bytes
+           << ", data: " << ctx->body_bytes;
+        return Status::InvalidArgument(ss.str());
+    }
+    // the loads of a group are loaded with one plan and one filter ratio, so the rows of
+    // each load are known only if all of them are loaded
+    for (const std::string& header :
+         {HTTP_WHERE, HTTP_PARTITIONS, HTTP_TEMP_PARTITIONS, HTTP_NEGATIVE, HTTP_MAX_FILTER_RATIO,
+          HTTP_MERGE_TYPE, HTTP_DELETE_CONDITION, HTTP_FUNCTION_COLUMN + "." + HTTP_SEQUENCE_COL}) {
+        if (!http_req->header(header).empty()) {
+            return Status::InvalidArgument("group commit doesn't support " + header);
+        }
+    }
+    return Status::OK();
+}
+
 Status StreamLoadAction::_data_saved_path(HttpRequest* req, std::string* file_path) {
     std::string prefix;
     RETURN_IF_ERROR(_exec_env->load_path_mgr()->allocate_dir(req->param(HTTP_DB_KEY), "", &prefix));
@@ -39,6 +39,9 @@ public:
 
     bool request_will_be_read_progressively() override { return true; }
 
+    // handle() waits for the load to finish and publish
+    bool handle_in_pool() override { return true; }
+
     int on_header(HttpRequest* req) override;
 
     void on_chunk_data(HttpRequest* req) override;
@@ -50,6 +53,8 @@ private:
     Status _data_saved_path(HttpRequest* req, std::string* file_path);
     Status _execute_plan_fragment(StreamLoadContext* ctx);
     Status _process_put(HttpRequest* http_req, StreamLoadContext* ctx);
+    // Checks that the load can be committed with other loads, see GroupCommitMgr.
+    Status _check_group_commit(HttpRequest* http_req, StreamLoadContext* ctx);
 
 private:
     ExecEnv* _exec_env;
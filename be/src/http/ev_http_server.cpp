@@ -25,9 +25,11 @@
 #include <event2/keyvalq_struct.h>
 #include <event2/thread.h>
 
+#include <functional>
 #include <memory>
 #include <sstream>
 
+#include "common/config.h"
 #include "common/logging.h"
 #include "http/http_channel.h"
 #include "http/http_handler.h"
@@ -55,9 +57,18 @@ static void on_request(struct evhttp_request* ev_req, void* arg) {
         // In this case, request's on_header return -1
         return;
     }
+    EvHttpServer* server = (EvHttpServer*)arg;
+    if (request->handler()->handle_in_pool() && server->handle_in_pool(request)) {
+        return;
+    }
     request->handler()->handle(request);
 }
 
+static void on_deferred_reply(evutil_socket_t fd, short events, void* arg) {
+    std::unique_ptr<std::function<void()>> reply((std::function<void()>*)arg);
+    (*reply)();
+}
+
 static int on_header(struct evhttp_request* ev_req, void* param) {
     EvHttpServer* server = (EvHttpServer*)ev_req->on_complete_cb_arg;
     return server->on_header(ev_req);
@@ -98,6 +109,13 @@ void EvHttpServer::start() {
             .set_min_threads(_num_workers)
             .set_max_threads(_num_workers)
             .build(&_workers);
+    if (config::webserver_handler_thread_num > 0) {
+        ThreadPoolBuilder("EvHttpHandler")
+                .set_min_threads(0)
+                .set_max_threads(config::webserver_handler_thread_num)
+                .set_max_queue_size(config::webserver_handler_queue_size)
+                .build(&_handler_pool);
+    }
 
     evthread_use_pthreads();
     event_bases.resize(_num_workers);
@@ -127,6 +145,10 @@ void EvHttpServer::start() {
 }
 
 void EvHttpServer::stop() {
+    // the handlers running in the pool post their replies to the event bases
+    if (_handler_pool != nullptr) {
+        _handler_pool->shutdown();
+    }
     for (int i = 0; i < _num_workers; ++i) {
         LOG(WARNING) << "event_base_loopexit ret: "
                      << event_base_loopexit(event_bases[i].get(), nullptr);
@@ -137,6 +159,39 @@ void EvHttpServer::stop() {
 
 void EvHttpServer::join() {}
 
+bool EvHttpServer::handle_in_pool(HttpRequest* request) {
+    if (_handler_pool == nullptr) {
+        return false;
+    }
+    struct evhttp_request* ev_req = request->get_evhttp_request();
+    struct event_base* base = evhttp_connection_get_base(evhttp_request_get_connection(ev_req));
+    // libevent keeps the request until its reply is sent, even if the connection is closed
+    // meanwhile, so it is valid in the pool. But the request, including its output headers,
+    // must not be touched by the event loop thread once handed over, and its reply is sent by
+    // the event loop thread after the handler returns.
+    request->set_handled_in_pool(true);
+    auto st = _handler_pool->submit_func([request, base]() {
+        request->handler()->handle(request);
+        auto reply = new std::function<void()>(request->release_deferred_reply());
+        if (!*reply) {
+            delete reply;
+            return;
+        }
+        if (event_base_once(base, -1, EV_TIMEOUT, on_deferred_reply, reply, nullptr) != 0) {
+            LOG(WARNING) << "failed to schedule the reply of http request, uri="
+                         << request->uri();
+            delete reply;
+        }
+    });
+    if (!st.ok()) {
+        // the pool is full, handle it in the event loop thread, which slows down the requests
+        // coming through it
+        request->set_handled_in_pool(false);
+        return false;
+    }
+    return true;
+}
+
 Status EvHttpServer::_bind() {
     butil::EndPoint point;
     auto res = butil::hostname2endpoint(_host.c_str(), _port, &point);
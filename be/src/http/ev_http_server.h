@@ -49,6 +49,10 @@ public:
     // callback
     int on_header(struct evhttp_request* ev_req);
 
+    // Run the handler of the request in the handler pool. Return false if the pool is
+    // disabled or full, then the caller handles it in the event loop thread.
+    bool handle_in_pool(HttpRequest* request);
+
     // get real port
     int get_real_port() { return _real_port; }
 
@@ -67,6 +71,8 @@ private:
     int _server_fd = -1;
     std::unique_ptr<ThreadPool> _workers;
     std::vector<std::shared_ptr<event_base>> event_bases;
+    // runs the handlers which block for long, see HttpHandler::handle_in_pool()
+    std::unique_ptr<ThreadPool> _handler_pool;
 
     pthread_rwlock_t _rw_lock;
 
@@ -43,13 +43,38 @@ void HttpChannel::send_basic_challenge(HttpRequest* req, const std::string& real
     send_reply(req, HttpStatus::UNAUTHORIZED, s_prompt_str);
 }
 
+static void send_reply_now(evhttp_request* ev_req, HttpStatus status, evbuffer* evb) {
+    evhttp_send_reply(ev_req, status, default_reason(status).c_str(), evb);
+    if (evb != nullptr) {
+        evbuffer_free(evb);
+    }
+}
+
+// Send the reply, or defer it to the event loop thread if the request is handled in the handler
+// pool of the server. Takes the ownership of 'evb'.
+static void send_or_defer_reply(HttpRequest* request, HttpStatus status, evbuffer* evb) {
+    auto ev_req = request->get_evhttp_request();
+    if (request->handled_in_pool()) {
+        request->set_deferred_reply(
+                [ev_req, status, evb]() { send_reply_now(ev_req, status, evb); });
+        return;
+    }
+    send_reply_now(ev_req, status, evb);
+}
+
 void HttpChannel::send_error(HttpRequest* request, HttpStatus status) {
-    evhttp_send_error(request->get_evhttp_request(), status, default_reason(status).c_str());
+    auto ev_req = request->get_evhttp_request();
+    if (request->handled_in_pool()) {
+        request->set_deferred_reply([ev_req, status]() {
+            evhttp_send_error(ev_req, status, default_reason(status).c_str());
+        });
+        return;
+    }
+    evhttp_send_error(ev_req, status, default_reason(status).c_str());
 }
 
 void HttpChannel::send_reply(HttpRequest* request, HttpStatus status) {
-    evhttp_send_reply(request->get_evhttp_request(), status, default_reason(status).c_str(),
-                      nullptr);
+    send_or_defer_reply(request, status, nullptr);
 }
 
 void HttpChannel::send_reply(HttpRequest* request, HttpStatus status, const std::string& content) {
@@ -62,16 +87,14 @@ void HttpChannel::send_reply(HttpRequest* request, HttpStatus status, const std:
     } else {
         evbuffer_add(evb, content.c_str(), content.size());
     }
-    evhttp_send_reply(request->get_evhttp_request(), status, default_reason(status).c_str(), evb);
-    evbuffer_free(evb);
+    send_or_defer_reply(request, status, evb);
 }
 
-void HttpChannel::send_file(HttpRequest* request, int fd, size_t off, size_t size) {
+void HttpChannel::send_file(HttpRequest* request, int fd, size_t off, size_t size,
+                            HttpStatus status) {
     auto evb = evbuffer_new();
     evbuffer_add_file(evb, fd, off, size);
-    evhttp_send_reply(request->get_evhttp_request(), HttpStatus::OK,
-                      default_reason(HttpStatus::OK).c_str(), evb);
-    evbuffer_free(evb);
+    send_or_defer_reply(request, status, evb);
 }
 
 bool HttpChannel::compress_content(const std::string& accept_encoding, const std::string& input,
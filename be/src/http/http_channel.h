@@ -45,7 +45,9 @@ public:
 
     static void send_reply(HttpRequest* request, HttpStatus status, const std::string& content);
 
-    static void send_file(HttpRequest* request, int fd, size_t off, size_t size);
+    // The file is sent with evbuffer_add_file, which uses sendfile(2) when available
+    static void send_file(HttpRequest* request, int fd, size_t off, size_t size,
+                          HttpStatus status = HttpStatus::OK);
 
     static bool compress_content(const std::string& accept_encoding, const std::string& input,
                                  std::string* output);
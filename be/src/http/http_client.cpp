@@ -17,6 +17,9 @@
 
 #include "http/http_client.h"
 
+#include <fcntl.h>
+#include <unistd.h>
+
 #include "common/config.h"
 
 namespace doris {
@@ -172,11 +175,7 @@ Status HttpClient::download(const std::string& local_path) {
     // set method to GET
     set_method(GET);
 
-    // TODO(zc) Move this download speed limit outside to limit download speed
-    // at system level
-    curl_easy_setopt(_curl, CURLOPT_LOW_SPEED_LIMIT, config::download_low_speed_limit_kbps * 1024);
-    curl_easy_setopt(_curl, CURLOPT_LOW_SPEED_TIME, config::download_low_speed_time);
-    curl_easy_setopt(_curl, CURLOPT_MAX_RECV_SPEED_LARGE, config::max_download_speed_kbps * 1024);
+    _set_download_speed_limit();
 
     auto fp_closer = [](FILE* fp) { fclose(fp); };
     std::unique_ptr<FILE, decltype(fp_closer)> fp(fopen(local_path.c_str(), "w"), fp_closer);
@@ -199,6 +198,57 @@ Status HttpClient::download(const std::string& local_path) {
     return status;
 }
 
+Status HttpClient::download_range(const std::string& local_path, uint64_t offset,
+                                  uint64_t length) {
+    set_method(GET);
+    _set_download_speed_limit();
+    std::string range = std::to_string(offset) + "-" + std::to_string(offset + length - 1);
+    curl_easy_setopt(_curl, CURLOPT_RANGE, range.c_str());
+
+    int fd = open(local_path.c_str(), O_WRONLY);
+    if (fd < 0) {
+        LOG(WARNING) << "open file failed, file=" << local_path;
+        return Status::InternalError("open file failed");
+    }
+    Status status;
+    uint64_t pos = offset;
+    auto callback = [&status, fd, &pos, offset, length, &local_path](const void* data,
+                                                                   size_t size) {
+        if (pos + size > offset + length) {
+            // the server sent more than the range, it doesn't support range requests
+            status = Status::InternalError("range is not supported by server");
+            return false;
+        }
+        if (pwrite(fd, data, size, pos) != static_cast<ssize_t>(size)) {
+            LOG(WARNING) << "fail to write data to file, file=" << local_path
+                         << ", offset=" << pos << ", errno=" << errno;
+            status = Status::InternalError("fail to write data when download");
+            return false;
+        }
+        pos += size;
+        return true;
+    };
+    Status st = execute(callback);
+    curl_easy_setopt(_curl, CURLOPT_RANGE, nullptr);
+    close(fd);
+    RETURN_IF_ERROR(status);
+    RETURN_IF_ERROR(st);
+    if (pos != offset + length) {
+        LOG(WARNING) << "download range length error, file=" << local_path << ", offset=" << offset
+                     << ", length=" << length << ", downloaded=" << pos - offset;
+        return Status::InternalError("downloaded range size is not equal");
+    }
+    return Status::OK();
+}
+
+void HttpClient::_set_download_speed_limit() {
+    curl_easy_setopt(_curl, CURLOPT_LOW_SPEED_LIMIT, config::download_low_speed_limit_kbps * 1024);
+    curl_easy_setopt(_curl, CURLOPT_LOW_SPEED_TIME, config::download_low_speed_time);
+    int64_t speed_kbps = _max_download_speed_kbps > 0 ? _max_download_speed_kbps
+                                                      : config::max_download_speed_kbps;
+    curl_easy_setopt(_curl, CURLOPT_MAX_RECV_SPEED_LARGE, (curl_off_t)speed_kbps * 1024);
+}
+
 Status HttpClient::execute(std::string* response) {
     auto callback = [response](const void* data, size_t length) {
         response->append((char*)data, length);
@@ -113,6 +113,13 @@ public:
     // a file to local_path
     Status download(const std::string& local_path);
 
+    // download bytes [offset, offset + length) of the remote file into the same range
+    // of local_path, which must already exist. Fail if the server ignores the range.
+    Status download_range(const std::string& local_path, uint64_t offset, uint64_t length);
+
+    // override config::max_download_speed_kbps for downloads of this client
+    void set_max_download_speed_kbps(int64_t speed_kbps) { _max_download_speed_kbps = speed_kbps; }
+
     Status execute_post_request(const std::string& payload, std::string* response);
 
     Status execute_delete_request(const std::string& payload, std::string* response);
@@ -128,12 +135,15 @@ public:
 private:
     const char* _to_errmsg(CURLcode code);
 
+    void _set_download_speed_limit();
+
 private:
     CURL* _curl = nullptr;
     using HttpCallback = std::function<bool(const void* data, size_t length)>;
     const HttpCallback* _callback = nullptr;
     char _error_buf[CURL_ERROR_SIZE];
     curl_slist* _header_list = nullptr;
+    int64_t _max_download_speed_kbps = 0;
 };
 
 } // namespace doris
@@ -31,6 +31,11 @@ public:
 
     virtual bool request_will_be_read_progressively() { return false; }
 
+    // Return true if handle() blocks for long, e.g. waiting for a load to finish. Then it runs
+    // in the handler pool of the server, so that the event loop thread keeps serving the other
+    // connections meanwhile. Its reply is sent after it returns.
+    virtual bool handle_in_pool() { return false; }
+
     // This function will called when all headers are receipt.
     // return 0 if process successfully. otherwise return -1;
     // If return -1, on_header function should send_reply to HTTP client
@@ -21,6 +21,7 @@
 #include <glog/logging.h>
 
 #include <boost/algorithm/string.hpp>
+#include <functional>
 #include <map>
 #include <string>
 
@@ -85,6 +86,22 @@ public:
 
     const char* remote_host() const;
 
+    // Set when the handler runs in the handler pool of the server instead of the event loop
+    // thread of the connection. The reply is then deferred until the handler returns, and
+    // sent by the event loop thread, since evhttp requests are not thread safe.
+    void set_handled_in_pool(bool handled_in_pool) { _handled_in_pool = handled_in_pool; }
+    bool handled_in_pool() const { return _handled_in_pool; }
+
+    void set_deferred_reply(std::function<void()> reply) {
+        DCHECK(!_deferred_reply) << "reply more than once, uri=" << _uri;
+        _deferred_reply = std::move(reply);
+    }
+    std::function<void()> release_deferred_reply() {
+        std::function<void()> reply;
+        reply.swap(_deferred_reply);
+        return reply;
+    }
+
 private:
     HttpMethod _method;
     std::string _uri;
@@ -99,6 +116,9 @@ private:
 
     void* _handler_ctx = nullptr;
     std::string _request_body;
+
+    bool _handled_in_pool = false;
+    std::function<void()> _deferred_reply;
 };
 
 } // namespace doris
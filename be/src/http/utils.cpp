@@ -18,6 +18,7 @@
 #include "http/utils.h"
 
 #include <fcntl.h>
+#include <stdlib.h>
 #include <sys/stat.h>
 
 #include "common/logging.h"
@@ -134,13 +135,8 @@ void do_file_response(const std::string& file_path, HttpRequest* req) {
     int64_t file_size = st.st_size;
 
     // TODO(lingbin): process "IF_MODIFIED_SINCE" header
-    // TODO(lingbin): process "RANGE" header
-    const std::string& range_header = req->header(HttpHeaders::RANGE);
-    if (!range_header.empty()) {
-        // analyse range header
-    }
-
     req->add_output_header(HttpHeaders::CONTENT_TYPE, get_content_type(file_path).c_str());
+    req->add_output_header(HttpHeaders::ACCEPT_RANGES, "bytes");
 
     if (req->method() == HttpMethod::HEAD) {
         close(fd);
@@ -149,9 +145,74 @@ void do_file_response(const std::string& file_path, HttpRequest* req) {
         return;
     }
 
+    // Only a single range is supported, multiple ranges are answered with the whole file
+    const std::string& range_header = req->header(HttpHeaders::RANGE);
+    if (!range_header.empty() && file_size > 0) {
+        int64_t start = 0;
+        int64_t end = 0;
+        if (!parse_range_header(range_header, file_size, &start, &end)) {
+            close(fd);
+            req->add_output_header(HttpHeaders::CONTENT_RANGE,
+                                   ("bytes */" + std::to_string(file_size)).c_str());
+            HttpChannel::send_error(req, HttpStatus::REQUESTED_RANGE_NOT_SATISFIED);
+            return;
+        }
+        if (start != 0 || end != file_size - 1) {
+            std::string content_range = "bytes " + std::to_string(start) + "-" +
+                                        std::to_string(end) + "/" + std::to_string(file_size);
+            req->add_output_header(HttpHeaders::CONTENT_RANGE, content_range.c_str());
+            HttpChannel::send_file(req, fd, start, end - start + 1, HttpStatus::PARTIAL_CONTENT);
+            return;
+        }
+    }
+
     HttpChannel::send_file(req, fd, 0, file_size);
 }
 
+bool parse_range_header(const std::string& range_header, int64_t file_size, int64_t* start,
+                        int64_t* end) {
+    const std::string prefix = "bytes=";
+    if (range_header.compare(0, prefix.size(), prefix) != 0 ||
+        range_header.find(',') != std::string::npos) {
+        // not a byte range or multiple ranges, fall back to the whole file
+        *start = 0;
+        *end = file_size - 1;
+        return true;
+    }
+    std::string spec = range_header.substr(prefix.size());
+    auto pos = spec.find('-');
+    if (pos == std::string::npos) {
+        return false;
+    }
+    std::string first = spec.substr(0, pos);
+    std::string last = spec.substr(pos + 1);
+    char* end_ptr = nullptr;
+    if (first.empty()) {
+        // suffix range: the last N bytes
+        int64_t suffix = strtoll(last.c_str(), &end_ptr, 10);
+        if (last.empty() || *end_ptr != '\0' || suffix <= 0) {
+            return false;
+        }
+        *start = std::max<int64_t>(0, file_size - suffix);
+        *end = file_size - 1;
+        return true;
+    }
+    *start = strtoll(first.c_str(), &end_ptr, 10);
+    if (*end_ptr != '\0' || *start < 0 || *start >= file_size) {
+        return false;
+    }
+    if (last.empty()) {
+        *end = file_size - 1;
+    } else {
+        *end = strtoll(last.c_str(), &end_ptr, 10);
+        if (*end_ptr != '\0' || *end < *start) {
+            return false;
+        }
+        *end = std::min(*end, file_size - 1);
+    }
+    return true;
+}
+
 void do_dir_response(const std::string& dir_path, HttpRequest* req) {
     std::vector<std::string> files;
     Status status = FileUtils::list_files(Env::Default(), dir_path, &files);
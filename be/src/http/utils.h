@@ -37,6 +37,11 @@ bool parse_basic_auth(const HttpRequest& req, AuthInfo* auth);
 
 void do_file_response(const std::string& dir_path, HttpRequest* req);
 
+// Parse a single "bytes=" range against a file of file_size (> 0) bytes into the
+// inclusive [start, end]. Return false if the range is not satisfiable.
+bool parse_range_header(const std::string& range_header, int64_t file_size, int64_t* start,
+                        int64_t* end);
+
 void do_dir_response(const std::string& dir_path, HttpRequest* req);
 
 std::string get_content_type(const std::string& file_name);
@@ -82,6 +82,10 @@ OLAPStatus BaseCompaction::execute_compact_impl() {
 
 OLAPStatus BaseCompaction::pick_rowsets_to_compact() {
     _input_rowsets.clear();
+    if (!_tablet->cumulative_compaction_policy()->need_base_compaction(_tablet.get())) {
+        // the cumulative compaction outputs of the policy are final
+        return OLAP_ERR_BE_NO_SUITABLE_VERSION;
+    }
     _tablet->pick_candidate_rowsets_to_base_compaction(&_input_rowsets);
     if (_input_rowsets.size() <= 1) {
         return OLAP_ERR_BE_NO_SUITABLE_VERSION;
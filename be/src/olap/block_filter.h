@@ -0,0 +1,54 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "common/status.h"
+#include "olap/olap_common.h"
+
+namespace doris {
+
+class Conditions;
+class RowBlockV2;
+
+// A filter which is evaluated on a whole RowBlockV2 by the storage layer, e.g.
+// the conjuncts of a query which are not pushed down as column predicates.
+//
+// SegmentIterator evaluates it after the column predicates and reads the
+// columns referenced by neither a predicate nor a filter only for the rows
+// which pass, so a selective filter saves the decoding of those columns.
+class BlockFilter {
+public:
+    virtual ~BlockFilter() {}
+
+    // Columns read by evaluate(), they must be part of the block's schema.
+    virtual const std::vector<ColumnId>& column_ids() const = 0;
+
+    // Keep in the selection vector 'sel' of '*size' rows only the rows that
+    // pass this filter, the order of the remaining rows is preserved.
+    virtual Status evaluate(const RowBlockV2& block, uint16_t* sel, uint16_t* size) = 0;
+
+    // Conditions the rows passing this filter satisfy, used to skip pages by zone maps.
+    // SegmentIterator asks for them when it opens a segment, so a filter which tightens
+    // while the storage reads skips more pages of the later segments. nullptr if none.
+    virtual const Conditions* zone_map_conditions() { return nullptr; }
+};
+
+} // namespace doris
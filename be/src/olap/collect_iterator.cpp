@@ -29,9 +29,12 @@ CollectIterator::~CollectIterator() {}
 void CollectIterator::init(Reader* reader) {
     _reader = reader;
     // when aggregate is enabled or key_type is DUP_KEYS, we don't merge
-    // multiple data to aggregate for performance in user fetch
-    if (_reader->_reader_type == READER_QUERY &&
-        (_reader->_aggregation || _reader->_tablet->keys_type() == KeysType::DUP_KEYS)) {
+    // multiple data to aggregate for performance in user fetch. Neither do we
+    // for merge-on-write tablets, whose replaced rows are skipped by delete bitmap.
+    // Unless the rows are asked for in the order of keys.
+    if (_reader->_reader_type == READER_QUERY && !_reader->_read_orderby_key &&
+        (_reader->_aggregation || _reader->_tablet->keys_type() == KeysType::DUP_KEYS ||
+         _reader->_tablet->enable_unique_key_merge_on_write())) {
         _merge = false;
     }
 }
@@ -95,25 +98,6 @@ void CollectIterator::build_heap() {
     _inner_iter->init();
 }
 
-bool CollectIterator::LevelIteratorComparator::operator()(const LevelIterator* a,
-                                                          const LevelIterator* b) {
-    // First compare row cursor.
-    const RowCursor* first = a->current_row();
-    const RowCursor* second = b->current_row();
-    int cmp_res = compare_row(*first, *second);
-    if (cmp_res != 0) {
-        return cmp_res > 0;
-    }
-    // if row cursors equal, compare data version.
-    // read data from higher version to lower version.
-    // for UNIQUE_KEYS just read the highest version and no need agg_update.
-    // for AGG_KEYS if a version is deleted, the lower version no need to agg_update
-    if (_reverse) {
-        return a->version() < b->version();
-    }
-    return a->version() > b->version();
-}
-
 void CollectIterator::clear() {
     for (auto child : _children) {
         if (child != nullptr) {
@@ -139,8 +123,15 @@ OLAPStatus CollectIterator::next(const RowCursor** row, bool* delete_flag) {
     }
 }
 
+bool CollectIterator::partial_columns() const {
+    return _inner_iter != nullptr && _inner_iter->partial_columns();
+}
+
 CollectIterator::Level0Iterator::Level0Iterator(RowsetReaderSharedPtr rs_reader, Reader* reader)
-        : _rs_reader(rs_reader), _is_delete(rs_reader->delete_flag()), _reader(reader) {}
+        : _rs_reader(rs_reader),
+          _is_delete(rs_reader->delete_flag()),
+          _partial_columns(rs_reader->rowset()->rowset_meta()->partial_columns()),
+          _reader(reader) {}
 
 CollectIterator::Level0Iterator::~Level0Iterator() {}
 
@@ -150,6 +141,11 @@ OLAPStatus CollectIterator::Level0Iterator::init() {
         LOG(WARNING) << "failed to init row cursor, res=" << res;
         return res;
     }
+    res = _last_row_cursor.init(_reader->_tablet->tablet_schema(), _reader->_seek_columns);
+    if (res != OLAP_SUCCESS) {
+        LOG(WARNING) << "failed to init row cursor, res=" << res;
+        return res;
+    }
     RETURN_NOT_OK(_refresh_current_row());
     return OLAP_SUCCESS;
 }
@@ -183,6 +179,7 @@ OLAPStatus CollectIterator::Level0Iterator::_refresh_current_row() {
             return OLAP_SUCCESS;
         } else {
             auto res = _rs_reader->next_block(&_row_block);
+            ++_block_id;
             if (res != OLAP_SUCCESS) {
                 _current_row = nullptr;
                 return res;
@@ -204,6 +201,17 @@ OLAPStatus CollectIterator::Level0Iterator::next(const RowCursor** row, bool* de
     return res;
 }
 
+const RowCursor* CollectIterator::Level0Iterator::last_buffered_row() {
+    if (_row_block == nullptr || _row_block->limit() == 0) {
+        return nullptr;
+    }
+    if (_last_row_block_id != _block_id) {
+        _row_block->get_row(_row_block->limit() - 1, &_last_row_cursor);
+        _last_row_block_id = _block_id;
+    }
+    return &_last_row_cursor;
+}
+
 CollectIterator::Level1Iterator::Level1Iterator(
         const std::vector<CollectIterator::LevelIterator*>& children, bool merge, bool reverse)
         : _children(children), _merge(merge), _reverse(reverse) {}
@@ -258,46 +266,101 @@ int32_t CollectIterator::Level1Iterator::version() const {
     return -1;
 }
 
+bool CollectIterator::Level1Iterator::partial_columns() const {
+    return _cur_child != nullptr && _cur_child->partial_columns();
+}
+
 OLAPStatus CollectIterator::Level1Iterator::init() {
     if (_children.size() == 0) {
         return OLAP_SUCCESS;
     }
     // Only when there are multiple children that need to be merged
     if (_merge && _children.size() > 1) {
-        _heap.reset(new MergeHeap(LevelIteratorComparator(_reverse)));
-        for (auto child : _children) {
-            if (child == nullptr || child->current_row() == nullptr) {
-                continue;
-            }
-            _heap->push(child);
-            _cur_child = _heap->top();
-        }
+        _tree.reset(new LoserTree<ChildLess>(ChildLess(this)));
+        _tree->init(_children.size());
+        _start_run();
     } else {
         _merge = false;
-        _heap.reset(nullptr);
+        _tree.reset(nullptr);
         _cur_child = _children[_child_idx];
     }
     return OLAP_SUCCESS;
 }
 
+bool CollectIterator::Level1Iterator::ChildLess::operator()(int a, int b) const {
+    const RowCursor* row = _parent->_children[a]->current_row();
+    if (row == nullptr) {
+        return false;
+    }
+    return _parent->_row_before(row, _parent->_children[a]->version(), b);
+}
+
+bool CollectIterator::Level1Iterator::_row_before(const RowCursor* row, int32_t version,
+                                                  int idx) const {
+    const RowCursor* other = _children[idx]->current_row();
+    if (other == nullptr) {
+        return true;
+    }
+    int cmp_res = compare_row(*row, *other);
+    if (cmp_res != 0) {
+        return cmp_res < 0;
+    }
+    // if row cursors equal, compare data version.
+    // read data from higher version to lower version.
+    // for UNIQUE_KEYS just read the highest version and no need agg_update.
+    // for AGG_KEYS if a version is deleted, the lower version no need to agg_update
+    if (_reverse) {
+        return version > _children[idx]->version();
+    }
+    return version < _children[idx]->version();
+}
+
+void CollectIterator::Level1Iterator::_start_run() {
+    int winner = _tree->winner();
+    _cur_child = _children[winner]->current_row() != nullptr ? _children[winner] : nullptr;
+    _runner_up = _tree->runner_up();
+    if (_runner_up >= 0 && _children[_runner_up]->current_row() == nullptr) {
+        _runner_up = -1;
+    }
+    _checked_buffer_id = UINT64_MAX;
+    _buffer_wins = false;
+}
+
+bool CollectIterator::Level1Iterator::_cur_child_still_wins() {
+    if (_runner_up < 0) {
+        return true;
+    }
+    uint64_t buffer_id = _cur_child->buffer_id();
+    if (buffer_id != _checked_buffer_id) {
+        // Rows of a buffer are ordered and of the same version, so if its last row is
+        // before the runner-up, so are all its rows.
+        _checked_buffer_id = buffer_id;
+        const RowCursor* last_row = _cur_child->last_buffered_row();
+        _buffer_wins = last_row != nullptr &&
+                       _row_before(last_row, _cur_child->version(), _runner_up);
+    }
+    if (_buffer_wins) {
+        return true;
+    }
+    return _row_before(_cur_child->current_row(), _cur_child->version(), _runner_up);
+}
+
 inline OLAPStatus CollectIterator::Level1Iterator::_merge_next(const RowCursor** row,
                                                                bool* delete_flag) {
-    _heap->pop();
     auto res = _cur_child->next(row, delete_flag);
     if (res == OLAP_SUCCESS) {
-        _heap->push(_cur_child);
-        _cur_child = _heap->top();
-    } else if (res == OLAP_ERR_DATA_EOF) {
-        if (!_heap->empty()) {
-            _cur_child = _heap->top();
-        } else {
-            _cur_child = nullptr;
-            return OLAP_ERR_DATA_EOF;
+        if (_cur_child_still_wins()) {
+            return OLAP_SUCCESS;
         }
-    } else {
+    } else if (res != OLAP_ERR_DATA_EOF) {
         LOG(WARNING) << "failed to get next from child, res=" << res;
         return res;
     }
+    _tree->replay();
+    _start_run();
+    if (_cur_child == nullptr) {
+        return OLAP_ERR_DATA_EOF;
+    }
     *row = _cur_child->current_row(delete_flag);
     return OLAP_SUCCESS;
 }
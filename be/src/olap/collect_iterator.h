@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include "olap/loser_tree.h"
 #include "olap/olap_define.h"
 #include "olap/row_cursor.h"
 #include "olap/rowset/rowset_reader.h"
@@ -47,6 +48,10 @@ public:
     //      Others when error happens
     OLAPStatus next(const RowCursor** row, bool* delete_flag);
 
+    // Whether the current row is from a rowset of partial columns, whose null values
+    // are to be filled from the lower versions.
+    bool partial_columns() const;
+
     // Clear the MergeSet element and reset state.
     void clear();
 
@@ -54,7 +59,7 @@ private:
     // This interface is the actual implementation of the new version of iterator.
     // It currently contains two implementations, one is Level0Iterator,
     // which only reads data from the rowset reader, and the other is Level1Iterator,
-    // which can read merged data from multiple LevelIterators through MergeHeap.
+    // which can read merged data from multiple LevelIterators through a loser tree.
     // By using Level1Iterator, some rowset readers can be merged in advance and 
     // then merged with other rowset readers.
     class LevelIterator {
@@ -67,24 +72,19 @@ private:
 
         virtual int32_t version() const = 0;
 
+        virtual bool partial_columns() const = 0;
+
         virtual OLAPStatus next(const RowCursor** row, bool* delete_flag) = 0;
-        virtual ~LevelIterator() = 0;
-    };
-    // Compare row cursors between multiple merge elements,
-    // if row cursors equal, compare data version.
-    class LevelIteratorComparator {
-    public:
-        LevelIteratorComparator(const bool reverse = false) : _reverse(reverse) {}
-        bool operator()(const LevelIterator* a, const LevelIterator* b);
 
-    private:
-        bool _reverse;
-        OlapReaderStatistics* _stats;
-    };
+        // The last row of the data buffered by this iterator: the rows from the current
+        // one to it are returned without reading more data. nullptr if unknown.
+        virtual const RowCursor* last_buffered_row() { return nullptr; }
 
-    typedef std::priority_queue<LevelIterator*, std::vector<LevelIterator*>,
-                                LevelIteratorComparator>
-            MergeHeap;
+        // Changes each time this iterator buffers new data.
+        virtual uint64_t buffer_id() const { return 0; }
+
+        virtual ~LevelIterator() = 0;
+    };
     // Iterate from rowset reader. This Iterator usually like a leaf node
     class Level0Iterator : public LevelIterator {
     public:
@@ -98,8 +98,14 @@ private:
 
         int32_t version() const;
 
+        bool partial_columns() const { return _partial_columns; }
+
         OLAPStatus next(const RowCursor** row, bool* delete_flag);
 
+        const RowCursor* last_buffered_row();
+
+        uint64_t buffer_id() const { return _block_id; }
+
         ~Level0Iterator();
 
     private:
@@ -109,10 +115,16 @@ private:
         RowsetReaderSharedPtr _rs_reader;
         const RowCursor* _current_row = nullptr;
         bool _is_delete = false;
+        bool _partial_columns = false;
         Reader* _reader = nullptr;
         // point to rows inside `_row_block`
         RowCursor _row_cursor;
         RowBlock* _row_block = nullptr;
+        // increased for each block read
+        uint64_t _block_id = 0;
+        // point to the last row of `_row_block`, valid if `_last_row_block_id == _block_id`
+        RowCursor _last_row_cursor;
+        uint64_t _last_row_block_id = UINT64_MAX;
     };
     // Iterate from LevelIterators (maybe Level0Iterators or Level1Iterator or mixed)
     class Level1Iterator : public LevelIterator {
@@ -127,29 +139,58 @@ private:
 
         int32_t version() const;
 
+        bool partial_columns() const;
+
         OLAPStatus next(const RowCursor** row, bool* delete_flag);
 
         ~Level1Iterator();
 
     private:
+        // Whether the current row of child a is before the one of child b: rows are
+        // ordered by keys, then by version, an exhausted child is after all others.
+        class ChildLess {
+        public:
+            explicit ChildLess(const Level1Iterator* parent) : _parent(parent) {}
+            bool operator()(int a, int b) const;
+
+        private:
+            const Level1Iterator* _parent;
+        };
+
         inline OLAPStatus _merge_next(const RowCursor** row, bool* delete_flag);
         inline OLAPStatus _normal_next(const RowCursor** row, bool* delete_flag);
 
+        // whether `row` of version `version` is before the current row of child `idx`
+        bool _row_before(const RowCursor* row, int32_t version, int idx) const;
+        // whether the current child still has the first row after it advanced
+        bool _cur_child_still_wins();
+        void _start_run();
+
         // each Level0Iterator corresponds to a rowset reader
         const std::vector<LevelIterator*> _children;
         // point to the Level0Iterator containing the next output row.
         // null when CollectIterator hasn't been initialized or reaches EOF.
         LevelIterator* _cur_child = nullptr;
 
-        // when `_merge == true`, rowset reader returns ordered rows and CollectIterator uses a priority queue to merge
+        // when `_merge == true`, rowset reader returns ordered rows and CollectIterator uses a loser tree to merge
         // sort them. The output of CollectIterator is also ordered.
         // When `_merge == false`, rowset reader returns *partial* ordered rows. CollectIterator simply returns all rows
         // from the first rowset, the second rowset, .., the last rowset. The output of CollectorIterator is also
         // *partially* ordered.
         bool _merge = true;
         bool _reverse = false;
-        // used when `_merge == true`
-        std::unique_ptr<MergeHeap> _heap;
+        // used when `_merge == true`, leaves are the indexes in `_children`
+        std::unique_ptr<LoserTree<ChildLess>> _tree;
+        // The winner keeps returning rows without replaying the tree as long as they
+        // are before the current row of the runner-up, which is the first row of the
+        // others. When the whole buffer of the winner is before it, e.g. rowsets whose
+        // key ranges don't overlap, the rows of the buffer are returned without any
+        // comparison. -1 if the other children are exhausted.
+        int _runner_up = -1;
+        // buffer of the winner checked against the runner-up, and whether all its rows
+        // are before the runner-up
+        uint64_t _checked_buffer_id = UINT64_MAX;
+        bool _buffer_wins = false;
         // used when `_merge == false`
         int _child_idx = 0;
     };
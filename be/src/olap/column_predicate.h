@@ -19,9 +19,12 @@
 #define DORIS_BE_SRC_OLAP_COLUMN_PREDICATE_H
 
 #include <roaring/roaring.hh>
+#include <vector>
 
 #include "olap/column_block.h"
 #include "olap/rowset/segment_v2/bitmap_index_reader.h"
+#include "olap/rowset/segment_v2/ngram_index_reader.h"
+#include "olap/rowset/segment_v2/s2_index_reader.h"
 #include "olap/selection_vector.h"
 
 using namespace doris::segment_v2;
@@ -48,8 +51,74 @@ public:
                             const std::vector<BitmapIndexIterator*>& iterators, uint32_t num_rows,
                             Roaring* roaring) const = 0;
 
+    // Whether the predicate can be evaluated by the evaluate() on bitmap indexes.
+    virtual bool can_use_bitmap_index() const { return true; }
+
+    // Remove from 'roaring' rows not satisfying this predicate by the n-gram index of
+    // the column. Rows left may not satisfy it either, so it's still evaluated on the
+    // values. No row is removed by default.
+    virtual Status evaluate_ngram_index(NGramIndexIterator* iterator, Roaring* roaring) const {
+        return Status::OK();
+    }
+
+    // Remove from 'roaring' rows not satisfying this predicate by the S2 index of the
+    // column, which is kept like the n-gram index. No row is removed by default.
+    virtual Status evaluate_s2_index(S2IndexIterator* iterator, Roaring* roaring) const {
+        return Status::OK();
+    }
+
+    // Whether this is a range predicate, i.e. <, <=, > or >=, which can be served by
+    // narrow_bitmap_index_range() together with the other range predicates of its column.
+    virtual bool is_range_predicate() const { return false; }
+
+    // Narrow [*from, *to), a range of ordinals of the dictionary of a bitmap index, to
+    // the values satisfying this range predicate. Only for range predicates.
+    virtual Status narrow_bitmap_index_range(BitmapIndexIterator* iterator, rowid_t* from,
+                                             rowid_t* to) const {
+        return Status::NotSupported("not a range predicate");
+    }
+
     uint32_t column_id() const { return _column_id; }
 
+    // Evaluate on the dictionary codes of a string column. 'match' is called
+    // once per word of the dictionary and the result is cached in the batch of
+    // the block until it's decoded from another dictionary. Return false if the
+    // block is not decoded from one dictionary, and the caller should evaluate values.
+    template <class MatchFn>
+    bool evaluate_dict(ColumnBlock* block, uint16_t* sel, uint16_t* size, MatchFn match) const {
+        ColumnVectorBatch* batch = block->vector_batch();
+        const Slice* words = batch->dict_words();
+        if (words == nullptr) {
+            return false;
+        }
+        ColumnVectorBatch::DictMatches* cache = batch->dict_matches(this);
+        if (cache->dict_id != batch->dict_id()) {
+            cache->matches.resize(batch->dict_size());
+            for (size_t i = 0; i < batch->dict_size(); ++i) {
+                cache->matches[i] = match(words[i]);
+            }
+            cache->dict_id = batch->dict_id();
+        }
+        const uint8_t* dict_matches = cache->matches.data();
+        const int32_t* codes = batch->dict_codes();
+        uint16_t new_size = 0;
+        if (block->is_nullable()) {
+            for (uint16_t i = 0; i < *size; ++i) {
+                uint16_t idx = sel[i];
+                sel[new_size] = idx;
+                new_size += (!block->is_null(idx) && dict_matches[codes[idx]]);
+            }
+        } else {
+            for (uint16_t i = 0; i < *size; ++i) {
+                uint16_t idx = sel[i];
+                sel[new_size] = idx;
+                new_size += dict_matches[codes[idx]];
+            }
+        }
+        *size = new_size;
+        return true;
+    }
+
 protected:
     uint32_t _column_id;
 };
@@ -17,6 +17,10 @@
 
 #pragma once
 
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
 #include "common/status.h"
 #include "olap/olap_common.h"
 #include "olap/rowset/segment_v2/common.h" // for ordinal_t
@@ -24,6 +28,8 @@
 
 namespace doris {
 
+class ColumnPredicate;
+
 template <class T>
 class DataBuffer {
 private:
@@ -100,6 +106,55 @@ public:
 
     const bool* null_signs() const { return _null_signs.data(); }
 
+    // Dictionary codes of a string column decoded from dictionary encoded pages.
+    // dict_words() is not nullptr only if all non-null rows of this batch are
+    // decoded from the same dictionary, then the value of row i is
+    // dict_words()[dict_codes()[i]], and predicates can be evaluated on codes.
+    const Slice* dict_words() const { return _dict_mixed ? nullptr : _dict_words; }
+    size_t dict_size() const { return _dict_size; }
+    uint64_t dict_id() const { return _dict_id; }
+    const int32_t* dict_codes() const { return _dict_codes.data(); }
+
+    // Return the buffer to write the codes of rows [offset, offset + num_rows).
+    // Rows written are from dictionary 'dict_id' whose words are 'words'.
+    int32_t* prepare_dict_codes(uint64_t dict_id, const Slice* words, size_t dict_size,
+                                size_t offset, size_t num_rows) {
+        if (_dict_id == 0) {
+            _dict_id = dict_id;
+            _dict_words = words;
+            _dict_size = dict_size;
+        } else if (_dict_id != dict_id) {
+            _dict_mixed = true;
+        }
+        if (_dict_codes.size() < offset + num_rows) {
+            _dict_codes.resize(std::max(offset + num_rows, _capacity));
+        }
+        return _dict_codes.data() + offset;
+    }
+
+    // Result of a predicate on each word of a dictionary, matches[code] is the result on
+    // word 'code' of dictionary 'dict_id'.
+    struct DictMatches {
+        uint64_t dict_id = 0;
+        std::vector<uint8_t> matches;
+    };
+
+    // The cache of ColumnPredicate::evaluate_dict() for 'pred'. It's kept in the batch
+    // rather than the predicate since the batch belongs to a single iterator, which
+    // refills it from the same dictionary many times.
+    DictMatches* dict_matches(const ColumnPredicate* pred) { return &_dict_matches[pred]; }
+
+    // Rows not decoded from a dictionary were added to this batch.
+    void set_dict_mixed() { _dict_mixed = true; }
+
+    // Must be called before the batch is refilled.
+    void reset_dict() {
+        _dict_id = 0;
+        _dict_words = nullptr;
+        _dict_size = 0;
+        _dict_mixed = false;
+    }
+
     void set_delete_state(DelCondSatisfied delete_state) { _delete_state = delete_state; }
 
     DelCondSatisfied delete_state() const { return _delete_state; }
@@ -129,6 +184,13 @@ private:
     DelCondSatisfied _delete_state;
     const bool _nullable;
     DataBuffer<bool> _null_signs;
+
+    uint64_t _dict_id = 0;
+    const Slice* _dict_words = nullptr;
+    size_t _dict_size = 0;
+    bool _dict_mixed = false;
+    DataBuffer<int32_t> _dict_codes;
+    std::unordered_map<const ColumnPredicate*, DictMatches> _dict_matches;
 };
 
 template <class ScalarCppType>
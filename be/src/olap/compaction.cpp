@@ -17,8 +17,15 @@
 
 #include "olap/compaction.h"
 
+#include <algorithm>
+
 #include "gutil/strings/substitute.h"
+#include "olap/rowset/beta_rowset.h"
 #include "olap/rowset/rowset_factory.h"
+#include "olap/rowset/segment_v2/segment.h"
+#include "olap/wrapper_field.h"
+#include "util/continuous_cpu_profiler.h"
+#include "util/threadpool.h"
 #include "util/time.h"
 #include "util/trace.h"
 
@@ -52,6 +59,7 @@ OLAPStatus Compaction::execute_compact() {
 }
 
 OLAPStatus Compaction::do_compaction(int64_t permits) {
+    ScopedCpuProfilerTag profiler_tag(ContinuousCpuProfiler::COMPACTION);
     TRACE("start to do compaction");
     _tablet->data_dir()->disks_compaction_score_increment(permits);
     _tablet->data_dir()->disks_compaction_num_increment(1);
@@ -90,8 +98,25 @@ OLAPStatus Compaction::do_compaction_impl(int64_t permits) {
     // 2. write merged rows to output rowset
     // The test results show that merger is low-memory-footprint, there is no need to tracker its mem pool
     Merger::Statistics stats;
-    auto res = Merger::merge_rowsets(_tablet, compaction_type(), _input_rs_readers,
-                                     _output_rs_writer.get(), &stats);
+    OLAPStatus res;
+    bool linked = _is_rowsets_ordered();
+    int64_t num_key_ranges = linked ? 1 : _num_key_ranges();
+    if (linked) {
+        // no row needs to be merged, just link the segments into the output rowset
+        res = _link_ordered_rowsets(&stats);
+        TRACE_COUNTER_INCREMENT("linked_ordered_rowsets", 1);
+    } else if (num_key_ranges > 1) {
+        res = _merge_by_key_ranges(num_key_ranges, &stats);
+    } else if (Merger::can_vertical_merge(_tablet, _input_rowsets, _output_rs_writer.get())) {
+        res = Merger::vertical_merge_rowsets(_tablet, _input_rowsets, _output_rs_writer.get(),
+                                             &stats);
+    } else if (Merger::can_block_merge(_tablet, _input_rowsets, _output_rs_writer.get())) {
+        res = Merger::block_merge_rowsets(_tablet, _input_rowsets, _output_rs_writer.get(),
+                                          &stats);
+    } else {
+        res = Merger::merge_rowsets(_tablet, compaction_type(), _input_rs_readers,
+                                    _output_rs_writer.get(), &stats);
+    }
     if (res != OLAP_SUCCESS) {
         LOG(WARNING) << "fail to do " << compaction_name() << ". res=" << res
                      << ", tablet=" << _tablet->full_name()
@@ -120,9 +145,17 @@ OLAPStatus Compaction::do_compaction_impl(int64_t permits) {
     TRACE("check correctness finished");
 
     // 4. modify rowsets in memory
-    modify_rowsets();
+    RETURN_NOT_OK(modify_rowsets());
     TRACE("modify rowsets finished");
 
+    // the input rowsets are only read by the queries which have captured them before,
+    // unless their segments are linked into the output rowset
+    if (config::compaction_drop_input_page_cache && !linked) {
+        for (auto& rowset : _input_rowsets) {
+            rowset->drop_page_cache();
+        }
+    }
+
     // 5. update last success compaction time
     int64_t now = UnixMillis();
     if (compaction_type() == ReaderType::READER_CUMULATIVE_COMPACTION) {
@@ -139,7 +172,162 @@ OLAPStatus Compaction::do_compaction_impl(int64_t permits) {
     return OLAP_SUCCESS;
 }
 
+bool Compaction::_is_rowsets_ordered() {
+    if (!config::enable_ordered_data_compaction || _input_rowsets.size() < 2 ||
+        _output_rs_writer->type() != BETA_ROWSET || _tablet->enable_unique_key_merge_on_write()) {
+        return false;
+    }
+    // Rows of input rowsets are never aggregated if the key ranges of their segments don't
+    // overlap, which is judged by the segment-level zone maps of the first key column.
+    // Nulls are not in zone maps, so the column must not be nullable.
+    const TabletColumn& column = _tablet->tablet_schema().column(0);
+    if (column.is_nullable()) {
+        return false;
+    }
+    std::unique_ptr<WrapperField> prev_max;
+    std::unique_ptr<WrapperField> min_value(WrapperField::create(column));
+    std::unique_ptr<WrapperField> max_value(WrapperField::create(column));
+    for (auto& rowset : _input_rowsets) {
+        if (rowset->rowset_meta()->rowset_type() != BETA_ROWSET ||
+            rowset->rowset_meta()->has_delete_predicate() ||
+            _tablet->tablet_meta()->delete_bitmap().contains(rowset->rowset_id())) {
+            return false;
+        }
+        auto beta_rowset = std::static_pointer_cast<BetaRowset>(rowset);
+        std::vector<segment_v2::SegmentSharedPtr> segments;
+        if (beta_rowset->load_segments(&segments) != OLAP_SUCCESS) {
+            return false;
+        }
+        for (auto& segment : segments) {
+            if (segment->num_rows() == 0) {
+                continue;
+            }
+            if (!segment->get_min_max(0, min_value.get(), max_value.get()).ok() ||
+                min_value->is_null()) {
+                return false;
+            }
+            if (prev_max != nullptr && prev_max->cmp(min_value.get()) >= 0) {
+                return false;
+            }
+            if (prev_max == nullptr) {
+                prev_max.reset(WrapperField::create(column));
+            }
+            std::swap(prev_max, max_value);
+        }
+    }
+    return true;
+}
+
+OLAPStatus Compaction::_link_ordered_rowsets(Merger::Statistics* stats) {
+    for (auto& rowset : _input_rowsets) {
+        RETURN_NOT_OK_LOG(_output_rs_writer->add_rowset(rowset),
+                          "failed to link rowset " + rowset->rowset_id().to_string() +
+                                  " of tablet " + _tablet->full_name());
+    }
+    stats->output_rows = _input_row_num;
+    stats->merged_rows = 0;
+    stats->filtered_rows = 0;
+    return OLAP_SUCCESS;
+}
+
+int64_t Compaction::_num_key_ranges() {
+    ThreadPool* pool = StorageEngine::instance()->base_compaction_key_range_pool();
+    if (compaction_type() != READER_BASE_COMPACTION || pool == nullptr ||
+        config::base_compaction_parallel_key_ranges <= 1 ||
+        _output_rs_writer->type() != BETA_ROWSET || _tablet->tablet_schema().is_clustered()) {
+        return 1;
+    }
+    for (auto& rowset : _input_rowsets) {
+        if (rowset->rowset_meta()->rowset_type() != BETA_ROWSET) {
+            return 1;
+        }
+    }
+    int64_t min_rows = std::max<int64_t>(1, config::base_compaction_min_rows_per_key_range);
+    return std::max<int64_t>(
+            1, std::min<int64_t>(config::base_compaction_parallel_key_ranges,
+                                 _input_row_num / min_rows));
+}
+
+OLAPStatus Compaction::_merge_by_key_ranges(int64_t num_ranges, Merger::Statistics* stats) {
+    // pairs of the start and end keys of ranges, the end key of a range is the start key of
+    // the next one, see BetaRowset::split_range()
+    std::vector<OlapTuple> keys;
+    OLAPStatus res = _tablet->split_range(OlapTuple(), OlapTuple(), _input_row_num / num_ranges,
+                                          &keys);
+    if (res != OLAP_SUCCESS || keys.size() < 4) {
+        // the keys of the largest segment are too few to split
+        return Merger::merge_rowsets(_tablet, compaction_type(), _input_rs_readers,
+                                     _output_rs_writer.get(), stats);
+    }
+    size_t n = keys.size() / 2;
+    std::vector<RowsetSharedPtr> rowsets(n);
+    std::vector<Merger::Statistics> range_stats(n);
+    std::vector<OLAPStatus> statuses(n, OLAP_SUCCESS);
+    // the last range is unbounded rather than ended by the max key of the short key columns
+    OlapTuple unbounded;
+    auto merge_range = [&](size_t i) {
+        const OlapTuple& end_key = i + 1 < n ? keys[2 * i + 1] : unbounded;
+        statuses[i] = _merge_key_range(keys[2 * i], end_key, &rowsets[i], &range_stats[i]);
+    };
+    std::unique_ptr<ThreadPoolToken> token =
+            StorageEngine::instance()->base_compaction_key_range_pool()->new_token(
+                    ThreadPool::ExecutionMode::CONCURRENT);
+    for (size_t i = 1; i < n; ++i) {
+        if (!token->submit_func([&merge_range, i]() { merge_range(i); }).ok()) {
+            merge_range(i);
+        }
+    }
+    merge_range(0);
+    token->wait();
+    TRACE_COUNTER_INCREMENT("merged_key_ranges", n);
+
+    for (size_t i = 0; i < n && res == OLAP_SUCCESS; ++i) {
+        res = statuses[i];
+    }
+    for (size_t i = 0; i < n && res == OLAP_SUCCESS; ++i) {
+        res = _output_rs_writer->add_rowset(rowsets[i]);
+        stats->output_rows += range_stats[i].output_rows;
+        stats->merged_rows += range_stats[i].merged_rows;
+        stats->filtered_rows += range_stats[i].filtered_rows;
+    }
+    // the segments linked into the output rowset are kept by their links
+    for (auto& rowset : rowsets) {
+        StorageEngine::instance()->add_unused_rowset(rowset);
+    }
+    if (res != OLAP_SUCCESS) {
+        LOG(WARNING) << "failed to merge key ranges of tablet " << _tablet->full_name()
+                     << ", num_ranges=" << n << ", res=" << res;
+    }
+    return res;
+}
+
+OLAPStatus Compaction::_merge_key_range(const OlapTuple& start_key, const OlapTuple& end_key,
+                                        RowsetSharedPtr* output_rowset,
+                                        Merger::Statistics* stats) {
+    std::vector<RowsetReaderSharedPtr> rs_readers;
+    for (auto& rowset : _input_rowsets) {
+        RowsetReaderSharedPtr rs_reader;
+        RETURN_NOT_OK(rowset->create_reader(_readers_tracker, &rs_reader));
+        rs_readers.push_back(std::move(rs_reader));
+    }
+    std::unique_ptr<RowsetWriter> rs_writer;
+    RETURN_NOT_OK(_create_rowset_writer(&rs_writer));
+    RETURN_NOT_OK(Merger::merge_rowsets(_tablet, compaction_type(), rs_readers, start_key,
+                                        end_key, rs_writer.get(), stats));
+    *output_rowset = rs_writer->build();
+    if (*output_rowset == nullptr) {
+        LOG(WARNING) << "failed to build rowset of key range " << start_key
+                     << " of tablet " << _tablet->full_name();
+        return OLAP_ERR_MALLOC_ERROR;
+    }
+    return OLAP_SUCCESS;
+}
+
 OLAPStatus Compaction::construct_output_rowset_writer() {
+    return _create_rowset_writer(&_output_rs_writer);
+}
+
+OLAPStatus Compaction::_create_rowset_writer(std::unique_ptr<RowsetWriter>* rs_writer) {
     RowsetWriterContext context;
     context.rowset_id = StorageEngine::instance()->next_rowset_id();
     context.tablet_uid = _tablet->tablet_uid();
@@ -151,13 +339,19 @@ OLAPStatus Compaction::construct_output_rowset_writer() {
         context.rowset_type = BETA_ROWSET;
     }
     context.rowset_path_prefix = _tablet->tablet_path();
+    context.data_dir = _tablet->data_dir();
+    context.direct_io = config::segment_write_direct_io;
     context.tablet_schema = &(_tablet->tablet_schema());
     context.rowset_state = VISIBLE;
     context.version = _output_version;
     context.version_hash = _output_version_hash;
     context.segments_overlap = NONOVERLAPPING;
+    // base compaction merges all versions from 0, its output has full columns, while
+    // cumulative compaction merges the rowsets of partial columns only with each other
+    context.partial_columns = compaction_type() == READER_CUMULATIVE_COMPACTION &&
+                              _input_rowsets.front()->rowset_meta()->partial_columns();
     // The test results show that one rs writer is low-memory-footprint, there is no need to tracker its mem pool
-    RETURN_NOT_OK(RowsetFactory::create_rowset_writer(context, &_output_rs_writer));
+    RETURN_NOT_OK(RowsetFactory::create_rowset_writer(context, rs_writer));
     return OLAP_SUCCESS;
 }
 
@@ -170,13 +364,46 @@ OLAPStatus Compaction::construct_input_rowset_readers() {
     return OLAP_SUCCESS;
 }
 
-void Compaction::modify_rowsets() {
+OLAPStatus Compaction::modify_rowsets() {
     std::vector<RowsetSharedPtr> output_rowsets;
     output_rowsets.push_back(_output_rowset);
 
+    // Rows of the input rowsets replaced by the loads published during the compaction, or
+    // deleted by the deletes newer than the output rowset, are marked in delete bitmap of
+    // the input rowsets, mark them in the output rowset. A delete by bitmap may be
+    // published on any tablet, so the update lock is always held.
+    DeleteBitmap delete_bitmap;
+    std::lock_guard<std::mutex> update_lock(*_tablet->get_rowset_update_lock());
+    std::vector<RowsetSharedPtr> newer_rowsets;
+    DelPredicateArray delete_predicates;
+    {
+        ReadLock rdlock(_tablet->get_header_lock_ptr());
+        _tablet->get_rowsets_after_version(_output_version.second, &newer_rowsets);
+        delete_predicates = _tablet->delete_predicates();
+    }
+    for (auto& delete_predicate : delete_predicates) {
+        if (delete_predicate.by_bitmap() && delete_predicate.version() > _output_version.second) {
+            RETURN_NOT_OK(Tablet::calc_delete_bitmap_by_predicate(
+                    _tablet->tablet_schema(), delete_predicate, output_rowsets, &delete_bitmap));
+        }
+    }
+    if (_tablet->enable_unique_key_merge_on_write()) {
+        std::sort(newer_rowsets.begin(), newer_rowsets.end(),
+                  [](const RowsetSharedPtr& a, const RowsetSharedPtr& b) {
+                      return a->end_version() < b->end_version();
+                  });
+        for (auto& rowset : newer_rowsets) {
+            RETURN_NOT_OK(Tablet::calc_delete_bitmap(rowset, output_rowsets,
+                                                     rowset->end_version(), false,
+                                                     &delete_bitmap));
+        }
+    }
+
     WriteLock wrlock(_tablet->get_header_lock_ptr());
+    _tablet->tablet_meta()->delete_bitmap().merge(delete_bitmap);
     _tablet->modify_rowsets(output_rowsets, _input_rowsets);
     _tablet->save_meta();
+    return OLAP_SUCCESS;
 }
 
 void Compaction::gc_output_rowset() {
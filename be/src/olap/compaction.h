@@ -63,7 +63,7 @@ protected:
     OLAPStatus do_compaction(int64_t permits);
     OLAPStatus do_compaction_impl(int64_t permits);
 
-    void modify_rowsets();
+    OLAPStatus modify_rowsets();
     void gc_output_rowset();
 
     OLAPStatus construct_output_rowset_writer();
@@ -80,6 +80,23 @@ private:
     // return -1 if these are not alpha rowsets.
     int64_t _get_input_num_rows_from_seg_grps();
 
+    // Whether input rowsets are beta rowsets whose segments are already sorted by key
+    // and don't overlap, so that they can be linked into the output rowset as they are.
+    bool _is_rowsets_ordered();
+    OLAPStatus _link_ordered_rowsets(Merger::Statistics* stats);
+
+    // The number of key ranges that the input rowsets of a base compaction are merged by in
+    // parallel, 1 if they are merged in one range.
+    int64_t _num_key_ranges();
+    // Split the input rowsets into key ranges by the short key index, merge each range into
+    // a rowset in parallel, and link the rowsets into the output rowset in key order.
+    OLAPStatus _merge_by_key_ranges(int64_t num_ranges, Merger::Statistics* stats);
+    OLAPStatus _merge_key_range(const OlapTuple& start_key, const OlapTuple& end_key,
+                                RowsetSharedPtr* output_rowset, Merger::Statistics* stats);
+
+    // create a writer of a new rowset of the output version
+    OLAPStatus _create_rowset_writer(std::unique_ptr<RowsetWriter>* rs_writer);
+
 protected:
     // the root tracker for this compaction
     std::shared_ptr<MemTracker> _mem_tracker;
@@ -0,0 +1,107 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/compaction_io_limiter.h"
+
+#include <set>
+
+#include "common/config.h"
+#include "olap/data_dir.h"
+#include "util/disk_info.h"
+#include "util/doris_metrics.h"
+#include "util/time.h"
+
+namespace doris {
+
+void CompactionIOLimiter::init(const std::vector<DataDir*>& data_dirs) {
+    std::lock_guard<std::mutex> l(_lock);
+    for (auto data_dir : data_dirs) {
+        std::set<std::string> devices;
+        auto st = DiskInfo::get_disk_devices({data_dir->path()}, &devices);
+        if (!st.ok() || devices.size() != 1) {
+            LOG(WARNING) << "failed to get disk device of data dir " << data_dir->path()
+                         << ", its compaction is not limited by disk I/O";
+            _states[data_dir];
+            continue;
+        }
+        _states[data_dir].device = *devices.begin();
+    }
+}
+
+void CompactionIOLimiter::update() {
+    SystemMetrics* system_metrics = DorisMetrics::instance()->system_metrics();
+    if (system_metrics == nullptr) {
+        return;
+    }
+    std::map<std::string, SystemMetrics::DiskIOStat> stats;
+    system_metrics->get_disks_io_stat(&stats);
+    int64_t now = MonotonicMillis();
+
+    std::lock_guard<std::mutex> l(_lock);
+    for (auto& it : _states) {
+        DiskIOState& state = it.second;
+        auto stat_it = stats.find(state.device);
+        if (stat_it == stats.end()) {
+            continue;
+        }
+        const SystemMetrics::DiskIOStat& stat = stat_it->second;
+        if (state.last_sample_ms == 0) {
+            state.last_stat = stat;
+            state.last_sample_ms = now;
+            continue;
+        }
+        int64_t interval_ms = now - state.last_sample_ms;
+        // system metrics are refreshed periodically, so the interval should be long enough
+        // to cover several refreshes
+        if (interval_ms < config::compaction_disk_io_stat_interval_sec * 1000L) {
+            continue;
+        }
+        int64_t ios = stat.ios_completed - state.last_stat.ios_completed;
+        state.read_mbytes_per_sec =
+                (stat.bytes_read - state.last_stat.bytes_read) * 1000.0 / interval_ms / 1024 / 1024;
+        state.write_mbytes_per_sec = (stat.bytes_written - state.last_stat.bytes_written) *
+                                     1000.0 / interval_ms / 1024 / 1024;
+        state.latency_ms =
+                ios > 0 ? (double)(stat.rw_time_ms - state.last_stat.rw_time_ms) / ios : 0;
+        state.util_percent = (stat.io_time_ms - state.last_stat.io_time_ms) * 100.0 / interval_ms;
+        state.last_stat = stat;
+        state.last_sample_ms = now;
+        VLOG(3) << "disk I/O of data dir " << it.first->path() << ": device=" << state.device
+                << ", read=" << state.read_mbytes_per_sec
+                << "MB/s, write=" << state.write_mbytes_per_sec
+                << "MB/s, latency=" << state.latency_ms << "ms, util=" << state.util_percent
+                << "%";
+    }
+}
+
+bool CompactionIOLimiter::admit(DataDir* data_dir, size_t num_running) {
+    int32_t share = config::compaction_disk_io_util_share;
+    if (share <= 0 || share >= 100 || num_running == 0) {
+        return true;
+    }
+    std::lock_guard<std::mutex> l(_lock);
+    auto it = _states.find(data_dir);
+    if (it == _states.end() || it->second.util_percent <= share) {
+        return true;
+    }
+    VLOG(3) << "throttle compaction of data dir " << data_dir->path()
+            << ", util=" << it->second.util_percent << "%, share=" << share
+            << "%, running=" << num_running;
+    return false;
+}
+
+} // namespace doris
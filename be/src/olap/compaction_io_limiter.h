@@ -0,0 +1,66 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "util/system_metrics.h"
+
+namespace doris {
+
+class DataDir;
+
+/*
+    This class is used to keep compaction under a share of the I/O capacity of each data dir. It samples
+    the I/O counters of the disk device of every data dir from system metrics, and derives the throughput,
+    the latency and the utilization of the disk. New compaction tasks on a data dir whose utilization
+    exceeds "compaction_disk_io_util_share" are throttled: only one task may run on it until the
+    utilization drops. It admits all tasks if system metrics are disabled.
+*/
+class CompactionIOLimiter {
+public:
+    struct DiskIOState {
+        // disk device of the data dir, empty if unknown
+        std::string device;
+        SystemMetrics::DiskIOStat last_stat;
+        int64_t last_sample_ms = 0;
+
+        double read_mbytes_per_sec = 0;
+        double write_mbytes_per_sec = 0;
+        // average time of an I/O
+        double latency_ms = 0;
+        // percent of time the disk is busy
+        double util_percent = 0;
+    };
+
+    void init(const std::vector<DataDir*>& data_dirs);
+
+    // Sample I/O counters, stats are refreshed every "compaction_disk_io_stat_interval_sec".
+    void update();
+
+    // Whether a new compaction task may run on `data_dir` which has `num_running` running tasks.
+    bool admit(DataDir* data_dir, size_t num_running);
+
+private:
+    std::mutex _lock;
+    std::map<DataDir*, DiskIOState> _states;
+};
+} // namespace doris
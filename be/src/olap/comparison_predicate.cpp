@@ -17,8 +17,12 @@
 
 #include "olap/comparison_predicate.h"
 
+#include <algorithm>
+#include <functional>
+
 #include "common/logging.h"
 #include "olap/schema.h"
+#include "olap/selection_kernel.h"
 #include "runtime/string_value.hpp"
 #include "runtime/vectorized_row_batch.h"
 
@@ -109,9 +113,60 @@ COMPARISON_PRED_EVALUATE(LessEqualPredicate, <=)
 COMPARISON_PRED_EVALUATE(GreaterPredicate, >)
 COMPARISON_PRED_EVALUATE(GreaterEqualPredicate, >=)
 
-#define COMPARISON_PRED_COLUMN_BLOCK_EVALUATE(CLASS, OP)                                  \
+// Evaluate a block with a dense selection vector by selection_kernel.
+// Return false if the block can't be evaluated this way.
+template <class Op, class type>
+static typename std::enable_if<selection_kernel::is_simd_comparable<type>::value, bool>::type
+evaluate_dense(ColumnBlock* block, const type& value, uint16_t* sel, uint16_t* size) {
+    if (!selection_kernel::is_dense(sel, *size)) {
+        return false;
+    }
+    const type* data = reinterpret_cast<const type*>(block->cell_ptr(0));
+    const bool* is_null = block->is_nullable() ? block->vector_batch()->null_signs() : nullptr;
+    *size = selection_kernel::evaluate_dense<type, Op>(data, is_null, *size, value, sel);
+    return true;
+}
+
+template <class Op, class type>
+static typename std::enable_if<!selection_kernel::is_simd_comparable<type>::value, bool>::type
+evaluate_dense(ColumnBlock* block, const type& value, uint16_t* sel, uint16_t* size) {
+    return false;
+}
+
+template <class Op>
+struct DictWordMatcher {
+    DictWordMatcher(const StringValue& value) : value(value) {}
+    bool operator()(const Slice& word) const {
+        return Op()(StringValue(word.data, word.size), value);
+    }
+    const StringValue& value;
+};
+
+// Evaluate a string column decoded from a dictionary on its codes.
+// Return false if the block can't be evaluated this way.
+template <class Op, class type>
+static typename std::enable_if<std::is_same<type, StringValue>::value, bool>::type evaluate_dict(
+        const ColumnPredicate* pred, ColumnBlock* block, const type& value, uint16_t* sel,
+        uint16_t* size) {
+    return pred->evaluate_dict(block, sel, size, DictWordMatcher<Op>(value));
+}
+
+template <class Op, class type>
+static typename std::enable_if<!std::is_same<type, StringValue>::value, bool>::type
+evaluate_dict(const ColumnPredicate* pred, ColumnBlock* block, const type& value, uint16_t* sel,
+              uint16_t* size) {
+    return false;
+}
+
+#define COMPARISON_PRED_COLUMN_BLOCK_EVALUATE(CLASS, OP, FUNCTOR)                         \
     template <class type>                                                                 \
     void CLASS<type>::evaluate(ColumnBlock* block, uint16_t* sel, uint16_t* size) const { \
+        if (evaluate_dense<FUNCTOR<type>>(block, _value, sel, size)) {                    \
+            return;                                                                       \
+        }                                                                                 \
+        if (evaluate_dict<FUNCTOR<type>>(this, block, _value, sel, size)) {               \
+            return;                                                                       \
+        }                                                                                 \
         uint16_t new_size = 0;                                                            \
         if (block->is_nullable()) {                                                       \
             for (uint16_t i = 0; i < *size; ++i) {                                        \
@@ -133,12 +188,12 @@ COMPARISON_PRED_EVALUATE(GreaterEqualPredicate, >=)
         *size = new_size;                                                                 \
     }
 
-COMPARISON_PRED_COLUMN_BLOCK_EVALUATE(EqualPredicate, ==)
-COMPARISON_PRED_COLUMN_BLOCK_EVALUATE(NotEqualPredicate, !=)
-COMPARISON_PRED_COLUMN_BLOCK_EVALUATE(LessPredicate, <)
-COMPARISON_PRED_COLUMN_BLOCK_EVALUATE(LessEqualPredicate, <=)
-COMPARISON_PRED_COLUMN_BLOCK_EVALUATE(GreaterPredicate, >)
-COMPARISON_PRED_COLUMN_BLOCK_EVALUATE(GreaterEqualPredicate, >=)
+COMPARISON_PRED_COLUMN_BLOCK_EVALUATE(EqualPredicate, ==, std::equal_to)
+COMPARISON_PRED_COLUMN_BLOCK_EVALUATE(NotEqualPredicate, !=, std::not_equal_to)
+COMPARISON_PRED_COLUMN_BLOCK_EVALUATE(LessPredicate, <, std::less)
+COMPARISON_PRED_COLUMN_BLOCK_EVALUATE(LessEqualPredicate, <=, std::less_equal)
+COMPARISON_PRED_COLUMN_BLOCK_EVALUATE(GreaterPredicate, >, std::greater)
+COMPARISON_PRED_COLUMN_BLOCK_EVALUATE(GreaterEqualPredicate, >=, std::greater_equal)
 
 #define BITMAP_COMPARE_EqualPredicate(s, exact_match, seeked_ordinal, iterator, bitmap, roaring) \
     do {                                                                                         \
@@ -254,6 +309,77 @@ COMPARISON_PRED_BITMAP_EVALUATE(LessEqualPredicate, <=)
 COMPARISON_PRED_BITMAP_EVALUATE(GreaterPredicate, >)
 COMPARISON_PRED_BITMAP_EVALUATE(GreaterEqualPredicate, >=)
 
+#define BITMAP_NARROW_LessPredicate(s, exact_match, seeked_ordinal, from, to) \
+    do {                                                                      \
+        if (!s.is_not_found()) {                                              \
+            *to = std::min(*to, seeked_ordinal);                              \
+        }                                                                     \
+    } while (0)
+
+#define BITMAP_NARROW_LessEqualPredicate(s, exact_match, seeked_ordinal, from, to)  \
+    do {                                                                            \
+        if (!s.is_not_found()) {                                                    \
+            *to = std::min(*to, exact_match ? seeked_ordinal + 1 : seeked_ordinal); \
+        }                                                                           \
+    } while (0)
+
+#define BITMAP_NARROW_GreaterPredicate(s, exact_match, seeked_ordinal, from, to)        \
+    do {                                                                                \
+        if (s.is_not_found()) {                                                         \
+            *from = *to;                                                                \
+        } else {                                                                        \
+            *from = std::max(*from, exact_match ? seeked_ordinal + 1 : seeked_ordinal); \
+        }                                                                               \
+    } while (0)
+
+#define BITMAP_NARROW_GreaterEqualPredicate(s, exact_match, seeked_ordinal, from, to) \
+    do {                                                                              \
+        if (s.is_not_found()) {                                                       \
+            *from = *to;                                                              \
+        } else {                                                                      \
+            *from = std::max(*from, seeked_ordinal);                                  \
+        }                                                                             \
+    } while (0)
+
+#define BITMAP_NARROW(CLASS, s, exact_match, seeked_ordinal, from, to) \
+    BITMAP_NARROW_##CLASS(s, exact_match, seeked_ordinal, from, to)
+
+#define COMPARISON_PRED_BITMAP_NARROW(CLASS)                                                    \
+    template <class type>                                                                       \
+    bool CLASS<type>::is_range_predicate() const {                                              \
+        return true;                                                                            \
+    }                                                                                           \
+    template <class type>                                                                       \
+    Status CLASS<type>::narrow_bitmap_index_range(BitmapIndexIterator* iterator, rowid_t* from, \
+                                                  rowid_t* to) const {                          \
+        bool exact_match;                                                                       \
+        Status s = iterator->seek_dictionary(&_value, &exact_match);                            \
+        if (!s.ok() && !s.is_not_found()) {                                                     \
+            return s;                                                                           \
+        }                                                                                       \
+        rowid_t seeked_ordinal = iterator->current_ordinal();                                   \
+        BITMAP_NARROW(CLASS, s, exact_match, seeked_ordinal, from, to);                         \
+        return Status::OK();                                                                    \
+    }
+
+#define COMPARISON_PRED_BITMAP_NOT_RANGE(CLASS)                                                 \
+    template <class type>                                                                       \
+    bool CLASS<type>::is_range_predicate() const {                                              \
+        return false;                                                                           \
+    }                                                                                           \
+    template <class type>                                                                       \
+    Status CLASS<type>::narrow_bitmap_index_range(BitmapIndexIterator* iterator, rowid_t* from, \
+                                                  rowid_t* to) const {                          \
+        return Status::NotSupported("not a range predicate");                                   \
+    }
+
+COMPARISON_PRED_BITMAP_NOT_RANGE(EqualPredicate)
+COMPARISON_PRED_BITMAP_NOT_RANGE(NotEqualPredicate)
+COMPARISON_PRED_BITMAP_NARROW(LessPredicate)
+COMPARISON_PRED_BITMAP_NARROW(LessEqualPredicate)
+COMPARISON_PRED_BITMAP_NARROW(GreaterPredicate)
+COMPARISON_PRED_BITMAP_NARROW(GreaterEqualPredicate)
+
 #define COMPARISON_PRED_CONSTRUCTOR_DECLARATION(CLASS)                                \
     template CLASS<int8_t>::CLASS(uint32_t column_id, const int8_t& value);           \
     template CLASS<int16_t>::CLASS(uint32_t column_id, const int16_t& value);         \
@@ -372,4 +498,49 @@ COMPARISON_PRED_BITMAP_EVALUATE_DECLARATION(LessEqualPredicate)
 COMPARISON_PRED_BITMAP_EVALUATE_DECLARATION(GreaterPredicate)
 COMPARISON_PRED_BITMAP_EVALUATE_DECLARATION(GreaterEqualPredicate)
 
+#define COMPARISON_PRED_BITMAP_NARROW_DECLARATION(CLASS)                      \
+    template bool CLASS<int8_t>::is_range_predicate() const;                  \
+    template Status CLASS<int8_t>::narrow_bitmap_index_range(                 \
+            BitmapIndexIterator* iterator, rowid_t* from, rowid_t* to) const; \
+    template bool CLASS<int16_t>::is_range_predicate() const;                 \
+    template Status CLASS<int16_t>::narrow_bitmap_index_range(                \
+            BitmapIndexIterator* iterator, rowid_t* from, rowid_t* to) const; \
+    template bool CLASS<int32_t>::is_range_predicate() const;                 \
+    template Status CLASS<int32_t>::narrow_bitmap_index_range(                \
+            BitmapIndexIterator* iterator, rowid_t* from, rowid_t* to) const; \
+    template bool CLASS<int64_t>::is_range_predicate() const;                 \
+    template Status CLASS<int64_t>::narrow_bitmap_index_range(                \
+            BitmapIndexIterator* iterator, rowid_t* from, rowid_t* to) const; \
+    template bool CLASS<int128_t>::is_range_predicate() const;                \
+    template Status CLASS<int128_t>::narrow_bitmap_index_range(               \
+            BitmapIndexIterator* iterator, rowid_t* from, rowid_t* to) const; \
+    template bool CLASS<float>::is_range_predicate() const;                   \
+    template Status CLASS<float>::narrow_bitmap_index_range(                  \
+            BitmapIndexIterator* iterator, rowid_t* from, rowid_t* to) const; \
+    template bool CLASS<double>::is_range_predicate() const;                  \
+    template Status CLASS<double>::narrow_bitmap_index_range(                 \
+            BitmapIndexIterator* iterator, rowid_t* from, rowid_t* to) const; \
+    template bool CLASS<decimal12_t>::is_range_predicate() const;             \
+    template Status CLASS<decimal12_t>::narrow_bitmap_index_range(            \
+            BitmapIndexIterator* iterator, rowid_t* from, rowid_t* to) const; \
+    template bool CLASS<StringValue>::is_range_predicate() const;             \
+    template Status CLASS<StringValue>::narrow_bitmap_index_range(            \
+            BitmapIndexIterator* iterator, rowid_t* from, rowid_t* to) const; \
+    template bool CLASS<uint24_t>::is_range_predicate() const;                \
+    template Status CLASS<uint24_t>::narrow_bitmap_index_range(               \
+            BitmapIndexIterator* iterator, rowid_t* from, rowid_t* to) const; \
+    template bool CLASS<uint64_t>::is_range_predicate() const;                \
+    template Status CLASS<uint64_t>::narrow_bitmap_index_range(               \
+            BitmapIndexIterator* iterator, rowid_t* from, rowid_t* to) const; \
+    template bool CLASS<bool>::is_range_predicate() const;                    \
+    template Status CLASS<bool>::narrow_bitmap_index_range(                   \
+            BitmapIndexIterator* iterator, rowid_t* from, rowid_t* to) const;
+
+COMPARISON_PRED_BITMAP_NARROW_DECLARATION(EqualPredicate)
+COMPARISON_PRED_BITMAP_NARROW_DECLARATION(NotEqualPredicate)
+COMPARISON_PRED_BITMAP_NARROW_DECLARATION(LessPredicate)
+COMPARISON_PRED_BITMAP_NARROW_DECLARATION(LessEqualPredicate)
+COMPARISON_PRED_BITMAP_NARROW_DECLARATION(GreaterPredicate)
+COMPARISON_PRED_BITMAP_NARROW_DECLARATION(GreaterEqualPredicate)
+
 } //namespace doris
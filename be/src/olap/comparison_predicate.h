@@ -37,6 +37,9 @@ class VectorizedRowBatch;
         virtual Status evaluate(const Schema& schema,                                    \
                                 const std::vector<BitmapIndexIterator*>& iterators,      \
                                 uint32_t num_rows, Roaring* roaring) const override;     \
+        bool is_range_predicate() const override;                                        \
+        Status narrow_bitmap_index_range(BitmapIndexIterator* iterator, rowid_t* from,   \
+                                         rowid_t* to) const override;                    \
                                                                                          \
     private:                                                                             \
         type _value;                                                                     \
@@ -17,6 +17,8 @@
 
 #include "olap/cumulative_compaction.h"
 
+#include <algorithm>
+
 #include "util/doris_metrics.h"
 #include "util/time.h"
 #include "util/trace.h"
@@ -50,6 +52,7 @@ OLAPStatus CumulativeCompaction::prepare_compact() {
 
     // 2. pick rowsets to compact
     RETURN_NOT_OK(pick_rowsets_to_compact());
+    RETURN_NOT_OK(_cut_at_partial_columns_change());
     TRACE("rowsets picked");
     TRACE_COUNTER_INCREMENT("input_rowsets_count", _input_rowsets.size());
     _tablet->set_clone_occurred(false);
@@ -182,4 +185,24 @@ OLAPStatus CumulativeCompaction::pick_rowsets_to_compact() {
     return OLAP_SUCCESS;
 }
 
+OLAPStatus CumulativeCompaction::_cut_at_partial_columns_change() {
+    bool partial_columns = _input_rowsets.front()->rowset_meta()->partial_columns();
+    auto it = std::find_if(_input_rowsets.begin(), _input_rowsets.end(),
+                           [partial_columns](const RowsetSharedPtr& rowset) {
+                               return rowset->rowset_meta()->partial_columns() != partial_columns;
+                           });
+    if (it == _input_rowsets.end()) {
+        return OLAP_SUCCESS;
+    }
+    _input_rowsets.erase(it, _input_rowsets.end());
+    if (_input_rowsets.size() == 1) {
+        // like a delete version, the single rowset is left to base compaction, which merges
+        // it with the lower versions, so that the cumulative point moves on
+        _tablet->set_cumulative_layer_point(_input_rowsets.front()->end_version() + 1);
+        _input_rowsets.clear();
+        return OLAP_ERR_CUMULATIVE_NO_SUITABLE_VERSIONS;
+    }
+    return OLAP_SUCCESS;
+}
+
 } // namespace doris
@@ -44,6 +44,11 @@ protected:
     ReaderType compaction_type() const override { return ReaderType::READER_CUMULATIVE_COMPACTION; }
 
 private:
+    // The output rowset has one partial_columns flag for all its rows, so the rowsets of
+    // partial columns aren't compacted with the others: the input rowsets are cut at the
+    // first change of the flag.
+    OLAPStatus _cut_at_partial_columns_change();
+
     int64_t _cumulative_rowset_size_threshold;
 
     Version _last_delete_version{-1, -1};
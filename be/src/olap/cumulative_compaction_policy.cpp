@@ -17,7 +17,9 @@
 
 #include "olap/cumulative_compaction_policy.h"
 
+#include <algorithm>
 #include <boost/algorithm/string.hpp>
+#include <limits>
 #include <string>
 
 #include "util/time.h"
@@ -420,6 +422,177 @@ void NumBasedCumulativeCompactionPolicy::calculate_cumulative_point(
     }
 }
 
+TimeSeriesCumulativeCompactionPolicy::TimeSeriesCumulativeCompactionPolicy(
+        int64_t goal_size, int64_t file_count_threshold, int64_t time_threshold_sec)
+        : CumulativeCompactionPolicy(),
+          _goal_size(goal_size),
+          _file_count_threshold(file_count_threshold),
+          _time_threshold_sec(time_threshold_sec) {}
+
+void TimeSeriesCumulativeCompactionPolicy::calculate_cumulative_point(
+        Tablet* tablet, const std::vector<RowsetMetaSharedPtr>& all_metas,
+        int64_t current_cumulative_point, int64_t* ret_cumulative_point) {
+    *ret_cumulative_point = Tablet::K_INVALID_CUMULATIVE_POINT;
+    if (current_cumulative_point != Tablet::K_INVALID_CUMULATIVE_POINT) {
+        // only calculate the point once.
+        // after that, cumulative point will be updated along with compaction process.
+        return;
+    }
+
+    std::list<RowsetMetaSharedPtr> existing_rss;
+    for (auto& rs : all_metas) {
+        existing_rss.emplace_back(rs);
+    }
+
+    // sort the existing rowsets by version in ascending order
+    existing_rss.sort([](const RowsetMetaSharedPtr& a, const RowsetMetaSharedPtr& b) {
+        // simple because 2 versions are certainly not overlapping
+        return a->version().first < b->version().first;
+    });
+
+    int64_t prev_version = -1;
+    for (const RowsetMetaSharedPtr& rs : existing_rss) {
+        if (rs->version().first > prev_version + 1) {
+            // There is a hole, do not continue
+            break;
+        }
+        // the rowsets before the first overlapping or singleton one are final outputs
+        if (rs->is_segments_overlapping() || rs->is_singleton_delta()) {
+            *ret_cumulative_point = rs->version().first;
+            break;
+        }
+
+        prev_version = rs->version().second;
+        *ret_cumulative_point = prev_version + 1;
+    }
+}
+
+bool TimeSeriesCumulativeCompactionPolicy::_is_window_closed(int64_t total_size,
+                                                             int64_t num_rowsets,
+                                                             int64_t oldest_creation_time) {
+    return total_size >= _goal_size || num_rowsets >= _file_count_threshold ||
+           UnixSeconds() - oldest_creation_time >= _time_threshold_sec;
+}
+
+int TimeSeriesCumulativeCompactionPolicy::pick_input_rowsets(
+        Tablet* tablet, const std::vector<RowsetSharedPtr>& candidate_rowsets,
+        const int64_t max_compaction_score, const int64_t min_compaction_score,
+        std::vector<RowsetSharedPtr>* input_rowsets, Version* last_delete_version,
+        size_t* compaction_score) {
+    *compaction_score = 0;
+    int transient_size = 0;
+    int64_t total_size = 0;
+    int64_t oldest_creation_time = std::numeric_limits<int64_t>::max();
+    bool window_full = false;
+    for (size_t i = 0; i < candidate_rowsets.size(); ++i) {
+        RowsetSharedPtr rowset = candidate_rowsets[i];
+        // check whether this rowset is delete version
+        if (tablet->version_for_delete_predicate(rowset->version())) {
+            *last_delete_version = rowset->version();
+            if (!input_rowsets->empty()) {
+                // we meet a delete version, and there were other versions before.
+                // we should compact those version before handling them over to base compaction
+                break;
+            } else {
+                // we meet a delete version, and no other versions before, skip it and continue
+                input_rowsets->clear();
+                *compaction_score = 0;
+                transient_size = 0;
+                continue;
+            }
+        }
+        auto rs_meta = rowset->rowset_meta();
+        if (input_rowsets->empty() && !rs_meta->is_segments_overlapping() &&
+            rs_meta->total_disk_size() >= _goal_size) {
+            // the rowset is a window of the goal size already, hand it over as it is
+            tablet->set_cumulative_layer_point(rowset->end_version() + 1);
+            transient_size += 1;
+            continue;
+        }
+        *compaction_score += rs_meta->get_compaction_score();
+        total_size += rs_meta->total_disk_size();
+        oldest_creation_time = std::min(oldest_creation_time, rs_meta->creation_time());
+        transient_size += 1;
+        input_rowsets->push_back(rowset);
+        if (total_size >= _goal_size ||
+            static_cast<int64_t>(input_rowsets->size()) >= _file_count_threshold ||
+            *compaction_score >= max_compaction_score) {
+            // the window is full, the following rowsets are of the next window
+            window_full = true;
+            break;
+        }
+    }
+
+    if (input_rowsets->empty()) {
+        return transient_size;
+    }
+
+    // a window is closed by a delete version as well, the output is final anyway
+    if (!window_full && last_delete_version->first == -1 &&
+        !_is_window_closed(total_size, input_rowsets->size(), oldest_creation_time)) {
+        input_rowsets->clear();
+        *compaction_score = 0;
+        return transient_size;
+    }
+
+    if (input_rowsets->size() == 1 &&
+        !input_rowsets->front()->rowset_meta()->is_segments_overlapping()) {
+        // there is only one rowset and not overlapping, no need to do compaction,
+        // move the cumulative point after it
+        tablet->set_cumulative_layer_point(input_rowsets->front()->end_version() + 1);
+        input_rowsets->clear();
+        *compaction_score = 0;
+    }
+
+    VLOG(1) << "cumulative compaction time_series policy, compaction_score = " << *compaction_score
+            << ", total_size = " << total_size << ", goal size = " << _goal_size
+            << ", tablet = " << tablet->full_name() << ", input_rowset size "
+            << input_rowsets->size();
+    return transient_size;
+}
+
+void TimeSeriesCumulativeCompactionPolicy::update_cumulative_point(
+        Tablet* tablet, const std::vector<RowsetSharedPtr>& input_rowsets,
+        RowsetSharedPtr output_rowset, Version& last_delete_version) {
+    // the output of a window is final, never compact it again
+    tablet->set_cumulative_layer_point(output_rowset->end_version() + 1);
+}
+
+void TimeSeriesCumulativeCompactionPolicy::calc_cumulative_compaction_score(
+        const std::vector<RowsetMetaSharedPtr>& all_metas, int64_t current_cumulative_point,
+        uint32_t* score) {
+    bool base_rowset_exist = false;
+    const int64_t point = current_cumulative_point;
+    int64_t total_size = 0;
+    int64_t num_rowsets = 0;
+    int64_t oldest_creation_time = std::numeric_limits<int64_t>::max();
+    for (auto& rs_meta : all_metas) {
+        if (rs_meta->start_version() == 0) {
+            base_rowset_exist = true;
+        }
+        if (rs_meta->start_version() < point) {
+            // all_rs_metas() is not sorted, so we use _continue_ other than _break_ here.
+            continue;
+        }
+        *score += rs_meta->get_compaction_score();
+        total_size += rs_meta->total_disk_size();
+        num_rowsets += 1;
+        oldest_creation_time = std::min(oldest_creation_time, rs_meta->creation_time());
+    }
+
+    // If base version does not exist, it may be that tablet is doing alter table.
+    // Do not select it and set *score = 0.
+    // The rowsets of a window which is not closed are not compacted either.
+    if (!base_rowset_exist || num_rowsets == 0 ||
+        !_is_window_closed(total_size, num_rowsets, oldest_creation_time)) {
+        *score = 0;
+    }
+}
+
+bool TimeSeriesCumulativeCompactionPolicy::need_base_compaction(const Tablet* tablet) {
+    return tablet->version_count() > config::max_tablet_version_num / 2;
+}
+
 void CumulativeCompactionPolicy::pick_candidate_rowsets(
         int64_t skip_window_sec,
         const std::unordered_map<Version, RowsetSharedPtr, HashOfVersion>& rs_version_map,
@@ -446,6 +619,9 @@ CumulativeCompactionPolicyFactory::create_cumulative_compaction_policy(std::stri
     } else if (policy_type == SIZE_BASED_POLICY) {
         return std::unique_ptr<CumulativeCompactionPolicy>(
                 new SizeBasedCumulativeCompactionPolicy());
+    } else if (policy_type == TIME_SERIES_POLICY) {
+        return std::unique_ptr<CumulativeCompactionPolicy>(
+                new TimeSeriesCumulativeCompactionPolicy());
     }
 
     return std::unique_ptr<CumulativeCompactionPolicy>(new NumBasedCumulativeCompactionPolicy());
@@ -458,6 +634,8 @@ void CumulativeCompactionPolicyFactory::_parse_cumulative_compaction_policy(
         *policy_type = NUM_BASED_POLICY;
     } else if (type == CUMULATIVE_SIZE_BASED_POLICY) {
         *policy_type = SIZE_BASED_POLICY;
+    } else if (type == CUMULATIVE_TIME_SERIES_POLICY) {
+        *policy_type = TIME_SERIES_POLICY;
     } else {
         LOG(WARNING) << "parse cumulative compaction policy error " << type << ", default use "
                      << CUMULATIVE_NUM_BASED_POLICY;
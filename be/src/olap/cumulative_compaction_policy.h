@@ -31,16 +31,19 @@ namespace doris {
 class Tablet;
 
 /// This CompactionPolicy enum is used to represent the type of compaction policy.
-/// Now it has two values, NUM_BASED_POLICY and SIZE_BASED_POLICY.
+/// Now it has three values, NUM_BASED_POLICY, SIZE_BASED_POLICY and TIME_SERIES_POLICY.
 /// NUM_BASED_POLICY means current compaction policy implemented by num based policy.
 /// SIZE_BASED_POLICY means current compaction policy implemented by size_based policy.
+/// TIME_SERIES_POLICY means current compaction policy implemented by time_series policy.
 enum CompactionPolicy {
     NUM_BASED_POLICY = 0,
     SIZE_BASED_POLICY = 1,
+    TIME_SERIES_POLICY = 2,
 };
 
 const static std::string CUMULATIVE_NUM_BASED_POLICY = "NUM_BASED";
 const static std::string CUMULATIVE_SIZE_BASED_POLICY = "SIZE_BASED";
+const static std::string CUMULATIVE_TIME_SERIES_POLICY = "TIME_SERIES";
 /// This class CumulativeCompactionPolicy is the base class of cumulative compaction policy.
 /// It defines the policy to do cumulative compaction. It has different derived classes, which implements
 /// concrete cumulative compaction algorithm. The policy is configured by conf::cumulative_compaction_policy.
@@ -114,6 +117,11 @@ public:
                                             int64_t current_cumulative_point,
                                             int64_t* cumulative_point) = 0;
 
+    /// Whether the rowsets before the cumulative point are merged by base compaction. The policies whose
+    /// cumulative compaction output is final can skip base compaction, which merges the same data again.
+    /// param tablet, the tablet to do base compaction
+    virtual bool need_base_compaction(const Tablet* tablet) { return true; }
+
     /// Fetch cumulative policy name
     virtual std::string name() = 0;
 };
@@ -243,11 +251,79 @@ private:
     std::vector<int64_t> _levels;
 };
 
+/// TimeSeries cumulative compaction policy implemention. TimeSeries policy which derives CumulativeCompactionPolicy is
+/// for the tablets of append-only time series data, whose loads arrive in time order and hardly overlap with older data.
+/// The rowsets after the cumulative point form a window, which is compacted once it reaches the goal size, has enough
+/// rowsets, or stays open for long. The output rowset is final, the cumulative point moves after it, and it is never
+/// compacted again, neither by cumulative compaction nor by base compaction unless the tablet has too many versions.
+class TimeSeriesCumulativeCompactionPolicy final : public CumulativeCompactionPolicy {
+public:
+    /// Constructor function of TimeSeriesCumulativeCompactionPolicy.
+    /// param goal_size, the total disk size of a window to compact, unit is byte.
+    /// param file_count_threshold, the number of rowsets of a window to compact.
+    /// param time_threshold_sec, the seconds since the oldest rowset of a window was created to compact it.
+    TimeSeriesCumulativeCompactionPolicy(
+            int64_t goal_size = config::time_series_compaction_goal_size_mbytes * 1024 * 1024,
+            int64_t file_count_threshold = config::time_series_compaction_file_count_threshold,
+            int64_t time_threshold_sec = config::time_series_compaction_time_threshold_seconds);
+
+    /// Destructor function of TimeSeriesCumulativeCompactionPolicy.
+    ~TimeSeriesCumulativeCompactionPolicy() {}
+
+    /// TimeSeries cumulative compaction policy implements calculate cumulative point function.
+    /// Like num based policy, it finds the first rowset which is segments_overlapping or singleton, the rowsets
+    /// before it are the final outputs of compaction.
+    void calculate_cumulative_point(Tablet* tablet,
+                                    const std::vector<RowsetMetaSharedPtr>& all_rowsets,
+                                    int64_t current_cumulative_point,
+                                    int64_t* cumulative_point) override;
+
+    /// TimeSeries cumulative compaction policy implements pick input rowsets function.
+    /// Its main policy is picking rowsets in version order until the window reaches the goal size, the file count
+    /// threshold or max_compaction_score, and picking nothing if the window is not closed yet. A non-overlapping
+    /// rowset of the goal size at the start of the window is final as it is, the cumulative point moves after it.
+    int pick_input_rowsets(Tablet* tablet, const std::vector<RowsetSharedPtr>& candidate_rowsets,
+                           const int64_t max_compaction_score, const int64_t min_compaction_score,
+                           std::vector<RowsetSharedPtr>* input_rowsets,
+                           Version* last_delete_version, size_t* compaction_score) override;
+
+    /// TimeSeries cumulative compaction policy implements update cumulative point function.
+    /// The output rowset is always final, so the cumulative point moves after it.
+    void update_cumulative_point(Tablet* tablet, const std::vector<RowsetSharedPtr>& input_rowsets,
+                                 RowsetSharedPtr _output_rowset,
+                                 Version& last_delete_version) override;
+
+    /// TimeSeries cumulative compaction policy implements calc cumulative compaction score function.
+    /// Its main policy is calculating the accumulative compaction score after current cumulative_point in tablet,
+    /// which is zero until the window is closed.
+    void calc_cumulative_compaction_score(const std::vector<RowsetMetaSharedPtr>& all_rowsets,
+                                          int64_t current_cumulative_point,
+                                          uint32_t* score) override;
+
+    /// The outputs of time series policy are merged by base compaction only if the tablet has more than half of
+    /// max_tablet_version_num versions.
+    bool need_base_compaction(const Tablet* tablet) override;
+
+    std::string name() { return CUMULATIVE_TIME_SERIES_POLICY; }
+
+private:
+    /// whether a window of these rowsets is closed and can be compacted
+    bool _is_window_closed(int64_t total_size, int64_t num_rowsets, int64_t oldest_creation_time);
+
+private:
+    /// the total disk size of a window to compact, unit is byte.
+    int64_t _goal_size;
+    /// the number of rowsets of a window to compact.
+    int64_t _file_count_threshold;
+    /// the seconds since the oldest rowset of a window was created to compact it.
+    int64_t _time_threshold_sec;
+};
+
 /// The factory of CumulativeCompactionPolicy, it can product different policy according to the `policy` parameter.
 class CumulativeCompactionPolicyFactory {
 public:
     /// Static factory function. It can product different policy according to the `policy` parameter and use tablet ptr
-    /// to construct the policy. Now it can product size based and num based policies.
+    /// to construct the policy. Now it can product size based, num based and time series policies.
     static std::unique_ptr<CumulativeCompactionPolicy> create_cumulative_compaction_policy(
             std::string policy);
 
@@ -30,12 +30,17 @@
 #include <boost/algorithm/string/trim.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/interprocess/sync/file_lock.hpp>
+#include <algorithm>
+#include <atomic>
 #include <fstream>
+#include <functional>
 #include <set>
 #include <sstream>
+#include <unordered_map>
 
 #include "env/env.h"
 #include "gutil/strings/substitute.h"
+#include "common/config.h"
 #include "olap/file_helper.h"
 #include "olap/olap_define.h"
 #include "olap/olap_snapshot_converter.h"
@@ -47,9 +52,12 @@
 #include "olap/utils.h" // for check_dir_existed
 #include "service/backend_options.h"
 #include "util/errno.h"
+#include "util/doris_metrics.h"
 #include "util/file_utils.h"
 #include "util/monotime.h"
+#include "util/stopwatch.hpp"
 #include "util/string_util.h"
+#include "util/threadpool.h"
 
 using strings::Substitute;
 
@@ -61,6 +69,11 @@ DEFINE_GAUGE_METRIC_PROTOTYPE_2ARG(disks_data_used_capacity, MetricUnit::BYTES);
 DEFINE_GAUGE_METRIC_PROTOTYPE_2ARG(disks_state, MetricUnit::BYTES);
 DEFINE_GAUGE_METRIC_PROTOTYPE_2ARG(disks_compaction_score, MetricUnit::NOUNIT);
 DEFINE_GAUGE_METRIC_PROTOTYPE_2ARG(disks_compaction_num, MetricUnit::NOUNIT);
+DEFINE_HISTOGRAM_METRIC_PROTOTYPE_2ARG(disks_read_latency_us, MetricUnit::MICROSECONDS);
+DEFINE_HISTOGRAM_METRIC_PROTOTYPE_2ARG(disks_write_latency_us, MetricUnit::MICROSECONDS);
+DEFINE_GAUGE_METRIC_PROTOTYPE_2ARG(disks_recent_read_latency_p99_us, MetricUnit::MICROSECONDS);
+DEFINE_GAUGE_METRIC_PROTOTYPE_2ARG(disks_recent_write_latency_p99_us, MetricUnit::MICROSECONDS);
+DEFINE_GAUGE_METRIC_PROTOTYPE_2ARG(disks_slow, MetricUnit::NOUNIT);
 
 static const char* const kMtabPath = "/etc/mtab";
 static const char* const kTestFilePath = "/.testfile";
@@ -88,6 +101,13 @@ DataDir::DataDir(const std::string& path, int64_t capacity_bytes,
     INT_GAUGE_METRIC_REGISTER(_data_dir_metric_entity, disks_state);
     INT_GAUGE_METRIC_REGISTER(_data_dir_metric_entity, disks_compaction_score);
     INT_GAUGE_METRIC_REGISTER(_data_dir_metric_entity, disks_compaction_num);
+    HISTOGRAM_METRIC_REGISTER(_data_dir_metric_entity, disks_read_latency_us);
+    HISTOGRAM_METRIC_REGISTER(_data_dir_metric_entity, disks_write_latency_us);
+    INT_GAUGE_METRIC_REGISTER(_data_dir_metric_entity, disks_recent_read_latency_p99_us);
+    INT_GAUGE_METRIC_REGISTER(_data_dir_metric_entity, disks_recent_write_latency_p99_us);
+    INT_GAUGE_METRIC_REGISTER(_data_dir_metric_entity, disks_slow);
+    _last_read_latency_counts.resize(HistogramMetric::NUM_BUCKETS, 0);
+    _last_write_latency_counts.resize(HistogramMetric::NUM_BUCKETS, 0);
 }
 
 DataDir::~DataDir() {
@@ -316,14 +336,56 @@ void DataDir::health_check() {
     // check disk
     if (_is_used) {
         OLAPStatus res = OLAP_SUCCESS;
+        MonotonicStopWatch watch;
+        watch.start();
         if ((res = _read_and_write_test_file()) != OLAP_SUCCESS) {
             LOG(WARNING) << "store read/write test file occur IO Error. path=" << _path;
             if (is_io_error(res)) {
                 _is_used = false;
             }
         }
+        // the test file is written with O_DIRECT, so it's a write to the disk
+        add_write_latency(watch.elapsed_time() / 1000);
     }
     disks_state->set_value(_is_used ? 1 : 0);
+
+    int64_t read_p99 = _recent_p99_latency(disks_read_latency_us, &_last_read_latency_counts);
+    int64_t write_p99 =
+            _recent_p99_latency(disks_write_latency_us, &_last_write_latency_counts);
+    disks_recent_read_latency_p99_us->set_value(std::max<int64_t>(read_p99, 0));
+    disks_recent_write_latency_p99_us->set_value(std::max<int64_t>(write_p99, 0));
+    int64_t threshold_us = config::slow_disk_latency_threshold_ms * 1000L;
+    if (threshold_us <= 0) {
+        _is_slow = false;
+    } else if (read_p99 >= 0 || write_p99 >= 0) {
+        // keep the judgement if there are too few reads and writes to judge
+        bool is_slow = std::max(read_p99, write_p99) > threshold_us;
+        if (is_slow != _is_slow) {
+            LOG(WARNING) << "store is " << (is_slow ? "slow" : "no longer slow")
+                         << ". path=" << _path << ", recent p99 read latency(us)=" << read_p99
+                         << ", recent p99 write latency(us)=" << write_p99;
+            _is_slow = is_slow;
+        }
+    }
+    disks_slow->set_value(_is_slow ? 1 : 0);
+}
+
+int64_t DataDir::_recent_p99_latency(const HistogramMetric* histogram,
+                                     std::vector<int64_t>* last_counts) {
+    int64_t counts[HistogramMetric::NUM_BUCKETS];
+    histogram->get_counts(counts);
+    int64_t recent_counts[HistogramMetric::NUM_BUCKETS];
+    int64_t num = 0;
+    for (int i = 0; i < HistogramMetric::NUM_BUCKETS; ++i) {
+        recent_counts[i] = counts[i] - (*last_counts)[i];
+        num += recent_counts[i];
+    }
+    if (num < config::slow_disk_min_latency_samples) {
+        // wait for more values
+        return -1;
+    }
+    last_counts->assign(counts, counts + HistogramMetric::NUM_BUCKETS);
+    return HistogramMetric::percentile_of_counts(recent_counts, 99);
 }
 
 OLAPStatus DataDir::_read_and_write_test_file() {
@@ -678,32 +740,67 @@ OLAPStatus DataDir::load() {
     }
 
     // load tablet
-    // create tablet from tablet meta and add it to tablet mgr
+    // create tablet from tablet meta and add it to tablet mgr, tablets are loaded in parallel
     LOG(INFO) << "begin loading tablet from meta";
+    std::unique_ptr<ThreadPool> load_pool;
+    Status st = ThreadPoolBuilder("LoadTabletThreadPool")
+                        .set_min_threads(1)
+                        .set_max_threads(std::max(1, config::load_tablet_thread_num_per_data_dir))
+                        .build(&load_pool);
+    if (!st.ok()) {
+        LOG(WARNING) << "fail to create thread pool to load tablets, load them serially. "
+                     << "error=" << st.to_string();
+    }
+    // run the task in the pool, or in this thread if it can't be submitted
+    auto run_load_task = [&load_pool](const std::function<void()>& task) {
+        if (load_pool == nullptr || !load_pool->submit_func(task).ok()) {
+            task();
+        }
+    };
+
+    std::mutex tablet_ids_lock;
     std::set<int64_t> tablet_ids;
     std::set<int64_t> failed_tablet_ids;
-    auto load_tablet_func = [this, &tablet_ids, &failed_tablet_ids](
+    std::atomic<int64_t> num_finished_tablets(0);
+    auto load_tablet_func = [this, &run_load_task, &tablet_ids_lock, &tablet_ids,
+                             &failed_tablet_ids, &num_finished_tablets](
                                     int64_t tablet_id, int32_t schema_hash,
                                     const std::string& value) -> bool {
-        OLAPStatus status = _tablet_manager->load_tablet_from_meta(this, tablet_id, schema_hash,
-                                                                   value, false, false);
-        if (status != OLAP_SUCCESS && status != OLAP_ERR_TABLE_ALREADY_DELETED_ERROR) {
-            // load_tablet_from_meta() may return OLAP_ERR_TABLE_ALREADY_DELETED_ERROR
-            // which means the tablet status is DELETED
-            // This may happen when the tablet was just deleted before the BE restarted,
-            // but it has not been cleared from rocksdb. At this time, restarting the BE
-            // will read the tablet in the DELETE state from rocksdb. These tablets have been
-            // added to the garbage collection queue and will be automatically deleted afterwards.
-            // Therefore, we believe that this situation is not a failure.
-            LOG(WARNING) << "load tablet from header failed. status:" << status
-                         << ", tablet=" << tablet_id << "." << schema_hash;
-            failed_tablet_ids.insert(tablet_id);
-        } else {
-            tablet_ids.insert(tablet_id);
-        }
+        DorisMetrics::instance()->startup_tablets_total->increment(1);
+        // the value is only valid during this call
+        std::string meta_str = value;
+        run_load_task([this, tablet_id, schema_hash, meta_str, &tablet_ids_lock, &tablet_ids,
+                       &failed_tablet_ids, &num_finished_tablets]() {
+            OLAPStatus status = _tablet_manager->load_tablet_from_meta(
+                    this, tablet_id, schema_hash, meta_str, false, false);
+            if (status != OLAP_SUCCESS && status != OLAP_ERR_TABLE_ALREADY_DELETED_ERROR) {
+                // load_tablet_from_meta() may return OLAP_ERR_TABLE_ALREADY_DELETED_ERROR
+                // which means the tablet status is DELETED
+                // This may happen when the tablet was just deleted before the BE restarted,
+                // but it has not been cleared from rocksdb. At this time, restarting the BE
+                // will read the tablet in the DELETE state from rocksdb. These tablets have been
+                // added to the garbage collection queue and will be automatically deleted afterwards.
+                // Therefore, we believe that this situation is not a failure.
+                LOG(WARNING) << "load tablet from header failed. status:" << status
+                             << ", tablet=" << tablet_id << "." << schema_hash;
+                std::lock_guard<std::mutex> l(tablet_ids_lock);
+                failed_tablet_ids.insert(tablet_id);
+            } else {
+                std::lock_guard<std::mutex> l(tablet_ids_lock);
+                tablet_ids.insert(tablet_id);
+            }
+            DorisMetrics::instance()->startup_loaded_tablets_total->increment(1);
+            int64_t num_finished = ++num_finished_tablets;
+            if (num_finished % 10000 == 0) {
+                LOG(INFO) << "loaded " << num_finished << " tablets from meta, path: " << _path;
+            }
+        });
         return true;
     };
     OLAPStatus load_tablet_status = TabletMetaManager::traverse_headers(_meta, load_tablet_func);
+    if (load_pool != nullptr) {
+        load_pool->wait();
+    }
     if (failed_tablet_ids.size() != 0) {
         LOG(WARNING) << "load tablets from header failed"
                      << ", loaded tablet: " << tablet_ids.size()
@@ -726,64 +823,84 @@ OLAPStatus DataDir::load() {
     // 1. add committed rowset to txn map
     // 2. add visible rowset to tablet
     // ignore any errors when load tablet or rowset, because fe will repair them after report
-    for (auto rowset_meta : dir_rowset_metas) {
-        TabletSharedPtr tablet = _tablet_manager->get_tablet(rowset_meta->tablet_id(),
-                                                             rowset_meta->tablet_schema_hash());
-        // tablet maybe dropped, but not drop related rowset meta
-        if (tablet == nullptr) {
-            LOG(WARNING) << "could not find tablet id: " << rowset_meta->tablet_id()
-                         << ", schema hash: " << rowset_meta->tablet_schema_hash()
-                         << ", for rowset: " << rowset_meta->rowset_id() << ", skip this rowset";
-            continue;
-        }
-        RowsetSharedPtr rowset;
-        OLAPStatus create_status = RowsetFactory::create_rowset(
-                &tablet->tablet_schema(), tablet->tablet_path(), rowset_meta, &rowset);
-        if (create_status != OLAP_SUCCESS) {
-            LOG(WARNING) << "could not create rowset from rowsetmeta: "
-                         << " rowset_id: " << rowset_meta->rowset_id()
-                         << " rowset_type: " << rowset_meta->rowset_type()
-                         << " rowset_state: " << rowset_meta->rowset_state();
-            continue;
-        }
-        if (rowset_meta->rowset_state() == RowsetStatePB::COMMITTED &&
-            rowset_meta->tablet_uid() == tablet->tablet_uid()) {
-            OLAPStatus commit_txn_status = _txn_manager->commit_txn(
-                    _meta, rowset_meta->partition_id(), rowset_meta->txn_id(),
-                    rowset_meta->tablet_id(), rowset_meta->tablet_schema_hash(),
-                    rowset_meta->tablet_uid(), rowset_meta->load_id(), rowset, true);
-            if (commit_txn_status != OLAP_SUCCESS &&
-                commit_txn_status != OLAP_ERR_PUSH_TRANSACTION_ALREADY_EXIST) {
-                LOG(WARNING) << "failed to add committed rowset: " << rowset_meta->rowset_id()
-                             << " to tablet: " << rowset_meta->tablet_id()
-                             << " for txn: " << rowset_meta->txn_id();
-            } else {
-                LOG(INFO) << "successfully to add committed rowset: " << rowset_meta->rowset_id()
-                          << " to tablet: " << rowset_meta->tablet_id()
-                          << " schema hash: " << rowset_meta->tablet_schema_hash()
-                          << " for txn: " << rowset_meta->txn_id();
-            }
-        } else if (rowset_meta->rowset_state() == RowsetStatePB::VISIBLE &&
-                   rowset_meta->tablet_uid() == tablet->tablet_uid()) {
-            OLAPStatus publish_status = tablet->add_rowset(rowset, false);
-            if (publish_status != OLAP_SUCCESS &&
-                publish_status != OLAP_ERR_PUSH_VERSION_ALREADY_EXIST) {
-                LOG(WARNING) << "add visible rowset to tablet failed rowset_id:"
-                             << rowset->rowset_id() << " tablet id: " << rowset_meta->tablet_id()
-                             << " txn id:" << rowset_meta->txn_id()
-                             << " start_version: " << rowset_meta->version().first
-                             << " end_version: " << rowset_meta->version().second;
+    // Rowsets of different tablets are added in parallel. Segments of rowsets are not
+    // opened here but on their first access.
+    std::unordered_map<int64_t, std::vector<RowsetMetaSharedPtr>> tablet_rowset_metas;
+    for (auto& rowset_meta : dir_rowset_metas) {
+        tablet_rowset_metas[rowset_meta->tablet_id()].push_back(rowset_meta);
+    }
+    for (auto& it : tablet_rowset_metas) {
+        const std::vector<RowsetMetaSharedPtr>& rowset_metas = it.second;
+        run_load_task([this, &rowset_metas]() {
+            for (auto& rowset_meta : rowset_metas) {
+                _load_rowset(rowset_meta);
             }
+        });
+    }
+    if (load_pool != nullptr) {
+        load_pool->wait();
+        load_pool->shutdown();
+    }
+    LOG(INFO) << "load rowsets finished, path: " << _path;
+    return OLAP_SUCCESS;
+}
+
+void DataDir::_load_rowset(const RowsetMetaSharedPtr& rowset_meta) {
+    TabletSharedPtr tablet = _tablet_manager->get_tablet(rowset_meta->tablet_id(),
+                                                         rowset_meta->tablet_schema_hash());
+    // tablet maybe dropped, but not drop related rowset meta
+    if (tablet == nullptr) {
+        LOG(WARNING) << "could not find tablet id: " << rowset_meta->tablet_id()
+                     << ", schema hash: " << rowset_meta->tablet_schema_hash()
+                     << ", for rowset: " << rowset_meta->rowset_id() << ", skip this rowset";
+        return;
+    }
+    RowsetSharedPtr rowset;
+    OLAPStatus create_status = RowsetFactory::create_rowset(
+            &tablet->tablet_schema(), tablet->tablet_path(), rowset_meta, &rowset);
+    if (create_status != OLAP_SUCCESS) {
+        LOG(WARNING) << "could not create rowset from rowsetmeta: "
+                     << " rowset_id: " << rowset_meta->rowset_id()
+                     << " rowset_type: " << rowset_meta->rowset_type()
+                     << " rowset_state: " << rowset_meta->rowset_state();
+        return;
+    }
+    if (rowset_meta->rowset_state() == RowsetStatePB::COMMITTED &&
+        rowset_meta->tablet_uid() == tablet->tablet_uid()) {
+        OLAPStatus commit_txn_status = _txn_manager->commit_txn(
+                _meta, rowset_meta->partition_id(), rowset_meta->txn_id(),
+                rowset_meta->tablet_id(), rowset_meta->tablet_schema_hash(),
+                rowset_meta->tablet_uid(), rowset_meta->load_id(), rowset, true);
+        if (commit_txn_status != OLAP_SUCCESS &&
+            commit_txn_status != OLAP_ERR_PUSH_TRANSACTION_ALREADY_EXIST) {
+            LOG(WARNING) << "failed to add committed rowset: " << rowset_meta->rowset_id()
+                         << " to tablet: " << rowset_meta->tablet_id()
+                         << " for txn: " << rowset_meta->txn_id();
         } else {
-            LOG(WARNING) << "find invalid rowset: " << rowset_meta->rowset_id()
-                         << " with tablet id: " << rowset_meta->tablet_id()
-                         << " tablet uid: " << rowset_meta->tablet_uid()
-                         << " schema hash: " << rowset_meta->tablet_schema_hash()
-                         << " txn: " << rowset_meta->txn_id()
-                         << " current valid tablet uid: " << tablet->tablet_uid();
+            LOG(INFO) << "successfully to add committed rowset: " << rowset_meta->rowset_id()
+                      << " to tablet: " << rowset_meta->tablet_id()
+                      << " schema hash: " << rowset_meta->tablet_schema_hash()
+                      << " for txn: " << rowset_meta->txn_id();
+        }
+    } else if (rowset_meta->rowset_state() == RowsetStatePB::VISIBLE &&
+               rowset_meta->tablet_uid() == tablet->tablet_uid()) {
+        OLAPStatus publish_status = tablet->add_rowset(rowset, false);
+        if (publish_status != OLAP_SUCCESS &&
+            publish_status != OLAP_ERR_PUSH_VERSION_ALREADY_EXIST) {
+            LOG(WARNING) << "add visible rowset to tablet failed rowset_id:"
+                         << rowset->rowset_id() << " tablet id: " << rowset_meta->tablet_id()
+                         << " txn id:" << rowset_meta->txn_id()
+                         << " start_version: " << rowset_meta->version().first
+                         << " end_version: " << rowset_meta->version().second;
         }
+    } else {
+        LOG(WARNING) << "find invalid rowset: " << rowset_meta->rowset_id()
+                     << " with tablet id: " << rowset_meta->tablet_id()
+                     << " tablet uid: " << rowset_meta->tablet_uid()
+                     << " schema hash: " << rowset_meta->tablet_schema_hash()
+                     << " txn: " << rowset_meta->txn_id()
+                     << " current valid tablet uid: " << tablet->tablet_uid();
     }
-    return OLAP_SUCCESS;
 }
 
 void DataDir::add_pending_ids(const std::string& id) {
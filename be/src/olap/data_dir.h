@@ -17,17 +17,20 @@
 
 #pragma once
 
+#include <atomic>
 #include <condition_variable>
 #include <cstdint>
 #include <mutex>
 #include <set>
 #include <string>
+#include <vector>
 
 #include "common/status.h"
 #include "gen_cpp/Types_types.h"
 #include "gen_cpp/olap_file.pb.h"
 #include "olap/olap_common.h"
 #include "olap/rowset/rowset_id_generator.h"
+#include "olap/rowset/rowset_meta.h"
 #include "util/metrics.h"
 #include "util/mutex.h"
 
@@ -71,8 +74,16 @@ public:
     // invalid be config for example two be use the same
     // data path
     Status set_cluster_id(int32_t cluster_id);
+    // Tests the disk, and judges whether it's slow by the latencies since the last check.
     void health_check();
 
+    // Record the latency of a read or write of the disk in microseconds
+    void add_read_latency(int64_t latency_us) { disks_read_latency_us->add(latency_us); }
+    void add_write_latency(int64_t latency_us) { disks_write_latency_us->add(latency_us); }
+    // Whether the p99 latency of the reads or writes exceeds
+    // config::slow_disk_latency_threshold_ms at the last health check
+    bool is_slow() const { return _is_slow; }
+
     OLAPStatus get_shard(uint64_t* shard);
 
     OlapMeta* get_meta() { return _meta; }
@@ -141,6 +152,11 @@ private:
 
     Status _check_disk();
     OLAPStatus _read_and_write_test_file();
+    // Returns the p99 latency of the values added to 'histogram' since 'last_counts', and
+    // updates 'last_counts'. -1 if there are less than config::slow_disk_min_latency_samples
+    // such values, and 'last_counts' is kept.
+    int64_t _recent_p99_latency(const HistogramMetric* histogram,
+                                std::vector<int64_t>* last_counts);
     Status _read_cluster_id(const std::string& cluster_id_path, int32_t* cluster_id);
     Status _write_cluster_id_to_path(const std::string& path, int32_t cluster_id);
     OLAPStatus _clean_unfinished_converting_data();
@@ -150,6 +166,9 @@ private:
     // process will log fatal.
     OLAPStatus _check_incompatible_old_format_tablet();
 
+    // Add a rowset loaded from meta to its tablet, or to the txn manager if it's committed.
+    void _load_rowset(const RowsetMetaSharedPtr& rowset_meta);
+
     void _process_garbage_path(const std::string& path);
 
     void _remove_check_paths(const std::set<std::string>& paths);
@@ -207,6 +226,16 @@ private:
     IntGauge* disks_state;
     IntGauge* disks_compaction_score;
     IntGauge* disks_compaction_num;
+    HistogramMetric* disks_read_latency_us;
+    HistogramMetric* disks_write_latency_us;
+    IntGauge* disks_recent_read_latency_p99_us;
+    IntGauge* disks_recent_write_latency_p99_us;
+    IntGauge* disks_slow;
+
+    // the counts of the latency histograms at the last health check
+    std::vector<int64_t> _last_read_latency_counts;
+    std::vector<int64_t> _last_write_latency_counts;
+    std::atomic<bool> _is_slow {false};
 };
 
 } // namespace doris
@@ -237,6 +237,10 @@ OLAPStatus DeleteHandler::init(const TabletSchema& schema,
         if (it->version() > version) {
             continue;
         }
+        // the rows deleted are skipped by the delete bitmap of the tablet
+        if (it->by_bitmap()) {
+            continue;
+        }
 
         DeleteConditions temp;
         temp.filter_version = it->version();
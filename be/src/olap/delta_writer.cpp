@@ -157,11 +157,14 @@ OLAPStatus DeltaWriter::init() {
         writer_context.rowset_type = ALPHA_ROWSET;
     }
     writer_context.rowset_path_prefix = _tablet->tablet_path();
+    writer_context.data_dir = _tablet->data_dir();
+    writer_context.direct_io = config::segment_write_direct_io;
     writer_context.tablet_schema = &(_tablet->tablet_schema());
     writer_context.rowset_state = PREPARED;
     writer_context.txn_id = _req.txn_id;
     writer_context.load_id = _req.load_id;
     writer_context.segments_overlap = OVERLAPPING;
+    writer_context.partial_columns = _req.partial_columns;
     RETURN_NOT_OK(RowsetFactory::create_rowset_writer(writer_context, &_rowset_writer));
 
     _tablet_schema = &(_tablet->tablet_schema());
@@ -169,7 +172,8 @@ OLAPStatus DeltaWriter::init() {
     _reset_mem_table();
 
     // create flush handler
-    RETURN_NOT_OK(_storage_engine->memtable_flush_executor()->create_flush_token(&_flush_token));
+    RETURN_NOT_OK(_storage_engine->memtable_flush_executor()->create_flush_token(
+            &_flush_token, _rowset_writer->support_concurrent_flush()));
 
     _is_init = true;
     return OLAP_SUCCESS;
@@ -193,6 +197,14 @@ OLAPStatus DeltaWriter::write(Tuple* tuple) {
 }
 
 OLAPStatus DeltaWriter::_flush_memtable_async() {
+    if (_flush_token->is_concurrent()) {
+        // every reserved segment must be written, so don't reserve one for nothing
+        if (_mem_table->empty()) {
+            return OLAP_SUCCESS;
+        }
+        // reserve in the order memtables are generated, though they may finish in any order
+        _mem_table->set_segment_id(_rowset_writer->reserve_segment());
+    }
     return _flush_token->submit(_mem_table);
 }
 
@@ -213,10 +225,30 @@ OLAPStatus DeltaWriter::flush_memtable_and_wait() {
     return OLAP_SUCCESS;
 }
 
+OLAPStatus DeltaWriter::flush_memtable() {
+    if (_mem_table == nullptr || _mem_table->empty()) {
+        return OLAP_SUCCESS;
+    }
+    VLOG(3) << "flush memtable to reduce mem consumption. memtable size: "
+            << _mem_table->memory_usage() << ", tablet: " << _req.tablet_id
+            << ", load id: " << print_id(_req.load_id);
+    RETURN_NOT_OK(_flush_memtable_async());
+    _reset_mem_table();
+    return OLAP_SUCCESS;
+}
+
+OLAPStatus DeltaWriter::wait_flush() {
+    if (_flush_token == nullptr) {
+        return OLAP_SUCCESS;
+    }
+    return _flush_token->wait();
+}
+
 void DeltaWriter::_reset_mem_table() {
     _mem_table.reset(new MemTable(_tablet->tablet_id(), _schema.get(), _tablet_schema, _req.slots,
                                   _req.tuple_desc, _tablet->keys_type(), _rowset_writer.get(),
                                   _mem_tracker));
+    _mem_table->set_partial_columns(_req.partial_columns);
 }
 
 OLAPStatus DeltaWriter::close() {
@@ -239,6 +271,7 @@ OLAPStatus DeltaWriter::close_wait(google::protobuf::RepeatedPtrField<PTabletInf
             << "delta writer is supposed be to initialized before close_wait() being called";
     // return error if previous flush failed
     RETURN_NOT_OK(_flush_token->wait());
+    _mem_tracker->FlushConsumptionCaches();
     DCHECK_EQ(_mem_tracker->consumption(), 0);
 
     // use rowset meta manager to save meta
@@ -303,6 +336,7 @@ OLAPStatus DeltaWriter::cancel() {
         // cancel and wait all memtables in flush queue to be finished
         _flush_token->cancel();
     }
+    _mem_tracker->FlushConsumptionCaches();
     DCHECK_EQ(_mem_tracker->consumption(), 0);
     return OLAP_SUCCESS;
 }
@@ -311,6 +345,10 @@ int64_t DeltaWriter::mem_consumption() const {
     return _mem_tracker->consumption();
 }
 
+int64_t DeltaWriter::memtable_consumption() const {
+    return _mem_table == nullptr ? 0 : _mem_table->memory_usage();
+}
+
 int64_t DeltaWriter::partition_id() const {
     return _req.partition_id;
 }
@@ -46,6 +46,9 @@ struct WriteRequest {
     TupleDescriptor* tuple_desc;
     // slots are in order of tablet's schema
     const std::vector<SlotDescriptor*>* slots;
+    // the rows only have the values of some columns of a unique key table,
+    // the others are null and read from the older versions
+    bool partial_columns = false;
 };
 
 // Writer for a particular (load, index, tablet).
@@ -75,10 +78,19 @@ public:
     // This is currently for reducing mem consumption of this delta writer.
     OLAPStatus flush_memtable_and_wait();
 
+    // submit current memtable to flush queue without waiting, no-op if it is empty.
+    OLAPStatus flush_memtable();
+
+    // wait all memtables in flush queue to be flushed.
+    OLAPStatus wait_flush();
+
     int64_t partition_id() const;
 
     int64_t mem_consumption() const;
 
+    // memory consumed by the memtable being written, those in flush queue are not included.
+    int64_t memtable_consumption() const;
+
 private:
     DeltaWriter(WriteRequest* req, const std::shared_ptr<MemTracker>& parent,
                 StorageEngine* storage_engine);
@@ -172,6 +172,8 @@ public:
 struct CreateBlockOptions {
     // const std::string tablet_id;
     const std::string path;
+    // write the block with O_DIRECT, see WritableFileOptions::direct_io
+    bool direct_io;
 };
 
 // Block manager creation options.
@@ -231,6 +233,11 @@ public:
     // Does not modify 'block' on error.
     virtual Status open_block(const std::string& path, std::unique_ptr<ReadableBlock>* block) = 0;
 
+    // Like open_block() above, and sets 'opened' to whether the file was opened rather
+    // than found in the file cache.
+    virtual Status open_block(const std::string& path, std::unique_ptr<ReadableBlock>* block,
+                              bool* opened) = 0;
+
     // Retrieves the IDs of all blocks under management by this block manager.
     // These include ReadableBlocks as well as WritableBlocks.
     //
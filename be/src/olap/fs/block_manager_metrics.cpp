@@ -34,6 +34,9 @@ BlockManagerMetrics::BlockManagerMetrics() {
     total_bytes_read = DorisMetrics::instance()->bytes_read_total;
     total_bytes_written = DorisMetrics::instance()->bytes_written_total;
     total_disk_sync = DorisMetrics::instance()->disk_sync_total;
+    total_file_cache_hits = DorisMetrics::instance()->block_file_cache_hit_total;
+    total_file_opens = DorisMetrics::instance()->block_file_open_total;
+    total_file_open_duration_us = DorisMetrics::instance()->block_file_open_duration_us;
 }
 
 } // namespace internal
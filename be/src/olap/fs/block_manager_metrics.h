@@ -47,6 +47,12 @@ struct BlockManagerMetrics {
     IntCounter* total_bytes_written;
     // Number of disk synchronizations of block data since service start
     IntCounter* total_disk_sync;
+    // Number of readable blocks whose file is found in the file cache since service start
+    IntCounter* total_file_cache_hits;
+    // Number of files opened for readable blocks since service start
+    IntCounter* total_file_opens;
+    // Total time in microseconds spent on opening files for readable blocks
+    IntCounter* total_file_open_duration_us;
 };
 
 } // namespace internal
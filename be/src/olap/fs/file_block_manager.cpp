@@ -31,6 +31,7 @@
 #include "gutil/strings/substitute.h"
 #include "olap/fs/block_id.h"
 #include "olap/fs/block_manager_metrics.h"
+#include "olap/fs/ssd_block_cache.h"
 #include "olap/storage_engine.h"
 #include "runtime/mem_tracker.h"
 #include "util/doris_metrics.h"
@@ -38,6 +39,7 @@
 #include "util/metrics.h"
 #include "util/path_util.h"
 #include "util/slice.h"
+#include "util/time.h"
 
 using std::accumulate;
 using std::shared_ptr;
@@ -235,6 +237,14 @@ Status FileWritableBlock::_close(SyncMode mode) {
     RETURN_IF_ERROR(close);
     RETURN_IF_ERROR(sync);
 
+    // newly written files are likely to be read soon, write them through the ssd cache
+    SsdBlockCache* ssd_cache = SsdBlockCache::instance();
+    if (config::ssd_cache_write_through && ssd_cache != nullptr &&
+        ssd_cache->is_cached_file(_path)) {
+        WARN_IF_ERROR(ssd_cache->insert_file(_path),
+                      strings::Substitute("Failed to write block $0 through ssd cache", _path));
+    }
+
     // Prefer the result of Close() to that of Sync().
     return close.ok() ? close : sync;
 }
@@ -283,6 +293,11 @@ private:
     // the backing file of OpenedFileHandle, not owned.
     RandomAccessFile* _file;
 
+    // whether the block is read through the ssd cache
+    bool _ssd_cached;
+    // size of the file, only used by reads through the ssd cache
+    mutable std::atomic<int64_t> _file_size;
+
     // Whether or not this block has been closed. Close() is thread-safe, so
     // this must be an atomic primitive.
     std::atomic_bool _closed;
@@ -296,12 +311,15 @@ FileReadableBlock::FileReadableBlock(
         : _block_manager(block_manager),
           _path(std::move(path)),
           _file_handle(file_handle),
+          _file_size(-1),
           _closed(false) {
     if (_block_manager->_metrics) {
         _block_manager->_metrics->blocks_open_reading->increment(1);
         _block_manager->_metrics->total_readable_blocks->increment(1);
     }
     _file = _file_handle->file();
+    SsdBlockCache* ssd_cache = SsdBlockCache::instance();
+    _ssd_cached = ssd_cache != nullptr && ssd_cache->is_cached_file(_path);
 }
 
 FileReadableBlock::~FileReadableBlock() {
@@ -347,7 +365,19 @@ Status FileReadableBlock::read(uint64_t offset, Slice result) const {
 Status FileReadableBlock::readv(uint64_t offset, const Slice* results, size_t res_cnt) const {
     DCHECK(!_closed.load());
 
-    RETURN_IF_ERROR(_file->readv_at(offset, results, res_cnt));
+    if (_ssd_cached) {
+        int64_t file_size = _file_size.load();
+        if (file_size < 0) {
+            uint64_t sz = 0;
+            RETURN_IF_ERROR(_file->size(&sz));
+            file_size = sz;
+            _file_size.store(file_size);
+        }
+        RETURN_IF_ERROR(SsdBlockCache::instance()->readv(_path, _file, file_size, offset, results,
+                                                         res_cnt));
+    } else {
+        RETURN_IF_ERROR(_file->readv_at(offset, results, res_cnt));
+    }
 
     if (_block_manager->_metrics) {
         // Calculate the read amount of data
@@ -397,6 +427,7 @@ Status FileBlockManager::create_block(const CreateBlockOptions& opts,
     shared_ptr<WritableFile> writer;
     WritableFileOptions wr_opts;
     wr_opts.mode = Env::MUST_CREATE;
+    wr_opts.direct_io = opts.direct_io;
     RETURN_IF_ERROR(env_util::open_file_for_write(wr_opts, _env, opts.path, &writer));
 
     VLOG(1) << "Creating new block at " << opts.path;
@@ -406,14 +437,30 @@ Status FileBlockManager::create_block(const CreateBlockOptions& opts,
 
 Status FileBlockManager::open_block(const std::string& path,
                                     std::unique_ptr<ReadableBlock>* block) {
+    bool opened = false;
+    return open_block(path, block, &opened);
+}
+
+Status FileBlockManager::open_block(const std::string& path, std::unique_ptr<ReadableBlock>* block,
+                                    bool* opened) {
     VLOG(1) << "Opening block with path at " << path;
     std::shared_ptr<OpenedFileHandle<RandomAccessFile>> file_handle(
             new OpenedFileHandle<RandomAccessFile>());
-    bool found = _file_cache->lookup(path, file_handle.get());
-    if (!found) {
-        std::unique_ptr<RandomAccessFile> file;
-        RETURN_IF_ERROR(_env->new_random_access_file(path, &file));
-        _file_cache->insert(path, file.release(), file_handle.get());
+    *opened = false;
+    int64_t open_start_us = MonotonicMicros();
+    RETURN_IF_ERROR(_file_cache->lookup_or_open(
+            path,
+            [this, &path](std::unique_ptr<RandomAccessFile>* file) {
+                return _env->new_random_access_file(path, file);
+            },
+            file_handle.get(), opened));
+    if (_metrics) {
+        if (*opened) {
+            _metrics->total_file_opens->increment(1);
+            _metrics->total_file_open_duration_us->increment(MonotonicMicros() - open_start_us);
+        } else {
+            _metrics->total_file_cache_hits->increment(1);
+        }
     }
 
     block->reset(new internal::FileReadableBlock(this, path, file_handle));
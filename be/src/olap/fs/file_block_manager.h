@@ -71,6 +71,8 @@ public:
     Status create_block(const CreateBlockOptions& opts,
                         std::unique_ptr<WritableBlock>* block) override;
     Status open_block(const std::string& path, std::unique_ptr<ReadableBlock>* block) override;
+    Status open_block(const std::string& path, std::unique_ptr<ReadableBlock>* block,
+                      bool* opened) override;
 
     Status get_all_block_ids(std::vector<BlockId>* block_ids) override {
         // TODO(lingbin): to be implemented after we assign each block an id
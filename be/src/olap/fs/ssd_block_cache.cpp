@@ -0,0 +1,194 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/fs/ssd_block_cache.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "common/config.h"
+#include "common/logging.h"
+#include "env/env.h"
+#include "util/file_utils.h"
+
+namespace doris {
+namespace fs {
+
+SsdBlockCache* SsdBlockCache::_s_instance = nullptr;
+
+static const size_t kMinGhosts = 1024;
+
+void SsdBlockCache::create_global_cache(const std::string& cache_path, size_t capacity,
+                                        size_t block_size) {
+    DCHECK(_s_instance == nullptr);
+    static SsdBlockCache instance(cache_path, capacity, block_size);
+    _s_instance = &instance;
+}
+
+SsdBlockCache::SsdBlockCache(const std::string& cache_path, size_t capacity, size_t block_size)
+        : _cache_path(cache_path),
+          _capacity(capacity),
+          _block_size(std::max<size_t>(block_size, 4096)) {}
+
+Status SsdBlockCache::init() {
+    // the index of cached blocks is not persisted, so the blocks left are useless
+    RETURN_IF_ERROR(FileUtils::remove_all(_cache_path));
+    RETURN_IF_ERROR(FileUtils::create_dir(_cache_path));
+    _blocks.reset(new_lru_cache("SsdBlockCache", _capacity));
+    // Remember about as many keys as the blocks the cache can hold, so that a block
+    // accessed twice before that many other blocks is admitted.
+    _ghosts.reset(new_lru_cache("SsdBlockCacheGhosts",
+                                std::max(_capacity / _block_size, kMinGhosts)));
+    _inited = true;
+    LOG(INFO) << "init ssd block cache, path=" << _cache_path << ", capacity=" << _capacity
+              << ", block_size=" << _block_size;
+    return Status::OK();
+}
+
+void SsdBlockCache::add_cached_root(const std::string& root_path) {
+    LOG(INFO) << "cache files of " << root_path << " in ssd block cache";
+    _cached_roots.push_back(root_path + "/");
+}
+
+bool SsdBlockCache::is_cached_file(const std::string& fname) const {
+    if (!_inited) {
+        return false;
+    }
+    for (auto& root : _cached_roots) {
+        if (fname.compare(0, root.size(), root) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::string SsdBlockCache::_block_key(const std::string& fname, uint64_t block_index) {
+    std::string key = fname;
+    key.push_back('\0');
+    key.append(reinterpret_cast<const char*>(&block_index), sizeof(block_index));
+    return key;
+}
+
+Status SsdBlockCache::readv(const std::string& fname, const RandomAccessFile* file,
+                            uint64_t file_size, uint64_t offset, const Slice* res,
+                            size_t res_cnt) {
+    for (size_t i = 0; i < res_cnt; ++i) {
+        const Slice& result = res[i];
+        size_t pos = 0;
+        while (pos < result.size) {
+            uint64_t block_index = (offset + pos) / _block_size;
+            uint64_t block_end = (block_index + 1) * _block_size;
+            size_t len = std::min<uint64_t>(result.size - pos, block_end - (offset + pos));
+            RETURN_IF_ERROR(_read_in_block(fname, file, file_size, block_index, offset + pos,
+                                           Slice(result.data + pos, len)));
+            pos += len;
+        }
+        offset += result.size;
+    }
+    return Status::OK();
+}
+
+Status SsdBlockCache::_read_in_block(const std::string& fname, const RandomAccessFile* file,
+                                     uint64_t file_size, uint64_t block_index, uint64_t offset,
+                                     const Slice& result) {
+    uint64_t block_offset = block_index * _block_size;
+    std::string key = _block_key(fname, block_index);
+    auto handle = _blocks->lookup(CacheKey(key));
+    if (handle != nullptr) {
+        const std::string path = reinterpret_cast<Entry*>(_blocks->value(handle))->path;
+        std::unique_ptr<RandomAccessFile> cache_file;
+        Status st = Env::Default()->new_random_access_file(path, &cache_file);
+        if (st.ok()) {
+            st = cache_file->read_at(offset - block_offset, result);
+        }
+        _blocks->release(handle);
+        if (st.ok()) {
+            return st;
+        }
+        // read from the file itself if the cached block is broken
+        LOG(WARNING) << "fail to read ssd cached block " << path << ", error=" << st.to_string();
+        _blocks->erase(CacheKey(key));
+    }
+
+    if (!_admit(key)) {
+        return file->read_at(offset, result);
+    }
+    size_t block_len = std::min<uint64_t>(_block_size, file_size - block_offset);
+    std::unique_ptr<char[]> buf(new char[block_len]);
+    RETURN_IF_ERROR(file->read_at(block_offset, Slice(buf.get(), block_len)));
+    memcpy(result.data, buf.get() + (offset - block_offset), result.size);
+    WARN_IF_ERROR(_insert(key, Slice(buf.get(), block_len)), "fail to cache block of " + fname);
+    return Status::OK();
+}
+
+bool SsdBlockCache::_admit(const std::string& key) {
+    if (!config::ssd_cache_admit_on_second_access) {
+        return true;
+    }
+    auto ghost = _ghosts->lookup(CacheKey(key));
+    if (ghost != nullptr) {
+        _ghosts->release(ghost);
+        _ghosts->erase(CacheKey(key));
+        return true;
+    }
+    auto deleter = [](const doris::CacheKey& key, void* value) {};
+    _ghosts->release(_ghosts->insert(CacheKey(key), nullptr, 1, deleter));
+    return false;
+}
+
+Status SsdBlockCache::_insert(const std::string& key, const Slice& data) {
+    std::unique_ptr<Entry> entry(new Entry());
+    entry->path = _cache_path + "/" + std::to_string(_blocks->new_id());
+    std::unique_ptr<WritableFile> cache_file;
+    RETURN_IF_ERROR(Env::Default()->new_writable_file(entry->path, &cache_file));
+    Status st = cache_file->append(data);
+    if (st.ok()) {
+        st = cache_file->close();
+    }
+    if (!st.ok()) {
+        WARN_IF_ERROR(Env::Default()->delete_file(entry->path), "fail to delete " + entry->path);
+        return st;
+    }
+    // the cache file is deleted when its block is evicted and no longer read
+    auto deleter = [](const doris::CacheKey& key, void* value) {
+        Entry* entry = reinterpret_cast<Entry*>(value);
+        WARN_IF_ERROR(Env::Default()->delete_file(entry->path),
+                      "fail to delete ssd cached block " + entry->path);
+        delete entry;
+    };
+    _blocks->release(_blocks->insert(CacheKey(key), entry.release(), data.size, deleter));
+    return Status::OK();
+}
+
+Status SsdBlockCache::insert_file(const std::string& fname) {
+    std::unique_ptr<RandomAccessFile> file;
+    RETURN_IF_ERROR(Env::Default()->new_random_access_file(fname, &file));
+    uint64_t file_size = 0;
+    RETURN_IF_ERROR(file->size(&file_size));
+    std::unique_ptr<char[]> buf(new char[_block_size]);
+    for (uint64_t block_index = 0; block_index * _block_size < file_size; ++block_index) {
+        uint64_t block_offset = block_index * _block_size;
+        size_t block_len = std::min<uint64_t>(_block_size, file_size - block_offset);
+        Slice data(buf.get(), block_len);
+        RETURN_IF_ERROR(file->read_at(block_offset, data));
+        RETURN_IF_ERROR(_insert(_block_key(fname, block_index), data));
+    }
+    return Status::OK();
+}
+
+} // namespace fs
+} // namespace doris
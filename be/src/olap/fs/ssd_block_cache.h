@@ -0,0 +1,106 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/status.h"
+#include "gutil/macros.h"
+#include "olap/lru_cache.h"
+#include "util/slice.h"
+
+namespace doris {
+
+class RandomAccessFile;
+
+namespace fs {
+
+// A read cache on a local SSD directory for the files of data dirs on HDD.
+//
+// Files are cached in blocks of a fixed size, each cached block is stored as a
+// file under the cache directory, and the blocks are evicted in LRU order when
+// the total size exceeds the capacity. A block read from HDD is only admitted on
+// its second access within a while, so that a scan of cold data doesn't flush
+// the hot blocks. Newly written segment files can be written through into the
+// cache (see insert_file()), as recent data is usually the hottest.
+//
+// The index of the cache is kept in memory, cached blocks left by a previous
+// process are removed in init().
+class SsdBlockCache {
+public:
+    // Create global instance of this class, the cache is not usable until init()
+    // succeeds.
+    static void create_global_cache(const std::string& cache_path, size_t capacity,
+                                    size_t block_size);
+
+    // Return global instance, nullptr if the cache is not created.
+    static SsdBlockCache* instance() { return _s_instance; }
+
+    SsdBlockCache(const std::string& cache_path, size_t capacity, size_t block_size);
+
+    Status init();
+
+    // Files under root_path are cached.
+    void add_cached_root(const std::string& root_path);
+
+    bool is_cached_file(const std::string& fname) const;
+
+    // Read [offset, offset + total size of res) of file 'fname' into res through the cache,
+    // 'file' is the opened file and 'file_size' its size.
+    Status readv(const std::string& fname, const RandomAccessFile* file, uint64_t file_size,
+                 uint64_t offset, const Slice* res, size_t res_cnt);
+
+    // Write all the blocks of a newly written file into the cache.
+    Status insert_file(const std::string& fname);
+
+private:
+    struct Entry {
+        std::string path;
+    };
+
+    static std::string _block_key(const std::string& fname, uint64_t block_index);
+
+    // Read [offset, offset + result.size) which is inside one block.
+    Status _read_in_block(const std::string& fname, const RandomAccessFile* file,
+                          uint64_t file_size, uint64_t block_index, uint64_t offset,
+                          const Slice& result);
+
+    bool _admit(const std::string& key);
+
+    // Store the data of a block as a cache file and insert it into the cache.
+    Status _insert(const std::string& key, const Slice& data);
+
+    static SsdBlockCache* _s_instance;
+
+    const std::string _cache_path;
+    const size_t _capacity;
+    const size_t _block_size;
+    bool _inited = false;
+    std::vector<std::string> _cached_roots;
+
+    std::unique_ptr<Cache> _blocks;
+    // keys of blocks accessed once recently, values are unused
+    std::unique_ptr<Cache> _ghosts;
+
+    DISALLOW_COPY_AND_ASSIGN(SsdBlockCache);
+};
+
+} // namespace fs
+} // namespace doris
@@ -17,6 +17,7 @@
 
 #include <queue>
 
+#include "gutil/strings/substitute.h"
 #include "olap/iterators.h"
 #include "olap/row.h"
 #include "olap/row_block2.h"
@@ -112,8 +113,10 @@ Status AutoIncrementIterator::next_batch(RowBlockV2* block) {
 //      }
 class MergeIteratorContext {
 public:
-    // This class don't take iter's ownership, client should delete it
-    MergeIteratorContext(RowwiseIterator* iter) : _iter(iter), _block(iter->schema(), 1024) {}
+    // This class don't take iter's ownership, client should delete it.
+    // `source' is the index of iter among the inputs of the merge.
+    MergeIteratorContext(RowwiseIterator* iter, uint16_t source = 0)
+            : _iter(iter), _source(source), _block(iter->schema(), 1024) {}
 
     // Initialize this context and will prepare data for current_row()
     Status init(const StorageReadOptions& opts);
@@ -139,7 +142,7 @@ public:
 
     int is_partial_delete() const { return _block.delete_state() == DEL_PARTIAL_SATISFIED; }
 
-    uint64_t data_id() const { return _iter->data_id(); }
+    uint16_t source() const { return _source; }
 
 private:
     // Load next block into _block
@@ -147,6 +150,7 @@ private:
 
 private:
     RowwiseIterator* _iter;
+    uint16_t _source;
     // used to store data load from iterator
     RowBlockV2 _block;
 
@@ -198,7 +202,8 @@ Status MergeIteratorContext::_load_next_block() {
 class MergeIterator : public RowwiseIterator {
 public:
     // MergeIterator takes the ownership of input iterators
-    MergeIterator(std::vector<RowwiseIterator*> iters) : _origin_iters(std::move(iters)) {}
+    MergeIterator(std::vector<RowwiseIterator*> iters, std::vector<uint16_t>* row_sources)
+            : _origin_iters(std::move(iters)), _row_sources(row_sources) {}
 
     ~MergeIterator() override {
         for (auto iter : _origin_iters) {
@@ -216,6 +221,8 @@ public:
 private:
     std::vector<RowwiseIterator*> _origin_iters;
     std::vector<MergeIteratorContext*> _merge_ctxs;
+    // not owned, nullptr if the sources are not recorded
+    std::vector<uint16_t>* _row_sources;
 
     std::unique_ptr<Schema> _schema;
 
@@ -227,11 +234,11 @@ private:
             if (cmp_res != 0) {
                 return cmp_res > 0;
             }
-            // if row cursors equal, compare segment id.
-            // here we sort segment id in reverse order, because of the row order in AGG_KEYS
+            // if row cursors equal, compare the index of input.
+            // here we sort inputs in reverse order, because of the row order in AGG_KEYS
             // dose no matter, but in UNIQUE_KEYS table we only read the latest is one, so we
-            // return the row in reverse order of segment id
-            return lhs->data_id() < rhs->data_id();
+            // return the row in reverse order of input, which is the order of segment id
+            return lhs->source() < rhs->source();
         }
     };
     using MergeHeap = std::priority_queue<MergeIteratorContext*, std::vector<MergeIteratorContext*>,
@@ -246,8 +253,8 @@ Status MergeIterator::init(const StorageReadOptions& opts) {
     _schema.reset(new Schema(_origin_iters[0]->schema()));
     _merge_heap.reset(new MergeHeap);
 
-    for (auto iter : _origin_iters) {
-        std::unique_ptr<MergeIteratorContext> ctx(new MergeIteratorContext(iter));
+    for (size_t i = 0; i < _origin_iters.size(); ++i) {
+        std::unique_ptr<MergeIteratorContext> ctx(new MergeIteratorContext(_origin_iters[i], i));
         RETURN_IF_ERROR(ctx->init(opts));
         if (!ctx->valid()) {
             continue;
@@ -267,6 +274,9 @@ Status MergeIterator::next_batch(RowBlockV2* block) {
         RowBlockRow dst_row = block->row(row_idx);
         // copy current row to block
         copy_row(&dst_row, ctx->current_row(), block->pool());
+        if (_row_sources != nullptr) {
+            _row_sources->push_back(ctx->source());
+        }
 
         // TODO(hkp): refactor conditions and filter rows here with delete conditions
         if (ctx->is_partial_delete()) {
@@ -332,11 +342,87 @@ Status UnionIterator::next_batch(RowBlockV2* block) {
     return Status::EndOfFile("End of UnionIterator");
 }
 
-RowwiseIterator* new_merge_iterator(std::vector<RowwiseIterator*> inputs) {
+// Returns the rows of its inputs in the order recorded by a MergeIterator. It doesn't
+// compare rows, so the inputs may contain no key column at all.
+class RowSourcesIterator : public RowwiseIterator {
+public:
+    // RowSourcesIterator takes the ownership of input iterators
+    RowSourcesIterator(std::vector<RowwiseIterator*> iters,
+                       const std::vector<uint16_t>* row_sources)
+            : _origin_iters(std::move(iters)), _row_sources(row_sources) {}
+
+    ~RowSourcesIterator() override {
+        for (auto iter : _origin_iters) {
+            delete iter;
+        }
+        for (auto ctx : _ctxs) {
+            delete ctx;
+        }
+    }
+    Status init(const StorageReadOptions& opts) override;
+    Status next_batch(RowBlockV2* block) override;
+
+    const Schema& schema() const override { return *_schema; }
+
+private:
+    std::vector<RowwiseIterator*> _origin_iters;
+    // one for each of _origin_iters
+    std::vector<MergeIteratorContext*> _ctxs;
+    const std::vector<uint16_t>* _row_sources;
+    // index in _row_sources of the next row to return
+    size_t _pos = 0;
+
+    std::unique_ptr<Schema> _schema;
+};
+
+Status RowSourcesIterator::init(const StorageReadOptions& opts) {
+    if (_origin_iters.empty()) {
+        return Status::OK();
+    }
+    _schema.reset(new Schema(_origin_iters[0]->schema()));
+    for (size_t i = 0; i < _origin_iters.size(); ++i) {
+        _ctxs.push_back(new MergeIteratorContext(_origin_iters[i], i));
+        RETURN_IF_ERROR(_ctxs.back()->init(opts));
+    }
+    return Status::OK();
+}
+
+Status RowSourcesIterator::next_batch(RowBlockV2* block) {
+    size_t row_idx = 0;
+    for (; row_idx < block->capacity() && _pos < _row_sources->size(); ++row_idx, ++_pos) {
+        uint16_t source = (*_row_sources)[_pos];
+        if (source >= _ctxs.size() || !_ctxs[source]->valid()) {
+            return Status::InternalError(
+                    strings::Substitute("no row of input $0 for row $1", source, _pos));
+        }
+        MergeIteratorContext* ctx = _ctxs[source];
+        RowBlockRow dst_row = block->row(row_idx);
+        copy_row(&dst_row, ctx->current_row(), block->pool());
+        RETURN_IF_ERROR(ctx->advance());
+    }
+    block->set_num_rows(row_idx);
+    block->set_selected_size(row_idx);
+    if (row_idx > 0) {
+        return Status::OK();
+    } else {
+        return Status::EndOfFile("End of RowSourcesIterator");
+    }
+}
+
+RowwiseIterator* new_merge_iterator(std::vector<RowwiseIterator*> inputs,
+                                    std::vector<uint16_t>* row_sources) {
+    if (inputs.size() == 1 && row_sources == nullptr) {
+        return inputs[0];
+    }
+    return new MergeIterator(std::move(inputs), row_sources);
+}
+
+RowwiseIterator* new_row_sources_iterator(std::vector<RowwiseIterator*> inputs,
+                                          const std::vector<uint16_t>* row_sources) {
     if (inputs.size() == 1) {
         return inputs[0];
     }
-    return new MergeIterator(std::move(inputs));
+    return new RowSourcesIterator(std::move(inputs), row_sources);
 }
 
 RowwiseIterator* new_union_iterator(std::vector<RowwiseIterator*> inputs) {
@@ -25,7 +25,23 @@ namespace doris {
 //
 // Inputs iterators' ownership is taken by created merge iterator. And client
 // should delete returned iterator after usage.
-RowwiseIterator* new_merge_iterator(std::vector<RowwiseIterator*> inputs);
+//
+// Equal rows are returned in reverse order of their inputs.
+//
+// If `row_sources` is not nullptr, the index of the input of every returned row
+// is appended to it.
+RowwiseIterator* new_merge_iterator(std::vector<RowwiseIterator*> inputs,
+                                    std::vector<uint16_t>* row_sources = nullptr);
+
+// Create an iterator which returns the rows of input iterators in the order
+// recorded by new_merge_iterator() in `row_sources`, which must outlive it. The
+// inputs must return the same rows as those of the merge, but they may have other
+// columns, e.g. the value columns of rows whose keys have been merged.
+//
+// Inputs iterators' ownership is taken by created iterator. And client should
+// delete returned iterator after usage.
+RowwiseIterator* new_row_sources_iterator(std::vector<RowwiseIterator*> inputs,
+                                          const std::vector<uint16_t>* row_sources);
 
 // Create a union iterator for input iterators. Union iterator will read
 // input iterators one by one.
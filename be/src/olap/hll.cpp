@@ -18,7 +18,11 @@
 #include "olap/hll.h"
 
 #include <algorithm>
+#include <cmath>
 #include <map>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 #include "common/logging.h"
 #include "runtime/string_value.h"
@@ -75,6 +79,31 @@ void HyperLogLog::update(uint64_t hash_value) {
     }
 }
 
+void HyperLogLog::update(const uint64_t* hash_values, size_t num_values) {
+    size_t i = 0;
+    for (; i < num_values && (_type == HLL_DATA_EMPTY || _type == HLL_DATA_EXPLICIT); ++i) {
+        update(hash_values[i]);
+    }
+    // the rest goes to the registers without checking the type again
+    for (; i < num_values; ++i) {
+        _update_registers(hash_values[i]);
+    }
+}
+
+void HyperLogLog::merge_registers(uint8_t* registers, const uint8_t* other_registers) {
+    int i = 0;
+#ifdef __SSE2__
+    for (; i + 16 <= HLL_REGISTERS_COUNT; i += 16) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(registers + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(other_registers + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(registers + i), _mm_max_epu8(a, b));
+    }
+#endif
+    for (; i < HLL_REGISTERS_COUNT; ++i) {
+        registers[i] = std::max(registers[i], other_registers[i]);
+    }
+}
+
 void HyperLogLog::merge(const HyperLogLog& other) {
     // fast path
     if (other._type == HLL_DATA_EMPTY) {
@@ -112,7 +141,7 @@ void HyperLogLog::merge(const HyperLogLog& other) {
         case HLL_DATA_SPARSE:
         case HLL_DATA_FULL:
             _convert_explicit_to_register();
-            _merge_registers(other._registers);
+            merge_registers(_registers, other._registers);
             _type = HLL_DATA_FULL;
             break;
         default:
@@ -130,7 +159,7 @@ void HyperLogLog::merge(const HyperLogLog& other) {
             break;
         case HLL_DATA_SPARSE:
         case HLL_DATA_FULL:
-            _merge_registers(other._registers);
+            merge_registers(_registers, other._registers);
             break;
         default:
             break;
@@ -140,6 +169,60 @@ void HyperLogLog::merge(const HyperLogLog& other) {
     }
 }
 
+void HyperLogLog::merge(const Slice& slice) {
+    // an invalid value is deserialized as an empty one
+    if (slice.data == nullptr || slice.size <= 0 || !is_valid(slice)) {
+        return;
+    }
+    const uint8_t* ptr = (const uint8_t*)slice.data;
+    auto other_type = (HllDataType)*ptr++;
+    switch (other_type) {
+    case HLL_DATA_EXPLICIT: {
+        uint8_t num_explicits = *ptr++;
+        if (_type == HLL_DATA_SPARSE || _type == HLL_DATA_FULL) {
+            for (int i = 0; i < num_explicits; ++i, ptr += 8) {
+                _update_registers(decode_fixed64_le(ptr));
+            }
+            break;
+        }
+        bool was_explicit = _type == HLL_DATA_EXPLICIT;
+        _type = HLL_DATA_EXPLICIT;
+        for (int i = 0; i < num_explicits; ++i, ptr += 8) {
+            _hash_set.insert(decode_fixed64_le(ptr));
+        }
+        if (was_explicit && _hash_set.size() > HLL_EXPLICIT_INT64_NUM) {
+            _convert_explicit_to_register();
+            _type = HLL_DATA_FULL;
+        }
+        break;
+    }
+    case HLL_DATA_SPARSE:
+    case HLL_DATA_FULL: {
+        if (_type == HLL_DATA_EMPTY) {
+            _registers = new uint8_t[HLL_REGISTERS_COUNT];
+            memset(_registers, 0, HLL_REGISTERS_COUNT);
+            _type = other_type;
+        } else if (_type == HLL_DATA_EXPLICIT) {
+            _convert_explicit_to_register();
+            _type = HLL_DATA_FULL;
+        }
+        if (other_type == HLL_DATA_FULL) {
+            merge_registers(_registers, ptr);
+            break;
+        }
+        uint32_t num_registers = decode_fixed32_le(ptr);
+        ptr += 4;
+        for (uint32_t i = 0; i < num_registers; ++i, ptr += 3) {
+            uint16_t register_idx = decode_fixed16_le(ptr);
+            _registers[register_idx] = std::max(_registers[register_idx], ptr[2]);
+        }
+        break;
+    }
+    default:
+        break;
+    }
+}
+
 size_t HyperLogLog::max_serialized_size() const {
     switch (_type) {
     case HLL_DATA_EMPTY:
@@ -322,7 +405,10 @@ int64_t HyperLogLog::estimate_cardinality() const {
     if (_type == HLL_DATA_EXPLICIT) {
         return _hash_set.size();
     }
+    return estimate_registers(_registers);
+}
 
+int64_t HyperLogLog::estimate_registers(const uint8_t* registers) {
     const int num_streams = HLL_REGISTERS_COUNT;
     // Empirical constants for the algorithm.
     float alpha = 0;
@@ -337,18 +423,22 @@ int64_t HyperLogLog::estimate_cardinality() const {
         alpha = 0.7213f / (1 + 1.079f / num_streams);
     }
 
-    float harmonic_mean = 0;
-    int num_zero_registers = 0;
-
+    // The registers only take a few distinct values, so the sum of 2^-register is
+    // computed from the number of registers of each value rather than register by
+    // register.
+    uint32_t num_registers_by_value[256] = {0};
     for (int i = 0; i < HLL_REGISTERS_COUNT; ++i) {
-        harmonic_mean += powf(2.0f, -_registers[i]);
-
-        if (_registers[i] == 0) {
-            ++num_zero_registers;
+        ++num_registers_by_value[registers[i]];
+    }
+    double harmonic_mean = 0;
+    for (int value = 0; value < 256; ++value) {
+        if (num_registers_by_value[value] != 0) {
+            harmonic_mean += num_registers_by_value[value] * std::ldexp(1.0, -value);
         }
     }
+    int num_zero_registers = num_registers_by_value[0];
 
-    harmonic_mean = 1.0f / harmonic_mean;
+    harmonic_mean = 1.0 / harmonic_mean;
     double estimate = alpha * num_streams * num_streams * harmonic_mean;
     // according to HyperLogLog current correction, if E is cardinal
     // E =< num_streams * 2.5 , LC has higher accuracy.
@@ -97,8 +97,15 @@ public:
     // NOTE: input must be a hash_value
     void update(uint64_t hash_value);
 
+    // Same as calling update() with each of the 'num_values' hash values.
+    void update(const uint64_t* hash_values, size_t num_values);
+
     void merge(const HyperLogLog& other);
 
+    // Same as merge(HyperLogLog(slice)), but the serialized value is merged directly
+    // without building its registers.
+    void merge(const Slice& slice);
+
     // Return max size of serialized binary
     size_t max_serialized_size() const;
 
@@ -113,6 +120,13 @@ public:
 
     int64_t estimate_cardinality() const;
 
+    // Absorbs the HLL_REGISTERS_COUNT 'other_registers' into 'registers', i.e. each
+    // register becomes the max of both.
+    static void merge_registers(uint8_t* registers, const uint8_t* other_registers);
+
+    // Estimates the cardinality of HLL_REGISTERS_COUNT registers.
+    static int64_t estimate_registers(const uint8_t* registers);
+
     static std::string empty() {
         static HyperLogLog hll;
         std::string buf;
@@ -171,13 +185,6 @@ private:
         uint8_t first_one_bit = __builtin_ctzl(hash_value) + 1;
         _registers[idx] = std::max((uint8_t)_registers[idx], first_one_bit);
     }
-
-    // absorb other registers into this registers
-    void _merge_registers(const uint8_t* other_registers) {
-        for (int i = 0; i < HLL_REGISTERS_COUNT; ++i) {
-            _registers[i] = std::max(_registers[i], other_registers[i]);
-        }
-    }
 };
 
 // todo(kks): remove this when dpp_sink class was removed
@@ -17,6 +17,8 @@
 
 #include "olap/in_list_predicate.h"
 
+#include <type_traits>
+
 #include "olap/field.h"
 #include "runtime/string_value.hpp"
 #include "runtime/vectorized_row_batch.h"
@@ -85,9 +87,38 @@ IN_LIST_PRED_CONSTRUCTOR(NotInListPredicate)
 IN_LIST_PRED_EVALUATE(InListPredicate, !=)
 IN_LIST_PRED_EVALUATE(NotInListPredicate, ==)
 
-#define IN_LIST_PRED_COLUMN_BLOCK_EVALUATE(CLASS, OP)                                     \
+template <class type>
+struct DictWordMatcher {
+    DictWordMatcher(const std::set<type>& values, bool is_in) : values(values), is_in(is_in) {}
+    bool operator()(const Slice& word) const {
+        return (values.find(StringValue(word.data, word.size)) != values.end()) == is_in;
+    }
+    const std::set<type>& values;
+    bool is_in;
+};
+
+// Evaluate a string column decoded from a dictionary on its codes.
+// Return false if the block can't be evaluated this way.
+template <class type>
+static typename std::enable_if<std::is_same<type, StringValue>::value, bool>::type evaluate_dict(
+        const ColumnPredicate* pred, ColumnBlock* block, const std::set<type>& values, bool is_in,
+        uint16_t* sel, uint16_t* size) {
+    return pred->evaluate_dict(block, sel, size, DictWordMatcher<type>(values, is_in));
+}
+
+template <class type>
+static typename std::enable_if<!std::is_same<type, StringValue>::value, bool>::type
+evaluate_dict(const ColumnPredicate* pred, ColumnBlock* block, const std::set<type>& values,
+              bool is_in, uint16_t* sel, uint16_t* size) {
+    return false;
+}
+
+#define IN_LIST_PRED_COLUMN_BLOCK_EVALUATE(CLASS, OP, IS_IN)                              \
     template <class type>                                                                 \
     void CLASS<type>::evaluate(ColumnBlock* block, uint16_t* sel, uint16_t* size) const { \
+        if (evaluate_dict(this, block, _values, IS_IN, sel, size)) {                      \
+            return;                                                                       \
+        }                                                                                 \
         uint16_t new_size = 0;                                                            \
         if (block->is_nullable()) {                                                       \
             for (uint16_t i = 0; i < *size; ++i) {                                        \
@@ -110,8 +141,8 @@ IN_LIST_PRED_EVALUATE(NotInListPredicate, ==)
         *size = new_size;                                                                 \
     }
 
-IN_LIST_PRED_COLUMN_BLOCK_EVALUATE(InListPredicate, !=)
-IN_LIST_PRED_COLUMN_BLOCK_EVALUATE(NotInListPredicate, ==)
+IN_LIST_PRED_COLUMN_BLOCK_EVALUATE(InListPredicate, !=, true)
+IN_LIST_PRED_COLUMN_BLOCK_EVALUATE(NotInListPredicate, ==, false)
 
 #define IN_LIST_PRED_BITMAP_EVALUATE(CLASS, OP)                                      \
     template <class type>                                                            \
@@ -29,6 +29,9 @@ class RowBlockV2;
 class Schema;
 class Conditions;
 class ColumnPredicate;
+class ThreadPool;
+class BlockFilter;
+class DeleteBitmap;
 
 class StorageReadOptions {
 public:
@@ -72,10 +75,24 @@ public:
     // TODO(hkp): refactor the column predicate framework
     // to unify Conditions and ColumnPredicate
     const std::vector<ColumnPredicate*>* column_predicates = nullptr;
+    // filters evaluated after column predicates, nullptr if not existed
+    const std::vector<BlockFilter*>* block_filters = nullptr;
+
+    // delete bitmap of a merge-on-write tablet, nullptr if not existed.
+    // rows of the segments of rowset `rowset_id` replaced by a version not newer than
+    // `delete_bitmap_version` are skipped
+    const DeleteBitmap* delete_bitmap = nullptr;
+    RowsetId rowset_id;
+    int64_t delete_bitmap_version = -1;
 
     // REQUIRED (null is not allowed)
     OlapReaderStatistics* stats = nullptr;
     bool use_page_cache = false;
+
+    // if not null, each column iterator reads up to `read_ahead_pages` data pages
+    // ahead on this pool
+    ThreadPool* read_ahead_pool = nullptr;
+    int read_ahead_pages = 0;
 };
 
 // Used to read data in RowBlockV2 one by one
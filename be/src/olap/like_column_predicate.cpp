@@ -0,0 +1,177 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/like_column_predicate.h"
+
+#include <cstring>
+
+#include "olap/rowset/segment_v2/ngram_index_reader.h"
+#include "runtime/string_value.hpp"
+#include "runtime/vectorized_row_batch.h"
+
+namespace doris {
+
+static const char kEscapeChar = '\\';
+
+LikeColumnPredicate::LikeColumnPredicate(uint32_t column_id, const std::string& pattern,
+                                         bool is_char)
+        : ColumnPredicate(column_id), _is_char(is_char) {
+    bool is_escaped = false;
+    for (char c : pattern) {
+        if (!is_escaped && c == '%') {
+            // "%%" is the same as "%"
+            if (_items.empty() || _items.back().type != ANY_CHARS) {
+                _items.push_back({ANY_CHARS, ""});
+            }
+        } else if (!is_escaped && c == '_') {
+            _items.push_back({ANY_CHAR, ""});
+        } else if (!is_escaped && c == kEscapeChar) {
+            is_escaped = true;
+        } else {
+            if (_items.empty() || _items.back().type != LITERAL) {
+                _items.push_back({LITERAL, ""});
+            }
+            _items.back().literal.push_back(c);
+            is_escaped = false;
+        }
+    }
+}
+
+// the position after the UTF-8 character at 'pos'
+static inline size_t next_char(const char* data, size_t size, size_t pos) {
+    ++pos;
+    while (pos < size && (static_cast<uint8_t>(data[pos]) & 0xC0) == 0x80) {
+        ++pos;
+    }
+    return pos;
+}
+
+bool LikeColumnPredicate::match(const Slice& value) const {
+    const char* data = value.data;
+    size_t size = _is_char ? strnlen(value.data, value.size) : value.size;
+    size_t item = 0;
+    size_t pos = 0;
+    // Position of the last '%' matched and of the value where it's matched to end. When
+    // the items after it don't match, it takes one more byte and they are matched again.
+    size_t star_item = _items.size();
+    size_t star_pos = 0;
+    while (item < _items.size() || pos < size) {
+        if (item < _items.size()) {
+            const Item& it = _items[item];
+            if (it.type == ANY_CHARS) {
+                star_item = item++;
+                star_pos = pos;
+                continue;
+            }
+            if (it.type == ANY_CHAR && pos < size) {
+                pos = next_char(data, size, pos);
+                ++item;
+                continue;
+            }
+            if (it.type == LITERAL && size - pos >= it.literal.size() &&
+                memcmp(data + pos, it.literal.data(), it.literal.size()) == 0) {
+                pos += it.literal.size();
+                ++item;
+                continue;
+            }
+        }
+        if (star_item < _items.size() && star_pos < size) {
+            pos = ++star_pos;
+            item = star_item + 1;
+            continue;
+        }
+        return false;
+    }
+    return true;
+}
+
+void LikeColumnPredicate::evaluate(VectorizedRowBatch* batch) const {
+    uint16_t n = batch->size();
+    if (n == 0) {
+        return;
+    }
+    uint16_t* sel = batch->selected();
+    const StringValue* col_vector =
+            reinterpret_cast<const StringValue*>(batch->column(_column_id)->col_data());
+    const bool* is_null =
+            batch->column(_column_id)->no_nulls() ? nullptr : batch->column(_column_id)->is_null();
+    uint16_t new_size = 0;
+    if (batch->selected_in_use()) {
+        for (uint16_t j = 0; j != n; ++j) {
+            uint16_t i = sel[j];
+            sel[new_size] = i;
+            new_size += ((is_null == nullptr || !is_null[i]) &&
+                         match(Slice(col_vector[i].ptr, col_vector[i].len)));
+        }
+        batch->set_size(new_size);
+    } else {
+        for (uint16_t i = 0; i != n; ++i) {
+            sel[new_size] = i;
+            new_size += ((is_null == nullptr || !is_null[i]) &&
+                         match(Slice(col_vector[i].ptr, col_vector[i].len)));
+        }
+        if (new_size < n) {
+            batch->set_size(new_size);
+            batch->set_selected_in_use(true);
+        }
+    }
+}
+
+namespace {
+
+struct DictWordMatcher {
+    explicit DictWordMatcher(const LikeColumnPredicate* pred) : pred(pred) {}
+    bool operator()(const Slice& word) const { return pred->match(word); }
+    const LikeColumnPredicate* pred;
+};
+
+} // namespace
+
+void LikeColumnPredicate::evaluate(ColumnBlock* block, uint16_t* sel, uint16_t* size) const {
+    if (evaluate_dict(block, sel, size, DictWordMatcher(this))) {
+        return;
+    }
+    uint16_t new_size = 0;
+    for (uint16_t i = 0; i < *size; ++i) {
+        uint16_t idx = sel[i];
+        sel[new_size] = idx;
+        new_size += (!block->cell(idx).is_null() &&
+                     match(*reinterpret_cast<const Slice*>(block->cell(idx).cell_ptr())));
+    }
+    *size = new_size;
+}
+
+Status LikeColumnPredicate::evaluate(const Schema& schema,
+                                     const std::vector<BitmapIndexIterator*>& iterators,
+                                     uint32_t num_rows, Roaring* roaring) const {
+    return Status::NotSupported("like predicate can't be evaluated by bitmap index");
+}
+
+Status LikeColumnPredicate::evaluate_ngram_index(NGramIndexIterator* iterator,
+                                                 Roaring* roaring) const {
+    for (auto& item : _items) {
+        if (roaring->isEmpty()) {
+            break;
+        }
+        if (item.type == LITERAL) {
+            RETURN_IF_ERROR(iterator->filter_rows_containing(Slice(item.literal), roaring));
+        }
+    }
+    return Status::OK();
+}
+
+} //namespace doris
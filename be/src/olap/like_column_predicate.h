@@ -0,0 +1,74 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#ifndef DORIS_BE_SRC_OLAP_LIKE_COLUMN_PREDICATE_H
+#define DORIS_BE_SRC_OLAP_LIKE_COLUMN_PREDICATE_H
+
+#include <stdint.h>
+
+#include <roaring/roaring.hh>
+#include <string>
+#include <vector>
+
+#include "olap/column_predicate.h"
+#include "util/slice.h"
+
+namespace doris {
+
+class VectorizedRowBatch;
+
+// Predicate "column LIKE pattern" on CHAR and VARCHAR columns, in which '%' matches any
+// characters, '_' matches one UTF-8 character and '\' escapes the next character.
+//
+// Besides evaluating values, the literal parts of the pattern are looked up in the
+// n-gram index of the column to skip rows not containing them.
+class LikeColumnPredicate : public ColumnPredicate {
+public:
+    // 'is_char' is true for CHAR columns, whose values are padded with '\0'
+    LikeColumnPredicate(uint32_t column_id, const std::string& pattern, bool is_char);
+    ~LikeColumnPredicate() override = default;
+
+    void evaluate(VectorizedRowBatch* batch) const override;
+
+    void evaluate(ColumnBlock* block, uint16_t* sel, uint16_t* size) const override;
+
+    // not supported, bitmap indexes are only used for the predicates of values
+    Status evaluate(const Schema& schema, const std::vector<BitmapIndexIterator*>& iterators,
+                    uint32_t num_rows, Roaring* roaring) const override;
+
+    bool can_use_bitmap_index() const override { return false; }
+
+    Status evaluate_ngram_index(NGramIndexIterator* iterator, Roaring* roaring) const override;
+
+    bool match(const Slice& value) const;
+
+private:
+    enum ItemType { LITERAL, ANY_CHAR, ANY_CHARS };
+    struct Item {
+        ItemType type;
+        // for LITERAL
+        std::string literal;
+    };
+
+    // the pattern parsed, adjacent literal characters are merged into one item
+    std::vector<Item> _items;
+    bool _is_char;
+};
+
+} //namespace doris
+
+#endif //DORIS_BE_SRC_OLAP_LIKE_COLUMN_PREDICATE_H
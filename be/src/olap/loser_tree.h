@@ -0,0 +1,94 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+#pragma once
+
+#include <utility>
+#include <vector>
+
+namespace doris {
+
+// Tournament tree of losers to merge k sorted inputs. Each internal node keeps the
+// loser of the match between its two subtrees, so that replacing the winner
+// replays only the matches on the path from its leaf to the root: log(k)
+// comparisons, against about 2*log(k) of a binary heap.
+//
+// Leaves are identified by their index in [0, num_leaves). `Less(a, b)` returns
+// whether the current item of leaf a is before the one of leaf b, an exhausted
+// leaf should be after all others.
+template <typename Less>
+class LoserTree {
+public:
+    explicit LoserTree(Less less) : _less(std::move(less)) {}
+
+    // Build the tree from the current items of `num_leaves` leaves.
+    void init(int num_leaves) {
+        _num_leaves = num_leaves;
+        _nodes.assign(num_leaves, 0);
+        if (num_leaves > 0) {
+            _nodes[0] = _build(1);
+        }
+    }
+
+    // Leaf of the first item.
+    int winner() const { return _nodes[0]; }
+
+    // Restore the tree after the item of the winner leaf has changed.
+    void replay() {
+        int winner = _nodes[0];
+        for (int node = (winner + _num_leaves) / 2; node > 0; node /= 2) {
+            if (_less(_nodes[node], winner)) {
+                std::swap(_nodes[node], winner);
+            }
+        }
+        _nodes[0] = winner;
+    }
+
+    // Leaf of the first item except the one of the winner, -1 if there is only one
+    // leaf. It has lost to the winner directly, so it is kept on the path of the winner.
+    int runner_up() const {
+        int runner_up = -1;
+        for (int node = (_nodes[0] + _num_leaves) / 2; node > 0; node /= 2) {
+            if (runner_up < 0 || _less(_nodes[node], runner_up)) {
+                runner_up = _nodes[node];
+            }
+        }
+        return runner_up;
+    }
+
+private:
+    // Nodes are numbered as in a binary heap: internal nodes in [1, num_leaves) and
+    // leaf i at num_leaves + i. Return the winner of the subtree of `node`.
+    int _build(int node) {
+        if (node >= _num_leaves) {
+            return node - _num_leaves;
+        }
+        int left = _build(2 * node);
+        int right = _build(2 * node + 1);
+        if (_less(right, left)) {
+            std::swap(left, right);
+        }
+        _nodes[node] = right;
+        return left;
+    }
+
+    Less _less;
+    int _num_leaves = 0;
+    // _nodes[0] is the winner, _nodes[i] the loser at internal node i
+    std::vector<int> _nodes;
+};
+
+} // namespace doris
@@ -28,6 +28,8 @@ DEFINE_GAUGE_METRIC_PROTOTYPE_2ARG(usage, MetricUnit::BYTES);
 DEFINE_GAUGE_METRIC_PROTOTYPE_2ARG(usage_ratio, MetricUnit::NOUNIT);
 DEFINE_COUNTER_METRIC_PROTOTYPE_2ARG(lookup_count, MetricUnit::OPERATIONS);
 DEFINE_COUNTER_METRIC_PROTOTYPE_2ARG(hit_count, MetricUnit::OPERATIONS);
+DEFINE_COUNTER_METRIC_PROTOTYPE_2ARG(miss_count, MetricUnit::OPERATIONS);
+DEFINE_COUNTER_METRIC_PROTOTYPE_2ARG(evict_count, MetricUnit::OPERATIONS);
 DEFINE_GAUGE_METRIC_PROTOTYPE_2ARG(hit_ratio, MetricUnit::NOUNIT);
 
 uint32_t CacheKey::hash(const char* data, size_t n, uint32_t seed) const {
@@ -241,6 +243,7 @@ void LRUCache::release(Cache::Handle* handle) {
                 e->in_cache = false;
                 _unref(e);
                 _usage -= e->charge;
+                ++_evict_count;
                 last_ref = true;
             } else {
                 // put it to LRU free list
@@ -286,6 +289,7 @@ void LRUCache::_evict_one_entry(LRUHandle* e) {
     e->in_cache = false;
     _unref(e);
     _usage -= e->charge;
+    ++_evict_count;
 }
 
 Cache::Handle* LRUCache::insert(const CacheKey& key, uint32_t hash, void* value, size_t charge,
@@ -298,6 +302,7 @@ Cache::Handle* LRUCache::insert(const CacheKey& key, uint32_t hash, void* value,
     e->key_length = key.size();
     e->hash = hash;
     e->refs = 2; // one for the returned handle, one for LRUCache.
+    e->visited = false;
     e->next = e->prev = nullptr;
     e->in_cache = true;
     e->priority = priority;
@@ -390,6 +395,196 @@ int LRUCache::prune() {
     return pruned_count;
 }
 
+ClockCache::ClockCache() : _mutex(RWMutex::Priority::PREFER_WRITING) {
+    // Make empty circular linked list
+    _clock.next = &_clock;
+    _clock.prev = &_clock;
+    _hand = &_clock;
+}
+
+ClockCache::~ClockCache() {
+    prune();
+}
+
+void ClockCache::_clock_remove(LRUHandle* e) {
+    if (_hand == e) {
+        _hand = e->next;
+    }
+    e->next->prev = e->prev;
+    e->prev->next = e->next;
+    e->prev = e->next = nullptr;
+    --_num_entries;
+}
+
+void ClockCache::_clock_insert(LRUHandle* e) {
+    e->next = _hand;
+    e->prev = _hand->prev;
+    e->prev->next = e;
+    e->next->prev = e;
+    ++_num_entries;
+}
+
+bool ClockCache::_remove_from_cache(LRUHandle* e) {
+    DCHECK(e->in_cache);
+    _clock_remove(e);
+    e->in_cache = false;
+    return e->refs.fetch_sub(1) == 1;
+}
+
+Cache::Handle* ClockCache::lookup(const CacheKey& key, uint32_t hash) {
+    _lookup_count.fetch_add(1, std::memory_order_relaxed);
+    ReadLock l(&_mutex);
+    LRUHandle* e = _table.lookup(key, hash);
+    if (e != nullptr) {
+        // the cache holds a reference of e while it's in _table, so refs can't
+        // drop to 0 before we add ours
+        e->refs.fetch_add(1, std::memory_order_relaxed);
+        if (!e->visited.load(std::memory_order_relaxed)) {
+            e->visited.store(true, std::memory_order_relaxed);
+        }
+        _hit_count.fetch_add(1, std::memory_order_relaxed);
+    }
+    return reinterpret_cast<Cache::Handle*>(e);
+}
+
+void ClockCache::release(Cache::Handle* handle) {
+    if (handle == nullptr) {
+        return;
+    }
+    LRUHandle* e = reinterpret_cast<LRUHandle*>(handle);
+    // entries over capacity are left to the next insert, so that release
+    // doesn't need the lock
+    if (e->refs.fetch_sub(1) == 1) {
+        DCHECK(!e->in_cache);
+        _usage -= e->charge;
+        e->free();
+    }
+}
+
+void ClockCache::_evict(size_t charge, LRUHandle** to_remove_head) {
+    // 1. evict normal cache entries
+    // 2. evict durable cache entries if need
+    for (int round = 0; round < 2; ++round) {
+        bool evict_durable = (round == 1);
+        // An entry is evicted at the latest the second time the hand meets it,
+        // after its reference bit was cleared the first time.
+        size_t max_steps = 2 * (_num_entries + 1);
+        for (size_t i = 0; i < max_steps && _usage + charge > _capacity && _num_entries > 0;
+             ++i) {
+            LRUHandle* e = _hand;
+            _hand = e->next;
+            if (e == &_clock || e->refs.load(std::memory_order_relaxed) > 1) {
+                // the dummy head or entry in use
+                continue;
+            }
+            if (e->priority == CachePriority::DURABLE && !evict_durable) {
+                continue;
+            }
+            if (e->visited.load(std::memory_order_relaxed)) {
+                e->visited.store(false, std::memory_order_relaxed);
+                continue;
+            }
+            _table.remove(e);
+            // no handle refers to e and lookup() can't get it under our exclusive lock
+            bool last_ref = _remove_from_cache(e);
+            DCHECK(last_ref);
+            _usage -= e->charge;
+            ++_evict_count;
+            e->next = *to_remove_head;
+            *to_remove_head = e;
+        }
+    }
+}
+
+Cache::Handle* ClockCache::insert(const CacheKey& key, uint32_t hash, void* value, size_t charge,
+                                  void (*deleter)(const CacheKey& key, void* value),
+                                  CachePriority priority) {
+    LRUHandle* e = reinterpret_cast<LRUHandle*>(malloc(sizeof(LRUHandle) - 1 + key.size()));
+    e->value = value;
+    e->deleter = deleter;
+    e->charge = charge;
+    e->key_length = key.size();
+    e->hash = hash;
+    e->refs = 2; // one for the returned handle, one for ClockCache.
+    e->visited = false;
+    e->next = e->prev = nullptr;
+    e->in_cache = true;
+    e->priority = priority;
+    memcpy(e->key_data, key.data(), key.size());
+    LRUHandle* to_remove_head = nullptr;
+    {
+        WriteLock l(&_mutex);
+
+        _evict(charge, &to_remove_head);
+
+        // note that the cache might get larger than its capacity if not enough
+        // space was freed
+        auto old = _table.insert(e);
+        _usage += charge;
+        if (old != nullptr && _remove_from_cache(old)) {
+            _usage -= old->charge;
+            old->next = to_remove_head;
+            to_remove_head = old;
+        }
+        _clock_insert(e);
+    }
+
+    // we free the entries here outside of mutex for
+    // performance reasons
+    while (to_remove_head != nullptr) {
+        LRUHandle* next = to_remove_head->next;
+        to_remove_head->free();
+        to_remove_head = next;
+    }
+
+    return reinterpret_cast<Cache::Handle*>(e);
+}
+
+void ClockCache::erase(const CacheKey& key, uint32_t hash) {
+    LRUHandle* e = nullptr;
+    bool last_ref = false;
+    {
+        WriteLock l(&_mutex);
+        e = _table.remove(key, hash);
+        if (e != nullptr) {
+            last_ref = _remove_from_cache(e);
+        }
+    }
+    // free handle out of mutex, when last_ref is true, e must not be nullptr
+    if (last_ref) {
+        _usage -= e->charge;
+        e->free();
+    }
+}
+
+int ClockCache::prune() {
+    LRUHandle* to_remove_head = nullptr;
+    {
+        WriteLock l(&_mutex);
+        LRUHandle* e = _clock.next;
+        while (e != &_clock) {
+            LRUHandle* next = e->next;
+            if (e->refs.load(std::memory_order_relaxed) == 1) {
+                _table.remove(e);
+                bool last_ref = _remove_from_cache(e);
+                DCHECK(last_ref);
+                _usage -= e->charge;
+                e->next = to_remove_head;
+                to_remove_head = e;
+            }
+            e = next;
+        }
+    }
+    int pruned_count = 0;
+    while (to_remove_head != nullptr) {
+        ++pruned_count;
+        LRUHandle* next = to_remove_head->next;
+        to_remove_head->free();
+        to_remove_head = next;
+    }
+    return pruned_count;
+}
+
 inline uint32_t ShardedLRUCache::_hash_slice(const CacheKey& s) {
     return s.hash(s.data(), s.size(), 0);
 }
@@ -398,11 +593,17 @@ uint32_t ShardedLRUCache::_shard(uint32_t hash) {
     return hash >> (32 - kNumShardBits);
 }
 
-ShardedLRUCache::ShardedLRUCache(const std::string& name, size_t total_capacity)
+ShardedLRUCache::ShardedLRUCache(const std::string& name, size_t total_capacity,
+                                 LRUCacheType type)
         : _name(name), _last_id(1) {
     const size_t per_shard = (total_capacity + (kNumShards - 1)) / kNumShards;
     for (int s = 0; s < kNumShards; s++) {
-        _shards[s].set_capacity(per_shard);
+        if (type == LRUCacheType::CLOCK) {
+            _shards[s] = new ClockCache();
+        } else {
+            _shards[s] = new LRUCache();
+        }
+        _shards[s]->set_capacity(per_shard);
     }
 
     _entity = DorisMetrics::instance()->metric_registry()->register_entity(
@@ -413,34 +614,39 @@ ShardedLRUCache::ShardedLRUCache(const std::string& name, size_t total_capacity)
     INT_DOUBLE_METRIC_REGISTER(_entity, usage_ratio);
     INT_ATOMIC_COUNTER_METRIC_REGISTER(_entity, lookup_count);
     INT_ATOMIC_COUNTER_METRIC_REGISTER(_entity, hit_count);
+    INT_ATOMIC_COUNTER_METRIC_REGISTER(_entity, miss_count);
+    INT_ATOMIC_COUNTER_METRIC_REGISTER(_entity, evict_count);
     INT_DOUBLE_METRIC_REGISTER(_entity, hit_ratio);
 }
 
 ShardedLRUCache::~ShardedLRUCache() {
     _entity->deregister_hook(_name);
     DorisMetrics::instance()->metric_registry()->deregister_entity(_entity);
+    for (int s = 0; s < kNumShards; s++) {
+        delete _shards[s];
+    }
 }
 
 Cache::Handle* ShardedLRUCache::insert(const CacheKey& key, void* value, size_t charge,
                                        void (*deleter)(const CacheKey& key, void* value),
                                        CachePriority priority) {
     const uint32_t hash = _hash_slice(key);
-    return _shards[_shard(hash)].insert(key, hash, value, charge, deleter, priority);
+    return _shards[_shard(hash)]->insert(key, hash, value, charge, deleter, priority);
 }
 
 Cache::Handle* ShardedLRUCache::lookup(const CacheKey& key) {
     const uint32_t hash = _hash_slice(key);
-    return _shards[_shard(hash)].lookup(key, hash);
+    return _shards[_shard(hash)]->lookup(key, hash);
 }
 
 void ShardedLRUCache::release(Handle* handle) {
     LRUHandle* h = reinterpret_cast<LRUHandle*>(handle);
-    _shards[_shard(h->hash)].release(handle);
+    _shards[_shard(h->hash)]->release(handle);
 }
 
 void ShardedLRUCache::erase(const CacheKey& key) {
     const uint32_t hash = _hash_slice(key);
-    _shards[_shard(hash)].erase(key, hash);
+    _shards[_shard(hash)]->erase(key, hash);
 }
 
 void* ShardedLRUCache::value(Handle* handle) {
@@ -459,7 +665,7 @@ uint64_t ShardedLRUCache::new_id() {
 void ShardedLRUCache::prune() {
     int num_prune = 0;
     for (int s = 0; s < kNumShards; s++) {
-        num_prune += _shards[s].prune();
+        num_prune += _shards[s]->prune();
     }
     VLOG(7) << "Successfully prune cache, clean " << num_prune << " entries.";
 }
@@ -469,23 +675,28 @@ void ShardedLRUCache::update_cache_metrics() const {
     size_t total_usage = 0;
     size_t total_lookup_count = 0;
     size_t total_hit_count = 0;
+    size_t total_evict_count = 0;
     for (int i = 0; i < kNumShards; i++) {
-        total_capacity += _shards[i].get_capacity();
-        total_usage += _shards[i].get_usage();
-        total_lookup_count += _shards[i].get_lookup_count();
-        total_hit_count += _shards[i].get_hit_count();
+        total_capacity += _shards[i]->get_capacity();
+        total_usage += _shards[i]->get_usage();
+        total_lookup_count += _shards[i]->get_lookup_count();
+        total_hit_count += _shards[i]->get_hit_count();
+        total_evict_count += _shards[i]->get_evict_count();
     }
 
     capacity->set_value(total_capacity);
     usage->set_value(total_usage);
     lookup_count->set_value(total_lookup_count);
     hit_count->set_value(total_hit_count);
-    usage_ratio->set_value(total_capacity == 0 ? 0 : (total_usage / total_capacity));
-    hit_ratio->set_value(total_lookup_count == 0 ? 0 : (total_hit_count / total_lookup_count));
+    miss_count->set_value(total_lookup_count - total_hit_count);
+    evict_count->set_value(total_evict_count);
+    usage_ratio->set_value(total_capacity == 0 ? 0 : ((double)total_usage / total_capacity));
+    hit_ratio->set_value(total_lookup_count == 0 ? 0
+                                                 : ((double)total_hit_count / total_lookup_count));
 }
 
-Cache* new_lru_cache(const std::string& name, size_t capacity) {
-    return new ShardedLRUCache(name, capacity);
+Cache* new_lru_cache(const std::string& name, size_t capacity, LRUCacheType type) {
+    return new ShardedLRUCache(name, capacity, type);
 }
 
 } // namespace doris
@@ -10,6 +10,7 @@
 #include <stdint.h>
 #include <string.h>
 
+#include <atomic>
 #include <string>
 #include <vector>
 
@@ -47,9 +48,21 @@ namespace doris {
 class Cache;
 class CacheKey;
 
+// Eviction policy of the shards of a cache.
+enum class LRUCacheType {
+    // Strict LRU, every hit moves the entry out of the LRU list under the shard mutex.
+    LRU,
+    // CLOCK approximation of LRU. A hit only sets the reference bit of the entry
+    // under a shared lock and release() takes no lock, so concurrent hits on a hot
+    // shard don't serialize. Suits caches dominated by lookups, like the page cache.
+    CLOCK,
+};
+
 // Create a new cache with a specified name and a fixed size capacity.  This implementation
-// of Cache uses a least-recently-used eviction policy.
-extern Cache* new_lru_cache(const std::string& name, size_t capacity);
+// of Cache uses a least-recently-used eviction policy, or an approximation of it
+// if type is CLOCK.
+extern Cache* new_lru_cache(const std::string& name, size_t capacity,
+                            LRUCacheType type = LRUCacheType::LRU);
 
 class CacheKey {
 public:
@@ -218,7 +231,10 @@ typedef struct LRUHandle {
     size_t charge;
     size_t key_length;
     bool in_cache; // Whether entry is in the cache.
-    uint32_t refs;
+    // Atomic because ClockCache changes it without holding the shard lock exclusively.
+    std::atomic<uint32_t> refs;
+    // Reference bit of ClockCache, set by hits and cleared by the clock hand.
+    std::atomic<bool> visited;
     uint32_t hash; // Hash of key(); used for fast sharding and comparisons
     CachePriority priority = CachePriority::NORMAL;
     char key_data[1]; // Beginning of key
@@ -284,27 +300,50 @@ private:
 };
 
 // A single shard of sharded cache.
-class LRUCache {
+class CacheShard {
 public:
-    LRUCache();
-    ~LRUCache();
+    virtual ~CacheShard() {}
 
-    // Separate from constructor so caller can easily make an array of LRUCache
+    // Separate from constructor so caller can easily make an array of shards
     void set_capacity(size_t capacity) { _capacity = capacity; }
 
     // Like Cache methods, but with an extra "hash" parameter.
+    virtual Cache::Handle* insert(const CacheKey& key, uint32_t hash, void* value, size_t charge,
+                                  void (*deleter)(const CacheKey& key, void* value),
+                                  CachePriority priority = CachePriority::NORMAL) = 0;
+    virtual Cache::Handle* lookup(const CacheKey& key, uint32_t hash) = 0;
+    virtual void release(Cache::Handle* handle) = 0;
+    virtual void erase(const CacheKey& key, uint32_t hash) = 0;
+    virtual int prune() = 0;
+
+    virtual uint64_t get_lookup_count() const = 0;
+    virtual uint64_t get_hit_count() const = 0;
+    virtual uint64_t get_evict_count() const = 0;
+    virtual size_t get_usage() const = 0;
+    size_t get_capacity() const { return _capacity; }
+
+protected:
+    // Initialized before use.
+    size_t _capacity = 0;
+};
+
+class LRUCache : public CacheShard {
+public:
+    LRUCache();
+    ~LRUCache() override;
+
     Cache::Handle* insert(const CacheKey& key, uint32_t hash, void* value, size_t charge,
                           void (*deleter)(const CacheKey& key, void* value),
-                          CachePriority priority = CachePriority::NORMAL);
-    Cache::Handle* lookup(const CacheKey& key, uint32_t hash);
-    void release(Cache::Handle* handle);
-    void erase(const CacheKey& key, uint32_t hash);
-    int prune();
-
-    uint64_t get_lookup_count() const { return _lookup_count; }
-    uint64_t get_hit_count() const { return _hit_count; }
-    size_t get_usage() const { return _usage; }
-    size_t get_capacity() const { return _capacity; }
+                          CachePriority priority = CachePriority::NORMAL) override;
+    Cache::Handle* lookup(const CacheKey& key, uint32_t hash) override;
+    void release(Cache::Handle* handle) override;
+    void erase(const CacheKey& key, uint32_t hash) override;
+    int prune() override;
+
+    uint64_t get_lookup_count() const override { return _lookup_count; }
+    uint64_t get_hit_count() const override { return _hit_count; }
+    uint64_t get_evict_count() const override { return _evict_count; }
+    size_t get_usage() const override { return _usage; }
 
 private:
     void _lru_remove(LRUHandle* e);
@@ -313,9 +352,6 @@ private:
     void _evict_from_lru(size_t charge, LRUHandle** to_remove_head);
     void _evict_one_entry(LRUHandle* e);
 
-    // Initialized before use.
-    size_t _capacity = 0;
-
     // _mutex protects the following state.
     Mutex _mutex;
     size_t _usage = 0;
@@ -329,6 +365,60 @@ private:
 
     uint64_t _lookup_count = 0; // cache查找总次数
     uint64_t _hit_count = 0;    // 命中cache的总次数
+    uint64_t _evict_count = 0;  // entries evicted to make room or because of over capacity
+};
+
+// Shard which evicts with the CLOCK algorithm. All entries in cache are kept in
+// a circular list, and the clock hand sweeps it on insert. An entry whose
+// reference bit is set gets a second chance, an entry which is not referenced
+// by any handle and has not been visited since the last sweep is evicted.
+//
+// lookup() only takes _mutex in shared mode and doesn't touch the list, and
+// release() doesn't take _mutex at all. The handle that drops the last
+// reference frees the entry.
+class ClockCache : public CacheShard {
+public:
+    ClockCache();
+    ~ClockCache() override;
+
+    Cache::Handle* insert(const CacheKey& key, uint32_t hash, void* value, size_t charge,
+                          void (*deleter)(const CacheKey& key, void* value),
+                          CachePriority priority = CachePriority::NORMAL) override;
+    Cache::Handle* lookup(const CacheKey& key, uint32_t hash) override;
+    void release(Cache::Handle* handle) override;
+    void erase(const CacheKey& key, uint32_t hash) override;
+    int prune() override;
+
+    uint64_t get_lookup_count() const override { return _lookup_count; }
+    uint64_t get_hit_count() const override { return _hit_count; }
+    uint64_t get_evict_count() const override { return _evict_count; }
+    size_t get_usage() const override { return _usage; }
+
+private:
+    void _clock_remove(LRUHandle* e);
+    void _clock_insert(LRUHandle* e);
+    // Remove e from cache, e must be in cache. Return true if the cache held
+    // the last reference, then the caller must free e.
+    bool _remove_from_cache(LRUHandle* e);
+    void _evict(size_t charge, LRUHandle** to_remove_head);
+
+    // Writers, who change _table or the circular list, hold _mutex exclusively.
+    RWMutex _mutex;
+    // Charge of all entries not yet freed, including the erased ones which are
+    // still referenced by handles.
+    std::atomic<size_t> _usage{0};
+
+    // Dummy head of the circular list of entries in cache, new entries are
+    // inserted just behind the hand, so that they are visited last.
+    LRUHandle _clock;
+    LRUHandle* _hand;
+    size_t _num_entries = 0;
+
+    HandleTable _table;
+
+    std::atomic<uint64_t> _lookup_count{0};
+    std::atomic<uint64_t> _hit_count{0};
+    uint64_t _evict_count = 0;
 };
 
 static const int kNumShardBits = 4;
@@ -336,7 +426,8 @@ static const int kNumShards = 1 << kNumShardBits;
 
 class ShardedLRUCache : public Cache {
 public:
-    explicit ShardedLRUCache(const std::string& name, size_t total_capacity);
+    explicit ShardedLRUCache(const std::string& name, size_t total_capacity,
+                             LRUCacheType type = LRUCacheType::LRU);
     // TODO(fdy): 析构时清除所有cache元素
     virtual ~ShardedLRUCache();
     virtual Handle* insert(const CacheKey& key, void* value, size_t charge,
@@ -358,7 +449,7 @@ private:
     static uint32_t _shard(uint32_t hash);
 
     std::string _name;
-    LRUCache _shards[kNumShards];
+    CacheShard* _shards[kNumShards];
     std::atomic<uint64_t> _last_id;
 
     std::shared_ptr<MetricEntity> _entity = nullptr;
@@ -367,6 +458,8 @@ private:
     DoubleGauge* usage_ratio = nullptr;
     IntAtomicCounter* lookup_count = nullptr;
     IntAtomicCounter* hit_count = nullptr;
+    IntAtomicCounter* miss_count = nullptr;
+    IntAtomicCounter* evict_count = nullptr;
     DoubleGauge* hit_ratio = nullptr;
 };
 
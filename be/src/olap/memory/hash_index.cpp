@@ -126,6 +126,12 @@ uint64_t HashIndex::find(uint64_t key_hash, std::vector<uint32_t>* entries) cons
     }
 }
 
+void HashIndex::prefetch(uint64_t key_hash) const {
+    if (_chunks != nullptr) {
+        __builtin_prefetch(&_chunks[(key_hash >> 8) & _chunk_mask]);
+    }
+}
+
 void HashIndex::set(uint64_t entry_pos, uint64_t key_hash, uint32_t value) {
     uint64_t pos = entry_pos >> 4;
     uint64_t tpos = entry_pos & 0xf;
@@ -83,6 +83,10 @@ public:
     // add a value with the same key hash directly into this hash index.
     uint64_t find(uint64_t key_hash, std::vector<uint32_t>* entries) const;
 
+    // Prefetch the chunk where key_hash is probed first, so that a later find()
+    // of a batch of keys doesn't wait for memory one key at a time.
+    void prefetch(uint64_t key_hash) const;
+
     // Set a value with hash key_hash, at a entry position returned by find
     void set(uint64_t entry_pos, uint64_t key_hash, uint32_t value);
 
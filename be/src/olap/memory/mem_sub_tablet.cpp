@@ -106,6 +106,7 @@ Status MemSubTablet::begin_write(scoped_refptr<Schema>* schema) {
         }
     }
     _temp_hash_entries.reserve(8);
+    _temp_rows.resize(kWriteRowBatchSize);
 
     // setup stats
     _write_start = GetMonoTimeSecondsAsDouble();
@@ -116,79 +117,96 @@ Status MemSubTablet::begin_write(scoped_refptr<Schema>* schema) {
 }
 
 Status MemSubTablet::apply_partial_row_batch(PartialRowBatch* batch) {
-    while (true) {
-        bool has_row = false;
-        RETURN_IF_ERROR(batch->next_row(&has_row));
-        if (!has_row) {
-            break;
-        }
-        DCHECK_GE(batch->cur_row_cell_size(), 1);
-        const ColumnSchema* dsc;
-        const void* key;
-        // get key column and find in hash index
-        // TODO: support multi-column row key
-        batch->cur_row_get_cell(0, &dsc, &key);
-        ColumnWriter* keyw = _writers[1].get();
-        // find candidate rowids, and check equality
-        uint64_t hashcode = keyw->hashcode(key, 0);
-        _temp_hash_entries.clear();
-        uint32_t newslot = _write_index->find(hashcode, &_temp_hash_entries);
-        uint32_t rid = -1;
-        for (size_t i = 0; i < _temp_hash_entries.size(); i++) {
-            uint32_t test_rid = _temp_hash_entries[i];
-            if (keyw->equals(test_rid, key, 0)) {
-                rid = test_rid;
+    // TODO: support multi-column row key
+    ColumnWriter* keyw = _writers[1].get();
+    bool has_row = true;
+    while (has_row) {
+        // Read a batch of rows and prefetch the hash index chunks of their keys,
+        // so that the cache misses of probing them overlap.
+        size_t num_rows = 0;
+        while (num_rows < kWriteRowBatchSize) {
+            RETURN_IF_ERROR(batch->next_row(&has_row));
+            if (!has_row) {
                 break;
             }
-        }
-        // if rowkey not found, do insertion/append
-        if (rid == -1) {
-            rid = _row_size;
-            // add all columns
-            //DLOG(INFO) << StringPrintf"insert rid=%u", rid);
+            DCHECK_GE(batch->cur_row_cell_size(), 1);
+            WriteRow& row = _temp_rows[num_rows];
+            row.cells.clear();
             for (size_t i = 0; i < batch->cur_row_cell_size(); i++) {
+                const ColumnSchema* dsc;
                 const void* data;
                 RETURN_IF_ERROR(batch->cur_row_get_cell(i, &dsc, &data));
-                uint32_t cid = dsc->cid();
-                if (_writers[cid] == nullptr) {
-                    RETURN_IF_ERROR(_columns[cid]->create_writer(&_writers[cid]));
-                }
-                RETURN_IF_ERROR(_writers[cid]->insert(rid, data));
+                row.cells.emplace_back(dsc, data);
+            }
+            row.hashcode = keyw->hashcode(row.cells[0].second, 0);
+            _write_index->prefetch(row.hashcode);
+            num_rows++;
+        }
+        for (size_t i = 0; i < num_rows; i++) {
+            RETURN_IF_ERROR(apply_row(_temp_rows[i]));
+        }
+    }
+    return Status::OK();
+}
+
+Status MemSubTablet::apply_row(const WriteRow& row) {
+    ColumnWriter* keyw = _writers[1].get();
+    const void* key = row.cells[0].second;
+    // find candidate rowids, and check equality
+    uint64_t hashcode = row.hashcode;
+    _temp_hash_entries.clear();
+    uint32_t newslot = _write_index->find(hashcode, &_temp_hash_entries);
+    uint32_t rid = -1;
+    for (size_t i = 0; i < _temp_hash_entries.size(); i++) {
+        uint32_t test_rid = _temp_hash_entries[i];
+        if (keyw->equals(test_rid, key, 0)) {
+            rid = test_rid;
+            break;
+        }
+    }
+    // if rowkey not found, do insertion/append
+    if (rid == -1) {
+        rid = _row_size;
+        // add all columns
+        //DLOG(INFO) << StringPrintf"insert rid=%u", rid);
+        for (auto& cell : row.cells) {
+            uint32_t cid = cell.first->cid();
+            if (_writers[cid] == nullptr) {
+                RETURN_IF_ERROR(_columns[cid]->create_writer(&_writers[cid]));
             }
-            _write_index->set(newslot, hashcode, rid);
-            _row_size++;
-            if (_write_index->need_rebuild()) {
-                scoped_refptr<HashIndex> new_index;
-                // TODO: trace memory usage
-                size_t new_capacity = _row_size * 2;
-                while (true) {
-                    new_index = rebuild_hash_index(new_capacity);
-                    if (new_index.get() != nullptr) {
-                        break;
-                    } else {
-                        new_capacity += 1 << 16;
-                    }
+            RETURN_IF_ERROR(_writers[cid]->insert(rid, cell.second));
+        }
+        _write_index->set(newslot, hashcode, rid);
+        _row_size++;
+        if (_write_index->need_rebuild()) {
+            scoped_refptr<HashIndex> new_index;
+            // TODO: trace memory usage
+            size_t new_capacity = _row_size * 2;
+            while (true) {
+                new_index = rebuild_hash_index(new_capacity);
+                if (new_index.get() != nullptr) {
+                    break;
+                } else {
+                    new_capacity += 1 << 16;
                 }
-                _write_index = new_index;
             }
-            _num_insert++;
-        } else {
-            // rowkey found, do update
-            // add non-key columns
-            for (size_t i = 1; i < batch->cur_row_cell_size(); i++) {
-                const void* data;
-                RETURN_IF_ERROR(batch->cur_row_get_cell(i, &dsc, &data));
-                uint32_t cid = dsc->cid();
-                if (cid > _schema->num_key_columns()) {
-                    if (_writers[cid] == nullptr) {
-                        RETURN_IF_ERROR(_columns[cid]->create_writer(&_writers[cid]));
-                    }
-                    RETURN_IF_ERROR(_writers[cid]->update(rid, data));
+            _write_index = new_index;
+        }
+        _num_insert++;
+    } else {
+        // rowkey found, do update
+        // add non-key columns
+        for (size_t i = 1; i < row.cells.size(); i++) {
+            uint32_t cid = row.cells[i].first->cid();
+            if (cid > _schema->num_key_columns()) {
+                if (_writers[cid] == nullptr) {
+                    RETURN_IF_ERROR(_columns[cid]->create_writer(&_writers[cid]));
                 }
+                RETURN_IF_ERROR(_writers[cid]->update(rid, row.cells[i].second));
             }
-            _num_update++;
-            _num_update_cell += batch->cur_row_cell_size() - 1;
         }
+        _num_update++;
+        _num_update_cell += row.cells.size() - 1;
     }
     return Status::OK();
 }
@@ -83,9 +83,20 @@ public:
     Status commit_write(uint64_t version);
 
 private:
+    // A row read from PartialRowBatch, with the hashcode of its key
+    struct WriteRow {
+        uint64_t hashcode = 0;
+        std::vector<std::pair<const ColumnSchema*, const void*>> cells;
+    };
+
+    // Number of rows whose hash index chunks are prefetched before they are applied
+    static const size_t kWriteRowBatchSize = 16;
+
     MemSubTablet();
     scoped_refptr<HashIndex> rebuild_hash_index(size_t new_capacity);
 
+    Status apply_row(const WriteRow& row);
+
     mutable std::mutex _lock;
     scoped_refptr<HashIndex> _index;
     struct VersionInfo {
@@ -107,6 +118,8 @@ private:
     std::vector<std::unique_ptr<ColumnWriter>> _writers;
     // Temporary variable to reuse hash entry vector
     std::vector<uint32_t> _temp_hash_entries;
+    // Temporary variable to reuse rows being applied
+    std::vector<WriteRow> _temp_rows;
     // Write stats
     double _write_start = 0;
     size_t _num_insert = 0;
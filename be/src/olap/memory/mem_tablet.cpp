@@ -17,9 +17,14 @@
 
 #include "olap/memory/mem_tablet.h"
 
+#include <algorithm>
+
 #include "olap/memory/mem_sub_tablet.h"
 #include "olap/memory/mem_tablet_scan.h"
 #include "olap/memory/write_txn.h"
+#include "olap/row.h"
+#include "olap/row_cursor.h"
+#include "olap/rowset/rowset_writer.h"
 
 namespace doris {
 namespace memory {
@@ -86,5 +91,56 @@ Status MemTablet::commit_write_txn(WriteTxn* wtxn, uint64_t version) {
     return Status::OK();
 }
 
+Status MemTablet::flush(uint64_t version, RowsetWriter* writer) {
+    std::vector<std::string> columns;
+    for (size_t i = 0; i < _mem_schema->num_columns(); ++i) {
+        columns.push_back(_mem_schema->get(i)->name());
+    }
+    std::unique_ptr<ScanSpec> spec(new ScanSpec(std::move(columns), version));
+    std::unique_ptr<MemTabletScan> mscan;
+    RETURN_IF_ERROR(scan(&spec, &mscan));
+
+    // Rows are kept in the order they are inserted, but segments must be sorted by key.
+    std::vector<std::unique_ptr<RowCursor>> rows;
+    while (true) {
+        const RowBlock* block = nullptr;
+        RETURN_IF_ERROR(mscan->next_block(&block));
+        if (block == nullptr) {
+            break;
+        }
+        for (size_t r = 0; r < block->num_rows(); ++r) {
+            std::unique_ptr<RowCursor> row(new RowCursor());
+            if (row->init(_schema) != OLAP_SUCCESS) {
+                return Status::InternalError("failed to init row cursor");
+            }
+            for (size_t c = 0; c < block->num_columns(); ++c) {
+                const ColumnBlock& column = block->get_column(c);
+                if (column.is_null(r)) {
+                    row->set_null(c);
+                    continue;
+                }
+                row->set_not_null(c);
+                size_t size = _mem_schema->get_column_byte_size(_mem_schema->get(c)->cid());
+                memcpy(row->cell_ptr(c), column.data().as<uint8_t>() + r * size, size);
+            }
+            rows.push_back(std::move(row));
+        }
+    }
+    std::sort(rows.begin(), rows.end(),
+              [](const std::unique_ptr<RowCursor>& lhs, const std::unique_ptr<RowCursor>& rhs) {
+                  return compare_row(*lhs, *rhs) < 0;
+              });
+
+    for (auto& row : rows) {
+        if (writer->add_row(*row) != OLAP_SUCCESS) {
+            return Status::InternalError("failed to add row to rowset writer");
+        }
+    }
+    if (writer->flush() != OLAP_SUCCESS) {
+        return Status::InternalError("failed to flush rowset writer");
+    }
+    return Status::OK();
+}
+
 } // namespace memory
 } // namespace doris
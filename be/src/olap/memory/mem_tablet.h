@@ -21,6 +21,9 @@
 #include "olap/memory/schema.h"
 
 namespace doris {
+
+class RowsetWriter;
+
 namespace memory {
 
 class MemSubTablet;
@@ -70,6 +73,13 @@ public:
     // Note: commit is done sequentially, protected by internal write lock
     Status commit_write_txn(WriteTxn* wtxn, uint64_t version);
 
+    // Write all rows of the specified version into a segment_v2 rowset by 'writer',
+    // sorted by key, so that the data can be persisted and read by the disk engine.
+    // The caller builds and commits the rowset.
+    //
+    // Note: thread-safe, it's a scan of the version and doesn't block writes.
+    Status flush(uint64_t version, RowsetWriter* writer);
+
 private:
     friend class MemTabletScan;
     // memory::Schema is used internally rather than TabletSchema, so we need an extra
@@ -17,18 +17,48 @@
 
 #include "olap/memtable.h"
 
+#include <algorithm>
+
+#include "common/config.h"
 #include "common/logging.h"
+#include "gutil/endian.h"
+#include "olap/key_coder.h"
 #include "olap/row.h"
 #include "olap/row_cursor.h"
 #include "olap/rowset/column_data_writer.h"
 #include "olap/rowset/rowset_writer.h"
 #include "olap/schema.h"
+#include "olap/zorder.h"
 #include "runtime/tuple.h"
 #include "util/debug_util.h"
 #include "util/doris_metrics.h"
+#include "util/radix_sort.h"
 
 namespace doris {
 
+namespace {
+
+// Sorting less rows than this by radix sort doesn't pay off its passes
+const size_t kMinRowsToRadixSort = 256;
+
+} // namespace
+
+struct MemTable::SortEntryRadixSortTraits {
+    using Element = SortEntry;
+    using Key = uint64_t;
+    using CountType = uint32_t;
+    using KeyBits = uint64_t;
+
+    static constexpr size_t PART_SIZE_BITS = 8;
+
+    using Transform = RadixSortIdentityTransform<KeyBits>;
+    using Allocator = RadixSortMallocAllocator;
+
+    static Key& extractKey(Element& elem) { return elem.prefix; }
+
+    static bool less(Key x, Key y) { return x < y; }
+};
+
 MemTable::MemTable(int64_t tablet_id, Schema* schema, const TabletSchema* tablet_schema,
                    const std::vector<SlotDescriptor*>* slot_descs, TupleDescriptor* tuple_desc,
                    KeysType keys_type, RowsetWriter* rowset_writer,
@@ -44,12 +74,25 @@ MemTable::MemTable(int64_t tablet_id, Schema* schema, const TabletSchema* tablet
           _buffer_mem_pool(new MemPool(_mem_tracker.get())),
           _table_mem_pool(new MemPool(_mem_tracker.get())),
           _schema_size(_schema->schema_size()),
-          _skip_list(new Table(_row_comparator, _table_mem_pool.get(),
-                               _keys_type == KeysType::DUP_KEYS)),
-          _rowset_writer(rowset_writer) {}
+          _sort_on_flush(config::memtable_sort_on_flush ||
+                         (keys_type == KeysType::DUP_KEYS && tablet_schema->is_clustered())),
+          _skip_list(nullptr),
+          _key_coder(get_key_coder(_schema->column(0)->type())),
+          _rowset_writer(rowset_writer) {
+    if (!_sort_on_flush) {
+        _skip_list = new Table(_row_comparator, _table_mem_pool.get(),
+                               _keys_type == KeysType::DUP_KEYS);
+    }
+    if (_keys_type == KeysType::DUP_KEYS && _tablet_schema->is_clustered()) {
+        std::vector<uint32_t> column_ids(_tablet_schema->clustering_col_idxs().begin(),
+                                         _tablet_schema->clustering_col_idxs().end());
+        _zorder_sorter.reset(new ZOrderSorter(_schema, column_ids));
+    }
+}
 
 MemTable::~MemTable() {
     delete _skip_list;
+    _mem_tracker->Release(_rows.capacity() * sizeof(char*));
 }
 
 MemTable::RowCursorComparator::RowCursorComparator(const Schema* schema) : _schema(schema) {}
@@ -61,15 +104,40 @@ int MemTable::RowCursorComparator::operator()(const char* left, const char* righ
 }
 
 void MemTable::insert(const Tuple* tuple) {
+    ++_num_inserted_rows;
     bool overwritten = false;
     uint8_t* _tuple_buf = nullptr;
+    if (_sort_on_flush) {
+        // Rows with equal keys are aggregated on flush, so all rows use memory from
+        // _table_mem_pool
+        _tuple_buf = _table_mem_pool->allocate(_schema_size);
+        ContiguousRow row(_schema, _tuple_buf);
+        _tuple_to_row(tuple, &row, _table_mem_pool.get());
+        if (_input_sorted && !_rows.empty()) {
+            _input_sorted = _row_comparator(_rows.back(), (char*)_tuple_buf) <= 0;
+        }
+        size_t old_capacity = _rows.capacity();
+        _rows.push_back((char*)_tuple_buf);
+        if (_rows.capacity() != old_capacity) {
+            _mem_tracker->Consume((_rows.capacity() - old_capacity) * sizeof(char*));
+        }
+        return;
+    }
     if (_keys_type == KeysType::DUP_KEYS) {
         // Will insert directly, so use memory from _table_mem_pool
         _tuple_buf = _table_mem_pool->allocate(_schema_size);
         ContiguousRow row(_schema, _tuple_buf);
         _tuple_to_row(tuple, &row, _table_mem_pool.get());
-        _skip_list->Insert((TableKey)_tuple_buf, &overwritten);
-        DCHECK(!overwritten) << "Duplicate key model meet overwrite in SkipList";
+        bool is_exist = false;
+        if (_input_sorted) {
+            _input_sorted = _skip_list->FindAtTail((TableKey)_tuple_buf, &_hint, &is_exist);
+        }
+        if (_input_sorted) {
+            _skip_list->InsertWithHint((TableKey)_tuple_buf, is_exist, &_hint);
+        } else {
+            _skip_list->Insert((TableKey)_tuple_buf, &overwritten);
+            DCHECK(!overwritten) << "Duplicate key model meet overwrite in SkipList";
+        }
         return;
     }
 
@@ -81,7 +149,13 @@ void MemTable::insert(const Tuple* tuple) {
     ContiguousRow src_row(_schema, _tuple_buf);
     _tuple_to_row(tuple, &src_row, _buffer_mem_pool.get());
 
-    bool is_exist = _skip_list->Find((TableKey)_tuple_buf, &_hint);
+    bool is_exist = false;
+    if (_input_sorted) {
+        _input_sorted = _skip_list->FindAtTail((TableKey)_tuple_buf, &_hint, &is_exist);
+    }
+    if (!_input_sorted) {
+        is_exist = _skip_list->Find((TableKey)_tuple_buf, &_hint);
+    }
     if (is_exist) {
         _aggregate_two_row(src_row, _hint.curr->key);
     } else {
@@ -112,26 +186,134 @@ void MemTable::_aggregate_two_row(const ContiguousRow& src_row, TableKey row_in_
     if (_tablet_schema->has_sequence_col()) {
         agg_update_row_with_sequence(&dst_row, src_row, _tablet_schema->sequence_col_idx(),
                                      _table_mem_pool.get());
+    } else if (_partial_columns) {
+        agg_update_row_if_not_null(&dst_row, src_row, _table_mem_pool.get());
     } else {
         agg_update_row(&dst_row, src_row, _table_mem_pool.get());
     }
 }
 
+uint64_t MemTable::_key_prefix(const char* row) {
+    ContiguousRow src_row(_schema, row);
+    auto cell = src_row.cell(0);
+    // null is less than any value, and a value may have prefix 0 as well
+    if (cell.is_null() || _key_coder == nullptr) {
+        return 0;
+    }
+    // Encoded keys are compared by memcmp, so comparing the big endian load of
+    // their first bytes padded with zeros never contradicts compare_row().
+    _prefix_buf.clear();
+    _key_coder->encode_ascending(cell.cell_ptr(), sizeof(uint64_t), &_prefix_buf);
+    char buf[sizeof(uint64_t)] = {0};
+    memcpy(buf, _prefix_buf.data(), std::min(_prefix_buf.size(), sizeof(buf)));
+    return BigEndian::Load64(buf);
+}
+
+void MemTable::_sort_rows() {
+    std::vector<SortEntry> entries(_rows.size());
+    for (size_t i = 0; i < _rows.size(); ++i) {
+        entries[i].prefix = _key_prefix(_rows[i]);
+        entries[i].row = _rows[i];
+    }
+    auto prefix_less = [](const SortEntry& lhs, const SortEntry& rhs) {
+        return lhs.prefix < rhs.prefix;
+    };
+    if (entries.size() >= kMinRowsToRadixSort) {
+        RadixSort<SortEntryRadixSortTraits>::executeLSD(entries.data(), entries.size());
+    } else {
+        std::stable_sort(entries.begin(), entries.end(), prefix_less);
+    }
+
+    // then sort the rows with equal prefix by the whole key
+    auto row_less = [this](const SortEntry& lhs, const SortEntry& rhs) {
+        return _row_comparator(lhs.row, rhs.row) < 0;
+    };
+    for (size_t begin = 0; begin < entries.size();) {
+        size_t end = begin + 1;
+        while (end < entries.size() && entries[end].prefix == entries[begin].prefix) {
+            ++end;
+        }
+        if (end - begin > 1) {
+            std::stable_sort(entries.begin() + begin, entries.begin() + end, row_less);
+        }
+        begin = end;
+    }
+    for (size_t i = 0; i < entries.size(); ++i) {
+        _rows[i] = entries[i].row;
+    }
+}
+
+OLAPStatus MemTable::_write_sorted_rows(const AddRowFunc& add_row) {
+    if (_zorder_sorter != nullptr) {
+        // rows of duplicate keys are never aggregated, so they needn't be sorted by keys
+        _zorder_sorter->sort(&_rows);
+    } else if (!_input_sorted) {
+        _sort_rows();
+    }
+    for (size_t i = 0; i < _rows.size();) {
+        char* row = _rows[i];
+        size_t next = i + 1;
+        if (_keys_type != KeysType::DUP_KEYS) {
+            for (; next < _rows.size() && _row_comparator(row, _rows[next]) == 0; ++next) {
+                _aggregate_two_row(ContiguousRow(_schema, _rows[next]), row);
+            }
+        }
+        ContiguousRow dst_row(_schema, row);
+        agg_finalize_row(&dst_row, _table_mem_pool.get());
+        RETURN_NOT_OK(add_row(dst_row));
+        i = next;
+    }
+    return OLAP_SUCCESS;
+}
+
+OLAPStatus MemTable::write_rows(const AddRowFunc& add_row) {
+    if (_sort_on_flush) {
+        return _write_sorted_rows(add_row);
+    }
+    Table::Iterator it(_skip_list);
+    for (it.SeekToFirst(); it.Valid(); it.Next()) {
+        char* row = (char*)it.key();
+        ContiguousRow dst_row(_schema, row);
+        agg_finalize_row(&dst_row, _table_mem_pool.get());
+        RETURN_NOT_OK(add_row(dst_row));
+    }
+    return OLAP_SUCCESS;
+}
+
+OLAPStatus MemTable::write_rows_in_batches(const AddRowsFunc& add_rows) {
+    // the rows point to the memory of this memtable, which doesn't change during the flush
+    std::vector<ContiguousRow> rows;
+    rows.reserve(FLUSH_BATCH_ROWS);
+    auto add_row = [&add_rows, &rows](const ContiguousRow& row) -> OLAPStatus {
+        rows.push_back(row);
+        if (rows.size() < FLUSH_BATCH_ROWS) {
+            return OLAP_SUCCESS;
+        }
+        OLAPStatus res = add_rows(rows);
+        rows.clear();
+        return res;
+    };
+    RETURN_NOT_OK(write_rows(add_row));
+    return rows.empty() ? OLAP_SUCCESS : add_rows(rows);
+}
+
 OLAPStatus MemTable::flush() {
     int64_t duration_ns = 0;
     {
         SCOPED_RAW_TIMER(&duration_ns);
-        Table::Iterator it(_skip_list);
-        for (it.SeekToFirst(); it.Valid(); it.Next()) {
-            char* row = (char*)it.key();
-            ContiguousRow dst_row(_schema, row);
-            agg_finalize_row(&dst_row, _table_mem_pool.get());
-            RETURN_NOT_OK(_rowset_writer->add_row(dst_row));
+        if (_segment_id >= 0) {
+            RETURN_NOT_OK(_rowset_writer->flush_memtable(this, _segment_id));
+        } else {
+            auto add_rows = [this](const std::vector<ContiguousRow>& rows) {
+                return _rowset_writer->add_rows(rows);
+            };
+            RETURN_NOT_OK(write_rows_in_batches(add_rows));
+            RETURN_NOT_OK(_rowset_writer->flush());
         }
-        RETURN_NOT_OK(_rowset_writer->flush());
     }
     DorisMetrics::instance()->memtable_flush_total->increment(1);
     DorisMetrics::instance()->memtable_flush_duration_us->increment(duration_ns / 1000);
+    DorisMetrics::instance()->memtable_flush_latency_us->add(duration_ns / 1000);
     return OLAP_SUCCESS;
 }
 
@@ -18,7 +18,11 @@
 #ifndef DORIS_BE_SRC_OLAP_MEMTABLE_H
 #define DORIS_BE_SRC_OLAP_MEMTABLE_H
 
+#include <functional>
+#include <memory>
 #include <ostream>
+#include <string>
+#include <vector>
 
 #include "common/object_pool.h"
 #include "olap/olap_define.h"
@@ -28,12 +32,14 @@
 namespace doris {
 
 class ContiguousRow;
+class KeyCoder;
 class RowsetWriter;
 class Schema;
 class SlotDescriptor;
 class TabletSchema;
 class Tuple;
 class TupleDescriptor;
+class ZOrderSorter;
 
 class MemTable {
 public:
@@ -45,10 +51,33 @@ public:
 
     int64_t tablet_id() const { return _tablet_id; }
     size_t memory_usage() const { return _mem_tracker->consumption(); }
+    bool empty() const { return _num_inserted_rows == 0; }
     void insert(const Tuple* tuple);
+
+    // Flush to the segment reserved by RowsetWriter::reserve_segment() instead of the
+    // current segment of the rowset writer, so that it may run concurrently with the
+    // flush of other memtables.
+    void set_segment_id(int32_t segment_id) { _segment_id = segment_id; }
+
+    // The rows only have the values of some columns of a unique key table, the null values
+    // are the columns not loaded and don't replace the values of the earlier rows.
+    void set_partial_columns(bool partial_columns) { _partial_columns = partial_columns; }
+
     OLAPStatus flush();
     OLAPStatus close();
 
+    typedef std::function<OLAPStatus(const ContiguousRow&)> AddRowFunc;
+    // Pass the rows to add_row in key order, rows with equal keys are aggregated.
+    // The rows of a clustered duplicate key tablet are passed in Z-order instead.
+    OLAPStatus write_rows(const AddRowFunc& add_row);
+
+    // The rows a flush passes to the rowset writer at a time
+    static const size_t FLUSH_BATCH_ROWS = 4096;
+    typedef std::function<OLAPStatus(const std::vector<ContiguousRow>&)> AddRowsFunc;
+    // Same as write_rows(), but passes at most FLUSH_BATCH_ROWS rows at a time, so that
+    // they can be written column by column.
+    OLAPStatus write_rows_in_batches(const AddRowsFunc& add_rows);
+
 private:
     class RowCursorComparator {
     public:
@@ -61,8 +90,19 @@ private:
     typedef SkipList<char*, RowCursorComparator> Table;
     typedef Table::key_type TableKey;
 
+    // Row and an order-preserving prefix of its first key column
+    struct SortEntry {
+        uint64_t prefix;
+        char* row;
+    };
+    struct SortEntryRadixSortTraits;
+
     void _tuple_to_row(const Tuple* tuple, ContiguousRow* row, MemPool* mem_pool);
     void _aggregate_two_row(const ContiguousRow& new_row, TableKey row_in_skiplist);
+    uint64_t _key_prefix(const char* row);
+    // Sort _rows stably by key, rows with equal keys keep the order of insertion
+    void _sort_rows();
+    OLAPStatus _write_sorted_rows(const AddRowFunc& add_row);
 
     int64_t _tablet_id;
     Schema* _schema;
@@ -84,10 +124,27 @@ private:
     ObjectPool _agg_object_pool;
 
     size_t _schema_size;
+    // Only one of _skip_list and _rows is used, see config::memtable_sort_on_flush.
+    // Rows of clustered tablets are always sorted on flush.
+    bool _sort_on_flush;
     Table* _skip_list;
     Table::Hint _hint;
+    // Rows in order of insertion, sorted and aggregated by flush()
+    std::vector<char*> _rows;
+    const KeyCoder* _key_coder;
+    std::string _prefix_buf;
+    // True until a row is inserted with a smaller key than the last row, while it's true
+    // the rows are appended to _skip_list without searching it and _rows needn't be sorted.
+    // It's not set back once false, so unordered input pays no more comparisons.
+    bool _input_sorted = true;
+    // not null if the rows are sorted by the Z-order of the clustering columns
+    std::unique_ptr<ZOrderSorter> _zorder_sorter;
 
     RowsetWriter* _rowset_writer;
+    // -1 if the memtable is flushed to the current segment of _rowset_writer
+    int32_t _segment_id = -1;
+    size_t _num_inserted_rows = 0;
+    bool _partial_columns = false;
 
 }; // class MemTable
 
@@ -20,6 +20,7 @@
 #include <functional>
 
 #include "olap/memtable.h"
+#include "util/continuous_cpu_profiler.h"
 #include "util/scoped_cleanup.h"
 
 namespace doris {
@@ -37,6 +38,12 @@ std::ostream& operator<<(std::ostream& os, const FlushStatistic& stat) {
 // its reference count is not 0.
 OLAPStatus FlushToken::submit(const std::shared_ptr<MemTable>& memtable) {
     RETURN_NOT_OK(_flush_status.load());
+    if (is_concurrent()) {
+        std::unique_lock<std::mutex> l(_lock);
+        _cv.wait(l, [this]() { return _num_flushing < _max_flushing; });
+        RETURN_NOT_OK(_flush_status.load());
+        ++_num_flushing;
+    }
     _flush_token->submit_func(std::bind(&FlushToken::_flush_memtable, this, memtable));
     return OLAP_SUCCESS;
 }
@@ -51,7 +58,15 @@ OLAPStatus FlushToken::wait() {
 }
 
 void FlushToken::_flush_memtable(std::shared_ptr<MemTable> memtable) {
-    SCOPED_CLEANUP({ memtable.reset(); });
+    ScopedCpuProfilerTag profiler_tag(ContinuousCpuProfiler::FLUSH);
+    SCOPED_CLEANUP({
+        memtable.reset();
+        if (is_concurrent()) {
+            std::lock_guard<std::mutex> l(_lock);
+            --_num_flushing;
+            _cv.notify_all();
+        }
+    });
 
     // If previous flush has failed, return directly
     if (_flush_status.load() != OLAP_SUCCESS) {
@@ -80,9 +95,18 @@ void MemTableFlushExecutor::init(const std::vector<DataDir*>& data_dirs) {
             .build(&_flush_pool);
 }
 
-// NOTE: we use SERIAL mode here to ensure all mem-tables from one tablet are flushed in order.
-OLAPStatus MemTableFlushExecutor::create_flush_token(std::unique_ptr<FlushToken>* flush_token) {
-    flush_token->reset(new FlushToken(_flush_pool->new_token(ThreadPool::ExecutionMode::SERIAL)));
+// NOTE: we use SERIAL mode here to ensure all mem-tables from one tablet are flushed in order,
+// unless each mem-table is flushed to its own segment reserved in order.
+OLAPStatus MemTableFlushExecutor::create_flush_token(std::unique_ptr<FlushToken>* flush_token,
+                                                     bool should_concurrent) {
+    int max_flushing = config::max_flushing_memtables_per_writer;
+    if (should_concurrent && max_flushing > 1) {
+        flush_token->reset(new FlushToken(
+                _flush_pool->new_token(ThreadPool::ExecutionMode::CONCURRENT), max_flushing));
+    } else {
+        flush_token->reset(
+                new FlushToken(_flush_pool->new_token(ThreadPool::ExecutionMode::SERIAL)));
+    }
     return OLAP_SUCCESS;
 }
 
@@ -18,7 +18,9 @@
 #pragma once
 
 #include <atomic>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 #include <vector>
 
 #include "olap/olap_define.h"
@@ -34,9 +36,9 @@ class MemTable;
 // the statistic of a certain flush handler.
 // use atomic because it may be updated by multi threads
 struct FlushStatistic {
-    int64_t flush_time_ns = 0;
-    int64_t flush_count = 0;
-    int64_t flush_size_bytes = 0;
+    std::atomic<int64_t> flush_time_ns{0};
+    std::atomic<int64_t> flush_count{0};
+    std::atomic<int64_t> flush_size_bytes{0};
 };
 
 std::ostream& operator<<(std::ostream& os, const FlushStatistic& stat);
@@ -48,10 +50,18 @@ std::ostream& operator<<(std::ostream& os, const FlushStatistic& stat);
 // 1. Immediately disallow submission of any subsequent memtable
 // 2. For the memtables that have already been submitted, there is no need to flush,
 //    because the entire job will definitely fail;
+//
+// If max_flushing is greater than 1, up to max_flushing memtables are flushed
+// concurrently, each to the segment reserved for it, and submit() blocks while
+// so many memtables are flushing.
 class FlushToken {
 public:
-    explicit FlushToken(std::unique_ptr<ThreadPoolToken> flush_pool_token)
-            : _flush_token(std::move(flush_pool_token)), _flush_status(OLAP_SUCCESS) {}
+    explicit FlushToken(std::unique_ptr<ThreadPoolToken> flush_pool_token, int max_flushing = 1)
+            : _flush_token(std::move(flush_pool_token)),
+              _flush_status(OLAP_SUCCESS),
+              _max_flushing(max_flushing) {}
+
+    bool is_concurrent() const { return _max_flushing > 1; }
 
     OLAPStatus submit(const std::shared_ptr<MemTable>& mem_table);
 
@@ -74,6 +84,12 @@ private:
     // Note: Once its value is set to Failed, it cannot return to SUCCESS.
     std::atomic<OLAPStatus> _flush_status;
 
+    const int _max_flushing;
+    // Guards _num_flushing, which is only maintained in concurrent mode
+    std::mutex _lock;
+    std::condition_variable _cv;
+    int _num_flushing = 0;
+
     FlushStatistic _stats;
 };
 
@@ -95,7 +111,10 @@ public:
     // because it needs path hash of each data dir.
     void init(const std::vector<DataDir*>& data_dirs);
 
-    OLAPStatus create_flush_token(std::unique_ptr<FlushToken>* flush_token);
+    // Memtables are flushed concurrently if should_concurrent is true and
+    // config::max_flushing_memtables_per_writer is greater than 1.
+    OLAPStatus create_flush_token(std::unique_ptr<FlushToken>* flush_token,
+                                  bool should_concurrent = false);
 
 private:
     std::unique_ptr<ThreadPool> _flush_pool;
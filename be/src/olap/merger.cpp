@@ -17,13 +17,24 @@
 
 #include "olap/merger.h"
 
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <map>
 #include <memory>
 #include <vector>
 
+#include "olap/generic_iterators.h"
 #include "olap/olap_define.h"
 #include "olap/reader.h"
+#include "olap/row.h"
+#include "olap/row_block2.h"
 #include "olap/row_cursor.h"
+#include "olap/rowset/beta_rowset.h"
+#include "olap/rowset/segment_v2/segment.h"
+#include "olap/schema.h"
 #include "olap/tablet.h"
+#include "olap/zorder.h"
 #include "util/trace.h"
 
 namespace doris {
@@ -32,6 +43,15 @@ OLAPStatus Merger::merge_rowsets(TabletSharedPtr tablet, ReaderType reader_type,
                                  const std::vector<RowsetReaderSharedPtr>& src_rowset_readers,
                                  RowsetWriter* dst_rowset_writer,
                                  Merger::Statistics* stats_output) {
+    return merge_rowsets(tablet, reader_type, src_rowset_readers, OlapTuple(), OlapTuple(),
+                         dst_rowset_writer, stats_output);
+}
+
+OLAPStatus Merger::merge_rowsets(TabletSharedPtr tablet, ReaderType reader_type,
+                                 const std::vector<RowsetReaderSharedPtr>& src_rowset_readers,
+                                 const OlapTuple& start_key, const OlapTuple& end_key,
+                                 RowsetWriter* dst_rowset_writer,
+                                 Merger::Statistics* stats_output) {
     TRACE_COUNTER_SCOPE_LATENCY_US("merge_rowsets_latency_us");
 
     Reader reader;
@@ -40,6 +60,12 @@ OLAPStatus Merger::merge_rowsets(TabletSharedPtr tablet, ReaderType reader_type,
     reader_params.reader_type = reader_type;
     reader_params.rs_readers = src_rowset_readers;
     reader_params.version = dst_rowset_writer->version();
+    if (start_key.size() > 0) {
+        reader_params.range = "ge";
+        reader_params.end_range = "lt";
+        reader_params.start_key.push_back(start_key);
+        reader_params.end_key.push_back(end_key);
+    }
     RETURN_NOT_OK(reader.init(reader_params));
 
     RowCursor row_cursor;
@@ -51,6 +77,34 @@ OLAPStatus Merger::merge_rowsets(TabletSharedPtr tablet, ReaderType reader_type,
     std::shared_ptr<MemTracker> tracker(new MemTracker(-1));
     std::unique_ptr<MemPool> mem_pool(new MemPool(tracker.get()));
 
+    // The rows of a clustered tablet are copied to sort_pool, and sorted by Z-order and
+    // written once they take clustering_compaction_sort_bytes.
+    const TabletSchema& tablet_schema = tablet->tablet_schema();
+    Schema schema(tablet_schema);
+    std::unique_ptr<ZOrderSorter> zorder_sorter;
+    std::unique_ptr<MemPool> sort_pool;
+    std::vector<char*> sort_rows;
+    if (tablet_schema.is_clustered()) {
+        std::vector<uint32_t> column_ids(tablet_schema.clustering_col_idxs().begin(),
+                                         tablet_schema.clustering_col_idxs().end());
+        zorder_sorter.reset(new ZOrderSorter(&schema, column_ids));
+        sort_pool.reset(new MemPool(tracker.get()));
+    }
+    auto write_sort_rows = [&]() -> OLAPStatus {
+        zorder_sorter->sort(&sort_rows);
+        std::vector<ContiguousRow> rows;
+        rows.reserve(sort_rows.size());
+        for (char* row : sort_rows) {
+            rows.emplace_back(&schema, row);
+        }
+        RETURN_NOT_OK_LOG(
+                dst_rowset_writer->add_rows(rows),
+                "failed to write rows when merging rowsets of tablet " + tablet->full_name());
+        sort_rows.clear();
+        sort_pool->clear();
+        return OLAP_SUCCESS;
+    };
+
     // The following procedure would last for long time, half of one day, etc.
     int64_t output_rows = 0;
     while (true) {
@@ -63,9 +117,19 @@ OLAPStatus Merger::merge_rowsets(TabletSharedPtr tablet, ReaderType reader_type,
         if (eof) {
             break;
         }
-        RETURN_NOT_OK_LOG(
-                dst_rowset_writer->add_row(row_cursor),
-                "failed to write row when merging rowsets of tablet " + tablet->full_name());
+        if (zorder_sorter != nullptr) {
+            char* row = (char*)sort_pool->allocate(schema.schema_size());
+            ContiguousRow dst_row(&schema, row);
+            copy_row(&dst_row, row_cursor, sort_pool.get());
+            sort_rows.push_back(row);
+            if (sort_pool->total_allocated_bytes() >= config::clustering_compaction_sort_bytes) {
+                RETURN_NOT_OK(write_sort_rows());
+            }
+        } else {
+            RETURN_NOT_OK_LOG(
+                    dst_rowset_writer->add_row(row_cursor),
+                    "failed to write row when merging rowsets of tablet " + tablet->full_name());
+        }
         output_rows++;
         LOG_IF(INFO, config::row_step_for_compaction_merge_log != 0 &&
                              output_rows % config::row_step_for_compaction_merge_log == 0)
@@ -76,6 +140,10 @@ OLAPStatus Merger::merge_rowsets(TabletSharedPtr tablet, ReaderType reader_type,
         mem_pool->clear();
     }
 
+    if (!sort_rows.empty()) {
+        RETURN_NOT_OK(write_sort_rows());
+    }
+
     if (stats_output != nullptr) {
         stats_output->output_rows = output_rows;
         stats_output->merged_rows = reader.merged_rows();
@@ -88,4 +156,385 @@ OLAPStatus Merger::merge_rowsets(TabletSharedPtr tablet, ReaderType reader_type,
     return OLAP_SUCCESS;
 }
 
+bool Merger::can_vertical_merge(TabletSharedPtr tablet,
+                                const std::vector<RowsetSharedPtr>& src_rowsets,
+                                RowsetWriter* dst_rowset_writer) {
+    // the rows of clustered tablets are not written in the order of keys
+    if (!config::enable_vertical_compaction || tablet->keys_type() != DUP_KEYS ||
+        !dst_rowset_writer->support_vertical_write() || tablet->tablet_schema().is_clustered()) {
+        return false;
+    }
+    const TabletSchema& schema = tablet->tablet_schema();
+    // nothing to gain if all columns fit in one group
+    if (schema.num_columns() - schema.num_key_columns() <=
+        static_cast<size_t>(config::vertical_compaction_num_columns_per_group)) {
+        return false;
+    }
+    size_t num_segments = 0;
+    for (auto& rowset : src_rowsets) {
+        // the rows deleted by bitmap are skipped by Reader only
+        if (rowset->rowset_meta()->rowset_type() != BETA_ROWSET ||
+            rowset->rowset_meta()->has_delete_predicate() ||
+            tablet->tablet_meta()->delete_bitmap().contains(rowset->rowset_id())) {
+            return false;
+        }
+        num_segments += rowset->num_segments();
+    }
+    // the input of every row is recorded in uint16_t
+    return num_segments <= std::numeric_limits<uint16_t>::max();
+}
+
+// Create an iterator over the columns `column_ids` of all `segments`. The key group is
+// merged and records the input of every row into `row_sources`, value groups follow it.
+static Status new_segments_iterator(const std::vector<segment_v2::SegmentSharedPtr>& segments,
+                                    const TabletSchema& tablet_schema,
+                                    const std::vector<uint32_t>& column_ids, bool is_key,
+                                    const StorageReadOptions& read_options,
+                                    std::vector<uint16_t>* row_sources,
+                                    std::unique_ptr<RowwiseIterator>* iter) {
+    Schema schema(tablet_schema.columns(), column_ids);
+    std::vector<RowwiseIterator*> iterators;
+    for (auto& segment : segments) {
+        std::unique_ptr<RowwiseIterator> seg_iter;
+        auto s = segment->new_iterator(schema, read_options, &seg_iter);
+        if (!s.ok()) {
+            for (auto it : iterators) {
+                delete it;
+            }
+            return s;
+        }
+        iterators.push_back(seg_iter.release());
+    }
+    if (is_key) {
+        iter->reset(new_merge_iterator(std::move(iterators), row_sources));
+    } else {
+        iter->reset(new_row_sources_iterator(std::move(iterators), row_sources));
+    }
+    return (*iter)->init(read_options);
+}
+
+OLAPStatus Merger::vertical_merge_rowsets(TabletSharedPtr tablet,
+                                          const std::vector<RowsetSharedPtr>& src_rowsets,
+                                          RowsetWriter* dst_rowset_writer,
+                                          Merger::Statistics* stats_output) {
+    TRACE_COUNTER_SCOPE_LATENCY_US("vertical_merge_rowsets_latency_us");
+    const TabletSchema& tablet_schema = tablet->tablet_schema();
+
+    std::vector<segment_v2::SegmentSharedPtr> segments;
+    int64_t input_rows = 0;
+    int64_t input_size = 0;
+    for (auto& rowset : src_rowsets) {
+        auto beta_rowset = std::static_pointer_cast<BetaRowset>(rowset);
+        std::vector<segment_v2::SegmentSharedPtr> rowset_segments;
+        RETURN_NOT_OK_LOG(beta_rowset->load_segments(&rowset_segments),
+                          "failed to load rowset when merging rowsets of tablet " +
+                                  tablet->full_name());
+        segments.insert(segments.end(), rowset_segments.begin(), rowset_segments.end());
+        input_rows += rowset->num_rows();
+        input_size += rowset->data_disk_size();
+    }
+    // Segments are cut by rows when key columns are written, so estimate the rows of a
+    // segment of the max size from the size of input rows.
+    uint32_t max_rows_per_segment = std::numeric_limits<uint32_t>::max();
+    if (input_rows > 0 && input_size > 0) {
+        int64_t max_segment_size = static_cast<int64_t>(OLAP_MAX_COLUMN_SEGMENT_FILE_SIZE *
+                                                        OLAP_COLUMN_FILE_SEGMENT_SIZE_SCALE);
+        int64_t row_size = std::max<int64_t>(1, input_size / input_rows);
+        max_rows_per_segment = std::max<int64_t>(
+                1, std::min<int64_t>(max_rows_per_segment, max_segment_size / row_size));
+    }
+
+    // key columns are the first group, value columns are split into groups of
+    // vertical_compaction_num_columns_per_group columns. The two columns of an S2 index
+    // are in the same group, which builds the index.
+    size_t num_columns_per_group =
+            std::max<int32_t>(1, config::vertical_compaction_num_columns_per_group);
+    std::map<uint32_t, uint32_t> s2_index_columns;
+    for (uint32_t cid = 0; cid < tablet_schema.num_columns(); ++cid) {
+        const TabletColumn& column = tablet_schema.column(cid);
+        if (!column.has_s2_index()) {
+            continue;
+        }
+        for (uint32_t lat_cid = 0; lat_cid < tablet_schema.num_columns(); ++lat_cid) {
+            if (tablet_schema.column(lat_cid).unique_id() == column.s2_index_lat_unique_id()) {
+                s2_index_columns[cid] = lat_cid;
+                s2_index_columns[lat_cid] = cid;
+            }
+        }
+    }
+    std::vector<std::vector<uint32_t>> column_groups(1);
+    std::vector<bool> grouped(tablet_schema.num_columns(), false);
+    for (uint32_t cid = 0; cid < tablet_schema.num_columns(); ++cid) {
+        if (grouped[cid]) {
+            continue;
+        }
+        if (cid >= tablet_schema.num_key_columns() &&
+            (cid == tablet_schema.num_key_columns() ||
+             column_groups.back().size() >= num_columns_per_group)) {
+            column_groups.emplace_back();
+        }
+        column_groups.back().push_back(cid);
+        grouped[cid] = true;
+        auto it = s2_index_columns.find(cid);
+        if (it != s2_index_columns.end() && !grouped[it->second]) {
+            column_groups.back().push_back(it->second);
+            grouped[it->second] = true;
+            std::sort(column_groups.back().begin(), column_groups.back().end());
+        }
+    }
+    if (segments.empty()) {
+        column_groups.clear();
+    }
+
+    OlapReaderStatistics stats;
+    StorageReadOptions read_options;
+    read_options.stats = &stats;
+
+    // input segment of every output row
+    std::vector<uint16_t> row_sources;
+    row_sources.reserve(input_rows);
+    int64_t output_rows = 0;
+    for (size_t i = 0; i < column_groups.size(); ++i) {
+        bool is_key = i == 0;
+        std::unique_ptr<RowwiseIterator> iter;
+        auto s = new_segments_iterator(segments, tablet_schema, column_groups[i], is_key,
+                                       read_options, &row_sources, &iter);
+        if (!s.ok()) {
+            LOG(WARNING) << "failed to create iterator when merging rowsets of tablet "
+                         << tablet->full_name() << ": " << s.to_string();
+            return OLAP_ERR_ROWSET_READER_INIT;
+        }
+        RowBlockV2 block(iter->schema(), 1024);
+        while (true) {
+            block.clear();
+            s = iter->next_batch(&block);
+            if (s.is_end_of_file()) {
+                break;
+            } else if (!s.ok()) {
+                LOG(WARNING) << "failed to read next block when merging rowsets of tablet "
+                             << tablet->full_name() << ": " << s.to_string();
+                return OLAP_ERR_ROWSET_READ_FAILED;
+            }
+            RETURN_NOT_OK_LOG(dst_rowset_writer->add_columns(block, column_groups[i], is_key,
+                                                             max_rows_per_segment),
+                              "failed to write columns when merging rowsets of tablet " +
+                                      tablet->full_name());
+            if (is_key) {
+                output_rows += block.selected_size();
+            }
+        }
+        RETURN_NOT_OK_LOG(dst_rowset_writer->flush_columns(),
+                          "failed to flush columns when merging rowsets of tablet " +
+                                  tablet->full_name());
+    }
+    RETURN_NOT_OK_LOG(
+            dst_rowset_writer->final_flush(),
+            "failed to flush rowset when merging rowsets of tablet " + tablet->full_name());
+
+    if (stats_output != nullptr) {
+        stats_output->output_rows = output_rows;
+        stats_output->merged_rows = 0;
+        stats_output->filtered_rows = 0;
+    }
+    return OLAP_SUCCESS;
+}
+
+bool Merger::can_block_merge(TabletSharedPtr tablet,
+                             const std::vector<RowsetSharedPtr>& src_rowsets,
+                             RowsetWriter* dst_rowset_writer) {
+    if (!config::enable_block_compaction || dst_rowset_writer->type() != BETA_ROWSET ||
+        tablet->enable_unique_key_merge_on_write() ||
+        tablet->tablet_schema().has_sequence_col() || tablet->tablet_schema().is_clustered()) {
+        return false;
+    }
+    for (auto& rowset : src_rowsets) {
+        // the null values of rows of partial columns are filled by Reader only, and the
+        // rows deleted by bitmap are skipped by Reader only
+        if (rowset->rowset_meta()->rowset_type() != BETA_ROWSET ||
+            rowset->rowset_meta()->has_delete_predicate() ||
+            rowset->rowset_meta()->partial_columns() ||
+            tablet->tablet_meta()->delete_bitmap().contains(rowset->rowset_id())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+OLAPStatus Merger::block_merge_rowsets(TabletSharedPtr tablet,
+                                       const std::vector<RowsetSharedPtr>& src_rowsets,
+                                       RowsetWriter* dst_rowset_writer,
+                                       Merger::Statistics* stats_output) {
+    TRACE_COUNTER_SCOPE_LATENCY_US("block_merge_rowsets_latency_us");
+    const TabletSchema& tablet_schema = tablet->tablet_schema();
+    KeysType keys_type = tablet_schema.keys_type();
+    Schema schema(tablet_schema);
+
+    OlapReaderStatistics stats;
+    StorageReadOptions read_options;
+    read_options.stats = &stats;
+
+    // Equal rows are returned by merge iterator in reverse order of inputs. For UNIQUE_KEYS
+    // the first one is kept, so inputs are from old to new. For AGG_KEYS rows are aggregated
+    // in order, so inputs are from new to old to make REPLACE take the newest value.
+    std::vector<RowsetSharedPtr> rowsets(src_rowsets);
+    if (keys_type == AGG_KEYS) {
+        std::reverse(rowsets.begin(), rowsets.end());
+    }
+    std::vector<std::unique_ptr<RowwiseIterator>> inputs;
+    for (auto& rowset : rowsets) {
+        auto beta_rowset = std::static_pointer_cast<BetaRowset>(rowset);
+        std::vector<segment_v2::SegmentSharedPtr> segments;
+        RETURN_NOT_OK_LOG(beta_rowset->load_segments(&segments),
+                          "failed to load rowset when merging rowsets of tablet " +
+                                  tablet->full_name());
+        std::vector<std::unique_ptr<RowwiseIterator>> seg_iters;
+        for (auto& segment : segments) {
+            std::unique_ptr<RowwiseIterator> iter;
+            auto s = segment->new_iterator(schema, read_options, &iter);
+            if (!s.ok()) {
+                LOG(WARNING) << "failed to create iterator when merging rowsets of tablet "
+                             << tablet->full_name() << ": " << s.to_string();
+                return OLAP_ERR_ROWSET_READER_INIT;
+            }
+            seg_iters.push_back(std::move(iter));
+        }
+        if (rowset->rowset_meta()->is_segments_overlapping()) {
+            if (keys_type == AGG_KEYS) {
+                std::reverse(seg_iters.begin(), seg_iters.end());
+            }
+            std::move(seg_iters.begin(), seg_iters.end(), std::back_inserter(inputs));
+        } else if (!seg_iters.empty()) {
+            // non-overlapping segments are ordered by keys already
+            std::vector<RowwiseIterator*> iters;
+            for (auto& iter : seg_iters) {
+                iters.push_back(iter.release());
+            }
+            inputs.emplace_back(new_union_iterator(std::move(iters)));
+        }
+    }
+
+    int64_t output_rows = 0;
+    int64_t merged_rows = 0;
+    if (!inputs.empty()) {
+        std::vector<RowwiseIterator*> iters;
+        for (auto& iter : inputs) {
+            iters.push_back(iter.release());
+        }
+        std::unique_ptr<RowwiseIterator> iter(new_merge_iterator(std::move(iters)));
+        auto s = iter->init(read_options);
+        if (!s.ok()) {
+            LOG(WARNING) << "failed to init iterator when merging rowsets of tablet "
+                         << tablet->full_name() << ": " << s.to_string();
+            return OLAP_ERR_ROWSET_READER_INIT;
+        }
+
+        // A run of rows with equal keys is aggregated into `agg_row`, which may go across
+        // blocks. Other rows are written as they are.
+        std::vector<uint8_t> agg_buf(schema.schema_size());
+        std::vector<uint8_t> src_buf(schema.schema_size());
+        ContiguousRow agg_row(&schema, agg_buf.data());
+        ContiguousRow src_row(&schema, src_buf.data());
+        bool has_agg_row = false;
+        std::shared_ptr<MemTracker> tracker(new MemTracker(-1));
+        std::unique_ptr<MemPool> mem_pool(new MemPool(tracker.get()));
+        ObjectPool agg_object_pool;
+
+        auto init_agg_row = [&](const RowBlockRow& row) {
+            copy_row(&src_row, row, mem_pool.get());
+            if (keys_type == AGG_KEYS) {
+                init_row_with_others(&agg_row, src_row, mem_pool.get(), &agg_object_pool);
+            } else {
+                direct_copy_row(&agg_row, src_row);
+            }
+            has_agg_row = true;
+        };
+        // UNIQUE_KEYS keeps the first row of a run
+        auto update_agg_row = [&](const RowBlockRow& row) {
+            if (keys_type == AGG_KEYS) {
+                direct_copy_row(&src_row, row);
+                agg_update_row(&agg_row, src_row, mem_pool.get());
+            }
+            ++merged_rows;
+        };
+        auto flush_agg_row = [&]() -> OLAPStatus {
+            if (keys_type == AGG_KEYS) {
+                agg_finalize_row(&agg_row, mem_pool.get());
+            }
+            RETURN_NOT_OK(dst_rowset_writer->add_row(agg_row));
+            ++output_rows;
+            has_agg_row = false;
+            mem_pool->clear();
+            agg_object_pool.clear();
+            return OLAP_SUCCESS;
+        };
+
+        RowBlockV2 block(schema, 1024);
+        while (true) {
+            block.clear();
+            s = iter->next_batch(&block);
+            if (s.is_end_of_file()) {
+                break;
+            } else if (!s.ok()) {
+                LOG(WARNING) << "failed to read next block when merging rowsets of tablet "
+                             << tablet->full_name() << ": " << s.to_string();
+                return OLAP_ERR_ROWSET_READ_FAILED;
+            }
+            const uint16_t* selection = block.selection_vector();
+            size_t num_rows = block.selected_size();
+            if (keys_type == DUP_KEYS) {
+                RETURN_NOT_OK_LOG(dst_rowset_writer->add_block(block, 0, num_rows),
+                                  "failed to write block when merging rowsets of tablet " +
+                                          tablet->full_name());
+                output_rows += num_rows;
+                continue;
+            }
+            size_t i = 0;
+            while (i < num_rows) {
+                if (!has_agg_row) {
+                    // rows [start, i) differ from their next rows, they are written directly
+                    size_t start = i;
+                    while (i + 1 < num_rows && compare_row(block.row(selection[i]),
+                                                           block.row(selection[i + 1])) != 0) {
+                        ++i;
+                    }
+                    if (i > start) {
+                        RETURN_NOT_OK_LOG(dst_rowset_writer->add_block(block, start, i - start),
+                                          "failed to write block when merging rowsets of tablet " +
+                                                  tablet->full_name());
+                        output_rows += i - start;
+                    }
+                    // row i is the last row of block or equal to the next row
+                    init_agg_row(block.row(selection[i]));
+                    ++i;
+                }
+                while (i < num_rows && compare_row(agg_row, block.row(selection[i])) == 0) {
+                    update_agg_row(block.row(selection[i]));
+                    ++i;
+                }
+                if (i < num_rows) {
+                    RETURN_NOT_OK_LOG(flush_agg_row(),
+                                      "failed to write row when merging rowsets of tablet " +
+                                              tablet->full_name());
+                }
+            }
+        }
+        if (has_agg_row) {
+            RETURN_NOT_OK_LOG(flush_agg_row(),
+                              "failed to write row when merging rowsets of tablet " +
+                                      tablet->full_name());
+        }
+    }
+
+    if (stats_output != nullptr) {
+        stats_output->output_rows = output_rows;
+        stats_output->merged_rows = merged_rows;
+        stats_output->filtered_rows = 0;
+    }
+
+    RETURN_NOT_OK_LOG(
+            dst_rowset_writer->flush(),
+            "failed to flush rowset when merging rowsets of tablet " + tablet->full_name());
+    return OLAP_SUCCESS;
+}
+
 } // namespace doris
@@ -21,6 +21,7 @@
 #include "olap/olap_define.h"
 #include "olap/rowset/rowset_writer.h"
 #include "olap/tablet.h"
+#include "olap/tuple.h"
 
 namespace doris {
 
@@ -39,6 +40,41 @@ public:
     static OLAPStatus merge_rowsets(TabletSharedPtr tablet, ReaderType reader_type,
                                     const std::vector<RowsetReaderSharedPtr>& src_rowset_readers,
                                     RowsetWriter* dst_rowset_writer, Statistics* stats_output);
+
+    // Like merge_rowsets(), but only merge the rows whose keys are in [start_key, end_key),
+    // or not less than start_key if end_key is empty, so that the key ranges of a tablet
+    // can be merged in parallel. The keys are prefixes of the key columns.
+    static OLAPStatus merge_rowsets(TabletSharedPtr tablet, ReaderType reader_type,
+                                    const std::vector<RowsetReaderSharedPtr>& src_rowset_readers,
+                                    const OlapTuple& start_key, const OlapTuple& end_key,
+                                    RowsetWriter* dst_rowset_writer, Statistics* stats_output);
+
+    // Like merge_rowsets(), but merge the key columns of `src_rowsets` first to decide the
+    // order of output rows, then write the value columns in that order group by group,
+    // so that only a few columns are in memory at any time. Rows are neither aggregated
+    // nor filtered, so this is only for duplicate key tablets whose input rowsets are
+    // beta rowsets without delete predicate, see can_vertical_merge().
+    static OLAPStatus vertical_merge_rowsets(TabletSharedPtr tablet,
+                                             const std::vector<RowsetSharedPtr>& src_rowsets,
+                                             RowsetWriter* dst_rowset_writer,
+                                             Statistics* stats_output);
+
+    static bool can_vertical_merge(TabletSharedPtr tablet,
+                                   const std::vector<RowsetSharedPtr>& src_rowsets,
+                                   RowsetWriter* dst_rowset_writer);
+
+    // Like merge_rowsets(), but rows are read in RowBlockV2 from segments and runs of
+    // rows with distinct keys are written to segments column by column. Only rows with
+    // equal keys are aggregated one by one. It is for beta rowsets without delete
+    // predicate, see can_block_merge().
+    static OLAPStatus block_merge_rowsets(TabletSharedPtr tablet,
+                                          const std::vector<RowsetSharedPtr>& src_rowsets,
+                                          RowsetWriter* dst_rowset_writer,
+                                          Statistics* stats_output);
+
+    static bool can_block_merge(TabletSharedPtr tablet,
+                                const std::vector<RowsetSharedPtr>& src_rowsets,
+                                RowsetWriter* dst_rowset_writer);
 };
 
 } // namespace doris
@@ -71,10 +71,15 @@ void NullPredicate::evaluate(ColumnBlock* block, uint16_t* sel, uint16_t* size)
         *size = 0;
         return;
     }
+    if (!block->is_nullable()) {
+        // no row is null and the predicate is "is not null"
+        return;
+    }
+    const bool* is_null = block->vector_batch()->null_signs();
     for (uint16_t i = 0; i < *size; ++i) {
         uint16_t idx = sel[i];
         sel[new_size] = idx;
-        new_size += (block->cell(idx).is_null() == _is_null);
+        new_size += (is_null[idx] == _is_null);
     }
     *size = new_size;
 }
@@ -243,6 +243,13 @@ struct OlapReaderStatistics {
     int64_t rows_vec_cond_filtered = 0;
     int64_t vec_cond_ns = 0;
 
+    int64_t rows_block_filter_filtered = 0;
+    int64_t block_filter_ns = 0;
+
+    // data pages read ahead and time waited for them
+    int64_t read_ahead_pages_num = 0;
+    int64_t read_ahead_wait_ns = 0;
+
     int64_t rows_key_range_filtered = 0;
     int64_t rows_stats_filtered = 0;
     int64_t rows_bf_filtered = 0;
@@ -254,14 +261,24 @@ struct OlapReaderStatistics {
     int64_t rows_del_filtered = 0;
     // the number of rows filtered by various column indexes.
     int64_t rows_conditions_filtered = 0;
+    // the number of rows replaced by later loads of a merge-on-write tablet
+    int64_t rows_del_by_bitmap = 0;
 
     int64_t index_load_ns = 0;
 
     int64_t total_pages_num = 0;
     int64_t cached_pages_num = 0;
+    // compressed bytes of the pages found in the page cache, rather than read from the files
+    int64_t cached_bytes_read = 0;
+    // segment files opened, rather than found in the file cache
+    int64_t file_open_num = 0;
 
     int64_t rows_bitmap_index_filtered = 0;
     int64_t bitmap_index_filter_timer = 0;
+    int64_t rows_ngram_index_filtered = 0;
+    int64_t ngram_index_filter_timer = 0;
+    int64_t rows_s2_index_filtered = 0;
+    int64_t s2_index_filter_timer = 0;
     // number of segment filtered by column stat when creating seg iterator
     int64_t filtered_segment_number = 0;
     // total number of segment
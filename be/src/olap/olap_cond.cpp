@@ -19,12 +19,15 @@
 
 #include <thrift/protocol/TDebugProtocol.h>
 
+#include <algorithm>
 #include <cstring>
+#include <memory>
 #include <string>
 #include <utility>
 
 #include "olap/olap_common.h"
 #include "olap/olap_define.h"
+#include "olap/row_block2.h"
 #include "olap/utils.h"
 #include "olap/wrapper_field.h"
 
@@ -456,20 +459,21 @@ bool Cond::eval(const segment_v2::BloomFilter* bf) const {
         return existed;
     }
     case OP_IN: {
-        FieldSet::const_iterator it = operand_set.begin();
-        for (; it != operand_set.end(); ++it) {
-            bool existed = false;
-            if ((*it)->is_string_type()) {
-                Slice* slice = (Slice*)((*it)->ptr());
-                existed = bf->test_bytes(slice->data, slice->size);
+        // hash all the values first, so that the bloom filter probes them in a batch
+        std::vector<uint64_t> hashes;
+        hashes.reserve(operand_set.size());
+        for (const WrapperField* field : operand_set) {
+            if (field->is_string_type()) {
+                Slice* slice = (Slice*)(field->ptr());
+                hashes.push_back(bf->hash(slice->data, slice->size));
             } else {
-                existed = bf->test_bytes((*it)->ptr(), (*it)->size());
-            }
-            if (existed) {
-                return true;
+                hashes.push_back(bf->hash(field->ptr(), field->size()));
             }
         }
-        return false;
+        std::unique_ptr<bool[]> existed(new bool[hashes.size()]);
+        bf->test_hashes(hashes.data(), hashes.size(), existed.get());
+        return std::any_of(existed.get(), existed.get() + hashes.size(),
+                           [](bool e) { return e; });
     }
     case OP_IS: {
         // IS [NOT] NULL can only used in to filter IS NULL predicate.
@@ -512,6 +516,31 @@ bool CondColumn::eval(const RowCursor& row) const {
     return true;
 }
 
+void CondColumn::eval(const ColumnBlock& block, const uint16_t* sel, uint16_t size,
+                      bool* satisfied) const {
+    // Cond::eval() takes a cell laid out as in RowCursor, i.e. a null byte followed
+    // by the value, so the values are copied into such a cell one by one.
+    const size_t value_size = block.type_info()->size();
+    std::unique_ptr<char[]> buf(new char[1 + value_size]);
+    RowCursorCell cell(buf.get());
+    for (uint16_t i = 0; i < size; ++i) {
+        if (!satisfied[i]) {
+            continue;
+        }
+        uint16_t idx = sel[i];
+        cell.set_is_null(block.is_null(idx));
+        if (!cell.is_null()) {
+            memcpy(cell.mutable_cell_ptr(), block.cell_ptr(idx), value_size);
+        }
+        for (auto& each_cond : _conds) {
+            if (!each_cond->eval(cell)) {
+                satisfied[i] = false;
+                break;
+            }
+        }
+    }
+}
+
 bool CondColumn::eval(const std::pair<WrapperField*, WrapperField*>& statistic) const {
     //通过一列上的所有查询条件对version进行过滤
     for (auto& each_cond : _conds) {
@@ -623,6 +652,41 @@ bool Conditions::delete_conditions_eval(const RowCursor& row) const {
     return true;
 }
 
+void Conditions::delete_conditions_eval(const RowBlockV2& block, uint16_t* sel,
+                                        uint16_t* size) const {
+    if (_columns.empty() || *size == 0) {
+        return;
+    }
+
+    // a row is deleted when it satisfies the conditions of all columns
+    std::unique_ptr<bool[]> deleted(new bool[*size]);
+    std::fill(deleted.get(), deleted.get() + *size, true);
+    for (auto& each_cond : _columns) {
+        if (_cond_column_is_key_or_duplicate(each_cond.second)) {
+            each_cond.second->eval(block.column_block(each_cond.first), sel, *size,
+                                   deleted.get());
+        }
+    }
+
+    uint16_t new_size = 0;
+    for (uint16_t i = 0; i < *size; ++i) {
+        if (!deleted[i]) {
+            sel[new_size++] = sel[i];
+        }
+    }
+    *size = new_size;
+}
+
+std::vector<ColumnId> Conditions::delete_condition_columns() const {
+    std::vector<ColumnId> cids;
+    for (auto& each_cond : _columns) {
+        if (_cond_column_is_key_or_duplicate(each_cond.second)) {
+            cids.push_back(each_cond.first);
+        }
+    }
+    return cids;
+}
+
 bool Conditions::rowset_pruning_filter(const std::vector<KeyRange>& zone_maps) const {
     // ZoneMap will store min/max of rowset.
     // The function is to filter rowset using ZoneMaps
@@ -27,6 +27,7 @@
 #include "gen_cpp/PaloInternalService_types.h"
 #include "gen_cpp/column_data_file.pb.h"
 #include "olap/bloom_filter.hpp"
+#include "olap/column_block.h"
 #include "olap/field.h"
 #include "olap/row_cursor.h"
 #include "olap/rowset/segment_v2/bloom_filter.h"
@@ -36,6 +37,7 @@ namespace doris {
 
 class WrapperField;
 class RowCursorCell;
+class RowBlockV2;
 
 enum CondOp {
     OP_NULL = -1, // invalid op
@@ -111,6 +113,12 @@ public:
     // 对一行数据中的指定列，用所有过滤条件进行比较，如果所有条件都满足，则过滤此行
     bool eval(const RowCursor& row) const;
 
+    // Evaluate all conditions on the rows of 'block' selected by the first 'size'
+    // entries of 'sel', and set satisfied[i] to false if row sel[i] doesn't satisfy
+    // them. Rows whose satisfied[i] is already false are skipped.
+    void eval(const ColumnBlock& block, const uint16_t* sel, uint16_t size,
+              bool* satisfied) const;
+
     bool eval(const std::pair<WrapperField*, WrapperField*>& statistic) const;
     int del_eval(const std::pair<WrapperField*, WrapperField*>& statistic) const;
 
@@ -166,6 +174,14 @@ public:
 
     bool delete_conditions_eval(const RowCursor& row) const;
 
+    // Remove the rows which meet the delete conditions from the selection vector
+    // 'sel' of '*size' rows of 'block', the order of the remaining rows is preserved.
+    // All columns returned by delete_condition_columns() must be in the block.
+    void delete_conditions_eval(const RowBlockV2& block, uint16_t* sel, uint16_t* size) const;
+
+    // Columns read by delete_conditions_eval()
+    std::vector<ColumnId> delete_condition_columns() const;
+
     bool rowset_pruning_filter(const std::vector<KeyRange>& zone_maps) const;
     int delete_pruning_filter(const std::vector<KeyRange>& zone_maps) const;
 
@@ -250,6 +250,8 @@ enum OLAPStatus {
     OLAP_ERR_PUSH_BATCH_PROCESS_REMOVED = -912,
     OLAP_ERR_PUSH_COMMIT_ROWSET = -913,
     OLAP_ERR_PUSH_ROWSET_NOT_FOUND = -914,
+    // a version of a merge-on-write tablet is published before the former ones
+    OLAP_ERR_PUBLISH_VERSION_NOT_CONTINUOUS = -915,
 
     // SegmentGroup
     // [-1000, -1100)
@@ -17,15 +17,18 @@
 
 #include "olap/olap_meta.h"
 
+#include <algorithm>
 #include <sstream>
 #include <vector>
 
+#include "common/config.h"
 #include "common/logging.h"
 #include "olap/olap_define.h"
 #include "rocksdb/db.h"
 #include "rocksdb/options.h"
 #include "rocksdb/slice.h"
 #include "rocksdb/slice_transform.h"
+#include "rocksdb/write_batch.h"
 #include "util/doris_metrics.h"
 #include "util/runtime_profile.h"
 
@@ -36,6 +39,7 @@ using rocksdb::ColumnFamilyHandle;
 using rocksdb::ColumnFamilyOptions;
 using rocksdb::ReadOptions;
 using rocksdb::WriteOptions;
+using rocksdb::WriteBatch;
 using rocksdb::Slice;
 using rocksdb::Iterator;
 using rocksdb::kDefaultColumnFamilyName;
@@ -104,41 +108,82 @@ OLAPStatus OlapMeta::get(const int column_family_index, const std::string& key,
 
 OLAPStatus OlapMeta::put(const int column_family_index, const std::string& key,
                          const std::string& value) {
+    return _write({{column_family_index, key, value, false}}, OLAP_ERR_META_PUT);
+}
+
+OLAPStatus OlapMeta::remove(const int column_family_index, const std::string& key) {
+    return _write({{column_family_index, key, "", true}}, OLAP_ERR_META_DELETE);
+}
+
+OLAPStatus OlapMeta::write_batch(const std::vector<WriteOp>& ops) {
+    if (ops.empty()) {
+        return OLAP_SUCCESS;
+    }
+    return _write(ops, OLAP_ERR_META_PUT);
+}
+
+OLAPStatus OlapMeta::_write(const std::vector<WriteOp>& ops, OLAPStatus error_status) {
     DorisMetrics::instance()->meta_write_request_total->increment(1);
-    rocksdb::ColumnFamilyHandle* handle = _handles[column_family_index];
     int64_t duration_ns = 0;
     rocksdb::Status s;
     {
         SCOPED_RAW_TIMER(&duration_ns);
-        WriteOptions write_options;
-        write_options.sync = config::sync_tablet_meta;
-        s = _db->Put(write_options, handle, Slice(key), Slice(value));
+        s = _group_commit(ops);
     }
     DorisMetrics::instance()->meta_write_request_duration_us->increment(duration_ns / 1000);
     if (!s.ok()) {
-        LOG(WARNING) << "rocks db put key:" << key << " failed, reason:" << s.ToString();
-        return OLAP_ERR_META_PUT;
+        LOG(WARNING) << "rocks db write key:" << ops[0].key << " failed, op_num:" << ops.size()
+                     << ", reason:" << s.ToString();
+        return error_status;
     }
     return OLAP_SUCCESS;
 }
 
-OLAPStatus OlapMeta::remove(const int column_family_index, const std::string& key) {
-    DorisMetrics::instance()->meta_write_request_total->increment(1);
-    rocksdb::ColumnFamilyHandle* handle = _handles[column_family_index];
-    rocksdb::Status s;
-    int64_t duration_ns = 0;
-    {
-        SCOPED_RAW_TIMER(&duration_ns);
-        WriteOptions write_options;
-        write_options.sync = config::sync_tablet_meta;
-        s = _db->Delete(write_options, handle, Slice(key));
+rocksdb::Status OlapMeta::_group_commit(const std::vector<WriteOp>& ops) {
+    WriteRequest request;
+    request.ops = &ops;
+
+    std::unique_lock<std::mutex> l(_write_lock);
+    _write_queue.push_back(&request);
+    while (!request.done && &request != _write_queue.front()) {
+        _write_cv.wait(l);
     }
-    DorisMetrics::instance()->meta_write_request_duration_us->increment(duration_ns / 1000);
-    if (!s.ok()) {
-        LOG(WARNING) << "rocks db delete key:" << key << " failed, reason:" << s.ToString();
-        return OLAP_ERR_META_DELETE;
+    if (request.done) {
+        // written by another leader
+        return request.status;
     }
-    return OLAP_SUCCESS;
+
+    // this request is the leader, take the queued requests into one batch
+    WriteBatch batch;
+    size_t group_size = 0;
+    size_t max_group_size = std::max<int32_t>(1, config::meta_group_commit_max_requests);
+    for (auto it = _write_queue.begin(); it != _write_queue.end() && group_size < max_group_size;
+         ++it, ++group_size) {
+        for (auto& op : *(*it)->ops) {
+            rocksdb::ColumnFamilyHandle* handle = _handles[op.column_family_index];
+            if (op.is_remove) {
+                batch.Delete(handle, Slice(op.key));
+            } else {
+                batch.Put(handle, Slice(op.key), Slice(op.value));
+            }
+        }
+    }
+    l.unlock();
+
+    WriteOptions write_options;
+    write_options.sync = config::sync_tablet_meta;
+    rocksdb::Status s = _db->Write(write_options, &batch);
+
+    l.lock();
+    for (size_t i = 0; i < group_size; ++i) {
+        WriteRequest* member = _write_queue.front();
+        _write_queue.pop_front();
+        member->status = s;
+        member->done = true;
+    }
+    // wake up the followers and the leader of next group
+    _write_cv.notify_all();
+    return s;
 }
 
 OLAPStatus OlapMeta::iterate(
@@ -18,9 +18,13 @@
 #ifndef DORIS_BE_SRC_OLAP_OLAP_OLAP_META_H
 #define DORIS_BE_SRC_OLAP_OLAP_OLAP_META_H
 
+#include <condition_variable>
+#include <deque>
 #include <functional>
 #include <map>
+#include <mutex>
 #include <string>
+#include <vector>
 
 #include "olap/olap_define.h"
 #include "rocksdb/db.h"
@@ -41,6 +45,17 @@ public:
 
     OLAPStatus remove(const int column_family_index, const std::string& key);
 
+    struct WriteOp {
+        int column_family_index;
+        std::string key;
+        // ignored for remove
+        std::string value;
+        bool is_remove;
+    };
+
+    // write all ops atomically in one rocksdb write batch
+    OLAPStatus write_batch(const std::vector<WriteOp>& ops);
+
     OLAPStatus iterate(const int column_family_index, const std::string& prefix,
                        std::function<bool(const std::string&, const std::string&)> const& func);
 
@@ -50,10 +65,27 @@ public:
 
     OLAPStatus set_tablet_convert_finished();
 
+private:
+    struct WriteRequest {
+        const std::vector<WriteOp>* ops;
+        rocksdb::Status status;
+        bool done = false;
+    };
+
+    // Group commit: concurrent writers queue their ops, the writer at the head of the
+    // queue writes the ops of the queued requests in one write batch for all of them.
+    rocksdb::Status _group_commit(const std::vector<WriteOp>& ops);
+
+    OLAPStatus _write(const std::vector<WriteOp>& ops, OLAPStatus error_status);
+
 private:
     std::string _root_path;
     rocksdb::DB* _db;
     std::vector<rocksdb::ColumnFamilyHandle*> _handles;
+
+    std::mutex _write_lock;
+    std::condition_variable _write_cv;
+    std::deque<WriteRequest*> _write_queue;
 };
 
 } // namespace doris
@@ -29,7 +29,10 @@
 #include "olap/cumulative_compaction.h"
 #include "olap/olap_common.h"
 #include "olap/olap_define.h"
+#include "olap/rowset_conversion.h"
 #include "olap/storage_engine.h"
+#include "olap/tablet_column_statistics.h"
+#include "olap/tablet_index_builder.h"
 #include "util/time.h"
 
 using std::string;
@@ -81,6 +84,30 @@ Status StorageEngine::start_bg_threads() {
             &_compaction_tasks_producer_thread));
     LOG(INFO) << "compaction tasks producer thread started";
 
+    RETURN_IF_ERROR(ThreadPoolBuilder("RowsetConversionThreadPool")
+                            .set_min_threads(1)
+                            .set_max_threads(std::max(1, config::rowset_conversion_thread_num))
+                            .build(&_rowset_conversion_thread_pool));
+    RETURN_IF_ERROR(Thread::create(
+            "StorageEngine", "rowset_conversion_producer_thread",
+            [this]() { this->_rowset_conversion_producer_callback(); },
+            &_rowset_conversion_producer_thread));
+    LOG(INFO) << "rowset conversion producer thread started";
+
+    RETURN_IF_ERROR(ThreadPoolBuilder("IndexBuildThreadPool")
+                            .set_min_threads(1)
+                            .set_max_threads(std::max(1, config::index_build_thread_num))
+                            .build(&_index_build_thread_pool));
+    RETURN_IF_ERROR(Thread::create(
+            "StorageEngine", "index_build_producer_thread",
+            [this]() { this->_index_build_producer_callback(); }, &_index_build_producer_thread));
+    LOG(INFO) << "index build producer thread started";
+
+    RETURN_IF_ERROR(Thread::create(
+            "StorageEngine", "column_statistics_thread",
+            [this]() { this->_column_statistics_thread_callback(); }, &_column_statistics_thread));
+    LOG(INFO) << "column statistics thread started";
+
     // tablet checkpoint thread
     for (auto data_dir : data_dirs) {
         scoped_refptr<Thread> tablet_checkpoint_thread;
@@ -321,6 +348,7 @@ void StorageEngine::_compaction_tasks_producer_callback() {
         data_dirs.push_back(tmp_store.second);
         _tablet_submitted_compaction[tmp_store.second] = tablet_submitted;
     }
+    _io_limiter.init(data_dirs);
 
     int round = 0;
     CompactionType compaction_type;
@@ -333,6 +361,7 @@ void StorageEngine::_compaction_tasks_producer_callback() {
                 compaction_type = CompactionType::BASE_COMPACTION;
                 round = 0;
             }
+            _io_limiter.update();
             std::vector<TabletSharedPtr> tablets_compaction =
                     _compaction_tasks_generator(compaction_type, data_dirs);
             if (tablets_compaction.size() == 0) {
@@ -389,7 +418,8 @@ std::vector<TabletSharedPtr> StorageEngine::_compaction_tasks_generator(
     std::random_shuffle(data_dirs.begin(), data_dirs.end());
     for (auto data_dir : data_dirs) {
         std::unique_lock<std::mutex> lock(_tablet_submitted_compaction_mutex);
-        if (_tablet_submitted_compaction[data_dir].size() >= config::compaction_task_num_per_disk) {
+        if (_tablet_submitted_compaction[data_dir].size() >= config::compaction_task_num_per_disk ||
+            !_io_limiter.admit(data_dir, _tablet_submitted_compaction[data_dir].size())) {
             continue;
         }
         if (!data_dir->reach_capacity_limit(0)) {
@@ -400,6 +430,176 @@ std::vector<TabletSharedPtr> StorageEngine::_compaction_tasks_generator(
             }
         }
     }
+    // tablets queried more often are submitted first, so they get permits first
+    std::vector<std::pair<double, TabletSharedPtr>> scan_frequencies;
+    for (auto& tablet : tablets_compaction) {
+        double scan_frequency = tablet->calculate_scan_frequency();
+        scan_frequencies.emplace_back(std::isnan(scan_frequency) ? 0 : scan_frequency, tablet);
+    }
+    std::stable_sort(scan_frequencies.begin(), scan_frequencies.end(),
+                     [](const std::pair<double, TabletSharedPtr>& a,
+                        const std::pair<double, TabletSharedPtr>& b) { return a.first > b.first; });
+    for (size_t i = 0; i < scan_frequencies.size(); ++i) {
+        tablets_compaction[i] = scan_frequencies[i].second;
+    }
     return tablets_compaction;
 }
+
+void StorageEngine::_rowset_conversion_producer_callback() {
+#ifdef GOOGLE_PROFILER
+    ProfilerRegisterThread();
+#endif
+    int32_t interval = config::rowset_conversion_check_interval_sec;
+    while (!_stop_background_threads_latch.wait_for(
+            MonoDelta::FromSeconds(std::max(1, interval)))) {
+        interval = config::rowset_conversion_check_interval_sec;
+        if (!config::enable_rowset_conversion) {
+            continue;
+        }
+        _io_limiter.update();
+        int64_t num_rowsets = 0;
+        for (auto data_dir : get_stores()) {
+            std::vector<TabletSharedPtr> tablets;
+            {
+                std::lock_guard<std::mutex> lock(_tablet_submitted_conversion_mutex);
+                const std::set<TTabletId>& submitted = _tablet_submitted_conversion[data_dir];
+                size_t max_num = 0;
+                if (submitted.size() < config::rowset_conversion_task_num_per_disk &&
+                    _io_limiter.admit(data_dir, submitted.size()) &&
+                    !data_dir->reach_capacity_limit(0)) {
+                    max_num = config::rowset_conversion_task_num_per_disk - submitted.size();
+                }
+                num_rowsets += _tablet_manager->find_tablets_to_convert_rowsets(
+                        data_dir, submitted, max_num, &tablets);
+            }
+            for (auto& tablet : tablets) {
+                _submit_rowset_conversion(tablet);
+            }
+        }
+        DorisMetrics::instance()->rowset_conversion_remaining_rowsets->set_value(num_rowsets);
+    }
+}
+
+void StorageEngine::_submit_rowset_conversion(const TabletSharedPtr& tablet) {
+    std::string tracker_label = "rowset conversion " + std::to_string(tablet->tablet_id());
+    std::shared_ptr<RowsetConversion> conversion(
+            new RowsetConversion(tablet, tracker_label, _compaction_mem_tracker));
+    if (conversion->prepare_compact() != OLAP_SUCCESS) {
+        return;
+    }
+    int64_t permits = conversion->permits();
+    if (!_permit_limiter.request(permits)) {
+        return;
+    }
+    DataDir* data_dir = tablet->data_dir();
+    TTabletId tablet_id = tablet->tablet_id();
+    {
+        std::lock_guard<std::mutex> lock(_tablet_submitted_conversion_mutex);
+        _tablet_submitted_conversion[data_dir].insert(tablet_id);
+    }
+    auto st = _rowset_conversion_thread_pool->submit_func([=]() {
+        CgroupsMgr::apply_system_cgroup();
+        OLAPStatus res = conversion->execute_compact();
+        if (res != OLAP_SUCCESS) {
+            LOG(WARNING) << "failed to convert rowset. res=" << res
+                         << ", tablet=" << tablet->full_name();
+        }
+        _permit_limiter.release(permits);
+        std::lock_guard<std::mutex> lock(_tablet_submitted_conversion_mutex);
+        _tablet_submitted_conversion[data_dir].erase(tablet_id);
+    });
+    if (!st.ok()) {
+        _permit_limiter.release(permits);
+        std::lock_guard<std::mutex> lock(_tablet_submitted_conversion_mutex);
+        _tablet_submitted_conversion[data_dir].erase(tablet_id);
+    }
+}
+
+void StorageEngine::_index_build_producer_callback() {
+#ifdef GOOGLE_PROFILER
+    ProfilerRegisterThread();
+#endif
+    int32_t interval = config::index_build_check_interval_sec;
+    while (!_stop_background_threads_latch.wait_for(
+            MonoDelta::FromSeconds(std::max(1, interval)))) {
+        interval = config::index_build_check_interval_sec;
+        _io_limiter.update();
+        int64_t num_rowsets = 0;
+        for (auto data_dir : get_stores()) {
+            std::vector<TabletSharedPtr> tablets;
+            {
+                std::lock_guard<std::mutex> lock(_tablet_submitted_index_build_mutex);
+                const std::set<TTabletId>& submitted = _tablet_submitted_index_build[data_dir];
+                size_t max_num = 0;
+                if (submitted.size() < config::index_build_task_num_per_disk &&
+                    _io_limiter.admit(data_dir, submitted.size()) &&
+                    !data_dir->reach_capacity_limit(0)) {
+                    max_num = config::index_build_task_num_per_disk - submitted.size();
+                }
+                num_rowsets += _tablet_manager->find_tablets_to_build_index(data_dir, submitted,
+                                                                            max_num, &tablets);
+            }
+            for (auto& tablet : tablets) {
+                _submit_index_build(tablet);
+            }
+        }
+        DorisMetrics::instance()->index_build_remaining_rowsets->set_value(num_rowsets);
+    }
+}
+
+void StorageEngine::_submit_index_build(const TabletSharedPtr& tablet) {
+    DataDir* data_dir = tablet->data_dir();
+    TTabletId tablet_id = tablet->tablet_id();
+    {
+        std::lock_guard<std::mutex> lock(_tablet_submitted_index_build_mutex);
+        _tablet_submitted_index_build[data_dir].insert(tablet_id);
+    }
+    auto st = _index_build_thread_pool->submit_func([=]() {
+        CgroupsMgr::apply_system_cgroup();
+        OLAPStatus res = TabletIndexBuilder(tablet).run();
+        if (res != OLAP_SUCCESS) {
+            LOG(WARNING) << "failed to build index. res=" << res
+                         << ", tablet=" << tablet->full_name();
+        }
+        std::lock_guard<std::mutex> lock(_tablet_submitted_index_build_mutex);
+        _tablet_submitted_index_build[data_dir].erase(tablet_id);
+    });
+    if (!st.ok()) {
+        std::lock_guard<std::mutex> lock(_tablet_submitted_index_build_mutex);
+        _tablet_submitted_index_build[data_dir].erase(tablet_id);
+    }
+}
+
+void StorageEngine::_column_statistics_thread_callback() {
+#ifdef GOOGLE_PROFILER
+    ProfilerRegisterThread();
+#endif
+    int32_t interval = config::column_statistics_collect_interval_sec;
+    while (!_stop_background_threads_latch.wait_for(
+            MonoDelta::FromSeconds(std::max(1, interval)))) {
+        interval = config::column_statistics_collect_interval_sec;
+        if (!config::enable_column_statistics) {
+            continue;
+        }
+        std::vector<TabletSharedPtr> tablets;
+        _tablet_manager->find_tablets_to_collect_column_statistics(
+                std::max(0, config::column_statistics_collect_tablet_num_per_round), &tablets);
+        for (auto& tablet : tablets) {
+            int64_t version = -1;
+            std::vector<TColumnStatistics> stats;
+            OLAPStatus res = TabletColumnStatisticsCollector(tablet).collect(&version, &stats);
+            if (res != OLAP_SUCCESS) {
+                // not retried until the next version, and nothing is reported meanwhile
+                VLOG(3) << "failed to collect column statistics. res=" << res
+                        << ", tablet=" << tablet->full_name();
+                stats.clear();
+            }
+            tablet->set_column_statistics(version, std::move(stats));
+            if (_stop_background_threads_latch.count() == 0) {
+                break;
+            }
+        }
+    }
+}
+
 } // namespace doris
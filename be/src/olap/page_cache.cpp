@@ -17,30 +17,86 @@
 
 #include "olap/page_cache.h"
 
+#include <algorithm>
+
+#include "common/config.h"
+
 namespace doris {
 
 StoragePageCache* StoragePageCache::_s_instance = nullptr;
 
-void StoragePageCache::create_global_cache(size_t capacity) {
+// Number of file ids kept, each entry is charged 1.
+static const size_t kFileIdCacheCapacity = 64 * 1024;
+// Used to estimate how many data pages fit in data page cache
+static const size_t kTypicalDataPageSize = 64 * 1024;
+static const size_t kMinDataPageGhosts = 1024;
+
+void StoragePageCache::create_global_cache(size_t capacity, int32_t index_cache_percentage) {
     DCHECK(_s_instance == nullptr);
-    static StoragePageCache instance(capacity);
+    static StoragePageCache instance(capacity, index_cache_percentage);
     _s_instance = &instance;
 }
 
-StoragePageCache::StoragePageCache(size_t capacity)
-        : _cache(new_lru_cache("StoragePageCache", capacity)) {}
+StoragePageCache::StoragePageCache(size_t capacity, int32_t index_cache_percentage) {
+    DCHECK(index_cache_percentage >= 0 && index_cache_percentage <= 100);
+    size_t index_capacity = capacity / 100 * index_cache_percentage;
+    size_t data_capacity = capacity - index_capacity;
+    // Page lookups of concurrent scanners dominate, hits must not serialize on the shard lock
+    _data_page_cache.reset(new_lru_cache("DataPageCache", data_capacity, LRUCacheType::CLOCK));
+    _index_page_cache.reset(
+            new_lru_cache("IndexPageCache", index_capacity, LRUCacheType::CLOCK));
+    // Remember about as many keys as the pages the data page cache can hold, so
+    // that a page accessed twice before that many other pages is admitted.
+    _data_page_ghosts.reset(new_lru_cache(
+            "DataPageGhosts", std::max(data_capacity / kTypicalDataPageSize, kMinDataPageGhosts)));
+    _file_ids.reset(new_lru_cache("StoragePageCacheFileIds", kFileIdCacheCapacity,
+                                  LRUCacheType::CLOCK));
+}
 
-bool StoragePageCache::lookup(const CacheKey& key, PageCacheHandle* handle) {
-    auto lru_handle = _cache->lookup(key.encode());
+uint64_t StoragePageCache::file_id(const std::string& fname) {
+    auto handle = _file_ids->lookup(fname);
+    if (handle == nullptr) {
+        // If two threads insert the same file concurrently, the file just has its
+        // pages cached under two ids.
+        auto deleter = [](const doris::CacheKey& key, void* value) {};
+        uint64_t id = _file_ids->new_id();
+        handle = _file_ids->insert(fname, reinterpret_cast<void*>(id), 1, deleter);
+    }
+    uint64_t id = reinterpret_cast<uint64_t>(_file_ids->value(handle));
+    _file_ids->release(handle);
+    return id;
+}
+
+bool StoragePageCache::lookup(const CacheKey& key, PageCacheHandle* handle,
+                              segment_v2::PageTypePB page_type) {
+    Cache* cache = _get_cache(page_type);
+    auto lru_handle = cache->lookup(key.encode());
     if (lru_handle == nullptr) {
         return false;
     }
-    *handle = PageCacheHandle(_cache.get(), lru_handle);
+    *handle = PageCacheHandle(cache, lru_handle);
     return true;
 }
 
+bool StoragePageCache::admit(const CacheKey& key, segment_v2::PageTypePB page_type,
+                             bool in_memory) {
+    if (in_memory || page_type != segment_v2::DATA_PAGE ||
+        !config::storage_page_cache_admit_on_second_access) {
+        return true;
+    }
+    auto ghost = _data_page_ghosts->lookup(key.encode());
+    if (ghost != nullptr) {
+        _data_page_ghosts->release(ghost);
+        _data_page_ghosts->erase(key.encode());
+        return true;
+    }
+    auto deleter = [](const doris::CacheKey& key, void* value) {};
+    _data_page_ghosts->release(_data_page_ghosts->insert(key.encode(), nullptr, 1, deleter));
+    return false;
+}
+
 void StoragePageCache::insert(const CacheKey& key, const Slice& data, PageCacheHandle* handle,
-                              bool in_memory) {
+                              segment_v2::PageTypePB page_type, bool in_memory) {
     auto deleter = [](const doris::CacheKey& key, void* value) { delete[](uint8_t*) value; };
 
     CachePriority priority = CachePriority::NORMAL;
@@ -48,8 +104,9 @@ void StoragePageCache::insert(const CacheKey& key, const Slice& data, PageCacheH
         priority = CachePriority::DURABLE;
     }
 
-    auto lru_handle = _cache->insert(key.encode(), data.data, data.size, deleter, priority);
-    *handle = PageCacheHandle(_cache.get(), lru_handle);
+    Cache* cache = _get_cache(page_type);
+    auto lru_handle = cache->insert(key.encode(), data.data, data.size, deleter, priority);
+    *handle = PageCacheHandle(cache, lru_handle);
 }
 
 } // namespace doris
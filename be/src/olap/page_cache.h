@@ -21,6 +21,7 @@
 #include <string>
 #include <utility>
 
+#include "gen_cpp/segment_v2.pb.h"
 #include "gutil/macros.h" // for DISALLOW_COPY_AND_ASSIGN
 #include "olap/lru_cache.h"
 
@@ -30,36 +31,49 @@ class PageCacheHandle;
 
 // Wrapper around Cache, and used for cache page of column data
 // in Segment.
-// TODO(zc): We should add some metric to see cache hit/miss rate.
+//
+// Data pages and the other pages (index, dictionary and short key pages) are
+// kept in two caches of independent capacities, so that a large scan can't
+// evict the index pages point queries depend on. Besides, a data page read
+// from disk is only admitted on its second access within a while (see admit()),
+// pages touched once by a scan don't flush the data pages read repeatedly.
+//
+// Hit, miss and eviction counts are reported by the metric entities
+// "lru_cache:DataPageCache" and "lru_cache:IndexPageCache".
 class StoragePageCache {
 public:
     // The unique key identifying entries in the page cache.
     // Each cached page corresponds to a specific offset within
-    // a file.
-    //
-    // TODO(zc): Now we use file name(std::string) as a part of
-    // key, which is not efficient. We should make it better later
+    // a file, which is identified by the id returned by file_id().
     struct CacheKey {
-        CacheKey(std::string fname_, int64_t offset_) : fname(std::move(fname_)), offset(offset_) {}
-        std::string fname;
+        CacheKey(uint64_t file_id_, int64_t offset_) : file_id(file_id_), offset(offset_) {}
+        uint64_t file_id;
         int64_t offset;
 
-        // Encode to a flat binary which can be used as LRUCache's key
-        std::string encode() const {
-            std::string key_buf(fname);
-            key_buf.append((char*)&offset, sizeof(offset));
-            return key_buf;
+        // Encode to a flat binary which can be used as LRUCache's key.
+        // The returned key refers to this object.
+        doris::CacheKey encode() const {
+            return doris::CacheKey(reinterpret_cast<const char*>(this), sizeof(*this));
         }
     };
 
-    // Create global instance of this class
-    static void create_global_cache(size_t capacity);
+    // Create global instance of this class.
+    // 'index_cache_percentage' of 'capacity' is used to cache pages other than
+    // data pages.
+    static void create_global_cache(size_t capacity, int32_t index_cache_percentage);
 
     // Return global instance.
     // Client should call create_global_cache before.
     static StoragePageCache* instance() { return _s_instance; }
 
-    StoragePageCache(size_t capacity);
+    StoragePageCache(size_t capacity, int32_t index_cache_percentage);
+
+    // Return the id which identifies file 'fname' in CacheKey, readers should get
+    // it once and keep it rather than call this for every page.
+    //
+    // Ids are never reused. A file may be given a new id after its id is evicted,
+    // then pages cached under the old id are no longer hit and will be evicted.
+    uint64_t file_id(const std::string& fname);
 
     // Lookup the given page in the cache.
     //
@@ -68,7 +82,13 @@ public:
     // destructs.
     //
     // Return true if entry is found, otherwise return false.
-    bool lookup(const CacheKey& key, PageCacheHandle* handle);
+    bool lookup(const CacheKey& key, PageCacheHandle* handle,
+                segment_v2::PageTypePB page_type);
+
+    // Whether a page just read from disk should be inserted. Returns false
+    // for a data page which isn't accessed recently, the access is recorded
+    // so that it's admitted next time.
+    bool admit(const CacheKey& key, segment_v2::PageTypePB page_type, bool in_memory);
 
     // Insert a page with key into this cache.
     // Given handle will be set to valid reference.
@@ -76,15 +96,27 @@ public:
     // concurrently, this function can assure that only one page is cached.
     // The in_memory page will have higher priority.
     void insert(const CacheKey& key, const Slice& data, PageCacheHandle* handle,
-                bool in_memory = false);
+                segment_v2::PageTypePB page_type, bool in_memory = false);
 
 private:
     StoragePageCache();
     static StoragePageCache* _s_instance;
 
-    std::unique_ptr<Cache> _cache = nullptr;
+    Cache* _get_cache(segment_v2::PageTypePB page_type) const {
+        return page_type == segment_v2::DATA_PAGE ? _data_page_cache.get()
+                                                  : _index_page_cache.get();
+    }
+
+    std::unique_ptr<Cache> _data_page_cache = nullptr;
+    std::unique_ptr<Cache> _index_page_cache = nullptr;
+    // keys of data pages accessed once recently, values are unused
+    std::unique_ptr<Cache> _data_page_ghosts = nullptr;
+    // file name -> id, the id is stored as the value pointer
+    std::unique_ptr<Cache> _file_ids = nullptr;
 };
 
+static_assert(sizeof(StoragePageCache::CacheKey) == 16, "CacheKey should not have padding");
+
 // A handle for StoragePageCache entry. This class make it easy to handle
 // Cache entry. Users don't need to release the obtained cache entry. This
 // class will release the cache entry when it is destroyed.
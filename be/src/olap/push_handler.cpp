@@ -22,6 +22,7 @@
 #include <iostream>
 #include <sstream>
 
+#include "common/config.h"
 #include "common/status.h"
 #include "exec/parquet_scanner.h"
 #include "olap/row.h"
@@ -173,6 +174,10 @@ OLAPStatus PushHandler::_do_streaming_ingestion(TabletSharedPtr tablet, const TP
             tablet_var.tablet->obtain_header_rdlock();
             res = del_cond_handler.generate_delete_predicate(tablet_var.tablet->tablet_schema(),
                                                              request.delete_conditions, &del_pred);
+            if (config::enable_delete_by_bitmap &&
+                tablet_var.tablet->tablet_meta()->preferred_rowset_type() == BETA_ROWSET) {
+                del_pred.set_by_bitmap(true);
+            }
             del_preds.push(del_pred);
             tablet_var.tablet->release_header_lock();
             if (res != OLAP_SUCCESS) {
@@ -22,11 +22,13 @@
 #include "olap/collect_iterator.h"
 #include "olap/comparison_predicate.h"
 #include "olap/in_list_predicate.h"
+#include "olap/like_column_predicate.h"
 #include "olap/null_predicate.h"
 #include "olap/row.h"
 #include "olap/row_block.h"
 #include "olap/row_cursor.h"
 #include "olap/rowset/column_data.h"
+#include "olap/s2_column_predicate.h"
 #include "olap/storage_engine.h"
 #include "olap/tablet.h"
 #include "runtime/mem_pool.h"
@@ -84,7 +86,7 @@ std::string Reader::KeysParam::to_string() const {
         ss << " keys=" << start_key->to_string();
     }
     for (auto end_key : end_keys) {
-        ss << " end_keys=" << end_key->to_string();
+        ss << " end_keys=" << (end_key != nullptr ? end_key->to_string() : "unbounded");
     }
 
     return ss.str();
@@ -123,6 +125,9 @@ OLAPStatus Reader::init(const ReaderParams& read_params) {
     if (_rs_readers.size() == 1 &&
         !_rs_readers[0]->rowset()->rowset_meta()->is_segments_overlapping()) {
         _next_row_func = &Reader::_dup_key_next_row;
+    } else if (_reader_type == READER_QUERY && _tablet->enable_unique_key_merge_on_write()) {
+        // replaced rows are skipped by delete bitmap, the rows left are unique
+        _next_row_func = &Reader::_dup_key_next_row;
     } else {
         switch (_tablet->keys_type()) {
         case KeysType::DUP_KEYS:
@@ -182,10 +187,10 @@ OLAPStatus Reader::_agg_key_next_row(RowCursor* row_cursor, MemPool* mem_pool, O
         }
 
         // break while can NOT doing aggregation
-        if (!equal_row(_key_cids, *row_cursor, *_next_key)) {
+        if (!_merge_funcs.equal(*row_cursor, *_next_key)) {
             break;
         }
-        agg_update_row(_value_cids, row_cursor, *_next_key);
+        _merge_funcs.agg_update(row_cursor, *_next_key);
         ++merged_count;
     } while (true);
     _merged_rows += merged_count;
@@ -212,6 +217,9 @@ OLAPStatus Reader::_unique_key_next_row(RowCursor* row_cursor, MemPool* mem_pool
         // in UNIQUE_KEY highest version is the final result, there is no need to
         // merge the lower versions
         direct_copy_row(row_cursor, *_next_key);
+        // unless it's from a rowset of partial columns, whose null values are the columns
+        // not loaded and taken from the lower versions until a row of full columns
+        bool filling = _collect_iter->partial_columns();
         // skip the lower version rows;
         while (nullptr != _next_key) {
             auto res = _collect_iter->next(&_next_key, &_next_delete_flag);
@@ -222,7 +230,7 @@ OLAPStatus Reader::_unique_key_next_row(RowCursor* row_cursor, MemPool* mem_pool
                 break;
             }
             // break while can NOT doing aggregation
-            if (!equal_row(_key_cids, *row_cursor, *_next_key)) {
+            if (!_merge_funcs.equal(*row_cursor, *_next_key)) {
                 agg_finalize_row(_value_cids, row_cursor, mem_pool);
                 break;
             }
@@ -232,6 +240,14 @@ OLAPStatus Reader::_unique_key_next_row(RowCursor* row_cursor, MemPool* mem_pool
             if (_has_sequence_col) {
                 agg_update_row_with_sequence(_value_cids, row_cursor, *_next_key,
                                              _sequence_col_idx);
+            } else if (filling) {
+                // a deleted row doesn't exist, its values are not taken
+                if (_next_delete_flag) {
+                    filling = false;
+                } else {
+                    fill_null_cells(_value_cids, row_cursor, *_next_key);
+                    filling = _collect_iter->partial_columns();
+                }
             }
         }
 
@@ -327,6 +343,14 @@ OLAPStatus Reader::_capture_rs_readers(const ReaderParams& read_params) {
             // it's ok for rowset to return unordered result
             need_ordered_result = false;
         }
+        if (_tablet->enable_unique_key_merge_on_write()) {
+            // keys are unique after the replaced rows are skipped by delete bitmap
+            need_ordered_result = false;
+        }
+        if (_read_orderby_key) {
+            // the rows are limited by their order of keys
+            need_ordered_result = true;
+        }
     }
 
     _reader_context.reader_type = read_params.reader_type;
@@ -337,11 +361,36 @@ OLAPStatus Reader::_capture_rs_readers(const ReaderParams& read_params) {
     _reader_context.load_bf_columns = &_load_bf_columns;
     _reader_context.conditions = &_conditions;
     _reader_context.predicates = &_col_predicates;
+    _reader_context.block_filters = nullptr;
+    _block_filters_applied = false;
+    if (!read_params.block_filters.empty() && read_params.reader_type == READER_QUERY &&
+        _tablet->tablet_schema().keys_type() == DUP_KEYS) {
+        // rows of duplicate keys tables are never merged, so filtering them before
+        // they reach the reader doesn't change the result
+        bool all_beta = true;
+        for (auto& rs_reader : *rs_readers) {
+            if (rs_reader->rowset()->rowset_meta()->rowset_type() != BETA_ROWSET) {
+                all_beta = false;
+                break;
+            }
+        }
+        if (all_beta) {
+            _block_filters = read_params.block_filters;
+            _reader_context.block_filters = &_block_filters;
+            _block_filters_applied = true;
+        }
+    }
     _reader_context.lower_bound_keys = &_keys_param.start_keys;
     _reader_context.is_lower_keys_included = &_is_lower_keys_included;
     _reader_context.upper_bound_keys = &_keys_param.end_keys;
     _reader_context.is_upper_keys_included = &_is_upper_keys_included;
     _reader_context.delete_handler = &_delete_handler;
+    // rows of merge-on-write tablets replaced by newer loads, or deleted by bitmap
+    if (_tablet->enable_unique_key_merge_on_write() ||
+        !_tablet->tablet_meta()->delete_bitmap().empty()) {
+        _reader_context.delete_bitmap = &_tablet->tablet_meta()->delete_bitmap();
+        _reader_context.delete_bitmap_version = read_params.version.second;
+    }
     _reader_context.stats = &_stats;
     _reader_context.runtime_state = read_params.runtime_state;
     _reader_context.use_page_cache = read_params.use_page_cache;
@@ -364,6 +413,7 @@ OLAPStatus Reader::_init_params(const ReaderParams& read_params) {
 
     _aggregation = read_params.aggregation;
     _need_agg_finalize = read_params.need_agg_finalize;
+    _read_orderby_key = read_params.read_orderby_key;
     _reader_type = read_params.reader_type;
     _tablet = read_params.tablet;
 
@@ -456,6 +506,7 @@ OLAPStatus Reader::_init_return_columns(const ReaderParams& read_params) {
     }
 
     std::sort(_key_cids.begin(), _key_cids.end(), std::greater<uint32_t>());
+    _merge_funcs.init(_tablet->tablet_schema(), _key_cids, _value_cids);
 
     return OLAP_SUCCESS;
 }
@@ -472,7 +523,7 @@ void Reader::_init_seek_columns() {
         }
     }
     for (auto key : _keys_param.end_keys) {
-        if (key->field_count() > max_key_column_count) {
+        if (key != nullptr && key->field_count() > max_key_column_count) {
             max_key_column_count = key->field_count();
         }
     }
@@ -516,6 +567,10 @@ OLAPStatus Reader::_init_keys_param(const ReaderParams& read_params) {
     size_t end_key_size = read_params.end_key.size();
     _keys_param.end_keys.resize(end_key_size, NULL);
     for (size_t i = 0; i < end_key_size; ++i) {
+        // an empty end key leaves the range unbounded
+        if (read_params.end_key[i].size() == 0) {
+            continue;
+        }
         if ((_keys_param.end_keys[i] = new (nothrow) RowCursor()) == NULL) {
             OLAP_LOG_WARNING("fail to new RowCursor!");
             return OLAP_ERR_MALLOC_ERROR;
@@ -543,7 +598,10 @@ OLAPStatus Reader::_init_keys_param(const ReaderParams& read_params) {
 void Reader::_init_conditions_param(const ReaderParams& read_params) {
     _conditions.set_tablet_schema(&_tablet->tablet_schema());
     for (const auto& condition : read_params.conditions) {
-        DCHECK_EQ(OLAP_SUCCESS, _conditions.append_condition(condition));
+        // LIKE and geo predicates are only evaluated as column predicates
+        if (condition.condition_op != "like" && condition.condition_op != "s2") {
+            DCHECK_EQ(OLAP_SUCCESS, _conditions.append_condition(condition));
+        }
         ColumnPredicate* predicate = _parse_to_predicate(condition);
         if (predicate != nullptr) {
             _col_predicates.push_back(predicate);
@@ -790,6 +848,20 @@ ColumnPredicate* Reader::_parse_to_predicate(const TCondition& condition) {
         }
     } else if (condition.condition_op == "is") {
         predicate = new NullPredicate(index, condition.condition_values[0] == "null");
+    } else if (condition.condition_op == "like") {
+        if (column.type() == OLAP_FIELD_TYPE_CHAR || column.type() == OLAP_FIELD_TYPE_VARCHAR) {
+            predicate = new LikeColumnPredicate(index, condition.condition_values[0],
+                                                column.type() == OLAP_FIELD_TYPE_CHAR);
+        }
+    } else if (condition.condition_op == "s2") {
+        // values are the latitude column and the encoded shape, the S2 index of the
+        // longitude column is used only if it's built with the same latitude column
+        if (column.type() == OLAP_FIELD_TYPE_DOUBLE) {
+            int32_t lat_index = _tablet->field_index(condition.condition_values[0]);
+            int32_t lat_unique_id =
+                    lat_index < 0 ? -1 : _tablet->tablet_schema().column(lat_index).unique_id();
+            predicate = new S2ColumnPredicate(index, lat_unique_id, condition.condition_values[1]);
+        }
     }
     return predicate;
 }
@@ -35,6 +35,7 @@
 #include "olap/olap_cond.h"
 #include "olap/olap_define.h"
 #include "olap/row_cursor.h"
+#include "olap/row_merge_funcs.h"
 #include "olap/rowset/rowset_reader.h"
 #include "olap/tablet.h"
 #include "util/runtime_profile.h"
@@ -46,6 +47,7 @@ class RowCursor;
 class RowBlock;
 class CollectIterator;
 class RuntimeState;
+class BlockFilter;
 
 // Params for Reader,
 // mainly include tablet, data version and fetch range.
@@ -54,6 +56,9 @@ struct ReaderParams {
     ReaderType reader_type = READER_QUERY;
     bool aggregation = false;
     bool need_agg_finalize = true;
+    // Return rows of a query ordered by the keys even if the tablet does not need
+    // them merged, e.g. to serve a TOP-N limit on a key prefix.
+    bool read_orderby_key = false;
     // 1. when read column data page:
     //     for compaction, schema_change, check_sum: we don't use page cache
     //     for query and config::disable_storage_page_cache is false, we use page cache
@@ -66,11 +71,17 @@ struct ReaderParams {
     // possible values are "lt", "le"
     std::string end_range;
     std::vector<OlapTuple> start_key;
+    // an empty end key means the range has no upper bound, which is only supported by
+    // beta rowsets
     std::vector<OlapTuple> end_key;
     std::vector<TCondition> conditions;
     // The ColumnData will be set when using Merger, eg Cumulative, BE.
     std::vector<RowsetReaderSharedPtr> rs_readers;
     std::vector<uint32_t> return_columns;
+    // Filters the storage may evaluate on row blocks before reading the other
+    // columns. They are only applied to queries on duplicate keys tables whose
+    // rowsets are all beta rowsets, see Reader::block_filters_applied().
+    std::vector<BlockFilter*> block_filters;
     RuntimeProfile* profile = nullptr;
     RuntimeState* runtime_state = nullptr;
 
@@ -101,12 +112,17 @@ public:
     uint64_t merged_rows() const { return _merged_rows; }
 
     uint64_t filtered_rows() const {
-        return _stats.rows_del_filtered + _stats.rows_conditions_filtered;
+        return _stats.rows_del_filtered + _stats.rows_conditions_filtered +
+               _stats.rows_del_by_bitmap;
     }
 
     const OlapReaderStatistics& stats() const { return _stats; }
     OlapReaderStatistics* mutable_stats() { return &_stats; }
 
+    // Whether ReaderParams::block_filters are applied to all rows returned by
+    // this reader, otherwise the caller must evaluate them itself.
+    bool block_filters_applied() const { return _block_filters_applied; }
+
 private:
     struct KeysParam {
         ~KeysParam();
@@ -169,6 +185,8 @@ private:
     std::vector<bool> _is_upper_keys_included;
     Conditions _conditions;
     std::vector<ColumnPredicate*> _col_predicates;
+    std::vector<BlockFilter*> _block_filters;
+    bool _block_filters_applied = false;
     DeleteHandler _delete_handler;
 
     OLAPStatus (Reader::*_next_row_func)(RowCursor* row_cursor, MemPool* mem_pool,
@@ -177,6 +195,7 @@ private:
     bool _aggregation = false;
     // for agg query, we don't need to finalize when scan agg object data
     bool _need_agg_finalize = true;
+    bool _read_orderby_key = false;
     ReaderType _reader_type = READER_QUERY;
     bool _next_delete_flag = false;
     bool _filter_delete = false;
@@ -186,6 +205,8 @@ private:
     CollectIterator* _collect_iter = nullptr;
     std::vector<uint32_t> _key_cids;
     std::vector<uint32_t> _value_cids;
+    // equal_row() and agg_update_row() of _key_cids and _value_cids for the merges
+    RowMergeFuncs _merge_funcs;
 
     uint64_t _merged_rows = 0;
     OlapReaderStatistics _stats;
@@ -174,6 +174,21 @@ void agg_update_row_with_sequence(DstRowType* dst, const SrcRowType& src, uint32
     }
 }
 
+// Aggregate the non-null values of source row into destination row, the null values of
+// a row of partial columns are the columns not loaded.
+template <typename DstRowType, typename SrcRowType>
+void agg_update_row_if_not_null(DstRowType* dst, const SrcRowType& src, MemPool* mem_pool) {
+    for (uint32_t cid = dst->schema()->num_key_columns(); cid < dst->schema()->num_columns();
+         ++cid) {
+        auto src_cell = src.cell(cid);
+        if (src_cell.is_null()) {
+            continue;
+        }
+        auto dst_cell = dst->cell(cid);
+        dst->schema()->column(cid)->agg_update(&dst_cell, src_cell, mem_pool);
+    }
+}
+
 // Do aggregate update source row to destination row.
 // This function will operate on given cids.
 // TODO(zc): unify two versions of agg_update_row
@@ -203,6 +218,17 @@ void agg_update_row_with_sequence(const std::vector<uint32_t>& cids, DstRowType*
     }
 }
 
+// Copy the values of source row to the null cells of destination row on given cids.
+template <typename DstRowType, typename SrcRowType>
+void fill_null_cells(const std::vector<uint32_t>& cids, DstRowType* dst, const SrcRowType& src) {
+    for (auto cid : cids) {
+        auto dst_cell = dst->cell(cid);
+        if (dst_cell.is_null()) {
+            dst->schema()->column(cid)->direct_copy(&dst_cell, src.cell(cid));
+        }
+    }
+}
+
 template <typename RowType>
 void agg_finalize_row(RowType* row, MemPool* mem_pool) {
     for (uint32_t cid = row->schema()->num_key_columns(); cid < row->schema()->num_columns();
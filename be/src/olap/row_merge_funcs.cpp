@@ -0,0 +1,136 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/row_merge_funcs.h"
+
+#include "olap/tablet_schema.h"
+#include "olap/types.h"
+
+namespace doris {
+
+namespace {
+
+// Types of which the equal values are the equal bytes and the values are copied as bytes
+bool is_bytes_type(FieldType type) {
+    switch (type) {
+    case OLAP_FIELD_TYPE_TINYINT:
+    case OLAP_FIELD_TYPE_UNSIGNED_TINYINT:
+    case OLAP_FIELD_TYPE_SMALLINT:
+    case OLAP_FIELD_TYPE_UNSIGNED_SMALLINT:
+    case OLAP_FIELD_TYPE_INT:
+    case OLAP_FIELD_TYPE_UNSIGNED_INT:
+    case OLAP_FIELD_TYPE_BIGINT:
+    case OLAP_FIELD_TYPE_UNSIGNED_BIGINT:
+    case OLAP_FIELD_TYPE_LARGEINT:
+    case OLAP_FIELD_TYPE_DATE:
+    case OLAP_FIELD_TYPE_DATETIME:
+    case OLAP_FIELD_TYPE_BOOL:
+        return true;
+    default:
+        return false;
+    }
+}
+
+} // namespace
+
+bool RowMergeFuncs::_number_type(FieldType type, NumberType* number_type) {
+    switch (type) {
+    case OLAP_FIELD_TYPE_TINYINT:
+        *number_type = NumberType::INT8;
+        return true;
+    case OLAP_FIELD_TYPE_SMALLINT:
+        *number_type = NumberType::INT16;
+        return true;
+    case OLAP_FIELD_TYPE_INT:
+        *number_type = NumberType::INT32;
+        return true;
+    case OLAP_FIELD_TYPE_BIGINT:
+    case OLAP_FIELD_TYPE_DATETIME:
+        *number_type = NumberType::INT64;
+        return true;
+    case OLAP_FIELD_TYPE_LARGEINT:
+        *number_type = NumberType::INT128;
+        return true;
+    case OLAP_FIELD_TYPE_FLOAT:
+        *number_type = NumberType::FLOAT;
+        return true;
+    case OLAP_FIELD_TYPE_DOUBLE:
+        *number_type = NumberType::DOUBLE;
+        return true;
+    default:
+        return false;
+    }
+}
+
+void RowMergeFuncs::init(const TabletSchema& schema, const std::vector<uint32_t>& key_cids,
+                         const std::vector<uint32_t>& value_cids) {
+    _keys.clear();
+    for (uint32_t cid : key_cids) {
+        FieldType type = schema.column(cid).type();
+        KeyColumn key {cid, KeyKind::GENERIC, 0};
+        if (is_bytes_type(type)) {
+            key.kind = KeyKind::BYTES;
+            key.size = get_type_info(type)->size();
+        } else if (type == OLAP_FIELD_TYPE_CHAR || type == OLAP_FIELD_TYPE_VARCHAR) {
+            key.kind = KeyKind::SLICE;
+        }
+        _keys.push_back(key);
+    }
+
+    _values.clear();
+    for (uint32_t cid : value_cids) {
+        const TabletColumn& column = schema.column(cid);
+        FieldType type = column.type();
+        ValueColumn value {cid, ValueKind::GENERIC, NumberType::INT8, 0};
+        bool fixed = is_bytes_type(type) || type == OLAP_FIELD_TYPE_FLOAT ||
+                     type == OLAP_FIELD_TYPE_DOUBLE || type == OLAP_FIELD_TYPE_DECIMAL;
+        switch (column.aggregation()) {
+        case OLAP_FIELD_AGGREGATION_SUM:
+            if (_number_type(type, &value.number_type) && type != OLAP_FIELD_TYPE_DATETIME) {
+                value.kind = ValueKind::SUM;
+            }
+            break;
+        case OLAP_FIELD_AGGREGATION_MIN:
+            if (_number_type(type, &value.number_type)) {
+                value.kind = ValueKind::MIN;
+            }
+            break;
+        case OLAP_FIELD_AGGREGATION_MAX:
+            if (_number_type(type, &value.number_type)) {
+                value.kind = ValueKind::MAX;
+            }
+            break;
+        case OLAP_FIELD_AGGREGATION_REPLACE:
+            if (fixed) {
+                value.kind = ValueKind::REPLACE;
+                value.size = get_type_info(type)->size();
+            }
+            break;
+        case OLAP_FIELD_AGGREGATION_REPLACE_IF_NOT_NULL:
+            if (fixed) {
+                value.kind = ValueKind::REPLACE_IF_NOT_NULL;
+                value.size = get_type_info(type)->size();
+            }
+            break;
+        default:
+            break;
+        }
+        _values.push_back(value);
+    }
+}
+
+} // namespace doris
@@ -0,0 +1,236 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "olap/olap_common.h"
+#include "olap/row_cursor_cell.h"
+#include "util/slice.h"
+
+namespace doris {
+
+class TabletSchema;
+
+// The key comparison and the aggregation of the rows merged by Reader, resolved by the
+// column types once when the reader is initialized. The common columns, e.g. integer keys
+// and SUM/MIN/MAX/REPLACE of numbers, are compared and aggregated inline instead of
+// through the virtual TypeInfo and the AggregateInfo function pointers of each cell.
+// Other columns fall back to their Field.
+class RowMergeFuncs {
+public:
+    void init(const TabletSchema& schema, const std::vector<uint32_t>& key_cids,
+              const std::vector<uint32_t>& value_cids);
+
+    // Same as equal_row(key_cids, lhs, rhs)
+    template <typename LhsRowType, typename RhsRowType>
+    bool equal(const LhsRowType& lhs, const RhsRowType& rhs) const;
+
+    // Same as agg_update_row(value_cids, dst, src)
+    template <typename DstRowType, typename SrcRowType>
+    void agg_update(DstRowType* dst, const SrcRowType& src) const;
+
+private:
+    enum class KeyKind : uint8_t {
+        // equal if the bytes of the values are
+        BYTES,
+        SLICE,
+        GENERIC,
+    };
+
+    enum class ValueKind : uint8_t {
+        SUM,
+        MIN,
+        MAX,
+        // the values are copied as 'size' bytes
+        REPLACE,
+        REPLACE_IF_NOT_NULL,
+        GENERIC,
+    };
+
+    // the type of SUM/MIN/MAX values
+    enum class NumberType : uint8_t { INT8, INT16, INT32, INT64, INT128, FLOAT, DOUBLE };
+
+    struct KeyColumn {
+        uint32_t cid;
+        KeyKind kind;
+        uint8_t size;
+    };
+
+    struct ValueColumn {
+        uint32_t cid;
+        ValueKind kind;
+        NumberType number_type;
+        uint8_t size;
+    };
+
+    // Whether SUM/MIN/MAX of the type are the plain operators of its cpp type
+    static bool _number_type(FieldType type, NumberType* number_type);
+
+    struct SumOp {
+        template <typename T>
+        static T apply(T dst, T src) {
+            return dst + src;
+        }
+    };
+
+    struct MinOp {
+        template <typename T>
+        static T apply(T dst, T src) {
+            return src < dst ? src : dst;
+        }
+    };
+
+    struct MaxOp {
+        template <typename T>
+        static T apply(T dst, T src) {
+            return src > dst ? src : dst;
+        }
+    };
+
+    static bool _bytes_equal(const void* lhs, const void* rhs, uint8_t size) {
+        switch (size) {
+        case 1:
+            return *(const uint8_t*)lhs == *(const uint8_t*)rhs;
+        case 2:
+            return _load<uint16_t>(lhs) == _load<uint16_t>(rhs);
+        case 4:
+            return _load<uint32_t>(lhs) == _load<uint32_t>(rhs);
+        case 8:
+            return _load<uint64_t>(lhs) == _load<uint64_t>(rhs);
+        default:
+            return memcmp(lhs, rhs, size) == 0;
+        }
+    }
+
+    template <typename T>
+    static T _load(const void* ptr) {
+        T value;
+        memcpy(&value, ptr, sizeof(T));
+        return value;
+    }
+
+    // SUM/MIN/MAX ignore a null source, and a null destination takes the source
+    template <typename Op, typename T>
+    static void _update_number(const RowCursorCell& dst, const RowCursorCell& src) {
+        if (src.is_null()) {
+            return;
+        }
+        T value = _load<T>(src.cell_ptr());
+        if (!dst.is_null()) {
+            value = Op::apply(_load<T>(dst.cell_ptr()), value);
+        }
+        dst.set_not_null();
+        memcpy(dst.mutable_cell_ptr(), &value, sizeof(T));
+    }
+
+    template <typename Op>
+    static void _update_number(NumberType type, const RowCursorCell& dst,
+                               const RowCursorCell& src) {
+        switch (type) {
+        case NumberType::INT8:
+            return _update_number<Op, int8_t>(dst, src);
+        case NumberType::INT16:
+            return _update_number<Op, int16_t>(dst, src);
+        case NumberType::INT32:
+            return _update_number<Op, int32_t>(dst, src);
+        case NumberType::INT64:
+            return _update_number<Op, int64_t>(dst, src);
+        case NumberType::INT128:
+            return _update_number<Op, int128_t>(dst, src);
+        case NumberType::FLOAT:
+            return _update_number<Op, float>(dst, src);
+        case NumberType::DOUBLE:
+            return _update_number<Op, double>(dst, src);
+        }
+    }
+
+    std::vector<KeyColumn> _keys;
+    std::vector<ValueColumn> _values;
+};
+
+template <typename LhsRowType, typename RhsRowType>
+bool RowMergeFuncs::equal(const LhsRowType& lhs, const RhsRowType& rhs) const {
+    for (const auto& key : _keys) {
+        auto l_cell = lhs.cell(key.cid);
+        auto r_cell = rhs.cell(key.cid);
+        bool l_null = l_cell.is_null();
+        if (l_null != r_cell.is_null()) {
+            return false;
+        }
+        if (l_null) {
+            continue;
+        }
+        switch (key.kind) {
+        case KeyKind::BYTES:
+            if (!_bytes_equal(l_cell.cell_ptr(), r_cell.cell_ptr(), key.size)) {
+                return false;
+            }
+            break;
+        case KeyKind::SLICE:
+            if (!(*(const Slice*)l_cell.cell_ptr() == *(const Slice*)r_cell.cell_ptr())) {
+                return false;
+            }
+            break;
+        case KeyKind::GENERIC:
+            if (!lhs.schema()->column(key.cid)->equal(l_cell, r_cell)) {
+                return false;
+            }
+            break;
+        }
+    }
+    return true;
+}
+
+template <typename DstRowType, typename SrcRowType>
+void RowMergeFuncs::agg_update(DstRowType* dst, const SrcRowType& src) const {
+    for (const auto& value : _values) {
+        auto dst_cell = dst->cell(value.cid);
+        auto src_cell = src.cell(value.cid);
+        switch (value.kind) {
+        case ValueKind::SUM:
+            _update_number<SumOp>(value.number_type, dst_cell, src_cell);
+            break;
+        case ValueKind::MIN:
+            _update_number<MinOp>(value.number_type, dst_cell, src_cell);
+            break;
+        case ValueKind::MAX:
+            _update_number<MaxOp>(value.number_type, dst_cell, src_cell);
+            break;
+        case ValueKind::REPLACE:
+            dst_cell.set_is_null(src_cell.is_null());
+            if (!src_cell.is_null()) {
+                memcpy(dst_cell.mutable_cell_ptr(), src_cell.cell_ptr(), value.size);
+            }
+            break;
+        case ValueKind::REPLACE_IF_NOT_NULL:
+            if (!src_cell.is_null()) {
+                dst_cell.set_not_null();
+                memcpy(dst_cell.mutable_cell_ptr(), src_cell.cell_ptr(), value.size);
+            }
+            break;
+        case ValueKind::GENERIC:
+            dst->schema()->column(value.cid)->agg_update(&dst_cell, src_cell);
+            break;
+        }
+    }
+}
+
+} // namespace doris
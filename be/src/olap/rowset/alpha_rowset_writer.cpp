@@ -59,6 +59,7 @@ OLAPStatus AlphaRowsetWriter::init(const RowsetWriterContext& rowset_writer_cont
     _current_rowset_meta->set_rowset_type(_rowset_writer_context.rowset_type);
     _current_rowset_meta->set_rowset_state(rowset_writer_context.rowset_state);
     _current_rowset_meta->set_segments_overlap(rowset_writer_context.segments_overlap);
+    _current_rowset_meta->set_partial_columns(rowset_writer_context.partial_columns);
     RowsetStatePB rowset_state = _rowset_writer_context.rowset_state;
     if (rowset_state == PREPARED || rowset_state == COMMITTED) {
         _is_pending_rowset = true;
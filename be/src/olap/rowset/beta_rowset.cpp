@@ -23,9 +23,16 @@
 
 #include <set>
 
+#include "env/env.h"
 #include "gutil/strings/substitute.h"
+#include "olap/row.h"
+#include "olap/row_cursor.h"
 #include "olap/rowset/beta_rowset_reader.h"
+#include "olap/segment_cache.h"
+#include "olap/short_key_index.h"
 #include "olap/utils.h"
+#include "runtime/mem_pool.h"
+#include "runtime/mem_tracker.h"
 
 namespace doris {
 
@@ -34,11 +41,20 @@ std::string BetaRowset::segment_file_path(const std::string& dir, const RowsetId
     return strings::Substitute("$0/$1_$2.dat", dir, rowset_id.to_string(), segment_id);
 }
 
+std::string BetaRowset::segment_index_file_path(const std::string& dir, const RowsetId& rowset_id,
+                                                int segment_id) {
+    return segment_v2::Segment::index_file_name(segment_file_path(dir, rowset_id, segment_id));
+}
+
 BetaRowset::BetaRowset(const TabletSchema* schema, string rowset_path,
                        RowsetMetaSharedPtr rowset_meta)
         : Rowset(schema, std::move(rowset_path), std::move(rowset_meta)) {}
 
-BetaRowset::~BetaRowset() {}
+BetaRowset::~BetaRowset() {
+    if (SegmentCache::instance() != nullptr) {
+        SegmentCache::instance()->erase(unique_id());
+    }
+}
 
 OLAPStatus BetaRowset::init() {
     return OLAP_SUCCESS; // no op
@@ -46,7 +62,27 @@ OLAPStatus BetaRowset::init() {
 
 // `use_cache` is ignored because beta rowset doesn't support fd cache now
 OLAPStatus BetaRowset::do_load(bool /*use_cache*/) {
-    // Open all segments under the current rowset
+    // open segments to check them, they are kept in segment cache for readers
+    std::vector<segment_v2::SegmentSharedPtr> segments;
+    return load_segments(&segments);
+}
+
+OLAPStatus BetaRowset::load_segments(std::vector<segment_v2::SegmentSharedPtr>* segments) {
+    SegmentCache* segment_cache = SegmentCache::instance();
+    if (segment_cache == nullptr) {
+        return _open_segments(segments);
+    }
+    std::string key = unique_id();
+    if (segment_cache->lookup(key, segments)) {
+        return OLAP_SUCCESS;
+    }
+    RETURN_NOT_OK(_open_segments(segments));
+    segment_cache->insert(key, *segments);
+    return OLAP_SUCCESS;
+}
+
+OLAPStatus BetaRowset::_open_segments(std::vector<segment_v2::SegmentSharedPtr>* segments) {
+    segments->clear();
     for (int seg_id = 0; seg_id < num_segments(); ++seg_id) {
         std::string seg_path = segment_file_path(_rowset_path, rowset_id(), seg_id);
         std::shared_ptr<segment_v2::Segment> segment;
@@ -56,7 +92,7 @@ OLAPStatus BetaRowset::do_load(bool /*use_cache*/) {
                          << " : " << s.to_string();
             return OLAP_ERR_ROWSET_LOAD_FAILED;
         }
-        _segments.push_back(std::move(segment));
+        segments->push_back(std::move(segment));
     }
     return OLAP_SUCCESS;
 }
@@ -75,10 +111,98 @@ OLAPStatus BetaRowset::create_reader(const std::shared_ptr<MemTracker>& parent_t
     return OLAP_SUCCESS;
 }
 
+// Decode a key of the short key index into the short key columns of 'key'.
+static Status decode_short_key(Slice encoded_key, size_t num_short_keys, RowCursor* key,
+                               MemPool* pool) {
+    for (size_t cid = 0; cid < num_short_keys; ++cid) {
+        if (encoded_key.empty()) {
+            return Status::Corruption("short key is too short");
+        }
+        uint8_t marker = encoded_key[0];
+        encoded_key.remove_prefix(1);
+        if (marker == KEY_NULL_FIRST_MARKER) {
+            key->set_null(cid);
+            continue;
+        }
+        if (marker != KEY_NORMAL_MARKER) {
+            return Status::Corruption(strings::Substitute("unexpected key marker $0", marker));
+        }
+        key->set_not_null(cid);
+        RETURN_IF_ERROR(key->column_schema(cid)->decode_ascending(
+                &encoded_key, reinterpret_cast<uint8_t*>(key->cell_ptr(cid)), pool));
+    }
+    return Status::OK();
+}
+
+// Split [start_key, end_key] into ranges of about request_block_row_count rows by the
+// short key index of the largest segment, so that a tablet of one big rowset can be
+// read by several scanners. Every boundary is a key value, a range still covers rows
+// of all rowsets and segments, and the reader merges them as the key model requires.
 OLAPStatus BetaRowset::split_range(const RowCursor& start_key, const RowCursor& end_key,
                                    uint64_t request_block_row_count,
                                    std::vector<OlapTuple>* ranges) {
+    segment_v2::SegmentSharedPtr largest_segment;
+    std::vector<segment_v2::SegmentSharedPtr> segments;
+    if (load_segments(&segments) == OLAP_SUCCESS) {
+        for (auto& segment : segments) {
+            if (largest_segment == nullptr || segment->num_rows() > largest_segment->num_rows()) {
+                largest_segment = segment;
+            }
+        }
+    }
+    if (largest_segment == nullptr || largest_segment->num_rows() == 0 ||
+        !largest_segment->load_index().ok() || largest_segment->num_rows_per_block() == 0) {
+        ranges->emplace_back(start_key.to_tuple());
+        ranges->emplace_back(end_key.to_tuple());
+        return OLAP_SUCCESS;
+    }
+    uint64_t blocks_per_range = request_block_row_count / largest_segment->num_rows_per_block();
+    if (blocks_per_range == 0) {
+        LOG(WARNING) << "expected_rows less than 1. [request_block_row_count = "
+                     << request_block_row_count << "]";
+        return OLAP_ERR_TABLE_NOT_FOUND;
+    }
+
+    size_t num_short_keys = _schema->num_short_key_columns();
+    std::string encoded_start_key;
+    encode_key_with_padding(&encoded_start_key, start_key, num_short_keys, true);
+    std::string encoded_end_key;
+    encode_key_with_padding(&encoded_end_key, end_key, num_short_keys, false);
+    auto start_iter = largest_segment->lower_bound(encoded_start_key);
+    auto end_iter = largest_segment->upper_bound(encoded_end_key);
+
+    RowCursor cur_key;
+    RowCursor last_key;
+    if (cur_key.init(*_schema, num_short_keys) != OLAP_SUCCESS ||
+        last_key.init(*_schema, num_short_keys) != OLAP_SUCCESS) {
+        LOG(WARNING) << "fail to init cursor";
+        return OLAP_ERR_INIT_FAILED;
+    }
+    last_key.allocate_memory_for_string_type(*_schema);
+    std::vector<uint32_t> cids;
+    for (uint32_t cid = 0; cid < num_short_keys; ++cid) {
+        cids.push_back(cid);
+    }
+
+    // start_key is the key given by query layer, not the first key in index
     ranges->emplace_back(start_key.to_tuple());
+    bool has_last_key = false;
+    auto tracker = std::make_shared<MemTracker>();
+    MemPool pool(tracker.get());
+    for (auto iter = start_iter; end_iter - iter > (ssize_t)blocks_per_range;) {
+        iter += blocks_per_range;
+        auto st = decode_short_key(*iter, num_short_keys, &cur_key, &pool);
+        if (!st.ok()) {
+            LOG(WARNING) << "fail to decode short key: " << st.to_string();
+            return OLAP_ERR_ROWBLOCK_FIND_ROW_EXCEPTION;
+        }
+        if (!has_last_key || !equal_row(cids, cur_key, last_key)) {
+            ranges->emplace_back(cur_key.to_tuple()); // end of last section
+            ranges->emplace_back(cur_key.to_tuple()); // start a new section
+            direct_copy_row(&last_key, cur_key);
+            has_last_key = true;
+        }
+    }
     ranges->emplace_back(end_key.to_tuple());
     return OLAP_SUCCESS;
 }
@@ -99,6 +223,13 @@ OLAPStatus BetaRowset::remove() {
                          << ", path=" << path;
             success = false;
         }
+        std::string index_path = segment_index_file_path(_rowset_path, rowset_id(), i);
+        if (::remove(index_path.c_str()) != 0 && errno != ENOENT) {
+            char errmsg[64];
+            LOG(WARNING) << "failed to delete file. err=" << strerror_r(errno, errmsg, 64)
+                         << ", path=" << index_path;
+            success = false;
+        }
     }
     if (!success) {
         LOG(WARNING) << "failed to remove files in rowset " << unique_id();
@@ -108,12 +239,20 @@ OLAPStatus BetaRowset::remove() {
 }
 
 void BetaRowset::do_close() {
-    _segments.clear();
+    if (SegmentCache::instance() != nullptr) {
+        SegmentCache::instance()->erase(unique_id());
+    }
 }
 
 OLAPStatus BetaRowset::link_files_to(const std::string& dir, RowsetId new_rowset_id) {
+    return link_files_to(dir, new_rowset_id, 0);
+}
+
+OLAPStatus BetaRowset::link_files_to(const std::string& dir, RowsetId new_rowset_id,
+                                     int32_t new_segment_start_id, bool link_index_files) {
     for (int i = 0; i < num_segments(); ++i) {
-        std::string dst_link_path = segment_file_path(dir, new_rowset_id, i);
+        std::string dst_link_path =
+                segment_file_path(dir, new_rowset_id, new_segment_start_id + i);
         // TODO(lingbin): use Env API? or EnvUtil?
         if (FileUtils::check_exist(dst_link_path)) {
             LOG(WARNING) << "failed to create hard link, file already exist: " << dst_link_path;
@@ -128,6 +267,18 @@ OLAPStatus BetaRowset::link_files_to(const std::string& dir, RowsetId new_rowset
                          << "errno=" << Errno::no();
             return OLAP_ERR_OS_ERROR;
         }
+        std::string src_index_path = segment_index_file_path(_rowset_path, rowset_id(), i);
+        if (!link_index_files || !FileUtils::check_exist(src_index_path)) {
+            continue;
+        }
+        std::string dst_index_path =
+                segment_index_file_path(dir, new_rowset_id, new_segment_start_id + i);
+        if (link(src_index_path.c_str(), dst_index_path.c_str()) != 0) {
+            LOG(WARNING) << "fail to create hard link. from=" << src_index_path << ", "
+                         << "to=" << dst_index_path << ", "
+                         << "errno=" << Errno::no();
+            return OLAP_ERR_OS_ERROR;
+        }
     }
     return OLAP_SUCCESS;
 }
@@ -145,6 +296,16 @@ OLAPStatus BetaRowset::copy_files_to(const std::string& dir) {
                          << ", errno=" << Errno::no();
             return OLAP_ERR_OS_ERROR;
         }
+        std::string src_index_path = segment_index_file_path(_rowset_path, rowset_id(), i);
+        if (!FileUtils::check_exist(src_index_path)) {
+            continue;
+        }
+        std::string dst_index_path = segment_index_file_path(dir, rowset_id(), i);
+        if (copy_file(src_index_path, dst_index_path) != OLAP_SUCCESS) {
+            LOG(WARNING) << "fail to copy file. from=" << src_index_path
+                         << ", to=" << dst_index_path << ", errno=" << Errno::no();
+            return OLAP_ERR_OS_ERROR;
+        }
     }
     return OLAP_SUCCESS;
 }
@@ -153,8 +314,17 @@ bool BetaRowset::check_path(const std::string& path) {
     std::set<std::string> valid_paths;
     for (int i = 0; i < num_segments(); ++i) {
         valid_paths.insert(segment_file_path(_rowset_path, rowset_id(), i));
+        valid_paths.insert(segment_index_file_path(_rowset_path, rowset_id(), i));
     }
     return valid_paths.find(path) != valid_paths.end();
 }
 
+void BetaRowset::drop_page_cache() {
+    for (int i = 0; i < num_segments(); ++i) {
+        std::string path = segment_file_path(_rowset_path, rowset_id(), i);
+        WARN_IF_ERROR(Env::Default()->drop_page_cache(path),
+                      strings::Substitute("failed to drop page cache of $0", path));
+    }
+}
+
 } // namespace doris
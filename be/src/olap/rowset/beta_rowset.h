@@ -45,6 +45,10 @@ public:
     static std::string segment_file_path(const std::string& segment_dir, const RowsetId& rowset_id,
                                          int segment_id);
 
+    // The index file of the segment, see Segment::index_file_name(). It may not exist.
+    static std::string segment_index_file_path(const std::string& segment_dir,
+                                               const RowsetId& rowset_id, int segment_id);
+
     OLAPStatus split_range(const RowCursor& start_key, const RowCursor& end_key,
                            uint64_t request_block_row_count,
                            std::vector<OlapTuple>* ranges) override;
@@ -53,6 +57,12 @@ public:
 
     OLAPStatus link_files_to(const std::string& dir, RowsetId new_rowset_id) override;
 
+    // Like link_files_to(), but the segments are linked as the segments of the new rowset
+    // starting from `new_segment_start_id`. The index files of the segments are not linked
+    // if `link_index_files` is false, e.g. the new rowset is to build other indexes.
+    OLAPStatus link_files_to(const std::string& dir, RowsetId new_rowset_id,
+                             int32_t new_segment_start_id, bool link_index_files = true);
+
     OLAPStatus copy_files_to(const std::string& dir) override;
 
     // only applicable to alpha rowset, no op here
@@ -62,6 +72,12 @@ public:
 
     bool check_path(const std::string& path) override;
 
+    void drop_page_cache() override;
+
+    // Get the opened segments of this rowset, from the global SegmentCache if they
+    // are cached.
+    OLAPStatus load_segments(std::vector<segment_v2::SegmentSharedPtr>* segments);
+
 protected:
     BetaRowset(const TabletSchema* schema, std::string rowset_path,
                RowsetMetaSharedPtr rowset_meta);
@@ -76,7 +92,9 @@ protected:
 private:
     friend class RowsetFactory;
     friend class BetaRowsetReader;
-    std::vector<segment_v2::SegmentSharedPtr> _segments;
+
+    // Open all segments of this rowset.
+    OLAPStatus _open_segments(std::vector<segment_v2::SegmentSharedPtr>* segments);
 };
 
 } // namespace doris
@@ -22,8 +22,10 @@
 #include "olap/row_block.h"
 #include "olap/row_block2.h"
 #include "olap/row_cursor.h"
+#include "olap/rowset/segment_v2/empty_segment_iterator.h"
 #include "olap/rowset/segment_v2/segment_iterator.h"
 #include "olap/schema.h"
+#include "olap/storage_engine.h"
 
 namespace doris {
 
@@ -62,11 +64,27 @@ OLAPStatus BetaRowsetReader::init(RowsetReaderContext* read_context) {
                 _rowset->end_version(), &read_options.delete_conditions);
     }
     read_options.column_predicates = read_context->predicates;
+    read_options.block_filters = read_context->block_filters;
+    read_options.delete_bitmap = read_context->delete_bitmap;
+    read_options.rowset_id = _rowset->rowset_id();
+    read_options.delete_bitmap_version = read_context->delete_bitmap_version;
     read_options.use_page_cache = read_context->use_page_cache;
+    if (StorageEngine::instance() != nullptr) {
+        read_options.read_ahead_pool = StorageEngine::instance()->segment_read_ahead_pool();
+        read_options.read_ahead_pages = config::segment_read_ahead_pages;
+    }
 
-    // create iterator for each segment
+    // create iterator for each segment, segments which can't match are skipped before
+    // their indexes are loaded
+    std::vector<segment_v2::SegmentSharedPtr> segments;
+    RETURN_NOT_OK(_rowset->load_segments(&segments));
     std::vector<std::unique_ptr<RowwiseIterator>> seg_iterators;
-    for (auto& seg_ptr : _rowset->_segments) {
+    for (auto& seg_ptr : segments) {
+        if (seg_ptr->can_be_pruned(read_options)) {
+            _stats->total_segment_number++;
+            _stats->filtered_segment_number++;
+            continue;
+        }
         std::unique_ptr<RowwiseIterator> iter;
         auto s = seg_ptr->new_iterator(schema, read_options, &iter);
         if (!s.ok()) {
@@ -83,7 +101,10 @@ OLAPStatus BetaRowsetReader::init(RowsetReaderContext* read_context) {
 
     // merge or union segment iterator
     RowwiseIterator* final_iterator;
-    if (read_context->need_ordered_result && _rowset->rowset_meta()->is_segments_overlapping()) {
+    if (iterators.empty()) {
+        final_iterator = new segment_v2::EmptySegmentIterator(schema);
+    } else if (read_context->need_ordered_result &&
+               _rowset->rowset_meta()->is_segments_overlapping()) {
         final_iterator = new_merge_iterator(iterators);
     } else {
         final_iterator = new_union_iterator(iterators);
@@ -135,6 +156,9 @@ OLAPStatus BetaRowsetReader::next_block(RowBlock** block) {
         SCOPED_RAW_TIMER(&_stats->block_convert_ns);
         _input_block->convert_to_row_block(_row.get(), _output_block.get());
     }
+    // rows meeting the delete conditions are usually removed by segment iterators already,
+    // then the block needn't be checked row by row
+    _output_block->set_block_status(_input_block->delete_state());
     *block = _output_block.get();
     return OLAP_SUCCESS;
 }
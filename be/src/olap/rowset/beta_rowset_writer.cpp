@@ -18,20 +18,24 @@
 #include "olap/rowset/beta_rowset_writer.h"
 
 #include <ctime> // time
+#include <map>
 
 #include "common/config.h"
 #include "common/logging.h"
 #include "env/env.h"
 #include "gutil/strings/substitute.h"
 #include "olap/fs/fs_util.h"
+#include "olap/memtable.h"
 #include "olap/olap_define.h"
 #include "olap/row.h"        // ContiguousRow
+#include "olap/row_block2.h" // RowBlockV2
 #include "olap/row_cursor.h" // RowCursor
 #include "olap/rowset/beta_rowset.h"
 #include "olap/rowset/rowset_factory.h"
 #include "olap/rowset/segment_v2/segment_writer.h"
 #include "olap/storage_engine.h"
 #include "runtime/exec_env.h"
+#include "util/stopwatch.hpp"
 
 namespace doris {
 
@@ -51,6 +55,7 @@ BetaRowsetWriter::~BetaRowsetWriter() {
     // TODO(lingbin): Should wrapper exception logic, no need to know file ops directly.
     if (!_already_built) {       // abnormal exit, remove all files generated
         _segment_writer.reset(); // ensure all files are closed
+        _vertical_segment_writers.clear();
         Status st;
         for (int i = 0; i < _num_segment; ++i) {
             auto path = BetaRowset::segment_file_path(_context.rowset_path_prefix,
@@ -74,6 +79,7 @@ OLAPStatus BetaRowsetWriter::init(const RowsetWriterContext& rowset_writer_conte
     _rowset_meta->set_rowset_type(_context.rowset_type);
     _rowset_meta->set_rowset_state(_context.rowset_state);
     _rowset_meta->set_segments_overlap(_context.segments_overlap);
+    _rowset_meta->set_partial_columns(_context.partial_columns);
     if (_context.rowset_state == PREPARED || _context.rowset_state == COMMITTED) {
         _is_pending = true;
         _rowset_meta->set_txn_id(_context.txn_id);
@@ -109,9 +115,73 @@ OLAPStatus BetaRowsetWriter::_add_row(const RowType& row) {
 template OLAPStatus BetaRowsetWriter::_add_row(const RowCursor& row);
 template OLAPStatus BetaRowsetWriter::_add_row(const ContiguousRow& row);
 
+OLAPStatus BetaRowsetWriter::add_rows(const std::vector<ContiguousRow>& rows) {
+    size_t offset = 0;
+    while (offset < rows.size()) {
+        if (PREDICT_FALSE(_segment_writer == nullptr)) {
+            RETURN_NOT_OK(_create_segment_writer());
+        }
+        size_t n = std::min<size_t>(
+                rows.size() - offset,
+                _context.max_rows_per_segment - _segment_writer->num_rows_written());
+        auto s = _segment_writer->append_rows(&rows[offset], n);
+        if (PREDICT_FALSE(!s.ok())) {
+            LOG(WARNING) << "failed to append rows: " << s.to_string();
+            return OLAP_ERR_WRITER_DATA_WRITE_ERROR;
+        }
+        _num_rows_written += n;
+        offset += n;
+        if (PREDICT_FALSE(_segment_writer->estimate_segment_size() >= MAX_SEGMENT_SIZE ||
+                          _segment_writer->num_rows_written() >= _context.max_rows_per_segment)) {
+            RETURN_NOT_OK(_flush_segment_writer());
+        }
+    }
+    return OLAP_SUCCESS;
+}
+
+OLAPStatus BetaRowsetWriter::add_block(const RowBlockV2& block, size_t offset,
+                                       size_t num_rows) {
+    const uint16_t* selection = block.selection_vector();
+    // selected rows are contiguous if all rows are selected
+    bool contiguous = block.selected_size() == block.num_rows();
+    while (num_rows > 0) {
+        if (PREDICT_FALSE(_segment_writer == nullptr)) {
+            RETURN_NOT_OK(_create_segment_writer());
+        }
+        size_t n = std::min<size_t>(
+                num_rows, _context.max_rows_per_segment - _segment_writer->num_rows_written());
+        Status s;
+        if (contiguous) {
+            s = _segment_writer->append_block(block, selection[offset], n);
+        } else {
+            for (size_t i = 0; i < n && s.ok(); ++i) {
+                s = _segment_writer->append_row(block.row(selection[offset + i]));
+            }
+        }
+        if (PREDICT_FALSE(!s.ok())) {
+            LOG(WARNING) << "failed to append block: " << s.to_string();
+            return OLAP_ERR_WRITER_DATA_WRITE_ERROR;
+        }
+        _num_rows_written += n;
+        offset += n;
+        num_rows -= n;
+        if (PREDICT_FALSE(_segment_writer->estimate_segment_size() >= MAX_SEGMENT_SIZE ||
+                          _segment_writer->num_rows_written() >= _context.max_rows_per_segment)) {
+            RETURN_NOT_OK(_flush_segment_writer());
+        }
+    }
+    return OLAP_SUCCESS;
+}
+
 OLAPStatus BetaRowsetWriter::add_rowset(RowsetSharedPtr rowset) {
+    return _add_rowset(rowset, true);
+}
+
+OLAPStatus BetaRowsetWriter::_add_rowset(const RowsetSharedPtr& rowset, bool link_index_files) {
     assert(rowset->rowset_meta()->rowset_type() == BETA_ROWSET);
-    RETURN_NOT_OK(rowset->link_files_to(_context.rowset_path_prefix, _context.rowset_id));
+    // segments of all added rowsets are numbered in the order they are added
+    RETURN_NOT_OK(std::static_pointer_cast<BetaRowset>(rowset)->link_files_to(
+            _context.rowset_path_prefix, _context.rowset_id, _num_segment, link_index_files));
     _num_rows_written += rowset->num_rows();
     _total_data_size += rowset->rowset_meta()->data_disk_size();
     _total_index_size += rowset->rowset_meta()->index_disk_size();
@@ -120,13 +190,47 @@ OLAPStatus BetaRowsetWriter::add_rowset(RowsetSharedPtr rowset) {
     if (rowset->rowset_meta()->has_delete_predicate()) {
         _rowset_meta->set_delete_predicate(rowset->rowset_meta()->delete_predicate());
     }
+    if (rowset->rowset_meta()->missing_indexes()) {
+        _rowset_meta->set_missing_indexes(true);
+    }
     return OLAP_SUCCESS;
 }
 
+// Whether a column of 'new_schema' has a bitmap or bloom filter index which the column of
+// the same unique id in 'old_schema' doesn't have, so the segments written with
+// 'old_schema' lack it.
+static bool lacks_indexes(const TabletSchema& old_schema, const TabletSchema& new_schema) {
+    std::map<int32_t, const TabletColumn*> old_columns;
+    for (auto& column : old_schema.columns()) {
+        old_columns.emplace(column.unique_id(), &column);
+    }
+    for (auto& column : new_schema.columns()) {
+        if (!column.has_bitmap_index() && !column.is_bf_column()) {
+            continue;
+        }
+        auto it = old_columns.find(column.unique_id());
+        if (it == old_columns.end()) {
+            continue; // the column is not in the segments, nothing to index
+        }
+        if ((column.has_bitmap_index() && !it->second->has_bitmap_index()) ||
+            (column.is_bf_column() && !it->second->is_bf_column())) {
+            return true;
+        }
+    }
+    return false;
+}
+
 OLAPStatus BetaRowsetWriter::add_rowset_for_linked_schema_change(
         RowsetSharedPtr rowset, const SchemaMapping& schema_mapping) {
     // TODO use schema_mapping to transfer zonemap
-    return add_rowset(rowset);
+    // An index file is never rewritten, so it's not linked if other indexes are to be
+    // built, and all the indexes the segments lack are built into a new one.
+    bool missing_indexes = lacks_indexes(*rowset->schema(), *_context.tablet_schema);
+    RETURN_NOT_OK(_add_rowset(rowset, !missing_indexes));
+    if (missing_indexes) {
+        _rowset_meta->set_missing_indexes(true);
+    }
+    return OLAP_SUCCESS;
 }
 
 OLAPStatus BetaRowsetWriter::flush() {
@@ -136,14 +240,134 @@ OLAPStatus BetaRowsetWriter::flush() {
     return OLAP_SUCCESS;
 }
 
+OLAPStatus BetaRowsetWriter::flush_memtable(MemTable* mem_table, int32_t segment_id) {
+    DCHECK(segment_id >= 0 && segment_id < _num_segment);
+    std::unique_ptr<segment_v2::SegmentWriter> writer;
+    RETURN_NOT_OK(_create_segment_writer(segment_id, &writer));
+    // The rows of a memtable are written to one segment regardless of MAX_SEGMENT_SIZE
+    // and max_rows_per_segment, because the memtable is bounded by write_buffer_size.
+    int64_t num_rows = 0;
+    auto add_rows = [&writer, &num_rows](const std::vector<ContiguousRow>& rows) -> OLAPStatus {
+        auto s = writer->append_rows(rows.data(), rows.size());
+        if (PREDICT_FALSE(!s.ok())) {
+            LOG(WARNING) << "failed to append rows: " << s.to_string();
+            return OLAP_ERR_WRITER_DATA_WRITE_ERROR;
+        }
+        num_rows += rows.size();
+        return OLAP_SUCCESS;
+    };
+    RETURN_NOT_OK(mem_table->write_rows_in_batches(add_rows));
+    RETURN_NOT_OK(_finalize_segment_writer(writer.get()));
+    std::lock_guard<std::mutex> l(_lock);
+    _num_rows_written += num_rows;
+    return OLAP_SUCCESS;
+}
+
+OLAPStatus BetaRowsetWriter::add_columns(const RowBlockV2& block,
+                                         const std::vector<uint32_t>& col_ids, bool is_key,
+                                         uint32_t max_rows_per_segment) {
+    for (uint16_t i = 0; i < block.selected_size(); ++i) {
+        if (is_key) {
+            if (_vertical_segment_writers.empty() ||
+                _vertical_segment_writers.back()->num_rows_written() >= max_rows_per_segment) {
+                RETURN_NOT_OK(_finalize_vertical_columns());
+                std::unique_ptr<segment_v2::SegmentWriter> writer;
+                RETURN_NOT_OK(_create_segment_writer(_num_segment++, &writer, &col_ids));
+                _vertical_segment_writers.push_back(std::move(writer));
+                _vertical_writer_idx = _vertical_segment_writers.size() - 1;
+                _vertical_group_inited = true;
+            }
+        } else {
+            // value columns follow the segments of key columns
+            while (!_vertical_group_inited ||
+                   _vertical_segment_writers[_vertical_writer_idx]->num_rows_in_group() >=
+                           _vertical_segment_writers[_vertical_writer_idx]->num_rows_written()) {
+                if (_vertical_group_inited) {
+                    RETURN_NOT_OK(_finalize_vertical_columns());
+                    ++_vertical_writer_idx;
+                }
+                if (_vertical_writer_idx >= _vertical_segment_writers.size()) {
+                    LOG(WARNING) << "value columns have more rows than key columns";
+                    return OLAP_ERR_WRITER_DATA_WRITE_ERROR;
+                }
+                auto s = _vertical_segment_writers[_vertical_writer_idx]->init(col_ids, false);
+                if (!s.ok()) {
+                    LOG(WARNING) << "failed to init segment writer: " << s.to_string();
+                    return OLAP_ERR_INIT_FAILED;
+                }
+                _vertical_group_inited = true;
+            }
+        }
+        auto s = _vertical_segment_writers[_vertical_writer_idx]->append_row(
+                block.row(block.selection_vector()[i]));
+        if (PREDICT_FALSE(!s.ok())) {
+            LOG(WARNING) << "failed to append row: " << s.to_string();
+            return OLAP_ERR_WRITER_DATA_WRITE_ERROR;
+        }
+        if (is_key) {
+            ++_num_rows_written;
+        }
+    }
+    return OLAP_SUCCESS;
+}
+
+OLAPStatus BetaRowsetWriter::flush_columns() {
+    if (_vertical_segment_writers.empty()) {
+        return OLAP_SUCCESS;
+    }
+    if (!_vertical_group_inited || _vertical_writer_idx + 1 != _vertical_segment_writers.size()) {
+        LOG(WARNING) << "value columns have less rows than key columns";
+        return OLAP_ERR_WRITER_DATA_WRITE_ERROR;
+    }
+    RETURN_NOT_OK(_finalize_vertical_columns());
+    _vertical_writer_idx = 0;
+    return OLAP_SUCCESS;
+}
+
+OLAPStatus BetaRowsetWriter::final_flush() {
+    for (auto& writer : _vertical_segment_writers) {
+        uint64_t segment_size;
+        Status s = writer->finalize_footer(&segment_size);
+        if (!s.ok()) {
+            LOG(WARNING) << "failed to finalize segment: " << s.to_string();
+            return OLAP_ERR_WRITER_DATA_WRITE_ERROR;
+        }
+        _total_data_size += segment_size;
+    }
+    _vertical_segment_writers.clear();
+    return OLAP_SUCCESS;
+}
+
+OLAPStatus BetaRowsetWriter::_finalize_vertical_columns() {
+    if (!_vertical_group_inited) {
+        return OLAP_SUCCESS;
+    }
+    uint64_t index_size;
+    Status s = _vertical_segment_writers[_vertical_writer_idx]->finalize_columns(&index_size);
+    if (!s.ok()) {
+        LOG(WARNING) << "failed to finalize columns of segment: " << s.to_string();
+        return OLAP_ERR_WRITER_DATA_WRITE_ERROR;
+    }
+    _total_index_size += index_size;
+    _vertical_group_inited = false;
+    return OLAP_SUCCESS;
+}
+
 RowsetSharedPtr BetaRowsetWriter::build() {
     // TODO(lingbin): move to more better place, or in a CreateBlockBatch?
     for (auto& wblock : _wblocks) {
+        MonotonicStopWatch watch;
+        watch.start();
         wblock->close();
+        if (_context.data_dir != nullptr) {
+            // the block is synced to the disk when closed
+            _context.data_dir->add_write_latency(watch.elapsed_time() / 1000);
+        }
     }
     // When building a rowset, we must ensure that the current _segment_writer has been
     // flushed, that is, the current _segment_writer is nullptr
     DCHECK(_segment_writer == nullptr) << "segment must be null when build rowset";
+    DCHECK(_vertical_segment_writers.empty()) << "final_flush() must be called before build";
     _rowset_meta->set_num_rows(_num_rows_written);
     _rowset_meta->set_total_disk_size(_total_data_size);
     _rowset_meta->set_data_disk_size(_total_data_size);
@@ -173,13 +397,19 @@ RowsetSharedPtr BetaRowsetWriter::build() {
 }
 
 OLAPStatus BetaRowsetWriter::_create_segment_writer() {
+    return _create_segment_writer(_num_segment++, &_segment_writer);
+}
+
+OLAPStatus BetaRowsetWriter::_create_segment_writer(
+        int32_t segment_id, std::unique_ptr<segment_v2::SegmentWriter>* writer,
+        const std::vector<uint32_t>* column_ids) {
     auto path = BetaRowset::segment_file_path(_context.rowset_path_prefix, _context.rowset_id,
-                                              _num_segment);
+                                              segment_id);
     // TODO(lingbin): should use a more general way to get BlockManager object
     // and tablets with the same type should share one BlockManager object;
     fs::BlockManager* block_mgr = fs::fs_util::block_manager();
     std::unique_ptr<fs::WritableBlock> wblock;
-    fs::CreateBlockOptions opts({path});
+    fs::CreateBlockOptions opts({path, _context.direct_io});
     DCHECK(block_mgr != nullptr);
     Status st = block_mgr->create_block(opts, &wblock);
     if (!st.ok()) {
@@ -189,31 +419,43 @@ OLAPStatus BetaRowsetWriter::_create_segment_writer() {
 
     DCHECK(wblock != nullptr);
     segment_v2::SegmentWriterOptions writer_options;
-    _segment_writer.reset(new segment_v2::SegmentWriter(wblock.get(), _num_segment,
-                                                        _context.tablet_schema, writer_options));
-    _wblocks.push_back(std::move(wblock));
+    if (StorageEngine::instance() != nullptr) {
+        writer_options.column_encode_pool = StorageEngine::instance()->column_encode_thread_pool();
+    }
+    writer->reset(new segment_v2::SegmentWriter(wblock.get(), segment_id, _context.tablet_schema,
+                                                writer_options));
+    {
+        std::lock_guard<std::mutex> l(_lock);
+        _wblocks.push_back(std::move(wblock));
+    }
     // TODO set write_mbytes_per_sec based on writer type (load/base compaction/cumulative compaction)
-    auto s = _segment_writer->init(config::push_write_mbytes_per_sec);
+    auto s = column_ids == nullptr ? (*writer)->init(config::push_write_mbytes_per_sec)
+                                   : (*writer)->init(*column_ids, true);
     if (!s.ok()) {
         LOG(WARNING) << "failed to init segment writer: " << s.to_string();
-        _segment_writer.reset(nullptr);
+        writer->reset(nullptr);
         return OLAP_ERR_INIT_FAILED;
     }
-    ++_num_segment;
     return OLAP_SUCCESS;
 }
 
 OLAPStatus BetaRowsetWriter::_flush_segment_writer() {
+    RETURN_NOT_OK(_finalize_segment_writer(_segment_writer.get()));
+    _segment_writer.reset();
+    return OLAP_SUCCESS;
+}
+
+OLAPStatus BetaRowsetWriter::_finalize_segment_writer(segment_v2::SegmentWriter* writer) {
     uint64_t segment_size;
     uint64_t index_size;
-    Status s = _segment_writer->finalize(&segment_size, &index_size);
+    Status s = writer->finalize(&segment_size, &index_size);
     if (!s.ok()) {
         LOG(WARNING) << "failed to finalize segment: " << s.to_string();
         return OLAP_ERR_WRITER_DATA_WRITE_ERROR;
     }
+    std::lock_guard<std::mutex> l(_lock);
     _total_data_size += segment_size;
     _total_index_size += index_size;
-    _segment_writer.reset();
     return OLAP_SUCCESS;
 }
 
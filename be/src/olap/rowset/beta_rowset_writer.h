@@ -18,6 +18,9 @@
 #ifndef DORIS_BE_SRC_OLAP_ROWSET_BETA_ROWSET_WRITER_H
 #define DORIS_BE_SRC_OLAP_ROWSET_BETA_ROWSET_WRITER_H
 
+#include <atomic>
+#include <mutex>
+
 #include "olap/rowset/rowset_writer.h"
 #include "vector"
 
@@ -44,6 +47,10 @@ public:
     OLAPStatus add_row(const ContiguousRow& row) override { return _add_row(row); }
 
     // add rowset by create hard link
+    OLAPStatus add_rows(const std::vector<ContiguousRow>& rows) override;
+
+    OLAPStatus add_block(const RowBlockV2& block, size_t offset, size_t num_rows) override;
+
     OLAPStatus add_rowset(RowsetSharedPtr rowset) override;
 
     OLAPStatus add_rowset_for_linked_schema_change(RowsetSharedPtr rowset,
@@ -51,6 +58,21 @@ public:
 
     OLAPStatus flush() override;
 
+    bool support_concurrent_flush() const override { return true; }
+
+    int32_t reserve_segment() override { return _num_segment++; }
+
+    OLAPStatus flush_memtable(MemTable* mem_table, int32_t segment_id) override;
+
+    bool support_vertical_write() const override { return true; }
+
+    OLAPStatus add_columns(const RowBlockV2& block, const std::vector<uint32_t>& col_ids,
+                           bool is_key, uint32_t max_rows_per_segment) override;
+
+    OLAPStatus flush_columns() override;
+
+    OLAPStatus final_flush() override;
+
     RowsetSharedPtr build() override;
 
     Version version() override { return _context.version; }
@@ -59,20 +81,46 @@ public:
 
     RowsetId rowset_id() override { return _context.rowset_id; }
 
+    RowsetTypePB type() override { return BETA_ROWSET; }
+
 private:
     template <typename RowType>
     OLAPStatus _add_row(const RowType& row);
 
+    OLAPStatus _add_rowset(const RowsetSharedPtr& rowset, bool link_index_files);
+
     OLAPStatus _create_segment_writer();
 
+    // If `column_ids' is not nullptr, the writer is inited to write these columns
+    // as the key group of vertical compaction.
+    OLAPStatus _create_segment_writer(int32_t segment_id,
+                                      std::unique_ptr<segment_v2::SegmentWriter>* writer,
+                                      const std::vector<uint32_t>* column_ids = nullptr);
+
     OLAPStatus _flush_segment_writer();
 
+    OLAPStatus _finalize_segment_writer(segment_v2::SegmentWriter* writer);
+
+    // Finish the columns of current group in current vertical segment writer
+    OLAPStatus _finalize_vertical_columns();
+
 private:
     RowsetWriterContext _context;
     std::shared_ptr<RowsetMeta> _rowset_meta;
 
-    int _num_segment;
+    // number of segments created or reserved, segment ids are in [0, _num_segment)
+    std::atomic<int32_t> _num_segment;
     std::unique_ptr<segment_v2::SegmentWriter> _segment_writer;
+
+    // segment writers of vertical compaction, kept until final_flush()
+    std::vector<std::unique_ptr<segment_v2::SegmentWriter>> _vertical_segment_writers;
+    // index of the writer which current group is written to
+    size_t _vertical_writer_idx = 0;
+    // whether current vertical segment writer has been inited for current group
+    bool _vertical_group_inited = false;
+
+    // Guards _wblocks and the counters, which may be updated by concurrent flush_memtable()
+    std::mutex _lock;
     // TODO(lingbin): it is better to wrapper in a Batch?
     std::vector<std::unique_ptr<fs::WritableBlock>> _wblocks;
 
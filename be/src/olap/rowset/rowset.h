@@ -135,6 +135,8 @@ public:
 
     const RowsetMetaSharedPtr& rowset_meta() const { return _rowset_meta; }
 
+    const TabletSchema* schema() const { return _schema; }
+
     bool is_pending() const { return _is_pending; }
 
     // publish rowset to make it visible to read
@@ -205,6 +207,9 @@ public:
     // return whether `path` is one of the files in this rowset
     virtual bool check_path(const std::string& path) = 0;
 
+    // drop the pages of the files of this rowset from the OS page cache
+    virtual void drop_page_cache() {}
+
     // return an unique identifier string for this rowset
     std::string unique_id() const { return _rowset_path + "/" + rowset_id().to_string(); }
 
@@ -239,6 +239,18 @@ public:
 
     bool is_remove_from_rowset_meta() const { return _is_removed_from_rowset_meta; }
 
+    bool partial_columns() const { return _rowset_meta_pb.partial_columns(); }
+
+    void set_partial_columns(bool partial_columns) {
+        _rowset_meta_pb.set_partial_columns(partial_columns);
+    }
+
+    bool missing_indexes() const { return _rowset_meta_pb.missing_indexes(); }
+
+    void set_missing_indexes(bool missing_indexes) {
+        _rowset_meta_pb.set_missing_indexes(missing_indexes);
+    }
+
     SegmentsOverlapPB segments_overlap() const { return _rowset_meta_pb.segments_overlap_pb(); }
 
     void set_segments_overlap(SegmentsOverlapPB segments_overlap) {
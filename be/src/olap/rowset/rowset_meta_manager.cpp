@@ -108,6 +108,18 @@ OLAPStatus RowsetMetaManager::remove(OlapMeta* meta, TabletUid tablet_uid,
     return status;
 }
 
+OLAPStatus RowsetMetaManager::remove(OlapMeta* meta, TabletUid tablet_uid,
+                                     const std::vector<RowsetId>& rowset_ids) {
+    std::vector<OlapMeta::WriteOp> ops;
+    ops.reserve(rowset_ids.size());
+    for (auto& rowset_id : rowset_ids) {
+        std::string key = ROWSET_PREFIX + tablet_uid.to_string() + "_" + rowset_id.to_string();
+        ops.push_back({META_COLUMN_FAMILY_INDEX, key, "", true});
+    }
+    VLOG(3) << "start to remove " << rowset_ids.size() << " rowsets of tablet:" << tablet_uid.to_string();
+    return meta->write_batch(ops);
+}
+
 OLAPStatus RowsetMetaManager::traverse_rowset_metas(
         OlapMeta* meta,
         std::function<bool(const TabletUid&, const RowsetId&, const std::string&)> const& func) {
@@ -19,6 +19,7 @@
 #define DORIS_BE_SRC_OLAP_ROWSET_ROWSET_META_MANAGER_H
 
 #include <string>
+#include <vector>
 
 #include "olap/olap_meta.h"
 #include "olap/rowset/rowset_meta.h"
@@ -44,6 +45,10 @@ public:
 
     static OLAPStatus remove(OlapMeta* meta, TabletUid tablet_uid, const RowsetId& rowset_id);
 
+    // remove the rowset metas of one tablet in one write batch
+    static OLAPStatus remove(OlapMeta* meta, TabletUid tablet_uid,
+                             const std::vector<RowsetId>& rowset_ids);
+
     static OLAPStatus traverse_rowset_metas(
             OlapMeta* meta,
             std::function<bool(const TabletUid&, const RowsetId&, const std::string&)> const& func);
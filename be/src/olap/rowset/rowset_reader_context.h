@@ -28,6 +28,8 @@ class RowCursor;
 class Conditions;
 class DeleteHandler;
 class TabletSchema;
+class BlockFilter;
+class DeleteBitmap;
 
 struct RowsetReaderContext {
     ReaderType reader_type = READER_QUERY;
@@ -47,11 +49,17 @@ struct RowsetReaderContext {
     // column name -> column predicate
     // adding column_name for predicate to make use of column selectivity
     const std::vector<ColumnPredicate*>* predicates = nullptr;
+    // filters evaluated on row blocks, only supported by beta rowset
+    const std::vector<BlockFilter*>* block_filters = nullptr;
     const std::vector<RowCursor*>* lower_bound_keys = nullptr;
     const std::vector<bool>* is_lower_keys_included = nullptr;
     const std::vector<RowCursor*>* upper_bound_keys = nullptr;
     const std::vector<bool>* is_upper_keys_included = nullptr;
     const DeleteHandler* delete_handler = nullptr;
+    // delete bitmap of a merge-on-write tablet, rows replaced by a version not newer
+    // than `delete_bitmap_version` are skipped. only supported by beta rowset
+    const DeleteBitmap* delete_bitmap = nullptr;
+    int64_t delete_bitmap_version = -1;
     OlapReaderStatistics* stats = nullptr;
     RuntimeState* runtime_state = nullptr;
     bool use_page_cache = false;
@@ -21,12 +21,14 @@
 #include "gen_cpp/types.pb.h"
 #include "gutil/macros.h"
 #include "olap/column_mapping.h"
+#include "olap/row.h"
 #include "olap/rowset/rowset.h"
 #include "olap/rowset/rowset_writer_context.h"
 
 namespace doris {
 
-class ContiguousRow;
+class MemTable;
+class RowBlockV2;
 class RowCursor;
 
 class RowsetWriter {
@@ -41,6 +43,15 @@ public:
     virtual OLAPStatus add_row(const RowCursor& row) = 0;
     virtual OLAPStatus add_row(const ContiguousRow& row) = 0;
 
+    // Add `rows', whose memory must be valid until it returns. A writer may append a batch
+    // of rows column by column, they are added one by one by default.
+    virtual OLAPStatus add_rows(const std::vector<ContiguousRow>& rows) {
+        for (const auto& row : rows) {
+            RETURN_NOT_OK(add_row(row));
+        }
+        return OLAP_SUCCESS;
+    }
+
     // Precondition: the input `rowset` should have the same type of the rowset we're building
     virtual OLAPStatus add_rowset(RowsetSharedPtr rowset) = 0;
 
@@ -52,6 +63,46 @@ public:
     // note that `add_row` could also trigger flush when certain conditions are met
     virtual OLAPStatus flush() = 0;
 
+    // Memtables of a load are flushed one at a time through add_row() and flush() by default.
+    // A writer which supports concurrent flush writes each memtable to its own segment
+    // reserved by reserve_segment() in the order the memtables are generated, so the order
+    // of segments doesn't depend on which flush finishes first.
+    virtual bool support_concurrent_flush() const { return false; }
+
+    // Return the id of the reserved segment, which must be written by flush_memtable().
+    virtual int32_t reserve_segment() { return -1; }
+
+    // Write all rows of `mem_table` to the reserved segment `segment_id`, it's thread safe
+    // for different segments.
+    virtual OLAPStatus flush_memtable(MemTable* mem_table, int32_t segment_id) {
+        return OLAP_ERR_FUNC_NOT_IMPLEMENTED;
+    }
+
+    // Add the selected rows [offset, offset + num_rows) of `block`, i.e. the rows indexed by
+    // selection_vector()[offset, offset + num_rows).
+    virtual OLAPStatus add_block(const RowBlockV2& block, size_t offset, size_t num_rows) {
+        return OLAP_ERR_FUNC_NOT_IMPLEMENTED;
+    }
+
+    // Vertical compaction writes the columns of a rowset group by group: the key group
+    // first, which decides the segments and their rows, then every value group with
+    // the same rows in the same order:
+    //   add_columns(key ids, true)... -> flush_columns() ->
+    //   add_columns(value ids, false)... -> flush_columns() -> ... -> final_flush()
+    // A segment of the key group is closed once it has `max_rows_per_segment` rows.
+    virtual bool support_vertical_write() const { return false; }
+
+    virtual OLAPStatus add_columns(const RowBlockV2& block, const std::vector<uint32_t>& col_ids,
+                                   bool is_key, uint32_t max_rows_per_segment) {
+        return OLAP_ERR_FUNC_NOT_IMPLEMENTED;
+    }
+
+    // Finish the columns of current group.
+    virtual OLAPStatus flush_columns() { return OLAP_ERR_FUNC_NOT_IMPLEMENTED; }
+
+    // Finish all segments written by add_columns().
+    virtual OLAPStatus final_flush() { return OLAP_ERR_FUNC_NOT_IMPLEMENTED; }
+
     // finish building and return pointer to the built rowset (guaranteed to be inited).
     // return nullptr when failed
     virtual RowsetSharedPtr build() = 0;
@@ -62,6 +113,8 @@ public:
 
     virtual RowsetId rowset_id() = 0;
 
+    virtual RowsetTypePB type() = 0;
+
 private:
     DISALLOW_COPY_AND_ASSIGN(RowsetWriter);
 };
@@ -69,6 +69,13 @@ struct RowsetWriterContext {
     // the default is set to INT32_MAX to avoid overflow issue when casting from uint32_t to int.
     // test cases can change this value to control flush timing
     uint32_t max_rows_per_segment = INT32_MAX;
+    // whether the rows only have the values of some columns, the others are null
+    // and filled from the older versions when read. See RowsetMetaPB.partial_columns.
+    bool partial_columns = false;
+    // the data dir to record the write latencies to, if not null
+    DataDir* data_dir = nullptr;
+    // write the segments with O_DIRECT, bypassing the page cache
+    bool direct_io = false;
 };
 
 } // namespace doris
@@ -231,8 +231,17 @@ void BinaryDictPageDecoder::set_dict_decoder(PageDecoder* dict_decoder) {
     _dict_decoder = (BinaryPlainPageDecoder*)dict_decoder;
 };
 
+void BinaryDictPageDecoder::set_dict_decoder(PageDecoder* dict_decoder, const Slice* dict_words,
+                                             uint64_t dict_id) {
+    _dict_decoder = (BinaryPlainPageDecoder*)dict_decoder;
+    _dict_words = dict_words;
+    _dict_id = dict_id;
+}
+
 Status BinaryDictPageDecoder::next_batch(size_t* n, ColumnBlockView* dst) {
     if (_encoding_type == PLAIN_ENCODING) {
+        // rows of this page have no dictionary code
+        dst->column_block()->vector_batch()->set_dict_mixed();
         return _data_page_decoder->next_batch(n, dst);
     }
     // dictionary encoding
@@ -248,6 +257,17 @@ Status BinaryDictPageDecoder::next_batch(size_t* n, ColumnBlockView* dst) {
     ColumnBlock column_block(_batch.get(), dst->column_block()->pool());
     ColumnBlockView tmp_block_view(&column_block);
     RETURN_IF_ERROR(_data_page_decoder->next_batch(n, &tmp_block_view));
+    const int32_t* codewords = reinterpret_cast<const int32_t*>(column_block.cell_ptr(0));
+    if (_dict_words != nullptr) {
+        int32_t* codes = dst->column_block()->vector_batch()->prepare_dict_codes(
+                _dict_id, _dict_words, _dict_decoder->count(), dst->current_offset(), *n);
+        memcpy(codes, codewords, *n * sizeof(int32_t));
+        // words are kept alive by the owner of the dictionary page
+        for (int i = 0; i < *n; ++i) {
+            out[i] = _dict_words[codewords[i]];
+        }
+        return Status::OK();
+    }
     for (int i = 0; i < *n; ++i) {
         int32_t codeword = *reinterpret_cast<const int32_t*>(column_block.cell_ptr(i));
         // get the string from the dict decoder
@@ -114,11 +114,20 @@ public:
 
     void set_dict_decoder(PageDecoder* dict_decoder);
 
+    // Besides the dict decoder, give the words of the dictionary and an id
+    // unique to it. Decoded values then point into the dictionary page instead
+    // of being copied, so the caller must keep the dictionary page alive as long
+    // as the decoded data is used. The dictionary codes are also kept in the
+    // destination ColumnVectorBatch for predicates to evaluate on.
+    void set_dict_decoder(PageDecoder* dict_decoder, const Slice* dict_words, uint64_t dict_id);
+
 private:
     Slice _data;
     PageDecoderOptions _options;
     std::unique_ptr<PageDecoder> _data_page_decoder;
     const BinaryPlainPageDecoder* _dict_decoder = nullptr;
+    const Slice* _dict_words = nullptr;
+    uint64_t _dict_id = 0;
     bool _parsed;
     EncodingTypePB _encoding_type;
     // use as data buf.
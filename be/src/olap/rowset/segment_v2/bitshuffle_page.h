@@ -212,7 +212,8 @@ public:
               _compressed_size(0),
               _num_element_after_padding(0),
               _size_of_element(0),
-              _cur_index(0) {}
+              _cur_index(0),
+              _decoded_ready(false) {}
 
     Status init() override {
         CHECK(!_parsed);
@@ -268,7 +269,8 @@ public:
             return Status::InternalError(ss.str());
         }
 
-        RETURN_IF_ERROR(_decode());
+        // the page is unshuffled by the first read, straight into the column block if
+        // possible, see next_batch()
         _parsed = true;
         return Status::OK();
     }
@@ -281,6 +283,7 @@ public:
         }
 
         DCHECK_LE(pos, _num_elements);
+        RETURN_IF_ERROR(_decode());
         _cur_index = pos;
         return Status::OK();
     }
@@ -291,6 +294,7 @@ public:
         if (_num_elements == 0) {
             return Status::NotFound("page is empty");
         }
+        RETURN_IF_ERROR(_decode());
 
         size_t left = 0;
         size_t right = _num_elements;
@@ -334,6 +338,18 @@ public:
         }
 
         size_t max_fetch = std::min(*n, static_cast<size_t>(_num_elements - _cur_index));
+        if (forward_index && !_decoded_ready && _cur_index == 0 && max_fetch == _num_elements &&
+            _size_of_element == SIZE_OF_TYPE &&
+            dst->column_block()->vector_batch()->capacity() - dst->current_offset() >=
+                    _num_element_after_padding) {
+            // The whole page is read at once, unshuffle into the column block directly
+            // to save a copy. The padding values are beyond the rows read.
+            RETURN_IF_ERROR(_decode_to(dst->data()));
+            *n = max_fetch;
+            _cur_index += max_fetch;
+            return Status::OK();
+        }
+        RETURN_IF_ERROR(_decode());
         _copy_next_values(max_fetch, dst->data());
         *n = max_fetch;
         if (forward_index) {
@@ -356,13 +372,24 @@ private:
         memcpy(data, &_decoded[_cur_index * SIZE_OF_TYPE], n * SIZE_OF_TYPE);
     }
 
+    // Unshuffle the page into _decoded if not yet
     Status _decode() {
+        if (_decoded_ready) {
+            return Status::OK();
+        }
+        _decoded.resize(_num_element_after_padding * _size_of_element);
+        RETURN_IF_ERROR(_decode_to(_decoded.data()));
+        _decoded_ready = true;
+        return Status::OK();
+    }
+
+    // Unshuffle the page into 'out', which must be able to hold
+    // _num_element_after_padding elements
+    Status _decode_to(void* out) {
         if (_num_elements > 0) {
-            int64_t bytes;
-            _decoded.resize(_num_element_after_padding * _size_of_element);
             char* in = const_cast<char*>(&_data[BITSHUFFLE_PAGE_HEADER_SIZE]);
-            bytes = bitshuffle::decompress_lz4(in, _decoded.data(), _num_element_after_padding,
-                                               _size_of_element, 0);
+            int64_t bytes = bitshuffle::decompress_lz4(in, out, _num_element_after_padding,
+                                                       _size_of_element, 0);
             if (PREDICT_FALSE(bytes < 0)) {
                 // Ideally, this should not happen.
                 warn_with_bitshuffle_error(bytes);
@@ -386,6 +413,7 @@ private:
     int _size_of_element;
     size_t _cur_index;
     faststring _decoded;
+    bool _decoded_ready;
 };
 
 } // namespace segment_v2
@@ -17,48 +17,96 @@
 
 #include "olap/rowset/segment_v2/block_split_bloom_filter.h"
 
+#include "util/cpu_dispatch.h"
 #include "util/debug_util.h"
 
+#ifdef DORIS_TARGET_AVX2
+#include <immintrin.h>
+#endif
+
 namespace doris {
 namespace segment_v2 {
 
 const uint32_t BlockSplitBloomFilter::SALT[8] = {0x47b6137b, 0x44974d91, 0x8824ad5b, 0xa2b7289d,
                                                  0x705495c7, 0x2df1424b, 0x9efc4947, 0x5c6bfb31};
 
-void BlockSplitBloomFilter::add_hash(uint64_t hash) {
-    // most significant 32 bit mod block size as block index(BTW:block size is
-    // power of 2)
-    DCHECK(_num_bytes >= BYTES_PER_BLOCK);
-    uint32_t block_size = _num_bytes / BYTES_PER_BLOCK;
-    uint32_t block_index = (uint32_t)(hash >> 32) & (block_size - 1);
-    uint32_t key = (uint32_t)hash;
+#ifdef DORIS_TARGET_AVX2
+
+// The masks of the 8 words of a block: the (key * salt[i]) >> 27 bit of word i
+DORIS_TARGET_AVX2 static inline __m256i make_masks(uint32_t key, const uint32_t* salt) {
+    __m256i salts = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(salt));
+    __m256i bits = _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_set1_epi32(key), salts), 27);
+    return _mm256_sllv_epi32(_mm256_set1_epi32(1), bits);
+}
+
+DORIS_TARGET_AVX2 static void insert_block_avx2(uint32_t* block, uint32_t key,
+                                                const uint32_t* salt) {
+    // the data of bloom filter is not aligned to 32 bytes
+    __m256i* dst = reinterpret_cast<__m256i*>(block);
+    _mm256_storeu_si256(dst, _mm256_or_si256(_mm256_loadu_si256(dst), make_masks(key, salt)));
+}
 
+DORIS_TARGET_AVX2 static bool test_block_avx2(const uint32_t* block, uint32_t key,
+                                              const uint32_t* salt) {
+    __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+    // all the bits of the masks are set in the block
+    return _mm256_testc_si256(data, make_masks(key, salt));
+}
+
+#endif // DORIS_TARGET_AVX2
+
+void BlockSplitBloomFilter::_insert_block(uint32_t* block, uint32_t key) {
+#ifdef DORIS_TARGET_AVX2
+    if (cpu_dispatch::best_isa() >= cpu_dispatch::Isa::AVX2) {
+        insert_block_avx2(block, key, SALT);
+        return;
+    }
+#endif
     // Calculate masks for bucket.
-    uint32_t masks[8];
+    uint32_t masks[BITS_SET_PER_BLOCK];
     _set_masks(key, masks);
-    uint32_t* block_offset = (uint32_t*)(_data + BYTES_PER_BLOCK * block_index);
     for (int i = 0; i < BITS_SET_PER_BLOCK; ++i) {
-        *(block_offset + i) |= masks[i];
+        *(block + i) |= masks[i];
     }
 }
 
-bool BlockSplitBloomFilter::test_hash(uint64_t hash) const {
-    // most significant 32 bit mod block size as block index(BTW:block size is
-    // power of 2)
-    uint32_t block_size = _num_bytes / BYTES_PER_BLOCK;
-    uint32_t block_index = (uint32_t)(hash >> 32) & (block_size - 1);
-    uint32_t key = (uint32_t)hash;
+bool BlockSplitBloomFilter::_test_block(const uint32_t* block, uint32_t key) const {
+#ifdef DORIS_TARGET_AVX2
+    if (cpu_dispatch::best_isa() >= cpu_dispatch::Isa::AVX2) {
+        return test_block_avx2(block, key, SALT);
+    }
+#endif
     // Calculate masks for bucket.
     uint32_t masks[BITS_SET_PER_BLOCK];
     _set_masks(key, masks);
-    uint32_t* block_offset = (uint32_t*)(_data + BYTES_PER_BLOCK * block_index);
     for (int i = 0; i < BITS_SET_PER_BLOCK; ++i) {
-        if ((*(block_offset + i) & masks[i]) == 0) {
+        if ((*(block + i) & masks[i]) == 0) {
             return false;
         }
     }
     return true;
 }
 
+void BlockSplitBloomFilter::add_hash(uint64_t hash) {
+    DCHECK(_num_bytes >= BYTES_PER_BLOCK);
+    _insert_block(_block(hash), (uint32_t)hash);
+}
+
+bool BlockSplitBloomFilter::test_hash(uint64_t hash) const {
+    return _test_block(_block(hash), (uint32_t)hash);
+}
+
+void BlockSplitBloomFilter::test_hashes(const uint64_t* hashes, size_t num, bool* results) const {
+    for (size_t i = 0; i < num && i < PREFETCH_DISTANCE; ++i) {
+        __builtin_prefetch(_block(hashes[i]));
+    }
+    for (size_t i = 0; i < num; ++i) {
+        if (i + PREFETCH_DISTANCE < num) {
+            __builtin_prefetch(_block(hashes[i + PREFETCH_DISTANCE]));
+        }
+        results[i] = _test_block(_block(hashes[i]), (uint32_t)hashes[i]);
+    }
+}
+
 } // namespace segment_v2
 } // namespace doris
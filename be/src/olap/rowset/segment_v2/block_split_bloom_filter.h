@@ -26,13 +26,17 @@ namespace segment_v2 {
 // from Putze et al.'s "Cache-, Hash- and Space-Efficient Bloom filters". The basic
 // idea is to hash the item to a tiny Bloom filter which size fit a single cache line
 // or smaller. This implementation sets 8 bits in each tiny Bloom filter. Each tiny
-// Bloom filter is 32 bytes to take advantage of 32-byte SIMD instruction.
+// Bloom filter is 32 bytes to take advantage of 32-byte SIMD instruction: on the CPUs
+// with AVX2, the 8 words of a block are inserted and tested in one 256-bit register.
 class BlockSplitBloomFilter : public BloomFilter {
 public:
     void add_hash(uint64_t hash) override;
 
     bool test_hash(uint64_t hash) const override;
 
+    // Prefetches the blocks of the following hashes, whose accesses are random
+    void test_hashes(const uint64_t* hashes, size_t num, bool* results) const override;
+
 private:
     void _set_masks(uint32_t key, uint32_t* masks) const {
         for (int i = 0; i < BITS_SET_PER_BLOCK; ++i) {
@@ -45,6 +49,18 @@ private:
         }
     }
 
+    uint32_t* _block(uint64_t hash) const {
+        // most significant 32 bit mod block size as block index(BTW:block size is
+        // power of 2)
+        uint32_t block_size = _num_bytes / BYTES_PER_BLOCK;
+        uint32_t block_index = (uint32_t)(hash >> 32) & (block_size - 1);
+        return (uint32_t*)(_data + BYTES_PER_BLOCK * block_index);
+    }
+
+    void _insert_block(uint32_t* block, uint32_t key);
+
+    bool _test_block(const uint32_t* block, uint32_t key) const;
+
 private:
     // Bytes in a tiny Bloom filter block.
     static const uint32_t BYTES_PER_BLOCK = 32;
@@ -52,6 +68,9 @@ private:
     // The number of bits to set in a tiny Bloom filter block
     static const int BITS_SET_PER_BLOCK = 8;
 
+    // How many hashes ahead test_hashes() prefetches the block of
+    static const size_t PREFETCH_DISTANCE = 8;
+
     static const uint32_t SALT[BITS_SET_PER_BLOCK];
 };
 
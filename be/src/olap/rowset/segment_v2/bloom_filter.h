@@ -134,6 +134,13 @@ public:
     virtual void add_hash(uint64_t hash) = 0;
     virtual bool test_hash(uint64_t hash) const = 0;
 
+    // Test a batch of hashes, results[i] is whether hashes[i] may be in the bloom filter
+    virtual void test_hashes(const uint64_t* hashes, size_t num, bool* results) const {
+        for (size_t i = 0; i < num; ++i) {
+            results[i] = test_hash(hashes[i]);
+        }
+    }
+
 private:
     // Compute the optimal bit number according to the following rule:
     //     m = -n * ln(fpp) / (ln(2) ^ 2)
@@ -17,25 +17,35 @@
 
 #include "olap/rowset/segment_v2/column_reader.h"
 
+#include <atomic>
+
 #include "common/logging.h"
 #include "gutil/strings/substitute.h"                // for Substitute
 #include "olap/column_block.h"                       // for ColumnBlockView
+#include "olap/page_cache.h"
 #include "olap/rowset/segment_v2/binary_dict_page.h" // for BinaryDictPageDecoder
 #include "olap/rowset/segment_v2/bloom_filter_index_reader.h"
+#include "olap/rowset/segment_v2/decoded_page_cache.h"
 #include "olap/rowset/segment_v2/encoding_info.h" // for EncodingInfo
 #include "olap/rowset/segment_v2/page_handle.h"   // for PageHandle
 #include "olap/rowset/segment_v2/page_io.h"
 #include "olap/rowset/segment_v2/page_pointer.h" // for PagePointer
+#include "olap/rowset/segment_v2/statistics_index.h"
 #include "olap/types.h"                          // for TypeInfo
 #include "util/block_compression.h"
 #include "util/coding.h"       // for get_varint32
 #include "util/rle_encoding.h" // for RleDecoder
+#include "util/runtime_profile.h"
+#include "util/threadpool.h"
 
 namespace doris {
 namespace segment_v2 {
 
 using strings::Substitute;
 
+// id 0 means "no dictionary"
+static std::atomic<uint64_t> s_next_dict_id(1);
+
 Status ColumnReader::create(const ColumnReaderOptions& opts, const ColumnMetaPB& meta,
                             uint64_t num_rows, const std::string& file_name,
                             std::unique_ptr<ColumnReader>* reader) {
@@ -51,7 +61,10 @@ Status ColumnReader::create(const ColumnReaderOptions& opts, const ColumnMetaPB&
         case FieldType::OLAP_FIELD_TYPE_ARRAY: {
             std::unique_ptr<ColumnReader> item_reader;
             DCHECK(meta.children_columns_size() == 1);
-            RETURN_IF_ERROR(ColumnReader::create(opts, meta.children_columns(0),
+            // the index file has no index of items
+            ColumnReaderOptions item_opts = opts;
+            item_opts.index_file_meta = nullptr;
+            RETURN_IF_ERROR(ColumnReader::create(item_opts, meta.children_columns(0),
                                                  meta.children_columns(0).num_rows(), file_name,
                                                  &item_reader));
             RETURN_IF_ERROR(item_reader->init());
@@ -73,7 +86,12 @@ Status ColumnReader::create(const ColumnReaderOptions& opts, const ColumnMetaPB&
 
 ColumnReader::ColumnReader(const ColumnReaderOptions& opts, const ColumnMetaPB& meta,
                            uint64_t num_rows, const std::string& file_name)
-        : _meta(meta), _opts(opts), _num_rows(num_rows), _file_name(file_name) {}
+        : _meta(meta), _opts(opts), _num_rows(num_rows), _file_name(file_name) {
+    if (opts.index_file_meta != nullptr) {
+        _index_file_meta = *opts.index_file_meta;
+    }
+    _opts.index_file_meta = nullptr;
+}
 
 ColumnReader::~ColumnReader() = default;
 
@@ -101,6 +119,15 @@ Status ColumnReader::init() {
         case BLOOM_FILTER_INDEX:
             _bf_index_meta = &index_meta.bloom_filter_index();
             break;
+        case NGRAM_INDEX:
+            _ngram_index_meta = &index_meta.ngram_index();
+            break;
+        case S2_INDEX:
+            _s2_index_meta = &index_meta.s2_index();
+            break;
+        case STATISTICS_INDEX:
+            _statistics_index_meta = &index_meta.statistics_index();
+            break;
         default:
             return Status::Corruption(strings::Substitute(
                     "Bad file $0: invalid column index type $1", _file_name, index_meta.type()));
@@ -110,6 +137,25 @@ Status ColumnReader::init() {
         return Status::Corruption(strings::Substitute(
                 "Bad file $0: missing ordinal index for column $1", _file_name, _meta.column_id()));
     }
+    _bitmap_index_file_name = _file_name;
+    _bf_index_file_name = _file_name;
+    for (int i = 0; i < _index_file_meta.indexes_size(); i++) {
+        auto& index_meta = _index_file_meta.indexes(i);
+        if (index_meta.type() == BITMAP_INDEX && _bitmap_index_meta == nullptr) {
+            _bitmap_index_meta = &index_meta.bitmap_index();
+            _bitmap_index_file_name = _opts.index_file_name;
+        } else if (index_meta.type() == BLOOM_FILTER_INDEX && _bf_index_meta == nullptr) {
+            _bf_index_meta = &index_meta.bloom_filter_index();
+            _bf_index_file_name = _opts.index_file_name;
+        }
+    }
+    // tools reading segments may not create page cache
+    if (StoragePageCache::instance() != nullptr) {
+        _page_cache_file_id = StoragePageCache::instance()->file_id(_file_name);
+    }
+    _use_decoded_page_cache = _opts.kept_in_memory && _page_cache_file_id != 0 &&
+                              DecodedPageCache::instance() != nullptr &&
+                              DecodedPageCache::is_supported_type(_type_info->type());
     return Status::OK();
 }
 
@@ -119,12 +165,27 @@ Status ColumnReader::new_bitmap_index_iterator(BitmapIndexIterator** iterator) {
     return Status::OK();
 }
 
+Status ColumnReader::new_ngram_index_iterator(NGramIndexIterator** iterator) {
+    RETURN_IF_ERROR(_ensure_index_loaded());
+    RETURN_IF_ERROR(_ngram_index->new_iterator(iterator));
+    return Status::OK();
+}
+
+Status ColumnReader::new_s2_index_iterator(S2IndexIterator** iterator) {
+    RETURN_IF_ERROR(_ensure_index_loaded());
+    RETURN_IF_ERROR(_s2_index->new_iterator(iterator));
+    return Status::OK();
+}
+
 Status ColumnReader::read_page(const ColumnIteratorOptions& iter_opts, const PagePointer& pp,
-                               PageHandle* handle, Slice* page_body, PageFooterPB* footer) {
+                               PageTypePB type, PageHandle* handle, Slice* page_body,
+                               PageFooterPB* footer) {
     iter_opts.sanity_check();
     PageReadOptions opts;
     opts.rblock = iter_opts.rblock;
     opts.page_pointer = pp;
+    opts.file_id = _page_cache_file_id;
+    opts.type = type;
     opts.codec = _compress_codec;
     opts.stats = iter_opts.stats;
     opts.verify_checksum = _opts.verify_checksum;
@@ -158,6 +219,41 @@ bool ColumnReader::match_condition(CondColumn* cond) const {
                                      max_value.get(), cond);
 }
 
+int ColumnReader::delete_match_condition(CondColumn* del_cond) const {
+    if (_zone_map_index_meta == nullptr) {
+        return DEL_PARTIAL_SATISFIED;
+    }
+    const ZoneMapPB& zone_map = _zone_map_index_meta->segment_zone_map();
+    if (!zone_map.has_not_null() && !zone_map.has_null()) {
+        return DEL_PARTIAL_SATISFIED;
+    }
+    FieldType type = _type_info->type();
+    std::unique_ptr<WrapperField> min_value(WrapperField::create_by_type(type, _meta.length()));
+    std::unique_ptr<WrapperField> max_value(WrapperField::create_by_type(type, _meta.length()));
+    _parse_zone_map(zone_map, min_value.get(), max_value.get());
+    return del_cond->del_eval({min_value.get(), max_value.get()});
+}
+
+bool ColumnReader::get_segment_min_max(WrapperField* min_value, WrapperField* max_value) const {
+    if (_zone_map_index_meta == nullptr) {
+        return false;
+    }
+    const ZoneMapPB& zone_map = _zone_map_index_meta->segment_zone_map();
+    if (!zone_map.has_not_null()) {
+        min_value->set_null();
+        max_value->set_null();
+        return true;
+    }
+    // unlike _parse_zone_map(), null is not taken as the min value
+    if (min_value->from_string(zone_map.min()) != OLAP_SUCCESS ||
+        max_value->from_string(zone_map.max()) != OLAP_SUCCESS) {
+        return false;
+    }
+    min_value->set_not_null();
+    max_value->set_not_null();
+    return true;
+}
+
 void ColumnReader::_parse_zone_map(const ZoneMapPB& zone_map, WrapperField* min_value_container,
                                    WrapperField* max_value_container) const {
     // min value and max value are valid if has_not_null is true
@@ -282,7 +378,7 @@ Status ColumnReader::_load_zone_map_index(bool use_page_cache, bool kept_in_memo
 
 Status ColumnReader::_load_bitmap_index(bool use_page_cache, bool kept_in_memory) {
     if (_bitmap_index_meta != nullptr) {
-        _bitmap_index.reset(new BitmapIndexReader(_file_name, _bitmap_index_meta));
+        _bitmap_index.reset(new BitmapIndexReader(_bitmap_index_file_name, _bitmap_index_meta));
         return _bitmap_index->load(use_page_cache, kept_in_memory);
     }
     return Status::OK();
@@ -290,12 +386,29 @@ Status ColumnReader::_load_bitmap_index(bool use_page_cache, bool kept_in_memory
 
 Status ColumnReader::_load_bloom_filter_index(bool use_page_cache, bool kept_in_memory) {
     if (_bf_index_meta != nullptr) {
-        _bloom_filter_index.reset(new BloomFilterIndexReader(_file_name, _bf_index_meta));
+        _bloom_filter_index.reset(
+                new BloomFilterIndexReader(_bf_index_file_name, _bf_index_meta));
         return _bloom_filter_index->load(use_page_cache, kept_in_memory);
     }
     return Status::OK();
 }
 
+Status ColumnReader::_load_ngram_index(bool use_page_cache, bool kept_in_memory) {
+    if (_ngram_index_meta != nullptr) {
+        _ngram_index.reset(new NGramIndexReader(_file_name, _ngram_index_meta));
+        return _ngram_index->load(use_page_cache, kept_in_memory);
+    }
+    return Status::OK();
+}
+
+Status ColumnReader::_load_s2_index(bool use_page_cache, bool kept_in_memory) {
+    if (_s2_index_meta != nullptr) {
+        _s2_index.reset(new S2IndexReader(_file_name, _s2_index_meta));
+        return _s2_index->load(use_page_cache, kept_in_memory);
+    }
+    return Status::OK();
+}
+
 Status ColumnReader::seek_to_first(OrdinalPageIndexIterator* iter) {
     RETURN_IF_ERROR(_ensure_index_loaded());
     *iter = _ordinal_index->begin();
@@ -314,6 +427,50 @@ Status ColumnReader::seek_at_or_before(ordinal_t ordinal, OrdinalPageIndexIterat
     return Status::OK();
 }
 
+Status ColumnReader::get_page_first_ordinals(std::vector<ordinal_t>* ordinals) {
+    RETURN_IF_ERROR(_ensure_index_loaded());
+    ordinals->clear();
+    for (int32_t i = 0; i < _ordinal_index->num_data_pages(); ++i) {
+        ordinals->push_back(_ordinal_index->get_first_ordinal(i));
+    }
+    return Status::OK();
+}
+
+// The indexes below are read only by the collection of statistics, so they are read by
+// temporary readers instead of being kept in memory with the other indexes.
+Status ColumnReader::get_page_zone_maps(std::vector<ZoneMapPB>* zone_maps,
+                                        std::vector<uint32_t>* page_num_rows) {
+    if (_zone_map_index_meta == nullptr) {
+        return Status::NotSupported("no zone map");
+    }
+    bool use_page_cache = !config::disable_storage_page_cache;
+    ZoneMapIndexReader zone_map_index(_file_name, _zone_map_index_meta);
+    RETURN_IF_ERROR(zone_map_index.load(use_page_cache, false));
+    OrdinalIndexReader ordinal_index(_file_name, _ordinal_index_meta, _num_rows);
+    RETURN_IF_ERROR(ordinal_index.load(use_page_cache, false));
+    if (zone_map_index.num_pages() != ordinal_index.num_data_pages()) {
+        return Status::Corruption(strings::Substitute(
+                "Bad file $0: column $1 has $2 pages but $3 page zone maps", _file_name,
+                _meta.column_id(), ordinal_index.num_data_pages(), zone_map_index.num_pages()));
+    }
+    *zone_maps = zone_map_index.page_zone_maps();
+    page_num_rows->clear();
+    for (int32_t i = 0; i < ordinal_index.num_data_pages(); ++i) {
+        page_num_rows->push_back(ordinal_index.get_last_ordinal(i) -
+                                 ordinal_index.get_first_ordinal(i) + 1);
+    }
+    return Status::OK();
+}
+
+Status ColumnReader::get_statistics(uint64_t* null_count, std::string* ndv_sketch) {
+    if (_statistics_index_meta == nullptr) {
+        return Status::NotSupported("no statistics index");
+    }
+    StatisticsIndexReader reader(_file_name, _statistics_index_meta);
+    *null_count = reader.null_count();
+    return reader.read_ndv_sketch(!config::disable_storage_page_cache, ndv_sketch);
+}
+
 Status ColumnReader::new_iterator(ColumnIterator** iterator) {
     if (is_scalar_type((FieldType)_meta.type())) {
         *iterator = new FileColumnIterator(this);
@@ -431,7 +588,22 @@ Status ArrayFileColumnIterator::next_batch(size_t* n, ColumnBlockView* dst, bool
 
 FileColumnIterator::FileColumnIterator(ColumnReader* reader) : _reader(reader) {}
 
-FileColumnIterator::~FileColumnIterator() = default;
+FileColumnIterator::~FileColumnIterator() {
+    // pages being read refer to the block and the reader
+    std::unique_lock<std::mutex> l(_read_ahead_lock);
+    _read_ahead_cv.wait(l, [this]() { return _num_read_ahead_running == 0; });
+}
+
+void FileColumnIterator::enable_read_ahead(ThreadPool* pool, int num_pages,
+                                           const Roaring* row_bitmap) {
+    if (_reader->use_decoded_page_cache()) {
+        // pages are usually decoded from the cache without any read
+        return;
+    }
+    _read_ahead_pool = pool;
+    _num_read_ahead_pages = num_pages;
+    _read_ahead_rows = row_bitmap;
+}
 
 Status FileColumnIterator::seek_to_first() {
     RETURN_IF_ERROR(_reader->seek_to_first(&_page_iter));
@@ -566,14 +738,31 @@ Status FileColumnIterator::_load_next_page(bool* eos) {
 }
 
 Status FileColumnIterator::_read_data_page(const OrdinalPageIndexIterator& iter) {
+    if (_reader->use_decoded_page_cache()) {
+        std::shared_ptr<const DecodedPage> decoded_page;
+        if (DecodedPageCache::instance()->lookup(_reader->page_cache_key(iter.page()),
+                                                 &decoded_page)) {
+            return ParsedPage::create(std::move(decoded_page), iter.page(), iter.page_index(),
+                                      &_page);
+        }
+    }
     PageHandle handle;
     Slice page_body;
     PageFooterPB footer;
-    RETURN_IF_ERROR(_reader->read_page(_opts, iter.page(), &handle, &page_body, &footer));
+    bool found = false;
+    RETURN_IF_ERROR(_take_read_ahead_page(iter, &handle, &page_body, &footer, &found));
+    if (!found) {
+        RETURN_IF_ERROR(
+                _reader->read_page(_opts, iter.page(), DATA_PAGE, &handle, &page_body, &footer));
+    }
+    _schedule_read_ahead(iter);
     // parse data page
     RETURN_IF_ERROR(ParsedPage::create(std::move(handle), page_body, footer.data_page_footer(),
                                        _reader->encoding_info(), iter.page(), iter.page_index(),
                                        &_page));
+    if (_reader->use_decoded_page_cache()) {
+        return _cache_decoded_page(iter);
+    }
 
     // dictionary page is read when the first data page that uses it is read,
     // this is to optimize the memory usage: when there is no query on one column, we could
@@ -588,18 +777,132 @@ Status FileColumnIterator::_read_data_page(const OrdinalPageIndexIterator& iter)
                 Slice dict_data;
                 PageFooterPB dict_footer;
                 RETURN_IF_ERROR(_reader->read_page(_opts, _reader->get_dict_page_pointer(),
-                                                   &_dict_page_handle, &dict_data, &dict_footer));
+                                                   DICTIONARY_PAGE, &_dict_page_handle,
+                                                   &dict_data, &dict_footer));
                 // ignore dict_footer.dict_page_footer().encoding() due to only
                 // PLAIN_ENCODING is supported for dict page right now
-                _dict_decoder.reset(new BinaryPlainPageDecoder(dict_data));
+                auto dict_decoder = new BinaryPlainPageDecoder(dict_data);
+                _dict_decoder.reset(dict_decoder);
                 RETURN_IF_ERROR(_dict_decoder->init());
+
+                _dict_words.resize(dict_decoder->count());
+                for (size_t i = 0; i < _dict_words.size(); ++i) {
+                    _dict_words[i] = dict_decoder->string_at_index(i);
+                }
+                _dict_id = s_next_dict_id.fetch_add(1);
             }
-            dict_page_decoder->set_dict_decoder(_dict_decoder.get());
+            dict_page_decoder->set_dict_decoder(_dict_decoder.get(), _dict_words.data(), _dict_id);
         }
     }
     return Status::OK();
 }
 
+Status FileColumnIterator::_cache_decoded_page(const OrdinalPageIndexIterator& iter) {
+    std::shared_ptr<DecodedPage> decoded_page(new DecodedPage());
+    decoded_page->first_ordinal = _page->first_ordinal;
+    decoded_page->num_rows = _page->num_rows;
+    decoded_page->null_bitmap = _page->null_bitmap.to_string();
+    size_t num_values = _page->data_decoder->count();
+    RETURN_IF_ERROR(ColumnVectorBatch::create(num_values, false, _reader->type_info(), nullptr,
+                                              &decoded_page->values));
+    // fixed-length values don't need a MemPool
+    ColumnBlock block(decoded_page->values.get(), nullptr);
+    ColumnBlockView dst(&block);
+    size_t num_decoded = num_values;
+    RETURN_IF_ERROR(_page->data_decoder->next_batch(&num_decoded, &dst));
+    if (num_decoded != num_values) {
+        return Status::Corruption(strings::Substitute("Bad data page $0: $1 values, $2 decoded",
+                                                      iter.page_index(), num_values, num_decoded));
+    }
+    DecodedPageCache::instance()->insert(_reader->page_cache_key(iter.page()), decoded_page);
+    return ParsedPage::create(std::move(decoded_page), iter.page(), iter.page_index(), &_page);
+}
+
+Status FileColumnIterator::_take_read_ahead_page(const OrdinalPageIndexIterator& iter,
+                                                 PageHandle* handle, Slice* body,
+                                                 PageFooterPB* footer, bool* found) {
+    *found = false;
+    // drop the pages skipped by a seek
+    while (!_read_ahead_pages.empty() &&
+           _read_ahead_pages.front()->page_index < iter.page_index()) {
+        _read_ahead_pages.pop_front();
+    }
+    if (_read_ahead_pages.empty() || _read_ahead_pages.front()->page_index != iter.page_index()) {
+        // seek backward, start over from this page
+        _read_ahead_pages.clear();
+        _next_read_ahead_index = iter.page_index() + 1;
+        return Status::OK();
+    }
+
+    std::shared_ptr<ReadAheadPage> page = std::move(_read_ahead_pages.front());
+    _read_ahead_pages.pop_front();
+    {
+        SCOPED_RAW_TIMER(&_opts.stats->read_ahead_wait_ns);
+        std::unique_lock<std::mutex> l(_read_ahead_lock);
+        _read_ahead_cv.wait(l, [&page]() { return page->done; });
+    }
+    _opts.stats->total_pages_num += page->stats.total_pages_num;
+    _opts.stats->cached_pages_num += page->stats.cached_pages_num;
+    _opts.stats->io_ns += page->stats.io_ns;
+    _opts.stats->compressed_bytes_read += page->stats.compressed_bytes_read;
+    _opts.stats->decompress_ns += page->stats.decompress_ns;
+    _opts.stats->uncompressed_bytes_read += page->stats.uncompressed_bytes_read;
+    _opts.stats->read_ahead_pages_num++;
+    RETURN_IF_ERROR(page->status);
+    *handle = std::move(page->handle);
+    *body = page->body;
+    *footer = std::move(page->footer);
+    *found = true;
+    return Status::OK();
+}
+
+void FileColumnIterator::_schedule_read_ahead(const OrdinalPageIndexIterator& iter) {
+    if (_read_ahead_pool == nullptr || _read_ahead_rows->isEmpty()) {
+        return;
+    }
+    uint32_t last_row = _read_ahead_rows->maximum();
+    OrdinalPageIndexIterator next = iter;
+    next.seek_to_page(std::max(_next_read_ahead_index, iter.page_index() + 1));
+    while ((int)_read_ahead_pages.size() < _num_read_ahead_pages && next.valid() &&
+           next.first_ordinal() <= last_row) {
+        // skip the pages which have no row to read
+        ordinal_t first = next.first_ordinal();
+        uint64_t num_rows_before = first == 0 ? 0 : _read_ahead_rows->rank(first - 1);
+        if (_read_ahead_rows->rank(next.last_ordinal()) == num_rows_before) {
+            next.next();
+            continue;
+        }
+
+        auto page = std::make_shared<ReadAheadPage>();
+        page->page_index = next.page_index();
+        ColumnIteratorOptions opts = _opts;
+        opts.stats = &page->stats;
+        PagePointer pp = next.page();
+        {
+            std::lock_guard<std::mutex> l(_read_ahead_lock);
+            ++_num_read_ahead_running;
+        }
+        Status st = _read_ahead_pool->submit_func([this, page, opts, pp]() {
+            Status st = _reader->read_page(opts, pp, DATA_PAGE, &page->handle, &page->body,
+                                           &page->footer);
+            std::lock_guard<std::mutex> l(_read_ahead_lock);
+            page->status = st;
+            page->done = true;
+            --_num_read_ahead_running;
+            _read_ahead_cv.notify_all();
+        });
+        if (!st.ok()) {
+            // the pool is shut down or full, read synchronously
+            std::lock_guard<std::mutex> l(_read_ahead_lock);
+            --_num_read_ahead_running;
+            break;
+        }
+        _read_ahead_pages.push_back(std::move(page));
+        next.next();
+    }
+    _next_read_ahead_index = next.page_index();
+}
+
 Status FileColumnIterator::get_row_ranges_by_zone_map(CondColumn* cond_column,
                                                       CondColumn* delete_condition,
                                                       RowRanges* row_ranges) {
@@ -17,20 +17,26 @@
 
 #pragma once
 
+#include <condition_variable>
 #include <cstddef> // for size_t
 #include <cstdint> // for uint32_t
-#include <memory>  // for unique_ptr
+#include <deque>
+#include <memory> // for unique_ptr
+#include <mutex>
 
 #include "common/logging.h"
 #include "common/status.h"                              // for Status
 #include "gen_cpp/segment_v2.pb.h"                      // for ColumnMetaPB
+#include "olap/olap_common.h"                           // for OlapReaderStatistics
 #include "olap/olap_cond.h"                             // for CondColumn
 #include "olap/rowset/segment_v2/bitmap_index_reader.h" // for BitmapIndexReader
 #include "olap/rowset/segment_v2/common.h"
+#include "olap/rowset/segment_v2/ngram_index_reader.h" // for NGramIndexReader
 #include "olap/rowset/segment_v2/ordinal_page_index.h" // for OrdinalPageIndexIterator
 #include "olap/rowset/segment_v2/page_handle.h"        // for PageHandle
 #include "olap/rowset/segment_v2/parsed_page.h"        // for ParsedPage
 #include "olap/rowset/segment_v2/row_ranges.h"         // for RowRanges
+#include "olap/rowset/segment_v2/s2_index_reader.h"    // for S2IndexReader
 #include "olap/rowset/segment_v2/zone_map_index.h"
 #include "olap/tablet_schema.h"
 #include "util/file_cache.h"
@@ -39,6 +45,7 @@
 namespace doris {
 
 class ColumnBlock;
+class ThreadPool;
 class TypeInfo;
 class BlockCompressionCodec;
 class WrapperField;
@@ -60,6 +67,10 @@ struct ColumnReaderOptions {
     bool verify_checksum = true;
     // for in memory olap table, use DURABLE CachePriority in page cache
     bool kept_in_memory = false;
+    // the column in the index file of the segment, whose bitmap and bloom filter indexes
+    // are used if the segment file lacks them
+    const ColumnMetaPB* index_file_meta = nullptr;
+    std::string index_file_name;
 };
 
 struct ColumnIteratorOptions {
@@ -92,28 +103,66 @@ public:
     Status new_iterator(ColumnIterator** iterator);
     // Client should delete returned iterator
     Status new_bitmap_index_iterator(BitmapIndexIterator** iterator);
+    // Client should delete returned iterator
+    Status new_ngram_index_iterator(NGramIndexIterator** iterator);
+    // Client should delete returned iterator
+    Status new_s2_index_iterator(S2IndexIterator** iterator);
 
     // Seek to the first entry in the column.
     Status seek_to_first(OrdinalPageIndexIterator* iter);
     Status seek_at_or_before(ordinal_t ordinal, OrdinalPageIndexIterator* iter);
 
-    // read a page from file into a page handle
+    // Get the first ordinal of each data page, e.g. to build the page-level bloom filters
+    // of the column.
+    Status get_page_first_ordinals(std::vector<ordinal_t>* ordinals);
+
+    // Get the zone map and the number of rows of each data page, NotSupported if the
+    // column has no zone map.
+    Status get_page_zone_maps(std::vector<ZoneMapPB>* zone_maps,
+                              std::vector<uint32_t>* page_num_rows);
+
+    // Get the number of nulls and the serialized HyperLogLog of the not-null values from
+    // the statistics index, NotSupported if the column has no statistics index.
+    Status get_statistics(uint64_t* null_count, std::string* ndv_sketch);
+
+    // read a page of 'type' (DATA_PAGE or DICTIONARY_PAGE) from file into a page handle
     Status read_page(const ColumnIteratorOptions& iter_opts, const PagePointer& pp,
-                     PageHandle* handle, Slice* page_body, PageFooterPB* footer);
+                     PageTypePB type, PageHandle* handle, Slice* page_body, PageFooterPB* footer);
 
     bool is_nullable() const { return _meta.is_nullable(); }
 
+    const TypeInfo* type_info() const { return _type_info; }
+
     const EncodingInfo* encoding_info() const { return _encoding_info; }
 
+    // Whether decoded data pages of this column are kept in DecodedPageCache, true for
+    // fixed-length columns of in_memory tables if the cache is created.
+    bool use_decoded_page_cache() const { return _use_decoded_page_cache; }
+
+    StoragePageCache::CacheKey page_cache_key(const PagePointer& pp) const {
+        return StoragePageCache::CacheKey(_page_cache_file_id, pp.offset);
+    }
+
     bool has_zone_map() const { return _zone_map_index_meta != nullptr; }
     bool has_bitmap_index() const { return _bitmap_index_meta != nullptr; }
     bool has_bloom_filter_index() const { return _bf_index_meta != nullptr; }
+    bool has_ngram_index() const { return _ngram_index_meta != nullptr; }
+    bool has_s2_index() const { return _s2_index_meta != nullptr; }
+    bool has_statistics() const { return _statistics_index_meta != nullptr; }
 
     // Check if this column could match `cond' using segment zone map.
     // Since segment zone map is stored in metadata, this function is fast without I/O.
     // Return true if segment zone map is absent or `cond' could be satisfied, false otherwise.
     bool match_condition(CondColumn* cond) const;
 
+    // Evaluate the delete condition `del_cond' against the segment zone map, without I/O.
+    // Return DEL_SATISFIED if all rows of this segment are deleted by it.
+    int delete_match_condition(CondColumn* del_cond) const;
+
+    // Parse the min and max values of the segment zone map, without I/O. Both are set to
+    // null if all values are null. Return false if there is no zone map.
+    bool get_segment_min_max(WrapperField* min_value, WrapperField* max_value) const;
+
     // get row ranges with zone map
     // - cond_column is user's query predicate
     // - delete_condition is a delete predicate of one version
@@ -140,6 +189,8 @@ private:
             RETURN_IF_ERROR(_load_ordinal_index(use_page_cache, _opts.kept_in_memory));
             RETURN_IF_ERROR(_load_bitmap_index(use_page_cache, _opts.kept_in_memory));
             RETURN_IF_ERROR(_load_bloom_filter_index(use_page_cache, _opts.kept_in_memory));
+            RETURN_IF_ERROR(_load_ngram_index(use_page_cache, _opts.kept_in_memory));
+            RETURN_IF_ERROR(_load_s2_index(use_page_cache, _opts.kept_in_memory));
             return Status::OK();
         });
     }
@@ -148,6 +199,8 @@ private:
     Status _load_ordinal_index(bool use_page_cache, bool kept_in_memory);
     Status _load_bitmap_index(bool use_page_cache, bool kept_in_memory);
     Status _load_bloom_filter_index(bool use_page_cache, bool kept_in_memory);
+    Status _load_ngram_index(bool use_page_cache, bool kept_in_memory);
+    Status _load_s2_index(bool use_page_cache, bool kept_in_memory);
 
     bool _zone_map_match_condition(const ZoneMapPB& zone_map, WrapperField* min_value_container,
                                    WrapperField* max_value_container, CondColumn* cond) const;
@@ -163,9 +216,15 @@ private:
 
 private:
     ColumnMetaPB _meta;
+    // empty if the column is not in the index file
+    ColumnMetaPB _index_file_meta;
     ColumnReaderOptions _opts;
     uint64_t _num_rows;
     std::string _file_name;
+    // id of _file_name in StoragePageCache, initialized in init()
+    uint64_t _page_cache_file_id = 0;
+    // initialized in init()
+    bool _use_decoded_page_cache = false;
 
     const TypeInfo* _type_info = nullptr; // initialized in init(), may changed by subclasses.
     const EncodingInfo* _encoding_info =
@@ -177,12 +236,20 @@ private:
     const OrdinalIndexPB* _ordinal_index_meta = nullptr;
     const BitmapIndexPB* _bitmap_index_meta = nullptr;
     const BloomFilterIndexPB* _bf_index_meta = nullptr;
+    const NGramIndexPB* _ngram_index_meta = nullptr;
+    // the files of the indexes, which are in the index file if the segment file lacks them
+    std::string _bitmap_index_file_name;
+    std::string _bf_index_file_name;
+    const S2IndexPB* _s2_index_meta = nullptr;
+    const StatisticsIndexPB* _statistics_index_meta = nullptr;
 
     DorisCallOnce<Status> _load_index_once;
     std::unique_ptr<ZoneMapIndexReader> _zone_map_index;
     std::unique_ptr<OrdinalIndexReader> _ordinal_index;
     std::unique_ptr<BitmapIndexReader> _bitmap_index;
     std::unique_ptr<BloomFilterIndexReader> _bloom_filter_index;
+    std::unique_ptr<NGramIndexReader> _ngram_index;
+    std::unique_ptr<S2IndexReader> _s2_index;
 
     std::vector<std::unique_ptr<ColumnReader>> _sub_readers;
 };
@@ -198,6 +265,11 @@ public:
         return Status::OK();
     }
 
+    // Read up to `num_pages` pages which contain rows of `row_bitmap` ahead of
+    // the current page on `pool`. `row_bitmap` must outlive this iterator.
+    // It's a hint, iterators which don't read pages ignore it.
+    virtual void enable_read_ahead(ThreadPool* pool, int num_pages, const Roaring* row_bitmap) {}
+
     // Seek to the first entry in the column.
     virtual Status seek_to_first() = 0;
 
@@ -277,10 +349,33 @@ public:
 
     bool is_nullable() { return _reader->is_nullable(); }
 
+    void enable_read_ahead(ThreadPool* pool, int num_pages, const Roaring* row_bitmap) override;
+
 private:
+    // A data page read on the read ahead pool
+    struct ReadAheadPage {
+        int32_t page_index = -1;
+        // set when the read finished, guarded by _read_ahead_lock
+        bool done = false;
+        Status status;
+        PageHandle handle;
+        Slice body;
+        PageFooterPB footer;
+        // statistics of this read, added to _opts.stats when the page is taken
+        OlapReaderStatistics stats;
+    };
+
     void _seek_to_pos_in_page(ParsedPage* page, ordinal_t offset_in_page);
     Status _load_next_page(bool* eos);
     Status _read_data_page(const OrdinalPageIndexIterator& iter);
+    // Take the page of `iter` if it has been read ahead, set `*found` to false otherwise.
+    Status _take_read_ahead_page(const OrdinalPageIndexIterator& iter, PageHandle* handle,
+                                 Slice* body, PageFooterPB* footer, bool* found);
+    // Read the next pages after `iter` which contain rows to read ahead.
+    void _schedule_read_ahead(const OrdinalPageIndexIterator& iter);
+    // Decode all values of `_page` which is read from `iter`, cache them in
+    // DecodedPageCache and make `_page` read from the decoded page.
+    Status _cache_decoded_page(const OrdinalPageIndexIterator& iter);
 
 private:
     ColumnReader* _reader;
@@ -297,6 +392,11 @@ private:
     // keep dict page handle to avoid released
     PageHandle _dict_page_handle;
 
+    // words of the dictionary, they point into _dict_page_handle
+    std::vector<Slice> _dict_words;
+    // unique among all dictionaries loaded by this process
+    uint64_t _dict_id = 0;
+
     // page iterator used to get next page when current page is finished.
     // This value will be reset when a new seek is issued
     OrdinalPageIndexIterator _page_iter;
@@ -306,6 +406,19 @@ private:
 
     // page indexes those are DEL_PARTIAL_SATISFIED
     std::unordered_set<uint32_t> _delete_partial_satisfied_pages;
+
+    ThreadPool* _read_ahead_pool = nullptr;
+    int _num_read_ahead_pages = 0;
+    const Roaring* _read_ahead_rows = nullptr;
+    // pages read ahead, in the order of page index
+    std::deque<std::shared_ptr<ReadAheadPage>> _read_ahead_pages;
+    // the first page which may be read ahead next
+    int32_t _next_read_ahead_index = 0;
+    std::mutex _read_ahead_lock;
+    std::condition_variable _read_ahead_cv;
+    // number of submitted reads which haven't finished, including the pages
+    // dropped from _read_ahead_pages by a seek
+    int _num_read_ahead_running = 0;
 };
 
 class ArrayFileColumnIterator final : public ColumnIterator {
@@ -19,6 +19,7 @@
 
 #include <cstddef>
 
+#include "common/config.h"
 #include "common/logging.h"
 #include "env/env.h"
 #include "gutil/strings/substitute.h"
@@ -27,10 +28,12 @@
 #include "olap/rowset/segment_v2/bloom_filter.h"
 #include "olap/rowset/segment_v2/bloom_filter_index_writer.h"
 #include "olap/rowset/segment_v2/encoding_info.h"
+#include "olap/rowset/segment_v2/ngram_index_writer.h"
 #include "olap/rowset/segment_v2/options.h"
 #include "olap/rowset/segment_v2/ordinal_page_index.h"
 #include "olap/rowset/segment_v2/page_builder.h"
 #include "olap/rowset/segment_v2/page_io.h"
+#include "olap/rowset/segment_v2/statistics_index.h"
 #include "olap/rowset/segment_v2/zone_map_index.h"
 #include "util/block_compression.h"
 #include "util/faststring.h"
@@ -93,6 +96,7 @@ Status ColumnWriter::create(const ColumnWriterOptions& opts, const TabletColumn*
 
             ColumnWriterOptions item_options;
             item_options.meta = opts.meta->mutable_children_columns(0);
+            item_options.compression_level = opts.compression_level;
             item_options.need_zone_map = false;
             item_options.need_bloom_filter = item_column.is_bf_column();
             item_options.need_bitmap_index = item_column.has_bitmap_index();
@@ -178,26 +182,20 @@ ScalarColumnWriter::~ScalarColumnWriter() {
 }
 
 Status ScalarColumnWriter::init() {
-    RETURN_IF_ERROR(get_block_compression_codec(_opts.meta->compression(), &_compress_codec));
-
-    PageBuilder* page_builder = nullptr;
+    RETURN_IF_ERROR(get_block_compression_codec(_opts.meta->compression(), _opts.compression_level,
+                                                &_compress_codec));
 
+    _is_sampling = _opts.adaptive_encoding && _opts.meta->encoding() == DEFAULT_ENCODING &&
+                   EncodingInfo::get_all(get_field()->type_info()).size() > 1;
     RETURN_IF_ERROR(
             EncodingInfo::get(get_field()->type_info(), _opts.meta->encoding(), &_encoding_info));
     _opts.meta->set_encoding(_encoding_info->encoding());
-    // create page builder
-    PageBuilderOptions opts;
-    opts.data_page_size = _opts.data_page_size;
-    RETURN_IF_ERROR(_encoding_info->create_page_builder(opts, &page_builder));
-    if (page_builder == nullptr) {
-        return Status::NotSupported(
-                strings::Substitute("Failed to create page builder for type $0 and encoding $1",
-                                    get_field()->type(), _opts.meta->encoding()));
-    }
     // should store more concrete encoding type instead of DEFAULT_ENCODING
     // because the default encoding of a data type can be changed in the future
     DCHECK_NE(_opts.meta->encoding(), DEFAULT_ENCODING);
-    _page_builder.reset(page_builder);
+    if (!_is_sampling) {
+        RETURN_IF_ERROR(_create_page_builder(_encoding_info));
+    }
     // create ordinal builder
     _ordinal_index_builder.reset(new OrdinalIndexWriter());
     // create null bitmap builder
@@ -215,10 +213,39 @@ Status ScalarColumnWriter::init() {
         RETURN_IF_ERROR(BloomFilterIndexWriter::create(
                 BloomFilterOptions(), get_field()->type_info(), &_bloom_filter_index_builder));
     }
+    if (_opts.need_ngram_index) {
+        RETURN_IF_ERROR(NGramIndexWriter::create(
+                get_field()->type_info(), config::ngram_index_gram_size, &_ngram_index_builder));
+    }
+    if (_opts.need_statistics) {
+        _statistics_index_builder.reset(new StatisticsIndexWriter(get_field()));
+    }
+    return Status::OK();
+}
+
+Status ScalarColumnWriter::_create_page_builder(const EncodingInfo* encoding_info) {
+    PageBuilder* page_builder = nullptr;
+    PageBuilderOptions opts;
+    opts.data_page_size = _opts.data_page_size;
+    RETURN_IF_ERROR(encoding_info->create_page_builder(opts, &page_builder));
+    if (page_builder == nullptr) {
+        return Status::NotSupported(
+                strings::Substitute("Failed to create page builder for type $0 and encoding $1",
+                                    get_field()->type(), encoding_info->encoding()));
+    }
+    _page_builder.reset(page_builder);
     return Status::OK();
 }
 
 Status ScalarColumnWriter::append_nulls(size_t num_rows) {
+    if (_is_sampling) {
+        if (!_sample_runs.empty() && _sample_runs.back().first) {
+            _sample_runs.back().second += num_rows;
+        } else {
+            _sample_runs.emplace_back(true, num_rows);
+        }
+        return Status::OK();
+    }
     _null_bitmap_builder->add_run(true, num_rows);
     _next_rowid += num_rows;
     if (_opts.need_zone_map) {
@@ -230,6 +257,12 @@ Status ScalarColumnWriter::append_nulls(size_t num_rows) {
     if (_opts.need_bloom_filter) {
         _bloom_filter_index_builder->add_nulls(num_rows);
     }
+    if (_opts.need_ngram_index) {
+        _ngram_index_builder->add_nulls(num_rows);
+    }
+    if (_opts.need_statistics) {
+        _statistics_index_builder->add_nulls(num_rows);
+    }
     return Status::OK();
 }
 
@@ -237,6 +270,14 @@ Status ScalarColumnWriter::append_nulls(size_t num_rows) {
 // num_rows must be written before return. And ptr will be modified
 // to next data should be written
 Status ScalarColumnWriter::append_data(const uint8_t** ptr, size_t num_rows) {
+    if (_is_sampling) {
+        RETURN_IF_ERROR(_add_sample_values(*ptr, num_rows));
+        *ptr += get_field()->size() * num_rows;
+        if (_sample_data.size() >= _opts.data_page_size) {
+            RETURN_IF_ERROR(_choose_encoding());
+        }
+        return Status::OK();
+    }
     size_t remaining = num_rows;
     while (remaining > 0) {
         size_t num_written = remaining;
@@ -250,8 +291,16 @@ Status ScalarColumnWriter::append_data(const uint8_t** ptr, size_t num_rows) {
         if (_opts.need_bloom_filter) {
             _bloom_filter_index_builder->add_values(*ptr, num_written);
         }
+        if (_opts.need_ngram_index) {
+            _ngram_index_builder->add_values(*ptr, num_written);
+        }
+        if (_opts.need_statistics) {
+            _statistics_index_builder->add_values(*ptr, num_written);
+        }
 
-        bool is_page_full = (num_written < remaining);
+        // some page builders, e.g. frame of reference, accept all values and only
+        // report the page is full
+        bool is_page_full = (num_written < remaining) || _page_builder->is_page_full();
         remaining -= num_written;
         _next_rowid += num_written;
         *ptr += get_field()->size() * num_written;
@@ -268,7 +317,137 @@ Status ScalarColumnWriter::append_data(const uint8_t** ptr, size_t num_rows) {
     return Status::OK();
 }
 
+Status ScalarColumnWriter::_add_sample_values(const uint8_t* ptr, size_t num_rows) {
+    if (!_sample_runs.empty() && !_sample_runs.back().first) {
+        _sample_runs.back().second += num_rows;
+    } else {
+        _sample_runs.emplace_back(false, num_rows);
+    }
+    FieldType type = get_field()->type();
+    if (type == OLAP_FIELD_TYPE_CHAR || type == OLAP_FIELD_TYPE_VARCHAR) {
+        // the data of Slices may not live until the sample is used
+        const Slice* slices = reinterpret_cast<const Slice*>(ptr);
+        for (size_t i = 0; i < num_rows; ++i) {
+            _sample_data.append(slices[i].data, slices[i].size);
+            _sample_value_sizes.push_back(slices[i].size);
+        }
+    } else {
+        _sample_data.append(ptr, get_field()->size() * num_rows);
+    }
+    _num_sample_values += num_rows;
+    return Status::OK();
+}
+
+// Relative cost to decode a value, an encoding which decodes slower must save more
+// space to be chosen.
+static double decode_cost(EncodingTypePB encoding) {
+    switch (encoding) {
+    case PLAIN_ENCODING:
+        return 1.0;
+    case BIT_SHUFFLE:
+    case DICT_ENCODING:
+        return 1.1;
+    case RLE:
+        return 1.2;
+    case FOR_ENCODING:
+        return 1.3;
+    case PREFIX_ENCODING:
+        return 1.5;
+    default:
+        return 2.0;
+    }
+}
+
+Status ScalarColumnWriter::_encoded_size(const EncodingInfo* encoding_info,
+                                         const uint8_t* values, size_t num_values,
+                                         uint64_t* size) {
+    PageBuilder* builder = nullptr;
+    PageBuilderOptions opts;
+    opts.data_page_size = _opts.data_page_size;
+    RETURN_IF_ERROR(encoding_info->create_page_builder(opts, &builder));
+    if (builder == nullptr) {
+        return Status::NotSupported("page builder is not supported");
+    }
+    std::unique_ptr<PageBuilder> page_builder(builder);
+    *size = 0;
+    size_t remaining = num_values;
+    while (remaining > 0) {
+        size_t num_written = remaining;
+        RETURN_IF_ERROR(page_builder->add(values, &num_written));
+        values += get_field()->size() * num_written;
+        remaining -= num_written;
+        if (remaining > 0 || page_builder->is_page_full()) {
+            *size += page_builder->finish().slice().size;
+            page_builder->reset();
+        }
+    }
+    if (page_builder->count() > 0) {
+        *size += page_builder->finish().slice().size;
+    }
+    if (encoding_info->encoding() == DICT_ENCODING) {
+        OwnedSlice dict_body;
+        RETURN_IF_ERROR(page_builder->get_dictionary_page(&dict_body));
+        *size += dict_body.slice().size;
+    }
+    return Status::OK();
+}
+
+Status ScalarColumnWriter::_choose_encoding() {
+    _is_sampling = false;
+    const uint8_t* values = _sample_data.data();
+    std::vector<Slice> slices;
+    if (!_sample_value_sizes.empty()) {
+        slices.reserve(_sample_value_sizes.size());
+        size_t offset = 0;
+        for (auto size : _sample_value_sizes) {
+            slices.emplace_back(_sample_data.data() + offset, size);
+            offset += size;
+        }
+        values = reinterpret_cast<const uint8_t*>(slices.data());
+    }
+
+    if (_num_sample_values > 0) {
+        double min_cost = 0;
+        for (auto encoding_info : EncodingInfo::get_all(get_field()->type_info())) {
+            uint64_t size = 0;
+            if (!_encoded_size(encoding_info, values, _num_sample_values, &size).ok()) {
+                continue;
+            }
+            double cost = size * decode_cost(encoding_info->encoding());
+            if (encoding_info == _encoding_info) {
+                // prefer the default encoding when costs are equal
+                cost *= 0.99;
+            }
+            if (min_cost == 0 || cost < min_cost) {
+                min_cost = cost;
+                _encoding_info = encoding_info;
+            }
+        }
+        _opts.meta->set_encoding(_encoding_info->encoding());
+    }
+    RETURN_IF_ERROR(_create_page_builder(_encoding_info));
+
+    // append the sample again
+    for (auto& run : _sample_runs) {
+        if (run.first) {
+            RETURN_IF_ERROR(append_nulls(run.second));
+        } else {
+            RETURN_IF_ERROR(append_data(&values, run.second));
+        }
+    }
+    _sample_runs.clear();
+    _sample_data.clear();
+    _sample_data.shrink_to_fit();
+    _sample_value_sizes.clear();
+    _sample_value_sizes.shrink_to_fit();
+    _num_sample_values = 0;
+    return Status::OK();
+}
+
 uint64_t ScalarColumnWriter::estimate_buffer_size() {
+    if (_is_sampling) {
+        return _sample_data.size() + _sample_value_sizes.size() * sizeof(uint32_t);
+    }
     uint64_t size = _data_size;
     size += _page_builder->size();
     if (is_nullable()) {
@@ -284,10 +463,19 @@ uint64_t ScalarColumnWriter::estimate_buffer_size() {
     if (_opts.need_bloom_filter) {
         size += _bloom_filter_index_builder->size();
     }
+    if (_opts.need_ngram_index) {
+        size += _ngram_index_builder->size();
+    }
+    if (_opts.need_statistics) {
+        size += _statistics_index_builder->size();
+    }
     return size;
 }
 
 Status ScalarColumnWriter::finish() {
+    if (_is_sampling) {
+        RETURN_IF_ERROR(_choose_encoding());
+    }
     RETURN_IF_ERROR(finish_current_page());
     _opts.meta->set_num_rows(_next_rowid);
     return Status::OK();
@@ -343,6 +531,20 @@ Status ScalarColumnWriter::write_bloom_filter_index() {
     return Status::OK();
 }
 
+Status ScalarColumnWriter::write_ngram_index() {
+    if (_opts.need_ngram_index) {
+        return _ngram_index_builder->finish(_wblock, _opts.meta->add_indexes());
+    }
+    return Status::OK();
+}
+
+Status ScalarColumnWriter::write_statistics_index() {
+    if (_opts.need_statistics) {
+        return _statistics_index_builder->finish(_wblock, _opts.meta->add_indexes());
+    }
+    return Status::OK();
+}
+
 // write a data page into file and update ordinal index
 Status ScalarColumnWriter::_write_data_page(Page* page) {
     PagePointer pp;
@@ -356,6 +558,9 @@ Status ScalarColumnWriter::_write_data_page(Page* page) {
 }
 
 Status ScalarColumnWriter::finish_current_page() {
+    if (_is_sampling) {
+        RETURN_IF_ERROR(_choose_encoding());
+    }
     if (_next_rowid == _first_rowid) {
         return Status::OK();
     }
@@ -18,6 +18,8 @@
 #pragma once
 
 #include <memory> // for unique_ptr
+#include <utility>
+#include <vector>
 
 #include "common/status.h"         // for Status
 #include "gen_cpp/segment_v2.pb.h" // for EncodingTypePB
@@ -25,6 +27,7 @@
 #include "olap/rowset/segment_v2/page_pointer.h" // for PagePointer
 #include "olap/tablet_schema.h"                  // for TabletColumn
 #include "util/bitmap.h"                         // for BitmapChange
+#include "util/faststring.h"
 #include "util/slice.h"                          // for OwnedSlice
 
 namespace doris {
@@ -47,9 +50,17 @@ struct ColumnWriterOptions {
     // store compressed page only when space saving is above the threshold.
     // space saving = 1 - compressed_size / uncompressed_size
     double compression_min_space_saving = 0.1;
+    // only used by ZSTD, 0 means the default level
+    int compression_level = 0;
     bool need_zone_map = false;
     bool need_bitmap_index = false;
     bool need_bloom_filter = false;
+    bool need_ngram_index = false;
+    // see StatisticsIndexWriter
+    bool need_statistics = false;
+    // If true and meta's encoding is DEFAULT_ENCODING, choose the encoding by the first
+    // data_page_size bytes of values, see ScalarColumnWriter::_choose_encoding().
+    bool adaptive_encoding = false;
 };
 
 class BitmapIndexWriter;
@@ -58,6 +69,8 @@ class NullBitmapBuilder;
 class OrdinalIndexWriter;
 class PageBuilder;
 class BloomFilterIndexWriter;
+class NGramIndexWriter;
+class StatisticsIndexWriter;
 class ZoneMapIndexWriter;
 
 class ColumnWriter {
@@ -115,6 +128,10 @@ public:
 
     virtual Status write_bloom_filter_index() = 0;
 
+    virtual Status write_ngram_index() = 0;
+
+    virtual Status write_statistics_index() = 0;
+
     virtual ordinal_t get_next_rowid() const = 0;
 
     // used for append not null data.
@@ -161,6 +178,8 @@ public:
     Status write_zone_map() override;
     Status write_bitmap_index() override;
     Status write_bloom_filter_index() override;
+    Status write_ngram_index() override;
+    Status write_statistics_index() override;
     ordinal_t get_next_rowid() const override { return _next_rowid; }
 
     void register_flush_page_callback(FlushPageCallback* flush_page_callback) {
@@ -214,6 +233,14 @@ private:
 
     Status _write_data_page(Page* page);
 
+    Status _create_page_builder(const EncodingInfo* encoding_info);
+    Status _add_sample_values(const uint8_t* ptr, size_t num_rows);
+    // Choose the encoding by the sample, then append the sample to the page builder.
+    Status _choose_encoding();
+    // Sum of the page sizes when 'values' are encoded by 'encoding_info'
+    Status _encoded_size(const EncodingInfo* encoding_info, const uint8_t* values,
+                         size_t num_values, uint64_t* size);
+
 private:
     fs::WritableBlock* _wblock = nullptr;
     // total size of data page list
@@ -229,9 +256,20 @@ private:
     std::unique_ptr<ZoneMapIndexWriter> _zone_map_index_builder;
     std::unique_ptr<BitmapIndexWriter> _bitmap_index_builder;
     std::unique_ptr<BloomFilterIndexWriter> _bloom_filter_index_builder;
+    std::unique_ptr<NGramIndexWriter> _ngram_index_builder;
+    std::unique_ptr<StatisticsIndexWriter> _statistics_index_builder;
 
     // call before flush data page.
     FlushPageCallback* _new_page_callback = nullptr;
+
+    // Rows appended before the encoding is chosen. _sample_runs are the runs of null
+    // (true) and not null rows in appending order. _sample_data holds the values, or the
+    // content of Slices whose sizes are in _sample_value_sizes.
+    bool _is_sampling = false;
+    std::vector<std::pair<bool, size_t>> _sample_runs;
+    faststring _sample_data;
+    std::vector<uint32_t> _sample_value_sizes;
+    size_t _num_sample_values = 0;
 };
 
 class ArrayColumnWriter final : public ColumnWriter, public FlushPageCallback {
@@ -260,6 +298,10 @@ public:
 
     Status write_bloom_filter_index() override { return Status::OK(); }
 
+    Status write_ngram_index() override { return Status::OK(); }
+
+    Status write_statistics_index() override { return Status::OK(); }
+
     ordinal_t get_next_rowid() const override { return _offset_writer->get_next_rowid(); }
 
 private:
@@ -0,0 +1,85 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/rowset/segment_v2/decoded_page_cache.h"
+
+#include "runtime/mem_tracker.h"
+
+namespace doris {
+namespace segment_v2 {
+
+DecodedPage::~DecodedPage() {
+    if (_mem_tracker != nullptr) {
+        _mem_tracker->Release(mem_usage());
+    }
+}
+
+DecodedPageCache* DecodedPageCache::_s_instance = nullptr;
+
+void DecodedPageCache::create_global_cache(size_t capacity) {
+    DCHECK(_s_instance == nullptr);
+    static DecodedPageCache instance(capacity);
+    _s_instance = &instance;
+}
+
+DecodedPageCache::DecodedPageCache(size_t capacity)
+        : _mem_tracker(MemTracker::CreateTracker(capacity, "DecodedPageCache")) {
+    _cache.reset(new_lru_cache("DecodedPageCache", capacity));
+}
+
+bool DecodedPageCache::is_supported_type(FieldType type) {
+    // values of these types refer to other memory or are not scalar
+    switch (type) {
+    case OLAP_FIELD_TYPE_CHAR:
+    case OLAP_FIELD_TYPE_VARCHAR:
+    case OLAP_FIELD_TYPE_HLL:
+    case OLAP_FIELD_TYPE_OBJECT:
+    case OLAP_FIELD_TYPE_ARRAY:
+        return false;
+    default:
+        return is_scalar_type(type);
+    }
+}
+
+bool DecodedPageCache::lookup(const StoragePageCache::CacheKey& key,
+                              std::shared_ptr<const DecodedPage>* page) {
+    auto handle = _cache->lookup(key.encode());
+    if (handle == nullptr) {
+        return false;
+    }
+    *page = *reinterpret_cast<std::shared_ptr<const DecodedPage>*>(_cache->value(handle));
+    _cache->release(handle);
+    return true;
+}
+
+void DecodedPageCache::insert(const StoragePageCache::CacheKey& key,
+                              const std::shared_ptr<DecodedPage>& page) {
+    // the page may be used by readers after it's evicted, so its memory is
+    // released when the page is destroyed
+    size_t charge = page->mem_usage();
+    page->_mem_tracker = _mem_tracker;
+    _mem_tracker->Consume(charge);
+    auto deleter = [](const doris::CacheKey& key, void* value) {
+        delete reinterpret_cast<std::shared_ptr<const DecodedPage>*>(value);
+    };
+    auto handle = _cache->insert(key.encode(), new std::shared_ptr<const DecodedPage>(page),
+                                 charge, deleter);
+    _cache->release(handle);
+}
+
+} // namespace segment_v2
+} // namespace doris
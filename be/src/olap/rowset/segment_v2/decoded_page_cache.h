@@ -0,0 +1,139 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <string>
+
+#include "gutil/macros.h" // for DISALLOW_COPY_AND_ASSIGN
+#include "olap/column_vector.h"
+#include "olap/lru_cache.h"
+#include "olap/page_cache.h"
+#include "olap/rowset/segment_v2/common.h"
+#include "olap/rowset/segment_v2/page_decoder.h"
+
+namespace doris {
+
+class MemTracker;
+
+namespace segment_v2 {
+
+// A data page of a fixed-length column whose values have been decoded.
+struct DecodedPage {
+    ~DecodedPage();
+
+    // ordinal of the first value in this page
+    ordinal_t first_ordinal = 0;
+    // number of rows including nulls and not-nulls
+    ordinal_t num_rows = 0;
+    // null bitmap of the page, RLE encoded as in the page, empty if no null
+    std::string null_bitmap;
+    // decoded not-null values, there are values->capacity() of them
+    std::unique_ptr<ColumnVectorBatch> values;
+
+    size_t mem_usage() const {
+        return sizeof(*this) + null_bitmap.size() +
+               values->capacity() * values->type_info()->size();
+    }
+
+private:
+    friend class DecodedPageCache;
+    // tracker which consumes mem_usage(), set when the page is cached
+    std::shared_ptr<MemTracker> _mem_tracker;
+};
+
+// Cache of decoded data pages of in_memory tables.
+//
+// StoragePageCache caches the page bytes read from files, every read of a cached
+// page still decodes it (bitshuffle, RLE, ...). Decoded pages cost more memory
+// than encoded ones, so they are only cached for columns of in_memory tables,
+// whose pages are read over and over, and reading them is a memcpy of the values.
+//
+// Pages are keyed like in StoragePageCache. Memory of cached pages is consumed
+// from the tracker "DecodedPageCache", hit and usage counts are reported by the
+// metric entity "lru_cache:DecodedPageCache".
+class DecodedPageCache {
+public:
+    // Create global instance of this class.
+    static void create_global_cache(size_t capacity);
+
+    // Return global instance, nullptr if the cache is not created.
+    static DecodedPageCache* instance() { return _s_instance; }
+
+    explicit DecodedPageCache(size_t capacity);
+
+    // Only columns of these types are cached.
+    static bool is_supported_type(FieldType type);
+
+    // Return true and set 'page' if the page is cached.
+    bool lookup(const StoragePageCache::CacheKey& key, std::shared_ptr<const DecodedPage>* page);
+
+    void insert(const StoragePageCache::CacheKey& key, const std::shared_ptr<DecodedPage>& page);
+
+private:
+    static DecodedPageCache* _s_instance;
+
+    std::unique_ptr<Cache> _cache;
+    std::shared_ptr<MemTracker> _mem_tracker;
+
+    DISALLOW_COPY_AND_ASSIGN(DecodedPageCache);
+};
+
+// Decoder of the values of a DecodedPage, reading them is a memcpy.
+class DecodedPageDecoder : public PageDecoder {
+public:
+    explicit DecodedPageDecoder(const ColumnVectorBatch* values)
+            : _values(values), _value_size(values->type_info()->size()) {}
+
+    Status init() override { return Status::OK(); }
+
+    Status seek_to_position_in_page(size_t pos) override {
+        DCHECK_LE(pos, count());
+        _cur_index = pos;
+        return Status::OK();
+    }
+
+    Status next_batch(size_t* n, ColumnBlockView* dst) override {
+        RETURN_IF_ERROR(peek_next_batch(n, dst));
+        _cur_index += *n;
+        return Status::OK();
+    }
+
+    Status peek_next_batch(size_t* n, ColumnBlockView* dst) override {
+        *n = std::min(*n, count() - _cur_index);
+        if (*n == 0) {
+            return Status::OK();
+        }
+        memcpy(dst->data(), _values->cell_ptr(_cur_index), *n * _value_size);
+        return Status::OK();
+    }
+
+    size_t count() const override { return _values->capacity(); }
+
+    size_t current_index() const override { return _cur_index; }
+
+private:
+    const ColumnVectorBatch* _values;
+    const size_t _value_size;
+    size_t _cur_index = 0;
+};
+
+} // namespace segment_v2
+} // namespace doris
@@ -17,6 +17,7 @@
 
 #include "olap/rowset/segment_v2/encoding_info.h"
 
+#include <algorithm>
 #include <type_traits>
 
 #include "gutil/strings/substitute.h"
@@ -185,6 +186,20 @@ public:
 
     Status get(FieldType data_type, EncodingTypePB encoding_type, const EncodingInfo** out);
 
+    std::vector<const EncodingInfo*> get_all(FieldType data_type) const {
+        std::vector<const EncodingInfo*> encodings;
+        for (auto& it : _encoding_map) {
+            if (it.first.first == data_type) {
+                encodings.push_back(it.second);
+            }
+        }
+        std::sort(encodings.begin(), encodings.end(),
+                  [](const EncodingInfo* a, const EncodingInfo* b) {
+                      return a->encoding() < b->encoding();
+                  });
+        return encodings;
+    }
+
 private:
     // Not thread-safe
     template <FieldType type, EncodingTypePB encoding_type, bool optimize_value_seek = false>
@@ -318,5 +333,9 @@ EncodingTypePB EncodingInfo::get_default_encoding(const TypeInfo* type_info,
     return s_encoding_info_resolver.get_default_encoding(type_info->type(), optimize_value_seek);
 }
 
+std::vector<const EncodingInfo*> EncodingInfo::get_all(const TypeInfo* type_info) {
+    return s_encoding_info_resolver.get_all(type_info->type());
+}
+
 } // namespace segment_v2
 } // namespace doris
@@ -18,6 +18,7 @@
 #pragma once
 
 #include <functional>
+#include <vector>
 
 #include "common/status.h"
 #include "gen_cpp/segment_v2.pb.h"
@@ -44,6 +45,9 @@ public:
     // and support fast value seek operation
     static EncodingTypePB get_default_encoding(const TypeInfo* type_info, bool optimize_value_seek);
 
+    // Get all encodings supported by TypeInfo, ordered by EncodingTypePB
+    static std::vector<const EncodingInfo*> get_all(const TypeInfo* type_info);
+
     Status create_page_builder(const PageBuilderOptions& opts, PageBuilder** builder) const {
         return _create_builder_func(opts, builder);
     }
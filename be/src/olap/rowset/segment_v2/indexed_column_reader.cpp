@@ -19,6 +19,7 @@
 
 #include "gutil/strings/substitute.h" // for Substitute
 #include "olap/key_coder.h"
+#include "olap/page_cache.h"
 #include "olap/rowset/segment_v2/encoding_info.h" // for EncodingInfo
 #include "olap/rowset/segment_v2/page_io.h"
 
@@ -30,6 +31,9 @@ using strings::Substitute;
 Status IndexedColumnReader::load(bool use_page_cache, bool kept_in_memory) {
     _use_page_cache = use_page_cache;
     _kept_in_memory = kept_in_memory;
+    if (_use_page_cache) {
+        _page_cache_file_id = StoragePageCache::instance()->file_id(_file_name);
+    }
 
     _type_info = get_type_info((FieldType)_meta.data_type());
     if (_type_info == nullptr) {
@@ -82,6 +86,8 @@ Status IndexedColumnReader::read_page(fs::ReadableBlock* rblock, const PagePoint
     PageReadOptions opts;
     opts.rblock = rblock;
     opts.page_pointer = pp;
+    opts.file_id = _page_cache_file_id;
+    opts.type = INDEX_PAGE;
     opts.codec = _compress_codec;
     OlapReaderStatistics tmp_stats;
     opts.stats = &tmp_stats;
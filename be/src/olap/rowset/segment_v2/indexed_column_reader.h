@@ -70,6 +70,8 @@ private:
 
     bool _use_page_cache;
     bool _kept_in_memory;
+    // id of _file_name in StoragePageCache, valid only when _use_page_cache
+    uint64_t _page_cache_file_id = 0;
     int64_t _num_values = 0;
     // whether this column contains any index page.
     // could be false when the column contains only one data page.
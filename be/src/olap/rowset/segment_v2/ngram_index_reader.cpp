@@ -0,0 +1,56 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/rowset/segment_v2/ngram_index_reader.h"
+
+namespace doris {
+namespace segment_v2 {
+
+Status NGramIndexReader::new_iterator(NGramIndexIterator** iterator) {
+    *iterator = new NGramIndexIterator(this);
+    return Status::OK();
+}
+
+NGramIndexIterator::NGramIndexIterator(NGramIndexReader* reader)
+        : _reader(reader), _postings_iter(new BitmapIndexIterator(&reader->_postings)) {}
+
+Status NGramIndexIterator::filter_rows_containing(const Slice& literal, Roaring* rows) {
+    size_t gram_size = _reader->gram_size();
+    if (literal.size >= gram_size && _postings_iter->bitmap_nums() == 0) {
+        // no value has a gram
+        *rows = Roaring();
+        return Status::OK();
+    }
+    for (size_t pos = 0; pos + gram_size <= literal.size && !rows->isEmpty(); ++pos) {
+        Slice gram(literal.data + pos, gram_size);
+        bool exact_match = false;
+        Status st = _postings_iter->seek_dictionary(&gram, &exact_match);
+        if (st.is_not_found() || (st.ok() && !exact_match)) {
+            // no row contains the gram
+            *rows = Roaring();
+            return Status::OK();
+        }
+        RETURN_IF_ERROR(st);
+        Roaring gram_rows;
+        RETURN_IF_ERROR(_postings_iter->read_bitmap(_postings_iter->current_ordinal(), &gram_rows));
+        *rows &= gram_rows;
+    }
+    return Status::OK();
+}
+
+} // namespace segment_v2
+} // namespace doris
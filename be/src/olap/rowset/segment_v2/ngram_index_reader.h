@@ -0,0 +1,75 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include <roaring/roaring.hh>
+
+#include "common/status.h"
+#include "gen_cpp/segment_v2.pb.h"
+#include "olap/rowset/segment_v2/bitmap_index_reader.h"
+#include "util/slice.h"
+
+namespace doris {
+namespace segment_v2 {
+
+class NGramIndexIterator;
+
+// Reader of the n-gram index written by NGramIndexWriter.
+class NGramIndexReader {
+public:
+    NGramIndexReader(const std::string& file_name, const NGramIndexPB* ngram_index_meta)
+            : _ngram_index_meta(ngram_index_meta),
+              _postings(file_name, &ngram_index_meta->postings()) {}
+
+    Status load(bool use_page_cache, bool kept_in_memory) {
+        return _postings.load(use_page_cache, kept_in_memory);
+    }
+
+    // create a new iterator. Client should delete returned iterator
+    Status new_iterator(NGramIndexIterator** iterator);
+
+    size_t gram_size() const { return _ngram_index_meta->gram_size(); }
+
+private:
+    friend class NGramIndexIterator;
+
+    const NGramIndexPB* _ngram_index_meta;
+    BitmapIndexReader _postings;
+};
+
+class NGramIndexIterator {
+public:
+    explicit NGramIndexIterator(NGramIndexReader* reader);
+
+    size_t gram_size() const { return _reader->gram_size(); }
+
+    // Remove from 'rows' the rows not containing all the grams of 'literal', the rows
+    // left are a superset of the rows containing 'literal'. Nothing is removed if
+    // 'literal' is shorter than a gram.
+    Status filter_rows_containing(const Slice& literal, Roaring* rows);
+
+private:
+    NGramIndexReader* _reader;
+    std::unique_ptr<BitmapIndexIterator> _postings_iter;
+};
+
+} // namespace segment_v2
+} // namespace doris
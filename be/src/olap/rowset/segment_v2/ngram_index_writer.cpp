@@ -0,0 +1,133 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/rowset/segment_v2/ngram_index_writer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "olap/rowset/segment_v2/encoding_info.h"
+#include "olap/rowset/segment_v2/indexed_column_writer.h"
+#include "olap/types.h"
+#include "util/faststring.h"
+
+namespace doris {
+namespace segment_v2 {
+
+Status NGramIndexWriter::create(const TypeInfo* typeinfo, size_t gram_size,
+                                std::unique_ptr<NGramIndexWriter>* res) {
+    FieldType type = typeinfo->type();
+    if (type != OLAP_FIELD_TYPE_CHAR && type != OLAP_FIELD_TYPE_VARCHAR) {
+        return Status::NotSupported("unsupported type for ngram index: " + std::to_string(type));
+    }
+    if (gram_size == 0) {
+        return Status::InvalidArgument("gram size of ngram index must be positive");
+    }
+    res->reset(new NGramIndexWriter(gram_size));
+    return Status::OK();
+}
+
+void NGramIndexWriter::add_values(const void* values, size_t count) {
+    auto p = reinterpret_cast<const Slice*>(values);
+    for (size_t i = 0; i < count; ++i) {
+        _add_value(p[i]);
+        _rid++;
+    }
+}
+
+void NGramIndexWriter::_add_value(const Slice& value) {
+    // values of CHAR are padded with '\0', which is not part of the value read by queries
+    size_t len = strnlen(value.data, value.size);
+    for (size_t pos = 0; pos + _gram_size <= len; ++pos) {
+        Roaring& rows = _postings[std::string(value.data + pos, _gram_size)];
+        // a gram repeated in a value is added once
+        if (rows.isEmpty() || rows.maximum() != _rid) {
+            rows.add(_rid);
+            _num_entries++;
+        }
+    }
+}
+
+Status NGramIndexWriter::finish(fs::WritableBlock* wblock, ColumnIndexMetaPB* index_meta) {
+    index_meta->set_type(NGRAM_INDEX);
+    NGramIndexPB* ngram_meta = index_meta->mutable_ngram_index();
+    ngram_meta->set_gram_size(_gram_size);
+    BitmapIndexPB* meta = ngram_meta->mutable_postings();
+    meta->set_bitmap_type(BitmapIndexPB::ROARING_BITMAP);
+    meta->set_has_null(false);
+
+    // the dictionary is ordered
+    std::vector<std::pair<const std::string, Roaring>*> postings;
+    postings.reserve(_postings.size());
+    for (auto& it : _postings) {
+        postings.push_back(&it);
+    }
+    std::sort(postings.begin(), postings.end(),
+              [](const std::pair<const std::string, Roaring>* a,
+                 const std::pair<const std::string, Roaring>* b) { return a->first < b->first; });
+
+    { // write dictionary
+        const TypeInfo* dict_typeinfo = get_type_info(OLAP_FIELD_TYPE_VARCHAR);
+        IndexedColumnWriterOptions options;
+        options.write_ordinal_index = false;
+        options.write_value_index = true;
+        options.encoding = EncodingInfo::get_default_encoding(dict_typeinfo, true);
+        options.compression = LZ4F;
+
+        IndexedColumnWriter dict_column_writer(options, dict_typeinfo, wblock);
+        RETURN_IF_ERROR(dict_column_writer.init());
+        for (auto posting : postings) {
+            Slice gram(posting->first);
+            RETURN_IF_ERROR(dict_column_writer.add(&gram));
+        }
+        RETURN_IF_ERROR(dict_column_writer.finish(meta->mutable_dict_column()));
+    }
+    { // write bitmaps
+        const TypeInfo* bitmap_typeinfo = get_type_info(OLAP_FIELD_TYPE_OBJECT);
+        IndexedColumnWriterOptions options;
+        options.write_ordinal_index = true;
+        options.write_value_index = false;
+        options.encoding = EncodingInfo::get_default_encoding(bitmap_typeinfo, false);
+        // we already store compressed bitmap, use NO_COMPRESSION to save some cpu
+        options.compression = NO_COMPRESSION;
+
+        IndexedColumnWriter bitmap_column_writer(options, bitmap_typeinfo, wblock);
+        RETURN_IF_ERROR(bitmap_column_writer.init());
+
+        faststring buf;
+        for (auto posting : postings) {
+            Roaring& bitmap = posting->second;
+            bitmap.runOptimize();
+            buf.resize(bitmap.getSizeInBytes(false));
+            bitmap.write(reinterpret_cast<char*>(buf.data()), false);
+            Slice buf_slice(buf);
+            RETURN_IF_ERROR(bitmap_column_writer.add(&buf_slice));
+        }
+        RETURN_IF_ERROR(bitmap_column_writer.finish(meta->mutable_bitmap_column()));
+    }
+    return Status::OK();
+}
+
+uint64_t NGramIndexWriter::size() const {
+    // the roaring bitmaps take about 2 bytes per row for dense grams and 4 for sparse ones
+    return _postings.size() * (_gram_size + sizeof(std::string) + sizeof(Roaring)) +
+           _num_entries * sizeof(rowid_t);
+}
+
+} // namespace segment_v2
+} // namespace doris
@@ -0,0 +1,84 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include <roaring/roaring.hh>
+
+#include "common/status.h"
+#include "gen_cpp/segment_v2.pb.h"
+#include "gutil/macros.h"
+#include "olap/rowset/segment_v2/common.h"
+#include "util/slice.h"
+
+namespace doris {
+
+class TypeInfo;
+
+namespace fs {
+class WritableBlock;
+}
+
+namespace segment_v2 {
+
+// Builder for n-gram index of a string column, which serves LIKE patterns with a literal
+// part of at least 'gram_size' bytes.
+//
+// Every substring of 'gram_size' bytes of a value is a gram, and the index maps each
+// distinct gram to the bitmap of the rows containing it. It's stored in the layout of
+// bitmap index, grams as the dictionary and bitmaps as the posting list, so that it's
+// read by BitmapIndexReader. Rows containing all the grams of a literal are a superset
+// of the rows containing the literal.
+//
+// E.g, with gram_size 3, the value "abcd" contains grams "abc" and "bcd", and a row
+// containing "bcd" may contain "%bcd%", a row not containing it can't.
+class NGramIndexWriter {
+public:
+    static Status create(const TypeInfo* typeinfo, size_t gram_size,
+                         std::unique_ptr<NGramIndexWriter>* res);
+
+    explicit NGramIndexWriter(size_t gram_size) : _gram_size(gram_size) {}
+
+    // values are Slices
+    void add_values(const void* values, size_t count);
+
+    void add_nulls(uint32_t count) { _rid += count; }
+
+    Status finish(fs::WritableBlock* wblock, ColumnIndexMetaPB* index_meta);
+
+    uint64_t size() const;
+
+private:
+    void _add_value(const Slice& value);
+
+    const size_t _gram_size;
+    rowid_t _rid = 0;
+    // gram to the rows containing it
+    std::unordered_map<std::string, Roaring> _postings;
+    // number of (gram, row) pairs added, to estimate the memory of _postings
+    uint64_t _num_entries = 0;
+
+    DISALLOW_COPY_AND_ASSIGN(NGramIndexWriter);
+};
+
+} // namespace segment_v2
+} // namespace doris
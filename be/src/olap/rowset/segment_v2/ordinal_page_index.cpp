@@ -75,6 +75,7 @@ Status OrdinalIndexReader::load(bool use_page_cache, bool kept_in_memory) {
     PageReadOptions opts;
     opts.rblock = rblock.get();
     opts.page_pointer = PagePointer(_index_meta->root_page().root_page());
+    opts.type = INDEX_PAGE;
     opts.codec = nullptr; // ordinal index page uses NO_COMPRESSION right now
     OlapReaderStatistics tmp_stats;
     opts.stats = &tmp_stats;
@@ -109,6 +109,11 @@ public:
         _cur_idx++;
     }
     int32_t page_index() const { return _cur_idx; };
+    // move to the page at `page_index`, which may be the end
+    void seek_to_page(int32_t page_index) {
+        DCHECK_LE(page_index, _index->_num_pages);
+        _cur_idx = page_index;
+    }
     const PagePointer& page() const { return _index->_pages[_cur_idx]; };
     ordinal_t first_ordinal() const { return _index->get_first_ordinal(_cur_idx); }
     ordinal_t last_ordinal() const { return _index->get_last_ordinal(_cur_idx); }
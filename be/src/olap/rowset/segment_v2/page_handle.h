@@ -19,6 +19,8 @@
 
 #include "gutil/macros.h" // for DISALLOW_COPY_AND_ASSIGN
 #include "olap/page_cache.h"
+#include "runtime/memory/chunk.h"
+#include "runtime/memory/chunk_allocator.h"
 #include "util/slice.h" // for Slice
 
 namespace doris {
@@ -37,6 +39,11 @@ public:
     // free it when deconstructs.
     PageHandle(const Slice& data) : _is_data_owner(true), _data(data) {}
 
+    // This class will take the ownership of 'chunk' of ChunkAllocator which holds 'data', and
+    // free it to ChunkAllocator when deconstructs.
+    PageHandle(const Chunk& chunk, const Slice& data)
+            : _is_data_owner(true), _data(data), _chunk(chunk) {}
+
     // This class will take the content of cache data, and will make input
     // cache_data to a invalid cache handle.
     PageHandle(PageCacheHandle cache_data)
@@ -46,21 +53,28 @@ public:
     PageHandle(PageHandle&& other) noexcept
             : _is_data_owner(false),
               _data(std::move(other._data)),
+              _chunk(other._chunk),
               _cache_data(std::move(other._cache_data)) {
         // we can use std::exchange if we switch c++14 on
         std::swap(_is_data_owner, other._is_data_owner);
     }
 
     PageHandle& operator=(PageHandle&& other) noexcept {
+        // the data owned by this before is freed by 'other'
         std::swap(_is_data_owner, other._is_data_owner);
-        _data = std::move(other._data);
+        std::swap(_data, other._data);
+        std::swap(_chunk, other._chunk);
         _cache_data = std::move(other._cache_data);
         return *this;
     }
 
     ~PageHandle() {
         if (_is_data_owner) {
-            delete[] _data.data;
+            if (_chunk.data != nullptr) {
+                ChunkAllocator::instance()->free(_chunk);
+            } else {
+                delete[] _data.data;
+            }
         }
     }
 
@@ -78,6 +92,8 @@ private:
     // otherwise _cache_data is valid, and data is belong to cache.
     bool _is_data_owner = false;
     Slice _data;
+    // the chunk holding _data if it's from ChunkAllocator
+    Chunk _chunk {nullptr, 0, -1};
     PageCacheHandle _cache_data;
 
     // Don't allow copy and assign
@@ -25,9 +25,12 @@
 #include "gutil/strings/substitute.h"
 #include "olap/fs/block_manager.h"
 #include "olap/page_cache.h"
+#include "runtime/memory/chunk_allocator.h"
+#include "util/bit_util.h"
 #include "util/block_compression.h"
 #include "util/coding.h"
 #include "util/crc32c.h"
+#include "util/doris_metrics.h"
 #include "util/faststring.h"
 #include "util/runtime_profile.h"
 
@@ -36,6 +39,74 @@ namespace segment_v2 {
 
 using strings::Substitute;
 
+namespace {
+
+// The buffer of a page being read. The pages which are not inserted into the page cache live
+// as long as their readers use them, so their buffers and those of the compressed pages are
+// from ChunkAllocator, and reused by the following reads instead of being allocated and freed
+// for each page. The pages inserted are allocated with their exact sizes, since the cache
+// keeps them for long and frees them by delete[].
+class PageBuffer {
+public:
+    PageBuffer() {}
+    ~PageBuffer() { reset(); }
+
+    void allocate(size_t size, bool pooled) {
+        reset();
+        if (pooled && ChunkAllocator::instance()->allocate(BitUtil::RoundUpToPowerOfTwo(size),
+                                                           &_chunk)) {
+            _data = reinterpret_cast<char*>(_chunk.data);
+            return;
+        }
+        _chunk.data = nullptr;
+        _data = new char[size];
+    }
+
+    char* data() const { return _data; }
+    bool pooled() const { return _chunk.data != nullptr; }
+
+    void swap(PageBuffer* other) {
+        std::swap(_data, other->_data);
+        std::swap(_chunk, other->_chunk);
+    }
+
+    // Hand the buffer over to a PageHandle of 'size' bytes of it.
+    PageHandle to_page_handle(size_t size) {
+        Slice data(_data, size);
+        _data = nullptr;
+        if (_chunk.data != nullptr) {
+            Chunk chunk = _chunk;
+            _chunk.data = nullptr;
+            return PageHandle(chunk, data);
+        }
+        return PageHandle(data);
+    }
+
+    // Give up the buffer which is allocated by new[], now owned by the page cache.
+    void release() {
+        DCHECK(!pooled());
+        _data = nullptr;
+    }
+
+private:
+    void reset() {
+        if (_chunk.data != nullptr) {
+            ChunkAllocator::instance()->free(_chunk);
+        } else {
+            delete[] _data;
+        }
+        _chunk.data = nullptr;
+        _data = nullptr;
+    }
+
+    char* _data = nullptr;
+    Chunk _chunk {nullptr, 0, -1};
+
+    DISALLOW_COPY_AND_ASSIGN(PageBuffer);
+};
+
+} // namespace
+
 Status PageIO::compress_page_body(const BlockCompressionCodec* codec, double min_space_saving,
                                   const std::vector<Slice>& body, OwnedSlice* compressed_body) {
     size_t uncompressed_size = Slice::compute_total_size(body);
@@ -111,11 +182,15 @@ Status PageIO::read_and_decompress_page(const PageReadOptions& opts, PageHandle*
 
     auto cache = StoragePageCache::instance();
     PageCacheHandle cache_handle;
-    StoragePageCache::CacheKey cache_key(opts.rblock->path(), opts.page_pointer.offset);
-    if (opts.use_page_cache && cache->lookup(cache_key, &cache_handle)) {
+    StoragePageCache::CacheKey cache_key(opts.file_id, opts.page_pointer.offset);
+    if (opts.use_page_cache && cache_key.file_id == 0) {
+        cache_key.file_id = cache->file_id(opts.rblock->path());
+    }
+    if (opts.use_page_cache && cache->lookup(cache_key, &cache_handle, opts.type)) {
         // we find page in cache, use it
         *handle = PageHandle(std::move(cache_handle));
         opts.stats->cached_pages_num++;
+        opts.stats->cached_bytes_read += opts.page_pointer.size;
         // parse body and footer
         Slice page_slice = handle->data();
         uint32_t footer_size = decode_fixed32_le((uint8_t*)page_slice.data + page_slice.size - 4);
@@ -133,11 +208,18 @@ Status PageIO::read_and_decompress_page(const PageReadOptions& opts, PageHandle*
         return Status::Corruption(strings::Substitute("Bad page: too small size ($0)", page_size));
     }
 
-    // hold compressed page at first, reset to decompressed page later
-    std::unique_ptr<char[]> page(new char[page_size]);
-    Slice page_slice(page.get(), page_size);
+    // decided before the page is read, so that its buffer is allocated for where it ends up
+    bool insert_cache =
+            opts.use_page_cache && cache->admit(cache_key, opts.type, opts.kept_in_memory);
+
+    // hold compressed page at first, reset to decompressed page later. A page without codec
+    // is never compressed, which is read into the buffer of the cache entry if it's inserted.
+    PageBuffer page;
+    page.allocate(page_size, !insert_cache || opts.codec != nullptr);
+    Slice page_slice(page.data(), page_size);
     {
         SCOPED_RAW_TIMER(&opts.stats->io_ns);
+        ScopedLatencyRecorder latency(DorisMetrics::instance()->page_read_latency_us);
         RETURN_IF_ERROR(opts.rblock->read(opts.page_pointer.offset, page_slice));
         opts.stats->compressed_bytes_read += page_size;
     }
@@ -165,12 +247,13 @@ Status PageIO::read_and_decompress_page(const PageReadOptions& opts, PageHandle*
             return Status::Corruption("Bad page: page is compressed but codec is NO_COMPRESSION");
         }
         SCOPED_RAW_TIMER(&opts.stats->decompress_ns);
-        std::unique_ptr<char[]> decompressed_page(
-                new char[footer->uncompressed_size() + footer_size + 4]);
+        // decompressed into the buffer of the cache entry if it's inserted
+        PageBuffer decompressed_page;
+        decompressed_page.allocate(footer->uncompressed_size() + footer_size + 4, !insert_cache);
 
         // decompress page body
         Slice compressed_body(page_slice.data, body_size);
-        Slice decompressed_body(decompressed_page.get(), footer->uncompressed_size());
+        Slice decompressed_body(decompressed_page.data(), footer->uncompressed_size());
         RETURN_IF_ERROR(opts.codec->decompress(compressed_body, &decompressed_body));
         if (decompressed_body.size != footer->uncompressed_size()) {
             return Status::Corruption(strings::Substitute(
@@ -180,23 +263,31 @@ Status PageIO::read_and_decompress_page(const PageReadOptions& opts, PageHandle*
         // append footer and footer size
         memcpy(decompressed_body.data + decompressed_body.size, page_slice.data + body_size,
                footer_size + 4);
-        // free memory of compressed page
-        page = std::move(decompressed_page);
-        page_slice = Slice(page.get(), footer->uncompressed_size() + footer_size + 4);
+        // the compressed page is freed with decompressed_page
+        page.swap(&decompressed_page);
+        page_slice = Slice(page.data(), footer->uncompressed_size() + footer_size + 4);
         opts.stats->uncompressed_bytes_read += page_slice.size;
     } else {
+        if (insert_cache && page.pooled()) {
+            // a page of a codec is rarely left uncompressed, copied for the cache here
+            PageBuffer cache_page;
+            cache_page.allocate(page_slice.size, false);
+            memcpy(cache_page.data(), page_slice.data, page_slice.size);
+            page.swap(&cache_page);
+            page_slice.data = page.data();
+        }
         opts.stats->uncompressed_bytes_read += body_size;
     }
 
     *body = Slice(page_slice.data, page_slice.size - 4 - footer_size);
-    if (opts.use_page_cache) {
+    if (insert_cache) {
         // insert this page into cache and return the cache handle
-        cache->insert(cache_key, page_slice, &cache_handle, opts.kept_in_memory);
+        cache->insert(cache_key, page_slice, &cache_handle, opts.type, opts.kept_in_memory);
+        page.release(); // memory now managed by cache
         *handle = PageHandle(std::move(cache_handle));
     } else {
-        *handle = PageHandle(page_slice);
+        *handle = page.to_page_handle(page_slice.size);
     }
-    page.release(); // memory now managed by handle
     return Status::OK();
 }
 
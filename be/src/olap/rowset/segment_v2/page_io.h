@@ -43,6 +43,12 @@ struct PageReadOptions {
     fs::ReadableBlock* rblock = nullptr;
     // location of the page
     PagePointer page_pointer;
+    // id of the file in page cache, got from StoragePageCache::file_id().
+    // 0 means it's looked up by the path of rblock for this read.
+    uint64_t file_id = 0;
+    // decides which part of page cache the page is cached in, pages of
+    // IndexedColumn are INDEX_PAGE no matter what type the footer says
+    PageTypePB type = DATA_PAGE;
     // decompressor for page body (null means page body is not compressed)
     const BlockCompressionCodec* codec = nullptr;
     // used to collect IO metrics
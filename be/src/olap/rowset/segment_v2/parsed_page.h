@@ -22,6 +22,7 @@
 #include "common/status.h"
 #include "gen_cpp/segment_v2.pb.h"
 #include "olap/rowset/segment_v2/common.h"
+#include "olap/rowset/segment_v2/decoded_page_cache.h"
 #include "olap/rowset/segment_v2/encoding_info.h"
 #include "olap/rowset/segment_v2/options.h"
 #include "olap/rowset/segment_v2/page_decoder.h"
@@ -67,9 +68,37 @@ struct ParsedPage {
         return Status::OK();
     }
 
+    // Create a page which reads the values of a cached decoded page.
+    static Status create(std::shared_ptr<const DecodedPage> decoded_page,
+                         const PagePointer& page_pointer, uint32_t page_index,
+                         std::unique_ptr<ParsedPage>* result) {
+        std::unique_ptr<ParsedPage> page(new ParsedPage);
+        page->has_null = !decoded_page->null_bitmap.empty();
+        page->null_bitmap = Slice(decoded_page->null_bitmap);
+        if (page->has_null) {
+            page->null_decoder = RleDecoder<bool>((const uint8_t*)page->null_bitmap.data,
+                                                  page->null_bitmap.size, 1);
+        }
+
+        page->data_decoder = new DecodedPageDecoder(decoded_page->values.get());
+        RETURN_IF_ERROR(page->data_decoder->init());
+
+        page->first_ordinal = decoded_page->first_ordinal;
+        page->num_rows = decoded_page->num_rows;
+
+        page->page_pointer = page_pointer;
+        page->page_index = page_index;
+
+        page->decoded_page = std::move(decoded_page);
+        *result = std::move(page);
+        return Status::OK();
+    }
+
     ~ParsedPage() { delete data_decoder; }
 
     PageHandle page_handle;
+    // set if the page is read from DecodedPageCache, values are kept alive by it
+    std::shared_ptr<const DecodedPage> decoded_page;
 
     bool has_null;
     Slice null_bitmap;
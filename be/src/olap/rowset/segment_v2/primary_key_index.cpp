@@ -0,0 +1,113 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/rowset/segment_v2/primary_key_index.h"
+
+#include "olap/column_block.h"
+#include "olap/column_vector.h"
+#include "olap/rowset/segment_v2/encoding_info.h"
+#include "olap/rowset/segment_v2/indexed_column_writer.h"
+#include "olap/types.h"
+#include "runtime/mem_pool.h"
+
+namespace doris {
+namespace segment_v2 {
+
+PrimaryKeyIndexBuilder::PrimaryKeyIndexBuilder(fs::WritableBlock* wblock) : _wblock(wblock) {}
+
+PrimaryKeyIndexBuilder::~PrimaryKeyIndexBuilder() = default;
+
+Status PrimaryKeyIndexBuilder::init() {
+    const TypeInfo* type_info = get_scalar_type_info(OLAP_FIELD_TYPE_VARCHAR);
+    IndexedColumnWriterOptions options;
+    // ordinal index is used to read all keys of a segment
+    options.write_ordinal_index = true;
+    options.write_value_index = true;
+    options.encoding = EncodingInfo::get_default_encoding(type_info, true);
+    options.compression = LZ4F;
+    _column_writer.reset(new IndexedColumnWriter(options, type_info, _wblock));
+    return _column_writer->init();
+}
+
+Status PrimaryKeyIndexBuilder::add_item(const Slice& key) {
+    DCHECK(_num_rows == 0 || key.compare(Slice(_last_key)) > 0)
+            << "keys of primary key index must be ascending and unique";
+    RETURN_IF_ERROR(_column_writer->add(&key));
+    if (_num_rows == 0) {
+        _min_key.assign_copy(reinterpret_cast<const uint8_t*>(key.data), key.size);
+    }
+    _last_key.assign_copy(reinterpret_cast<const uint8_t*>(key.data), key.size);
+    _num_rows++;
+    _size += key.size;
+    return Status::OK();
+}
+
+Status PrimaryKeyIndexBuilder::finalize(PrimaryKeyIndexMetaPB* meta) {
+    meta->set_min_key(_min_key.data(), _min_key.size());
+    meta->set_max_key(_last_key.data(), _last_key.size());
+    return _column_writer->finish(meta->mutable_primary_key_column());
+}
+
+Status PrimaryKeyIndexReader::parse(const std::string& file_name,
+                                    const PrimaryKeyIndexMetaPB& meta) {
+    _column_reader.reset(new IndexedColumnReader(file_name, meta.primary_key_column()));
+    RETURN_IF_ERROR(_column_reader->load(true, false));
+    _min_key = meta.min_key();
+    _max_key = meta.max_key();
+    return Status::OK();
+}
+
+Status PrimaryKeyIndexReader::new_iterator(std::unique_ptr<IndexedColumnIterator>* iter) const {
+    iter->reset(new IndexedColumnIterator(_column_reader.get()));
+    return Status::OK();
+}
+
+Status PrimaryKeyIndexReader::lookup_row_id(IndexedColumnIterator* iter, const Slice& key,
+                                            rowid_t* row_id) const {
+    if (!may_contain(key)) {
+        return Status::NotFound("key is out of the range of primary key index");
+    }
+    bool exact_match = false;
+    RETURN_IF_ERROR(iter->seek_at_or_after(&key, &exact_match));
+    if (!exact_match) {
+        return Status::NotFound("key is not in primary key index");
+    }
+    *row_id = iter->get_current_ordinal();
+    return Status::OK();
+}
+
+Status PrimaryKeyIndexReader::read_keys(IndexedColumnIterator* iter, rowid_t from, size_t* n,
+                                        MemPool* pool, std::vector<Slice>* keys) const {
+    keys->clear();
+    if (from >= num_rows()) {
+        *n = 0;
+        return Status::OK();
+    }
+    std::unique_ptr<ColumnVectorBatch> cvb;
+    RETURN_IF_ERROR(ColumnVectorBatch::create(*n, false, _column_reader->type_info(), nullptr,
+                                              &cvb));
+    ColumnBlock block(cvb.get(), pool);
+    ColumnBlockView column_block_view(&block);
+    RETURN_IF_ERROR(iter->seek_to_ordinal(from));
+    RETURN_IF_ERROR(iter->next_batch(n, &column_block_view));
+    const Slice* values = reinterpret_cast<const Slice*>(block.data());
+    keys->assign(values, values + *n);
+    return Status::OK();
+}
+
+} // namespace segment_v2
+} // namespace doris
@@ -0,0 +1,142 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/status.h"
+#include "gen_cpp/segment_v2.pb.h"
+#include "gutil/macros.h"
+#include "olap/olap_common.h"
+#include "olap/rowset/segment_v2/common.h"
+#include "olap/rowset/segment_v2/indexed_column_reader.h"
+#include "olap/short_key_index.h"
+#include "util/faststring.h"
+#include "util/slice.h"
+
+namespace doris {
+
+class MemPool;
+
+namespace fs {
+class WritableBlock;
+}
+
+namespace segment_v2 {
+
+class IndexedColumnWriter;
+
+// Encode the key columns of `row` into `buf`. Encoded keys compare by memcmp as the
+// rows compare, and different keys are never encoded the same: unlike encode_key(),
+// strings are not truncated, and are escaped and terminated so that they can be
+// followed by other key columns.
+template <typename RowType>
+void encode_primary_key(const RowType& row, size_t num_keys, std::string* buf) {
+    for (size_t cid = 0; cid < num_keys; ++cid) {
+        auto cell = row.cell(cid);
+        if (cell.is_null()) {
+            buf->push_back(KEY_NULL_FIRST_MARKER);
+            continue;
+        }
+        buf->push_back(KEY_NORMAL_MARKER);
+        auto field = row.schema()->column(cid);
+        if (field->type() == OLAP_FIELD_TYPE_CHAR || field->type() == OLAP_FIELD_TYPE_VARCHAR) {
+            // 0x00 is escaped to 0x00 0x01, and 0x00 0x00 terminates the string
+            auto slice = reinterpret_cast<const Slice*>(cell.cell_ptr());
+            for (size_t i = 0; i < slice->size; ++i) {
+                buf->push_back(slice->data[i]);
+                if (slice->data[i] == '\0') {
+                    buf->push_back('\x01');
+                }
+            }
+            buf->push_back('\0');
+            buf->push_back('\0');
+        } else {
+            field->full_encode_ascending(cell.cell_ptr(), buf);
+        }
+    }
+}
+
+// Builder of the primary key index of a segment, which maps the encoded key of each
+// row to its row id. Since rows of a segment are sorted and unique by their keys,
+// the index is an indexed column of the encoded keys with value index.
+class PrimaryKeyIndexBuilder {
+public:
+    explicit PrimaryKeyIndexBuilder(fs::WritableBlock* wblock);
+    ~PrimaryKeyIndexBuilder();
+
+    Status init();
+
+    // Keys must be added in ascending order, one for each row.
+    Status add_item(const Slice& key);
+
+    uint32_t num_rows() const { return _num_rows; }
+
+    // bytes of keys added
+    uint64_t size() const { return _size; }
+
+    Status finalize(PrimaryKeyIndexMetaPB* meta);
+
+private:
+    fs::WritableBlock* _wblock;
+    std::unique_ptr<IndexedColumnWriter> _column_writer;
+    uint32_t _num_rows = 0;
+    uint64_t _size = 0;
+    faststring _min_key;
+    faststring _last_key;
+
+    DISALLOW_COPY_AND_ASSIGN(PrimaryKeyIndexBuilder);
+};
+
+// Thread-safe reader of the primary key index of a segment. Each thread looks up keys
+// with its own iterator created by new_iterator().
+class PrimaryKeyIndexReader {
+public:
+    PrimaryKeyIndexReader() = default;
+
+    Status parse(const std::string& file_name, const PrimaryKeyIndexMetaPB& meta);
+
+    Status new_iterator(std::unique_ptr<IndexedColumnIterator>* iter) const;
+
+    int64_t num_rows() const { return _column_reader->num_values(); }
+
+    // Return false if `key` is surely not in the index.
+    bool may_contain(const Slice& key) const {
+        return key.compare(Slice(_min_key)) >= 0 && key.compare(Slice(_max_key)) <= 0;
+    }
+
+    // Row id of `key`, NotFound if `key` is not in the index. Looking up keys in
+    // ascending order reuses the pages loaded by `iter`.
+    Status lookup_row_id(IndexedColumnIterator* iter, const Slice& key, rowid_t* row_id) const;
+
+    // Read at most `*n` keys from row `from`, the keys are allocated from `pool`.
+    Status read_keys(IndexedColumnIterator* iter, rowid_t from, size_t* n, MemPool* pool,
+                     std::vector<Slice>* keys) const;
+
+private:
+    std::unique_ptr<IndexedColumnReader> _column_reader;
+    std::string _min_key;
+    std::string _max_key;
+
+    DISALLOW_COPY_AND_ASSIGN(PrimaryKeyIndexReader);
+};
+
+} // namespace segment_v2
+} // namespace doris
@@ -0,0 +1,76 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/rowset/segment_v2/s2_index_reader.h"
+
+#include <s2/s2cell_id.h>
+
+#include "olap/rowset/segment_v2/s2_index_writer.h"
+
+namespace doris {
+namespace segment_v2 {
+
+Status S2IndexReader::new_iterator(S2IndexIterator** iterator) {
+    *iterator = new S2IndexIterator(this);
+    return Status::OK();
+}
+
+S2IndexIterator::S2IndexIterator(S2IndexReader* reader)
+        : _reader(reader), _cells_iter(new BitmapIndexIterator(&reader->_cells)) {}
+
+Status S2IndexIterator::filter_rows_in_cells(const std::vector<S2CellId>& cells,
+                                             Roaring* rows) {
+    int level = _reader->level();
+    Roaring matched;
+    for (const S2CellId& cell : cells) {
+        // the cells of the index in `cell', or the one containing it
+        int64_t lo = S2IndexWriter::cell_key(cell.range_min(), level);
+        int64_t hi = S2IndexWriter::cell_key(cell.range_max(), level);
+        rowid_t from = 0;
+        rowid_t to = 0;
+        RETURN_IF_ERROR(_seek_key_range(lo, hi, &from, &to));
+        if (from < to) {
+            RETURN_IF_ERROR(_cells_iter->read_union_bitmap(from, to, &matched));
+        }
+    }
+    *rows &= matched;
+    return Status::OK();
+}
+
+Status S2IndexIterator::_seek_key_range(int64_t lo, int64_t hi, rowid_t* from, rowid_t* to) {
+    bool exact_match = false;
+    Status st = _cells_iter->seek_dictionary(&lo, &exact_match);
+    if (st.is_not_found()) {
+        // all the keys are less than lo
+        *from = *to = 0;
+        return Status::OK();
+    }
+    RETURN_IF_ERROR(st);
+    *from = _cells_iter->current_ordinal();
+    st = _cells_iter->seek_dictionary(&hi, &exact_match);
+    if (st.is_not_found()) {
+        // the null bitmap is the last one
+        *to = _cells_iter->bitmap_nums() - (_cells_iter->has_null_bitmap() ? 1 : 0);
+        return Status::OK();
+    }
+    RETURN_IF_ERROR(st);
+    *to = _cells_iter->current_ordinal() + (exact_match ? 1 : 0);
+    return Status::OK();
+}
+
+} // namespace segment_v2
+} // namespace doris
@@ -0,0 +1,82 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <roaring/roaring.hh>
+
+#include "common/status.h"
+#include "gen_cpp/segment_v2.pb.h"
+#include "olap/rowset/segment_v2/bitmap_index_reader.h"
+
+class S2CellId;
+
+namespace doris {
+namespace segment_v2 {
+
+class S2IndexIterator;
+
+class S2IndexReader {
+public:
+    S2IndexReader(const std::string& file_name, const S2IndexPB* s2_index_meta)
+            : _s2_index_meta(s2_index_meta), _cells(file_name, &s2_index_meta->cells()) {}
+
+    Status load(bool use_page_cache, bool kept_in_memory) {
+        return _cells.load(use_page_cache, kept_in_memory);
+    }
+
+    // create a new iterator. Client should delete returned iterator
+    Status new_iterator(S2IndexIterator** iterator);
+
+    int level() const { return _s2_index_meta->level(); }
+
+    int32_t lat_column_unique_id() const { return _s2_index_meta->lat_column_unique_id(); }
+
+private:
+    friend class S2IndexIterator;
+
+    const S2IndexPB* _s2_index_meta;
+    BitmapIndexReader _cells;
+};
+
+class S2IndexIterator {
+public:
+    explicit S2IndexIterator(S2IndexReader* reader);
+
+    int level() const { return _reader->level(); }
+
+    int32_t lat_column_unique_id() const { return _reader->lat_column_unique_id(); }
+
+    // Remove from 'rows' the rows whose points are in none of 'cells', which are cells
+    // of any level, e.g. the covering of a region by S2RegionCoverer.
+    Status filter_rows_in_cells(const std::vector<S2CellId>& cells, Roaring* rows);
+
+private:
+    // Find the range [*from, *to) of the ordinals of the keys in [lo, hi]
+    Status _seek_key_range(int64_t lo, int64_t hi, rowid_t* from, rowid_t* to);
+
+    S2IndexReader* _reader;
+    std::unique_ptr<BitmapIndexIterator> _cells_iter;
+};
+
+} // namespace segment_v2
+} // namespace doris
@@ -0,0 +1,82 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/rowset/segment_v2/s2_index_writer.h"
+
+#include <s2/s2cell_id.h>
+#include <s2/s2latlng.h>
+
+#include <cmath>
+
+#include "olap/rowset/segment_v2/bitmap_index_writer.h"
+#include "olap/types.h"
+
+namespace doris {
+namespace segment_v2 {
+
+Status S2IndexWriter::create(int level, int32_t lat_column_unique_id,
+                             std::unique_ptr<S2IndexWriter>* res) {
+    if (level < 0 || level > S2CellId::kMaxLevel) {
+        return Status::InvalidArgument("invalid level of s2 index: " + std::to_string(level));
+    }
+    std::unique_ptr<BitmapIndexWriter> cells;
+    RETURN_IF_ERROR(BitmapIndexWriter::create(get_type_info(OLAP_FIELD_TYPE_BIGINT), &cells));
+    res->reset(new S2IndexWriter(level, lat_column_unique_id, std::move(cells)));
+    return Status::OK();
+}
+
+S2IndexWriter::S2IndexWriter(int level, int32_t lat_column_unique_id,
+                             std::unique_ptr<BitmapIndexWriter> cells)
+        : _level(level), _lat_column_unique_id(lat_column_unique_id), _cells(std::move(cells)) {}
+
+S2IndexWriter::~S2IndexWriter() = default;
+
+void S2IndexWriter::add_point(const double* lng, const double* lat) {
+    // the geo functions return null for the points out of range, which are in no shape
+    if (lng == nullptr || lat == nullptr || !(std::abs(*lng) <= 180) || !(std::abs(*lat) <= 90)) {
+        _cells->add_nulls(1);
+        return;
+    }
+    S2CellId cell_id(S2LatLng::FromDegrees(*lat, *lng));
+    int64_t key = cell_key(cell_id, _level);
+    _cells->add_values(&key, 1);
+}
+
+int64_t S2IndexWriter::cell_key(const S2CellId& cell_id, int level) {
+    // the id of a cell of `level' is its face and position bits followed by a 1 bit and
+    // 2 * (kMaxLevel - level) 0 bits, the key drops the trailing bits
+    return static_cast<int64_t>(cell_id.parent(level).id() >>
+                                (2 * (S2CellId::kMaxLevel - level) + 1));
+}
+
+Status S2IndexWriter::finish(fs::WritableBlock* wblock, ColumnIndexMetaPB* index_meta) {
+    ColumnIndexMetaPB cells_meta;
+    RETURN_IF_ERROR(_cells->finish(wblock, &cells_meta));
+    index_meta->set_type(S2_INDEX);
+    S2IndexPB* s2_meta = index_meta->mutable_s2_index();
+    s2_meta->set_level(_level);
+    s2_meta->set_lat_column_unique_id(_lat_column_unique_id);
+    s2_meta->mutable_cells()->Swap(cells_meta.mutable_bitmap_index());
+    return Status::OK();
+}
+
+uint64_t S2IndexWriter::size() const {
+    return _cells->size();
+}
+
+} // namespace segment_v2
+} // namespace doris
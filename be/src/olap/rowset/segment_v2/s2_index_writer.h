@@ -0,0 +1,74 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "common/status.h"
+#include "gen_cpp/segment_v2.pb.h"
+#include "gutil/macros.h"
+
+class S2CellId;
+
+namespace doris {
+
+namespace fs {
+class WritableBlock;
+}
+
+namespace segment_v2 {
+
+class BitmapIndexWriter;
+
+// Builds the S2 index of a segment on the points of a longitude and a latitude column.
+// The S2 cell of the given level containing each point is encoded by cell_key(), and the
+// keys are stored in the bitmap index layout, so that the rows in a cell or in a range of
+// cells are read by BitmapIndexIterator.
+class S2IndexWriter {
+public:
+    static Status create(int level, int32_t lat_column_unique_id,
+                         std::unique_ptr<S2IndexWriter>* res);
+
+    S2IndexWriter(int level, int32_t lat_column_unique_id,
+                  std::unique_ptr<BitmapIndexWriter> cells);
+    ~S2IndexWriter();
+
+    // Add the point of the next row, nullptr for a null value. Rows without a valid
+    // point have no cell.
+    void add_point(const double* lng, const double* lat);
+
+    Status finish(fs::WritableBlock* wblock, ColumnIndexMetaPB* index_meta);
+
+    uint64_t size() const;
+
+    // The key of the cell of `level' containing `cell_id'. The keys of the cells of a
+    // level are in the order of their ids, so the cells of a level in a cell of a lower
+    // level are a range of keys.
+    static int64_t cell_key(const S2CellId& cell_id, int level);
+
+private:
+    const int _level;
+    const int32_t _lat_column_unique_id;
+    std::unique_ptr<BitmapIndexWriter> _cells;
+
+    DISALLOW_COPY_AND_ASSIGN(S2IndexWriter);
+};
+
+} // namespace segment_v2
+} // namespace doris
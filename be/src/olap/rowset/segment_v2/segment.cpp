@@ -18,11 +18,13 @@
 #include "olap/rowset/segment_v2/segment.h"
 
 #include "common/logging.h" // LOG
+#include "env/env.h"
 #include "gutil/strings/substitute.h"
 #include "olap/fs/fs_util.h"
 #include "olap/rowset/segment_v2/column_reader.h" // ColumnReader
 #include "olap/rowset/segment_v2/empty_segment_iterator.h"
 #include "olap/rowset/segment_v2/page_io.h"
+#include "olap/rowset/segment_v2/primary_key_index.h"
 #include "olap/rowset/segment_v2/segment_iterator.h"
 #include "olap/rowset/segment_v2/segment_writer.h" // k_segment_magic_length
 #include "olap/tablet_schema.h"
@@ -47,8 +49,29 @@ Segment::Segment(std::string fname, uint32_t segment_id, const TabletSchema* tab
 
 Segment::~Segment() = default;
 
+std::string Segment::index_file_name(const std::string& segment_file) {
+    static const std::string kSegmentSuffix = ".dat";
+    if (segment_file.size() > kSegmentSuffix.size() &&
+        segment_file.compare(segment_file.size() - kSegmentSuffix.size(), kSegmentSuffix.size(),
+                             kSegmentSuffix) == 0) {
+        return segment_file.substr(0, segment_file.size() - kSegmentSuffix.size()) + ".idx";
+    }
+    return segment_file + ".idx";
+}
+
 Status Segment::_open() {
-    RETURN_IF_ERROR(_parse_footer());
+    RETURN_IF_ERROR(parse_footer(_fname, &_footer));
+    // the index file is only an optimization, the segment is still readable without it
+    std::string index_fname = index_file_name(_fname);
+    if (Env::Default()->path_exists(index_fname).ok()) {
+        Status st = parse_footer(index_fname, &_index_footer);
+        if (st.ok()) {
+            _index_fname = std::move(index_fname);
+        } else {
+            LOG(WARNING) << "ignore bad index file " << index_fname << ": " << st.to_string();
+            _index_footer.Clear();
+        }
+    }
     RETURN_IF_ERROR(_create_column_readers());
     return Status::OK();
 }
@@ -57,6 +80,19 @@ Status Segment::new_iterator(const Schema& schema, const StorageReadOptions& rea
                              std::unique_ptr<RowwiseIterator>* iter) {
     DCHECK_NOTNULL(read_options.stats);
     read_options.stats->total_segment_number++;
+    if (can_be_pruned(read_options)) {
+        iter->reset(new EmptySegmentIterator(schema));
+        read_options.stats->filtered_segment_number++;
+        return Status::OK();
+    }
+
+    RETURN_IF_ERROR(_load_index());
+    iter->reset(new SegmentIterator(this->shared_from_this(), schema));
+    iter->get()->init(read_options);
+    return Status::OK();
+}
+
+bool Segment::can_be_pruned(const StorageReadOptions& read_options) const {
     // trying to prune the current segment by segment-level zone map
     if (read_options.conditions != nullptr) {
         for (auto& column_condition : read_options.conditions->columns()) {
@@ -66,32 +102,76 @@ Status Segment::new_iterator(const Schema& schema, const StorageReadOptions& rea
                 continue;
             }
             if (!_column_readers[column_id]->match_condition(column_condition.second)) {
-                // any condition not satisfied, return.
-                iter->reset(new EmptySegmentIterator(schema));
-                read_options.stats->filtered_segment_number++;
-                return Status::OK();
+                // any condition not satisfied
+                return true;
+            }
+        }
+    }
+    // a delete condition deletes all rows if all of its columns are satisfied
+    for (auto delete_condition : read_options.delete_conditions) {
+        if (delete_condition->columns().empty()) {
+            continue;
+        }
+        bool all_deleted = true;
+        for (auto& column_condition : delete_condition->columns()) {
+            int32_t column_id = column_condition.first;
+            if (_column_readers[column_id] == nullptr ||
+                _column_readers[column_id]->delete_match_condition(column_condition.second) !=
+                        DEL_SATISFIED) {
+                all_deleted = false;
+                break;
             }
         }
+        if (all_deleted) {
+            return true;
+        }
     }
+    return false;
+}
 
-    RETURN_IF_ERROR(_load_index());
-    iter->reset(new SegmentIterator(this->shared_from_this(), schema));
-    iter->get()->init(read_options);
+Status Segment::get_min_max(uint32_t cid, WrapperField* min_value, WrapperField* max_value) const {
+    if (cid >= _column_readers.size() || _column_readers[cid] == nullptr ||
+        !_column_readers[cid]->get_segment_min_max(min_value, max_value)) {
+        return Status::NotSupported(Substitute("no zone map of column $0", cid));
+    }
     return Status::OK();
 }
 
-Status Segment::_parse_footer() {
+Status Segment::get_page_zone_maps(uint32_t cid, std::vector<ZoneMapPB>* zone_maps,
+                                   std::vector<uint32_t>* page_num_rows) {
+    if (cid >= _column_readers.size() || _column_readers[cid] == nullptr ||
+        !_column_readers[cid]->has_zone_map()) {
+        return Status::NotSupported(Substitute("no zone map of column $0", cid));
+    }
+    return _column_readers[cid]->get_page_zone_maps(zone_maps, page_num_rows);
+}
+
+Status Segment::get_column_statistics(uint32_t cid, uint64_t* null_count,
+                                      std::string* ndv_sketch) {
+    if (cid >= _column_readers.size() || _column_readers[cid] == nullptr ||
+        !_column_readers[cid]->has_statistics()) {
+        return Status::NotSupported(Substitute("no statistics index of column $0", cid));
+    }
+    return _column_readers[cid]->get_statistics(null_count, ndv_sketch);
+}
+
+size_t Segment::mem_usage() const {
+    return sizeof(Segment) + _fname.size() + _footer.SpaceUsedLong() + _index_fname.size() +
+           _index_footer.SpaceUsedLong() + _column_readers.size() * sizeof(ColumnReader);
+}
+
+Status Segment::parse_footer(const std::string& fname, SegmentFooterPB* footer) {
     // Footer := SegmentFooterPB, FooterPBSize(4), FooterPBChecksum(4), MagicNumber(4)
     std::unique_ptr<fs::ReadableBlock> rblock;
     fs::BlockManager* block_mgr = fs::fs_util::block_manager();
-    RETURN_IF_ERROR(block_mgr->open_block(_fname, &rblock));
+    RETURN_IF_ERROR(block_mgr->open_block(fname, &rblock));
 
     uint64_t file_size;
     RETURN_IF_ERROR(rblock->size(&file_size));
 
     if (file_size < 12) {
         return Status::Corruption(
-                strings::Substitute("Bad segment file $0: file size $1 < 12", _fname, file_size));
+                strings::Substitute("Bad segment file $0: file size $1 < 12", fname, file_size));
     }
 
     uint8_t fixed_buf[12];
@@ -100,14 +180,14 @@ Status Segment::_parse_footer() {
     // validate magic number
     if (memcmp(fixed_buf + 8, k_segment_magic, k_segment_magic_length) != 0) {
         return Status::Corruption(
-                strings::Substitute("Bad segment file $0: magic number not match", _fname));
+                strings::Substitute("Bad segment file $0: magic number not match", fname));
     }
 
     // read footer PB
     uint32_t footer_length = decode_fixed32_le(fixed_buf);
     if (file_size < 12 + footer_length) {
         return Status::Corruption(strings::Substitute("Bad segment file $0: file size $1 < $2",
-                                                      _fname, file_size, 12 + footer_length));
+                                                      fname, file_size, 12 + footer_length));
     }
     std::string footer_buf;
     footer_buf.resize(footer_length);
@@ -118,14 +198,14 @@ Status Segment::_parse_footer() {
     uint32_t actual_checksum = crc32c::Value(footer_buf.data(), footer_buf.size());
     if (actual_checksum != expect_checksum) {
         return Status::Corruption(strings::Substitute(
-                "Bad segment file $0: footer checksum not match, actual=$1 vs expect=$2", _fname,
+                "Bad segment file $0: footer checksum not match, actual=$1 vs expect=$2", fname,
                 actual_checksum, expect_checksum));
     }
 
     // deserialize footer PB
-    if (!_footer.ParseFromString(footer_buf)) {
+    if (!footer->ParseFromString(footer_buf)) {
         return Status::Corruption(strings::Substitute(
-                "Bad segment file $0: failed to parse SegmentFooterPB", _fname));
+                "Bad segment file $0: failed to parse SegmentFooterPB", fname));
     }
     return Status::OK();
 }
@@ -140,6 +220,7 @@ Status Segment::_load_index() {
         PageReadOptions opts;
         opts.rblock = rblock.get();
         opts.page_pointer = PagePointer(_footer.short_key_index_page());
+        opts.type = SHORT_KEY_PAGE;
         opts.codec = nullptr; // short key index page uses NO_COMPRESSION for now
         OlapReaderStatistics tmp_stats;
         opts.stats = &tmp_stats;
@@ -155,11 +236,26 @@ Status Segment::_load_index() {
     });
 }
 
+Status Segment::load_pk_index() {
+    return _load_pk_index_once.call([this] {
+        if (!_footer.has_primary_key_index()) {
+            return Status::NotSupported(
+                    strings::Substitute("segment $0 has no primary key index", _fname));
+        }
+        _pk_index_reader.reset(new PrimaryKeyIndexReader());
+        return _pk_index_reader->parse(_fname, _footer.primary_key_index());
+    });
+}
+
 Status Segment::_create_column_readers() {
     for (uint32_t ordinal = 0; ordinal < _footer.columns().size(); ++ordinal) {
         auto& column_pb = _footer.columns(ordinal);
         _column_id_to_footer_ordinal.emplace(column_pb.unique_id(), ordinal);
     }
+    std::unordered_map<uint32_t, uint32_t> index_column_id_to_ordinal;
+    for (uint32_t ordinal = 0; ordinal < _index_footer.columns().size(); ++ordinal) {
+        index_column_id_to_ordinal.emplace(_index_footer.columns(ordinal).unique_id(), ordinal);
+    }
 
     _column_readers.resize(_tablet_schema->columns().size());
     for (uint32_t ordinal = 0; ordinal < _tablet_schema->num_columns(); ++ordinal) {
@@ -171,6 +267,11 @@ Status Segment::_create_column_readers() {
 
         ColumnReaderOptions opts;
         opts.kept_in_memory = _tablet_schema->is_in_memory();
+        auto index_iter = index_column_id_to_ordinal.find(column.unique_id());
+        if (index_iter != index_column_id_to_ordinal.end()) {
+            opts.index_file_meta = &_index_footer.columns(index_iter->second);
+            opts.index_file_name = _index_fname;
+        }
         std::unique_ptr<ColumnReader> reader;
         RETURN_IF_ERROR(ColumnReader::create(opts, _footer.columns(iter->second),
                                              _footer.num_rows(), _fname, &reader));
@@ -205,5 +306,19 @@ Status Segment::new_bitmap_index_iterator(uint32_t cid, BitmapIndexIterator** it
     return Status::OK();
 }
 
+Status Segment::new_ngram_index_iterator(uint32_t cid, NGramIndexIterator** iter) {
+    if (_column_readers[cid] != nullptr && _column_readers[cid]->has_ngram_index()) {
+        return _column_readers[cid]->new_ngram_index_iterator(iter);
+    }
+    return Status::OK();
+}
+
+Status Segment::new_s2_index_iterator(uint32_t cid, S2IndexIterator** iter) {
+    if (_column_readers[cid] != nullptr && _column_readers[cid]->has_s2_index()) {
+        return _column_readers[cid]->new_s2_index_iterator(iter);
+    }
+    return Status::OK();
+}
+
 } // namespace segment_v2
 } // namespace doris
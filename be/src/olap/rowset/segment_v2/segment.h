@@ -39,12 +39,16 @@ class TabletSchema;
 class ShortKeyIndexDecoder;
 class Schema;
 class StorageReadOptions;
+class WrapperField;
 
 namespace segment_v2 {
 
 class BitmapIndexIterator;
 class ColumnReader;
 class ColumnIterator;
+class NGramIndexIterator;
+class PrimaryKeyIndexReader;
+class S2IndexIterator;
 class Segment;
 class SegmentIterator;
 using SegmentSharedPtr = std::shared_ptr<Segment>;
@@ -64,9 +68,37 @@ public:
 
     ~Segment();
 
+    // The file of the indexes built after the segment file was written, see SegmentIndexBuilder.
+    // It has the format of a segment file, whose footer only has the ColumnMetaPBs of the
+    // indexes. Its indexes are used by the columns whose segment file lacks them.
+    static std::string index_file_name(const std::string& segment_file);
+
+    // Read and validate the footer of a segment file or an index file.
+    static Status parse_footer(const std::string& fname, SegmentFooterPB* footer);
+
     Status new_iterator(const Schema& schema, const StorageReadOptions& read_options,
                         std::unique_ptr<RowwiseIterator>* iter);
 
+    // Return true if no row of this segment can be read with `read_options', judged by
+    // the segment-level zone maps in footer, i.e. some condition matches no row or some
+    // delete condition deletes all rows. It is fast and doesn't load any index.
+    bool can_be_pruned(const StorageReadOptions& read_options) const;
+
+    // Get the min and max values of column `cid' from its segment-level zone map, without
+    // I/O. Both are set to null if all values are null. NotSupported if the column is not
+    // in this segment or has no zone map.
+    Status get_min_max(uint32_t cid, WrapperField* min_value, WrapperField* max_value) const;
+
+    // Get the zone map and the number of rows of each data page of column `cid'.
+    // NotSupported if the column is not in this segment or has no zone map.
+    Status get_page_zone_maps(uint32_t cid, std::vector<ZoneMapPB>* zone_maps,
+                              std::vector<uint32_t>* page_num_rows);
+
+    // Get the number of nulls and the serialized HyperLogLog of the not-null values of
+    // column `cid', see StatisticsIndexWriter. NotSupported if the column is not in this
+    // segment or has no statistics index.
+    Status get_column_statistics(uint32_t cid, uint64_t* null_count, std::string* ndv_sketch);
+
     uint64_t id() const { return _segment_id; }
 
     uint32_t num_rows() const { return _footer.num_rows(); }
@@ -75,7 +107,21 @@ public:
 
     Status new_bitmap_index_iterator(uint32_t cid, BitmapIndexIterator** iter);
 
-    size_t num_short_keys() const { return _tablet_schema->num_short_key_columns(); }
+    Status new_ngram_index_iterator(uint32_t cid, NGramIndexIterator** iter);
+
+    Status new_s2_index_iterator(uint32_t cid, S2IndexIterator** iter);
+
+    // Load the short key index if it is not loaded yet. It must be called before
+    // functions below when no iterator has been created on this segment.
+    Status load_index() { return _load_index(); }
+
+    // The number of key columns the short key index is encoded with, which is more than
+    // the short key columns if the segment was written with all the key columns
+    size_t num_short_keys() const {
+        DCHECK(_load_index_once.has_called() && _load_index_once.stored_result().ok());
+        uint32_t num_key_columns = _sk_index_decoder->num_key_columns();
+        return num_key_columns > 0 ? num_key_columns : _tablet_schema->num_short_key_columns();
+    }
 
     uint32_t num_rows_per_block() const {
         DCHECK(_load_index_once.has_called() && _load_index_once.stored_result().ok());
@@ -99,15 +145,34 @@ public:
         return _sk_index_decoder->num_items() - 1;
     }
 
+    bool has_primary_key_index() const { return _footer.has_primary_key_index(); }
+
+    // See SegmentFooterPB.clustered
+    bool is_clustered() const { return _footer.clustered(); }
+
+    // Load the primary key index if it is not loaded yet. It must be called before
+    // primary_key_index(), NotSupported if the segment has no primary key index.
+    Status load_pk_index();
+
+    const PrimaryKeyIndexReader* primary_key_index() const {
+        DCHECK(_load_pk_index_once.has_called() && _load_pk_index_once.stored_result().ok());
+        return _pk_index_reader.get();
+    }
+
+    // Estimated memory used by the footer and column readers of this segment.
+    size_t mem_usage() const;
+
     // only used by UT
     const SegmentFooterPB& footer() const { return _footer; }
 
+    // The footer of the index file, empty if the segment has no index file.
+    const SegmentFooterPB& index_footer() const { return _index_footer; }
+
 private:
     DISALLOW_COPY_AND_ASSIGN(Segment);
     Segment(std::string fname, uint32_t segment_id, const TabletSchema* tablet_schema);
     // open segment file and read the minimum amount of necessary information (footer)
     Status _open();
-    Status _parse_footer();
     Status _create_column_readers();
     // Load and decode short key index.
     // May be called multiple times, subsequent calls will no op.
@@ -115,11 +180,15 @@ private:
 
 private:
     friend class SegmentIterator;
+    friend class SegmentIndexBuilder;
     std::string _fname;
     uint32_t _segment_id;
     const TabletSchema* _tablet_schema;
 
     SegmentFooterPB _footer;
+    // empty if there is no index file
+    std::string _index_fname;
+    SegmentFooterPB _index_footer;
 
     // Map from column unique id to column ordinal in footer's ColumnMetaPB
     // If we can't find unique id from it, it means this segment is created
@@ -137,6 +206,9 @@ private:
     PageHandle _sk_index_handle;
     // short key index decoder
     std::unique_ptr<ShortKeyIndexDecoder> _sk_index_decoder;
+
+    DorisCallOnce<Status> _load_pk_index_once;
+    std::unique_ptr<PrimaryKeyIndexReader> _pk_index_reader;
 };
 
 } // namespace segment_v2
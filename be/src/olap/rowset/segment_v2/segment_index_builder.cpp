@@ -0,0 +1,236 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/rowset/segment_v2/segment_index_builder.h"
+
+#include <algorithm>
+
+#include "env/env.h"
+#include "gutil/strings/substitute.h"
+#include "olap/column_block.h"
+#include "olap/column_vector.h"
+#include "olap/fs/block_manager.h"
+#include "olap/fs/fs_util.h"
+#include "olap/rowset/segment_v2/bitmap_index_writer.h"
+#include "olap/rowset/segment_v2/bloom_filter.h"
+#include "olap/rowset/segment_v2/bloom_filter_index_writer.h"
+#include "olap/rowset/segment_v2/column_reader.h"
+#include "olap/rowset/segment_v2/segment_writer.h"
+#include "olap/tablet_schema.h"
+#include "olap/types.h"
+#include "runtime/mem_pool.h"
+#include "runtime/mem_tracker.h"
+
+namespace doris {
+namespace segment_v2 {
+
+// rows read from a column at a time to feed the index writers
+static const size_t kBuildBatchRows = 1024;
+
+static bool has_index(const ColumnMetaPB& meta, ColumnIndexTypePB type) {
+    for (auto& index_meta : meta.indexes()) {
+        if (index_meta.type() == type) {
+            return true;
+        }
+    }
+    return false;
+}
+
+SegmentIndexBuilder::SegmentIndexBuilder(SegmentSharedPtr segment,
+                                         const TabletSchema* tablet_schema)
+        : _segment(std::move(segment)), _tablet_schema(tablet_schema) {}
+
+std::vector<SegmentIndexBuilder::ColumnIndexes> SegmentIndexBuilder::_indexes_to_build() const {
+    std::vector<ColumnIndexes> result;
+    for (uint32_t ordinal = 0; ordinal < _tablet_schema->num_columns(); ++ordinal) {
+        const TabletColumn& column = _tablet_schema->column(ordinal);
+        if (!column.has_bitmap_index() && !column.is_bf_column()) {
+            continue;
+        }
+        // the indexes of the items of arrays are not built
+        if (_segment->_column_readers[ordinal] == nullptr || !is_scalar_type(column.type())) {
+            continue;
+        }
+        auto iter = _segment->_column_id_to_footer_ordinal.find(column.unique_id());
+        DCHECK(iter != _segment->_column_id_to_footer_ordinal.end());
+        const ColumnMetaPB& meta = _segment->_footer.columns(iter->second);
+        ColumnIndexes indexes;
+        indexes.ordinal = ordinal;
+        indexes.need_bitmap_index = column.has_bitmap_index() && !has_index(meta, BITMAP_INDEX);
+        indexes.need_bloom_filter = column.is_bf_column() && !has_index(meta, BLOOM_FILTER_INDEX);
+        if (indexes.need_bitmap_index || indexes.need_bloom_filter) {
+            result.push_back(indexes);
+        }
+    }
+    return result;
+}
+
+bool SegmentIndexBuilder::need_build() const {
+    const SegmentFooterPB& index_footer = _segment->_index_footer;
+    for (auto& indexes : _indexes_to_build()) {
+        int32_t unique_id = _tablet_schema->column(indexes.ordinal).unique_id();
+        auto iter = std::find_if(
+                index_footer.columns().begin(), index_footer.columns().end(),
+                [unique_id](const ColumnMetaPB& meta) { return meta.unique_id() == unique_id; });
+        if (iter == index_footer.columns().end() ||
+            (indexes.need_bitmap_index && !has_index(*iter, BITMAP_INDEX)) ||
+            (indexes.need_bloom_filter && !has_index(*iter, BLOOM_FILTER_INDEX))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+Status SegmentIndexBuilder::build() {
+    std::string index_fname = Segment::index_file_name(_segment->_fname);
+    if (!_segment->_index_fname.empty() || Env::Default()->path_exists(index_fname).ok()) {
+        return Status::AlreadyExist(
+                strings::Substitute("index file $0 already exists", index_fname));
+    }
+    // the index file is written under a temporary name, so that a broken one is never read
+    std::string tmp_fname = index_fname + ".tmp";
+    if (Env::Default()->path_exists(tmp_fname).ok()) {
+        RETURN_IF_ERROR(Env::Default()->delete_file(tmp_fname));
+    }
+    std::unique_ptr<fs::WritableBlock> wblock;
+    fs::CreateBlockOptions opts({tmp_fname, false});
+    RETURN_IF_ERROR(fs::fs_util::block_manager()->create_block(opts, &wblock));
+
+    SegmentFooterPB footer;
+    footer.set_num_rows(_segment->num_rows());
+    Status st;
+    for (auto& indexes : _indexes_to_build()) {
+        st = _build_column(indexes, wblock.get(), footer.add_columns());
+        if (!st.ok()) {
+            break;
+        }
+    }
+    if (st.ok()) {
+        st = SegmentWriter::write_footer(wblock.get(), footer);
+    }
+    if (st.ok()) {
+        st = wblock->close();
+    }
+    if (!st.ok()) {
+        wblock->abort();
+        WARN_IF_ERROR(Env::Default()->delete_file(tmp_fname),
+                      strings::Substitute("failed to delete $0", tmp_fname));
+        return st;
+    }
+    return Env::Default()->rename_file(tmp_fname, index_fname);
+}
+
+Status SegmentIndexBuilder::_build_column(const ColumnIndexes& indexes,
+                                          fs::WritableBlock* wblock, ColumnMetaPB* meta) {
+    const TabletColumn& column = _tablet_schema->column(indexes.ordinal);
+    ColumnReader* reader = _segment->_column_readers[indexes.ordinal].get();
+    const TypeInfo* type_info = reader->type_info();
+    meta->set_column_id(indexes.ordinal);
+    meta->set_unique_id(column.unique_id());
+    meta->set_type(column.type());
+    meta->set_is_nullable(reader->is_nullable());
+
+    std::unique_ptr<BitmapIndexWriter> bitmap_writer;
+    if (indexes.need_bitmap_index) {
+        RETURN_IF_ERROR(BitmapIndexWriter::create(type_info, &bitmap_writer));
+    }
+    std::unique_ptr<BloomFilterIndexWriter> bf_writer;
+    if (indexes.need_bloom_filter) {
+        RETURN_IF_ERROR(
+                BloomFilterIndexWriter::create(BloomFilterOptions(), type_info, &bf_writer));
+    }
+
+    std::unique_ptr<fs::ReadableBlock> rblock;
+    RETURN_IF_ERROR(fs::fs_util::block_manager()->open_block(_segment->_fname, &rblock));
+    ColumnIterator* raw_iter = nullptr;
+    RETURN_IF_ERROR(reader->new_iterator(&raw_iter));
+    std::unique_ptr<ColumnIterator> iter(raw_iter);
+    OlapReaderStatistics stats;
+    ColumnIteratorOptions iter_opts;
+    iter_opts.rblock = rblock.get();
+    iter_opts.stats = &stats;
+    RETURN_IF_ERROR(iter->init(iter_opts));
+    RETURN_IF_ERROR(iter->seek_to_first());
+
+    // a bloom filter is built for each data page, which is the unit of reading
+    std::vector<ordinal_t> page_ordinals;
+    RETURN_IF_ERROR(reader->get_page_first_ordinals(&page_ordinals));
+    page_ordinals.push_back(_segment->num_rows());
+
+    auto tracker = std::make_shared<MemTracker>();
+    MemPool pool(tracker.get());
+    std::unique_ptr<ColumnVectorBatch> batch;
+    RETURN_IF_ERROR(ColumnVectorBatch::create(kBuildBatchRows, reader->is_nullable(), type_info,
+                                              nullptr, &batch));
+    ColumnBlock block(batch.get(), &pool);
+    for (size_t page = 0; page + 1 < page_ordinals.size(); ++page) {
+        ordinal_t rowid = page_ordinals[page];
+        while (rowid < page_ordinals[page + 1]) {
+            size_t num_rows = std::min<ordinal_t>(kBuildBatchRows, page_ordinals[page + 1] - rowid);
+            ColumnBlockView dst(&block);
+            bool has_null = false;
+            RETURN_IF_ERROR(iter->next_batch(&num_rows, &dst, &has_null));
+            if (num_rows == 0) {
+                return Status::Corruption(strings::Substitute(
+                        "failed to read column $0 of $1 at row $2", column.name(),
+                        _segment->_fname, rowid));
+            }
+            // add the runs of nulls and values
+            size_t run_start = 0;
+            while (run_start < num_rows) {
+                bool is_null = has_null && block.is_null(run_start);
+                size_t run_end = run_start + 1;
+                while (run_end < num_rows && has_null && block.is_null(run_end) == is_null) {
+                    ++run_end;
+                }
+                size_t run_length = run_end - run_start;
+                if (is_null) {
+                    if (bitmap_writer != nullptr) {
+                        bitmap_writer->add_nulls(run_length);
+                    }
+                    if (bf_writer != nullptr) {
+                        bf_writer->add_nulls(run_length);
+                    }
+                } else {
+                    if (bitmap_writer != nullptr) {
+                        bitmap_writer->add_values(block.cell_ptr(run_start), run_length);
+                    }
+                    if (bf_writer != nullptr) {
+                        bf_writer->add_values(block.cell_ptr(run_start), run_length);
+                    }
+                }
+                run_start = run_end;
+            }
+            rowid += num_rows;
+            pool.clear();
+        }
+        if (bf_writer != nullptr) {
+            RETURN_IF_ERROR(bf_writer->flush());
+        }
+    }
+
+    if (bitmap_writer != nullptr) {
+        RETURN_IF_ERROR(bitmap_writer->finish(wblock, meta->add_indexes()));
+    }
+    if (bf_writer != nullptr) {
+        RETURN_IF_ERROR(bf_writer->finish(wblock, meta->add_indexes()));
+    }
+    return Status::OK();
+}
+
+} // namespace segment_v2
+} // namespace doris
@@ -0,0 +1,85 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "common/status.h"
+#include "gen_cpp/segment_v2.pb.h"
+#include "gutil/macros.h"
+#include "olap/rowset/segment_v2/segment.h"
+
+namespace doris {
+
+class TabletSchema;
+
+namespace fs {
+class WritableBlock;
+}
+
+namespace segment_v2 {
+
+// Build the bitmap and bloom filter indexes of the columns of a tablet schema, which the
+// segment file lacks, e.g. the indexes are added to the columns by a linked schema change
+// after the segment was written. They are written into the index file of the segment, see
+// Segment::index_file_name(), without rewriting the segment file. The index file is used
+// once the segment is opened again.
+//
+// Usage:
+//      SegmentIndexBuilder builder(segment, tablet_schema);
+//      if (builder.need_build()) {
+//          RETURN_IF_ERROR(builder.build());
+//      }
+class SegmentIndexBuilder {
+public:
+    // 'segment' must be opened with 'tablet_schema'
+    SegmentIndexBuilder(SegmentSharedPtr segment, const TabletSchema* tablet_schema);
+
+    // Whether some index is in neither the segment file nor the index file of the segment.
+    bool need_build() const;
+
+    // Write all the indexes the segment file lacks into a new index file. An existing index
+    // file is never rewritten, since its pages and file handles may be cached, so it's an
+    // error if the segment has an index file.
+    Status build();
+
+private:
+    DISALLOW_COPY_AND_ASSIGN(SegmentIndexBuilder);
+
+    struct ColumnIndexes {
+        // ordinal of the column in tablet schema
+        uint32_t ordinal;
+        bool need_bitmap_index;
+        bool need_bloom_filter;
+    };
+
+    // Find the indexes of the columns which the segment file lacks
+    std::vector<ColumnIndexes> _indexes_to_build() const;
+
+    // Read the values of the column and write its indexes into 'wblock'
+    Status _build_column(const ColumnIndexes& indexes, fs::WritableBlock* wblock,
+                         ColumnMetaPB* meta);
+
+    SegmentSharedPtr _segment;
+    const TabletSchema* _tablet_schema;
+};
+
+} // namespace segment_v2
+} // namespace doris
@@ -17,9 +17,12 @@
 
 #include "olap/rowset/segment_v2/segment_iterator.h"
 
+#include <map>
 #include <set>
 
+#include "common/config.h"
 #include "gutil/strings/substitute.h"
+#include "olap/block_filter.h"
 #include "olap/column_predicate.h"
 #include "olap/fs/fs_util.h"
 #include "olap/row.h"
@@ -28,6 +31,7 @@
 #include "olap/rowset/segment_v2/column_reader.h"
 #include "olap/rowset/segment_v2/segment.h"
 #include "olap/short_key_index.h"
+#include "olap/tablet_meta.h"
 #include "util/doris_metrics.h"
 
 using strings::Substitute;
@@ -96,7 +100,13 @@ SegmentIterator::SegmentIterator(std::shared_ptr<Segment> segment, const Schema&
           _bitmap_index_iterators(_schema.num_columns(), nullptr),
           _cur_rowid(0),
           _lazy_materialization_read(false),
-          _inited(false) {}
+          _inited(false) {
+    if (Trace::CurrentTrace() != nullptr) {
+        _trace = new Trace;
+        Trace::CurrentTrace()->AddChildTrace(Substitute("segment $0", _segment->id()),
+                                             _trace.get());
+    }
+}
 
 SegmentIterator::~SegmentIterator() {
     for (auto iter : _column_iterators) {
@@ -116,20 +126,53 @@ Status SegmentIterator::init(const StorageReadOptions& opts) {
 }
 
 Status SegmentIterator::_init() {
+    ADOPT_TRACE(_trace.get());
     DorisMetrics::instance()->segment_read_total->increment(1);
     // get file handle from file descriptor of segment
     fs::BlockManager* block_mgr = fs::fs_util::block_manager();
-    RETURN_IF_ERROR(block_mgr->open_block(_segment->_fname, &_rblock));
+    bool opened = false;
+    RETURN_IF_ERROR(block_mgr->open_block(_segment->_fname, &_rblock, &opened));
+    if (opened) {
+        _opts.stats->file_open_num++;
+    }
     _row_bitmap.addRange(0, _segment->num_rows());
     RETURN_IF_ERROR(_init_return_column_iterators());
     RETURN_IF_ERROR(_init_bitmap_index_iterators());
+    TRACE("column iterators of $0 rows created", _segment->num_rows());
     RETURN_IF_ERROR(_get_row_ranges_by_keys());
+    TRACE("$0 rows left by the short key index", _row_bitmap.cardinality());
+    _apply_delete_bitmap();
     RETURN_IF_ERROR(_get_row_ranges_by_column_conditions());
+    TRACE("$0 rows left by the delete bitmap and the column indexes", _row_bitmap.cardinality());
+    RETURN_IF_ERROR(_get_row_ranges_by_block_filters());
+    TRACE("$0 rows left by the block filters", _row_bitmap.cardinality());
+    if (_opts.read_ahead_pool != nullptr && _opts.read_ahead_pages > 0) {
+        for (auto cid : _schema.column_ids()) {
+            _column_iterators[cid]->enable_read_ahead(_opts.read_ahead_pool,
+                                                      _opts.read_ahead_pages, &_row_bitmap);
+        }
+    }
+    _init_delete_conditions();
     _init_lazy_materialization();
     _range_iter.reset(new BitmapRangeIterator(_row_bitmap));
     return Status::OK();
 }
 
+void SegmentIterator::_apply_delete_bitmap() {
+    if (_opts.delete_bitmap == nullptr || _row_bitmap.isEmpty()) {
+        return;
+    }
+    Roaring deleted;
+    _opts.delete_bitmap->get_agg(_opts.rowset_id, _segment->id(), _opts.delete_bitmap_version,
+                                 &deleted);
+    if (deleted.isEmpty()) {
+        return;
+    }
+    size_t pre_size = _row_bitmap.cardinality();
+    _row_bitmap -= deleted;
+    _opts.stats->rows_del_by_bitmap += (pre_size - _row_bitmap.cardinality());
+}
+
 Status SegmentIterator::_get_row_ranges_by_keys() {
     DorisMetrics::instance()->segment_row_total->increment(num_rows());
 
@@ -137,6 +180,11 @@ Status SegmentIterator::_get_row_ranges_by_keys() {
     if (_row_bitmap.isEmpty() || _opts.key_ranges.empty()) {
         return Status::OK();
     }
+    // The rows of a clustered segment are not ordered by keys. Key ranges are built from
+    // the conditions on key columns, which select the rows by themselves anyway.
+    if (_segment->is_clustered()) {
+        return Status::OK();
+    }
 
     RowRanges result_ranges;
     for (auto& key_range : _opts.key_ranges) {
@@ -206,6 +254,8 @@ Status SegmentIterator::_get_row_ranges_by_column_conditions() {
         return Status::OK();
     }
     RETURN_IF_ERROR(_apply_bitmap_index());
+    RETURN_IF_ERROR(_apply_ngram_index());
+    RETURN_IF_ERROR(_apply_s2_index());
 
     if (!_row_bitmap.isEmpty() &&
         (_opts.conditions != nullptr || _opts.delete_conditions.size() > 0)) {
@@ -287,6 +337,31 @@ Status SegmentIterator::_get_row_ranges_from_conditions(RowRanges* condition_row
     return Status::OK();
 }
 
+Status SegmentIterator::_get_row_ranges_by_block_filters() {
+    if (!_has_block_filters() || _row_bitmap.isEmpty()) {
+        return Status::OK();
+    }
+    for (auto filter : *_opts.block_filters) {
+        const Conditions* conditions = filter->zone_map_conditions();
+        if (conditions == nullptr) {
+            continue;
+        }
+        for (auto& column_condition : conditions->columns()) {
+            ColumnId cid = column_condition.first;
+            if (_schema.column(cid) == nullptr) {
+                continue;
+            }
+            RowRanges column_row_ranges = RowRanges::create_single(num_rows());
+            RETURN_IF_ERROR(_column_iterators[cid]->get_row_ranges_by_zone_map(
+                    column_condition.second, nullptr, &column_row_ranges));
+            size_t pre_size = _row_bitmap.cardinality();
+            _row_bitmap &= RowRanges::ranges_to_roaring(column_row_ranges);
+            _opts.stats->rows_stats_filtered += (pre_size - _row_bitmap.cardinality());
+        }
+    }
+    return Status::OK();
+}
+
 // filter rows by evaluating column predicates using bitmap indexes.
 // upon return, predicates that've been evaluated by bitmap indexes are removed from _col_predicates.
 Status SegmentIterator::_apply_bitmap_index() {
@@ -294,16 +369,30 @@ Status SegmentIterator::_apply_bitmap_index() {
     size_t input_rows = _row_bitmap.cardinality();
     std::vector<ColumnPredicate*> remaining_predicates;
 
+    // range predicates of a column are served together by the union of the bitmaps of
+    // the values in the intersection of their ranges
+    std::map<ColumnId, std::vector<ColumnPredicate*>> range_predicates;
     for (auto pred : _col_predicates) {
-        if (_bitmap_index_iterators[pred->column_id()] == nullptr) {
+        if (_bitmap_index_iterators[pred->column_id()] == nullptr ||
+            !pred->can_use_bitmap_index()) {
             // no bitmap index for this column
             remaining_predicates.push_back(pred);
-        } else {
+        } else if (pred->is_range_predicate()) {
+            range_predicates[pred->column_id()].push_back(pred);
+        } else if (!_row_bitmap.isEmpty()) {
             RETURN_IF_ERROR(pred->evaluate(_schema, _bitmap_index_iterators, _segment->num_rows(),
                                            &_row_bitmap));
-            if (_row_bitmap.isEmpty()) {
-                break; // all rows have been pruned, no need to process further predicates
-            }
+        }
+    }
+    for (auto& it : range_predicates) {
+        if (_row_bitmap.isEmpty()) {
+            break; // all rows have been pruned, no need to process further predicates
+        }
+        bool applied = false;
+        RETURN_IF_ERROR(_apply_bitmap_index_range(it.first, it.second, &applied));
+        if (!applied) {
+            remaining_predicates.insert(remaining_predicates.end(), it.second.begin(),
+                                        it.second.end());
         }
     }
     _col_predicates = std::move(remaining_predicates);
@@ -311,6 +400,81 @@ Status SegmentIterator::_apply_bitmap_index() {
     return Status::OK();
 }
 
+Status SegmentIterator::_apply_bitmap_index_range(ColumnId cid,
+                                                   const std::vector<ColumnPredicate*>& predicates,
+                                                   bool* applied) {
+    BitmapIndexIterator* iterator = _bitmap_index_iterators[cid];
+    // the null bitmap is stored after the bitmaps of all values
+    rowid_t num_values = iterator->bitmap_nums() - (iterator->has_null_bitmap() ? 1 : 0);
+    rowid_t from = 0;
+    rowid_t to = num_values;
+    for (auto pred : predicates) {
+        RETURN_IF_ERROR(pred->narrow_bitmap_index_range(iterator, &from, &to));
+    }
+    if (from >= to) {
+        // no value satisfies the predicates, null doesn't either
+        _row_bitmap = Roaring();
+        *applied = true;
+        return Status::OK();
+    }
+    // Rows of a wide range are read faster by scanning the column than by the union of
+    // many bitmaps, and few of them are pruned. The share of distinct values in the range
+    // is taken as the share of rows.
+    if (to - from > num_values * config::bitmap_index_range_max_selectivity) {
+        *applied = false;
+        return Status::OK();
+    }
+    Roaring roaring;
+    RETURN_IF_ERROR(iterator->read_union_bitmap(from, to, &roaring));
+    _row_bitmap &= roaring;
+    *applied = true;
+    return Status::OK();
+}
+
+Status SegmentIterator::_apply_ngram_index() {
+    if (_row_bitmap.isEmpty()) {
+        return Status::OK();
+    }
+    SCOPED_RAW_TIMER(&_opts.stats->ngram_index_filter_timer);
+    size_t input_rows = _row_bitmap.cardinality();
+    for (auto pred : _col_predicates) {
+        NGramIndexIterator* iter = nullptr;
+        RETURN_IF_ERROR(_segment->new_ngram_index_iterator(pred->column_id(), &iter));
+        if (iter == nullptr) {
+            continue;
+        }
+        std::unique_ptr<NGramIndexIterator> iter_holder(iter);
+        RETURN_IF_ERROR(pred->evaluate_ngram_index(iter, &_row_bitmap));
+        if (_row_bitmap.isEmpty()) {
+            break;
+        }
+    }
+    _opts.stats->rows_ngram_index_filtered += (input_rows - _row_bitmap.cardinality());
+    return Status::OK();
+}
+
+Status SegmentIterator::_apply_s2_index() {
+    if (_row_bitmap.isEmpty()) {
+        return Status::OK();
+    }
+    SCOPED_RAW_TIMER(&_opts.stats->s2_index_filter_timer);
+    size_t input_rows = _row_bitmap.cardinality();
+    for (auto pred : _col_predicates) {
+        S2IndexIterator* iter = nullptr;
+        RETURN_IF_ERROR(_segment->new_s2_index_iterator(pred->column_id(), &iter));
+        if (iter == nullptr) {
+            continue;
+        }
+        std::unique_ptr<S2IndexIterator> iter_holder(iter);
+        RETURN_IF_ERROR(pred->evaluate_s2_index(iter, &_row_bitmap));
+        if (_row_bitmap.isEmpty()) {
+            break;
+        }
+    }
+    _opts.stats->rows_s2_index_filtered += (input_rows - _row_bitmap.cardinality());
+    return Status::OK();
+}
+
 Status SegmentIterator::_init_return_column_iterators() {
     if (_cur_rowid >= num_rows()) {
         return Status::OK();
@@ -427,12 +591,36 @@ Status SegmentIterator::_seek_and_peek(rowid_t rowid) {
     return Status::OK();
 }
 
+void SegmentIterator::_init_delete_conditions() {
+    std::set<ColumnId> cids;
+    for (auto delete_condition : _opts.delete_conditions) {
+        for (auto cid : delete_condition->delete_condition_columns()) {
+            cids.insert(cid);
+        }
+    }
+    for (auto cid : cids) {
+        if (_schema.column(cid) == nullptr) {
+            // can't evaluate on blocks, the caller checks the rows one by one
+            return;
+        }
+    }
+    _apply_delete_conditions = !_opts.delete_conditions.empty();
+    _delete_condition_columns.assign(cids.cbegin(), cids.cend());
+}
+
 void SegmentIterator::_init_lazy_materialization() {
-    if (!_col_predicates.empty()) {
+    if (!_col_predicates.empty() || _has_block_filters() || _apply_delete_conditions) {
         std::set<ColumnId> predicate_columns;
         for (auto predicate : _col_predicates) {
             predicate_columns.insert(predicate->column_id());
         }
+        predicate_columns.insert(_delete_condition_columns.begin(),
+                                 _delete_condition_columns.end());
+        if (_has_block_filters()) {
+            for (auto filter : *_opts.block_filters) {
+                predicate_columns.insert(filter->column_ids().begin(), filter->column_ids().end());
+            }
+        }
         // when all return columns have predicates, disable lazy materialization to avoid its overhead
         if (_schema.column_ids().size() > predicate_columns.size()) {
             _lazy_materialization_read = true;
@@ -462,7 +650,6 @@ Status SegmentIterator::_read_columns(const std::vector<ColumnId>& column_ids, R
         ColumnBlockView dst(&column_block, row_offset);
         size_t rows_read = nrows;
         RETURN_IF_ERROR(_column_iterators[cid]->next_batch(&rows_read, &dst));
-        block->set_delete_state(column_block.delete_state());
         DCHECK_EQ(nrows, rows_read);
     }
     return Status::OK();
@@ -483,6 +670,9 @@ Status SegmentIterator::next_batch(RowBlockV2* block) {
     _block_rowids.resize(nrows_read_limit);
     const auto& read_columns =
             _lazy_materialization_read ? _predicate_columns : block->schema()->column_ids();
+    for (auto cid : read_columns) {
+        block->column_block(cid).vector_batch()->reset_dict();
+    }
 
     // phase 1: read rows selected by various index (indicated by _row_bitmap) into block
     // when using lazy-materialization-read, only columns with predicates are read
@@ -518,8 +708,9 @@ Status SegmentIterator::next_batch(RowBlockV2* block) {
     _opts.stats->raw_rows_read += nrows_read;
     _opts.stats->blocks_load += 1;
 
-    // phase 2: run vectorization evaluation on remaining predicates to prune rows.
-    // block's selection vector will be set to indicate which rows have passed predicates.
+    // phase 2: run vectorization evaluation on remaining predicates, delete conditions and
+    // then block filters to prune rows. block's selection vector will be set to indicate
+    // which rows have passed.
     // TODO(hkp): optimize column predicate to check column block once for one column
     if (!_col_predicates.empty()) {
         // init selection position index
@@ -534,6 +725,34 @@ Status SegmentIterator::next_batch(RowBlockV2* block) {
         block->set_num_rows(selected_size);
         _opts.stats->rows_vec_cond_filtered += original_size - selected_size;
     }
+    if (_apply_delete_conditions) {
+        uint16_t selected_size = block->selected_size();
+        uint16_t original_size = selected_size;
+        SCOPED_RAW_TIMER(&_opts.stats->vec_cond_ns);
+        for (auto delete_condition : _opts.delete_conditions) {
+            delete_condition->delete_conditions_eval(*block, block->selection_vector(),
+                                                     &selected_size);
+        }
+        block->set_selected_size(selected_size);
+        block->set_num_rows(selected_size);
+        _opts.stats->rows_del_filtered += original_size - selected_size;
+    } else if (!_opts.delete_conditions.empty()) {
+        block->set_delete_state(DEL_PARTIAL_SATISFIED);
+    }
+    if (_has_block_filters() && block->selected_size() > 0) {
+        uint16_t selected_size = block->selected_size();
+        uint16_t original_size = selected_size;
+        SCOPED_RAW_TIMER(&_opts.stats->block_filter_ns);
+        for (auto filter : *_opts.block_filters) {
+            RETURN_IF_ERROR(filter->evaluate(*block, block->selection_vector(), &selected_size));
+            if (selected_size == 0) {
+                break;
+            }
+        }
+        block->set_selected_size(selected_size);
+        block->set_num_rows(selected_size);
+        _opts.stats->rows_block_filter_filtered += original_size - selected_size;
+    }
 
     // phase 3: read non-predicate columns of rows that have passed predicates
     if (_lazy_materialization_read) {
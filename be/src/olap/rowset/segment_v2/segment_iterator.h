@@ -28,6 +28,7 @@
 #include "olap/rowset/segment_v2/segment.h"
 #include "olap/schema.h"
 #include "util/file_cache.h"
+#include "util/trace.h"
 
 namespace doris {
 
@@ -58,11 +59,17 @@ public:
 private:
     Status _init();
 
+    bool _has_block_filters() const {
+        return _opts.block_filters != nullptr && !_opts.block_filters->empty();
+    }
+
     Status _init_return_column_iterators();
     Status _init_bitmap_index_iterators();
 
     // calculate row ranges that fall into requested key ranges using short key index
     Status _get_row_ranges_by_keys();
+    // remove rows replaced by later loads of a merge-on-write tablet from _row_bitmap
+    void _apply_delete_bitmap();
     Status _prepare_seek(const StorageReadOptions::KeyRange& key_range);
     Status _lookup_ordinal(const RowCursor& key, bool is_include, rowid_t upper_bound,
                            rowid_t* rowid);
@@ -71,8 +78,22 @@ private:
     // calculate row ranges that satisfy requested column conditions using various column index
     Status _get_row_ranges_by_column_conditions();
     Status _get_row_ranges_from_conditions(RowRanges* condition_row_ranges);
+    // remove pages rejected by the zone map conditions of block filters from _row_bitmap
+    Status _get_row_ranges_by_block_filters();
     Status _apply_bitmap_index();
-
+    // Apply the range predicates of column `cid` by its bitmap index, `*applied` is set to
+    // false if the range is too wide to use the index.
+    Status _apply_bitmap_index_range(ColumnId cid, const std::vector<ColumnPredicate*>& predicates,
+                                     bool* applied);
+    // remove rows not satisfying the predicates on columns with n-gram index, the
+    // predicates are kept as the rows left may not satisfy them either
+    Status _apply_ngram_index();
+    // remove rows whose points are in no cell covering the shapes of the predicates on
+    // columns with S2 index, the predicates are kept like those of n-gram index
+    Status _apply_s2_index();
+
+    // decide whether delete conditions are evaluated on the blocks read
+    void _init_delete_conditions();
     void _init_lazy_materialization();
 
     uint32_t segment_id() const { return _segment->id(); }
@@ -114,10 +135,18 @@ private:
 
     // the actual init process is delayed to the first call to next_batch()
     bool _inited;
+    // records the index loading of the segment, a child of the trace of the thread
+    // creating the iterator, nullptr if that thread isn't traced
+    scoped_refptr<Trace> _trace;
 
     StorageReadOptions _opts;
     // make a copy of `_opts.column_predicates` in order to make local changes
     std::vector<ColumnPredicate*> _col_predicates;
+    // whether rows meeting `_opts.delete_conditions` are removed from the blocks read,
+    // otherwise they are left to the caller, see RowBlockV2::delete_state()
+    bool _apply_delete_conditions = false;
+    // columns read by `_opts.delete_conditions`
+    std::vector<ColumnId> _delete_condition_columns;
 
     // row schema of the key to seek
     // only used in `_get_row_ranges_by_keys`
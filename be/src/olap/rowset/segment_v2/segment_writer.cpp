@@ -17,17 +17,25 @@
 
 #include "olap/rowset/segment_v2/segment_writer.h"
 
+#include <algorithm>
+
+#include "common/config.h"
 #include "common/logging.h" // LOG
 #include "env/env.h"        // Env
+#include "gutil/strings/substitute.h"
 #include "olap/fs/block_manager.h"
 #include "olap/row.h"                             // ContiguousRow
+#include "olap/row_block2.h"                      // RowBlockRow
 #include "olap/row_cursor.h"                      // RowCursor
 #include "olap/rowset/segment_v2/column_writer.h" // ColumnWriter
 #include "olap/rowset/segment_v2/page_io.h"
+#include "olap/rowset/segment_v2/primary_key_index.h"
+#include "olap/rowset/segment_v2/s2_index_writer.h"
 #include "olap/schema.h"
 #include "olap/short_key_index.h"
 #include "util/crc32c.h"
 #include "util/faststring.h"
+#include "util/threadpool.h"
 
 namespace doris {
 namespace segment_v2 {
@@ -51,7 +59,7 @@ void SegmentWriter::_init_column_meta(ColumnMetaPB* meta, uint32_t* column_id,
     meta->set_type(column.type());
     meta->set_length(column.length());
     meta->set_encoding(DEFAULT_ENCODING);
-    meta->set_compression(LZ4F);
+    meta->set_compression(_tablet_schema->compression_type(column));
     meta->set_is_nullable(column.is_nullable());
     if (column.get_subtype_count() > 0) {
         for (uint32_t i = 0; i < column.get_subtype_count(); ++i) {
@@ -61,13 +69,32 @@ void SegmentWriter::_init_column_meta(ColumnMetaPB* meta, uint32_t* column_id,
 }
 
 Status SegmentWriter::init(uint32_t write_mbytes_per_sec __attribute__((unused))) {
-    uint32_t column_id = 0;
-    _column_writers.reserve(_tablet_schema->columns().size());
-    for (auto& column : _tablet_schema->columns()) {
-        ColumnWriterOptions opts;
-        opts.meta = _footer.add_columns();
+    std::vector<uint32_t> column_ids(_tablet_schema->num_columns());
+    for (uint32_t cid = 0; cid < column_ids.size(); ++cid) {
+        column_ids[cid] = cid;
+    }
+    return init(column_ids, true);
+}
 
-        _init_column_meta(opts.meta, &column_id, column);
+Status SegmentWriter::init(const std::vector<uint32_t>& column_ids, bool has_key) {
+    // column metas are kept in footer in the order of schema, whichever group is
+    // written first
+    if (_footer.columns_size() == 0) {
+        uint32_t column_id = 0;
+        for (auto& column : _tablet_schema->columns()) {
+            _init_column_meta(_footer.add_columns(), &column_id, column);
+        }
+    }
+    _column_writers.clear();
+    _column_writers.reserve(column_ids.size());
+    _column_ids = column_ids;
+    _has_key = has_key;
+    _num_rows_in_group = 0;
+    for (uint32_t cid : column_ids) {
+        const TabletColumn& column = _tablet_schema->column(cid);
+        ColumnWriterOptions opts;
+        opts.meta = _footer.mutable_columns(cid);
+        opts.compression_level = _tablet_schema->compression_level();
 
         // now we create zone map for key columns
         // and not support zone map for array type.
@@ -77,6 +104,13 @@ Status SegmentWriter::init(uint32_t write_mbytes_per_sec __attribute__((unused))
         }
         opts.need_bloom_filter = column.is_bf_column();
         opts.need_bitmap_index = column.has_bitmap_index();
+        opts.need_ngram_index = column.has_ngram_index();
+        opts.need_statistics = config::enable_column_statistics &&
+                               column.type() != FieldType::OLAP_FIELD_TYPE_ARRAY &&
+                               column.type() != FieldType::OLAP_FIELD_TYPE_HLL &&
+                               column.type() != FieldType::OLAP_FIELD_TYPE_OBJECT;
+        opts.adaptive_encoding = config::enable_adaptive_encoding &&
+                                 column.type() != FieldType::OLAP_FIELD_TYPE_ARRAY;
         if (column.type() == FieldType::OLAP_FIELD_TYPE_ARRAY) {
             if (opts.need_bloom_filter) {
                 return Status::NotSupported("Do not support bloom filter for array type");
@@ -84,6 +118,9 @@ Status SegmentWriter::init(uint32_t write_mbytes_per_sec __attribute__((unused))
             if (opts.need_bitmap_index) {
                 return Status::NotSupported("Do not support bitmap index for array type");
             }
+            if (opts.need_ngram_index) {
+                return Status::NotSupported("Do not support ngram index for array type");
+            }
         }
 
         std::unique_ptr<ColumnWriter> writer;
@@ -91,29 +128,180 @@ Status SegmentWriter::init(uint32_t write_mbytes_per_sec __attribute__((unused))
         RETURN_IF_ERROR(writer->init());
         _column_writers.push_back(std::move(writer));
     }
-    _index_builder.reset(new ShortKeyIndexBuilder(_segment_id, _opts.num_rows_per_block));
+    RETURN_IF_ERROR(_init_s2_index_builders());
+    if (!has_key) {
+        return Status::OK();
+    }
+    if (config::short_key_index_all_key_columns) {
+        _num_short_key_columns = _tablet_schema->num_key_columns();
+        _index_builder.reset(new ShortKeyIndexBuilder(_segment_id, _opts.num_rows_per_block,
+                                                      _num_short_key_columns));
+    } else {
+        _num_short_key_columns = _tablet_schema->num_short_key_columns();
+        _index_builder.reset(new ShortKeyIndexBuilder(_segment_id, _opts.num_rows_per_block));
+    }
+    if (_tablet_schema->enable_unique_key_merge_on_write()) {
+        _primary_key_index_builder.reset(new PrimaryKeyIndexBuilder(_wblock));
+        RETURN_IF_ERROR(_primary_key_index_builder->init());
+    }
+    return Status::OK();
+}
+
+Status SegmentWriter::_init_s2_index_builders() {
+    _s2_index_builders.clear();
+    for (uint32_t lng_cid : _column_ids) {
+        const TabletColumn& lng_column = _tablet_schema->column(lng_cid);
+        if (!lng_column.has_s2_index()) {
+            continue;
+        }
+        uint32_t lat_cid = 0;
+        while (lat_cid < _tablet_schema->num_columns() &&
+               _tablet_schema->column(lat_cid).unique_id() !=
+                       lng_column.s2_index_lat_unique_id()) {
+            ++lat_cid;
+        }
+        // no S2 index if the latitude column is dropped or written by another group
+        if (std::find(_column_ids.begin(), _column_ids.end(), lat_cid) == _column_ids.end()) {
+            continue;
+        }
+        if (lng_column.type() != OLAP_FIELD_TYPE_DOUBLE ||
+            _tablet_schema->column(lat_cid).type() != OLAP_FIELD_TYPE_DOUBLE) {
+            return Status::NotSupported("S2 index needs DOUBLE longitude and latitude columns");
+        }
+        S2IndexBuilder builder;
+        builder.lng_cid = lng_cid;
+        builder.lat_cid = lat_cid;
+        RETURN_IF_ERROR(S2IndexWriter::create(config::s2_index_cell_level,
+                                              lng_column.s2_index_lat_unique_id(),
+                                              &builder.writer));
+        _s2_index_builders.push_back(std::move(builder));
+    }
     return Status::OK();
 }
 
 template <typename RowType>
-Status SegmentWriter::append_row(const RowType& row) {
-    for (size_t cid = 0; cid < _column_writers.size(); ++cid) {
-        auto cell = row.cell(cid);
-        RETURN_IF_ERROR(_column_writers[cid]->append(cell));
+void SegmentWriter::_add_s2_points(const RowType& row) {
+    for (auto& builder : _s2_index_builders) {
+        auto lng = row.cell(builder.lng_cid);
+        auto lat = row.cell(builder.lat_cid);
+        builder.writer->add_point(
+                lng.is_null() ? nullptr : reinterpret_cast<const double*>(lng.cell_ptr()),
+                lat.is_null() ? nullptr : reinterpret_cast<const double*>(lat.cell_ptr()));
     }
+}
 
+template <typename RowType>
+Status SegmentWriter::_append_key(const RowType& row) {
     // At the begin of one block, so add a short key index entry
     if ((_row_count % _opts.num_rows_per_block) == 0) {
         std::string encoded_key;
-        encode_key(&encoded_key, row, _tablet_schema->num_short_key_columns());
+        encode_key(&encoded_key, row, _num_short_key_columns);
         RETURN_IF_ERROR(_index_builder->add_item(encoded_key));
     }
+    if (_primary_key_index_builder != nullptr) {
+        std::string primary_key;
+        encode_primary_key(row, _tablet_schema->num_key_columns(), &primary_key);
+        RETURN_IF_ERROR(_primary_key_index_builder->add_item(primary_key));
+    }
     ++_row_count;
     return Status::OK();
 }
 
+template <typename RowType>
+Status SegmentWriter::append_row(const RowType& row) {
+    for (size_t i = 0; i < _column_writers.size(); ++i) {
+        auto cell = row.cell(_column_ids[i]);
+        RETURN_IF_ERROR(_column_writers[i]->append(cell));
+    }
+    _add_s2_points(row);
+    ++_num_rows_in_group;
+    if (!_has_key) {
+        return Status::OK();
+    }
+    return _append_key(row);
+}
+
+Status SegmentWriter::append_rows(const ContiguousRow* rows, size_t num_rows) {
+    RETURN_IF_ERROR(_for_each_column([this, rows, num_rows](size_t i) -> Status {
+        for (size_t j = 0; j < num_rows; ++j) {
+            RETURN_IF_ERROR(_column_writers[i]->append(rows[j].cell(_column_ids[i])));
+        }
+        return Status::OK();
+    }));
+    for (size_t j = 0; j < num_rows && !_s2_index_builders.empty(); ++j) {
+        _add_s2_points(rows[j]);
+    }
+    _num_rows_in_group += num_rows;
+    if (!_has_key) {
+        return Status::OK();
+    }
+    for (size_t j = 0; j < num_rows; ++j) {
+        RETURN_IF_ERROR(_append_key(rows[j]));
+    }
+    return Status::OK();
+}
+
+Status SegmentWriter::_for_each_column(const std::function<Status(size_t)>& fn) {
+    if (_opts.column_encode_pool == nullptr || _column_writers.size() < 2) {
+        for (size_t i = 0; i < _column_writers.size(); ++i) {
+            RETURN_IF_ERROR(fn(i));
+        }
+        return Status::OK();
+    }
+    // the column writers share nothing until their pages are written to the block
+    std::vector<Status> statuses(_column_writers.size());
+    std::unique_ptr<ThreadPoolToken> token =
+            _opts.column_encode_pool->new_token(ThreadPool::ExecutionMode::CONCURRENT);
+    for (size_t i = 0; i < _column_writers.size(); ++i) {
+        if (!token->submit_func([&fn, &statuses, i]() { statuses[i] = fn(i); }).ok()) {
+            statuses[i] = fn(i);
+        }
+    }
+    token->wait();
+    for (const auto& status : statuses) {
+        RETURN_IF_ERROR(status);
+    }
+    return Status::OK();
+}
+
+Status SegmentWriter::append_block(const RowBlockV2& block, size_t row_pos, size_t num_rows) {
+    for (size_t i = 0; i < _column_writers.size(); ++i) {
+        ColumnBlock column = block.column_block(_column_ids[i]);
+        const uint8_t* data = column.cell_ptr(row_pos);
+        if (_column_writers[i]->is_nullable()) {
+            // nulls of a column block are bytes, while column writer takes a bitmap
+            _null_bitmap.assign(BitmapSize(num_rows), 0);
+            for (size_t j = 0; j < num_rows; ++j) {
+                BitmapChange(_null_bitmap.data(), j, column.is_null(row_pos + j));
+            }
+            RETURN_IF_ERROR(
+                    _column_writers[i]->append_nullable(_null_bitmap.data(), data, num_rows));
+        } else {
+            RETURN_IF_ERROR(_column_writers[i]->append_not_nulls(data, num_rows));
+        }
+    }
+    for (auto& builder : _s2_index_builders) {
+        ColumnBlock lng = block.column_block(builder.lng_cid);
+        ColumnBlock lat = block.column_block(builder.lat_cid);
+        for (size_t j = row_pos; j < row_pos + num_rows; ++j) {
+            builder.writer->add_point(
+                    lng.is_null(j) ? nullptr : reinterpret_cast<const double*>(lng.cell_ptr(j)),
+                    lat.is_null(j) ? nullptr : reinterpret_cast<const double*>(lat.cell_ptr(j)));
+        }
+    }
+    _num_rows_in_group += num_rows;
+    if (!_has_key) {
+        return Status::OK();
+    }
+    for (size_t j = 0; j < num_rows; ++j) {
+        RETURN_IF_ERROR(_append_key(block.row(row_pos + j)));
+    }
+    return Status::OK();
+}
+
 template Status SegmentWriter::append_row(const RowCursor& row);
 template Status SegmentWriter::append_row(const ContiguousRow& row);
+template Status SegmentWriter::append_row(const RowBlockRow& row);
 
 // TODO(lingbin): Currently this function does not include the size of various indexes,
 // We should make this more precise.
@@ -125,22 +313,52 @@ uint64_t SegmentWriter::estimate_segment_size() {
     for (auto& column_writer : _column_writers) {
         size += column_writer->estimate_buffer_size();
     }
-    size += _index_builder->size();
+    for (auto& builder : _s2_index_builders) {
+        size += builder.writer->size();
+    }
+    if (_index_builder != nullptr) {
+        size += _index_builder->size();
+    }
+    if (_primary_key_index_builder != nullptr) {
+        size += _primary_key_index_builder->size();
+    }
     return size;
 }
 
 Status SegmentWriter::finalize(uint64_t* segment_file_size, uint64_t* index_size) {
-    for (auto& column_writer : _column_writers) {
-        RETURN_IF_ERROR(column_writer->finish());
+    RETURN_IF_ERROR(finalize_columns(index_size));
+    return finalize_footer(segment_file_size);
+}
+
+Status SegmentWriter::finalize_columns(uint64_t* index_size) {
+    if (!_has_key && _num_rows_in_group != _row_count) {
+        return Status::InternalError(strings::Substitute(
+                "value columns have $0 rows, but key columns have $1 rows in segment $2",
+                _num_rows_in_group, _row_count, _segment_id));
     }
+    // the last pages of the columns are compressed by finish()
+    RETURN_IF_ERROR(_for_each_column([this](size_t i) { return _column_writers[i]->finish(); }));
     RETURN_IF_ERROR(_write_data());
     uint64_t index_offset = _wblock->bytes_appended();
     RETURN_IF_ERROR(_write_ordinal_index());
     RETURN_IF_ERROR(_write_zone_map());
     RETURN_IF_ERROR(_write_bitmap_index());
     RETURN_IF_ERROR(_write_bloom_filter_index());
-    RETURN_IF_ERROR(_write_short_key_index());
+    RETURN_IF_ERROR(_write_ngram_index());
+    RETURN_IF_ERROR(_write_statistics_index());
+    RETURN_IF_ERROR(_write_s2_index());
+    if (_has_key) {
+        RETURN_IF_ERROR(_write_short_key_index());
+        RETURN_IF_ERROR(_write_primary_key_index());
+    }
     *index_size = _wblock->bytes_appended() - index_offset;
+    // release the memory of pages of this group
+    _column_writers.clear();
+    _s2_index_builders.clear();
+    return Status::OK();
+}
+
+Status SegmentWriter::finalize_footer(uint64_t* segment_file_size) {
     RETURN_IF_ERROR(_write_footer());
     RETURN_IF_ERROR(_wblock->finalize());
     *segment_file_size = _wblock->bytes_appended();
@@ -184,6 +402,28 @@ Status SegmentWriter::_write_bloom_filter_index() {
     return Status::OK();
 }
 
+Status SegmentWriter::_write_ngram_index() {
+    for (auto& column_writer : _column_writers) {
+        RETURN_IF_ERROR(column_writer->write_ngram_index());
+    }
+    return Status::OK();
+}
+
+Status SegmentWriter::_write_statistics_index() {
+    for (auto& column_writer : _column_writers) {
+        RETURN_IF_ERROR(column_writer->write_statistics_index());
+    }
+    return Status::OK();
+}
+
+Status SegmentWriter::_write_s2_index() {
+    for (auto& builder : _s2_index_builders) {
+        RETURN_IF_ERROR(builder.writer->finish(
+                _wblock, _footer.mutable_columns(builder.lng_cid)->add_indexes()));
+    }
+    return Status::OK();
+}
+
 Status SegmentWriter::_write_short_key_index() {
     std::vector<Slice> body;
     PageFooterPB footer;
@@ -195,12 +435,26 @@ Status SegmentWriter::_write_short_key_index() {
     return Status::OK();
 }
 
+Status SegmentWriter::_write_primary_key_index() {
+    if (_primary_key_index_builder == nullptr) {
+        return Status::OK();
+    }
+    DCHECK_EQ(_row_count, _primary_key_index_builder->num_rows());
+    return _primary_key_index_builder->finalize(_footer.mutable_primary_key_index());
+}
+
 Status SegmentWriter::_write_footer() {
     _footer.set_num_rows(_row_count);
+    if (_tablet_schema->is_clustered()) {
+        _footer.set_clustered(true);
+    }
+    return write_footer(_wblock, _footer);
+}
 
+Status SegmentWriter::write_footer(fs::WritableBlock* wblock, const SegmentFooterPB& footer) {
     // Footer := SegmentFooterPB, FooterPBSize(4), FooterPBChecksum(4), MagicNumber(4)
     std::string footer_buf;
-    if (!_footer.SerializeToString(&footer_buf)) {
+    if (!footer.SerializeToString(&footer_buf)) {
         return Status::InternalError("failed to serialize segment footer");
     }
 
@@ -215,12 +469,7 @@ Status SegmentWriter::_write_footer() {
     fixed_buf.append(k_segment_magic, k_segment_magic_length);
 
     std::vector<Slice> slices{footer_buf, fixed_buf};
-    return _write_raw_data(slices);
-}
-
-Status SegmentWriter::_write_raw_data(const std::vector<Slice>& slices) {
-    RETURN_IF_ERROR(_wblock->appendv(&slices[0], slices.size()));
-    return Status::OK();
+    return wblock->appendv(&slices[0], slices.size());
 }
 
 } // namespace segment_v2
@@ -18,6 +18,7 @@
 #pragma once
 
 #include <cstdint>
+#include <functional>
 #include <memory> // unique_ptr
 #include <string>
 #include <vector>
@@ -29,7 +30,10 @@
 namespace doris {
 
 class RowBlock;
+class RowBlockV2;
 class RowCursor;
+class ThreadPool;
+struct ContiguousRow;
 class TabletSchema;
 class TabletColumn;
 class ShortKeyIndexBuilder;
@@ -41,12 +45,17 @@ class WritableBlock;
 namespace segment_v2 {
 
 class ColumnWriter;
+class PrimaryKeyIndexBuilder;
+class S2IndexWriter;
 
 extern const char* k_segment_magic;
 extern const uint32_t k_segment_magic_length;
 
 struct SegmentWriterOptions {
     uint32_t num_rows_per_block = 1024;
+    // If not null, append_rows() and finalize encode and compress the columns in parallel
+    // on it.
+    ThreadPool* column_encode_pool = nullptr;
 };
 
 class SegmentWriter {
@@ -57,25 +66,69 @@ public:
 
     Status init(uint32_t write_mbytes_per_sec);
 
+    // Init the writer to write the columns `column_ids' only, which is used by vertical
+    // compaction to write a segment group by group of columns:
+    //   init(key_column_ids, true) -> append_row()... -> finalize_columns()
+    //   init(value_column_ids, false) -> append_row()... -> finalize_columns()
+    //   ... -> finalize_footer()
+    // The key group must be written first, and every value group must have the same
+    // rows as it. Short key index and primary key index are built by the key group.
+    Status init(const std::vector<uint32_t>& column_ids, bool has_key);
+
     template <typename RowType>
     Status append_row(const RowType& row);
 
+    // Append rows [row_pos, row_pos + num_rows) of `block`, the data of every column is
+    // appended to its column writer at once.
+    Status append_block(const RowBlockV2& block, size_t row_pos, size_t num_rows);
+
+    // Append `num_rows' rows, every column of them at once, so that the columns can be
+    // appended in parallel on column_encode_pool.
+    Status append_rows(const ContiguousRow* rows, size_t num_rows);
+
     uint64_t estimate_segment_size();
 
     uint32_t num_rows_written() { return _row_count; }
 
+    // rows appended since the last init()
+    uint32_t num_rows_in_group() const { return _num_rows_in_group; }
+
     Status finalize(uint64_t* segment_file_size, uint64_t* index_size);
 
+    // Write data and indexes of the columns of current group, `index_size' is the
+    // size of indexes of this group.
+    Status finalize_columns(uint64_t* index_size);
+
+    Status finalize_footer(uint64_t* segment_file_size);
+
+    // Append `footer' to `wblock' in the format of segment file footer, which is parsed
+    // by Segment::parse_footer().
+    static Status write_footer(fs::WritableBlock* wblock, const SegmentFooterPB& footer);
+
 private:
     DISALLOW_COPY_AND_ASSIGN(SegmentWriter);
+    // Add the index entries of the keys of `row', the next row of the key group.
+    template <typename RowType>
+    Status _append_key(const RowType& row);
+    // Create the builders of the S2 indexes whose columns are both in current group
+    Status _init_s2_index_builders();
+    // Add the points of `row' to the S2 indexes of current group
+    template <typename RowType>
+    void _add_s2_points(const RowType& row);
+    // Call `fn' with the index of every column writer, in parallel on column_encode_pool
+    // if it's set, and return the first error.
+    Status _for_each_column(const std::function<Status(size_t)>& fn);
     Status _write_data();
     Status _write_ordinal_index();
     Status _write_zone_map();
     Status _write_bitmap_index();
     Status _write_bloom_filter_index();
+    Status _write_ngram_index();
+    Status _write_statistics_index();
+    Status _write_s2_index();
     Status _write_short_key_index();
+    Status _write_primary_key_index();
     Status _write_footer();
-    Status _write_raw_data(const std::vector<Slice>& slices);
     void _init_column_meta(ColumnMetaPB* meta, uint32_t* column_id, const TabletColumn& column);
 
 private:
@@ -88,8 +141,29 @@ private:
 
     SegmentFooterPB _footer;
     std::unique_ptr<ShortKeyIndexBuilder> _index_builder;
+    // the number of key columns the items of _index_builder are encoded with
+    size_t _num_short_key_columns = 0;
+    // not null iff the tablet is merge-on-write
+    std::unique_ptr<PrimaryKeyIndexBuilder> _primary_key_index_builder;
     std::vector<std::unique_ptr<ColumnWriter>> _column_writers;
+    // column id in _tablet_schema of each of _column_writers
+    std::vector<uint32_t> _column_ids;
+    bool _has_key = true;
+    // rows of the key group
     uint32_t _row_count = 0;
+    // rows of current group
+    uint32_t _num_rows_in_group = 0;
+    // null bitmap of a column in append_block()
+    std::vector<uint8_t> _null_bitmap;
+
+    struct S2IndexBuilder {
+        // column ids in _tablet_schema of the longitude and latitude columns
+        uint32_t lng_cid;
+        uint32_t lat_cid;
+        std::unique_ptr<S2IndexWriter> writer;
+    };
+    // the S2 indexes of current group
+    std::vector<S2IndexBuilder> _s2_index_builders;
 };
 
 } // namespace segment_v2
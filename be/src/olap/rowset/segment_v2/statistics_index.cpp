@@ -0,0 +1,125 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/rowset/segment_v2/statistics_index.h"
+
+#include <algorithm>
+
+#include "olap/column_block.h"
+#include "olap/field.h"
+#include "olap/fs/block_manager.h"
+#include "olap/hll.h"
+#include "olap/rowset/segment_v2/encoding_info.h"
+#include "olap/rowset/segment_v2/indexed_column_reader.h"
+#include "olap/rowset/segment_v2/indexed_column_writer.h"
+#include "olap/types.h"
+#include "runtime/mem_pool.h"
+#include "runtime/mem_tracker.h"
+#include "util/hash_util.hpp"
+
+namespace doris {
+namespace segment_v2 {
+
+// values are hashed in batches of this size before being added to the HyperLogLog
+static const size_t kHashBatchSize = 256;
+
+StatisticsIndexWriter::StatisticsIndexWriter(Field* field)
+        : _field(field), _ndv_sketch(new HyperLogLog()) {}
+
+StatisticsIndexWriter::~StatisticsIndexWriter() = default;
+
+uint64_t StatisticsIndexWriter::hash_value(const Field* field, const void* value) {
+    switch (field->type()) {
+    case OLAP_FIELD_TYPE_CHAR:
+    case OLAP_FIELD_TYPE_VARCHAR: {
+        const Slice* slice = reinterpret_cast<const Slice*>(value);
+        return HashUtil::murmur_hash64A(slice->data, slice->size, HashUtil::MURMUR_SEED);
+    }
+    default:
+        return HashUtil::murmur_hash64A(value, field->size(), HashUtil::MURMUR_SEED);
+    }
+}
+
+void StatisticsIndexWriter::add_values(const void* values, size_t count) {
+    const char* vals = reinterpret_cast<const char*>(values);
+    uint64_t hashes[kHashBatchSize];
+    while (count > 0) {
+        size_t num = std::min(count, kHashBatchSize);
+        for (size_t i = 0; i < num; ++i) {
+            hashes[i] = hash_value(_field, vals);
+            vals += _field->size();
+        }
+        _ndv_sketch->update(hashes, num);
+        count -= num;
+    }
+}
+
+uint64_t StatisticsIndexWriter::size() const {
+    return _ndv_sketch->max_serialized_size();
+}
+
+Status StatisticsIndexWriter::finish(fs::WritableBlock* wblock, ColumnIndexMetaPB* index_meta) {
+    index_meta->set_type(STATISTICS_INDEX);
+    StatisticsIndexPB* meta = index_meta->mutable_statistics_index();
+    meta->set_null_count(_null_count);
+
+    std::string ndv_sketch;
+    ndv_sketch.resize(_ndv_sketch->max_serialized_size());
+    ndv_sketch.resize(_ndv_sketch->serialize(reinterpret_cast<uint8_t*>(&ndv_sketch[0])));
+
+    const TypeInfo* typeinfo = get_type_info(OLAP_FIELD_TYPE_OBJECT);
+    IndexedColumnWriterOptions options;
+    options.write_ordinal_index = true;
+    options.write_value_index = false;
+    options.encoding = EncodingInfo::get_default_encoding(typeinfo, false);
+    options.compression = LZ4F;
+
+    IndexedColumnWriter writer(options, typeinfo, wblock);
+    RETURN_IF_ERROR(writer.init());
+    Slice value(ndv_sketch);
+    RETURN_IF_ERROR(writer.add(&value));
+    return writer.finish(meta->mutable_ndv_sketch());
+}
+
+Status StatisticsIndexReader::read_ndv_sketch(bool use_page_cache, std::string* ndv_sketch) {
+    IndexedColumnReader reader(_file_name, _index_meta->ndv_sketch());
+    RETURN_IF_ERROR(reader.load(use_page_cache, false));
+    if (reader.num_values() != 1) {
+        return Status::Corruption("Bad statistics index: no ndv sketch");
+    }
+    IndexedColumnIterator iter(&reader);
+    auto tracker = std::make_shared<MemTracker>(-1, "temp in StatisticsIndexReader");
+    MemPool pool(tracker.get());
+    std::unique_ptr<ColumnVectorBatch> cvb;
+    RETURN_IF_ERROR(ColumnVectorBatch::create(1, false, reader.type_info(), nullptr, &cvb));
+    ColumnBlock block(cvb.get(), &pool);
+    ColumnBlockView column_block_view(&block);
+
+    RETURN_IF_ERROR(iter.seek_to_ordinal(0));
+    size_t num_read = 1;
+    RETURN_IF_ERROR(iter.next_batch(&num_read, &column_block_view));
+    DCHECK_EQ(1, num_read);
+    const Slice* value = reinterpret_cast<const Slice*>(cvb->data());
+    if (!HyperLogLog::is_valid(*value)) {
+        return Status::Corruption("Bad statistics index: invalid ndv sketch");
+    }
+    ndv_sketch->assign(value->data, value->size);
+    return Status::OK();
+}
+
+} // namespace segment_v2
+} // namespace doris
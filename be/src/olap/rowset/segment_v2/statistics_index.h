@@ -0,0 +1,84 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "common/status.h"
+#include "gen_cpp/segment_v2.pb.h"
+#include "gutil/macros.h"
+
+namespace doris {
+
+class Field;
+class HyperLogLog;
+
+namespace fs {
+class WritableBlock;
+}
+
+namespace segment_v2 {
+
+// Statistics index keeps the statistics of a column in a segment for the cost-based
+// planning of FE, which are merged with the ones of the other segments of a tablet,
+// see TabletColumnStatisticsCollector: the number of nulls and a HyperLogLog of the
+// hashes of the not-null values to estimate the number of distinct values.
+class StatisticsIndexWriter {
+public:
+    explicit StatisticsIndexWriter(Field* field);
+    ~StatisticsIndexWriter();
+
+    void add_values(const void* values, size_t count);
+
+    void add_nulls(uint32_t count) { _null_count += count; }
+
+    Status finish(fs::WritableBlock* wblock, ColumnIndexMetaPB* index_meta);
+
+    uint64_t size() const;
+
+    // The hash of a not-null value in the HyperLogLog, which is the same for the same
+    // value in any segment
+    static uint64_t hash_value(const Field* field, const void* value);
+
+private:
+    Field* _field;
+    uint64_t _null_count = 0;
+    std::unique_ptr<HyperLogLog> _ndv_sketch;
+
+    DISALLOW_COPY_AND_ASSIGN(StatisticsIndexWriter);
+};
+
+class StatisticsIndexReader {
+public:
+    StatisticsIndexReader(const std::string& file_name, const StatisticsIndexPB* index_meta)
+            : _file_name(file_name), _index_meta(index_meta) {}
+
+    uint64_t null_count() const { return _index_meta->null_count(); }
+
+    // Read the serialized HyperLogLog of the not-null values into 'ndv_sketch'
+    Status read_ndv_sketch(bool use_page_cache, std::string* ndv_sketch);
+
+private:
+    std::string _file_name;
+    const StatisticsIndexPB* _index_meta;
+};
+
+} // namespace segment_v2
+} // namespace doris
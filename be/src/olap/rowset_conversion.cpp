@@ -0,0 +1,107 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/rowset_conversion.h"
+
+#include "util/doris_metrics.h"
+#include "util/trace.h"
+
+namespace doris {
+
+RowsetConversion::RowsetConversion(TabletSharedPtr tablet, const std::string& label,
+                                   const std::shared_ptr<MemTracker>& parent_tracker)
+        : Compaction(tablet, label, parent_tracker) {}
+
+RowsetConversion::~RowsetConversion() {}
+
+bool RowsetConversion::need_conversion(Tablet* tablet, const RowsetMetaSharedPtr& rs_meta) {
+    // the output rowset of compactions is beta only if it is the default or preferred type
+    return rs_meta->rowset_type() == ALPHA_ROWSET && !rs_meta->has_delete_predicate() &&
+           (StorageEngine::instance()->default_rowset_type() == BETA_ROWSET ||
+            tablet->tablet_meta()->preferred_rowset_type() == BETA_ROWSET);
+}
+
+OLAPStatus RowsetConversion::prepare_compact() {
+    if (!_tablet->init_succeeded()) {
+        return OLAP_ERR_INPUT_PARAMETER_ERROR;
+    }
+
+    // the rowset may be under either base or cumulative compaction
+    MutexLock base_lock(_tablet->get_base_lock(), TRY_LOCK);
+    if (!base_lock.own_lock()) {
+        return OLAP_ERR_BE_TRY_BE_LOCK_ERROR;
+    }
+    MutexLock cumulative_lock(_tablet->get_cumulative_lock(), TRY_LOCK);
+    if (!cumulative_lock.own_lock()) {
+        return OLAP_ERR_BE_TRY_BE_LOCK_ERROR;
+    }
+    RETURN_NOT_OK(pick_rowsets_to_compact());
+    TRACE("rowsets picked");
+    return OLAP_SUCCESS;
+}
+
+OLAPStatus RowsetConversion::execute_compact_impl() {
+    MutexLock base_lock(_tablet->get_base_lock(), TRY_LOCK);
+    if (!base_lock.own_lock()) {
+        LOG(WARNING) << "another base compaction is running. tablet=" << _tablet->full_name();
+        return OLAP_ERR_BE_TRY_BE_LOCK_ERROR;
+    }
+    MutexLock cumulative_lock(_tablet->get_cumulative_lock(), TRY_LOCK);
+    if (!cumulative_lock.own_lock()) {
+        LOG(WARNING) << "another cumulative compaction is running. tablet="
+                     << _tablet->full_name();
+        return OLAP_ERR_BE_TRY_BE_LOCK_ERROR;
+    }
+    TRACE("got compaction locks");
+
+    // the rowset may be compacted or replaced by clone since it is picked
+    {
+        ReadLock rdlock(_tablet->get_header_lock_ptr());
+        if (_tablet->get_rowset_by_version(_input_rowsets[0]->version()) != _input_rowsets[0]) {
+            return OLAP_ERR_BE_NO_SUITABLE_VERSION;
+        }
+    }
+
+    RETURN_NOT_OK(do_compaction(get_compaction_permits()));
+    TRACE("compaction finished");
+
+    _state = CompactionState::SUCCESS;
+
+    DorisMetrics::instance()->rowset_conversion_rowsets_total->increment(_input_rowsets.size());
+    DorisMetrics::instance()->rowset_conversion_bytes_total->increment(_input_rowsets_size);
+    TRACE("save rowset conversion metrics");
+
+    return OLAP_SUCCESS;
+}
+
+OLAPStatus RowsetConversion::pick_rowsets_to_compact() {
+    _input_rowsets.clear();
+    ReadLock rdlock(_tablet->get_header_lock_ptr());
+    for (auto& rs_meta : _tablet->tablet_meta()->all_rs_metas()) {
+        if (!need_conversion(_tablet.get(), rs_meta)) {
+            continue;
+        }
+        RowsetSharedPtr rowset = _tablet->get_rowset_by_version(rs_meta->version());
+        if (rowset != nullptr &&
+            (_input_rowsets.empty() || rowset->end_version() < _input_rowsets[0]->end_version())) {
+            _input_rowsets.assign(1, rowset);
+        }
+    }
+    return _input_rowsets.empty() ? OLAP_ERR_BE_NO_SUITABLE_VERSION : OLAP_SUCCESS;
+}
+
+} // namespace doris
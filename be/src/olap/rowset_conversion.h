@@ -0,0 +1,56 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <string>
+
+#include "olap/compaction.h"
+
+namespace doris {
+
+// Rewrites an alpha rowset of a tablet to a beta rowset of the same version in background,
+// so that the legacy data is read through segment_v2 and its indexes. The rowset is merged
+// like a cumulative compaction of itself, so delete predicates are not applied to its rows.
+// Rowsets of delete predicates are left, they have no data to read.
+class RowsetConversion : public Compaction {
+public:
+    RowsetConversion(TabletSharedPtr tablet, const std::string& label,
+                     const std::shared_ptr<MemTracker>& parent_tracker);
+    ~RowsetConversion() override;
+
+    OLAPStatus prepare_compact() override;
+    OLAPStatus execute_compact_impl() override;
+
+    // the permits to request from the compaction permit limiter, after prepare_compact()
+    int64_t permits() { return get_compaction_permits(); }
+
+    // Whether 'rs_meta' of 'tablet' is to be converted, the header lock must be held.
+    static bool need_conversion(Tablet* tablet, const RowsetMetaSharedPtr& rs_meta);
+
+protected:
+    // pick the alpha rowset of the lowest version
+    OLAPStatus pick_rowsets_to_compact() override;
+
+    std::string compaction_name() const override { return "rowset conversion"; }
+
+    ReaderType compaction_type() const override { return ReaderType::READER_CUMULATIVE_COMPACTION; }
+
+    DISALLOW_COPY_AND_ASSIGN(RowsetConversion);
+};
+
+} // namespace doris
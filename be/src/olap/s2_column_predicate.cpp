@@ -0,0 +1,125 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/s2_column_predicate.h"
+
+#include <s2/s1angle.h>
+#include <s2/s2latlng_rect.h>
+#include <s2/s2region_coverer.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include "common/config.h"
+#include "geo/geo_types.h"
+#include "runtime/vectorized_row_batch.h"
+
+namespace doris {
+
+// Margin in radians added to the longitude bound of the shape, so that the rounding of
+// the functions and the bound don't skip a point on the boundary
+static const double kLngBoundMargin = 1e-9;
+
+S2ColumnPredicate::S2ColumnPredicate(uint32_t column_id, int32_t lat_column_unique_id,
+                                     const std::string& encoded_shape)
+        : ColumnPredicate(column_id),
+          _lat_column_unique_id(lat_column_unique_id),
+          _shape(GeoShape::from_encoded(encoded_shape.data(), encoded_shape.size())),
+          _lng_bound(S1Interval::Full()) {
+    if (_shape != nullptr && _shape->region() != nullptr) {
+        _lng_bound = _shape->region()->GetRectBound().lng().Expanded(kLngBoundMargin);
+    }
+}
+
+S2ColumnPredicate::~S2ColumnPredicate() = default;
+
+bool S2ColumnPredicate::may_contain(double lng) const {
+    // the geo functions return null for the points out of range
+    if (!(std::abs(lng) <= 180)) {
+        return false;
+    }
+    double radians = std::min(M_PI, std::max(-M_PI, S1Angle::Degrees(lng).radians()));
+    return _lng_bound.Contains(radians);
+}
+
+void S2ColumnPredicate::evaluate(VectorizedRowBatch* batch) const {
+    uint16_t n = batch->size();
+    if (n == 0) {
+        return;
+    }
+    uint16_t* sel = batch->selected();
+    const double* col_vector =
+            reinterpret_cast<const double*>(batch->column(_column_id)->col_data());
+    const bool* is_null =
+            batch->column(_column_id)->no_nulls() ? nullptr : batch->column(_column_id)->is_null();
+    uint16_t new_size = 0;
+    if (batch->selected_in_use()) {
+        for (uint16_t j = 0; j != n; ++j) {
+            uint16_t i = sel[j];
+            sel[new_size] = i;
+            new_size += ((is_null == nullptr || !is_null[i]) && may_contain(col_vector[i]));
+        }
+        batch->set_size(new_size);
+    } else {
+        for (uint16_t i = 0; i != n; ++i) {
+            sel[new_size] = i;
+            new_size += ((is_null == nullptr || !is_null[i]) && may_contain(col_vector[i]));
+        }
+        if (new_size < n) {
+            batch->set_size(new_size);
+            batch->set_selected_in_use(true);
+        }
+    }
+}
+
+void S2ColumnPredicate::evaluate(ColumnBlock* block, uint16_t* sel, uint16_t* size) const {
+    uint16_t new_size = 0;
+    for (uint16_t i = 0; i < *size; ++i) {
+        uint16_t idx = sel[i];
+        sel[new_size] = idx;
+        new_size += (!block->cell(idx).is_null() &&
+                     may_contain(*reinterpret_cast<const double*>(block->cell(idx).cell_ptr())));
+    }
+    *size = new_size;
+}
+
+Status S2ColumnPredicate::evaluate(const Schema& schema,
+                                   const std::vector<BitmapIndexIterator*>& iterators,
+                                   uint32_t num_rows, Roaring* roaring) const {
+    return Status::NotSupported("s2 predicate can't be evaluated by bitmap index");
+}
+
+Status S2ColumnPredicate::evaluate_s2_index(S2IndexIterator* iterator, Roaring* roaring) const {
+    // the latitude column of the index is another one if it was dropped and added again
+    if (_shape == nullptr || _shape->region() == nullptr ||
+        iterator->lat_column_unique_id() != _lat_column_unique_id) {
+        return Status::OK();
+    }
+    if (_covering_level != iterator->level()) {
+        S2RegionCoverer::Options options;
+        options.set_max_cells(std::max<int32_t>(1, config::s2_index_max_covering_cells));
+        // cells of higher levels than the index are no more selective than their parents
+        options.set_max_level(iterator->level());
+        S2RegionCoverer coverer(options);
+        _covering.clear();
+        coverer.GetCovering(*_shape->region(), &_covering);
+        _covering_level = iterator->level();
+    }
+    return iterator->filter_rows_in_cells(_covering, roaring);
+}
+
+} // namespace doris
@@ -0,0 +1,77 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <s2/s1interval.h>
+#include <s2/s2cell_id.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <roaring/roaring.hh>
+
+#include "olap/column_predicate.h"
+
+namespace doris {
+
+class GeoShape;
+class VectorizedRowBatch;
+
+// Predicate that the point of a longitude column, which has an S2 index, and its
+// latitude column may be in a shape, pushed down for st_contains(shape, st_point(lng, lat))
+// and st_distance_sphere(lng, lat, x, y) < radius. It's necessary but not sufficient, so
+// the exact function is still evaluated on the rows left:
+//  - the S2 index skips the rows in no cell of the covering of the shape
+//  - values skip the rows whose longitude is null or out of the bound of the shape
+class S2ColumnPredicate : public ColumnPredicate {
+public:
+    // 'encoded_shape' is a GeoShape encoded by GeoShape::encode_to(), nothing is pruned
+    // if it can't be decoded or isn't a region
+    S2ColumnPredicate(uint32_t column_id, int32_t lat_column_unique_id,
+                      const std::string& encoded_shape);
+    ~S2ColumnPredicate() override;
+
+    void evaluate(VectorizedRowBatch* batch) const override;
+
+    void evaluate(ColumnBlock* block, uint16_t* sel, uint16_t* size) const override;
+
+    // not supported, bitmap indexes are only used for the predicates of values
+    Status evaluate(const Schema& schema, const std::vector<BitmapIndexIterator*>& iterators,
+                    uint32_t num_rows, Roaring* roaring) const override;
+
+    bool can_use_bitmap_index() const override { return false; }
+
+    Status evaluate_s2_index(S2IndexIterator* iterator, Roaring* roaring) const override;
+
+    // whether a point of longitude 'lng' may be in the shape
+    bool may_contain(double lng) const;
+
+private:
+    int32_t _lat_column_unique_id;
+    std::unique_ptr<GeoShape> _shape;
+    // longitudes of the bound of the shape, in radians
+    S1Interval _lng_bound;
+    // covering of the shape by cells of at most level _covering_level, computed for
+    // the level of the S2 index of the first segment and recomputed if another level
+    mutable int _covering_level = -1;
+    mutable std::vector<S2CellId> _covering;
+};
+
+} // namespace doris
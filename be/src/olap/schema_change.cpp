@@ -1136,6 +1136,7 @@ OLAPStatus SchemaChangeWithSorting::process(RowsetReaderSharedPtr rowset_reader,
     }
 
     SegmentsOverlapPB segments_overlap = rowset->rowset_meta()->segments_overlap();
+    bool partial_columns = rowset->rowset_meta()->partial_columns();
     RowBlock* ref_row_block = nullptr;
     rowset_reader->next_block(&ref_row_block);
     while (ref_row_block != nullptr && ref_row_block->has_remaining()) {
@@ -1164,7 +1165,7 @@ OLAPStatus SchemaChangeWithSorting::process(RowsetReaderSharedPtr rowset_reader,
                         row_block_arr,
                         Version(_temp_delta_versions.second, _temp_delta_versions.second),
                         rowset_reader->version_hash(), new_tablet, new_rowset_type,
-                        segments_overlap, &rowset)) {
+                        segments_overlap, partial_columns, &rowset)) {
                 LOG(WARNING) << "failed to sorting internally.";
                 res = OLAP_ERR_ALTER_STATUS_ERR;
                 goto SORTING_PROCESS_ERR;
@@ -1222,7 +1223,7 @@ OLAPStatus SchemaChangeWithSorting::process(RowsetReaderSharedPtr rowset_reader,
         if (!_internal_sorting(row_block_arr,
                                Version(_temp_delta_versions.second, _temp_delta_versions.second),
                                rowset_reader->version_hash(), new_tablet, new_rowset_type,
-                               segments_overlap, &rowset)) {
+                               segments_overlap, partial_columns, &rowset)) {
             LOG(WARNING) << "failed to sorting internally.";
             res = OLAP_ERR_ALTER_STATUS_ERR;
             goto SORTING_PROCESS_ERR;
@@ -1298,7 +1299,7 @@ bool SchemaChangeWithSorting::_internal_sorting(const std::vector<RowBlock*>& ro
                                                 TabletSharedPtr new_tablet,
                                                 RowsetTypePB new_rowset_type,
                                                 SegmentsOverlapPB segments_overlap,
-                                                RowsetSharedPtr* rowset) {
+                                                bool partial_columns, RowsetSharedPtr* rowset) {
     uint64_t merged_rows = 0;
     RowBlockMerger merger(new_tablet);
 
@@ -1315,6 +1316,7 @@ bool SchemaChangeWithSorting::_internal_sorting(const std::vector<RowBlock*>& ro
     context.version = version;
     context.version_hash = version_hash;
     context.segments_overlap = segments_overlap;
+    context.partial_columns = partial_columns;
     VLOG(3) << "init rowset builder. tablet=" << new_tablet->full_name()
             << ", block_row_size=" << new_tablet->num_rows_per_row_block();
 
@@ -1411,6 +1413,13 @@ OLAPStatus SchemaChangeHandler::_do_process_alter_tablet_v2(const TAlterTabletRe
         return OLAP_ERR_TABLE_NOT_FOUND;
     }
 
+    // the delete bitmap can't be converted along with the rows yet
+    if (base_tablet->enable_unique_key_merge_on_write()) {
+        LOG(WARNING) << "schema change of merge-on-write tablet is not supported. base_tablet="
+                     << base_tablet->full_name();
+        return OLAP_ERR_FUNC_NOT_IMPLEMENTED;
+    }
+
     // check if tablet's state is not_ready, if it is ready, it means the tablet already finished
     // check whether the tablet's max continuous version == request.version
     if (new_tablet->tablet_state() != TABLET_NOTREADY) {
@@ -1529,6 +1538,11 @@ OLAPStatus SchemaChangeHandler::_do_process_alter_tablet_v2(const TAlterTabletRe
         _reader_context.tablet_schema = &base_tablet->tablet_schema();
         _reader_context.need_ordered_result = true;
         _reader_context.delete_handler = &delete_handler;
+        // the rows deleted by bitmap are skipped as well
+        if (!base_tablet->tablet_meta()->delete_bitmap().empty()) {
+            _reader_context.delete_bitmap = &base_tablet->tablet_meta()->delete_bitmap();
+            _reader_context.delete_bitmap_version = end_version;
+        }
         _reader_context.return_columns = &return_columns;
         // for schema change, seek_columns is the same to return_columns
         _reader_context.seek_columns = &return_columns;
@@ -1695,6 +1709,7 @@ OLAPStatus SchemaChangeHandler::schema_version_convert(TabletSharedPtr base_tabl
     writer_context.load_id.set_hi((*base_rowset)->load_id().hi());
     writer_context.load_id.set_lo((*base_rowset)->load_id().lo());
     writer_context.segments_overlap = (*base_rowset)->rowset_meta()->segments_overlap();
+    writer_context.partial_columns = (*base_rowset)->rowset_meta()->partial_columns();
 
     std::unique_ptr<RowsetWriter> rowset_writer;
     RowsetFactory::create_rowset_writer(writer_context, &rowset_writer);
@@ -1897,6 +1912,7 @@ OLAPStatus SchemaChangeHandler::_convert_historical_rowsets(const SchemaChangePa
         writer_context.version = rs_reader->version();
         writer_context.version_hash = rs_reader->version_hash();
         writer_context.segments_overlap = rs_reader->rowset()->rowset_meta()->segments_overlap();
+        writer_context.partial_columns = rs_reader->rowset()->rowset_meta()->partial_columns();
 
         std::unique_ptr<RowsetWriter> rowset_writer;
         OLAPStatus status = RowsetFactory::create_rowset_writer(writer_context, &rowset_writer);
@@ -2105,6 +2121,20 @@ OLAPStatus SchemaChangeHandler::_parse_request(
         return OLAP_SUCCESS;
     }
 
+    // the bitmap and bloom filter indexes of the linked beta rowsets can be built in background,
+    // while alpha segments must have the bloom filters of the schema
+    bool can_build_indexes = config::enable_index_build &&
+                             base_tablet->tablet_meta()->preferred_rowset_type() == BETA_ROWSET &&
+                             new_tablet->tablet_meta()->preferred_rowset_type() == BETA_ROWSET;
+    if (can_build_indexes) {
+        ReadLock rdlock(base_tablet->get_header_lock_ptr());
+        for (auto& rs_meta : base_tablet->tablet_meta()->all_rs_metas()) {
+            if (rs_meta->rowset_type() != BETA_ROWSET) {
+                can_build_indexes = false;
+                break;
+            }
+        }
+    }
     for (size_t i = 0; i < new_tablet->num_columns(); ++i) {
         ColumnMapping* column_mapping = rb_changer->get_mutable_column_mapping(i);
         if (column_mapping->ref_column < 0) {
@@ -2121,19 +2151,23 @@ OLAPStatus SchemaChangeHandler::_parse_request(
                 *sc_directly = true;
                 return OLAP_SUCCESS;
 
-            } else if (new_tablet_schema.column(i).is_bf_column() !=
-                       ref_tablet_schema.column(column_mapping->ref_column).is_bf_column()) {
+            } else if (!can_build_indexes &&
+                       new_tablet_schema.column(i).is_bf_column() !=
+                               ref_tablet_schema.column(column_mapping->ref_column)
+                                       .is_bf_column()) {
                 *sc_directly = true;
                 return OLAP_SUCCESS;
-            } else if (new_tablet_schema.column(i).has_bitmap_index() !=
-                       ref_tablet_schema.column(column_mapping->ref_column).has_bitmap_index()) {
+            } else if (!can_build_indexes &&
+                       new_tablet_schema.column(i).has_bitmap_index() !=
+                               ref_tablet_schema.column(column_mapping->ref_column)
+                                       .has_bitmap_index()) {
                 *sc_directly = true;
                 return OLAP_SUCCESS;
             }
         }
     }
 
-    if (base_tablet->delete_predicates().size() != 0) {
+    if (!_can_link_with_delete_predicates(base_tablet, new_tablet)) {
         //there exists delete condition in header, can't do linked schema change
         *sc_directly = true;
     }
@@ -2147,6 +2181,38 @@ OLAPStatus SchemaChangeHandler::_parse_request(
     return OLAP_SUCCESS;
 }
 
+// Beta segments are read with the reader's schema, so columns added by a linked
+// schema change are filled with default values and dropped columns are skipped.
+// Delete predicates are carried over with the linked rowsets and evaluated at read
+// time, which is only safe when every predicate still applies to the new schema.
+bool SchemaChangeHandler::_can_link_with_delete_predicates(TabletSharedPtr base_tablet,
+                                                           TabletSharedPtr new_tablet) {
+    ReadLock rdlock(base_tablet->get_header_lock_ptr());
+    if (base_tablet->delete_predicates().empty()) {
+        return true;
+    }
+    // the delete bitmap is of the rowsets of base tablet, which are not kept by linking
+    if (!base_tablet->tablet_meta()->delete_bitmap().empty()) {
+        return false;
+    }
+    for (auto& rs_meta : base_tablet->tablet_meta()->all_rs_metas()) {
+        if (rs_meta->rowset_type() != BETA_ROWSET) {
+            return false;
+        }
+    }
+
+    DeleteHandler delete_handler;
+    OLAPStatus res = delete_handler.init(new_tablet->tablet_schema(),
+                                         base_tablet->delete_predicates(), INT32_MAX);
+    delete_handler.finalize();
+    if (res != OLAP_SUCCESS) {
+        LOG(INFO) << "delete predicates of base tablet are invalid on new schema, "
+                  << "can't do linked schema change. base_tablet=" << base_tablet->full_name();
+        return false;
+    }
+    return true;
+}
+
 OLAPStatus SchemaChangeHandler::_init_column_mapping(ColumnMapping* column_mapping,
                                                      const TabletColumn& column_schema,
                                                      const std::string& value) {
@@ -163,7 +163,8 @@ private:
     bool _internal_sorting(const std::vector<RowBlock*>& row_block_arr,
                            const Version& temp_delta_versions, const VersionHash version_hash,
                            TabletSharedPtr new_tablet, RowsetTypePB new_rowset_type,
-                           SegmentsOverlapPB segments_overlap, RowsetSharedPtr* rowset);
+                           SegmentsOverlapPB segments_overlap, bool partial_columns,
+                           RowsetSharedPtr* rowset);
 
     bool _external_sorting(std::vector<RowsetSharedPtr>& src_rowsets, RowsetWriter* rowset_writer,
                            TabletSharedPtr new_tablet);
@@ -234,6 +235,11 @@ private:
             const std::unordered_map<std::string, AlterMaterializedViewParam>&
                     materialized_function_map);
 
+    // Whether the delete predicates of base tablet, if any, still allow a linked schema
+    // change. Takes the header lock of base tablet.
+    static bool _can_link_with_delete_predicates(TabletSharedPtr base_tablet,
+                                                 TabletSharedPtr new_tablet);
+
     // 需要新建default_value时的初始化设置
     static OLAPStatus _init_column_mapping(ColumnMapping* column_mapping,
                                            const TabletColumn& column_schema,
@@ -0,0 +1,62 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/segment_cache.h"
+
+#include "olap/rowset/segment_v2/segment.h"
+
+namespace doris {
+
+SegmentCache* SegmentCache::_s_instance = nullptr;
+
+void SegmentCache::create_global_cache(size_t capacity) {
+    DCHECK(_s_instance == nullptr);
+    static SegmentCache instance(capacity);
+    _s_instance = &instance;
+}
+
+SegmentCache::SegmentCache(size_t capacity) {
+    _cache.reset(new_lru_cache("SegmentCache", capacity));
+}
+
+bool SegmentCache::lookup(const std::string& rowset_key, Segments* segments) {
+    auto handle = _cache->lookup(CacheKey(rowset_key));
+    if (handle == nullptr) {
+        return false;
+    }
+    *segments = *reinterpret_cast<Segments*>(_cache->value(handle));
+    _cache->release(handle);
+    return true;
+}
+
+void SegmentCache::insert(const std::string& rowset_key, const Segments& segments) {
+    size_t charge = sizeof(Segments);
+    for (auto& segment : segments) {
+        charge += segment->mem_usage();
+    }
+    auto deleter = [](const doris::CacheKey& key, void* value) {
+        delete reinterpret_cast<Segments*>(value);
+    };
+    auto handle = _cache->insert(CacheKey(rowset_key), new Segments(segments), charge, deleter);
+    _cache->release(handle);
+}
+
+void SegmentCache::erase(const std::string& rowset_key) {
+    _cache->erase(CacheKey(rowset_key));
+}
+
+} // namespace doris
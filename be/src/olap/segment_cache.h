@@ -0,0 +1,74 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/status.h"
+#include "gutil/macros.h" // for DISALLOW_COPY_AND_ASSIGN
+#include "olap/lru_cache.h"
+
+namespace doris {
+
+namespace segment_v2 {
+class Segment;
+} // namespace segment_v2
+
+// Cache of opened segments of beta rowsets, keyed by the unique id of rowsets
+// (see Rowset::unique_id()), i.e. the rowset id and the path of the rowset.
+//
+// Opening a segment reads and parses its footer and creates its column readers,
+// and its short key index is kept once loaded. Keeping the segments of all
+// rowsets ever read costs unbounded memory, so they are kept in an LRU cache
+// whose entries are charged by the estimated memory of the segments.
+//
+// Segments are shared by the readers using them, an evicted segment is released
+// when its last reader finishes. Usage and hit counts are reported by the metric
+// entity "lru_cache:SegmentCache".
+class SegmentCache {
+public:
+    using Segments = std::vector<std::shared_ptr<segment_v2::Segment>>;
+
+    // Create global instance of this class.
+    static void create_global_cache(size_t capacity);
+
+    // Return global instance, nullptr if the cache is not created.
+    static SegmentCache* instance() { return _s_instance; }
+
+    explicit SegmentCache(size_t capacity);
+
+    // Return true and set 'segments' if segments of the rowset are cached.
+    bool lookup(const std::string& rowset_key, Segments* segments);
+
+    // Cache the segments of the rowset.
+    void insert(const std::string& rowset_key, const Segments& segments);
+
+    // Remove segments of the rowset from the cache, called when the rowset is closed.
+    void erase(const std::string& rowset_key);
+
+private:
+    static SegmentCache* _s_instance;
+
+    std::unique_ptr<Cache> _cache;
+
+    DISALLOW_COPY_AND_ASSIGN(SegmentCache);
+};
+
+} // namespace doris
@@ -0,0 +1,164 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "util/cpu_dispatch.h"
+
+namespace doris {
+
+// Kernels used by ColumnPredicate to evaluate a whole ColumnBlock at once.
+//
+// When nothing has been filtered yet, the selection vector is the identity
+// [0, size). In that case a predicate is evaluated in two passes: first a
+// branch free comparison of the contiguous column data into a byte mask,
+// which the compiler vectorizes, then the mask is compacted into the
+// selection vector. The comparison pass is compiled for AVX2 and AVX-512 as
+// well and the variant is chosen at runtime through cpu_dispatch.
+namespace selection_kernel {
+
+// Number of rows evaluated per pass, so that the mask fits on the stack.
+static constexpr uint16_t kChunkSize = 1024;
+
+// The selection vector is sorted and without duplicates, so it is the
+// identity iff its last element is size - 1.
+inline bool is_dense(const uint16_t* sel, uint16_t size) {
+    return size > 0 && sel[size - 1] == size - 1;
+}
+
+// Only plain arithmetic types can be compared in place by SIMD lanes.
+template <class T>
+struct is_simd_comparable
+        : std::integral_constant<bool, std::is_arithmetic<T>::value && sizeof(T) <= 8> {};
+
+template <class T, class Op>
+inline void compare_to_mask_default(const T* __restrict data, uint16_t size, T value,
+                                    uint8_t* __restrict mask) {
+    Op op;
+    for (uint16_t i = 0; i < size; ++i) {
+        mask[i] = op(data[i], value);
+    }
+}
+
+#ifdef DORIS_TARGET_AVX2
+template <class T, class Op>
+DORIS_TARGET_AVX2 void compare_to_mask_avx2(const T* __restrict data, uint16_t size, T value,
+                                            uint8_t* __restrict mask) {
+    Op op;
+    for (uint16_t i = 0; i < size; ++i) {
+        mask[i] = op(data[i], value);
+    }
+}
+#endif
+
+#ifdef DORIS_TARGET_AVX512
+template <class T, class Op>
+DORIS_TARGET_AVX512 void compare_to_mask_avx512(const T* __restrict data, uint16_t size,
+                                                T value, uint8_t* __restrict mask) {
+    Op op;
+    for (uint16_t i = 0; i < size; ++i) {
+        mask[i] = op(data[i], value);
+    }
+}
+#endif
+
+// mask[i] = Op(data[i], value), for i in [0, size)
+template <class T, class Op>
+inline void compare_to_mask(const T* data, uint16_t size, T value, uint8_t* mask) {
+    switch (cpu_dispatch::best_isa()) {
+#ifdef DORIS_TARGET_AVX512
+    case cpu_dispatch::Isa::AVX512:
+        compare_to_mask_avx512<T, Op>(data, size, value, mask);
+        return;
+#endif
+#ifdef DORIS_TARGET_AVX2
+    case cpu_dispatch::Isa::AVX2:
+        compare_to_mask_avx2<T, Op>(data, size, value, mask);
+        return;
+#endif
+    default:
+        compare_to_mask_default<T, Op>(data, size, value, mask);
+    }
+}
+
+// mask[i] = mask[i] && !is_null[i]
+inline void mask_out_nulls(const bool* __restrict is_null, uint16_t size,
+                           uint8_t* __restrict mask) {
+    const uint8_t* nulls = reinterpret_cast<const uint8_t*>(is_null);
+    for (uint16_t i = 0; i < size; ++i) {
+        mask[i] &= (nulls[i] ^ 1);
+    }
+}
+
+// Write base + the index of every non zero byte of mask to sel, return the
+// count. Spans of 8 rows that are all selected or all filtered are handled
+// with one 64bit load.
+inline uint16_t mask_to_selection(const uint8_t* mask, uint16_t size, uint16_t base,
+                                  uint16_t* sel) {
+    static constexpr uint64_t kAllSelected = 0x0101010101010101ULL;
+    uint16_t new_size = 0;
+    uint16_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        memcpy(&word, mask + i, sizeof(word));
+        if (word == 0) {
+            continue;
+        }
+        if (word == kAllSelected) {
+            for (uint16_t j = 0; j < 8; ++j) {
+                sel[new_size++] = base + i + j;
+            }
+            continue;
+        }
+        for (uint16_t j = 0; j < 8; ++j) {
+            sel[new_size] = base + i + j;
+            new_size += mask[i + j];
+        }
+    }
+    for (; i < size; ++i) {
+        sel[new_size] = base + i;
+        new_size += mask[i];
+    }
+    return new_size;
+}
+
+// Evaluate "data[i] Op value" for a dense selection of size rows, and
+// write the selected rows to sel. is_null is nullptr if the column is not
+// nullable.
+template <class T, class Op>
+inline uint16_t evaluate_dense(const T* data, const bool* is_null, uint16_t size, T value,
+                               uint16_t* sel) {
+    uint8_t mask[kChunkSize];
+    uint16_t new_size = 0;
+    for (uint32_t base = 0; base < size; base += kChunkSize) {
+        uint16_t num = std::min<uint32_t>(kChunkSize, size - base);
+        compare_to_mask<T, Op>(data + base, num, value, mask);
+        if (is_null != nullptr) {
+            mask_out_nulls(is_null + base, num, mask);
+        }
+        new_size += mask_to_selection(mask, num, base, sel + new_size);
+    }
+    return new_size;
+}
+
+} // namespace selection_kernel
+} // namespace doris
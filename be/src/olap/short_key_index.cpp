@@ -17,6 +17,7 @@
 
 #include "olap/short_key_index.h"
 
+#include <algorithm>
 #include <string>
 
 #include "gutil/strings/substitute.h"
@@ -45,6 +46,9 @@ Status ShortKeyIndexBuilder::finalize(uint32_t num_segment_rows, std::vector<Sli
     footer->set_segment_id(_segment_id);
     footer->set_num_rows_per_block(_num_rows_per_block);
     footer->set_num_segment_rows(num_segment_rows);
+    if (_num_key_columns > 0) {
+        footer->set_num_key_columns(_num_key_columns);
+    }
 
     body->emplace_back(_key_buf);
     body->emplace_back(_offset_buf);
@@ -83,6 +87,23 @@ Status ShortKeyIndexDecoder::parse(const Slice& body, const segment_v2::ShortKey
     if (offset_slice.size != 0) {
         return Status::Corruption("Still has data after parse all key offset");
     }
+
+    uint32_t max_key_bytes = 0;
+    for (uint32_t i = 0; i < _footer.num_items(); ++i) {
+        if (_offsets[i] > _offsets[i + 1]) {
+            return Status::Corruption("Index offsets are not ascending");
+        }
+        max_key_bytes = std::max(max_key_bytes, _offsets[i + 1] - _offsets[i]);
+    }
+    _prefix_bytes = (std::max(max_key_bytes, 1U) + 7) / 8 * 8;
+    if (_prefix_bytes > MAX_PREFIX_BYTES) {
+        _prefix_bytes = MAX_PREFIX_BYTES;
+    }
+    _prefixes.resize(_footer.num_items() * _prefix_bytes);
+    for (uint32_t i = 0; i < _footer.num_items(); ++i) {
+        Slice item(_key_data.data + _offsets[i], _offsets[i + 1] - _offsets[i]);
+        _fill_prefix(item, _prefixes.data() + i * _prefix_bytes);
+    }
     _parsed = true;
     return Status::OK();
 }
@@ -17,7 +17,9 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cstdint>
+#include <cstring>
 #include <iterator>
 #include <string>
 #include <vector>
@@ -126,8 +128,14 @@ void encode_key(std::string* buf, const RowType& row, size_t num_keys) {
 //    more than short key
 class ShortKeyIndexBuilder {
 public:
-    ShortKeyIndexBuilder(uint32_t segment_id, uint32_t num_rows_per_block)
-            : _segment_id(segment_id), _num_rows_per_block(num_rows_per_block), _num_items(0) {}
+    // 'num_key_columns' is how many key columns the items are encoded with, which is
+    // recorded only if it's not the short key columns of the tablet (0)
+    ShortKeyIndexBuilder(uint32_t segment_id, uint32_t num_rows_per_block,
+                         uint32_t num_key_columns = 0)
+            : _segment_id(segment_id),
+              _num_rows_per_block(num_rows_per_block),
+              _num_key_columns(num_key_columns),
+              _num_items(0) {}
 
     Status add_item(const Slice& key);
 
@@ -138,6 +146,7 @@ public:
 private:
     uint32_t _segment_id;
     uint32_t _num_rows_per_block;
+    uint32_t _num_key_columns;
     uint32_t _num_items;
 
     faststring _key_buf;
@@ -203,6 +212,10 @@ private:
 };
 
 // Used to decode short key to header and encoded index data.
+// Besides the encoded keys, the decoder keeps the first bytes of each key, zero padded
+// to the same width, in one contiguous buffer. A search compares these fixed-width
+// prefixes with memcmp, and reads the full key of an item only if its prefix is equal
+// to the prefix of the searched key, so most steps of a search touch a few cache lines.
 // Usage:
 //      ShortKeyIndexDecoder decoder;
 //      decoder.parse(body, footer);
@@ -250,6 +263,13 @@ public:
         return _footer.num_rows_per_block();
     }
 
+    // The number of key columns the items are encoded with, 0 if they are encoded with
+    // the short key columns of the tablet
+    uint32_t num_key_columns() const {
+        DCHECK(_parsed);
+        return _footer.num_key_columns();
+    }
+
     Slice key(ssize_t ordinal) const {
         DCHECK(_parsed);
         DCHECK(ordinal >= 0 && ordinal < num_items());
@@ -259,23 +279,52 @@ public:
 private:
     template <bool lower_bound>
     ShortKeyIndexIterator seek(const Slice& key) const {
-        auto comparator = [this](const Slice& lhs, const Slice& rhs) {
-            return lhs.compare(rhs) < 0;
-        };
-        if (lower_bound) {
-            return std::lower_bound(begin(), end(), key, comparator);
-        } else {
-            return std::upper_bound(begin(), end(), key, comparator);
+        char key_prefix[MAX_PREFIX_BYTES];
+        _fill_prefix(key, key_prefix);
+        uint32_t start = 0;
+        uint32_t end = num_items();
+        while (start < end) {
+            uint32_t mid = start + (end - start) / 2;
+            int cmp = _compare(mid, key, key_prefix);
+            if (cmp < 0 || (!lower_bound && cmp == 0)) {
+                start = mid + 1;
+            } else {
+                end = mid;
+            }
         }
+        return {this, start};
+    }
+
+    // The first '_prefix_bytes' bytes of 'key', zero padded. A key which is a prefix of
+    // another one is less than it, so is its padded prefix unless the prefixes are equal.
+    void _fill_prefix(const Slice& key, char* prefix) const {
+        size_t size = std::min(key.size, _prefix_bytes);
+        memcpy(prefix, key.data, size);
+        memset(prefix + size, 0, _prefix_bytes - size);
+    }
+
+    // Compare the item at 'ordinal' with 'key', whose prefix is 'key_prefix'
+    int _compare(uint32_t ordinal, const Slice& key, const char* key_prefix) const {
+        int cmp = memcmp(_prefixes.data() + ordinal * _prefix_bytes, key_prefix, _prefix_bytes);
+        if (cmp != 0) {
+            return cmp;
+        }
+        return this->key(ordinal).compare(key);
     }
 
 private:
+    // The width of the prefixes is the longest key rounded up to 8 bytes, but at most this
+    static const size_t MAX_PREFIX_BYTES = 32;
+
     bool _parsed;
 
     // All following fields are only valid after parse has been executed successfully
     segment_v2::ShortKeyFooterPB _footer;
     std::vector<uint32_t> _offsets;
     Slice _key_data;
+    size_t _prefix_bytes = 0;
+    // the prefixes of all the items, '_prefix_bytes' each
+    std::vector<char> _prefixes;
 };
 
 inline Slice ShortKeyIndexIterator::operator*() const {
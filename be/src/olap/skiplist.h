@@ -79,6 +79,11 @@ public:
     // Like Contains(), but it will return the position info as a hint. We can use this
     // position info to insert directly using InsertWithHint().
     bool Find(const Key& key, Hint* hint) const;
+    // Like Find(), but only compares key with the last key, so that keys inserted in order
+    // are not searched for. Returns false if key is less than the last key, otherwise fills
+    // the hint for InsertWithHint(), which appends key, and sets *is_exist if key is equal
+    // to the last key.
+    bool FindAtTail(const Key& key, Hint* hint, bool* is_exist) const;
 
     // Iteration over the contents of a skip list
     class Iterator {
@@ -132,6 +137,9 @@ private:
     // values are ok.
     std::atomic<int> max_height_; // Height of the entire list
 
+    // The last node of each level, head_ if the level is empty. Written only by the inserts.
+    Node* tail_[kMaxHeight];
+
     inline int GetMaxHeight() const { return max_height_.load(std::memory_order_relaxed); }
 
     // Read/written only by Insert().
@@ -352,6 +360,7 @@ SkipList<Key, Comparator>::SkipList(Comparator cmp, MemPool* mem_pool, bool can_
           rnd_(0xdeadbeef) {
     for (int i = 0; i < kMaxHeight; i++) {
         head_->SetNext(i, NULL);
+        tail_[i] = head_;
     }
 }
 
@@ -395,6 +404,9 @@ void SkipList<Key, Comparator>::Insert(const Key& key, bool* overwritten) {
         // we publish a pointer to "x" in prev[i].
         x->NoBarrier_SetNext(i, prev[i]->NoBarrier_Next(i));
         prev[i]->SetNext(i, x);
+        if (x->NoBarrier_Next(i) == NULL) {
+            tail_[i] = x;
+        }
     }
 }
 
@@ -436,6 +448,9 @@ void SkipList<Key, Comparator>::InsertWithHint(const Key& key, bool is_exist, Hi
         // we publish a pointer to "x" in prev[i].
         x->NoBarrier_SetNext(i, prev[i]->NoBarrier_Next(i));
         prev[i]->SetNext(i, x);
+        if (x->NoBarrier_Next(i) == NULL) {
+            tail_[i] = x;
+        }
     }
 }
 
@@ -460,6 +475,21 @@ bool SkipList<Key, Comparator>::Find(const Key& key, Hint* hint) const {
     }
 }
 
+template <typename Key, class Comparator>
+bool SkipList<Key, Comparator>::FindAtTail(const Key& key, Hint* hint, bool* is_exist) const {
+    Node* last = tail_[0];
+    int cmp = last == head_ ? 1 : compare_(key, last->key);
+    if (cmp < 0) {
+        return false;
+    }
+    *is_exist = cmp == 0;
+    hint->curr = *is_exist ? last : NULL;
+    for (int i = 0; i < kMaxHeight; i++) {
+        hint->prev[i] = tail_[i];
+    }
+    return true;
+}
+
 } // namespace doris
 
 #endif // DORIS_BE_SRC_OLAP_SKIPLIST_H
@@ -157,9 +157,12 @@ OLAPStatus SnapshotManager::convert_rowset_ids(const string& clone_dir, int64_t
     tablet_schema.init_from_pb(new_tablet_meta_pb.schema());
 
     std::unordered_map<Version, RowsetMetaPB*, HashOfVersion> _rs_version_map;
+    // old rowset id -> new rowset id, to convert the delete bitmap
+    std::unordered_map<std::string, std::string> rowset_id_map;
     for (auto& visible_rowset : cloned_tablet_meta_pb.rs_metas()) {
         RowsetMetaPB* rowset_meta = new_tablet_meta_pb.add_rs_metas();
         RowsetId rowset_id = StorageEngine::instance()->next_rowset_id();
+        rowset_id_map[visible_rowset.rowset_id_v2()] = rowset_id.to_string();
         RETURN_NOT_OK(_rename_rowset_id(visible_rowset, clone_dir, tablet_schema, rowset_id,
                                         rowset_meta));
         rowset_meta->set_tablet_id(tablet_id);
@@ -178,12 +181,23 @@ OLAPStatus SnapshotManager::convert_rowset_ids(const string& clone_dir, int64_t
         }
         RowsetMetaPB* rowset_meta = new_tablet_meta_pb.add_inc_rs_metas();
         RowsetId rowset_id = StorageEngine::instance()->next_rowset_id();
+        rowset_id_map[inc_rowset.rowset_id_v2()] = rowset_id.to_string();
         RETURN_NOT_OK(
                 _rename_rowset_id(inc_rowset, clone_dir, tablet_schema, rowset_id, rowset_meta));
         rowset_meta->set_tablet_id(tablet_id);
         rowset_meta->set_tablet_schema_hash(schema_hash);
     }
 
+    if (new_tablet_meta_pb.has_delete_bitmap()) {
+        DeleteBitmapPB* delete_bitmap = new_tablet_meta_pb.mutable_delete_bitmap();
+        for (int i = 0; i < delete_bitmap->rowset_ids_size(); ++i) {
+            auto it = rowset_id_map.find(delete_bitmap->rowset_ids(i));
+            if (it != rowset_id_map.end()) {
+                delete_bitmap->set_rowset_ids(i, it->second);
+            }
+        }
+    }
+
     res = TabletMeta::save(cloned_meta_file, new_tablet_meta_pb);
     if (res != OLAP_SUCCESS) {
         LOG(WARNING) << "fail to save converted tablet meta to dir='" << clone_dir;
@@ -227,6 +241,7 @@ OLAPStatus SnapshotManager::_rename_rowset_id(const RowsetMetaPB& rs_meta_pb,
     context.version_hash = org_rowset_meta->version_hash();
     // keep segments_overlap same as origin rowset
     context.segments_overlap = alpha_rowset_meta->segments_overlap();
+    context.partial_columns = alpha_rowset_meta->partial_columns();
 
     std::unique_ptr<RowsetWriter> rs_writer;
     RETURN_NOT_OK(RowsetFactory::create_rowset_writer(context, &rs_writer));
@@ -406,13 +421,30 @@ OLAPStatus SnapshotManager::_create_snapshot_files(const TabletSharedPtr& ref_ta
             ref_tablet->generate_tablet_meta_copy_unlocked(new_tablet_meta);
         }
 
+        // the rowsets the requester has are listed by the header without their files
+        std::set<string> base_rowset_ids;
+        std::set<std::pair<int64_t, int64_t>> base_versions;
+        if (!request.__isset.missing_version &&
+            snapshot_version == g_Types_constants.TSNAPSHOT_REQ_VERSION2) {
+            base_rowset_ids.insert(request.base_rowset_ids.begin(), request.base_rowset_ids.end());
+            for (size_t i = 0; i + 1 < request.base_versions.size(); i += 2) {
+                base_versions.emplace(request.base_versions[i], request.base_versions[i + 1]);
+            }
+        }
+        int64_t num_base_rowsets = 0;
         std::vector<RowsetMetaSharedPtr> rs_metas;
         for (auto& rs : consistent_rowsets) {
+            rs_metas.push_back(rs->rowset_meta());
+            if (base_rowset_ids.count(rs->rowset_id().to_string()) > 0 ||
+                (rs->rowset_meta()->rowset_type() == BETA_ROWSET &&
+                 base_versions.count({rs->start_version(), rs->end_version()}) > 0)) {
+                ++num_base_rowsets;
+                continue;
+            }
             res = rs->link_files_to(schema_full_path, rs->rowset_id());
             if (res != OLAP_SUCCESS) {
                 break;
             }
-            rs_metas.push_back(rs->rowset_meta());
             VLOG(3) << "add rowset meta to clone list. "
                     << " start version " << rs->rowset_meta()->start_version() << " end version "
                     << rs->rowset_meta()->end_version() << " empty " << rs->rowset_meta()->empty();
@@ -421,6 +453,11 @@ OLAPStatus SnapshotManager::_create_snapshot_files(const TabletSharedPtr& ref_ta
             LOG(WARNING) << "fail to create hard link. [path=" << snapshot_id_path << "]";
             break;
         }
+        if (num_base_rowsets > 0) {
+            LOG(INFO) << "skip the files of rowsets in base when snapshot. tablet="
+                      << ref_tablet->full_name() << ", num_rowsets=" << consistent_rowsets.size()
+                      << ", num_base_rowsets=" << num_base_rowsets;
+        }
 
         // clear alter task info in snapshot files
         new_tablet_meta->delete_alter_task();
@@ -40,6 +40,7 @@
 #include "olap/cumulative_compaction.h"
 #include "olap/data_dir.h"
 #include "olap/fs/file_block_manager.h"
+#include "olap/fs/ssd_block_cache.h"
 #include "olap/lru_cache.h"
 #include "olap/memtable_flush_executor.h"
 #include "olap/olap_snapshot_converter.h"
@@ -176,16 +177,72 @@ Status StorageEngine::_open() {
     _file_cache.reset(new_lru_cache("FileHandlerCache", config::file_descriptor_cache_capacity));
 
     auto dirs = get_stores<false>();
+    _init_ssd_block_cache(dirs);
     load_data_dirs(dirs);
 
     _memtable_flush_executor.reset(new MemTableFlushExecutor());
     _memtable_flush_executor->init(dirs);
 
+    if (config::segment_read_ahead_thread_num > 0) {
+        RETURN_IF_ERROR(ThreadPoolBuilder("SegmentReadAheadThreadPool")
+                                .set_min_threads(1)
+                                .set_max_threads(config::segment_read_ahead_thread_num)
+                                .build(&_segment_read_ahead_pool));
+    }
+
+    if (config::publish_version_tablet_thread_num > 0) {
+        RETURN_IF_ERROR(ThreadPoolBuilder("PublishVersionThreadPool")
+                                .set_min_threads(1)
+                                .set_max_threads(config::publish_version_tablet_thread_num)
+                                .build(&_publish_version_thread_pool));
+    }
+
+    if (config::flush_column_encode_thread_num > 0) {
+        RETURN_IF_ERROR(ThreadPoolBuilder("ColumnEncodeThreadPool")
+                                .set_min_threads(1)
+                                .set_max_threads(config::flush_column_encode_thread_num)
+                                .build(&_column_encode_thread_pool));
+    }
+
+    if (config::base_compaction_key_range_thread_num > 0) {
+        RETURN_IF_ERROR(ThreadPoolBuilder("BaseCompactionKeyRangeThreadPool")
+                                .set_min_threads(1)
+                                .set_max_threads(config::base_compaction_key_range_thread_num)
+                                .build(&_base_compaction_key_range_pool));
+    }
+
+    if (config::storage_migration_copy_thread_num > 0) {
+        RETURN_IF_ERROR(ThreadPoolBuilder("StorageMigrationCopyThreadPool")
+                                .set_min_threads(1)
+                                .set_max_threads(config::storage_migration_copy_thread_num)
+                                .build(&_storage_migration_copy_pool));
+    }
+
     _parse_default_rowset_type();
 
     return Status::OK();
 }
 
+void StorageEngine::_init_ssd_block_cache(const std::vector<DataDir*>& dirs) {
+    if (config::ssd_cache_path.empty()) {
+        return;
+    }
+    fs::SsdBlockCache::create_global_cache(config::ssd_cache_path,
+                                           config::ssd_cache_capacity_bytes,
+                                           config::ssd_cache_block_size);
+    Status st = fs::SsdBlockCache::instance()->init();
+    if (!st.ok()) {
+        // reads go to the data dirs directly without the cache
+        LOG(WARNING) << "fail to init ssd block cache, error=" << st.to_string();
+        return;
+    }
+    for (auto dir : dirs) {
+        if (dir->storage_medium() == TStorageMedium::HDD) {
+            fs::SsdBlockCache::instance()->add_cached_root(dir->path());
+        }
+    }
+}
+
 Status StorageEngine::_init_store_map() {
     std::vector<DataDir*> tmp_stores;
     std::vector<std::thread> threads;
@@ -415,13 +472,18 @@ Status StorageEngine::set_cluster_id(int32_t cluster_id) {
 std::vector<DataDir*> StorageEngine::get_stores_for_create_tablet(
         TStorageMedium::type storage_medium) {
     std::vector<DataDir*> stores;
+    std::vector<DataDir*> slow_stores;
     {
         std::lock_guard<std::mutex> l(_store_lock);
         for (auto& it : _store_map) {
             if (it.second->is_used()) {
                 if (_available_storage_medium_type_count == 1 ||
                     it.second->storage_medium() == storage_medium) {
-                    stores.push_back(it.second);
+                    if (it.second->is_slow()) {
+                        slow_stores.push_back(it.second);
+                    } else {
+                        stores.push_back(it.second);
+                    }
                 }
             }
         }
@@ -442,6 +504,9 @@ std::vector<DataDir*> StorageEngine::get_stores_for_create_tablet(
             break;
         }
     }
+    // the slow stores are only used when the others fail
+    std::random_shuffle(slow_stores.begin(), slow_stores.end());
+    stores.insert(stores.end(), slow_stores.begin(), slow_stores.end());
     return stores;
 }
 
@@ -510,6 +575,9 @@ void StorageEngine::stop() {
     THREAD_JOIN(_garbage_sweeper_thread);
     THREAD_JOIN(_disk_stat_monitor_thread);
     THREAD_JOIN(_fd_cache_clean_thread);
+    THREAD_JOIN(_rowset_conversion_producer_thread);
+    THREAD_JOIN(_index_build_producer_thread);
+    THREAD_JOIN(_column_statistics_thread);
 #undef THREAD_JOIN
 
 #define THREADS_JOIN(threads)           \
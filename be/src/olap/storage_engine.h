@@ -37,6 +37,7 @@
 #include "gen_cpp/BackendService_types.h"
 #include "gen_cpp/MasterService_types.h"
 #include "gutil/ref_counted.h"
+#include "olap/compaction_io_limiter.h"
 #include "olap/compaction_permit_limiter.h"
 #include "olap/fs/fs_util.h"
 #include "olap/olap_common.h"
@@ -50,6 +51,7 @@
 #include "olap/task/engine_task.h"
 #include "olap/txn_manager.h"
 #include "runtime/heartbeat_flags.h"
+#include "util/bandwidth_limiter.h"
 #include "util/countdown_latch.h"
 #include "util/thread.h"
 #include "util/threadpool.h"
@@ -100,7 +102,7 @@ public:
     OLAPStatus get_all_data_dir_info(std::vector<DataDirInfo>* data_dir_infos, bool need_update);
 
     // get root path for creating tablet. The returned vector of root path should be random,
-    // for avoiding that all the tablet would be deployed one disk.
+    // for avoiding that all the tablet would be deployed one disk. The slow ones are at the end.
     std::vector<DataDir*> get_stores_for_create_tablet(TStorageMedium::type storage_medium);
     DataDir* get_store(const std::string& path);
 
@@ -137,6 +139,12 @@ public:
     TabletManager* tablet_manager() { return _tablet_manager.get(); }
     TxnManager* txn_manager() { return _txn_manager.get(); }
     MemTableFlushExecutor* memtable_flush_executor() { return _memtable_flush_executor.get(); }
+    ThreadPool* segment_read_ahead_pool() { return _segment_read_ahead_pool.get(); }
+    ThreadPool* publish_version_thread_pool() { return _publish_version_thread_pool.get(); }
+    ThreadPool* column_encode_thread_pool() { return _column_encode_thread_pool.get(); }
+    ThreadPool* base_compaction_key_range_pool() { return _base_compaction_key_range_pool.get(); }
+    ThreadPool* storage_migration_copy_pool() { return _storage_migration_copy_pool.get(); }
+    BandwidthLimiter* storage_migration_limiter() { return &_storage_migration_limiter; }
 
     bool check_rowset_id_in_unused_rowsets(const RowsetId& rowset_id);
 
@@ -184,6 +192,9 @@ private:
 
     Status _init_store_map();
 
+    // Create the ssd block cache if configured and cache files of HDD data dirs in it.
+    void _init_ssd_block_cache(const std::vector<DataDir*>& dirs);
+
     void _update_storage_medium_type_count();
 
     // Some check methods
@@ -240,6 +251,17 @@ private:
     vector<TabletSharedPtr> _compaction_tasks_generator(CompactionType compaction_type,
                                                         std::vector<DataDir*> data_dirs);
 
+    // submit rowset conversion tasks of the tablets with alpha rowsets on each data dir
+    void _rowset_conversion_producer_callback();
+    void _submit_rowset_conversion(const TabletSharedPtr& tablet);
+
+    // submit index build tasks of the tablets with rowsets missing indexes on each data dir
+    void _index_build_producer_callback();
+    void _submit_index_build(const TabletSharedPtr& tablet);
+
+    // collect the column statistics of the tablets with new versions
+    void _column_statistics_thread_callback();
+
 private:
     struct CompactionCandidate {
         CompactionCandidate(uint32_t nicumulative_compaction_, int64_t tablet_id_, uint32_t index_)
@@ -308,6 +330,9 @@ private:
     // threads to check cumulative
     std::vector<scoped_refptr<Thread>> _cumulative_compaction_threads;
     scoped_refptr<Thread> _compaction_tasks_producer_thread;
+    scoped_refptr<Thread> _rowset_conversion_producer_thread;
+    scoped_refptr<Thread> _index_build_producer_thread;
+    scoped_refptr<Thread> _column_statistics_thread;
     scoped_refptr<Thread> _fd_cache_clean_thread;
     // threads to clean all file descriptor not actively in use
     std::vector<scoped_refptr<Thread>> _path_gc_threads;
@@ -336,12 +361,35 @@ private:
     HeartbeatFlags* _heartbeat_flags;
 
     std::unique_ptr<ThreadPool> _compaction_thread_pool;
+    // reads data pages ahead for segment iterators, see config::segment_read_ahead_pages
+    std::unique_ptr<ThreadPool> _segment_read_ahead_pool;
+    // publishes version on the tablets of publish version tasks concurrently
+    std::unique_ptr<ThreadPool> _publish_version_thread_pool;
+    // encodes the columns of the segments of flushed memtables in parallel
+    std::unique_ptr<ThreadPool> _column_encode_thread_pool;
+    // merges the key ranges of base compactions in parallel
+    std::unique_ptr<ThreadPool> _base_compaction_key_range_pool;
+    // copies the files of storage medium migrations in parallel
+    std::unique_ptr<ThreadPool> _storage_migration_copy_pool;
+    // shared by the copies of all the storage medium migrations
+    BandwidthLimiter _storage_migration_limiter;
 
     CompactionPermitLimiter _permit_limiter;
+    CompactionIOLimiter _io_limiter;
 
     std::mutex _tablet_submitted_compaction_mutex;
     std::map<DataDir*, vector<TTabletId>> _tablet_submitted_compaction;
 
+    // converts alpha rowsets to beta rowsets, see RowsetConversion
+    std::unique_ptr<ThreadPool> _rowset_conversion_thread_pool;
+    std::mutex _tablet_submitted_conversion_mutex;
+    std::map<DataDir*, std::set<TTabletId>> _tablet_submitted_conversion;
+
+    // builds the indexes rowsets miss, see TabletIndexBuilder
+    std::unique_ptr<ThreadPool> _index_build_thread_pool;
+    std::mutex _tablet_submitted_index_build_mutex;
+    std::map<DataDir*, std::set<TTabletId>> _tablet_submitted_index_build;
+
     AtomicInt32 _wakeup_producer_flag;
 
     std::mutex _compaction_producer_sleep_mutex;
@@ -30,14 +30,22 @@
 
 #include "olap/base_compaction.h"
 #include "olap/cumulative_compaction.h"
+#include "olap/delete_handler.h"
 #include "olap/olap_common.h"
 #include "olap/olap_define.h"
 #include "olap/reader.h"
+#include "olap/row_block2.h"
 #include "olap/row_cursor.h"
+#include "olap/rowset/beta_rowset.h"
 #include "olap/rowset/rowset_factory.h"
 #include "olap/rowset/rowset_meta_manager.h"
+#include "olap/rowset/segment_v2/primary_key_index.h"
+#include "olap/rowset/segment_v2/segment.h"
+#include "olap/schema.h"
 #include "olap/storage_engine.h"
 #include "olap/tablet_meta_manager.h"
+#include "runtime/mem_pool.h"
+#include "runtime/mem_tracker.h"
 #include "util/path_util.h"
 #include "util/pretty_printer.h"
 #include "util/scoped_cleanup.h"
@@ -153,10 +161,22 @@ void Tablet::save_meta() {
 }
 
 OLAPStatus Tablet::revise_tablet_meta(const std::vector<RowsetMetaSharedPtr>& rowsets_to_clone,
-                                      const std::vector<Version>& versions_to_delete) {
+                                      const std::vector<Version>& versions_to_delete,
+                                      const DeleteBitmap* cloned_delete_bitmap) {
     LOG(INFO) << "begin to clone data to tablet. tablet=" << full_name()
               << ", rowsets_to_clone=" << rowsets_to_clone.size()
               << ", versions_to_delete_size=" << versions_to_delete.size();
+    std::vector<RowsetSharedPtr> cloned_rowsets;
+    for (auto& rs_meta : rowsets_to_clone) {
+        RowsetSharedPtr rowset;
+        OLAPStatus res = RowsetFactory::create_rowset(&_schema, _tablet_path, rs_meta, &rowset);
+        if (res != OLAP_SUCCESS) {
+            LOG(WARNING) << "fail to init rowset. version=" << rs_meta->version();
+            return res;
+        }
+        cloned_rowsets.push_back(std::move(rowset));
+    }
+
     OLAPStatus res = OLAP_SUCCESS;
     do {
         // load new local tablet_meta to operate on
@@ -169,6 +189,10 @@ OLAPStatus Tablet::revise_tablet_meta(const std::vector<RowsetMetaSharedPtr>& ro
             if (new_tablet_meta->version_for_delete_predicate(version)) {
                 new_tablet_meta->remove_delete_predicate_by_version(version);
             }
+            auto it = _rs_version_map.find(version);
+            if (it != _rs_version_map.end()) {
+                new_tablet_meta->delete_bitmap().remove(it->second->rowset_id());
+            }
             LOG(INFO) << "delete version from new local tablet_meta when clone. [table="
                       << full_name() << ", version=" << version << "]";
         }
@@ -176,6 +200,27 @@ OLAPStatus Tablet::revise_tablet_meta(const std::vector<RowsetMetaSharedPtr>& ro
         for (auto& rs_meta : rowsets_to_clone) {
             new_tablet_meta->add_rs_meta(rs_meta);
         }
+        if (enable_unique_key_merge_on_write() && !cloned_rowsets.empty()) {
+            std::vector<RowsetSharedPtr> kept_rowsets;
+            for (auto& it : _rs_version_map) {
+                if (std::find(versions_to_delete.begin(), versions_to_delete.end(),
+                              it.first) == versions_to_delete.end()) {
+                    kept_rowsets.push_back(it.second);
+                }
+            }
+            res = _calc_delete_bitmap_of_cloned_rowsets(cloned_rowsets, kept_rowsets,
+                                                        cloned_delete_bitmap,
+                                                        &new_tablet_meta->delete_bitmap());
+            if (res != OLAP_SUCCESS) {
+                LOG(WARNING) << "failed to calc delete bitmap when clone. res:" << res;
+                break;
+            }
+        }
+        // the deletes resolved into the delete bitmap are not cloned, the rowsets cloned
+        // may have the deleted rows
+        if (!rowsets_to_clone.empty()) {
+            new_tablet_meta->clear_delete_by_bitmap();
+        }
         VLOG(3) << "load rowsets successfully when clone. tablet=" << full_name()
                 << ", added rowset size=" << rowsets_to_clone.size();
         // save and reload tablet_meta
@@ -186,6 +231,9 @@ OLAPStatus Tablet::revise_tablet_meta(const std::vector<RowsetMetaSharedPtr>& ro
         }
         _tablet_meta = new_tablet_meta;
     } while (0);
+    if (res != OLAP_SUCCESS) {
+        return res;
+    }
 
     for (auto& version : versions_to_delete) {
         auto it = _rs_version_map.find(version);
@@ -198,15 +246,8 @@ OLAPStatus Tablet::revise_tablet_meta(const std::vector<RowsetMetaSharedPtr>& ro
     }
     _inc_rs_version_map.clear();
 
-    for (auto& rs_meta : rowsets_to_clone) {
-        Version version = {rs_meta->start_version(), rs_meta->end_version()};
-        RowsetSharedPtr rowset;
-        res = RowsetFactory::create_rowset(&_schema, _tablet_path, rs_meta, &rowset);
-        if (res != OLAP_SUCCESS) {
-            LOG(WARNING) << "fail to init rowset. version=" << version;
-            return res;
-        }
-        _rs_version_map[version] = std::move(rowset);
+    for (auto& rowset : cloned_rowsets) {
+        _rs_version_map[rowset->version()] = rowset;
     }
 
     // reconstruct from tablet meta
@@ -218,6 +259,48 @@ OLAPStatus Tablet::revise_tablet_meta(const std::vector<RowsetMetaSharedPtr>& ro
     return res;
 }
 
+OLAPStatus Tablet::_calc_delete_bitmap_of_cloned_rowsets(
+        const std::vector<RowsetSharedPtr>& cloned_rowsets,
+        const std::vector<RowsetSharedPtr>& kept_rowsets,
+        const DeleteBitmap* cloned_delete_bitmap, DeleteBitmap* delete_bitmap) {
+    std::vector<RowsetSharedPtr> rowsets = cloned_rowsets;
+    std::sort(rowsets.begin(), rowsets.end(),
+              [](const RowsetSharedPtr& a, const RowsetSharedPtr& b) {
+                  return a->end_version() < b->end_version();
+              });
+    // the visible rowsets older than the next cloned one
+    std::vector<RowsetSharedPtr> targets;
+    for (auto& rowset : rowsets) {
+        targets.clear();
+        for (auto& kept : kept_rowsets) {
+            if (kept->end_version() < rowset->start_version()) {
+                targets.push_back(kept);
+            }
+        }
+        if (cloned_delete_bitmap != nullptr) {
+            // the rows of the cloned rowsets replaced by the later cloned ones, or in their
+            // own former segments, are in the cloned delete bitmap already. Only the rows
+            // of the local rowsets kept are looked up, which may be marked again by a later
+            // rowset than the one replacing them, and it does no harm.
+            delete_bitmap->merge(*cloned_delete_bitmap, rowset->rowset_id());
+            RETURN_NOT_OK(calc_delete_bitmap(rowset, targets, rowset->end_version(), false,
+                                             delete_bitmap));
+        } else {
+            // an incremental clone adds the missed versions after the local ones, since
+            // merge-on-write versions are published in order. They are looked up one by one
+            // in version order, as if they were published.
+            for (auto& cloned : rowsets) {
+                if (cloned->end_version() < rowset->start_version()) {
+                    targets.push_back(cloned);
+                }
+            }
+            RETURN_NOT_OK(calc_delete_bitmap(rowset, targets, rowset->end_version(), true,
+                                             delete_bitmap));
+        }
+    }
+    return OLAP_SUCCESS;
+}
+
 OLAPStatus Tablet::add_rowset(RowsetSharedPtr rowset, bool need_persist) {
     DCHECK(rowset != nullptr);
     WriteLock wrlock(&_meta_lock);
@@ -229,6 +312,11 @@ OLAPStatus Tablet::add_rowset(RowsetSharedPtr rowset, bool need_persist) {
     // Otherwise, the version should be not contained in any existing rowset.
     RETURN_NOT_OK(_contains_version(rowset->version()));
 
+    // the delete bitmap is computed only when publishing
+    if (rowset->rowset_meta()->has_delete_predicate() &&
+        rowset->rowset_meta()->delete_predicate().by_bitmap()) {
+        rowset->rowset_meta()->mutable_delete_predicate()->set_by_bitmap(false);
+    }
     RETURN_NOT_OK(_tablet_meta->add_rs_meta(rowset->rowset_meta()));
     _rs_version_map[rowset->version()] = rowset;
     _timestamped_version_tracker.add_version(rowset->version());
@@ -324,6 +412,14 @@ const RowsetSharedPtr Tablet::get_inc_rowset_by_version(const Version& version)
 }
 
 // Already under _meta_lock
+void Tablet::get_rowsets_after_version(int64_t version, vector<RowsetSharedPtr>* rowsets) const {
+    for (auto& it : _rs_version_map) {
+        if (it.first.first > version) {
+            rowsets->push_back(it.second);
+        }
+    }
+}
+
 const RowsetSharedPtr Tablet::rowset_with_max_version() const {
     Version max_version = _tablet_meta->max_version();
     if (max_version.first == -1) {
@@ -356,12 +452,79 @@ RowsetSharedPtr Tablet::_rowset_with_largest_size() {
 // add inc rowset should not persist tablet meta, because it will be persisted when publish txn.
 OLAPStatus Tablet::add_inc_rowset(const RowsetSharedPtr& rowset) {
     DCHECK(rowset != nullptr);
+    // rows of the visible rowsets replaced by `rowset`, and rows of `rowset` deleted by the
+    // newer deletes by bitmap
+    DeleteBitmap delete_bitmap;
+    // a delete by bitmap may be published on any tablet, so the update lock is always held
+    std::lock_guard<std::mutex> update_lock(_rowset_update_lock);
+    bool delete_by_bitmap = rowset->rowset_meta()->has_delete_predicate() &&
+                            rowset->rowset_meta()->delete_predicate().by_bitmap();
+    std::vector<RowsetSharedPtr> rowsets;
+    DelPredicateArray delete_predicates;
+    {
+        ReadLock rdlock(&_meta_lock);
+        if (_contains_rowset(rowset->rowset_id())) {
+            return OLAP_SUCCESS;
+        }
+        if (enable_unique_key_merge_on_write()) {
+            RETURN_NOT_OK(_check_publish_order_unlocked(rowset->version()));
+        }
+        if (enable_unique_key_merge_on_write() || delete_by_bitmap) {
+            for (auto& it : _rs_version_map) {
+                rowsets.push_back(it.second);
+            }
+        }
+        delete_predicates = _tablet_meta->delete_predicates();
+    }
+    if (enable_unique_key_merge_on_write()) {
+        RETURN_NOT_OK(calc_delete_bitmap(rowset, rowsets, rowset->end_version(), true,
+                                         &delete_bitmap));
+    }
+    if (delete_by_bitmap) {
+        // the version of the predicate is decided when publishing
+        DeletePredicatePB delete_predicate = rowset->rowset_meta()->delete_predicate();
+        delete_predicate.set_version(rowset->start_version());
+        DeleteBitmap deleted_rows;
+        if (calc_delete_bitmap_by_predicate(tablet_schema(), delete_predicate, rowsets,
+                                            &deleted_rows) == OLAP_SUCCESS) {
+            delete_bitmap.merge(deleted_rows);
+        } else {
+            // e.g. there are alpha rowsets, evaluate the predicate when reading instead
+            LOG(INFO) << "fall back to delete by predicate, tablet=" << full_name()
+                      << ", version=" << rowset->version();
+            rowset->rowset_meta()->mutable_delete_predicate()->set_by_bitmap(false);
+        }
+    }
+    // Publishes are not ordered, the deletes by bitmap published before `rowset` but newer
+    // than it have not marked its rows
+    bool newer_deletes_by_bitmap_failed = false;
+    for (auto& delete_predicate : delete_predicates) {
+        if (!delete_predicate.by_bitmap() || delete_predicate.version() <= rowset->end_version()) {
+            continue;
+        }
+        DeleteBitmap deleted_rows;
+        if (calc_delete_bitmap_by_predicate(tablet_schema(), delete_predicate, {rowset},
+                                            &deleted_rows) != OLAP_SUCCESS) {
+            newer_deletes_by_bitmap_failed = true;
+            break;
+        }
+        delete_bitmap.merge(deleted_rows);
+    }
+
     WriteLock wrlock(&_meta_lock);
     if (_contains_rowset(rowset->rowset_id())) {
         return OLAP_SUCCESS;
     }
     RETURN_NOT_OK(_contains_version(rowset->version()));
 
+    // the replaced rows must be deleted once `rowset` is visible
+    _tablet_meta->delete_bitmap().merge(delete_bitmap);
+    if (newer_deletes_by_bitmap_failed) {
+        // e.g. `rowset` is an alpha rowset, evaluate the deletes when reading instead
+        LOG(INFO) << "fall back to delete by predicate, tablet=" << full_name()
+                  << ", rowset version=" << rowset->version();
+        _tablet_meta->clear_delete_by_bitmap();
+    }
     RETURN_NOT_OK(_tablet_meta->add_rs_meta(rowset->rowset_meta()));
     _rs_version_map[rowset->version()] = rowset;
     _inc_rs_version_map[rowset->version()] = rowset;
@@ -373,6 +536,24 @@ OLAPStatus Tablet::add_inc_rowset(const RowsetSharedPtr& rowset) {
     return OLAP_SUCCESS;
 }
 
+OLAPStatus Tablet::check_publish_order(const Version& version) const {
+    ReadLock rdlock(&_meta_lock);
+    return _check_publish_order_unlocked(version);
+}
+
+OLAPStatus Tablet::_check_publish_order_unlocked(const Version& version) const {
+    if (check_version_exist(version)) {
+        return OLAP_SUCCESS;
+    }
+    Version max_version = _tablet_meta->max_version();
+    if (version.first != max_version.second + 1) {
+        LOG(INFO) << "version is not published in order, tablet=" << full_name()
+                  << ", version=" << version << ", max_version=" << max_version;
+        return OLAP_ERR_PUBLISH_VERSION_NOT_CONTINUOUS;
+    }
+    return OLAP_SUCCESS;
+}
+
 void Tablet::_delete_inc_rowset_by_version(const Version& version,
                                            const VersionHash& version_hash) {
     // delete incremental rowset from map
@@ -392,6 +573,7 @@ void Tablet::_delete_stale_rowset_by_version(const Version& version) {
         return;
     }
     _tablet_meta->delete_stale_rs_meta_by_version(version);
+    _tablet_meta->delete_bitmap().remove(rowset_meta->rowset_id());
     VLOG(3) << "delete stale rowset. tablet=" << full_name() << ", version=" << version;
 }
 
@@ -771,6 +953,10 @@ const uint32_t Tablet::_calc_cumulative_compaction_score() const {
 }
 
 const uint32_t Tablet::_calc_base_compaction_score() const {
+    if (_cumulative_compaction_policy != nullptr &&
+        !_cumulative_compaction_policy->need_base_compaction(this)) {
+        return 0;
+    }
     uint32_t score = 0;
     const int64_t point = cumulative_layer_point();
     bool base_rowset_exist = false;
@@ -1177,7 +1363,8 @@ void Tablet::do_tablet_meta_checkpoint() {
     LOG(INFO) << "start to do tablet meta checkpoint, tablet=" << full_name();
     save_meta();
     // if save meta successfully, then should remove the rowset meta existing in tablet
-    // meta from rowset meta store
+    // meta from rowset meta store, in one write batch
+    std::vector<RowsetId> rowset_ids_to_remove;
     for (auto& rs_meta : _tablet_meta->all_rs_metas()) {
         // If we delete it from rowset manager's meta explicitly in previous checkpoint, just skip.
         if (rs_meta->is_remove_from_rowset_meta()) {
@@ -1185,7 +1372,7 @@ void Tablet::do_tablet_meta_checkpoint() {
         }
         if (RowsetMetaManager::check_rowset_meta(_data_dir->get_meta(), tablet_uid(),
                                                  rs_meta->rowset_id())) {
-            RowsetMetaManager::remove(_data_dir->get_meta(), tablet_uid(), rs_meta->rowset_id());
+            rowset_ids_to_remove.push_back(rs_meta->rowset_id());
             LOG(INFO) << "remove rowset id from meta store because it is already persistent with "
                          "tablet meta"
                       << ", rowset_id=" << rs_meta->rowset_id();
@@ -1201,13 +1388,14 @@ void Tablet::do_tablet_meta_checkpoint() {
         }
         if (RowsetMetaManager::check_rowset_meta(_data_dir->get_meta(), tablet_uid(),
                                                  rs_meta->rowset_id())) {
-            RowsetMetaManager::remove(_data_dir->get_meta(), tablet_uid(), rs_meta->rowset_id());
+            rowset_ids_to_remove.push_back(rs_meta->rowset_id());
             LOG(INFO) << "remove rowset id from meta store because it is already persistent with "
                          "tablet meta"
                       << ", rowset_id=" << rs_meta->rowset_id();
         }
         rs_meta->set_remove_from_rowset_meta();
     }
+    RowsetMetaManager::remove(_data_dir->get_meta(), tablet_uid(), rowset_ids_to_remove);
 
     _newly_created_rowset_num = 0;
     _last_checkpoint_time = UnixMillis();
@@ -1292,6 +1480,24 @@ void Tablet::build_tablet_report_info(TTabletInfo* tablet_info) {
     tablet_info->__set_is_in_memory(_tablet_meta->tablet_schema().is_in_memory());
 }
 
+void Tablet::set_column_statistics(int64_t version, std::vector<TColumnStatistics> stats) {
+    std::lock_guard<std::mutex> l(_column_statistics_lock);
+    _column_statistics_version = version;
+    _column_statistics = std::move(stats);
+}
+
+void Tablet::get_column_statistics(int64_t* version,
+                                   std::vector<TColumnStatistics>* stats) const {
+    std::lock_guard<std::mutex> l(_column_statistics_lock);
+    *version = _column_statistics_version;
+    *stats = _column_statistics;
+}
+
+int64_t Tablet::column_statistics_version() const {
+    std::lock_guard<std::mutex> l(_column_statistics_lock);
+    return _column_statistics_version;
+}
+
 // should use this method to get a copy of current tablet meta
 // there are some rowset meta in local meta store and in in-memory tablet meta
 // but not in tablet meta in local meta store
@@ -1428,4 +1634,213 @@ void Tablet::execute_compaction(CompactionType compaction_type) {
     }
 }
 
+// Load the segments of `rowset` and their primary key indexes.
+static OLAPStatus load_pk_segments(const RowsetSharedPtr& rowset,
+                                   std::vector<segment_v2::SegmentSharedPtr>* segments) {
+    if (rowset->rowset_meta()->rowset_type() != BETA_ROWSET) {
+        LOG(WARNING) << "merge-on-write needs beta rowset, rowset=" << rowset->rowset_id();
+        return OLAP_ERR_ROWSET_INVALID;
+    }
+    std::vector<segment_v2::SegmentSharedPtr> rowset_segments;
+    RETURN_NOT_OK(std::static_pointer_cast<BetaRowset>(rowset)->load_segments(&rowset_segments));
+    for (auto& segment : rowset_segments) {
+        Status st = segment->load_pk_index();
+        if (!st.ok()) {
+            LOG(WARNING) << "failed to load primary key index, rowset=" << rowset->rowset_id()
+                         << ", segment=" << segment->id() << ", st=" << st.to_string();
+            return OLAP_ERR_ROWSET_LOAD_FAILED;
+        }
+        segments->push_back(segment);
+    }
+    return OLAP_SUCCESS;
+}
+
+static OLAPStatus new_pk_iterator(const segment_v2::SegmentSharedPtr& segment,
+                                  std::unique_ptr<segment_v2::IndexedColumnIterator>* iter) {
+    Status st = segment->primary_key_index()->new_iterator(iter);
+    if (!st.ok()) {
+        LOG(WARNING) << "failed to create primary key iterator, st=" << st.to_string();
+        return OLAP_ERR_ROWSET_READER_INIT;
+    }
+    return OLAP_SUCCESS;
+}
+
+// Look up `key` in the primary key index of `segment`, the row found is marked as
+// replaced from `version` and `*found` is set.
+static OLAPStatus lookup_and_mark(const segment_v2::SegmentSharedPtr& segment,
+                                  segment_v2::IndexedColumnIterator* iter,
+                                  const Slice& key, const RowsetId& rowset_id, int64_t version,
+                                  DeleteBitmap* delete_bitmap, bool* found) {
+    segment_v2::rowid_t row_id;
+    Status st = segment->primary_key_index()->lookup_row_id(iter, key, &row_id);
+    if (st.is_not_found()) {
+        return OLAP_SUCCESS;
+    }
+    if (!st.ok()) {
+        LOG(WARNING) << "failed to look up primary key, rowset=" << rowset_id
+                     << ", st=" << st.to_string();
+        return OLAP_ERR_ROWSET_READ_FAILED;
+    }
+    delete_bitmap->add({rowset_id, static_cast<uint32_t>(segment->id()), version}, row_id);
+    *found = true;
+    return OLAP_SUCCESS;
+}
+
+OLAPStatus Tablet::calc_delete_bitmap(const RowsetSharedPtr& rowset,
+                                      const std::vector<RowsetSharedPtr>& target_rowsets,
+                                      int64_t version, bool check_own_segments,
+                                      DeleteBitmap* delete_bitmap) {
+    if (rowset->num_rows() == 0) {
+        return OLAP_SUCCESS;
+    }
+    std::vector<segment_v2::SegmentSharedPtr> segments;
+    RETURN_NOT_OK(load_pk_segments(rowset, &segments));
+
+    // a key is replaced by its newest version only, so the newer rowsets are searched first
+    std::vector<RowsetSharedPtr> targets;
+    for (auto& target : target_rowsets) {
+        if (target->rowset_id() != rowset->rowset_id() && target->num_rows() > 0) {
+            targets.push_back(target);
+        }
+    }
+    std::sort(targets.begin(), targets.end(),
+              [](const RowsetSharedPtr& a, const RowsetSharedPtr& b) {
+                  return a->end_version() > b->end_version();
+              });
+    std::vector<std::pair<RowsetId, segment_v2::SegmentSharedPtr>> target_segments;
+    for (auto& target : targets) {
+        std::vector<segment_v2::SegmentSharedPtr> segs;
+        RETURN_NOT_OK(load_pk_segments(target, &segs));
+        for (auto it = segs.rbegin(); it != segs.rend(); ++it) {
+            target_segments.emplace_back(target->rowset_id(), *it);
+        }
+    }
+    std::vector<std::unique_ptr<segment_v2::IndexedColumnIterator>> target_iters(
+            target_segments.size());
+    for (size_t i = 0; i < target_segments.size(); ++i) {
+        RETURN_NOT_OK(new_pk_iterator(target_segments[i].second, &target_iters[i]));
+    }
+
+    static const size_t kBatchSize = 1024;
+    auto tracker = std::make_shared<MemTracker>(-1, "calc delete bitmap");
+    MemPool pool(tracker.get());
+    std::vector<Slice> keys;
+    for (size_t seg_idx = 0; seg_idx < segments.size(); ++seg_idx) {
+        const segment_v2::PrimaryKeyIndexReader* pk_index = segments[seg_idx]->primary_key_index();
+        std::unique_ptr<segment_v2::IndexedColumnIterator> iter;
+        RETURN_NOT_OK(new_pk_iterator(segments[seg_idx], &iter));
+        // iterators of the former segments of `rowset`, the latest first
+        std::vector<std::unique_ptr<segment_v2::IndexedColumnIterator>> own_iters;
+        if (check_own_segments) {
+            for (size_t i = seg_idx; i > 0; --i) {
+                own_iters.emplace_back();
+                RETURN_NOT_OK(new_pk_iterator(segments[i - 1], &own_iters.back()));
+            }
+        }
+
+        for (segment_v2::rowid_t from = 0; from < pk_index->num_rows(); from += keys.size()) {
+            size_t n = kBatchSize;
+            keys.clear();
+            pool.clear();
+            Status st = pk_index->read_keys(iter.get(), from, &n, &pool, &keys);
+            if (!st.ok() || n == 0) {
+                LOG(WARNING) << "failed to read primary keys, rowset=" << rowset->rowset_id()
+                             << ", st=" << st.to_string();
+                return OLAP_ERR_ROWSET_READ_FAILED;
+            }
+            for (auto& key : keys) {
+                // the first index containing the key holds its latest version
+                bool found = false;
+                for (size_t i = 0; i < own_iters.size() && !found; ++i) {
+                    RETURN_NOT_OK(lookup_and_mark(segments[seg_idx - 1 - i], own_iters[i].get(),
+                                                  key, rowset->rowset_id(), version,
+                                                  delete_bitmap, &found));
+                }
+                for (size_t i = 0; i < target_segments.size() && !found; ++i) {
+                    RETURN_NOT_OK(lookup_and_mark(target_segments[i].second,
+                                                  target_iters[i].get(), key,
+                                                  target_segments[i].first, version,
+                                                  delete_bitmap, &found));
+                }
+            }
+        }
+    }
+    return OLAP_SUCCESS;
+}
+
+OLAPStatus Tablet::calc_delete_bitmap_by_predicate(const TabletSchema& tablet_schema,
+                                                   const DeletePredicatePB& delete_predicate,
+                                                   const std::vector<RowsetSharedPtr>& rowsets,
+                                                   DeleteBitmap* delete_bitmap) {
+    int64_t version = delete_predicate.version();
+    DelPredicateArray del_preds;
+    DeletePredicatePB* del_pred = del_preds.Add();
+    *del_pred = delete_predicate;
+    del_pred->set_by_bitmap(false);
+    DeleteHandler delete_handler;
+    SCOPED_CLEANUP({ delete_handler.finalize(); });
+    RETURN_NOT_OK(delete_handler.init(tablet_schema, del_preds, version));
+    const Conditions* conditions = delete_handler.get_delete_conditions()[0].del_cond;
+
+    // only the columns of the predicate are read, all rows of a segment in order
+    Schema schema(tablet_schema.columns(), conditions->delete_condition_columns());
+    static const uint16_t kBatchSize = 1024;
+    RowBlockV2 block(schema, kBatchSize);
+    uint16_t sel[kBatchSize];
+    for (auto& rowset : rowsets) {
+        if (rowset->end_version() >= version || rowset->num_rows() == 0) {
+            continue;
+        }
+        if (rowset->rowset_meta()->rowset_type() != BETA_ROWSET) {
+            LOG(WARNING) << "delete by bitmap needs beta rowset, rowset=" << rowset->rowset_id();
+            return OLAP_ERR_ROWSET_INVALID;
+        }
+        std::vector<segment_v2::SegmentSharedPtr> segments;
+        RETURN_NOT_OK(std::static_pointer_cast<BetaRowset>(rowset)->load_segments(&segments));
+        for (auto& segment : segments) {
+            OlapReaderStatistics stats;
+            StorageReadOptions read_options;
+            read_options.stats = &stats;
+            std::unique_ptr<RowwiseIterator> iter;
+            Status st = segment->new_iterator(schema, read_options, &iter);
+            if (!st.ok()) {
+                LOG(WARNING) << "failed to create segment iterator, rowset="
+                             << rowset->rowset_id() << ", st=" << st.to_string();
+                return OLAP_ERR_ROWSET_READER_INIT;
+            }
+            segment_v2::rowid_t row_id = 0;
+            while (true) {
+                block.clear();
+                st = iter->next_batch(&block);
+                if (st.is_end_of_file()) {
+                    break;
+                }
+                if (!st.ok()) {
+                    LOG(WARNING) << "failed to read segment, rowset=" << rowset->rowset_id()
+                                 << ", st=" << st.to_string();
+                    return OLAP_ERR_ROWSET_READ_FAILED;
+                }
+                uint16_t num_rows = block.num_rows();
+                for (uint16_t i = 0; i < num_rows; ++i) {
+                    sel[i] = i;
+                }
+                // the rows left in `sel` are not deleted
+                uint16_t num_kept = num_rows;
+                conditions->delete_conditions_eval(block, sel, &num_kept);
+                for (uint16_t i = 0, j = 0; i < num_rows; ++i) {
+                    if (j < num_kept && sel[j] == i) {
+                        ++j;
+                    } else {
+                        delete_bitmap->add({rowset->rowset_id(),
+                                            static_cast<uint32_t>(segment->id()), version},
+                                           row_id + i);
+                    }
+                }
+                row_id += num_rows;
+            }
+        }
+    }
+    return OLAP_SUCCESS;
+}
+
 }  // namespace doris
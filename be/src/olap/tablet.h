@@ -19,12 +19,14 @@
 #define DORIS_BE_SRC_OLAP_TABLET_H
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
 #include "gen_cpp/AgentService_types.h"
+#include "gen_cpp/BackendService_types.h"
 #include "gen_cpp/MasterService_types.h"
 #include "gen_cpp/olap_file.pb.h"
 #include "olap/base_tablet.h"
@@ -67,9 +69,13 @@ public:
     void deregister_tablet_from_dir();
 
     void save_meta();
-    // Used in clone task, to update local meta when finishing a clone job
+    // Used in clone task, to update local meta when finishing a clone job.
+    // For a merge-on-write tablet, `cloned_delete_bitmap` is the delete bitmap of the cloned
+    // tablet meta in a full clone, and nullptr in an incremental clone, whose rowsets are
+    // looked up here instead. The rowset update lock must be held for such a tablet.
     OLAPStatus revise_tablet_meta(const std::vector<RowsetMetaSharedPtr>& rowsets_to_clone,
-                                  const std::vector<Version>& versions_to_delete);
+                                  const std::vector<Version>& versions_to_delete,
+                                  const DeleteBitmap* cloned_delete_bitmap = nullptr);
 
     inline const int64_t cumulative_layer_point() const;
     inline void set_cumulative_layer_point(int64_t new_point);
@@ -92,6 +98,7 @@ public:
     inline size_t next_unique_id() const;
     inline size_t row_size() const;
     inline int32_t field_index(const string& field_name) const;
+    inline bool enable_unique_key_merge_on_write() const;
 
     // operation in rowsets
     OLAPStatus add_rowset(RowsetSharedPtr rowset, bool need_persist = true);
@@ -103,6 +110,8 @@ public:
     const RowsetSharedPtr get_rowset_by_version(const Version& version) const;
     const RowsetSharedPtr get_inc_rowset_by_version(const Version& version) const;
     const RowsetSharedPtr get_stale_rowset_by_version(const Version& version) const;
+    // rowsets in _rs_version_map whose start version is larger than `version`
+    void get_rowsets_after_version(int64_t version, vector<RowsetSharedPtr>* rowsets) const;
 
     const RowsetSharedPtr rowset_with_max_version() const;
 
@@ -235,6 +244,12 @@ public:
 
     void build_tablet_report_info(TTabletInfo* tablet_info);
 
+    // The column statistics collected from `version', see TabletColumnStatisticsCollector.
+    // The version is -1 if no statistics have been collected.
+    void set_column_statistics(int64_t version, std::vector<TColumnStatistics> stats);
+    void get_column_statistics(int64_t* version, std::vector<TColumnStatistics>* stats) const;
+    int64_t column_statistics_version() const;
+
     void generate_tablet_meta_copy(TabletMetaSharedPtr new_tablet_meta) const;
     // caller should hold the _meta_lock before calling this method
     void generate_tablet_meta_copy_unlocked(TabletMetaSharedPtr new_tablet_meta) const;
@@ -250,15 +265,48 @@ public:
     void set_clone_occurred(bool clone_occurred) { _is_clone_occurred = clone_occurred; }
     bool get_clone_occurred() { return _is_clone_occurred; }
 
+    // Merge-on-write only. The keys of a rowset are looked up in the visible rowsets when
+    // it's published, which must all be older than it, so the versions are published in
+    // order. Returns OLAP_ERR_PUBLISH_VERSION_NOT_CONTINUOUS if `version` neither exists
+    // nor is the next version of the tablet, then it should be published again later.
+    OLAPStatus check_publish_order(const Version& version) const;
+
+    // Publishing a load, clone and replacing the rowsets of a compaction hold it while the
+    // delete bitmap is computed, so that no rowset is added or removed meanwhile.
+    std::mutex* get_rowset_update_lock() { return &_rowset_update_lock; }
+
+    // Merge-on-write only. Look up the keys of `rowset` in `target_rowsets` and mark the
+    // rows found in `delete_bitmap` as replaced at `version`. If `check_own_segments`,
+    // a key is looked up in the former segments of `rowset` as well, which are replaced
+    // by the later ones.
+    static OLAPStatus calc_delete_bitmap(const RowsetSharedPtr& rowset,
+                                         const std::vector<RowsetSharedPtr>& target_rowsets,
+                                         int64_t version, bool check_own_segments,
+                                         DeleteBitmap* delete_bitmap);
+
+    // Mark the rows of the beta rowsets among `rowsets` older than `delete_predicate`
+    // which match it in `delete_bitmap` as deleted at its version.
+    static OLAPStatus calc_delete_bitmap_by_predicate(const TabletSchema& tablet_schema,
+                                                      const DeletePredicatePB& delete_predicate,
+                                                      const std::vector<RowsetSharedPtr>& rowsets,
+                                                      DeleteBitmap* delete_bitmap);
+
 private:
     OLAPStatus _init_once_action();
     void _print_missed_versions(const std::vector<Version>& missed_versions) const;
     bool _contains_rowset(const RowsetId rowset_id);
+    OLAPStatus _check_publish_order_unlocked(const Version& version) const;
     OLAPStatus _contains_version(const Version& version);
     void _max_continuous_version_from_beginning_unlocked(Version* version,
                                                          VersionHash* v_hash) const;
     RowsetSharedPtr _rowset_with_largest_size();
     void _delete_inc_rowset_by_version(const Version& version, const VersionHash& version_hash);
+    // Merge-on-write only. Mark the rows replaced by the rowsets cloned into `delete_bitmap`,
+    // see revise_tablet_meta(). `kept_rowsets` are the local rowsets which stay visible.
+    OLAPStatus _calc_delete_bitmap_of_cloned_rowsets(
+            const std::vector<RowsetSharedPtr>& cloned_rowsets,
+            const std::vector<RowsetSharedPtr>& kept_rowsets,
+            const DeleteBitmap* cloned_delete_bitmap, DeleteBitmap* delete_bitmap);
     /// Delete stale rowset by version. This method not only delete the version in expired rowset map,
     /// but also delete the version in rowset meta vector.
     void _delete_stale_rowset_by_version(const Version& version);
@@ -282,6 +330,7 @@ private:
     Mutex _base_lock;
     Mutex _cumulative_lock;
     RWMutex _migration_lock;
+    std::mutex _rowset_update_lock;
 
     // TODO(lingbin): There is a _meta_lock TabletMeta too, there should be a comment to
     // explain how these two locks work together.
@@ -334,6 +383,10 @@ private:
     // whether clone task occurred during the tablet is in thread pool queue to wait for compaction
     std::atomic<bool> _is_clone_occurred;
 
+    mutable std::mutex _column_statistics_lock;
+    int64_t _column_statistics_version = -1;
+    std::vector<TColumnStatistics> _column_statistics;
+
     DISALLOW_COPY_AND_ASSIGN(Tablet);
 
 public:
@@ -395,6 +448,10 @@ inline KeysType Tablet::keys_type() const {
     return _schema.keys_type();
 }
 
+inline bool Tablet::enable_unique_key_merge_on_write() const {
+    return _schema.enable_unique_key_merge_on_write();
+}
+
 inline size_t Tablet::num_columns() const {
     return _schema.num_columns();
 }
@@ -0,0 +1,191 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/tablet_column_statistics.h"
+
+#include <algorithm>
+
+#include "common/config.h"
+#include "olap/hll.h"
+#include "olap/rowset/beta_rowset.h"
+#include "olap/rowset/segment_v2/segment.h"
+
+namespace doris {
+
+TabletColumnStatisticsCollector::TabletColumnStatisticsCollector(TabletSharedPtr tablet)
+        : _tablet(std::move(tablet)) {}
+
+OLAPStatus TabletColumnStatisticsCollector::collect(int64_t* version,
+                                                    std::vector<TColumnStatistics>* stats) {
+    std::vector<RowsetSharedPtr> rowsets;
+    {
+        ReadLock rdlock(_tablet->get_header_lock_ptr());
+        *version = _tablet->max_version().second;
+        RETURN_NOT_OK(_tablet->capture_consistent_rowsets(Version(0, *version), &rowsets));
+    }
+    std::vector<segment_v2::SegmentSharedPtr> segments;
+    for (auto& rowset : rowsets) {
+        if (rowset->num_rows() == 0) {
+            continue;
+        }
+        if (rowset->rowset_meta()->rowset_type() != BETA_ROWSET) {
+            VLOG(3) << "column statistics need beta rowsets, tablet=" << _tablet->full_name()
+                    << ", rowset=" << rowset->rowset_id();
+            return OLAP_ERR_ROWSET_TYPE_NOT_FOUND;
+        }
+        std::vector<segment_v2::SegmentSharedPtr> rowset_segments;
+        RETURN_NOT_OK(std::static_pointer_cast<BetaRowset>(rowset)->load_segments(
+                &rowset_segments));
+        segments.insert(segments.end(), rowset_segments.begin(), rowset_segments.end());
+    }
+
+    stats->clear();
+    const TabletSchema& tablet_schema = _tablet->tablet_schema();
+    for (uint32_t cid = 0; cid < tablet_schema.num_columns(); ++cid) {
+        FieldType type = tablet_schema.column(cid).type();
+        if (type == OLAP_FIELD_TYPE_ARRAY || type == OLAP_FIELD_TYPE_HLL ||
+            type == OLAP_FIELD_TYPE_OBJECT) {
+            continue;
+        }
+        TColumnStatistics column_stats;
+        RETURN_NOT_OK(_collect_column(cid, segments, &column_stats));
+        if (column_stats.__isset.ndv || column_stats.__isset.min_value) {
+            stats->push_back(std::move(column_stats));
+        }
+    }
+    return OLAP_SUCCESS;
+}
+
+OLAPStatus TabletColumnStatisticsCollector::_collect_column(
+        uint32_t cid, const std::vector<segment_v2::SegmentSharedPtr>& segments,
+        TColumnStatistics* stats) {
+    const TabletColumn& column = _tablet->tablet_schema().column(cid);
+    stats->column_name = column.name();
+
+    bool has_statistics = !segments.empty();
+    uint64_t null_count = 0;
+    HyperLogLog ndv_sketch;
+    bool has_zone_maps = !segments.empty();
+    std::vector<PageRange> pages;
+    for (auto& segment : segments) {
+        if (has_statistics) {
+            uint64_t segment_null_count = 0;
+            std::string segment_ndv_sketch;
+            Status st = segment->get_column_statistics(cid, &segment_null_count,
+                                                       &segment_ndv_sketch);
+            if (st.is_not_supported()) {
+                has_statistics = false;
+            } else if (!st.ok()) {
+                LOG(WARNING) << "failed to read column statistics, tablet="
+                             << _tablet->full_name() << ", column=" << column.name()
+                             << ", st=" << st.to_string();
+                return OLAP_ERR_ROWSET_READ_FAILED;
+            } else {
+                null_count += segment_null_count;
+                ndv_sketch.merge(Slice(segment_ndv_sketch));
+            }
+        }
+        if (has_zone_maps) {
+            std::vector<segment_v2::ZoneMapPB> zone_maps;
+            std::vector<uint32_t> page_num_rows;
+            Status st = segment->get_page_zone_maps(cid, &zone_maps, &page_num_rows);
+            if (st.is_not_supported()) {
+                has_zone_maps = false;
+            } else if (!st.ok()) {
+                LOG(WARNING) << "failed to read page zone maps, tablet=" << _tablet->full_name()
+                             << ", column=" << column.name() << ", st=" << st.to_string();
+                return OLAP_ERR_ROWSET_READ_FAILED;
+            } else {
+                for (size_t i = 0; i < zone_maps.size(); ++i) {
+                    if (!zone_maps[i].has_not_null()) {
+                        continue;
+                    }
+                    PageRange page;
+                    page.min.reset(WrapperField::create(column));
+                    page.max.reset(WrapperField::create(column));
+                    if (page.min == nullptr || page.max == nullptr) {
+                        return OLAP_ERR_MALLOC_ERROR;
+                    }
+                    RETURN_NOT_OK(page.min->from_string(zone_maps[i].min()));
+                    RETURN_NOT_OK(page.max->from_string(zone_maps[i].max()));
+                    page.num_rows = page_num_rows[i];
+                    pages.push_back(std::move(page));
+                }
+            }
+        }
+    }
+
+    if (has_statistics) {
+        stats->__set_ndv(ndv_sketch.estimate_cardinality());
+        stats->__set_null_count(null_count);
+    }
+    if (has_zone_maps && !pages.empty()) {
+        const WrapperField* max_value = pages[0].max.get();
+        for (auto& page : pages) {
+            if (page.max->cmp(max_value) > 0) {
+                max_value = page.max.get();
+            }
+        }
+        stats->__set_max_value(max_value->to_string());
+        std::vector<THistogramBucket> histogram;
+        build_histogram(&pages, config::column_statistics_histogram_buckets, &histogram);
+        stats->__set_min_value(pages[0].min->to_string());
+        stats->__set_histogram(histogram);
+    }
+    return OLAP_SUCCESS;
+}
+
+void TabletColumnStatisticsCollector::build_histogram(std::vector<PageRange>* pages,
+                                                      size_t max_buckets,
+                                                      std::vector<THistogramBucket>* histogram) {
+    histogram->clear();
+    if (pages->empty() || max_buckets == 0) {
+        return;
+    }
+    std::sort(pages->begin(), pages->end(), [](const PageRange& a, const PageRange& b) {
+        return a.min->cmp(b.min.get()) < 0;
+    });
+    uint64_t num_rows = 0;
+    for (auto& page : *pages) {
+        num_rows += page.num_rows;
+    }
+    uint64_t bucket_rows = std::max<uint64_t>(1, (num_rows + max_buckets - 1) / max_buckets);
+
+    THistogramBucket bucket;
+    const WrapperField* upper = nullptr;
+    for (auto& page : *pages) {
+        if (upper == nullptr) {
+            bucket.lower = page.min->to_string();
+            bucket.count = 0;
+            upper = page.max.get();
+        } else if (page.max->cmp(upper) > 0) {
+            upper = page.max.get();
+        }
+        bucket.count += page.num_rows;
+        if (bucket.count >= bucket_rows) {
+            bucket.upper = upper->to_string();
+            histogram->push_back(bucket);
+            upper = nullptr;
+        }
+    }
+    if (upper != nullptr) {
+        bucket.upper = upper->to_string();
+        histogram->push_back(bucket);
+    }
+}
+
+} // namespace doris
@@ -0,0 +1,73 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "gen_cpp/BackendService_types.h"
+#include "olap/olap_define.h"
+#include "olap/tablet.h"
+#include "olap/wrapper_field.h"
+
+namespace doris {
+
+// Collects the statistics of the columns of a tablet for the cost-based planning of FE
+// from the segments of its latest version, without reading their data: the numbers of
+// nulls and distinct values from the statistics indexes written at flush and compaction
+// time, see StatisticsIndexWriter, and the min and max values and an equi-height histogram
+// from the zone maps of the data pages. The statistics are approximate, e.g. the rows
+// replaced in unique key tablets or deleted by delete predicates are counted until they
+// are merged by compaction.
+//
+// Usage:
+//      TabletColumnStatisticsCollector collector(tablet);
+//      int64_t version = -1;
+//      std::vector<TColumnStatistics> stats;
+//      RETURN_NOT_OK(collector.collect(&version, &stats));
+class TabletColumnStatisticsCollector {
+public:
+    explicit TabletColumnStatisticsCollector(TabletSharedPtr tablet);
+
+    // Collect the statistics of the columns of the latest version, which is set to
+    // 'version' even if it fails. A column only gets the statistics all its segments have,
+    // e.g. none of an alpha rowset.
+    OLAPStatus collect(int64_t* version, std::vector<TColumnStatistics>* stats);
+
+    // A data page whose not-null values are in [min, max]
+    struct PageRange {
+        std::unique_ptr<WrapperField> min;
+        std::unique_ptr<WrapperField> max;
+        uint32_t num_rows = 0;
+    };
+
+    // Build an equi-height histogram of at most 'max_buckets' buckets from 'pages', which
+    // are sorted by their min values. A bucket takes the pages in order until it has the
+    // rows of a bucket, so the buckets may overlap when the pages do.
+    static void build_histogram(std::vector<PageRange>* pages, size_t max_buckets,
+                                std::vector<THistogramBucket>* histogram);
+
+private:
+    OLAPStatus _collect_column(uint32_t cid,
+                               const std::vector<segment_v2::SegmentSharedPtr>& segments,
+                               TColumnStatistics* stats);
+
+    TabletSharedPtr _tablet;
+};
+
+} // namespace doris
@@ -0,0 +1,93 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/tablet_index_builder.h"
+
+#include "olap/rowset/beta_rowset.h"
+#include "olap/rowset/segment_v2/segment_index_builder.h"
+#include "olap/segment_cache.h"
+#include "util/doris_metrics.h"
+
+namespace doris {
+
+TabletIndexBuilder::TabletIndexBuilder(TabletSharedPtr tablet) : _tablet(std::move(tablet)) {}
+
+OLAPStatus TabletIndexBuilder::run() {
+    std::vector<RowsetSharedPtr> rowsets;
+    {
+        ReadLock rdlock(_tablet->get_header_lock_ptr());
+        for (auto& rs_meta : _tablet->tablet_meta()->all_rs_metas()) {
+            if (!need_build(rs_meta)) {
+                continue;
+            }
+            RowsetSharedPtr rowset = _tablet->get_rowset_by_version(rs_meta->version());
+            if (rowset != nullptr) {
+                rowsets.push_back(rowset);
+            }
+        }
+    }
+    for (auto& rowset : rowsets) {
+        RETURN_NOT_OK(_build_rowset(rowset));
+    }
+    return OLAP_SUCCESS;
+}
+
+OLAPStatus TabletIndexBuilder::_build_rowset(const RowsetSharedPtr& rowset) {
+    std::vector<segment_v2::SegmentSharedPtr> segments;
+    RETURN_NOT_OK(std::static_pointer_cast<BetaRowset>(rowset)->load_segments(&segments));
+    bool built = false;
+    for (auto& segment : segments) {
+        segment_v2::SegmentIndexBuilder builder(segment, &_tablet->tablet_schema());
+        if (!builder.need_build()) {
+            continue;
+        }
+        Status st = builder.build();
+        if (st.is_already_exist()) {
+            // the index file of the linked rowset lacks indexes, which is not expected as
+            // the files are not linked then, and the segment is just read without them
+            LOG(WARNING) << "skip building indexes of segment " << segment->id()
+                         << " of rowset " << rowset->rowset_id() << ": " << st.to_string();
+            continue;
+        }
+        if (!st.ok()) {
+            LOG(WARNING) << "failed to build indexes of segment " << segment->id()
+                         << " of rowset " << rowset->rowset_id()
+                         << ", tablet=" << _tablet->full_name() << ", st=" << st.to_string();
+            return OLAP_ERR_WRITER_DATA_WRITE_ERROR;
+        }
+        built = true;
+    }
+    if (built && SegmentCache::instance() != nullptr) {
+        // the segments are opened again with the index files
+        SegmentCache::instance()->erase(rowset->unique_id());
+    }
+
+    WriteLock wrlock(_tablet->get_header_lock_ptr());
+    RowsetSharedPtr current = _tablet->get_rowset_by_version(rowset->version());
+    if (current == nullptr || current->rowset_id() != rowset->rowset_id()) {
+        // the rowset is compacted or dropped, and its files will be removed
+        return OLAP_SUCCESS;
+    }
+    rowset->rowset_meta()->set_missing_indexes(false);
+    _tablet->save_meta();
+    DorisMetrics::instance()->index_build_rowsets_total->increment(1);
+    LOG(INFO) << "built indexes of rowset " << rowset->rowset_id()
+              << ", version=" << rowset->version() << ", tablet=" << _tablet->full_name();
+    return OLAP_SUCCESS;
+}
+
+} // namespace doris
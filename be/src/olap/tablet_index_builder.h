@@ -0,0 +1,50 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include "olap/olap_common.h"
+#include "olap/rowset/rowset.h"
+#include "olap/tablet.h"
+
+namespace doris {
+
+// Builds the bitmap and bloom filter indexes of the tablet schema into the index files of
+// the segments of the rowsets which lack them in background, see
+// RowsetMetaPB.missing_indexes and segment_v2::SegmentIndexBuilder. A rowset is marked
+// complete once the index files of all its segments are written.
+class TabletIndexBuilder {
+public:
+    explicit TabletIndexBuilder(TabletSharedPtr tablet);
+
+    // Build the indexes of all the rowsets of the tablet missing indexes
+    OLAPStatus run();
+
+    // Whether the indexes of 'rs_meta' are to be built
+    static bool need_build(const RowsetMetaSharedPtr& rs_meta) {
+        return rs_meta->rowset_type() == BETA_ROWSET && rs_meta->missing_indexes();
+    }
+
+private:
+    OLAPStatus _build_rowset(const RowsetSharedPtr& rowset);
+
+    TabletSharedPtr _tablet;
+
+    DISALLOW_COPY_AND_ASSIGN(TabletIndexBuilder);
+};
+
+} // namespace doris
@@ -40,13 +40,16 @@
 #include "olap/rowset/column_data_writer.h"
 #include "olap/rowset/rowset_factory.h"
 #include "olap/rowset/rowset_id_generator.h"
+#include "olap/rowset_conversion.h"
 #include "olap/schema_change.h"
 #include "olap/tablet.h"
+#include "olap/tablet_index_builder.h"
 #include "olap/tablet_meta.h"
 #include "olap/tablet_meta_manager.h"
 #include "olap/utils.h"
 #include "util/doris_metrics.h"
 #include "util/file_utils.h"
+#include "util/hash_util.hpp"
 #include "util/path_util.h"
 #include "util/pretty_printer.h"
 #include "util/scoped_cleanup.h"
@@ -777,6 +780,100 @@ TabletSharedPtr TabletManager::find_best_tablet_to_compaction(
     return best_tablet;
 }
 
+int64_t TabletManager::find_tablets_to_convert_rowsets(DataDir* data_dir,
+                                                       const std::set<TTabletId>& excluded,
+                                                       size_t max_num,
+                                                       std::vector<TabletSharedPtr>* tablets) {
+    int64_t num_rowsets = 0;
+    for (const auto& tablets_shard : _tablets_shards) {
+        ReadLock rlock(tablets_shard.lock.get());
+        for (const auto& tablet_map : tablets_shard.tablet_map) {
+            for (const TabletSharedPtr& tablet_ptr : tablet_map.second.table_arr) {
+                if (tablet_ptr->data_dir()->path_hash() != data_dir->path_hash() ||
+                    tablet_ptr->tablet_state() == TABLET_NOTREADY || !tablet_ptr->is_used() ||
+                    !tablet_ptr->init_succeeded() || !tablet_ptr->can_do_compaction()) {
+                    continue;
+                }
+                int64_t num_tablet_rowsets = 0;
+                {
+                    ReadLock rdlock(tablet_ptr->get_header_lock_ptr());
+                    for (auto& rs_meta : tablet_ptr->tablet_meta()->all_rs_metas()) {
+                        if (RowsetConversion::need_conversion(tablet_ptr.get(), rs_meta)) {
+                            ++num_tablet_rowsets;
+                        }
+                    }
+                }
+                num_rowsets += num_tablet_rowsets;
+                if (num_tablet_rowsets > 0 && tablets->size() < max_num &&
+                    excluded.count(tablet_ptr->tablet_id()) == 0) {
+                    tablets->push_back(tablet_ptr);
+                }
+            }
+        }
+    }
+    return num_rowsets;
+}
+
+int64_t TabletManager::find_tablets_to_build_index(DataDir* data_dir,
+                                                   const std::set<TTabletId>& excluded,
+                                                   size_t max_num,
+                                                   std::vector<TabletSharedPtr>* tablets) {
+    int64_t num_rowsets = 0;
+    for (const auto& tablets_shard : _tablets_shards) {
+        ReadLock rlock(tablets_shard.lock.get());
+        for (const auto& tablet_map : tablets_shard.tablet_map) {
+            for (const TabletSharedPtr& tablet_ptr : tablet_map.second.table_arr) {
+                if (tablet_ptr->data_dir()->path_hash() != data_dir->path_hash() ||
+                    tablet_ptr->tablet_state() == TABLET_NOTREADY || !tablet_ptr->is_used() ||
+                    !tablet_ptr->init_succeeded()) {
+                    continue;
+                }
+                int64_t num_tablet_rowsets = 0;
+                {
+                    ReadLock rdlock(tablet_ptr->get_header_lock_ptr());
+                    for (auto& rs_meta : tablet_ptr->tablet_meta()->all_rs_metas()) {
+                        if (TabletIndexBuilder::need_build(rs_meta)) {
+                            ++num_tablet_rowsets;
+                        }
+                    }
+                }
+                num_rowsets += num_tablet_rowsets;
+                if (num_tablet_rowsets > 0 && tablets->size() < max_num &&
+                    excluded.count(tablet_ptr->tablet_id()) == 0) {
+                    tablets->push_back(tablet_ptr);
+                }
+            }
+        }
+    }
+    return num_rowsets;
+}
+
+void TabletManager::find_tablets_to_collect_column_statistics(
+        size_t max_num, std::vector<TabletSharedPtr>* tablets) {
+    for (const auto& tablets_shard : _tablets_shards) {
+        ReadLock rlock(tablets_shard.lock.get());
+        for (const auto& tablet_map : tablets_shard.tablet_map) {
+            for (const TabletSharedPtr& tablet_ptr : tablet_map.second.table_arr) {
+                if (tablets->size() >= max_num) {
+                    return;
+                }
+                if (tablet_ptr->tablet_state() == TABLET_NOTREADY || !tablet_ptr->is_used() ||
+                    !tablet_ptr->init_succeeded()) {
+                    continue;
+                }
+                int64_t max_version = -1;
+                {
+                    ReadLock rdlock(tablet_ptr->get_header_lock_ptr());
+                    max_version = tablet_ptr->max_version().second;
+                }
+                if (tablet_ptr->column_statistics_version() != max_version) {
+                    tablets->push_back(tablet_ptr);
+                }
+            }
+        }
+    }
+}
+
 OLAPStatus TabletManager::load_tablet_from_meta(DataDir* data_dir, TTabletId tablet_id,
                                                 TSchemaHash schema_hash, const string& meta_binary,
                                                 bool update_meta, bool force, bool restore) {
@@ -928,7 +1025,34 @@ OLAPStatus TabletManager::report_tablet_info(TTabletInfo* tablet_info) {
     return res;
 }
 
-OLAPStatus TabletManager::report_all_tablets_info(std::map<TTabletId, TTablet>* tablets_info) {
+template <typename T>
+static void update_report_signature(const T& value, uint64_t* hash) {
+    *hash = HashUtil::hash64(&value, sizeof(value), *hash);
+}
+
+// Signature of the fields FE syncs from a tablet report
+static uint64_t tablet_report_signature(const TTablet& t_tablet) {
+    uint64_t hash = 0;
+    for (auto& info : t_tablet.tablet_infos) {
+        update_report_signature(info.schema_hash, &hash);
+        update_report_signature(info.version, &hash);
+        update_report_signature(info.version_hash, &hash);
+        update_report_signature(info.row_count, &hash);
+        update_report_signature(info.data_size, &hash);
+        update_report_signature(info.version_count, &hash);
+        update_report_signature(info.partition_id, &hash);
+        update_report_signature(info.storage_medium, &hash);
+        update_report_signature(info.path_hash, &hash);
+        update_report_signature(info.is_in_memory, &hash);
+        update_report_signature(info.__isset.version_miss, &hash);
+        update_report_signature(info.__isset.used, &hash);
+        update_report_signature(info.used, &hash);
+    }
+    return hash;
+}
+
+OLAPStatus TabletManager::report_all_tablets_info(std::map<TTabletId, TTablet>* tablets_info,
+                                                  bool* incremental) {
     DCHECK(tablets_info != nullptr);
     LOG(INFO) << "begin to report all tablets info";
 
@@ -939,38 +1063,78 @@ OLAPStatus TabletManager::report_all_tablets_info(std::map<TTabletId, TTablet>*
 
     DorisMetrics::instance()->report_all_tablets_requests_total->increment(1);
 
+    // collect the tablets under the shard locks, and build their report info outside
+    std::vector<std::pair<TTabletId, std::vector<TabletSharedPtr>>> all_tablets;
     for (const auto& tablets_shard : _tablets_shards) {
         ReadLock rlock(tablets_shard.lock.get());
         for (const auto& item : tablets_shard.tablet_map) {
             if (item.second.table_arr.empty()) {
                 continue;
             }
+            all_tablets.emplace_back(item.first, item.second.table_arr);
+        }
+    }
 
-            uint64_t tablet_id = item.first;
-            TTablet t_tablet;
-            for (TabletSharedPtr tablet_ptr : item.second.table_arr) {
-                TTabletInfo tablet_info;
-                tablet_ptr->build_tablet_report_info(&tablet_info);
-
-                // find expired transaction corresponding to this tablet
-                TabletInfo tinfo(tablet_id, tablet_ptr->schema_hash(), tablet_ptr->tablet_uid());
-                auto find = expire_txn_map.find(tinfo);
-                if (find != expire_txn_map.end()) {
-                    tablet_info.__set_transaction_ids(find->second);
-                    expire_txn_map.erase(find);
-                }
-                t_tablet.tablet_infos.push_back(tablet_info);
+    std::lock_guard<std::mutex> l(_report_lock);
+    bool is_incremental = incremental != nullptr && *incremental && _has_reported;
+    if (is_incremental) {
+        // FE treats the tablets missing in a full report as dropped, so tablets dropped
+        // since last report can only be reported in a full report
+        size_t num_reported = 0;
+        for (auto& item : all_tablets) {
+            num_reported += _reported_tablet_signatures.count(item.first);
+        }
+        is_incremental = num_reported == _reported_tablet_signatures.size();
+    }
+    _pending_tablet_signatures.clear();
+    _pending_tablet_signatures.reserve(all_tablets.size());
+    for (auto& item : all_tablets) {
+        uint64_t tablet_id = item.first;
+        TTablet t_tablet;
+        bool has_expired_txn = false;
+        for (TabletSharedPtr tablet_ptr : item.second) {
+            TTabletInfo tablet_info;
+            tablet_ptr->build_tablet_report_info(&tablet_info);
+
+            // find expired transaction corresponding to this tablet
+            TabletInfo tinfo(tablet_id, tablet_ptr->schema_hash(), tablet_ptr->tablet_uid());
+            auto find = expire_txn_map.find(tinfo);
+            if (find != expire_txn_map.end()) {
+                tablet_info.__set_transaction_ids(find->second);
+                expire_txn_map.erase(find);
+                has_expired_txn = true;
             }
+            t_tablet.tablet_infos.push_back(tablet_info);
+        }
 
-            if (!t_tablet.tablet_infos.empty()) {
-                tablets_info->emplace(tablet_id, t_tablet);
+        uint64_t signature = tablet_report_signature(t_tablet);
+        _pending_tablet_signatures[tablet_id] = signature;
+        if (is_incremental && !has_expired_txn) {
+            auto it = _reported_tablet_signatures.find(tablet_id);
+            if (it != _reported_tablet_signatures.end() && it->second == signature) {
+                continue;
             }
         }
+        tablets_info->emplace(tablet_id, std::move(t_tablet));
+    }
+
+    if (incremental != nullptr) {
+        *incremental = is_incremental;
     }
-    LOG(INFO) << "success to report all tablets info. tablet_count=" << tablets_info->size();
+    LOG(INFO) << "success to report all tablets info. tablet_count=" << tablets_info->size()
+              << ", incremental=" << is_incremental;
     return OLAP_SUCCESS;
 }
 
+void TabletManager::finish_tablets_report(bool accepted) {
+    std::lock_guard<std::mutex> l(_report_lock);
+    if (accepted) {
+        _reported_tablet_signatures.swap(_pending_tablet_signatures);
+        _has_reported = true;
+    }
+    _pending_tablet_signatures.clear();
+}
+
 OLAPStatus TabletManager::start_trash_sweep() {
     {
         std::vector<int64_t> tablets_to_clean;
@@ -1234,6 +1398,13 @@ void TabletManager::_build_tablet_stat() {
                 }
                 stat.__set_data_size(tablet->tablet_footprint());
                 stat.__set_row_num(tablet->num_rows());
+                int64_t column_stats_version = -1;
+                std::vector<TColumnStatistics> column_stats;
+                tablet->get_column_statistics(&column_stats_version, &column_stats);
+                if (column_stats_version >= 0) {
+                    stat.__set_column_stats_version(column_stats_version);
+                    stat.__set_column_stats(column_stats);
+                }
                 VLOG(3) << "building tablet stat. tablet_id=" << item.first
                         << ", data_size=" << tablet->tablet_footprint()
                         << ", row_num=" << tablet->num_rows();
@@ -1262,8 +1433,11 @@ OLAPStatus TabletManager::_create_initial_rowset_unlocked(const TCreateTabletReq
             context.tablet_id = tablet->tablet_id();
             context.partition_id = tablet->partition_id();
             context.tablet_schema_hash = tablet->schema_hash();
-            if (!request.__isset.storage_format ||
-                request.storage_format == TStorageFormat::DEFAULT) {
+            if (tablet->enable_unique_key_merge_on_write()) {
+                // merge-on-write relies on the primary key index of beta rowset
+                context.rowset_type = RowsetTypePB::BETA_ROWSET;
+            } else if (!request.__isset.storage_format ||
+                       request.storage_format == TStorageFormat::DEFAULT) {
                 context.rowset_type = StorageEngine::instance()->default_rowset_type();
             } else if (request.storage_format == TStorageFormat::V1) {
                 context.rowset_type = RowsetTypePB::ALPHA_ROWSET;
@@ -1356,7 +1530,9 @@ OLAPStatus TabletManager::_create_tablet_meta_unlocked(const TCreateTabletReq& r
                                         col_idx_to_unique_id, tablet_meta);
 
     // TODO(lingbin): when beta-rowset is default, should remove it
-    if (request.__isset.storage_format && request.storage_format == TStorageFormat::V2) {
+    if ((request.__isset.storage_format && request.storage_format == TStorageFormat::V2) ||
+        (res == OLAP_SUCCESS &&
+         (*tablet_meta)->tablet_schema().enable_unique_key_merge_on_write())) {
         (*tablet_meta)->set_preferred_rowset_type(BETA_ROWSET);
     } else {
         (*tablet_meta)->set_preferred_rowset_type(ALPHA_ROWSET);
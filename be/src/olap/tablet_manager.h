@@ -73,6 +73,21 @@ public:
                                                    DataDir* data_dir,
                                                    vector<TTabletId>& tablet_submitted_compaction);
 
+    // Find at most 'max_num' tablets on 'data_dir' and not in 'excluded', which have alpha
+    // rowsets to convert to beta rowsets. Return the number of such rowsets on 'data_dir'.
+    int64_t find_tablets_to_convert_rowsets(DataDir* data_dir, const std::set<TTabletId>& excluded,
+                                            size_t max_num, std::vector<TabletSharedPtr>* tablets);
+
+    // Find at most 'max_num' tablets on 'data_dir' and not in 'excluded', which have rowsets
+    // missing indexes to build. Return the number of such rowsets on 'data_dir'.
+    int64_t find_tablets_to_build_index(DataDir* data_dir, const std::set<TTabletId>& excluded,
+                                        size_t max_num, std::vector<TabletSharedPtr>* tablets);
+
+    // Find at most 'max_num' tablets whose column statistics are not collected from their
+    // latest versions.
+    void find_tablets_to_collect_column_statistics(size_t max_num,
+                                                   std::vector<TabletSharedPtr>* tablets);
+
     TabletSharedPtr get_tablet(TTabletId tablet_id, SchemaHash schema_hash,
                                bool include_deleted = false, std::string* err = nullptr);
 
@@ -115,7 +130,16 @@ public:
     //        OLAP_ERR_INPUT_PARAMETER_ERROR, if tables is null
     OLAPStatus report_tablet_info(TTabletInfo* tablet_info);
 
-    OLAPStatus report_all_tablets_info(std::map<TTabletId, TTablet>* tablets_info);
+    // Build the tablets info of a tablet report. If *incremental is true, only the tablets
+    // whose report info changed since the last acknowledged report are included. It is
+    // set to false if a full report is needed instead, e.g. when tablets were dropped.
+    // finish_tablets_report() must be called with the result of sending the report.
+    OLAPStatus report_all_tablets_info(std::map<TTabletId, TTablet>* tablets_info,
+                                       bool* incremental = nullptr);
+
+    // Called after the report built by report_all_tablets_info() is sent, the report
+    // becomes the base of next incremental report if it is accepted by FE.
+    void finish_tablets_report(bool accepted);
 
     OLAPStatus start_trash_sweep();
     // Prevent schema change executed concurrently.
@@ -226,6 +250,13 @@ private:
     // last update time of tablet stat cache
     int64_t _last_update_stat_ms;
 
+    std::mutex _report_lock;
+    // tablet id => signature of its report info in the last acknowledged tablet report
+    std::unordered_map<TTabletId, uint64_t> _reported_tablet_signatures;
+    // signatures of the report being sent
+    std::unordered_map<TTabletId, uint64_t> _pending_tablet_signatures;
+    bool _has_reported = false;
+
     tablet_map_t& _get_tablet_map(TTabletId tablet_id);
 
     tablets_shard& _get_tablets_shard(TTabletId tabletId);
@@ -58,6 +58,18 @@ OLAPStatus AlterTabletTask::set_alter_state(AlterTabletState alter_state) {
     return OLAP_SUCCESS;
 }
 
+// Parse the codec name sent by FE, unknown ones are ignored with a warning.
+static bool parse_compression_type(const std::string& name,
+                                   segment_v2::CompressionTypePB* compression_type) {
+    if (!segment_v2::CompressionTypePB_Parse(name, compression_type) ||
+        *compression_type == segment_v2::UNKNOWN_COMPRESSION ||
+        *compression_type == segment_v2::DEFAULT_COMPRESSION) {
+        LOG(WARNING) << "unknown compression type " << name << ", use the default one";
+        return false;
+    }
+    return true;
+}
+
 OLAPStatus TabletMeta::create(const TCreateTabletReq& request, const TabletUid& tablet_uid,
                               uint64_t shard_id, uint32_t next_unique_id,
                               const unordered_map<uint32_t, uint32_t>& col_ordinal_to_unique_id,
@@ -159,13 +171,35 @@ TabletMeta::TabletMeta(int64_t table_id, int64_t partition_id, int64_t tablet_id
             column->set_is_bf_column(tcolumn.is_bloom_filter_column);
             has_bf_columns = true;
         }
+        if (tcolumn.__isset.compression_type) {
+            segment_v2::CompressionTypePB compression_type;
+            if (parse_compression_type(tcolumn.compression_type, &compression_type)) {
+                column->set_compression_type(compression_type);
+            }
+        }
         if (tablet_schema.__isset.indexes) {
             for (auto& index : tablet_schema.indexes) {
                 if (index.index_type == TIndexType::type::BITMAP) {
                     DCHECK_EQ(index.columns.size(), 1);
                     if (boost::iequals(tcolumn.column_name, index.columns[0])) {
                         column->set_has_bitmap_index(true);
-                        break;
+                    }
+                } else if (index.index_type == TIndexType::type::NGRAM) {
+                    DCHECK_EQ(index.columns.size(), 1);
+                    if (boost::iequals(tcolumn.column_name, index.columns[0])) {
+                        column->set_has_ngram_index(true);
+                    }
+                } else if (index.index_type == TIndexType::type::S2) {
+                    DCHECK_EQ(index.columns.size(), 2);
+                    if (boost::iequals(tcolumn.column_name, index.columns[0])) {
+                        for (uint32_t i = 0; i < tablet_schema.columns.size(); ++i) {
+                            if (boost::iequals(tablet_schema.columns[i].column_name,
+                                               index.columns[1])) {
+                                column->set_s2_index_lat_unique_id(
+                                        col_ordinal_to_unique_id.at(i));
+                                break;
+                            }
+                        }
                     }
                 }
             }
@@ -185,6 +219,24 @@ TabletMeta::TabletMeta(int64_t table_id, int64_t partition_id, int64_t tablet_id
         schema->set_delete_sign_idx(tablet_schema.delete_sign_idx);
     }
 
+    if (tablet_schema.__isset.compression_type) {
+        segment_v2::CompressionTypePB compression_type;
+        if (parse_compression_type(tablet_schema.compression_type, &compression_type)) {
+            schema->set_compression_type(compression_type);
+        }
+    }
+    schema->set_compression_level(tablet_schema.compression_level);
+    if (tablet_schema.keys_type == TKeysType::UNIQUE_KEYS) {
+        schema->set_enable_unique_key_merge_on_write(
+                tablet_schema.enable_unique_key_merge_on_write);
+    }
+    if (tablet_schema.keys_type == TKeysType::DUP_KEYS &&
+        tablet_schema.__isset.clustering_column_idxs) {
+        for (int32_t idx : tablet_schema.clustering_column_idxs) {
+            schema->add_clustering_col_idxs(idx);
+        }
+    }
+
     init_from_pb(tablet_meta_pb);
 }
 
@@ -399,6 +451,10 @@ void TabletMeta::init_from_pb(const TabletMetaPB& tablet_meta_pb) {
     if (tablet_meta_pb.has_preferred_rowset_type()) {
         _preferred_rowset_type = tablet_meta_pb.preferred_rowset_type();
     }
+
+    if (tablet_meta_pb.has_delete_bitmap()) {
+        _delete_bitmap.init_from_pb(tablet_meta_pb.delete_bitmap());
+    }
 }
 
 void TabletMeta::to_meta_pb(TabletMetaPB* tablet_meta_pb) {
@@ -449,6 +505,10 @@ void TabletMeta::to_meta_pb(TabletMetaPB* tablet_meta_pb) {
     if (_preferred_rowset_type == BETA_ROWSET) {
         tablet_meta_pb->set_preferred_rowset_type(_preferred_rowset_type);
     }
+
+    if (!_delete_bitmap.empty()) {
+        _delete_bitmap.to_pb(tablet_meta_pb->mutable_delete_bitmap());
+    }
 }
 
 void TabletMeta::to_json(string* json_string, json2pb::Pb2JsonOptions& options) {
@@ -604,6 +664,7 @@ void TabletMeta::add_delete_predicate(const DeletePredicatePB& delete_predicate,
     for (auto& del_pred : _del_pred_array) {
         if (del_pred.version() == version) {
             *del_pred.mutable_sub_predicates() = delete_predicate.sub_predicates();
+            del_pred.set_by_bitmap(delete_predicate.by_bitmap());
             return;
         }
     }
@@ -611,6 +672,7 @@ void TabletMeta::add_delete_predicate(const DeletePredicatePB& delete_predicate,
     del_pred->set_version(version);
     *del_pred->mutable_sub_predicates() = delete_predicate.sub_predicates();
     *del_pred->mutable_in_predicates() = delete_predicate.in_predicates();
+    del_pred->set_by_bitmap(delete_predicate.by_bitmap());
 }
 
 void TabletMeta::remove_delete_predicate_by_version(const Version& version) {
@@ -633,6 +695,17 @@ void TabletMeta::remove_delete_predicate_by_version(const Version& version) {
     }
 }
 
+void TabletMeta::clear_delete_by_bitmap() {
+    for (auto& rs_meta : _rs_metas) {
+        if (rs_meta->has_delete_predicate() && rs_meta->delete_predicate().by_bitmap()) {
+            rs_meta->mutable_delete_predicate()->set_by_bitmap(false);
+        }
+    }
+    for (auto& del_pred : _del_pred_array) {
+        del_pred.set_by_bitmap(false);
+    }
+}
+
 DelPredicateArray TabletMeta::delete_predicates() const {
     return _del_pred_array;
 }
@@ -702,6 +775,90 @@ OLAPStatus TabletMeta::set_partition_id(int64_t partition_id) {
     return OLAP_SUCCESS;
 }
 
+void DeleteBitmap::add(const BitmapKey& key, uint32_t row_id) {
+    WriteLock wrlock(&_lock);
+    _bitmaps[key].add(row_id);
+}
+
+void DeleteBitmap::merge(const DeleteBitmap& other) {
+    if (&other == this) {
+        return;
+    }
+    ReadLock rdlock(&other._lock);
+    WriteLock wrlock(&_lock);
+    for (auto& it : other._bitmaps) {
+        _bitmaps[it.first] |= it.second;
+    }
+}
+
+void DeleteBitmap::merge(const DeleteBitmap& other, const RowsetId& rowset_id) {
+    if (&other == this) {
+        return;
+    }
+    ReadLock rdlock(&other._lock);
+    WriteLock wrlock(&_lock);
+    for (auto it = other._bitmaps.lower_bound(BitmapKey(rowset_id, 0, INT64_MIN));
+         it != other._bitmaps.end() && std::get<0>(it->first) == rowset_id; ++it) {
+        _bitmaps[it->first] |= it->second;
+    }
+}
+
+void DeleteBitmap::remove(const RowsetId& rowset_id) {
+    WriteLock wrlock(&_lock);
+    auto it = _bitmaps.lower_bound(BitmapKey(rowset_id, 0, INT64_MIN));
+    while (it != _bitmaps.end() && std::get<0>(it->first) == rowset_id) {
+        it = _bitmaps.erase(it);
+    }
+}
+
+void DeleteBitmap::get_agg(const RowsetId& rowset_id, uint32_t segment_id, int64_t version,
+                           Roaring* bitmap) const {
+    ReadLock rdlock(&_lock);
+    *bitmap = Roaring();
+    for (auto it = _bitmaps.lower_bound(BitmapKey(rowset_id, segment_id, INT64_MIN));
+         it != _bitmaps.end(); ++it) {
+        if (std::get<0>(it->first) != rowset_id || std::get<1>(it->first) != segment_id ||
+            std::get<2>(it->first) > version) {
+            break;
+        }
+        *bitmap |= it->second;
+    }
+}
+
+bool DeleteBitmap::contains(const RowsetId& rowset_id) const {
+    ReadLock rdlock(&_lock);
+    auto it = _bitmaps.lower_bound(BitmapKey(rowset_id, 0, INT64_MIN));
+    return it != _bitmaps.end() && std::get<0>(it->first) == rowset_id;
+}
+
+bool DeleteBitmap::empty() const {
+    ReadLock rdlock(&_lock);
+    return _bitmaps.empty();
+}
+
+void DeleteBitmap::to_pb(DeleteBitmapPB* delete_bitmap_pb) const {
+    ReadLock rdlock(&_lock);
+    for (auto& it : _bitmaps) {
+        delete_bitmap_pb->add_rowset_ids(std::get<0>(it.first).to_string());
+        delete_bitmap_pb->add_segment_ids(std::get<1>(it.first));
+        delete_bitmap_pb->add_versions(std::get<2>(it.first));
+        std::string* buf = delete_bitmap_pb->add_segment_delete_bitmaps();
+        buf->resize(it.second.getSizeInBytes());
+        it.second.write(&(*buf)[0]);
+    }
+}
+
+void DeleteBitmap::init_from_pb(const DeleteBitmapPB& delete_bitmap_pb) {
+    WriteLock wrlock(&_lock);
+    _bitmaps.clear();
+    for (int i = 0; i < delete_bitmap_pb.rowset_ids_size(); ++i) {
+        RowsetId rowset_id;
+        rowset_id.init(delete_bitmap_pb.rowset_ids(i));
+        BitmapKey key(rowset_id, delete_bitmap_pb.segment_ids(i), delete_bitmap_pb.versions(i));
+        _bitmaps[key] = Roaring::read(delete_bitmap_pb.segment_delete_bitmaps(i).data());
+    }
+}
+
 bool operator==(const AlterTabletTask& a, const AlterTabletTask& b) {
     if (a._alter_state != b._alter_state) return false;
     if (a._related_tablet_id != b._related_tablet_id) return false;
@@ -18,8 +18,11 @@
 #ifndef DORIS_BE_SRC_OLAP_TABLET_META_H
 #define DORIS_BE_SRC_OLAP_TABLET_META_H
 
+#include <map>
 #include <mutex>
+#include <roaring/roaring.hh>
 #include <string>
+#include <tuple>
 #include <vector>
 
 #include "common/logging.h"
@@ -102,6 +105,43 @@ bool operator!=(const AlterTabletTask& a, const AlterTabletTask& b);
 
 typedef std::shared_ptr<AlterTabletTask> AlterTabletTaskSharedPtr;
 
+// Rows replaced by later loads in the segments of a merge-on-write tablet. There is a
+// bitmap of row ids for each (rowset id, segment id, version), where version is the
+// version of the load which replaced the rows, so that old versions can still be read.
+// Thread-safe.
+class DeleteBitmap {
+public:
+    // rowset id, segment id, version
+    using BitmapKey = std::tuple<RowsetId, uint32_t, int64_t>;
+
+    void add(const BitmapKey& key, uint32_t row_id);
+
+    void merge(const DeleteBitmap& other);
+
+    // Merge the bitmaps of rowset `rowset_id` in `other`.
+    void merge(const DeleteBitmap& other, const RowsetId& rowset_id);
+
+    // Remove all bitmaps of rowset `rowset_id`.
+    void remove(const RowsetId& rowset_id);
+
+    // Set `bitmap` to the union of the bitmaps of segment `segment_id` of rowset
+    // `rowset_id` whose versions are not newer than `version`.
+    void get_agg(const RowsetId& rowset_id, uint32_t segment_id, int64_t version,
+                 Roaring* bitmap) const;
+
+    // Whether any row of rowset `rowset_id` is marked.
+    bool contains(const RowsetId& rowset_id) const;
+
+    bool empty() const;
+
+    void to_pb(DeleteBitmapPB* delete_bitmap_pb) const;
+    void init_from_pb(const DeleteBitmapPB& delete_bitmap_pb);
+
+private:
+    mutable RWMutex _lock;
+    std::map<BitmapKey, Roaring> _bitmaps;
+};
+
 // Class encapsulates meta of tablet.
 // The concurrency control is handled in Tablet Class, not in this class.
 class TabletMeta {
@@ -183,6 +223,9 @@ public:
 
     void add_delete_predicate(const DeletePredicatePB& delete_predicate, int64_t version);
     void remove_delete_predicate_by_version(const Version& version);
+    // Makes the deletes resolved into the delete bitmap be evaluated as predicates again,
+    // e.g. when the rowsets they were resolved on are replaced by clone.
+    void clear_delete_by_bitmap();
     DelPredicateArray delete_predicates() const;
     bool version_for_delete_predicate(const Version& version);
     AlterTabletTaskSharedPtr alter_task();
@@ -200,6 +243,9 @@ public:
         _preferred_rowset_type = preferred_rowset_type;
     }
 
+    // Only used by merge-on-write tablets
+    DeleteBitmap& delete_bitmap() { return _delete_bitmap; }
+
 private:
     OLAPStatus _save_meta(DataDir* data_dir);
 
@@ -232,6 +278,7 @@ private:
     AlterTabletTaskSharedPtr _alter_task;
     bool _in_restore_mode = false;
     RowsetTypePB _preferred_rowset_type = ALPHA_ROWSET;
+    DeleteBitmap _delete_bitmap;
 
     RWMutex _meta_lock;
 };
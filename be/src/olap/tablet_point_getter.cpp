@@ -0,0 +1,159 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/tablet_point_getter.h"
+
+#include <algorithm>
+
+#include "common/config.h"
+#include "olap/iterators.h"
+#include "olap/row.h"
+#include "olap/row_block2.h"
+#include "olap/row_cursor.h"
+#include "olap/rowset/beta_rowset.h"
+#include "runtime/mem_tracker.h"
+
+namespace doris {
+
+// A key has a row in a segment of a unique key tablet, so a few rows are enough
+static const uint16_t kPointGetBlockRows = 16;
+
+TabletPointGetter::TabletPointGetter(TabletSharedPtr tablet, int64_t version)
+        : _tablet(std::move(tablet)),
+          _version(version),
+          _schema(_tablet->tablet_schema()),
+          _tracker(std::make_shared<MemTracker>(-1, "TabletPointGetter")),
+          _pool(new MemPool(_tracker.get())) {}
+
+TabletPointGetter::~TabletPointGetter() {
+    _delete_handler.finalize();
+}
+
+OLAPStatus TabletPointGetter::init() {
+    const TabletSchema& tablet_schema = _tablet->tablet_schema();
+    if (tablet_schema.keys_type() != UNIQUE_KEYS) {
+        LOG(WARNING) << "point get is only supported by unique key tablets, tablet="
+                     << _tablet->full_name();
+        return OLAP_ERR_INPUT_PARAMETER_ERROR;
+    }
+    if (tablet_schema.has_sequence_col() && !tablet_schema.enable_unique_key_merge_on_write()) {
+        LOG(WARNING) << "point get is not supported by tablets with sequence column, tablet="
+                     << _tablet->full_name();
+        return OLAP_ERR_FUNC_NOT_IMPLEMENTED;
+    }
+
+    std::vector<RowsetSharedPtr> rowsets;
+    {
+        ReadLock rdlock(_tablet->get_header_lock_ptr());
+        RETURN_NOT_OK(_tablet->capture_consistent_rowsets(Version(0, _version), &rowsets));
+        RETURN_NOT_OK(_delete_handler.init(tablet_schema, _tablet->delete_predicates(),
+                                           _version));
+    }
+    for (auto& rowset : rowsets) {
+        if (rowset->rowset_meta()->rowset_type() != BETA_ROWSET) {
+            LOG(WARNING) << "point get needs beta rowset, rowset=" << rowset->rowset_id();
+            return OLAP_ERR_ROWSET_TYPE_NOT_FOUND;
+        }
+        if (rowset->num_rows() > 0) {
+            _rowsets.push_back(rowset);
+        }
+    }
+    std::sort(_rowsets.begin(), _rowsets.end(),
+              [](const RowsetSharedPtr& a, const RowsetSharedPtr& b) {
+                  return a->end_version() > b->end_version();
+              });
+    _segments.resize(_rowsets.size());
+    for (size_t i = 0; i < _rowsets.size(); ++i) {
+        auto rowset = std::static_pointer_cast<BetaRowset>(_rowsets[i]);
+        RETURN_NOT_OK(rowset->load_segments(&_segments[i]));
+    }
+    return OLAP_SUCCESS;
+}
+
+OLAPStatus TabletPointGetter::get(const OlapTuple& key, RowCursor* row, bool* found) {
+    *found = false;
+    _pool->clear();
+    const TabletSchema& tablet_schema = _tablet->tablet_schema();
+    if (key.size() != tablet_schema.num_key_columns()) {
+        LOG(WARNING) << "point get needs all the key columns, tablet=" << _tablet->full_name()
+                     << ", num_key_columns=" << tablet_schema.num_key_columns()
+                     << ", key=" << key;
+        return OLAP_ERR_INPUT_PARAMETER_ERROR;
+    }
+    RowCursor key_cursor;
+    RETURN_NOT_OK(key_cursor.init_scan_key(tablet_schema, key.values()));
+    RETURN_NOT_OK(key_cursor.from_tuple(key));
+
+    StorageReadOptions opts;
+    opts.key_ranges.emplace_back(&key_cursor, true, &key_cursor, true);
+    opts.stats = &_stats;
+    opts.use_page_cache = !config::disable_storage_page_cache;
+    if (_tablet->enable_unique_key_merge_on_write()) {
+        opts.delete_bitmap = &_tablet->tablet_meta()->delete_bitmap();
+        opts.delete_bitmap_version = _version;
+    }
+    for (size_t i = 0; i < _rowsets.size() && !*found; ++i) {
+        opts.rowset_id = _rowsets[i]->rowset_id();
+        opts.delete_conditions.clear();
+        _delete_handler.get_delete_conditions_after_version(_rowsets[i]->end_version(),
+                                                            &opts.delete_conditions);
+        // the segments of an overlapping rowset are written in order, the last is the newest
+        auto& segments = _segments[i];
+        for (auto it = segments.rbegin(); it != segments.rend() && !*found; ++it) {
+            RETURN_NOT_OK(_get_from_segment(*it, opts, row, found));
+        }
+        // the latest row of the key, which is deleted if a newer delete predicate matches
+        // it or its delete sign is set
+        if (*found && (_delete_handler.is_filter_data(_rowsets[i]->end_version(), *row) ||
+                       row->is_delete())) {
+            *found = false;
+            return OLAP_SUCCESS;
+        }
+    }
+    return OLAP_SUCCESS;
+}
+
+OLAPStatus TabletPointGetter::_get_from_segment(const segment_v2::SegmentSharedPtr& segment,
+                                                const StorageReadOptions& opts, RowCursor* row,
+                                                bool* found) {
+    std::unique_ptr<RowwiseIterator> iter;
+    Status st = segment->new_iterator(_schema, opts, &iter);
+    if (!st.ok()) {
+        LOG(WARNING) << "failed to create segment iterator, tablet=" << _tablet->full_name()
+                     << ", st=" << st.to_string();
+        return OLAP_ERR_ROWSET_READER_INIT;
+    }
+    RowBlockV2 block(_schema, kPointGetBlockRows);
+    while (true) {
+        st = iter->next_batch(&block);
+        if (st.is_end_of_file()) {
+            return OLAP_SUCCESS;
+        }
+        if (!st.ok()) {
+            LOG(WARNING) << "failed to read segment, tablet=" << _tablet->full_name()
+                         << ", st=" << st.to_string();
+            return OLAP_ERR_ROWSET_READ_FAILED;
+        }
+        if (block.selected_size() > 0) {
+            uint16_t last = block.selection_vector()[block.selected_size() - 1];
+            copy_row(row, block.row(last), _pool.get());
+            *found = true;
+        }
+    }
+}
+
+} // namespace doris
@@ -0,0 +1,85 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "olap/delete_handler.h"
+#include "olap/iterators.h"
+#include "olap/olap_common.h"
+#include "olap/rowset/segment_v2/segment.h"
+#include "olap/schema.h"
+#include "olap/tablet.h"
+#include "olap/tuple.h"
+#include "runtime/mem_pool.h"
+
+namespace doris {
+
+class MemTracker;
+class RowCursor;
+
+// Gets the rows of keys from a unique key tablet without the scan pipeline of a query:
+// the rowsets of a version are searched from the newest one by the short key indexes of
+// their segments, and the first row found is the latest version of the key. So no plan
+// fragment, scanner thread or merge of the rowsets is needed for a point get.
+//
+// Usage:
+//      TabletPointGetter getter(tablet, version);
+//      RETURN_NOT_OK(getter.init());
+//      RowCursor row;
+//      RETURN_NOT_OK(row.init(tablet->tablet_schema()));
+//      bool found = false;
+//      RETURN_NOT_OK(getter.get(key, &row, &found));
+class TabletPointGetter {
+public:
+    TabletPointGetter(TabletSharedPtr tablet, int64_t version);
+
+    ~TabletPointGetter();
+
+    // Capture the rowsets of the version. Tablets not of unique keys, or with a sequence
+    // column but not merge-on-write, whose latest row is not in the newest rowset, are
+    // not supported.
+    OLAPStatus init();
+
+    // 'key' holds the values of all the key columns in order. If the key exists, '*found'
+    // is set and 'row', which is initialized with all the columns of the tablet, is set
+    // to its row. The variable length values of 'row' are valid until the next get().
+    OLAPStatus get(const OlapTuple& key, RowCursor* row, bool* found);
+
+    const OlapReaderStatistics& stats() const { return _stats; }
+
+private:
+    // Read the last row of 'key' in 'segment' into 'row'
+    OLAPStatus _get_from_segment(const segment_v2::SegmentSharedPtr& segment,
+                                 const StorageReadOptions& opts, RowCursor* row, bool* found);
+
+    TabletSharedPtr _tablet;
+    int64_t _version;
+    Schema _schema;
+    // rowsets of the version which have rows, the newest first
+    std::vector<RowsetSharedPtr> _rowsets;
+    // segments of each of _rowsets
+    std::vector<std::vector<segment_v2::SegmentSharedPtr>> _segments;
+    DeleteHandler _delete_handler;
+    OlapReaderStatistics _stats;
+    std::shared_ptr<MemTracker> _tracker;
+    std::unique_ptr<MemPool> _pool;
+};
+
+} // namespace doris
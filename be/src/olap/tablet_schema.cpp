@@ -308,6 +308,9 @@ void TabletColumn::init_from_pb(const ColumnPB& column) {
     } else {
         _has_bitmap_index = false;
     }
+    _has_ngram_index = column.has_ngram_index();
+    _s2_index_lat_unique_id =
+            column.has_s2_index_lat_unique_id() ? column.s2_index_lat_unique_id() : -1;
     _has_referenced_column = column.has_referenced_column_id();
     if (_has_referenced_column) {
         _referenced_column_id = column.referenced_column_id();
@@ -318,6 +321,7 @@ void TabletColumn::init_from_pb(const ColumnPB& column) {
     if (column.has_visible()) {
         _visible = column.visible();
     }
+    _compression_type = column.compression_type();
     if (_type == FieldType::OLAP_FIELD_TYPE_ARRAY) {
         DCHECK(column.children_columns_size() == 1) << "LIST type has more than 1 children types.";
         TabletColumn child_column;
@@ -351,7 +355,16 @@ void TabletColumn::to_schema_pb(ColumnPB* column) {
     if (_has_bitmap_index) {
         column->set_has_bitmap_index(_has_bitmap_index);
     }
+    if (_has_ngram_index) {
+        column->set_has_ngram_index(_has_ngram_index);
+    }
+    if (_s2_index_lat_unique_id >= 0) {
+        column->set_s2_index_lat_unique_id(_s2_index_lat_unique_id);
+    }
     column->set_visible(_visible);
+    if (_compression_type != segment_v2::DEFAULT_COMPRESSION) {
+        column->set_compression_type(_compression_type);
+    }
 }
 
 void TabletColumn::add_sub_column(TabletColumn& sub_column) {
@@ -394,6 +407,18 @@ void TabletSchema::init_from_pb(const TabletSchemaPB& schema) {
     _is_in_memory = schema.is_in_memory();
     _delete_sign_idx = schema.delete_sign_idx();
     _sequence_col_idx = schema.sequence_col_idx();
+    _compression_type = schema.compression_type();
+    _compression_level = schema.compression_level();
+    _enable_unique_key_merge_on_write =
+            _keys_type == UNIQUE_KEYS && schema.enable_unique_key_merge_on_write();
+    _clustering_col_idxs.clear();
+    if (_keys_type == DUP_KEYS) {
+        for (int32_t idx : schema.clustering_col_idxs()) {
+            if (idx >= 0 && static_cast<size_t>(idx) < _num_columns) {
+                _clustering_col_idxs.push_back(idx);
+            }
+        }
+    }
 }
 
 void TabletSchema::to_schema_pb(TabletSchemaPB* tablet_meta_pb) {
@@ -412,6 +437,12 @@ void TabletSchema::to_schema_pb(TabletSchemaPB* tablet_meta_pb) {
     tablet_meta_pb->set_is_in_memory(_is_in_memory);
     tablet_meta_pb->set_delete_sign_idx(_delete_sign_idx);
     tablet_meta_pb->set_sequence_col_idx(_sequence_col_idx);
+    tablet_meta_pb->set_compression_type(_compression_type);
+    tablet_meta_pb->set_compression_level(_compression_level);
+    tablet_meta_pb->set_enable_unique_key_merge_on_write(_enable_unique_key_merge_on_write);
+    for (int32_t idx : _clustering_col_idxs) {
+        tablet_meta_pb->add_clustering_col_idxs(idx);
+    }
 }
 
 size_t TabletSchema::row_size() const {
@@ -470,6 +501,9 @@ bool operator==(const TabletColumn& a, const TabletColumn& b) {
         if (a._referenced_column != b._referenced_column) return false;
     }
     if (a._has_bitmap_index != b._has_bitmap_index) return false;
+    if (a._has_ngram_index != b._has_ngram_index) return false;
+    if (a._s2_index_lat_unique_id != b._s2_index_lat_unique_id) return false;
+    if (a._compression_type != b._compression_type) return false;
     return true;
 }
 
@@ -496,6 +530,10 @@ bool operator==(const TabletSchema& a, const TabletSchema& b) {
     }
     if (a._is_in_memory != b._is_in_memory) return false;
     if (a._delete_sign_idx != b._delete_sign_idx) return false;
+    if (a._compression_type != b._compression_type) return false;
+    if (a._compression_level != b._compression_level) return false;
+    if (a._enable_unique_key_merge_on_write != b._enable_unique_key_merge_on_write) return false;
+    if (a._clustering_col_idxs != b._clustering_col_idxs) return false;
     return true;
 }
 
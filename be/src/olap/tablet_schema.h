@@ -43,6 +43,11 @@ public:
     inline bool is_nullable() const { return _is_nullable; }
     inline bool is_bf_column() const { return _is_bf_column; }
     inline bool has_bitmap_index() const { return _has_bitmap_index; }
+    inline bool has_ngram_index() const { return _has_ngram_index; }
+    // whether this is the longitude column of an S2 index
+    inline bool has_s2_index() const { return _s2_index_lat_unique_id >= 0; }
+    // unique id of the latitude column of the S2 index of this column, -1 if none
+    inline int32_t s2_index_lat_unique_id() const { return _s2_index_lat_unique_id; }
     bool has_default_value() const { return _has_default_value; }
     std::string default_value() const { return _default_value; }
     bool has_reference_column() const { return _has_referenced_column; }
@@ -54,6 +59,8 @@ public:
     int precision() const { return _precision; }
     int frac() const { return _frac; }
     inline bool visible() { return _visible; }
+    // DEFAULT_COMPRESSION means to use the compression type of the tablet schema
+    segment_v2::CompressionTypePB compression_type() const { return _compression_type; }
     /**
      * Add a sub column.
      */
@@ -96,7 +103,10 @@ private:
     std::string _referenced_column;
 
     bool _has_bitmap_index = false;
+    bool _has_ngram_index = false;
+    int32_t _s2_index_lat_unique_id = -1;
     bool _visible = true;
+    segment_v2::CompressionTypePB _compression_type = segment_v2::DEFAULT_COMPRESSION;
 
     TabletColumn* _parent = nullptr;
     std::vector<TabletColumn> _sub_columns;
@@ -133,6 +143,22 @@ public:
     inline void set_delete_sign_idx(int32_t delete_sign_idx) { _delete_sign_idx = delete_sign_idx; }
     inline bool has_sequence_col() const { return _sequence_col_idx != -1; }
     inline int32_t sequence_col_idx() const { return _sequence_col_idx; }
+    // Codec of the segment v2 pages of `column`
+    segment_v2::CompressionTypePB compression_type(const TabletColumn& column) const {
+        return column.compression_type() == segment_v2::DEFAULT_COMPRESSION
+                       ? _compression_type
+                       : column.compression_type();
+    }
+    inline int32_t compression_level() const { return _compression_level; }
+    // See TabletSchemaPB.enable_unique_key_merge_on_write
+    inline bool enable_unique_key_merge_on_write() const {
+        return _enable_unique_key_merge_on_write;
+    }
+    // See TabletSchemaPB.clustering_col_idxs, empty if the rows are sorted by keys
+    inline const std::vector<int32_t>& clustering_col_idxs() const {
+        return _clustering_col_idxs;
+    }
+    inline bool is_clustered() const { return !_clustering_col_idxs.empty(); }
 
 private:
     // Only for unit test
@@ -158,6 +184,10 @@ private:
     bool _is_in_memory = false;
     int32_t _delete_sign_idx = -1;
     int32_t _sequence_col_idx = -1;
+    segment_v2::CompressionTypePB _compression_type = segment_v2::LZ4F;
+    int32_t _compression_level = 0;
+    bool _enable_unique_key_merge_on_write = false;
+    std::vector<int32_t> _clustering_col_idxs;
 };
 
 bool operator==(const TabletSchema& a, const TabletSchema& b);
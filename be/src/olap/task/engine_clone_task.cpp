@@ -17,6 +17,12 @@
 
 #include "olap/task/engine_clone_task.h"
 
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <map>
+#include <mutex>
 #include <set>
 
 #include "env/env.h"
@@ -27,10 +33,12 @@
 #include "gutil/strings/substitute.h"
 #include "http/http_client.h"
 #include "olap/olap_snapshot_converter.h"
+#include "olap/rowset/beta_rowset.h"
 #include "olap/rowset/rowset.h"
 #include "olap/rowset/rowset_factory.h"
 #include "olap/snapshot_manager.h"
 #include "runtime/client_cache.h"
+#include "util/threadpool.h"
 #include "util/thrift_rpc_helper.h"
 
 using std::set;
@@ -48,6 +56,31 @@ const uint32_t DOWNLOAD_FILE_MAX_RETRY = 3;
 const uint32_t LIST_REMOTE_FILE_TIMEOUT = 15;
 const uint32_t GET_LENGTH_TIMEOUT = 10;
 
+static std::atomic<int32_t> s_running_download_streams {0};
+
+// Share config::clone_max_download_speed_kbps among the running download streams of
+// this node. The share is fixed when a stream starts.
+class DownloadStreamGuard {
+public:
+    DownloadStreamGuard() : _num_streams(++s_running_download_streams) {}
+    ~DownloadStreamGuard() { --s_running_download_streams; }
+
+    // 0 means no limit other than config::max_download_speed_kbps
+    int64_t max_speed_kbps() const {
+        int64_t node_limit = config::clone_max_download_speed_kbps;
+        if (node_limit <= 0) {
+            return 0;
+        }
+        // stay above the low speed limit, or curl aborts the transfer
+        int64_t share = std::max<int64_t>(node_limit / _num_streams,
+                                          config::download_low_speed_limit_kbps * 2);
+        return std::min<int64_t>(share, config::max_download_speed_kbps);
+    }
+
+private:
+    int32_t _num_streams;
+};
+
 EngineCloneTask::EngineCloneTask(const TCloneReq& clone_req, const TMasterInfo& master_info,
                                  int64_t signature, std::vector<string>* error_msgs,
                                  std::vector<TTabletInfo>* tablet_infos, AgentStatus* res_status)
@@ -129,6 +162,7 @@ OLAPStatus EngineCloneTask::_do_clone() {
             bool allow_incremental_clone = false;
             // begin to full clone if incremental failed
             LOG(INFO) << "begin to full clone. [table=" << tablet->full_name();
+            _capture_base_rowsets(tablet.get());
             status = _clone_copy(*(tablet->data_dir()), local_data_path, &src_host, &src_file_path,
                                  _error_msgs, NULL, &allow_incremental_clone);
             if (status == DORIS_SUCCESS) {
@@ -347,6 +381,14 @@ AgentStatus EngineCloneTask::_clone_copy(DataDir& data_dir, const string& local_
                 status = DORIS_ERROR;
             }
         }
+        if (status == DORIS_SUCCESS && missed_versions == nullptr && !_base_rowsets.empty()) {
+            auto olap_st = _drop_base_rowset_metas(local_path, _clone_req.tablet_id);
+            if (olap_st != OLAP_SUCCESS) {
+                LOG(WARNING) << "fail to drop base rowsets, path=" << local_path
+                             << ", tablet_id=" << _clone_req.tablet_id << ", error=" << olap_st;
+                status = DORIS_ERROR;
+            }
+        }
         if (status == DORIS_SUCCESS) {
             // change all rowset ids because they maybe its id same with local rowset
             auto olap_st = SnapshotManager::instance()->convert_rowset_ids(
@@ -393,6 +435,13 @@ Status EngineCloneTask::_make_snapshot(const std::string& ip, int port, TTableId
             request.missing_version.push_back(version.first);
         }
     }
+    if (missed_versions == nullptr && !_base_rowsets.empty()) {
+        request.__isset.base_versions = true;
+        for (auto& rowset : _base_rowsets) {
+            request.base_versions.push_back(rowset->start_version());
+            request.base_versions.push_back(rowset->end_version());
+        }
+    }
     if (timeout_s > 0) {
         request.__set_timeout(timeout_s);
     }
@@ -460,18 +509,23 @@ Status EngineCloneTask::_download_files(DataDir* data_dir, const std::string& re
     // If the header file is not exist, the table couldn't loaded by olap engine.
     // Avoid of data is not complete, we copy the header file at last.
     // The header file's name is end of .hdr.
-    for (int i = 0; i < file_name_list.size() - 1; ++i) {
+    for (size_t i = 0; i + 1 < file_name_list.size(); ++i) {
         StringPiece sp(file_name_list[i]);
         if (sp.ends_with(".hdr")) {
             std::swap(file_name_list[i], file_name_list[file_name_list.size() - 1]);
             break;
         }
     }
+    size_t data_file_num = file_name_list.size();
+    if (!file_name_list.empty() && StringPiece(file_name_list.back()).ends_with(".hdr")) {
+        data_file_num--;
+    }
 
     // Get copy from remote
     uint64_t total_file_size = 0;
     MonotonicStopWatch watch;
     watch.start();
+    std::vector<uint64_t> file_sizes;
     for (auto& file_name : file_name_list) {
         auto remote_file_url = remote_url_prefix + file_name;
 
@@ -486,41 +540,87 @@ Status EngineCloneTask::_download_files(DataDir* data_dir, const std::string& re
         };
         RETURN_IF_ERROR(
                 HttpClient::execute_with_retry(DOWNLOAD_FILE_MAX_RETRY, 1, get_file_size_cb));
-        // check disk capacity
-        if (data_dir->reach_capacity_limit(file_size)) {
-            return Status::InternalError("Disk reach capacity limit");
-        }
-
         total_file_size += file_size;
-        uint64_t estimate_timeout = file_size / config::download_low_speed_limit_kbps / 1024;
-        if (estimate_timeout < config::download_low_speed_time) {
-            estimate_timeout = config::download_low_speed_time;
-        }
-
-        std::string local_file_path = local_path + file_name;
+        file_sizes.push_back(file_size);
+    }
+    // check disk capacity
+    if (data_dir->reach_capacity_limit(total_file_size)) {
+        return Status::InternalError("Disk reach capacity limit");
+    }
 
-        LOG(INFO) << "clone begin to download file from: " << remote_file_url
-                  << " to: " << local_file_path << ". size(B): " << file_size
-                  << ", timeout(s): " << estimate_timeout;
+    // Download data files concurrently and large files in ranges, the header file
+    // is downloaded after all of them.
+    std::unique_ptr<ThreadPool> download_pool;
+    RETURN_IF_ERROR(ThreadPoolBuilder("CloneDownloadThreadPool")
+                            .set_min_threads(1)
+                            .set_max_threads(std::max(1, config::clone_download_threads))
+                            .build(&download_pool));
+    std::mutex status_lock;
+    Status download_status = Status::OK();
+    // files whose ranged download failed, they are downloaded as a whole again
+    std::set<size_t> range_failed_files;
+    auto submit_download = [&](size_t idx, uint64_t offset, uint64_t length) {
+        return download_pool->submit_func([&, idx, offset, length]() {
+            {
+                std::lock_guard<std::mutex> l(status_lock);
+                if (!download_status.ok()) {
+                    return;
+                }
+            }
+            Status st = _download_file(remote_url_prefix + file_name_list[idx],
+                                       local_path + file_name_list[idx], file_sizes[idx], offset,
+                                       length);
+            if (!st.ok()) {
+                std::lock_guard<std::mutex> l(status_lock);
+                if (length > 0) {
+                    range_failed_files.insert(idx);
+                } else {
+                    download_status = st;
+                }
+            }
+        });
+    };
 
-        auto download_cb = [&remote_file_url, estimate_timeout, &local_file_path,
-                            file_size](HttpClient* client) {
-            RETURN_IF_ERROR(client->init(remote_file_url));
-            client->set_timeout_ms(estimate_timeout * 1000);
-            RETURN_IF_ERROR(client->download(local_file_path));
-
-            // Check file length
-            uint64_t local_file_size = boost::filesystem::file_size(local_file_path);
-            if (local_file_size != file_size) {
-                LOG(WARNING) << "download file length error"
-                             << ", remote_path=" << remote_file_url << ", file_size=" << file_size
-                             << ", local_file_size=" << local_file_size;
-                return Status::InternalError("downloaded file size is not equal");
+    uint64_t range_bytes = std::max<int64_t>(0, config::clone_download_range_bytes);
+    Status submit_status = Status::OK();
+    for (size_t i = 0; i < data_file_num && submit_status.ok(); ++i) {
+        uint64_t file_size = file_sizes[i];
+        std::string local_file_path = local_path + file_name_list[i];
+        LOG(INFO) << "clone begin to download file from: " << remote_url_prefix + file_name_list[i]
+                  << " to: " << local_file_path << ". size(B): " << file_size;
+        if (range_bytes == 0 || file_size <= range_bytes) {
+            submit_status = submit_download(i, 0, 0);
+            continue;
+        }
+        int fd = open(local_file_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+        if (fd < 0 || ftruncate(fd, file_size) != 0) {
+            LOG(WARNING) << "fail to create file for ranged download, file=" << local_file_path
+                         << ", errno=" << errno;
+            if (fd >= 0) {
+                close(fd);
             }
-            chmod(local_file_path.c_str(), S_IRUSR | S_IWUSR);
-            return Status::OK();
-        };
-        RETURN_IF_ERROR(HttpClient::execute_with_retry(DOWNLOAD_FILE_MAX_RETRY, 1, download_cb));
+            submit_status = Status::InternalError("fail to create file");
+            break;
+        }
+        close(fd);
+        for (uint64_t offset = 0; offset < file_size && submit_status.ok();
+             offset += range_bytes) {
+            submit_status = submit_download(i, offset, std::min(range_bytes, file_size - offset));
+        }
+    }
+    download_pool->wait();
+    RETURN_IF_ERROR(submit_status);
+    RETURN_IF_ERROR(download_status);
+
+    for (size_t idx : range_failed_files) {
+        LOG(INFO) << "ranged download failed, download the whole file: "
+                  << remote_url_prefix + file_name_list[idx];
+        RETURN_IF_ERROR(_download_file(remote_url_prefix + file_name_list[idx],
+                                       local_path + file_name_list[idx], file_sizes[idx], 0, 0));
+    }
+    for (size_t i = data_file_num; i < file_name_list.size(); ++i) {
+        RETURN_IF_ERROR(_download_file(remote_url_prefix + file_name_list[i],
+                                       local_path + file_name_list[i], file_sizes[i], 0, 0));
     } // Clone files from remote backend
 
     uint64_t total_time_ms = watch.elapsed_time() / 1000 / 1000;
@@ -538,6 +638,40 @@ Status EngineCloneTask::_download_files(DataDir* data_dir, const std::string& re
     return Status::OK();
 }
 
+Status EngineCloneTask::_download_file(const std::string& remote_file_url,
+                                       const std::string& local_file_path, uint64_t file_size,
+                                       uint64_t offset, uint64_t length) {
+    uint64_t download_size = length > 0 ? length : file_size;
+    uint64_t estimate_timeout = download_size / config::download_low_speed_limit_kbps / 1024;
+    if (estimate_timeout < config::download_low_speed_time) {
+        estimate_timeout = config::download_low_speed_time;
+    }
+
+    auto download_cb = [&remote_file_url, estimate_timeout, &local_file_path, file_size, offset,
+                        length](HttpClient* client) {
+        RETURN_IF_ERROR(client->init(remote_file_url));
+        client->set_timeout_ms(estimate_timeout * 1000);
+        DownloadStreamGuard stream_guard;
+        client->set_max_download_speed_kbps(stream_guard.max_speed_kbps());
+        if (length > 0) {
+            return client->download_range(local_file_path, offset, length);
+        }
+        RETURN_IF_ERROR(client->download(local_file_path));
+
+        // Check file length
+        uint64_t local_file_size = boost::filesystem::file_size(local_file_path);
+        if (local_file_size != file_size) {
+            LOG(WARNING) << "download file length error"
+                         << ", remote_path=" << remote_file_url << ", file_size=" << file_size
+                         << ", local_file_size=" << local_file_size;
+            return Status::InternalError("downloaded file size is not equal");
+        }
+        chmod(local_file_path.c_str(), S_IRUSR | S_IWUSR);
+        return Status::OK();
+    };
+    return HttpClient::execute_with_retry(DOWNLOAD_FILE_MAX_RETRY, 1, download_cb);
+}
+
 OLAPStatus EngineCloneTask::_convert_to_new_snapshot(const string& clone_dir, int64_t tablet_id) {
     OLAPStatus res = OLAP_SUCCESS;
     // check clone dir existed
@@ -602,6 +736,90 @@ OLAPStatus EngineCloneTask::_convert_to_new_snapshot(const string& clone_dir, in
     return OLAP_SUCCESS;
 }
 
+void EngineCloneTask::_capture_base_rowsets(Tablet* tablet) {
+    _base_rowsets.clear();
+    _skipped_base_rowsets.clear();
+    // the delete bitmap in the source header refers to the segments of the source rowsets
+    if (!config::clone_reuse_local_rowsets || tablet->enable_unique_key_merge_on_write()) {
+        return;
+    }
+    ReadLock rdlock(tablet->get_header_lock_ptr());
+    for (auto& rs_meta : tablet->tablet_meta()->all_rs_metas()) {
+        RowsetSharedPtr rowset = tablet->get_rowset_by_version(rs_meta->version());
+        if (rowset != nullptr && rowset->end_version() <= _clone_req.committed_version) {
+            _base_rowsets.push_back(rowset);
+        }
+    }
+}
+
+OLAPStatus EngineCloneTask::_drop_base_rowset_metas(const string& clone_dir, int64_t tablet_id) {
+    string header_path = TabletMeta::construct_header_file_path(clone_dir, tablet_id);
+    TabletMeta cloned_tablet_meta;
+    RETURN_NOT_OK(cloned_tablet_meta.create_from_file(header_path));
+    TabletMetaPB tablet_meta_pb;
+    cloned_tablet_meta.to_meta_pb(&tablet_meta_pb);
+
+    std::map<std::pair<int64_t, int64_t>, RowsetSharedPtr> base_rowsets;
+    for (auto& rowset : _base_rowsets) {
+        base_rowsets[{rowset->start_version(), rowset->end_version()}] = rowset;
+    }
+    std::set<string> dropped_rowset_ids;
+    auto rs_metas = tablet_meta_pb.mutable_rs_metas();
+    for (auto it = rs_metas->begin(); it != rs_metas->end();) {
+        auto base_it = base_rowsets.find({it->start_version(), it->end_version()});
+        // the source doesn't skip alpha rowsets, nor any rowset if it is of an older version
+        if (base_it == base_rowsets.end() || it->rowset_type() != BETA_ROWSET ||
+            it->num_segments() == 0) {
+            ++it;
+            continue;
+        }
+        RowsetId src_rowset_id;
+        src_rowset_id.init(it->rowset_id_v2());
+        if (FileUtils::check_exist(BetaRowset::segment_file_path(clone_dir, src_rowset_id, 0))) {
+            ++it;
+            continue;
+        }
+        // the local rowset of the same version is kept in place of the source one, so
+        // _clone_full_data() neither installs nor removes anything for this version
+        _skipped_base_rowsets.push_back(base_it->second);
+        dropped_rowset_ids.insert(it->rowset_id_v2());
+        it = rs_metas->erase(it);
+    }
+    auto inc_rs_metas = tablet_meta_pb.mutable_inc_rs_metas();
+    for (auto it = inc_rs_metas->begin(); it != inc_rs_metas->end();) {
+        if (dropped_rowset_ids.count(it->rowset_id_v2()) > 0) {
+            it = inc_rs_metas->erase(it);
+        } else {
+            ++it;
+        }
+    }
+    LOG(INFO) << "drop base rowsets from clone header. tablet_id=" << tablet_id
+              << ", num_base_rowsets=" << _base_rowsets.size()
+              << ", num_dropped=" << _skipped_base_rowsets.size();
+    return TabletMeta::save(header_path, tablet_meta_pb);
+}
+
+OLAPStatus EngineCloneTask::_link_base_rowset(Tablet* tablet, const RowsetSharedPtr& rowset,
+                                              RowsetSharedPtr* linked_rowset) {
+    RowsetId rowset_id = StorageEngine::instance()->next_rowset_id();
+    RowsetMetaPB rs_meta_pb;
+    rowset->rowset_meta()->to_rowset_pb(&rs_meta_pb);
+    RowsetMetaSharedPtr rs_meta(new RowsetMeta());
+    rs_meta->init_from_pb(rs_meta_pb);
+    rs_meta->set_rowset_id(rowset_id);
+    rs_meta->set_tablet_id(tablet->tablet_id());
+    rs_meta->set_tablet_uid(tablet->tablet_uid());
+    RETURN_NOT_OK(RowsetFactory::create_rowset(&tablet->tablet_schema(), tablet->tablet_path(),
+                                               rs_meta, linked_rowset));
+    OLAPStatus res = rowset->link_files_to(tablet->tablet_path(), rowset_id);
+    if (res != OLAP_SUCCESS) {
+        // remove the files linked before the failure
+        (*linked_rowset)->remove();
+        linked_rowset->reset();
+    }
+    return res;
+}
+
 // only incremental clone use this method
 OLAPStatus EngineCloneTask::_finish_clone(Tablet* tablet, const string& clone_dir,
                                           int64_t committed_version, bool is_incremental_clone) {
@@ -614,6 +832,8 @@ OLAPStatus EngineCloneTask::_finish_clone(Tablet* tablet, const string& clone_di
     tablet->set_clone_occurred(true);
 
     tablet->obtain_push_lock();
+    // no load is published on the tablet meanwhile, whose delete bitmap is revised by clone
+    std::lock_guard<std::mutex> update_lock(*tablet->get_rowset_update_lock());
     tablet->obtain_header_wrlock();
     do {
         // check clone dir existed
@@ -788,6 +1008,13 @@ OLAPStatus EngineCloneTask::_clone_full_data(Tablet* tablet, TabletMeta* cloned_
                     break;
                 }
             }
+            // nor if it is a base rowset the source skipped
+            for (auto& rowset : _skipped_base_rowsets) {
+                if (rowset->version() == local_version) {
+                    existed_in_src = true;
+                    break;
+                }
+            }
 
             if (existed_in_src) {
                 cloned_tablet_meta->delete_rs_meta_by_version(local_version,
@@ -814,6 +1041,30 @@ OLAPStatus EngineCloneTask::_clone_full_data(Tablet* tablet, TabletMeta* cloned_
                   << "tablet=" << tablet->full_name() << ", version=" << rs_meta->version().first
                   << "-" << rs_meta->version().second;
     }
+    // a base rowset the source skipped is gone locally if a compaction merged it before the
+    // clone locked the tablet, its files are still held by '_skipped_base_rowsets'
+    std::vector<RowsetSharedPtr> linked_base_rowsets;
+    for (auto& rowset : _skipped_base_rowsets) {
+        if (tablet->get_rowset_by_version(rowset->version()) != nullptr) {
+            continue;
+        }
+        RowsetSharedPtr linked_rowset;
+        OLAPStatus res = _link_base_rowset(tablet, rowset, &linked_rowset);
+        if (res != OLAP_SUCCESS) {
+            LOG(WARNING) << "fail to link base rowset when full clone. tablet="
+                         << tablet->full_name() << ", rowset_id=" << rowset->rowset_id()
+                         << ", res=" << res;
+            for (auto& linked : linked_base_rowsets) {
+                linked->remove();
+            }
+            return res;
+        }
+        linked_base_rowsets.push_back(linked_rowset);
+        rowsets_to_clone.push_back(linked_rowset->rowset_meta());
+        LOG(INFO) << "Base delta to clone."
+                  << "tablet=" << tablet->full_name() << ", version=" << rowset->start_version()
+                  << "-" << rowset->end_version();
+    }
 
     // clone_data to tablet
     // only replace rowset info, must not modify other info such as alter task info. for example
@@ -821,8 +1072,14 @@ OLAPStatus EngineCloneTask::_clone_full_data(Tablet* tablet, TabletMeta* cloned_
     // 2. local tablet has error in push
     // 3. local tablet cloned rowset from other nodes
     // 4. if cleared alter task info, then push will not write to new tablet, the report info is error
-    OLAPStatus clone_res = tablet->revise_tablet_meta(rowsets_to_clone, versions_to_delete);
+    OLAPStatus clone_res = tablet->revise_tablet_meta(rowsets_to_clone, versions_to_delete,
+                                                      &cloned_tablet_meta->delete_bitmap());
     LOG(INFO) << "finish to full clone. tablet=" << tablet->full_name() << ", res=" << clone_res;
+    if (clone_res != OLAP_SUCCESS) {
+        for (auto& linked : linked_base_rowsets) {
+            linked->remove();
+        }
+    }
     // in previous step, copy all files from CLONE_DIR to tablet dir
     // but some rowset is useless, so that remove them here
     for (auto& rs_meta_ptr : rs_metas_found_in_src) {
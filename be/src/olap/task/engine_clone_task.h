@@ -56,12 +56,29 @@ private:
 
     OLAPStatus _convert_to_new_snapshot(const string& clone_dir, int64_t tablet_id);
 
+    // Capture the local rowsets of 'tablet' whose files are not downloaded by a full clone
+    void _capture_base_rowsets(Tablet* tablet);
+
+    // Remove the rowsets whose files the source skipped from the header of the downloaded
+    // snapshot in 'clone_dir', the base rowsets of their versions are kept in their place
+    OLAPStatus _drop_base_rowset_metas(const string& clone_dir, int64_t tablet_id);
+
+    // Link the files of a base rowset the source skipped into 'tablet' as a new rowset,
+    // in case the local rowset of its version is gone by the end of the clone
+    OLAPStatus _link_base_rowset(Tablet* tablet, const RowsetSharedPtr& rowset,
+                                 RowsetSharedPtr* linked_rowset);
+
     void _set_tablet_info(AgentStatus status, bool is_new_tablet);
 
     // Download tablet files from
     Status _download_files(DataDir* data_dir, const std::string& remote_url_prefix,
                            const std::string& local_path);
 
+    // Download [offset, offset + length) of one remote file, length 0 means the whole file
+    static Status _download_file(const std::string& remote_file_url,
+                                 const std::string& local_file_path, uint64_t file_size,
+                                 uint64_t offset, uint64_t length);
+
     Status _make_snapshot(const std::string& ip, int port, TTableId tablet_id,
                           TSchemaHash schema_hash, int timeout_s,
                           const std::vector<Version>* missed_versions, std::string* snapshot_path,
@@ -78,6 +95,10 @@ private:
     const TMasterInfo& _master_info;
     int64_t _copy_size;
     int64_t _copy_time_ms;
+    // the local rowsets whose versions are sent to the snapshot source as base_versions
+    std::vector<RowsetSharedPtr> _base_rowsets;
+    // the base rowsets whose files the source skipped, they stand for the source ones
+    std::vector<RowsetSharedPtr> _skipped_base_rowsets;
 }; // EngineTask
 
 } // namespace doris
@@ -17,11 +17,15 @@
 
 #include "olap/task/engine_publish_version_task.h"
 
+#include <algorithm>
 #include <map>
+#include <mutex>
+#include <set>
 
 #include "olap/data_dir.h"
 #include "olap/rowset/rowset_meta_manager.h"
 #include "olap/tablet_manager.h"
+#include "util/threadpool.h"
 
 namespace doris {
 
@@ -29,129 +33,226 @@ using std::map;
 
 EnginePublishVersionTask::EnginePublishVersionTask(TPublishVersionRequest& publish_version_req,
                                                    std::vector<TTabletId>* error_tablet_ids)
-        : _publish_version_req(publish_version_req), _error_tablet_ids(error_tablet_ids) {}
+        : _publish_version_reqs({&publish_version_req}), _error_tablet_ids({error_tablet_ids}) {}
+
+EnginePublishVersionTask::EnginePublishVersionTask(
+        const std::vector<const TPublishVersionRequest*>& publish_version_reqs,
+        const std::vector<std::vector<TTabletId>*>& error_tablet_ids)
+        : _publish_version_reqs(publish_version_reqs), _error_tablet_ids(error_tablet_ids) {
+    DCHECK_EQ(_publish_version_reqs.size(), _error_tablet_ids.size());
+}
+
+namespace {
+
+// A partition of a publish version request
+struct PartitionPublish {
+    size_t req_idx;
+    TPartitionId partition_id;
+    Version version;
+    VersionHash version_hash;
+    // the related tablets of the partition which are not published yet
+    std::set<TabletInfo> unpublished_tablets;
+};
+
+// The rowset of a transaction to publish on a tablet
+struct TabletPublish {
+    // index of the partition in the partitions of the batch
+    size_t partition_idx;
+    TabletInfo tablet_info;
+    RowsetSharedPtr rowset;
+};
+
+} // namespace
 
 OLAPStatus EnginePublishVersionTask::finish() {
-    OLAPStatus res = OLAP_SUCCESS;
-    int64_t transaction_id = _publish_version_req.transaction_id;
-    LOG(INFO) << "begin to process publish version. transaction_id=" << transaction_id;
-
-    // each partition
-    for (auto& par_ver_info : _publish_version_req.partition_version_infos) {
-        int64_t partition_id = par_ver_info.partition_id;
-        // get all partition related tablets and check whether the tablet have the related version
-        std::set<TabletInfo> partition_related_tablet_infos;
-        StorageEngine::instance()->tablet_manager()->get_partition_related_tablets(
-                partition_id, &partition_related_tablet_infos);
-        if (_publish_version_req.strict_mode && partition_related_tablet_infos.empty()) {
-            LOG(INFO) << "could not find related tablet for partition " << partition_id
-                      << ", skip publish version";
-            continue;
-        }
+    _results.assign(_publish_version_reqs.size(), OLAP_SUCCESS);
+    // the related tablets of the partitions, which several requests may publish
+    map<TPartitionId, std::set<TabletInfo>> partition_related_tablet_infos;
+    std::vector<PartitionPublish> partitions;
+    std::vector<TabletPublish> tablets;
+    for (size_t i = 0; i < _publish_version_reqs.size(); ++i) {
+        const TPublishVersionRequest& req = *_publish_version_reqs[i];
+        int64_t transaction_id = req.transaction_id;
+        LOG(INFO) << "begin to process publish version. transaction_id=" << transaction_id;
 
-        map<TabletInfo, RowsetSharedPtr> tablet_related_rs;
-        StorageEngine::instance()->txn_manager()->get_txn_related_tablets(
-                transaction_id, partition_id, &tablet_related_rs);
-
-        Version version(par_ver_info.version, par_ver_info.version);
-        VersionHash version_hash = par_ver_info.version_hash;
-
-        // each tablet
-        for (auto& tablet_rs : tablet_related_rs) {
-            OLAPStatus publish_status = OLAP_SUCCESS;
-            TabletInfo tablet_info = tablet_rs.first;
-            RowsetSharedPtr rowset = tablet_rs.second;
-            LOG(INFO) << "begin to publish version on tablet. "
-                      << "tablet_id=" << tablet_info.tablet_id
-                      << ", schema_hash=" << tablet_info.schema_hash
-                      << ", version=" << version.first << ", version_hash=" << version_hash
-                      << ", transaction_id=" << transaction_id;
-            // if rowset is null, it means this be received write task, but failed during write
-            // and receive fe's publish version task
-            // this be must return as an error tablet
-            if (rowset == nullptr) {
-                LOG(WARNING) << "could not find related rowset for tablet " << tablet_info.tablet_id
-                             << " txn id " << transaction_id;
-                _error_tablet_ids->push_back(tablet_info.tablet_id);
-                res = OLAP_ERR_PUSH_ROWSET_NOT_FOUND;
-                continue;
+        // each partition
+        for (auto& par_ver_info : req.partition_version_infos) {
+            int64_t partition_id = par_ver_info.partition_id;
+            // get all partition related tablets and check whether the tablet have the related
+            // version
+            auto it = partition_related_tablet_infos.find(partition_id);
+            if (it == partition_related_tablet_infos.end()) {
+                it = partition_related_tablet_infos.emplace(partition_id, std::set<TabletInfo>())
+                             .first;
+                StorageEngine::instance()->tablet_manager()->get_partition_related_tablets(
+                        partition_id, &it->second);
             }
-            TabletSharedPtr tablet = StorageEngine::instance()->tablet_manager()->get_tablet(
-                    tablet_info.tablet_id, tablet_info.schema_hash, tablet_info.tablet_uid);
-            if (tablet == nullptr) {
-                LOG(WARNING) << "can't get tablet when publish version. tablet_id="
-                             << tablet_info.tablet_id << " schema_hash=" << tablet_info.schema_hash;
-                _error_tablet_ids->push_back(tablet_info.tablet_id);
-                res = OLAP_ERR_PUSH_TABLE_NOT_EXIST;
+            if (req.strict_mode && it->second.empty()) {
+                LOG(INFO) << "could not find related tablet for partition " << partition_id
+                          << ", skip publish version";
                 continue;
             }
+            partitions.push_back({i, partition_id,
+                                  Version(par_ver_info.version, par_ver_info.version),
+                                  par_ver_info.version_hash, it->second});
 
-            publish_status = StorageEngine::instance()->txn_manager()->publish_txn(
-                    partition_id, tablet, transaction_id, version, version_hash);
-            if (publish_status != OLAP_SUCCESS) {
-                LOG(WARNING) << "failed to publish version. rowset_id=" << rowset->rowset_id()
-                             << ", tablet_id=" << tablet_info.tablet_id
-                             << ", txn_id=" << transaction_id;
-                _error_tablet_ids->push_back(tablet_info.tablet_id);
-                res = publish_status;
-                continue;
+            map<TabletInfo, RowsetSharedPtr> tablet_related_rs;
+            StorageEngine::instance()->txn_manager()->get_txn_related_tablets(
+                    transaction_id, partition_id, &tablet_related_rs);
+            for (auto& tablet_rs : tablet_related_rs) {
+                tablets.push_back({partitions.size() - 1, tablet_rs.first, tablet_rs.second});
             }
+        }
+    }
 
-            // add visible rowset to tablet
-            publish_status = tablet->add_inc_rowset(rowset);
-            if (publish_status != OLAP_SUCCESS &&
-                publish_status != OLAP_ERR_PUSH_VERSION_ALREADY_EXIST) {
-                LOG(WARNING) << "fail to add visible rowset to tablet. rowset_id="
-                             << rowset->rowset_id() << ", tablet_id=" << tablet_info.tablet_id
-                             << ", txn_id=" << transaction_id << ", res=" << publish_status;
-                _error_tablet_ids->push_back(tablet_info.tablet_id);
-                res = publish_status;
-                continue;
+    // The versions of a tablet are published in ascending order by one task, since a
+    // version of a merge-on-write tablet is only published after the former ones. The
+    // tablets are published concurrently on the publish version pool if it exists.
+    std::map<TTabletId, std::vector<const TabletPublish*>> tablet_groups;
+    for (auto& tablet : tablets) {
+        tablet_groups[tablet.tablet_info.tablet_id].push_back(&tablet);
+    }
+    std::mutex publish_lock;
+    auto publish_tablet = [&](std::vector<const TabletPublish*>* group) {
+        std::stable_sort(group->begin(), group->end(),
+                         [&partitions](const TabletPublish* a, const TabletPublish* b) {
+                             return partitions[a->partition_idx].version.first <
+                                    partitions[b->partition_idx].version.first;
+                         });
+        for (const TabletPublish* tablet : *group) {
+            PartitionPublish& partition = partitions[tablet->partition_idx];
+            OLAPStatus publish_status = _publish_version_on_tablet(
+                    _publish_version_reqs[partition.req_idx]->transaction_id,
+                    partition.partition_id, tablet->tablet_info, tablet->rowset,
+                    partition.version, partition.version_hash);
+            std::lock_guard<std::mutex> l(publish_lock);
+            if (publish_status != OLAP_SUCCESS) {
+                _error_tablet_ids[partition.req_idx]->push_back(tablet->tablet_info.tablet_id);
+                _results[partition.req_idx] = publish_status;
+            } else {
+                partition.unpublished_tablets.erase(tablet->tablet_info);
             }
-            partition_related_tablet_infos.erase(tablet_info);
-            LOG(INFO) << "publish version successfully on tablet. tablet=" << tablet->full_name()
-                      << ", transaction_id=" << transaction_id << ", version=" << version.first
-                      << ", res=" << publish_status;
         }
+    };
+    ThreadPool* pool = StorageEngine::instance()->publish_version_thread_pool();
+    std::unique_ptr<ThreadPoolToken> token;
+    if (pool != nullptr && tablet_groups.size() > 1) {
+        token = pool->new_token(ThreadPool::ExecutionMode::CONCURRENT);
+    }
+    for (auto& it : tablet_groups) {
+        std::vector<const TabletPublish*>* group = &it.second;
+        if (token != nullptr &&
+            token->submit_func([&publish_tablet, group]() { publish_tablet(group); }).ok()) {
+            continue;
+        }
+        publish_tablet(group);
+    }
+    if (token != nullptr) {
+        token->wait();
+    }
+
+    for (auto& partition : partitions) {
+        // has to use strict mode to check if check all tablets
+        if (_publish_version_reqs[partition.req_idx]->strict_mode) {
+            _check_unpublished_tablets(partition.req_idx, partition.unpublished_tablets,
+                                       partition.version);
+        }
+    }
 
-        // check if the related tablet remained all have the version
-        for (auto& tablet_info : partition_related_tablet_infos) {
-            // has to use strict mode to check if check all tablets
-            if (!_publish_version_req.strict_mode) {
-                break;
-            }
-            TabletSharedPtr tablet = StorageEngine::instance()->tablet_manager()->get_tablet(
-                    tablet_info.tablet_id, tablet_info.schema_hash);
-            if (tablet == nullptr) {
-                _error_tablet_ids->push_back(tablet_info.tablet_id);
-            } else {
-                // check if the version exist, if not exist, then set publish failed
-                if (!tablet->check_version_exist(version)) {
-                    _error_tablet_ids->push_back(tablet_info.tablet_id);
-                    // generate a pull rowset meta task to pull rowset from remote meta store and storage
-                    // pull rowset meta using tablet_id + txn_id
-                    // it depends on the tablet type to download file or only meta
-                    if (tablet->in_eco_mode()) {
-                        if (tablet->is_primary_replica()) {
-                            // primary replica should fetch the meta using txn id
-                            // it will fetch the rowset to meta store, and will be published in next publish version task
-                            StorageEngine::instance()->tablet_sync_service()->fetch_rowset(
-                                    tablet, transaction_id, FETCH_DATA);
-                        } else {
-                            // shadow replica should fetch the meta using version
-                            StorageEngine::instance()->tablet_sync_service()->fetch_rowset(
-                                    tablet, version, NOT_FETCH_DATA);
-                        }
-                    }
+    OLAPStatus res = OLAP_SUCCESS;
+    for (size_t i = 0; i < _publish_version_reqs.size(); ++i) {
+        LOG(INFO) << "finish to publish version on transaction."
+                  << "transaction_id=" << _publish_version_reqs[i]->transaction_id
+                  << ", error_tablet_size=" << _error_tablet_ids[i]->size();
+        if (res == OLAP_SUCCESS) {
+            res = _results[i];
+        }
+    }
+    return res;
+}
+
+void EnginePublishVersionTask::_check_unpublished_tablets(size_t req_idx,
+                                                          const std::set<TabletInfo>& tablet_infos,
+                                                          const Version& version) {
+    int64_t transaction_id = _publish_version_reqs[req_idx]->transaction_id;
+    // check if the related tablet remained all have the version
+    for (auto& tablet_info : tablet_infos) {
+        TabletSharedPtr tablet = StorageEngine::instance()->tablet_manager()->get_tablet(
+                tablet_info.tablet_id, tablet_info.schema_hash);
+        if (tablet == nullptr) {
+            _error_tablet_ids[req_idx]->push_back(tablet_info.tablet_id);
+            continue;
+        }
+        // check if the version exist, if not exist, then set publish failed
+        if (!tablet->check_version_exist(version)) {
+            _error_tablet_ids[req_idx]->push_back(tablet_info.tablet_id);
+            // generate a pull rowset meta task to pull rowset from remote meta store and
+            // storage, pull rowset meta using tablet_id + txn_id
+            // it depends on the tablet type to download file or only meta
+            if (tablet->in_eco_mode()) {
+                if (tablet->is_primary_replica()) {
+                    // primary replica should fetch the meta using txn id, it will fetch the
+                    // rowset to meta store, and will be published in next publish version task
+                    StorageEngine::instance()->tablet_sync_service()->fetch_rowset(
+                            tablet, transaction_id, FETCH_DATA);
+                } else {
+                    // shadow replica should fetch the meta using version
+                    StorageEngine::instance()->tablet_sync_service()->fetch_rowset(
+                            tablet, version, NOT_FETCH_DATA);
                 }
             }
         }
     }
+}
 
-    LOG(INFO) << "finish to publish version on transaction."
-              << "transaction_id=" << transaction_id
-              << ", error_tablet_size=" << _error_tablet_ids->size();
-    return res;
+OLAPStatus EnginePublishVersionTask::_publish_version_on_tablet(
+        int64_t transaction_id, TPartitionId partition_id, const TabletInfo& tablet_info,
+        const RowsetSharedPtr& rowset, const Version& version, VersionHash version_hash) {
+    LOG(INFO) << "begin to publish version on tablet. "
+              << "tablet_id=" << tablet_info.tablet_id << ", schema_hash=" << tablet_info.schema_hash
+              << ", version=" << version.first << ", version_hash=" << version_hash
+              << ", transaction_id=" << transaction_id;
+    // if rowset is null, it means this be received write task, but failed during write
+    // and receive fe's publish version task
+    // this be must return as an error tablet
+    if (rowset == nullptr) {
+        LOG(WARNING) << "could not find related rowset for tablet " << tablet_info.tablet_id
+                     << " txn id " << transaction_id;
+        return OLAP_ERR_PUSH_ROWSET_NOT_FOUND;
+    }
+    TabletSharedPtr tablet = StorageEngine::instance()->tablet_manager()->get_tablet(
+            tablet_info.tablet_id, tablet_info.schema_hash, tablet_info.tablet_uid);
+    if (tablet == nullptr) {
+        LOG(WARNING) << "can't get tablet when publish version. tablet_id="
+                     << tablet_info.tablet_id << " schema_hash=" << tablet_info.schema_hash;
+        return OLAP_ERR_PUSH_TABLE_NOT_EXIST;
+    }
+
+    // checked before the txn is published, otherwise it could not be published again
+    if (tablet->enable_unique_key_merge_on_write()) {
+        RETURN_NOT_OK(tablet->check_publish_order(version));
+    }
+
+    OLAPStatus publish_status = StorageEngine::instance()->txn_manager()->publish_txn(
+            partition_id, tablet, transaction_id, version, version_hash);
+    if (publish_status != OLAP_SUCCESS) {
+        LOG(WARNING) << "failed to publish version. rowset_id=" << rowset->rowset_id()
+                     << ", tablet_id=" << tablet_info.tablet_id << ", txn_id=" << transaction_id;
+        return publish_status;
+    }
+
+    // add visible rowset to tablet
+    publish_status = tablet->add_inc_rowset(rowset);
+    if (publish_status != OLAP_SUCCESS && publish_status != OLAP_ERR_PUSH_VERSION_ALREADY_EXIST) {
+        LOG(WARNING) << "fail to add visible rowset to tablet. rowset_id=" << rowset->rowset_id()
+                     << ", tablet_id=" << tablet_info.tablet_id << ", txn_id=" << transaction_id
+                     << ", res=" << publish_status;
+        return publish_status;
+    }
+    LOG(INFO) << "publish version successfully on tablet. tablet=" << tablet->full_name()
+              << ", transaction_id=" << transaction_id << ", version=" << version.first
+              << ", res=" << publish_status;
+    return OLAP_SUCCESS;
 }
 
 } // namespace doris
@@ -18,8 +18,13 @@
 #ifndef DORIS_BE_SRC_OLAP_TASK_ENGINE_PUBLISH_VERSION_TASK_H
 #define DORIS_BE_SRC_OLAP_TASK_ENGINE_PUBLISH_VERSION_TASK_H
 
+#include <set>
+#include <vector>
+
 #include "gen_cpp/AgentService_types.h"
 #include "olap/olap_define.h"
+#include "olap/rowset/rowset.h"
+#include "olap/txn_manager.h"
 #include "olap/task/engine_task.h"
 
 namespace doris {
@@ -28,13 +33,34 @@ class EnginePublishVersionTask : public EngineTask {
 public:
     EnginePublishVersionTask(TPublishVersionRequest& publish_version_req,
                              vector<TTabletId>* error_tablet_ids);
+    // Publish the transactions of a batch of requests in one pass: the related tablets of
+    // a partition are looked up once for all of them, and the tablets of all of them are
+    // published concurrently. The error tablets of publish_version_reqs[i] are added to
+    // error_tablet_ids[i], and its result is results()[i] after finish().
+    EnginePublishVersionTask(const vector<const TPublishVersionRequest*>& publish_version_reqs,
+                             const vector<vector<TTabletId>*>& error_tablet_ids);
     ~EnginePublishVersionTask() {}
 
+    // Returns the first error of the requests
     virtual OLAPStatus finish() override;
 
+    const vector<OLAPStatus>& results() const { return _results; }
+
+private:
+    OLAPStatus _publish_version_on_tablet(int64_t transaction_id, TPartitionId partition_id,
+                                          const TabletInfo& tablet_info,
+                                          const RowsetSharedPtr& rowset, const Version& version,
+                                          VersionHash version_hash);
+
+    // Check that the related tablets of a partition not published by the request all
+    // have the version, in strict mode
+    void _check_unpublished_tablets(size_t req_idx, const std::set<TabletInfo>& tablet_infos,
+                                    const Version& version);
+
 private:
-    const TPublishVersionRequest& _publish_version_req;
-    vector<TTabletId>* _error_tablet_ids;
+    vector<const TPublishVersionRequest*> _publish_version_reqs;
+    vector<vector<TTabletId>*> _error_tablet_ids;
+    vector<OLAPStatus> _results;
 };
 
 } // namespace doris
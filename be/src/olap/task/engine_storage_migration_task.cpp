@@ -17,13 +17,46 @@
 
 #include "olap/task/engine_storage_migration_task.h"
 
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <mutex>
+#include <set>
+
+#include "common/config.h"
+#include "olap/rowset/beta_rowset.h"
 #include "olap/snapshot_manager.h"
 #include "olap/tablet_meta_manager.h"
+#include "util/bandwidth_limiter.h"
+#include "util/file_utils.h"
+#include "util/scoped_cleanup.h"
+#include "util/threadpool.h"
 
 namespace doris {
 
 using std::stringstream;
 
+// the tablets being migrated, a tablet is migrated by one task at a time
+static std::mutex s_migrating_tablets_lock;
+static std::set<int64_t> s_migrating_tablets;
+
+static OLAPStatus link_or_copy_file(const std::string& src, const std::string& dest,
+                                    bool link_file, BandwidthLimiter* limiter) {
+    if (FileUtils::check_exist(dest)) {
+        LOG(WARNING) << "file already exist: " << dest;
+        return OLAP_ERR_FILE_ALREADY_EXIST;
+    }
+    if (link_file && link(src.c_str(), dest.c_str()) == 0) {
+        return OLAP_SUCCESS;
+    }
+    if (copy_file(src, dest, limiter) != OLAP_SUCCESS) {
+        LOG(WARNING) << "fail to copy file. from=" << src << ", to=" << dest
+                     << ", errno=" << Errno::no();
+        return OLAP_ERR_OS_ERROR;
+    }
+    return OLAP_SUCCESS;
+}
+
 EngineStorageMigrationTask::EngineStorageMigrationTask(const TabletSharedPtr& tablet,
                                                        DataDir* dest_store)
         : _tablet(tablet), _dest_store(dest_store) {}
@@ -32,6 +65,10 @@ OLAPStatus EngineStorageMigrationTask::execute() {
     return _migrate();
 }
 
+// The files are copied in two phases so that loads are not blocked by copying the whole
+// tablet: the rowsets are copied without the migration lock first, then the rowsets added
+// during the copy are copied under the migration lock and the push lock, and the tablet
+// is switched to the new path.
 OLAPStatus EngineStorageMigrationTask::_migrate() {
     int64_t tablet_id = _tablet->tablet_id();
     int32_t schema_hash = _tablet->schema_hash();
@@ -40,82 +77,92 @@ OLAPStatus EngineStorageMigrationTask::_migrate() {
 
     DorisMetrics::instance()->storage_migrate_requests_total->increment(1);
 
-    // try hold migration lock first
-    OLAPStatus res = OLAP_SUCCESS;
-    WriteLock migration_wlock(_tablet->get_migration_lock_ptr(), TRY_LOCK);
-    if (!migration_wlock.own_lock()) {
-        return OLAP_ERR_RWLOCK_ERROR;
+    {
+        std::lock_guard<std::mutex> l(s_migrating_tablets_lock);
+        if (!s_migrating_tablets.insert(tablet_id).second) {
+            LOG(WARNING) << "tablet is being migrated, tablet=" << _tablet->full_name();
+            return OLAP_ERR_RWLOCK_ERROR;
+        }
     }
+    SCOPED_CLEANUP({
+        std::lock_guard<std::mutex> l(s_migrating_tablets_lock);
+        s_migrating_tablets.erase(tablet_id);
+    });
 
     // check if this tablet has related running txns. if yes, can not do migration.
-    int64_t partition_id;
-    std::set<int64_t> transaction_ids;
-    StorageEngine::instance()->txn_manager()->get_tablet_related_txns(
-            tablet_id, schema_hash, _tablet->tablet_uid(), &partition_id, &transaction_ids);
-    if (transaction_ids.size() > 0) {
+    if (_has_running_txns()) {
         LOG(WARNING) << "could not migration because has unfinished txns, "
                      << " tablet=" << _tablet->full_name();
         return OLAP_ERR_HEADER_HAS_PENDING_DATA;
     }
 
-    _tablet->obtain_push_lock();
+    std::vector<RowsetSharedPtr> consistent_rowsets;
+    OLAPStatus res = _get_consistent_rowsets(&consistent_rowsets);
+    if (res != OLAP_SUCCESS) {
+        return res;
+    }
 
-    // TODO(ygl): the tablet should not under schema change or rollup or load
-    do {
-        // get all versions to be migrate
-        _tablet->obtain_header_rdlock();
-        const RowsetSharedPtr last_version = _tablet->rowset_with_max_version();
-        if (last_version == nullptr) {
-            _tablet->release_header_lock();
-            res = OLAP_ERR_VERSION_NOT_EXIST;
-            LOG(WARNING) << "failed to get rowset with max version, tablet="
-                         << _tablet->full_name();
-            break;
-        }
+    uint64_t shard = 0;
+    res = _dest_store->get_shard(&shard);
+    if (res != OLAP_SUCCESS) {
+        LOG(WARNING) << "fail to get shard from store: " << _dest_store->path();
+        return res;
+    }
+    std::stringstream root_path_stream;
+    root_path_stream << _dest_store->path() << DATA_PREFIX << "/" << shard;
+    string full_path = SnapshotManager::instance()->get_schema_hash_full_path(
+            _tablet, root_path_stream.str());
+    // if dir already exist then return err, it should not happen.
+    // should not remove the dir directly, for safety reason.
+    if (FileUtils::check_exist(full_path)) {
+        LOG(INFO) << "schema hash path already exist, skip this path. "
+                  << "full_path=" << full_path;
+        return OLAP_ERR_FILE_ALREADY_EXIST;
+    }
 
-        int32_t end_version = last_version->end_version();
-        std::vector<RowsetSharedPtr> consistent_rowsets;
-        res = _tablet->capture_consistent_rowsets(Version(0, end_version), &consistent_rowsets);
-        if (consistent_rowsets.empty()) {
-            _tablet->release_header_lock();
-            res = OLAP_ERR_VERSION_NOT_EXIST;
-            LOG(WARNING) << "fail to capture consistent rowsets. tablet=" << _tablet->full_name()
-                         << ", version=" << end_version;
-            break;
+    Status st = FileUtils::create_dir(full_path);
+    if (!st.ok()) {
+        LOG(WARNING) << "fail to create path. path=" << full_path << ", error:" << st.to_string();
+        return OLAP_ERR_CANNOT_CREATE_DIR;
+    }
+    // the new path is removed if the new tablet is not loaded from it
+    bool tablet_loaded = false;
+    SCOPED_CLEANUP({
+        if (!tablet_loaded) {
+            Status ret = FileUtils::remove_all(full_path);
+            if (!ret.ok()) {
+                LOG(WARNING) << "remove storage migration path failed. "
+                             << "full_path:" << full_path << " error: " << ret.to_string();
+            }
         }
-        _tablet->release_header_lock();
+    });
 
-        uint64_t shard = 0;
-        res = _dest_store->get_shard(&shard);
-        if (res != OLAP_SUCCESS) {
-            LOG(WARNING) << "fail to get shard from store: " << _dest_store->path();
-            break;
-        }
-        std::stringstream root_path_stream;
-        root_path_stream << _dest_store->path() << DATA_PREFIX << "/" << shard;
-        string full_path = SnapshotManager::instance()->get_schema_hash_full_path(
-                _tablet, root_path_stream.str());
-        // if dir already exist then return err, it should not happen.
-        // should not remove the dir directly, for safety reason.
-        if (FileUtils::check_exist(full_path)) {
-            LOG(INFO) << "schema hash path already exist, skip this path. "
-                      << "full_path=" << full_path;
-            res = OLAP_ERR_FILE_ALREADY_EXIST;
-            break;
-        }
+    // migrate all index and data files but header file
+    res = _copy_index_and_data_files(full_path, consistent_rowsets);
+    if (res != OLAP_SUCCESS) {
+        LOG(WARNING) << "fail to copy index and data files when migrate. res=" << res;
+        return res;
+    }
 
-        Status st = FileUtils::create_dir(full_path);
-        if (!st.ok()) {
-            res = OLAP_ERR_CANNOT_CREATE_DIR;
-            LOG(WARNING) << "fail to create path. path=" << full_path
-                         << ", error:" << st.to_string();
-            break;
-        }
+    WriteLock migration_wlock(_tablet->get_migration_lock_ptr(), TRY_LOCK);
+    if (!migration_wlock.own_lock()) {
+        return OLAP_ERR_RWLOCK_ERROR;
+    }
+    // txns may begin during the copy
+    if (_has_running_txns()) {
+        LOG(WARNING) << "could not migration because has unfinished txns, "
+                     << " tablet=" << _tablet->full_name();
+        return OLAP_ERR_HEADER_HAS_PENDING_DATA;
+    }
+
+    _tablet->obtain_push_lock();
 
-        // migrate all index and data files but header file
-        res = _copy_index_and_data_files(full_path, consistent_rowsets);
+    // TODO(ygl): the tablet should not under schema change or rollup or load
+    do {
+        // the rowsets may be changed by compactions during the copy
+        res = _copy_rowsets_changed(full_path, &consistent_rowsets);
         if (res != OLAP_SUCCESS) {
-            LOG(WARNING) << "fail to copy index and data files when migrate. res=" << res;
+            LOG(WARNING) << "fail to copy changed rowsets when migrate. res=" << res;
             break;
         }
 
@@ -155,6 +202,7 @@ OLAPStatus EngineStorageMigrationTask::_migrate() {
                          << " schema_hash=" << schema_hash << " path = " << full_path;
             break;
         }
+        tablet_loaded = true;
 
         // if old tablet finished schema change, then the schema change status of the new tablet is DONE
         // else the schema change status of the new tablet is FAILED
@@ -181,6 +229,36 @@ OLAPStatus EngineStorageMigrationTask::_migrate() {
     return res;
 }
 
+bool EngineStorageMigrationTask::_has_running_txns() const {
+    int64_t partition_id;
+    std::set<int64_t> transaction_ids;
+    StorageEngine::instance()->txn_manager()->get_tablet_related_txns(
+            _tablet->tablet_id(), _tablet->schema_hash(), _tablet->tablet_uid(), &partition_id,
+            &transaction_ids);
+    return !transaction_ids.empty();
+}
+
+OLAPStatus EngineStorageMigrationTask::_get_consistent_rowsets(
+        std::vector<RowsetSharedPtr>* consistent_rowsets) const {
+    // get all versions to be migrate
+    ReadLock rdlock(_tablet->get_header_lock_ptr());
+    const RowsetSharedPtr last_version = _tablet->rowset_with_max_version();
+    if (last_version == nullptr) {
+        LOG(WARNING) << "failed to get rowset with max version, tablet=" << _tablet->full_name();
+        return OLAP_ERR_VERSION_NOT_EXIST;
+    }
+
+    int32_t end_version = last_version->end_version();
+    consistent_rowsets->clear();
+    _tablet->capture_consistent_rowsets(Version(0, end_version), consistent_rowsets);
+    if (consistent_rowsets->empty()) {
+        LOG(WARNING) << "fail to capture consistent rowsets. tablet=" << _tablet->full_name()
+                     << ", version=" << end_version;
+        return OLAP_ERR_VERSION_NOT_EXIST;
+    }
+    return OLAP_SUCCESS;
+}
+
 // TODO(ygl): lost some information here, such as cumulative layer point
 void EngineStorageMigrationTask::_generate_new_header(
         uint64_t new_shard, const std::vector<RowsetSharedPtr>& consistent_rowsets,
@@ -199,20 +277,103 @@ void EngineStorageMigrationTask::_generate_new_header(
 }
 
 OLAPStatus EngineStorageMigrationTask::_copy_index_and_data_files(
-        const string& full_path, const std::vector<RowsetSharedPtr>& consistent_rowsets) const {
-    OLAPStatus status = OLAP_SUCCESS;
-    for (const auto& rs : consistent_rowsets) {
-        status = rs->copy_files_to(full_path);
-        if (status != OLAP_SUCCESS) {
-            Status ret = FileUtils::remove_all(full_path);
-            if (!ret.ok()) {
-                LOG(FATAL) << "remove storage migration path failed. "
-                           << "full_path:" << full_path << " error: " << ret.to_string();
+        const string& full_path, const std::vector<RowsetSharedPtr>& rowsets) const {
+    BandwidthLimiter* limiter = StorageEngine::instance()->storage_migration_limiter();
+    limiter->set_rate(config::storage_migration_mbytes_per_sec * 1024L * 1024L);
+    // a file on the same file system is linked rather than copied, the files of the
+    // old tablet are not changed until they are removed
+    struct stat src_stat;
+    struct stat dest_stat;
+    bool link_file = stat(_tablet->tablet_path().c_str(), &src_stat) == 0 &&
+                     stat(full_path.c_str(), &dest_stat) == 0 &&
+                     src_stat.st_dev == dest_stat.st_dev;
+
+    // pairs of the source and destination paths of segment files and their index files
+    std::vector<std::pair<std::string, std::string>> files;
+    for (const auto& rs : rowsets) {
+        if (rs->rowset_meta()->rowset_type() != BETA_ROWSET) {
+            RETURN_NOT_OK(rs->copy_files_to(full_path));
+            continue;
+        }
+        for (int i = 0; i < rs->num_segments(); ++i) {
+            files.emplace_back(
+                    BetaRowset::segment_file_path(_tablet->tablet_path(), rs->rowset_id(), i),
+                    BetaRowset::segment_file_path(full_path, rs->rowset_id(), i));
+            std::string index_path = BetaRowset::segment_index_file_path(_tablet->tablet_path(),
+                                                                         rs->rowset_id(), i);
+            if (FileUtils::check_exist(index_path)) {
+                files.emplace_back(index_path, BetaRowset::segment_index_file_path(
+                                                       full_path, rs->rowset_id(), i));
+            }
+        }
+    }
+
+    std::vector<OLAPStatus> statuses(files.size(), OLAP_SUCCESS);
+    auto copy_file_at = [&](size_t i) {
+        statuses[i] = link_or_copy_file(files[i].first, files[i].second, link_file, limiter);
+    };
+    ThreadPool* pool = StorageEngine::instance()->storage_migration_copy_pool();
+    if (pool == nullptr) {
+        for (size_t i = 0; i < files.size(); ++i) {
+            copy_file_at(i);
+        }
+    } else {
+        std::unique_ptr<ThreadPoolToken> token =
+                pool->new_token(ThreadPool::ExecutionMode::CONCURRENT);
+        for (size_t i = 0; i < files.size(); ++i) {
+            if (!token->submit_func([&copy_file_at, i]() { copy_file_at(i); }).ok()) {
+                copy_file_at(i);
+            }
+        }
+        token->wait();
+    }
+    for (OLAPStatus status : statuses) {
+        RETURN_NOT_OK(status);
+    }
+    return OLAP_SUCCESS;
+}
+
+OLAPStatus EngineStorageMigrationTask::_copy_rowsets_changed(
+        const std::string& full_path, std::vector<RowsetSharedPtr>* copied_rowsets) const {
+    std::vector<RowsetSharedPtr> rowsets;
+    RETURN_NOT_OK(_get_consistent_rowsets(&rowsets));
+
+    std::set<RowsetId> copied_ids;
+    for (const auto& rs : *copied_rowsets) {
+        copied_ids.insert(rs->rowset_id());
+    }
+    std::set<RowsetId> rowset_ids;
+    std::vector<RowsetSharedPtr> new_rowsets;
+    for (const auto& rs : rowsets) {
+        rowset_ids.insert(rs->rowset_id());
+        if (copied_ids.count(rs->rowset_id()) == 0) {
+            new_rowsets.push_back(rs);
+        }
+    }
+    RETURN_NOT_OK(_copy_index_and_data_files(full_path, new_rowsets));
+
+    // the files of stale alpha rowsets are left to the path gc
+    for (const auto& rs : *copied_rowsets) {
+        if (rowset_ids.count(rs->rowset_id()) > 0 ||
+            rs->rowset_meta()->rowset_type() != BETA_ROWSET) {
+            continue;
+        }
+        for (int i = 0; i < rs->num_segments(); ++i) {
+            std::string path = BetaRowset::segment_file_path(full_path, rs->rowset_id(), i);
+            if (::remove(path.c_str()) != 0) {
+                LOG(WARNING) << "fail to remove file. path=" << path
+                             << ", errno=" << Errno::no();
+            }
+            std::string index_path =
+                    BetaRowset::segment_index_file_path(full_path, rs->rowset_id(), i);
+            if (::remove(index_path.c_str()) != 0 && errno != ENOENT) {
+                LOG(WARNING) << "fail to remove file. path=" << index_path
+                             << ", errno=" << Errno::no();
             }
-            break;
         }
     }
-    return status;
+    copied_rowsets->swap(rowsets);
+    return OLAP_SUCCESS;
 }
 
 } // namespace doris
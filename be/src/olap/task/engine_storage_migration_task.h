@@ -37,15 +37,25 @@ public:
 private:
     OLAPStatus _migrate();
 
+    // Return true if the tablet has txns not published
+    bool _has_running_txns() const;
+
+    OLAPStatus _get_consistent_rowsets(std::vector<RowsetSharedPtr>* consistent_rowsets) const;
+
     void _generate_new_header(uint64_t new_shard,
                               const std::vector<RowsetSharedPtr>& consistent_rowsets,
                               TabletMetaSharedPtr new_tablet_meta);
 
-    // TODO: hkp
-    // rewrite this function
-    OLAPStatus _copy_index_and_data_files(
-            const std::string& full_path,
-            const std::vector<RowsetSharedPtr>& consistent_rowsets) const;
+    // Copy the files of 'rowsets' to 'full_path', the segment files of beta rowsets in
+    // parallel. The files are hard linked if 'full_path' is on the same file system.
+    OLAPStatus _copy_index_and_data_files(const std::string& full_path,
+                                          const std::vector<RowsetSharedPtr>& rowsets) const;
+
+    // Copy the rowsets of the tablet added since 'copied_rowsets' were copied to
+    // 'full_path', and remove the copies of the rowsets which are not in the tablet any
+    // more. 'copied_rowsets' is set to the current rowsets of the tablet.
+    OLAPStatus _copy_rowsets_changed(const std::string& full_path,
+                                     std::vector<RowsetSharedPtr>* copied_rowsets) const;
 
 private:
     // tablet to do migrated
@@ -186,7 +186,7 @@ OLAPStatus TxnManager::commit_txn(OlapMeta* meta, TPartitionId partition_id,
         return OLAP_ERR_ROWSET_INVALID;
     }
 
-    MutexLock txn_lock(&_get_txn_lock(transaction_id));
+    MutexLock txn_lock(&_get_txn_lock(transaction_id, tablet_id));
     {
         // get tx
         ReadLock rdlock(&_get_txn_map_lock(transaction_id));
@@ -247,12 +247,12 @@ OLAPStatus TxnManager::commit_txn(OlapMeta* meta, TPartitionId partition_id,
         txn_tablet_map_t& txn_tablet_map = _get_txn_tablet_map(transaction_id);
         txn_tablet_map[key][tablet_info] = load_info;
         _insert_txn_partition_map_unlocked(transaction_id, partition_id);
-        LOG(INFO) << "commit transaction to engine successfully."
-                  << " partition_id: " << key.first << ", transaction_id: " << key.second
-                  << ", tablet: " << tablet_info.to_string()
-                  << ", rowsetid: " << rowset_ptr->rowset_id()
-                  << ", version: " << rowset_ptr->version().first;
     }
+    LOG(INFO) << "commit transaction to engine successfully."
+              << " partition_id: " << key.first << ", transaction_id: " << key.second
+              << ", tablet: " << tablet_info.to_string()
+              << ", rowsetid: " << rowset_ptr->rowset_id()
+              << ", version: " << rowset_ptr->version().first;
     return OLAP_SUCCESS;
 }
 
@@ -264,7 +264,7 @@ OLAPStatus TxnManager::publish_txn(OlapMeta* meta, TPartitionId partition_id,
     pair<int64_t, int64_t> key(partition_id, transaction_id);
     TabletInfo tablet_info(tablet_id, schema_hash, tablet_uid);
     RowsetSharedPtr rowset_ptr = nullptr;
-    MutexLock txn_lock(&_get_txn_lock(transaction_id));
+    MutexLock txn_lock(&_get_txn_lock(transaction_id, tablet_id));
     {
         ReadLock rlock(&_get_txn_map_lock(transaction_id));
         txn_tablet_map_t& txn_tablet_map = _get_txn_tablet_map(transaction_id);
@@ -298,24 +298,28 @@ OLAPStatus TxnManager::publish_txn(OlapMeta* meta, TPartitionId partition_id,
     } else {
         return OLAP_ERR_TRANSACTION_NOT_EXIST;
     }
+    bool erased = false;
     {
         WriteLock wrlock(&_get_txn_map_lock(transaction_id));
         txn_tablet_map_t& txn_tablet_map = _get_txn_tablet_map(transaction_id);
         auto it = txn_tablet_map.find(key);
         if (it != txn_tablet_map.end()) {
             it->second.erase(tablet_info);
-            LOG(INFO) << "publish txn successfully."
-                      << " partition_id: " << key.first << ", txn_id: " << key.second
-                      << ", tablet: " << tablet_info.to_string()
-                      << ", rowsetid: " << rowset_ptr->rowset_id() << ", version: " << version.first
-                      << "," << version.second;
+            erased = true;
             if (it->second.empty()) {
                 txn_tablet_map.erase(it);
                 _clear_txn_partition_map_unlocked(transaction_id, partition_id);
             }
         }
-        return OLAP_SUCCESS;
     }
+    if (erased) {
+        LOG(INFO) << "publish txn successfully."
+                  << " partition_id: " << key.first << ", txn_id: " << key.second
+                  << ", tablet: " << tablet_info.to_string()
+                  << ", rowsetid: " << rowset_ptr->rowset_id() << ", version: " << version.first
+                  << "," << version.second;
+    }
+    return OLAP_SUCCESS;
 }
 
 // txn could be rollbacked if it does not have related rowset
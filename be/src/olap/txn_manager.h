@@ -168,7 +168,9 @@ private:
 
     inline txn_partition_map_t& _get_txn_partition_map(TTransactionId transactionId);
 
-    inline Mutex& _get_txn_lock(TTransactionId transactionId);
+    // The lock serializes commit and publish of one tablet in a txn. It is sharded by
+    // tablet too, so that the tablets of one txn can save their rowset metas concurrently.
+    inline Mutex& _get_txn_lock(TTransactionId transactionId, TTabletId tablet_id);
 
     // insert or remove (transaction_id, partition_id) from _txn_partition_map
     // get _txn_map_lock before calling
@@ -207,8 +209,8 @@ inline TxnManager::txn_partition_map_t& TxnManager::_get_txn_partition_map(
     return _txn_partition_maps[transactionId & (_txn_map_shard_size - 1)];
 }
 
-inline Mutex& TxnManager::_get_txn_lock(TTransactionId transactionId) {
-    return _txn_mutex[transactionId & (_txn_shard_size - 1)];
+inline Mutex& TxnManager::_get_txn_lock(TTransactionId transactionId, TTabletId tablet_id) {
+    return _txn_mutex[(transactionId + tablet_id) & (_txn_shard_size - 1)];
 }
 
 } // namespace doris
@@ -49,6 +49,7 @@
 #include "gutil/strings/substitute.h"
 #include "olap/olap_common.h"
 #include "olap/olap_define.h"
+#include "util/bandwidth_limiter.h"
 #include "util/errno.h"
 #include "util/mutex.h"
 #include "util/string_parser.hpp"
@@ -654,7 +655,7 @@ int operator-(const BinarySearchIterator& left, const BinarySearchIterator& righ
     return *left - *right;
 }
 
-OLAPStatus copy_file(const string& src, const string& dest) {
+OLAPStatus copy_file(const string& src, const string& dest, BandwidthLimiter* limiter) {
     int src_fd = -1;
     int dest_fd = -1;
     char buf[1024 * 1024];
@@ -683,10 +684,14 @@ OLAPStatus copy_file(const string& src, const string& dest) {
         if (rd_size < 0) {
             OLAP_LOG_WARNING("failed to read from file. [err=%m file_name=%s fd=%d size=%ld]",
                              src.c_str(), src_fd, rd_size);
-            return OLAP_ERR_IO_ERROR;
+            res = OLAP_ERR_IO_ERROR;
+            goto COPY_EXIT;
         } else if (0 == rd_size) {
             break;
         }
+        if (limiter != nullptr) {
+            limiter->acquire(rd_size);
+        }
 
         ssize_t wr_size = ::write(dest_fd, buf, rd_size);
         if (wr_size != rd_size) {
@@ -45,6 +45,9 @@
 #define TRY_LOCK true
 
 namespace doris {
+
+class BandwidthLimiter;
+
 void write_log_info(char* buf, size_t buf_len, const char* fmt, ...);
 static const std::string DELETE_SIGN = "__DORIS_DELETE_SIGN__";
 
@@ -196,7 +199,9 @@ int operator-(const BinarySearchIterator& left, const BinarySearchIterator& righ
 // 不用sse4指令的crc32c的计算函数
 unsigned int crc32c_lut(char const* b, unsigned int off, unsigned int len, unsigned int crc);
 
-OLAPStatus copy_file(const std::string& src, const std::string& dest);
+// Copy 'src' to 'dest', at the rate of 'limiter' if it is not null
+OLAPStatus copy_file(const std::string& src, const std::string& dest,
+                     BandwidthLimiter* limiter = nullptr);
 
 OLAPStatus copy_dir(const std::string& src_dir, const std::string& dst_dir);
 
@@ -0,0 +1,130 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/zorder.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include "common/logging.h"
+#include "gutil/endian.h"
+#include "olap/key_coder.h"
+#include "olap/row.h"
+#include "olap/schema.h"
+#include "util/radix_sort.h"
+
+namespace doris {
+
+namespace {
+
+// Sorting less rows than this by radix sort doesn't pay off its passes
+const size_t kMinRowsToRadixSort = 256;
+
+} // namespace
+
+struct ZOrderSorter::SortEntryRadixSortTraits {
+    using Element = SortEntry;
+    using Key = uint64_t;
+    using CountType = uint32_t;
+    using KeyBits = uint64_t;
+
+    static constexpr size_t PART_SIZE_BITS = 8;
+
+    using Transform = RadixSortIdentityTransform<KeyBits>;
+    using Allocator = RadixSortMallocAllocator;
+
+    static Key& extractKey(Element& elem) { return elem.z_value; }
+
+    static bool less(Key x, Key y) { return x < y; }
+};
+
+ZOrderSorter::ZOrderSorter(const Schema* schema, const std::vector<uint32_t>& column_ids)
+        : _schema(schema), _column_ids(column_ids) {
+    DCHECK(!_column_ids.empty() && _column_ids.size() <= 64);
+    for (uint32_t cid : _column_ids) {
+        // columns without key coder, which FE doesn't allow, are ignored by z-values
+        _key_coders.push_back(get_key_coder(_schema->column(cid)->type()));
+    }
+}
+
+uint64_t ZOrderSorter::_prefix(const char* row, size_t col) {
+    ContiguousRow src_row(_schema, row);
+    auto cell = src_row.cell(_column_ids[col]);
+    // null is less than any value, and a value may have prefix 0 as well
+    if (cell.is_null() || _key_coders[col] == nullptr) {
+        return 0;
+    }
+    _prefix_buf.clear();
+    _key_coders[col]->encode_ascending(cell.cell_ptr(), sizeof(uint64_t), &_prefix_buf);
+    char buf[sizeof(uint64_t)] = {0};
+    memcpy(buf, _prefix_buf.data(), std::min(_prefix_buf.size(), sizeof(buf)));
+    return BigEndian::Load64(buf);
+}
+
+void ZOrderSorter::sort(std::vector<char*>* rows) {
+    size_t num_rows = rows->size();
+    size_t num_columns = _column_ids.size();
+    if (num_rows < 2) {
+        return;
+    }
+    int bits_per_column = 64 / num_columns;
+
+    // the prefixes of a column are normalized to [0, 2^bits_per_column)
+    std::vector<uint64_t> prefixes(num_rows * num_columns);
+    for (size_t col = 0; col < num_columns; ++col) {
+        uint64_t min_prefix = std::numeric_limits<uint64_t>::max();
+        uint64_t max_prefix = 0;
+        uint64_t* col_prefixes = &prefixes[col * num_rows];
+        for (size_t i = 0; i < num_rows; ++i) {
+            col_prefixes[i] = _prefix((*rows)[i], col);
+            min_prefix = std::min(min_prefix, col_prefixes[i]);
+            max_prefix = std::max(max_prefix, col_prefixes[i]);
+        }
+        uint64_t range = max_prefix - min_prefix;
+        int range_bits = range == 0 ? 0 : 64 - __builtin_clzll(range);
+        int shift = std::max(0, range_bits - bits_per_column);
+        for (size_t i = 0; i < num_rows; ++i) {
+            col_prefixes[i] = (col_prefixes[i] - min_prefix) >> shift;
+        }
+    }
+
+    std::vector<SortEntry> entries(num_rows);
+    for (size_t i = 0; i < num_rows; ++i) {
+        uint64_t z_value = 0;
+        for (int bit = bits_per_column - 1; bit >= 0; --bit) {
+            for (size_t col = 0; col < num_columns; ++col) {
+                z_value = (z_value << 1) | ((prefixes[col * num_rows + i] >> bit) & 1);
+            }
+        }
+        entries[i].z_value = z_value;
+        entries[i].row = (*rows)[i];
+    }
+    if (num_rows >= kMinRowsToRadixSort) {
+        RadixSort<SortEntryRadixSortTraits>::executeLSD(entries.data(), entries.size());
+    } else {
+        std::stable_sort(entries.begin(), entries.end(),
+                         [](const SortEntry& lhs, const SortEntry& rhs) {
+                             return lhs.z_value < rhs.z_value;
+                         });
+    }
+    for (size_t i = 0; i < num_rows; ++i) {
+        (*rows)[i] = entries[i].row;
+    }
+}
+
+} // namespace doris
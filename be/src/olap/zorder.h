@@ -0,0 +1,60 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace doris {
+
+class KeyCoder;
+class Schema;
+
+// Sorts rows by the Z-order curve of some of their columns, which interleaves the bits of
+// the columns, so that rows close to each other in any of the columns tend to be stored
+// together, and the zone maps and bloom filters of pages are selective on all of them.
+//
+// A column takes 64 / num_columns bits of the z-value of a row: the order-preserving prefix
+// of its value minus the min prefix of the rows, shifted to the bits of the range of the
+// rows. So the values of the rows, not the range of their type, are spread over the bits.
+class ZOrderSorter {
+public:
+    // 'column_ids' are the ids of the clustering columns in 'schema'
+    ZOrderSorter(const Schema* schema, const std::vector<uint32_t>& column_ids);
+
+    // Sort the rows of 'schema' stably by their z-values
+    void sort(std::vector<char*>* rows);
+
+private:
+    struct SortEntry {
+        uint64_t z_value;
+        char* row;
+    };
+    struct SortEntryRadixSortTraits;
+
+    // The big endian load of the first 8 bytes of the memcmp-comparable encoding
+    uint64_t _prefix(const char* row, size_t col);
+
+    const Schema* _schema;
+    std::vector<uint32_t> _column_ids;
+    std::vector<const KeyCoder*> _key_coders;
+    std::string _prefix_buf;
+};
+
+} // namespace doris
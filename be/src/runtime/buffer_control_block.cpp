@@ -47,7 +47,13 @@ void GetResultBatchCtx::on_close(int64_t packet_seq, QueryStatistics* statistics
 void GetResultBatchCtx::on_data(TFetchDataResult* t_result, int64_t packet_seq, bool eos) {
     uint8_t* buf = nullptr;
     uint32_t len = 0;
-    ThriftSerializer ser(false, 4096);
+    // size the buffer for the whole batch up front instead of growing it from 4KB, list<binary>
+    // takes 4 bytes for the length of each row, the rest of the struct fits in 64 bytes
+    size_t serialized_size = 64;
+    for (const auto& row : t_result->result_batch.rows) {
+        serialized_size += 4 + row.size();
+    }
+    ThriftSerializer ser(false, serialized_size);
     auto st = ser.serialize(&t_result->result_batch, &len, &buf);
     if (st.ok()) {
         cntl->response_attachment().append(buf, len);
@@ -149,7 +155,8 @@ Status BufferControlBlock::get_batch(TFetchDataResult* result) {
         _buffer_rows -= item->result_batch.rows.size();
         _data_removal.notify_one();
     }
-    *result = *item;
+    // the rows are moved rather than copied
+    swap(*result, *item);
     result->__set_packet_num(_packet_num);
     _packet_num++;
     // destruct item new from Result writer
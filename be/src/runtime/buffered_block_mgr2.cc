@@ -17,6 +17,9 @@
 
 #include "runtime/buffered_block_mgr2.h"
 
+#include <algorithm>
+
+#include "common/config.h"
 #include "exec/exec_node.h"
 #include "runtime/exec_env.h"
 #include "runtime/mem_pool.h"
@@ -24,6 +27,7 @@
 #include "runtime/runtime_state.h"
 #include "runtime/tmp_file_mgr.h"
 #include "util/bit_util.h"
+#include "util/block_compression.h"
 #include "util/debug_util.h"
 #include "util/disk_info.h"
 #include "util/doris_metrics.h"
@@ -134,6 +138,8 @@ BufferedBlockMgr2::Block::Block(BufferedBlockMgr2* block_mgr)
           _write_range(NULL),
           _tmp_file(NULL),
           _valid_data_len(0),
+          _compressed_len(0),
+          _compression_buffer(NULL),
           _num_rows(0) {}
 
 Status BufferedBlockMgr2::Block::pin(bool* pinned, Block* release_block, bool unpin) {
@@ -154,6 +160,7 @@ void BufferedBlockMgr2::Block::init() {
     _in_write = false;
     _is_deleted = false;
     _valid_data_len = 0;
+    _compressed_len = 0;
     _client = NULL;
     _num_rows = 0;
 }
@@ -217,6 +224,7 @@ BufferedBlockMgr2::BufferedBlockMgr2(RuntimeState* state, TmpFileMgr* tmp_file_m
           _unfullfilled_reserved_buffers(0),
           _total_pinned_buffers(0),
           _non_local_outstanding_writes(0),
+          _compression_codec(NULL),
           _io_mgr(state->exec_env()->disk_io_mgr()),
           _is_cancelled(false),
           _writes_issued(0),
@@ -374,7 +382,7 @@ bool BufferedBlockMgr2::consume_memory(Client* client, int64_t size) {
 
     Status status = Status::OK();
     if (buffers_acquired == buffers_needed) {
-        status = write_unpinned_blocks();
+        status = write_unpinned_blocks(lock);
     }
     // If we either couldn't acquire enough buffers or write_unpinned_blocks() failed, undo
     // the reservation.
@@ -525,7 +533,7 @@ Status BufferedBlockMgr2::transfer_buffer(Block* dst, Block* src, bool unpin) {
     if (unpin) {
         unique_lock<mutex> lock(_lock);
         src->_client_local = true;
-        status = write_unpinned_block(src);
+        status = write_unpinned_block(lock, src);
         if (!status.ok()) {
             // The transfer failed, return the buffer to src.
             src->_is_pinned = true;
@@ -595,6 +603,11 @@ BufferedBlockMgr2::~BufferedBlockMgr2() {
         _mem_tracker->Release(buffer->len);
         delete[] buffer->buffer;
     }
+    for (uint8_t* buffer : _all_compression_buffers) {
+        _mem_tracker->Release(_max_block_size);
+        delete[] buffer;
+    }
+    _mem_tracker->FlushConsumptionCaches();
     DCHECK_EQ(_mem_tracker->consumption(), 0);
     _mem_tracker.reset();
 }
@@ -603,6 +616,38 @@ int64_t BufferedBlockMgr2::bytes_allocated() const {
     return _mem_tracker->consumption();
 }
 
+int64_t BufferedBlockMgr2::release_free_buffers(int64_t bytes) {
+    unique_lock<mutex> lock(_lock, boost::try_to_lock);
+    if (!lock.owns_lock() || !_initialized) {
+        return 0;
+    }
+    int64_t freed = 0;
+    while (freed < bytes && !_free_io_buffers.empty()) {
+        BufferDescriptor* buffer = _free_io_buffers.dequeue();
+        if (buffer->block != NULL) {
+            DCHECK(buffer->block->_write_range != NULL) << buffer->block->debug_string();
+            buffer->block->_buffer_desc = NULL;
+            buffer->block = NULL;
+        }
+        _all_io_buffers.erase(buffer->all_buffers_it);
+        delete[] buffer->buffer;
+        buffer->buffer = NULL;
+        _mem_tracker->Release(buffer->len);
+        freed += buffer->len;
+    }
+    while (freed < bytes && !_free_compression_buffers.empty()) {
+        uint8_t* buffer = _free_compression_buffers.back();
+        _free_compression_buffers.pop_back();
+        _all_compression_buffers.erase(std::find(_all_compression_buffers.begin(),
+                                                 _all_compression_buffers.end(), buffer));
+        delete[] buffer;
+        _mem_tracker->Release(_max_block_size);
+        freed += _max_block_size;
+    }
+    DCHECK(validate()) << endl << debug_internal();
+    return freed;
+}
+
 int BufferedBlockMgr2::num_pinned_buffers(Client* client) const {
     return client->_num_pinned_buffers;
 }
@@ -654,7 +699,7 @@ Status BufferedBlockMgr2::pin_block(Block* block, bool* pinned, Block* release_b
 
         if (block->_buffer_desc != NULL) {
             {
-                lock_guard<mutex> lock(_lock);
+                unique_lock<mutex> lock(_lock);
                 if (_free_io_buffers.contains(block->_buffer_desc)) {
                     DCHECK(!block->_is_pinned && !block->_in_write &&
                            !_unpinned_blocks.contains(block))
@@ -670,7 +715,7 @@ Status BufferedBlockMgr2::pin_block(Block* block, bool* pinned, Block* release_b
                 *pinned = true;
                 block->_client->pin_buffer(block->_buffer_desc);
                 ++_total_pinned_buffers;
-                RETURN_IF_ERROR(write_unpinned_blocks());
+                RETURN_IF_ERROR(write_unpinned_blocks(lock));
             }
             return delete_or_unpin_block(release_block, unpin);
         }
@@ -693,26 +738,53 @@ Status BufferedBlockMgr2::pin_block(Block* block, bool* pinned, Block* release_b
     vector<DiskIoMgr::ScanRange*> ranges(1, scan_range);
     RETURN_IF_ERROR(_io_mgr->add_scan_ranges(_io_request_context, ranges, true));
 
-    // Read from the io mgr buffer into the block's assigned buffer.
+    // Read from the io mgr buffer into the block's assigned buffer, or into a compression
+    // buffer if the block was written compressed. The compression buffer is freed with
+    // the block mgr if an error is returned before it is given back.
+    uint8_t* read_buffer = block->buffer();
+    if (block->_compressed_len > 0) {
+        lock_guard<mutex> lock(_lock);
+        read_buffer = get_compression_buffer();
+    }
     int64_t offset = 0;
     bool buffer_eosr = false;
     do {
         DiskIoMgr::BufferDescriptor* io_mgr_buffer;
         RETURN_IF_ERROR(scan_range->get_next(&io_mgr_buffer));
-        memcpy(block->buffer() + offset, io_mgr_buffer->buffer(), io_mgr_buffer->len());
+        memcpy(read_buffer + offset, io_mgr_buffer->buffer(), io_mgr_buffer->len());
         offset += io_mgr_buffer->len();
         buffer_eosr = io_mgr_buffer->eosr();
         io_mgr_buffer->return_buffer();
     } while (!buffer_eosr);
     DCHECK_EQ(offset, block->_write_range->len());
 
+    if (block->_compressed_len > 0) {
+        DCHECK_EQ(offset, block->_compressed_len);
+        Slice decompressed(block->buffer(), block->_valid_data_len);
+        Status status;
+        {
+            SCOPED_TIMER(_compression_timer);
+            status = _compression_codec->decompress(Slice(read_buffer, offset), &decompressed);
+        }
+        {
+            lock_guard<mutex> lock(_lock);
+            _free_compression_buffers.push_back(read_buffer);
+        }
+        RETURN_IF_ERROR(status);
+        if (decompressed.size != block->_valid_data_len) {
+            return Status::InternalError("Spilled block was corrupted: decompressed " +
+                                         std::to_string(decompressed.size) + " bytes, expected " +
+                                         std::to_string(block->_valid_data_len));
+        }
+    }
+
     return delete_or_unpin_block(release_block, unpin);
 }
 
 Status BufferedBlockMgr2::unpin_block(Block* block) {
     DCHECK(!block->_is_deleted) << "Unpin for deleted block.";
 
-    lock_guard<mutex> unpinned_lock(_lock);
+    unique_lock<mutex> unpinned_lock(_lock);
     if (_is_cancelled) {
         return Status::Cancelled("Cancelled");
     }
@@ -734,13 +806,13 @@ Status BufferedBlockMgr2::unpin_block(Block* block) {
         ++_unfullfilled_reserved_buffers;
     }
     --_total_pinned_buffers;
-    RETURN_IF_ERROR(write_unpinned_blocks());
+    RETURN_IF_ERROR(write_unpinned_blocks(unpinned_lock));
     DCHECK(validate()) << endl << debug_internal();
     DCHECK(block->validate()) << endl << block->debug_string();
     return Status::OK();
 }
 
-Status BufferedBlockMgr2::write_unpinned_blocks() {
+Status BufferedBlockMgr2::write_unpinned_blocks(unique_lock<mutex>& lock) {
     if (!_enable_spill) {
         return Status::OK();
     }
@@ -751,14 +823,19 @@ Status BufferedBlockMgr2::write_unpinned_blocks() {
         // Pop a block from the back of the list (LIFO).
         Block* write_block = _unpinned_blocks.pop_back();
         write_block->_client_local = false;
-        RETURN_IF_ERROR(write_unpinned_block(write_block));
+        // Counted before it's issued, the lock is released while the block is compressed.
         ++_non_local_outstanding_writes;
+        Status status = write_unpinned_block(lock, write_block);
+        if (!status.ok()) {
+            --_non_local_outstanding_writes;
+            return status;
+        }
     }
     DCHECK(validate()) << endl << debug_internal();
     return Status::OK();
 }
 
-Status BufferedBlockMgr2::write_unpinned_block(Block* block) {
+Status BufferedBlockMgr2::write_unpinned_block(unique_lock<mutex>& lock, Block* block) {
     // Assumes block manager lock is already taken.
     DCHECK(!block->_is_pinned) << block->debug_string();
     DCHECK(!block->_in_write) << block->debug_string();
@@ -787,23 +864,90 @@ Status BufferedBlockMgr2::write_unpinned_block(Block* block) {
         block->_tmp_file = tmp_file;
     }
 
-    uint8_t* outbuf = NULL;
-    outbuf = block->buffer();
+    // The block is in write from here on, so its buffer is neither reused nor written
+    // again while the lock is released to compress it.
+    block->_in_write = true;
+    uint8_t* outbuf = block->buffer();
+    int64_t write_len = block->_valid_data_len;
+    compress_block(lock, block);
+    if (block->_compression_buffer != NULL) {
+        outbuf = block->_compression_buffer;
+        write_len = block->_compressed_len;
+    }
 
-    block->_write_range->set_data(outbuf, block->_valid_data_len);
+    block->_write_range->set_data(outbuf, write_len);
 
     // Issue write through DiskIoMgr.
-    RETURN_IF_ERROR(_io_mgr->add_write_range(_io_request_context, block->_write_range));
-    block->_in_write = true;
+    Status status = _io_mgr->add_write_range(_io_request_context, block->_write_range);
+    if (!status.ok()) {
+        block->_in_write = false;
+        if (block->_compression_buffer != NULL) {
+            _free_compression_buffers.push_back(block->_compression_buffer);
+            block->_compression_buffer = NULL;
+        }
+        // Finish a delete_block() that was deferred to the write.
+        if (block->_is_deleted && block->_buffer_desc != NULL) {
+            _free_io_buffers.enqueue(block->_buffer_desc);
+            block->_buffer_desc->block = NULL;
+            block->_buffer_desc = NULL;
+            return_unused_block(block);
+        }
+        return status;
+    }
     DCHECK(block->validate()) << endl << block->debug_string();
     _outstanding_writes_counter->update(1);
-    _bytes_written_counter->update(block->_valid_data_len);
+    _bytes_written_counter->update(write_len);
     ++_writes_issued;
     if (_writes_issued == 1) {
     }
     return Status::OK();
 }
 
+void BufferedBlockMgr2::compress_block(unique_lock<mutex>& lock, Block* block) {
+    // Assumes block manager lock is already taken.
+    DCHECK(block->_in_write);
+    DCHECK(block->_compression_buffer == NULL);
+    block->_compressed_len = 0;
+    if (!config::compress_spilled_blocks || _compression_codec == NULL) {
+        return;
+    }
+    uint8_t* buffer = get_compression_buffer();
+    // The output is limited to the input size, LZ4 gives up on data that doesn't shrink.
+    Slice compressed(buffer, block->_valid_data_len);
+    Status status;
+    // Compress outside the lock like pin_block() decompresses, the other threads of the
+    // query don't wait for it.
+    lock.unlock();
+    {
+        SCOPED_TIMER(_compression_timer);
+        status = _compression_codec->compress(Slice(block->buffer(), block->_valid_data_len),
+                                              &compressed);
+    }
+    lock.lock();
+    if (!status.ok() || compressed.size >= block->_valid_data_len) {
+        _free_compression_buffers.push_back(buffer);
+        return;
+    }
+    block->_compressed_len = compressed.size;
+    block->_compression_buffer = buffer;
+    _bytes_compressed_counter->update(block->_valid_data_len);
+}
+
+uint8_t* BufferedBlockMgr2::get_compression_buffer() {
+    // Assumes block manager lock is already taken.
+    if (!_free_compression_buffers.empty()) {
+        uint8_t* buffer = _free_compression_buffers.back();
+        _free_compression_buffers.pop_back();
+        return buffer;
+    }
+    // The buffers are needed to make progress, they aren't limited by mem_limit like the
+    // io buffers.
+    _mem_tracker->Consume(_max_block_size);
+    uint8_t* buffer = new uint8_t[_max_block_size];
+    _all_compression_buffers.push_back(buffer);
+    return buffer;
+}
+
 Status BufferedBlockMgr2::allocate_scratch_space(int64_t block_size, TmpFileMgr::File** tmp_file,
                                                  int64_t* file_offset) {
     // Assumes block manager lock is already taken.
@@ -835,7 +979,7 @@ Status BufferedBlockMgr2::allocate_scratch_space(int64_t block_size, TmpFileMgr:
 
 void BufferedBlockMgr2::write_complete(Block* block, const Status& write_status) {
     Status status = Status::OK();
-    lock_guard<mutex> lock(_lock);
+    unique_lock<mutex> lock(_lock);
     _outstanding_writes_counter->update(-1);
     DCHECK(validate()) << endl << debug_internal();
     DCHECK(_is_cancelled || block->_in_write) << "write_complete() for block not in write." << endl
@@ -845,6 +989,10 @@ void BufferedBlockMgr2::write_complete(Block* block, const Status& write_status)
         --_non_local_outstanding_writes;
     }
     block->_in_write = false;
+    if (block->_compression_buffer != NULL) {
+        _free_compression_buffers.push_back(block->_compression_buffer);
+        block->_compression_buffer = NULL;
+    }
 
     // Explicitly release our temporarily allocated buffer here so that it doesn't
     // hang around needlessly.
@@ -860,7 +1008,7 @@ void BufferedBlockMgr2::write_complete(Block* block, const Status& write_status)
         DCHECK(!block->_client_local)
                 << "Client should be waiting. No one should have pinned this block.";
         if (write_status.ok() && !_is_cancelled && !state->is_cancelled()) {
-            status = write_unpinned_blocks();
+            status = write_unpinned_blocks(lock);
         }
     } else if (block->_client_local) {
         DCHECK(!block->_is_deleted)
@@ -1073,7 +1221,7 @@ Status BufferedBlockMgr2::find_buffer_for_block(Block* block, bool* in_mem) {
     DCHECK(block->validate()) << endl << block->debug_string();
     // The number of free buffers has decreased. Write unpinned blocks if the number
     // of free buffers below the threshold is reached.
-    RETURN_IF_ERROR(write_unpinned_blocks());
+    RETURN_IF_ERROR(write_unpinned_blocks(l));
     DCHECK(validate()) << endl << debug_internal();
     return Status::OK();
 }
@@ -1116,9 +1264,12 @@ Status BufferedBlockMgr2::find_buffer(unique_lock<mutex>& lock, BufferDescriptor
             }
             SCOPED_TIMER(_buffer_wait_timer);
             // Try to evict unpinned blocks before waiting.
-            RETURN_IF_ERROR(write_unpinned_blocks());
+            RETURN_IF_ERROR(write_unpinned_blocks(lock));
             DCHECK_GT(_non_local_outstanding_writes, 0) << endl << debug_internal();
-            _buffer_available_cv.wait(lock);
+            // A write may have completed while the lock was released to compress a block.
+            if (_free_io_buffers.empty()) {
+                _buffer_available_cv.wait(lock);
+            }
             if (_is_cancelled) {
                 return Status::Cancelled("Cancelled");
             }
@@ -1283,6 +1434,8 @@ void BufferedBlockMgr2::init(DiskIoMgr* io_mgr, RuntimeProfile* parent_profile,
     _disk_read_timer = ADD_TIMER(_profile.get(), "TotalReadBlockTime");
     _buffer_wait_timer = ADD_TIMER(_profile.get(), "TotalBufferWaitTime");
     _encryption_timer = ADD_TIMER(_profile.get(), "TotalEncryptionTime");
+    _compression_timer = ADD_TIMER(_profile.get(), "TotalCompressionTime");
+    _bytes_compressed_counter = ADD_COUNTER(_profile.get(), "BytesCompressed", TUnit::BYTES);
     _integrity_check_timer = ADD_TIMER(_profile.get(), "TotalIntegrityCheckTime");
 
     // Create a new mem_tracker and allocate buffers.
@@ -1290,6 +1443,10 @@ void BufferedBlockMgr2::init(DiskIoMgr* io_mgr, RuntimeProfile* parent_profile,
     //             profile(), mem_limit, -1, "Block Manager", parent_tracker));
     _mem_tracker = MemTracker::CreateTracker(mem_limit, "Block Manager2", parent_tracker);
 
+    Status status = get_block_compression_codec(segment_v2::CompressionTypePB::LZ4,
+                                                &_compression_codec);
+    DCHECK(status.ok()) << status.get_error_msg();
+
     _initialized = true;
 }
 
@@ -28,6 +28,7 @@
 
 namespace doris {
 
+class BlockCompressionCodec;
 class RuntimeState;
 
 // The BufferedBlockMgr2 is used to allocate and manage blocks of data using a fixed memory
@@ -51,7 +52,9 @@ class RuntimeState;
 // itself. When the number of free buffers falls below 'block_write_threshold', unpinned
 // blocks are flushed in Last-In-First-Out order. (It is assumed that unpinned blocks are
 // re-read in FIFO order). The TmpFileMgr is used to obtain file handles to write to
-// within the tmp directories configured for Impala.
+// within the tmp directories configured for Impala. The blocks are round-robined across
+// the tmp devices and, if config::compress_spilled_blocks is set, compressed with LZ4 when
+// that makes them smaller.
 //
 // It is expected to have one BufferedBlockMgr2 per query. All allocations that can grow
 // proportional to the input size and that might need to spill to disk should allocate
@@ -253,6 +256,14 @@ public:
         // Length of valid (i.e. allocated) data within the block.
         int64_t _valid_data_len;
 
+        // Length of the block on disk if it was compressed the last time it was written,
+        // 0 if it was written as is.
+        int64_t _compressed_len;
+
+        // The compression buffer holding the data of a compressed write while it is in
+        // flight, NULL otherwise.
+        uint8_t* _compression_buffer;
+
         // Number of rows in this block.
         int _num_rows;
 
@@ -379,6 +390,13 @@ public:
         { return _max_block_size; }
     }
     int64_t bytes_allocated() const;
+
+    // Frees up to 'bytes' of the io buffers on the free list and of the unused compression
+    // buffers, e.g. when the process runs out of memory. A persisted block whose buffer is
+    // freed is read back from disk when it's pinned. Returns the number of bytes freed.
+    // Doesn't wait for _lock and frees nothing if it is taken, it may be called by the GC
+    // of the mem trackers in a thread that holds it.
+    int64_t release_free_buffers(int64_t bytes);
     RuntimeProfile* profile() {
         { return _profile.get(); }
     }
@@ -461,11 +479,23 @@ private:
     // Writes unpinned blocks via DiskIoMgr until one of the following is true:
     //   1. The number of outstanding writes >= (_block_write_threshold - num free buffers)
     //   2. There are no more unpinned blocks
-    // Must be called with the _lock already taken. Is not blocking.
-    Status write_unpinned_blocks();
+    // Must be called with the _lock already taken. Is not blocking, but releases the
+    // lock while the blocks are compressed.
+    Status write_unpinned_blocks(boost::unique_lock<boost::mutex>& lock);
+
+    // Issues the write for this block to the DiskIoMgr. Must be called with the _lock
+    // already taken, see compress_block().
+    Status write_unpinned_block(boost::unique_lock<boost::mutex>& lock, Block* block);
+
+    // Compresses the data of 'block' into a compression buffer and sets the block's
+    // _compressed_len and _compression_buffer if that makes it smaller. Otherwise the
+    // block is written as is. Must be called with the _lock already taken and the block
+    // in write, the lock is released while compressing.
+    void compress_block(boost::unique_lock<boost::mutex>& lock, Block* block);
 
-    // Issues the write for this block to the DiskIoMgr.
-    Status write_unpinned_block(Block* block);
+    // Returns an unused compression buffer of _max_block_size bytes, allocating it if
+    // there is none. Must be called with the _lock already taken.
+    uint8_t* get_compression_buffer();
 
     // Allocate block_size bytes in a temporary file. Try multiple disks if error occurs.
     // Returns an error only if no temporary files are usable.
@@ -561,6 +591,15 @@ private:
     // All allocated io-sized buffers.
     std::list<BufferDescriptor*> _all_io_buffers;
 
+    // Codec of the spilled blocks, see compress_block().
+    const BlockCompressionCodec* _compression_codec;
+
+    // All allocated compression buffers and the unused ones. They are used for the
+    // compressed data of the blocks being written or read, so there are about as many as
+    // concurrent writes and reads. They count against _mem_tracker.
+    std::vector<uint8_t*> _all_compression_buffers;
+    std::vector<uint8_t*> _free_compression_buffers;
+
     // Temporary physical file handle, (one per tmp device) to which blocks may be written.
     // Blocks are round-robined across these files.
     boost::ptr_vector<TmpFileMgr::File> _tmp_files;
@@ -609,6 +648,12 @@ private:
     // Time spent in disk spill encryption and decryption.
     RuntimeProfile::Counter* _encryption_timer;
 
+    // Time spent in compressing and decompressing spilled blocks.
+    RuntimeProfile::Counter* _compression_timer;
+
+    // Number of bytes of the blocks that were written compressed, before compression.
+    RuntimeProfile::Counter* _bytes_compressed_counter;
+
     // Time spent in disk spill integrity generation and checking.
     RuntimeProfile::Counter* _integrity_check_timer;
 
@@ -24,6 +24,7 @@
 #include "gutil/strings/substitute.h"
 #include "util/bit_util.h"
 #include "util/error_util.h"
+#include "util/huge_page_util.h"
 
 // TODO: IMPALA-5073: this should eventually become the default once we are confident
 // that it is superior to allocating via TCMalloc.
@@ -37,10 +38,8 @@
 
 namespace doris {
 
-/// These are the page sizes on x86-64. We could parse /proc/meminfo to programmatically
-/// get this, but it is unlikely to change unless we port to a different architecture.
+/// The small page size on x86-64, see HugePageUtil::HUGE_PAGE_SIZE.
 static int64_t SMALL_PAGE_SIZE = 4LL * 1024;
-static int64_t HUGE_PAGE_SIZE = 2LL * 1024 * 1024;
 
 SystemAllocator::SystemAllocator(int64_t min_buffer_len) : min_buffer_len_(min_buffer_len) {
     DCHECK(BitUtil::IsPowerOf2(min_buffer_len));
@@ -69,53 +68,27 @@ Status SystemAllocator::Allocate(int64_t len, BufferPool::BufferHandle* buffer)
 }
 
 Status SystemAllocator::AllocateViaMMap(int64_t len, uint8_t** buffer_mem) {
-    int64_t map_len = len;
-    bool use_huge_pages = len % HUGE_PAGE_SIZE == 0 && config::madvise_huge_pages;
-    if (use_huge_pages) {
-        // Map an extra huge page so we can fix up the alignment if needed.
-        map_len += HUGE_PAGE_SIZE;
+    if (HugePageUtil::use_huge_pages(len)) {
+        *buffer_mem = HugePageUtil::map(len);
+        if (*buffer_mem == nullptr) {
+            return Status::BufferAllocFailed("mmap failed");
+        }
+        return Status::OK();
     }
     uint8_t* mem = reinterpret_cast<uint8_t*>(
-            mmap(nullptr, map_len, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0));
+            mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0));
     if (mem == MAP_FAILED) {
         return Status::BufferAllocFailed("mmap failed");
     }
-
-    if (use_huge_pages) {
-        // mmap() may return memory that is not aligned to the huge page size. For the
-        // subsequent madvise() call to work well, we need to align it ourselves and
-        // unmap the memory on either side of the buffer that we don't need.
-        uintptr_t misalignment = reinterpret_cast<uintptr_t>(mem) % HUGE_PAGE_SIZE;
-        if (misalignment != 0) {
-            uintptr_t fixup = HUGE_PAGE_SIZE - misalignment;
-            munmap(mem, fixup);
-            mem += fixup;
-            map_len -= fixup;
-        }
-        munmap(mem + len, map_len - len);
-        DCHECK_EQ(reinterpret_cast<uintptr_t>(mem) % HUGE_PAGE_SIZE, 0) << mem;
-        // Mark the buffer as a candidate for promotion to huge pages. The Linux Transparent
-        // Huge Pages implementation will try to back the memory with a huge page if it is
-        // enabled. MADV_HUGEPAGE was introduced in 2.6.38, so we similarly need to skip this
-        // code if we are compiling against an older kernel.
-#ifdef MADV_HUGEPAGE
-        int rc;
-        // According to madvise() docs it may return EAGAIN to signal that we should retry.
-        do {
-            rc = madvise(mem, len, MADV_HUGEPAGE);
-        } while (rc == -1 && errno == EAGAIN);
-        DCHECK(rc == 0) << "madvise(MADV_HUGEPAGE) shouldn't fail" << errno;
-#endif
-    }
     *buffer_mem = mem;
     return Status::OK();
 }
 
 Status SystemAllocator::AllocateViaMalloc(int64_t len, uint8_t** buffer_mem) {
-    bool use_huge_pages = len % HUGE_PAGE_SIZE == 0 && config::madvise_huge_pages;
+    bool use_huge_pages = HugePageUtil::use_huge_pages(len);
     // Allocate, aligned to the page size that we expect to back the memory range.
     // This ensures that it can be backed by a whole pages, rather than parts of pages.
-    size_t alignment = use_huge_pages ? HUGE_PAGE_SIZE : SMALL_PAGE_SIZE;
+    size_t alignment = use_huge_pages ? HugePageUtil::HUGE_PAGE_SIZE : SMALL_PAGE_SIZE;
     int rc = posix_memalign(reinterpret_cast<void**>(buffer_mem), alignment, len);
 #if !defined(ADDRESS_SANITIZER) && !defined(LEAK_SANITIZER)
     // Workaround ASAN bug where posix_memalign returns 0 even when allocation fails.
@@ -128,13 +101,7 @@ Status SystemAllocator::AllocateViaMalloc(int64_t len, uint8_t** buffer_mem) {
         return Status::InternalError(ss.str());
     }
     if (use_huge_pages) {
-#ifdef MADV_HUGEPAGE
-        // According to madvise() docs it may return EAGAIN to signal that we should retry.
-        do {
-            rc = madvise(*buffer_mem, len, MADV_HUGEPAGE);
-        } while (rc == -1 && errno == EAGAIN);
-        DCHECK(rc == 0) << "madvise(MADV_HUGEPAGE) shouldn't fail" << errno;
-#endif
+        HugePageUtil::advise(*buffer_mem, len, true);
     }
     return Status::OK();
 }
@@ -144,22 +111,14 @@ void SystemAllocator::Free(BufferPool::BufferHandle&& buffer) {
         int rc = munmap(buffer.data(), buffer.len());
         DCHECK_EQ(rc, 0) << "Unexpected munmap() error: " << errno;
     } else {
-        bool use_huge_pages = buffer.len() % HUGE_PAGE_SIZE == 0 && config::madvise_huge_pages;
-        if (use_huge_pages) {
+        if (HugePageUtil::use_huge_pages(buffer.len())) {
             // Undo the madvise so that is isn't a candidate to be newly backed by huge pages.
             // We depend on TCMalloc's "aggressive decommit" mode decommitting the physical
             // huge pages with madvise(DONTNEED) when we call free(). Otherwise, this huge
             // page region may be divvied up and subsequently decommitted in smaller chunks,
             // which may not actually release the physical memory, causing Impala physical
             // memory usage to exceed the process limit.
-#ifdef MADV_NOHUGEPAGE
-            // According to madvise() docs it may return EAGAIN to signal that we should retry.
-            int rc;
-            do {
-                rc = madvise(buffer.data(), buffer.len(), MADV_NOHUGEPAGE);
-            } while (rc == -1 && errno == EAGAIN);
-            DCHECK(rc == 0) << "madvise(MADV_NOHUGEPAGE) shouldn't fail" << errno;
-#endif
+            HugePageUtil::advise(buffer.data(), buffer.len(), false);
         }
         free(buffer.data());
     }
@@ -71,11 +71,16 @@ void ResultNodeList::clear() {
     }
     _node_count = 0;
 }
+ResultCacheShard::~ResultCacheShard() {
+    _node_list.clear();
+    _mem_tracker->Release(_tracked_size);
+}
+
 /**
  * Find the node and update partition data
  * New node, the node updated in the first partition will move to the tail of the list
  */
-void ResultCache::update(const PUpdateCacheRequest* request, PCacheResponse* response) {
+void ResultCacheShard::update(const PUpdateCacheRequest* request, PCacheResponse* response) {
     ResultNode* node;
     PCacheStatus status;
     bool update_first = false;
@@ -104,13 +109,13 @@ void ResultCache::update(const PUpdateCacheRequest* request, PCacheResponse* res
     response->set_status(status);
 
     prune();
-    update_monitor();
+    update_mem_tracker();
 }
 
 /**
  * Fetch cache through sql key, partition key, version and time
  */
-void ResultCache::fetch(const PFetchCacheRequest* request, PFetchCacheResult* result) {
+void ResultCacheShard::fetch(const PFetchCacheRequest* request, PFetchCacheResult* result) {
     bool hit_first = false;
     ResultNodeMap::iterator node_it;
     const UniqueId sql_key = request->sql_key();
@@ -145,11 +150,15 @@ void ResultCache::fetch(const PFetchCacheRequest* request, PFetchCacheResult* re
 
     if (hit_first) {
         CacheWriteLock write_lock(_cache_mtx);
-        _node_list.move_tail(node_it->second);
+        // the node may be pruned after the read lock is released
+        node_it = _node_map.find(sql_key);
+        if (node_it != _node_map.end()) {
+            _node_list.move_tail(node_it->second);
+        }
     }
 }
 
-bool ResultCache::contains(const UniqueId& sql_key) {
+bool ResultCacheShard::contains(const UniqueId& sql_key) {
     CacheReadLock read_lock(_cache_mtx);
     return _node_map.find(sql_key) != _node_map.end();
 }
@@ -162,10 +171,10 @@ bool ResultCache::contains(const UniqueId& sql_key) {
  *   CLEAR_SQL_KEY = 3
  * };
  */
-void ResultCache::clear(const PClearCacheRequest* request, PCacheResponse* response) {
+void ResultCacheShard::clear(const PClearCacheRequest* request) {
+    CacheWriteLock write_lock(_cache_mtx);
     LOG(INFO) << "clear cache type" << request->clear_type()
               << ", node size:" << _node_list.get_node_count() << ", map size:" << _node_map.size();
-    CacheWriteLock write_lock(_cache_mtx);
     //0 clear, 1 prune, 2 before_time,3 sql_key
     switch (request->clear_type()) {
     case PClearType::CLEAR_ALL:
@@ -181,8 +190,7 @@ void ResultCache::clear(const PClearCacheRequest* request, PCacheResponse* respo
     default:
         break;
     }
-    update_monitor();
-    response->set_status(PCacheStatus::CACHE_OK);
+    update_mem_tracker();
 }
 
 //private method
@@ -217,7 +225,7 @@ ResultNode* find_min_time_node(ResultNode* result_node) {
 *   4,3,6,8
 *   5,7,9,11,13 //_tail
 */
-void ResultCache::prune() {
+void ResultCacheShard::prune() {
     if (_cache_size <= (_max_size + _elasticity_size)) {
         return;
     }
@@ -253,7 +261,7 @@ void ResultCache::prune() {
     }
 }
 
-void ResultCache::remove(ResultNode* result_node) {
+void ResultCacheShard::remove(ResultNode* result_node) {
     auto node_it = _node_map.find(result_node->get_sql_key());
     if (node_it != _node_map.end()) {
         _node_map.erase(node_it);
@@ -262,10 +270,62 @@ void ResultCache::remove(ResultNode* result_node) {
     }
 }
 
+void ResultCacheShard::update_mem_tracker() {
+    size_t cache_size = _cache_size;
+    _mem_tracker->Consume(static_cast<int64_t>(cache_size) - static_cast<int64_t>(_tracked_size));
+    _tracked_size = cache_size;
+}
+
+ResultCache::ResultCache(int32 max_size, int32 elasticity_size)
+        : _mem_tracker(MemTracker::CreateTracker(-1, "ResultCache")) {
+    int num_shards = std::max(config::query_cache_shard_num, 1);
+    size_t shard_max_size = static_cast<size_t>(max_size) * 1024 * 1024 / num_shards;
+    size_t shard_elasticity_size = static_cast<size_t>(elasticity_size) * 1024 * 1024 / num_shards;
+    for (int i = 0; i < num_shards; ++i) {
+        _shards.emplace_back(
+                new ResultCacheShard(shard_max_size, shard_elasticity_size, _mem_tracker.get()));
+    }
+}
+
+void ResultCache::update(const PUpdateCacheRequest* request, PCacheResponse* response) {
+    get_shard(request->sql_key())->update(request, response);
+    update_monitor();
+}
+
+void ResultCache::fetch(const PFetchCacheRequest* request, PFetchCacheResult* result) {
+    get_shard(request->sql_key())->fetch(request, result);
+}
+
+bool ResultCache::contains(const UniqueId& sql_key) {
+    return get_shard(sql_key)->contains(sql_key);
+}
+
+void ResultCache::clear(const PClearCacheRequest* request, PCacheResponse* response) {
+    for (auto& shard : _shards) {
+        shard->clear(request);
+    }
+    update_monitor();
+    response->set_status(PCacheStatus::CACHE_OK);
+}
+
+size_t ResultCache::get_cache_size() {
+    size_t cache_size = 0;
+    for (auto& shard : _shards) {
+        cache_size += shard->get_cache_size();
+    }
+    return cache_size;
+}
+
 void ResultCache::update_monitor() {
-    DorisMetrics::instance()->query_cache_memory_total_byte->set_value(_cache_size);
-    DorisMetrics::instance()->query_cache_sql_total_count->set_value(_node_count);
-    DorisMetrics::instance()->query_cache_partition_total_count->set_value(_partition_count);
+    size_t node_count = 0;
+    size_t partition_count = 0;
+    for (auto& shard : _shards) {
+        node_count += shard->get_node_count();
+        partition_count += shard->get_partition_count();
+    }
+    DorisMetrics::instance()->query_cache_memory_total_byte->set_value(get_cache_size());
+    DorisMetrics::instance()->query_cache_sql_total_count->set_value(node_count);
+    DorisMetrics::instance()->query_cache_partition_total_count->set_value(partition_count);
 }
 
 } // namespace doris
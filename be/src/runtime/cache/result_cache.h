@@ -18,6 +18,7 @@
 #ifndef DORIS_BE_SRC_RUNTIME_RESULT_CACHE_H
 #define DORIS_BE_SRC_RUNTIME_RESULT_CACHE_H
 
+#include <atomic>
 #include <boost/thread.hpp>
 #include <cassert>
 #include <cstdio>
@@ -26,9 +27,11 @@
 #include <iostream>
 #include <list>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <shared_mutex>
 #include <thread>
+#include <vector>
 
 #include "common/config.h"
 #include "runtime/cache/cache_utils.h"
@@ -72,33 +75,38 @@ private:
 };
 
 /**
- * Cache results of query, including the entire result set or the result set of divided partitions.
+ * A shard of the ResultCache, it caches the results of the sql keys hashed to it,
+ * including the entire result set or the result set of divided partitions.
  * Two data structures, one is unordered_map and the other is a doubly linked list, corresponding to a result node.
  * If the cache is hit, the node will be moved to the end of the linked list.
  * If the cache is cleared, nodes that are expired or have not been accessed for a long time will be cleared.
  */
-class ResultCache {
+class ResultCacheShard {
 public:
-    ResultCache(int32 max_size, int32 elasticity_size) {
-        _max_size = max_size * 1024 * 1024;
-        _elasticity_size = elasticity_size * 1024 * 1024;
-        _cache_size = 0;
-        _node_count = 0;
-        _partition_count = 0;
-    }
-
-    virtual ~ResultCache() {}
+    ResultCacheShard(size_t max_size, size_t elasticity_size, MemTracker* mem_tracker)
+            : _cache_size(0),
+              _max_size(max_size),
+              _elasticity_size(elasticity_size),
+              _node_count(0),
+              _partition_count(0),
+              _mem_tracker(mem_tracker),
+              _tracked_size(0) {}
+
+    virtual ~ResultCacheShard();
     void update(const PUpdateCacheRequest* request, PCacheResponse* response);
     void fetch(const PFetchCacheRequest* request, PFetchCacheResult* result);
     bool contains(const UniqueId& sql_key);
-    void clear(const PClearCacheRequest* request, PCacheResponse* response);
+    void clear(const PClearCacheRequest* request);
 
-    size_t get_cache_size() { return _cache_size; }
+    size_t get_cache_size() const { return _cache_size; }
+    size_t get_node_count() const { return _node_count; }
+    size_t get_partition_count() const { return _partition_count; }
 
 private:
     void prune();
     void remove(ResultNode* result_node);
-    void update_monitor();
+    // consume or release the change of _cache_size on _mem_tracker
+    void update_mem_tracker();
 
     //At the same time, multithreaded reading
     //Single thread updating and cleaning(only single be, Fe is not affected)
@@ -106,11 +114,48 @@ private:
     ResultNodeMap _node_map;
     //List of result nodes corresponding to SqlKey,last recently used at the tail
     ResultNodeList _node_list;
-    size_t _cache_size;
+    // read by ResultCache without _cache_mtx
+    std::atomic<size_t> _cache_size;
     size_t _max_size;
     double _elasticity_size;
-    size_t _node_count;
-    size_t _partition_count;
+    std::atomic<size_t> _node_count;
+    std::atomic<size_t> _partition_count;
+    MemTracker* _mem_tracker;
+    // the part of _cache_size consumed on _mem_tracker
+    size_t _tracked_size;
+
+private:
+    ResultCacheShard();
+    ResultCacheShard(const ResultCacheShard&);
+    const ResultCacheShard& operator=(const ResultCacheShard&);
+};
+
+/**
+ * Cache results of query. The sql keys are spread over query_cache_shard_num shards by hash,
+ * each with its own lock and LRU list, so requests on different sql keys don't wait for each
+ * other. The cache size limits are divided evenly among the shards, the cached data is
+ * tracked by a MemTracker.
+ */
+class ResultCache {
+public:
+    ResultCache(int32 max_size, int32 elasticity_size);
+
+    virtual ~ResultCache() {}
+    void update(const PUpdateCacheRequest* request, PCacheResponse* response);
+    void fetch(const PFetchCacheRequest* request, PFetchCacheResult* result);
+    bool contains(const UniqueId& sql_key);
+    void clear(const PClearCacheRequest* request, PCacheResponse* response);
+
+    size_t get_cache_size();
+
+private:
+    ResultCacheShard* get_shard(const UniqueId& sql_key) {
+        return _shards[sql_key.hash() % _shards.size()].get();
+    }
+    void update_monitor();
+
+    std::shared_ptr<MemTracker> _mem_tracker;
+    std::vector<std::unique_ptr<ResultCacheShard>> _shards;
 
 private:
     ResultCache();
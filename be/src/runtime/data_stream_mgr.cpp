@@ -26,6 +26,7 @@
 #include "gen_cpp/PaloInternalService_types.h"
 #include "gen_cpp/types.pb.h" // PUniqueId
 #include "runtime/data_stream_recvr.h"
+#include "runtime/exec_env.h"
 #include "runtime/raw_value.h"
 #include "runtime/row_batch.h"
 #include "runtime/runtime_state.h"
@@ -69,13 +70,17 @@ inline uint32_t DataStreamMgr::get_hash_value(const TUniqueId& fragment_instance
 shared_ptr<DataStreamRecvr> DataStreamMgr::create_recvr(
         RuntimeState* state, const RowDescriptor& row_desc, const TUniqueId& fragment_instance_id,
         PlanNodeId dest_node_id, int num_senders, int buffer_size, RuntimeProfile* profile,
-        bool is_merging, std::shared_ptr<QueryStatisticsRecvr> sub_plan_query_statistics_recvr) {
+        bool is_merging, std::shared_ptr<QueryStatisticsRecvr> sub_plan_query_statistics_recvr,
+        bool can_spill) {
     DCHECK(profile != NULL);
     VLOG_FILE << "creating receiver for fragment=" << fragment_instance_id
               << ", node=" << dest_node_id;
     shared_ptr<DataStreamRecvr> recvr(new DataStreamRecvr(
             this, state->instance_mem_tracker(), row_desc, fragment_instance_id, dest_node_id,
             num_senders, is_merging, buffer_size, profile, sub_plan_query_statistics_recvr));
+    if (can_spill) {
+        recvr->enable_spill(state->exec_env()->tmp_file_mgr(), state->query_id());
+    }
     uint32_t hash_value = get_hash_value(fragment_instance_id, dest_node_id);
     lock_guard<mutex> l(_lock);
     _fragment_stream_set.insert(std::make_pair(fragment_instance_id, dest_node_id));
@@ -110,6 +115,7 @@ shared_ptr<DataStreamRecvr> DataStreamMgr::find_recvr(const TUniqueId& fragment_
 }
 
 Status DataStreamMgr::transmit_data(const PTransmitDataParams* request,
+                                    const butil::IOBuf* attachment,
                                     ::google::protobuf::Closure** done) {
     const PUniqueId& finst_id = request->finst_id();
     TUniqueId t_finst_id;
@@ -124,7 +130,9 @@ Status DataStreamMgr::transmit_data(const PTransmitDataParams* request,
         // in acquiring _lock.
         // TODO: Rethink the lifecycle of DataStreamRecvr to distinguish
         // errors from receiver-initiated teardowns.
-        return Status::OK();
+        // Receivers are registered before their senders start, so the receiver is gone
+        // and the sender can stop.
+        return Status::EndOfFile("data stream receiver closed");
     }
 
     // request can only be used before calling recvr's add_batch or when request
@@ -135,9 +143,16 @@ Status DataStreamMgr::transmit_data(const PTransmitDataParams* request,
     }
 
     bool eos = request->eos();
+    if (recvr->is_finished()) {
+        // the receiver needs no more rows, e.g. its exchange node reached the limit
+        if (eos) {
+            recvr->remove_sender(request->sender_id(), request->be_number());
+        }
+        return Status::EndOfFile("data stream receiver finished");
+    }
     if (request->has_row_batch()) {
-        recvr->add_batch(request->row_batch(), request->sender_id(), request->be_number(),
-                         request->packet_seq(), eos ? nullptr : done);
+        recvr->add_batch(request->row_batch(), attachment, request->sender_id(),
+                         request->be_number(), request->packet_seq(), eos ? nullptr : done);
     }
 
     if (eos) {
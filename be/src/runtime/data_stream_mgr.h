@@ -41,6 +41,10 @@ class Closure;
 }
 } // namespace google
 
+namespace butil {
+class IOBuf;
+}
+
 namespace doris {
 
 class DescriptorTbl;
@@ -75,17 +79,31 @@ public:
     // single stream.
     // Ownership of the receiver is shared between this DataStream mgr instance and the
     // caller.
+    // If can_spill is true, the receiver spills the batches once its buffer is full instead
+    // of blocking the senders, see DataStreamRecvr::enable_spill().
     boost::shared_ptr<DataStreamRecvr> create_recvr(
             RuntimeState* state, const RowDescriptor& row_desc,
             const TUniqueId& fragment_instance_id, PlanNodeId dest_node_id, int num_senders,
             int buffer_size, RuntimeProfile* profile, bool is_merging,
-            std::shared_ptr<QueryStatisticsRecvr> sub_plan_query_statistics_recvr);
+            std::shared_ptr<QueryStatisticsRecvr> sub_plan_query_statistics_recvr,
+            bool can_spill = false);
 
-    Status transmit_data(const PTransmitDataParams* request, ::google::protobuf::Closure** done);
+    // 'attachment' is the brpc attachment of the request, it carries the tuple data of the
+    // row batch if row_batch.tuple_data_in_attachment is true.
+    // Returns END_OF_FILE if the receiver is closed or finished, telling the sender to
+    // stop sending.
+    Status transmit_data(const PTransmitDataParams* request, const butil::IOBuf* attachment,
+                         ::google::protobuf::Closure** done);
 
     // Closes all receivers registered for fragment_instance_id immediately.
     void cancel(const TUniqueId& fragment_instance_id);
 
+    // Return the receiver for given fragment_instance_id/node_id,
+    // or NULL if not found. If 'acquire_lock' is false, assumes _lock is already being
+    // held and won't try to acquire it.
+    boost::shared_ptr<DataStreamRecvr> find_recvr(const TUniqueId& fragment_instance_id,
+                                                  PlanNodeId node_id, bool acquire_lock = true);
+
 private:
     friend class DataStreamRecvr;
 
@@ -121,12 +139,6 @@ private:
     typedef std::set<std::pair<TUniqueId, PlanNodeId>, ComparisonOp> FragmentStreamSet;
     FragmentStreamSet _fragment_stream_set;
 
-    // Return the receiver for given fragment_instance_id/node_id,
-    // or NULL if not found. If 'acquire_lock' is false, assumes _lock is already being
-    // held and won't try to acquire it.
-    boost::shared_ptr<DataStreamRecvr> find_recvr(const TUniqueId& fragment_instance_id,
-                                                  PlanNodeId node_id, bool acquire_lock = true);
-
     // Remove receiver block for fragment_instance_id/node_id from the map.
     Status deregister_recvr(const TUniqueId& fragment_instance_id, PlanNodeId node_id);
 
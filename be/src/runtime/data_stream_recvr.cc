@@ -17,19 +17,29 @@
 
 #include "runtime/data_stream_recvr.h"
 
+#include "service/brpc.h"
+
+#include <fcntl.h>
 #include <google/protobuf/stubs/common.h>
+#include <unistd.h>
 
 #include <boost/thread/locks.hpp>
 #include <boost/thread/mutex.hpp>
 #include <deque>
+#include <mutex>
 #include <unordered_map>
 #include <unordered_set>
 
+#include "common/config.h"
 #include "gen_cpp/data.pb.h"
+#include "gutil/strings/substitute.h"
 #include "runtime/data_stream_mgr.h"
 #include "runtime/row_batch.h"
 #include "runtime/sorted_run_merger.h"
+#include "runtime/tmp_file_mgr.h"
+#include "util/coding.h"
 #include "util/debug_util.h"
+#include "util/doris_metrics.h"
 #include "util/logging.h"
 #include "util/runtime_profile.h"
 
@@ -38,17 +48,125 @@ using std::vector;
 using std::pair;
 using std::make_pair;
 
-using boost::condition_variable;
-using boost::mutex;
 using boost::scoped_ptr;
-using boost::unique_lock;
 using boost::try_lock;
 using boost::try_mutex;
-using boost::lock_guard;
 using boost::mem_fn;
 
 namespace doris {
 
+// The temporary file the batches of a receiver are spilled to. A batch is appended in its
+// serialized form, i.e. the length of the PRowBatch, the PRowBatch and its attachment, and read
+// back by its offset. The file is removed when the receiver is destroyed.
+class DataStreamRecvr::SpillFile {
+public:
+    SpillFile(TmpFileMgr* tmp_file_mgr, const TUniqueId& query_id)
+            : _tmp_file_mgr(tmp_file_mgr), _query_id(query_id) {}
+
+    ~SpillFile() {
+        if (_fd >= 0) {
+            close(_fd);
+        }
+        if (_file != nullptr) {
+            _file->remove();
+        }
+    }
+
+    // Whether 'bytes' more are allowed by config::data_stream_receiver_spill_max_bytes
+    bool has_space(int64_t bytes) {
+        return _num_bytes.load() + bytes <= config::data_stream_receiver_spill_max_bytes;
+    }
+
+    Status write(const PRowBatch& pb_batch, const butil::IOBuf* attachment, int64_t* offset,
+                 int64_t* len);
+
+    Status read(int64_t offset, int64_t len, PRowBatch* pb_batch, butil::IOBuf* attachment);
+
+private:
+    Status _open();
+
+    TmpFileMgr* _tmp_file_mgr;
+    TUniqueId _query_id;
+
+    // protects the allocation of the file and its space, writes to the allocated ranges and
+    // reads need no lock
+    std::mutex _lock;
+    std::unique_ptr<TmpFileMgr::File> _file;
+    int _fd = -1;
+    std::atomic<int64_t> _num_bytes {0};
+};
+
+Status DataStreamRecvr::SpillFile::_open() {
+    std::vector<TmpFileMgr::DeviceId> devices = _tmp_file_mgr->active_tmp_devices();
+    if (devices.empty()) {
+        return Status::InternalError("no tmp dir to spill the batches of data stream");
+    }
+    TmpFileMgr::File* file = nullptr;
+    RETURN_IF_ERROR(_tmp_file_mgr->get_file(devices[rand() % devices.size()], _query_id, &file));
+    _file.reset(file);
+    return Status::OK();
+}
+
+Status DataStreamRecvr::SpillFile::write(const PRowBatch& pb_batch,
+                                         const butil::IOBuf* attachment, int64_t* offset,
+                                         int64_t* len) {
+    size_t pb_len = pb_batch.ByteSizeLong();
+    size_t attachment_len = pb_batch.tuple_data_in_attachment() ? attachment->size() : 0;
+    std::string data;
+    data.resize(sizeof(uint32_t) + pb_len + attachment_len);
+    encode_fixed32_le((uint8_t*)&data[0], pb_len);
+    if (!pb_batch.SerializeToArray(&data[sizeof(uint32_t)], pb_len)) {
+        return Status::InternalError("failed to serialize row batch to spill");
+    }
+    if (attachment_len > 0) {
+        attachment->copy_to(&data[sizeof(uint32_t) + pb_len], attachment_len);
+    }
+
+    {
+        std::lock_guard<std::mutex> l(_lock);
+        if (_file == nullptr) {
+            RETURN_IF_ERROR(_open());
+        }
+        RETURN_IF_ERROR(_file->allocate_space(data.size(), offset));
+        if (_fd < 0) {
+            // the file is created by the first allocation
+            _fd = open(_file->path().c_str(), O_RDWR);
+            if (_fd < 0) {
+                return Status::InternalError("failed to open spill file " + _file->path());
+            }
+        }
+    }
+    if (pwrite(_fd, data.data(), data.size(), *offset) != (ssize_t)data.size()) {
+        char buf[64];
+        return Status::InternalError(strings::Substitute(
+                "failed to write spill file $0: $1", _file->path(),
+                strerror_r(errno, buf, sizeof(buf))));
+    }
+    *len = data.size();
+    _num_bytes += data.size();
+    return Status::OK();
+}
+
+Status DataStreamRecvr::SpillFile::read(int64_t offset, int64_t len, PRowBatch* pb_batch,
+                                        butil::IOBuf* attachment) {
+    std::string data;
+    data.resize(len);
+    if (pread(_fd, &data[0], len, offset) != len) {
+        char buf[64];
+        return Status::InternalError(strings::Substitute(
+                "failed to read spill file $0: $1", _file->path(),
+                strerror_r(errno, buf, sizeof(buf))));
+    }
+    uint32_t pb_len = decode_fixed32_le((const uint8_t*)data.data());
+    if (sizeof(uint32_t) + pb_len > (size_t)len ||
+        !pb_batch->ParseFromArray(data.data() + sizeof(uint32_t), pb_len)) {
+        return Status::Corruption("invalid row batch in spill file " + _file->path());
+    }
+    size_t attachment_offset = sizeof(uint32_t) + pb_len;
+    attachment->append(data.data() + attachment_offset, len - attachment_offset);
+    return Status::OK();
+}
+
 // Implements a blocking queue of row batches from one or more senders. One queue
 // is maintained per sender if _is_merging is true for the enclosing receiver, otherwise
 // rows from all senders are placed in the same queue.
@@ -70,8 +188,12 @@ public:
     // blocks if this will make the stream exceed its buffer limit.
     // If the total size of the batches in this queue would exceed the allowed buffer size,
     // the queue is considered full and the call blocks until a batch is dequeued.
-    void add_batch(const PRowBatch& pb_batch, int be_number, int64_t packet_seq,
-                   ::google::protobuf::Closure** done);
+    void add_batch(const PRowBatch& pb_batch, const butil::IOBuf* attachment, int be_number,
+                   int64_t packet_seq, ::google::protobuf::Closure** done);
+
+    // Adds the rows of a batch from a local sender, see DataStreamRecvr::add_batch().
+    // There is no ack to withhold, so the call blocks while the buffer is full.
+    void add_batch(RowBatch* batch, bool use_move);
 
     // Decrement the number of remaining senders for this queue and signal eos ("new data")
     // if the count drops to 0. The number of senders will be 1 for a merging
@@ -94,8 +216,9 @@ private:
     // Receiver of which this queue is a member.
     DataStreamRecvr* _recvr;
 
-    // protects all subsequent data.
-    mutex _lock;
+    // protects all subsequent data. The waits on it suspend the bthread, not the worker,
+    // if the fragment runs in a bthread, see config::fragment_exec_in_bthread.
+    bthread::Mutex _lock;
 
     // if true, the receiver fragment for this stream got cancelled
     bool _is_cancelled;
@@ -105,16 +228,43 @@ private:
     int _num_remaining_senders;
 
     // signal arrival of new batch or the eos/cancelled condition
-    condition_variable _data_arrival_cv;
+    bthread::ConditionVariable _data_arrival_cv;
 
     // signal removal of data by stream consumer
-    condition_variable _data_removal_cv;
-
-    // queue of (batch length, batch) pairs.  The SenderQueue block owns memory to
+    bthread::ConditionVariable _data_removal_cv;
+
+    // A batch in memory, or spilled if 'batch' is nullptr
+    struct QueuedBatch {
+        // bytes of the batch in memory
+        int size = 0;
+        RowBatch* batch = nullptr;
+        // range of the batch in the spill file
+        int64_t spill_offset = 0;
+        int64_t spill_len = 0;
+        // the batch is being written to the spill file, it can't be dequeued yet
+        bool spilling = false;
+    };
+
+    typedef list<QueuedBatch> RowBatchQueue;
+
+    // Spill the batch instead of queueing it in memory. Return false if it's not spilled,
+    // e.g. the spill file is full. The batch takes its place in the queue at once, but is
+    // written with 'l' released, so the rpc thread doesn't block the queue on the disk. If
+    // the write fails, the batch is kept in memory in its place and 'done' is withheld.
+    bool _spill_batch(std::unique_lock<bthread::Mutex>& l, const PRowBatch& pb_batch,
+                      const butil::IOBuf* attachment, int batch_size,
+                      ::google::protobuf::Closure** done);
+
+    // Read back the spilled batch
+    Status _read_spilled_batch(const QueuedBatch& queued, RowBatch** batch);
+
+    // queue of the batches, in memory or spilled. The SenderQueue block owns memory to
     // these batches. They are handed off to the caller via get_batch.
-    typedef list<pair<int, RowBatch*>> RowBatchQueue;
     RowBatchQueue _batch_queue;
 
+    // number of the batches in _batch_queue being written to the spill file
+    int _num_spilling = 0;
+
     // The batch that was most recently returned via get_batch(), i.e. the current batch
     // from this queue being processed by a consumer. Is destroyed when the next batch
     // is retrieved.
@@ -137,9 +287,10 @@ DataStreamRecvr::SenderQueue::SenderQueue(DataStreamRecvr* parent_recvr, int num
           _received_first_batch(false) {}
 
 Status DataStreamRecvr::SenderQueue::get_batch(RowBatch** next_batch) {
-    unique_lock<mutex> l(_lock);
+    std::unique_lock<bthread::Mutex> l(_lock);
     // wait until something shows up or we know we're done
-    while (!_is_cancelled && _batch_queue.empty() && _num_remaining_senders > 0) {
+    while (!_is_cancelled && (_batch_queue.empty() ? _num_remaining_senders > 0
+                                                   : _batch_queue.front().spilling)) {
         VLOG_ROW << "wait arrival fragment_instance_id=" << _recvr->fragment_instance_id()
                  << " node=" << _recvr->dest_node_id();
         // Don't count time spent waiting on the sender as active time.
@@ -165,11 +316,14 @@ Status DataStreamRecvr::SenderQueue::get_batch(RowBatch** next_batch) {
     _received_first_batch = true;
 
     DCHECK(!_batch_queue.empty());
-    RowBatch* result = _batch_queue.front().second;
-    _recvr->_num_buffered_bytes -= _batch_queue.front().first;
+    RowBatch* result = _batch_queue.front().batch;
+    if (result == nullptr) {
+        RETURN_IF_ERROR(_read_spilled_batch(_batch_queue.front(), &result));
+    }
+    _recvr->_num_buffered_bytes -= _batch_queue.front().size;
     VLOG_ROW << "fetched #rows=" << result->num_rows();
     _batch_queue.pop_front();
-    // _data_removal_cv.notify_one();
+    _data_removal_cv.notify_one();
     _current_batch.reset(result);
     *next_batch = _current_batch.get();
 
@@ -185,10 +339,11 @@ Status DataStreamRecvr::SenderQueue::get_batch(RowBatch** next_batch) {
     return Status::OK();
 }
 
-void DataStreamRecvr::SenderQueue::add_batch(const PRowBatch& pb_batch, int be_number,
+void DataStreamRecvr::SenderQueue::add_batch(const PRowBatch& pb_batch,
+                                             const butil::IOBuf* attachment, int be_number,
                                              int64_t packet_seq,
                                              ::google::protobuf::Closure** done) {
-    unique_lock<mutex> l(_lock);
+    std::unique_lock<bthread::Mutex> l(_lock);
     if (_is_cancelled) {
         return;
     }
@@ -205,6 +360,9 @@ void DataStreamRecvr::SenderQueue::add_batch(const PRowBatch& pb_batch, int be_n
     }
 
     int batch_size = RowBatch::get_batch_size(pb_batch);
+    if (pb_batch.tuple_data_in_attachment()) {
+        batch_size += attachment->size();
+    }
     COUNTER_UPDATE(_recvr->_bytes_received_counter, batch_size);
 
     // Following situation will match the following condition.
@@ -233,17 +391,28 @@ void DataStreamRecvr::SenderQueue::add_batch(const PRowBatch& pb_batch, int be_n
         return;
     }
 
+    // Spill the batch rather than blocking the sender, if the receiver feeds a blocking
+    // operator. Like the limit below, keep the batch in memory if the queue is empty.
+    if (done != nullptr && _recvr->_spill_file != nullptr && !_batch_queue.empty() &&
+        _recvr->exceeds_limit(batch_size) && _spill_batch(l, pb_batch, attachment, batch_size, done)) {
+        return;
+    }
+
     RowBatch* batch = NULL;
     {
         SCOPED_TIMER(_recvr->_deserialize_row_batch_timer);
         // Note: if this function makes a row batch, the batch *must* be added
         // to _batch_queue. It is not valid to create the row batch and destroy
         // it in this thread.
-        batch = new RowBatch(_recvr->row_desc(), pb_batch, _recvr->mem_tracker().get());
+        batch = new RowBatch(_recvr->row_desc(), pb_batch, attachment,
+                             _recvr->mem_tracker().get());
     }
 
     VLOG_ROW << "added #rows=" << batch->num_rows() << " batch_size=" << batch_size << "\n";
-    _batch_queue.emplace_back(batch_size, batch);
+    QueuedBatch queued;
+    queued.size = batch_size;
+    queued.batch = batch;
+    _batch_queue.push_back(queued);
     // if done is nullptr, this function can't delay this response
     if (done != nullptr && _recvr->exceeds_limit(batch_size)) {
         MonotonicStopWatch monotonicStopWatch;
@@ -251,13 +420,115 @@ void DataStreamRecvr::SenderQueue::add_batch(const PRowBatch& pb_batch, int be_n
         DCHECK(*done != nullptr);
         _pending_closures.emplace_back(*done, monotonicStopWatch);
         *done = nullptr;
+        COUNTER_UPDATE(_recvr->_bytes_blocked_counter, batch_size);
+        DorisMetrics::instance()->data_stream_receiver_blocked_bytes->increment(batch_size);
     }
     _recvr->_num_buffered_bytes += batch_size;
     _data_arrival_cv.notify_one();
 }
 
+void DataStreamRecvr::SenderQueue::add_batch(RowBatch* batch, bool use_move) {
+    std::unique_lock<bthread::Mutex> l(_lock);
+    // Like the remote batches, always accept a batch if the queue is empty, otherwise a
+    // merging receiver may wait for this queue while the buffer is full.
+    if (!_is_cancelled && !_batch_queue.empty() && _recvr->exceeds_limit(0)) {
+        MonotonicStopWatch watch;
+        watch.start();
+        while (!_is_cancelled && !_batch_queue.empty() && _recvr->exceeds_limit(0)) {
+            _data_removal_cv.wait(l);
+        }
+        watch.stop();
+        if (!_is_cancelled) {
+            _recvr->_buffer_full_total_timer->update(watch.elapsed_time());
+        }
+    }
+    if (_is_cancelled || _num_remaining_senders <= 0) {
+        return;
+    }
+
+    RowBatch* nbatch = new RowBatch(_recvr->row_desc(), batch->capacity(),
+                                    _recvr->mem_tracker().get());
+    if (use_move) {
+        nbatch->acquire_state(batch);
+    } else {
+        batch->deep_copy_to(nbatch);
+    }
+    int batch_size = nbatch->tuple_data_pool()->total_allocated_bytes();
+    COUNTER_UPDATE(_recvr->_bytes_received_counter, batch_size);
+
+    VLOG_ROW << "added #rows=" << nbatch->num_rows() << " batch_size=" << batch_size << "\n";
+    QueuedBatch queued;
+    queued.size = batch_size;
+    queued.batch = nbatch;
+    _batch_queue.push_back(queued);
+    _recvr->_num_buffered_bytes += batch_size;
+    _data_arrival_cv.notify_one();
+}
+
+bool DataStreamRecvr::SenderQueue::_spill_batch(std::unique_lock<bthread::Mutex>& l,
+                                                const PRowBatch& pb_batch,
+                                                const butil::IOBuf* attachment,
+                                                int batch_size,
+                                                ::google::protobuf::Closure** done) {
+    SpillFile* spill_file = _recvr->_spill_file.get();
+    if (!spill_file->has_space(batch_size)) {
+        return false;
+    }
+    QueuedBatch queued;
+    queued.spilling = true;
+    RowBatchQueue::iterator it = _batch_queue.insert(_batch_queue.end(), queued);
+    ++_num_spilling;
+    l.unlock();
+    Status st;
+    {
+        SCOPED_TIMER(_recvr->_spill_timer);
+        st = spill_file->write(pb_batch, attachment, &it->spill_offset, &it->spill_len);
+    }
+    l.lock();
+    it->spilling = false;
+    --_num_spilling;
+    if (st.ok()) {
+        VLOG_ROW << "spilled batch_size=" << batch_size << " len=" << it->spill_len;
+        COUNTER_UPDATE(_recvr->_bytes_spilled_counter, it->spill_len);
+        DorisMetrics::instance()->data_stream_receiver_spilled_bytes->increment(it->spill_len);
+    } else {
+        LOG(WARNING) << "failed to spill row batch, fragment_instance_id="
+                     << _recvr->fragment_instance_id() << ", node=" << _recvr->dest_node_id()
+                     << ", st=" << st.get_error_msg();
+        SCOPED_TIMER(_recvr->_deserialize_row_batch_timer);
+        it->batch = new RowBatch(_recvr->row_desc(), pb_batch, attachment,
+                                 _recvr->mem_tracker().get());
+        it->size = batch_size;
+        MonotonicStopWatch watch;
+        watch.start();
+        _pending_closures.emplace_back(*done, watch);
+        *done = nullptr;
+        COUNTER_UPDATE(_recvr->_bytes_blocked_counter, batch_size);
+        DorisMetrics::instance()->data_stream_receiver_blocked_bytes->increment(batch_size);
+        _recvr->_num_buffered_bytes += batch_size;
+    }
+    // the consumer and close() wait for the batch at the front, or for all of them
+    _data_arrival_cv.notify_all();
+    return true;
+}
+
+Status DataStreamRecvr::SenderQueue::_read_spilled_batch(const QueuedBatch& queued,
+                                                         RowBatch** batch) {
+    PRowBatch pb_batch;
+    butil::IOBuf attachment;
+    {
+        SCOPED_TIMER(_recvr->_spill_timer);
+        RETURN_IF_ERROR(_recvr->_spill_file->read(queued.spill_offset, queued.spill_len,
+                                                  &pb_batch, &attachment));
+    }
+    SCOPED_TIMER(_recvr->_deserialize_row_batch_timer);
+    *batch = new RowBatch(_recvr->row_desc(), pb_batch, &attachment,
+                          _recvr->mem_tracker().get());
+    return Status::OK();
+}
+
 void DataStreamRecvr::SenderQueue::decrement_senders(int be_number) {
-    lock_guard<mutex> l(_lock);
+    std::lock_guard<bthread::Mutex> l(_lock);
     if (_sender_eos_set.end() != _sender_eos_set.find(be_number)) {
         return;
     }
@@ -273,7 +544,7 @@ void DataStreamRecvr::SenderQueue::decrement_senders(int be_number) {
 
 void DataStreamRecvr::SenderQueue::cancel() {
     {
-        lock_guard<mutex> l(_lock);
+        std::lock_guard<bthread::Mutex> l(_lock);
         if (_is_cancelled) {
             return;
         }
@@ -284,12 +555,12 @@ void DataStreamRecvr::SenderQueue::cancel() {
     // Wake up all threads waiting to produce/consume batches.  They will all
     // notice that the stream is cancelled and handle it.
     _data_arrival_cv.notify_all();
-    // _data_removal_cv.notify_all();
+    _data_removal_cv.notify_all();
     // PeriodicCounterUpdater::StopTimeSeriesCounter(
     //         _recvr->_bytes_received_time_series_counter);
 
     {
-        boost::lock_guard<boost::mutex> l(_lock);
+        std::lock_guard<bthread::Mutex> l(_lock);
         for (auto closure_pair : _pending_closures) {
             closure_pair.first->Run();
         }
@@ -302,18 +573,24 @@ void DataStreamRecvr::SenderQueue::close() {
         // If _is_cancelled is not set to true, there may be concurrent send
         // which add batch to _batch_queue. The batch added after _batch_queue
         // is clear will be memory leak
-        boost::lock_guard<boost::mutex> l(_lock);
+        std::unique_lock<bthread::Mutex> l(_lock);
         _is_cancelled = true;
+        // the rpc threads spilling batches still write to their entries in _batch_queue
+        while (_num_spilling > 0) {
+            _data_arrival_cv.wait(l);
+        }
 
         for (auto closure_pair : _pending_closures) {
             closure_pair.first->Run();
         }
         _pending_closures.clear();
     }
+    // wake up local senders blocked in add_batch()
+    _data_removal_cv.notify_all();
 
     // Delete any batches queued in _batch_queue
     for (RowBatchQueue::iterator it = _batch_queue.begin(); it != _batch_queue.end(); ++it) {
-        delete it->second;
+        delete it->batch;
     }
 
     _current_batch.reset();
@@ -378,6 +655,16 @@ DataStreamRecvr::DataStreamRecvr(
     _data_arrival_timer = ADD_TIMER(_profile, "DataArrivalWaitTime");
     _buffer_full_total_timer = ADD_TIMER(_profile, "SendersBlockedTotalTimer(*)");
     _first_batch_wait_total_timer = ADD_TIMER(_profile, "FirstBatchArrivalWaitTime");
+    _bytes_blocked_counter = ADD_COUNTER(_profile, "SendersBlockedBytes", TUnit::BYTES);
+    _bytes_spilled_counter = ADD_COUNTER(_profile, "BytesSpilled", TUnit::BYTES);
+    _spill_timer = ADD_TIMER(_profile, "SpillTime");
+}
+
+void DataStreamRecvr::enable_spill(TmpFileMgr* tmp_file_mgr, const TUniqueId& query_id) {
+    if (config::data_stream_receiver_spill_max_bytes <= 0 || tmp_file_mgr == nullptr) {
+        return;
+    }
+    _spill_file.reset(new SpillFile(tmp_file_mgr, query_id));
 }
 
 Status DataStreamRecvr::get_next(RowBatch* output_batch, bool* eos) {
@@ -385,11 +672,17 @@ Status DataStreamRecvr::get_next(RowBatch* output_batch, bool* eos) {
     return _merger->get_next(output_batch, eos);
 }
 
-void DataStreamRecvr::add_batch(const PRowBatch& batch, int sender_id, int be_number,
-                                int64_t packet_seq, ::google::protobuf::Closure** done) {
+void DataStreamRecvr::add_batch(const PRowBatch& batch, const butil::IOBuf* attachment,
+                                int sender_id, int be_number, int64_t packet_seq,
+                                ::google::protobuf::Closure** done) {
     int use_sender_id = _is_merging ? sender_id : 0;
     // Add all batches to the same queue if _is_merging is false.
-    _sender_queues[use_sender_id]->add_batch(batch, be_number, packet_seq, done);
+    _sender_queues[use_sender_id]->add_batch(batch, attachment, be_number, packet_seq, done);
+}
+
+void DataStreamRecvr::add_batch(RowBatch* batch, int sender_id, bool use_move) {
+    int use_sender_id = _is_merging ? sender_id : 0;
+    _sender_queues[use_sender_id]->add_batch(batch, use_move);
 }
 
 void DataStreamRecvr::remove_sender(int sender_id, int be_number) {
@@ -403,6 +696,16 @@ void DataStreamRecvr::cancel_stream() {
     }
 }
 
+void DataStreamRecvr::finish() {
+    if (_is_finished.exchange(true)) {
+        return;
+    }
+    // Senders blocked on the buffer limit are released and later batches dropped
+    for (int i = 0; i < _sender_queues.size(); ++i) {
+        _sender_queues[i]->cancel();
+    }
+}
+
 void DataStreamRecvr::close() {
     for (int i = 0; i < _sender_queues.size(); ++i) {
         _sender_queues[i]->close();
@@ -412,6 +715,8 @@ void DataStreamRecvr::close() {
     _mgr->deregister_recvr(fragment_instance_id(), dest_node_id());
     _mgr = NULL;
     _merger.reset();
+    // no batch is spilled or read back once the queues are closed
+    _spill_file.reset();
     // TODO: Maybe shared tracker doesn't need to be reset manually
     _mem_tracker.reset();
 }
@@ -18,8 +18,10 @@
 #ifndef DORIS_BE_SRC_RUNTIME_DATA_STREAM_RECVR_H
 #define DORIS_BE_SRC_RUNTIME_DATA_STREAM_RECVR_H
 
+#include <atomic>
 #include <boost/scoped_ptr.hpp>
 #include <boost/thread/mutex.hpp>
+#include <memory>
 
 #include "common/object_pool.h"
 #include "common/status.h"
@@ -34,10 +36,15 @@ class Closure;
 }
 } // namespace google
 
+namespace butil {
+class IOBuf;
+}
+
 namespace doris {
 
 class DataStreamMgr;
 class SortedRunMerger;
+class TmpFileMgr;
 class MemTracker;
 class RowBatch;
 class RuntimeProfile;
@@ -82,6 +89,14 @@ public:
     // Deregister from DataStreamMgr instance, which shares ownership of this instance.
     void close();
 
+    // Called once the exchange node needs no more rows, e.g. it reached its limit, and
+    // must not get batches anymore. Batches sent later are dropped and the current ones
+    // are kept for transfer_all_resources(). Senders are told to stop by the END_OF_FILE
+    // of DataStreamMgr::transmit_data(), or by is_finished() if they are local.
+    void finish();
+
+    bool is_finished() const { return _is_finished; }
+
     // Create a SortedRunMerger instance to merge rows from multiple sender according to the
     // specified row comparator. Fetches the first batches from the individual sender
     // queues. The exprs used in less_than must have already been prepared and opened.
@@ -104,6 +119,15 @@ public:
         _sub_plan_query_statistics_recvr->insert(statistics, sender_id);
     }
 
+    // Adds the rows of 'batch' from a sender on this backend, without serialization.
+    // If use_move is true, the resources of 'batch' are acquired and 'batch' is reset,
+    // otherwise its rows are deep copied. Blocks while the buffer limit is exceeded.
+    void add_batch(RowBatch* batch, int sender_id, bool use_move);
+
+    // Indicate that a particular sender is done. Delegated to the appropriate
+    // sender queue. Called from DataStreamMgr and local senders.
+    void remove_sender(int sender_id, int be_number);
+
 private:
     friend class DataStreamMgr;
     class SenderQueue;
@@ -115,16 +139,18 @@ private:
                     std::shared_ptr<QueryStatisticsRecvr> sub_plan_query_statistics_recvr);
 
     // If receive queue is full, done is enqueue pending, and return with *done is nullptr
-    void add_batch(const PRowBatch& batch, int sender_id, int be_number, int64_t packet_seq,
-                   ::google::protobuf::Closure** done);
-
-    // Indicate that a particular sender is done. Delegated to the appropriate
-    // sender queue. Called from DataStreamMgr.
-    void remove_sender(int sender_id, int be_number);
+    // 'attachment' is the brpc attachment of the request which carried the batch.
+    void add_batch(const PRowBatch& batch, const butil::IOBuf* attachment, int sender_id,
+                   int be_number, int64_t packet_seq, ::google::protobuf::Closure** done);
 
     // Empties the sender queues and notifies all waiting consumers of cancellation.
     void cancel_stream();
 
+    // Called before the receiver is registered. Once the buffer is full, the remote batches
+    // are then spilled to a temporary file of the query, instead of blocking their senders
+    // until the queued batches are consumed.
+    void enable_spill(TmpFileMgr* tmp_file_mgr, const TUniqueId& query_id);
+
     // Return true if the addition of a new batch of size 'batch_size' would exceed the
     // total buffer limit.
     bool exceeds_limit(int batch_size) {
@@ -153,6 +179,9 @@ private:
     // total number of bytes held across all sender queues.
     AtomicInt<int> _num_buffered_bytes;
 
+    // set by finish()
+    std::atomic<bool> _is_finished{false};
+
     // Memtracker for batches in the sender queue(s).
     std::shared_ptr<MemTracker> _mem_tracker;
 
@@ -162,6 +191,10 @@ private:
     // receiver and placed in _sender_queue_pool.
     std::vector<SenderQueue*> _sender_queues;
 
+    // Set by enable_spill(), shared by the sender queues
+    class SpillFile;
+    std::unique_ptr<SpillFile> _spill_file;
+
     // SortedRunMerger used to merge rows from different senders.
     boost::scoped_ptr<SortedRunMerger> _merger;
 
@@ -188,6 +221,13 @@ private:
     // time.
     RuntimeProfile::Counter* _buffer_full_total_timer;
 
+    // Bytes of the batches whose senders were blocked by the buffer limit
+    RuntimeProfile::Counter* _bytes_blocked_counter;
+
+    // Bytes of the batches spilled, and the time spent to write and read them
+    RuntimeProfile::Counter* _bytes_spilled_counter;
+    RuntimeProfile::Counter* _spill_timer;
+
     // Sub plan query statistics receiver.
     std::shared_ptr<QueryStatisticsRecvr> _sub_plan_query_statistics_recvr;
 
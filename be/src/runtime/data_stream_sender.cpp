@@ -20,10 +20,12 @@
 #include <arpa/inet.h>
 #include <thrift/protocol/TDebugProtocol.h>
 
+#include <algorithm>
 #include <boost/shared_ptr.hpp>
 #include <boost/thread/thread.hpp>
 #include <iostream>
 
+#include "common/config.h"
 #include "common/logging.h"
 #include "exprs/expr.h"
 #include "gen_cpp/BackendService.h"
@@ -31,6 +33,8 @@
 #include "gen_cpp/Types_types.h"
 #include "gen_cpp/internal_service.pb.h"
 #include "runtime/client_cache.h"
+#include "runtime/data_stream_mgr.h"
+#include "runtime/data_stream_recvr.h"
 #include "runtime/descriptors.h"
 #include "runtime/dpp_sink_internal.h"
 #include "runtime/exec_env.h"
@@ -43,6 +47,7 @@
 #include "service/brpc.h"
 #include "util/brpc_stub_cache.h"
 #include "util/debug_util.h"
+#include "util/iobuf_util.h"
 #include "util/network_util.h"
 #include "util/ref_count_closure.h"
 #include "util/thrift_client.h"
@@ -50,6 +55,12 @@
 
 namespace doris {
 
+// In adaptive mode, a compressed batch which is larger than this ratio of its
+// uncompressed size isn't worth the CPU, the following batches are sent without
+// compression and then compression is tried again.
+static const double kMinAdaptiveCompressRatio = 0.8;
+static const int kAdaptiveCompressSkipBatches = 16;
+
 // A channel sends data asynchronously via calls to transmit_data
 // to a single destination ipaddress/node.
 // It has a fixed-capacity buffer and allows the caller either to add rows to
@@ -97,11 +108,22 @@ public:
     // Returns error status if any of the preceding rpcs failed, OK otherwise.
     Status add_row(TupleRow* row);
 
+    // Copies the rows of 'batch' at the indexes 'rows' into the output buffer, the tuples
+    // of the same slot into one allocation, and flushes the buffer when it's full.
+    Status add_rows(RowBatch* batch, const int* rows, int num_rows);
+
     // Asynchronously sends a row batch.
     // Returns the status of the most recently finished transmit_data
     // rpc (or OK if there wasn't one that hasn't been reported yet).
     // if batch is nullptr, send the eof packet
-    Status send_batch(PRowBatch* batch, bool eos = false);
+    // 'attachment' carries the tuple data of batch if batch->tuple_data_in_attachment()
+    Status send_batch(PRowBatch* batch, bool eos = false,
+                      const butil::IOBuf* attachment = nullptr);
+
+    // Hands the rows of a batch to the local receiver, see DataStreamRecvr::add_batch().
+    // Must only be called if is_local_recvr() is true.
+    // if batch is nullptr, only the eos is sent
+    Status send_local_batch(RowBatch* batch, bool use_move, bool eos = false);
 
     // Flush buffered rows and close channel. This function don't wait the response
     // of close operation, client should call close_wait() to finish channel's close.
@@ -116,6 +138,10 @@ public:
 
     PRowBatch* pb_batch() { return &_pb_batch; }
 
+    CompressState* compress_state() { return &_compress_state; }
+
+    butil::IOBuf* attachment() { return &_attachment; }
+
     std::string get_fragment_instance_id_str() {
         UniqueId uid(_fragment_instance_id);
         return uid.to_string();
@@ -123,10 +149,21 @@ public:
 
     TUniqueId get_fragment_instance_id() { return _fragment_instance_id; }
 
+    bool is_local() const { return _brpc_dest_addr.hostname == BackendOptions::get_localhost(); }
+
+    // true if the receiver is on this backend and batches bypass brpc
+    bool is_local_recvr() const { return _local_recvr != nullptr; }
+
+    // true once the receiver told it needs no more rows, later rows are not sent
+    bool receiver_finished() const { return _receiver_finished; }
+
 private:
     inline Status _wait_last_brpc() {
         auto cntl = &_closure->cntl;
-        brpc::Join(cntl->call_id());
+        {
+            SCOPED_TIMER(_parent->_rpc_wait_timer);
+            brpc::Join(cntl->call_id());
+        }
         if (cntl->Failed()) {
             std::stringstream ss;
             ss << "failed to send brpc batch, error=" << berror(cntl->ErrorCode())
@@ -135,6 +172,10 @@ private:
             LOG(WARNING) << ss.str();
             return Status::ThriftRpcError(ss.str());
         }
+        if (_closure->result.has_status() &&
+            Status(_closure->result.status()).is_end_of_file()) {
+            _receiver_finished = true;
+        }
         return Status::OK();
     }
 
@@ -166,13 +207,18 @@ private:
     // TODO(zc): initused for brpc
     PUniqueId _finst_id;
     PRowBatch _pb_batch;
+    butil::IOBuf _attachment;
+    CompressState _compress_state;
     PTransmitDataParams _brpc_request;
     PBackendService_Stub* _brpc_stub = nullptr;
     RefCountClosure<PTransmitDataResult>* _closure = nullptr;
     int32_t _brpc_timeout_ms = 500;
+    // receiver of the same backend, batches are sent to it directly if it's not nullptr
+    boost::shared_ptr<DataStreamRecvr> _local_recvr;
     // whether the dest can be treated as query statistics transfer chain.
     bool _is_transfer_chain;
     bool _send_query_statistics_with_every_batch;
+    bool _receiver_finished = false;
 };
 
 Status DataStreamSender::Channel::init(RuntimeState* state) {
@@ -199,18 +245,40 @@ Status DataStreamSender::Channel::init(RuntimeState* state) {
     _brpc_timeout_ms = std::min(3600, state->query_options().query_timeout) * 1000;
     _brpc_stub = state->exec_env()->brpc_stub_cache()->get_stub(_brpc_dest_addr);
 
+    if (config::enable_local_exchange && is_local() &&
+        _brpc_dest_addr.port == config::brpc_port) {
+        // the receiver is created when its fragment is prepared, fall back to brpc if
+        // it's not there
+        _local_recvr = state->exec_env()->stream_mgr()->find_recvr(_fragment_instance_id,
+                                                                   _dest_node_id);
+    }
+
+    _compress_state.compress_type = _parent->_compress_type;
+    if (_parent->_adaptive_compress && is_local()) {
+        // nothing to save on a local link
+        _compress_state.compress_type = segment_v2::CompressionTypePB::NO_COMPRESSION;
+    }
+
     _need_close = true;
     return Status::OK();
 }
 
-Status DataStreamSender::Channel::send_batch(PRowBatch* batch, bool eos) {
+Status DataStreamSender::Channel::send_batch(PRowBatch* batch, bool eos,
+                                            const butil::IOBuf* attachment) {
     if (_closure == nullptr) {
         _closure = new RefCountClosure<PTransmitDataResult>();
         _closure->ref();
     } else {
         RETURN_IF_ERROR(_wait_last_brpc());
+        if (_receiver_finished) {
+            return Status::OK();
+        }
         _closure->cntl.Reset();
     }
+    if (batch != nullptr && attachment != nullptr && !attachment->empty()) {
+        // shares the blocks of attachment, no copy
+        _closure->cntl.request_attachment().append(*attachment);
+    }
     VLOG_ROW << "Channel::send_batch() instance_id=" << _fragment_instance_id
              << " dest_node=" << _dest_node_id;
     if (_is_transfer_chain && (_send_query_statistics_with_every_batch || eos)) {
@@ -233,8 +301,30 @@ Status DataStreamSender::Channel::send_batch(PRowBatch* batch, bool eos) {
     return Status::OK();
 }
 
+Status DataStreamSender::Channel::send_local_batch(RowBatch* batch, bool use_move, bool eos) {
+    DCHECK(_local_recvr != nullptr);
+    if (_local_recvr->is_finished()) {
+        _receiver_finished = true;
+    }
+    VLOG_ROW << "Channel::send_local_batch() instance_id=" << _fragment_instance_id
+             << " dest_node=" << _dest_node_id;
+    if (_is_transfer_chain && (_send_query_statistics_with_every_batch || eos)) {
+        PQueryStatistics statistics;
+        _parent->_query_statistics->to_pb(&statistics);
+        _local_recvr->add_sub_plan_statistics(statistics, _parent->_sender_id);
+    }
+    if (!_receiver_finished && batch != nullptr && batch->num_rows() > 0) {
+        COUNTER_UPDATE(_parent->_local_sent_rows_counter, batch->num_rows());
+        _local_recvr->add_batch(batch, _parent->_sender_id, use_move);
+    }
+    if (eos) {
+        _local_recvr->remove_sender(_parent->_sender_id, _be_number);
+    }
+    return Status::OK();
+}
+
 Status DataStreamSender::Channel::add_row(TupleRow* row) {
-    if (_fragment_instance_id.lo == -1) {
+    if (_fragment_instance_id.lo == -1 || _receiver_finished) {
         return Status::OK();
     }
     int row_num = _batch->add_row();
@@ -263,15 +353,52 @@ Status DataStreamSender::Channel::add_row(TupleRow* row) {
     return Status::OK();
 }
 
+Status DataStreamSender::Channel::add_rows(RowBatch* batch, const int* rows, int num_rows) {
+    if (_fragment_instance_id.lo == -1 || _receiver_finished) {
+        return Status::OK();
+    }
+    const std::vector<TupleDescriptor*>& descs = _row_desc.tuple_descriptors();
+    while (num_rows > 0) {
+        if (_batch->num_rows() == _batch->capacity()) {
+            RETURN_IF_ERROR(send_current_batch());
+        }
+        int n = std::min(num_rows, _batch->capacity() - _batch->num_rows());
+        int row_num = _batch->add_rows(n);
+        DCHECK_NE(row_num, RowBatch::INVALID_ROW_INDEX);
+        MemPool* pool = _batch->tuple_data_pool();
+        for (int i = 0; i < descs.size(); ++i) {
+            int tuple_size = descs[i]->byte_size();
+            uint8_t* tuple_buf = pool->allocate(n * tuple_size);
+            for (int j = 0; j < n; ++j) {
+                Tuple* src = batch->get_row(rows[j])->get_tuple(i);
+                TupleRow* dest = _batch->get_row(row_num + j);
+                if (UNLIKELY(src == nullptr)) {
+                    dest->set_tuple(i, nullptr);
+                } else {
+                    Tuple* dest_tuple = reinterpret_cast<Tuple*>(tuple_buf + j * tuple_size);
+                    src->deep_copy(dest_tuple, *descs[i], pool);
+                    dest->set_tuple(i, dest_tuple);
+                }
+            }
+        }
+        _batch->commit_rows(n);
+        rows += n;
+        num_rows -= n;
+    }
+    return Status::OK();
+}
+
 Status DataStreamSender::Channel::send_current_batch(bool eos) {
-    {
-        SCOPED_TIMER(_parent->_serialize_batch_timer);
-        int uncompressed_bytes = _batch->serialize(&_pb_batch);
-        COUNTER_UPDATE(_parent->_bytes_sent_counter, RowBatch::get_batch_size(_pb_batch));
-        COUNTER_UPDATE(_parent->_uncompressed_bytes_counter, uncompressed_bytes);
+    if (is_local_recvr()) {
+        // rows of _batch are deep copied from the input, so its resources can be moved
+        RETURN_IF_ERROR(send_local_batch(_batch.get(), true, eos));
+        _batch->reset();
+        return Status::OK();
     }
+    RETURN_IF_ERROR(_parent->serialize_batch(_batch.get(), &_pb_batch, 1, &_compress_state,
+                                             &_attachment));
     _batch->reset();
-    RETURN_IF_ERROR(send_batch(&_pb_batch, eos));
+    RETURN_IF_ERROR(send_batch(&_pb_batch, eos, &_attachment));
     return Status::OK();
 }
 
@@ -282,8 +409,10 @@ Status DataStreamSender::Channel::close_internal() {
     VLOG_RPC << "Channel::close() instance_id=" << _fragment_instance_id
              << " dest_node=" << _dest_node_id
              << " #rows= " << ((_batch == nullptr) ? 0 : _batch->num_rows());
-    if (_batch != NULL && _batch->num_rows() > 0) {
+    if (_batch != NULL && _batch->num_rows() > 0 && !_receiver_finished) {
         RETURN_IF_ERROR(send_current_batch(true));
+    } else if (is_local_recvr()) {
+        RETURN_IF_ERROR(send_local_batch(nullptr, false, true));
     } else {
         RETURN_IF_ERROR(send_batch(nullptr, true));
     }
@@ -300,7 +429,10 @@ Status DataStreamSender::Channel::close(RuntimeState* state) {
 }
 
 Status DataStreamSender::Channel::close_wait(RuntimeState* state) {
-    if (_need_close) {
+    if (_need_close && is_local_recvr()) {
+        // nothing in flight
+        _need_close = false;
+    } else if (_need_close) {
         Status st = _wait_last_brpc();
         if (!st.ok()) {
             state->log_error(st.get_error_msg());
@@ -324,6 +456,9 @@ DataStreamSender::DataStreamSender(ObjectPool* pool, int sender_id, const RowDes
           _part_type(sink.output_partition.type),
           _ignore_not_found(sink.__isset.ignore_not_found ? sink.ignore_not_found : true),
           _current_pb_batch(&_pb_batch1),
+          _attachment1(new butil::IOBuf()),
+          _attachment2(new butil::IOBuf()),
+          _current_attachment(_attachment1.get()),
           _profile(NULL),
           _serialize_batch_timer(NULL),
           _bytes_sent_counter(NULL),
@@ -431,16 +566,46 @@ Status DataStreamSender::prepare(RuntimeState* state) {
     _bytes_sent_counter = ADD_COUNTER(profile(), "BytesSent", TUnit::BYTES);
     _uncompressed_bytes_counter = ADD_COUNTER(profile(), "UncompressedRowBatchSize", TUnit::BYTES);
     _ignore_rows = ADD_COUNTER(profile(), "IgnoreRows", TUnit::UNIT);
+    _compress_skipped_batches_counter =
+            ADD_COUNTER(profile(), "CompressSkippedBatches", TUnit::UNIT);
+    _local_sent_rows_counter = ADD_COUNTER(profile(), "LocalSentRows", TUnit::UNIT);
     _serialize_batch_timer = ADD_TIMER(profile(), "SerializeBatchTime");
+    _rpc_wait_timer = ADD_TIMER(profile(), "RpcWaitTime");
     _overall_throughput = profile()->add_derived_counter(
             "OverallThroughput", TUnit::BYTES_PER_SECOND,
             boost::bind<int64_t>(&RuntimeProfile::units_per_second, _bytes_sent_counter,
                                  profile()->total_time_counter()),
             "");
+
+    _compress_type = config::compress_rowbatches ? segment_v2::CompressionTypePB::SNAPPY
+                                                 : segment_v2::CompressionTypePB::NO_COMPRESSION;
+    const TQueryOptions& query_options = state->query_options();
+    if (query_options.__isset.exchange_compress_type) {
+        segment_v2::CompressionTypePB type;
+        if (segment_v2::CompressionTypePB_Parse(query_options.exchange_compress_type, &type) &&
+            type != segment_v2::CompressionTypePB::UNKNOWN_COMPRESSION &&
+            type != segment_v2::CompressionTypePB::DEFAULT_COMPRESSION) {
+            _compress_type = type;
+        } else {
+            LOG(WARNING) << "unknown exchange_compress_type "
+                         << query_options.exchange_compress_type
+                         << ", use default codec of row batches";
+        }
+    }
+    _compress_level = query_options.exchange_compress_level;
+    _adaptive_compress = query_options.enable_adaptive_exchange_compress;
+
     for (int i = 0; i < _channels.size(); ++i) {
         RETURN_IF_ERROR(_channels[i]->init(state));
     }
 
+    _compress_state.compress_type = _compress_type;
+    if (_adaptive_compress && !_channels.empty() &&
+        std::all_of(_channels.begin(), _channels.end(),
+                    [](Channel* channel) { return channel->is_local(); })) {
+        _compress_state.compress_type = segment_v2::CompressionTypePB::NO_COMPRESSION;
+    }
+
     return Status::OK();
 }
 
@@ -459,60 +624,120 @@ Status DataStreamSender::open(RuntimeState* state) {
     return Status::OK();
 }
 
+template <typename Channels>
+Status DataStreamSender::hash_partition(RowBatch* batch, bool use_crc, const Channels& channels) {
+    int num_rows = batch->num_rows();
+    _hash_vals.assign(num_rows, 0);
+    for (auto ctx : _partition_expr_ctxs) {
+        const TypeDescriptor& type = ctx->root()->type();
+        if (use_crc) {
+            for (int i = 0; i < num_rows; ++i) {
+                void* partition_val = ctx->get_value(batch->get_row(i));
+                _hash_vals[i] = RawValue::zlib_crc32(partition_val, type, _hash_vals[i]);
+            }
+        } else {
+            for (int i = 0; i < num_rows; ++i) {
+                void* partition_val = ctx->get_value(batch->get_row(i));
+                _hash_vals[i] = RawValue::get_hash_value_fvn(partition_val, type, _hash_vals[i]);
+            }
+        }
+    }
+
+    // group the rows by channel with a counting sort
+    int num_channels = channels.size();
+    _channel_row_offsets.assign(num_channels + 1, 0);
+    for (int i = 0; i < num_rows; ++i) {
+        _hash_vals[i] %= num_channels;
+        ++_channel_row_offsets[_hash_vals[i] + 1];
+    }
+    for (int i = 0; i < num_channels; ++i) {
+        _channel_row_offsets[i + 1] += _channel_row_offsets[i];
+    }
+    _channel_rows.resize(num_rows);
+    for (int i = 0; i < num_rows; ++i) {
+        // the offset of the channel is moved to its end, and then back
+        _channel_rows[_channel_row_offsets[_hash_vals[i]]++] = i;
+    }
+    for (int i = num_channels; i > 0; --i) {
+        _channel_row_offsets[i] = _channel_row_offsets[i - 1];
+    }
+    _channel_row_offsets[0] = 0;
+
+    for (int i = 0; i < num_channels; ++i) {
+        int start = _channel_row_offsets[i];
+        int num_channel_rows = _channel_row_offsets[i + 1] - start;
+        if (num_channel_rows > 0) {
+            RETURN_IF_ERROR(
+                    channels[i]->add_rows(batch, _channel_rows.data() + start, num_channel_rows));
+        }
+    }
+    return Status::OK();
+}
+
 Status DataStreamSender::send(RuntimeState* state, RowBatch* batch) {
     SCOPED_TIMER(_profile->total_time_counter());
 
+    // A receiver tells it's finished by the response of a later batch, so some rows
+    // may still be sent after it reached its limit.
+    bool all_finished = true;
+    for (auto channel : _channels) {
+        all_finished &= channel->receiver_finished();
+    }
+    if (all_finished) {
+        return Status::EndOfFile("all receivers of the data stream finished");
+    }
+
     // Unpartition or _channel size
     if (_part_type == TPartitionType::UNPARTITIONED || _channels.size() == 1) {
-        RETURN_IF_ERROR(serialize_batch(batch, _current_pb_batch, _channels.size()));
+        // only serialize for the remote receivers, the input batch is owned by the caller
+        // so rows are copied to the local ones
+        int num_remote_channels = 0;
         for (auto channel : _channels) {
-            RETURN_IF_ERROR(channel->send_batch(_current_pb_batch));
+            if (channel->receiver_finished()) {
+                continue;
+            } else if (channel->is_local_recvr()) {
+                RETURN_IF_ERROR(channel->send_local_batch(batch, false));
+            } else {
+                ++num_remote_channels;
+            }
+        }
+        if (num_remote_channels > 0) {
+            RETURN_IF_ERROR(serialize_batch(batch, _current_pb_batch, num_remote_channels,
+                                            &_compress_state, _current_attachment));
+            for (auto channel : _channels) {
+                if (!channel->is_local_recvr() && !channel->receiver_finished()) {
+                    RETURN_IF_ERROR(
+                            channel->send_batch(_current_pb_batch, false, _current_attachment));
+                }
+            }
+            _current_pb_batch = (_current_pb_batch == &_pb_batch1 ? &_pb_batch2 : &_pb_batch1);
+            _current_attachment = (_current_attachment == _attachment1.get() ? _attachment2.get()
+                                                                             : _attachment1.get());
         }
-        _current_pb_batch = (_current_pb_batch == &_pb_batch1 ? &_pb_batch2 : &_pb_batch1);
     } else if (_part_type == TPartitionType::RANDOM) {
         // Round-robin batches among channels. Wait for the current channel to finish its
         // rpc before overwriting its batch.
         Channel* current_channel = _channels[_current_channel_idx];
-        RETURN_IF_ERROR(serialize_batch(batch, current_channel->pb_batch()));
-        RETURN_IF_ERROR(current_channel->send_batch(current_channel->pb_batch()));
+        if (current_channel->is_local_recvr()) {
+            RETURN_IF_ERROR(current_channel->send_local_batch(batch, false));
+        } else {
+            RETURN_IF_ERROR(serialize_batch(batch, current_channel->pb_batch(), 1,
+                                            current_channel->compress_state(),
+                                            current_channel->attachment()));
+            RETURN_IF_ERROR(current_channel->send_batch(current_channel->pb_batch(), false,
+                                                        current_channel->attachment()));
+        }
         _current_channel_idx = (_current_channel_idx + 1) % _channels.size();
     } else if (_part_type == TPartitionType::HASH_PARTITIONED) {
-        // hash-partition batch's rows across channels
-        int num_channels = _channels.size();
-
-        for (int i = 0; i < batch->num_rows(); ++i) {
-            TupleRow* row = batch->get_row(i);
-            size_t hash_val = 0;
-
-            for (auto ctx : _partition_expr_ctxs) {
-                void* partition_val = ctx->get_value(row);
-                // We can't use the crc hash function here because it does not result
-                // in uncorrelated hashes with different seeds.  Instead we must use
-                // fvn hash.
-                // TODO: fix crc hash/GetHashValue()
-                hash_val =
-                        RawValue::get_hash_value_fvn(partition_val, ctx->root()->type(), hash_val);
-            }
-            auto target_channel_id = hash_val % num_channels;
-            RETURN_IF_ERROR(_channels[target_channel_id]->add_row(row));
-        }
+        // We can't use the crc hash function here because it does not result
+        // in uncorrelated hashes with different seeds.  Instead we must use
+        // fvn hash.
+        // TODO: fix crc hash/GetHashValue()
+        RETURN_IF_ERROR(hash_partition(batch, false, _channels));
     } else if (_part_type == TPartitionType::BUCKET_SHFFULE_HASH_PARTITIONED) {
-        // hash-partition batch's rows across channels
-        int num_channels = _channel_shared_ptrs.size();
-
-        for (int i = 0; i < batch->num_rows(); ++i) {
-            TupleRow* row = batch->get_row(i);
-            size_t hash_val = 0;
-
-            for (auto ctx : _partition_expr_ctxs) {
-                void* partition_val = ctx->get_value(row);
-                // We must use the crc hash function to make sure the hash val equal
-                // to left table data distribute hash val
-                hash_val = RawValue::zlib_crc32(partition_val, ctx->root()->type(), hash_val);
-            }
-            auto target_channel_id = hash_val % num_channels;
-            RETURN_IF_ERROR(_channel_shared_ptrs[target_channel_id]->add_row(row));
-        }
+        // We must use the crc hash function to make sure the hash val equal
+        // to left table data distribute hash val
+        RETURN_IF_ERROR(hash_partition(batch, true, _channel_shared_ptrs));
     } else {
         // Range partition
         int num_channels = _channels.size();
@@ -656,23 +881,43 @@ Status DataStreamSender::close(RuntimeState* state, Status exec_status) {
     return final_st;
 }
 
-template <typename T>
-Status DataStreamSender::serialize_batch(RowBatch* src, T* dest, int num_receivers) {
+Status DataStreamSender::serialize_batch(RowBatch* src, PRowBatch* dest, int num_receivers,
+                                         CompressState* state, butil::IOBuf* attachment) {
     VLOG_ROW << "serializing " << src->num_rows() << " rows";
     {
         // TODO(zc)
         // SCOPED_TIMER(_profile->total_time_counter());
         SCOPED_TIMER(_serialize_batch_timer);
-        // TODO(zc)
-        // RETURN_IF_ERROR(src->serialize(dest));
-        int uncompressed_bytes = src->serialize(dest);
+        segment_v2::CompressionTypePB compress_type =
+                state != nullptr ? state->compress_type : _compress_type;
+        if (state != nullptr && state->num_skip_batches > 0) {
+            --state->num_skip_batches;
+            compress_type = segment_v2::CompressionTypePB::NO_COMPRESSION;
+            COUNTER_UPDATE(_compress_skipped_batches_counter, 1);
+        }
+        int uncompressed_bytes = src->serialize(dest, compress_type, _compress_level);
         int bytes = RowBatch::get_batch_size(*dest);
+        if (_adaptive_compress && state != nullptr &&
+            compress_type != segment_v2::CompressionTypePB::NO_COMPRESSION &&
+            bytes > uncompressed_bytes * kMinAdaptiveCompressRatio) {
+            state->num_skip_batches = kAdaptiveCompressSkipBatches;
+        }
         // TODO(zc)
         // int uncompressed_bytes = bytes - dest->tuple_data.size() + dest->uncompressed_size;
         // The size output_batch would be if we didn't compress tuple_data (will be equal to
         // actual batch size if tuple_data isn't compressed)
         COUNTER_UPDATE(_bytes_sent_counter, bytes * num_receivers);
         COUNTER_UPDATE(_uncompressed_bytes_counter, uncompressed_bytes * num_receivers);
+
+        if (attachment != nullptr) {
+            // the blocks are still referenced by the in-flight requests they were
+            // appended to
+            attachment->clear();
+            if (config::transfer_row_batch_by_brpc_attachment) {
+                move_string_to_iobuf(dest->mutable_tuple_data(), attachment);
+                dest->set_tuple_data_in_attachment(true);
+            }
+        }
     }
 
     return Status::OK();
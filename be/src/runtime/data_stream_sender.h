@@ -18,6 +18,7 @@
 #ifndef DORIS_BE_RUNTIME_DATA_STREAM_SENDER_H
 #define DORIS_BE_RUNTIME_DATA_STREAM_SENDER_H
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -26,8 +27,13 @@
 #include "common/status.h"
 #include "exec/data_sink.h"
 #include "gen_cpp/data.pb.h" // for PRowBatch
+#include "gen_cpp/segment_v2.pb.h"
 #include "util/runtime_profile.h"
 
+namespace butil {
+class IOBuf;
+}
+
 namespace doris {
 
 class ExprContext;
@@ -77,17 +83,31 @@ public:
     // Blocks until all rows in batch are placed in their appropriate outgoing
     // buffers (ie, blocks if there are still in-flight rpcs from the last
     // send() call).
+    // Returns END_OF_FILE once all receivers need no more rows, e.g. their exchange
+    // nodes reached the limit, so the fragment can stop early.
     virtual Status send(RuntimeState* state, RowBatch* batch);
 
     // Flush all buffered data and close all existing channels to destination
     // hosts. Further send() calls are illegal after calling close().
     virtual Status close(RuntimeState* state, Status exec_status);
 
+    // Codec state of a stream of batches, i.e. of a channel or of the broadcast.
+    struct CompressState {
+        segment_v2::CompressionTypePB compress_type = segment_v2::CompressionTypePB::NO_COMPRESSION;
+        // in adaptive mode, number of following batches sent without compression
+        // because the last compressed one didn't shrink enough
+        int num_skip_batches = 0;
+    };
+
     /// Serializes the src batch into the dest thrift batch. Maintains metrics.
     /// num_receivers is the number of receivers this batch will be sent to. Only
     /// used to maintain metrics.
-    template <class T>
-    Status serialize_batch(RowBatch* src, T* dest, int num_receivers = 1);
+    /// The batch is compressed according to 'state', or to the sender's codec if
+    /// 'state' is nullptr.
+    /// If 'attachment' is not nullptr and config::transfer_row_batch_by_brpc_attachment
+    /// is true, the tuple data is moved to 'attachment' instead of dest->tuple_data.
+    Status serialize_batch(RowBatch* src, PRowBatch* dest, int num_receivers = 1,
+                           CompressState* state = nullptr, butil::IOBuf* attachment = nullptr);
 
     // Return total number of bytes sent in TRowBatch.data. If batches are
     // broadcast to multiple receivers, they are counted once per receiver.
@@ -108,6 +128,12 @@ private:
     Status process_distribute(RuntimeState* state, TupleRow* row, const PartitionInfo* part,
                               size_t* hash_val);
 
+    // Hashes the partition exprs of the rows of 'batch' an expr at a time, and adds the rows
+    // to 'channels' by the hash values, the rows of a channel at once. 'channels' is
+    // _channels or _channel_shared_ptrs.
+    template <typename Channels>
+    Status hash_partition(RowBatch* batch, bool use_crc, const Channels& channels);
+
     // Sender instance id, unique within a fragment.
     int _sender_id;
 
@@ -128,12 +154,30 @@ private:
     PRowBatch _pb_batch1;
     PRowBatch _pb_batch2;
     PRowBatch* _current_pb_batch = nullptr;
+    // brpc attachments of _pb_batch1 and _pb_batch2
+    std::unique_ptr<butil::IOBuf> _attachment1;
+    std::unique_ptr<butil::IOBuf> _attachment2;
+    butil::IOBuf* _current_attachment = nullptr;
+
+    // codec of the batches, from query options or config::compress_rowbatches
+    segment_v2::CompressionTypePB _compress_type = segment_v2::CompressionTypePB::NO_COMPRESSION;
+    int _compress_level = 0;
+    // skip compression for local receivers and poorly compressed batches
+    bool _adaptive_compress = false;
+    // state of the broadcast batches
+    CompressState _compress_state;
 
     std::vector<ExprContext*> _partition_expr_ctxs; // compute per-row partition values
 
     std::vector<Channel*> _channels;
     std::vector<std::shared_ptr<Channel>> _channel_shared_ptrs;
 
+    // buffers of hash_partition(): the hash values and then the channels of the rows of
+    // a batch, the rows grouped by channel, and the start of the rows of each channel
+    std::vector<uint32_t> _hash_vals;
+    std::vector<int> _channel_rows;
+    std::vector<int> _channel_row_offsets;
+
     // map from range value to partition_id
     // sorted in ascending orderi by range for binary search
     std::vector<PartitionInfo*> _partition_infos;
@@ -142,6 +186,11 @@ private:
     RuntimeProfile::Counter* _serialize_batch_timer;
     RuntimeProfile::Counter* _bytes_sent_counter;
     RuntimeProfile::Counter* _uncompressed_bytes_counter;
+    RuntimeProfile::Counter* _compress_skipped_batches_counter = nullptr;
+    // rows handed to receivers on this backend without serialization
+    RuntimeProfile::Counter* _local_sent_rows_counter = nullptr;
+    // time waiting for the responses of the previous brpc batches
+    RuntimeProfile::Counter* _rpc_wait_timer = nullptr;
     RuntimeProfile::Counter* _ignore_rows;
 
     std::shared_ptr<MemTracker> _mem_tracker;
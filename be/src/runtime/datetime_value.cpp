@@ -80,10 +80,49 @@ bool DateTimeValue::check_date() const {
     return false;
 }
 
+// Parses 'str' if it's exactly 'YYYY-MM-DD' or 'YYYY-MM-DD HH:MM:SS', the formats of
+// most of the loaded values, without scanning for the fields and delimiters.
+// Returns the number of fields set in 'vals', 0 if 'str' isn't in one of the formats.
+static int parse_fixed_date_str(const char* str, int len, uint32_t* vals) {
+    static const char format[] = "0000-00-00 00:00:00";
+    if (len != 10 && len != 19) {
+        return 0;
+    }
+    for (int i = 0; i < len; ++i) {
+        bool is_digit = static_cast<uint8_t>(str[i] - '0') <= 9;
+        if (format[i] == '0' ? !is_digit : str[i] != format[i]) {
+            return 0;
+        }
+    }
+    vals[0] = (str[0] - '0') * 1000 + (str[1] - '0') * 100 + (str[2] - '0') * 10 + (str[3] - '0');
+    int num_fields = len == 10 ? 3 : 6;
+    for (int i = 1; i < num_fields; ++i) {
+        // the 2 digits of the other fields follow the delimiters at 4, 7, 10, 13 and 16
+        const char* field = str + 2 + 3 * i;
+        vals[i] = (field[0] - '0') * 10 + (field[1] - '0');
+    }
+    return num_fields;
+}
+
 // The interval format is that with no delimiters
 // YYYY-MM-DD HH-MM-DD.FFFFFF AM in default format
 // 0    1  2  3  4  5  6      7
 bool DateTimeValue::from_date_str(const char* date_str, int len) {
+    uint32_t fixed_val[6] = {0};
+    int num_fixed_field = parse_fixed_date_str(date_str, len, fixed_val);
+    if (num_fixed_field != 0) {
+        _neg = false;
+        _type = num_fixed_field == 3 ? TIME_DATE : TIME_DATETIME;
+        _year = fixed_val[0];
+        _month = fixed_val[1];
+        _day = fixed_val[2];
+        _hour = fixed_val[3];
+        _minute = fixed_val[4];
+        _second = fixed_val[5];
+        _microsecond = 0;
+        return !check_range() && !check_date();
+    }
+
     const char* ptr = date_str;
     const char* end = date_str + len;
     // ONLY 2, 6 can follow by a sapce
@@ -476,10 +515,22 @@ int64_t DateTimeValue::to_int64() const {
     }
 }
 
+// The last day converted by get_date_from_daynr() in this thread and its date packed as
+// year << 16 | month << 8 | day. The rows of a batch often share the day, e.g. when they
+// are bucketed by day or are the days added to the dates of a day partition.
+static __thread uint64_t s_last_daynr = 0;
+static __thread uint32_t s_last_date = 0;
+
 bool DateTimeValue::get_date_from_daynr(uint64_t daynr) {
     if (daynr <= 0 || daynr > DATE_MAX_DAYNR) {
         return false;
     }
+    if (daynr == s_last_daynr) {
+        _year = s_last_date >> 16;
+        _month = (s_last_date >> 8) & 0xFF;
+        _day = s_last_date & 0xFF;
+        return true;
+    }
     _year = daynr / 365;
     uint32_t days_befor_year = 0;
     while (daynr < (days_befor_year = calc_daynr(_year, 1, 1))) {
@@ -501,6 +552,8 @@ bool DateTimeValue::get_date_from_daynr(uint64_t daynr) {
         _month++;
     }
     _day = days_of_year + leap_day;
+    s_last_daynr = daynr;
+    s_last_date = (_year << 16) | (_month << 8) | _day;
     return true;
 }
 
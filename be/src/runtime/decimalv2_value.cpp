@@ -72,7 +72,8 @@ static int do_mul(int128_t x, int128_t y, int128_t* result) {
     }
 
     int128_t product = x * y;
-    *result = product / DecimalV2Value::ONE_BILLION;
+    uint64_t remainder = 0;
+    *result = div_mod_uint64(product, DecimalV2Value::ONE_BILLION, &remainder);
 
     // overflow
     if (*result > DecimalV2Value::MAX_DECIMAL_VALUE) {
@@ -82,7 +83,6 @@ static int do_mul(int128_t x, int128_t y, int128_t* result) {
     }
 
     // truncate with round
-    int128_t remainder = product % DecimalV2Value::ONE_BILLION;
     if (remainder != 0) {
         error = E_DEC_TRUNCATED;
         if (remainder >= (DecimalV2Value::ONE_BILLION >> 1)) {
@@ -250,33 +250,25 @@ int DecimalV2Value::parse_from_str(const char* decimal_str, int32_t length) {
 std::string DecimalV2Value::to_string(int round_scale) const {
     if (_value == 0) return std::string(1, '0');
 
-    int last_char_idx = PRECISION + 2 + (_value < 0);
-    std::string str = std::string(last_char_idx, '0');
-
-    int128_t remaining_value = _value;
-    int first_digit_idx = 0;
+    // the parts are split by one division, instead of dividing __int128 for each digit
+    int32_t frac = 0;
+    int128_t int_part = _div_one_billion(&frac);
+    char buf[64];
+    char* end = buf + sizeof(buf);
+    char* d = LargeIntValue::write_digits(static_cast<uint64_t>(frac < 0 ? -frac : frac), end,
+                                          SCALE);
+    --d;
+    *d = '.';
+    unsigned __int128 abs_int_part = static_cast<unsigned __int128>(int_part);
+    if (int_part < 0) {
+        abs_int_part = -abs_int_part;
+    }
+    d = LargeIntValue::write_digits(abs_int_part, d);
     if (_value < 0) {
-        remaining_value = -_value;
-        first_digit_idx = 1;
+        --d;
+        *d = '-';
     }
-
-    int remaining_scale = SCALE;
-    do {
-        str[--last_char_idx] = (remaining_value % 10) + '0';
-        remaining_value /= 10;
-    } while (--remaining_scale > 0);
-    str[--last_char_idx] = '.';
-
-    do {
-        str[--last_char_idx] = (remaining_value % 10) + '0';
-        remaining_value /= 10;
-        if (remaining_value == 0) {
-            if (last_char_idx > first_digit_idx) str.erase(0, last_char_idx - first_digit_idx);
-            break;
-        }
-    } while (last_char_idx > first_digit_idx);
-
-    if (_value < 0) str[0] = '-';
+    std::string str(d, end - d);
 
     // right trim and round
     int scale = 0;
@@ -28,6 +28,7 @@
 
 #include "common/logging.h"
 #include "runtime/decimal_value.h"
+#include "runtime/large_int_value.h"
 #include "udf/udf.h"
 #include "util/hash_util.hpp"
 
@@ -109,13 +110,13 @@ public:
     // e.g. "ComputeFunctions::Cast_DecimalV2Value_double()"
     // Discard the scale part
     // ATTN: invoker must make sure no OVERFLOW
-    operator int64_t() const { return static_cast<int64_t>(_value / ONE_BILLION); }
+    operator int64_t() const { return static_cast<int64_t>(_div_one_billion(nullptr)); }
 
     // These cast functions are needed in "functions.cc", which is generated by python script.
     // e.g. "ComputeFunctions::Cast_DecimalV2Value_double()"
     // Discard the scale part
     // ATTN: invoker must make sure no OVERFLOW
-    operator int128_t() const { return static_cast<int128_t>(_value / ONE_BILLION); }
+    operator int128_t() const { return _div_one_billion(nullptr); }
 
     operator bool() const { return _value != 0; }
 
@@ -145,7 +146,11 @@ public:
     // NOTE: return a negative value if decimal is negative.
     // ATTN: the max length of fraction part in OLAP is 9, so the 'big digits' except the first one
     // will be truncated.
-    int32_t frac_value() const { return static_cast<int64_t>(_value % ONE_BILLION); }
+    int32_t frac_value() const {
+        int32_t frac = 0;
+        _div_one_billion(&frac);
+        return frac;
+    }
 
     bool operator==(const DecimalV2Value& other) const { return _value == other.value(); }
 
@@ -269,6 +274,21 @@ public:
     bool is_zero() const { return _value == 0; }
 
 private:
+    // Return _value / ONE_BILLION and set '*frac' to _value % ONE_BILLION if it's not null,
+    // which are truncated toward zero like the operators, by the division of 64 bits.
+    int128_t _div_one_billion(int32_t* frac) const {
+        unsigned __int128 abs_value = static_cast<unsigned __int128>(_value);
+        if (_value < 0) {
+            abs_value = -abs_value;
+        }
+        uint64_t remainder = 0;
+        int128_t quotient = div_mod_uint64(abs_value, ONE_BILLION, &remainder);
+        if (frac != nullptr) {
+            *frac = _value < 0 ? -static_cast<int32_t>(remainder) : remainder;
+        }
+        return _value < 0 ? -quotient : quotient;
+    }
+
     int128_t _value;
 };
 
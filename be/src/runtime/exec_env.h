@@ -34,16 +34,21 @@ class EtlJobMgr;
 class EvHttpServer;
 class ExternalScanContextMgr;
 class FragmentMgr;
+class GroupCommitMgr;
 class ResultCache;
 class LoadPathMgr;
 class LoadStreamMgr;
+class MemAdmissionController;
 class MemTracker;
 class StorageEngine;
 class PoolMemTrackerRegistry;
+class FairThreadPool;
 class PriorityThreadPool;
 class ReservationTracker;
+class ResourceGroupMgr;
 class ResultBufferMgr;
 class ResultQueueMgr;
+class SharedHashTableMgr;
 class TMasterInfo;
 class LoadChannelMgr;
 class TestExecEnv;
@@ -94,6 +99,7 @@ public:
     DataStreamMgr* stream_mgr() { return _stream_mgr; }
     ResultBufferMgr* result_mgr() { return _result_mgr; }
     ResultQueueMgr* result_queue_mgr() { return _result_queue_mgr; }
+    SharedHashTableMgr* shared_hash_table_mgr() { return _shared_hash_table_mgr; }
     ClientCache<BackendServiceClient>* client_cache() { return _backend_client_cache; }
     ClientCache<FrontendServiceClient>* frontend_client_cache() { return _frontend_client_cache; }
     ClientCache<TPaloBrokerServiceClient>* broker_client_cache() { return _broker_client_cache; }
@@ -110,7 +116,8 @@ public:
     std::shared_ptr<MemTracker> process_mem_tracker() { return _mem_tracker; }
     PoolMemTrackerRegistry* pool_mem_trackers() { return _pool_mem_trackers; }
     ThreadResourceMgr* thread_mgr() { return _thread_mgr; }
-    PriorityThreadPool* thread_pool() { return _thread_pool; }
+    FairThreadPool* scan_thread_pool() { return _scan_thread_pool; }
+    FairThreadPool* broker_scan_thread_pool() { return _broker_scan_thread_pool; }
     PriorityThreadPool* etl_thread_pool() { return _etl_thread_pool; }
     CgroupsMgr* cgroups_mgr() { return _cgroups_mgr; }
     FragmentMgr* fragment_mgr() { return _fragment_mgr; }
@@ -125,6 +132,8 @@ public:
     BrpcStubCache* brpc_stub_cache() const { return _brpc_stub_cache; }
     ReservationTracker* buffer_reservation() { return _buffer_reservation; }
     BufferPool* buffer_pool() { return _buffer_pool; }
+    MemAdmissionController* mem_admission_controller() { return _mem_admission_controller; }
+    ResourceGroupMgr* resource_group_mgr() { return _resource_group_mgr; }
     LoadChannelMgr* load_channel_mgr() { return _load_channel_mgr; }
     LoadStreamMgr* load_stream_mgr() { return _load_stream_mgr; }
     SmallFileMgr* small_file_mgr() { return _small_file_mgr; }
@@ -135,6 +144,7 @@ public:
     void set_storage_engine(StorageEngine* storage_engine) { _storage_engine = storage_engine; }
 
     StreamLoadExecutor* stream_load_executor() { return _stream_load_executor; }
+    GroupCommitMgr* group_commit_mgr() { return _group_commit_mgr; }
     RoutineLoadTaskExecutor* routine_load_task_executor() { return _routine_load_task_executor; }
     HeartbeatFlags* heartbeat_flags() { return _heartbeat_flags; }
 
@@ -156,6 +166,7 @@ private:
     DataStreamMgr* _stream_mgr = nullptr;
     ResultBufferMgr* _result_mgr = nullptr;
     ResultQueueMgr* _result_queue_mgr = nullptr;
+    SharedHashTableMgr* _shared_hash_table_mgr = nullptr;
     ClientCache<BackendServiceClient>* _backend_client_cache = nullptr;
     ClientCache<FrontendServiceClient>* _frontend_client_cache = nullptr;
     ClientCache<TPaloBrokerServiceClient>* _broker_client_cache = nullptr;
@@ -163,7 +174,9 @@ private:
     std::shared_ptr<MemTracker> _mem_tracker;
     PoolMemTrackerRegistry* _pool_mem_trackers = nullptr;
     ThreadResourceMgr* _thread_mgr = nullptr;
-    PriorityThreadPool* _thread_pool = nullptr;
+    FairThreadPool* _scan_thread_pool = nullptr;
+    // Shared by the scanners of the broker files of all loads
+    FairThreadPool* _broker_scan_thread_pool = nullptr;
     PriorityThreadPool* _etl_thread_pool = nullptr;
     CgroupsMgr* _cgroups_mgr = nullptr;
     FragmentMgr* _fragment_mgr = nullptr;
@@ -182,10 +195,14 @@ private:
 
     ReservationTracker* _buffer_reservation = nullptr;
     BufferPool* _buffer_pool = nullptr;
+    // Not deleted, like the process mem tracker which calls it to free memory.
+    MemAdmissionController* _mem_admission_controller = nullptr;
+    ResourceGroupMgr* _resource_group_mgr = nullptr;
 
     StorageEngine* _storage_engine = nullptr;
 
     StreamLoadExecutor* _stream_load_executor = nullptr;
+    GroupCommitMgr* _group_commit_mgr = nullptr;
     RoutineLoadTaskExecutor* _routine_load_task_executor = nullptr;
     SmallFileMgr* _small_file_mgr = nullptr;
     HeartbeatFlags* _heartbeat_flags = nullptr;
@@ -20,12 +20,15 @@
 #include "agent/cgroups_mgr.h"
 #include "common/config.h"
 #include "common/logging.h"
+#include "exec/agg_result_cache.h"
 #include "gen_cpp/BackendService.h"
 #include "gen_cpp/FrontendService.h"
 #include "gen_cpp/HeartbeatService_types.h"
 #include "gen_cpp/TExtDataSourceService.h"
 #include "gen_cpp/TPaloBrokerService.h"
 #include "olap/page_cache.h"
+#include "olap/rowset/segment_v2/decoded_page_cache.h"
+#include "olap/segment_cache.h"
 #include "olap/storage_engine.h"
 #include "plugin/plugin_mgr.h"
 #include "runtime/broker_mgr.h"
@@ -42,11 +45,15 @@
 #include "runtime/heartbeat_flags.h"
 #include "runtime/load_channel_mgr.h"
 #include "runtime/load_path_mgr.h"
+#include "runtime/mem_admission_controller.h"
+#include "runtime/resource_group_mgr.h"
 #include "runtime/mem_tracker.h"
 #include "runtime/result_buffer_mgr.h"
 #include "runtime/result_queue_mgr.h"
 #include "runtime/routine_load/routine_load_task_executor.h"
+#include "runtime/shared_hash_table_mgr.h"
 #include "runtime/small_file_mgr.h"
+#include "runtime/stream_load/group_commit_mgr.h"
 #include "runtime/stream_load/load_stream_mgr.h"
 #include "runtime/stream_load/stream_load_executor.h"
 #include "runtime/thread_resource_mgr.h"
@@ -55,6 +62,7 @@
 #include "util/brpc_stub_cache.h"
 #include "util/debug_util.h"
 #include "util/doris_metrics.h"
+#include "util/fair_thread_pool.h"
 #include "util/mem_info.h"
 #include "util/metrics.h"
 #include "util/network_util.h"
@@ -64,6 +72,9 @@
 
 namespace doris {
 
+DEFINE_GAUGE_METRIC_PROTOTYPE_2ARG(scanner_thread_pool_queue_size, MetricUnit::NOUNIT);
+DEFINE_GAUGE_METRIC_PROTOTYPE_2ARG(broker_scanner_thread_pool_queue_size, MetricUnit::NOUNIT);
+
 Status ExecEnv::init(ExecEnv* env, const std::vector<StorePath>& store_paths) {
     return env->_init(store_paths);
 }
@@ -78,6 +89,7 @@ Status ExecEnv::_init(const std::vector<StorePath>& store_paths) {
     _stream_mgr = new DataStreamMgr();
     _result_mgr = new ResultBufferMgr();
     _result_queue_mgr = new ResultQueueMgr();
+    _shared_hash_table_mgr = new SharedHashTableMgr();
     _backend_client_cache = new BackendServiceClientCache(config::max_client_cache_size_per_host);
     _frontend_client_cache = new FrontendServiceClientCache(config::max_client_cache_size_per_host);
     _broker_client_cache = new BrokerServiceClientCache(config::max_client_cache_size_per_host);
@@ -85,8 +97,17 @@ Status ExecEnv::_init(const std::vector<StorePath>& store_paths) {
             new ExtDataSourceServiceClientCache(config::max_client_cache_size_per_host);
     _pool_mem_trackers = new PoolMemTrackerRegistry();
     _thread_mgr = new ThreadResourceMgr();
-    _thread_pool = new PriorityThreadPool(config::doris_scanner_thread_pool_thread_num,
-                                          config::doris_scanner_thread_pool_queue_size);
+    _scan_thread_pool = new FairThreadPool(config::doris_scanner_thread_pool_thread_num,
+                                           config::doris_scanner_thread_pool_queue_size);
+    REGISTER_HOOK_METRIC(scanner_thread_pool_queue_size,
+                         [this]() { return _scan_thread_pool->get_queue_size(); });
+    if (config::broker_scanner_thread_pool_thread_num > 0) {
+        _broker_scan_thread_pool =
+                new FairThreadPool(config::broker_scanner_thread_pool_thread_num,
+                                   config::broker_scanner_thread_pool_queue_size);
+        REGISTER_HOOK_METRIC(broker_scanner_thread_pool_queue_size,
+                             [this]() { return _broker_scan_thread_pool->get_queue_size(); });
+    }
     _etl_thread_pool = new PriorityThreadPool(config::etl_thread_pool_size,
                                               config::etl_thread_pool_queue_size);
     _cgroups_mgr = new CgroupsMgr(this, config::doris_cgroups);
@@ -103,6 +124,7 @@ Status ExecEnv::_init(const std::vector<StorePath>& store_paths) {
     _load_stream_mgr = new LoadStreamMgr();
     _brpc_stub_cache = new BrpcStubCache();
     _stream_load_executor = new StreamLoadExecutor(this);
+    _group_commit_mgr = new GroupCommitMgr(this);
     _routine_load_task_executor = new RoutineLoadTaskExecutor(this);
     _small_file_mgr = new SmallFileMgr(this, config::small_file_dir);
     _plugin_mgr = new PluginMgr();
@@ -112,7 +134,7 @@ Status ExecEnv::_init(const std::vector<StorePath>& store_paths) {
     _broker_client_cache->init_metrics("broker");
     _extdatasource_client_cache->init_metrics("extdatasource");
     _result_mgr->init();
-    _cgroups_mgr->init_cgroups();
+    bool cgroups_available = _cgroups_mgr->init_cgroups() == AgentStatus::DORIS_SUCCESS;
     _etl_job_mgr->init();
     Status status = _load_path_mgr->init();
     if (!status.ok()) {
@@ -121,7 +143,11 @@ Status ExecEnv::_init(const std::vector<StorePath>& store_paths) {
     }
     _broker_mgr->init();
     _small_file_mgr->init();
+    RETURN_IF_ERROR(_group_commit_mgr->init());
     _init_mem_tracker();
+    _resource_group_mgr = new ResourceGroupMgr();
+    RETURN_IF_ERROR(_resource_group_mgr->init(config::resource_groups, _mem_tracker,
+                                              cgroups_available ? _cgroups_mgr : nullptr));
 
     RETURN_IF_ERROR(_load_channel_mgr->init(_mem_tracker->limit()));
     _heartbeat_flags = new HeartbeatFlags();
@@ -181,6 +207,7 @@ Status ExecEnv::_init_mem_tracker() {
 
     _mem_tracker =
             MemTracker::CreateTracker(bytes_limit, "ExecEnv root", MemTracker::GetRootTracker());
+    _mem_admission_controller = new MemAdmissionController(_mem_tracker);
 
     LOG(INFO) << "Using global memory limit: " << PrettyPrinter::print(bytes_limit, TUnit::BYTES);
     RETURN_IF_ERROR(_disk_io_mgr->init(_mem_tracker));
@@ -192,7 +219,34 @@ Status ExecEnv::_init_mem_tracker() {
         LOG(WARNING) << "Config storage_page_cache_limit is greater than memory size, config="
                      << config::storage_page_cache_limit << ", memory=" << MemInfo::physical_mem();
     }
-    StoragePageCache::create_global_cache(storage_cache_limit);
+    int32_t index_page_cache_percentage = config::index_page_cache_percentage;
+    if (index_page_cache_percentage < 0 || index_page_cache_percentage > 100) {
+        LOG(WARNING) << "Config index_page_cache_percentage should be in [0, 100], config="
+                     << index_page_cache_percentage << ", use 10 instead";
+        index_page_cache_percentage = 10;
+    }
+    StoragePageCache::create_global_cache(storage_cache_limit, index_page_cache_percentage);
+
+    int64_t segment_cache_limit =
+            ParseUtil::parse_mem_spec(config::segment_cache_limit, &is_percent);
+    if (segment_cache_limit < 0) {
+        LOG(WARNING) << "Config segment_cache_limit is invalid, config="
+                     << config::segment_cache_limit << ", use 2G instead";
+        segment_cache_limit = 2L * 1024 * 1024 * 1024;
+    }
+    SegmentCache::create_global_cache(segment_cache_limit);
+
+    int64_t agg_result_cache_limit =
+            ParseUtil::parse_mem_spec(config::agg_result_cache_limit, &is_percent);
+    if (agg_result_cache_limit > 0) {
+        AggResultCache::create_global_cache(agg_result_cache_limit);
+    }
+
+    int64_t decoded_page_cache_limit =
+            ParseUtil::parse_mem_spec(config::decoded_page_cache_limit, &is_percent);
+    if (decoded_page_cache_limit > 0) {
+        segment_v2::DecodedPageCache::create_global_cache(decoded_page_cache_limit);
+    }
 
     // TODO(zc): The current memory usage configuration is a bit confusing,
     // we need to sort out the use of memory
@@ -212,6 +266,7 @@ void ExecEnv::_destroy() {
     if (!_is_init) {
         return;
     }
+    SAFE_DELETE(_group_commit_mgr);
     SAFE_DELETE(_brpc_stub_cache);
     SAFE_DELETE(_load_stream_mgr);
     SAFE_DELETE(_load_channel_mgr);
@@ -225,7 +280,13 @@ void ExecEnv::_destroy() {
     SAFE_DELETE(_fragment_mgr);
     SAFE_DELETE(_cgroups_mgr);
     SAFE_DELETE(_etl_thread_pool);
-    SAFE_DELETE(_thread_pool);
+    SAFE_DELETE(_resource_group_mgr);
+    DEREGISTER_HOOK_METRIC(scanner_thread_pool_queue_size);
+    SAFE_DELETE(_scan_thread_pool);
+    if (_broker_scan_thread_pool != nullptr) {
+        DEREGISTER_HOOK_METRIC(broker_scanner_thread_pool_queue_size);
+        SAFE_DELETE(_broker_scan_thread_pool);
+    }
     SAFE_DELETE(_thread_mgr);
     SAFE_DELETE(_pool_mem_trackers);
     SAFE_DELETE(_broker_client_cache);
@@ -234,6 +295,7 @@ void ExecEnv::_destroy() {
     SAFE_DELETE(_backend_client_cache);
     SAFE_DELETE(_result_mgr);
     SAFE_DELETE(_result_queue_mgr);
+    SAFE_DELETE(_shared_hash_table_mgr);
     SAFE_DELETE(_stream_mgr);
     SAFE_DELETE(_stream_load_executor);
     SAFE_DELETE(_routine_load_task_executor);
@@ -17,12 +17,16 @@
 
 #include "runtime/external_scan_context_mgr.h"
 
+#include <arrow/record_batch.h>
+
 #include <chrono>
 #include <functional>
 #include <vector>
 
+#include "gutil/strings/substitute.h"
 #include "runtime/fragment_mgr.h"
 #include "runtime/result_queue_mgr.h"
+#include "util/arrow/row_batch.h"
 #include "util/doris_metrics.h"
 #include "util/uid_util.h"
 
@@ -105,6 +109,60 @@ Status ExternalScanContextMgr::clear_scan_context(const std::string& context_id)
     return Status::OK();
 }
 
+Status ExternalScanContextMgr::open_scanner(const TScanOpenParams& params, std::string* context_id,
+                                            std::vector<TScanColumnDesc>* selected_columns) {
+    TUniqueId fragment_instance_id = generate_uuid();
+    std::shared_ptr<ScanContext> p_context;
+    create_scan_context(&p_context);
+    p_context->fragment_instance_id = fragment_instance_id;
+    p_context->offset = 0;
+    p_context->last_access_time = time(NULL);
+    if (params.__isset.keep_alive_min) {
+        p_context->keep_alive_min = params.keep_alive_min;
+    } else {
+        p_context->keep_alive_min = 5;
+    }
+    *context_id = p_context->context_id;
+    // start the scan procedure
+    return _exec_env->fragment_mgr()->exec_external_plan_fragment(params, fragment_instance_id,
+                                                                  selected_columns);
+}
+
+// fetch result from polling the queue, should always maintain the context offset, otherwise
+// inconsistent result
+Status ExternalScanContextMgr::get_next(const std::string& context_id, int64_t offset, bool* eos,
+                                        std::string* rows) {
+    std::shared_ptr<ScanContext> context;
+    RETURN_IF_ERROR(get_scan_context(context_id, &context));
+    if (offset != context->offset) {
+        LOG(ERROR) << "getNext error: context offset [" << context->offset << " ]"
+                   << " ,client offset [ " << offset << " ]";
+        // invalid offset
+        return Status::NotFound(
+                strings::Substitute("context_id=$0, send_offset=$1, context_offset=$2",
+                                    context_id, offset, context->offset));
+    }
+    // during accessing, should disabled last_access_time
+    context->last_access_time = -1;
+    TUniqueId fragment_instance_id = context->fragment_instance_id;
+    std::shared_ptr<arrow::RecordBatch> record_batch;
+    Status st = _exec_env->result_queue_mgr()->fetch_result(fragment_instance_id, &record_batch,
+                                                            eos);
+    if (st.ok()) {
+        if (!*eos) {
+            st = serialize_record_batch(*record_batch, rows);
+            if (st.ok()) {
+                context->offset += record_batch->num_rows();
+            }
+        }
+    } else {
+        LOG(WARNING) << "fragment_instance_id [" << print_id(fragment_instance_id)
+                     << "] fetch result status [" << st.to_string() + "]";
+    }
+    context->last_access_time = time(NULL);
+    return st;
+}
+
 void ExternalScanContextMgr::gc_expired_context() {
 #ifndef BE_TEST
     while (!_stop_background_threads_latch.wait_for(
@@ -25,8 +25,10 @@
 #include <string>
 #include <thread>
 #include <utility>
+#include <vector>
 
 #include "common/status.h"
+#include "gen_cpp/DorisExternalService_types.h"
 #include "gen_cpp/Types_types.h"
 #include "gutil/ref_counted.h"
 #include "runtime/exec_env.h"
@@ -60,6 +62,16 @@ public:
 
     Status clear_scan_context(const std::string& context_id);
 
+    // Starts the scan of 'params' in a new context. Shared by the thrift and the brpc
+    // services of the external scans.
+    Status open_scanner(const TScanOpenParams& params, std::string* context_id,
+                        std::vector<TScanColumnDesc>* selected_columns);
+
+    // Fetches the next batch of the scan of 'context_id' as a serialized arrow record batch
+    // into 'rows', unless the scan reached its end. 'offset' must be the number of rows
+    // fetched before, so that a retried call is detected. Blocks until a batch is ready.
+    Status get_next(const std::string& context_id, int64_t offset, bool* eos, std::string* rows);
+
 private:
     ExecEnv* _exec_env;
     std::map<std::string, std::shared_ptr<ScanContext>> _active_contexts;
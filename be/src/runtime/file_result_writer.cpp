@@ -42,7 +42,10 @@ FileResultWriter::FileResultWriter(const ResultFileOptions* file_opts,
           _parent_profile(parent_profile) {}
 
 FileResultWriter::~FileResultWriter() {
-    _close_file_writer(true);
+    // close() isn't called on errors. The profile may already be gone, so just release the
+    // writers, they close their files when deleted.
+    delete _parquet_writer;
+    delete _file_writer;
 }
 
 Status FileResultWriter::init(RuntimeState* state) {
@@ -80,6 +83,7 @@ Status FileResultWriter::_create_file_writer() {
         break;
     case TFileFormatType::FORMAT_PARQUET:
         _parquet_writer = new ParquetWriterWrapper(_file_writer, _output_expr_ctxs);
+        RETURN_IF_ERROR(_parquet_writer->init());
         break;
     default:
         return Status::InternalError(
@@ -115,7 +119,14 @@ Status FileResultWriter::append_row_batch(const RowBatch* batch) {
 
     SCOPED_TIMER(_append_row_batch_timer);
     if (_parquet_writer != nullptr) {
-        RETURN_IF_ERROR(_parquet_writer->write(*batch));
+        {
+            SCOPED_TIMER(_convert_tuple_timer);
+            RETURN_IF_ERROR(_parquet_writer->write(*batch));
+        }
+        int64_t written_len = _parquet_writer->written_len();
+        COUNTER_UPDATE(_written_data_bytes, written_len - _current_written_bytes);
+        _current_written_bytes = written_len;
+        RETURN_IF_ERROR(_create_new_file_if_exceed_size());
     } else {
         RETURN_IF_ERROR(_write_csv_file(*batch));
     }
@@ -291,18 +302,21 @@ Status FileResultWriter::_create_new_file_if_exceed_size() {
 }
 
 Status FileResultWriter::_close_file_writer(bool done) {
+    Status st;
     if (_parquet_writer != nullptr) {
-        _parquet_writer->close();
+        // writes the rest of the rows and the footer
+        st = _parquet_writer->close();
+        COUNTER_UPDATE(_written_data_bytes,
+                       _parquet_writer->written_len() - _current_written_bytes);
         delete _parquet_writer;
         _parquet_writer = nullptr;
-        if (!done) {
-            //TODO(cmy): implement parquet writer later
-        }
-    } else if (_file_writer != nullptr) {
+    }
+    if (_file_writer != nullptr) {
         _file_writer->close();
         delete _file_writer;
         _file_writer = nullptr;
     }
+    RETURN_IF_ERROR(st);
 
     if (!done) {
         // not finished, create new file writer for next file
@@ -312,11 +326,6 @@ Status FileResultWriter::_close_file_writer(bool done) {
 }
 
 Status FileResultWriter::close() {
-    // the following 2 profile "_written_rows_counter" and "_writer_close_timer"
-    // must be outside the `_close_file_writer()`.
-    // because `_close_file_writer()` may be called in deconstructor,
-    // at that time, the RuntimeState may already been deconstructed,
-    // so does the profile in RuntimeState.
     COUNTER_SET(_written_rows_counter, _written_rows);
     SCOPED_TIMER(_writer_close_timer);
     RETURN_IF_ERROR(_close_file_writer(true));
@@ -94,8 +94,8 @@ private:
     const ResultFileOptions* _file_opts;
     const std::vector<ExprContext*>& _output_expr_ctxs;
 
-    // If the result file format is plain text, like CSV, this _file_writer is owned by this FileResultWriter.
-    // If the result file format is Parquet, this _file_writer is owned by _parquet_writer.
+    // owned by this FileResultWriter. If the result file format is Parquet, the data is written
+    // into it by _parquet_writer.
     FileWriter* _file_writer = nullptr;
     // parquet file writer
     ParquetWriterWrapper* _parquet_writer = nullptr;
@@ -17,6 +17,8 @@
 
 #include "runtime/fragment_mgr.h"
 
+#include "service/brpc.h"
+
 #include <gperftools/profiler.h>
 #include <thrift/protocol/TDebugProtocol.h>
 
@@ -215,7 +217,10 @@ Status FragmentExecState::execute() {
     int64_t duration_ns = 0;
     {
         SCOPED_RAW_TIMER(&duration_ns);
-        CgroupsMgr::apply_system_cgroup();
+        if (bthread_self() == 0) {
+            // don't move the brpc workers running this as a bthread
+            CgroupsMgr::apply_system_cgroup();
+        }
         WARN_IF_ERROR(_executor.open(), strings::Substitute("Got error while opening fragment $0",
                                                             print_id(_fragment_instance_id)));
         _executor.close();
@@ -418,6 +423,27 @@ FragmentMgr::~FragmentMgr() {
 
 static void empty_function(PlanFragmentExecutor* exec) {}
 
+static void* run_in_bthread(void* arg) {
+    std::unique_ptr<std::function<void()>> func(static_cast<std::function<void()>*>(arg));
+    (*func)();
+    return nullptr;
+}
+
+Status FragmentMgr::_submit(std::function<void()> func) {
+    if (!config::fragment_exec_in_bthread) {
+        return _thread_pool->submit_func(std::move(func));
+    }
+    // the plans may recurse deeply, so use the large stacks
+    auto arg = new std::function<void()>(std::move(func));
+    bthread_t tid;
+    int err = bthread_start_background(&tid, &BTHREAD_ATTR_LARGE, run_in_bthread, arg);
+    if (err != 0) {
+        delete arg;
+        return Status::InternalError(strings::Substitute("Failed to start bthread: $0", err));
+    }
+    return Status::OK();
+}
+
 void FragmentMgr::_exec_actual(std::shared_ptr<FragmentExecState> exec_state, FinishCallback cb) {
     exec_state->execute();
 
@@ -521,8 +547,7 @@ Status FragmentMgr::exec_plan_fragment(const TExecPlanFragmentParams& params, Fi
         _fragment_map.insert(std::make_pair(params.params.fragment_instance_id, exec_state));
     }
 
-    auto st = _thread_pool->submit_func(
-            std::bind<void>(&FragmentMgr::_exec_actual, this, exec_state, cb));
+    auto st = _submit(std::bind<void>(&FragmentMgr::_exec_actual, this, exec_state, cb));
     if (!st.ok()) {
         {
             // Remove the exec state added
@@ -537,6 +562,17 @@ Status FragmentMgr::exec_plan_fragment(const TExecPlanFragmentParams& params, Fi
     return Status::OK();
 }
 
+Status FragmentMgr::exec_plan_fragments(TExecPlanFragmentParamsList* params_list) {
+    std::vector<TExecPlanFragmentParams>& params = params_list->paramsList;
+    for (int i = 0; i < params.size(); ++i) {
+        if (!params[i].__isset.fragment && i > 0) {
+            params[i].__set_fragment(params[0].fragment);
+        }
+        RETURN_IF_ERROR(exec_plan_fragment(params[i]));
+    }
+    return Status::OK();
+}
+
 Status FragmentMgr::cancel(const TUniqueId& fragment_id, const PPlanFragmentCancelReason& reason) {
     std::shared_ptr<FragmentExecState> exec_state;
     {
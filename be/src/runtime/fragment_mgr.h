@@ -45,6 +45,7 @@ class PlanFragmentExecutor;
 class ThreadPool;
 class TExecPlanFragmentParams;
 class TExecPlanFragmentParamsList;
+class TExecPlanFragmentParamsList;
 class TUniqueId;
 
 std::string to_load_error_http_path(const std::string& file_name);
@@ -63,6 +64,11 @@ public:
     // TODO(zc): report this is over
     Status exec_plan_fragment(const TExecPlanFragmentParams& params, FinishCallback cb);
 
+    // Executes the instances in 'params_list' in order, the ones without a fragment get
+    // the one of the first instance. Stops at the first one that fails, the coordinator
+    // cancels the started ones then.
+    Status exec_plan_fragments(TExecPlanFragmentParamsList* params_list);
+
     Status cancel(const TUniqueId& fragment_id) {
         return cancel(fragment_id, PPlanFragmentCancelReason::INTERNAL_ERROR);
     }
@@ -85,6 +91,9 @@ public:
 private:
     void _exec_actual(std::shared_ptr<FragmentExecState> exec_state, FinishCallback cb);
 
+    // Runs 'func' on _thread_pool, or in a bthread if config::fragment_exec_in_bthread.
+    Status _submit(std::function<void()> func);
+
     // This is input params
     ExecEnv* _exec_env;
 
@@ -35,22 +35,49 @@ namespace doris {
 const __int128 MAX_INT128 = ~((__int128)0x01 << 127);
 const __int128 MIN_INT128 = ((__int128)0x01 << 127);
 
+// Divide 'value' by 'divisor' of 64 bits and set the remainder to '*remainder'. The division
+// of __int128 is a call of __udivti3 which is much slower, while it's one or two divisions of
+// 64 bits here.
+inline unsigned __int128 div_mod_uint64(unsigned __int128 value, uint64_t divisor,
+                                        uint64_t* remainder) {
+    uint64_t high = static_cast<uint64_t>(value >> 64);
+    uint64_t low = static_cast<uint64_t>(value);
+    if (high == 0) {
+        *remainder = low % divisor;
+        return low / divisor;
+    }
+#if defined(__x86_64__)
+    uint64_t quotient_high = high / divisor;
+    uint64_t quotient_low;
+    // the high part of the dividend is less than 'divisor', so the quotient fits 64 bits
+    __asm__("divq %4"
+            : "=a"(quotient_low), "=d"(*remainder)
+            : "0"(low), "1"(high % divisor), "r"(divisor));
+    return (static_cast<unsigned __int128>(quotient_high) << 64) | quotient_low;
+#else
+    *remainder = static_cast<uint64_t>(value % divisor);
+    return value / divisor;
+#endif
+}
+
 class LargeIntValue {
 public:
+    // 10^19, the max power of 10 in 64 bits
+    static const uint64_t TEN_POW_19 = 10000000000000000000ULL;
+
     static char* to_string(__int128 value, char* buffer, int* len) {
         DCHECK(*len >= 40);
-        unsigned __int128 tmp = value < 0 ? -value : value;
-        char* d = buffer + *len;
-        do {
-            --d;
-            *d = "0123456789"[tmp % 10];
-            tmp /= 10;
-        } while (tmp != 0);
+        unsigned __int128 tmp = static_cast<unsigned __int128>(value);
+        if (value < 0) {
+            tmp = -tmp;
+        }
+        char* end = buffer + *len;
+        char* d = write_digits(tmp, end);
         if (value < 0) {
             --d;
             *d = '-';
         }
-        *len = (buffer + *len) - d;
+        *len = end - d;
         return d;
     }
 
@@ -60,6 +87,48 @@ public:
         char* str = to_string(value, buf, &len);
         return std::string(str, len);
     }
+
+    // Write the decimal digits of 'value' backward from 'end' and return the first one.
+    // 19 digits are split at a time, so only the values of more than 64 bits divide __int128.
+    static char* write_digits(unsigned __int128 value, char* end) {
+        char* d = end;
+        while ((value >> 64) != 0) {
+            uint64_t digits;
+            value = div_mod_uint64(value, TEN_POW_19, &digits);
+            d = write_digits(static_cast<uint64_t>(digits), d, 19);
+        }
+        return write_digits(static_cast<uint64_t>(value), d, 1);
+    }
+
+    // Write the decimal digits of 'value' backward from 'end', two digits at a time, and pad
+    // them with '0' to 'min_digits'. Return the first digit written.
+    static char* write_digits(uint64_t value, char* end, int min_digits) {
+        static const char kDigitPairs[] =
+                "0001020304050607080910111213141516171819"
+                "2021222324252627282930313233343536373839"
+                "4041424344454647484950515253545556575859"
+                "6061626364656667686970717273747576777879"
+                "8081828384858687888990919293949596979899";
+        char* d = end;
+        while (value >= 100) {
+            uint64_t pair = value % 100;
+            value /= 100;
+            d -= 2;
+            memcpy(d, kDigitPairs + pair * 2, 2);
+        }
+        if (value >= 10) {
+            d -= 2;
+            memcpy(d, kDigitPairs + value * 2, 2);
+        } else {
+            --d;
+            *d = static_cast<char>('0' + value);
+        }
+        while (end - d < min_digits) {
+            --d;
+            *d = '0';
+        }
+        return d;
+    }
 };
 
 std::ostream& operator<<(std::ostream& os, __int128 const& value);
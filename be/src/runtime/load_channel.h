@@ -21,6 +21,7 @@
 #include <ostream>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include "common/status.h"
 #include "gen_cpp/PaloInternalService_types.h"
@@ -66,6 +67,10 @@ public:
 
     int64_t mem_consumption() const { return _mem_tracker->consumption(); }
 
+    // append all tablets channels of this load channel to 'channels'. The channel of an
+    // index is removed once all its senders are closed, so none of them is finished.
+    void get_tablets_channels(std::vector<std::shared_ptr<TabletsChannel>>* channels);
+
     int64_t timeout() const { return _timeout_s; }
 
 private:
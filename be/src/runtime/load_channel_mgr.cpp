@@ -17,6 +17,8 @@
 
 #include "runtime/load_channel_mgr.h"
 
+#include <algorithm>
+
 #include "gutil/strings/substitute.h"
 #include "olap/lru_cache.h"
 #include "runtime/load_channel.h"
@@ -170,25 +172,69 @@ void LoadChannelMgr::_handle_mem_exceed_limit() {
         return;
     }
 
-    int64_t max_consume = 0;
-    std::shared_ptr<LoadChannel> channel;
+    // Reduce the consumption down to the low water mark instead of just below the limit,
+    // otherwise the limit is hit again after a few batches and each time only a little
+    // data is flushed.
+    int64_t low_water_mark = _mem_tracker->limit() * config::load_process_low_water_percent / 100;
+    int64_t mem_to_reduce = _mem_tracker->consumption() - low_water_mark;
+
+    struct MemTableItem {
+        std::shared_ptr<TabletsChannel> channel;
+        int64_t tablet_id;
+        int64_t consumption;
+    };
+    std::vector<MemTableItem> memtables;
+    std::vector<std::shared_ptr<TabletsChannel>> tablets_channels;
     for (auto& kv : _load_channels) {
-        if (kv.second->mem_consumption() > max_consume) {
-            max_consume = kv.second->mem_consumption();
-            channel = kv.second;
+        kv.second->get_tablets_channels(&tablets_channels);
+    }
+    std::vector<std::pair<int64_t, int64_t>> consumptions;
+    for (auto& channel : tablets_channels) {
+        consumptions.clear();
+        channel->get_memtable_consumptions(&consumptions);
+        for (auto& it : consumptions) {
+            memtables.push_back({channel, it.first, it.second});
         }
     }
-    if (max_consume == 0) {
-        // should not happen, add log to observe
-        LOG(WARNING) << "failed to find suitable load channel when total load mem limit exceed";
+    if (memtables.empty()) {
+        // all memory is held by memtables being flushed, or by batches being added
+        LOG(WARNING) << "failed to find memtable to flush when total load mem limit exceed";
         return;
     }
-    DCHECK(channel.get() != nullptr);
 
-    // force reduce mem limit of the selected channel
-    LOG(INFO) << "reducing memory of " << *channel << " because total load mem consumption "
-              << _mem_tracker->consumption() << " has exceeded limit " << _mem_tracker->limit();
-    channel->handle_mem_exceed_limit(true);
+    // flush the largest memtables first, so that the segments written are as large as possible
+    std::sort(memtables.begin(), memtables.end(),
+              [](const MemTableItem& lhs, const MemTableItem& rhs) {
+                  return lhs.consumption > rhs.consumption;
+              });
+    std::unordered_map<TabletsChannel*, std::vector<int64_t>> tablets_to_flush;
+    int64_t mem_to_flush = 0;
+    int num_to_flush = 0;
+    for (auto& item : memtables) {
+        tablets_to_flush[item.channel.get()].push_back(item.tablet_id);
+        mem_to_flush += item.consumption;
+        ++num_to_flush;
+        if (mem_to_flush >= mem_to_reduce) {
+            break;
+        }
+    }
+
+    LOG(INFO) << "flushing " << num_to_flush << " memtables of " << mem_to_flush
+              << " bytes because total load mem consumption " << _mem_tracker->consumption()
+              << " has exceeded limit " << _mem_tracker->limit();
+    // submit all memtables before waiting any of them, so that they are flushed concurrently
+    for (auto& it : tablets_to_flush) {
+        auto st = it.first->flush_memtables(it.second);
+        if (!st.ok()) {
+            LOG(WARNING) << st.get_error_msg();
+        }
+    }
+    for (auto& it : tablets_to_flush) {
+        auto st = it.first->wait_flush(it.second);
+        if (!st.ok()) {
+            LOG(WARNING) << st.get_error_msg();
+        }
+    }
 }
 
 Status LoadChannelMgr::cancel(const PTabletWriterCancelRequest& params) {
@@ -59,7 +59,8 @@ public:
 
 private:
     // check if the total load mem consumption exceeds limit.
-    // If yes, it will pick a load channel to try to reduce memory consumption.
+    // If yes, it will flush the largest memtables of all load channels, until the
+    // consumption falls to config::load_process_low_water_percent of the limit.
     void _handle_mem_exceed_limit();
 
     Status _start_bg_worker();
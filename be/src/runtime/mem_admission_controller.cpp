@@ -0,0 +1,206 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "runtime/mem_admission_controller.h"
+
+#include <algorithm>
+#include <chrono>
+#include <sstream>
+#include <vector>
+
+#include "common/config.h"
+#include "common/logging.h"
+#include "runtime/buffered_block_mgr2.h"
+#include "runtime/initial_reservations.h"
+#include "runtime/mem_tracker.h"
+#include "runtime/runtime_state.h"
+#include "util/doris_metrics.h"
+#include "util/pretty_printer.h"
+#include "util/stopwatch.hpp"
+
+namespace doris {
+
+DEFINE_GAUGE_METRIC_PROTOTYPE_2ARG(fragment_admission_waiting, MetricUnit::NOUNIT);
+DEFINE_COUNTER_METRIC_PROTOTYPE_2ARG(fragment_admission_timeout_total, MetricUnit::NOUNIT);
+DEFINE_COUNTER_METRIC_PROTOTYPE_2ARG(fragment_admission_revoked_bytes, MetricUnit::BYTES);
+
+// The waiting instances also retry at this interval, memory may be released by others
+// than the admitted instances, e.g. loads and caches.
+static const int64_t ADMISSION_RETRY_INTERVAL_MS = 100;
+
+MemAdmissionController::MemAdmissionController(
+        const std::shared_ptr<MemTracker>& process_mem_tracker) {
+    auto entity = DorisMetrics::instance()->server_entity();
+    INT_GAUGE_METRIC_REGISTER(entity, fragment_admission_waiting);
+    INT_COUNTER_METRIC_REGISTER(entity, fragment_admission_timeout_total);
+    INT_COUNTER_METRIC_REGISTER(entity, fragment_admission_revoked_bytes);
+    process_mem_tracker->AddGcFunction(
+            [this](int64_t bytes_to_free) { revoke(bytes_to_free, -1); });
+}
+
+MemAdmissionController::~MemAdmissionController() {
+    auto entity = DorisMetrics::instance()->server_entity();
+    METRIC_DEREGISTER(entity, fragment_admission_waiting);
+    METRIC_DEREGISTER(entity, fragment_admission_timeout_total);
+    METRIC_DEREGISTER(entity, fragment_admission_revoked_bytes);
+}
+
+Status MemAdmissionController::admit(RuntimeState* state) {
+    const TUniqueId& instance_id = state->fragment_instance_id();
+    int64_t timeout_ms = config::fragment_admission_timeout_ms;
+    std::unique_lock<std::mutex> l(_lock);
+    int64_t query_seq = _add_query_instance(state->query_id());
+    if (timeout_ms <= 0) {
+        l.unlock();
+        Status status = _try_reserve(state, query_seq);
+        l.lock();
+        if (status.ok()) {
+            _add_instance(state);
+        } else {
+            _remove_query_instance(state->query_id());
+        }
+        return status;
+    }
+
+    MonotonicStopWatch watch;
+    watch.start();
+    _waiters.push_back(instance_id);
+    fragment_admission_waiting->increment(1);
+    Status status;
+    while (true) {
+        if (_waiters.front() == instance_id) {
+            l.unlock();
+            status = _try_reserve(state, query_seq);
+            l.lock();
+            if (status.ok()) {
+                break;
+            }
+        }
+        int64_t elapsed_ms = watch.elapsed_time() / 1000000;
+        if (state->is_cancelled()) {
+            status = Status::Cancelled("Cancelled while waiting for admission");
+            break;
+        }
+        if (elapsed_ms >= timeout_ms) {
+            fragment_admission_timeout_total->increment(1);
+            std::stringstream ss;
+            ss << "Fragment instance " << print_id(instance_id) << " was not admitted in "
+               << timeout_ms << "ms: initial reservation of "
+               << PrettyPrinter::print(state->min_reservation(), TUnit::BYTES)
+               << " unavailable";
+            if (!status.ok()) {
+                ss << ", " << status.get_error_msg();
+            }
+            status = Status::MemoryLimitExceeded(ss.str());
+            break;
+        }
+        int64_t wait_ms = std::min(timeout_ms - elapsed_ms, ADMISSION_RETRY_INTERVAL_MS);
+        _cv.wait_for(l, std::chrono::milliseconds(wait_ms));
+    }
+
+    _waiters.erase(std::find(_waiters.begin(), _waiters.end(), instance_id));
+    fragment_admission_waiting->increment(-1);
+    if (status.ok()) {
+        _add_instance(state);
+    } else {
+        _remove_query_instance(state->query_id());
+    }
+    _cv.notify_all();
+    return status;
+}
+
+Status MemAdmissionController::_try_reserve(RuntimeState* state, int64_t query_seq) {
+    InitialReservations* reservations = state->initial_reservations();
+    int64_t min_reservation = state->min_reservation();
+    Status status = reservations->Init(state->query_id(), min_reservation);
+    if (!status.ok() && revoke(min_reservation, query_seq) > 0) {
+        status = reservations->Init(state->query_id(), min_reservation);
+    }
+    return status;
+}
+
+void MemAdmissionController::release(const TUniqueId& fragment_instance_id) {
+    std::lock_guard<std::mutex> l(_lock);
+    auto it = _instances.find(fragment_instance_id);
+    if (it == _instances.end()) {
+        return;
+    }
+    _remove_query_instance(it->second.query_id);
+    _instances.erase(it);
+    _cv.notify_all();
+}
+
+void MemAdmissionController::_add_instance(RuntimeState* state) {
+    Instance& instance = _instances[state->fragment_instance_id()];
+    instance.query_id = state->query_id();
+    instance.block_mgr = state->shared_block_mgr2();
+}
+
+int64_t MemAdmissionController::revoke(int64_t bytes, int64_t query_seq) {
+    // The buffers are freed without holding _lock, the block mgrs are taken out of it.
+    std::vector<std::pair<int64_t, boost::shared_ptr<BufferedBlockMgr2>>> block_mgrs;
+    {
+        std::lock_guard<std::mutex> l(_lock);
+        for (auto& it : _instances) {
+            int64_t seq = _queries[it.second.query_id].seq;
+            if (seq <= query_seq) {
+                continue;
+            }
+            boost::shared_ptr<BufferedBlockMgr2> block_mgr = it.second.block_mgr.lock();
+            if (block_mgr != nullptr) {
+                block_mgrs.emplace_back(seq, block_mgr);
+            }
+        }
+    }
+    std::sort(block_mgrs.begin(), block_mgrs.end(),
+              [](const std::pair<int64_t, boost::shared_ptr<BufferedBlockMgr2>>& a,
+                 const std::pair<int64_t, boost::shared_ptr<BufferedBlockMgr2>>& b) {
+                  return a.first > b.first;
+              });
+    int64_t freed = 0;
+    for (auto& block_mgr : block_mgrs) {
+        if (freed >= bytes) {
+            break;
+        }
+        freed += block_mgr.second->release_free_buffers(bytes - freed);
+    }
+    if (freed > 0) {
+        fragment_admission_revoked_bytes->increment(freed);
+        VLOG_QUERY << "Revoked " << PrettyPrinter::print(freed, TUnit::BYTES)
+                   << " from the queries after #" << query_seq;
+    }
+    return freed;
+}
+
+int64_t MemAdmissionController::_add_query_instance(const TUniqueId& query_id) {
+    auto it = _queries.find(query_id);
+    if (it == _queries.end()) {
+        it = _queries.emplace(query_id, Query{_next_query_seq++, 0}).first;
+    }
+    ++it->second.num_instances;
+    return it->second.seq;
+}
+
+void MemAdmissionController::_remove_query_instance(const TUniqueId& query_id) {
+    auto it = _queries.find(query_id);
+    DCHECK(it != _queries.end());
+    if (--it->second.num_instances == 0) {
+        _queries.erase(it);
+    }
+}
+
+} // namespace doris
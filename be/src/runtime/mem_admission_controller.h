@@ -0,0 +1,116 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <boost/shared_ptr.hpp>
+#include <boost/weak_ptr.hpp>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "common/status.h"
+#include "gen_cpp/Types_types.h"
+#include "util/metrics.h"
+#include "util/uid_util.h"
+
+namespace doris {
+
+class BufferedBlockMgr2;
+class MemTracker;
+class RuntimeState;
+
+// Admits the fragment instances of this backend by their initial buffer reservation and
+// frees memory of the running ones when the process runs out of it.
+//
+// An instance is admitted once the initial reservation of its query, see
+// InitialReservations, is taken from the process ReservationTracker, which also counts
+// it against the process mem tracker. Instead of failing right away, the instances that
+// don't fit wait in FIFO order until enough memory is released, up to
+// config::fragment_admission_timeout_ms.
+//
+// Queries are prioritized by arrival: a query whose first instance came later has a lower
+// priority. When the process mem tracker reaches its limit, or the first waiting instance
+// doesn't fit, the memory of the spillable operators of the lowest priority queries is
+// revoked first, i.e. the buffers of their BufferedBlockMgr2s that don't hold pinned or
+// unwritten blocks are freed, see BufferedBlockMgr2::release_free_buffers().
+class MemAdmissionController {
+public:
+    // Registers a GC function on 'process_mem_tracker' to revoke memory when it is full.
+    // The controller must outlive the tracker.
+    explicit MemAdmissionController(const std::shared_ptr<MemTracker>& process_mem_tracker);
+    ~MemAdmissionController();
+
+    // Takes the initial reservations of 'state', waiting for them to fit if needed.
+    // Returns an error if they don't fit before the timeout or 'state' is cancelled.
+    Status admit(RuntimeState* state);
+
+    // Called when an admitted instance is closed, after its reservations are released.
+    void release(const TUniqueId& fragment_instance_id);
+
+    // Frees up to 'bytes' from the queries whose priority is lower than that of the
+    // query numbered 'query_seq', lowest first; -1 frees from all queries. Returns the
+    // number of bytes freed.
+    int64_t revoke(int64_t bytes, int64_t query_seq);
+
+private:
+    struct Query {
+        // Arrival order of the query, the higher the lower its priority.
+        int64_t seq;
+        // Number of waiting and admitted instances.
+        int num_instances;
+    };
+
+    struct Instance {
+        TUniqueId query_id;
+        // The memory of the instance that can be revoked.
+        boost::weak_ptr<BufferedBlockMgr2> block_mgr;
+    };
+
+    // Records that the instance of 'state' is admitted. Must be called with _lock taken.
+    void _add_instance(RuntimeState* state);
+
+    // Adds an instance of 'query_id' and returns the seq of the query. Must be called with
+    // _lock taken.
+    int64_t _add_query_instance(const TUniqueId& query_id);
+
+    // Removes an instance of 'query_id'. Must be called with _lock taken.
+    void _remove_query_instance(const TUniqueId& query_id);
+
+    // Takes the initial reservations of 'state', revoking memory of lower priority queries
+    // if they don't fit. Must be called without _lock taken.
+    Status _try_reserve(RuntimeState* state, int64_t query_seq);
+
+    std::mutex _lock;
+    // Notified when an instance is admitted, released or stops waiting.
+    std::condition_variable _cv;
+
+    int64_t _next_query_seq = 0;
+    std::unordered_map<TUniqueId, Query> _queries;
+    // The admitted instances.
+    std::unordered_map<TUniqueId, Instance> _instances;
+    // The waiting instances, the first one is admitted next.
+    std::deque<TUniqueId> _waiters;
+
+    IntGauge* fragment_admission_waiting;
+    IntCounter* fragment_admission_timeout_total;
+    IntCounter* fragment_admission_revoked_bytes;
+};
+
+} // namespace doris
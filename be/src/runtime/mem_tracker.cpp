@@ -19,9 +19,11 @@
 
 #include <stdint.h>
 
+#include <algorithm>
 #include <boost/algorithm/string/join.hpp>
 #include <limits>
 #include <memory>
+#include <unordered_set>
 
 #include "exec/exec_node.h"
 #include "gutil/once.h"
@@ -69,6 +71,109 @@ static int64_t CalcSoftLimit(int64_t limit) {
 static std::shared_ptr<MemTracker> root_tracker;
 static GoogleOnceType root_tracker_once = GOOGLE_ONCE_INIT;
 
+// The change of the consumption of a tracker made by a thread but not applied to it and
+// its ancestors yet. It holds a reference to the tracker while there's a change, so the
+// change is applied before the tracker is destroyed, at the latest when the thread exits.
+// The caches of all threads are registered, so that closing a tracker can apply the
+// changes cached by other threads and drop their references, see FlushConsumptionCaches().
+struct ThreadConsumptionCache {
+    ThreadConsumptionCache();
+    ~ThreadConsumptionCache();
+
+    // Applies the cached change and returns the reference to the tracker, which must be
+    // released without holding 'lock'. Requires 'lock'.
+    std::shared_ptr<MemTracker> flush_locked() {
+        if (tracker == nullptr) return nullptr;
+        std::shared_ptr<MemTracker> flushed_tracker = std::move(tracker);
+        tracker.reset();
+        for (auto& t : flushed_tracker->all_trackers_) {
+            // may be transiently negative while other threads hold the matching changes
+            t->consumption_->add(bytes);
+        }
+        bytes = 0;
+        return flushed_tracker;
+    }
+
+    void flush() {
+        std::shared_ptr<MemTracker> flushed_tracker;
+        {
+            lock_guard<SpinLock> l(lock);
+            flushed_tracker = flush_locked();
+        }
+        // releasing the last reference to a tracker releases its consumption from the
+        // parent, which may be cached again
+    }
+
+    // Protects 'tracker' and 'bytes', which are only changed by other threads when they
+    // flush the cache
+    SpinLock lock;
+    std::shared_ptr<MemTracker> tracker;
+    int64_t bytes = 0;
+};
+
+// The caches of all running threads
+static SpinLock consumption_caches_lock;
+static std::unordered_set<ThreadConsumptionCache*>* consumption_caches =
+        new std::unordered_set<ThreadConsumptionCache*>();
+
+ThreadConsumptionCache::ThreadConsumptionCache() {
+    lock_guard<SpinLock> l(consumption_caches_lock);
+    consumption_caches->insert(this);
+}
+
+ThreadConsumptionCache::~ThreadConsumptionCache() {
+    {
+        lock_guard<SpinLock> l(consumption_caches_lock);
+        consumption_caches->erase(this);
+    }
+    while (tracker != nullptr) {
+        flush();
+    }
+}
+
+static thread_local ThreadConsumptionCache tls_consumption_cache;
+
+bool MemTracker::CacheConsumption(int64_t bytes) {
+    const int64_t max_cached_bytes = config::mem_tracker_consumption_cache_bytes;
+    if (max_cached_bytes <= 0 || !cacheable_) return false;
+    ThreadConsumptionCache& cache = tls_consumption_cache;
+    std::shared_ptr<MemTracker> flushed_tracker;
+    lock_guard<SpinLock> l(cache.lock);
+    if (UNLIKELY(cache.tracker.get() != this)) {
+        flushed_tracker = cache.flush_locked();
+        cache.tracker = shared_from_this();
+    }
+    cache.bytes += bytes;
+    if (cache.bytes >= max_cached_bytes || cache.bytes <= -max_cached_bytes) {
+        flushed_tracker = cache.flush_locked();
+    }
+    // 'l' is released before 'flushed_tracker'
+    return true;
+}
+
+void MemTracker::FlushThreadConsumption() {
+    if (config::mem_tracker_consumption_cache_bytes <= 0) return;
+    tls_consumption_cache.flush();
+}
+
+void MemTracker::FlushConsumptionCaches() {
+    if (config::mem_tracker_consumption_cache_bytes <= 0) return;
+    std::vector<std::shared_ptr<MemTracker>> flushed_trackers;
+    {
+        lock_guard<SpinLock> l(consumption_caches_lock);
+        for (ThreadConsumptionCache* cache : *consumption_caches) {
+            lock_guard<SpinLock> cache_l(cache->lock);
+            if (cache->tracker == nullptr) continue;
+            const auto& ancestors = cache->tracker->all_trackers_;
+            if (std::find(ancestors.begin(), ancestors.end(), this) != ancestors.end()) {
+                flushed_trackers.push_back(cache->flush_locked());
+            }
+        }
+    }
+    // the references are released without holding the locks, see
+    // ThreadConsumptionCache::flush()
+}
+
 void MemTracker::CreateRootTracker() {
     root_tracker.reset(new MemTracker(-1, "root"));
     root_tracker->Init();
@@ -87,6 +192,7 @@ std::shared_ptr<MemTracker> MemTracker::CreateTracker(int64_t byte_limit, const
             new MemTracker(nullptr, byte_limit, label, real_parent, log_usage_if_zero));
     real_parent->AddChildTracker(tracker);
     tracker->Init();
+    tracker->cacheable_ = true;
 
     return tracker;
 }
@@ -103,6 +209,7 @@ std::shared_ptr<MemTracker> MemTracker::CreateTracker(RuntimeProfile* profile, i
     shared_ptr<MemTracker> tracker(new MemTracker(profile, byte_limit, label, real_parent, true));
     real_parent->AddChildTracker(tracker);
     tracker->Init();
+    tracker->cacheable_ = true;
 
     return tracker;
 }
@@ -43,6 +43,7 @@ enum class MemLimit { HARD, SOFT };
 class ObjectPool;
 class MemTracker;
 struct ReservationTrackerCounters;
+struct ThreadConsumptionCache;
 class RuntimeState;
 class TQueryOptions;
 
@@ -127,6 +128,7 @@ public:
             RefreshConsumptionFromMetric();
             return; // TODO(yingchun): why return not update tracker?
         }
+        if (CacheConsumption(bytes)) return;
         for (auto& tracker : all_trackers_) {
             tracker->consumption_->add(bytes);
             if (tracker->consumption_metric_ == nullptr) {
@@ -166,6 +168,8 @@ public:
             Release(-bytes);
             return true;
         }
+        // the limits are checked against the changes cached by this thread too
+        FlushThreadConsumption();
         // if (UNLIKELY(bytes == 0)) return true;
         // if (UNLIKELY(bytes < 0)) return false; // needed in RELEASE, hits DCHECK in DEBUG
         if (consumption_metric_ != nullptr) RefreshConsumptionFromMetric();
@@ -223,6 +227,7 @@ public:
             RefreshConsumptionFromMetric();
             return;
         }
+        if (CacheConsumption(-bytes)) return;
         for (auto& tracker : all_trackers_) {
             tracker->consumption_->add(-bytes);
             /// If a UDF calls FunctionContext::TrackAllocation() but allocates less than the
@@ -248,6 +253,7 @@ public:
     /// Returns true if a valid limit of this tracker or one of its ancestors is
     /// exceeded.
     bool AnyLimitExceeded(MemLimit mode) {
+        FlushThreadConsumption();
         for (const auto& tracker : limit_trackers_) {
             if (tracker->LimitExceeded(mode)) {
                 return true;
@@ -261,6 +267,7 @@ public:
     /// limit is exceeded after calling the GC functions. Returns false if there is no limit
     /// or consumption is under the limit.
     bool LimitExceeded(MemLimit mode) {
+        FlushThreadConsumption();
         if (UNLIKELY(CheckLimitExceeded(mode))) return LimitExceededSlow(mode);
         return false;
     }
@@ -284,6 +291,16 @@ public:
     /// call if this tracker has a consumption metric.
     void RefreshConsumptionFromMetric();
 
+    /// Applies the changes of consumption cached by the calling thread to their tracker
+    /// and its ancestors, see config::mem_tracker_consumption_cache_bytes.
+    static void FlushThreadConsumption();
+
+    /// Applies the changes of consumption of this tracker and its descendants cached by
+    /// any thread, and drops the references of the caches to them, so that the
+    /// consumption is exact and finished trackers aren't kept alive by idle threads.
+    /// Called when a tracker is closed, before checking that it has no consumption.
+    void FlushConsumptionCaches();
+
     // TODO(yingchun): following functions are old style which have no MemLimit parameter
     bool limit_exceeded() const { return limit_ >= 0 && limit_ < consumption(); }
 
@@ -473,6 +490,16 @@ private:
     /// Otherwise return NULL.
     MemTracker* GetQueryMemTracker();
 
+    friend struct ThreadConsumptionCache;
+
+    /// If config::mem_tracker_consumption_cache_bytes is set, Consume() and Release()
+    /// accumulate their changes in a cache of the calling thread, which applies them to
+    /// this tracker and its ancestors once they add up to that many bytes, instead of
+    /// updating every tracker up to the root on each call. The limits are checked after
+    /// flushing the cache of the checking thread, the consumption of a tracker may be
+    /// off by the changes cached by other threads. Returns false if 'bytes' isn't cached.
+    bool CacheConsumption(int64_t bytes);
+
     /// Increases/Decreases the consumption of this tracker and the ancestors up to (but
     /// not including) end_tracker.
     void ChangeConsumption(int64_t bytes, MemTracker* end_tracker) {
@@ -553,6 +580,10 @@ private:
     /// if consumption is 0.
     bool log_usage_if_zero_;
 
+    /// True if the changes of the consumption may be cached by threads, only the trackers
+    /// created by CreateTracker() are owned by shared_ptrs that the caches can hold.
+    bool cacheable_ = false;
+
     /// The number of times the GcFunctions were called.
     IntCounter* num_gcs_metric_;
 
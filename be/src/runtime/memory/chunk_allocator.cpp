@@ -21,6 +21,7 @@
 #include <list>
 #include <mutex>
 
+#include "common/config.h"
 #include "gutil/dynamic_annotations.h"
 #include "runtime/memory/chunk.h"
 #include "runtime/memory/system_allocator.h"
@@ -36,13 +37,17 @@ ChunkAllocator* ChunkAllocator::_s_instance = nullptr;
 
 DEFINE_COUNTER_METRIC_PROTOTYPE_2ARG(chunk_pool_local_core_alloc_count, MetricUnit::NOUNIT);
 DEFINE_COUNTER_METRIC_PROTOTYPE_2ARG(chunk_pool_other_core_alloc_count, MetricUnit::NOUNIT);
+DEFINE_COUNTER_METRIC_PROTOTYPE_2ARG(chunk_pool_other_node_alloc_count, MetricUnit::NOUNIT);
 DEFINE_COUNTER_METRIC_PROTOTYPE_2ARG(chunk_pool_system_alloc_count, MetricUnit::NOUNIT);
 DEFINE_COUNTER_METRIC_PROTOTYPE_2ARG(chunk_pool_system_free_count, MetricUnit::NOUNIT);
 DEFINE_COUNTER_METRIC_PROTOTYPE_2ARG(chunk_pool_system_alloc_cost_ns, MetricUnit::NANOSECONDS);
 DEFINE_COUNTER_METRIC_PROTOTYPE_2ARG(chunk_pool_system_free_cost_ns, MetricUnit::NANOSECONDS);
+DEFINE_GAUGE_METRIC_PROTOTYPE_2ARG(chunk_pool_reserved_bytes, MetricUnit::BYTES);
+DEFINE_COUNTER_METRIC_PROTOTYPE_2ARG(chunk_pool_node_system_alloc_count, MetricUnit::NOUNIT);
 
 static IntCounter* chunk_pool_local_core_alloc_count;
 static IntCounter* chunk_pool_other_core_alloc_count;
+static IntCounter* chunk_pool_other_node_alloc_count;
 static IntCounter* chunk_pool_system_alloc_count;
 static IntCounter* chunk_pool_system_free_count;
 static IntCounter* chunk_pool_system_alloc_cost_ns;
@@ -105,74 +110,134 @@ private:
     std::vector<std::vector<uint8_t*>> _chunk_lists;
 };
 
+// The reserved bytes and the metrics of the chunks of a NUMA node, which are reported by
+// the metric entity "chunk_allocator.numa_node_<id>".
+struct ChunkAllocator::NumaNode {
+    NumaNode(int id, size_t reserve_limit) : reserve_bytes_limit(reserve_limit) {
+        entity = DorisMetrics::instance()->metric_registry()->register_entity(
+                "chunk_allocator.numa_node_" + std::to_string(id),
+                {{"numa_node", std::to_string(id)}});
+        INT_GAUGE_METRIC_REGISTER(entity, chunk_pool_reserved_bytes);
+        INT_COUNTER_METRIC_REGISTER(entity, chunk_pool_node_system_alloc_count);
+        entity->register_hook("chunk_allocator", [this]() {
+            chunk_pool_reserved_bytes->set_value(reserved_bytes.load());
+        });
+    }
+
+    ~NumaNode() {
+        entity->deregister_hook("chunk_allocator");
+        DorisMetrics::instance()->metric_registry()->deregister_entity(entity);
+    }
+
+    size_t reserve_bytes_limit;
+    std::atomic<int64_t> reserved_bytes {0};
+
+    std::shared_ptr<MetricEntity> entity;
+    IntGauge* chunk_pool_reserved_bytes;
+    IntCounter* chunk_pool_node_system_alloc_count;
+};
+
 void ChunkAllocator::init_instance(size_t reserve_limit) {
     if (_s_instance != nullptr) return;
     _s_instance = new ChunkAllocator(reserve_limit);
 }
 
 ChunkAllocator::ChunkAllocator(size_t reserve_limit)
-        : _reserve_bytes_limit(reserve_limit),
-          _reserved_bytes(0),
-          _arenas(CpuInfo::get_max_num_cores()) {
+        : _reserve_bytes_limit(reserve_limit), _arenas(CpuInfo::get_max_num_cores()) {
     for (int i = 0; i < _arenas.size(); ++i) {
         _arenas[i].reset(new ChunkArena());
     }
+    int num_nodes = CpuInfo::get_max_num_numa_nodes();
+    for (int i = 0; i < num_nodes; ++i) {
+        _nodes.emplace_back(new NumaNode(i, reserve_limit / num_nodes));
+    }
 
     _chunk_allocator_metric_entity =
             DorisMetrics::instance()->metric_registry()->register_entity("chunk_allocator");
     INT_COUNTER_METRIC_REGISTER(_chunk_allocator_metric_entity, chunk_pool_local_core_alloc_count);
     INT_COUNTER_METRIC_REGISTER(_chunk_allocator_metric_entity, chunk_pool_other_core_alloc_count);
+    INT_COUNTER_METRIC_REGISTER(_chunk_allocator_metric_entity, chunk_pool_other_node_alloc_count);
     INT_COUNTER_METRIC_REGISTER(_chunk_allocator_metric_entity, chunk_pool_system_alloc_count);
     INT_COUNTER_METRIC_REGISTER(_chunk_allocator_metric_entity, chunk_pool_system_free_count);
     INT_COUNTER_METRIC_REGISTER(_chunk_allocator_metric_entity, chunk_pool_system_alloc_cost_ns);
     INT_COUNTER_METRIC_REGISTER(_chunk_allocator_metric_entity, chunk_pool_system_free_cost_ns);
 }
 
+ChunkAllocator::~ChunkAllocator() {
+    // the cached chunks are freed to the system
+    _arenas.clear();
+    _nodes.clear();
+}
+
+bool ChunkAllocator::pop_from_node(int node_id, int first_core_idx, int num_cores, size_t size,
+                                   Chunk* chunk) {
+    const std::vector<int>& cores = CpuInfo::get_cores_of_numa_node(node_id);
+    for (int i = 0; i < num_cores; ++i) {
+        int core_id = cores[(first_core_idx + i) % cores.size()];
+        if (_arenas[core_id]->pop_free_chunk(size, &chunk->data)) {
+            _nodes[node_id]->reserved_bytes.fetch_sub(size);
+            chunk->core_id = core_id;
+            return true;
+        }
+    }
+    return false;
+}
+
 bool ChunkAllocator::allocate(size_t size, Chunk* chunk) {
     // fast path: allocate from current core arena
     int core_id = CpuInfo::get_current_core();
+    int node_id = CpuInfo::get_numa_node_of_core(core_id);
+    NumaNode* node = _nodes[node_id].get();
     chunk->size = size;
     chunk->core_id = core_id;
 
     if (_arenas[core_id]->pop_free_chunk(size, &chunk->data)) {
-        _reserved_bytes.fetch_sub(size);
+        node->reserved_bytes.fetch_sub(size);
         chunk_pool_local_core_alloc_count->increment(1);
         return true;
     }
-    if (_reserved_bytes > size) {
-        // try to allocate from other core's arena
-        ++core_id;
-        for (int i = 1; i < _arenas.size(); ++i, ++core_id) {
-            if (_arenas[core_id % _arenas.size()]->pop_free_chunk(size, &chunk->data)) {
-                _reserved_bytes.fetch_sub(size);
-                chunk_pool_other_core_alloc_count->increment(1);
-                // reset chunk's core_id to other
-                chunk->core_id = core_id % _arenas.size();
-                return true;
-            }
-        }
+    // try to allocate from other core's arena of the same node
+    int num_node_cores = CpuInfo::get_cores_of_numa_node(node_id).size();
+    if (node->reserved_bytes > size &&
+        pop_from_node(node_id, CpuInfo::get_numa_node_core_idx(core_id) + 1, num_node_cores - 1,
+                      size, chunk)) {
+        chunk_pool_other_core_alloc_count->increment(1);
+        return true;
     }
 
     int64_t cost_ns = 0;
     {
         SCOPED_RAW_TIMER(&cost_ns);
-        // allocate from system allocator
-        chunk->data = SystemAllocator::allocate(size);
+        // allocate from system allocator, bound to this node if there are others
+        bool bind = config::chunk_allocator_bind_numa_node && _nodes.size() > 1;
+        chunk->data = SystemAllocator::allocate(size, bind ? node_id : -1);
     }
     chunk_pool_system_alloc_count->increment(1);
     chunk_pool_system_alloc_cost_ns->increment(cost_ns);
-    if (chunk->data == nullptr) {
-        return false;
+    node->chunk_pool_node_system_alloc_count->increment(1);
+    if (chunk->data != nullptr) {
+        return true;
+    }
+
+    // out of memory, the chunks of the other nodes are better than failing
+    for (int i = 0; i < _nodes.size(); ++i) {
+        if (i != node_id && _nodes[i]->reserved_bytes >= size &&
+            pop_from_node(i, 0, CpuInfo::get_cores_of_numa_node(i).size(), size, chunk)) {
+            chunk_pool_other_node_alloc_count->increment(1);
+            return true;
+        }
     }
-    return true;
+    return false;
 }
 
 void ChunkAllocator::free(const Chunk& chunk) {
-    int64_t old_reserved_bytes = _reserved_bytes;
+    // the chunk goes back to the node it's allocated from
+    NumaNode* node = _nodes[CpuInfo::get_numa_node_of_core(chunk.core_id)].get();
+    int64_t old_reserved_bytes = node->reserved_bytes;
     int64_t new_reserved_bytes = 0;
     do {
         new_reserved_bytes = old_reserved_bytes + chunk.size;
-        if (new_reserved_bytes > _reserve_bytes_limit) {
+        if (new_reserved_bytes > node->reserve_bytes_limit) {
             int64_t cost_ns = 0;
             {
                 SCOPED_RAW_TIMER(&cost_ns);
@@ -183,7 +248,7 @@ void ChunkAllocator::free(const Chunk& chunk) {
 
             return;
         }
-    } while (!_reserved_bytes.compare_exchange_weak(old_reserved_bytes, new_reserved_bytes));
+    } while (!node->reserved_bytes.compare_exchange_weak(old_reserved_bytes, new_reserved_bytes));
 
     _arenas[chunk.core_id]->push_free_chunk(chunk.data, chunk.size);
 }
@@ -36,15 +36,21 @@ class MetricEntity;
 // ChunkAllocator has one ChunkArena for each CPU core, it will try to allocate
 // memory from current core arena firstly. In this way, there will be no lock contention
 // between concurrently-running threads. If this fails, ChunkAllocator will try to allocate
-// memory from other core's arena.
+// memory from the arenas of the other cores of the same NUMA node. The chunks cached by
+// other nodes are only used when the system is out of memory, accessing them from this
+// node costs memory bandwidth for the rest of their lives.
 //
 // Memory Reservation
 // ChunkAllocator has a limit about how much free chunk bytes it can reserve, above which
 // chunk will released to system memory. For the worst case, when the limits is 0, it will
-// act as allocating directly from system.
+// act as allocating directly from system. The limit is divided evenly among the NUMA nodes,
+// each node counts its own reserved bytes.
 //
 // ChunkArena will keep a separate free list for each chunk size. In common case, chunk will
-// be allocated from current core arena. In this case, there is no lock contention.
+// be allocated from current core arena. In this case, there is no lock contention. A chunk
+// is freed to the arena it's allocated from, i.e. to the node of its memory: chunks
+// allocated via mmap are bound to the node of the allocating core, see
+// config::chunk_allocator_bind_numa_node.
 //
 // Must call CpuInfo::init() and DorisMetrics::instance()->initialize() to achieve good performance
 // before first object is created. And call init_instance() before use instance is called.
@@ -59,6 +65,7 @@ public:
 #endif
 
     ChunkAllocator(size_t reserve_limit);
+    ~ChunkAllocator();
 
     // Allocate a Chunk with a power-of-two length "size".
     // Return true if success and allocated chunk is saved in "chunk".
@@ -69,10 +76,18 @@ public:
     void free(const Chunk& chunk);
 
 private:
+    struct NumaNode;
+
+    // Pop a free chunk of 'size' from the arenas of 'num_cores' cores of NUMA node 'node_id',
+    // starting with its 'first_core_idx'-th core (see CpuInfo::get_numa_node_core_idx()).
+    bool pop_from_node(int node_id, int first_core_idx, int num_cores, size_t size,
+                       Chunk* chunk);
+
     static ChunkAllocator* _s_instance;
 
     size_t _reserve_bytes_limit;
-    std::atomic<int64_t> _reserved_bytes;
+    // each NUMA node has its reserved bytes and metrics
+    std::vector<std::unique_ptr<NumaNode>> _nodes;
     // each core has a ChunkArena
     std::vector<std::unique_ptr<ChunkArena>> _arenas;
 
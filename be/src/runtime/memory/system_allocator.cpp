@@ -20,17 +20,23 @@
 #include <stdlib.h>
 #include <string.h>
 #include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
 
 #include "common/config.h"
 #include "common/logging.h"
+#include "util/huge_page_util.h"
 
 namespace doris {
 
 #define PAGE_SIZE (4 * 1024) // 4K
 
-uint8_t* SystemAllocator::allocate(size_t length) {
+// The mode of mbind() in <numaif.h>, libnuma isn't a dependency so it's called via syscall()
+static const int MPOL_PREFERRED_MODE = 1;
+
+uint8_t* SystemAllocator::allocate(size_t length, int numa_node) {
     if (config::use_mmap_allocate_chunk) {
-        return allocate_via_mmap(length);
+        return allocate_via_mmap(length, numa_node);
     } else {
         return allocate_via_malloc(length);
     }
@@ -45,32 +51,60 @@ void SystemAllocator::free(uint8_t* ptr, size_t length) {
                        << ", errmsg=" << strerror_r(errno, buf, 64);
         }
     } else {
+        if (HugePageUtil::use_huge_pages(length)) {
+            // undo the madvise, the memory may be reused for small allocations
+            HugePageUtil::advise(ptr, length, false);
+        }
         ::free(ptr);
     }
 }
 
 uint8_t* SystemAllocator::allocate_via_malloc(size_t length) {
     void* ptr = nullptr;
+    bool use_huge_pages = HugePageUtil::use_huge_pages(length);
     // try to use a whole page instead of parts of one page
-    int res = posix_memalign(&ptr, PAGE_SIZE, length);
+    int res = posix_memalign(&ptr, use_huge_pages ? HugePageUtil::HUGE_PAGE_SIZE : PAGE_SIZE,
+                             length);
     if (res != 0) {
         char buf[64];
         LOG(ERROR) << "fail to allocate mem via posix_memalign, res=" << res
                    << ", errmsg=" << strerror_r(res, buf, 64);
         return nullptr;
     }
+    if (use_huge_pages) {
+        HugePageUtil::advise((uint8_t*)ptr, length, true);
+    }
     return (uint8_t*)ptr;
 }
 
-uint8_t* SystemAllocator::allocate_via_mmap(size_t length) {
-    auto ptr = (uint8_t*)mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE,
-                              -1, 0);
-    if (ptr == MAP_FAILED) {
+uint8_t* SystemAllocator::allocate_via_mmap(size_t length, int numa_node) {
+    uint8_t* ptr = nullptr;
+    if (HugePageUtil::use_huge_pages(length)) {
+        ptr = HugePageUtil::map(length);
+    } else {
+        ptr = (uint8_t*)mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE,
+                             -1, 0);
+        if (ptr == MAP_FAILED) {
+            ptr = nullptr;
+        }
+    }
+    if (ptr == nullptr) {
         char buf[64];
         LOG(ERROR) << "fail to allocate memory via mmap, errno=" << errno
                    << ", errmsg=" << strerror_r(errno, buf, 64);
         return nullptr;
     }
+    // the pages aren't touched yet, so they're all placed by the policy
+    if (numa_node >= 0 && numa_node < 64) {
+        unsigned long nodemask = 1UL << numa_node;
+        if (syscall(SYS_mbind, ptr, length, MPOL_PREFERRED_MODE, &nodemask,
+                    sizeof(nodemask) * 8 + 1, 0) != 0) {
+            char buf[64];
+            LOG_FIRST_N(WARNING, 5) << "fail to bind memory to numa node " << numa_node
+                                    << ", errno=" << errno
+                                    << ", errmsg=" << strerror_r(errno, buf, 64);
+        }
+    }
     return ptr;
 }
 
@@ -26,12 +26,14 @@ namespace doris {
 // to allocate memory via mmap or malloc.
 class SystemAllocator {
 public:
-    static uint8_t* allocate(size_t length);
+    // If 'numa_node' isn't -1 and the memory is allocated via mmap, the pages prefer the
+    // memory of that NUMA node, they're only placed on other nodes if it's full.
+    static uint8_t* allocate(size_t length, int numa_node = -1);
 
     static void free(uint8_t* ptr, size_t length);
 
 private:
-    static uint8_t* allocate_via_mmap(size_t length);
+    static uint8_t* allocate_via_mmap(size_t length, int numa_node);
     static uint8_t* allocate_via_malloc(size_t length);
 };
 
@@ -33,19 +33,42 @@
 #include "runtime/data_stream_mgr.h"
 #include "runtime/descriptors.h"
 #include "runtime/exec_env.h"
+#include "runtime/initial_reservations.h"
+#include "runtime/mem_admission_controller.h"
 #include "runtime/mem_tracker.h"
+#include "runtime/resource_group_mgr.h"
 #include "runtime/result_buffer_mgr.h"
 #include "runtime/result_queue_mgr.h"
 #include "runtime/row_batch.h"
 #include "util/container_util.hpp"
+#include "util/continuous_cpu_profiler.h"
 #include "util/cpu_info.h"
 #include "util/mem_info.h"
 #include "util/parse_util.h"
 #include "util/pretty_printer.h"
+#include "util/thread_perf_counters.h"
 #include "util/uid_util.h"
 
 namespace doris {
 
+// The counters rolled up into the TotalCpuTime and TotalWaitTime of a fragment instance.
+// Scanner threads run apart from the fragment instance thread, so their cpu time is added
+// to the one of the instance thread. The wait times are the ones of the instance thread
+// for the admission, the scanners, the data of the exchanges and the rpcs of the senders.
+static const std::vector<std::string> CPU_TIME_COUNTERS = {"FragmentCpuTime", "ScannerCpuTime"};
+static const std::vector<std::string> WAIT_TIME_COUNTERS = {
+        "ResourceGroupWaitTime", "AdmissionWaitTime", "WaitScannerTime", "DataArrivalWaitTime",
+        "RpcWaitTime"};
+
+// Returns the sum of the counters named 'names' in 'profile' and its children.
+static int64_t sum_counters(RuntimeProfile* profile, const std::vector<std::string>& names) {
+    std::vector<RuntimeProfile::Counter*> counters;
+    for (auto& name : names) {
+        profile->get_counters(name, &counters);
+    }
+    return RuntimeProfile::counter_sum(&counters);
+}
+
 PlanFragmentExecutor::PlanFragmentExecutor(ExecEnv* exec_env,
                                            const report_status_callback& report_status_cb)
         : _exec_env(exec_env),
@@ -218,6 +241,20 @@ Status PlanFragmentExecutor::prepare(const TExecPlanFragmentParams& request,
     // set up profile counters
     profile()->add_child(_plan->runtime_profile(), true, NULL);
     _rows_produced_counter = ADD_COUNTER(profile(), "RowsProduced", TUnit::UNIT);
+    // the cpu time and the perf counters are read from the current thread, a bthread may
+    // move between workers while they run, so they are not collected in that mode
+    if (!config::fragment_exec_in_bthread) {
+        _fragment_cpu_timer = ADD_TIMER(profile(), "FragmentCpuTime");
+        if (_runtime_state->query_options().enable_perf_counters) {
+            _perf_counters.reset(new ThreadPerfCounters(profile(), ""));
+        }
+    }
+    profile()->add_derived_counter(
+            "TotalCpuTime", TUnit::TIME_NS,
+            boost::bind<int64_t>(&sum_counters, profile(), CPU_TIME_COUNTERS), "");
+    profile()->add_derived_counter(
+            "TotalWaitTime", TUnit::TIME_NS,
+            boost::bind<int64_t>(&sum_counters, profile(), WAIT_TIME_COUNTERS), "");
 
     _row_batch.reset(new RowBatch(_plan->row_desc(), _runtime_state->batch_size(),
                                   _runtime_state->instance_mem_tracker().get()));
@@ -235,6 +272,7 @@ Status PlanFragmentExecutor::prepare(const TExecPlanFragmentParams& request,
 Status PlanFragmentExecutor::open() {
     LOG(INFO) << "Open(): fragment_instance_id="
               << print_id(_runtime_state->fragment_instance_id());
+    ScopedCpuProfilerTag profiler_tag(_runtime_state->query_id(), ContinuousCpuProfiler::FRAGMENT);
 
     // we need to start the profile-reporting thread before calling Open(), since it
     // may block
@@ -265,6 +303,22 @@ Status PlanFragmentExecutor::open() {
 Status PlanFragmentExecutor::open_internal() {
     {
         SCOPED_TIMER(profile()->total_time_counter());
+        SCOPED_CPU_TIMER(_fragment_cpu_timer);
+        SCOPED_PERF_COUNTERS(_perf_counters.get());
+        ResourceGroup* resource_group = _runtime_state->resource_group();
+        if (resource_group != nullptr) {
+            SCOPED_TIMER(ADD_TIMER(profile(), "ResourceGroupWaitTime"));
+            RETURN_IF_ERROR(resource_group->admit(_runtime_state.get()));
+        }
+        // Take the initial reservations, which the nodes claim in open().
+        MemAdmissionController* admission_controller = _exec_env->mem_admission_controller();
+        if (admission_controller != nullptr) {
+            SCOPED_TIMER(ADD_TIMER(profile(), "AdmissionWaitTime"));
+            RETURN_IF_ERROR(admission_controller->admit(_runtime_state.get()));
+        } else {
+            RETURN_IF_ERROR(_runtime_state->initial_reservations()->Init(
+                    _query_id, _runtime_state->min_reservation()));
+        }
         RETURN_IF_ERROR(_plan->open(_runtime_state.get()));
     }
 
@@ -295,11 +349,21 @@ Status PlanFragmentExecutor::open_internal() {
         }
 
         SCOPED_TIMER(profile()->total_time_counter());
+        SCOPED_CPU_TIMER(_fragment_cpu_timer);
+        SCOPED_PERF_COUNTERS(_perf_counters.get());
         // Collect this plan and sub plan statistics, and send to parent plan.
         if (_collect_query_statistics_with_every_batch) {
             collect_query_statistics();
         }
-        RETURN_IF_ERROR(_sink->send(runtime_state(), batch));
+        Status st = _sink->send(runtime_state(), batch);
+        if (st.is_end_of_file()) {
+            // The receivers need no more rows. Closing the plan with the fragment stops
+            // the scans.
+            VLOG_QUERY << "receivers of fragment instance "
+                       << print_id(_runtime_state->fragment_instance_id()) << " finished";
+            break;
+        }
+        RETURN_IF_ERROR(st);
     }
 
     // Close the sink *before* stopping the report thread. Close may
@@ -315,6 +379,8 @@ Status PlanFragmentExecutor::open_internal() {
     // audit the sinks to check that this is ok, or change that behaviour.
     {
         SCOPED_TIMER(profile()->total_time_counter());
+        SCOPED_CPU_TIMER(_fragment_cpu_timer);
+        SCOPED_PERF_COUNTERS(_perf_counters.get());
         collect_query_statistics();
         Status status;
         {
@@ -464,6 +530,8 @@ Status PlanFragmentExecutor::get_next_internal(RowBatch** batch) {
     while (!_done) {
         _row_batch->reset();
         SCOPED_TIMER(profile()->total_time_counter());
+        SCOPED_CPU_TIMER(_fragment_cpu_timer);
+        SCOPED_PERF_COUNTERS(_perf_counters.get());
         RETURN_IF_ERROR(_plan->get_next(_runtime_state.get(), _row_batch.get(), &_done));
 
         if (_row_batch->num_rows() > 0) {
@@ -571,10 +639,15 @@ void PlanFragmentExecutor::close() {
             _runtime_state->runtime_profile()->pretty_print(&ss);
             LOG(INFO) << ss.str();
         }
+        // the threads which ran the fragment may still cache changes of its trackers
+        if (_runtime_state->query_mem_tracker() != nullptr) {
+            _runtime_state->query_mem_tracker()->FlushConsumptionCaches();
+        }
     }
 
     // _mem_tracker init failed
     if (_mem_tracker.get() != nullptr) {
+        _mem_tracker->FlushConsumptionCaches();
         _mem_tracker->Release(_mem_tracker->consumption());
     }
     _closed = true;
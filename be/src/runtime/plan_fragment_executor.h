@@ -45,6 +45,7 @@ class TPlanExecRequest;
 class TPlanFragment;
 class TPlanFragmentExecParams;
 class TPlanExecParams;
+class ThreadPerfCounters;
 
 // PlanFragmentExecutor handles all aspects of the execution of a single plan fragment,
 // including setup and tear-down, both in the success and error case.
@@ -205,6 +206,13 @@ private:
     // Number of rows returned by this fragment
     RuntimeProfile::Counter* _rows_produced_counter;
 
+    // Thread cpu time of the fragment instance thread driving the plan and the sink
+    RuntimeProfile::Counter* _fragment_cpu_timer = nullptr;
+
+    // Hardware events of the fragment instance thread, only if the query option
+    // enable_perf_counters is set
+    boost::scoped_ptr<ThreadPerfCounters> _perf_counters;
+
     // Average number of thread tokens for the duration of the plan fragment execution.
     // Fragments that do a lot of cpu work (non-coordinator fragment) will have at
     // least 1 token.  Fragments that contain a hdfs scan node will have 1+ tokens
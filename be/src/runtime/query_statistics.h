@@ -32,17 +32,32 @@ class QueryStatisticsRecvr;
 // or plan's statistics and QueryStatisticsRecvr is responsible for collecting it.
 class QueryStatistics {
 public:
-    QueryStatistics() : scan_rows(0), scan_bytes(0), returned_rows(0) {}
+    QueryStatistics()
+            : scan_rows(0),
+              scan_bytes(0),
+              scan_cached_bytes(0),
+              scan_io_ns(0),
+              scan_file_opens(0),
+              returned_rows(0) {}
 
     void merge(const QueryStatistics& other) {
         scan_rows += other.scan_rows;
         scan_bytes += other.scan_bytes;
+        scan_cached_bytes += other.scan_cached_bytes;
+        scan_io_ns += other.scan_io_ns;
+        scan_file_opens += other.scan_file_opens;
     }
 
     void add_scan_rows(int64_t scan_rows) { this->scan_rows += scan_rows; }
 
     void add_scan_bytes(int64_t scan_bytes) { this->scan_bytes += scan_bytes; }
 
+    void add_scan_cached_bytes(int64_t bytes) { this->scan_cached_bytes += bytes; }
+
+    void add_scan_io_ns(int64_t ns) { this->scan_io_ns += ns; }
+
+    void add_scan_file_opens(int64_t num) { this->scan_file_opens += num; }
+
     void set_returned_rows(int64_t num_rows) { this->returned_rows = num_rows; }
 
     void merge(QueryStatisticsRecvr* recvr);
@@ -50,6 +65,9 @@ public:
     void clear() {
         scan_rows = 0;
         scan_bytes = 0;
+        scan_cached_bytes = 0;
+        scan_io_ns = 0;
+        scan_file_opens = 0;
         returned_rows = 0;
     }
 
@@ -57,17 +75,28 @@ public:
         DCHECK(statistics != nullptr);
         statistics->set_scan_rows(scan_rows);
         statistics->set_scan_bytes(scan_bytes);
+        statistics->set_scan_cached_bytes(scan_cached_bytes);
+        statistics->set_scan_io_ns(scan_io_ns);
+        statistics->set_scan_file_opens(scan_file_opens);
         statistics->set_returned_rows(returned_rows);
     }
 
     void merge_pb(const PQueryStatistics& statistics) {
         scan_rows += statistics.scan_rows();
         scan_bytes += statistics.scan_bytes();
+        scan_cached_bytes += statistics.scan_cached_bytes();
+        scan_io_ns += statistics.scan_io_ns();
+        scan_file_opens += statistics.scan_file_opens();
     }
 
 private:
     int64_t scan_rows;
+    // compressed bytes read from the files
     int64_t scan_bytes;
+    // compressed bytes of the pages found in the page cache
+    int64_t scan_cached_bytes;
+    int64_t scan_io_ns;
+    int64_t scan_file_opens;
     // number rows returned by query.
     // only set once by result sink when closing.
     int64_t returned_rows;
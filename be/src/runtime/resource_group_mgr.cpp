@@ -0,0 +1,180 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "runtime/resource_group_mgr.h"
+
+#include <algorithm>
+#include <chrono>
+#include <sstream>
+#include <vector>
+
+#include "agent/cgroups_mgr.h"
+#include "common/config.h"
+#include "common/logging.h"
+#include "gutil/strings/split.h"
+#include "gutil/strings/strip.h"
+#include "runtime/mem_tracker.h"
+#include "runtime/runtime_state.h"
+#include "util/fair_thread_pool.h"
+#include "util/parse_util.h"
+#include "util/stopwatch.hpp"
+#include "util/string_parser.hpp"
+
+namespace doris {
+
+// The queries waiting for a slot also check for cancellation at this interval.
+static const int64_t ADMISSION_RETRY_INTERVAL_MS = 100;
+
+ResourceGroup::~ResourceGroup() {}
+
+Status ResourceGroup::admit(RuntimeState* state) {
+    const TUniqueId& query_id = state->query_id();
+    int64_t timeout_ms = config::fragment_admission_timeout_ms;
+    MonotonicStopWatch watch;
+    watch.start();
+    std::unique_lock<std::mutex> l(_lock);
+    while (_max_queries > 0 && _queries.size() >= static_cast<size_t>(_max_queries) &&
+           _queries.find(query_id) == _queries.end()) {
+        int64_t elapsed_ms = watch.elapsed_time() / 1000000;
+        if (state->is_cancelled()) {
+            return Status::Cancelled("Cancelled while waiting for resource group " + _name);
+        }
+        if (elapsed_ms >= timeout_ms) {
+            std::stringstream ss;
+            ss << "Query " << print_id(query_id) << " was not admitted in " << timeout_ms
+               << "ms: resource group " << _name << " is running " << _queries.size()
+               << " queries, max_queries is " << _max_queries;
+            return Status::InternalError(ss.str());
+        }
+        int64_t wait_ms = std::min(timeout_ms - elapsed_ms, ADMISSION_RETRY_INTERVAL_MS);
+        _cv.wait_for(l, std::chrono::milliseconds(wait_ms));
+    }
+    ++_queries[query_id];
+    _instances[state->fragment_instance_id()] = query_id;
+    return Status::OK();
+}
+
+void ResourceGroup::release(const TUniqueId& fragment_instance_id) {
+    std::lock_guard<std::mutex> l(_lock);
+    auto instance = _instances.find(fragment_instance_id);
+    if (instance == _instances.end()) {
+        return;
+    }
+    auto query = _queries.find(instance->second);
+    _instances.erase(instance);
+    DCHECK(query != _queries.end());
+    if (--query->second == 0) {
+        _queries.erase(query);
+        _cv.notify_all();
+    }
+}
+
+Status ResourceGroupMgr::init(const std::string& config,
+                              const std::shared_ptr<MemTracker>& process_mem_tracker,
+                              CgroupsMgr* cgroups_mgr) {
+    for (auto& spec : strings::Split(config, ";", strings::SkipWhitespace())) {
+        RETURN_IF_ERROR(_parse_group(spec, process_mem_tracker, cgroups_mgr));
+    }
+    return Status::OK();
+}
+
+ResourceGroup* ResourceGroupMgr::get(const std::string& name) const {
+    auto it = _groups.find(name);
+    return it == _groups.end() ? nullptr : it->second.get();
+}
+
+Status ResourceGroupMgr::_parse_group(const std::string& spec,
+                                      const std::shared_ptr<MemTracker>& parent,
+                                      CgroupsMgr* cgroups_mgr) {
+    std::vector<std::string> name_and_props =
+            strings::Split(spec, strings::delimiter::Limit(":", 1));
+    std::string name = name_and_props[0];
+    StripWhiteSpace(&name);
+    if (name.empty() || _groups.count(name) > 0) {
+        return Status::InvalidArgument("Invalid or duplicated resource group: " + spec);
+    }
+
+    int32_t scan_threads = 0;
+    int32_t cpu_shares = 0;
+    int64_t mem_limit = -1;
+    int32_t max_queries = 0;
+    if (name_and_props.size() > 1) {
+        for (auto& prop : strings::Split(name_and_props[1], ",", strings::SkipWhitespace())) {
+            std::vector<std::string> kv = strings::Split(prop, "=");
+            if (kv.size() != 2) {
+                return Status::InvalidArgument("Invalid property of resource group " + name +
+                                               ": " + prop);
+            }
+            StripWhiteSpace(&kv[0]);
+            StripWhiteSpace(&kv[1]);
+            StringParser::ParseResult result = StringParser::PARSE_SUCCESS;
+            if (kv[0] == "scan_threads") {
+                scan_threads = StringParser::string_to_int<int32_t>(kv[1].data(), kv[1].size(),
+                                                                    &result);
+            } else if (kv[0] == "cpu_shares") {
+                cpu_shares = StringParser::string_to_int<int32_t>(kv[1].data(), kv[1].size(),
+                                                                  &result);
+            } else if (kv[0] == "max_queries") {
+                max_queries = StringParser::string_to_int<int32_t>(kv[1].data(), kv[1].size(),
+                                                                   &result);
+            } else if (kv[0] == "mem_limit") {
+                bool is_percent = false;
+                mem_limit = ParseUtil::parse_mem_spec(kv[1], &is_percent);
+                if (mem_limit <= 0) {
+                    result = StringParser::PARSE_FAILURE;
+                }
+            } else {
+                return Status::InvalidArgument("Unknown property of resource group " + name +
+                                               ": " + kv[0]);
+            }
+            if (result != StringParser::PARSE_SUCCESS) {
+                return Status::InvalidArgument("Invalid property of resource group " + name +
+                                               ": " + prop);
+            }
+        }
+    }
+
+    std::unique_ptr<ResourceGroup> group(new ResourceGroup(name));
+    if (scan_threads > 0) {
+        group->_scan_thread_pool.reset(
+                new FairThreadPool(scan_threads, config::doris_scanner_thread_pool_queue_size));
+    }
+    if (cpu_shares > 0) {
+        if (cgroups_mgr == nullptr) {
+            LOG(WARNING) << "Ignore cpu_shares of resource group " << name
+                         << ", doris_cgroups is not available";
+        } else {
+            std::string cgroup = "resource_group_" + name;
+            if (cgroups_mgr->modify_user_cgroups(cgroup, {{"cpu.shares", cpu_shares}}, {}) ==
+                AgentStatus::DORIS_SUCCESS) {
+                group->_cgroup = cgroup;
+            } else {
+                LOG(WARNING) << "Failed to create cgroup of resource group " << name;
+            }
+        }
+    }
+    group->_mem_tracker = MemTracker::CreateTracker(mem_limit, "ResourceGroup: " + name, parent);
+    group->_max_queries = max_queries;
+
+    LOG(INFO) << "Created resource group " << name << ": scan_threads=" << scan_threads
+              << ", cpu_shares=" << cpu_shares << ", mem_limit=" << mem_limit
+              << ", max_queries=" << max_queries;
+    _groups.emplace(name, std::move(group));
+    return Status::OK();
+}
+
+} // namespace doris
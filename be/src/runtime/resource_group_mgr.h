@@ -0,0 +1,106 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "common/status.h"
+#include "gen_cpp/Types_types.h"
+#include "util/uid_util.h"
+
+namespace doris {
+
+class CgroupsMgr;
+class FairThreadPool;
+class MemTracker;
+class RuntimeState;
+
+// A named share of the Backend that a query runs in, selected by the query option
+// resource_group. A group may have
+//  - its own scanner thread pool, so its scans don't queue behind those of other groups;
+//  - a cpu cgroup with its own cpu.shares, which its scanner threads are assigned to;
+//  - a mem tracker with a limit, the parent of the mem trackers of its queries;
+//  - a limit of the queries running at the same time on this Backend.
+class ResourceGroup {
+public:
+    explicit ResourceGroup(const std::string& name) : _name(name) {}
+    ~ResourceGroup();
+
+    const std::string& name() const { return _name; }
+
+    // The pool to run the scanners of the queries in this group, nullptr to use the
+    // global one.
+    FairThreadPool* scan_thread_pool() const { return _scan_thread_pool.get(); }
+
+    // The cgroup to assign the scanner threads to, empty if none.
+    const std::string& cgroup() const { return _cgroup; }
+
+    const std::shared_ptr<MemTracker>& mem_tracker() const { return _mem_tracker; }
+
+    // Takes a slot for the query of 'state' if it's the first instance of it, waiting
+    // up to config::fragment_admission_timeout_ms while max_queries queries are running.
+    Status admit(RuntimeState* state);
+
+    // Called when an instance is closed, frees the slot of its query with the last one.
+    void release(const TUniqueId& fragment_instance_id);
+
+private:
+    friend class ResourceGroupMgr;
+
+    const std::string _name;
+    std::unique_ptr<FairThreadPool> _scan_thread_pool;
+    std::string _cgroup;
+    std::shared_ptr<MemTracker> _mem_tracker;
+    // 0 means no limit.
+    int _max_queries = 0;
+
+    std::mutex _lock;
+    std::condition_variable _cv;
+    // The admitted queries and their number of admitted instances.
+    std::unordered_map<TUniqueId, int> _queries;
+    // The admitted instances and their queries.
+    std::unordered_map<TUniqueId, TUniqueId> _instances;
+};
+
+// The resource groups of this Backend, defined by config::resource_groups.
+class ResourceGroupMgr {
+public:
+    ResourceGroupMgr() = default;
+
+    // Creates the groups as configured. 'cgroups_mgr' is used to create the cgroups of
+    // the groups with cpu_shares, it must have been initialized.
+    Status init(const std::string& config, const std::shared_ptr<MemTracker>& process_mem_tracker,
+                CgroupsMgr* cgroups_mgr);
+
+    // Returns the group named 'name' or nullptr if there is no such group.
+    ResourceGroup* get(const std::string& name) const;
+
+private:
+    Status _parse_group(const std::string& spec, const std::shared_ptr<MemTracker>& parent,
+                        CgroupsMgr* cgroups_mgr);
+
+    // Never changed after init().
+    std::map<std::string, std::unique_ptr<ResourceGroup>> _groups;
+};
+
+} // namespace doris
@@ -166,8 +166,8 @@ Status KafkaDataConsumerGroup::start_all(StreamLoadContext* ctx) {
                     << ", partition: " << msg->partition() << ", offset: " << msg->offset()
                     << ", len: " << msg->len();
 
-            (kafka_pipe.get()->*append_data)(static_cast<const char*>(msg->payload()),
-                                             static_cast<size_t>(msg->len()));
+            st = (kafka_pipe.get()->*append_data)(static_cast<const char*>(msg->payload()),
+                                                  static_cast<size_t>(msg->len()));
 
             if (st.ok()) {
                 left_rows--;
@@ -30,7 +30,9 @@ class DataConsumerGroup {
 public:
     typedef std::function<void(const Status&)> ConsumeFinishCallback;
 
-    DataConsumerGroup() : _grp_id(UniqueId::gen_uid()), _thread_pool(3, 10), _counter(0) {}
+    // 'consumer_num' consumers are added, each of them runs on a thread of its own.
+    explicit DataConsumerGroup(size_t consumer_num)
+            : _grp_id(UniqueId::gen_uid()), _thread_pool(consumer_num, 10), _counter(0) {}
 
     virtual ~DataConsumerGroup() { _consumers.clear(); }
 
@@ -63,7 +65,8 @@ protected:
 // for kafka
 class KafkaDataConsumerGroup : public DataConsumerGroup {
 public:
-    KafkaDataConsumerGroup() : DataConsumerGroup(), _queue(500) {}
+    explicit KafkaDataConsumerGroup(size_t consumer_num)
+            : DataConsumerGroup(consumer_num), _queue(500) {}
 
     virtual ~KafkaDataConsumerGroup();
 
@@ -19,6 +19,7 @@
 
 #include <thread>
 
+#include "common/config.h"
 #include "common/status.h"
 #include "gen_cpp/BackendService_types.h"
 #include "gen_cpp/FrontendService_types.h"
@@ -217,7 +218,10 @@ void RoutineLoadTaskExecutor::exec_task(StreamLoadContext* ctx, DataConsumerPool
     std::shared_ptr<StreamLoadPipe> pipe;
     switch (ctx->load_src_type) {
     case TLoadSourceType::KAFKA: {
-        pipe = std::make_shared<KafkaConsumerPipe>();
+        // the csv messages are appended to chunks of routine_load_pipe_chunk_bytes, which the
+        // scanners take as they are
+        pipe = std::make_shared<KafkaConsumerPipe>(config::stream_load_pipe_buffer_bytes,
+                                                   config::routine_load_pipe_chunk_bytes);
         Status st = std::static_pointer_cast<KafkaDataConsumerGroup>(consumer_grp)
                             ->assign_topic_partitions(ctx);
         if (!st.ok()) {
@@ -17,6 +17,8 @@
 
 #include "runtime/row_batch.h"
 
+#include "service/brpc.h"
+
 #include <snappy/snappy.h>
 #include <stdint.h> // for intptr_t
 
@@ -28,6 +30,7 @@
 //#include "runtime/mem_tracker.h"
 #include "gen_cpp/Data_types.h"
 #include "gen_cpp/data.pb.h"
+#include "util/block_compression.h"
 #include "util/debug_util.h"
 
 using std::vector;
@@ -71,6 +74,10 @@ RowBatch::RowBatch(const RowDescriptor& row_desc, int capacity, MemTracker* mem_
 // to allocated string data in special mempool
 // (change via python script that runs over Data_types.cc)
 RowBatch::RowBatch(const RowDescriptor& row_desc, const PRowBatch& input_batch, MemTracker* tracker)
+        : RowBatch(row_desc, input_batch, nullptr, tracker) {}
+
+RowBatch::RowBatch(const RowDescriptor& row_desc, const PRowBatch& input_batch,
+                   const butil::IOBuf* attachment, MemTracker* tracker)
         : _mem_tracker(tracker),
           _has_in_flight_row(false),
           _num_rows(input_batch.num_rows()),
@@ -95,11 +102,41 @@ RowBatch::RowBatch(const RowDescriptor& row_desc, const PRowBatch& input_batch,
         _tuple_ptrs = reinterpret_cast<Tuple**>(_tuple_data_pool->allocate(_tuple_ptrs_size));
     }
 
+    // the tuple data as received
+    const char* input_data = input_batch.tuple_data().data();
+    size_t input_size = input_batch.tuple_data().size();
+    std::string contiguous_data;
+    bool in_attachment = input_batch.tuple_data_in_attachment();
+    DCHECK(!in_attachment || attachment != nullptr);
+    if (in_attachment) {
+        input_size = attachment->size();
+        if (attachment->backing_block_num() == 1) {
+            input_data = attachment->backing_block(0).data();
+        } else if (input_batch.is_compressed()) {
+            // codecs need contiguous input, uncompressed data is copied block by block below
+            contiguous_data = attachment->to_string();
+            input_data = contiguous_data.data();
+        } else {
+            input_data = nullptr;
+        }
+    }
+
     uint8_t* tuple_data = nullptr;
-    if (input_batch.is_compressed()) {
+    if (input_batch.is_compressed() && input_batch.has_compress_type() &&
+        input_batch.compress_type() != segment_v2::CompressionTypePB::SNAPPY) {
+        const BlockCompressionCodec* codec = nullptr;
+        Status st = get_block_compression_codec(input_batch.compress_type(), &codec);
+        DCHECK(st.ok() && codec != nullptr) << "unknown compress type "
+                                            << input_batch.compress_type();
+        size_t uncompressed_size = input_batch.uncompressed_size();
+        tuple_data = reinterpret_cast<uint8_t*>(_tuple_data_pool->allocate(uncompressed_size));
+        Slice output(tuple_data, uncompressed_size);
+        st = codec->decompress(Slice(input_data, input_size), &output);
+        DCHECK(st.ok()) << "decompress tuple data failed: " << st.get_error_msg();
+    } else if (input_batch.is_compressed()) {
         // Decompress tuple data into data pool
-        const char* compressed_data = input_batch.tuple_data().c_str();
-        size_t compressed_size = input_batch.tuple_data().size();
+        const char* compressed_data = input_data;
+        size_t compressed_size = input_size;
         size_t uncompressed_size = 0;
         bool success =
                 snappy::GetUncompressedLength(compressed_data, compressed_size, &uncompressed_size);
@@ -108,47 +145,63 @@ RowBatch::RowBatch(const RowDescriptor& row_desc, const PRowBatch& input_batch,
         success = snappy::RawUncompress(compressed_data, compressed_size,
                                         reinterpret_cast<char*>(tuple_data));
         DCHECK(success) << "snappy::RawUncompress failed";
+    } else if (in_attachment && input_data != nullptr && contiguous_data.empty() &&
+               config::deserialize_row_batch_in_place &&
+               reinterpret_cast<uintptr_t>(input_data) % MemPool::DEFAULT_ALIGNMENT == 0) {
+        // The tuples point into the received buffer, whose reference is transferred with
+        // the other resources of the batch. Its offsets are converted in place, which only
+        // touches the bytes of this batch.
+        _agg_object_pool->add(new butil::IOBuf(*attachment));
+        tuple_data = reinterpret_cast<uint8_t*>(const_cast<char*>(input_data));
     } else {
         // Tuple data uncompressed, copy directly into data pool
-        tuple_data = _tuple_data_pool->allocate(input_batch.tuple_data().size());
-        memcpy(tuple_data, input_batch.tuple_data().c_str(), input_batch.tuple_data().size());
+        tuple_data = _tuple_data_pool->allocate(input_size);
+        if (input_data != nullptr) {
+            memcpy(tuple_data, input_data, input_size);
+        } else {
+            attachment->copy_to(tuple_data, input_size);
+        }
     }
 
     // convert input_batch.tuple_offsets into pointers
-    int tuple_idx = 0;
-    for (auto offset : input_batch.tuple_offsets()) {
-        if (offset == -1) {
-            _tuple_ptrs[tuple_idx++] = nullptr;
-        } else {
-            _tuple_ptrs[tuple_idx++] = reinterpret_cast<Tuple*>(tuple_data + offset);
-        }
+    const int32_t* tuple_offsets = input_batch.tuple_offsets().data();
+    int num_tuples = input_batch.tuple_offsets_size();
+    for (int i = 0; i < num_tuples; ++i) {
+        _tuple_ptrs[i] = tuple_offsets[i] == -1
+                                 ? nullptr
+                                 : reinterpret_cast<Tuple*>(tuple_data + tuple_offsets[i]);
     }
 
     // Check whether we have slots that require offset-to-pointer conversion.
     if (!_row_desc.has_varlen_slots()) {
         return;
     }
-    const std::vector<TupleDescriptor*>& tuple_descs = _row_desc.tuple_descriptors();
+    convert_string_offsets(tuple_data);
+}
 
-    // For every unique tuple, convert string offsets contained in tuple data into
-    // pointers. Tuples were serialized in the order we are deserializing them in,
-    // so the first occurrence of a tuple will always have a higher offset than any tuple
-    // we already converted.
-    for (int i = 0; i < _num_rows; ++i) {
-        TupleRow* row = get_row(i);
-        std::vector<TupleDescriptor*>::const_iterator desc = tuple_descs.begin();
-        for (int j = 0; desc != tuple_descs.end(); ++desc, ++j) {
-            if ((*desc)->string_slots().empty()) {
-                continue;
-            }
-            Tuple* tuple = row->get_tuple(j);
-            if (tuple == nullptr) {
+void RowBatch::convert_string_offsets(uint8_t* tuple_data) {
+    const std::vector<TupleDescriptor*>& tuple_descs = _row_desc.tuple_descriptors();
+    std::vector<int> slot_offsets;
+    // A tuple descriptor at a time, convert the string offsets of its tuples in all the rows
+    // into pointers, with the offsets of its string slots resolved once.
+    for (int j = 0; j < tuple_descs.size(); ++j) {
+        const std::vector<SlotDescriptor*>& string_slots = tuple_descs[j]->string_slots();
+        if (string_slots.empty()) {
+            continue;
+        }
+        slot_offsets.clear();
+        for (auto slot : string_slots) {
+            DCHECK(slot->type().is_string_type());
+            slot_offsets.push_back(slot->tuple_offset());
+        }
+        Tuple** tuple_ptr = _tuple_ptrs + j;
+        for (int i = 0; i < _num_rows; ++i, tuple_ptr += _num_tuples_per_row) {
+            if (*tuple_ptr == nullptr) {
                 continue;
             }
-
-            for (auto slot : (*desc)->string_slots()) {
-                DCHECK(slot->type().is_string_type());
-                StringValue* string_val = tuple->get_string_slot(slot->tuple_offset());
+            char* tuple = reinterpret_cast<char*>(*tuple_ptr);
+            for (int slot_offset : slot_offsets) {
+                StringValue* string_val = reinterpret_cast<StringValue*>(tuple + slot_offset);
                 int offset = reinterpret_cast<intptr_t>(string_val->ptr);
                 string_val->ptr = reinterpret_cast<char*>(tuple_data + offset);
 
@@ -229,41 +282,7 @@ RowBatch::RowBatch(const RowDescriptor& row_desc, const TRowBatch& input_batch,
     if (!_row_desc.has_varlen_slots()) {
         return;
     }
-    const std::vector<TupleDescriptor*>& tuple_descs = _row_desc.tuple_descriptors();
-
-    // For every unique tuple, convert string offsets contained in tuple data into
-    // pointers. Tuples were serialized in the order we are deserializing them in,
-    // so the first occurrence of a tuple will always have a higher offset than any tuple
-    // we already converted.
-    for (int i = 0; i < _num_rows; ++i) {
-        TupleRow* row = get_row(i);
-        std::vector<TupleDescriptor*>::const_iterator desc = tuple_descs.begin();
-        for (int j = 0; desc != tuple_descs.end(); ++desc, ++j) {
-            if ((*desc)->string_slots().empty()) {
-                continue;
-            }
-
-            Tuple* tuple = row->get_tuple(j);
-            if (tuple == NULL) {
-                continue;
-            }
-
-            std::vector<SlotDescriptor*>::const_iterator slot = (*desc)->string_slots().begin();
-            for (; slot != (*desc)->string_slots().end(); ++slot) {
-                DCHECK((*slot)->type().is_string_type());
-                StringValue* string_val = tuple->get_string_slot((*slot)->tuple_offset());
-
-                int offset = reinterpret_cast<intptr_t>(string_val->ptr);
-                string_val->ptr = reinterpret_cast<char*>(tuple_data + offset);
-
-                // Why we do this mask? Field len of StringValue is changed from int to size_t in
-                // Doris 0.11. When upgrading, some bits of len sent from 0.10 is random value,
-                // this works fine in version 0.10, however in 0.11 this will lead to an invalid
-                // length. So we make the high bits zero here.
-                string_val->len &= 0x7FFFFFFFL;
-            }
-        }
-    }
+    convert_string_offsets(tuple_data);
 }
 
 void RowBatch::clear() {
@@ -337,7 +356,7 @@ int RowBatch::serialize(TRowBatch* output_batch) {
 
     DCHECK_EQ(offset, size);
 
-    if (config::compress_rowbatches && size > 0) {
+    if (compress_type == segment_v2::CompressionTypePB::SNAPPY && size > 0) {
         // Try compressing tuple_data to _compression_scratch, swap if compressed data is
         // smaller
         int max_compressed_size = snappy::MaxCompressedLength(size);
@@ -366,6 +385,13 @@ int RowBatch::serialize(TRowBatch* output_batch) {
 }
 
 int RowBatch::serialize(PRowBatch* output_batch) {
+    return serialize(output_batch, config::compress_rowbatches
+                                           ? segment_v2::CompressionTypePB::SNAPPY
+                                           : segment_v2::CompressionTypePB::NO_COMPRESSION);
+}
+
+int RowBatch::serialize(PRowBatch* output_batch, segment_v2::CompressionTypePB compress_type,
+                        int compress_level) {
     // num_rows
     output_batch->set_num_rows(_num_rows);
     // row_tuples
@@ -375,6 +401,9 @@ int RowBatch::serialize(PRowBatch* output_batch) {
     output_batch->mutable_tuple_offsets()->Reserve(_num_rows * _num_tuples_per_row);
     // is_compressed
     output_batch->set_is_compressed(false);
+    output_batch->clear_compress_type();
+    output_batch->clear_uncompressed_size();
+    output_batch->clear_tuple_data_in_attachment();
     // tuple data
     int size = total_byte_size();
     auto mutable_tuple_data = output_batch->mutable_tuple_data();
@@ -403,7 +432,7 @@ int RowBatch::serialize(PRowBatch* output_batch) {
 
     DCHECK_EQ(offset, size);
 
-    if (config::compress_rowbatches && size > 0) {
+    if (compress_type == segment_v2::CompressionTypePB::SNAPPY && size > 0) {
         // Try compressing tuple_data to _compression_scratch, swap if compressed data is
         // smaller
         int max_compressed_size = snappy::MaxCompressedLength(size);
@@ -423,6 +452,30 @@ int RowBatch::serialize(PRowBatch* output_batch) {
         }
 
         VLOG_ROW << "uncompressed size: " << size << ", compressed size: " << compressed_size;
+    } else if (compress_type != segment_v2::CompressionTypePB::NO_COMPRESSION && size > 0) {
+        const BlockCompressionCodec* codec = nullptr;
+        Status st = get_block_compression_codec(compress_type, compress_level, &codec);
+        if (st.ok() && codec != nullptr) {
+            size_t max_compressed_size = codec->max_compressed_len(size);
+            if (_compression_scratch.size() < max_compressed_size) {
+                _compression_scratch.resize(max_compressed_size);
+            }
+            Slice compressed(_compression_scratch.data(), max_compressed_size);
+            st = codec->compress(*mutable_tuple_data, &compressed);
+            if (st.ok() && compressed.size < static_cast<size_t>(size)) {
+                _compression_scratch.resize(compressed.size);
+                mutable_tuple_data->swap(_compression_scratch);
+                output_batch->set_is_compressed(true);
+                output_batch->set_compress_type(compress_type);
+                output_batch->set_uncompressed_size(size);
+            }
+            VLOG_ROW << "uncompressed size: " << size << ", compressed size: " << compressed.size;
+        }
+        if (!st.ok()) {
+            // send it uncompressed
+            LOG(WARNING) << "failed to compress row batch, compress_type=" << compress_type
+                         << ", err=" << st.get_error_msg();
+        }
     }
 
     // The size output_batch would be if we didn't compress tuple_data (will be equal to
@@ -604,6 +657,18 @@ void RowBatch::acquire_state(RowBatch* src) {
     src->transfer_resource_ownership(this);
 }
 
+void RowBatch::deep_copy_to(RowBatch* dst) {
+    DCHECK_EQ(dst->_num_tuples_per_row, _num_tuples_per_row);
+    DCHECK_EQ(dst->_num_rows, 0);
+    DCHECK_GE(dst->_capacity, _num_rows);
+    dst->add_rows(_num_rows);
+    const std::vector<TupleDescriptor*>& tuple_descs = _row_desc.tuple_descriptors();
+    for (int i = 0; i < _num_rows; ++i) {
+        get_row(i)->deep_copy(dst->get_row(i), tuple_descs, dst->_tuple_data_pool.get(), false);
+    }
+    dst->commit_rows(_num_rows);
+}
+
 // TODO: consider computing size of batches as they are built up
 int RowBatch::total_byte_size() {
     int result = 0;
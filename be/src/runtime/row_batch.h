@@ -24,6 +24,7 @@
 
 #include "codegen/doris_ir.h"
 #include "common/logging.h"
+#include "gen_cpp/segment_v2.pb.h"
 #include "runtime/buffered_block_mgr2.h" // for BufferedBlockMgr2::Block
 // #include "runtime/buffered_tuple_stream2.inline.h"
 #include "runtime/bufferpool/buffer_pool.h"
@@ -32,6 +33,10 @@
 #include "runtime/mem_pool.h"
 #include "runtime/row_batch_interface.hpp"
 
+namespace butil {
+class IOBuf;
+}
+
 namespace doris {
 
 class BufferedTupleStream2;
@@ -94,6 +99,11 @@ public:
 
     RowBatch(const RowDescriptor& row_desc, const PRowBatch& input_batch, MemTracker* tracker);
 
+    // Same as above, but if input_batch.tuple_data_in_attachment() is true, the tuple data
+    // is read from 'attachment', i.e. the brpc attachment of the request.
+    RowBatch(const RowDescriptor& row_desc, const PRowBatch& input_batch,
+             const butil::IOBuf* attachment, MemTracker* tracker);
+
     // Releases all resources accumulated at this row batch.  This includes
     //  - tuple_ptrs
     //  - tuple mem pool data
@@ -349,6 +359,12 @@ public:
     // if tuple_data is actually uncompressed).
     int serialize(TRowBatch* output_batch);
     int serialize(PRowBatch* output_batch);
+    // Same as above, but tuple_data is compressed by 'compress_type' instead of snappy,
+    // with 'compress_level' if the codec supports it (0 means its default level).
+    // Codecs other than SNAPPY are recorded in output_batch.compress_type, so the
+    // receivers must be able to decompress it.
+    int serialize(PRowBatch* output_batch, segment_v2::CompressionTypePB compress_type,
+                  int compress_level = 0);
 
     // Utility function: returns total size of batch.
     static int get_batch_size(const TRowBatch& batch);
@@ -395,6 +411,10 @@ private:
     // Close owned tuple streams and delete if needed.
     void close_tuple_streams();
 
+    // Convert the offsets of the string slots of deserialized tuples into pointers into
+    // 'tuple_data'.
+    void convert_string_offsets(uint8_t* tuple_data);
+
     // All members need to be handled in RowBatch::swap()
 
     bool _has_in_flight_row; // if true, last row hasn't been committed yet
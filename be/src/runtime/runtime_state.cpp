@@ -35,6 +35,7 @@
 #include "runtime/initial_reservations.h"
 #include "runtime/load_path_mgr.h"
 #include "runtime/mem_tracker.h"
+#include "runtime/resource_group_mgr.h"
 #include "util/cpu_info.h"
 #include "util/disk_info.h"
 #include "util/file_utils.h"
@@ -149,6 +150,14 @@ RuntimeState::~RuntimeState() {
         _buffer_reservation->Close();
     }
 
+    if (_exec_env != nullptr && _exec_env->mem_admission_controller() != nullptr) {
+        _exec_env->mem_admission_controller()->release(_fragment_instance_id);
+    }
+
+    if (_resource_group != nullptr) {
+        _resource_group->release(_fragment_instance_id);
+    }
+
     if (_exec_env != nullptr && _exec_env->thread_mgr() != nullptr) {
         _exec_env->thread_mgr()->unregister_pool(_resource_pool);
     }
@@ -212,9 +221,21 @@ Status RuntimeState::init_mem_trackers(const TUniqueId& query_id) {
     auto mem_tracker_counter = ADD_COUNTER(&_profile, "MemoryLimit", TUnit::BYTES);
     mem_tracker_counter->set(bytes_limit);
 
+    std::shared_ptr<MemTracker> parent_mem_tracker = _exec_env->process_mem_tracker();
+    if (_query_options.__isset.resource_group && !_query_options.resource_group.empty()) {
+        ResourceGroupMgr* resource_group_mgr = _exec_env->resource_group_mgr();
+        if (resource_group_mgr != nullptr) {
+            _resource_group = resource_group_mgr->get(_query_options.resource_group);
+        }
+        if (_resource_group == nullptr) {
+            return Status::InvalidArgument("Unknown resource group " +
+                                           _query_options.resource_group);
+        }
+        parent_mem_tracker = _resource_group->mem_tracker();
+    }
     _query_mem_tracker = MemTracker::CreateTracker(
             bytes_limit, std::string("RuntimeState: query ") + runtime_profile()->name(),
-            _exec_env->process_mem_tracker());
+            parent_mem_tracker);
     _instance_mem_tracker = MemTracker::CreateTracker(
             &_profile, -1, std::string("RuntimeState: instance ") + runtime_profile()->name(),
             _query_mem_tracker);
@@ -232,7 +253,8 @@ Status RuntimeState::init_mem_trackers(const TUniqueId& query_id) {
     _initial_reservations = _obj_pool->add(
             new InitialReservations(_obj_pool.get(), _buffer_reservation, _query_mem_tracker,
                                     _query_options.initial_reservation_total_claims));
-    RETURN_IF_ERROR(_initial_reservations->Init(_query_id, min_reservation()));
+    // The initial reservations are taken when the instance is admitted, see
+    // MemAdmissionController.
     DCHECK_EQ(0, _initial_reservation_refcnt.load());
 
     if (_instance_buffer_reservation != nullptr) {
@@ -417,6 +439,7 @@ void RuntimeState::append_error_msg_to_file(const std::string& line, const std::
     if (_query_options.query_type != TQueryType::LOAD) {
         return;
     }
+    boost::lock_guard<boost::mutex> l(_error_log_file_lock);
     // If file havn't been opened, open it here
     if (_error_log_file == nullptr) {
         Status status = create_error_log_file();
@@ -56,6 +56,7 @@ class BufferedBlockMgr2;
 class LoadErrorHub;
 class ReservationTracker;
 class InitialReservations;
+class ResourceGroup;
 class RowDescriptor;
 
 // A collection of items that are part of the global state of a
@@ -125,6 +126,7 @@ public:
     std::shared_ptr<MemTracker> fragment_mem_tracker() { return _fragment_mem_tracker; }
 
     std::shared_ptr<MemTracker> instance_mem_tracker() { return _instance_mem_tracker; }
+    std::shared_ptr<MemTracker> query_mem_tracker() { return _query_mem_tracker; }
     ThreadResourceMgr::ResourcePool* resource_pool() { return _resource_pool; }
 
     void set_fragment_root_id(PlanNodeId id) {
@@ -153,6 +155,9 @@ public:
         return _block_mgr2.get();
     }
 
+    // May be NULL, e.g. before prepare.
+    const boost::shared_ptr<BufferedBlockMgr2>& shared_block_mgr2() const { return _block_mgr2; }
+
     Status query_status() {
         boost::lock_guard<boost::mutex> l(_process_status_lock);
         return _process_status;
@@ -345,6 +350,9 @@ public:
     // the following getters are only valid after Prepare()
     InitialReservations* initial_reservations() const { return _initial_reservations; }
 
+    // The resource group selected by the query option resource_group, nullptr if none.
+    ResourceGroup* resource_group() const { return _resource_group; }
+
     ReservationTracker* buffer_reservation() const { return _buffer_reservation; }
 
     const std::vector<TTabletCommitInfo>& tablet_commit_infos() const {
@@ -481,6 +489,8 @@ private:
     int64_t _error_row_number;
     std::string _error_log_file_path;
     std::ofstream* _error_log_file = nullptr; // error file path, absolute path
+    // protects _error_log_file, which the scanners parsing a stream in parallel write to
+    boost::mutex _error_log_file_lock;
     std::unique_ptr<LoadErrorHub> _error_hub;
     std::vector<TTabletCommitInfo> _tablet_commit_infos;
 
@@ -499,6 +509,9 @@ private:
     /// 'buffer_reservation_'. Owned by 'obj_pool_'. Set in Prepare().
     InitialReservations* _initial_reservations = nullptr;
 
+    // Owned by the ResourceGroupMgr of _exec_env. Set in init_mem_trackers().
+    ResourceGroup* _resource_group = nullptr;
+
     /// Number of fragment instances executing, which may need to claim
     /// from 'initial_reservations_'.
     /// TODO: not needed if we call ReleaseResources() in a timely manner (IMPALA-1575).
@@ -0,0 +1,51 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "runtime/shared_hash_table_mgr.h"
+
+namespace doris {
+
+std::shared_ptr<SharedHashTable> SharedHashTableMgr::get(const TUniqueId& query_id,
+                                                         int node_id) {
+    std::lock_guard<std::mutex> l(_lock);
+    std::weak_ptr<SharedHashTable>& entry = _tables[query_id][node_id];
+    std::shared_ptr<SharedHashTable> table = entry.lock();
+    if (table == nullptr) {
+        table.reset(new SharedHashTable());
+        entry = table;
+    }
+    return table;
+}
+
+void SharedHashTableMgr::release(const TUniqueId& query_id, int node_id,
+                                 std::shared_ptr<SharedHashTable>* table) {
+    std::lock_guard<std::mutex> l(_lock);
+    table->reset();
+    auto query = _tables.find(query_id);
+    if (query == _tables.end()) {
+        return;
+    }
+    auto node = query->second.find(node_id);
+    if (node != query->second.end() && node->second.expired()) {
+        query->second.erase(node);
+    }
+    if (query->second.empty()) {
+        _tables.erase(query);
+    }
+}
+
+} // namespace doris
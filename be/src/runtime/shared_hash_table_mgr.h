@@ -0,0 +1,72 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "common/status.h"
+#include "gen_cpp/Types_types.h"
+#include "util/hash_util.hpp"
+
+namespace doris {
+
+class HashTable;
+class MemPool;
+class MemTracker;
+
+// The hash table of a broadcast join, built once by one fragment instance on this
+// backend and probed by the other instances of the fragment.
+struct SharedHashTable {
+    std::mutex lock;
+    // Notified when 'done' is set
+    std::condition_variable cv;
+    // Set by the instance which builds the table, the others wait for it
+    bool building = false;
+    // Set when the table is built or the build failed
+    bool done = false;
+    Status status;
+
+    // The tracker the build is charged to, declared first to be released last
+    std::shared_ptr<MemTracker> mem_tracker;
+    // Holds the tuples of the rows in 'table'
+    std::shared_ptr<MemPool> build_pool;
+    std::shared_ptr<HashTable> table;
+};
+
+// Hands out the SharedHashTable of a join node of a query to the fragment instances
+// running it on this backend. A table is kept as long as an instance holds it.
+class SharedHashTableMgr {
+public:
+    // Returns the table of join 'node_id' of query 'query_id', a new one if no
+    // instance holds it.
+    std::shared_ptr<SharedHashTable> get(const TUniqueId& query_id, int node_id);
+
+    // Drops '*table' got by get(), and forgets it if no other instance holds it.
+    void release(const TUniqueId& query_id, int node_id, std::shared_ptr<SharedHashTable>* table);
+
+private:
+    std::mutex _lock;
+    // query id -> join node id -> table
+    std::unordered_map<TUniqueId, std::unordered_map<int, std::weak_ptr<SharedHashTable>>>
+            _tables;
+};
+
+} // namespace doris
@@ -99,35 +99,16 @@ private:
     SortedRunMerger* _parent;
 };
 
-void SortedRunMerger::heapify(int parent_index) {
-    int left_index = 2 * parent_index + 1;
-    int right_index = left_index + 1;
-    if (left_index >= _min_heap.size()) {
-        return;
-    }
-    int least_child = 0;
-    // Find the least child of parent.
-    if (right_index >= _min_heap.size() ||
-        _compare_less_than(_min_heap[left_index]->current_row(),
-                           _min_heap[right_index]->current_row())) {
-        least_child = left_index;
-    } else {
-        least_child = right_index;
-    }
-
-    // If the parent is out of place, swap it with the least child and invoke
-    // heapify recursively.
-    if (_compare_less_than(_min_heap[least_child]->current_row(),
-                           _min_heap[parent_index]->current_row())) {
-        iter_swap(_min_heap.begin() + least_child, _min_heap.begin() + parent_index);
-        heapify(least_child);
-    }
+bool SortedRunMerger::RunLessThan::operator()(int lhs, int rhs) const {
+    return merger->_compare_less_than(merger->_runs[lhs]->current_row(),
+                                      merger->_runs[rhs]->current_row());
 }
 
 SortedRunMerger::SortedRunMerger(const TupleRowComparator& compare_less_than,
                                  RowDescriptor* row_desc, RuntimeProfile* profile,
                                  bool deep_copy_input)
-        : _compare_less_than(compare_less_than),
+        : _loser_tree(RunLessThan{this}),
+          _compare_less_than(compare_less_than),
           _input_row_desc(row_desc),
           _deep_copy_input(deep_copy_input) {
     _get_next_timer = ADD_TIMER(profile, "MergeGetNext");
@@ -135,35 +116,31 @@ SortedRunMerger::SortedRunMerger(const TupleRowComparator& compare_less_than,
 }
 
 Status SortedRunMerger::prepare(const vector<RunBatchSupplier>& input_runs) {
-    DCHECK_EQ(_min_heap.size(), 0);
-    _min_heap.reserve(input_runs.size());
+    DCHECK_EQ(_runs.size(), 0);
+    _runs.reserve(input_runs.size());
     BOOST_FOREACH (const RunBatchSupplier& input_run, input_runs) {
         BatchedRowSupplier* new_elem = _pool.add(new BatchedRowSupplier(this, input_run));
         DCHECK(new_elem != NULL);
         bool empty = false;
         RETURN_IF_ERROR(new_elem->init(&empty));
         if (!empty) {
-            _min_heap.push_back(new_elem);
+            _runs.push_back(new_elem);
         }
     }
 
-    // Construct the min heap from the sorted runs.
-    const int last_parent = (_min_heap.size() / 2) - 1;
-    for (int i = last_parent; i >= 0; --i) {
-        heapify(i);
-    }
+    _loser_tree.init(_runs.size());
     return Status::OK();
 }
 
 Status SortedRunMerger::get_next(RowBatch* output_batch, bool* eos) {
     ScopedTimer<MonotonicStopWatch> timer(_get_next_timer);
-    if (_min_heap.empty()) {
+    if (_loser_tree.winner() < 0) {
         *eos = true;
         return Status::OK();
     }
 
     while (!output_batch->at_capacity()) {
-        BatchedRowSupplier* min = _min_heap[0];
+        BatchedRowSupplier* min = _runs[_loser_tree.winner()];
         int output_row_index = output_batch->add_row();
         TupleRow* output_row = output_batch->get_row(output_row_index);
         if (_deep_copy_input) {
@@ -181,17 +158,13 @@ Status SortedRunMerger::get_next(RowBatch* output_batch, bool* eos) {
         // Advance to the next element in min. output_batch is supplied to transfer
         // resource ownership if the input batch in min is exhausted.
         RETURN_IF_ERROR(min->next(_deep_copy_input ? NULL : output_batch, &min_run_complete));
-        if (min_run_complete) {
-            // Remove the element from the heap.
-            iter_swap(_min_heap.begin(), _min_heap.end() - 1);
-            _min_heap.pop_back();
-            if (_min_heap.empty()) break;
+        _loser_tree.update_winner(min_run_complete);
+        if (_loser_tree.winner() < 0) {
+            break;
         }
-
-        heapify(0);
     }
 
-    *eos = _min_heap.empty();
+    *eos = _loser_tree.winner() < 0;
     return Status::OK();
 }
 
@@ -22,6 +22,7 @@
 #include <boost/thread/mutex.hpp>
 
 #include "common/object_pool.h"
+#include "util/loser_tree.h"
 #include "util/tuple_row_compare.h"
 
 namespace doris {
@@ -32,8 +33,8 @@ class RuntimeProfile;
 
 // SortedRunMerger is used to merge multiple sorted runs of tuples. A run is a sorted
 // sequence of row batches, which are fetched from a RunBatchSupplier function object.
-// Merging is implemented using a binary min-heap that maintains the run with the next
-// tuple in sorted order at the top of the heap.
+// Merging is implemented using a LoserTree that maintains the run with the next tuple
+// in sorted order as the winner.
 //
 // Merged batches of rows are retrieved from SortedRunMerger via calls to get_next().
 // The merger is constructed with a boolean flag deep_copy_input.
@@ -54,8 +55,7 @@ public:
     ~SortedRunMerger() {}
 
     // Prepare this merger to merge and return rows from the sorted runs in 'input_runs'.
-    // Retrieves the first batch from each run and sets up the binary heap implementing
-    // the priority queue.
+    // Retrieves the first batch from each run and sets up the loser tree.
     Status prepare(const std::vector<RunBatchSupplier>& input_runs);
 
     // Return the next batch of sorted rows from this merger.
@@ -68,18 +68,19 @@ public:
 private:
     class BatchedRowSupplier;
 
-    // Assuming the element at parent_index is the only out of place element in the heap,
-    // restore the heap property (i.e. swap elements so parent <= children).
-    void heapify(int parent_index);
+    // Compares the current rows of two runs in _runs.
+    struct RunLessThan {
+        SortedRunMerger* merger;
+        bool operator()(int lhs, int rhs) const;
+    };
 
-    // The binary min-heap used to merge rows from the sorted input runs. Since the heap is
-    // stored in a 0-indexed array, the 0-th element is the minimum element in the heap,
-    // and the children of the element at index i are 2*i+1 and 2*i+2. The heap property is
-    // that row of the parent element is <= the rows of the child elements according to the
-    // comparator _compare_less_than.
-    // The BatchedRowSupplier objects used in the _min_heap are owned by this
+    // The non-empty input runs. The BatchedRowSupplier objects are owned by this
     // SortedRunMerger instance.
-    std::vector<BatchedRowSupplier*> _min_heap;
+    std::vector<BatchedRowSupplier*> _runs;
+
+    // Tournament tree on the indices of _runs, its winner is the run with the least
+    // current row according to _compare_less_than.
+    LoserTree<RunLessThan> _loser_tree;
 
     // Row comparator. Returns true if lhs < rhs.
     TupleRowComparator _compare_less_than;
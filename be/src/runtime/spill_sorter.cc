@@ -17,16 +17,21 @@
 
 #include "runtime/spill_sorter.h"
 
+#include <algorithm>
 #include <boost/mem_fn.hpp>
+#include <limits>
 #include <sstream>
 #include <string>
 
 #include "runtime/buffered_block_mgr2.h"
+#include "runtime/datetime_value.h"
 #include "runtime/row_batch.h"
 #include "runtime/runtime_state.h"
 #include "runtime/sorted_run_merger.h"
 #include "util/debug_util.h"
+#include "util/radix_sort.h"
 #include "util/runtime_profile.h"
+#include "util/types.h"
 
 using std::deque;
 using std::string;
@@ -42,6 +47,9 @@ namespace doris {
 // Number of pinned blocks required for a merge.
 const int BLOCKS_REQUIRED_FOR_MERGE = 3;
 
+// Sorting less tuples than this by radix sort doesn't pay off its passes
+const int64_t MIN_TUPLES_TO_RADIX_SORT = 256;
+
 // Error message when pinning fixed or variable length blocks failed.
 // TODO: Add the node id that initiated the sort
 const string PIN_FAILED_ERROR_MSG_1 = "Failed to pin block for ";
@@ -379,8 +387,137 @@ private:
 
     // Swaps tuples pointed to by left and right using the swap buffer.
     void swap(uint8_t* left, uint8_t* right);
+
+    // Index of a tuple in _run and an order-preserving prefix of its first ordering expr.
+    struct SortEntry {
+        uint64_t prefix;
+        int64_t index;
+    };
+    struct SortEntryRadixSortTraits;
+
+    // Sorts _run by radix sort on the prefixes of its first ordering expr, evaluated
+    // once per tuple, and compares the tuples only to order those of equal prefixes.
+    // Returns false without touching _run if the expr has no such prefix.
+    bool radix_sort();
+
+    uint8_t* tuple_at(int64_t index) const {
+        return _run->_fixed_len_blocks[index / _block_capacity]->buffer() +
+               (index % _block_capacity) * _tuple_size;
+    }
+
+    // Moves the tuple at (*order)[i] of _run to position i, for all i.
+    void permute(std::vector<int64_t>* order);
 }; // class TupleSorter
 
+struct SpillSorter::TupleSorter::SortEntryRadixSortTraits {
+    using Element = SortEntry;
+    using Key = uint64_t;
+    using CountType = uint32_t;
+    using KeyBits = uint64_t;
+
+    static constexpr size_t PART_SIZE_BITS = 8;
+
+    using Transform = RadixSortIdentityTransform<KeyBits>;
+    using Allocator = RadixSortMallocAllocator;
+
+    static Key& extractKey(Element& elem) { return elem.prefix; }
+
+    static bool less(Key x, Key y) { return x < y; }
+};
+
+namespace {
+
+uint64_t flip_sign(int64_t value) {
+    return static_cast<uint64_t>(value) ^ (uint64_t(1) << 63);
+}
+
+// Return true if values of 'type' have a normalized prefix. '*exact' is set if the
+// prefixes of distinct values are distinct.
+bool has_normalized_prefix(PrimitiveType type, bool* exact) {
+    switch (type) {
+    case TYPE_BOOLEAN:
+    case TYPE_TINYINT:
+    case TYPE_SMALLINT:
+    case TYPE_INT:
+    case TYPE_BIGINT:
+        *exact = true;
+        return true;
+    case TYPE_LARGEINT:
+    case TYPE_DECIMALV2:
+    case TYPE_FLOAT:
+    case TYPE_DOUBLE:
+    case TYPE_DATE:
+    case TYPE_DATETIME:
+    case TYPE_CHAR:
+    case TYPE_VARCHAR:
+        *exact = false;
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Map a value of 'type' to an unsigned integer, such that a < b implies prefix(a) <=
+// prefix(b) and a == b implies prefix(a) == prefix(b) by RawValue::compare(). Like the
+// memcmp-comparable encodings of olap/key_coder.h, cut to their first 8 bytes.
+uint64_t normalized_prefix(const void* value, PrimitiveType type) {
+    switch (type) {
+    case TYPE_BOOLEAN:
+        return *reinterpret_cast<const bool*>(value);
+    case TYPE_TINYINT:
+        return flip_sign(*reinterpret_cast<const int8_t*>(value));
+    case TYPE_SMALLINT:
+        return flip_sign(*reinterpret_cast<const int16_t*>(value));
+    case TYPE_INT:
+        return flip_sign(*reinterpret_cast<const int32_t*>(value));
+    case TYPE_BIGINT:
+        return flip_sign(*reinterpret_cast<const int64_t*>(value));
+    case TYPE_LARGEINT:
+    case TYPE_DECIMALV2: {
+        // saturated, values out of the range of int64_t share the prefixes of its ends
+        __int128 v = reinterpret_cast<const PackedInt128*>(value)->value;
+        v = std::max<__int128>(v, std::numeric_limits<int64_t>::min());
+        v = std::min<__int128>(v, std::numeric_limits<int64_t>::max());
+        return flip_sign(static_cast<int64_t>(v));
+    }
+    case TYPE_FLOAT: {
+        // +0.0, so -0.0 which is equal to it gets the same prefix
+        float v = *reinterpret_cast<const float*>(value) + 0.0f;
+        uint32_t bits = 0;
+        memcpy(&bits, &v, sizeof(v));
+        bits = (bits & (uint32_t(1) << 31)) ? ~bits : bits | (uint32_t(1) << 31);
+        return static_cast<uint64_t>(bits) << 32;
+    }
+    case TYPE_DOUBLE: {
+        double v = *reinterpret_cast<const double*>(value) + 0.0;
+        uint64_t bits = 0;
+        memcpy(&bits, &v, sizeof(v));
+        return (bits & (uint64_t(1) << 63)) ? ~bits : bits | (uint64_t(1) << 63);
+    }
+    case TYPE_DATE:
+    case TYPE_DATETIME:
+        return flip_sign(reinterpret_cast<const DateTimeValue*>(value)->to_int64_datetime_packed());
+    case TYPE_CHAR:
+    case TYPE_VARCHAR: {
+        // Big endian load of the first bytes padded with zeros. Strings are compared by
+        // strncmp(), which doesn't look past a '\0', neither does the prefix.
+        const StringValue* v = reinterpret_cast<const StringValue*>(value);
+        uint64_t prefix = 0;
+        int len = std::min<int>(v->len, sizeof(prefix));
+        for (int i = 0; i < len && v->ptr[i] != '\0'; ++i) {
+            prefix |= static_cast<uint64_t>(static_cast<uint8_t>(v->ptr[i]))
+                      << (8 * (sizeof(prefix) - 1 - i));
+        }
+        return prefix;
+    }
+    default:
+        DCHECK(false) << "no normalized prefix for type " << type;
+        return 0;
+    }
+}
+
+} // namespace
+
 // SpillSorter::Run methods
 SpillSorter::Run::Run(SpillSorter* parent, TupleDescriptor* sort_tuple_desc, bool materialize_slots)
         : _sorter(parent),
@@ -889,10 +1026,101 @@ SpillSorter::TupleSorter::~TupleSorter() {
 
 void SpillSorter::TupleSorter::sort(Run* run) {
     _run = run;
-    sort_helper(TupleIterator(this, 0), TupleIterator(this, _run->_num_tuples));
+    if (_run->_num_tuples < MIN_TUPLES_TO_RADIX_SORT || !radix_sort()) {
+        sort_helper(TupleIterator(this, 0), TupleIterator(this, _run->_num_tuples));
+    }
     run->_is_sorted = true;
 }
 
+bool SpillSorter::TupleSorter::radix_sort() {
+    ExprContext* expr_ctx = _less_than_comp.lhs_key_expr_ctxs()[0];
+    PrimitiveType type = expr_ctx->root()->type().type;
+    bool exact = false;
+    if (!has_normalized_prefix(type, &exact) ||
+        _run->_num_tuples >= std::numeric_limits<uint32_t>::max()) {
+        return false;
+    }
+    bool is_asc = _less_than_comp.is_asc(0);
+    // tuples of equal prefixes may still be ordered by the first expr or the others
+    bool has_ties = !exact || _less_than_comp.lhs_key_expr_ctxs().size() > 1;
+
+    std::vector<SortEntry> entries;
+    entries.reserve(_run->_num_tuples);
+    // nulls are ordered before or after all values, and among them by the other exprs
+    std::vector<int64_t> nulls;
+    TupleIterator iter(this, 0);
+    for (int64_t i = 0; i < _run->_num_tuples; ++i, iter.next()) {
+        void* value = expr_ctx->get_value(reinterpret_cast<TupleRow*>(&iter._current_tuple));
+        if (value == nullptr) {
+            nulls.push_back(i);
+            continue;
+        }
+        uint64_t prefix = normalized_prefix(value, type);
+        entries.push_back({is_asc ? prefix : ~prefix, i});
+    }
+    RadixSort<SortEntryRadixSortTraits>::executeLSD(entries.data(), entries.size());
+
+    std::vector<int64_t> order;
+    order.reserve(_run->_num_tuples);
+    auto tuple_less = [this](int64_t lhs, int64_t rhs) {
+        return _less_than_comp(reinterpret_cast<Tuple*>(tuple_at(lhs)),
+                               reinterpret_cast<Tuple*>(tuple_at(rhs)));
+    };
+    auto append_nulls = [&]() {
+        int64_t begin = order.size();
+        order.insert(order.end(), nulls.begin(), nulls.end());
+        if (_less_than_comp.lhs_key_expr_ctxs().size() > 1) {
+            std::sort(order.begin() + begin, order.end(), tuple_less);
+        }
+    };
+    if (_less_than_comp.nulls_first(0)) {
+        append_nulls();
+    }
+    for (size_t begin = 0; begin < entries.size();) {
+        size_t end = begin + 1;
+        while (end < entries.size() && entries[end].prefix == entries[begin].prefix) {
+            ++end;
+        }
+        int64_t order_begin = order.size();
+        for (size_t i = begin; i < end; ++i) {
+            order.push_back(entries[i].index);
+        }
+        if (has_ties && end - begin > 1) {
+            std::sort(order.begin() + order_begin, order.end(), tuple_less);
+            if (UNLIKELY(_state->is_cancelled())) {
+                return true;
+            }
+        }
+        begin = end;
+    }
+    if (!_less_than_comp.nulls_first(0)) {
+        append_nulls();
+    }
+    permute(&order);
+    return true;
+}
+
+void SpillSorter::TupleSorter::permute(std::vector<int64_t>* order) {
+    int64_t num_tuples = order->size();
+    for (int64_t i = 0; i < num_tuples; ++i) {
+        if ((*order)[i] == i) {
+            continue;
+        }
+        // follow the cycle of moves through position i, done positions are set to
+        // themselves
+        memcpy(_temp_tuple_buffer, tuple_at(i), _tuple_size);
+        int64_t j = i;
+        while ((*order)[j] != i) {
+            int64_t from = (*order)[j];
+            memcpy(tuple_at(j), tuple_at(from), _tuple_size);
+            (*order)[j] = j;
+            j = from;
+        }
+        memcpy(tuple_at(j), _temp_tuple_buffer, _tuple_size);
+        (*order)[j] = j;
+    }
+}
+
 // Sort the sequence of tuples from [first, last).
 // Begin with a sorted sequence of size 1 [first, first+1).
 // During each pass of the outermost loop, add the next tuple (at position 'i') to
@@ -0,0 +1,235 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "runtime/stream_load/group_commit_mgr.h"
+
+#include <thrift/protocol/TDebugProtocol.h>
+
+#include <algorithm>
+
+#include "common/config.h"
+#include "common/logging.h"
+#include "gen_cpp/FrontendService.h"
+#include "gen_cpp/HeartbeatService_types.h"
+#include "runtime/exec_env.h"
+#include "runtime/stream_load/load_stream_mgr.h"
+#include "runtime/stream_load/stream_load_context.h"
+#include "runtime/stream_load/stream_load_executor.h"
+#include "runtime/stream_load/stream_load_pipe.h"
+#include "util/thrift_rpc_helper.h"
+#include "util/time.h"
+#include "util/uid_util.h"
+
+namespace doris {
+
+// The open groups are checked for expiry at this interval.
+static const int64_t CLOSE_CHECK_INTERVAL_MS = 10;
+
+GroupCommitMgr::GroupCommitMgr(ExecEnv* exec_env)
+        : _exec_env(exec_env),
+          _load_pool(config::group_commit_threads, 1024),
+          _stop_background_threads_latch(1) {}
+
+GroupCommitMgr::~GroupCommitMgr() {
+    _stop_background_threads_latch.count_down();
+    if (_close_thread) {
+        _close_thread->join();
+    }
+    _load_pool.shutdown();
+    _load_pool.join();
+}
+
+Status GroupCommitMgr::init() {
+    return Thread::create(
+            "GroupCommitMgr", "close_expired_groups",
+            [this]() {
+                while (!_stop_background_threads_latch.wait_for(
+                        MonoDelta::FromMilliseconds(CLOSE_CHECK_INTERVAL_MS))) {
+                    _close_expired_groups();
+                }
+            },
+            &_close_thread);
+}
+
+Status GroupCommitMgr::commit(StreamLoadContext* ctx) {
+    // the loads with the same properties, but their own ids, share a group
+    TStreamLoadPutRequest request = ctx->group_commit_request;
+    request.txnId = -1;
+    request.__set_loadId(TUniqueId());
+    std::string key = apache::thrift::ThriftDebugString(request);
+
+    std::shared_ptr<Group> group;
+    std::unique_lock<std::mutex> l(_lock);
+    auto it = _open_groups.find(key);
+    if (it == _open_groups.end()) {
+        group = std::make_shared<Group>();
+        group->request = request;
+        group->open_time_ms = MonotonicMillis();
+        _open_groups.emplace(key, group);
+    } else {
+        group = it->second;
+    }
+    group->loads.push_back(ctx);
+    group->bytes += ctx->receive_bytes;
+    if (group->bytes >= config::group_commit_max_bytes) {
+        _open_groups.erase(key);
+        _submit_group(group);
+    }
+    _cv.wait(l, [&group]() { return group->done; });
+    return group->status;
+}
+
+void GroupCommitMgr::_close_expired_groups() {
+    int64_t now_ms = MonotonicMillis();
+    std::lock_guard<std::mutex> l(_lock);
+    for (auto it = _open_groups.begin(); it != _open_groups.end();) {
+        if (now_ms - it->second->open_time_ms >= config::group_commit_interval_ms) {
+            _submit_group(it->second);
+            it = _open_groups.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void GroupCommitMgr::_submit_group(const std::shared_ptr<Group>& group) {
+    if (!_load_pool.offer([this, group]() { _run_group(group); })) {
+        group->status = Status::ServiceUnavailable("group commit is shutting down");
+        group->done = true;
+        _cv.notify_all();
+    }
+}
+
+void GroupCommitMgr::_run_group(const std::shared_ptr<Group>& group) {
+    StreamLoadContext* ctx = new StreamLoadContext(_exec_env);
+    ctx->ref();
+    Status status = _load_group(group.get(), ctx);
+    if (!status.ok()) {
+        LOG(WARNING) << "group commit failed, errmsg=" << status.get_error_msg()
+                     << ", loads=" << group->loads.size() << ctx->brief();
+        if (ctx->need_rollback) {
+            _exec_env->stream_load_executor()->rollback_txn(ctx);
+            ctx->need_rollback = false;
+        }
+        if (ctx->body_sink != nullptr) {
+            ctx->body_sink->cancel();
+        }
+    } else {
+        VLOG(1) << "group commit finished, loads=" << group->loads.size()
+                << ", rows=" << ctx->number_loaded_rows << ctx->brief();
+    }
+
+    {
+        std::lock_guard<std::mutex> l(_lock);
+        for (auto load : group->loads) {
+            load->txn_id = ctx->txn_id;
+            load->group_commit_label = ctx->label;
+            load->begin_txn_cost_nanos = ctx->begin_txn_cost_nanos;
+            load->stream_load_put_cost_nanos = ctx->stream_load_put_cost_nanos;
+            load->write_data_cost_nanos = ctx->write_data_cost_nanos;
+            load->commit_and_publish_txn_cost_nanos = ctx->commit_and_publish_txn_cost_nanos;
+            load->error_url = ctx->error_url;
+            if (status.ok()) {
+                load->number_loaded_rows = load->number_total_rows;
+            }
+        }
+        group->status = status;
+        group->done = true;
+    }
+    _cv.notify_all();
+
+    if (ctx->unref()) {
+        delete ctx;
+    }
+}
+
+Status GroupCommitMgr::_load_group(Group* group, StreamLoadContext* ctx) {
+    StreamLoadContext* first = group->loads.front();
+    ctx->load_type = TLoadType::MANUL_LOAD;
+    ctx->load_src_type = TLoadSourceType::RAW;
+    ctx->db = first->db;
+    ctx->table = first->table;
+    ctx->auth = first->auth;
+    ctx->timeout_second = first->timeout_second;
+    ctx->label = "group_commit_" + generate_uuid_string();
+    ctx->use_streaming = true;
+    ctx->format = TFileFormatType::FORMAT_CSV_PLAIN;
+    ctx->receive_bytes = group->bytes;
+
+    int64_t begin_txn_start_time = MonotonicNanos();
+    RETURN_IF_ERROR(_exec_env->stream_load_executor()->begin_txn(ctx));
+    ctx->begin_txn_cost_nanos = MonotonicNanos() - begin_txn_start_time;
+
+    auto pipe = std::make_shared<StreamLoadPipe>(
+            config::stream_load_pipe_buffer_bytes /* max_buffered_bytes */,
+            64 * 1024 /* min_chunk_size */);
+    RETURN_IF_ERROR(_exec_env->load_stream_mgr()->put(ctx->id, pipe));
+    ctx->body_sink = pipe;
+
+    TStreamLoadPutRequest request = group->request;
+    request.txnId = ctx->txn_id;
+    request.__set_loadId(ctx->id.to_thrift());
+    TNetworkAddress master_addr = _exec_env->master_info()->network_address;
+    int64_t stream_load_put_start_time = MonotonicNanos();
+    RETURN_IF_ERROR(ThriftRpcHelper::rpc<FrontendServiceClient>(
+            master_addr.hostname, master_addr.port,
+            [&request, ctx](FrontendServiceConnection& client) {
+                client->streamLoadPut(ctx->put_result, request);
+            }));
+    ctx->stream_load_put_cost_nanos = MonotonicNanos() - stream_load_put_start_time;
+    RETURN_IF_ERROR(Status(ctx->put_result.status));
+
+    RETURN_IF_ERROR(_exec_env->stream_load_executor()->execute_plan_fragment(ctx));
+    for (auto load : group->loads) {
+        RETURN_IF_ERROR(_append_body(load, pipe.get()));
+    }
+    RETURN_IF_ERROR(pipe->finish());
+    RETURN_IF_ERROR(ctx->future.get());
+
+    int64_t commit_and_publish_start_time = MonotonicNanos();
+    RETURN_IF_ERROR(_exec_env->stream_load_executor()->commit_txn(ctx));
+    ctx->commit_and_publish_txn_cost_nanos = MonotonicNanos() - commit_and_publish_start_time;
+    return Status::OK();
+}
+
+Status GroupCommitMgr::_append_body(StreamLoadContext* load, StreamLoadPipe* pipe) {
+    auto body = std::static_pointer_cast<StreamLoadPipe>(load->body_sink);
+    int64_t num_lines = 0;
+    char last_char = '\n';
+    while (true) {
+        ByteBufferPtr buf;
+        RETURN_IF_ERROR(body->read_buffer(&buf));
+        if (buf == nullptr) {
+            break;
+        }
+        if (!buf->has_remaining()) {
+            continue;
+        }
+        num_lines += std::count(buf->ptr + buf->pos, buf->ptr + buf->limit, '\n');
+        last_char = buf->ptr[buf->limit - 1];
+        RETURN_IF_ERROR(pipe->append(buf));
+    }
+    // the last line of a body may have no delimiter, it must not run into the next body
+    if (last_char != '\n') {
+        RETURN_IF_ERROR(pipe->append("\n", 1));
+        ++num_lines;
+    }
+    load->number_total_rows = num_lines;
+    return Status::OK();
+}
+
+} // namespace doris
@@ -0,0 +1,104 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "common/status.h"
+#include "gen_cpp/FrontendService_types.h"
+#include "gutil/ref_counted.h"
+#include "util/countdown_latch.h"
+#include "util/priority_thread_pool.hpp"
+#include "util/thread.h"
+
+namespace doris {
+
+class ExecEnv;
+class StreamLoadContext;
+class StreamLoadPipe;
+
+// Loads the small csv stream loads sent with the header "group_commit: true" in groups,
+// one transaction per group, so that frequent small loads of a table don't each create
+// a version of its tablets and a transaction on the FE.
+//
+// A load joins the open group of the loads of the same table with the same credentials
+// and load properties once its body is received in full. A group is closed when it has
+// been open for config::group_commit_interval_ms or the bodies of its loads reach
+// config::group_commit_max_bytes. It's then loaded as one stream load: the bodies of its
+// loads are sent through one pipe to one load plan and the transaction is committed.
+// The loads of a group succeed or fail together.
+class GroupCommitMgr {
+public:
+    GroupCommitMgr(ExecEnv* exec_env);
+    ~GroupCommitMgr();
+
+    Status init();
+
+    // Adds the load of 'ctx' to its group and waits until the group is committed. The body
+    // of the load must be in its body_sink, a finished StreamLoadPipe, and its load
+    // properties in ctx->group_commit_request. On return ctx has the status of the group,
+    // its transaction and the number of rows of the load.
+    Status commit(StreamLoadContext* ctx);
+
+private:
+    struct Group {
+        // The properties of the loads of the group, used to plan it.
+        TStreamLoadPutRequest request;
+        std::vector<StreamLoadContext*> loads;
+        size_t bytes = 0;
+        int64_t open_time_ms = 0;
+
+        // Set when the group is loaded.
+        bool done = false;
+        Status status;
+    };
+
+    // Closes the groups that have been open for config::group_commit_interval_ms.
+    void _close_expired_groups();
+
+    // Submits 'group' to be loaded. Must be called with _lock taken.
+    void _submit_group(const std::shared_ptr<Group>& group);
+
+    // Loads 'group' and wakes up its loads.
+    void _run_group(const std::shared_ptr<Group>& group);
+
+    Status _load_group(Group* group, StreamLoadContext* ctx);
+
+    // Sends the body of 'load' to 'pipe', ending it with a line delimiter.
+    Status _append_body(StreamLoadContext* load, StreamLoadPipe* pipe);
+
+    ExecEnv* _exec_env;
+
+    std::mutex _lock;
+    // Notified when a group is done.
+    std::condition_variable _cv;
+    // The open groups by their load properties.
+    std::map<std::string, std::shared_ptr<Group>> _open_groups;
+
+    PriorityThreadPool _load_pool;
+
+    CountDownLatch _stop_background_threads_latch;
+    scoped_refptr<Thread> _close_thread;
+};
+
+} // namespace doris
@@ -182,6 +182,13 @@ public:
 
     std::unique_ptr<KafkaLoadInfo> kafka_info;
 
+    // set if the load is committed together with other small loads, see GroupCommitMgr
+    bool group_commit = false;
+    // the properties of a group commit load, its group is planned with them
+    TStreamLoadPutRequest group_commit_request;
+    // the label of the transaction of the group of a group commit load
+    std::string group_commit_label;
+
     // consumer_id is used for data consumer cache key.
     // to identified a specified data consumer.
     int64_t consumer_id;
@@ -17,9 +17,12 @@
 
 #pragma once
 
+#include <string.h>
+
 #include <condition_variable>
 #include <deque>
 #include <mutex>
+#include <string>
 
 #include "exec/file_reader.h"
 #include "runtime/message_body_sink.h"
@@ -146,6 +149,72 @@ public:
         return Status::OK();
     }
 
+    bool supports_read_buffer() const override { return true; }
+
+    Status read_buffer(ByteBufferPtr* buf) override {
+        std::unique_lock<std::mutex> l(_lock);
+        while (!_cancelled && !_finished && _buf_queue.empty()) {
+            _get_cond.wait(l);
+        }
+        // cancelled
+        if (_cancelled) {
+            return Status::InternalError("cancelled");
+        }
+        // finished
+        if (_buf_queue.empty()) {
+            DCHECK(_finished);
+            *buf = nullptr;
+            return Status::OK();
+        }
+        *buf = _buf_queue.front();
+        _buf_queue.pop_front();
+        _buffered_bytes -= (*buf)->limit;
+        _put_cond.notify_one();
+        return Status::OK();
+    }
+
+    // Reads the next chunk of about 'chunk_size' bytes, more if a line is longer, which ends
+    // at a line delimiter unless it's the last one. Used by the scanners that parse the lines
+    // of one stream in parallel, the chunks are numbered by 'seq' in the order of the stream.
+    // 'chunk' is set to nullptr at the end of the stream.
+    Status read_line_chunk(char line_delimiter, size_t chunk_size, int64_t* seq,
+                           ByteBufferPtr* chunk) {
+        std::lock_guard<std::mutex> l(_chunk_lock);
+        ByteBufferPtr buf = ByteBuffer::allocate(std::max(chunk_size, _chunk_remainder.size() * 2));
+        buf->put_bytes(_chunk_remainder.data(), _chunk_remainder.size());
+        _chunk_remainder.clear();
+        while (buf->pos < buf->capacity) {
+            size_t size = buf->capacity - buf->pos;
+            bool eof = false;
+            RETURN_IF_ERROR(read((uint8_t*)buf->ptr + buf->pos, &size, &eof));
+            buf->pos += size;
+            if (buf->pos < buf->capacity) {
+                // the end of the stream
+                break;
+            }
+            const char* last_delimiter =
+                    static_cast<const char*>(memrchr(buf->ptr, line_delimiter, buf->pos));
+            if (last_delimiter != nullptr) {
+                size_t length = last_delimiter - buf->ptr + 1;
+                _chunk_remainder.assign(buf->ptr + length, buf->pos - length);
+                buf->pos = length;
+                break;
+            }
+            // the line is longer than the chunk
+            ByteBufferPtr larger = ByteBuffer::allocate(buf->capacity * 2);
+            larger->put_bytes(buf->ptr, buf->pos);
+            buf = larger;
+        }
+        if (buf->pos == 0) {
+            *chunk = nullptr;
+            return Status::OK();
+        }
+        buf->flip();
+        *seq = _next_chunk_seq++;
+        *chunk = buf;
+        return Status::OK();
+    }
+
     Status readat(int64_t position, int64_t nbytes, int64_t* bytes_read, void* out) {
         return Status::InternalError("Not implemented");
     }
@@ -254,6 +323,12 @@ private:
     bool _cancelled;
 
     ByteBufferPtr _write_buf;
+
+    // Serializes read_line_chunk().
+    std::mutex _chunk_lock;
+    int64_t _next_chunk_seq = 0;
+    // The partial line after the last chunk.
+    std::string _chunk_remainder;
 };
 
 } // namespace doris
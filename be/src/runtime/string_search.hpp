@@ -57,14 +57,21 @@
 #include <vector>
 #include <cstring>
 #include <boost/cstdint.hpp>
+#ifdef __AVX2__
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 #include "common/logging.h"
 #include "runtime/string_value.h"
 
 namespace doris {
 
-// TODO: This can be sped up with SIDD_CMP_EQUAL_ORDERED or at the very least rewritten
-// from published algorithms.
+// Patterns of 2 or more chars are searched a register of positions at a time first: the
+// positions where both the first and the last char of the pattern match are found with
+// SIMD compares, and only those are compared with the whole pattern. The tail of the
+// string shorter than a register is searched with the loop below.
 class StringSearch {
 
 public:
@@ -120,12 +127,20 @@ public:
             return -1;
         }
 
+        int start = 0;
+#if defined(__AVX2__) || defined(__SSE2__)
+        int result = simd_search(s, n, &start);
+        if (result != -1) {
+            return result;
+        }
+#endif
+
         // General case.
         int j;
         // TODO: the original code seems to have an off by one error. It is possible
         // to index at w + m which is the length of the input string. Checks have
         // been added to make sure that w + m < str->len.
-        for (int i = 0; i <= w; i++) {
+        for (int i = start; i <= w; i++) {
             // note: using mlast in the skip path slows things down on x86
             if (s[i + m - 1] == p[m - 1]) {
                 // candidate match
@@ -158,6 +173,51 @@ public:
 private:
     static const int BLOOM_WIDTH = 64;
 
+#if defined(__AVX2__) || defined(__SSE2__)
+#ifdef __AVX2__
+    typedef __m256i Register;
+    static Register set1(char c) { return _mm256_set1_epi8(c); }
+    static uint32_t match_mask(Register first, Register last, const char* s, int m) {
+        Register block_first = _mm256_loadu_si256(reinterpret_cast<const Register*>(s));
+        Register block_last = _mm256_loadu_si256(reinterpret_cast<const Register*>(s + m - 1));
+        return _mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(first, block_first),
+                                                     _mm256_cmpeq_epi8(last, block_last)));
+    }
+#else
+    typedef __m128i Register;
+    static Register set1(char c) { return _mm_set1_epi8(c); }
+    static uint32_t match_mask(Register first, Register last, const char* s, int m) {
+        Register block_first = _mm_loadu_si128(reinterpret_cast<const Register*>(s));
+        Register block_last = _mm_loadu_si128(reinterpret_cast<const Register*>(s + m - 1));
+        return _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(first, block_first),
+                                               _mm_cmpeq_epi8(last, block_last)));
+    }
+#endif
+
+    // Searches the positions of 's' whose first and last chars of the pattern are in full
+    // registers. Returns the first match, or -1 and sets '*start' to the first position
+    // left to search.
+    int simd_search(const char* s, int n, int* start) const {
+        const int m = _pattern->len;
+        const char* p = _pattern->ptr;
+        const Register first = set1(p[0]);
+        const Register last = set1(p[m - 1]);
+        int i = 0;
+        for (; i + m - 1 + static_cast<int>(sizeof(Register)) <= n; i += sizeof(Register)) {
+            uint32_t mask = match_mask(first, last, s + i, m);
+            while (mask != 0) {
+                int pos = i + __builtin_ctz(mask);
+                if (memcmp(s + pos + 1, p + 1, m - 2) == 0) {
+                    return pos;
+                }
+                mask &= mask - 1;
+            }
+        }
+        *start = i;
+        return -1;
+    }
+#endif
+
     void bloom_add(char c) {
         _mask |= (1UL << (c & (BLOOM_WIDTH - 1)));
     }
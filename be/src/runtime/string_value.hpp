@@ -80,6 +80,9 @@ inline int StringValue::compare(const StringValue& other) const {
             return 1;
         }
     }
+    if (ptr == other.ptr && len == other.len) {
+        return 0;
+    }
 
     return string_compare(this->ptr, this->len, other.ptr, other.len, l);
 }
@@ -88,6 +91,10 @@ inline bool StringValue::eq(const StringValue& other) const {
     if (this->len != other.len) {
         return false;
     }
+    // e.g. the values unified by the string dictionary of a scan
+    if (this->ptr == other.ptr) {
+        return true;
+    }
 
     return string_compare(this->ptr, this->len, other.ptr, other.len, this->len) == 0;
 }
@@ -210,6 +210,62 @@ Status TabletsChannel::reduce_mem_usage() {
     return Status::OK();
 }
 
+void TabletsChannel::get_memtable_consumptions(
+        std::vector<std::pair<int64_t, int64_t>>* memtables) {
+    std::lock_guard<std::mutex> l(_lock);
+    if (_state == kFinished) {
+        return;
+    }
+    for (auto& it : _tablet_writers) {
+        int64_t consumption = it.second->memtable_consumption();
+        if (consumption > 0) {
+            memtables->emplace_back(it.first, consumption);
+        }
+    }
+}
+
+Status TabletsChannel::flush_memtables(const std::vector<int64_t>& tablet_ids) {
+    std::lock_guard<std::mutex> l(_lock);
+    if (_state == kFinished) {
+        return _close_status;
+    }
+    for (auto tablet_id : tablet_ids) {
+        auto it = _tablet_writers.find(tablet_id);
+        if (it == _tablet_writers.end()) {
+            continue;
+        }
+        OLAPStatus st = it->second->flush_memtable();
+        if (st != OLAP_SUCCESS) {
+            std::stringstream ss;
+            ss << "failed to reduce mem consumption by flushing memtable. tablet_id="
+               << tablet_id << ", err: " << st;
+            return Status::InternalError(ss.str());
+        }
+    }
+    return Status::OK();
+}
+
+Status TabletsChannel::wait_flush(const std::vector<int64_t>& tablet_ids) {
+    std::lock_guard<std::mutex> l(_lock);
+    if (_state == kFinished) {
+        // close_wait() has waited all writers
+        return _close_status;
+    }
+    for (auto tablet_id : tablet_ids) {
+        auto it = _tablet_writers.find(tablet_id);
+        if (it == _tablet_writers.end()) {
+            continue;
+        }
+        OLAPStatus st = it->second->wait_flush();
+        if (st != OLAP_SUCCESS) {
+            std::stringstream ss;
+            ss << "failed to flush memtable. tablet_id=" << tablet_id << ", err: " << st;
+            return Status::InternalError(ss.str());
+        }
+    }
+    return Status::OK();
+}
+
 Status TabletsChannel::_open_all_writers(const PTabletWriterOpenRequest& params) {
     std::vector<SlotDescriptor*>* index_slots = nullptr;
     int32_t schema_hash = 0;
@@ -236,6 +292,7 @@ Status TabletsChannel::_open_all_writers(const PTabletWriterOpenRequest& params)
         request.need_gen_rollup = params.need_gen_rollup();
         request.tuple_desc = _tuple_desc;
         request.slots = index_slots;
+        request.partial_columns = params.partial_columns();
 
         DeltaWriter* writer = nullptr;
         auto st = DeltaWriter::open(&request, _mem_tracker, &writer);
@@ -262,6 +319,7 @@ Status TabletsChannel::cancel() {
     for (auto& it : _tablet_writers) {
         it.second->cancel();
     }
+    _mem_tracker->FlushConsumptionCaches();
     DCHECK_EQ(_mem_tracker->consumption(), 0);
     _state = kFinished;
     return Status::OK();
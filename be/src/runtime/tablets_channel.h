@@ -80,6 +80,19 @@ public:
     // no-op when this channel has been closed or cancelled
     Status reduce_mem_usage();
 
+    // append the memtable consumption of every non-empty writer of this channel to
+    // 'memtables' as (tablet id, consumption).
+    // no-op when this channel has been closed or cancelled
+    void get_memtable_consumptions(std::vector<std::pair<int64_t, int64_t>>* memtables);
+
+    // submit the memtables of 'tablet_ids' to flush queue without waiting.
+    // no-op when this channel has been closed or cancelled
+    Status flush_memtables(const std::vector<int64_t>& tablet_ids);
+
+    // wait the memtables of 'tablet_ids' to be flushed.
+    // no-op when this channel has been closed or cancelled
+    Status wait_flush(const std::vector<int64_t>& tablet_ids);
+
     int64_t mem_consumption() const { return _mem_tracker->consumption(); }
 
 private:
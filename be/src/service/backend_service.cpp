@@ -228,80 +228,35 @@ void BackendService::submit_routine_load_task(TStatus& t_status,
  */
 void BackendService::open_scanner(TScanOpenResult& result_, const TScanOpenParams& params) {
     TStatus t_status;
-    TUniqueId fragment_instance_id = generate_uuid();
-    std::shared_ptr<ScanContext> p_context;
-    _exec_env->external_scan_context_mgr()->create_scan_context(&p_context);
-    p_context->fragment_instance_id = fragment_instance_id;
-    p_context->offset = 0;
-    p_context->last_access_time = time(NULL);
-    if (params.__isset.keep_alive_min) {
-        p_context->keep_alive_min = params.keep_alive_min;
-    } else {
-        p_context->keep_alive_min = 5;
-    }
+    std::string context_id;
     std::vector<TScanColumnDesc> selected_columns;
-    // start the scan procedure
-    Status exec_st = _exec_env->fragment_mgr()->exec_external_plan_fragment(
-            params, fragment_instance_id, &selected_columns);
+    Status exec_st = _exec_env->external_scan_context_mgr()->open_scanner(params, &context_id,
+                                                                          &selected_columns);
     exec_st.to_thrift(&t_status);
     //return status
     // t_status.status_code = TStatusCode::OK;
     result_.status = t_status;
-    result_.__set_context_id(p_context->context_id);
+    result_.__set_context_id(context_id);
     result_.__set_selected_columns(selected_columns);
 }
 
-// fetch result from polling the queue, should always maintain the context offset, otherwise inconsistent result
 void BackendService::get_next(TScanBatchResult& result_, const TScanNextBatchParams& params) {
-    std::string context_id = params.context_id;
-    u_int64_t offset = params.offset;
     TStatus t_status;
-    std::shared_ptr<ScanContext> context;
-    Status st = _exec_env->external_scan_context_mgr()->get_scan_context(context_id, &context);
-    if (!st.ok()) {
-        st.to_thrift(&t_status);
-        result_.status = t_status;
-        return;
-    }
-    if (offset != context->offset) {
-        LOG(ERROR) << "getNext error: context offset [" << context->offset << " ]"
-                   << " ,client offset [ " << offset << " ]";
-        // invalid offset
-        t_status.status_code = TStatusCode::NOT_FOUND;
-        t_status.error_msgs.push_back(
-                strings::Substitute("context_id=$0, send_offset=$1, context_offset=$2", context_id,
-                                    offset, context->offset));
-        result_.status = t_status;
-    } else {
-        // during accessing, should disabled last_access_time
-        context->last_access_time = -1;
-        TUniqueId fragment_instance_id = context->fragment_instance_id;
-        std::shared_ptr<arrow::RecordBatch> record_batch;
-        bool eos;
-
-        st = _exec_env->result_queue_mgr()->fetch_result(fragment_instance_id, &record_batch, &eos);
-        if (st.ok()) {
-            result_.__set_eos(eos);
-            if (!eos) {
-                std::string record_batch_str;
-                st = serialize_record_batch(*record_batch, &record_batch_str);
-                st.to_thrift(&t_status);
-                if (st.ok()) {
-                    // avoid copy large string
-                    result_.rows = std::move(record_batch_str);
-                    // set __isset
-                    result_.__isset.rows = true;
-                    context->offset += record_batch->num_rows();
-                }
-            }
-        } else {
-            LOG(WARNING) << "fragment_instance_id [" << print_id(fragment_instance_id)
-                         << "] fetch result status [" << st.to_string() + "]";
-            st.to_thrift(&t_status);
-            result_.status = t_status;
+    bool eos = false;
+    std::string rows;
+    Status st = _exec_env->external_scan_context_mgr()->get_next(params.context_id,
+                                                                 params.offset, &eos, &rows);
+    st.to_thrift(&t_status);
+    result_.status = t_status;
+    if (st.ok()) {
+        result_.__set_eos(eos);
+        if (!eos) {
+            // avoid copy large string
+            result_.rows = std::move(rows);
+            // set __isset
+            result_.__isset.rows = true;
         }
     }
-    context->last_access_time = time(NULL);
 }
 
 void BackendService::close_scanner(TScanCloseResult& result_, const TScanCloseParams& params) {
@@ -27,6 +27,7 @@ namespace brpc {
 
 DECLARE_uint64(max_body_size);
 DECLARE_int64(socket_max_unwritten_bytes);
+DECLARE_int32(max_connection_pool_size);
 
 } // namespace brpc
 
@@ -36,6 +37,7 @@ BRpcService::BRpcService(ExecEnv* exec_env) : _exec_env(exec_env), _server(new b
     // Set config
     brpc::FLAGS_max_body_size = config::brpc_max_body_size;
     brpc::FLAGS_socket_max_unwritten_bytes = config::brpc_socket_max_unwritten_bytes;
+    brpc::FLAGS_max_connection_pool_size = config::brpc_max_connections_per_peer;
 }
 
 BRpcService::~BRpcService() {}
@@ -135,6 +135,17 @@ int main(int argc, char** argv) {
         return -1;
     }
 
+    // fragments running as bthreads move between threads, the state kept per thread by
+    // these features would be charged to the wrong fragment
+    if (doris::config::fragment_exec_in_bthread &&
+        (doris::config::mem_tracker_consumption_cache_bytes > 0 ||
+         doris::config::continuous_cpu_profiler_interval_ms > 0)) {
+        fprintf(stderr,
+                "fragment_exec_in_bthread can't be used with "
+                "mem_tracker_consumption_cache_bytes or continuous_cpu_profiler_interval_ms. \n");
+        return -1;
+    }
+
 #if !defined(ADDRESS_SANITIZER) && !defined(LEAK_SANITIZER) && !defined(THREAD_SANITIZER)
     // Aggressive decommit is required so that unused pages in the TCMalloc page heap are
     // not backed by physical pages and do not contribute towards memory consumption.
@@ -20,14 +20,21 @@
 #include "common/config.h"
 #include "gen_cpp/BackendService.h"
 #include "gen_cpp/internal_service.pb.h"
+#include "gutil/strings/substitute.h"
+#include "olap/row_cursor.h"
+#include "olap/storage_engine.h"
+#include "olap/tablet_manager.h"
+#include "olap/tablet_point_getter.h"
 #include "runtime/buffer_control_block.h"
 #include "runtime/data_stream_mgr.h"
 #include "runtime/exec_env.h"
+#include "runtime/external_scan_context_mgr.h"
 #include "runtime/fragment_mgr.h"
 #include "runtime/load_channel_mgr.h"
 #include "runtime/result_buffer_mgr.h"
 #include "runtime/routine_load/routine_load_task_executor.h"
 #include "service/brpc.h"
+#include "util/doris_metrics.h"
 #include "util/thrift_util.h"
 #include "util/uid_util.h"
 
@@ -35,7 +42,9 @@ namespace doris {
 
 template <typename T>
 PInternalServiceImpl<T>::PInternalServiceImpl(ExecEnv* exec_env)
-        : _exec_env(exec_env), _tablet_worker_pool(config::number_tablet_writer_threads, 10240) {}
+        : _exec_env(exec_env),
+          _tablet_worker_pool(config::number_tablet_writer_threads, 10240),
+          _external_scan_pool(config::external_scan_rpc_threads, 10240) {}
 
 template <typename T>
 PInternalServiceImpl<T>::~PInternalServiceImpl() {}
@@ -47,7 +56,14 @@ void PInternalServiceImpl<T>::transmit_data(google::protobuf::RpcController* cnt
                                             google::protobuf::Closure* done) {
     VLOG_ROW << "transmit data: fragment_instance_id=" << print_id(request->finst_id())
              << " node=" << request->node_id();
-    _exec_env->stream_mgr()->transmit_data(request, &done);
+    ScopedLatencyRecorder latency(DorisMetrics::instance()->brpc_transmit_data_latency_us);
+    brpc::Controller* cntl = static_cast<brpc::Controller*>(cntl_base);
+    Status st =
+            _exec_env->stream_mgr()->transmit_data(request, &cntl->request_attachment(), &done);
+    if (!st.ok()) {
+        // 'done' is only kept by the receiver if the batch is queued, which never fails
+        st.to_protobuf(response->mutable_status());
+    }
     if (done != nullptr) {
         done->Run();
     }
@@ -58,6 +74,7 @@ void PInternalServiceImpl<T>::tablet_writer_open(google::protobuf::RpcController
                                                  const PTabletWriterOpenRequest* request,
                                                  PTabletWriterOpenResult* response,
                                                  google::protobuf::Closure* done) {
+    ScopedLatencyRecorder latency(DorisMetrics::instance()->brpc_tablet_writer_open_latency_us);
     VLOG_RPC << "tablet writer open, id=" << request->id() << ", index_id=" << request->index_id()
              << ", txn_id=" << request->txn_id();
     brpc::ClosureGuard closure_guard(done);
@@ -75,6 +92,7 @@ void PInternalServiceImpl<T>::exec_plan_fragment(google::protobuf::RpcController
                                                  const PExecPlanFragmentRequest* request,
                                                  PExecPlanFragmentResult* response,
                                                  google::protobuf::Closure* done) {
+    ScopedLatencyRecorder latency(DorisMetrics::instance()->brpc_exec_plan_fragment_latency_us);
     brpc::ClosureGuard closure_guard(done);
     brpc::Controller* cntl = static_cast<brpc::Controller*>(cntl_base);
     auto st = _exec_plan_fragment(cntl);
@@ -84,6 +102,21 @@ void PInternalServiceImpl<T>::exec_plan_fragment(google::protobuf::RpcController
     st.to_protobuf(response->mutable_status());
 }
 
+template <typename T>
+void PInternalServiceImpl<T>::exec_plan_fragments(google::protobuf::RpcController* cntl_base,
+                                                  const PExecPlanFragmentRequest* request,
+                                                  PExecPlanFragmentResult* response,
+                                                  google::protobuf::Closure* done) {
+    ScopedLatencyRecorder latency(DorisMetrics::instance()->brpc_exec_plan_fragment_latency_us);
+    brpc::ClosureGuard closure_guard(done);
+    brpc::Controller* cntl = static_cast<brpc::Controller*>(cntl_base);
+    auto st = _exec_plan_fragments(cntl);
+    if (!st.ok()) {
+        LOG(WARNING) << "exec plan fragments failed, errmsg=" << st.get_error_msg();
+    }
+    st.to_protobuf(response->mutable_status());
+}
+
 template <typename T>
 void PInternalServiceImpl<T>::tablet_writer_add_batch(google::protobuf::RpcController* controller,
                                                       const PTabletWriterAddBatchRequest* request,
@@ -110,6 +143,8 @@ void PInternalServiceImpl<T>::tablet_writer_add_batch(google::protobuf::RpcContr
             st.to_protobuf(response->mutable_status());
         }
         response->set_execution_time_us(execution_time_ns / 1000);
+        DorisMetrics::instance()->brpc_tablet_writer_add_batch_latency_us->add(
+                execution_time_ns / 1000);
         response->set_wait_lock_time_us(wait_lock_time_ns / 1000);
     });
 }
@@ -119,6 +154,7 @@ void PInternalServiceImpl<T>::tablet_writer_cancel(google::protobuf::RpcControll
                                                    const PTabletWriterCancelRequest* request,
                                                    PTabletWriterCancelResult* response,
                                                    google::protobuf::Closure* done) {
+    ScopedLatencyRecorder latency(DorisMetrics::instance()->brpc_tablet_writer_cancel_latency_us);
     VLOG_RPC << "tablet writer cancel, id=" << request->id() << ", index_id=" << request->index_id()
              << ", sender_id=" << request->sender_id();
     brpc::ClosureGuard closure_guard(done);
@@ -144,11 +180,24 @@ Status PInternalServiceImpl<T>::_exec_plan_fragment(brpc::Controller* cntl) {
     return _exec_env->fragment_mgr()->exec_plan_fragment(t_request);
 }
 
+template <typename T>
+Status PInternalServiceImpl<T>::_exec_plan_fragments(brpc::Controller* cntl) {
+    auto ser_request = cntl->request_attachment().to_string();
+    TExecPlanFragmentParamsList t_request;
+    {
+        const uint8_t* buf = (const uint8_t*)ser_request.data();
+        uint32_t len = ser_request.size();
+        RETURN_IF_ERROR(deserialize_thrift_msg(buf, &len, false, &t_request));
+    }
+    return _exec_env->fragment_mgr()->exec_plan_fragments(&t_request);
+}
+
 template <typename T>
 void PInternalServiceImpl<T>::cancel_plan_fragment(google::protobuf::RpcController* cntl_base,
                                                    const PCancelPlanFragmentRequest* request,
                                                    PCancelPlanFragmentResult* result,
                                                    google::protobuf::Closure* done) {
+    ScopedLatencyRecorder latency(DorisMetrics::instance()->brpc_cancel_plan_fragment_latency_us);
     brpc::ClosureGuard closure_guard(done);
     TUniqueId tid;
     tid.__set_hi(request->finst_id().hi());
@@ -236,6 +285,163 @@ void PInternalServiceImpl<T>::clear_cache(google::protobuf::RpcController* contr
     _exec_env->result_cache()->clear(request, response);
 }
 
+template <typename T>
+void PInternalServiceImpl<T>::external_scan_open(google::protobuf::RpcController* cntl_base,
+                                                 const PExternalScanOpenRequest* request,
+                                                 PExternalScanOpenResult* result,
+                                                 google::protobuf::Closure* done) {
+    brpc::Controller* cntl = static_cast<brpc::Controller*>(cntl_base);
+    // opening a scan prepares and starts its fragment, keep it out of the bthread workers
+    _external_scan_pool.offer([cntl, result, done, this]() {
+        brpc::ClosureGuard closure_guard(done);
+        auto st = _external_scan_open(cntl);
+        if (!st.ok()) {
+            LOG(WARNING) << "external scan open failed, errmsg=" << st.get_error_msg();
+        }
+        st.to_protobuf(result->mutable_status());
+    });
+}
+
+template <typename T>
+Status PInternalServiceImpl<T>::_external_scan_open(brpc::Controller* cntl) {
+    auto ser_request = cntl->request_attachment().to_string();
+    TScanOpenParams t_request;
+    {
+        const uint8_t* buf = (const uint8_t*)ser_request.data();
+        uint32_t len = ser_request.size();
+        RETURN_IF_ERROR(deserialize_thrift_msg(buf, &len, false, &t_request));
+    }
+    TScanOpenResult t_result;
+    std::string context_id;
+    std::vector<TScanColumnDesc> selected_columns;
+    Status st = _exec_env->external_scan_context_mgr()->open_scanner(t_request, &context_id,
+                                                                     &selected_columns);
+    st.to_thrift(&t_result.status);
+    t_result.__set_context_id(context_id);
+    t_result.__set_selected_columns(selected_columns);
+    ThriftSerializer ser(false, 1024);
+    std::string ser_result;
+    RETURN_IF_ERROR(ser.serialize(&t_result, &ser_result));
+    cntl->response_attachment().append(ser_result);
+    return st;
+}
+
+template <typename T>
+void PInternalServiceImpl<T>::external_scan_get_next(google::protobuf::RpcController* cntl_base,
+                                                     const PExternalScanNextBatchRequest* request,
+                                                     PExternalScanNextBatchResult* result,
+                                                     google::protobuf::Closure* done) {
+    brpc::Controller* cntl = static_cast<brpc::Controller*>(cntl_base);
+    // waits for the next batch of the scan, keep it out of the bthread workers
+    _external_scan_pool.offer([cntl, request, result, done, this]() {
+        brpc::ClosureGuard closure_guard(done);
+        bool eos = false;
+        std::string rows;
+        auto st = _exec_env->external_scan_context_mgr()->get_next(
+                request->context_id(), request->offset(), &eos, &rows);
+        if (st.ok()) {
+            result->set_eos(eos);
+            cntl->response_attachment().append(rows);
+        }
+        st.to_protobuf(result->mutable_status());
+    });
+}
+
+template <typename T>
+void PInternalServiceImpl<T>::external_scan_close(google::protobuf::RpcController* controller,
+                                                  const PExternalScanCloseRequest* request,
+                                                  PExternalScanCloseResult* result,
+                                                  google::protobuf::Closure* done) {
+    brpc::ClosureGuard closure_guard(done);
+    auto st = _exec_env->external_scan_context_mgr()->clear_scan_context(request->context_id());
+    st.to_protobuf(result->mutable_status());
+}
+
+template <typename T>
+void PInternalServiceImpl<T>::tablet_point_get(google::protobuf::RpcController* controller,
+                                               const PTabletPointGetRequest* request,
+                                               PTabletPointGetResult* result,
+                                               google::protobuf::Closure* done) {
+    brpc::ClosureGuard closure_guard(done);
+    auto st = _tablet_point_get(request, result);
+    if (!st.ok()) {
+        LOG(WARNING) << "tablet point get failed, tablet=" << request->tablet_id()
+                     << ", errmsg=" << st.get_error_msg();
+    }
+    st.to_protobuf(result->mutable_status());
+}
+
+template <typename T>
+Status PInternalServiceImpl<T>::_tablet_point_get(const PTabletPointGetRequest* request,
+                                                  PTabletPointGetResult* result) {
+    std::string err;
+    TabletSharedPtr tablet = StorageEngine::instance()->tablet_manager()->get_tablet(
+            request->tablet_id(), request->schema_hash(), true, &err);
+    if (tablet == nullptr) {
+        return Status::NotFound(
+                strings::Substitute("tablet $0 not found: $1", request->tablet_id(), err));
+    }
+    const TabletSchema& tablet_schema = tablet->tablet_schema();
+    std::vector<uint32_t> return_columns;
+    for (auto& column : request->columns()) {
+        int32_t cid = tablet_schema.field_index(column);
+        if (cid < 0) {
+            return Status::InvalidArgument(strings::Substitute("unknown column $0", column));
+        }
+        return_columns.push_back(cid);
+    }
+    if (return_columns.empty()) {
+        for (uint32_t cid = 0; cid < tablet_schema.num_columns(); ++cid) {
+            return_columns.push_back(cid);
+        }
+    }
+    int64_t version = request->version();
+    if (!request->has_version()) {
+        ReadLock rdlock(tablet->get_header_lock_ptr());
+        const RowsetSharedPtr rowset = tablet->rowset_with_max_version();
+        if (rowset == nullptr) {
+            return Status::InternalError(
+                    strings::Substitute("tablet $0 has no version", request->tablet_id()));
+        }
+        version = rowset->end_version();
+    }
+    OlapTuple key;
+    for (auto& value : request->key()) {
+        key.add_value(value.value(), value.is_null());
+    }
+
+    TabletPointGetter getter(tablet, version);
+    OLAPStatus res = getter.init();
+    if (res != OLAP_SUCCESS) {
+        return Status::InternalError(strings::Substitute(
+                "failed to init point get of tablet $0, version=$1, res=$2",
+                request->tablet_id(), version, res));
+    }
+    RowCursor row;
+    res = row.init(tablet_schema);
+    bool found = false;
+    if (res == OLAP_SUCCESS) {
+        res = getter.get(key, &row, &found);
+    }
+    if (res != OLAP_SUCCESS) {
+        return Status::InternalError(strings::Substitute(
+                "failed to point get tablet $0, version=$1, res=$2", request->tablet_id(),
+                version, res));
+    }
+    result->set_found(found);
+    if (found) {
+        for (uint32_t cid : return_columns) {
+            PPointGetValue* value = result->add_values();
+            if (row.is_null(cid)) {
+                value->set_is_null(true);
+            } else {
+                value->set_value(row.column_schema(cid)->to_string(row.cell_ptr(cid)));
+            }
+        }
+    }
+    return Status::OK();
+}
+
 template class PInternalServiceImpl<PBackendService>;
 template class PInternalServiceImpl<palo::PInternalService>;
 
@@ -47,6 +47,12 @@ public:
                             PExecPlanFragmentResult* result,
                             google::protobuf::Closure* done) override;
 
+    // Like exec_plan_fragment, but the attachment is a TExecPlanFragmentParamsList.
+    void exec_plan_fragments(google::protobuf::RpcController* controller,
+                             const PExecPlanFragmentRequest* request,
+                             PExecPlanFragmentResult* result,
+                             google::protobuf::Closure* done) override;
+
     void cancel_plan_fragment(google::protobuf::RpcController* controller,
                               const PCancelPlanFragmentRequest* request,
                               PCancelPlanFragmentResult* result,
@@ -88,12 +94,39 @@ public:
     void clear_cache(google::protobuf::RpcController* controller, const PClearCacheRequest* request,
                      PCacheResponse* response, google::protobuf::Closure* done) override;
 
+    void external_scan_open(google::protobuf::RpcController* controller,
+                            const PExternalScanOpenRequest* request,
+                            PExternalScanOpenResult* result,
+                            google::protobuf::Closure* done) override;
+
+    void external_scan_get_next(google::protobuf::RpcController* controller,
+                                const PExternalScanNextBatchRequest* request,
+                                PExternalScanNextBatchResult* result,
+                                google::protobuf::Closure* done) override;
+
+    void external_scan_close(google::protobuf::RpcController* controller,
+                             const PExternalScanCloseRequest* request,
+                             PExternalScanCloseResult* result,
+                             google::protobuf::Closure* done) override;
+
+    void tablet_point_get(google::protobuf::RpcController* controller,
+                          const PTabletPointGetRequest* request, PTabletPointGetResult* result,
+                          google::protobuf::Closure* done) override;
+
 private:
     Status _exec_plan_fragment(brpc::Controller* cntl);
 
+    Status _exec_plan_fragments(brpc::Controller* cntl);
+
+    Status _external_scan_open(brpc::Controller* cntl);
+
+    Status _tablet_point_get(const PTabletPointGetRequest* request, PTabletPointGetResult* result);
+
 private:
     ExecEnv* _exec_env;
     PriorityThreadPool _tablet_worker_pool;
+    // Runs the external scan rpcs, which may block for long.
+    PriorityThreadPool _external_scan_pool;
 };
 
 } // namespace doris
@@ -0,0 +1,428 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <gflags/gflags.h>
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "common/config.h"
+#include "gen_cpp/olap_file.pb.h"
+#include "gen_cpp/segment_v2.pb.h"
+#include "gutil/strings/split.h"
+#include "olap/comparison_predicate.h"
+#include "olap/olap_common.h"
+#include "olap/page_cache.h"
+#include "olap/row_block.h"
+#include "olap/row_cursor.h"
+#include "olap/rowset/rowset.h"
+#include "olap/rowset/rowset_factory.h"
+#include "olap/rowset/rowset_meta.h"
+#include "olap/rowset/rowset_reader.h"
+#include "olap/rowset/rowset_reader_context.h"
+#include "olap/rowset/rowset_writer.h"
+#include "olap/rowset/rowset_writer_context.h"
+#include "olap/tablet_schema.h"
+#include "runtime/memory/chunk_allocator.h"
+#include "runtime/string_value.h"
+#include "util/cpu_info.h"
+#include "util/file_utils.h"
+#include "util/mem_info.h"
+#include "util/parse_util.h"
+#include "util/time.h"
+
+using doris::ChunkAllocator;
+using doris::ColumnPB;
+using doris::ColumnPredicate;
+using doris::CpuInfo;
+using doris::FileUtils;
+using doris::LessPredicate;
+using doris::MemInfo;
+using doris::MonotonicNanos;
+using doris::OLAP_ERR_DATA_EOF;
+using doris::OLAP_SUCCESS;
+using doris::OlapReaderStatistics;
+using doris::OLAPStatus;
+using doris::ParseUtil;
+using doris::RowBlock;
+using doris::RowCursor;
+using doris::RowsetFactory;
+using doris::RowsetMeta;
+using doris::RowsetMetaSharedPtr;
+using doris::RowsetReaderContext;
+using doris::RowsetReaderSharedPtr;
+using doris::RowsetSharedPtr;
+using doris::RowsetWriter;
+using doris::RowsetWriterContext;
+using doris::Slice;
+using doris::Status;
+using doris::StoragePageCache;
+using doris::StringValue;
+using doris::TabletSchema;
+using doris::TabletSchemaPB;
+using doris::segment_v2::CompressionTypePB;
+
+const std::string SCHEMA_FILE = "tablet_schema.pb";
+const std::string ROWSET_META_FILE = "rowset_meta.pb";
+
+DEFINE_string(operation, "write_and_scan", "valid operation: write, scan, write_and_scan");
+DEFINE_string(path, "", "directory of the benchmark rowset");
+DEFINE_string(columns, "INT,BIGINT,VARCHAR",
+              "types of the value columns, any of INT, BIGINT and VARCHAR");
+DEFINE_int64(num_rows, 1000000, "number of rows to write");
+DEFINE_int64(cardinality, 1000, "number of distinct values in each value column");
+DEFINE_int32(string_length, 16, "length of the values of VARCHAR columns");
+DEFINE_int32(rows_per_segment, 1000000, "max number of rows in a segment");
+DEFINE_string(compression, "LZ4F", "compression of the pages: NO_COMPRESSION, SNAPPY, LZ4, "
+                                   "LZ4F, ZLIB or ZSTD");
+DEFINE_int32(compression_level, 0, "level of the compression, 0 means the default level");
+DEFINE_bool(adaptive_encoding, false, "choose the encoding of each column from its data");
+DEFINE_int32(predicate_column, -1, "column of the 'less than' predicate, -1 means no predicate");
+DEFINE_double(selectivity, 0.1, "fraction of the rows which pass the predicate");
+DEFINE_int32(scan_rounds, 3, "number of times the rowset is scanned");
+DEFINE_string(page_cache_limit, "1G", "capacity of the storage page cache");
+DEFINE_bool(use_page_cache, true, "read the pages through the storage page cache");
+
+std::string get_usage(const std::string& progname) {
+    std::stringstream ss;
+    ss << progname << " writes a synthetic segment_v2 rowset and scans it.\n";
+    ss << "The first column is a BIGINT key holding the row number, the value columns "
+          "hold uniform random values.\n";
+    ss << "Usage:\n";
+    ss << "./segment_bench --operation=write --path=/path/to/dir --columns=INT,VARCHAR "
+          "--num_rows=1000000 --cardinality=1000 --compression=ZSTD\n";
+    ss << "./segment_bench --operation=scan --path=/path/to/dir --predicate_column=1 "
+          "--selectivity=0.01 --page_cache_limit=512M\n";
+    return ss.str();
+}
+
+std::string format_string_value(int64_t value) {
+    char buf[32];
+    int len = snprintf(buf, sizeof(buf), "%0*ld", FLAGS_string_length, value);
+    return std::string(buf, len).substr(0, FLAGS_string_length);
+}
+
+bool create_tablet_schema(TabletSchemaPB* schema_pb) {
+    CompressionTypePB compression;
+    if (!doris::segment_v2::CompressionTypePB_Parse(FLAGS_compression, &compression)) {
+        std::cout << "invalid compression: " << FLAGS_compression << std::endl;
+        return false;
+    }
+    schema_pb->set_keys_type(doris::DUP_KEYS);
+    schema_pb->set_num_short_key_columns(1);
+    schema_pb->set_num_rows_per_row_block(1024);
+    schema_pb->set_compress_kind(doris::COMPRESS_NONE);
+    schema_pb->set_compression_type(compression);
+    schema_pb->set_compression_level(FLAGS_compression_level);
+
+    std::vector<std::string> types = strings::Split(FLAGS_columns, ",", strings::SkipWhitespace());
+    types.insert(types.begin(), "BIGINT");
+    for (int i = 0; i < types.size(); ++i) {
+        ColumnPB* column = schema_pb->add_column();
+        column->set_unique_id(i);
+        column->set_name(i == 0 ? "k" : "v" + std::to_string(i));
+        column->set_type(types[i]);
+        column->set_is_key(i == 0);
+        column->set_is_nullable(false);
+        if (types[i] == "INT") {
+            column->set_length(4);
+        } else if (types[i] == "BIGINT") {
+            column->set_length(8);
+        } else if (types[i] == "VARCHAR") {
+            column->set_length(FLAGS_string_length + sizeof(doris::StringLengthType));
+        } else {
+            std::cout << "invalid column type: " << types[i] << std::endl;
+            return false;
+        }
+        column->set_index_length(column->length());
+        if (i > 0) {
+            column->set_aggregation("NONE");
+        }
+    }
+    schema_pb->set_next_column_unique_id(types.size());
+    return true;
+}
+
+bool save_file(const std::string& file, const std::string& content) {
+    std::ofstream out(FLAGS_path + "/" + file, std::ios::binary | std::ios::trunc);
+    out << content;
+    return out.good();
+}
+
+bool load_file(const std::string& file, std::string* content) {
+    std::ifstream in(FLAGS_path + "/" + file, std::ios::binary);
+    std::stringstream ss;
+    ss << in.rdbuf();
+    *content = ss.str();
+    return in.good();
+}
+
+// Loads the rowset saved by a previous write, returns false if there is none.
+bool load_rowset(TabletSchema* schema, RowsetSharedPtr* rowset) {
+    std::string schema_buf;
+    std::string meta_buf;
+    if (!load_file(SCHEMA_FILE, &schema_buf) || !load_file(ROWSET_META_FILE, &meta_buf)) {
+        return false;
+    }
+    TabletSchemaPB schema_pb;
+    RowsetMetaSharedPtr meta(new RowsetMeta());
+    if (!schema_pb.ParseFromString(schema_buf) || !meta->init(meta_buf)) {
+        std::cout << "invalid rowset in " << FLAGS_path << std::endl;
+        return false;
+    }
+    schema->init_from_pb(schema_pb);
+    OLAPStatus s = RowsetFactory::create_rowset(schema, FLAGS_path, meta, rowset);
+    if (s != OLAP_SUCCESS) {
+        std::cout << "create rowset failed, status:" << s << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool write_rowset() {
+    // segment files are never overwritten, remove the ones of the previous run
+    {
+        TabletSchema old_schema;
+        RowsetSharedPtr old_rowset;
+        if (load_rowset(&old_schema, &old_rowset)) {
+            old_rowset->remove();
+        }
+    }
+
+    TabletSchemaPB schema_pb;
+    if (!create_tablet_schema(&schema_pb)) {
+        return false;
+    }
+    TabletSchema schema;
+    schema.init_from_pb(schema_pb);
+    doris::config::enable_adaptive_encoding = FLAGS_adaptive_encoding;
+
+    RowsetWriterContext context;
+    context.rowset_id.init(10000);
+    context.tablet_id = 10000;
+    context.tablet_schema_hash = 1111;
+    context.partition_id = 10;
+    context.rowset_type = doris::BETA_ROWSET;
+    context.rowset_path_prefix = FLAGS_path;
+    context.rowset_state = doris::VISIBLE;
+    context.tablet_schema = &schema;
+    context.version.first = 0;
+    context.version.second = 0;
+    context.max_rows_per_segment = FLAGS_rows_per_segment;
+    std::unique_ptr<RowsetWriter> writer;
+    OLAPStatus s = RowsetFactory::create_rowset_writer(context, &writer);
+    if (s != OLAP_SUCCESS) {
+        std::cout << "create rowset writer failed, status:" << s << std::endl;
+        return false;
+    }
+
+    RowCursor row;
+    row.init(schema);
+    size_t num_columns = schema.num_columns();
+    std::vector<int64_t> values(num_columns);
+    std::vector<int32_t> ints(num_columns);
+    std::vector<std::string> strings(num_columns);
+    std::vector<Slice> slices(num_columns);
+    std::mt19937_64 rng(42);
+    std::uniform_int_distribution<int64_t> distribution(0, FLAGS_cardinality - 1);
+
+    int64_t start_ns = MonotonicNanos();
+    for (int64_t rid = 0; rid < FLAGS_num_rows; ++rid) {
+        values[0] = rid;
+        row.set_field_content_shallow(0, reinterpret_cast<const char*>(&values[0]));
+        for (size_t cid = 1; cid < num_columns; ++cid) {
+            values[cid] = distribution(rng);
+            const char* content = reinterpret_cast<const char*>(&values[cid]);
+            if (schema.column(cid).type() == doris::OLAP_FIELD_TYPE_INT) {
+                ints[cid] = static_cast<int32_t>(values[cid]);
+                content = reinterpret_cast<const char*>(&ints[cid]);
+            } else if (schema.column(cid).type() == doris::OLAP_FIELD_TYPE_VARCHAR) {
+                strings[cid] = format_string_value(values[cid]);
+                slices[cid] = Slice(strings[cid]);
+                content = reinterpret_cast<const char*>(&slices[cid]);
+            }
+            row.set_field_content_shallow(cid, content);
+        }
+        s = writer->add_row(row);
+        if (s != OLAP_SUCCESS) {
+            std::cout << "add row failed, status:" << s << std::endl;
+            return false;
+        }
+    }
+    s = writer->flush();
+    if (s != OLAP_SUCCESS) {
+        std::cout << "flush rowset failed, status:" << s << std::endl;
+        return false;
+    }
+    RowsetSharedPtr rowset = writer->build();
+    if (rowset == nullptr) {
+        std::cout << "build rowset failed" << std::endl;
+        return false;
+    }
+    double seconds = (MonotonicNanos() - start_ns) / 1e9;
+
+    std::string meta_buf;
+    rowset->rowset_meta()->serialize(&meta_buf);
+    if (!save_file(SCHEMA_FILE, schema_pb.SerializeAsString()) ||
+        !save_file(ROWSET_META_FILE, meta_buf)) {
+        std::cout << "save rowset meta to " << FLAGS_path << " failed" << std::endl;
+        return false;
+    }
+
+    size_t disk_size = rowset->rowset_meta()->total_disk_size();
+    std::cout << "write " << FLAGS_num_rows << " rows into " << rowset->num_segments()
+              << " segments, " << disk_size / 1024.0 / 1024.0 << " MB on disk, in " << seconds
+              << " s: " << FLAGS_num_rows / seconds << " rows/s, "
+              << disk_size / 1024.0 / 1024.0 / seconds << " MB/s" << std::endl;
+    return true;
+}
+
+// Creates the predicate "column < value" which passes about FLAGS_selectivity of the rows.
+ColumnPredicate* create_predicate(const TabletSchema& schema) {
+    int cid = FLAGS_predicate_column;
+    int64_t range = cid == 0 ? FLAGS_num_rows : FLAGS_cardinality;
+    int64_t value = static_cast<int64_t>(range * FLAGS_selectivity);
+    switch (schema.column(cid).type()) {
+    case doris::OLAP_FIELD_TYPE_INT:
+        return new LessPredicate<int32_t>(cid, static_cast<int32_t>(value));
+    case doris::OLAP_FIELD_TYPE_BIGINT:
+        return new LessPredicate<int64_t>(cid, value);
+    default: {
+        // zero-padded numbers sort as the numbers do
+        std::string str = format_string_value(value);
+        return new LessPredicate<StringValue>(cid, StringValue(&str[0], str.size()));
+    }
+    }
+}
+
+bool scan_rowset() {
+    TabletSchema schema;
+    RowsetSharedPtr rowset;
+    if (!load_rowset(&schema, &rowset)) {
+        std::cout << "no rowset in " << FLAGS_path << ", write one first" << std::endl;
+        return false;
+    }
+    if (FLAGS_predicate_column >= static_cast<int>(schema.num_columns())) {
+        std::cout << "invalid predicate column: " << FLAGS_predicate_column << std::endl;
+        return false;
+    }
+
+    std::vector<uint32_t> return_columns;
+    for (uint32_t cid = 0; cid < schema.num_columns(); ++cid) {
+        return_columns.push_back(cid);
+    }
+    std::vector<ColumnPredicate*> predicates;
+    if (FLAGS_predicate_column >= 0) {
+        predicates.push_back(create_predicate(schema));
+    }
+
+    for (int round = 1; round <= FLAGS_scan_rounds; ++round) {
+        OlapReaderStatistics stats;
+        RowsetReaderContext context;
+        context.tablet_schema = &schema;
+        context.need_ordered_result = false;
+        context.return_columns = &return_columns;
+        context.seek_columns = &return_columns;
+        context.predicates = &predicates;
+        context.stats = &stats;
+        context.use_page_cache = FLAGS_use_page_cache;
+
+        int64_t start_ns = MonotonicNanos();
+        RowsetReaderSharedPtr reader;
+        rowset->create_reader(&reader);
+        OLAPStatus s = reader->init(&context);
+        if (s != OLAP_SUCCESS) {
+            std::cout << "init rowset reader failed, status:" << s << std::endl;
+            return false;
+        }
+        int64_t num_rows = 0;
+        RowBlock* block = nullptr;
+        while ((s = reader->next_block(&block)) == OLAP_SUCCESS) {
+            num_rows += block->row_num();
+        }
+        if (s != OLAP_ERR_DATA_EOF) {
+            std::cout << "scan rowset failed, status:" << s << std::endl;
+            return false;
+        }
+        double seconds = (MonotonicNanos() - start_ns) / 1e9;
+
+        double hit_rate = 0;
+        if (stats.total_pages_num > 0) {
+            hit_rate = 100.0 * stats.cached_pages_num / stats.total_pages_num;
+        }
+        std::cout << "scan round " << round << ": return " << num_rows << " of "
+                  << rowset->num_rows() << " rows in " << seconds
+                  << " s: " << rowset->num_rows() / seconds << " rows/s" << std::endl;
+        std::cout << "    page cache: " << stats.cached_pages_num << " hits of "
+                  << stats.total_pages_num << " pages (" << hit_rate << "%)" << std::endl;
+        std::cout << "    io: " << stats.compressed_bytes_read / 1024.0 / 1024.0 << " MB read in "
+                  << stats.io_ns / 1e9 << " s, decompress " << stats.uncompressed_bytes_read
+                  << " bytes in " << stats.decompress_ns / 1e9 << " s" << std::endl;
+    }
+    for (auto predicate : predicates) {
+        delete predicate;
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    std::string usage = get_usage(argv[0]);
+    gflags::SetUsageMessage(usage);
+    google::ParseCommandLineFlags(&argc, &argv, true);
+
+    if (FLAGS_operation != "write" && FLAGS_operation != "scan" &&
+        FLAGS_operation != "write_and_scan") {
+        std::cout << "invalid operation:" << FLAGS_operation << std::endl;
+        return -1;
+    }
+    if (FLAGS_path == "") {
+        std::cout << "no path flag for the rowset" << std::endl;
+        return -1;
+    }
+    Status st = FileUtils::create_dir(FLAGS_path);
+    if (!st.ok()) {
+        std::cout << "invalid path:" << FLAGS_path << ", error: " << st.to_string() << std::endl;
+        return -1;
+    }
+
+    CpuInfo::init();
+    MemInfo::init();
+    ChunkAllocator::init_instance(doris::config::chunk_reserved_bytes_limit);
+    bool is_percent = false;
+    int64_t page_cache_limit = ParseUtil::parse_mem_spec(FLAGS_page_cache_limit, &is_percent);
+    if (page_cache_limit <= 0) {
+        // the pages can't be read through a cache of no capacity
+        FLAGS_use_page_cache = false;
+        page_cache_limit = 0;
+    }
+    StoragePageCache::create_global_cache(page_cache_limit,
+                                          doris::config::index_page_cache_percentage);
+
+    if (FLAGS_operation != "scan" && !write_rowset()) {
+        return -1;
+    }
+    if (FLAGS_operation != "write" && !scan_rowset()) {
+        return -1;
+    }
+    return 0;
+}
@@ -460,7 +460,7 @@ void HllVal::agg_parse_and_cal(FunctionContext* ctx, const HllVal& other) {
     if (other.len == 0) {
         auto* hll = reinterpret_cast<doris::HyperLogLog*>(other.ptr);
         uint8_t* other_ptr = ctx->allocate(doris::HLL_COLUMN_DEFAULT_LEN);
-        int other_len = hll->serialize(ptr);
+        int other_len = hll->serialize(other_ptr);
         resolver.init((char*)other_ptr, other_len);
     } else {
         resolver.init((char*)other.ptr, other.len);
@@ -499,12 +499,7 @@ void HllVal::agg_parse_and_cal(FunctionContext* ctx, const HllVal& other) {
 }
 
 void HllVal::agg_merge(const HllVal& other) {
-    uint8_t* pdata = ptr + 1;
-    uint8_t* pdata_other = other.ptr + 1;
-
-    for (int i = 0; i < doris::HLL_REGISTERS_COUNT; ++i) {
-        pdata[i] = std::max(pdata[i], pdata_other[i]);
-    }
+    doris::HyperLogLog::merge_registers(ptr + 1, other.ptr + 1);
 }
 
 } // namespace doris_udf
@@ -302,6 +302,37 @@ typedef void (*UdfPrepare)(FunctionContext* context, FunctionContext::FunctionSt
 /// execution thread with 'scope' set to THREAD_LOCAL.
 typedef void (*UdfClose)(FunctionContext* context, FunctionContext::FunctionStateScope scope);
 
+/// --- Batch Functions ---
+/// -----------------------
+/// The UDF can optionally include a batch form of itself, specified in the "CREATE
+/// FUNCTION" statement using "batch_fn=<batch function symbol>". When the arguments of
+/// the UDF are evaluated a batch of rows at a time, it's called once for the rows instead
+/// of the UDF once per row, which saves the calls and lets the loop over the rows be
+/// vectorized by the compiler.
+///
+/// args[i] points to the array of the *Val type of the i-th argument (e.g. IntVal for an
+/// INT argument) and 'results' to the array of the *Val type of the return type. Both are
+/// indexed by the row in the batch, and only rows[0] ... rows[num_rows - 1] are to be read
+/// and set. The is_null of the values are the null maps of the columns. An example of
+/// the batch form of "IntVal AddUdf(FunctionContext*, const IntVal&, const IntVal&)":
+///
+///   void AddUdfBatch(FunctionContext* context, int num_rows, const int* rows,
+///                    const AnyVal* const* args, AnyVal* results) {
+///       const IntVal* a = static_cast<const IntVal*>(args[0]);
+///       const IntVal* b = static_cast<const IntVal*>(args[1]);
+///       IntVal* result = static_cast<IntVal*>(results);
+///       for (int i = 0; i < num_rows; ++i) {
+///           int r = rows[i];
+///           result[r].is_null = a[r].is_null || b[r].is_null;
+///           result[r].val = a[r].val + b[r].val;
+///       }
+///   }
+///
+/// The batch form must return the same results as the UDF, which is still required and
+/// used where the rows are evaluated one at a time. Variadic UDFs have no batch form.
+typedef void (*UdfBatch)(FunctionContext* context, int num_rows, const int* rows,
+                         const AnyVal* const* args, AnyVal* results);
+
 //----------------------------------------------------------------------------
 //------------------------------- UDAs ---------------------------------------
 //----------------------------------------------------------------------------
@@ -347,6 +378,15 @@ typedef void (*UdaUpdate)(FunctionContext* context, const InputType& input,
 typedef void (*UdaUpdate2)(FunctionContext* context, const InputType& input,
                            const InputType2& input2, IntermediateType* result);
 
+// The optional batch form of the update function, specified by "update_batch_fn=<symbol>".
+// It updates 'result' with the input values of rows[0] ... rows[num_rows - 1], which are
+// passed like the arguments of UdfBatch: args[i] points to the array of the *Val type of
+// the i-th input, indexed by the row. It's used when the rows of a batch all update the
+// same group, e.g. an aggregation without GROUP BY, and must be equivalent to calling
+// the update function for the rows in order.
+typedef void (*UdaUpdateBatch)(FunctionContext* context, int num_rows, const int* rows,
+                               const AnyVal* const* args, IntermediateType* result);
+
 // Merge an intermediate result 'src' into 'dst'.
 typedef void (*UdaMerge)(FunctionContext* context, const IntermediateType& src,
                          IntermediateType* dst);
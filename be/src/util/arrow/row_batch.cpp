@@ -27,6 +27,7 @@
 #include <arrow/record_batch.h>
 #include <arrow/status.h>
 #include <arrow/type.h>
+#include <arrow/util/bit_util.h>
 #include <arrow/visitor.h>
 #include <arrow/visitor_inline.h>
 
@@ -199,7 +200,19 @@ public:
     arrow::Status Visit(const arrow::StringType& type) override {
         arrow::StringBuilder builder(_pool);
         size_t num_rows = _batch.num_rows();
-        builder.Reserve(num_rows);
+        ARROW_RETURN_NOT_OK(builder.Reserve(num_rows));
+        PrimitiveType slot_type = _cur_slot_ref->type().type;
+        if (slot_type == TYPE_VARCHAR || slot_type == TYPE_CHAR || slot_type == TYPE_HLL) {
+            // the values are copied in without growing the data buffer
+            int64_t data_len = 0;
+            for (size_t i = 0; i < num_rows; ++i) {
+                TupleRow* row = _batch.get_row(i);
+                if (!_cur_slot_ref->is_null_bit_set(row)) {
+                    data_len += static_cast<const StringValue*>(_cur_slot_ref->get_slot(row))->len;
+                }
+            }
+            ARROW_RETURN_NOT_OK(builder.ReserveData(data_len));
+        }
         for (size_t i = 0; i < num_rows; ++i) {
             bool is_null = _cur_slot_ref->is_null_bit_set(_batch.get_row(i));
             if (is_null) {
@@ -213,13 +226,7 @@ public:
             case TYPE_CHAR:
             case TYPE_HLL: {
                 const StringValue* string_val = (const StringValue*)(cell_ptr);
-                if (string_val->len == 0) {
-                    // 0x01 is a magic num, not useful actually, just for present ""
-                    //char* tmp_val = reinterpret_cast<char*>(0x01);
-                    ARROW_RETURN_NOT_OK(builder.Append(""));
-                } else {
-                    ARROW_RETURN_NOT_OK(builder.Append(string_val->to_string()));
-                }
+                ARROW_RETURN_NOT_OK(builder.Append(string_val->ptr, string_val->len));
                 break;
             }
             case TYPE_DATE:
@@ -235,8 +242,7 @@ public:
                 int len = 48;
                 char* v = LargeIntValue::to_string(
                         reinterpret_cast<const PackedInt128*>(cell_ptr)->value, buf, &len);
-                std::string temp(v, len);
-                ARROW_RETURN_NOT_OK(builder.Append(std::move(temp)));
+                ARROW_RETURN_NOT_OK(builder.Append(v, len));
                 break;
             }
             case TYPE_DECIMAL: {
@@ -280,23 +286,42 @@ public:
     Status convert(std::shared_ptr<arrow::RecordBatch>* out);
 
 private:
+    // Fills the value buffer and the validity bitmap of the array directly rather than
+    // appending the values to a builder one by one.
     template <typename T>
     typename std::enable_if<std::is_base_of<arrow::PrimitiveCType, T>::value, arrow::Status>::type
     _visit(const T& type) {
-        arrow::NumericBuilder<T> builder(_pool);
-
-        size_t num_rows = _batch.num_rows();
-        builder.Reserve(num_rows);
-        for (size_t i = 0; i < num_rows; ++i) {
-            bool is_null = _cur_slot_ref->is_null_bit_set(_batch.get_row(i));
-            if (is_null) {
-                ARROW_RETURN_NOT_OK(builder.AppendNull());
+        typedef typename T::c_type CType;
+        int64_t num_rows = _batch.num_rows();
+        std::shared_ptr<arrow::Buffer> values;
+        ARROW_RETURN_NOT_OK(arrow::AllocateBuffer(_pool, num_rows * sizeof(CType), &values));
+        CType* data = reinterpret_cast<CType*>(values->mutable_data());
+
+        std::shared_ptr<arrow::Buffer> null_bitmap;
+        uint8_t* valid_bits = nullptr;
+        int64_t null_count = 0;
+        if (SlotRef::is_nullable(_cur_slot_ref.get())) {
+            int64_t bitmap_size = arrow::BitUtil::BytesForBits(num_rows);
+            ARROW_RETURN_NOT_OK(arrow::AllocateBuffer(_pool, bitmap_size, &null_bitmap));
+            valid_bits = null_bitmap->mutable_data();
+            memset(valid_bits, 0xFF, bitmap_size);
+        }
+        for (int64_t i = 0; i < num_rows; ++i) {
+            TupleRow* row = _batch.get_row(i);
+            if (valid_bits != nullptr && _cur_slot_ref->is_null_bit_set(row)) {
+                arrow::BitUtil::ClearBit(valid_bits, i);
+                data[i] = 0;
+                ++null_count;
                 continue;
             }
-            auto cell_ptr = _cur_slot_ref->get_slot(_batch.get_row(i));
-            ARROW_RETURN_NOT_OK(builder.Append(*(typename T::c_type*)cell_ptr));
+            data[i] = *reinterpret_cast<CType*>(_cur_slot_ref->get_slot(row));
         }
-        return builder.Finish(&_arrays[_cur_field_idx]);
+        if (null_count == 0) {
+            null_bitmap.reset();
+        }
+        _arrays[_cur_field_idx] =
+                std::make_shared<arrow::NumericArray<T>>(num_rows, values, null_bitmap, null_count);
+        return arrow::Status::OK();
     }
 
 private:
@@ -445,9 +470,38 @@ Status convert_to_row_batch(const arrow::RecordBatch& batch, const RowDescriptor
     return converter.convert(result);
 }
 
+// An arrow output stream that appends to a string, the serialized batch is written straight
+// into the result instead of being copied out of an arrow buffer afterwards.
+class StringOutputStream : public arrow::io::OutputStream {
+public:
+    explicit StringOutputStream(std::string* str) : _str(str) {
+        set_mode(arrow::io::FileMode::WRITE);
+    }
+
+    arrow::Status Write(const void* data, int64_t nbytes) override {
+        _str->append(static_cast<const char*>(data), nbytes);
+        return arrow::Status::OK();
+    }
+
+    arrow::Status Tell(int64_t* position) const override {
+        *position = _str->size();
+        return arrow::Status::OK();
+    }
+
+    arrow::Status Close() override {
+        _is_closed = true;
+        return arrow::Status::OK();
+    }
+
+    bool closed() const override { return _is_closed; }
+
+private:
+    std::string* _str;
+    bool _is_closed = false;
+};
+
 Status serialize_record_batch(const arrow::RecordBatch& record_batch, std::string* result) {
-    std::shared_ptr<arrow::io::BufferOutputStream> sink;
-    // create sink memory buffer outputstream with the computed capacity
+    // reserve the computed capacity for the result
     int64_t capacity;
     arrow::Status a_st = arrow::ipc::GetRecordBatchSize(record_batch, &capacity);
     if (!a_st.ok()) {
@@ -455,39 +509,32 @@ Status serialize_record_batch(const arrow::RecordBatch& record_batch, std::strin
         msg << "GetRecordBatchSize failure, reason: " << a_st.ToString();
         return Status::InternalError(msg.str());
     }
-    a_st = arrow::io::BufferOutputStream::Create(capacity, arrow::default_memory_pool(), &sink);
-    if (!a_st.ok()) {
-        std::stringstream msg;
-        msg << "create BufferOutputStream failure, reason: " << a_st.ToString();
-        return Status::InternalError(msg.str());
-    }
+    result->clear();
+    // the stream also holds the schema
+    result->reserve(capacity + 4096);
+    StringOutputStream sink(result);
     std::shared_ptr<arrow::ipc::RecordBatchWriter> record_batch_writer;
     // create RecordBatch Writer
-    a_st = arrow::ipc::RecordBatchStreamWriter::Open(sink.get(), record_batch.schema(),
+    a_st = arrow::ipc::RecordBatchStreamWriter::Open(&sink, record_batch.schema(),
                                                      &record_batch_writer);
     if (!a_st.ok()) {
         std::stringstream msg;
         msg << "open RecordBatchStreamWriter failure, reason: " << a_st.ToString();
         return Status::InternalError(msg.str());
     }
-    // write RecordBatch to memory buffer outputstream
+    // write RecordBatch to the result
     a_st = record_batch_writer->WriteRecordBatch(record_batch);
     if (!a_st.ok()) {
         std::stringstream msg;
         msg << "write record batch failure, reason: " << a_st.ToString();
         return Status::InternalError(msg.str());
     }
-    record_batch_writer->Close();
-    std::shared_ptr<arrow::Buffer> buffer;
-    sink->Finish(&buffer);
+    a_st = record_batch_writer->Close();
     if (!a_st.ok()) {
         std::stringstream msg;
-        msg << "allocate result buffer failure, reason: " << a_st.ToString();
+        msg << "close RecordBatchStreamWriter failure, reason: " << a_st.ToString();
         return Status::InternalError(msg.str());
     }
-    *result = buffer->ToString();
-    // close the sink
-    sink->Close();
     return Status::OK();
 }
 
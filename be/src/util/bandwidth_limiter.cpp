@@ -0,0 +1,50 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "util/bandwidth_limiter.h"
+
+#include <algorithm>
+
+#include "util/monotime.h"
+#include "util/time.h"
+
+namespace doris {
+
+void BandwidthLimiter::set_rate(int64_t bytes_per_sec) {
+    std::lock_guard<std::mutex> l(_lock);
+    _bytes_per_sec = bytes_per_sec;
+}
+
+void BandwidthLimiter::acquire(int64_t bytes) {
+    int64_t wait_us = 0;
+    {
+        std::lock_guard<std::mutex> l(_lock);
+        if (_bytes_per_sec <= 0 || bytes <= 0) {
+            return;
+        }
+        int64_t now = MonotonicMicros();
+        _next_free_us = std::max(_next_free_us, now);
+        wait_us = _next_free_us - now;
+        _next_free_us += bytes * MICROS_PER_SEC / _bytes_per_sec;
+    }
+    if (wait_us > 0) {
+        SleepFor(MonoDelta::FromMicroseconds(wait_us));
+    }
+}
+
+} // namespace doris
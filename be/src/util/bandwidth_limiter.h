@@ -0,0 +1,54 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#pragma once
+
+#include <stdint.h>
+
+#include <mutex>
+
+namespace doris {
+
+// Limits the throughput of the bytes passed by the threads sharing it. A thread acquires
+// the bytes before it reads or writes them, and sleeps until they fit in the rate, so the
+// threads share the rate in the order they acquire. Unused rate is not saved for later.
+//
+// Usage:
+//      BandwidthLimiter limiter(100 * 1024 * 1024);
+//      while (...) {
+//          limiter.acquire(buf_size);
+//          write(fd, buf, buf_size);
+//      }
+class BandwidthLimiter {
+public:
+    // 'bytes_per_sec' <= 0 means unlimited
+    explicit BandwidthLimiter(int64_t bytes_per_sec = 0) : _bytes_per_sec(bytes_per_sec) {}
+
+    void set_rate(int64_t bytes_per_sec);
+
+    // Block until 'bytes' fit in the rate.
+    void acquire(int64_t bytes);
+
+private:
+    std::mutex _lock;
+    int64_t _bytes_per_sec;
+    // monotonic time in microseconds at which the bytes acquired so far are passed
+    int64_t _next_free_us = 0;
+};
+
+} // namespace doris
@@ -29,6 +29,7 @@
 #include <stdexcept>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "common/logging.h"
 #include "util/coding.h"
@@ -79,6 +80,7 @@ class Roaring64MapSetBitForwardIterator;
 // What we change includes
 // - a custom serialization format is used inside read()/write()/getSizeInBytes()
 // - added clear() and is32BitsEnough()
+// - fastunion() unions the roarings of each high 32 bits with Roaring::fastunion()
 class Roaring64Map {
 public:
     /**
@@ -797,10 +799,23 @@ public:
      * pointer).
      */
     static Roaring64Map fastunion(size_t n, const Roaring64Map** inputs) {
-        Roaring64Map ans;
-        // not particularly fast
+        // the inputs are partitioned by the high 32 bits, each partition is
+        // unioned at once
+        std::map<uint32_t, std::vector<const Roaring*>> roarings_by_key;
         for (size_t lcv = 0; lcv < n; ++lcv) {
-            ans |= *(inputs[lcv]);
+            for (const auto& map_entry : inputs[lcv]->roarings) {
+                roarings_by_key[map_entry.first].push_back(&map_entry.second);
+            }
+        }
+        Roaring64Map ans;
+        for (auto& entry : roarings_by_key) {
+            if (entry.second.size() == 1) {
+                ans.roarings[entry.first] = *entry.second[0];
+            } else {
+                ans.roarings[entry.first] =
+                        Roaring::fastunion(entry.second.size(), entry.second.data());
+            }
+            ans.roarings[entry.first].setCopyOnWrite(ans.copyOnWrite);
         }
         return ans;
     }
@@ -1037,6 +1052,43 @@ public:
         return *this;
     }
 
+    // Compute the union between the current bitmap and all the provided bitmaps at once,
+    // which is much faster than unioning them one by one when there are many of them.
+    BitmapValue& fastunion(const std::vector<const BitmapValue*>& values) {
+        std::vector<const detail::Roaring64Map*> bitmaps;
+        std::vector<uint64_t> single_values;
+        for (const BitmapValue* value : values) {
+            switch (value->_type) {
+            case EMPTY:
+                break;
+            case SINGLE:
+                single_values.push_back(value->_sv);
+                break;
+            case BITMAP:
+                bitmaps.push_back(&value->_bitmap);
+                break;
+            }
+        }
+        if (!bitmaps.empty()) {
+            if (_type == BITMAP) {
+                bitmaps.push_back(&_bitmap);
+            }
+            _bitmap = detail::Roaring64Map::fastunion(bitmaps.size(), bitmaps.data());
+            if (_type == SINGLE) {
+                _bitmap.add(_sv);
+            }
+            _type = BITMAP;
+        }
+        for (size_t i = 0; i < single_values.size(); ++i) {
+            if (_type == BITMAP) {
+                _bitmap.addMany(single_values.size() - i, &single_values[i]);
+                break;
+            }
+            add(single_values[i]);
+        }
+        return *this;
+    }
+
     // Compute the intersection between the current bitmap and the provided bitmap.
     // Possible type transitions are:
     // SINGLE -> EMPTY
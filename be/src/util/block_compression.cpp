@@ -22,6 +22,7 @@
 #include <snappy/snappy-sinksource.h>
 #include <snappy/snappy.h>
 #include <zlib.h>
+#include <zstd.h>
 
 #include "gutil/strings/substitute.h"
 #include "util/faststring.h"
@@ -361,6 +362,59 @@ public:
     }
 };
 
+class ZstdBlockCompression : public BlockCompressionCodec {
+public:
+    // same as the default level of zstd command line
+    static const int DEFAULT_LEVEL = 3;
+    // higher levels are too slow to compress data on the fly
+    static const int MAX_LEVEL = 19;
+
+    static const ZstdBlockCompression* instance(int level = DEFAULT_LEVEL) {
+        static const std::vector<ZstdBlockCompression> s_instances = [] {
+            std::vector<ZstdBlockCompression> instances;
+            for (int i = 1; i <= MAX_LEVEL; ++i) {
+                instances.emplace_back(i);
+            }
+            return instances;
+        }();
+        if (level < 1) {
+            level = 1;
+        } else if (level > MAX_LEVEL) {
+            level = MAX_LEVEL;
+        }
+        return &s_instances[level - 1];
+    }
+
+    explicit ZstdBlockCompression(int level) : _level(level) {}
+    ~ZstdBlockCompression() override {}
+
+    Status compress(const Slice& input, Slice* output) const override {
+        auto compressed_len =
+                ZSTD_compress(output->data, output->size, input.data, input.size, _level);
+        if (ZSTD_isError(compressed_len)) {
+            return Status::InvalidArgument(Substitute("Fail to do ZSTD compress, error=$0",
+                                                      ZSTD_getErrorName(compressed_len)));
+        }
+        output->size = compressed_len;
+        return Status::OK();
+    }
+
+    Status decompress(const Slice& input, Slice* output) const override {
+        auto decompressed_len = ZSTD_decompress(output->data, output->size, input.data, input.size);
+        if (ZSTD_isError(decompressed_len)) {
+            return Status::InvalidArgument(Substitute("Fail to do ZSTD decompress, error=$0",
+                                                      ZSTD_getErrorName(decompressed_len)));
+        }
+        output->size = decompressed_len;
+        return Status::OK();
+    }
+
+    size_t max_compressed_len(size_t len) const override { return ZSTD_compressBound(len); }
+
+private:
+    int _level;
+};
+
 Status get_block_compression_codec(segment_v2::CompressionTypePB type,
                                    const BlockCompressionCodec** codec) {
     switch (type) {
@@ -379,10 +433,22 @@ Status get_block_compression_codec(segment_v2::CompressionTypePB type,
     case segment_v2::CompressionTypePB::ZLIB:
         *codec = ZlibBlockCompression::instance();
         break;
+    case segment_v2::CompressionTypePB::ZSTD:
+        *codec = ZstdBlockCompression::instance();
+        break;
     default:
         return Status::NotFound(strings::Substitute("unknown compression type($0)", type));
     }
     return Status::OK();
 }
 
+Status get_block_compression_codec(segment_v2::CompressionTypePB type, int level,
+                                   const BlockCompressionCodec** codec) {
+    if (type == segment_v2::CompressionTypePB::ZSTD && level > 0) {
+        *codec = ZstdBlockCompression::instance(level);
+        return Status::OK();
+    }
+    return get_block_compression_codec(type, codec);
+}
+
 } // namespace doris
@@ -63,4 +63,9 @@ public:
 Status get_block_compression_codec(segment_v2::CompressionTypePB type,
                                    const BlockCompressionCodec** codec);
 
+// Same as above, but with compression 'level' for codecs which support it, currently
+// only ZSTD. 'level' <= 0 means the default level of the codec.
+Status get_block_compression_codec(segment_v2::CompressionTypePB type, int level,
+                                   const BlockCompressionCodec** codec);
+
 } // namespace doris
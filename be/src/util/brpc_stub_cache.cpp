@@ -17,9 +17,81 @@
 
 #include "util/brpc_stub_cache.h"
 
+#include "common/config.h"
+#include "util/monotime.h"
+
 namespace doris {
 
 DEFINE_GAUGE_METRIC_PROTOTYPE_2ARG(brpc_endpoint_stub_count, MetricUnit::NOUNIT);
+DEFINE_COUNTER_METRIC_PROTOTYPE_2ARG(brpc_peer_rpc_total, MetricUnit::REQUESTS);
+DEFINE_COUNTER_METRIC_PROTOTYPE_2ARG(brpc_peer_rpc_failed_total, MetricUnit::REQUESTS);
+DEFINE_COUNTER_METRIC_PROTOTYPE_2ARG(brpc_peer_rpc_latency_us, MetricUnit::MICROSECONDS);
+DEFINE_GAUGE_METRIC_PROTOTYPE_2ARG(brpc_peer_rpc_in_flight, MetricUnit::REQUESTS);
+
+// Records the rpc in the metrics of the peer before running the done of the caller.
+class PeerMetricsChannel::DoneClosure : public google::protobuf::Closure {
+public:
+    DoneClosure(PeerMetricsChannel* channel, google::protobuf::RpcController* controller,
+                google::protobuf::Closure* done)
+            : _channel(channel),
+              _controller(controller),
+              _done(done),
+              _start_ns(MonoTime::Now().ToNanoseconds()) {}
+
+    void Run() override {
+        _channel->_on_rpc_done(_controller, _start_ns);
+        google::protobuf::Closure* done = _done;
+        delete this;
+        done->Run();
+    }
+
+private:
+    PeerMetricsChannel* _channel;
+    google::protobuf::RpcController* _controller;
+    google::protobuf::Closure* _done;
+    int64_t _start_ns;
+};
+
+PeerMetricsChannel::PeerMetricsChannel(brpc::Channel* channel, const butil::EndPoint& endpoint)
+        : _channel(channel) {
+    std::string peer = butil::endpoint2str(endpoint).c_str();
+    _entity = DorisMetrics::instance()->metric_registry()->register_entity(
+            "brpc_peer_metrics." + peer, {{"peer", peer}});
+    INT_COUNTER_METRIC_REGISTER(_entity, brpc_peer_rpc_total);
+    INT_COUNTER_METRIC_REGISTER(_entity, brpc_peer_rpc_failed_total);
+    INT_COUNTER_METRIC_REGISTER(_entity, brpc_peer_rpc_latency_us);
+    INT_GAUGE_METRIC_REGISTER(_entity, brpc_peer_rpc_in_flight);
+}
+
+PeerMetricsChannel::~PeerMetricsChannel() {
+    DorisMetrics::instance()->metric_registry()->deregister_entity(_entity);
+}
+
+void PeerMetricsChannel::CallMethod(const google::protobuf::MethodDescriptor* method,
+                                    google::protobuf::RpcController* controller,
+                                    const google::protobuf::Message* request,
+                                    google::protobuf::Message* response,
+                                    google::protobuf::Closure* done) {
+    brpc_peer_rpc_in_flight->increment(1);
+    if (done != nullptr) {
+        _channel->CallMethod(method, controller, request, response,
+                             new DoneClosure(this, controller, done));
+    } else {
+        int64_t start_ns = MonoTime::Now().ToNanoseconds();
+        _channel->CallMethod(method, controller, request, response, nullptr);
+        _on_rpc_done(controller, start_ns);
+    }
+}
+
+void PeerMetricsChannel::_on_rpc_done(google::protobuf::RpcController* controller,
+                                      int64_t start_ns) {
+    brpc_peer_rpc_in_flight->increment(-1);
+    brpc_peer_rpc_total->increment(1);
+    if (controller->Failed()) {
+        brpc_peer_rpc_failed_total->increment(1);
+    }
+    brpc_peer_rpc_latency_us->increment((MonoTime::Now().ToNanoseconds() - start_ns) / 1000);
+}
 
 BrpcStubCache::BrpcStubCache() {
     _stub_map.init(239);
@@ -35,4 +107,23 @@ BrpcStubCache::~BrpcStubCache() {
         delete stub.second;
     }
 }
+
+PBackendService_Stub* BrpcStubCache::get_stub(const butil::EndPoint& endpoint) {
+    std::lock_guard<SpinLock> l(_lock);
+    auto stub_ptr = _stub_map.seek(endpoint);
+    if (stub_ptr != nullptr) {
+        return *stub_ptr;
+    }
+    // new one stub and insert into map
+    brpc::ChannelOptions options;
+    options.connection_type = config::brpc_connection_type;
+    std::unique_ptr<brpc::Channel> channel(new brpc::Channel());
+    if (channel->Init(endpoint, &options)) {
+        return nullptr;
+    }
+    auto stub = new PBackendService_Stub(new PeerMetricsChannel(channel.release(), endpoint),
+                                         google::protobuf::Service::STUB_OWNS_CHANNEL);
+    _stub_map.insert(endpoint, stub);
+    return stub;
+}
 } // namespace doris
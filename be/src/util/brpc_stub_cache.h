@@ -28,29 +28,40 @@
 
 namespace doris {
 
+// Channel to a peer which counts the rpcs to it in the metrics of the peer, labeled by its
+// endpoint: the number of rpcs, the failed ones, the ones in flight and the total latency.
+class PeerMetricsChannel : public google::protobuf::RpcChannel {
+public:
+    PeerMetricsChannel(brpc::Channel* channel, const butil::EndPoint& endpoint);
+    ~PeerMetricsChannel() override;
+
+    void CallMethod(const google::protobuf::MethodDescriptor* method,
+                    google::protobuf::RpcController* controller,
+                    const google::protobuf::Message* request, google::protobuf::Message* response,
+                    google::protobuf::Closure* done) override;
+
+private:
+    class DoneClosure;
+
+    void _on_rpc_done(google::protobuf::RpcController* controller, int64_t start_ns);
+
+    std::unique_ptr<brpc::Channel> _channel;
+    std::shared_ptr<MetricEntity> _entity;
+
+    IntCounter* brpc_peer_rpc_total;
+    IntCounter* brpc_peer_rpc_failed_total;
+    IntCounter* brpc_peer_rpc_latency_us;
+    IntGauge* brpc_peer_rpc_in_flight;
+};
+
 // map used
 class BrpcStubCache {
 public:
     BrpcStubCache();
     ~BrpcStubCache();
 
-    PBackendService_Stub* get_stub(const butil::EndPoint& endpoint) {
-        std::lock_guard<SpinLock> l(_lock);
-        auto stub_ptr = _stub_map.seek(endpoint);
-        if (stub_ptr != nullptr) {
-            return *stub_ptr;
-        }
-        // new one stub and insert into map
-        brpc::ChannelOptions options;
-        std::unique_ptr<brpc::Channel> channel(new brpc::Channel());
-        if (channel->Init(endpoint, &options)) {
-            return nullptr;
-        }
-        auto stub = new PBackendService_Stub(channel.release(),
-                                             google::protobuf::Service::STUB_OWNS_CHANNEL);
-        _stub_map.insert(endpoint, stub);
-        return stub;
-    }
+    // The connections of the stubs are per config::brpc_connection_type.
+    PBackendService_Stub* get_stub(const butil::EndPoint& endpoint);
 
     PBackendService_Stub* get_stub(const TNetworkAddress& taddr) {
         butil::EndPoint endpoint;
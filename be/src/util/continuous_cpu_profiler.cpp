@@ -0,0 +1,163 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "util/continuous_cpu_profiler.h"
+
+#include <errno.h>
+#include <gperftools/stacktrace.h>
+#include <signal.h>
+#include <string.h>
+#include <time.h>
+
+#include "gutil/strings/substitute.h"
+
+namespace doris {
+
+const char* const ContinuousCpuProfiler::FRAGMENT = "fragment";
+const char* const ContinuousCpuProfiler::SCANNER = "scanner";
+const char* const ContinuousCpuProfiler::COMPACTION = "compaction";
+const char* const ContinuousCpuProfiler::FLUSH = "flush";
+
+// SIGPROF is used by the profiler of gperftools
+static const int kSignalOffsetFromRtMin = 2;
+
+// A POD, so that the signal handler can read it
+static __thread CpuProfilerTag tls_tag = {0, 0, "other"};
+
+static void sample_handler(int signo, siginfo_t* info, void* ucontext) {
+    int saved_errno = errno;
+    ContinuousCpuProfiler::instance()->add_sample(ucontext);
+    errno = saved_errno;
+}
+
+ContinuousCpuProfiler* ContinuousCpuProfiler::instance() {
+    static ContinuousCpuProfiler profiler;
+    return &profiler;
+}
+
+Status ContinuousCpuProfiler::start(int interval_ms, int capacity) {
+    if (started()) {
+        return Status::InternalError("continuous cpu profiler is already started");
+    }
+    if (interval_ms <= 0 || capacity <= 0) {
+        return Status::InvalidArgument(strings::Substitute(
+                "invalid interval $0ms or capacity $1 of continuous cpu profiler", interval_ms,
+                capacity));
+    }
+    _capacity = capacity;
+    _slots.reset(new Slot[capacity]);
+    for (int i = 0; i < capacity; ++i) {
+        _slots[i].seq.store(0, std::memory_order_relaxed);
+    }
+    // the unwinder may allocate on its first use, which must not be in the signal handler
+    void* frames[MAX_DEPTH];
+    GetStackTrace(frames, MAX_DEPTH, 0);
+
+    int signo = SIGRTMIN + kSignalOffsetFromRtMin;
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_sigaction = sample_handler;
+    sa.sa_flags = SA_SIGINFO | SA_RESTART;
+    sigemptyset(&sa.sa_mask);
+    struct sigevent sev;
+    memset(&sev, 0, sizeof(sev));
+    sev.sigev_notify = SIGEV_SIGNAL;
+    sev.sigev_signo = signo;
+    timer_t timer;
+    struct itimerspec its;
+    its.it_interval.tv_sec = interval_ms / 1000;
+    its.it_interval.tv_nsec = (interval_ms % 1000) * 1000000L;
+    its.it_value = its.it_interval;
+    // the timer of the CPU time of the process expires in the tick of a running thread, and
+    // the signal is delivered to that thread
+    if (sigaction(signo, &sa, nullptr) != 0 ||
+        timer_create(CLOCK_PROCESS_CPUTIME_ID, &sev, &timer) != 0 ||
+        timer_settime(timer, 0, &its, nullptr) != 0) {
+        char buf[64];
+        std::string msg = strings::Substitute("failed to start continuous cpu profiler: $0",
+                                              strerror_r(errno, buf, sizeof(buf)));
+        _slots.reset();
+        return Status::InternalError(msg);
+    }
+    return Status::OK();
+}
+
+void ContinuousCpuProfiler::add_sample(const void* ucontext) {
+    if (_slots == nullptr) {
+        return;
+    }
+    uint64_t n = _next_seq.fetch_add(1, std::memory_order_relaxed);
+    Slot& slot = _slots[n % _capacity];
+    slot.seq.store(2 * n + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    slot.sample.timestamp_ms = ts.tv_sec * 1000L + ts.tv_nsec / 1000000L;
+    slot.sample.tag = tls_tag;
+    // skip this function and the signal handler
+    slot.sample.depth = GetStackTraceWithContext(slot.sample.frames, MAX_DEPTH, 2, ucontext);
+    slot.seq.store(2 * n + 2, std::memory_order_release);
+}
+
+void ContinuousCpuProfiler::get_samples(int64_t start_ms, int64_t end_ms,
+                                        const TUniqueId* query_id, const std::string& role,
+                                        std::vector<Sample>* samples) const {
+    if (_slots == nullptr) {
+        return;
+    }
+    Sample sample;
+    for (size_t i = 0; i < _capacity; ++i) {
+        const Slot& slot = _slots[i];
+        uint64_t seq = slot.seq.load(std::memory_order_acquire);
+        if (seq == 0 || seq % 2 == 1) {
+            continue;
+        }
+        memcpy(&sample, &slot.sample, sizeof(Sample));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.seq.load(std::memory_order_relaxed) != seq) {
+            // overwritten while copied
+            continue;
+        }
+        if (sample.timestamp_ms < start_ms || sample.timestamp_ms > end_ms) {
+            continue;
+        }
+        if (query_id != nullptr &&
+            (sample.tag.query_id_hi != query_id->hi || sample.tag.query_id_lo != query_id->lo)) {
+            continue;
+        }
+        if (!role.empty() && role != sample.tag.role) {
+            continue;
+        }
+        samples->push_back(sample);
+    }
+}
+
+ScopedCpuProfilerTag::ScopedCpuProfilerTag(const TUniqueId& query_id, const char* role)
+        : _last_tag(tls_tag) {
+    tls_tag = {query_id.hi, query_id.lo, role};
+}
+
+ScopedCpuProfilerTag::ScopedCpuProfilerTag(const char* role) : _last_tag(tls_tag) {
+    tls_tag = {0, 0, role};
+}
+
+ScopedCpuProfilerTag::~ScopedCpuProfilerTag() {
+    tls_tag = _last_tag;
+}
+
+} // namespace doris
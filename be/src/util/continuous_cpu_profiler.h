@@ -0,0 +1,104 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/status.h"
+#include "gen_cpp/Types_types.h"
+
+namespace doris {
+
+// The query and the role of a thread, which tags the samples of the thread.
+// 'role' must be a string literal. It's "other" if the thread isn't tagged.
+struct CpuProfilerTag {
+    int64_t query_id_hi;
+    int64_t query_id_lo;
+    const char* role;
+};
+
+// A sampling CPU profiler that runs all the time at a low frequency, so that the CPU time
+// of a slow query can be looked at after it finished, instead of profiling it live.
+//
+// A sample is taken every 'interval_ms' milliseconds of the CPU time of the process, from the
+// thread that is running when the timer expires, with the CpuProfilerTag of that thread.
+// The latest samples are kept in a ring buffer, which is written in the signal handler
+// without locks.
+class ContinuousCpuProfiler {
+public:
+    static const char* const FRAGMENT;
+    static const char* const SCANNER;
+    static const char* const COMPACTION;
+    static const char* const FLUSH;
+
+    static const int MAX_DEPTH = 32;
+
+    struct Sample {
+        // unix time
+        int64_t timestamp_ms;
+        CpuProfilerTag tag;
+        int depth;
+        // the innermost frame first
+        void* frames[MAX_DEPTH];
+    };
+
+    static ContinuousCpuProfiler* instance();
+
+    // Starts sampling every 'interval_ms' milliseconds of CPU time, keeping the latest
+    // 'capacity' samples. Can only be started once.
+    Status start(int interval_ms, int capacity);
+    bool started() const { return _slots != nullptr; }
+
+    // Appends the samples taken in [start_ms, end_ms] to 'samples', of the query if
+    // 'query_id' is not null and of the role if 'role' is not empty.
+    void get_samples(int64_t start_ms, int64_t end_ms, const TUniqueId* query_id,
+                     const std::string& role, std::vector<Sample>* samples) const;
+
+    // Called in the signal handler
+    void add_sample(const void* ucontext);
+
+private:
+    // 'seq' is odd while the sample is written, 0 if it's never written
+    struct Slot {
+        std::atomic<uint64_t> seq;
+        Sample sample;
+    };
+
+    ContinuousCpuProfiler() {}
+
+    std::unique_ptr<Slot[]> _slots;
+    size_t _capacity = 0;
+    std::atomic<uint64_t> _next_seq {0};
+};
+
+// Tags the samples of the current thread in its scope, and restores the last tag at its end.
+class ScopedCpuProfilerTag {
+public:
+    ScopedCpuProfilerTag(const TUniqueId& query_id, const char* role);
+    explicit ScopedCpuProfilerTag(const char* role);
+    ~ScopedCpuProfilerTag();
+
+private:
+    CpuProfilerTag _last_tag;
+};
+
+} // namespace doris
@@ -0,0 +1,90 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include "util/cpu_info.h"
+
+// Runtime dispatch of the hot kernels by the instruction sets of the CPU.
+//
+// The BE is built for SSE4.2 on x86, which is what all the CPUs running it have. The
+// kernels gaining from wider instruction sets are compiled for them as well, by the
+// target attributes below whatever the build targets, and their implementation is chosen
+// by CpuInfo when they are called. So one binary runs AVX2 or AVX-512 kernels on the CPUs
+// having them, and the SSE4.2 ones on older CPUs without crashing. CpuInfo::TempDisable
+// turns the wider implementations off, e.g. to test the others.
+//
+// Usage:
+//      DORIS_TARGET_AVX2 void foo_avx2(const int* data, size_t size);
+//      void foo_default(const int* data, size_t size);
+//
+//      void foo(const int* data, size_t size) {
+//      #ifdef DORIS_TARGET_AVX2
+//          if (cpu_dispatch::best_isa() >= cpu_dispatch::Isa::AVX2) {
+//              return foo_avx2(data, size);
+//          }
+//      #endif
+//          foo_default(data, size);
+//      }
+#if defined(__x86_64__) && defined(__GNUC__)
+#define DORIS_TARGET_AVX2 __attribute__((target("avx2")))
+#define DORIS_TARGET_AVX512 __attribute__((target("avx2,avx512f,avx512bw")))
+#endif
+
+namespace doris {
+namespace cpu_dispatch {
+
+// The instruction sets of the kernels, each of which includes the previous ones
+enum class Isa : int {
+    DEFAULT = 0,
+    AVX2 = 1,
+    AVX512 = 2,
+};
+
+// The widest instruction set of the CPU which the kernels are built for. The default
+// implementations are used until CpuInfo is initialized, e.g. by tools and tests.
+inline Isa best_isa() {
+    if (!CpuInfo::initialized()) {
+        return Isa::DEFAULT;
+    }
+#ifdef DORIS_TARGET_AVX512
+    if (CpuInfo::is_supported(CpuInfo::AVX512F) && CpuInfo::is_supported(CpuInfo::AVX512BW) &&
+        CpuInfo::is_supported(CpuInfo::AVX2)) {
+        return Isa::AVX512;
+    }
+#endif
+#ifdef DORIS_TARGET_AVX2
+    if (CpuInfo::is_supported(CpuInfo::AVX2)) {
+        return Isa::AVX2;
+    }
+#endif
+    return Isa::DEFAULT;
+}
+
+inline const char* isa_name(Isa isa) {
+    switch (isa) {
+    case Isa::AVX512:
+        return "avx512";
+    case Isa::AVX2:
+        return "avx2";
+    default:
+        return "default";
+    }
+}
+
+} // namespace cpu_dispatch
+} // namespace doris
@@ -51,6 +51,7 @@
 #include "common/env_config.h"
 #include "gflags/gflags.h"
 #include "gutil/strings/substitute.h"
+#include "util/cpu_dispatch.h"
 #include "util/pretty_printer.h"
 #include "util/string_parser.hpp"
 
@@ -100,6 +101,7 @@ static struct {
 } flag_mappings[] = {
         {"ssse3", CpuInfo::SSSE3},   {"sse4_1", CpuInfo::SSE4_1}, {"sse4_2", CpuInfo::SSE4_2},
         {"popcnt", CpuInfo::POPCNT}, {"avx", CpuInfo::AVX},       {"avx2", CpuInfo::AVX2},
+        {"avx512f", CpuInfo::AVX512F}, {"avx512bw", CpuInfo::AVX512BW},
 };
 static const long num_flags = sizeof(flag_mappings) / sizeof(flag_mappings[0]);
 
@@ -372,6 +374,8 @@ std::string CpuInfo::debug_string() {
             stream << "    " << flag_mappings[i].name << std::endl;
         }
     }
+    stream << "  Kernels Dispatched To: " << cpu_dispatch::isa_name(cpu_dispatch::best_isa())
+           << std::endl;
     stream << "  Numa Nodes: " << max_num_numa_nodes_ << std::endl;
     stream << "  Numa Nodes of Cores:";
     for (int core = 0; core < max_num_cores_; ++core) {
@@ -39,6 +39,8 @@ public:
     static const int64_t POPCNT = (1 << 4);
     static const int64_t AVX = (1 << 5);
     static const int64_t AVX2 = (1 << 6);
+    static const int64_t AVX512F = (1 << 7);
+    static const int64_t AVX512BW = (1 << 8);
 
     /// Cache enums for L1 (data), L2 and L3
     enum CacheLevel {
@@ -61,6 +63,8 @@ public:
     /// Determine if CPU turbo is disabled and if not, issue an error.
     static void verify_turbo_disabled();
 
+    static bool initialized() { return initialized_; }
+
     /// Returns all the flags for this cpu
     static int64_t hardware_flags() {
         DCHECK(initialized_);
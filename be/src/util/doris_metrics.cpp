@@ -34,6 +34,8 @@ DEFINE_COUNTER_METRIC_PROTOTYPE_2ARG(http_requests_total, MetricUnit::REQUESTS);
 DEFINE_COUNTER_METRIC_PROTOTYPE_2ARG(http_request_send_bytes, MetricUnit::BYTES);
 DEFINE_COUNTER_METRIC_PROTOTYPE_2ARG(query_scan_bytes, MetricUnit::BYTES);
 DEFINE_COUNTER_METRIC_PROTOTYPE_2ARG(query_scan_rows, MetricUnit::ROWS);
+DEFINE_COUNTER_METRIC_PROTOTYPE_2ARG(data_stream_receiver_blocked_bytes, MetricUnit::BYTES);
+DEFINE_COUNTER_METRIC_PROTOTYPE_2ARG(data_stream_receiver_spilled_bytes, MetricUnit::BYTES);
 DEFINE_COUNTER_METRIC_PROTOTYPE_2ARG(query_scan_count, MetricUnit::NOUNIT);
 DEFINE_COUNTER_METRIC_PROTOTYPE_5ARG(push_requests_success_total, MetricUnit::REQUESTS, "",
                                      push_requests_total, Labels({{"status", "SUCCESS"}}));
@@ -84,6 +86,9 @@ DEFINE_COUNTER_METRIC_PROTOTYPE_5ARG(base_compaction_bytes_total, MetricUnit::BY
                                      compaction_bytes_total, Labels({{"type", "base"}}));
 DEFINE_COUNTER_METRIC_PROTOTYPE_5ARG(cumulative_compaction_bytes_total, MetricUnit::BYTES, "",
                                      compaction_bytes_total, Labels({{"type", "cumulative"}}));
+DEFINE_COUNTER_METRIC_PROTOTYPE_2ARG(rowset_conversion_rowsets_total, MetricUnit::ROWSETS);
+DEFINE_COUNTER_METRIC_PROTOTYPE_2ARG(rowset_conversion_bytes_total, MetricUnit::BYTES);
+DEFINE_COUNTER_METRIC_PROTOTYPE_2ARG(index_build_rowsets_total, MetricUnit::ROWSETS);
 
 DEFINE_COUNTER_METRIC_PROTOTYPE_5ARG(meta_write_request_total, MetricUnit::REQUESTS, "",
                                      meta_request_total, Labels({{"type", "write"}}));
@@ -130,6 +135,23 @@ DEFINE_COUNTER_METRIC_PROTOTYPE_2ARG(load_bytes, MetricUnit::BYTES);
 
 DEFINE_COUNTER_METRIC_PROTOTYPE_2ARG(memtable_flush_total, MetricUnit::OPERATIONS);
 DEFINE_COUNTER_METRIC_PROTOTYPE_2ARG(memtable_flush_duration_us, MetricUnit::MICROSECONDS);
+DEFINE_COUNTER_METRIC_PROTOTYPE_2ARG(huge_page_alloc_total, MetricUnit::NOUNIT);
+DEFINE_COUNTER_METRIC_PROTOTYPE_2ARG(hugetlb_alloc_total, MetricUnit::NOUNIT);
+DEFINE_COUNTER_METRIC_PROTOTYPE_2ARG(hugetlb_alloc_fallback_total, MetricUnit::NOUNIT);
+
+#define DEFINE_BRPC_LATENCY_METRIC(name, method)                                               \
+    DEFINE_HISTOGRAM_METRIC_PROTOTYPE_5ARG(name, MetricUnit::MICROSECONDS, "",                 \
+                                           brpc_request_latency_us,                            \
+                                           Labels({{"method", #method}}));
+DEFINE_BRPC_LATENCY_METRIC(brpc_transmit_data_latency_us, transmit_data);
+DEFINE_BRPC_LATENCY_METRIC(brpc_exec_plan_fragment_latency_us, exec_plan_fragment);
+DEFINE_BRPC_LATENCY_METRIC(brpc_cancel_plan_fragment_latency_us, cancel_plan_fragment);
+DEFINE_BRPC_LATENCY_METRIC(brpc_tablet_writer_open_latency_us, tablet_writer_open);
+DEFINE_BRPC_LATENCY_METRIC(brpc_tablet_writer_add_batch_latency_us, tablet_writer_add_batch);
+DEFINE_BRPC_LATENCY_METRIC(brpc_tablet_writer_cancel_latency_us, tablet_writer_cancel);
+DEFINE_HISTOGRAM_METRIC_PROTOTYPE_2ARG(page_read_latency_us, MetricUnit::MICROSECONDS);
+DEFINE_HISTOGRAM_METRIC_PROTOTYPE_2ARG(memtable_flush_latency_us, MetricUnit::MICROSECONDS);
+DEFINE_HISTOGRAM_METRIC_PROTOTYPE_2ARG(publish_latency_us, MetricUnit::MICROSECONDS);
 
 DEFINE_GAUGE_METRIC_PROTOTYPE_2ARG(memory_pool_bytes_total, MetricUnit::BYTES);
 DEFINE_GAUGE_CORE_METRIC_PROTOTYPE_2ARG(process_thread_num, MetricUnit::NOUNIT);
@@ -142,6 +164,8 @@ DEFINE_GAUGE_METRIC_PROTOTYPE_2ARG(tablet_base_max_compaction_score, MetricUnit:
 
 DEFINE_GAUGE_METRIC_PROTOTYPE_2ARG(compaction_used_permits, MetricUnit::NOUNIT);
 DEFINE_GAUGE_METRIC_PROTOTYPE_2ARG(compaction_waitting_permits, MetricUnit::NOUNIT);
+DEFINE_GAUGE_METRIC_PROTOTYPE_2ARG(rowset_conversion_remaining_rowsets, MetricUnit::ROWSETS);
+DEFINE_GAUGE_METRIC_PROTOTYPE_2ARG(index_build_remaining_rowsets, MetricUnit::ROWSETS);
 
 DEFINE_GAUGE_CORE_METRIC_PROTOTYPE_2ARG(push_request_write_bytes_per_second, MetricUnit::BYTES);
 DEFINE_GAUGE_CORE_METRIC_PROTOTYPE_2ARG(query_scan_bytes_per_second, MetricUnit::BYTES);
@@ -156,10 +180,16 @@ DEFINE_COUNTER_METRIC_PROTOTYPE_2ARG(blocks_deleted_total, MetricUnit::OPERATION
 DEFINE_COUNTER_METRIC_PROTOTYPE_2ARG(bytes_read_total, MetricUnit::BYTES);
 DEFINE_COUNTER_METRIC_PROTOTYPE_2ARG(bytes_written_total, MetricUnit::BYTES);
 DEFINE_COUNTER_METRIC_PROTOTYPE_2ARG(disk_sync_total, MetricUnit::OPERATIONS);
+DEFINE_COUNTER_METRIC_PROTOTYPE_2ARG(block_file_cache_hit_total, MetricUnit::OPERATIONS);
+DEFINE_COUNTER_METRIC_PROTOTYPE_2ARG(block_file_open_total, MetricUnit::OPERATIONS);
+DEFINE_COUNTER_METRIC_PROTOTYPE_2ARG(block_file_open_duration_us, MetricUnit::MICROSECONDS);
 
 DEFINE_GAUGE_METRIC_PROTOTYPE_2ARG(blocks_open_reading, MetricUnit::BLOCKS);
 DEFINE_GAUGE_METRIC_PROTOTYPE_2ARG(blocks_open_writing, MetricUnit::BLOCKS);
 
+DEFINE_COUNTER_METRIC_PROTOTYPE_2ARG(startup_tablets_total, MetricUnit::NOUNIT);
+DEFINE_COUNTER_METRIC_PROTOTYPE_2ARG(startup_loaded_tablets_total, MetricUnit::NOUNIT);
+
 DEFINE_GAUGE_CORE_METRIC_PROTOTYPE_2ARG(query_cache_memory_total_byte, MetricUnit::BYTES);
 DEFINE_GAUGE_CORE_METRIC_PROTOTYPE_2ARG(query_cache_sql_total_count, MetricUnit::NOUNIT);
 DEFINE_GAUGE_CORE_METRIC_PROTOTYPE_2ARG(query_cache_partition_total_count, MetricUnit::NOUNIT);
@@ -176,6 +206,8 @@ DorisMetrics::DorisMetrics() : _metric_registry(_s_registry_name) {
     INT_COUNTER_METRIC_REGISTER(_server_metric_entity, http_request_send_bytes);
     INT_COUNTER_METRIC_REGISTER(_server_metric_entity, query_scan_bytes);
     INT_COUNTER_METRIC_REGISTER(_server_metric_entity, query_scan_rows);
+    INT_COUNTER_METRIC_REGISTER(_server_metric_entity, data_stream_receiver_blocked_bytes);
+    INT_COUNTER_METRIC_REGISTER(_server_metric_entity, data_stream_receiver_spilled_bytes);
 
     INT_COUNTER_METRIC_REGISTER(_server_metric_entity, push_requests_success_total);
     INT_COUNTER_METRIC_REGISTER(_server_metric_entity, push_requests_fail_total);
@@ -217,6 +249,9 @@ DorisMetrics::DorisMetrics() : _metric_registry(_s_registry_name) {
     INT_COUNTER_METRIC_REGISTER(_server_metric_entity, base_compaction_bytes_total);
     INT_COUNTER_METRIC_REGISTER(_server_metric_entity, cumulative_compaction_deltas_total);
     INT_COUNTER_METRIC_REGISTER(_server_metric_entity, cumulative_compaction_bytes_total);
+    INT_COUNTER_METRIC_REGISTER(_server_metric_entity, rowset_conversion_rowsets_total);
+    INT_COUNTER_METRIC_REGISTER(_server_metric_entity, rowset_conversion_bytes_total);
+    INT_COUNTER_METRIC_REGISTER(_server_metric_entity, index_build_rowsets_total);
 
     INT_COUNTER_METRIC_REGISTER(_server_metric_entity, meta_write_request_total);
     INT_COUNTER_METRIC_REGISTER(_server_metric_entity, meta_write_request_duration_us);
@@ -237,6 +272,19 @@ DorisMetrics::DorisMetrics() : _metric_registry(_s_registry_name) {
 
     INT_COUNTER_METRIC_REGISTER(_server_metric_entity, memtable_flush_total);
     INT_COUNTER_METRIC_REGISTER(_server_metric_entity, memtable_flush_duration_us);
+    INT_COUNTER_METRIC_REGISTER(_server_metric_entity, huge_page_alloc_total);
+    INT_COUNTER_METRIC_REGISTER(_server_metric_entity, hugetlb_alloc_total);
+    INT_COUNTER_METRIC_REGISTER(_server_metric_entity, hugetlb_alloc_fallback_total);
+
+    HISTOGRAM_METRIC_REGISTER(_server_metric_entity, brpc_transmit_data_latency_us);
+    HISTOGRAM_METRIC_REGISTER(_server_metric_entity, brpc_exec_plan_fragment_latency_us);
+    HISTOGRAM_METRIC_REGISTER(_server_metric_entity, brpc_cancel_plan_fragment_latency_us);
+    HISTOGRAM_METRIC_REGISTER(_server_metric_entity, brpc_tablet_writer_open_latency_us);
+    HISTOGRAM_METRIC_REGISTER(_server_metric_entity, brpc_tablet_writer_add_batch_latency_us);
+    HISTOGRAM_METRIC_REGISTER(_server_metric_entity, brpc_tablet_writer_cancel_latency_us);
+    HISTOGRAM_METRIC_REGISTER(_server_metric_entity, page_read_latency_us);
+    HISTOGRAM_METRIC_REGISTER(_server_metric_entity, memtable_flush_latency_us);
+    HISTOGRAM_METRIC_REGISTER(_server_metric_entity, publish_latency_us);
 
     INT_GAUGE_METRIC_REGISTER(_server_metric_entity, memory_pool_bytes_total);
     INT_GAUGE_METRIC_REGISTER(_server_metric_entity, process_thread_num);
@@ -249,6 +297,8 @@ DorisMetrics::DorisMetrics() : _metric_registry(_s_registry_name) {
 
     INT_GAUGE_METRIC_REGISTER(_server_metric_entity, compaction_used_permits);
     INT_GAUGE_METRIC_REGISTER(_server_metric_entity, compaction_waitting_permits);
+    INT_GAUGE_METRIC_REGISTER(_server_metric_entity, rowset_conversion_remaining_rowsets);
+    INT_GAUGE_METRIC_REGISTER(_server_metric_entity, index_build_remaining_rowsets);
 
     INT_GAUGE_METRIC_REGISTER(_server_metric_entity, push_request_write_bytes_per_second);
     INT_GAUGE_METRIC_REGISTER(_server_metric_entity, query_scan_bytes_per_second);
@@ -263,9 +313,15 @@ DorisMetrics::DorisMetrics() : _metric_registry(_s_registry_name) {
     INT_COUNTER_METRIC_REGISTER(_server_metric_entity, bytes_read_total);
     INT_COUNTER_METRIC_REGISTER(_server_metric_entity, bytes_written_total);
     INT_COUNTER_METRIC_REGISTER(_server_metric_entity, disk_sync_total);
+    INT_COUNTER_METRIC_REGISTER(_server_metric_entity, block_file_cache_hit_total);
+    INT_COUNTER_METRIC_REGISTER(_server_metric_entity, block_file_open_total);
+    INT_COUNTER_METRIC_REGISTER(_server_metric_entity, block_file_open_duration_us);
     INT_GAUGE_METRIC_REGISTER(_server_metric_entity, blocks_open_reading);
     INT_GAUGE_METRIC_REGISTER(_server_metric_entity, blocks_open_writing);
 
+    INT_COUNTER_METRIC_REGISTER(_server_metric_entity, startup_tablets_total);
+    INT_COUNTER_METRIC_REGISTER(_server_metric_entity, startup_loaded_tablets_total);
+
     INT_COUNTER_METRIC_REGISTER(_server_metric_entity, load_rows);
     INT_COUNTER_METRIC_REGISTER(_server_metric_entity, load_bytes);
 
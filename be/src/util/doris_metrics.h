@@ -47,6 +47,10 @@ public:
     IntCounter* http_request_send_bytes;
     IntCounter* query_scan_bytes;
     IntCounter* query_scan_rows;
+    // bytes of the batches whose senders were blocked by full exchange receivers, and of the
+    // batches the receivers spilled instead
+    IntCounter* data_stream_receiver_blocked_bytes;
+    IntCounter* data_stream_receiver_spilled_bytes;
 
     IntCounter* push_requests_success_total;
     IntCounter* push_requests_fail_total;
@@ -89,6 +93,11 @@ public:
     IntCounter* cumulative_compaction_deltas_total;
     IntCounter* cumulative_compaction_bytes_total;
 
+    // alpha rowsets converted to beta rowsets in background, and their data size
+    IntCounter* rowset_conversion_rowsets_total;
+    IntCounter* rowset_conversion_bytes_total;
+    IntCounter* index_build_rowsets_total;
+
     IntCounter* publish_task_request_total;
     IntCounter* publish_task_failed_total;
 
@@ -120,6 +129,24 @@ public:
     IntCounter* memtable_flush_total;
     IntCounter* memtable_flush_duration_us;
 
+    // Buffers and chunks backed by huge pages, see util/huge_page.h
+    IntCounter* huge_page_alloc_total;
+    IntCounter* hugetlb_alloc_total;
+    IntCounter* hugetlb_alloc_fallback_total;
+
+    // Latency histograms, in microseconds
+    // time in the brpc handlers of PInternalService
+    HistogramMetric* brpc_transmit_data_latency_us;
+    HistogramMetric* brpc_exec_plan_fragment_latency_us;
+    HistogramMetric* brpc_cancel_plan_fragment_latency_us;
+    HistogramMetric* brpc_tablet_writer_open_latency_us;
+    HistogramMetric* brpc_tablet_writer_add_batch_latency_us;
+    HistogramMetric* brpc_tablet_writer_cancel_latency_us;
+    // reading a page of segment v2 from its file, so the pages in the page cache are left out
+    HistogramMetric* page_read_latency_us;
+    HistogramMetric* memtable_flush_latency_us;
+    HistogramMetric* publish_latency_us;
+
     IntGauge* memory_pool_bytes_total;
     IntGauge* process_thread_num;
     IntGauge* process_fd_num_used;
@@ -137,6 +164,10 @@ public:
     // permits required by the compaction task which is waitting for permits
     IntGauge* compaction_waitting_permits;
 
+    // alpha rowsets left to be converted to beta rowsets
+    IntGauge* rowset_conversion_remaining_rowsets;
+    IntGauge* index_build_remaining_rowsets;
+
     // The following metrics will be calculated
     // by metric calculator
     IntGauge* push_request_write_bytes_per_second;
@@ -153,9 +184,16 @@ public:
     IntCounter* bytes_read_total;
     IntCounter* bytes_written_total;
     IntCounter* disk_sync_total;
+    IntCounter* block_file_cache_hit_total;
+    IntCounter* block_file_open_total;
+    IntCounter* block_file_open_duration_us;
     IntGauge* blocks_open_reading;
     IntGauge* blocks_open_writing;
 
+    // Progress of loading tablets on start
+    IntCounter* startup_tablets_total;
+    IntCounter* startup_loaded_tablets_total;
+
     // Size of some global containers
     UIntGauge* rowset_count_generated_and_in_use;
     UIntGauge* unused_rowsets_count;
@@ -172,6 +210,8 @@ public:
     UIntGauge* stream_load_pipe_count;
     UIntGauge* brpc_endpoint_stub_count;
     UIntGauge* tablet_writer_count;
+    UIntGauge* scanner_thread_pool_queue_size;
+    UIntGauge* broker_scanner_thread_pool_queue_size;
 
     UIntGauge* compaction_mem_current_consumption;
 
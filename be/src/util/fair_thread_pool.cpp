@@ -0,0 +1,219 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "util/fair_thread_pool.h"
+
+#include <chrono>
+
+#include "common/logging.h"
+#include "util/time.h"
+
+namespace doris {
+
+FairThreadPool::FairThreadPool(uint32_t num_threads, uint32_t queue_size)
+        : _max_queued(queue_size) {
+    for (int i = 0; i < num_threads; ++i) {
+        _workers.emplace_back(new Worker());
+    }
+    for (int i = 0; i < num_threads; ++i) {
+        _threads.emplace_back(&FairThreadPool::_work_thread, this, i);
+    }
+}
+
+FairThreadPool::~FairThreadPool() {
+    shutdown();
+    join();
+}
+
+bool FairThreadPool::offer(const UniqueId& group_id, Task task) {
+    std::unique_lock<std::mutex> l(_lock);
+    // increase it before checking _num_queued, so that a consumer who makes room
+    // after our check will notify us
+    ++_num_waiting_offers;
+    while (!_shutdown && _num_queued >= _max_queued) {
+        _put_cv.wait(l);
+    }
+    --_num_waiting_offers;
+    if (_shutdown) {
+        return false;
+    }
+    task.offer_time_ns = MonotonicNanos();
+    auto& tasks = _groups[group_id];
+    if (tasks.empty()) {
+        _group_order.push_back(group_id);
+    }
+    tasks.push_back(std::move(task));
+    ++_num_queued;
+    l.unlock();
+    _get_cv.notify_one();
+    return true;
+}
+
+void FairThreadPool::shutdown() {
+    {
+        std::lock_guard<std::mutex> l(_lock);
+        _shutdown = true;
+    }
+    _get_cv.notify_all();
+    _put_cv.notify_all();
+}
+
+void FairThreadPool::join() {
+    for (auto& thread : _threads) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+}
+
+size_t FairThreadPool::num_groups() const {
+    std::lock_guard<std::mutex> l(_lock);
+    return _group_order.size();
+}
+
+void FairThreadPool::_work_thread(int thread_id) {
+    Task task;
+    while (_next_task(thread_id, &task)) {
+        if (task.queue_wait_timer != nullptr) {
+            task.queue_wait_timer->update(MonotonicNanos() - task.offer_time_ns);
+        }
+        task.work_function();
+        task = Task();
+    }
+}
+
+bool FairThreadPool::_next_task(int thread_id, Task* task) {
+    Worker* worker = _workers[thread_id].get();
+    bool found = false;
+    {
+        std::lock_guard<std::mutex> l(worker->lock);
+        if (!worker->tasks.empty()) {
+            *task = std::move(worker->tasks.front());
+            worker->tasks.pop_front();
+            found = true;
+        }
+    }
+    if (found) {
+        _on_task_dequeued(1);
+        return true;
+    }
+
+    std::unique_lock<std::mutex> l(_lock);
+    while (!_shutdown) {
+        size_t num_taken = _take_from_groups(thread_id, task);
+        if (num_taken > 0) {
+            l.unlock();
+            // others may steal the tasks put to our local queue
+            for (size_t i = 1; i < num_taken; ++i) {
+                _get_cv.notify_one();
+            }
+            _on_task_dequeued(1);
+            return true;
+        }
+        l.unlock();
+        if (_steal(thread_id, task)) {
+            _on_task_dequeued(1);
+            return true;
+        }
+        l.lock();
+        if (_shutdown || !_group_order.empty()) {
+            continue;
+        }
+        // Tasks put to local queues of busy workers don't notify us, so wake up
+        // periodically to steal them.
+        _get_cv.wait_for(l, std::chrono::milliseconds(100));
+    }
+    return false;
+}
+
+size_t FairThreadPool::_take_from_groups(int thread_id, Task* task) {
+    Worker* worker = _workers[thread_id].get();
+    size_t num_taken = 0;
+    while (num_taken < LOCAL_BATCH_SIZE && !_group_order.empty()) {
+        UniqueId group_id = _group_order.front();
+        _group_order.pop_front();
+        auto it = _groups.find(group_id);
+        DCHECK(it != _groups.end());
+        if (num_taken == 0) {
+            *task = std::move(it->second.front());
+        } else {
+            std::lock_guard<std::mutex> l(worker->lock);
+            worker->tasks.push_back(std::move(it->second.front()));
+        }
+        it->second.pop_front();
+        ++num_taken;
+        if (it->second.empty()) {
+            _groups.erase(it);
+        } else {
+            _group_order.push_back(group_id);
+        }
+    }
+    return num_taken;
+}
+
+bool FairThreadPool::_steal(int thread_id, Task* task) {
+    Worker* victim = nullptr;
+    size_t max_size = 0;
+    for (int i = 0; i < _workers.size(); ++i) {
+        if (i == thread_id) {
+            continue;
+        }
+        // the size may change after unlock, the victim is only a hint
+        std::lock_guard<std::mutex> l(_workers[i]->lock);
+        if (_workers[i]->tasks.size() > max_size) {
+            max_size = _workers[i]->tasks.size();
+            victim = _workers[i].get();
+        }
+    }
+    if (victim == nullptr) {
+        return false;
+    }
+
+    std::deque<Task> stolen;
+    {
+        std::lock_guard<std::mutex> l(victim->lock);
+        size_t num_steal = (victim->tasks.size() + 1) / 2;
+        for (size_t i = 0; i < num_steal; ++i) {
+            stolen.push_front(std::move(victim->tasks.back()));
+            victim->tasks.pop_back();
+        }
+    }
+    if (stolen.empty()) {
+        return false;
+    }
+    *task = std::move(stolen.front());
+    stolen.pop_front();
+    if (!stolen.empty()) {
+        Worker* worker = _workers[thread_id].get();
+        std::lock_guard<std::mutex> l(worker->lock);
+        for (auto& t : stolen) {
+            worker->tasks.push_back(std::move(t));
+        }
+    }
+    return true;
+}
+
+void FairThreadPool::_on_task_dequeued(size_t num) {
+    // must not hold any worker lock, see _take_from_groups() for lock order
+    _num_queued -= num;
+    if (_num_waiting_offers > 0) {
+        std::lock_guard<std::mutex> l(_lock);
+        _put_cv.notify_all();
+    }
+}
+
+} // namespace doris
@@ -0,0 +1,126 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "util/runtime_profile.h"
+#include "util/uid_util.h"
+
+namespace doris {
+
+// Thread pool which shares its threads fairly among groups of tasks, e.g. the
+// scanners of different queries.
+//
+// Tasks are queued per group and groups are served round robin, so a group
+// which offered thousands of tasks doesn't delay the few tasks of another
+// group. A task is expected to do a bounded slice of work and offer itself
+// again if there is more to do.
+//
+// A worker moves a small batch of tasks from the group queues to its own local
+// queue at a time, to keep the shared lock cold. A worker which finds both its
+// local queue and the group queues empty steals half of the local queue of the
+// most loaded worker.
+class FairThreadPool {
+public:
+    typedef std::function<void()> WorkFunction;
+
+    struct Task {
+        WorkFunction work_function;
+        // If not nullptr, time spent in queue is added to it when the task starts.
+        RuntimeProfile::Counter* queue_wait_timer = nullptr;
+        // Set by offer()
+        int64_t offer_time_ns = 0;
+    };
+
+    // Number of tasks a worker takes from the group queues at a time
+    static const size_t LOCAL_BATCH_SIZE = 4;
+
+    //  -- num_threads: how many threads are part of this pool
+    //  -- queue_size: the maximum number of queued tasks, offer() blocks if the
+    //     pool already has so many tasks queued.
+    FairThreadPool(uint32_t num_threads, uint32_t queue_size);
+
+    // Shutdown and wait threads to exit.
+    ~FairThreadPool();
+
+    // Puts a task to the queue of group 'group_id', blocks until there is
+    // capacity available. Returns false if the pool has been shut down.
+    bool offer(const UniqueId& group_id, Task task);
+
+    // Stop accepting tasks, worker threads exit after their current task and
+    // tasks still in queue are dropped.
+    void shutdown();
+
+    // Blocks until all threads are finished.
+    void join();
+
+    uint32_t get_queue_size() const { return _num_queued; }
+    size_t num_threads() const { return _workers.size(); }
+
+    // Number of groups which have tasks in group queues.
+    size_t num_groups() const;
+
+private:
+    struct Worker {
+        std::mutex lock;
+        std::deque<Task> tasks;
+    };
+
+    void _work_thread(int thread_id);
+
+    // Get next task to run for worker 'thread_id'. Returns false on shutdown.
+    bool _next_task(int thread_id, Task* task);
+
+    // Take tasks from group queues round robin, the first one is returned in
+    // 'task' and the others are put to local queue of worker 'thread_id'.
+    // _lock must be held.
+    size_t _take_from_groups(int thread_id, Task* task);
+
+    // Steal half of the local queue of the most loaded worker.
+    bool _steal(int thread_id, Task* task);
+
+    void _on_task_dequeued(size_t num);
+
+    const uint32_t _max_queued;
+    std::vector<std::unique_ptr<Worker>> _workers;
+    std::vector<std::thread> _threads;
+
+    // Guards _groups, _group_order and _shutdown
+    mutable std::mutex _lock;
+    std::condition_variable _get_cv;
+    std::condition_variable _put_cv;
+    std::map<UniqueId, std::deque<Task>> _groups;
+    // groups which have tasks, in the order they will be served
+    std::deque<UniqueId> _group_order;
+    bool _shutdown = false;
+
+    // number of tasks in group queues and local queues
+    std::atomic<uint32_t> _num_queued{0};
+    std::atomic<uint32_t> _num_waiting_offers{0};
+};
+
+} // namespace doris
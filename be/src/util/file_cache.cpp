@@ -55,6 +55,72 @@ void FileCache<FileType>::insert(const std::string& file_name, FileType* file,
     *file_handle = OpenedFileHandle<FileType>(_cache.get(), lru_handle);
 }
 
+template <class FileType>
+Status FileCache<FileType>::lookup_or_open(
+        const std::string& file_name,
+        const std::function<Status(std::unique_ptr<FileType>*)>& open_func,
+        OpenedFileHandle<FileType>* file_handle, bool* opened) {
+    if (opened != nullptr) {
+        *opened = false;
+    }
+    if (lookup(file_name, file_handle)) {
+        return Status::OK();
+    }
+
+    OpeningShard& shard = _opening_shards[std::hash<std::string>()(file_name) % kNumOpeningShards];
+    std::shared_ptr<OpeningFile> opening;
+    {
+        std::unique_lock<std::mutex> l(shard.lock);
+        auto it = shard.files.find(file_name);
+        if (it != shard.files.end()) {
+            // wait for the thread opening the file
+            opening = it->second;
+            shard.cond.wait(l, [&opening] { return opening->done; });
+            RETURN_IF_ERROR(opening->status);
+            opening.reset();
+        } else {
+            // the file may be inserted after the lookup above
+            if (lookup(file_name, file_handle)) {
+                return Status::OK();
+            }
+            opening.reset(new OpeningFile());
+            shard.files.emplace(file_name, opening);
+        }
+    }
+
+    if (opening == nullptr) {
+        if (lookup(file_name, file_handle)) {
+            return Status::OK();
+        }
+        // The file is already evicted, it's rare so open it without waking others.
+        std::unique_ptr<FileType> file;
+        RETURN_IF_ERROR(open_func(&file));
+        insert(file_name, file.release(), file_handle);
+        if (opened != nullptr) {
+            *opened = true;
+        }
+        return Status::OK();
+    }
+
+    // open the file outside of the lock
+    std::unique_ptr<FileType> file;
+    Status st = open_func(&file);
+    if (st.ok()) {
+        insert(file_name, file.release(), file_handle);
+        if (opened != nullptr) {
+            *opened = true;
+        }
+    }
+    {
+        std::lock_guard<std::mutex> l(shard.lock);
+        opening->done = true;
+        opening->status = st;
+        shard.files.erase(file_name);
+    }
+    shard.cond.notify_all();
+    return st;
+}
+
 // Explicit specialization for callers outside this compilation unit.
 template class FileCache<RandomAccessFile>;
 
@@ -17,9 +17,14 @@
 
 #pragma once
 
+#include <condition_variable>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 
+#include "common/status.h"
 #include "olap/lru_cache.h"
 
 namespace doris {
@@ -133,7 +138,30 @@ public:
     void insert(const std::string& file_name, FileType* file,
                 OpenedFileHandle<FileType>* file_handle);
 
+    // Find the file in the cache, or open it with 'open_func' and insert it into
+    // the cache if not found. Concurrent misses on the same file wait for the one
+    // opening it instead of opening it again. If 'opened' is not null, it's set to
+    // whether the file is opened by this call.
+    Status lookup_or_open(const std::string& file_name,
+                          const std::function<Status(std::unique_ptr<FileType>*)>& open_func,
+                          OpenedFileHandle<FileType>* file_handle, bool* opened = nullptr);
+
 private:
+    // A file being opened by some thread.
+    struct OpeningFile {
+        bool done = false;
+        Status status;
+    };
+
+    // Files being opened are sharded by name, so that opening different files
+    // doesn't contend on one lock.
+    struct OpeningShard {
+        std::mutex lock;
+        std::condition_variable cond;
+        std::unordered_map<std::string, std::shared_ptr<OpeningFile>> files;
+    };
+    static const int kNumOpeningShards = 16;
+
     // Name of the cache.
     std::string _cache_name;
 
@@ -145,6 +173,8 @@ private:
     // this case, _is_cache_own is set to false.
     bool _is_cache_own = false;
 
+    OpeningShard _opening_shards[kNumOpeningShards];
+
     DISALLOW_COPY_AND_ASSIGN(FileCache);
 };
 
@@ -0,0 +1,93 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "util/huge_page_util.h"
+
+#include <errno.h>
+#include <sys/mman.h>
+
+#include "common/config.h"
+#include "common/logging.h"
+#include "util/doris_metrics.h"
+
+namespace doris {
+
+const int64_t HugePageUtil::HUGE_PAGE_SIZE;
+
+bool HugePageUtil::use_huge_pages(int64_t len) {
+    return config::madvise_huge_pages && len > 0 && len % HUGE_PAGE_SIZE == 0;
+}
+
+uint8_t* HugePageUtil::map(int64_t len) {
+    DCHECK_EQ(len % HUGE_PAGE_SIZE, 0) << len;
+#ifdef MAP_HUGETLB
+    if (config::use_hugetlb_pages) {
+        void* mem = mmap(nullptr, len, PROT_READ | PROT_WRITE,
+                         MAP_ANONYMOUS | MAP_PRIVATE | MAP_HUGETLB, -1, 0);
+        if (mem != MAP_FAILED) {
+            DorisMetrics::instance()->hugetlb_alloc_total->increment(1);
+            return reinterpret_cast<uint8_t*>(mem);
+        }
+        // ENOMEM if there aren't enough free reserved huge pages
+        LOG_FIRST_N(WARNING, 5) << "mmap(MAP_HUGETLB) failed, errno=" << errno
+                                << ", fall back to transparent huge pages";
+        DorisMetrics::instance()->hugetlb_alloc_fallback_total->increment(1);
+    }
+#endif
+
+    // Map an extra huge page so we can fix up the alignment if needed.
+    int64_t map_len = len + HUGE_PAGE_SIZE;
+    void* map_mem = mmap(nullptr, map_len, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE,
+                         -1, 0);
+    if (map_mem == MAP_FAILED) {
+        return nullptr;
+    }
+    uint8_t* mem = reinterpret_cast<uint8_t*>(map_mem);
+    // mmap() may return memory that is not aligned to the huge page size. For the
+    // subsequent madvise() call to work well, we need to align it ourselves and
+    // unmap the memory on either side of the buffer that we don't need.
+    uintptr_t misalignment = reinterpret_cast<uintptr_t>(mem) % HUGE_PAGE_SIZE;
+    if (misalignment != 0) {
+        uintptr_t fixup = HUGE_PAGE_SIZE - misalignment;
+        munmap(mem, fixup);
+        mem += fixup;
+        map_len -= fixup;
+    }
+    munmap(mem + len, map_len - len);
+    advise(mem, len, true);
+    return mem;
+}
+
+void HugePageUtil::advise(uint8_t* ptr, int64_t len, bool huge) {
+    DCHECK_EQ(reinterpret_cast<uintptr_t>(ptr) % HUGE_PAGE_SIZE, 0) << ptr;
+    // The Linux Transparent Huge Pages implementation will try to back the memory with
+    // huge pages if it is enabled. MADV_HUGEPAGE was introduced in 2.6.38, so we similarly
+    // need to skip this code if we are compiling against an older kernel.
+#if defined(MADV_HUGEPAGE) && defined(MADV_NOHUGEPAGE)
+    int rc;
+    // According to madvise() docs it may return EAGAIN to signal that we should retry.
+    do {
+        rc = madvise(ptr, len, huge ? MADV_HUGEPAGE : MADV_NOHUGEPAGE);
+    } while (rc == -1 && errno == EAGAIN);
+    DCHECK(rc == 0) << "madvise() of huge pages shouldn't fail" << errno;
+    if (huge) {
+        DorisMetrics::instance()->huge_page_alloc_total->increment(1);
+    }
+#endif
+}
+
+} // namespace doris
@@ -0,0 +1,50 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <cstdint>
+
+namespace doris {
+
+// Backs large buffers with huge pages, which cuts the TLB misses of the random accesses
+// to hash tables and sort buffers. Used by the system allocators of the BufferPool and of
+// the ChunkAllocator, the allocations are counted by the huge_page_alloc_total,
+// hugetlb_alloc_total and hugetlb_alloc_fallback_total metrics.
+class HugePageUtil {
+public:
+    // The huge page size on x86-64. We could parse /proc/meminfo to programmatically
+    // get this, but it is unlikely to change unless we port to a different architecture.
+    static const int64_t HUGE_PAGE_SIZE = 2LL * 1024 * 1024;
+
+    // Returns true if a buffer of 'len' bytes is backed by huge pages, i.e.
+    // config::madvise_huge_pages is set and 'len' is a multiple of the huge page size.
+    static bool use_huge_pages(int64_t len);
+
+    // Maps 'len' bytes of memory backed by huge pages, 'len' must be a multiple of the
+    // huge page size. If config::use_hugetlb_pages is set, the pages come from the huge
+    // pages reserved by hugetlbfs. Otherwise, or if there aren't enough of them, the memory
+    // is aligned to the huge page size and advised to be backed by transparent huge pages.
+    // The memory is freed by munmap(). Returns nullptr if mmap() fails.
+    static uint8_t* map(int64_t len);
+
+    // Advises whether the memory of [ptr, ptr + len) is a candidate to be backed by
+    // transparent huge pages, 'ptr' must be aligned to the huge page size.
+    static void advise(uint8_t* ptr, int64_t len, bool huge);
+};
+
+} // namespace doris
@@ -0,0 +1,65 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "util/iobuf_util.h"
+
+#include "service/brpc.h"
+
+#include <mutex>
+#include <unordered_map>
+
+#include "common/logging.h"
+
+namespace doris {
+
+// The deleter of IOBuf user data only gets the data pointer, so the strings which
+// own the data are looked up by it.
+static std::mutex s_strings_lock;
+static std::unordered_map<const void*, std::string*> s_strings;
+
+static void delete_string(void* data) {
+    std::string* str = nullptr;
+    {
+        std::lock_guard<std::mutex> l(s_strings_lock);
+        auto it = s_strings.find(data);
+        DCHECK(it != s_strings.end());
+        str = it->second;
+        s_strings.erase(it);
+    }
+    delete str;
+}
+
+void move_string_to_iobuf(std::string* str, butil::IOBuf* buf) {
+    if (str->empty()) {
+        return;
+    }
+    std::string* holder = new std::string();
+    holder->swap(*str);
+    void* data = const_cast<char*>(holder->data());
+    {
+        std::lock_guard<std::mutex> l(s_strings_lock);
+        s_strings.emplace(data, holder);
+    }
+    if (buf->append_user_data(data, holder->size(), delete_string) != 0) {
+        // the deleter isn't called on failure
+        LOG(WARNING) << "failed to append user data to iobuf, size=" << holder->size();
+        buf->append(data, holder->size());
+        delete_string(data);
+    }
+}
+
+} // namespace doris
@@ -0,0 +1,159 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "common/logging.h"
+
+namespace doris {
+
+// Tournament tree of losers used to merge sorted runs, see Knuth TAOCP 5.4.1.
+//
+// Runs are identified by their index in [0, num_runs). Compare(lhs, rhs) returns true
+// if the current element of run lhs is less than the current element of run rhs. The
+// tree only keeps indices, advancing the runs is up to the caller:
+//
+//   LoserTree<Less> tree(less);
+//   tree.init(num_runs);
+//   while (tree.winner() >= 0) {
+//       output current element of run tree.winner() and advance the run
+//       tree.update_winner(run is exhausted);
+//   }
+//
+// Replacing the winner costs log2(num_runs) comparisons in the tree, about half of a
+// binary heap. Besides, if a run wins twice in a row, the runner-up is looked up and
+// the following elements of the run are only compared with it until the run loses,
+// so runs which hold ranges of the output cost one comparison per element.
+template <class Compare>
+class LoserTree {
+public:
+    explicit LoserTree(Compare compare) : _compare(compare) {}
+
+    // Sets up the tree for 'num_runs' runs which all have a current element.
+    void init(int num_runs) {
+        _num_runs = num_runs;
+        _exhausted.assign(num_runs, false);
+        _losers.assign(num_runs, -1);
+        _runner_up = -1;
+        if (num_runs == 0) {
+            return;
+        }
+        // winners of the nodes, leaves are at [num_runs, 2 * num_runs)
+        std::vector<int> winners(2 * num_runs);
+        for (int i = 0; i < num_runs; ++i) {
+            winners[num_runs + i] = i;
+        }
+        for (int node = num_runs - 1; node >= 1; --node) {
+            int lhs = winners[2 * node];
+            int rhs = winners[2 * node + 1];
+            if (_beats(rhs, lhs)) {
+                std::swap(lhs, rhs);
+            }
+            winners[node] = lhs;
+            _losers[node] = rhs;
+        }
+        _losers[0] = winners[1];
+    }
+
+    // Returns the run with the least current element, or -1 if all runs are exhausted.
+    int winner() const {
+        if (_num_runs == 0 || _exhausted[_losers[0]]) {
+            return -1;
+        }
+        return _losers[0];
+    }
+
+    // Must be called after the winner run advanced to its next element, or is exhausted.
+    void update_winner(bool exhausted) {
+        int winner = _losers[0];
+        DCHECK(!_exhausted[winner]);
+        if (exhausted) {
+            _exhausted[winner] = true;
+            _runner_up = -1;
+            _replay(winner);
+            return;
+        }
+        if (_runner_up >= 0) {
+            // The runner-up is less than or equal to all losers on the path of the
+            // winner, so the tree is still valid if the winner doesn't lose to it.
+            if (!_beats(_runner_up, winner)) {
+                return;
+            }
+            _runner_up = -1;
+            _replay(winner);
+            return;
+        }
+        _replay(winner);
+        if (_losers[0] == winner) {
+            _find_runner_up();
+        }
+    }
+
+private:
+    // true if the current element of run lhs goes before the one of run rhs
+    bool _beats(int lhs, int rhs) {
+        if (_exhausted[lhs]) {
+            return false;
+        }
+        if (_exhausted[rhs]) {
+            return true;
+        }
+        return _compare(lhs, rhs);
+    }
+
+    // Plays the matches from the leaf of 'run' to the root.
+    void _replay(int run) {
+        int winner = run;
+        for (int node = (_num_runs + run) / 2; node >= 1; node /= 2) {
+            if (_beats(_losers[node], winner)) {
+                std::swap(_losers[node], winner);
+            }
+        }
+        _losers[0] = winner;
+    }
+
+    // The runner-up only lost to the winner, so it's the least loser on the path of the
+    // winner.
+    void _find_runner_up() {
+        int run = _losers[0];
+        _runner_up = -1;
+        for (int node = (_num_runs + run) / 2; node >= 1; node /= 2) {
+            int loser = _losers[node];
+            if (_exhausted[loser]) {
+                continue;
+            }
+            if (_runner_up < 0 || _beats(loser, _runner_up)) {
+                _runner_up = loser;
+            }
+        }
+    }
+
+    Compare _compare;
+    int _num_runs = 0;
+    std::vector<bool> _exhausted;
+    // _losers[0] is the winner, _losers[node] is the loser of the match at node, the
+    // children of node are 2 * node and 2 * node + 1
+    std::vector<int> _losers;
+    // the least run except the winner, -1 if unknown
+    int _runner_up = -1;
+};
+
+} // namespace doris
@@ -19,6 +19,13 @@
 
 #include <rapidjson/stringbuffer.h>
 #include <rapidjson/writer.h>
+#include <sched.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <thread>
 
 namespace doris {
 
@@ -102,6 +109,165 @@ std::string labels_to_string(const Labels& entity_labels, const Labels& metric_l
     return ss.str();
 }
 
+HistogramMetric::HistogramMetric() {
+    // as many as CoreLocalValue has
+    size_t num_cores = 8;
+    while (num_cores < std::thread::hardware_concurrency()) {
+        num_cores <<= 1;
+    }
+    for (size_t i = 0; i < num_cores; ++i) {
+        std::unique_ptr<CoreBuckets> core(new CoreBuckets());
+        for (int j = 0; j < NUM_BUCKETS; ++j) {
+            core->counts[j].store(0, std::memory_order_relaxed);
+        }
+        core->sum.store(0, std::memory_order_relaxed);
+        _cores.push_back(std::move(core));
+    }
+}
+
+int HistogramMetric::bucket_index(int64_t value) {
+    if (value <= 4) {
+        return value < 0 ? 0 : value;
+    }
+    // bucket k covers the values in (2^k, 2^(k+1)]
+    uint64_t v = value - 1;
+    int k = 63 - __builtin_clzll(v);
+    if (k >= 40) {
+        return NUM_BUCKETS - 1;
+    }
+    return 5 + (k - 2) * 4 + ((v >> (k - 2)) & 3);
+}
+
+int64_t HistogramMetric::bucket_upper_bound(int index) {
+    if (index <= 4) {
+        return index;
+    }
+    int k = (index - 5) / 4 + 2;
+    return (int64_t)(5 + (index - 5) % 4) << (k - 2);
+}
+
+void HistogramMetric::add(int64_t value) {
+    size_t cpu_id = sched_getcpu();
+    CoreBuckets* core = _cores[cpu_id & (_cores.size() - 1)].get();
+    core->counts[bucket_index(value)].fetch_add(1, std::memory_order_relaxed);
+    core->sum.fetch_add(value, std::memory_order_relaxed);
+}
+
+int64_t HistogramMetric::_merge(int64_t* counts) const {
+    int64_t sum = 0;
+    memset(counts, 0, sizeof(int64_t) * NUM_BUCKETS);
+    for (const auto& core : _cores) {
+        for (int i = 0; i < NUM_BUCKETS; ++i) {
+            counts[i] += core->counts[i].load(std::memory_order_relaxed);
+        }
+        sum += core->sum.load(std::memory_order_relaxed);
+    }
+    return sum;
+}
+
+int64_t HistogramMetric::count() const {
+    int64_t counts[NUM_BUCKETS];
+    _merge(counts);
+    return std::accumulate(counts, counts + NUM_BUCKETS, (int64_t)0);
+}
+
+int64_t HistogramMetric::sum() const {
+    int64_t sum = 0;
+    for (const auto& core : _cores) {
+        sum += core->sum.load(std::memory_order_relaxed);
+    }
+    return sum;
+}
+
+int64_t HistogramMetric::percentile(double percentile) const {
+    int64_t counts[NUM_BUCKETS];
+    _merge(counts);
+    int64_t count = std::accumulate(counts, counts + NUM_BUCKETS, (int64_t)0);
+    return _percentile(counts, count, percentile);
+}
+
+int64_t HistogramMetric::percentile_of_counts(const int64_t* counts, double percentile) {
+    int64_t count = std::accumulate(counts, counts + NUM_BUCKETS, (int64_t)0);
+    return _percentile(counts, count, percentile);
+}
+
+int64_t HistogramMetric::_percentile(const int64_t* counts, int64_t count, double percentile) {
+    if (count == 0) {
+        return 0;
+    }
+    int64_t rank = std::ceil(percentile / 100 * count);
+    rank = std::max<int64_t>(1, std::min(rank, count));
+    int64_t seen = 0;
+    for (int i = 0; i < NUM_BUCKETS; ++i) {
+        if (seen + counts[i] < rank) {
+            seen += counts[i];
+            continue;
+        }
+        int64_t upper = bucket_upper_bound(i);
+        if (i <= 4) {
+            return upper;
+        }
+        // the values of the bucket are in (lower, upper]
+        int64_t lower = bucket_upper_bound(i - 1);
+        return lower + (int64_t)((double)(upper - lower) * (rank - seen) / counts[i]);
+    }
+    return bucket_upper_bound(NUM_BUCKETS - 1);
+}
+
+std::string HistogramMetric::to_string() const {
+    int64_t counts[NUM_BUCKETS];
+    int64_t sum = _merge(counts);
+    int64_t count = std::accumulate(counts, counts + NUM_BUCKETS, (int64_t)0);
+    std::stringstream ss;
+    ss << "count=" << count << " sum=" << sum << " p50=" << _percentile(counts, count, 50)
+       << " p90=" << _percentile(counts, count, 90) << " p99=" << _percentile(counts, count, 99)
+       << " p999=" << _percentile(counts, count, 99.9);
+    return ss.str();
+}
+
+rj::Value HistogramMetric::to_json_value(rj::Document::AllocatorType& allocator) const {
+    int64_t counts[NUM_BUCKETS];
+    int64_t sum = _merge(counts);
+    int64_t count = std::accumulate(counts, counts + NUM_BUCKETS, (int64_t)0);
+    rj::Value value(rj::kObjectType);
+    value.AddMember("count", rj::Value(count), allocator);
+    value.AddMember("sum", rj::Value(sum), allocator);
+    value.AddMember("p50", rj::Value(_percentile(counts, count, 50)), allocator);
+    value.AddMember("p90", rj::Value(_percentile(counts, count, 90)), allocator);
+    value.AddMember("p99", rj::Value(_percentile(counts, count, 99)), allocator);
+    value.AddMember("p999", rj::Value(_percentile(counts, count, 99.9)), allocator);
+    return value;
+}
+
+void HistogramMetric::to_prometheus(const std::string& name, const std::string& labels,
+                                    std::stringstream* ss) const {
+    int64_t counts[NUM_BUCKETS];
+    int64_t sum = _merge(counts);
+    int last = NUM_BUCKETS - 1;
+    while (last > 0 && counts[last] == 0) {
+        --last;
+    }
+    // the labels with 'le' added
+    std::string prefix = labels.empty() ? "{" : labels.substr(0, labels.size() - 1) + ",";
+    int64_t cumulative = 0;
+    int i = 0;
+    for (int64_t bound = 1;; bound <<= 1) {
+        for (; i < NUM_BUCKETS && bucket_upper_bound(i) <= bound; ++i) {
+            cumulative += counts[i];
+        }
+        (*ss) << name << "_bucket" << prefix << "le=\"" << bound << "\"} " << cumulative << "\n";
+        if (i > last) {
+            break;
+        }
+    }
+    for (; i < NUM_BUCKETS; ++i) {
+        cumulative += counts[i];
+    }
+    (*ss) << name << "_bucket" << prefix << "le=\"+Inf\"} " << cumulative << "\n";
+    (*ss) << name << "_sum" << labels << " " << sum << "\n";
+    (*ss) << name << "_count" << labels << " " << cumulative << "\n";
+}
+
 std::string MetricPrototype::simple_name() const {
     return group_name.empty() ? name : group_name;
 }
@@ -192,11 +358,24 @@ std::shared_ptr<MetricEntity> MetricRegistry::get_entity(const std::string& name
     return entity->first;
 }
 
-void MetricRegistry::trigger_all_hooks(bool force) const {
+std::vector<std::shared_ptr<MetricEntity>> MetricRegistry::_entities_snapshot(
+        bool with_tablet_metrics) const {
+    std::vector<std::shared_ptr<MetricEntity>> entities;
     std::lock_guard<SpinLock> l(_lock);
+    entities.reserve(_entities.size());
     for (const auto& entity : _entities) {
-        std::lock_guard<SpinLock> l(entity.first->_lock);
-        entity.first->trigger_hook_unlocked(force);
+        if (entity.first->_type == MetricEntityType::kTablet && !with_tablet_metrics) {
+            continue;
+        }
+        entities.push_back(entity.first);
+    }
+    return entities;
+}
+
+void MetricRegistry::trigger_all_hooks(bool force) const {
+    for (const auto& entity : _entities_snapshot(true)) {
+        std::lock_guard<SpinLock> l(entity->_lock);
+        entity->trigger_hook_unlocked(force);
     }
 }
 
@@ -204,16 +383,15 @@ std::string MetricRegistry::to_prometheus(bool with_tablet_metrics) const {
     std::stringstream ss;
     // Reorder by MetricPrototype
     EntityMetricsByType entity_metrics_by_types;
-    std::lock_guard<SpinLock> l(_lock);
-    for (const auto& entity : _entities) {
-        if (entity.first->_type == MetricEntityType::kTablet && !with_tablet_metrics) {
-            continue;
-        }
-        std::lock_guard<SpinLock> l(entity.first->_lock);
-        entity.first->trigger_hook_unlocked(false);
-        for (const auto& metric : entity.first->_metrics) {
+    // The entities are kept alive by the snapshot, so the registry is not locked while
+    // rendering and entities can be registered meanwhile.
+    auto entities = _entities_snapshot(with_tablet_metrics);
+    for (const auto& entity : entities) {
+        std::lock_guard<SpinLock> l(entity->_lock);
+        entity->trigger_hook_unlocked(false);
+        for (const auto& metric : entity->_metrics) {
             std::pair<MetricEntity*, Metric*> new_elem =
-                    std::make_pair(entity.first.get(), metric.second);
+                    std::make_pair(entity.get(), metric.second);
             auto found = entity_metrics_by_types.find(metric.first);
             if (found == entity_metrics_by_types.end()) {
                 entity_metrics_by_types.emplace(
@@ -234,6 +412,14 @@ std::string MetricRegistry::to_prometheus(bool with_tablet_metrics) const {
         last_group_name = entity_metrics_by_type.first->group_name;
         std::string display_name = entity_metrics_by_type.first->combine_name(_name);
         for (const auto& entity_metric : entity_metrics_by_type.second) {
+            if (entity_metrics_by_type.first->type == MetricType::HISTOGRAM) {
+                static_cast<HistogramMetric*>(entity_metric.second)
+                        ->to_prometheus(display_name,
+                                        labels_to_string(entity_metric.first->_labels,
+                                                         entity_metrics_by_type.first->labels),
+                                        &ss);
+                continue;
+            }
             ss << display_name // metric name
                << labels_to_string(entity_metric.first->_labels,
                                    entity_metrics_by_type.first->labels) // metric labels
@@ -247,14 +433,10 @@ std::string MetricRegistry::to_prometheus(bool with_tablet_metrics) const {
 std::string MetricRegistry::to_json(bool with_tablet_metrics) const {
     rj::Document doc{rj::kArrayType};
     rj::Document::AllocatorType& allocator = doc.GetAllocator();
-    std::lock_guard<SpinLock> l(_lock);
-    for (const auto& entity : _entities) {
-        if (entity.first->_type == MetricEntityType::kTablet && !with_tablet_metrics) {
-            continue;
-        }
-        std::lock_guard<SpinLock> l(entity.first->_lock);
-        entity.first->trigger_hook_unlocked(false);
-        for (const auto& metric : entity.first->_metrics) {
+    for (const auto& entity : _entities_snapshot(with_tablet_metrics)) {
+        std::lock_guard<SpinLock> l(entity->_lock);
+        entity->trigger_hook_unlocked(false);
+        for (const auto& metric : entity->_metrics) {
             rj::Value metric_obj(rj::kObjectType);
             // tags
             rj::Value tag_obj(rj::kObjectType);
@@ -266,7 +448,7 @@ std::string MetricRegistry::to_json(bool with_tablet_metrics) const {
                                   rj::Value(label.second.c_str(), allocator), allocator);
             }
             // MetricEntity's labels
-            for (auto& label : entity.first->_labels) {
+            for (auto& label : entity->_labels) {
                 tag_obj.AddMember(rj::Value(label.first.c_str(), allocator),
                                   rj::Value(label.second.c_str(), allocator), allocator);
             }
@@ -275,7 +457,14 @@ std::string MetricRegistry::to_json(bool with_tablet_metrics) const {
             rj::Value unit_val(unit_name(metric.first->unit), allocator);
             metric_obj.AddMember("unit", unit_val, allocator);
             // value
-            metric_obj.AddMember("value", metric.second->to_json_value(), allocator);
+            if (metric.first->type == MetricType::HISTOGRAM) {
+                metric_obj.AddMember(
+                        "value",
+                        static_cast<HistogramMetric*>(metric.second)->to_json_value(allocator),
+                        allocator);
+            } else {
+                metric_obj.AddMember("value", metric.second->to_json_value(), allocator);
+            }
             doc.PushBack(metric_obj, allocator);
         }
     }
@@ -288,11 +477,10 @@ std::string MetricRegistry::to_json(bool with_tablet_metrics) const {
 
 std::string MetricRegistry::to_core_string() const {
     std::stringstream ss;
-    std::lock_guard<SpinLock> l(_lock);
-    for (const auto& entity : _entities) {
-        std::lock_guard<SpinLock> l(entity.first->_lock);
-        entity.first->trigger_hook_unlocked(false);
-        for (const auto& metric : entity.first->_metrics) {
+    for (const auto& entity : _entities_snapshot(true)) {
+        std::lock_guard<SpinLock> l(entity->_lock);
+        entity->trigger_hook_unlocked(false);
+        for (const auto& metric : entity->_metrics) {
             if (metric.first->is_core_metric) {
                 ss << metric.first->combine_name(_name) << " LONG " << metric.second->to_string()
                    << "\n";
@@ -29,10 +29,12 @@
 #include <sstream>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "common/config.h"
 #include "util/core_local.h"
 #include "util/spinlock.h"
+#include "util/stopwatch.hpp"
 
 namespace doris {
 
@@ -188,6 +190,76 @@ public:
     virtual ~LockGauge() {}
 };
 
+// Histogram of non-negative values, e.g. latencies in microseconds, for their percentiles.
+// The values are counted in log-linear buckets: one for each value up to 4, then 4 of equal
+// width for each power of 2, so a percentile is off by at most a quarter of its value.
+// Like CoreLocalCounter, each core has its own buckets, which are added up when read.
+class HistogramMetric : public Metric {
+public:
+    HistogramMetric();
+    virtual ~HistogramMetric() {}
+
+    void add(int64_t value);
+
+    int64_t count() const;
+    int64_t sum() const;
+    // Returns the value that 'percentile' (0 to 100) percent of the values are not greater
+    // than, interpolated in its bucket. 0 if there is no value.
+    int64_t percentile(double percentile) const;
+
+    // e.g. "count=10 sum=1234 p50=100 p90=200 p99=300 p999=300"
+    std::string to_string() const override;
+    // the count, see the other one for the percentiles
+    rj::Value to_json_value() const override { return rj::Value(count()); }
+    rj::Value to_json_value(rj::Document::AllocatorType& allocator) const;
+    // Appends the histogram in the text format of Prometheus, with a bucket for each power
+    // of 2 up to the largest value. 'labels' is like "{k=\"v\"}" or empty.
+    void to_prometheus(const std::string& name, const std::string& labels,
+                       std::stringstream* ss) const;
+
+    static const int NUM_BUCKETS = 157;
+    // The bucket of 'value', the values greater than 2^40 are in the last one.
+    static int bucket_index(int64_t value);
+    // The largest value in a bucket
+    static int64_t bucket_upper_bound(int index);
+
+    // Copies the counts of the buckets, added up over the cores, to 'counts' of NUM_BUCKETS,
+    // e.g. to compute the percentiles of the values added after an earlier copy.
+    void get_counts(int64_t* counts) const { _merge(counts); }
+    // The percentile of the values counted in 'counts' of NUM_BUCKETS, see percentile()
+    static int64_t percentile_of_counts(const int64_t* counts, double percentile);
+
+private:
+    struct CoreBuckets {
+        std::atomic<int64_t> counts[NUM_BUCKETS];
+        std::atomic<int64_t> sum;
+    };
+
+    // Adds up the buckets of all cores to 'counts', and returns the sum of the values.
+    int64_t _merge(int64_t* counts) const;
+    static int64_t _percentile(const int64_t* counts, int64_t count, double percentile);
+
+    std::vector<std::unique_ptr<CoreBuckets>> _cores;
+};
+
+// Adds the microseconds from its construction to its destruction to a histogram, if it's
+// not null.
+class ScopedLatencyRecorder {
+public:
+    explicit ScopedLatencyRecorder(HistogramMetric* histogram) : _histogram(histogram) {
+        _watch.start();
+    }
+    ~ScopedLatencyRecorder() {
+        if (_histogram != nullptr) {
+            _histogram->add(_watch.elapsed_time() / 1000);
+        }
+    }
+
+private:
+    HistogramMetric* _histogram;
+    MonotonicStopWatch _watch;
+};
+
 using IntCounter = CoreLocalCounter<int64_t>;
 using IntAtomicCounter = AtomicCounter<int64_t>;
 using UIntCounter = CoreLocalCounter<uint64_t>;
@@ -243,6 +315,12 @@ public:
 #define DEFINE_GAUGE_METRIC_PROTOTYPE_3ARG(name, unit, desc) \
     DEFINE_METRIC_PROTOTYPE(name, MetricType::GAUGE, unit, desc, "", Labels(), false)
 
+#define DEFINE_HISTOGRAM_METRIC_PROTOTYPE_2ARG(name, unit) \
+    DEFINE_METRIC_PROTOTYPE(name, MetricType::HISTOGRAM, unit, "", "", Labels(), false)
+
+#define DEFINE_HISTOGRAM_METRIC_PROTOTYPE_5ARG(name, unit, desc, group, labels) \
+    DEFINE_METRIC_PROTOTYPE(name, MetricType::HISTOGRAM, unit, desc, #group, labels, false)
+
 #define INT_COUNTER_METRIC_REGISTER(entity, metric) \
     metric = (IntCounter*)(entity->register_metric<IntCounter>(&METRIC_##metric))
 
@@ -258,6 +336,9 @@ public:
 #define INT_ATOMIC_COUNTER_METRIC_REGISTER(entity, metric) \
     metric = (IntAtomicCounter*)(entity->register_metric<IntAtomicCounter>(&METRIC_##metric))
 
+#define HISTOGRAM_METRIC_REGISTER(entity, metric) \
+    metric = (HistogramMetric*)(entity->register_metric<HistogramMetric>(&METRIC_##metric))
+
 #define METRIC_DEREGISTER(entity, metric) entity->deregister_metric(&METRIC_##metric)
 
 // For 'metrics' in MetricEntity.
@@ -362,6 +443,9 @@ public:
     std::string to_core_string() const;
 
 private:
+    // Copy the registered entities, so they can be walked without holding '_lock'
+    std::vector<std::shared_ptr<MetricEntity>> _entities_snapshot(bool with_tablet_metrics) const;
+
     const std::string _name;
 
     mutable SpinLock _lock;
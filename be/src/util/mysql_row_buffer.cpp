@@ -106,12 +106,7 @@ int MysqlRowBuffer::push_tinyint(int8_t data) {
         return ret;
     }
 
-    int length = snprintf(_pos + 1, MAX_TINYINT_WIDTH + 2, "%d", data);
-
-    if (length < 0) {
-        LOG(ERROR) << "snprintf failed. data = " << data;
-        return length;
-    }
+    int length = FastInt32ToBufferLeft(data, _pos + 1) - (_pos + 1);
 
     int1store(_pos, length);
     _pos += length + 1;
@@ -127,12 +122,7 @@ int MysqlRowBuffer::push_smallint(int16_t data) {
         return ret;
     }
 
-    int length = snprintf(_pos + 1, MAX_SMALLINT_WIDTH + 2, "%d", data);
-
-    if (length < 0) {
-        LOG(ERROR) << "snprintf failed. data = " << data;
-        return length;
-    }
+    int length = FastInt32ToBufferLeft(data, _pos + 1) - (_pos + 1);
 
     int1store(_pos, length);
     _pos += length + 1;
@@ -148,12 +138,7 @@ int MysqlRowBuffer::push_int(int32_t data) {
         return ret;
     }
 
-    int length = snprintf(_pos + 1, MAX_INT_WIDTH + 2, "%d", data);
-
-    if (length < 0) {
-        LOG(ERROR) << "snprintf failed. data = " << data;
-        return length;
-    }
+    int length = FastInt32ToBufferLeft(data, _pos + 1) - (_pos + 1);
 
     int1store(_pos, length);
     _pos += length + 1;
@@ -169,12 +154,7 @@ int MysqlRowBuffer::push_bigint(int64_t data) {
         return ret;
     }
 
-    int length = snprintf(_pos + 1, MAX_BIGINT_WIDTH + 2, "%ld", data);
-
-    if (length < 0) {
-        LOG(ERROR) << "snprintf failed. data = " << data;
-        return length;
-    }
+    int length = FastInt64ToBufferLeft(data, _pos + 1) - (_pos + 1);
 
     int1store(_pos, length);
     _pos += length + 1;
@@ -190,12 +170,7 @@ int MysqlRowBuffer::push_unsigned_bigint(uint64_t data) {
         return ret;
     }
 
-    int length = snprintf(_pos + 1, MAX_BIGINT_WIDTH + 3, "%ld", data);
-
-    if (length < 0) {
-        LOG(ERROR) << "snprintf failed. data = " << data;
-        return length;
-    }
+    int length = FastUInt64ToBufferLeft(data, _pos + 1) - (_pos + 1);
 
     int1store(_pos, length);
     _pos += length + 1;
@@ -179,4 +179,23 @@ Status PprofUtils::generate_flamegraph(int32_t sample_seconds,
     return Status::OK();
 }
 
+Status PprofUtils::generate_flamegraph_from_folded(const std::string& folded_file,
+                                                   const std::string& flame_graph_tool_dir,
+                                                   std::string* svg_content) {
+    std::string flamegraph_pl = flame_graph_tool_dir + "/flamegraph.pl";
+    if (!FileUtils::check_exist(flamegraph_pl)) {
+        return Status::InternalError("Missing flamegraph.pl in FlameGraph");
+    }
+    std::stringstream gen_cmd;
+    gen_cmd << flamegraph_pl << " " << folded_file;
+    AgentUtils util;
+    std::string res_content;
+    bool rc = util.exec_cmd(gen_cmd.str(), &res_content, false);
+    if (!rc) {
+        return Status::InternalError("Failed to execute flamegraph command: " + res_content);
+    }
+    *svg_content = res_content;
+    return Status::OK();
+}
+
 } // namespace doris
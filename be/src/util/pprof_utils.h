@@ -48,6 +48,12 @@ public:
     static Status generate_flamegraph(int32_t sample_seconds,
                                       const std::string& flame_graph_tool_dir, bool return_file,
                                       std::string* svg_file_or_content);
+
+    /// Generates the svg of the flamegraph of the stacks in "folded_file", one
+    /// "frame;frame;... count" per line, to "svg_content".
+    static Status generate_flamegraph_from_folded(const std::string& folded_file,
+                                                  const std::string& flame_graph_tool_dir,
+                                                  std::string* svg_content);
 };
 
 } // namespace doris
@@ -23,6 +23,8 @@
 #include <string.h>
 #include <x86intrin.h>
 
+#include "util/cpu_dispatch.h"
+
 /*
  * These functions are used for validating utf8 string.
  * Details can be seen here: https://github.com/lemire/fastvalidate-utf-8
@@ -190,25 +192,47 @@ static bool validate_utf8_fast(const char* src, size_t len) {
     return _mm_testz_si128(has_error, has_error);
 }
 
-#ifdef __AVX2__
+// all bytes must be ascii, i.e. have the high bit cleared
+static inline bool validate_ascii_fast(const char* src, size_t len) {
+    size_t i = 0;
+    __m128i high_bits = _mm_setzero_si128();
+    if (len >= 16) {
+        for (; i <= len - 16; i += 16) {
+            high_bits = _mm_or_si128(high_bits, _mm_loadu_si128((const __m128i*)(src + i)));
+        }
+    }
+
+    // last part
+    uint8_t tail = 0;
+    for (; i < len; ++i) {
+        tail |= (uint8_t)src[i];
+    }
+    return _mm_movemask_epi8(high_bits) == 0 && tail < 0x80;
+}
+
+#ifdef DORIS_TARGET_AVX2
+
+// Compiled for AVX2 whatever the build targets, validate_utf8() calls them on the CPUs
+// with AVX2
 
 /*****************************/
-static inline __m256i push_last_byte_of_a_to_b(__m256i a, __m256i b) {
+DORIS_TARGET_AVX2 static inline __m256i push_last_byte_of_a_to_b(__m256i a, __m256i b) {
     return _mm256_alignr_epi8(b, _mm256_permute2x128_si256(a, b, 0x21), 15);
 }
 
-static inline __m256i push_last_2bytes_of_a_to_b(__m256i a, __m256i b) {
+DORIS_TARGET_AVX2 static inline __m256i push_last_2bytes_of_a_to_b(__m256i a, __m256i b) {
     return _mm256_alignr_epi8(b, _mm256_permute2x128_si256(a, b, 0x21), 14);
 }
 
 // all byte values must be no larger than 0xF4
-static inline void avxcheckSmallerThan0xF4(__m256i current_bytes, __m256i* has_error) {
+DORIS_TARGET_AVX2 static inline void avxcheckSmallerThan0xF4(__m256i current_bytes,
+                                                             __m256i* has_error) {
     // unsigned, saturates to 0 below max
     *has_error =
             _mm256_or_si256(*has_error, _mm256_subs_epu8(current_bytes, _mm256_set1_epi8(0xF4)));
 }
 
-static inline __m256i avxcontinuationLengths(__m256i high_nibbles) {
+DORIS_TARGET_AVX2 static inline __m256i avxcontinuationLengths(__m256i high_nibbles) {
     return _mm256_shuffle_epi8(_mm256_setr_epi8(1, 1, 1, 1, 1, 1, 1, 1, // 0xxx (ASCII)
                                                 0, 0, 0, 0,             // 10xx (continuation)
                                                 2, 2,                   // 110x
@@ -223,7 +247,8 @@ static inline __m256i avxcontinuationLengths(__m256i high_nibbles) {
                                high_nibbles);
 }
 
-static inline __m256i avxcarryContinuations(__m256i initial_lengths, __m256i previous_carries) {
+DORIS_TARGET_AVX2 static inline __m256i avxcarryContinuations(__m256i initial_lengths,
+                                                              __m256i previous_carries) {
     __m256i right1 = _mm256_subs_epu8(push_last_byte_of_a_to_b(previous_carries, initial_lengths),
                                       _mm256_set1_epi8(1));
     __m256i sum = _mm256_add_epi8(initial_lengths, right1);
@@ -233,8 +258,8 @@ static inline __m256i avxcarryContinuations(__m256i initial_lengths, __m256i pre
     return _mm256_add_epi8(sum, right2);
 }
 
-static inline void avxcheckContinuations(__m256i initial_lengths, __m256i carries,
-                                         __m256i* has_error) {
+DORIS_TARGET_AVX2 static inline void avxcheckContinuations(__m256i initial_lengths, __m256i carries,
+                                                           __m256i* has_error) {
     // overlap || underlap
     // carry > length && length > 0 || !(carry > length) && !(length > 0)
     // (carries > length) == (lengths > 0)
@@ -248,8 +273,9 @@ static inline void avxcheckContinuations(__m256i initial_lengths, __m256i carrie
 // when 0xED is found, next byte must be no larger than 0x9F
 // when 0xF4 is found, next byte must be no larger than 0x8F
 // next byte must be continuation, ie sign bit is set, so signed < is ok
-static inline void avxcheckFirstContinuationMax(__m256i current_bytes, __m256i off1_current_bytes,
-                                                __m256i* has_error) {
+DORIS_TARGET_AVX2 static inline void avxcheckFirstContinuationMax(__m256i current_bytes,
+                                                                  __m256i off1_current_bytes,
+                                                                  __m256i* has_error) {
     __m256i maskED = _mm256_cmpeq_epi8(off1_current_bytes, _mm256_set1_epi8(0xED));
     __m256i maskF4 = _mm256_cmpeq_epi8(off1_current_bytes, _mm256_set1_epi8(0xF4));
 
@@ -267,8 +293,9 @@ static inline void avxcheckFirstContinuationMax(__m256i current_bytes, __m256i o
 // E       => < E1 && < A0
 // F       => < F1 && < 90
 // else      false && false
-static inline void avxcheckOverlong(__m256i current_bytes, __m256i off1_current_bytes,
-                                    __m256i hibits, __m256i previous_hibits, __m256i* has_error) {
+DORIS_TARGET_AVX2 static inline void avxcheckOverlong(__m256i current_bytes,
+                                                      __m256i off1_current_bytes, __m256i hibits,
+                                                      __m256i previous_hibits, __m256i* has_error) {
     __m256i off1_hibits = push_last_byte_of_a_to_b(previous_hibits, hibits);
     __m256i initial_mins =
             _mm256_shuffle_epi8(_mm256_setr_epi8(-128, -128, -128, -128, -128, -128, -128, -128,
@@ -305,16 +332,16 @@ struct avx_processed_utf_bytes {
     __m256i carried_continuations;
 };
 
-static inline void avx_count_nibbles(__m256i bytes, struct avx_processed_utf_bytes* answer) {
+DORIS_TARGET_AVX2 static inline void avx_count_nibbles(__m256i bytes,
+                                                       struct avx_processed_utf_bytes* answer) {
     answer->rawbytes = bytes;
     answer->high_nibbles = _mm256_and_si256(_mm256_srli_epi16(bytes, 4), _mm256_set1_epi8(0x0F));
 }
 
 // check whether the current bytes are valid UTF-8
 // at the end of the function, previous gets updated
-static struct avx_processed_utf_bytes avxcheckUTF8Bytes(__m256i current_bytes,
-                                                        struct avx_processed_utf_bytes* previous,
-                                                        __m256i* has_error) {
+DORIS_TARGET_AVX2 static struct avx_processed_utf_bytes avxcheckUTF8Bytes(
+        __m256i current_bytes, struct avx_processed_utf_bytes* previous, __m256i* has_error) {
     struct avx_processed_utf_bytes pb;
     avx_count_nibbles(current_bytes, &pb);
 
@@ -337,7 +364,7 @@ static struct avx_processed_utf_bytes avxcheckUTF8Bytes(__m256i current_bytes,
 
 // check whether the current bytes are valid UTF-8
 // at the end of the function, previous gets updated
-static struct avx_processed_utf_bytes avxcheckUTF8Bytes_asciipath(
+DORIS_TARGET_AVX2 static struct avx_processed_utf_bytes avxcheckUTF8Bytes_asciipath(
         __m256i current_bytes, struct avx_processed_utf_bytes* previous, __m256i* has_error) {
     if (_mm256_testz_si256(current_bytes,
                            _mm256_set1_epi8(0x80))) { // fast ascii path
@@ -369,7 +396,7 @@ static struct avx_processed_utf_bytes avxcheckUTF8Bytes_asciipath(
     return pb;
 }
 
-static bool validate_utf8_fast_avx_asciipath(const char* src, size_t len) {
+DORIS_TARGET_AVX2 static bool validate_utf8_fast_avx_asciipath(const char* src, size_t len) {
     size_t i = 0;
     __m256i has_error = _mm256_setzero_si256();
     struct avx_processed_utf_bytes previous = {.rawbytes = _mm256_setzero_si256(),
@@ -400,7 +427,7 @@ static bool validate_utf8_fast_avx_asciipath(const char* src, size_t len) {
     return _mm256_testz_si256(has_error, has_error);
 }
 
-static bool validate_utf8_fast_avx(const char* src, size_t len) {
+DORIS_TARGET_AVX2 static bool validate_utf8_fast_avx(const char* src, size_t len) {
     size_t i = 0;
     __m256i has_error = _mm256_setzero_si256();
     struct avx_processed_utf_bytes previous = {.rawbytes = _mm256_setzero_si256(),
@@ -431,5 +458,5 @@ static bool validate_utf8_fast_avx(const char* src, size_t len) {
     return _mm256_testz_si256(has_error, has_error);
 }
 
-#endif // __AVX2__
+#endif // DORIS_TARGET_AVX2
 #endif
@@ -23,22 +23,26 @@
 
 namespace doris {
 
-// Stop watch for reporting elapsed time in nanosec based on CLOCK_MONOTONIC.
-// It is as fast as Rdtsc.
+// Stop watch for reporting elapsed time in nanosec based on the clock 'Clock'.
+// With CLOCK_MONOTONIC it is as fast as Rdtsc.
 // It is also accurate because it not affected by cpu frequency changes and
 // it is not affected by user setting the system clock.
 // CLOCK_MONOTONIC represents monotonic time since some unspecified starting point.
 // It is good for computing elapsed time.
-class MonotonicStopWatch {
+// CLOCK_THREAD_CPUTIME_ID represents the cpu time consumed by the calling thread, it
+// doesn't advance while the thread waits, so a watch on it must start and stop on the
+// same thread.
+template <clockid_t Clock>
+class CustomStopWatch {
 public:
-    MonotonicStopWatch() {
+    CustomStopWatch() {
         _total_time = 0;
         _running = false;
     }
 
     void start() {
         if (!_running) {
-            clock_gettime(CLOCK_MONOTONIC, &_start);
+            clock_gettime(Clock, &_start);
             _running = true;
         }
     }
@@ -55,7 +59,7 @@ public:
         uint64_t ret = elapsed_time();
 
         if (_running) {
-            clock_gettime(CLOCK_MONOTONIC, &_start);
+            clock_gettime(Clock, &_start);
         }
 
         return ret;
@@ -68,7 +72,7 @@ public:
         }
 
         timespec end;
-        clock_gettime(CLOCK_MONOTONIC, &end);
+        clock_gettime(Clock, &end);
         return (end.tv_sec - _start.tv_sec) * 1000L * 1000L * 1000L +
                (end.tv_nsec - _start.tv_nsec);
     }
@@ -79,6 +83,9 @@ private:
     bool _running;
 };
 
+using MonotonicStopWatch = CustomStopWatch<CLOCK_MONOTONIC>;
+using ThreadCpuStopWatch = CustomStopWatch<CLOCK_THREAD_CPUTIME_ID>;
+
 }
 
 #endif
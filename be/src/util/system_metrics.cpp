@@ -628,6 +628,21 @@ void SystemMetrics::get_disks_io_time(std::map<std::string, int64_t>* map) {
     }
 }
 
+void SystemMetrics::get_disks_io_stat(std::map<std::string, DiskIOStat>* map) {
+    map->clear();
+    for (auto& it : _disk_metrics) {
+        DiskIOStat stat;
+        stat.bytes_read = it.second->disk_bytes_read->value();
+        stat.bytes_written = it.second->disk_bytes_written->value();
+        stat.ios_completed = it.second->disk_reads_completed->value() +
+                             it.second->disk_writes_completed->value();
+        stat.rw_time_ms = it.second->disk_read_time_ms->value() +
+                          it.second->disk_write_time_ms->value();
+        stat.io_time_ms = it.second->disk_io_time_ms->value();
+        map->emplace(it.first, stat);
+    }
+}
+
 void SystemMetrics::get_network_traffic(std::map<std::string, int64_t>* send_map,
                                         std::map<std::string, int64_t>* rcv_map) {
     send_map->clear();
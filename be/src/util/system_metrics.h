@@ -32,6 +32,18 @@ class SnmpMetrics;
 
 class SystemMetrics {
 public:
+    // accumulated I/O counters of a disk device
+    struct DiskIOStat {
+        int64_t bytes_read = 0;
+        int64_t bytes_written = 0;
+        // reads and writes completed
+        int64_t ios_completed = 0;
+        // time spent reading and writing
+        int64_t rw_time_ms = 0;
+        // time the device has I/O in progress
+        int64_t io_time_ms = 0;
+    };
+
     SystemMetrics(MetricRegistry* registry, const std::set<std::string>& disk_devices,
                   const std::vector<std::string>& network_interfaces);
     ~SystemMetrics();
@@ -40,6 +52,7 @@ public:
     void update();
 
     void get_disks_io_time(std::map<std::string, int64_t>* map);
+    void get_disks_io_stat(std::map<std::string, DiskIOStat>* map);
     int64_t get_max_io_util(const std::map<std::string, int64_t>& lst_value, int64_t interval_sec);
 
     void get_network_traffic(std::map<std::string, int64_t>* send_map,
@@ -46,6 +46,7 @@
 #include <algorithm>
 #include <cfloat>
 #include <cmath>
+#include <cstring>
 #include <iostream>
 #include <memory>
 #include <queue>
@@ -215,6 +216,64 @@ public:
         add(others.cbegin(), others.cend());
     }
 
+    // merge in t-digests written by serialize(), like add() does for t-digests but without
+    // unserializing each of them into a TDigest first
+    void merge(const std::vector<const uint8_t*>& serialized) {
+        std::vector<Centroid> sorted;
+        std::vector<size_t> runs;
+        size_t totalSize = 0;
+        for (size_t i = 0; i < serialized.size(); ++i) {
+            // skip _compression, _min, _max, _max_processed and _max_unprocessed
+            const uint8_t* reader = serialized[i] + sizeof(Value) * 3 + sizeof(Index) * 2;
+            Value processed_weight;
+            Value unprocessed_weight;
+            memcpy(&processed_weight, reader, sizeof(Value));
+            reader += sizeof(Value);
+            memcpy(&unprocessed_weight, reader, sizeof(Value));
+            reader += sizeof(Value);
+
+            uint32_t size;
+            memcpy(&size, reader, sizeof(uint32_t));
+            reader += sizeof(uint32_t);
+            if (size > 0) {
+                if (sorted.empty() && !_processed.empty()) {
+                    sorted.insert(sorted.end(), _processed.cbegin(), _processed.cend());
+                    runs.push_back(sorted.size());
+                }
+                sorted.resize(sorted.size() + size);
+                memcpy(&sorted[sorted.size() - size], reader, size * sizeof(Centroid));
+                runs.push_back(sorted.size());
+                reader += size * sizeof(Centroid);
+                _processed_weight += processed_weight;
+            }
+            totalSize += size;
+
+            memcpy(&size, reader, sizeof(uint32_t));
+            reader += sizeof(uint32_t);
+            if (size > 0) {
+                _unprocessed.resize(_unprocessed.size() + size);
+                memcpy(&_unprocessed[_unprocessed.size() - size], reader,
+                       size * sizeof(Centroid));
+                _unprocessed_weight += unprocessed_weight;
+            }
+            totalSize += size;
+
+            if (totalSize >= kHighWater || i + 1 == serialized.size()) {
+                if (!sorted.empty()) {
+                    mergeRuns(&sorted, &runs);
+                    _processed = std::move(sorted);
+                    sorted.clear();
+                    runs.clear();
+                    _min = std::min(_min, _processed[0].mean());
+                    _max = std::max(_max, (_processed.cend() - 1)->mean());
+                }
+                processIfNecessary();
+                totalSize = 0;
+            }
+        }
+        updateCumulative();
+    }
+
     const std::vector<Centroid>& processed() const { return _processed; }
 
     const std::vector<Centroid>& unprocessed() const { return _unprocessed; }
@@ -429,6 +488,25 @@ public:
         return true;
     }
 
+    // add 'n' values of weight 1, the unprocessed centroids are processed each time they
+    // fill the buffer instead of being checked after every value
+    void add(const Value* values, size_t n) {
+        size_t i = 0;
+        while (i < n) {
+            const size_t end = std::min(n, i + _max_unprocessed - _unprocessed.size());
+            for (; i < end; i++) {
+                if (!std::isnan(values[i])) {
+                    _unprocessed.emplace_back(values[i], 1);
+                    _unprocessed_weight += 1;
+                }
+            }
+            if (_unprocessed.size() >= _max_unprocessed) {
+                process();
+            }
+        }
+        processIfNecessary();
+    }
+
     inline void add(std::vector<Centroid>::const_iterator iter,
                     std::vector<Centroid>::const_iterator end) {
         while (iter != end) {
@@ -442,13 +520,17 @@ public:
         }
     }
 
+    // The unprocessed centroids are processed first, they would take more space than the
+    // processed ones they're merged into. The cumulative weights aren't serialized, they
+    // are computed again by unserialize().
     uint32_t serialized_size() {
-        return sizeof(Value) * 5 + sizeof(Index) * 2 + sizeof(size_t) * 3 +
-               _processed.size() * sizeof(Centroid) + _unprocessed.size() * sizeof(Centroid) +
-               _cumulative.size() * sizeof(Weight);
+        if (haveUnprocessed()) process();
+        return sizeof(Value) * 5 + sizeof(Index) * 2 + sizeof(uint32_t) * 3 +
+               _processed.size() * sizeof(Centroid);
     }
 
     void serialize(uint8_t* writer) {
+        if (haveUnprocessed()) process();
         memcpy(writer, &_compression, sizeof(Value));
         writer += sizeof(Value);
         memcpy(writer, &_min, sizeof(Value));
@@ -467,26 +549,15 @@ public:
         uint32_t size = _processed.size();
         memcpy(writer, &size, sizeof(uint32_t));
         writer += sizeof(uint32_t);
-        for (int i = 0; i < size; i++) {
-            memcpy(writer, &_processed[i], sizeof(Centroid));
-            writer += sizeof(Centroid);
-        }
+        memcpy(writer, _processed.data(), size * sizeof(Centroid));
+        writer += size * sizeof(Centroid);
 
-        size = _unprocessed.size();
+        // no unprocessed centroids and cumulative weights, the sizes are kept so that the
+        // t-digests serialized by older versions can still be read
+        size = 0;
         memcpy(writer, &size, sizeof(uint32_t));
         writer += sizeof(uint32_t);
-        for (int i = 0; i < size; i++) {
-            memcpy(writer, &_unprocessed[i], sizeof(Centroid));
-            writer += sizeof(Centroid);
-        }
-
-        size = _cumulative.size();
         memcpy(writer, &size, sizeof(uint32_t));
-        writer += sizeof(uint32_t);
-        for (int i = 0; i < size; i++) {
-            memcpy(writer, &_cumulative[i], sizeof(Weight));
-            writer += sizeof(Weight);
-        }
     }
 
     void unserialize(const uint8_t* type_reader) {
@@ -528,6 +599,9 @@ public:
             memcpy(&_cumulative[i], type_reader, sizeof(Weight));
             type_reader += sizeof(Weight);
         }
+        if (_cumulative.empty()) {
+            updateCumulative();
+        }
     }
 
 private:
@@ -535,7 +609,7 @@ private:
 
     Value _min = std::numeric_limits<Value>::max();
 
-    Value _max = std::numeric_limits<Value>::min();
+    Value _max = std::numeric_limits<Value>::lowest();
 
     Index _max_processed;
 
@@ -613,6 +687,27 @@ private:
         }
     }
 
+    // merges the sorted runs of 'sorted' ending at 'runs' into one, pairwise so that it
+    // takes log(number of runs) passes
+    static void mergeRuns(std::vector<Centroid>* sorted, std::vector<size_t>* runs) {
+        CentroidComparator cc;
+        while (runs->size() > 1) {
+            size_t begin = 0;
+            size_t merged = 0;
+            for (size_t i = 0; i < runs->size(); i += 2) {
+                if (i + 1 < runs->size()) {
+                    std::inplace_merge(sorted->begin() + begin, sorted->begin() + (*runs)[i],
+                                       sorted->begin() + (*runs)[i + 1], cc);
+                    begin = (*runs)[i + 1];
+                } else {
+                    begin = (*runs)[i];
+                }
+                (*runs)[merged++] = begin;
+            }
+            runs->resize(merged);
+        }
+    }
+
     inline void processIfNecessary() {
         if (isDirty()) {
             process();
@@ -0,0 +1,132 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "util/thread_perf_counters.h"
+
+#include <linux/perf_event.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <vector>
+
+namespace doris {
+
+// The perf events of ThreadPerfCounters::Event, and the names of their counters
+static const uint64_t EVENT_CONFIGS[ThreadPerfCounters::NUM_EVENTS] = {
+        PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_REFERENCES,
+        PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+static const char* EVENT_NAMES[ThreadPerfCounters::NUM_EVENTS] = {
+        "PerfCpuCycles", "PerfInstructions", "PerfCacheReferences", "PerfCacheMisses",
+        "PerfBranchMisses"};
+
+// The hardware events of a thread, opened as a group the first time the thread counts
+// them and closed when it exits.
+class ThreadEvents {
+public:
+    ~ThreadEvents() {
+        for (int fd : _fds) {
+            close(fd);
+        }
+    }
+
+    bool start() {
+        if (!_opened) {
+            open();
+        }
+        if (_running || _fds.empty()) {
+            return false;
+        }
+        ioctl(_fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(_fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        _running = true;
+        return true;
+    }
+
+    // Stops counting and sets 'counts' to the counts of the events since start(),
+    // 0 for the ones left out.
+    void stop(int64_t* counts) {
+        DCHECK(_running);
+        ioctl(_fds[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+        _running = false;
+        memset(counts, 0, sizeof(int64_t) * ThreadPerfCounters::NUM_EVENTS);
+        // The leader of the group reads the number of the events followed by the count
+        // of each, in the order they were opened.
+        uint64_t buffer[ThreadPerfCounters::NUM_EVENTS + 1];
+        ssize_t expected = sizeof(uint64_t) * (_fds.size() + 1);
+        if (read(_fds[0], buffer, sizeof(buffer)) != expected) {
+            return;
+        }
+        for (size_t i = 0; i < _events.size(); ++i) {
+            counts[_events[i]] = buffer[i + 1];
+        }
+    }
+
+private:
+    void open() {
+        _opened = true;
+        for (int event = 0; event < ThreadPerfCounters::NUM_EVENTS; ++event) {
+            perf_event_attr attr;
+            memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = EVENT_CONFIGS[event];
+            attr.read_format = PERF_FORMAT_GROUP;
+            // the members of the group are enabled and disabled with the leader
+            attr.disabled = _fds.empty() ? 1 : 0;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            int group_fd = _fds.empty() ? -1 : _fds[0];
+            int fd = syscall(__NR_perf_event_open, &attr, 0, -1, group_fd, 0);
+            if (fd < 0) {
+                continue;
+            }
+            _fds.push_back(fd);
+            _events.push_back(event);
+        }
+    }
+
+    bool _opened = false;
+    bool _running = false;
+    // the leader of the group first
+    std::vector<int> _fds;
+    // the ThreadPerfCounters::Event of each of _fds
+    std::vector<int> _events;
+};
+
+static thread_local ThreadEvents thread_events;
+
+ThreadPerfCounters::ThreadPerfCounters(RuntimeProfile* profile, const std::string& prefix) {
+    for (int event = 0; event < NUM_EVENTS; ++event) {
+        _counters[event] = ADD_COUNTER(profile, prefix + EVENT_NAMES[event], TUnit::UNIT);
+    }
+}
+
+bool ThreadPerfCounters::start_thread_events() {
+    return thread_events.start();
+}
+
+void ThreadPerfCounters::stop_thread_events() {
+    int64_t counts[NUM_EVENTS];
+    thread_events.stop(counts);
+    for (int event = 0; event < NUM_EVENTS; ++event) {
+        COUNTER_UPDATE(_counters[event], counts[event]);
+    }
+}
+
+} // namespace doris
@@ -0,0 +1,82 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <string>
+
+#include "util/runtime_profile.h"
+
+namespace doris {
+
+// Profile counters of the hardware events of the threads running a fragment instance,
+// or its scanners, collected when the query option enable_perf_counters is set.
+// Each thread opens its events once, the first time it counts them, and counts them
+// only between start_thread_events() and stop_thread_events(). The events the cpu
+// can't count, e.g. in a vm, are left out. The instructions per cycle of the threads
+// is PerfInstructions / PerfCpuCycles.
+class ThreadPerfCounters {
+public:
+    enum Event {
+        CPU_CYCLES,
+        INSTRUCTIONS,
+        CACHE_REFERENCES,
+        // misses of the last level cache
+        CACHE_MISSES,
+        BRANCH_MISSES,
+        NUM_EVENTS,
+    };
+
+    // Adds the counters to 'profile', named by 'prefix' followed by the event names,
+    // e.g. "PerfInstructions".
+    ThreadPerfCounters(RuntimeProfile* profile, const std::string& prefix);
+
+    // Starts counting the events of the calling thread. Returns false if the thread
+    // counts them already or can't count any of them.
+    static bool start_thread_events();
+
+    // Stops counting the events of the calling thread and adds their counts since
+    // start_thread_events() to the counters.
+    void stop_thread_events();
+
+private:
+    RuntimeProfile::Counter* _counters[NUM_EVENTS];
+};
+
+// Counts the hardware events of the calling thread in the scope to 'counters', if
+// it's not null.
+class ScopedPerfCounters {
+public:
+    explicit ScopedPerfCounters(ThreadPerfCounters* counters)
+            : _counters(counters),
+              _started(counters != nullptr && ThreadPerfCounters::start_thread_events()) {}
+
+    ~ScopedPerfCounters() {
+        if (_started) {
+            _counters->stop_thread_events();
+        }
+    }
+
+private:
+    ThreadPerfCounters* _counters;
+    bool _started;
+};
+
+#define SCOPED_PERF_COUNTERS(c) \
+    ScopedPerfCounters MACRO_CONCAT(SCOPED_PERF_COUNTERS, __COUNTER__)(c)
+
+} // namespace doris
@@ -133,6 +133,11 @@ public:
         return (*this)(lhs_row, rhs_row);
     }
 
+    // The exprs evaluated on the left hand side of comparisons, and their sort orders.
+    const std::vector<ExprContext*>& lhs_key_expr_ctxs() const { return _key_expr_ctxs_lhs; }
+    bool is_asc(int i) const { return _is_asc[i]; }
+    bool nulls_first(int i) const { return _nulls_first[i] < 0; }
+
 private:
     const std::vector<ExprContext*>& _key_expr_ctxs_lhs;
     const std::vector<ExprContext*>& _key_expr_ctxs_rhs;
@@ -103,10 +103,27 @@ bool validate_utf8_naive(const char* data, size_t len) {
     return true;
 }
 
+bool validate_ascii_naive(const char* data, size_t len) {
+    uint8_t bits = 0;
+    for (size_t i = 0; i < len; ++i) {
+        bits |= (uint8_t)data[i];
+    }
+    return bits < 0x80;
+}
+
 #if defined(__i386) || defined(__x86_64__)
 bool validate_utf8(const char* src, size_t len) {
+#ifdef DORIS_TARGET_AVX2
+    if (cpu_dispatch::best_isa() >= cpu_dispatch::Isa::AVX2) {
+        return validate_utf8_fast_avx(src, len);
+    }
+#endif
     return validate_utf8_fast(src, len);
 }
+
+bool validate_ascii(const char* src, size_t len) {
+    return validate_ascii_fast(src, len);
+}
 #elif defined(__aarch64__)
 /*
  * Map high nibble of "First Byte" to legal character length minus 1
@@ -324,9 +341,23 @@ bool utf8_range(const char* data, size_t len) {
 bool validate_utf8(const char* src, size_t len) {
     return utf8_range(src, len);
 }
+
+bool validate_ascii(const char* src, size_t len) {
+    uint8x16_t high_bits = vdupq_n_u8(0);
+    while (len >= 16) {
+        high_bits = vorrq_u8(high_bits, vld1q_u8((const uint8_t*)src));
+        src += 16;
+        len -= 16;
+    }
+    return vmaxvq_u8(high_bits) < 0x80 && validate_ascii_naive(src, len);
+}
 #else
 bool validate_utf8(const char* src, size_t len) {
     return validate_utf8_naive(src, len);
 }
+
+bool validate_ascii(const char* src, size_t len) {
+    return validate_ascii_naive(src, len);
+}
 #endif
 } // namespace doris
@@ -26,6 +26,9 @@ namespace doris {
 bool validate_utf8(const char* src, size_t len);
 // check utf8 use naive c++
 bool validate_utf8_naive(const char* data, size_t len);
+// check that all the bytes are ascii, i.e. one byte utf8 chars, using simd instructions
+bool validate_ascii(const char* src, size_t len);
+bool validate_ascii_naive(const char* data, size_t len);
 } // namespace doris
 
 #endif // DORIS_BE_SRC_UTIL_UTF8_CHECK_H
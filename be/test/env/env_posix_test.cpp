@@ -19,6 +19,7 @@
 
 #include <algorithm>
 
+#include "common/config.h"
 #include "common/logging.h"
 #include "env/env.h"
 #include "util/file_utils.h"
@@ -101,6 +102,91 @@ TEST_F(EnvPosixTest, random_access) {
     }
 }
 
+TEST_F(EnvPosixTest, direct_write) {
+    std::string fname = "./ut_dir/env_posix/direct_write";
+    WritableFileOptions opts;
+    opts.direct_io = true;
+    opts.sync_on_close = true;
+    std::unique_ptr<WritableFile> wfile;
+    auto env = Env::Default();
+    ASSERT_TRUE(env->new_writable_file(opts, fname, &wfile).ok());
+    ASSERT_TRUE(wfile->pre_allocate(1024).ok());
+    // chunks of sizes not aligned, larger than the buffer at the end
+    std::string data;
+    for (int i = 0; data.size() < 3 * 1024 * 1024; ++i) {
+        std::string chunk(i * 997 % 5000 + 1, (char)('a' + i % 26));
+        if (i == 100) {
+            chunk.assign(2 * 1024 * 1024 + 7, 'z');
+        }
+        ASSERT_TRUE(wfile->append(chunk).ok());
+        data += chunk;
+        // the last partial block is written padded, and written again by the next sync
+        if (i % 50 == 0) {
+            ASSERT_TRUE(wfile->sync().ok());
+        }
+        ASSERT_EQ(data.size(), wfile->size());
+    }
+    ASSERT_TRUE(wfile->close().ok());
+    ASSERT_EQ(data.size(), wfile->size());
+
+    uint64_t size;
+    ASSERT_TRUE(env->get_file_size(fname, &size).ok());
+    ASSERT_EQ(data.size(), size);
+    std::unique_ptr<RandomAccessFile> rfile;
+    ASSERT_TRUE(env->new_random_access_file(fname, &rfile).ok());
+    std::string read_data(data.size(), 0);
+    ASSERT_TRUE(rfile->read_at(0, Slice(&read_data[0], read_data.size())).ok());
+    ASSERT_TRUE(data == read_data);
+
+    ASSERT_TRUE(env->drop_page_cache(fname).ok());
+}
+
+TEST_F(EnvPosixTest, read_batch) {
+    std::string fname = "./ut_dir/env_posix/read_batch";
+    std::string data;
+    for (int i = 0; i < 1024 * 1024; ++i) {
+        data.push_back((char)(i * 7 + i / 13));
+    }
+    auto env = Env::Default();
+    {
+        std::unique_ptr<WritableFile> wfile;
+        ASSERT_TRUE(env->new_writable_file(fname, &wfile).ok());
+        ASSERT_TRUE(wfile->append(data).ok());
+        ASSERT_TRUE(wfile->close().ok());
+    }
+    std::unique_ptr<RandomAccessFile> rfile;
+    ASSERT_TRUE(env->new_random_access_file(fname, &rfile).ok());
+
+    bool enable_io_uring = config::enable_io_uring;
+    for (bool use_io_uring : {false, true}) {
+        config::enable_io_uring = use_io_uring;
+        // more requests than the entries of a ring
+        const int num = 300;
+        std::vector<std::string> bufs(num);
+        std::vector<RandomAccessFile::ReadRequest> reqs(num);
+        for (int i = 0; i < num; ++i) {
+            size_t len = 100 + (i * 37) % 3000;
+            bufs[i].resize(len);
+            reqs[i].offset = (i * 104729) % (data.size() - len);
+            reqs[i].result = Slice(&bufs[i][0], len);
+        }
+        ASSERT_TRUE(rfile->read_batch(reqs.data(), num).ok());
+        for (int i = 0; i < num; ++i) {
+            ASSERT_EQ(data.substr(reqs[i].offset, bufs[i].size()), bufs[i]);
+        }
+
+        // end of file
+        char buf[16];
+        RandomAccessFile::ReadRequest eof_reqs[2];
+        eof_reqs[0].result = Slice(buf, 8);
+        eof_reqs[1].offset = data.size() - 4;
+        eof_reqs[1].result = Slice(buf + 8, 8);
+        auto st = rfile->read_batch(eof_reqs, 2);
+        ASSERT_EQ(TStatusCode::END_OF_FILE, st.code());
+    }
+    config::enable_io_uring = enable_io_uring;
+}
+
 TEST_F(EnvPosixTest, random_rw) {
     std::string fname = "./ut_dir/env_posix/random_rw";
     WritableFileOptions ops;
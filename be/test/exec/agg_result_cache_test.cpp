@@ -0,0 +1,62 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "exec/agg_result_cache.h"
+
+#include <gtest/gtest.h>
+
+#include "gen_cpp/Exprs_types.h"
+
+namespace doris {
+
+class AggResultCacheTest : public testing::Test {};
+
+TEST_F(AggResultCacheTest, normal) {
+    AggResultCache cache(1024 * 1024);
+    std::shared_ptr<const AggResultCache::Batches> batches;
+    ASSERT_FALSE(cache.lookup("plan|10001@5", &batches));
+
+    std::shared_ptr<AggResultCache::Batches> output(new AggResultCache::Batches(2));
+    output->at(0).set_num_rows(3);
+    cache.insert("plan|10001@5", output, 100);
+    ASSERT_TRUE(cache.lookup("plan|10001@5", &batches));
+    ASSERT_EQ(2, batches->size());
+    ASSERT_EQ(3, batches->at(0).num_rows());
+    // a newer version of the tablet
+    ASSERT_FALSE(cache.lookup("plan|10001@6", &batches));
+}
+
+TEST_F(AggResultCacheTest, volatile_fn) {
+    TExprNode node;
+    node.__set_node_type(TExprNodeType::FUNCTION_CALL);
+    TFunction fn;
+    fn.name.__set_function_name("abs");
+    node.__set_fn(fn);
+    std::vector<TExpr> exprs(1);
+    exprs[0].nodes.push_back(node);
+    ASSERT_FALSE(AggResultCache::has_volatile_fn(exprs));
+
+    exprs[0].nodes[0].fn.name.__set_function_name("rand");
+    ASSERT_TRUE(AggResultCache::has_volatile_fn(exprs));
+}
+
+} // namespace doris
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
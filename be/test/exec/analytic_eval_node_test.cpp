@@ -0,0 +1,345 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "exec/analytic_eval_node.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/object_pool.h"
+#include "gen_cpp/Exprs_types.h"
+#include "gen_cpp/PlanNodes_types.h"
+#include "runtime/descriptor_helper.h"
+#include "runtime/descriptors.h"
+#include "runtime/disk_io_mgr.h"
+#include "runtime/exec_env.h"
+#include "runtime/mem_tracker.h"
+#include "runtime/row_batch.h"
+#include "runtime/runtime_state.h"
+#include "runtime/thread_resource_mgr.h"
+#include "runtime/tmp_file_mgr.h"
+#include "runtime/tuple.h"
+#include "runtime/tuple_row.h"
+#include "runtime/user_function_cache.h"
+#include "util/cpu_info.h"
+#include "util/disk_info.h"
+#include "util/file_utils.h"
+
+namespace doris {
+
+static const int64_t kMemLimit = 512 * 1024 * 1024;
+static const std::string kLibDir = "./be/test/exec/test_data/analytic_eval_node_test/lib";
+
+// The input of the windows is in [0, kMaxValue), -1 standing for NULL
+static const int32_t kMaxValue = 100;
+
+// Returns `values` in the INT slot of its tuple to its parent
+class ValuesNode : public ExecNode {
+public:
+    ValuesNode(ObjectPool* pool, const TPlanNode& tnode, const DescriptorTbl& descs,
+               const std::vector<int32_t>& values)
+            : ExecNode(pool, tnode, descs), _values(values) {}
+
+    Status get_next(RuntimeState* state, RowBatch* row_batch, bool* eos) override {
+        const TupleDescriptor* tuple_desc = row_desc().tuple_descriptors()[0];
+        const SlotDescriptor* slot_desc = tuple_desc->slots()[0];
+        while (!row_batch->is_full() && _next < _values.size()) {
+            Tuple* tuple = reinterpret_cast<Tuple*>(
+                    row_batch->tuple_data_pool()->allocate(tuple_desc->byte_size()));
+            memset(tuple, 0, tuple_desc->byte_size());
+            int32_t value = _values[_next++];
+            if (value == -1) {
+                tuple->set_null(slot_desc->null_indicator_offset());
+            } else {
+                *reinterpret_cast<int32_t*>(tuple->get_slot(slot_desc->tuple_offset())) = value;
+            }
+            TupleRow* row = row_batch->get_row(row_batch->add_row());
+            row->set_tuple(0, tuple);
+            row_batch->commit_last_row();
+        }
+        *eos = _next == _values.size();
+        return Status::OK();
+    }
+
+private:
+    std::vector<int32_t> _values;
+    size_t _next = 0;
+};
+
+class AnalyticEvalNodeTest : public testing::Test {
+public:
+    static void SetUpTestCase() {
+        ExecEnv* env = ExecEnv::GetInstance();
+        env->_thread_mgr = new ThreadResourceMgr();
+        env->_disk_io_mgr = new DiskIoMgr();
+        ASSERT_TRUE(env->_disk_io_mgr->init(MemTracker::CreateTracker(-1, "DiskIoMgr")).ok());
+        // no scratch directories, the input of the tests is buffered in memory
+        env->_tmp_file_mgr = new TmpFileMgr();
+        ASSERT_TRUE(env->_tmp_file_mgr->init_custom({}, false).ok());
+        // min() and max() are looked up in the process
+        ASSERT_TRUE(UserFunctionCache::instance()->init(kLibDir).ok());
+    }
+
+    static void TearDownTestCase() {
+        ExecEnv* env = ExecEnv::GetInstance();
+        SAFE_DELETE(env->_tmp_file_mgr);
+        SAFE_DELETE(env->_disk_io_mgr);
+        SAFE_DELETE(env->_thread_mgr);
+        FileUtils::remove_all(kLibDir);
+    }
+
+    void SetUp() override {
+        // tuple 0 of the input (k int null), tuple 1 of the intermediate values and
+        // tuple 2 of the results of (min(k), max(k)), all nullable INT slots
+        TDescriptorTableBuilder dtb;
+        for (int i = 0; i < 3; ++i) {
+            TTupleDescriptorBuilder tuple_builder;
+            for (int j = 0; j < (i == 0 ? 1 : 2); ++j) {
+                tuple_builder.add_slot(TSlotDescriptorBuilder()
+                                               .type(TYPE_INT)
+                                               .column_name("c" + std::to_string(j))
+                                               .column_pos(j)
+                                               .nullable(true)
+                                               .build());
+            }
+            tuple_builder.build(&dtb);
+        }
+        ASSERT_TRUE(DescriptorTbl::create(&_obj_pool, dtb.desc_tbl(), &_desc_tbl).ok());
+
+        TQueryOptions query_options;
+        query_options.__set_mem_limit(kMemLimit);
+        _state.reset(new RuntimeState(TUniqueId(), query_options, TQueryGlobals(),
+                                      ExecEnv::GetInstance()));
+        ASSERT_TRUE(_state->init_mem_trackers(TUniqueId()).ok());
+        ASSERT_TRUE(_state->create_block_mgr().ok());
+        _state->set_desc_tbl(_desc_tbl);
+    }
+
+    void TearDown() override {
+        _obj_pool.clear();
+        _state.reset();
+    }
+
+    // Evaluates min(k) and max(k) over ROWS BETWEEN `start` AND `end` of `values`, offsets
+    // before the current row are negative, and checks them against the brute force ones.
+    void check_window(int64_t start, int64_t end, const std::vector<int32_t>& values) {
+        TPlanNode tnode;
+        tnode.__set_node_id(0);
+        tnode.__set_node_type(TPlanNodeType::ANALYTIC_EVAL_NODE);
+        tnode.__set_num_children(1);
+        tnode.__set_limit(-1);
+        tnode.__set_row_tuples({0, 2});
+        tnode.__set_nullable_tuples({false, false});
+        tnode.__set_compact_data(false);
+        TAnalyticWindow window;
+        window.__set_type(TAnalyticWindowType::ROWS);
+        window.__set_window_start(bound(start));
+        window.__set_window_end(bound(end));
+        TAnalyticNode analytic_node;
+        analytic_node.__set_partition_exprs({});
+        analytic_node.__set_order_by_exprs({});
+        analytic_node.__set_analytic_functions({min_max("min"), min_max("max")});
+        analytic_node.__set_window(window);
+        analytic_node.__set_intermediate_tuple_id(1);
+        analytic_node.__set_output_tuple_id(2);
+        tnode.__set_analytic_node(analytic_node);
+
+        TPlanNode child_tnode;
+        child_tnode.__set_node_id(1);
+        child_tnode.__set_node_type(TPlanNodeType::EMPTY_SET_NODE);
+        child_tnode.__set_num_children(0);
+        child_tnode.__set_limit(-1);
+        child_tnode.__set_row_tuples({0});
+        child_tnode.__set_nullable_tuples({false});
+        child_tnode.__set_compact_data(false);
+
+        AnalyticEvalNode* node = _obj_pool.add(new AnalyticEvalNode(&_obj_pool, tnode, *_desc_tbl));
+        ASSERT_TRUE(node->init(tnode, _state.get()).ok());
+        node->_children.push_back(
+                _obj_pool.add(new ValuesNode(&_obj_pool, child_tnode, *_desc_tbl, values)));
+        ASSERT_TRUE(node->prepare(_state.get()).ok());
+        ASSERT_TRUE(node->open(_state.get()).ok());
+
+        const std::vector<SlotDescriptor*>& slots = _desc_tbl->get_tuple_descriptor(2)->slots();
+        RowBatch batch(node->row_desc(), _state->batch_size(),
+                       _state->instance_mem_tracker().get());
+        int64_t row_idx = 0;
+        bool eos = false;
+        while (!eos) {
+            ASSERT_TRUE(node->get_next(_state.get(), &batch, &eos).ok());
+            for (int i = 0; i < batch.num_rows(); ++i, ++row_idx) {
+                ASSERT_LT(row_idx, static_cast<int64_t>(values.size()));
+                int32_t expected_min = -1;
+                int32_t expected_max = -1;
+                int64_t begin = std::max<int64_t>(row_idx + start, 0);
+                int64_t limit = std::min<int64_t>(row_idx + end + 1, values.size());
+                for (int64_t j = begin; j < limit; ++j) {
+                    if (values[j] == -1) {
+                        continue;
+                    }
+                    expected_min = expected_min == -1 ? values[j]
+                                                      : std::min(expected_min, values[j]);
+                    expected_max = std::max(expected_max, values[j]);
+                }
+                Tuple* result = batch.get_row(i)->get_tuple(1);
+                ASSERT_EQ(expected_min, value(result, slots[0])) << "row " << row_idx;
+                ASSERT_EQ(expected_max, value(result, slots[1])) << "row " << row_idx;
+            }
+            batch.reset();
+        }
+        ASSERT_EQ(static_cast<int64_t>(values.size()), row_idx);
+        ASSERT_TRUE(node->close(_state.get()).ok());
+    }
+
+    static int32_t value(Tuple* tuple, const SlotDescriptor* slot_desc) {
+        if (tuple->is_null(slot_desc->null_indicator_offset())) {
+            return -1;
+        }
+        return *reinterpret_cast<int32_t*>(tuple->get_slot(slot_desc->tuple_offset()));
+    }
+
+    // Returns `num_values` values with runs of ascending and descending values, to move
+    // the fronts of the monotonic queues forth and back, and of NULLs
+    static std::vector<int32_t> window_values(size_t num_values) {
+        std::vector<int32_t> values;
+        uint32_t seed = 1;
+        while (values.size() < num_values) {
+            seed = seed * 1103515245 + 12345;
+            int32_t value = (seed >> 8) % kMaxValue;
+            int run = (seed >> 16) % 8;
+            switch ((seed >> 24) % 4) {
+            case 0:
+                for (int i = 0; i < run; ++i) {
+                    values.push_back(std::min(value + i, kMaxValue - 1));
+                }
+                break;
+            case 1:
+                for (int i = 0; i < run; ++i) {
+                    values.push_back(std::max(value - i, 0));
+                }
+                break;
+            case 2:
+                values.push_back(-1);
+                break;
+            default:
+                values.push_back(value);
+                break;
+            }
+        }
+        values.resize(num_values);
+        return values;
+    }
+
+    static TAnalyticWindowBoundary bound(int64_t offset) {
+        TAnalyticWindowBoundary bound;
+        if (offset == 0) {
+            bound.__set_type(TAnalyticWindowBoundaryType::CURRENT_ROW);
+        } else {
+            bound.__set_type(offset < 0 ? TAnalyticWindowBoundaryType::PRECEDING
+                                        : TAnalyticWindowBoundaryType::FOLLOWING);
+            bound.__set_rows_offset_value(std::abs(offset));
+        }
+        return bound;
+    }
+
+    // Returns `name`(k) of the builtin `name` in ("min", "max") on INT, the way the FE
+    // plans it, which has no remove fn.
+    static TExpr min_max(const std::string& name) {
+        TTypeDesc int_type = TypeDescriptor(TYPE_INT).to_thrift();
+        const std::string prefix = "_ZN5doris18AggregateFunctions";
+        const std::string update_fn_symbol =
+                prefix + "3" + name + "IN9doris_udf6IntValEEEvPNS2_15FunctionContextERKT_PS6_";
+        TAggregateFunction aggregate_fn;
+        aggregate_fn.__set_intermediate_type(int_type);
+        aggregate_fn.__set_init_fn_symbol(
+                prefix + "9init_nullEPN9doris_udf15FunctionContextEPNS1_6AnyValE");
+        aggregate_fn.__set_update_fn_symbol(update_fn_symbol);
+        aggregate_fn.__set_merge_fn_symbol(update_fn_symbol);
+        TFunction fn;
+        fn.name.__set_function_name(name);
+        fn.__set_binary_type(TFunctionBinaryType::BUILTIN);
+        fn.__set_arg_types({int_type});
+        fn.__set_ret_type(int_type);
+        fn.__set_has_var_args(false);
+        fn.__set_aggregate_fn(aggregate_fn);
+        fn.__set_id(0);
+
+        TExprNode agg_node;
+        agg_node.__set_node_type(TExprNodeType::AGG_EXPR);
+        agg_node.__set_type(int_type);
+        agg_node.__set_num_children(1);
+        agg_node.__set_fn(fn);
+        TAggregateExpr agg_expr;
+        agg_expr.__set_is_merge_agg(false);
+        agg_node.__set_agg_expr(agg_expr);
+
+        TExprNode slot_node;
+        slot_node.__set_node_type(TExprNodeType::SLOT_REF);
+        slot_node.__set_type(int_type);
+        slot_node.__set_num_children(0);
+        TSlotRef slot_ref;
+        slot_ref.__set_slot_id(0);
+        slot_ref.__set_tuple_id(0);
+        slot_node.__set_slot_ref(slot_ref);
+
+        TExpr expr;
+        expr.nodes.push_back(agg_node);
+        expr.nodes.push_back(slot_node);
+        return expr;
+    }
+
+protected:
+    ObjectPool _obj_pool;
+    DescriptorTbl* _desc_tbl = nullptr;
+    std::unique_ptr<RuntimeState> _state;
+};
+
+TEST_F(AnalyticEvalNodeTest, min_max_preceding_window) {
+    check_window(-2, 0, window_values(3000));
+}
+
+TEST_F(AnalyticEvalNodeTest, min_max_preceding_following_window) {
+    check_window(-5, 3, window_values(3000));
+}
+
+TEST_F(AnalyticEvalNodeTest, min_max_following_window) {
+    check_window(1, 3, window_values(3000));
+}
+
+TEST_F(AnalyticEvalNodeTest, min_max_null_windows) {
+    // The windows of the rows in the middle have no values
+    std::vector<int32_t> null_values(100, -1);
+    null_values.front() = 7;
+    null_values.back() = 3;
+    check_window(-2, 1, null_values);
+}
+
+} // namespace doris
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    doris::CpuInfo::init();
+    doris::DiskInfo::init();
+    return RUN_ALL_TESTS();
+}
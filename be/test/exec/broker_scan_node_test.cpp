@@ -23,6 +23,7 @@
 #include <string>
 #include <vector>
 
+#include "common/config.h"
 #include "common/object_pool.h"
 #include "exec/local_file_reader.h"
 #include "exprs/cast_functions.h"
@@ -484,6 +485,61 @@ TEST_F(BrokerScanNodeTest, normal) {
     }
 }
 
+TEST_F(BrokerScanNodeTest, split_ranges) {
+    BrokerScanNode scan_node(&_obj_pool, _tnode, *_desc_tbl);
+    auto status = scan_node.prepare(&_runtime_state);
+    ASSERT_TRUE(status.ok());
+
+    std::vector<TScanRangeParams> scan_ranges;
+    {
+        TScanRangeParams scan_range_params;
+
+        TBrokerScanRange broker_scan_range;
+        broker_scan_range.params = _params;
+
+        TBrokerRangeDesc range;
+        range.path = "./be/test/exec/test_data/broker_scanner/normal.csv";
+        range.start_offset = 0;
+        range.size = -1;
+        range.__set_file_size(24);
+        range.file_type = TFileType::FILE_LOCAL;
+        range.format_type = TFileFormatType::FORMAT_CSV_PLAIN;
+        range.splittable = true;
+        std::vector<std::string> columns_from_path{"1"};
+        range.__set_columns_from_path(columns_from_path);
+        range.__set_num_of_columns_from_file(3);
+        broker_scan_range.ranges.push_back(range);
+
+        scan_range_params.scan_range.__set_broker_scan_range(broker_scan_range);
+
+        scan_ranges.push_back(scan_range_params);
+    }
+    scan_node.set_scan_ranges(scan_ranges);
+
+    int64_t split_bytes = config::broker_scan_split_bytes;
+    config::broker_scan_split_bytes = 5;
+    status = scan_node.open(&_runtime_state);
+    config::broker_scan_split_bytes = split_bytes;
+    ASSERT_TRUE(status.ok());
+    ASSERT_EQ(5, scan_node._scan_units.size());
+    ASSERT_EQ(20, scan_node._scan_units[4].ranges[0].start_offset);
+    ASSERT_EQ(4, scan_node._scan_units[4].ranges[0].size);
+
+    // the lines across the splits are read once, as the whole file is
+    auto tracker = std::make_shared<MemTracker>();
+    RowBatch batch(scan_node.row_desc(), _runtime_state.batch_size(), tracker.get());
+    int num_rows = 0;
+    bool eos = false;
+    while (!eos) {
+        batch.reset();
+        status = scan_node.get_next(&_runtime_state, &batch, &eos);
+        ASSERT_TRUE(status.ok());
+        num_rows += batch.num_rows();
+    }
+    ASSERT_EQ(3, num_rows);
+    scan_node.close(&_runtime_state);
+}
+
 } // namespace doris
 
 int main(int argc, char** argv) {
@@ -656,6 +656,44 @@ TEST_F(BrokerScannerTest, normal9) {
     ASSERT_TRUE(eof);
 }
 
+TEST_F(BrokerScannerTest, long_line) {
+    std::vector<TBrokerRangeDesc> ranges;
+    TBrokerRangeDesc range;
+    range.path = "./be/test/exec/test_data/broker_scanner/long_line.csv";
+    range.start_offset = 0;
+    range.size = -1;
+    range.splittable = true;
+    range.file_type = TFileType::FILE_LOCAL;
+    range.format_type = TFileFormatType::FORMAT_CSV_PLAIN;
+    ranges.push_back(range);
+
+    BrokerScanner scanner(&_runtime_state, _profile, _params, ranges, _addresses, &_counter);
+    auto st = scanner.open();
+    ASSERT_TRUE(st.ok());
+
+    MemPool tuple_pool(_tracker.get());
+    Tuple* tuple = (Tuple*)tuple_pool.allocate(20);
+    bool eof = false;
+    // the lines are longer than the chars split at a time
+    st = scanner.get_next(tuple, &tuple_pool, &eof);
+    ASSERT_TRUE(st.ok());
+    ASSERT_FALSE(eof);
+    ASSERT_EQ(123456789, *(int*)tuple->get_slot(0));
+    ASSERT_EQ(987654321, *(int*)tuple->get_slot(4));
+    ASSERT_EQ(1000000007, *(int*)tuple->get_slot(8));
+
+    st = scanner.get_next(tuple, &tuple_pool, &eof);
+    ASSERT_TRUE(st.ok());
+    ASSERT_FALSE(eof);
+    ASSERT_EQ(2147483647, *(int*)tuple->get_slot(0));
+    ASSERT_EQ(-2147483648, *(int*)tuple->get_slot(4));
+    ASSERT_EQ(0, *(int*)tuple->get_slot(8));
+    // end of file
+    st = scanner.get_next(tuple, &tuple_pool, &eof);
+    ASSERT_TRUE(st.ok());
+    ASSERT_TRUE(eof);
+}
+
 } // end namespace doris
 
 int main(int argc, char** argv) {
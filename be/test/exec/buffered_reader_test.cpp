@@ -19,6 +19,9 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <string>
+
 #include "exec/local_file_reader.h"
 #include "util/stopwatch.hpp"
 
@@ -173,6 +176,42 @@ TEST_F(BufferedReaderTest, test_miss) {
     ASSERT_EQ(45, bytes_read);
 }
 
+TEST_F(BufferedReaderTest, interleaved_reads) {
+    // buffered_reader_test_file 950 bytes
+    LocalFileReader file_reader(
+            "./be/test/exec/test_data/buffered_reader/buffered_reader_test_file", 0);
+    ASSERT_TRUE(file_reader.open().ok());
+    std::string expected(950, '\0');
+    int64_t bytes_read = 0;
+    ASSERT_TRUE(file_reader.readat(0, 950, &bytes_read, &expected[0]).ok());
+    ASSERT_EQ(950, bytes_read);
+
+    LocalFileReader file_reader2(
+            "./be/test/exec/test_data/buffered_reader/buffered_reader_test_file", 0);
+    BufferedReader reader(&file_reader2, 64, 2);
+    ASSERT_TRUE(reader.open().ok());
+    // two streams read 10 bytes at a time in turns, like the column chunks of a
+    // parquet file, each of them is read ahead
+    int64_t pos[2] = {0, 500};
+    while (pos[0] < 500 || pos[1] < 950) {
+        for (int i = 0; i < 2; ++i) {
+            int64_t end = i == 0 ? 500 : 950;
+            if (pos[i] >= end) {
+                continue;
+            }
+            char buf[10];
+            int64_t len = std::min<int64_t>(10, end - pos[i]);
+            ASSERT_TRUE(reader.readat(pos[i], len, &bytes_read, buf).ok());
+            ASSERT_EQ(len, bytes_read);
+            ASSERT_EQ(expected.substr(pos[i], len), std::string(buf, len));
+            pos[i] += len;
+        }
+    }
+    char buf[10];
+    ASSERT_TRUE(reader.readat(950, 10, &bytes_read, buf).ok());
+    ASSERT_EQ(0, bytes_read);
+}
+
 } // end namespace doris
 
 int main(int argc, char** argv) {
@@ -0,0 +1,384 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "exec/cross_join_node.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "common/object_pool.h"
+#include "gen_cpp/Exprs_types.h"
+#include "gen_cpp/PlanNodes_types.h"
+#include "runtime/descriptor_helper.h"
+#include "runtime/descriptors.h"
+#include "runtime/exec_env.h"
+#include "runtime/mem_pool.h"
+#include "runtime/row_batch.h"
+#include "runtime/runtime_state.h"
+#include "runtime/thread_resource_mgr.h"
+#include "runtime/tuple.h"
+#include "runtime/tuple_row.h"
+#include "util/cpu_info.h"
+
+namespace doris {
+
+// stands for NULL in the rows of the tests
+static const int32_t kNull = -1000;
+
+// Returns `rows` in the INT slots of its tuple, kNull for NULL
+class IntRowsNode : public ExecNode {
+public:
+    IntRowsNode(ObjectPool* pool, const TPlanNode& tnode, const DescriptorTbl& descs,
+                const std::vector<std::vector<int32_t>>& rows)
+            : ExecNode(pool, tnode, descs), _rows(rows) {}
+
+    Status get_next(RuntimeState* state, RowBatch* row_batch, bool* eos) override {
+        const TupleDescriptor* tuple_desc = row_desc().tuple_descriptors()[0];
+        while (!row_batch->is_full() && _next < _rows.size()) {
+            Tuple* tuple = reinterpret_cast<Tuple*>(
+                    row_batch->tuple_data_pool()->allocate(tuple_desc->byte_size()));
+            memset(tuple, 0, tuple_desc->byte_size());
+            const std::vector<int32_t>& values = _rows[_next++];
+            for (size_t i = 0; i < values.size(); ++i) {
+                const SlotDescriptor* slot_desc = tuple_desc->slots()[i];
+                if (values[i] == kNull) {
+                    tuple->set_null(slot_desc->null_indicator_offset());
+                } else {
+                    *reinterpret_cast<int32_t*>(tuple->get_slot(slot_desc->tuple_offset())) =
+                            values[i];
+                }
+            }
+            TupleRow* row = row_batch->get_row(row_batch->add_row());
+            row->set_tuple(0, tuple);
+            row_batch->commit_last_row();
+        }
+        *eos = _next == _rows.size();
+        return Status::OK();
+    }
+
+private:
+    std::vector<std::vector<int32_t>> _rows;
+    size_t _next = 0;
+};
+
+// The slots of the left tuple (id, v) and of the build tuple (id, lo, hi)
+enum Slot { LEFT_ID = 0, V = 1, BUILD_ID = 2, LO = 3, HI = 4 };
+
+// A conjunct 'lhs op rhs'
+struct Conjunct {
+    TExprOpcode::type op;
+    Slot lhs;
+    Slot rhs;
+};
+
+// (left id, build id)
+typedef std::vector<std::pair<int32_t, int32_t>> Rows;
+
+class CrossJoinNodeTest : public testing::Test {
+public:
+    static void SetUpTestCase() {
+        ExecEnv* env = ExecEnv::GetInstance();
+        env->_thread_mgr = new ThreadResourceMgr();
+    }
+
+    static void TearDownTestCase() {
+        ExecEnv* env = ExecEnv::GetInstance();
+        SAFE_DELETE(env->_thread_mgr);
+    }
+
+    void SetUp() override {
+        TDescriptorTableBuilder dtb;
+        TTupleDescriptorBuilder left_builder;
+        left_builder.add_slot(int_slot("id", 0));
+        left_builder.add_slot(int_slot("v", 1));
+        left_builder.build(&dtb);
+        TTupleDescriptorBuilder build_builder;
+        build_builder.add_slot(int_slot("id", 0));
+        build_builder.add_slot(int_slot("lo", 1));
+        build_builder.add_slot(int_slot("hi", 2));
+        build_builder.build(&dtb);
+        ASSERT_TRUE(DescriptorTbl::create(&_obj_pool, dtb.desc_tbl(), &_desc_tbl).ok());
+
+        // values of [-5, 100) and some NULLs
+        for (int32_t i = 0; i < 110; ++i) {
+            _left_rows.push_back({i, i % 11 == 10 ? kNull : i - 5});
+        }
+        // the ranges [3 * k, 3 * k + k % 5) of overlapping bounds in no order, and some
+        // NULL bounds
+        for (int32_t i = 0; i < 40; ++i) {
+            int32_t k = (i * 7) % 40;
+            _build_rows.push_back({i, i % 9 == 4 ? kNull : 3 * k,
+                                   i % 13 == 6 ? kNull : 3 * k + k % 5});
+        }
+    }
+
+    void TearDown() override {
+        if (_join != nullptr) {
+            _join->close(_state.get());
+        }
+        _obj_pool.clear();
+        _state.reset();
+    }
+
+    void create_join(const std::vector<Conjunct>& conjuncts) {
+        _conjuncts = conjuncts;
+        TQueryOptions query_options;
+        _state.reset(new RuntimeState(TUniqueId(), query_options, TQueryGlobals(),
+                                      ExecEnv::GetInstance()));
+        ASSERT_TRUE(_state->init_mem_trackers(TUniqueId()).ok());
+        _state->set_desc_tbl(_desc_tbl);
+
+        TPlanNode tnode;
+        tnode.__set_node_id(0);
+        tnode.__set_node_type(TPlanNodeType::CROSS_JOIN_NODE);
+        tnode.__set_num_children(2);
+        tnode.__set_limit(-1);
+        tnode.__set_row_tuples({0, 1});
+        tnode.__set_nullable_tuples({false, false});
+        tnode.__set_compact_data(false);
+        std::vector<TExpr> texprs;
+        for (const Conjunct& conjunct : conjuncts) {
+            texprs.push_back(binary_pred(conjunct));
+        }
+        tnode.__set_conjuncts(texprs);
+
+        _join = _obj_pool.add(new CrossJoinNode(&_obj_pool, tnode, *_desc_tbl));
+        ASSERT_TRUE(_join->init(tnode, _state.get()).ok());
+        _join->_children.push_back(_obj_pool.add(
+                new IntRowsNode(&_obj_pool, rows_plan_node(1, 0), *_desc_tbl, _left_rows)));
+        _join->_children.push_back(_obj_pool.add(
+                new IntRowsNode(&_obj_pool, rows_plan_node(2, 1), *_desc_tbl, _build_rows)));
+        ASSERT_TRUE(_join->prepare(_state.get()).ok());
+        ASSERT_TRUE(_join->open(_state.get()).ok());
+    }
+
+    Status get_rows(Rows* rows) {
+        const SlotDescriptor* left_id = _desc_tbl->get_tuple_descriptor(0)->slots()[0];
+        const SlotDescriptor* build_id = _desc_tbl->get_tuple_descriptor(1)->slots()[0];
+        RowBatch batch(_join->row_desc(), _state->batch_size(),
+                       _state->instance_mem_tracker().get());
+        bool eos = false;
+        while (!eos) {
+            RETURN_IF_ERROR(_join->get_next(_state.get(), &batch, &eos));
+            for (int i = 0; i < batch.num_rows(); ++i) {
+                TupleRow* row = batch.get_row(i);
+                rows->emplace_back(*reinterpret_cast<int32_t*>(row->get_tuple(0)->get_slot(
+                                           left_id->tuple_offset())),
+                                   *reinterpret_cast<int32_t*>(row->get_tuple(1)->get_slot(
+                                           build_id->tuple_offset())));
+            }
+            batch.reset();
+        }
+        std::sort(rows->begin(), rows->end());
+        return Status::OK();
+    }
+
+    // Joins the rows with the conjuncts and checks the result against the nested loop.
+    void check_join(const std::vector<Conjunct>& conjuncts, bool is_range_join = true) {
+        create_join(conjuncts);
+        ASSERT_EQ(is_range_join, _join->_is_range_join);
+        Rows rows;
+        ASSERT_TRUE(get_rows(&rows).ok());
+        Rows expected;
+        for (const auto& left_row : _left_rows) {
+            for (const auto& build_row : _build_rows) {
+                if (matches(left_row, build_row)) {
+                    expected.emplace_back(left_row[0], build_row[0]);
+                }
+            }
+        }
+        ASSERT_FALSE(expected.empty());
+        ASSERT_EQ(expected, rows);
+    }
+
+    bool matches(const std::vector<int32_t>& left_row, const std::vector<int32_t>& build_row) {
+        for (const Conjunct& conjunct : _conjuncts) {
+            int32_t lhs = conjunct.lhs <= V ? left_row[conjunct.lhs]
+                                            : build_row[conjunct.lhs - BUILD_ID];
+            int32_t rhs = conjunct.rhs <= V ? left_row[conjunct.rhs]
+                                            : build_row[conjunct.rhs - BUILD_ID];
+            if (lhs == kNull || rhs == kNull) {
+                return false;
+            }
+            bool match = false;
+            switch (conjunct.op) {
+            case TExprOpcode::LT:
+                match = lhs < rhs;
+                break;
+            case TExprOpcode::LE:
+                match = lhs <= rhs;
+                break;
+            case TExprOpcode::GT:
+                match = lhs > rhs;
+                break;
+            case TExprOpcode::GE:
+                match = lhs >= rhs;
+                break;
+            default:
+                break;
+            }
+            if (!match) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Returns the number of build rows visited for a left row of value 'v'.
+    int64_t num_visited_rows(int32_t v) {
+        const TupleDescriptor* tuple_desc = _desc_tbl->get_tuple_descriptor(0);
+        MemPool pool(_state->instance_mem_tracker().get());
+        Tuple* tuple = reinterpret_cast<Tuple*>(pool.allocate(tuple_desc->byte_size()));
+        memset(tuple, 0, tuple_desc->byte_size());
+        *reinterpret_cast<int32_t*>(tuple->get_slot(tuple_desc->slots()[1]->tuple_offset())) = v;
+        Tuple* tuples[] = {tuple};
+        _join->reset_build_rows(reinterpret_cast<TupleRow*>(tuples));
+        return _join->_range_end - _join->_range_pos;
+    }
+
+    static TSlotDescriptor int_slot(const std::string& name, int pos) {
+        return TSlotDescriptorBuilder()
+                .type(TYPE_INT)
+                .column_name(name)
+                .column_pos(pos)
+                .nullable(true)
+                .build();
+    }
+
+    static TPlanNode rows_plan_node(TPlanNodeId node_id, TTupleId tuple_id) {
+        TPlanNode tnode;
+        tnode.__set_node_id(node_id);
+        tnode.__set_node_type(TPlanNodeType::EMPTY_SET_NODE);
+        tnode.__set_num_children(0);
+        tnode.__set_limit(-1);
+        tnode.__set_row_tuples({tuple_id});
+        tnode.__set_nullable_tuples({false});
+        tnode.__set_compact_data(false);
+        return tnode;
+    }
+
+    static TExprNode slot_ref(Slot slot) {
+        TExprNode node;
+        node.__set_node_type(TExprNodeType::SLOT_REF);
+        node.__set_type(TypeDescriptor(TYPE_INT).to_thrift());
+        node.__set_num_children(0);
+        TSlotRef slot_ref;
+        slot_ref.__set_slot_id(slot);
+        slot_ref.__set_tuple_id(slot <= V ? 0 : 1);
+        node.__set_slot_ref(slot_ref);
+        return node;
+    }
+
+    static TExpr binary_pred(const Conjunct& conjunct) {
+        TExprNode node;
+        node.__set_node_type(TExprNodeType::BINARY_PRED);
+        node.__set_type(TypeDescriptor(TYPE_BOOLEAN).to_thrift());
+        node.__set_num_children(2);
+        node.__set_opcode(conjunct.op);
+        node.__set_child_type(TPrimitiveType::INT);
+        TExpr expr;
+        expr.nodes.push_back(node);
+        expr.nodes.push_back(slot_ref(conjunct.lhs));
+        expr.nodes.push_back(slot_ref(conjunct.rhs));
+        return expr;
+    }
+
+protected:
+    ObjectPool _obj_pool;
+    DescriptorTbl* _desc_tbl = nullptr;
+    std::unique_ptr<RuntimeState> _state;
+    CrossJoinNode* _join = nullptr;
+    std::vector<std::vector<int32_t>> _left_rows;
+    std::vector<std::vector<int32_t>> _build_rows;
+    std::vector<Conjunct> _conjuncts;
+};
+
+TEST_F(CrossJoinNodeTest, lower_bound_lt) {
+    check_join({{TExprOpcode::LT, LO, V}});
+}
+
+TEST_F(CrossJoinNodeTest, lower_bound_le) {
+    check_join({{TExprOpcode::LE, LO, V}});
+}
+
+TEST_F(CrossJoinNodeTest, lower_bound_gt) {
+    check_join({{TExprOpcode::GT, V, LO}});
+}
+
+TEST_F(CrossJoinNodeTest, lower_bound_ge) {
+    check_join({{TExprOpcode::GE, V, LO}});
+}
+
+TEST_F(CrossJoinNodeTest, between) {
+    check_join({{TExprOpcode::GE, V, LO}, {TExprOpcode::LE, V, HI}});
+}
+
+TEST_F(CrossJoinNodeTest, strict_range) {
+    check_join({{TExprOpcode::LT, LO, V}, {TExprOpcode::GT, HI, V}});
+}
+
+TEST_F(CrossJoinNodeTest, upper_bound_only) {
+    // 'v < hi' bounds no build slot from below, so all the build rows are visited
+    check_join({{TExprOpcode::LT, V, HI}}, false);
+}
+
+TEST_F(CrossJoinNodeTest, null_bounds) {
+    // a bound of half of the build rows is NULL, and so are some left values
+    for (size_t i = 0; i < _build_rows.size(); i += 4) {
+        _build_rows[i][1] = kNull;
+        _build_rows[i + 1][2] = kNull;
+    }
+    // the first rows by the lower bound have no upper bound
+    _build_rows[0][1] = 0;
+    _build_rows[0][2] = kNull;
+    check_join({{TExprOpcode::LE, LO, V}, {TExprOpcode::LE, V, HI}});
+}
+
+TEST_F(CrossJoinNodeTest, between_disjoint_ranges) {
+    // the ranges [10 * i, 10 * i + 5] in no order
+    _build_rows.clear();
+    for (int32_t i = 0; i < 40; ++i) {
+        int32_t k = (i * 7) % 40;
+        _build_rows.push_back({i, 10 * k, 10 * k + 5});
+    }
+    _left_rows.clear();
+    for (int32_t i = 0; i < 400; ++i) {
+        _left_rows.push_back({i, i});
+    }
+    check_join({{TExprOpcode::GE, V, LO}, {TExprOpcode::LE, V, HI}});
+
+    // each left row only visits the build rows it may match
+    ASSERT_EQ(1, num_visited_rows(0));
+    ASSERT_EQ(1, num_visited_rows(125));
+    ASSERT_EQ(1, num_visited_rows(395));
+    ASSERT_EQ(0, num_visited_rows(-1));
+    ASSERT_EQ(0, num_visited_rows(127));
+    ASSERT_EQ(0, num_visited_rows(396));
+}
+
+} // namespace doris
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    doris::CpuInfo::init();
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,587 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "exec/hash_join_node.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "common/object_pool.h"
+#include "gen_cpp/PlanNodes_types.h"
+#include "runtime/bufferpool/reservation_tracker.h"
+#include "runtime/descriptor_helper.h"
+#include "runtime/descriptors.h"
+#include "runtime/exec_env.h"
+#include "runtime/initial_reservations.h"
+#include "runtime/row_batch.h"
+#include "runtime/runtime_state.h"
+#include "runtime/shared_hash_table_mgr.h"
+#include "runtime/thread_resource_mgr.h"
+#include "runtime/tuple.h"
+#include "runtime/tuple_row.h"
+#include "util/cpu_info.h"
+
+namespace doris {
+
+// The pages of the spilled partitions
+static const int64_t kPageLen = 8 * 1024;
+// Covers the pages of all the partitions of the tests
+static const int64_t kMinReservation = 128 * kPageLen;
+static const int64_t kBufferPoolLimit = 4 * 1024 * 1024;
+static const int64_t kMemLimit = 8 * 1024 * 1024;
+
+// Returns a row of the INT slot of its tuple for each of `keys`. It consumes `hold_bytes`
+// with the first batch and releases them with the next one, so that the query exceeds its
+// memory limit once when `hold_bytes` is more than the limit.
+class KeysNode : public ExecNode {
+public:
+    KeysNode(ObjectPool* pool, const TPlanNode& tnode, const DescriptorTbl& descs,
+             const std::vector<int32_t>& keys, int64_t hold_bytes)
+            : ExecNode(pool, tnode, descs), _keys(keys), _hold_bytes(hold_bytes) {}
+
+    Status get_next(RuntimeState* state, RowBatch* row_batch, bool* eos) override {
+        if (_held_bytes > 0) {
+            mem_tracker()->Release(_held_bytes);
+            _held_bytes = 0;
+        } else if (_next == 0 && _hold_bytes > 0) {
+            mem_tracker()->Consume(_hold_bytes);
+            _held_bytes = _hold_bytes;
+        }
+        const TupleDescriptor* tuple_desc = row_desc().tuple_descriptors()[0];
+        const SlotDescriptor* slot_desc = tuple_desc->slots()[0];
+        while (!row_batch->is_full() && _next < _keys.size()) {
+            Tuple* tuple = reinterpret_cast<Tuple*>(
+                    row_batch->tuple_data_pool()->allocate(tuple_desc->byte_size()));
+            memset(tuple, 0, tuple_desc->byte_size());
+            *reinterpret_cast<int32_t*>(tuple->get_slot(slot_desc->tuple_offset())) =
+                    _keys[_next++];
+            TupleRow* row = row_batch->get_row(row_batch->add_row());
+            row->set_tuple(0, tuple);
+            row_batch->commit_last_row();
+        }
+        *eos = _next == _keys.size();
+        return Status::OK();
+    }
+
+    Status close(RuntimeState* state) override {
+        if (_held_bytes > 0) {
+            mem_tracker()->Release(_held_bytes);
+            _held_bytes = 0;
+        }
+        return ExecNode::close(state);
+    }
+
+private:
+    std::vector<int32_t> _keys;
+    size_t _next = 0;
+    int64_t _hold_bytes;
+    int64_t _held_bytes = 0;
+};
+
+// The broadcast of the build rows to the instances of a join. Its sender gets past the
+// first batch only once the receivers of the other instances are drained or closed, like
+// a DataStreamSender blocked on the full queue of a receiver.
+struct Broadcast {
+    std::mutex lock;
+    std::condition_variable cv;
+    int num_receivers = 0;
+    int num_closed = 0;
+};
+
+// The exchange receiving the build rows of an instance from `broadcast`
+class BroadcastReceiverNode : public KeysNode {
+public:
+    BroadcastReceiverNode(ObjectPool* pool, const TPlanNode& tnode, const DescriptorTbl& descs,
+                          const std::vector<int32_t>& keys, Broadcast* broadcast)
+            : KeysNode(pool, tnode, descs, keys, 0), _broadcast(broadcast) {}
+
+    Status get_next(RuntimeState* state, RowBatch* row_batch, bool* eos) override {
+        if (!_received) {
+            std::unique_lock<std::mutex> l(_broadcast->lock);
+            if (!_broadcast->cv.wait_for(l, std::chrono::seconds(30), [this]() {
+                    return _broadcast->num_closed >= _broadcast->num_receivers - 1;
+                })) {
+                return Status::TimedOut("the broadcast is blocked by the other receivers");
+            }
+            _received = true;
+        }
+        return KeysNode::get_next(state, row_batch, eos);
+    }
+
+    Status close(RuntimeState* state) override {
+        if (!_closed) {
+            _closed = true;
+            std::lock_guard<std::mutex> l(_broadcast->lock);
+            ++_broadcast->num_closed;
+            _broadcast->cv.notify_all();
+        }
+        return KeysNode::close(state);
+    }
+
+private:
+    Broadcast* _broadcast;
+    bool _received = false;
+    bool _closed = false;
+};
+
+// (probe key, build key), the build key is -1 if there's no build row
+typedef std::vector<std::pair<int32_t, int32_t>> Rows;
+
+class HashJoinNodeTest : public testing::Test {
+public:
+    static void SetUpTestCase() {
+        ExecEnv* env = ExecEnv::GetInstance();
+        env->_thread_mgr = new ThreadResourceMgr();
+        env->_shared_hash_table_mgr = new SharedHashTableMgr();
+        env->_init_buffer_pool(config::min_buffer_size, 2 * kBufferPoolLimit,
+                               2 * kBufferPoolLimit);
+    }
+
+    static void TearDownTestCase() {
+        ExecEnv* env = ExecEnv::GetInstance();
+        SAFE_DELETE(env->_buffer_pool);
+        env->_buffer_reservation->Close();
+        SAFE_DELETE(env->_buffer_reservation);
+        SAFE_DELETE(env->_shared_hash_table_mgr);
+        SAFE_DELETE(env->_thread_mgr);
+    }
+
+    void SetUp() override {
+        // tuple 0 of the probe side and tuple 1 of the build side, both (k int)
+        TDescriptorTableBuilder dtb;
+        for (int i = 0; i < 2; ++i) {
+            TTupleDescriptorBuilder tuple_builder;
+            tuple_builder.add_slot(TSlotDescriptorBuilder()
+                                           .type(TYPE_INT)
+                                           .column_name("k")
+                                           .column_pos(0)
+                                           .nullable(false)
+                                           .build());
+            tuple_builder.build(&dtb);
+        }
+        ASSERT_TRUE(DescriptorTbl::create(&_obj_pool, dtb.desc_tbl(), &_desc_tbl).ok());
+    }
+
+    void TearDown() override {
+        if (_join != nullptr) {
+            _join->close(_state.get());
+        }
+        _obj_pool.clear();
+        _state.reset();
+    }
+
+    // Create the join of `probe_keys` and `build_keys` on the key, the query of which
+    // has `min_reservation` of initial reservations. If `spill`, the build side holds more
+    // memory than the query limit with its first batch.
+    void create_join(TJoinOp::type join_op, const std::vector<int32_t>& probe_keys,
+                     const std::vector<int32_t>& build_keys, int64_t min_reservation,
+                     bool spill = true) {
+        _state.reset(create_state(min_reservation));
+        ASSERT_TRUE(_state != nullptr);
+        TPlanNode tnode = join_plan_node(join_op, min_reservation);
+        _join = _obj_pool.add(new HashJoinNode(&_obj_pool, tnode, *_desc_tbl));
+        ASSERT_TRUE(_join->init(tnode, _state.get()).ok());
+        _join->_children.push_back(
+                _obj_pool.add(new KeysNode(&_obj_pool, keys_plan_node(1, 0), *_desc_tbl,
+                                           probe_keys, 0)));
+        _join->_children.push_back(
+                _obj_pool.add(new KeysNode(&_obj_pool, keys_plan_node(2, 1), *_desc_tbl,
+                                           build_keys, spill ? 2 * kMemLimit : 0)));
+        ASSERT_TRUE(_join->prepare(_state.get()).ok());
+    }
+
+    // Returns the state of an instance of the query, whose instances all have the same
+    // query id.
+    RuntimeState* create_state(int64_t min_reservation) {
+        TQueryOptions query_options;
+        query_options.__set_enable_spilling(true);
+        query_options.__set_mem_limit(kMemLimit);
+        query_options.__set_buffer_pool_limit(kBufferPoolLimit);
+        query_options.__set_initial_reservation_total_claims(min_reservation);
+        std::unique_ptr<RuntimeState> state(new RuntimeState(
+                TUniqueId(), query_options, TQueryGlobals(), ExecEnv::GetInstance()));
+        if (!state->init_mem_trackers(TUniqueId()).ok() ||
+            !state->initial_reservations()->Init(TUniqueId(), min_reservation).ok()) {
+            return nullptr;
+        }
+        state->set_desc_tbl(_desc_tbl);
+        return state.release();
+    }
+
+    TPlanNode join_plan_node(TJoinOp::type join_op, int64_t min_reservation) {
+        TPlanNode tnode;
+        tnode.__set_node_id(0);
+        tnode.__set_node_type(TPlanNodeType::HASH_JOIN_NODE);
+        tnode.__set_num_children(2);
+        tnode.__set_limit(-1);
+        tnode.__set_row_tuples({0, 1});
+        tnode.__set_nullable_tuples({join_op == TJoinOp::FULL_OUTER_JOIN,
+                                     join_op == TJoinOp::LEFT_OUTER_JOIN ||
+                                             join_op == TJoinOp::FULL_OUTER_JOIN});
+        tnode.__set_compact_data(false);
+        TEqJoinCondition eq_join_conjunct;
+        eq_join_conjunct.__set_left(slot_ref(0, 0));
+        eq_join_conjunct.__set_right(slot_ref(1, 1));
+        THashJoinNode hash_join_node;
+        hash_join_node.__set_join_op(join_op);
+        hash_join_node.__set_eq_join_conjuncts({eq_join_conjunct});
+        hash_join_node.__set_is_push_down(false);
+        tnode.__set_hash_join_node(hash_join_node);
+        TBackendResourceProfile resource_profile;
+        resource_profile.__set_min_reservation(min_reservation);
+        resource_profile.__set_spillable_buffer_size(kPageLen);
+        resource_profile.__set_max_row_buffer_size(kPageLen);
+        tnode.__set_resource_profile(resource_profile);
+        return tnode;
+    }
+
+    Status get_rows(Rows* rows) { return get_rows(_join, _state.get(), rows); }
+
+    Status get_rows(HashJoinNode* join, RuntimeState* state, Rows* rows) {
+        const SlotDescriptor* probe_slot = _desc_tbl->get_tuple_descriptor(0)->slots()[0];
+        const SlotDescriptor* build_slot = _desc_tbl->get_tuple_descriptor(1)->slots()[0];
+        RowBatch batch(join->row_desc(), state->batch_size(),
+                       state->instance_mem_tracker().get());
+        bool eos = false;
+        while (!eos) {
+            RETURN_IF_ERROR(join->get_next(state, &batch, &eos));
+            for (int i = 0; i < batch.num_rows(); ++i) {
+                TupleRow* row = batch.get_row(i);
+                Tuple* build_tuple = row->get_tuple(1);
+                rows->emplace_back(
+                        *reinterpret_cast<int32_t*>(
+                                row->get_tuple(0)->get_slot(probe_slot->tuple_offset())),
+                        build_tuple == nullptr
+                                ? -1
+                                : *reinterpret_cast<int32_t*>(
+                                          build_tuple->get_slot(build_slot->tuple_offset())));
+            }
+            batch.reset();
+        }
+        std::sort(rows->begin(), rows->end());
+        return Status::OK();
+    }
+
+    static std::vector<int32_t> keys(int32_t begin, int32_t end, int times) {
+        std::vector<int32_t> keys;
+        for (int i = 0; i < times; ++i) {
+            for (int32_t key = begin; key < end; ++key) {
+                keys.push_back(key);
+            }
+        }
+        return keys;
+    }
+
+    static TPlanNode keys_plan_node(TPlanNodeId node_id, TTupleId tuple_id,
+                                    TPlanNodeType::type node_type = TPlanNodeType::EMPTY_SET_NODE) {
+        TPlanNode tnode;
+        tnode.__set_node_id(node_id);
+        tnode.__set_node_type(node_type);
+        tnode.__set_num_children(0);
+        tnode.__set_limit(-1);
+        tnode.__set_row_tuples({tuple_id});
+        tnode.__set_nullable_tuples({false});
+        tnode.__set_compact_data(false);
+        return tnode;
+    }
+
+    static TExpr slot_ref(TSlotId slot_id, TTupleId tuple_id) {
+        TExprNode node;
+        node.__set_node_type(TExprNodeType::SLOT_REF);
+        node.__set_type(TypeDescriptor(TYPE_INT).to_thrift());
+        node.__set_num_children(0);
+        TSlotRef slot_ref;
+        slot_ref.__set_slot_id(slot_id);
+        slot_ref.__set_tuple_id(tuple_id);
+        node.__set_slot_ref(slot_ref);
+        TExpr expr;
+        expr.nodes.push_back(node);
+        return expr;
+    }
+
+protected:
+    ObjectPool _obj_pool;
+    DescriptorTbl* _desc_tbl = nullptr;
+    std::unique_ptr<RuntimeState> _state;
+    HashJoinNode* _join = nullptr;
+};
+
+static const int32_t kNumBuildKeys = 20000;
+
+TEST_F(HashJoinNodeTest, spill_inner_join) {
+    create_join(TJoinOp::INNER_JOIN, keys(0, 2 * kNumBuildKeys, 1), keys(0, kNumBuildKeys, 1),
+                kMinReservation);
+    ASSERT_TRUE(_join->open(_state.get()).ok());
+    ASSERT_TRUE(_join->_spilled);
+    ASSERT_EQ(static_cast<int64_t>(HashJoinNode::PARTITION_FANOUT),
+              _join->_spilled_partitions_counter->value());
+    ASSERT_EQ(kNumBuildKeys, _join->_build_rows_counter->value());
+
+    Rows rows;
+    ASSERT_TRUE(get_rows(&rows).ok());
+    Rows expected;
+    for (int32_t key = 0; key < kNumBuildKeys; ++key) {
+        expected.emplace_back(key, key);
+    }
+    ASSERT_EQ(expected, rows);
+    ASSERT_EQ(0, _join->_num_repartitions_counter->value());
+}
+
+TEST_F(HashJoinNodeTest, spill_left_outer_join) {
+    // every build key twice, half of the probe keys have no build row
+    create_join(TJoinOp::LEFT_OUTER_JOIN, keys(0, 2 * kNumBuildKeys, 1),
+                keys(0, kNumBuildKeys, 2), kMinReservation);
+    ASSERT_TRUE(_join->open(_state.get()).ok());
+    ASSERT_TRUE(_join->_spilled);
+
+    Rows rows;
+    ASSERT_TRUE(get_rows(&rows).ok());
+    Rows expected;
+    for (int32_t key = 0; key < 2 * kNumBuildKeys; ++key) {
+        if (key < kNumBuildKeys) {
+            expected.emplace_back(key, key);
+            expected.emplace_back(key, key);
+        } else {
+            expected.emplace_back(key, -1);
+        }
+    }
+    ASSERT_EQ(expected, rows);
+}
+
+TEST_F(HashJoinNodeTest, repartition) {
+    create_join(TJoinOp::INNER_JOIN, keys(0, kNumBuildKeys, 1), keys(0, kNumBuildKeys, 1),
+                kMinReservation);
+    ASSERT_TRUE(_join->open(_state.get()).ok());
+    ASSERT_TRUE(_join->_spilled);
+
+    // partition the next partition again, as if its build rows couldn't be pinned
+    std::unique_ptr<HashJoinNode::Partition> partition =
+            std::move(_join->_spilled_partitions.front());
+    _join->_spilled_partitions.pop_front();
+    int64_t num_build_rows = partition->build_rows->num_rows();
+    int64_t num_probe_rows = partition->probe_rows->num_rows();
+    ASSERT_TRUE(_join->_repartition(_state.get(), partition.get()).ok());
+    _join->_close_partition(partition.get(), nullptr);
+    ASSERT_EQ(1, _join->_num_repartitions_counter->value());
+
+    int64_t num_repartitioned_build_rows = 0;
+    int64_t num_repartitioned_probe_rows = 0;
+    for (int i = 0; i < HashJoinNode::PARTITION_FANOUT; ++i) {
+        HashJoinNode::Partition* repartitioned = _join->_spilled_partitions[i].get();
+        ASSERT_EQ(1, repartitioned->level);
+        num_repartitioned_build_rows += repartitioned->build_rows->num_rows();
+        num_repartitioned_probe_rows += repartitioned->probe_rows->num_rows();
+    }
+    ASSERT_EQ(num_build_rows, num_repartitioned_build_rows);
+    ASSERT_EQ(num_probe_rows, num_repartitioned_probe_rows);
+
+    // the rows of the repartitioned partition are still joined
+    Rows rows;
+    ASSERT_TRUE(get_rows(&rows).ok());
+    Rows expected;
+    for (int32_t key = 0; key < kNumBuildKeys; ++key) {
+        expected.emplace_back(key, key);
+    }
+    ASSERT_EQ(expected, rows);
+}
+
+TEST_F(HashJoinNodeTest, repartition_too_deep) {
+    create_join(TJoinOp::INNER_JOIN, keys(0, kNumBuildKeys, 1), keys(0, kNumBuildKeys, 1),
+                kMinReservation);
+    ASSERT_TRUE(_join->open(_state.get()).ok());
+
+    std::unique_ptr<HashJoinNode::Partition> partition =
+            std::move(_join->_spilled_partitions.front());
+    _join->_spilled_partitions.pop_front();
+    partition->level = HashJoinNode::MAX_PARTITION_DEPTH - 1;
+    Status st = _join->_repartition(_state.get(), partition.get());
+    ASSERT_TRUE(st.is_mem_limit_exceeded()) << st.to_string();
+    _join->_close_partition(partition.get(), nullptr);
+    ASSERT_EQ(0, _join->_num_repartitions_counter->value());
+
+    // the partitions left and the pinned one are released on close
+    ASSERT_NE(nullptr, _join->_input_partition);
+    ASSERT_FALSE(_join->_spilled_partitions.empty());
+    ASSERT_TRUE(_join->close(_state.get()).ok());
+    ASSERT_EQ(nullptr, _join->_input_partition);
+    ASSERT_TRUE(_join->_spilled_partitions.empty());
+    ASSERT_FALSE(_join->_buffer_pool_client.is_registered());
+}
+
+TEST_F(HashJoinNodeTest, spill_without_reservation) {
+    // the query is over its limit, there's no buffer to partition the build rows into
+    create_join(TJoinOp::INNER_JOIN, keys(0, kNumBuildKeys, 1), keys(0, kNumBuildKeys, 1), 0);
+    Status st = _join->open(_state.get());
+    ASSERT_TRUE(st.is_mem_limit_exceeded()) << st.to_string();
+    ASSERT_TRUE(_join->_spilled_partitions.empty());
+
+    ASSERT_TRUE(_join->close(_state.get()).ok());
+    ASSERT_TRUE(_join->_hash_partitions.empty());
+    ASSERT_FALSE(_join->_buffer_pool_client.is_registered());
+}
+
+TEST_F(HashJoinNodeTest, no_spill_for_full_outer_join) {
+    // the unmatched build rows need the whole build side
+    create_join(TJoinOp::FULL_OUTER_JOIN, keys(0, kNumBuildKeys, 1), keys(0, kNumBuildKeys, 1),
+                kMinReservation);
+    Status st = _join->open(_state.get());
+    ASSERT_TRUE(st.is_mem_limit_exceeded()) << st.to_string();
+    ASSERT_FALSE(_join->_spilled);
+}
+
+TEST_F(HashJoinNodeTest, direct_map_inner_join) {
+    // every key of [100, 200) twice, probed by keys below, in and above the range
+    create_join(TJoinOp::INNER_JOIN, keys(0, 300, 1), keys(100, 200, 2), kMinReservation,
+                false);
+    ASSERT_TRUE(_join->open(_state.get()).ok());
+    ASSERT_FALSE(_join->_spilled);
+    ASSERT_NE(nullptr, _join->_hash_tbl->_direct_map);
+    ASSERT_EQ(100, _join->_hash_tbl->_direct_map_size);
+    ASSERT_NE(std::string::npos, _join->_runtime_exec_options.find("Direct Mapped Join Keys"));
+
+    Rows rows;
+    ASSERT_TRUE(get_rows(&rows).ok());
+    Rows expected;
+    for (int32_t key = 100; key < 200; ++key) {
+        expected.emplace_back(key, key);
+        expected.emplace_back(key, key);
+    }
+    ASSERT_EQ(expected, rows);
+}
+
+TEST_F(HashJoinNodeTest, direct_map_left_outer_join) {
+    // the keys fill half of their range
+    std::vector<int32_t> build_keys;
+    for (int32_t key = -100; key < 100; key += 2) {
+        build_keys.push_back(key);
+    }
+    create_join(TJoinOp::LEFT_OUTER_JOIN, keys(-200, 200, 1), build_keys, kMinReservation,
+                false);
+    ASSERT_TRUE(_join->open(_state.get()).ok());
+    ASSERT_NE(nullptr, _join->_hash_tbl->_direct_map);
+
+    Rows rows;
+    ASSERT_TRUE(get_rows(&rows).ok());
+    Rows expected;
+    for (int32_t key = -200; key < 200; ++key) {
+        bool matched = key >= -100 && key < 100 && key % 2 == 0;
+        expected.emplace_back(key, matched ? key : -1);
+    }
+    ASSERT_EQ(expected, rows);
+}
+
+TEST_F(HashJoinNodeTest, no_direct_map_for_sparse_keys) {
+    std::vector<int32_t> build_keys;
+    for (int32_t key = 0; key < 1000; key += 10) {
+        build_keys.push_back(key);
+    }
+    create_join(TJoinOp::INNER_JOIN, keys(0, 1000, 1), build_keys, kMinReservation, false);
+    ASSERT_TRUE(_join->open(_state.get()).ok());
+    ASSERT_EQ(nullptr, _join->_hash_tbl->_direct_map);
+    ASSERT_EQ(std::string::npos, _join->_runtime_exec_options.find("Direct Mapped Join Keys"));
+
+    Rows rows;
+    ASSERT_TRUE(get_rows(&rows).ok());
+    Rows expected;
+    for (int32_t key : build_keys) {
+        expected.emplace_back(key, key);
+    }
+    ASSERT_EQ(expected, rows);
+}
+
+TEST_F(HashJoinNodeTest, shared_broadcast_hash_table) {
+    // the instances of a broadcast join on a backend, each opened in its own fragment thread
+    const int num_instances = 4;
+    Broadcast broadcast;
+    broadcast.num_receivers = num_instances;
+    std::vector<std::unique_ptr<RuntimeState>> states;
+    std::vector<HashJoinNode*> joins;
+    for (int i = 0; i < num_instances; ++i) {
+        states.emplace_back(create_state(kMinReservation));
+        ASSERT_TRUE(states.back() != nullptr);
+        TPlanNode tnode = join_plan_node(TJoinOp::INNER_JOIN, kMinReservation);
+        tnode.hash_join_node.__set_is_broadcast_join(true);
+        HashJoinNode* join = _obj_pool.add(new HashJoinNode(&_obj_pool, tnode, *_desc_tbl));
+        ASSERT_TRUE(join->init(tnode, states[i].get()).ok());
+        join->_children.push_back(_obj_pool.add(new KeysNode(
+                &_obj_pool, keys_plan_node(1, 0), *_desc_tbl, keys(0, 2000, 1), 0)));
+        join->_children.push_back(_obj_pool.add(new BroadcastReceiverNode(
+                &_obj_pool, keys_plan_node(2, 1, TPlanNodeType::EXCHANGE_NODE), *_desc_tbl,
+                keys(0, 1000, 2), &broadcast)));
+        ASSERT_TRUE(join->prepare(states[i].get()).ok());
+        ASSERT_NE(nullptr, join->_shared_hash_table);
+        joins.push_back(join);
+    }
+
+    std::vector<Status> statuses(num_instances);
+    std::vector<Rows> rows(num_instances);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < num_instances; ++i) {
+        threads.emplace_back([&, i]() {
+            statuses[i] = joins[i]->open(states[i].get());
+            if (statuses[i].ok()) {
+                statuses[i] = get_rows(joins[i], states[i].get(), &rows[i]);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    Rows expected;
+    for (int32_t key = 0; key < 1000; ++key) {
+        expected.emplace_back(key, key);
+        expected.emplace_back(key, key);
+    }
+    int num_shared = 0;
+    for (int i = 0; i < num_instances; ++i) {
+        ASSERT_TRUE(statuses[i].ok()) << statuses[i].to_string();
+        ASSERT_EQ(expected, rows[i]);
+        ASSERT_EQ(2000, joins[i]->_build_rows_counter->value());
+        if (joins[i]->_runtime_exec_options.find("Shared Broadcast Hash Table") !=
+            std::string::npos) {
+            ++num_shared;
+        }
+    }
+    // one instance built the table, the others waited with their build side closed
+    ASSERT_EQ(num_instances - 1, num_shared);
+    ASSERT_EQ(num_instances, broadcast.num_closed);
+
+    for (int i = 0; i < num_instances; ++i) {
+        ASSERT_TRUE(joins[i]->close(states[i].get()).ok());
+    }
+    ASSERT_TRUE(ExecEnv::GetInstance()->shared_hash_table_mgr()->_tables.empty());
+}
+
+} // namespace doris
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    doris::CpuInfo::init();
+    return RUN_ALL_TESTS();
+}
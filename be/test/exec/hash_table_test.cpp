@@ -211,17 +211,17 @@ TEST_F(HashTableTest, BasicTest) {
     full_scan(&hash_table, 0, 5, true, scan_rows, build_rows);
     probe_test(&hash_table, probe_rows, 10, false);
 
-    // Resize to two and cause some collisions
+    // Resize to two, which can't hold 5 keys and is rounded up
     resize_table(&hash_table, 2);
-    EXPECT_EQ(hash_table.num_buckets(), 2);
+    EXPECT_EQ(hash_table.num_buckets(), 8);
     EXPECT_EQ(hash_table.size(), 5);
     memset(scan_rows, 0, sizeof(scan_rows));
     full_scan(&hash_table, 0, 5, true, scan_rows, build_rows);
     probe_test(&hash_table, probe_rows, 10, false);
 
-    // Resize to one and turn it into a linked list
+    // Resize to one, which is rounded up too
     resize_table(&hash_table, 1);
-    EXPECT_EQ(hash_table.num_buckets(), 1);
+    EXPECT_EQ(hash_table.num_buckets(), 8);
     EXPECT_EQ(hash_table.size(), 5);
     memset(scan_rows, 0, sizeof(scan_rows));
     full_scan(&hash_table, 0, 5, true, scan_rows, build_rows);
@@ -264,8 +264,9 @@ TEST_F(HashTableTest, ScanTest) {
     EXPECT_EQ(hash_table.num_buckets(), 16);
     probe_test(&hash_table, probe_rows, 15, true);
 
+    // 10 keys don't fit in 2 buckets
     resize_table(&hash_table, 2);
-    EXPECT_EQ(hash_table.num_buckets(), 2);
+    EXPECT_EQ(hash_table.num_buckets(), 16);
     probe_test(&hash_table, probe_rows, 15, true);
 }
 
@@ -0,0 +1,342 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <orc/OrcFile.hh>
+#include <string>
+#include <vector>
+
+#include "common/config.h"
+#include "common/object_pool.h"
+#include "exec/orc_scanner.h"
+#include "exprs/cast_functions.h"
+#include "exprs/expr.h"
+#include "exprs/expr_context.h"
+#include "gen_cpp/Descriptors_types.h"
+#include "gen_cpp/PlanNodes_types.h"
+#include "runtime/descriptor_helper.h"
+#include "runtime/descriptors.h"
+#include "runtime/mem_pool.h"
+#include "runtime/mem_tracker.h"
+#include "runtime/runtime_state.h"
+#include "runtime/tuple.h"
+#include "runtime/user_function_cache.h"
+#include "util/cpu_info.h"
+#include "util/file_utils.h"
+
+namespace doris {
+
+static const std::string kFile = "./be/test/exec/test_data/orc_stripe_filter_test.orc";
+static const int kNumStripes = 10;
+static const int kRowsPerStripe = 100;
+
+// the slots of the src tuple (k1, k2, k3 varchar) and of the dest tuple
+// (k1 int, k2 varchar, k3 int null)
+static const int kSrcK1 = 0;
+static const int kDestK1 = 3;
+static const int kDestK2 = 4;
+static const int kDestK3 = 5;
+
+class OrcStripeFilterTest : public testing::Test {
+public:
+    OrcStripeFilterTest() : _runtime_state(TQueryGlobals()) {
+        _profile = _runtime_state.runtime_profile();
+        _runtime_state._instance_mem_tracker.reset(new MemTracker());
+    }
+
+    // Writes the stripes of (k1 int, k2 string, k3 int), where row i has k1 = i and
+    // k2 = "key%04d" of i, and k3 = i from the stripe kNumStripes / 2 on, NULL before.
+    static void SetUpTestCase() {
+        UserFunctionCache::instance()->init(
+                "./be/test/runtime/test_data/user_function_cache/normal");
+        CastFunctions::init();
+
+        std::unique_ptr<orc::OutputStream> out = orc::writeLocalFile(kFile);
+        std::unique_ptr<orc::Type> type(
+                orc::Type::buildTypeFromString("struct<k1:int,k2:string,k3:int>"));
+        orc::WriterOptions options;
+        // every batch fills a stripe
+        options.setStripeSize(1);
+        std::unique_ptr<orc::Writer> writer = orc::createWriter(*type, out.get(), options);
+        std::unique_ptr<orc::ColumnVectorBatch> batch = writer->createRowBatch(kRowsPerStripe);
+        auto& root = dynamic_cast<orc::StructVectorBatch&>(*batch);
+        auto& k1 = dynamic_cast<orc::LongVectorBatch&>(*root.fields[0]);
+        auto& k2 = dynamic_cast<orc::StringVectorBatch&>(*root.fields[1]);
+        auto& k3 = dynamic_cast<orc::LongVectorBatch&>(*root.fields[2]);
+        std::vector<char> keys(kRowsPerStripe * 8);
+        for (int stripe = 0; stripe < kNumStripes; ++stripe) {
+            for (int j = 0; j < kRowsPerStripe; ++j) {
+                int i = stripe * kRowsPerStripe + j;
+                char key[16];
+                snprintf(key, sizeof(key), "key%04d", i);
+                memcpy(&keys[j * 7], key, 7);
+                k1.data[j] = i;
+                k2.data[j] = &keys[j * 7];
+                k2.length[j] = 7;
+                k3.data[j] = i;
+                k3.notNull[j] = stripe >= kNumStripes / 2;
+            }
+            k3.hasNulls = stripe < kNumStripes / 2;
+            root.numElements = k1.numElements = k2.numElements = k3.numElements =
+                    kRowsPerStripe;
+            writer->add(*batch);
+        }
+        writer->close();
+
+        std::unique_ptr<orc::Reader> reader =
+                orc::createReader(orc::readLocalFile(kFile), orc::ReaderOptions());
+        ASSERT_EQ(kNumStripes, static_cast<int>(reader->getNumberOfStripes()));
+    }
+
+    static void TearDownTestCase() { FileUtils::remove(kFile); }
+
+    void SetUp() override {
+        TDescriptorTableBuilder dtb;
+        TTupleDescriptorBuilder src_tuple_builder;
+        for (int i = 0; i < 3; ++i) {
+            src_tuple_builder.add_slot(TSlotDescriptorBuilder()
+                                               .string_type(64)
+                                               .nullable(true)
+                                               .column_name("k" + std::to_string(i + 1))
+                                               .column_pos(i)
+                                               .build());
+        }
+        src_tuple_builder.build(&dtb);
+        TTupleDescriptorBuilder dest_tuple_builder;
+        dest_tuple_builder.add_slot(
+                TSlotDescriptorBuilder().type(TYPE_INT).column_name("k1").column_pos(0).build());
+        dest_tuple_builder.add_slot(
+                TSlotDescriptorBuilder().string_type(64).column_name("k2").column_pos(1).build());
+        dest_tuple_builder.add_slot(TSlotDescriptorBuilder()
+                                            .type(TYPE_INT)
+                                            .nullable(true)
+                                            .column_name("k3")
+                                            .column_pos(2)
+                                            .build());
+        dest_tuple_builder.build(&dtb);
+        ASSERT_TRUE(DescriptorTbl::create(&_obj_pool, dtb.desc_tbl(), &_desc_tbl).ok());
+        _runtime_state.set_desc_tbl(_desc_tbl);
+        _mem_pool.reset(new MemPool(_mem_tracker.get()));
+
+        // k1 and k3 are cast to int, k2 is loaded as it is
+        for (int i = 0; i < 3; ++i) {
+            TExpr expr;
+            if (i != 1) {
+                expr.nodes.push_back(cast_to_int_node());
+            }
+            expr.nodes.push_back(slot_ref_node(TPrimitiveType::VARCHAR, kSrcK1 + i, 0));
+            _params.expr_of_dest_slot.emplace(kDestK1 + i, expr);
+            _params.src_slot_ids.push_back(kSrcK1 + i);
+            _params.dest_sid_to_src_sid_without_trans.emplace(kDestK1 + i, kSrcK1 + i);
+        }
+        _params.__isset.dest_sid_to_src_sid_without_trans = true;
+        _params.__set_src_tuple_id(0);
+        _params.__set_dest_tuple_id(1);
+    }
+
+    static TTypeDesc type_desc(TPrimitiveType::type type) {
+        TScalarType scalar_type;
+        scalar_type.__set_type(type);
+        if (type == TPrimitiveType::VARCHAR) {
+            scalar_type.__set_len(64);
+        }
+        TTypeNode node;
+        node.__set_type(TTypeNodeType::SCALAR);
+        node.__set_scalar_type(scalar_type);
+        TTypeDesc type_desc;
+        type_desc.types.push_back(node);
+        return type_desc;
+    }
+
+    static TExprNode cast_to_int_node() {
+        TExprNode node;
+        node.node_type = TExprNodeType::CAST_EXPR;
+        node.type = type_desc(TPrimitiveType::INT);
+        node.__set_opcode(TExprOpcode::CAST);
+        node.__set_num_children(1);
+        node.__set_output_scale(-1);
+        node.__isset.fn = true;
+        node.fn.name.function_name = "casttoint";
+        node.fn.binary_type = TFunctionBinaryType::BUILTIN;
+        node.fn.arg_types.push_back(type_desc(TPrimitiveType::VARCHAR));
+        node.fn.ret_type = type_desc(TPrimitiveType::INT);
+        node.fn.has_var_args = false;
+        node.fn.__set_signature("casttoint(VARCHAR(*))");
+        node.fn.__isset.scalar_fn = true;
+        node.fn.scalar_fn.symbol = "doris::CastFunctions::cast_to_int_val";
+        return node;
+    }
+
+    static TExprNode slot_ref_node(TPrimitiveType::type type, int slot_id, int tuple_id) {
+        TExprNode node;
+        node.node_type = TExprNodeType::SLOT_REF;
+        node.type = type_desc(type);
+        node.num_children = 0;
+        node.__isset.slot_ref = true;
+        node.slot_ref.slot_id = slot_id;
+        node.slot_ref.tuple_id = tuple_id;
+        return node;
+    }
+
+    // Adds the conjunct 'dest_slot op value' on the int dest slot 'dest_slot'.
+    void add_int_conjunct(int dest_slot, TExprOpcode::type op, int64_t value) {
+        TExprNode value_node;
+        value_node.node_type = TExprNodeType::INT_LITERAL;
+        value_node.type = type_desc(TPrimitiveType::INT);
+        value_node.num_children = 0;
+        value_node.__isset.int_literal = true;
+        value_node.int_literal.value = value;
+        add_conjunct(op, TPrimitiveType::INT, slot_ref_node(TPrimitiveType::INT, dest_slot, 1),
+                     value_node);
+    }
+
+    void add_conjunct(TExprOpcode::type op, TPrimitiveType::type child_type,
+                      const TExprNode& slot_ref, const TExprNode& value) {
+        TExprNode pred;
+        pred.node_type = TExprNodeType::BINARY_PRED;
+        pred.type = type_desc(TPrimitiveType::BOOLEAN);
+        pred.num_children = 2;
+        pred.__set_opcode(op);
+        pred.__set_child_type(child_type);
+        TExpr expr;
+        expr.nodes.push_back(pred);
+        expr.nodes.push_back(slot_ref);
+        expr.nodes.push_back(value);
+
+        ExprContext* ctx = nullptr;
+        ASSERT_TRUE(Expr::create_expr_tree(&_obj_pool, expr, &ctx).ok());
+        RowDescriptor row_desc(*_desc_tbl, {1}, {false});
+        ASSERT_TRUE(ctx->prepare(&_runtime_state, row_desc, _mem_tracker).ok());
+        ASSERT_TRUE(ctx->open(&_runtime_state).ok());
+        _conjunct_ctxs.push_back(ctx);
+    }
+
+    // Reads the k1 of the rows of the stripes that aren't skipped by the conjuncts.
+    Status read(std::vector<int>* keys, int* stripes_skipped) {
+        TBrokerRangeDesc range;
+        range.start_offset = 0;
+        range.size = -1;
+        range.format_type = TFileFormatType::FORMAT_ORC;
+        range.splittable = false;
+        range.path = kFile;
+        range.file_type = TFileType::FILE_LOCAL;
+        ORCScanner scanner(&_runtime_state, _profile, _params, {range}, _addresses, &_counter,
+                           _conjunct_ctxs);
+        RETURN_IF_ERROR(scanner.open());
+
+        const TupleDescriptor* tuple_desc = _desc_tbl->get_tuple_descriptor(1);
+        const SlotDescriptor* k1_slot = tuple_desc->slots()[0];
+        Tuple* tuple = reinterpret_cast<Tuple*>(_mem_pool->allocate(tuple_desc->byte_size()));
+        bool eof = false;
+        while (true) {
+            RETURN_IF_ERROR(scanner.get_next(tuple, _mem_pool.get(), &eof));
+            if (eof) {
+                break;
+            }
+            keys->push_back(*reinterpret_cast<int32_t*>(tuple->get_slot(k1_slot->tuple_offset())));
+        }
+        scanner.close();
+        *stripes_skipped = _profile->get_counter("StripesSkipped")->value();
+        return Status::OK();
+    }
+
+    // Checks that the conjuncts read exactly the stripes [begin, end).
+    void check_stripes(int begin, int end) {
+        std::vector<int> keys;
+        int stripes_skipped = 0;
+        ASSERT_TRUE(read(&keys, &stripes_skipped).ok());
+        ASSERT_EQ(kNumStripes - (end - begin), stripes_skipped);
+        ASSERT_EQ(stripes_skipped * kRowsPerStripe, _counter.num_rows_unselected);
+        ASSERT_EQ((end - begin) * kRowsPerStripe, static_cast<int>(keys.size()));
+        for (int i = 0; i < static_cast<int>(keys.size()); ++i) {
+            ASSERT_EQ(begin * kRowsPerStripe + i, keys[i]);
+        }
+    }
+
+protected:
+    RuntimeState _runtime_state;
+    RuntimeProfile* _profile;
+    ObjectPool _obj_pool;
+    DescriptorTbl* _desc_tbl = nullptr;
+    std::shared_ptr<MemTracker> _mem_tracker = MemTracker::CreateTracker(-1);
+    std::unique_ptr<MemPool> _mem_pool;
+    TBrokerScanRangeParams _params;
+    std::vector<TNetworkAddress> _addresses;
+    ScannerCounter _counter;
+    std::vector<ExprContext*> _conjunct_ctxs;
+};
+
+TEST_F(OrcStripeFilterTest, no_conjuncts) {
+    check_stripes(0, kNumStripes);
+}
+
+TEST_F(OrcStripeFilterTest, skip_by_int_range) {
+    add_int_conjunct(kDestK1, TExprOpcode::GE, 250);
+    add_int_conjunct(kDestK1, TExprOpcode::LT, 520);
+    check_stripes(2, 6);
+}
+
+TEST_F(OrcStripeFilterTest, skip_by_int_equality) {
+    add_int_conjunct(kDestK1, TExprOpcode::EQ, 950);
+    check_stripes(9, 10);
+}
+
+TEST_F(OrcStripeFilterTest, skip_by_string_range) {
+    TExprNode value_node;
+    value_node.node_type = TExprNodeType::STRING_LITERAL;
+    value_node.type = type_desc(TPrimitiveType::VARCHAR);
+    value_node.num_children = 0;
+    value_node.__isset.string_literal = true;
+    value_node.string_literal.value = "key07";
+    add_conjunct(TExprOpcode::GE, TPrimitiveType::VARCHAR,
+                 slot_ref_node(TPrimitiveType::VARCHAR, kDestK2, 1), value_node);
+    check_stripes(7, 10);
+}
+
+TEST_F(OrcStripeFilterTest, skip_all_null_stripes) {
+    // a comparison with NULL doesn't match, even one that matches all the values
+    add_int_conjunct(kDestK3, TExprOpcode::GE, 0);
+    check_stripes(kNumStripes / 2, kNumStripes);
+}
+
+TEST_F(OrcStripeFilterTest, skip_all_stripes) {
+    add_int_conjunct(kDestK1, TExprOpcode::GT, 5000);
+    std::vector<int> keys;
+    int stripes_skipped = 0;
+    ASSERT_TRUE(read(&keys, &stripes_skipped).ok());
+    ASSERT_EQ(kNumStripes, stripes_skipped);
+    ASSERT_TRUE(keys.empty());
+}
+
+TEST_F(OrcStripeFilterTest, disabled) {
+    config::enable_orc_stripe_filter = false;
+    add_int_conjunct(kDestK1, TExprOpcode::GE, 250);
+    check_stripes(0, kNumStripes);
+    config::enable_orc_stripe_filter = true;
+}
+
+} // namespace doris
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    doris::CpuInfo::init();
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,206 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "exec/parquet_reader.h"
+
+#include <arrow/api.h>
+#include <arrow/io/file.h>
+#include <gtest/gtest.h>
+#include <parquet/arrow/writer.h>
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/object_pool.h"
+#include "exec/base_scanner.h"
+#include "exec/local_file_reader.h"
+#include "runtime/descriptor_helper.h"
+#include "runtime/descriptors.h"
+#include "runtime/mem_pool.h"
+#include "runtime/mem_tracker.h"
+#include "runtime/string_value.h"
+#include "runtime/tuple.h"
+#include "util/file_utils.h"
+
+namespace doris {
+
+static const std::string kFile = "./be/test/exec/test_data/parquet_reader_test.parquet";
+static const int kNumRowGroups = 10;
+static const int kRowsPerGroup = 100;
+
+class ParquetReaderTest : public testing::Test {
+public:
+    // Writes the row groups of (k1 int, k2 string, k3 int), where row i has k1 = i and
+    // k2 = "key%04d" of i, and k3 = i from the row group kNumRowGroups / 2 on, NULL before.
+    static void SetUpTestCase() {
+        arrow::Int32Builder k1_builder;
+        arrow::StringBuilder k2_builder;
+        arrow::Int32Builder k3_builder;
+        for (int i = 0; i < kNumRowGroups * kRowsPerGroup; ++i) {
+            char key[16];
+            snprintf(key, sizeof(key), "key%04d", i);
+            ASSERT_TRUE(k1_builder.Append(i).ok());
+            ASSERT_TRUE(k2_builder.Append(key).ok());
+            if (i < kNumRowGroups / 2 * kRowsPerGroup) {
+                ASSERT_TRUE(k3_builder.AppendNull().ok());
+            } else {
+                ASSERT_TRUE(k3_builder.Append(i).ok());
+            }
+        }
+        std::vector<std::shared_ptr<arrow::Array>> arrays(3);
+        ASSERT_TRUE(k1_builder.Finish(&arrays[0]).ok());
+        ASSERT_TRUE(k2_builder.Finish(&arrays[1]).ok());
+        ASSERT_TRUE(k3_builder.Finish(&arrays[2]).ok());
+        std::shared_ptr<arrow::Schema> schema = arrow::schema({arrow::field("k1", arrow::int32()),
+                                                               arrow::field("k2", arrow::utf8()),
+                                                               arrow::field("k3", arrow::int32())});
+        std::shared_ptr<arrow::Table> table = arrow::Table::Make(schema, arrays);
+        std::shared_ptr<arrow::io::FileOutputStream> out;
+        ASSERT_TRUE(arrow::io::FileOutputStream::Open(kFile, &out).ok());
+        ASSERT_TRUE(parquet::arrow::WriteTable(*table, arrow::default_memory_pool(), out,
+                                               kRowsPerGroup)
+                            .ok());
+        ASSERT_TRUE(out->Close().ok());
+    }
+
+    static void TearDownTestCase() { FileUtils::remove(kFile); }
+
+    void SetUp() override {
+        // the src tuple (k1 varchar, k2 varchar, k3 varchar) the columns are read into
+        TDescriptorTableBuilder dtb;
+        TTupleDescriptorBuilder tuple_builder;
+        for (int i = 0; i < 3; ++i) {
+            tuple_builder.add_slot(TSlotDescriptorBuilder()
+                                           .string_type(64)
+                                           .column_name("k" + std::to_string(i + 1))
+                                           .column_pos(i)
+                                           .nullable(true)
+                                           .build());
+        }
+        tuple_builder.build(&dtb);
+        ASSERT_TRUE(DescriptorTbl::create(&_obj_pool, dtb.desc_tbl(), &_desc_tbl).ok());
+        _mem_pool.reset(new MemPool(_mem_tracker.get()));
+    }
+
+    // Reads the k1 of the rows of the row groups that aren't skipped by `predicates`.
+    Status read(const std::vector<FileColumnPredicate>& predicates, std::vector<int>* keys,
+                int* row_groups_skipped) {
+        std::unique_ptr<LocalFileReader> file_reader(new LocalFileReader(kFile, 0));
+        RETURN_IF_ERROR(file_reader->open());
+        const TupleDescriptor* tuple_desc = _desc_tbl->get_tuple_descriptor(0);
+        const std::vector<SlotDescriptor*>& slots = tuple_desc->slots();
+        ParquetReaderWrap reader(file_reader.release(), slots.size(), &predicates);
+        Status status = reader.init_parquet_reader(slots, "Asia/Shanghai");
+        bool eof = status.is_end_of_file();
+        if (!eof) {
+            RETURN_IF_ERROR(status);
+        }
+        Tuple* tuple = reinterpret_cast<Tuple*>(_mem_pool->allocate(tuple_desc->byte_size()));
+        while (!eof) {
+            RETURN_IF_ERROR(reader.read(tuple, slots, _mem_pool.get(), &eof));
+            const StringValue* k1 =
+                    reinterpret_cast<StringValue*>(tuple->get_slot(slots[0]->tuple_offset()));
+            keys->push_back(std::stoi(k1->to_string()));
+        }
+        *row_groups_skipped = reader.row_groups_skipped();
+        EXPECT_EQ(*row_groups_skipped * kRowsPerGroup, reader.rows_skipped());
+        return Status::OK();
+    }
+
+    // Checks that `predicates` read exactly the row groups [begin, end).
+    void check_row_groups(const std::vector<FileColumnPredicate>& predicates, int begin, int end) {
+        std::vector<int> keys;
+        int row_groups_skipped = 0;
+        ASSERT_TRUE(read(predicates, &keys, &row_groups_skipped).ok());
+        ASSERT_EQ(kNumRowGroups - (end - begin), row_groups_skipped);
+        ASSERT_EQ((end - begin) * kRowsPerGroup, static_cast<int>(keys.size()));
+        for (int i = 0; i < static_cast<int>(keys.size()); ++i) {
+            ASSERT_EQ(begin * kRowsPerGroup + i, keys[i]);
+        }
+    }
+
+    static FileColumnPredicate int_predicate(int column, TExprOpcode::type op, int64_t value) {
+        FileColumnPredicate pred;
+        pred.column = column;
+        pred.op = op;
+        pred.type = TYPE_INT;
+        pred.int_value = value;
+        return pred;
+    }
+
+protected:
+    ObjectPool _obj_pool;
+    DescriptorTbl* _desc_tbl = nullptr;
+    std::shared_ptr<MemTracker> _mem_tracker = MemTracker::CreateTracker(-1);
+    std::unique_ptr<MemPool> _mem_pool;
+};
+
+TEST_F(ParquetReaderTest, no_predicates) {
+    check_row_groups({}, 0, kNumRowGroups);
+}
+
+TEST_F(ParquetReaderTest, skip_by_int_range) {
+    check_row_groups({int_predicate(0, TExprOpcode::GE, 950)}, 9, 10);
+    check_row_groups({int_predicate(0, TExprOpcode::LT, 200)}, 0, 2);
+    check_row_groups(
+            {int_predicate(0, TExprOpcode::GT, 199), int_predicate(0, TExprOpcode::LE, 300)}, 2,
+            4);
+    check_row_groups({int_predicate(0, TExprOpcode::EQ, 250)}, 2, 3);
+}
+
+TEST_F(ParquetReaderTest, skip_by_string_range) {
+    FileColumnPredicate pred;
+    pred.column = 1;
+    pred.op = TExprOpcode::LT;
+    pred.type = TYPE_VARCHAR;
+    pred.string_value = "key0200";
+    check_row_groups({pred}, 0, 2);
+    pred.op = TExprOpcode::GE;
+    pred.string_value = "key07";
+    check_row_groups({pred}, 7, 10);
+}
+
+TEST_F(ParquetReaderTest, skip_all_null_row_groups) {
+    // a comparison with NULL doesn't match, even one that matches all the values
+    check_row_groups({int_predicate(2, TExprOpcode::GE, 0)}, kNumRowGroups / 2, kNumRowGroups);
+}
+
+TEST_F(ParquetReaderTest, keep_nulls_of_not_nullable_slot) {
+    // The NULLs of a not nullable dest slot are load errors, so the row groups of NULLs
+    // are read to report them
+    FileColumnPredicate pred = int_predicate(2, TExprOpcode::GE, 0);
+    pred.nullable = false;
+    check_row_groups({pred}, 0, kNumRowGroups);
+}
+
+TEST_F(ParquetReaderTest, skip_all_row_groups) {
+    std::vector<int> keys;
+    int row_groups_skipped = 0;
+    ASSERT_TRUE(read({int_predicate(0, TExprOpcode::GT, 5000)}, &keys, &row_groups_skipped).ok());
+    ASSERT_EQ(kNumRowGroups, row_groups_skipped);
+    ASSERT_TRUE(keys.empty());
+}
+
+} // namespace doris
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
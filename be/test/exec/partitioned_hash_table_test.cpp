@@ -0,0 +1,261 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "exec/partitioned_hash_table.h"
+
+#include <gtest/gtest.h>
+
+#include <boost/scoped_ptr.hpp>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/object_pool.h"
+#include "exec/partitioned_hash_table.inline.h"
+#include "exprs/slot_ref.h"
+#include "runtime/bufferpool/buffer_pool.h"
+#include "runtime/bufferpool/reservation_tracker.h"
+#include "runtime/bufferpool/suballocator.h"
+#include "runtime/descriptor_helper.h"
+#include "runtime/descriptors.h"
+#include "runtime/exec_env.h"
+#include "runtime/mem_pool.h"
+#include "runtime/runtime_state.h"
+#include "runtime/thread_resource_mgr.h"
+#include "runtime/tuple.h"
+#include "runtime/tuple_row.h"
+#include "util/cpu_info.h"
+
+namespace doris {
+
+static const int64_t kPageLen = 64 * 1024;
+static const int64_t kReservation = 4 * 1024 * 1024;
+static const int64_t kBufferPoolLimit = 16 * 1024 * 1024;
+
+// The keys of every grouping test are in [-1, kNumKeys), -1 standing for NULL
+static const int32_t kNumKeys = 64;
+
+class PartitionedHashTableTest : public testing::Test {
+public:
+    static void SetUpTestCase() {
+        ExecEnv* env = ExecEnv::GetInstance();
+        env->_thread_mgr = new ThreadResourceMgr();
+        env->_init_buffer_pool(config::min_buffer_size, kBufferPoolLimit, kBufferPoolLimit);
+    }
+
+    static void TearDownTestCase() {
+        ExecEnv* env = ExecEnv::GetInstance();
+        SAFE_DELETE(env->_buffer_pool);
+        env->_buffer_reservation->Close();
+        SAFE_DELETE(env->_buffer_reservation);
+        SAFE_DELETE(env->_thread_mgr);
+    }
+
+    void SetUp() override {
+        // (k1 int, k2 int, k3 bigint, k4 bigint, k5 bigint, k6 bigint, k7 varchar),
+        // all nullable
+        TDescriptorTableBuilder dtb;
+        TTupleDescriptorBuilder tuple_builder;
+        const PrimitiveType types[] = {TYPE_INT,    TYPE_INT,    TYPE_BIGINT, TYPE_BIGINT,
+                                       TYPE_BIGINT, TYPE_BIGINT, TYPE_VARCHAR};
+        for (int i = 0; i < 7; ++i) {
+            TSlotDescriptorBuilder slot_builder;
+            if (types[i] == TYPE_VARCHAR) {
+                slot_builder.string_type(16);
+            } else {
+                slot_builder.type(types[i]);
+            }
+            tuple_builder.add_slot(slot_builder.column_name("k" + std::to_string(i + 1))
+                                           .column_pos(i)
+                                           .nullable(true)
+                                           .build());
+        }
+        tuple_builder.build(&dtb);
+        ASSERT_TRUE(DescriptorTbl::create(&_obj_pool, dtb.desc_tbl(), &_desc_tbl).ok());
+        _row_desc.reset(new RowDescriptor(*_desc_tbl, {0}, {false}));
+
+        TQueryOptions query_options;
+        query_options.__set_buffer_pool_limit(kBufferPoolLimit);
+        _state.reset(new RuntimeState(TUniqueId(), query_options, TQueryGlobals(),
+                                      ExecEnv::GetInstance()));
+        ASSERT_TRUE(_state->init_mem_trackers(TUniqueId()).ok());
+        _state->set_desc_tbl(_desc_tbl);
+        _mem_pool.reset(new MemPool(_state->instance_mem_tracker().get()));
+        _tuple_pool.reset(new MemPool(_state->instance_mem_tracker().get()));
+
+        ASSERT_TRUE(ExecEnv::GetInstance()
+                            ->buffer_pool()
+                            ->RegisterClient("PartitionedHashTableTest",
+                                             _state->instance_buffer_reservation(),
+                                             _state->instance_mem_tracker(), kReservation,
+                                             _state->runtime_profile(), &_client)
+                            .ok());
+        ASSERT_TRUE(_client.IncreaseReservation(kReservation));
+    }
+
+    void TearDown() override {
+        ExecEnv::GetInstance()->buffer_pool()->DeregisterClient(&_client);
+        _tuple_pool->free_all();
+        _mem_pool->free_all();
+        _obj_pool.clear();
+        _state.reset();
+    }
+
+    // Creates the context grouping by the slots `slot_ids` of the tuple, which compares
+    // NULLs as equal like the aggregation does.
+    Status create_ctx(const std::vector<int>& slot_ids,
+                      boost::scoped_ptr<PartitionedHashTableCtx>* ht_ctx) {
+        const std::vector<SlotDescriptor*>& slots = _desc_tbl->get_tuple_descriptor(0)->slots();
+        std::vector<Expr*> exprs;
+        for (int slot_id : slot_ids) {
+            exprs.push_back(_obj_pool.add(new SlotRef(slots[slot_id])));
+        }
+        RETURN_IF_ERROR(PartitionedHashTableCtx::Create(
+                &_obj_pool, _state.get(), exprs, exprs, true,
+                std::vector<bool>(exprs.size(), true), 1, 16, 1, _mem_pool.get(),
+                _mem_pool.get(), _state->instance_mem_tracker(), *_row_desc, *_row_desc,
+                ht_ctx));
+        return (*ht_ctx)->Open(_state.get());
+    }
+
+    int packed_key_words(const std::vector<int>& slot_ids) {
+        boost::scoped_ptr<PartitionedHashTableCtx> ht_ctx;
+        EXPECT_TRUE(create_ctx(slot_ids, &ht_ctx).ok());
+        int packed_key_words = ht_ctx->expr_values_cache()->packed_key_words();
+        ht_ctx->Close(_state.get());
+        return packed_key_words;
+    }
+
+    // Returns a tuple of (k1, k2), -1 standing for NULL
+    Tuple* make_tuple(int32_t k1, int32_t k2) {
+        const TupleDescriptor* tuple_desc = _desc_tbl->get_tuple_descriptor(0);
+        Tuple* tuple = reinterpret_cast<Tuple*>(_tuple_pool->allocate(tuple_desc->byte_size()));
+        memset(tuple, 0, tuple_desc->byte_size());
+        const int32_t keys[] = {k1, k2};
+        for (int i = 0; i < 2; ++i) {
+            const SlotDescriptor* slot = tuple_desc->slots()[i];
+            if (keys[i] == -1) {
+                tuple->set_null(slot->null_indicator_offset());
+            } else {
+                *reinterpret_cast<int32_t*>(tuple->get_slot(slot->tuple_offset())) = keys[i];
+            }
+        }
+        return tuple;
+    }
+
+    // Returns the (k1, k2) of `tuple`, -1 standing for NULL
+    std::pair<int32_t, int32_t> keys(const Tuple* tuple) {
+        const TupleDescriptor* tuple_desc = _desc_tbl->get_tuple_descriptor(0);
+        int32_t keys[2];
+        for (int i = 0; i < 2; ++i) {
+            const SlotDescriptor* slot = tuple_desc->slots()[i];
+            keys[i] = tuple->is_null(slot->null_indicator_offset())
+                              ? -1
+                              : *reinterpret_cast<const int32_t*>(
+                                        tuple->get_slot(slot->tuple_offset()));
+        }
+        return std::make_pair(keys[0], keys[1]);
+    }
+
+    // Groups the rows of every (k1, k2) three times like the aggregation does, with the
+    // packed keys in the table if `packed`. Each row has to find the tuple of the first
+    // row of its group. Returns the number of groups.
+    int64_t group(bool packed) {
+        boost::scoped_ptr<PartitionedHashTableCtx> ht_ctx;
+        EXPECT_TRUE(create_ctx({0, 1}, &ht_ctx).ok());
+        PartitionedHashTableCtx::ExprValuesCache* expr_vals_cache = ht_ctx->expr_values_cache();
+        EXPECT_EQ(2, expr_vals_cache->packed_key_words());
+        Suballocator allocator(ExecEnv::GetInstance()->buffer_pool(), &_client, kPageLen);
+        boost::scoped_ptr<PartitionedHashTable> hash_tbl(PartitionedHashTable::Create(
+                &allocator, false, 1, nullptr, 1L << 20, 16,
+                packed ? expr_vals_cache->packed_key_words() : 0));
+        bool got_memory = false;
+        EXPECT_TRUE(hash_tbl->Init(&got_memory).ok());
+        EXPECT_TRUE(got_memory);
+
+        for (int i = 0; i < 3; ++i) {
+            for (int32_t k1 = -1; k1 < kNumKeys; ++k1) {
+                for (int32_t k2 = -1; k2 < kNumKeys; ++k2) {
+                    Tuple* tuple = make_tuple(k1, k2);
+                    TupleRow* row = reinterpret_cast<TupleRow*>(&tuple);
+                    EXPECT_TRUE(hash_tbl->CheckAndResize(1, ht_ctx.get(), &got_memory).ok());
+                    EXPECT_TRUE(got_memory);
+                    expr_vals_cache->Reset();
+                    EXPECT_TRUE(ht_ctx->EvalAndHashBuild(row));
+                    expr_vals_cache->NextRow();
+                    expr_vals_cache->ResetForRead();
+
+                    bool found = false;
+                    PartitionedHashTable::Iterator it =
+                            hash_tbl->FindBuildRowBucket(ht_ctx.get(), &found);
+                    EXPECT_FALSE(it.AtEnd());
+                    EXPECT_EQ(i > 0, found) << k1 << ", " << k2;
+                    if (found) {
+                        EXPECT_EQ(std::make_pair(k1, k2), keys(it.GetTuple()));
+                    } else {
+                        it.SetTuple(tuple, expr_vals_cache->CurExprValuesHash());
+                    }
+                }
+            }
+        }
+        int64_t num_groups = hash_tbl->size();
+        hash_tbl->Close();
+        ht_ctx->Close(_state.get());
+        return num_groups;
+    }
+
+protected:
+    ObjectPool _obj_pool;
+    DescriptorTbl* _desc_tbl = nullptr;
+    std::unique_ptr<RowDescriptor> _row_desc;
+    std::unique_ptr<RuntimeState> _state;
+    std::unique_ptr<MemPool> _mem_pool;
+    std::unique_ptr<MemPool> _tuple_pool;
+    BufferPool::ClientHandle _client;
+};
+
+TEST_F(PartitionedHashTableTest, packed_key_words) {
+    // The values and then the null bytes, rounded up to a power of two of words
+    ASSERT_EQ(1, packed_key_words({0}));
+    ASSERT_EQ(2, packed_key_words({0, 1}));
+    // The bigint is aligned after the int, 16 bytes of values and 2 null bytes
+    ASSERT_EQ(4, packed_key_words({0, 2}));
+    // More than 4 words
+    ASSERT_EQ(0, packed_key_words({2, 3, 4, 5}));
+    // Not fixed width
+    ASSERT_EQ(0, packed_key_words({0, 6}));
+}
+
+TEST_F(PartitionedHashTableTest, group_by_packed_keys) {
+    // NULLs are equal to each other and not to the zeros under them
+    ASSERT_EQ((kNumKeys + 1) * (kNumKeys + 1), group(true));
+}
+
+TEST_F(PartitionedHashTableTest, group_by_unpacked_keys) {
+    ASSERT_EQ((kNumKeys + 1) * (kNumKeys + 1), group(false));
+}
+
+} // namespace doris
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    doris::CpuInfo::init();
+    return RUN_ALL_TESTS();
+}
@@ -17,6 +17,7 @@
 
 #include <gtest/gtest.h>
 
+#include "exec/async_decompress_reader.h"
 #include "exec/decompressor.h"
 #include "exec/local_file_reader.h"
 #include "exec/plain_text_line_reader.h"
@@ -265,6 +266,55 @@ TEST_F(PlainTextLineReaderTest, gzip_test_limit5) {
     delete decompressor;
 }
 
+TEST_F(PlainTextLineReaderTest, gzip_async_decompress) {
+    LocalFileReader file_reader("./be/test/exec/test_data/plain_text_line_reader/test_file.csv.gz",
+                                0);
+    auto st = file_reader.open();
+    ASSERT_TRUE(st.ok());
+
+    Decompressor* decompressor;
+    st = Decompressor::create_decompressor(CompressType::GZIP, &decompressor);
+    ASSERT_TRUE(st.ok());
+
+    // the line reader reads the decompressed data
+    AsyncDecompressReader async_reader(&_profile, &file_reader, decompressor);
+    st = async_reader.open();
+    ASSERT_TRUE(st.ok());
+    PlainTextLineReader line_reader(&_profile, &async_reader, nullptr, -1, '\n');
+    const uint8_t* ptr;
+    size_t size;
+    bool eof;
+
+    st = line_reader.read_line(&ptr, &size, &eof);
+    ASSERT_TRUE(st.ok());
+    ASSERT_STREQ("1,2", std::string((char*)ptr, size).c_str());
+    ASSERT_FALSE(eof);
+
+    st = line_reader.read_line(&ptr, &size, &eof);
+    ASSERT_TRUE(st.ok());
+    ASSERT_EQ(0, size);
+    ASSERT_FALSE(eof);
+
+    st = line_reader.read_line(&ptr, &size, &eof);
+    ASSERT_TRUE(st.ok());
+    ASSERT_STREQ("1,2,3,4", std::string((char*)ptr, size).c_str());
+    ASSERT_FALSE(eof);
+
+    st = line_reader.read_line(&ptr, &size, &eof);
+    ASSERT_TRUE(st.ok());
+    ASSERT_FALSE(eof);
+
+    st = line_reader.read_line(&ptr, &size, &eof);
+    ASSERT_TRUE(st.ok());
+    ASSERT_FALSE(eof);
+
+    st = line_reader.read_line(&ptr, &size, &eof);
+    ASSERT_TRUE(st.ok());
+    ASSERT_TRUE(eof);
+    async_reader.close();
+    delete decompressor;
+}
+
 } // end namespace doris
 
 int main(int argc, char** argv) {
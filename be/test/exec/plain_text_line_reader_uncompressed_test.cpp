@@ -20,6 +20,7 @@
 #include "exec/decompressor.h"
 #include "exec/local_file_reader.h"
 #include "exec/plain_text_line_reader.h"
+#include "runtime/stream_load/stream_load_pipe.h"
 #include "util/runtime_profile.h"
 
 namespace doris {
@@ -290,6 +291,30 @@ TEST_F(PlainTextLineReaderTest, uncompressed_test_empty) {
     ASSERT_TRUE(eof);
 }
 
+TEST_F(PlainTextLineReaderTest, uncompressed_stream_load_pipe) {
+    StreamLoadPipe pipe(1024, 64);
+    // the second line spans the two buffers
+    std::string first = "1,2\n3,";
+    std::string second = "4\n\n5,6";
+    ASSERT_TRUE(pipe.append_and_flush(first.data(), first.size()).ok());
+    ASSERT_TRUE(pipe.append_and_flush(second.data(), second.size()).ok());
+    ASSERT_TRUE(pipe.finish().ok());
+
+    PlainTextLineReader line_reader(&_profile, &pipe, nullptr, -1, '\n');
+    const uint8_t* ptr;
+    size_t size;
+    bool eof;
+    for (auto& expected : {"1,2", "3,4", "", "5,6"}) {
+        auto st = line_reader.read_line(&ptr, &size, &eof);
+        ASSERT_TRUE(st.ok());
+        ASSERT_FALSE(eof);
+        ASSERT_EQ(expected, std::string((const char*)ptr, size));
+    }
+    auto st = line_reader.read_line(&ptr, &size, &eof);
+    ASSERT_TRUE(st.ok());
+    ASSERT_TRUE(eof);
+}
+
 } // end namespace doris
 
 int main(int argc, char** argv) {
@@ -0,0 +1,97 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "exec/scan_string_dict.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "runtime/mem_tracker.h"
+#include "runtime/string_value.hpp"
+
+namespace doris {
+
+class ScanStringDictTest : public testing::Test {
+public:
+    ScanStringDictTest() : _tracker(new MemTracker()) {}
+
+protected:
+    std::shared_ptr<MemTracker> _tracker;
+};
+
+TEST_F(ScanStringDictTest, unify) {
+    ScanStringDict dict(2, _tracker.get());
+    ScanStringDictCache cache1(&dict);
+    ScanStringDictCache cache2(&dict);
+
+    std::string beijing1 = "beijing";
+    std::string beijing2 = "beijing";
+    StringValue value1(beijing1);
+    StringValue value2(beijing2);
+    ASSERT_TRUE(cache1.unify(&value1));
+    ASSERT_TRUE(cache2.unify(&value2));
+    // the values are copied into the dictionary, and equal values share it
+    ASSERT_NE(beijing1.data(), value1.ptr);
+    ASSERT_EQ(value1.ptr, value2.ptr);
+    ASSERT_EQ("beijing", value1.to_string());
+    ASSERT_EQ(1, dict.size());
+
+    std::string shanghai = "shanghai";
+    StringValue value3(shanghai);
+    ASSERT_TRUE(cache1.unify(&value3));
+    ASSERT_EQ("shanghai", value3.to_string());
+    ASSERT_TRUE(cache1.enabled());
+
+    // full
+    std::string shenzhen = "shenzhen";
+    StringValue value4(shenzhen);
+    ASSERT_FALSE(cache2.unify(&value4));
+    ASSERT_EQ(shenzhen.data(), value4.ptr);
+    ASSERT_TRUE(dict.is_full());
+    ASSERT_FALSE(cache1.enabled());
+    ASSERT_EQ(2, dict.size());
+
+    // the values in the dictionary are still unified
+    StringValue value5(shanghai);
+    ASSERT_TRUE(cache2.unify(&value5));
+    ASSERT_EQ(value3.ptr, value5.ptr);
+}
+
+TEST_F(ScanStringDictTest, compare_unified) {
+    ScanStringDict dict(16, _tracker.get());
+    std::string a1 = "abc";
+    std::string a2 = "abc";
+    std::string b = "abd";
+    StringValue v1(a1);
+    StringValue v2(a2);
+    StringValue v3(b);
+    ASSERT_TRUE(dict.unify(&v1));
+    ASSERT_TRUE(dict.unify(&v2));
+    ASSERT_TRUE(dict.unify(&v3));
+    ASSERT_TRUE(v1.eq(v2));
+    ASSERT_EQ(0, v1.compare(v2));
+    ASSERT_FALSE(v1.eq(v3));
+    ASSERT_LT(v1.compare(v3), 0);
+}
+
+} // namespace doris
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,353 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "exec/spill_sort_node.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/object_pool.h"
+#include "gen_cpp/PlanNodes_types.h"
+#include "runtime/descriptor_helper.h"
+#include "runtime/descriptors.h"
+#include "runtime/disk_io_mgr.h"
+#include "runtime/exec_env.h"
+#include "runtime/mem_tracker.h"
+#include "runtime/row_batch.h"
+#include "runtime/runtime_state.h"
+#include "runtime/string_value.h"
+#include "runtime/thread_resource_mgr.h"
+#include "runtime/tmp_file_mgr.h"
+#include "runtime/tuple.h"
+#include "runtime/tuple_row.h"
+#include "util/cpu_info.h"
+#include "util/disk_info.h"
+
+namespace doris {
+
+static const int64_t kMemLimit = 512 * 1024 * 1024;
+
+// A row of (k1 int null, k2 double, k3 varchar)
+struct SortRow {
+    bool k1_null;
+    int32_t k1;
+    double k2;
+    std::string k3;
+
+    bool operator==(const SortRow& other) const {
+        return k1_null == other.k1_null && (k1_null || k1 == other.k1) && k2 == other.k2 &&
+               k3 == other.k3;
+    }
+};
+
+// An ordering expr on the column `column` of the rows
+struct SortOrder {
+    int column;
+    bool is_asc;
+    bool nulls_first;
+};
+
+// Returns `rows` to its parent
+class SortRowsNode : public ExecNode {
+public:
+    SortRowsNode(ObjectPool* pool, const TPlanNode& tnode, const DescriptorTbl& descs,
+                 const std::vector<SortRow>& rows)
+            : ExecNode(pool, tnode, descs), _rows(rows) {}
+
+    Status get_next(RuntimeState* state, RowBatch* row_batch, bool* eos) override {
+        const TupleDescriptor* tuple_desc = row_desc().tuple_descriptors()[0];
+        const std::vector<SlotDescriptor*>& slots = tuple_desc->slots();
+        while (!row_batch->is_full() && _next < _rows.size()) {
+            const SortRow& sort_row = _rows[_next++];
+            MemPool* pool = row_batch->tuple_data_pool();
+            Tuple* tuple = reinterpret_cast<Tuple*>(pool->allocate(tuple_desc->byte_size()));
+            memset(tuple, 0, tuple_desc->byte_size());
+            if (sort_row.k1_null) {
+                tuple->set_null(slots[0]->null_indicator_offset());
+            } else {
+                *reinterpret_cast<int32_t*>(tuple->get_slot(slots[0]->tuple_offset())) =
+                        sort_row.k1;
+            }
+            *reinterpret_cast<double*>(tuple->get_slot(slots[1]->tuple_offset())) = sort_row.k2;
+            char* k3 = reinterpret_cast<char*>(pool->allocate(sort_row.k3.size()));
+            memcpy(k3, sort_row.k3.data(), sort_row.k3.size());
+            *reinterpret_cast<StringValue*>(tuple->get_slot(slots[2]->tuple_offset())) =
+                    StringValue(k3, sort_row.k3.size());
+            TupleRow* row = row_batch->get_row(row_batch->add_row());
+            row->set_tuple(0, tuple);
+            row_batch->commit_last_row();
+        }
+        *eos = _next == _rows.size();
+        return Status::OK();
+    }
+
+private:
+    std::vector<SortRow> _rows;
+    size_t _next = 0;
+};
+
+class SpillSortNodeTest : public testing::Test {
+public:
+    static void SetUpTestCase() {
+        ExecEnv* env = ExecEnv::GetInstance();
+        env->_thread_mgr = new ThreadResourceMgr();
+        env->_disk_io_mgr = new DiskIoMgr();
+        ASSERT_TRUE(env->_disk_io_mgr->init(MemTracker::CreateTracker(-1, "DiskIoMgr")).ok());
+        // no scratch directories, the runs of the tests are sorted in memory
+        env->_tmp_file_mgr = new TmpFileMgr();
+        ASSERT_TRUE(env->_tmp_file_mgr->init_custom({}, false).ok());
+    }
+
+    static void TearDownTestCase() {
+        ExecEnv* env = ExecEnv::GetInstance();
+        SAFE_DELETE(env->_tmp_file_mgr);
+        SAFE_DELETE(env->_disk_io_mgr);
+        SAFE_DELETE(env->_thread_mgr);
+    }
+
+    void SetUp() override {
+        // tuple 0 of the input and tuple 1 of the sort tuples, both
+        // (k1 int null, k2 double, k3 varchar)
+        TDescriptorTableBuilder dtb;
+        for (int i = 0; i < 2; ++i) {
+            TTupleDescriptorBuilder tuple_builder;
+            tuple_builder.add_slot(TSlotDescriptorBuilder()
+                                           .type(TYPE_INT)
+                                           .column_name("k1")
+                                           .column_pos(0)
+                                           .nullable(true)
+                                           .build());
+            tuple_builder.add_slot(TSlotDescriptorBuilder()
+                                           .type(TYPE_DOUBLE)
+                                           .column_name("k2")
+                                           .column_pos(1)
+                                           .nullable(false)
+                                           .build());
+            tuple_builder.add_slot(TSlotDescriptorBuilder()
+                                           .string_type(64)
+                                           .column_name("k3")
+                                           .column_pos(2)
+                                           .nullable(false)
+                                           .build());
+            tuple_builder.build(&dtb);
+        }
+        ASSERT_TRUE(DescriptorTbl::create(&_obj_pool, dtb.desc_tbl(), &_desc_tbl).ok());
+
+        TQueryOptions query_options;
+        query_options.__set_mem_limit(kMemLimit);
+        _state.reset(new RuntimeState(TUniqueId(), query_options, TQueryGlobals(),
+                                      ExecEnv::GetInstance()));
+        ASSERT_TRUE(_state->init_mem_trackers(TUniqueId()).ok());
+        ASSERT_TRUE(_state->create_block_mgr().ok());
+        _state->set_desc_tbl(_desc_tbl);
+    }
+
+    void TearDown() override {
+        _obj_pool.clear();
+        _state.reset();
+    }
+
+    // Sorts `rows` by `orders` with a SpillSortNode into `sorted`.
+    void sort(const std::vector<SortOrder>& orders, const std::vector<SortRow>& rows,
+              std::vector<SortRow>* sorted) {
+        TPlanNode tnode;
+        tnode.__set_node_id(0);
+        tnode.__set_node_type(TPlanNodeType::SORT_NODE);
+        tnode.__set_num_children(1);
+        tnode.__set_limit(-1);
+        tnode.__set_row_tuples({1});
+        tnode.__set_nullable_tuples({false});
+        tnode.__set_compact_data(false);
+        TSortInfo sort_info;
+        for (const SortOrder& order : orders) {
+            sort_info.ordering_exprs.push_back(slot_ref(3 + order.column, 1));
+            sort_info.is_asc_order.push_back(order.is_asc);
+            sort_info.nulls_first.push_back(order.nulls_first);
+        }
+        sort_info.__set_sort_tuple_slot_exprs({slot_ref(0, 0), slot_ref(1, 0), slot_ref(2, 0)});
+        TSortNode sort_node;
+        sort_node.__set_sort_info(sort_info);
+        sort_node.__set_use_top_n(false);
+        tnode.__set_sort_node(sort_node);
+
+        TPlanNode child_tnode;
+        child_tnode.__set_node_id(1);
+        child_tnode.__set_node_type(TPlanNodeType::EMPTY_SET_NODE);
+        child_tnode.__set_num_children(0);
+        child_tnode.__set_limit(-1);
+        child_tnode.__set_row_tuples({0});
+        child_tnode.__set_nullable_tuples({false});
+        child_tnode.__set_compact_data(false);
+
+        SpillSortNode* sort_node_ptr =
+                _obj_pool.add(new SpillSortNode(&_obj_pool, tnode, *_desc_tbl));
+        ASSERT_TRUE(sort_node_ptr->init(tnode, _state.get()).ok());
+        sort_node_ptr->_children.push_back(
+                _obj_pool.add(new SortRowsNode(&_obj_pool, child_tnode, *_desc_tbl, rows)));
+        ASSERT_TRUE(sort_node_ptr->prepare(_state.get()).ok());
+        ASSERT_TRUE(sort_node_ptr->open(_state.get()).ok());
+
+        const std::vector<SlotDescriptor*>& slots = _desc_tbl->get_tuple_descriptor(1)->slots();
+        RowBatch batch(sort_node_ptr->row_desc(), _state->batch_size(),
+                       _state->instance_mem_tracker().get());
+        bool eos = false;
+        while (!eos) {
+            ASSERT_TRUE(sort_node_ptr->get_next(_state.get(), &batch, &eos).ok());
+            for (int i = 0; i < batch.num_rows(); ++i) {
+                Tuple* tuple = batch.get_row(i)->get_tuple(0);
+                SortRow sort_row;
+                sort_row.k1_null = tuple->is_null(slots[0]->null_indicator_offset());
+                sort_row.k1 = sort_row.k1_null ? 0
+                                               : *reinterpret_cast<int32_t*>(
+                                                         tuple->get_slot(slots[0]->tuple_offset()));
+                sort_row.k2 = *reinterpret_cast<double*>(tuple->get_slot(slots[1]->tuple_offset()));
+                const StringValue* k3 =
+                        reinterpret_cast<StringValue*>(tuple->get_slot(slots[2]->tuple_offset()));
+                sort_row.k3.assign(k3->ptr, k3->len);
+                sorted->push_back(sort_row);
+            }
+            batch.reset();
+        }
+        ASSERT_TRUE(sort_node_ptr->close(_state.get()).ok());
+    }
+
+    // Sorts `rows` by `orders` with the SpillSortNode and with std::sort(), the orders have
+    // to order all the rows.
+    void check_sort(const std::vector<SortOrder>& orders, const std::vector<SortRow>& rows) {
+        std::vector<SortRow> sorted;
+        sort(orders, rows, &sorted);
+        std::vector<SortRow> expected = rows;
+        std::sort(expected.begin(), expected.end(), [&](const SortRow& lhs, const SortRow& rhs) {
+            for (const SortOrder& order : orders) {
+                int cmp = compare(order, lhs, rhs);
+                if (cmp != 0) {
+                    return cmp < 0;
+                }
+            }
+            return false;
+        });
+        ASSERT_EQ(expected.size(), sorted.size());
+        for (size_t i = 0; i < expected.size(); ++i) {
+            ASSERT_TRUE(expected[i] == sorted[i]) << i << ": " << expected[i].k3 << " vs "
+                                                  << sorted[i].k3;
+        }
+    }
+
+    static int compare(const SortOrder& order, const SortRow& lhs, const SortRow& rhs) {
+        if (order.column == 0 && (lhs.k1_null || rhs.k1_null)) {
+            if (lhs.k1_null && rhs.k1_null) {
+                return 0;
+            }
+            return lhs.k1_null == order.nulls_first ? -1 : 1;
+        }
+        int cmp = 0;
+        if (order.column == 0) {
+            cmp = lhs.k1 < rhs.k1 ? -1 : lhs.k1 > rhs.k1;
+        } else if (order.column == 1) {
+            cmp = lhs.k2 < rhs.k2 ? -1 : lhs.k2 > rhs.k2;
+        } else {
+            cmp = lhs.k3.compare(rhs.k3);
+            cmp = cmp < 0 ? -1 : cmp > 0;
+        }
+        return order.is_asc ? cmp : -cmp;
+    }
+
+    // Returns `num_rows` rows of distinct k3 and k1 in [-kNumKeys, kNumKeys), one in
+    // ten of which is NULL
+    static std::vector<SortRow> rows(int num_rows) {
+        static const int32_t kNumKeys = 500;
+        std::vector<SortRow> rows;
+        uint32_t seed = 1;
+        for (int i = 0; i < num_rows; ++i) {
+            seed = seed * 1103515245 + 12345;
+            int32_t k1 = static_cast<int32_t>((seed >> 8) % (2 * kNumKeys)) - kNumKeys;
+            rows.push_back({i % 10 == 0, k1, k1 / 7.0, "row" + std::to_string(i)});
+        }
+        return rows;
+    }
+
+    TExpr slot_ref(TSlotId slot_id, TTupleId tuple_id) {
+        const SlotDescriptor* slot_desc = _desc_tbl->get_slot_descriptor(slot_id);
+        TExprNode node;
+        node.__set_node_type(TExprNodeType::SLOT_REF);
+        node.__set_type(slot_desc->type().to_thrift());
+        node.__set_num_children(0);
+        TSlotRef slot_ref;
+        slot_ref.__set_slot_id(slot_id);
+        slot_ref.__set_tuple_id(tuple_id);
+        node.__set_slot_ref(slot_ref);
+        TExpr expr;
+        expr.nodes.push_back(node);
+        return expr;
+    }
+
+protected:
+    ObjectPool _obj_pool;
+    DescriptorTbl* _desc_tbl = nullptr;
+    std::unique_ptr<RuntimeState> _state;
+};
+
+TEST_F(SpillSortNodeTest, sort_by_int_nulls_first) {
+    check_sort({{0, true, true}, {2, true, false}}, rows(4000));
+}
+
+TEST_F(SpillSortNodeTest, sort_by_int_desc_nulls_last) {
+    check_sort({{0, false, false}, {2, true, false}}, rows(4000));
+}
+
+TEST_F(SpillSortNodeTest, sort_small_run) {
+    // Too few tuples to sort by the prefixes
+    check_sort({{0, true, false}, {2, false, false}}, rows(100));
+}
+
+TEST_F(SpillSortNodeTest, sort_by_double) {
+    std::vector<SortRow> sort_rows = rows(4000);
+    // -0.0 is equal to 0.0, so they are ordered by k3
+    for (int i = 0; i < 100; ++i) {
+        sort_rows[i].k2 = i % 2 == 0 ? -0.0 : 0.0;
+    }
+    sort_rows[100].k2 = -1e300;
+    sort_rows[101].k2 = 1e300;
+    check_sort({{1, true, false}, {2, true, false}}, sort_rows);
+    check_sort({{1, false, false}, {2, false, false}}, sort_rows);
+}
+
+TEST_F(SpillSortNodeTest, sort_by_string) {
+    // Strings shorter than, as long as and longer than the 8 bytes prefixes, most of which
+    // share the prefix
+    std::vector<SortRow> sort_rows = rows(4000);
+    for (size_t i = 0; i < sort_rows.size(); ++i) {
+        sort_rows[i].k3 = (i % 3 == 0 ? "" : "prefix__") + std::to_string(i * 7919 % 4000);
+    }
+    check_sort({{2, true, false}}, sort_rows);
+    check_sort({{2, false, false}}, sort_rows);
+}
+
+} // namespace doris
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    doris::CpuInfo::init();
+    doris::DiskInfo::init();
+    return RUN_ALL_TESTS();
+}
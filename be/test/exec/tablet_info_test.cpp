@@ -222,6 +222,42 @@ TEST_F(OlapTablePartitionParamTest, normal) {
         ASSERT_TRUE(found);
         ASSERT_EQ(12, partition->id);
     }
+
+    // a batch of tuples, with runs of the same partition
+    {
+        std::vector<int64_t> values = {9, 1, 2, 25, 30, 10, 50, 55, 60, 100, 49, 9, 70};
+        std::vector<Tuple*> tuples;
+        for (int i = 0; i < values.size(); ++i) {
+            Tuple* tuple = (Tuple*)batch.tuple_data_pool()->allocate(tuple_desc->byte_size());
+            memset(tuple, 0, tuple_desc->byte_size());
+            *reinterpret_cast<int*>(tuple->get_slot(4)) = i;
+            *reinterpret_cast<int64_t*>(tuple->get_slot(8)) = values[i];
+            StringValue* str_val = reinterpret_cast<StringValue*>(tuple->get_slot(16));
+            str_val->ptr = (char*)batch.tuple_data_pool()->allocate(10);
+            str_val->len = 3;
+            memcpy(str_val->ptr, "abc", str_val->len);
+            tuples.push_back(tuple);
+        }
+        std::vector<const OlapTablePartition*> partitions(tuples.size());
+        std::vector<uint32_t> dist_hashes(tuples.size());
+        part.find_tablets(tuples.data(), tuples.size(), partitions.data(), dist_hashes.data());
+        for (int i = 0; i < tuples.size(); ++i) {
+            uint32_t dist_hash = 0;
+            const OlapTablePartition* partition = nullptr;
+            if (part.find_tablet(tuples[i], &partition, &dist_hash)) {
+                ASSERT_EQ(partition, partitions[i]);
+                ASSERT_EQ(dist_hash, dist_hashes[i]);
+            } else {
+                ASSERT_EQ(nullptr, partitions[i]);
+            }
+        }
+        ASSERT_EQ(10, partitions[1]->id);
+        ASSERT_EQ(11, partitions[5]->id);
+        ASSERT_EQ(nullptr, partitions[6]);
+        ASSERT_EQ(nullptr, partitions[7]);
+        ASSERT_EQ(12, partitions[8]->id);
+        ASSERT_EQ(11, partitions[10]->id);
+    }
 }
 
 TEST_F(OlapTablePartitionParamTest, to_protobuf) {
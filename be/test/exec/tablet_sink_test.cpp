@@ -36,6 +36,8 @@
 #include "util/brpc_stub_cache.h"
 #include "util/cpu_info.h"
 #include "util/debug/leakcheck_disabler.h"
+#include "util/monotime.h"
+#include "util/stopwatch.hpp"
 
 namespace doris {
 namespace stream_load {
@@ -974,6 +976,102 @@ TEST_F(OlapTableSinkTest, decimal) {
     // ASSERT_TRUE(output_set.count("[(14 999.99)]") > 0);
 }
 
+// Answers add batch rpcs slowly, so that batches are queued for the node channels
+class SlowInternalService : public TestInternalService {
+public:
+    void tablet_writer_add_batch(google::protobuf::RpcController* controller,
+                                 const PTabletWriterAddBatchRequest* request,
+                                 PTabletWriterAddBatchResult* response,
+                                 google::protobuf::Closure* done) override {
+        SleepFor(MonoDelta::FromMilliseconds(20));
+        TestInternalService::tablet_writer_add_batch(controller, request, response, done);
+    }
+};
+
+TEST_F(OlapTableSinkTest, pending_batches_bounded) {
+    // start brpc service first
+    _server = new brpc::Server();
+    auto service = new SlowInternalService();
+    ASSERT_EQ(_server->AddService(service, brpc::SERVER_OWNS_SERVICE), 0);
+    brpc::ServerOptions options;
+    {
+        debug::ScopedLeakCheckDisabler disable_lsan;
+        _server->Start(4356, &options);
+    }
+
+    int32_t max_pending_batches = config::olap_table_sink_max_pending_batches_per_channel;
+    int32_t send_interval_ms = config::olap_table_sink_send_interval_ms;
+    config::olap_table_sink_max_pending_batches_per_channel = 2;
+    // the sender only sends in time if it's woken up by the queued batches and the rpcs
+    config::olap_table_sink_send_interval_ms = 60 * 1000;
+
+    TUniqueId fragment_id;
+    TQueryOptions query_options;
+    query_options.batch_size = 1;
+    RuntimeState state(fragment_id, query_options, TQueryGlobals(), _env);
+    state.init_mem_trackers(TUniqueId());
+
+    ObjectPool obj_pool;
+    TDescriptorTable tdesc_tbl;
+    auto t_data_sink = get_data_sink(&tdesc_tbl);
+
+    DescriptorTbl* desc_tbl = nullptr;
+    auto st = DescriptorTbl::create(&obj_pool, tdesc_tbl, &desc_tbl);
+    ASSERT_TRUE(st.ok());
+    state._desc_tbl = desc_tbl;
+
+    TupleDescriptor* tuple_desc = desc_tbl->get_tuple_descriptor(0);
+    RowDescriptor row_desc(*desc_tbl, {0}, {false});
+
+    OlapTableSink sink(&obj_pool, row_desc, {}, &st);
+    ASSERT_TRUE(st.ok());
+    st = sink.init(t_data_sink);
+    ASSERT_TRUE(st.ok());
+    st = sink.prepare(&state);
+    ASSERT_TRUE(st.ok());
+    st = sink.open(&state);
+    ASSERT_TRUE(st.ok());
+
+    MonotonicStopWatch watch;
+    watch.start();
+    // a batch of one row per send, each row of a node channel fills a batch
+    const int num_rows = 20;
+    auto tracker = std::make_shared<MemTracker>();
+    RowBatch batch(row_desc, 1024, tracker.get());
+    for (int i = 0; i < num_rows; ++i) {
+        batch.reset();
+        Tuple* tuple = (Tuple*)batch.tuple_data_pool()->allocate(tuple_desc->byte_size());
+        batch.get_row(batch.add_row())->set_tuple(0, tuple);
+        memset(tuple, 0, tuple_desc->byte_size());
+
+        *reinterpret_cast<int*>(tuple->get_slot(4)) = 12 + i % 2;
+        *reinterpret_cast<int64_t*>(tuple->get_slot(8)) = i;
+        StringValue* str_val = reinterpret_cast<StringValue*>(tuple->get_slot(16));
+        str_val->ptr = (char*)batch.tuple_data_pool()->allocate(10);
+        str_val->len = 3;
+        memcpy(str_val->ptr, "abc", str_val->len);
+        batch.commit_last_row();
+
+        st = sink.send(&state, &batch);
+        ASSERT_TRUE(st.ok());
+        for (auto index_channel : sink._channels) {
+            index_channel->for_each_node_channel(
+                    [](NodeChannel* ch) { ASSERT_LE(ch->_pending_batches_num.load(), 2); });
+        }
+    }
+    st = sink.close(&state, Status::OK());
+    ASSERT_TRUE(st.ok());
+    ASSERT_LT(watch.elapsed_time(), 30 * 1000L * 1000L * 1000L);
+
+    ASSERT_EQ(2, service->eof_counters);
+    ASSERT_EQ(2 * num_rows, service->row_counters);
+    // the sink waited for the full queues of the slow rpcs
+    ASSERT_GT(sink._queue_full_block_timer->value(), 0);
+
+    config::olap_table_sink_max_pending_batches_per_channel = max_pending_batches;
+    config::olap_table_sink_send_interval_ms = send_interval_ms;
+}
+
 } // namespace stream_load
 } // namespace doris
 
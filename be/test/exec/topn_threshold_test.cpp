@@ -0,0 +1,134 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "exec/topn_threshold.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "runtime/string_value.h"
+
+namespace doris {
+
+class TopNThresholdTest : public testing::Test {
+public:
+    TopNThresholdTest() = default;
+};
+
+TEST_F(TopNThresholdTest, asc_nulls_first) {
+    TopNThreshold threshold(1, TypeDescriptor(TYPE_INT), true, true);
+    TopNThreshold::Snapshot snapshot;
+    threshold.get(&snapshot);
+    ASSERT_EQ(0, snapshot.version());
+    // everything passes until there's a threshold
+    int32_t big = 1000;
+    ASSERT_TRUE(snapshot.pass(&big));
+    TCondition condition;
+    ASSERT_FALSE(snapshot.to_condition("k1", &condition));
+
+    int32_t value = 10;
+    threshold.update(&value);
+    // the same value again doesn't change the version
+    threshold.update(&value);
+    ASSERT_EQ(1, threshold.version());
+    threshold.get(&snapshot);
+    ASSERT_EQ(1, snapshot.version());
+
+    int32_t less = 9;
+    int32_t more = 11;
+    ASSERT_TRUE(snapshot.pass(&less));
+    ASSERT_TRUE(snapshot.pass(&value));
+    ASSERT_FALSE(snapshot.pass(&more));
+    ASSERT_TRUE(snapshot.pass(nullptr));
+
+    ASSERT_TRUE(snapshot.to_condition("k1", &condition));
+    ASSERT_EQ("k1", condition.column_name);
+    ASSERT_EQ("<=", condition.condition_op);
+    ASSERT_EQ(1, condition.condition_values.size());
+    ASSERT_EQ("10", condition.condition_values[0]);
+
+    // the snapshot is kept until refreshed
+    value = 5;
+    threshold.update(&value);
+    ASSERT_EQ(2, threshold.version());
+    ASSERT_TRUE(snapshot.pass(&less));
+    threshold.get(&snapshot);
+    ASSERT_FALSE(snapshot.pass(&less));
+}
+
+TEST_F(TopNThresholdTest, desc_nulls_last) {
+    TopNThreshold threshold(1, TypeDescriptor(TYPE_BIGINT), false, false);
+    int64_t value = 100;
+    threshold.update(&value);
+    TopNThreshold::Snapshot snapshot;
+    threshold.get(&snapshot);
+
+    int64_t less = 99;
+    int64_t more = 101;
+    ASSERT_FALSE(snapshot.pass(&less));
+    ASSERT_TRUE(snapshot.pass(&more));
+    ASSERT_FALSE(snapshot.pass(nullptr));
+
+    TCondition condition;
+    ASSERT_TRUE(snapshot.to_condition("v1", &condition));
+    ASSERT_EQ(">=", condition.condition_op);
+    ASSERT_EQ("100", condition.condition_values[0]);
+}
+
+TEST_F(TopNThresholdTest, string_values) {
+    TopNThreshold threshold(1, TypeDescriptor::create_varchar_type(10), true, true);
+    {
+        // the threshold keeps its own copy
+        std::string copy = "doris";
+        StringValue str(const_cast<char*>(copy.data()), copy.size());
+        threshold.update(&str);
+    }
+    TopNThreshold::Snapshot snapshot;
+    threshold.get(&snapshot);
+
+    std::string apache_str = "apache";
+    std::string zoo_str = "zoo";
+    StringValue apache(apache_str);
+    StringValue zoo(zoo_str);
+    ASSERT_TRUE(snapshot.pass(&apache));
+    ASSERT_FALSE(snapshot.pass(&zoo));
+
+    TCondition condition;
+    ASSERT_TRUE(snapshot.to_condition("k2", &condition));
+    ASSERT_EQ("doris", condition.condition_values[0]);
+}
+
+TEST_F(TopNThresholdTest, no_condition_for_floats) {
+    TopNThreshold threshold(1, TypeDescriptor(TYPE_DOUBLE), false, false);
+    double value = 0.1;
+    threshold.update(&value);
+    TopNThreshold::Snapshot snapshot;
+    threshold.get(&snapshot);
+
+    double more = 0.2;
+    ASSERT_TRUE(snapshot.pass(&more));
+    TCondition condition;
+    ASSERT_FALSE(snapshot.to_condition("v2", &condition));
+}
+
+} // namespace doris
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
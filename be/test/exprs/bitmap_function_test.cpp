@@ -171,6 +171,24 @@ TEST_F(BitmapFunctionsTest, bitmap_union) {
     ASSERT_EQ(expected, result);
 }
 
+TEST_F(BitmapFunctionsTest, bitmap_union_batch) {
+    StringVal dst;
+    BitmapFunctions::bitmap_init(ctx, &dst);
+
+    BitmapValue bitmap1(1024);
+    BitmapValue bitmap2({1024, 2048, 4096});
+    // an agg object
+    BitmapValue bitmap3({1, 2});
+    StringVal agg_object(reinterpret_cast<uint8_t*>(&bitmap3), 0);
+    std::vector<StringVal> srcs = {convert_bitmap_to_string(ctx, bitmap1), StringVal::null(),
+                                   convert_bitmap_to_string(ctx, bitmap2), agg_object};
+    BitmapFunctions::bitmap_union_batch(ctx, srcs.data(), srcs.size(), &dst);
+    ASSERT_EQ(BigIntVal(5), BitmapFunctions::bitmap_get_value(ctx, dst));
+
+    BitmapFunctions::bitmap_union_batch(ctx, srcs.data(), 1, &dst);
+    ASSERT_EQ(BigIntVal(5), BitmapFunctions::bitmap_finalize(ctx, dst));
+}
+
 // test bitmap_intersect
 TEST_F(BitmapFunctionsTest, bitmap_intersect) {
     StringVal dst;
@@ -0,0 +1,173 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "exprs/aggregate_functions.h"
+#include "runtime/decimalv2_value.h"
+#include "testutil/function_utils.h"
+#include "udf/udf_internal.h"
+
+namespace doris {
+
+static const __int128 kMax = DecimalV2Value::MAX_DECIMAL_VALUE;
+
+// The layout of the intermediate value of avg() of decimalv2.
+struct AvgState {
+    DecimalV2Val sum;
+    int64_t count;
+};
+
+// Checks that sum() and avg() of decimalv2 give the same results on a batch at once as
+// on its rows one by one.
+class DecimalV2AggBatchTest : public testing::Test {
+public:
+    void SetUp() override {
+        _futil.reset(new FunctionUtils());
+        _ctx = _futil->get_fn_ctx();
+    }
+
+protected:
+    static DecimalV2Val val(__int128 v) { return DecimalV2Val(v); }
+
+    // Sums 'vals' starting from 'init' with both paths and returns the batch result.
+    DecimalV2Val check_sum(const DecimalV2Val& init, const std::vector<DecimalV2Val>& vals) {
+        DecimalV2Val row_sum = init;
+        for (auto& v : vals) {
+            AggregateFunctions::sum<DecimalV2Val, DecimalV2Val>(_ctx, v, &row_sum);
+        }
+        DecimalV2Val batch_sum = init;
+        AggregateFunctions::sum_decimalv2_batch(_ctx, vals.data(), vals.size(), &batch_sum);
+        EXPECT_EQ(row_sum.is_null, batch_sum.is_null);
+        if (!row_sum.is_null) {
+            EXPECT_TRUE(row_sum.val == batch_sum.val);
+        }
+        return batch_sum;
+    }
+
+    // Updates avg() states starting from the sum 'init' over 'num_init' values with both
+    // paths and returns the batch state.
+    AvgState check_avg(__int128 init, int64_t num_init, const std::vector<DecimalV2Val>& vals) {
+        StringVal row_avg;
+        AggregateFunctions::decimalv2_avg_init(_ctx, &row_avg);
+        StringVal batch_avg;
+        AggregateFunctions::decimalv2_avg_init(_ctx, &batch_avg);
+        for (auto avg : {&row_avg, &batch_avg}) {
+            AvgState* state = reinterpret_cast<AvgState*>(avg->ptr);
+            state->sum.val = init;
+            state->count = num_init;
+        }
+        for (auto& v : vals) {
+            if (!v.is_null) {
+                AggregateFunctions::decimalv2_avg_update(_ctx, v, &row_avg);
+            }
+        }
+        AggregateFunctions::decimalv2_avg_update_batch(_ctx, vals.data(), vals.size(),
+                                                       &batch_avg);
+        AvgState row_state = *reinterpret_cast<AvgState*>(row_avg.ptr);
+        AvgState batch_state = *reinterpret_cast<AvgState*>(batch_avg.ptr);
+        EXPECT_TRUE(row_state.sum.val == batch_state.sum.val);
+        EXPECT_EQ(row_state.count, batch_state.count);
+        AggregateFunctions::decimalv2_avg_finalize(_ctx, row_avg);
+        AggregateFunctions::decimalv2_avg_finalize(_ctx, batch_avg);
+        return batch_state;
+    }
+
+    std::unique_ptr<FunctionUtils> _futil;
+    FunctionContext* _ctx = nullptr;
+};
+
+TEST_F(DecimalV2AggBatchTest, nulls) {
+    std::vector<DecimalV2Val> vals = {val(1), DecimalV2Val::null(), val(-5), val(20),
+                                      DecimalV2Val::null()};
+    DecimalV2Val sum = check_sum(DecimalV2Val::null(), vals);
+    ASSERT_FALSE(sum.is_null);
+    ASSERT_TRUE(sum.val == 16);
+    sum = check_sum(val(100), vals);
+    ASSERT_TRUE(sum.val == 116);
+    AvgState avg = check_avg(0, 0, vals);
+    ASSERT_TRUE(avg.sum.val == 16);
+    ASSERT_EQ(3, avg.count);
+
+    // only nulls leave the sum null and the count as it is
+    std::vector<DecimalV2Val> nulls(3, DecimalV2Val::null());
+    ASSERT_TRUE(check_sum(DecimalV2Val::null(), nulls).is_null);
+    ASSERT_TRUE(check_sum(val(7), nulls).val == 7);
+    ASSERT_EQ(2, check_avg(7, 2, nulls).count);
+    ASSERT_TRUE(check_sum(DecimalV2Val::null(), {}).is_null);
+}
+
+TEST_F(DecimalV2AggBatchTest, overflow) {
+    // the running sum saturates at MAX, then goes back into the range
+    DecimalV2Val sum = check_sum(DecimalV2Val::null(), {val(kMax), val(kMax), val(-kMax)});
+    ASSERT_TRUE(sum.val == 0);
+    ASSERT_TRUE(check_avg(0, 0, {val(kMax), val(kMax), val(-kMax)}).sum.val == 0);
+    sum = check_sum(DecimalV2Val::null(), {val(-kMax), DecimalV2Val::null(), val(-1), val(1)});
+    ASSERT_TRUE(sum.val == -kMax + 1);
+
+    // it saturates on a single row of the batch near the limit
+    sum = check_sum(val(kMax - 10), {val(5), val(6), val(-7)});
+    ASSERT_TRUE(sum.val == kMax - 7);
+    ASSERT_TRUE(check_avg(kMax - 10, 1, {val(5), val(6), val(-7)}).sum.val == kMax - 7);
+    sum = check_sum(val(-kMax + 10), {val(-11), val(3)});
+    ASSERT_TRUE(sum.val == -kMax + 3);
+
+    // and stays at the limit
+    sum = check_sum(val(kMax), {val(kMax), val(kMax)});
+    ASSERT_TRUE(sum.val == kMax);
+
+    // right at the limit nothing saturates
+    sum = check_sum(val(kMax - 10), {val(4), val(6), val(-10)});
+    ASSERT_TRUE(sum.val == kMax - 10);
+}
+
+TEST_F(DecimalV2AggBatchTest, random_batches) {
+    std::mt19937_64 random(42);
+    // values of up to a quarter of the range, so the running sums cross the limits
+    auto random_val = [&random]() {
+        if (random() % 8 == 0) {
+            return DecimalV2Val::null();
+        }
+        __int128 v = static_cast<__int128>(random()) << 29 | random() % (1 << 29);
+        v %= kMax / 4;
+        return val(random() % 2 == 0 ? v : -v);
+    };
+    DecimalV2Val sum = DecimalV2Val::null();
+    __int128 avg_sum = 0;
+    int64_t avg_count = 0;
+    for (int i = 0; i < 200; ++i) {
+        std::vector<DecimalV2Val> vals(random() % 100);
+        for (auto& v : vals) {
+            v = random_val();
+        }
+        sum = check_sum(sum, vals);
+        AvgState avg = check_avg(avg_sum, avg_count, vals);
+        avg_sum = avg.sum.val;
+        avg_count = avg.count;
+    }
+}
+
+} // namespace doris
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,204 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+#include "common/object_pool.h"
+#include "exec/exec_node.h"
+#include "exprs/expr.h"
+#include "exprs/expr_column.h"
+#include "exprs/expr_context.h"
+#include "exprs/slot_ref.h"
+#include "gen_cpp/Exprs_types.h"
+#include "runtime/descriptor_helper.h"
+#include "runtime/descriptors.h"
+#include "runtime/mem_tracker.h"
+#include "runtime/row_batch.h"
+#include "runtime/tuple_row.h"
+
+namespace doris {
+
+class ExprBatchTest : public testing::Test {
+public:
+    ExprBatchTest() = default;
+
+    void SetUp() override {
+        TDescriptorTableBuilder dtb;
+        TTupleDescriptorBuilder tuple_builder;
+        tuple_builder.add_slot(TSlotDescriptorBuilder()
+                                       .type(TYPE_INT)
+                                       .nullable(true)
+                                       .column_name("c1")
+                                       .column_pos(0)
+                                       .build());
+        tuple_builder.build(&dtb);
+        ASSERT_TRUE(DescriptorTbl::create(&_pool, dtb.desc_tbl(), &_desc_tbl).ok());
+        _row_desc.reset(new RowDescriptor(*_desc_tbl, {0}, {false}));
+        _slot_desc = _desc_tbl->get_tuple_descriptor(0)->slots()[0];
+
+        // c1 is the row index, row 3 is null
+        _tracker = std::make_shared<MemTracker>();
+        _batch.reset(new RowBatch(*_row_desc, 1024, _tracker.get()));
+        int tuple_size = _desc_tbl->get_tuple_descriptor(0)->byte_size();
+        for (int i = 0; i < 10; ++i) {
+            Tuple* tuple = reinterpret_cast<Tuple*>(
+                    _batch->tuple_data_pool()->allocate(tuple_size));
+            memset(tuple, 0, tuple_size);
+            if (i == 3) {
+                tuple->set_null(_slot_desc->null_indicator_offset());
+            } else {
+                *reinterpret_cast<int32_t*>(tuple->get_slot(_slot_desc->tuple_offset())) = i;
+            }
+            _batch->get_row(_batch->add_row())->set_tuple(0, tuple);
+            _batch->commit_last_row();
+        }
+    }
+
+protected:
+    static TExprNode node(TExprNodeType::type node_type, PrimitiveType type, int num_children) {
+        TExprNode node;
+        node.__set_node_type(node_type);
+        node.__set_type(TypeDescriptor(type).to_thrift());
+        node.__set_num_children(num_children);
+        node.__set_output_scale(-1);
+        return node;
+    }
+
+    static TExprNode slot_node() {
+        TExprNode slot = node(TExprNodeType::SLOT_REF, TYPE_INT, 0);
+        TSlotRef slot_ref;
+        slot_ref.__set_slot_id(0);
+        slot_ref.__set_tuple_id(0);
+        slot.__set_slot_ref(slot_ref);
+        return slot;
+    }
+
+    static TExprNode int_node(int64_t value) {
+        TExprNode literal = node(TExprNodeType::INT_LITERAL, TYPE_INT, 0);
+        TIntLiteral int_literal;
+        int_literal.__set_value(value);
+        literal.__set_int_literal(int_literal);
+        return literal;
+    }
+
+    static TExprNode binary_pred_node(TExprOpcode::type op) {
+        TExprNode pred = node(TExprNodeType::BINARY_PRED, TYPE_BOOLEAN, 2);
+        pred.__set_opcode(op);
+        pred.__set_child_type(TPrimitiveType::INT);
+        return pred;
+    }
+
+    // c1 < 5 or c1 + 1 = 8
+    ExprContext* create_filter() {
+        TExpr texpr;
+        TExprNode or_pred = node(TExprNodeType::COMPOUND_PRED, TYPE_BOOLEAN, 2);
+        or_pred.__set_opcode(TExprOpcode::COMPOUND_OR);
+        texpr.nodes.push_back(or_pred);
+        texpr.nodes.push_back(binary_pred_node(TExprOpcode::LT));
+        texpr.nodes.push_back(slot_node());
+        texpr.nodes.push_back(int_node(5));
+        texpr.nodes.push_back(binary_pred_node(TExprOpcode::EQ));
+        TExprNode add = node(TExprNodeType::ARITHMETIC_EXPR, TYPE_INT, 2);
+        add.__set_opcode(TExprOpcode::ADD);
+        texpr.nodes.push_back(add);
+        texpr.nodes.push_back(slot_node());
+        texpr.nodes.push_back(int_node(1));
+        texpr.nodes.push_back(int_node(8));
+
+        ExprContext* ctx = nullptr;
+        EXPECT_TRUE(Expr::create_expr_tree(&_pool, texpr, &ctx).ok());
+        prepare_slot_refs(ctx->root());
+        return ctx;
+    }
+
+    void prepare_slot_refs(Expr* expr) {
+        if (expr->is_slotref()) {
+            ASSERT_TRUE(static_cast<SlotRef*>(expr)->prepare(_slot_desc, *_row_desc).ok());
+        }
+        for (int i = 0; i < expr->get_num_children(); ++i) {
+            prepare_slot_refs(expr->get_child(i));
+        }
+    }
+
+    std::vector<int> all_rows() const {
+        std::vector<int> sel(_batch->num_rows());
+        for (int i = 0; i < sel.size(); ++i) {
+            sel[i] = i;
+        }
+        return sel;
+    }
+
+    ObjectPool _pool;
+    DescriptorTbl* _desc_tbl = nullptr;
+    std::unique_ptr<RowDescriptor> _row_desc;
+    SlotDescriptor* _slot_desc = nullptr;
+    std::shared_ptr<MemTracker> _tracker;
+    std::unique_ptr<RowBatch> _batch;
+};
+
+TEST_F(ExprBatchTest, same_as_row_at_a_time) {
+    ExprContext* ctx = create_filter();
+    std::vector<int> sel = all_rows();
+    ExprColumn column;
+    ctx->evaluate_batch(_batch.get(), sel.data(), sel.size(), &column);
+    const BooleanVal* values = column.values<BooleanVal>();
+    for (int i = 0; i < _batch->num_rows(); ++i) {
+        BooleanVal expected = ctx->get_boolean_val(_batch->get_row(i));
+        ASSERT_EQ(expected.is_null, values[i].is_null) << "row " << i;
+        if (!expected.is_null) {
+            ASSERT_EQ(expected.val, values[i].val) << "row " << i;
+        }
+    }
+    ASSERT_TRUE(values[3].is_null);
+}
+
+TEST_F(ExprBatchTest, slot_ref_column) {
+    ExprContext* ctx = create_filter();
+    Expr* slot_ref = ctx->root()->get_child(0)->get_child(0);
+    // only the selected rows are evaluated
+    std::vector<int> sel = {1, 3, 8};
+    ExprColumn column;
+    slot_ref->evaluate_batch(ctx, _batch.get(), sel.data(), sel.size(), &column);
+    const IntVal* values = column.values<IntVal>();
+    ASSERT_EQ(IntVal(1), values[1]);
+    ASSERT_TRUE(values[3].is_null);
+    ASSERT_EQ(IntVal(8), values[8]);
+}
+
+TEST_F(ExprBatchTest, eval_conjuncts) {
+    ExprContext* ctx = create_filter();
+    std::vector<int> sel = all_rows();
+    int num_sel = ExecNode::eval_conjuncts(&ctx, 1, _batch.get(), sel.data(), sel.size());
+    ASSERT_EQ(5, num_sel);
+    std::vector<int> expected = {0, 1, 2, 4, 7};
+    ASSERT_EQ(expected, std::vector<int>(sel.begin(), sel.begin() + num_sel));
+
+    // a selection is narrowed further
+    num_sel = ExecNode::eval_conjuncts(&ctx, 1, _batch.get(), sel.data(), 2);
+    ASSERT_EQ(2, num_sel);
+    ASSERT_EQ(1, sel[1]);
+}
+
+} // namespace doris
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -21,6 +21,7 @@
 
 #include <iostream>
 #include <string>
+#include <vector>
 
 #include "exprs/aggregate_functions.h"
 #include "exprs/anyval_util.h"
@@ -107,6 +108,21 @@ TEST_F(HllFunctionsTest, hll_merge) {
     ASSERT_EQ(expected, hll.estimate_cardinality());
 }
 
+TEST_F(HllFunctionsTest, hll_batch) {
+    std::vector<IntVal> ints = {IntVal(1), IntVal::null(), IntVal(1234567), IntVal(1)};
+    StringVal dst;
+    HllFunctions::hll_init(ctx, &dst);
+    HllFunctions::hll_update_batch(ctx, ints.data(), ints.size(), &dst);
+    ASSERT_EQ(BigIntVal(2), HllFunctions::hll_get_value(ctx, dst));
+
+    HyperLogLog hll1(1024);
+    HyperLogLog hll2;
+    std::vector<StringVal> srcs = {convert_hll_to_string(ctx, hll1), StringVal::null(),
+                                   convert_hll_to_string(ctx, hll2)};
+    HllFunctions::hll_merge_batch(ctx, srcs.data(), srcs.size(), &dst);
+    ASSERT_EQ(BigIntVal(3), HllFunctions::hll_finalize(ctx, dst));
+}
+
 } // namespace doris
 
 int main(int argc, char** argv) {
@@ -20,6 +20,7 @@
 #include <gtest/gtest.h>
 
 #include <string>
+#include <vector>
 
 #include "common/configbase.h"
 #include "util/logging.h"
@@ -375,6 +376,84 @@ TEST_F(HybridSetTest, timestamp) {
     ASSERT_FALSE(set->find(&v23));
 }
 
+TEST_F(HybridSetTest, large_bigint) {
+    HybridSetBase* set = HybridSetBase::create_set(TYPE_BIGINT);
+    // grows past the small set into the table
+    for (int64_t i = 0; i < 1000; ++i) {
+        int64_t a = i * 7;
+        set->insert(&a);
+        set->insert(&a);
+    }
+    ASSERT_EQ(1000, set->size());
+    for (int64_t i = 0; i < 7000; ++i) {
+        ASSERT_EQ(i % 7 == 0, set->find(&i)) << i;
+    }
+
+    std::vector<int64_t> values = {0, 1, 14, 6993, 7000, -7};
+    std::vector<int> sel = {0, 1, 2, 3, 4, 5};
+    int num_found = set->find_batch(values.data(), sizeof(int64_t), sel.data(), sel.size(),
+                                    sel.data());
+    ASSERT_EQ(3, num_found);
+    ASSERT_EQ(0, sel[0]);
+    ASSERT_EQ(2, sel[1]);
+    ASSERT_EQ(3, sel[2]);
+
+    int count = 0;
+    HybridSetBase::IteratorBase* base = set->begin();
+    while (base->has_next()) {
+        ASSERT_EQ(0, *(int64_t*)base->get_value() % 7);
+        ++count;
+        base->next();
+    }
+    ASSERT_EQ(1000, count);
+}
+
+TEST_F(HybridSetTest, large_string) {
+    HybridSetBase* set = HybridSetBase::create_set(TYPE_VARCHAR);
+    std::vector<std::string> strs;
+    for (int i = 0; i < 100; ++i) {
+        strs.push_back("id_" + std::to_string(i * 2));
+    }
+    for (auto& str : strs) {
+        StringValue a(str);
+        set->insert(&a);
+    }
+    ASSERT_EQ(100, set->size());
+
+    std::vector<std::string> probes = {"id_0", "id_1", "id_198", "id_200", "", "id_42"};
+    std::vector<StringValue> values;
+    for (auto& probe : probes) {
+        values.emplace_back(probe);
+    }
+    std::vector<int> sel = {5, 4, 3, 2, 1, 0};
+    std::vector<int> found(sel.size());
+    int num_found = set->find_batch(values.data(), sizeof(StringValue), sel.data(), sel.size(),
+                                    found.data());
+    ASSERT_EQ(3, num_found);
+    ASSERT_EQ(5, found[0]);
+    ASSERT_EQ(2, found[1]);
+    ASSERT_EQ(0, found[2]);
+}
+
+TEST_F(HybridSetTest, flat_set) {
+    FlatSet<int32_t> set;
+    ASSERT_TRUE(set.empty());
+    for (int32_t i = 0; i < 100; ++i) {
+        ASSERT_TRUE(set.insert(-i * 3));
+        ASSERT_FALSE(set.insert(-i * 3));
+        ASSERT_EQ(i + 1, set.size());
+    }
+    for (int32_t i = -299; i < 10; ++i) {
+        ASSERT_EQ(i <= 0 && i % 3 == 0, set.contains(i)) << i;
+    }
+    // in the order of insertion
+    int32_t expected = 0;
+    for (int32_t value : set) {
+        ASSERT_EQ(expected, value);
+        expected -= 3;
+    }
+}
+
 } // namespace doris
 
 int main(int argc, char** argv) {
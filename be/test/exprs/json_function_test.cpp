@@ -275,6 +275,38 @@ TEST_F(JsonFunctionTest, json_path_test) {
     }
 }
 
+TEST_F(JsonFunctionTest, only_value_parsed) {
+    auto get = [](const std::string& json, const std::string& path) {
+        rapidjson::Document document;
+        rapidjson::Value* res = JsonFunctions::get_json_object(nullptr, json, path,
+                                                               JSON_FUN_STRING, &document);
+        if (res == nullptr || res->IsNull()) {
+            return std::string("NULL");
+        }
+        rapidjson::StringBuffer buf;
+        rapidjson::Writer<rapidjson::StringBuffer> writer(buf);
+        res->Accept(writer);
+        return std::string(buf.GetString());
+    };
+    std::string json = " {\"a\" : {\"b\": [1, {\"c\": \"x\"}, 2.50]}, \"d\": true, \"d\": 3} ";
+    ASSERT_EQ("\"x\"", get(json, "$.a.b[1].c"));
+    ASSERT_EQ("2.5", get(json, "$.a.b[2]"));
+    ASSERT_EQ("[1,{\"c\":\"x\"},2.5]", get(json, "$.a.b"));
+    // the first of the members with the same name
+    ASSERT_EQ("true", get(json, "$.d"));
+    ASSERT_EQ("NULL", get(json, "$.a.b[3]"));
+    ASSERT_EQ("NULL", get(json, "$.a.e"));
+    ASSERT_EQ("NULL", get(json, "$.d.e"));
+    // escaped names are compared unescaped
+    ASSERT_EQ("1", get("{\"\\u0061\": 1}", "$.a"));
+    // the whole document must be valid
+    ASSERT_EQ("NULL", get("{\"a\": 1, \"b\": tru}", "$.a"));
+    ASSERT_EQ("NULL", get("{\"a\": 1} {}", "$.a"));
+    ASSERT_EQ("NULL", get("{\"a\": 1, \"b\": [}", "$.a"));
+    // the document ends at the first '\0'
+    ASSERT_EQ("1", get(std::string("{\"a\": 1}\0xx", 11), "$.a"));
+}
+
 } // namespace doris
 
 int main(int argc, char** argv) {
@@ -0,0 +1,90 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "exprs/json_walker.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+namespace doris {
+
+static std::string text(const char* begin, const char* end) {
+    return std::string(begin, end - begin);
+}
+
+TEST(JsonWalkerTest, validate) {
+    auto validate = [](const std::string& json) {
+        return JsonWalker(json.data(), json.size()).validate();
+    };
+    ASSERT_EQ(JsonWalker::FOUND, validate(" {\"a\": [1, -2.5e3, \"x\\n\"], \"b\": null} "));
+    ASSERT_EQ(JsonWalker::FOUND, validate("[]"));
+    ASSERT_EQ(JsonWalker::MISSING, validate(""));
+    ASSERT_EQ(JsonWalker::MISSING, validate("{\"a\": 01}"));
+    ASSERT_EQ(JsonWalker::MISSING, validate("[1,]"));
+    ASSERT_EQ(JsonWalker::MISSING, validate("{} {}"));
+    // left to rapidjson
+    ASSERT_EQ(JsonWalker::UNSUPPORTED, validate("[\"\\ud800\"]"));
+}
+
+TEST(JsonWalkerTest, members) {
+    std::string json = "{ \"a\" : \"x\", \"b\\u0062\": {\"c\": [1]} , \"d\":true }";
+    JsonWalker walker(json.data(), json.size());
+    ASSERT_EQ(JsonWalker::FOUND, walker.enter());
+    std::vector<std::string> names;
+    std::vector<bool> escaped;
+    std::vector<std::string> values;
+    const char* name = nullptr;
+    size_t name_len = 0;
+    bool name_escaped = false;
+    const char* value = nullptr;
+    const char* value_end = nullptr;
+    while (walker.next_member(&name, &name_len, &name_escaped, &value, &value_end) ==
+           JsonWalker::FOUND) {
+        names.emplace_back(name, name_len);
+        escaped.push_back(name_escaped);
+        values.push_back(text(value, value_end));
+    }
+    ASSERT_EQ(std::vector<std::string>({"a", "b\\u0062", "d"}), names);
+    ASSERT_EQ(std::vector<bool>({false, true, false}), escaped);
+    ASSERT_EQ(std::vector<std::string>({"\"x\"", "{\"c\": [1]}", "true"}), values);
+}
+
+TEST(JsonWalkerTest, elements) {
+    std::string json = " [ {\"a\": 1}, 2 ,\"s\"]";
+    JsonWalker walker(json.data(), json.size());
+    ASSERT_EQ(JsonWalker::FOUND, walker.enter());
+    std::vector<std::string> values;
+    const char* value = nullptr;
+    const char* value_end = nullptr;
+    while (walker.next_element(&value, &value_end) == JsonWalker::FOUND) {
+        values.push_back(text(value, value_end));
+    }
+    ASSERT_EQ(std::vector<std::string>({"{\"a\": 1}", "2", "\"s\""}), values);
+
+    std::string scalar = "1";
+    ASSERT_EQ(JsonWalker::MISSING, JsonWalker(scalar.data(), scalar.size()).enter());
+}
+
+} // namespace doris
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,100 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "exprs/minmax_filter.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "common/object_pool.h"
+#include "exprs/expr.h"
+#include "exprs/expr_context.h"
+#include "exprs/slot_ref.h"
+#include "runtime/string_value.h"
+
+namespace doris {
+
+class MinMaxFilterTest : public testing::Test {
+public:
+    MinMaxFilterTest() = default;
+};
+
+TEST_F(MinMaxFilterTest, int_values) {
+    MinMaxFilter filter(TypeDescriptor(TYPE_INT));
+    ASSERT_TRUE(filter.empty());
+
+    int32_t values[] = {5, -3, 100, 7, 42};
+    for (auto& value : values) {
+        filter.insert(&value);
+    }
+    ASSERT_FALSE(filter.empty());
+    ASSERT_EQ(-3, *reinterpret_cast<const int32_t*>(filter.min_value()));
+    ASSERT_EQ(100, *reinterpret_cast<const int32_t*>(filter.max_value()));
+}
+
+TEST_F(MinMaxFilterTest, string_values) {
+    MinMaxFilter filter(TypeDescriptor(TYPE_VARCHAR));
+    std::string values[] = {"doris", "apache", "zoo", "be"};
+    for (auto& value : values) {
+        // filter must keep its own copy
+        std::string copy = value;
+        StringValue str(const_cast<char*>(copy.data()), copy.size());
+        filter.insert(&str);
+    }
+    ASSERT_EQ("apache", reinterpret_cast<const StringValue*>(filter.min_value())->to_string());
+    ASSERT_EQ("zoo", reinterpret_cast<const StringValue*>(filter.max_value())->to_string());
+}
+
+TEST_F(MinMaxFilterTest, unsupported_type) {
+    ASSERT_TRUE(MinMaxFilter::is_supported(TypeDescriptor(TYPE_BIGINT)));
+    ASSERT_TRUE(MinMaxFilter::is_supported(TypeDescriptor(TYPE_DATETIME)));
+    ASSERT_FALSE(MinMaxFilter::is_supported(TypeDescriptor(TYPE_HLL)));
+    ASSERT_FALSE(MinMaxFilter::is_supported(TypeDescriptor(TYPE_OBJECT)));
+}
+
+TEST_F(MinMaxFilterTest, create_predicates) {
+    ObjectPool pool;
+    SlotRef* slot_ref = pool.add(new SlotRef(TypeDescriptor(TYPE_BIGINT), 0));
+
+    MinMaxFilter filter(TypeDescriptor(TYPE_BIGINT));
+    int64_t values[] = {10, 1, 20};
+    for (auto& value : values) {
+        filter.insert(&value);
+    }
+
+    std::list<ExprContext*> ctxs;
+    ASSERT_TRUE(filter.create_predicates(&pool, slot_ref, &ctxs).ok());
+    ASSERT_EQ(2, ctxs.size());
+
+    Expr* ge = ctxs.front()->root();
+    ASSERT_EQ(TExprNodeType::BINARY_PRED, ge->node_type());
+    ASSERT_EQ(TExprOpcode::GE, ge->op());
+    ASSERT_EQ(2, ge->get_num_children());
+    ASSERT_TRUE(ge->get_child(1)->is_constant());
+
+    Expr* le = ctxs.back()->root();
+    ASSERT_EQ(TExprNodeType::BINARY_PRED, le->node_type());
+    ASSERT_EQ(TExprOpcode::LE, le->op());
+}
+
+} // namespace doris
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -17,8 +17,11 @@
 
 #include <gtest/gtest.h>
 
+#include <vector>
+
 #include "exprs/aggregate_functions.h"
 #include "testutil/function_utils.h"
+#include "udf/udf_internal.h"
 
 namespace doris {
 
@@ -119,6 +122,48 @@ TEST_F(PercentileApproxTest, testNullVale) {
     delete futil;
 }
 
+TEST_F(PercentileApproxTest, testBatch) {
+    FunctionUtils futil;
+    doris_udf::FunctionContext* context = futil.get_fn_ctx();
+
+    DoubleVal doubleQ(0.5);
+    std::vector<doris_udf::AnyVal*> const_vals = {nullptr, &doubleQ};
+    context->impl()->set_constant_args(const_vals);
+
+    // the values of each state are the same as the ones of one batch
+    std::vector<DoubleVal> vals;
+    std::vector<StringVal> serialized;
+    for (int i = 0; i < 4; i++) {
+        StringVal rowVal;
+        StringVal batchVal;
+        AggregateFunctions::percentile_approx_init(context, &rowVal);
+        AggregateFunctions::percentile_approx_init(context, &batchVal);
+        vals.clear();
+        for (int j = 0; j < 1000; j++) {
+            vals.push_back(j % 7 == 0 ? DoubleVal::null() : DoubleVal(i * 1000 + j));
+            AggregateFunctions::percentile_approx_update(context, vals.back(), doubleQ, &rowVal);
+        }
+        AggregateFunctions::percentile_approx_update_batch(context, vals.data(), vals.size(),
+                                                           &batchVal);
+        serialized.push_back(AggregateFunctions::percentile_approx_serialize(context, rowVal));
+        serialized.push_back(AggregateFunctions::percentile_approx_serialize(context, batchVal));
+    }
+
+    StringVal rowVal;
+    AggregateFunctions::percentile_approx_init(context, &rowVal);
+    for (int i = 0; i < serialized.size(); i += 2) {
+        AggregateFunctions::percentile_approx_merge(context, serialized[i], &rowVal);
+        ASSERT_EQ(serialized[i], serialized[i + 1]);
+    }
+    StringVal batchVal;
+    AggregateFunctions::percentile_approx_init(context, &batchVal);
+    AggregateFunctions::percentile_approx_merge_batch(context, serialized.data(),
+                                                      serialized.size(), &batchVal);
+    DoubleVal v = AggregateFunctions::percentile_approx_finalize(context, rowVal);
+    ASSERT_NEAR(v.val, 2000, 10);
+    ASSERT_NEAR(v.val, AggregateFunctions::percentile_approx_finalize(context, batchVal).val, 1);
+}
+
 } // namespace doris
 
 int main(int argc, char** argv) {
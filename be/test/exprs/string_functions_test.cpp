@@ -319,6 +319,12 @@ TEST_F(StringFunctionsTest, substring) {
 
     ASSERT_EQ(AnyValUtil::from_string_temp(context, std::string("h")),
               StringFunctions::substring(context, StringVal("hello word 你好"), 1, 1));
+
+    ASSERT_EQ(AnyValUtil::from_string_temp(context, std::string("word")),
+              StringFunctions::substring(context, StringVal("hello word"), -4, 10));
+
+    ASSERT_EQ(AnyValUtil::from_string_temp(context, std::string("d")),
+              StringFunctions::substring(context, StringVal("hello word"), 10));
     delete context;
 }
 
@@ -354,6 +360,24 @@ TEST_F(StringFunctionsTest, length) {
     delete context;
 }
 
+TEST_F(StringFunctionsTest, lower_upper) {
+    ASSERT_EQ(StringVal("hello"), StringFunctions::lower(ctx, StringVal("HeLLo")));
+    ASSERT_EQ(StringVal("HELLO"), StringFunctions::upper(ctx, StringVal("HeLLo")));
+    ASSERT_EQ(StringVal(""), StringFunctions::lower(ctx, StringVal("")));
+    ASSERT_EQ(StringVal::null(), StringFunctions::upper(ctx, StringVal::null()));
+
+    // longer than a simd register, with multi byte chars and the bytes around the letters
+    std::string str = "@AZ[`az{ Hello World 你好 Doris @AZ[`az{";
+    std::string lower = str;
+    std::string upper = str;
+    for (int i = 0; i < str.size(); ++i) {
+        lower[i] = ::tolower(str[i]);
+        upper[i] = ::toupper(str[i]);
+    }
+    ASSERT_EQ(StringVal(lower.c_str()), StringFunctions::lower(ctx, StringVal(str.c_str())));
+    ASSERT_EQ(StringVal(upper.c_str()), StringFunctions::upper(ctx, StringVal(str.c_str())));
+}
+
 TEST_F(StringFunctionsTest, append_trailing_char_if_absent) {
     ASSERT_EQ(StringVal("ac"),
               StringFunctions::append_trailing_char_if_absent(ctx, StringVal("a"), StringVal("c")));
@@ -468,6 +492,8 @@ TEST_F(StringFunctionsTest, lpad) {
               StringFunctions::lpad(ctx, StringVal("hi"), IntVal(1), StringVal("?")));
     ASSERT_EQ(StringVal("你"),
               StringFunctions::lpad(ctx, StringVal("你好"), IntVal(1), StringVal("?")));
+    ASSERT_EQ(StringVal("你好"),
+              StringFunctions::lpad(ctx, StringVal("你好"), IntVal(2), StringVal("?")));
     ASSERT_EQ(StringVal(""),
               StringFunctions::lpad(ctx, StringVal("hi"), IntVal(0), StringVal("?")));
     ASSERT_EQ(StringVal::null(),
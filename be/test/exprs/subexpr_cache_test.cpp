@@ -0,0 +1,340 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "exprs/subexpr_cache.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/object_pool.h"
+#include "exprs/expr.h"
+#include "exprs/expr_context.h"
+#include "exprs/math_functions.h"
+#include "exprs/scalar_fn_call.h"
+#include "exprs/string_functions.h"
+#include "gen_cpp/Exprs_types.h"
+#include "runtime/descriptor_helper.h"
+#include "runtime/descriptors.h"
+#include "runtime/mem_pool.h"
+#include "runtime/mem_tracker.h"
+#include "runtime/runtime_state.h"
+#include "runtime/string_value.h"
+#include "runtime/tuple.h"
+#include "runtime/tuple_row.h"
+#include "runtime/user_function_cache.h"
+#include "util/cpu_info.h"
+
+namespace doris {
+
+static const std::string kUpper =
+        "_ZN5doris15StringFunctions5upperEPN9doris_udf15FunctionContextERKNS1_9StringValE";
+static const std::string kLower =
+        "_ZN5doris15StringFunctions5lowerEPN9doris_udf15FunctionContextERKNS1_9StringValE";
+static const std::string kInstr =
+        "_ZN5doris15StringFunctions5instrEPN9doris_udf15FunctionContextERKNS1_9StringValES6_";
+static const std::string kRandSeed =
+        "_ZN5doris13MathFunctions9rand_seedEPN9doris_udf15FunctionContextERKNS1_9BigIntValE";
+static const std::string kRandPrepare =
+        "_ZN5doris13MathFunctions12rand_prepareEPN9doris_udf15FunctionContextENS2_"
+        "18FunctionStateScopeE";
+static const std::string kRandClose =
+        "_ZN5doris13MathFunctions10rand_closeEPN9doris_udf15FunctionContextENS2_"
+        "18FunctionStateScopeE";
+
+class SubexprCacheTest : public testing::Test {
+public:
+    SubexprCacheTest() : _runtime_state(TQueryGlobals()) {
+        _runtime_state._instance_mem_tracker.reset(new MemTracker());
+    }
+
+    static void SetUpTestCase() {
+        // the builtins are looked up in the process
+        UserFunctionCache::instance()->init(
+                "./be/test/runtime/test_data/user_function_cache/normal");
+        StringFunctions::init();
+        MathFunctions::init();
+    }
+
+    // tuple 0 of (k varchar null)
+    void SetUp() override {
+        TDescriptorTableBuilder dtb;
+        TTupleDescriptorBuilder tuple_builder;
+        tuple_builder.add_slot(TSlotDescriptorBuilder()
+                                       .string_type(64)
+                                       .nullable(true)
+                                       .column_name("k")
+                                       .column_pos(0)
+                                       .build());
+        tuple_builder.build(&dtb);
+        ASSERT_TRUE(DescriptorTbl::create(&_pool, dtb.desc_tbl(), &_desc_tbl).ok());
+        _runtime_state.set_desc_tbl(_desc_tbl);
+        _row_desc.reset(new RowDescriptor(*_desc_tbl, {0}, {false}));
+        _tracker = std::make_shared<MemTracker>();
+        _mem_pool.reset(new MemPool(_tracker.get()));
+    }
+
+    void TearDown() override {
+        for (auto ctx : _ctxs) {
+            ctx->close(&_runtime_state);
+        }
+    }
+
+protected:
+    static TExprNode node(TExprNodeType::type node_type, PrimitiveType type, int num_children) {
+        TExprNode node;
+        node.__set_node_type(node_type);
+        node.__set_type(TypeDescriptor(type).to_thrift());
+        node.__set_num_children(num_children);
+        node.__set_output_scale(-1);
+        return node;
+    }
+
+    static TExprNode slot_node() {
+        TExprNode slot = node(TExprNodeType::SLOT_REF, TYPE_VARCHAR, 0);
+        TSlotRef slot_ref;
+        slot_ref.__set_slot_id(0);
+        slot_ref.__set_tuple_id(0);
+        slot.__set_slot_ref(slot_ref);
+        return slot;
+    }
+
+    static TExprNode string_node(const std::string& value) {
+        TExprNode literal = node(TExprNodeType::STRING_LITERAL, TYPE_VARCHAR, 0);
+        TStringLiteral string_literal;
+        string_literal.__set_value(value);
+        literal.__set_string_literal(string_literal);
+        return literal;
+    }
+
+    static TExprNode bigint_node(int64_t value) {
+        TExprNode literal = node(TExprNodeType::INT_LITERAL, TYPE_BIGINT, 0);
+        TIntLiteral int_literal;
+        int_literal.__set_value(value);
+        literal.__set_int_literal(int_literal);
+        return literal;
+    }
+
+    static TExprNode fn_node(const std::string& name, PrimitiveType ret_type,
+                             const std::vector<PrimitiveType>& arg_types,
+                             const std::string& symbol) {
+        TExprNode fn_call = node(TExprNodeType::FUNCTION_CALL, ret_type, arg_types.size());
+        TFunction fn;
+        TFunctionName fn_name;
+        fn_name.__set_function_name(name);
+        fn.__set_name(fn_name);
+        fn.__set_binary_type(TFunctionBinaryType::BUILTIN);
+        for (auto arg_type : arg_types) {
+            fn.arg_types.push_back(TypeDescriptor(arg_type).to_thrift());
+        }
+        fn.__set_ret_type(TypeDescriptor(ret_type).to_thrift());
+        fn.__set_has_var_args(false);
+        TScalarFunction scalar_fn;
+        scalar_fn.__set_symbol(symbol);
+        fn.__set_scalar_fn(scalar_fn);
+        fn_call.__set_fn(fn);
+        return fn_call;
+    }
+
+    static TExprNode upper_node() { return fn_node("upper", TYPE_VARCHAR, {TYPE_VARCHAR}, kUpper); }
+
+    static TExprNode lower_node() { return fn_node("lower", TYPE_VARCHAR, {TYPE_VARCHAR}, kLower); }
+
+    static TExprNode instr_node() {
+        return fn_node("instr", TYPE_INT, {TYPE_VARCHAR, TYPE_VARCHAR}, kInstr);
+    }
+
+    static TExprNode rand_node() {
+        TExprNode rand = fn_node("rand", TYPE_DOUBLE, {TYPE_BIGINT}, kRandSeed);
+        rand.fn.scalar_fn.__set_prepare_fn_symbol(kRandPrepare);
+        rand.fn.scalar_fn.__set_close_fn_symbol(kRandClose);
+        return rand;
+    }
+
+    static TExpr texpr(const std::vector<TExprNode>& nodes) {
+        TExpr texpr;
+        texpr.nodes = nodes;
+        return texpr;
+    }
+
+    void create_ctxs(const std::vector<TExpr>& texprs) {
+        for (auto& texpr : texprs) {
+            ExprContext* ctx = nullptr;
+            ASSERT_TRUE(Expr::create_expr_tree(&_pool, texpr, &ctx).ok());
+            _ctxs.push_back(ctx);
+        }
+    }
+
+    // Prepares and opens the ctxs the way a scanner does, the cache is created on the
+    // opened ctxs.
+    void open_ctxs() {
+        for (auto ctx : _ctxs) {
+            ASSERT_TRUE(ctx->prepare(&_runtime_state, *_row_desc, _tracker).ok());
+            ASSERT_TRUE(ctx->open(&_runtime_state).ok());
+        }
+    }
+
+    TupleRow* create_row(const std::string& k) {
+        const TupleDescriptor* tuple_desc = _desc_tbl->get_tuple_descriptor(0);
+        Tuple* tuple = reinterpret_cast<Tuple*>(_mem_pool->allocate(tuple_desc->byte_size()));
+        memset(tuple, 0, tuple_desc->byte_size());
+        const SlotDescriptor* slot_desc = tuple_desc->slots()[0];
+        char* ptr = reinterpret_cast<char*>(_mem_pool->allocate(k.size()));
+        memcpy(ptr, k.data(), k.size());
+        *reinterpret_cast<StringValue*>(tuple->get_slot(slot_desc->tuple_offset())) =
+                StringValue(ptr, k.size());
+        TupleRow* row = reinterpret_cast<TupleRow*>(_mem_pool->allocate(sizeof(Tuple*)));
+        row->set_tuple(0, tuple);
+        return row;
+    }
+
+    static std::string to_string(const StringVal& val) {
+        return std::string(reinterpret_cast<const char*>(val.ptr), val.len);
+    }
+
+    static ScalarFnCall* fn_call(Expr* expr) {
+        ScalarFnCall* fn_call = dynamic_cast<ScalarFnCall*>(expr);
+        EXPECT_TRUE(fn_call != nullptr);
+        return fn_call;
+    }
+
+    ObjectPool _pool;
+    RuntimeState _runtime_state;
+    DescriptorTbl* _desc_tbl = nullptr;
+    std::unique_ptr<RowDescriptor> _row_desc;
+    std::shared_ptr<MemTracker> _tracker;
+    std::unique_ptr<MemPool> _mem_pool;
+    std::vector<ExprContext*> _ctxs;
+};
+
+TEST_F(SubexprCacheTest, shared_calls) {
+    // upper(k), instr(upper(k), 'B'), lower(upper(k)), lower(k)
+    std::vector<TExpr> texprs = {
+            texpr({upper_node(), slot_node()}),
+            texpr({instr_node(), upper_node(), slot_node(), string_node("B")}),
+            texpr({lower_node(), upper_node(), slot_node()}),
+            texpr({lower_node(), slot_node()})};
+    create_ctxs(texprs);
+    open_ctxs();
+    SubexprCache* cache = SubexprCache::create(&_pool, texprs, _ctxs);
+    ASSERT_TRUE(cache != nullptr);
+    // only upper(k) occurs more than once
+    ASSERT_EQ(1, cache->num_subexprs());
+    ASSERT_EQ(0, fn_call(_ctxs[0]->root())->_subexpr_idx);
+    ASSERT_EQ(-1, fn_call(_ctxs[1]->root())->_subexpr_idx);
+    ASSERT_EQ(0, fn_call(_ctxs[1]->root()->get_child(0))->_subexpr_idx);
+    ASSERT_EQ(-1, fn_call(_ctxs[2]->root())->_subexpr_idx);
+    ASSERT_EQ(0, fn_call(_ctxs[2]->root()->get_child(0))->_subexpr_idx);
+    ASSERT_EQ(-1, fn_call(_ctxs[3]->root())->_subexpr_idx);
+    for (auto ctx : _ctxs) {
+        ASSERT_EQ(cache, ctx->_subexpr_cache);
+    }
+
+    TupleRow* row = create_row("abc");
+    ASSERT_EQ("ABC", to_string(_ctxs[0]->get_string_val(row)));
+    ASSERT_EQ(2, _ctxs[1]->get_int_val(row).val);
+    ASSERT_EQ("abc", to_string(_ctxs[2]->get_string_val(row)));
+    ASSERT_EQ("abc", to_string(_ctxs[3]->get_string_val(row)));
+
+    // the result of upper(k) is reused until the next row, even for another row
+    TupleRow* other_row = create_row("zzz");
+    ASSERT_EQ(2, _ctxs[1]->get_int_val(other_row).val);
+    ASSERT_EQ("zzz", to_string(_ctxs[3]->get_string_val(other_row)));
+    cache->next_row();
+    ASSERT_EQ(0, _ctxs[1]->get_int_val(other_row).val);
+    ASSERT_EQ("ZZZ", to_string(_ctxs[0]->get_string_val(other_row)));
+    ASSERT_EQ("zzz", to_string(_ctxs[2]->get_string_val(other_row)));
+}
+
+TEST_F(SubexprCacheTest, nothing_shared) {
+    std::vector<TExpr> texprs = {texpr({upper_node(), slot_node()}),
+                                 texpr({lower_node(), slot_node()})};
+    create_ctxs(texprs);
+    open_ctxs();
+    ASSERT_TRUE(SubexprCache::create(&_pool, texprs, _ctxs) == nullptr);
+    ASSERT_TRUE(_ctxs[0]->_subexpr_cache == nullptr);
+    ASSERT_EQ(-1, fn_call(_ctxs[0]->root())->_subexpr_idx);
+    ASSERT_EQ(-1, fn_call(_ctxs[1]->root())->_subexpr_idx);
+}
+
+TEST_F(SubexprCacheTest, constant_calls_folded) {
+    // upper('abc'), instr(upper('abc'), 'B'), upper(k)
+    std::vector<TExpr> texprs = {
+            texpr({upper_node(), string_node("abc")}),
+            texpr({instr_node(), upper_node(), string_node("abc"), string_node("B")}),
+            texpr({upper_node(), slot_node()})};
+    create_ctxs(texprs);
+    open_ctxs();
+    // the constant calls are folded instead of shared
+    ASSERT_TRUE(SubexprCache::create(&_pool, texprs, _ctxs) == nullptr);
+    ScalarFnCall* upper = fn_call(_ctxs[0]->root());
+    ASSERT_TRUE(upper->_is_folded);
+    ASSERT_EQ(-1, upper->_subexpr_idx);
+    ASSERT_TRUE(fn_call(_ctxs[1]->root())->_is_folded);
+    ASSERT_TRUE(fn_call(_ctxs[1]->root()->get_child(0))->_is_folded);
+    ASSERT_FALSE(fn_call(_ctxs[2]->root())->_is_folded);
+
+    TupleRow* row = create_row("xyz");
+    StringVal val = _ctxs[0]->get_string_val(row);
+    ASSERT_EQ("ABC", to_string(val));
+    // the folded string is owned by the expr, not by the local allocations
+    ASSERT_EQ("ABC", upper->_folded_string);
+    ASSERT_EQ(reinterpret_cast<uint8_t*>(&upper->_folded_string[0]), val.ptr);
+    _ctxs[0]->free_local_allocations();
+    ASSERT_EQ("ABC", to_string(_ctxs[0]->get_string_val(row)));
+    ASSERT_EQ(2, _ctxs[1]->get_int_val(row).val);
+    ASSERT_EQ("XYZ", to_string(_ctxs[2]->get_string_val(row)));
+}
+
+TEST_F(SubexprCacheTest, volatile_calls) {
+    ASSERT_TRUE(ScalarFnCall::is_volatile_fn("rand"));
+    ASSERT_TRUE(ScalarFnCall::is_volatile_fn("random"));
+    ASSERT_TRUE(ScalarFnCall::is_volatile_fn("sleep"));
+    ASSERT_FALSE(ScalarFnCall::is_volatile_fn("upper"));
+
+    // rand(42) twice, on constant arguments
+    std::vector<TExpr> texprs = {texpr({rand_node(), bigint_node(42)}),
+                                 texpr({rand_node(), bigint_node(42)})};
+    create_ctxs(texprs);
+    open_ctxs();
+    // neither shared nor folded
+    ASSERT_TRUE(SubexprCache::create(&_pool, texprs, _ctxs) == nullptr);
+    for (auto ctx : _ctxs) {
+        ScalarFnCall* rand = fn_call(ctx->root());
+        ASSERT_FALSE(rand->is_constant());
+        ASSERT_FALSE(rand->_is_folded);
+        ASSERT_EQ(-1, rand->_subexpr_idx);
+    }
+
+    // every call draws the next number of the seeded sequence of its own ctx
+    TupleRow* row = create_row("");
+    double first = _ctxs[0]->get_double_val(row).val;
+    double second = _ctxs[0]->get_double_val(row).val;
+    ASSERT_NE(first, second);
+    ASSERT_EQ(first, _ctxs[1]->get_double_val(row).val);
+    ASSERT_EQ(second, _ctxs[1]->get_double_val(row).val);
+}
+
+} // namespace doris
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    doris::CpuInfo::init();
+    return RUN_ALL_TESTS();
+}
@@ -19,6 +19,8 @@
 
 #include <gtest/gtest.h>
 
+#include <vector>
+
 #include <boost/scoped_ptr.hpp>
 
 #include "runtime/exec_env.h"
@@ -274,6 +276,33 @@ TEST_F(TimestampFunctionsTest, convert_tz_test) {
     delete context;
 }
 
+TEST_F(TimestampFunctionsTest, date_format_constant_format) {
+    doris_udf::FunctionContext::TypeDesc return_type;
+    return_type.type = doris_udf::FunctionContext::Type::TYPE_VARCHAR;
+    doris_udf::FunctionContext::TypeDesc datetime_type;
+    datetime_type.type = doris_udf::FunctionContext::Type::TYPE_DATETIME;
+    FunctionUtils fu(return_type, {datetime_type, return_type}, 0);
+    doris_udf::FunctionContext* context = fu.get_fn_ctx();
+    StringVal format("%Y-%m-%d %H:00");
+    std::vector<doris_udf::AnyVal*> constant_args = {nullptr, &format};
+    context->impl()->set_constant_args(constant_args);
+    TimestampFunctions::format_prepare(context, FunctionContext::FRAGMENT_LOCAL);
+    TimestampFunctions::format_prepare(context, FunctionContext::THREAD_LOCAL);
+    ASSERT_NE(nullptr, context->get_function_state(FunctionContext::THREAD_LOCAL));
+
+    // the repeated values are formatted once
+    int64_t values[] = {20190806163857, 20190806163857, 20190806170000, 20190806163857};
+    const char* expected[] = {"2019-08-06 16:00", "2019-08-06 16:00", "2019-08-06 17:00",
+                              "2019-08-06 16:00"};
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_EQ(StringVal(expected[i]),
+                  TimestampFunctions::date_format(context, datetime_val(values[i]), format));
+    }
+
+    TimestampFunctions::format_close(context, FunctionContext::THREAD_LOCAL);
+    TimestampFunctions::format_close(context, FunctionContext::FRAGMENT_LOCAL);
+}
+
 #define ASSERT_DIFF(unit, diff, tv1, tv2)                                                         \
     ASSERT_EQ(                                                                                    \
             diff,                                                                                 \
@@ -68,8 +68,23 @@ public:
     }
 };
 
+class HttpClientTestPooledHandler : public HttpHandler {
+public:
+    bool handle_in_pool() override { return true; }
+
+    void handle(HttpRequest* req) override {
+        if (req->param("fail") == "true") {
+            HttpChannel::send_error(req, HttpStatus::INTERNAL_SERVER_ERROR);
+            return;
+        }
+        req->add_output_header(HttpHeaders::CONTENT_TYPE, "text/plain");
+        HttpChannel::send_reply(req, "pooled");
+    }
+};
+
 static HttpClientTestSimpleGetHandler s_simple_get_handler = HttpClientTestSimpleGetHandler();
 static HttpClientTestSimplePostHandler s_simple_post_handler = HttpClientTestSimplePostHandler();
+static HttpClientTestPooledHandler s_pooled_handler = HttpClientTestPooledHandler();
 static EvHttpServer* s_server = nullptr;
 static int real_port = 0;
 static std::string hostname = "";
@@ -84,6 +99,7 @@ public:
         s_server->register_handler(GET, "/simple_get", &s_simple_get_handler);
         s_server->register_handler(HEAD, "/simple_get", &s_simple_get_handler);
         s_server->register_handler(POST, "/simple_post", &s_simple_post_handler);
+        s_server->register_handler(GET, "/pooled", &s_pooled_handler);
         s_server->start();
         real_port = s_server->get_real_port();
         ASSERT_NE(0, real_port);
@@ -114,6 +130,27 @@ TEST_F(HttpClientTest, get_normal) {
     ASSERT_EQ(5, client.get_content_length());
 }
 
+TEST_F(HttpClientTest, handle_in_pool) {
+    for (int i = 0; i < 10; ++i) {
+        HttpClient client;
+        auto st = client.init(hostname + "/pooled");
+        ASSERT_TRUE(st.ok());
+        client.set_method(GET);
+        std::string response;
+        st = client.execute(&response);
+        ASSERT_TRUE(st.ok());
+        ASSERT_STREQ("pooled", response.c_str());
+    }
+
+    HttpClient client;
+    auto st = client.init(hostname + "/pooled?fail=true");
+    ASSERT_TRUE(st.ok());
+    client.set_method(GET);
+    std::string response;
+    st = client.execute(&response);
+    ASSERT_FALSE(st.ok());
+}
+
 TEST_F(HttpClientTest, download) {
     HttpClient client;
     auto st = client.init(hostname + "/simple_get");
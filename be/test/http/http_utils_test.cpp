@@ -89,6 +89,32 @@ TEST_F(HttpUtilsTest, parse_basic_auth) {
     }
 }
 
+TEST_F(HttpUtilsTest, parse_range_header) {
+    int64_t start = 0;
+    int64_t end = 0;
+    ASSERT_TRUE(parse_range_header("bytes=10-19", 100, &start, &end));
+    ASSERT_EQ(10, start);
+    ASSERT_EQ(19, end);
+    ASSERT_TRUE(parse_range_header("bytes=90-", 100, &start, &end));
+    ASSERT_EQ(90, start);
+    ASSERT_EQ(99, end);
+    ASSERT_TRUE(parse_range_header("bytes=-30", 100, &start, &end));
+    ASSERT_EQ(70, start);
+    ASSERT_EQ(99, end);
+    ASSERT_TRUE(parse_range_header("bytes=50-1000", 100, &start, &end));
+    ASSERT_EQ(50, start);
+    ASSERT_EQ(99, end);
+    // multiple ranges fall back to the whole file
+    ASSERT_TRUE(parse_range_header("bytes=0-1,5-6", 100, &start, &end));
+    ASSERT_EQ(0, start);
+    ASSERT_EQ(99, end);
+
+    ASSERT_FALSE(parse_range_header("bytes=100-", 100, &start, &end));
+    ASSERT_FALSE(parse_range_header("bytes=20-10", 100, &start, &end));
+    ASSERT_FALSE(parse_range_header("bytes=abc", 100, &start, &end));
+    ASSERT_FALSE(parse_range_header("bytes=1x-2", 100, &start, &end));
+}
+
 } // namespace doris
 
 int main(int argc, char** argv) {
@@ -19,6 +19,7 @@
 
 #include <gtest/gtest.h>
 
+#include "common/config.h"
 #include "http/http_channel.h"
 #include "http/http_request.h"
 #include "http/http_response.h"
@@ -94,6 +95,38 @@ TEST_F(MetricsActionTest, prometheus_no_prefix) {
     action.handle(&request);
 }
 
+TEST_F(MetricsActionTest, prometheus_snapshot) {
+    MetricRegistry metric_registry("test");
+    std::shared_ptr<MetricEntity> entity =
+            metric_registry.register_entity("metrics_action_test.prometheus_snapshot");
+
+    IntGauge* cpu_idle = nullptr;
+    DEFINE_GAUGE_METRIC_PROTOTYPE_2ARG(cpu_idle, MetricUnit::PERCENT);
+    INT_GAUGE_METRIC_REGISTER(entity, cpu_idle);
+
+    int32_t interval_ms = config::metrics_snapshot_interval_ms;
+    config::metrics_snapshot_interval_ms = 3600 * 1000;
+    MetricsAction action(&metric_registry);
+    HttpRequest request(_evhttp_req);
+    cpu_idle->set_value(50);
+    s_expect_response =
+            "# TYPE test_cpu_idle gauge\n"
+            "test_cpu_idle 50\n";
+    action.handle(&request);
+
+    // served by the snapshot
+    cpu_idle->set_value(60);
+    action.handle(&request);
+
+    // rendered for each request
+    config::metrics_snapshot_interval_ms = 0;
+    s_expect_response =
+            "# TYPE test_cpu_idle gauge\n"
+            "test_cpu_idle 60\n";
+    action.handle(&request);
+    config::metrics_snapshot_interval_ms = interval_ms;
+}
+
 } // namespace doris
 
 int main(int argc, char** argv) {
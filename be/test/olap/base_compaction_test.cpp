@@ -0,0 +1,379 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gen_cpp/AgentService_types.h"
+#include "gen_cpp/Descriptors_types.h"
+#include "olap/base_compaction.h"
+#include "olap/delta_writer.h"
+#include "olap/iterators.h"
+#include "olap/row_block2.h"
+#include "olap/rowset/beta_rowset.h"
+#include "olap/schema.h"
+#include "olap/storage_engine.h"
+#include "olap/tablet.h"
+#include "olap/task/engine_publish_version_task.h"
+#include "runtime/descriptor_helper.h"
+#include "runtime/descriptors.h"
+#include "runtime/exec_env.h"
+#include "runtime/mem_pool.h"
+#include "runtime/mem_tracker.h"
+#include "runtime/tuple.h"
+#include "util/cpu_info.h"
+#include "util/file_utils.h"
+
+namespace doris {
+
+static const uint32_t MAX_PATH_LEN = 1024;
+static const int64_t kPartitionId = 30101;
+static const int32_t kSchemaHash = 270068391;
+
+static StorageEngine* k_engine = nullptr;
+static std::shared_ptr<MemTracker> k_mem_tracker = nullptr;
+
+using Rows = std::vector<std::pair<int32_t, int32_t>>;
+
+static void set_up() {
+    char buffer[MAX_PATH_LEN];
+    getcwd(buffer, MAX_PATH_LEN);
+    config::storage_root_path = std::string(buffer) + "/data_base_compaction_test";
+    FileUtils::remove_all(config::storage_root_path);
+    FileUtils::create_dir(config::storage_root_path);
+    std::vector<StorePath> paths;
+    paths.emplace_back(config::storage_root_path, -1);
+
+    EngineOptions options;
+    options.store_paths = paths;
+    Status s = StorageEngine::open(options, &k_engine);
+    ASSERT_TRUE(s.ok()) << s.to_string();
+    ExecEnv::GetInstance()->set_storage_engine(k_engine);
+    k_mem_tracker.reset(new MemTracker(-1, "base compaction test"));
+}
+
+static void tear_down() {
+    if (k_engine != nullptr) {
+        k_engine->stop();
+        delete k_engine;
+        k_engine = nullptr;
+    }
+    FileUtils::remove_all(config::storage_root_path);
+}
+
+class BaseCompactionTest : public testing::Test {
+protected:
+    void SetUp() override {
+        _parallel_key_ranges = config::base_compaction_parallel_key_ranges;
+        _min_rows_per_key_range = config::base_compaction_min_rows_per_key_range;
+        _ordered_data_compaction = config::enable_ordered_data_compaction;
+    }
+
+    void TearDown() override {
+        config::base_compaction_parallel_key_ranges = _parallel_key_ranges;
+        config::base_compaction_min_rows_per_key_range = _min_rows_per_key_range;
+        config::enable_ordered_data_compaction = _ordered_data_compaction;
+        for (int64_t tablet_id : _tablet_ids) {
+            k_engine->tablet_manager()->drop_tablet(tablet_id, kSchemaHash);
+        }
+    }
+
+    // (k1 int, v1 int sum) aggregate key (k1)
+    TabletSharedPtr create_tablet(int64_t tablet_id) {
+        TCreateTabletReq request;
+        request.tablet_id = tablet_id;
+        request.__set_version(1);
+        request.__set_version_hash(0);
+        request.__set_storage_format(TStorageFormat::V2);
+        request.tablet_schema.schema_hash = kSchemaHash;
+        request.tablet_schema.short_key_column_count = 1;
+        request.tablet_schema.keys_type = TKeysType::AGG_KEYS;
+        request.tablet_schema.storage_type = TStorageType::COLUMN;
+
+        TColumn k1;
+        k1.column_name = "k1";
+        k1.__set_is_key(true);
+        k1.column_type.type = TPrimitiveType::INT;
+        request.tablet_schema.columns.push_back(k1);
+
+        TColumn v1;
+        v1.column_name = "v1";
+        v1.__set_is_key(false);
+        v1.column_type.type = TPrimitiveType::INT;
+        v1.__set_aggregation_type(TAggregationType::SUM);
+        request.tablet_schema.columns.push_back(v1);
+
+        EXPECT_EQ(OLAP_SUCCESS, k_engine->create_tablet(request));
+        _tablet_ids.push_back(tablet_id);
+        return k_engine->tablet_manager()->get_tablet(tablet_id, kSchemaHash);
+    }
+
+    // Load `rows` into the tablet by txn `txn_id` and publish them as `version`
+    void load(const TabletSharedPtr& tablet, int64_t txn_id, int64_t version, const Rows& rows) {
+        TDescriptorTableBuilder dtb;
+        TTupleDescriptorBuilder tuple_builder;
+        tuple_builder.add_slot(
+                TSlotDescriptorBuilder().type(TYPE_INT).column_name("k1").column_pos(0).build());
+        tuple_builder.add_slot(
+                TSlotDescriptorBuilder().type(TYPE_INT).column_name("v1").column_pos(1).build());
+        tuple_builder.build(&dtb);
+        ObjectPool obj_pool;
+        DescriptorTbl* desc_tbl = nullptr;
+        DescriptorTbl::create(&obj_pool, dtb.desc_tbl(), &desc_tbl);
+        TupleDescriptor* tuple_desc = desc_tbl->get_tuple_descriptor(0);
+        const std::vector<SlotDescriptor*>& slots = tuple_desc->slots();
+
+        PUniqueId load_id;
+        load_id.set_hi(tablet->tablet_id());
+        load_id.set_lo(txn_id);
+        WriteRequest write_req = {tablet->tablet_id(), kSchemaHash, WriteType::LOAD,
+                                  txn_id,              kPartitionId, load_id,
+                                  false,               tuple_desc,   &slots};
+        DeltaWriter* delta_writer = nullptr;
+        DeltaWriter::open(&write_req, k_mem_tracker, &delta_writer);
+        ASSERT_NE(nullptr, delta_writer);
+        std::unique_ptr<DeltaWriter> delta_writer_guard(delta_writer);
+
+        MemTracker tracker;
+        MemPool pool(&tracker);
+        for (auto& row : rows) {
+            Tuple* tuple = reinterpret_cast<Tuple*>(pool.allocate(tuple_desc->byte_size()));
+            memset(tuple, 0, tuple_desc->byte_size());
+            *(int32_t*)(tuple->get_slot(slots[0]->tuple_offset())) = row.first;
+            *(int32_t*)(tuple->get_slot(slots[1]->tuple_offset())) = row.second;
+            ASSERT_EQ(OLAP_SUCCESS, delta_writer->write(tuple));
+        }
+        ASSERT_EQ(OLAP_SUCCESS, delta_writer->close());
+        ASSERT_EQ(OLAP_SUCCESS, delta_writer->close_wait(nullptr));
+
+        TPublishVersionRequest publish_req;
+        TPartitionVersionInfo par_ver_info;
+        par_ver_info.partition_id = kPartitionId;
+        par_ver_info.version = version;
+        par_ver_info.version_hash = 0;
+        publish_req.transaction_id = txn_id;
+        publish_req.partition_version_infos.push_back(par_ver_info);
+        std::vector<TTabletId> error_tablet_ids;
+        EnginePublishVersionTask task(publish_req, &error_tablet_ids);
+        ASSERT_EQ(OLAP_SUCCESS, k_engine->execute_task(&task));
+    }
+
+    // The rows of `rowset` in the order of its segments
+    Rows read_rows(const TabletSharedPtr& tablet, const RowsetSharedPtr& rowset) {
+        Schema schema(tablet->tablet_schema());
+        RowBlockV2 block(schema, 1024);
+        Rows rows;
+        std::vector<segment_v2::SegmentSharedPtr> segments;
+        EXPECT_EQ(OLAP_SUCCESS,
+                  std::static_pointer_cast<BetaRowset>(rowset)->load_segments(&segments));
+        for (auto& segment : segments) {
+            OlapReaderStatistics stats;
+            StorageReadOptions opts;
+            opts.stats = &stats;
+            std::unique_ptr<RowwiseIterator> iter;
+            EXPECT_TRUE(segment->new_iterator(schema, opts, &iter).ok());
+            while (true) {
+                block.clear();
+                Status st = iter->next_batch(&block);
+                if (st.is_end_of_file()) {
+                    break;
+                }
+                EXPECT_TRUE(st.ok()) << st.to_string();
+                for (uint16_t i = 0; i < block.selected_size(); ++i) {
+                    RowBlockRow row = block.row(block.selection_vector()[i]);
+                    rows.emplace_back(*(const int32_t*)row.cell_ptr(0),
+                                      *(const int32_t*)row.cell_ptr(1));
+                }
+            }
+        }
+        return rows;
+    }
+
+    // Load the rows of keys [begin, end) with value `value` as `version`
+    void load_keys(const TabletSharedPtr& tablet, int64_t txn_id, int64_t version,
+                   int32_t begin, int32_t end, int32_t value) {
+        Rows rows;
+        for (int32_t k = begin; k < end; ++k) {
+            rows.emplace_back(k, value);
+        }
+        load(tablet, txn_id, version, rows);
+    }
+
+    // Base compact versions [0, `max_version`] of the tablet, return the output rowset
+    RowsetSharedPtr compact(const TabletSharedPtr& tablet, int64_t max_version) {
+        BaseCompaction compaction(tablet, "base compaction test", k_mem_tracker);
+        {
+            ReadLock rdlock(tablet->get_header_lock_ptr());
+            EXPECT_EQ(OLAP_SUCCESS, tablet->capture_consistent_rowsets(
+                                            Version(0, max_version), &compaction._input_rowsets));
+        }
+        EXPECT_EQ(OLAP_SUCCESS, compaction.do_compaction(0));
+        return compaction._output_rowset;
+    }
+
+    std::vector<int64_t> _tablet_ids;
+    int32_t _parallel_key_ranges = 1;
+    int64_t _min_rows_per_key_range = 0;
+    bool _ordered_data_compaction = true;
+};
+
+TEST_F(BaseCompactionTest, merge_by_key_ranges) {
+    TabletSharedPtr tablet = create_tablet(15101);
+    ASSERT_NE(nullptr, tablet);
+    // version 2 has every key of [0, kNumKeys), and is the largest rowset whose short key
+    // index, an entry per 1024 rows, splits the keys. Versions 3 and 4 have every 8th key,
+    // including the first keys of the blocks of version 2, which are the range boundaries.
+    const int32_t kNumKeys = 10240;
+    Rows base_rows;
+    Rows sparse_rows;
+    for (int32_t k = 0; k < kNumKeys; ++k) {
+        base_rows.emplace_back(k, 1);
+        if (k % 8 == 0) {
+            sparse_rows.emplace_back(k, 10);
+        }
+    }
+    load(tablet, 20101, 2, base_rows);
+    load(tablet, 20102, 3, sparse_rows);
+    load(tablet, 20103, 4, sparse_rows);
+
+    config::base_compaction_parallel_key_ranges = 4;
+    config::base_compaction_min_rows_per_key_range = 1000;
+    BaseCompaction compaction(tablet, "base compaction test", k_mem_tracker);
+    {
+        ReadLock rdlock(tablet->get_header_lock_ptr());
+        ASSERT_EQ(OLAP_SUCCESS, tablet->capture_consistent_rowsets(Version(0, 4),
+                                                                   &compaction._input_rowsets));
+    }
+    ASSERT_EQ(OLAP_SUCCESS, compaction.do_compaction(0));
+    ASSERT_EQ(4, compaction._num_key_ranges());
+
+    // each range is merged into its own segments, which are linked in key order
+    RowsetSharedPtr output = compaction._output_rowset;
+    ASSERT_NE(nullptr, output);
+    ASSERT_EQ(Version(0, 4), output->version());
+    ASSERT_GT(output->num_segments(), 1);
+    ASSERT_EQ(kNumKeys, output->num_rows());
+
+    // every key once, the keys at the boundaries and in the unbounded last range included
+    Rows rows = read_rows(tablet, output);
+    ASSERT_EQ(kNumKeys, rows.size());
+    for (int32_t k = 0; k < kNumKeys; ++k) {
+        ASSERT_EQ(k, rows[k].first);
+        ASSERT_EQ(k % 8 == 0 ? 21 : 1, rows[k].second) << "key " << k;
+    }
+}
+
+TEST_F(BaseCompactionTest, num_key_ranges) {
+    TabletSharedPtr tablet = create_tablet(15102);
+    ASSERT_NE(nullptr, tablet);
+    Rows rows;
+    for (int32_t k = 0; k < 3000; ++k) {
+        rows.emplace_back(k, 1);
+    }
+    load(tablet, 20111, 2, rows);
+
+    BaseCompaction compaction(tablet, "base compaction test", k_mem_tracker);
+    {
+        ReadLock rdlock(tablet->get_header_lock_ptr());
+        ASSERT_EQ(OLAP_SUCCESS, tablet->capture_consistent_rowsets(Version(0, 2),
+                                                                   &compaction._input_rowsets));
+    }
+    ASSERT_EQ(OLAP_SUCCESS, compaction.construct_output_rowset_writer());
+    compaction._input_row_num = 3000;
+
+    // merged in one range unless the ranges have enough rows
+    config::base_compaction_parallel_key_ranges = 1;
+    config::base_compaction_min_rows_per_key_range = 1000;
+    ASSERT_EQ(1, compaction._num_key_ranges());
+    config::base_compaction_parallel_key_ranges = 8;
+    ASSERT_EQ(3, compaction._num_key_ranges());
+    config::base_compaction_min_rows_per_key_range = 2000;
+    ASSERT_EQ(1, compaction._num_key_ranges());
+    config::base_compaction_min_rows_per_key_range = 100;
+    ASSERT_EQ(8, compaction._num_key_ranges());
+}
+
+TEST_F(BaseCompactionTest, link_ordered_rowsets) {
+    TabletSharedPtr tablet = create_tablet(15103);
+    ASSERT_NE(nullptr, tablet);
+    load_keys(tablet, 20121, 2, 0, 100, 1);
+    load_keys(tablet, 20122, 3, 100, 200, 2);
+    load_keys(tablet, 20123, 4, 200, 300, 3);
+
+    // the key ranges of the rowsets don't overlap, their segments are linked as they are
+    config::enable_ordered_data_compaction = true;
+    RowsetSharedPtr output = compact(tablet, 4);
+    ASSERT_NE(nullptr, output);
+    ASSERT_EQ(3, output->num_segments());
+    ASSERT_EQ(300, output->num_rows());
+    Rows rows = read_rows(tablet, output);
+    ASSERT_EQ(300, rows.size());
+    for (int32_t k = 0; k < 300; ++k) {
+        ASSERT_EQ(std::make_pair(k, k / 100 + 1), rows[k]);
+    }
+}
+
+TEST_F(BaseCompactionTest, merge_overlapping_rowsets) {
+    TabletSharedPtr tablet = create_tablet(15104);
+    ASSERT_NE(nullptr, tablet);
+    load_keys(tablet, 20131, 2, 0, 100, 1);
+    load_keys(tablet, 20132, 3, 99, 200, 2);
+
+    // key 99 is in both rowsets, so they are merged
+    config::enable_ordered_data_compaction = true;
+    RowsetSharedPtr output = compact(tablet, 3);
+    ASSERT_NE(nullptr, output);
+    ASSERT_EQ(1, output->num_segments());
+    Rows rows = read_rows(tablet, output);
+    ASSERT_EQ(200, rows.size());
+    ASSERT_EQ(std::make_pair(98, 1), rows[98]);
+    ASSERT_EQ(std::make_pair(99, 3), rows[99]);
+    ASSERT_EQ(std::make_pair(100, 2), rows[100]);
+}
+
+TEST_F(BaseCompactionTest, ordered_data_compaction_disabled) {
+    TabletSharedPtr tablet = create_tablet(15105);
+    ASSERT_NE(nullptr, tablet);
+    load_keys(tablet, 20141, 2, 0, 100, 1);
+    load_keys(tablet, 20142, 3, 100, 200, 2);
+
+    config::enable_ordered_data_compaction = false;
+    RowsetSharedPtr output = compact(tablet, 3);
+    ASSERT_NE(nullptr, output);
+    ASSERT_EQ(1, output->num_segments());
+    ASSERT_EQ(200, output->num_rows());
+}
+
+} // namespace doris
+
+int main(int argc, char** argv) {
+    std::string conffile = std::string(getenv("DORIS_HOME")) + "/conf/be.conf";
+    if (!doris::config::init(conffile.c_str(), false)) {
+        fprintf(stderr, "error read config file. \n");
+        return -1;
+    }
+    testing::InitGoogleTest(&argc, argv);
+    doris::CpuInfo::init();
+    doris::set_up();
+    int ret = RUN_ALL_TESTS();
+    doris::tear_down();
+    google::protobuf::ShutdownProtobufLibrary();
+    return ret;
+}
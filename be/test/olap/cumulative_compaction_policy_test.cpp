@@ -24,6 +24,7 @@
 #include "olap/cumulative_compaction.h"
 #include "olap/rowset/rowset_meta.h"
 #include "olap/tablet_meta.h"
+#include "util/time.h"
 
 namespace doris {
 
@@ -1050,6 +1051,242 @@ TEST_F(TestSizeBasedCumulativeCompactionPolicy, _pick_missing_version_cumulative
     compaction.find_longest_consecutive_version(&rowsets3, nullptr);
     ASSERT_EQ(0, rowsets3.size());
 }
+
+class TestTimeSeriesCumulativeCompactionPolicy : public testing::Test {
+public:
+    TestTimeSeriesCumulativeCompactionPolicy() {}
+    void SetUp() {
+        config::time_series_compaction_goal_size_mbytes = 1;
+        config::time_series_compaction_file_count_threshold = 10;
+        config::time_series_compaction_time_threshold_seconds = 3600;
+
+        _tablet_meta = static_cast<TabletMetaSharedPtr>(
+                new TabletMeta(1, 2, 15673, 4, 5, TTabletSchema(), 6, {{7, 8}}, UniqueId(9, 10),
+                               TTabletType::TABLET_TYPE_DISK));
+
+        _json_rowset_meta = R"({
+            "rowset_id": 540081,
+            "tablet_id": 15673,
+            "txn_id": 4042,
+            "tablet_schema_hash": 567997577,
+            "rowset_type": "BETA_ROWSET",
+            "rowset_state": "VISIBLE",
+            "start_version": 2,
+            "end_version": 2,
+            "version_hash": 8391828013814912580,
+            "num_rows": 3929,
+            "total_disk_size": 41,
+            "data_disk_size": 41,
+            "index_disk_size": 235,
+            "empty": false,
+            "load_id": {
+                "hi": -5350970832824939812,
+                "lo": -6717994719194512122
+            },
+            "creation_time": 1553765670,
+            "alpha_rowset_extra_meta_pb": {
+                "segment_groups": [
+                {
+                    "segment_group_id": 0,
+                    "num_segments": 2,
+                    "index_size": 132,
+                    "data_size": 576,
+                    "num_rows": 5,
+                    "zone_maps": [
+                    {
+                        "min": "MQ==",
+                        "max": "NQ==",
+                        "null_flag": false
+                    },
+                    {
+                        "min": "MQ==",
+                        "max": "Mw==",
+                        "null_flag": false
+                    },
+                    {
+                        "min": "J2J1c2gn",
+                        "max": "J3RvbSc=",
+                        "null_flag": false
+                    }
+                    ],
+                    "empty": false
+                },
+                {
+                    "segment_group_id": 1,
+                    "num_segments": 1,
+                    "index_size": 132,
+                    "data_size": 576,
+                    "num_rows": 5,
+                    "zone_maps": [
+                    {
+                        "min": "MQ==",
+                        "max": "NQ==",
+                        "null_flag": false
+                    },
+                    {
+                        "min": "MQ==",
+                        "max": "Mw==",
+                        "null_flag": false
+                    },
+                    {
+                        "min": "J2J1c2gn",
+                        "max": "J3RvbSc=",
+                        "null_flag": false
+                    }
+                    ],
+                    "empty": false
+                }
+                ]
+            }
+        })";
+    }
+    void TearDown() {}
+
+    // a rowset of 41 bytes created just now
+    void init_rs_meta(RowsetMetaSharedPtr& pb1, int64_t start, int64_t end) {
+        pb1->init_from_json(_json_rowset_meta);
+        pb1->set_start_version(start);
+        pb1->set_end_version(end);
+        pb1->set_total_disk_size(41);
+        pb1->set_creation_time(UnixSeconds() - 10);
+    }
+
+    // a base rowset and three small singleton rowsets
+    void init_rs_meta_small(std::vector<RowsetMetaSharedPtr>* rs_metas) {
+        RowsetMetaSharedPtr ptr1(new RowsetMeta());
+        init_rs_meta(ptr1, 0, 1);
+        ptr1->set_segments_overlap(NONOVERLAPPING);
+        rs_metas->push_back(ptr1);
+
+        for (int64_t version = 2; version <= 4; ++version) {
+            RowsetMetaSharedPtr ptr(new RowsetMeta());
+            init_rs_meta(ptr, version, version);
+            rs_metas->push_back(ptr);
+        }
+    }
+
+    void init_tablet(const std::vector<RowsetMetaSharedPtr>& rs_metas) {
+        for (auto& rowset : rs_metas) {
+            _tablet_meta->add_rs_meta(rowset);
+        }
+        _tablet.reset(new Tablet(_tablet_meta, nullptr, CUMULATIVE_TIME_SERIES_POLICY));
+        _tablet->init();
+        _tablet->calculate_cumulative_point();
+    }
+
+    void pick_input_rowsets(std::vector<RowsetSharedPtr>* input_rowsets) {
+        std::vector<RowsetSharedPtr> candidate_rowsets;
+        _tablet->pick_candidate_rowsets_to_cumulative_compaction(0, &candidate_rowsets);
+        Version last_delete_version{-1, -1};
+        size_t compaction_score = 0;
+        _tablet->_cumulative_compaction_policy->pick_input_rowsets(
+                _tablet.get(), candidate_rowsets, 1000, 5, input_rowsets, &last_delete_version,
+                &compaction_score);
+    }
+
+protected:
+    std::string _json_rowset_meta;
+    TabletMetaSharedPtr _tablet_meta;
+    TabletSharedPtr _tablet;
+};
+
+TEST_F(TestTimeSeriesCumulativeCompactionPolicy, calc_cumulative_compaction_score_window_open) {
+    std::vector<RowsetMetaSharedPtr> rs_metas;
+    init_rs_meta_small(&rs_metas);
+    init_tablet(rs_metas);
+
+    ASSERT_EQ(2, _tablet->cumulative_layer_point());
+    ASSERT_EQ(0, _tablet->calc_compaction_score(CompactionType::CUMULATIVE_COMPACTION));
+}
+
+TEST_F(TestTimeSeriesCumulativeCompactionPolicy, calc_cumulative_compaction_score_window_full) {
+    std::vector<RowsetMetaSharedPtr> rs_metas;
+    init_rs_meta_small(&rs_metas);
+    rs_metas[2]->set_total_disk_size(1024 * 1024);
+    init_tablet(rs_metas);
+
+    ASSERT_EQ(9, _tablet->calc_compaction_score(CompactionType::CUMULATIVE_COMPACTION));
+}
+
+TEST_F(TestTimeSeriesCumulativeCompactionPolicy, pick_input_rowsets_window_full) {
+    std::vector<RowsetMetaSharedPtr> rs_metas;
+    init_rs_meta_small(&rs_metas);
+    // version 3 fills the window, version 4 is of the next window
+    rs_metas[2]->set_total_disk_size(1024 * 1024);
+    init_tablet(rs_metas);
+
+    std::vector<RowsetSharedPtr> input_rowsets;
+    pick_input_rowsets(&input_rowsets);
+    ASSERT_EQ(2, input_rowsets.size());
+    ASSERT_EQ(2, input_rowsets[0]->start_version());
+    ASSERT_EQ(3, input_rowsets[1]->end_version());
+}
+
+TEST_F(TestTimeSeriesCumulativeCompactionPolicy, pick_input_rowsets_window_open) {
+    std::vector<RowsetMetaSharedPtr> rs_metas;
+    init_rs_meta_small(&rs_metas);
+    init_tablet(rs_metas);
+
+    std::vector<RowsetSharedPtr> input_rowsets;
+    pick_input_rowsets(&input_rowsets);
+    ASSERT_EQ(0, input_rowsets.size());
+    ASSERT_EQ(2, _tablet->cumulative_layer_point());
+}
+
+TEST_F(TestTimeSeriesCumulativeCompactionPolicy, pick_input_rowsets_window_timeout) {
+    std::vector<RowsetMetaSharedPtr> rs_metas;
+    init_rs_meta_small(&rs_metas);
+    rs_metas[1]->set_creation_time(UnixSeconds() - 7200);
+    init_tablet(rs_metas);
+
+    std::vector<RowsetSharedPtr> input_rowsets;
+    pick_input_rowsets(&input_rowsets);
+    ASSERT_EQ(3, input_rowsets.size());
+}
+
+TEST_F(TestTimeSeriesCumulativeCompactionPolicy, pick_input_rowsets_final_rowset) {
+    std::vector<RowsetMetaSharedPtr> rs_metas;
+    init_rs_meta_small(&rs_metas);
+    // version 2 is of the goal size and sorted, it needs no compaction
+    rs_metas[1]->set_total_disk_size(2 * 1024 * 1024);
+    rs_metas[1]->set_segments_overlap(NONOVERLAPPING);
+    init_tablet(rs_metas);
+    ASSERT_EQ(2, _tablet->cumulative_layer_point());
+
+    std::vector<RowsetSharedPtr> input_rowsets;
+    pick_input_rowsets(&input_rowsets);
+    ASSERT_EQ(0, input_rowsets.size());
+    ASSERT_EQ(3, _tablet->cumulative_layer_point());
+}
+
+TEST_F(TestTimeSeriesCumulativeCompactionPolicy, update_cumulative_point) {
+    std::vector<RowsetMetaSharedPtr> rs_metas;
+    init_rs_meta_small(&rs_metas);
+    init_tablet(rs_metas);
+
+    // the output of a small window is final as well
+    std::vector<RowsetSharedPtr> input_rowsets;
+    input_rowsets.push_back(_tablet->get_rowset_by_version({2, 2}));
+    input_rowsets.push_back(_tablet->get_rowset_by_version({3, 3}));
+    Version last_delete_version{-1, -1};
+    _tablet->_cumulative_compaction_policy->update_cumulative_point(
+            _tablet.get(), input_rowsets, input_rowsets.back(), last_delete_version);
+    ASSERT_EQ(4, _tablet->cumulative_layer_point());
+}
+
+TEST_F(TestTimeSeriesCumulativeCompactionPolicy, need_base_compaction) {
+    std::vector<RowsetMetaSharedPtr> rs_metas;
+    init_rs_meta_small(&rs_metas);
+    init_tablet(rs_metas);
+
+    ASSERT_FALSE(_tablet->_cumulative_compaction_policy->need_base_compaction(_tablet.get()));
+    ASSERT_EQ(0, _tablet->calc_compaction_score(CompactionType::BASE_COMPACTION));
+
+    int32_t max_tablet_version_num = config::max_tablet_version_num;
+    config::max_tablet_version_num = 4;
+    ASSERT_TRUE(_tablet->_cumulative_compaction_policy->need_base_compaction(_tablet.get()));
+    config::max_tablet_version_num = max_tablet_version_num;
+}
 } // namespace doris
 
 // @brief Test Stub
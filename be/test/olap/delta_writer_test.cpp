@@ -21,15 +21,18 @@
 #include <sys/file.h>
 
 #include <string>
+#include <tuple>
 
 #include "gen_cpp/Descriptors_types.h"
 #include "gen_cpp/PaloInternalService_types.h"
 #include "gen_cpp/Types_types.h"
 #include "olap/field.h"
 #include "olap/options.h"
+#include "olap/row_cursor.h"
 #include "olap/storage_engine.h"
 #include "olap/tablet.h"
 #include "olap/tablet_meta_manager.h"
+#include "olap/tablet_point_getter.h"
 #include "olap/utils.h"
 #include "runtime/descriptor_helper.h"
 #include "runtime/exec_env.h"
@@ -592,6 +595,180 @@ TEST_F(TestDeltaWriter, sequence_col) {
     delete delta_writer;
 }
 
+static void create_unique_tablet_request(int64_t tablet_id, int32_t schema_hash,
+                                        TCreateTabletReq* request) {
+    create_tablet_request_with_sequence_col(tablet_id, schema_hash, request);
+    request->tablet_schema.__isset.sequence_col_idx = false;
+    request->tablet_schema.columns.erase(request->tablet_schema.columns.begin() + 2);
+}
+
+static TDescriptorTable create_descriptor_unique_tablet() {
+    TDescriptorTableBuilder dtb;
+    TTupleDescriptorBuilder tuple_builder;
+    tuple_builder.add_slot(
+            TSlotDescriptorBuilder().type(TYPE_TINYINT).column_name("k1").column_pos(0).build());
+    tuple_builder.add_slot(
+            TSlotDescriptorBuilder().type(TYPE_SMALLINT).column_name("k2").column_pos(1).build());
+    tuple_builder.add_slot(
+            TSlotDescriptorBuilder().type(TYPE_DATETIME).column_name("v1").column_pos(2).build());
+    tuple_builder.build(&dtb);
+    return dtb.desc_tbl();
+}
+
+// Load rows of (k1, k2, v1) into the tablet by txn `txn_id`, and publish it as the next version
+static void load_unique_rows(TabletSharedPtr tablet, int64_t txn_id,
+                             const std::vector<std::tuple<int8_t, int16_t, std::string>>& rows) {
+    TDescriptorTable tdesc_tbl = create_descriptor_unique_tablet();
+    ObjectPool obj_pool;
+    DescriptorTbl* desc_tbl = nullptr;
+    DescriptorTbl::create(&obj_pool, tdesc_tbl, &desc_tbl);
+    TupleDescriptor* tuple_desc = desc_tbl->get_tuple_descriptor(0);
+    const std::vector<SlotDescriptor*>& slots = tuple_desc->slots();
+
+    PUniqueId load_id;
+    load_id.set_hi(0);
+    load_id.set_lo(txn_id);
+    WriteRequest write_req = {tablet->tablet_id(), tablet->schema_hash(), WriteType::LOAD,
+                              txn_id,              30006,                 load_id,
+                              false,               tuple_desc,            &(tuple_desc->slots())};
+    DeltaWriter* delta_writer = nullptr;
+    DeltaWriter::open(&write_req, k_mem_tracker, &delta_writer);
+    ASSERT_NE(delta_writer, nullptr);
+    std::unique_ptr<DeltaWriter> delta_writer_guard(delta_writer);
+
+    MemTracker tracker;
+    MemPool pool(&tracker);
+    for (auto& row : rows) {
+        Tuple* tuple = reinterpret_cast<Tuple*>(pool.allocate(tuple_desc->byte_size()));
+        memset(tuple, 0, tuple_desc->byte_size());
+        *(int8_t*)(tuple->get_slot(slots[0]->tuple_offset())) = std::get<0>(row);
+        *(int16_t*)(tuple->get_slot(slots[1]->tuple_offset())) = std::get<1>(row);
+        ((DateTimeValue*)(tuple->get_slot(slots[2]->tuple_offset())))
+                ->from_date_str(std::get<2>(row).c_str(), std::get<2>(row).size());
+        ASSERT_EQ(OLAP_SUCCESS, delta_writer->write(tuple));
+    }
+    ASSERT_EQ(OLAP_SUCCESS, delta_writer->close());
+    ASSERT_EQ(OLAP_SUCCESS, delta_writer->close_wait(nullptr));
+
+    Version version(tablet->rowset_with_max_version()->end_version() + 1,
+                    tablet->rowset_with_max_version()->end_version() + 1);
+    std::map<TabletInfo, RowsetSharedPtr> tablet_related_rs;
+    StorageEngine::instance()->txn_manager()->get_txn_related_tablets(
+            write_req.txn_id, write_req.partition_id, &tablet_related_rs);
+    for (auto& tablet_rs : tablet_related_rs) {
+        ASSERT_EQ(OLAP_SUCCESS, k_engine->txn_manager()->publish_txn(
+                                        tablet->data_dir()->get_meta(), write_req.partition_id,
+                                        write_req.txn_id, write_req.tablet_id,
+                                        write_req.schema_hash, tablet_rs.first.tablet_uid,
+                                        version, 2));
+        ASSERT_EQ(OLAP_SUCCESS, tablet->add_inc_rowset(tablet_rs.second));
+    }
+}
+
+// Get v1 of (k1, k2) at `version`, empty if not found
+static std::string point_get(TabletSharedPtr tablet, int64_t version, int8_t k1, int16_t k2) {
+    TabletPointGetter getter(tablet, version);
+    EXPECT_EQ(OLAP_SUCCESS, getter.init());
+    RowCursor row;
+    EXPECT_EQ(OLAP_SUCCESS, row.init(tablet->tablet_schema()));
+    OlapTuple key({std::to_string(k1), std::to_string(k2)});
+    bool found = false;
+    EXPECT_EQ(OLAP_SUCCESS, getter.get(key, &row, &found));
+    if (!found) {
+        return "";
+    }
+    return row.column_schema(2)->to_string(row.cell_ptr(2));
+}
+
+TEST_F(TestDeltaWriter, point_get) {
+    TCreateTabletReq request;
+    create_unique_tablet_request(10007, 270068379, &request);
+    ASSERT_EQ(OLAP_SUCCESS, k_engine->create_tablet(request));
+    TabletSharedPtr tablet = k_engine->tablet_manager()->get_tablet(10007, 270068379);
+    ASSERT_NE(nullptr, tablet);
+
+    // version 2
+    load_unique_rows(tablet, 20007,
+                     {std::make_tuple(1, 1, "2020-07-16 19:39:43"),
+                      std::make_tuple(1, 2, "2020-07-16 19:39:44")});
+    // version 3 replaces (1, 1)
+    load_unique_rows(tablet, 20008, {std::make_tuple(1, 1, "2021-01-01 00:00:00")});
+
+    ASSERT_EQ("2021-01-01 00:00:00", point_get(tablet, 3, 1, 1));
+    ASSERT_EQ("2020-07-16 19:39:44", point_get(tablet, 3, 1, 2));
+    ASSERT_EQ("", point_get(tablet, 3, 1, 3));
+    // old versions are still readable
+    ASSERT_EQ("2020-07-16 19:39:43", point_get(tablet, 2, 1, 1));
+    ASSERT_EQ("", point_get(tablet, 1, 1, 1));
+
+    ASSERT_EQ(OLAP_SUCCESS, k_engine->tablet_manager()->drop_tablet(10007, 270068379));
+}
+
+TEST_F(TestDeltaWriter, concurrent_flush) {
+    int32_t old_max_flushing = config::max_flushing_memtables_per_writer;
+    int64_t old_write_buffer_size = config::write_buffer_size;
+    config::max_flushing_memtables_per_writer = 4;
+    // every row fills a memtable
+    config::write_buffer_size = 1;
+
+    TCreateTabletReq request;
+    create_tablet_request_with_sequence_col(10006, 270068378, &request);
+    OLAPStatus res = k_engine->create_tablet(request);
+    ASSERT_EQ(OLAP_SUCCESS, res);
+
+    TDescriptorTable tdesc_tbl = create_descriptor_tablet_with_sequence_col();
+    ObjectPool obj_pool;
+    DescriptorTbl* desc_tbl = nullptr;
+    DescriptorTbl::create(&obj_pool, tdesc_tbl, &desc_tbl);
+    TupleDescriptor* tuple_desc = desc_tbl->get_tuple_descriptor(0);
+    const std::vector<SlotDescriptor*>& slots = tuple_desc->slots();
+
+    PUniqueId load_id;
+    load_id.set_hi(0);
+    load_id.set_lo(0);
+    WriteRequest write_req = {10006, 270068378,  WriteType::LOAD,       20004, 30004, load_id,
+                              false, tuple_desc, &(tuple_desc->slots())};
+    DeltaWriter* delta_writer = nullptr;
+    DeltaWriter::open(&write_req, k_mem_tracker, &delta_writer);
+    ASSERT_NE(delta_writer, nullptr);
+
+    MemTracker tracker;
+    MemPool pool(&tracker);
+    const int num_rows = 100;
+    for (int i = 0; i < num_rows; ++i) {
+        Tuple* tuple = reinterpret_cast<Tuple*>(pool.allocate(tuple_desc->byte_size()));
+        memset(tuple, 0, tuple_desc->byte_size());
+        *(int8_t*)(tuple->get_slot(slots[0]->tuple_offset())) = 1;
+        *(int16_t*)(tuple->get_slot(slots[1]->tuple_offset())) = i;
+        *(int32_t*)(tuple->get_slot(slots[2]->tuple_offset())) = 1;
+        ((DateTimeValue*)(tuple->get_slot(slots[3]->tuple_offset())))
+                ->from_date_str("2020-07-16 19:39:43", 19);
+
+        res = delta_writer->write(tuple);
+        ASSERT_EQ(OLAP_SUCCESS, res);
+    }
+
+    res = delta_writer->close();
+    ASSERT_EQ(OLAP_SUCCESS, res);
+    res = delta_writer->close_wait(nullptr);
+    ASSERT_EQ(OLAP_SUCCESS, res);
+
+    std::map<TabletInfo, RowsetSharedPtr> tablet_related_rs;
+    StorageEngine::instance()->txn_manager()->get_txn_related_tablets(
+            write_req.txn_id, write_req.partition_id, &tablet_related_rs);
+    ASSERT_EQ(1, tablet_related_rs.size());
+    RowsetSharedPtr rowset = tablet_related_rs.begin()->second;
+    // one segment per memtable, whichever finishes first
+    ASSERT_EQ(num_rows, rowset->num_rows());
+    ASSERT_EQ(num_rows, rowset->num_segments());
+
+    config::max_flushing_memtables_per_writer = old_max_flushing;
+    config::write_buffer_size = old_write_buffer_size;
+    res = k_engine->tablet_manager()->drop_tablet(10006, 270068378);
+    ASSERT_EQ(OLAP_SUCCESS, res);
+    delete delta_writer;
+}
+
 } // namespace doris
 
 int main(int argc, char** argv) {
@@ -0,0 +1,330 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/task/engine_clone_task.h"
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gen_cpp/AgentService_types.h"
+#include "gen_cpp/Descriptors_types.h"
+#include "gen_cpp/Types_constants.h"
+#include "olap/delta_writer.h"
+#include "olap/olap_define.h"
+#include "olap/rowset/beta_rowset.h"
+#include "olap/snapshot_manager.h"
+#include "olap/storage_engine.h"
+#include "olap/tablet.h"
+#include "olap/task/engine_publish_version_task.h"
+#include "runtime/descriptor_helper.h"
+#include "runtime/descriptors.h"
+#include "runtime/exec_env.h"
+#include "runtime/mem_pool.h"
+#include "runtime/mem_tracker.h"
+#include "runtime/tuple.h"
+#include "util/cpu_info.h"
+#include "util/file_utils.h"
+
+namespace doris {
+
+static const uint32_t MAX_PATH_LEN = 1024;
+static const int64_t kPartitionId = 31001;
+static const int32_t kSchemaHash = 270068391;
+
+static StorageEngine* k_engine = nullptr;
+static std::shared_ptr<MemTracker> k_mem_tracker = nullptr;
+
+static void set_up() {
+    char buffer[MAX_PATH_LEN];
+    getcwd(buffer, MAX_PATH_LEN);
+    config::storage_root_path = std::string(buffer) + "/data_engine_clone_task_test";
+    FileUtils::remove_all(config::storage_root_path);
+    FileUtils::create_dir(config::storage_root_path);
+    std::vector<StorePath> paths;
+    paths.emplace_back(config::storage_root_path, -1);
+
+    EngineOptions options;
+    options.store_paths = paths;
+    Status s = StorageEngine::open(options, &k_engine);
+    ASSERT_TRUE(s.ok()) << s.to_string();
+    ExecEnv::GetInstance()->set_storage_engine(k_engine);
+    k_mem_tracker.reset(new MemTracker(-1, "engine clone task test"));
+}
+
+static void tear_down() {
+    if (k_engine != nullptr) {
+        k_engine->stop();
+        delete k_engine;
+        k_engine = nullptr;
+    }
+    FileUtils::remove_all(config::storage_root_path);
+}
+
+// Full clones of a tablet which has some of the versions of the source already, so the
+// snapshot skips the files of the rowsets of those versions.
+class EngineCloneTaskTest : public testing::Test {
+protected:
+    // (k1 int, v1 int) duplicate key (k1)
+    TabletSharedPtr create_tablet(int64_t tablet_id) {
+        TCreateTabletReq request;
+        request.tablet_id = tablet_id;
+        request.__set_version(1);
+        request.__set_version_hash(0);
+        request.__set_storage_format(TStorageFormat::V2);
+        request.tablet_schema.schema_hash = kSchemaHash;
+        request.tablet_schema.short_key_column_count = 1;
+        request.tablet_schema.keys_type = TKeysType::DUP_KEYS;
+        request.tablet_schema.storage_type = TStorageType::COLUMN;
+
+        TColumn k1;
+        k1.column_name = "k1";
+        k1.__set_is_key(true);
+        k1.column_type.type = TPrimitiveType::INT;
+        request.tablet_schema.columns.push_back(k1);
+
+        TColumn v1;
+        v1.column_name = "v1";
+        v1.__set_is_key(false);
+        v1.column_type.type = TPrimitiveType::INT;
+        v1.__set_aggregation_type(TAggregationType::NONE);
+        request.tablet_schema.columns.push_back(v1);
+
+        EXPECT_EQ(OLAP_SUCCESS, k_engine->create_tablet(request));
+        _tablet_ids.push_back(tablet_id);
+        return k_engine->tablet_manager()->get_tablet(tablet_id, kSchemaHash);
+    }
+
+    void TearDown() override {
+        for (int64_t tablet_id : _tablet_ids) {
+            k_engine->tablet_manager()->drop_tablet(tablet_id, kSchemaHash);
+        }
+    }
+
+    // Load `num_rows` rows into the tablet by txn `txn_id` and publish them as `version`
+    void load(const TabletSharedPtr& tablet, int64_t txn_id, int64_t version, int num_rows) {
+        TDescriptorTableBuilder dtb;
+        TTupleDescriptorBuilder tuple_builder;
+        tuple_builder.add_slot(
+                TSlotDescriptorBuilder().type(TYPE_INT).column_name("k1").column_pos(0).build());
+        tuple_builder.add_slot(
+                TSlotDescriptorBuilder().type(TYPE_INT).column_name("v1").column_pos(1).build());
+        tuple_builder.build(&dtb);
+        ObjectPool obj_pool;
+        DescriptorTbl* desc_tbl = nullptr;
+        DescriptorTbl::create(&obj_pool, dtb.desc_tbl(), &desc_tbl);
+        TupleDescriptor* tuple_desc = desc_tbl->get_tuple_descriptor(0);
+        const std::vector<SlotDescriptor*>& slots = tuple_desc->slots();
+
+        PUniqueId load_id;
+        load_id.set_hi(tablet->tablet_id());
+        load_id.set_lo(txn_id);
+        WriteRequest write_req = {tablet->tablet_id(), kSchemaHash, WriteType::LOAD,
+                                  txn_id,              kPartitionId, load_id,
+                                  false,               tuple_desc,   &slots};
+        DeltaWriter* delta_writer = nullptr;
+        DeltaWriter::open(&write_req, k_mem_tracker, &delta_writer);
+        ASSERT_NE(nullptr, delta_writer);
+        std::unique_ptr<DeltaWriter> delta_writer_guard(delta_writer);
+
+        MemTracker tracker;
+        MemPool pool(&tracker);
+        for (int i = 0; i < num_rows; ++i) {
+            Tuple* tuple = reinterpret_cast<Tuple*>(pool.allocate(tuple_desc->byte_size()));
+            memset(tuple, 0, tuple_desc->byte_size());
+            *(int32_t*)(tuple->get_slot(slots[0]->tuple_offset())) = i;
+            *(int32_t*)(tuple->get_slot(slots[1]->tuple_offset())) = i * 10;
+            ASSERT_EQ(OLAP_SUCCESS, delta_writer->write(tuple));
+        }
+        ASSERT_EQ(OLAP_SUCCESS, delta_writer->close());
+        ASSERT_EQ(OLAP_SUCCESS, delta_writer->close_wait(nullptr));
+
+        TPublishVersionRequest req;
+        TPartitionVersionInfo par_ver_info;
+        par_ver_info.partition_id = kPartitionId;
+        par_ver_info.version = version;
+        par_ver_info.version_hash = 0;
+        req.transaction_id = txn_id;
+        req.partition_version_infos.push_back(par_ver_info);
+        std::vector<TTabletId> error_tablet_ids;
+        EnginePublishVersionTask task(req, &error_tablet_ids);
+        ASSERT_EQ(OLAP_SUCCESS, k_engine->execute_task(&task));
+    }
+
+    // Make a full snapshot of `src` without the files of the base rowsets of `task`, and
+    // download it into the clone dir of `dst` as _do_clone() does, up to converting the
+    // rowset ids. Returns the clone dir.
+    std::string download(const TabletSharedPtr& src, const TabletSharedPtr& dst,
+                         EngineCloneTask* task) {
+        TSnapshotRequest request;
+        request.tablet_id = src->tablet_id();
+        request.schema_hash = kSchemaHash;
+        request.__set_preferred_snapshot_version(g_Types_constants.TSNAPSHOT_REQ_VERSION2);
+        request.__isset.base_versions = true;
+        for (auto& rowset : task->_base_rowsets) {
+            request.base_versions.push_back(rowset->start_version());
+            request.base_versions.push_back(rowset->end_version());
+        }
+        std::string snapshot_path;
+        EXPECT_EQ(OLAP_SUCCESS,
+                  SnapshotManager::instance()->make_snapshot(request, &snapshot_path));
+        std::string snapshot_dir = snapshot_path + "/" + std::to_string(src->tablet_id()) + "/" +
+                                   std::to_string(kSchemaHash);
+
+        // the files of the base version are skipped, the others are linked
+        RowsetSharedPtr base_rowset = src->get_rowset_by_version({2, 2});
+        RowsetSharedPtr new_rowset = src->get_rowset_by_version({3, 3});
+        EXPECT_FALSE(FileUtils::check_exist(
+                BetaRowset::segment_file_path(snapshot_dir, base_rowset->rowset_id(), 0)));
+        EXPECT_TRUE(FileUtils::check_exist(
+                BetaRowset::segment_file_path(snapshot_dir, new_rowset->rowset_id(), 0)));
+
+        std::string clone_dir = dst->tablet_path() + CLONE_PREFIX;
+        EXPECT_TRUE(FileUtils::create_dir(clone_dir).ok());
+        std::set<std::string> files;
+        EXPECT_TRUE(FileUtils::list_dirs_files(snapshot_dir, nullptr, &files, Env::Default()).ok());
+        for (auto& file : files) {
+            std::string to = file == std::to_string(src->tablet_id()) + ".hdr"
+                                     ? std::to_string(dst->tablet_id()) + ".hdr"
+                                     : file;
+            EXPECT_EQ(0, link((snapshot_dir + "/" + file).c_str(),
+                              (clone_dir + "/" + to).c_str()));
+        }
+        EXPECT_EQ(OLAP_SUCCESS, SnapshotManager::instance()->release_snapshot(snapshot_path));
+
+        EXPECT_EQ(OLAP_SUCCESS, task->_drop_base_rowset_metas(clone_dir, dst->tablet_id()));
+        EXPECT_EQ(OLAP_SUCCESS, SnapshotManager::instance()->convert_rowset_ids(
+                                        clone_dir, dst->tablet_id(), kSchemaHash));
+        return clone_dir;
+    }
+
+    // Check that every file in the dir of `tablet` belongs to a rowset of its meta,
+    // except those of `other_rowset_id`, and the segments of its rowsets exist
+    void check_files(const TabletSharedPtr& tablet, const std::string& other_rowset_id = "") {
+        std::set<std::string> rowset_ids;
+        for (auto& rs_meta : tablet->tablet_meta()->all_rs_metas()) {
+            rowset_ids.insert(rs_meta->rowset_id().to_string());
+            for (int64_t i = 0; i < rs_meta->num_segments(); ++i) {
+                ASSERT_TRUE(FileUtils::check_exist(BetaRowset::segment_file_path(
+                        tablet->tablet_path(), rs_meta->rowset_id(), i)));
+            }
+        }
+        std::set<std::string> files;
+        ASSERT_TRUE(FileUtils::list_dirs_files(tablet->tablet_path(), nullptr, &files,
+                                               Env::Default())
+                            .ok());
+        for (auto& file : files) {
+            std::string rowset_id = file.substr(0, file.find('_'));
+            ASSERT_TRUE(rowset_ids.count(rowset_id) > 0 || rowset_id == other_rowset_id)
+                    << "unreferenced file " << file;
+        }
+    }
+
+    EngineCloneTask* new_task(const TabletSharedPtr& tablet, int64_t committed_version) {
+        _clone_req.tablet_id = tablet->tablet_id();
+        _clone_req.schema_hash = kSchemaHash;
+        _clone_req.__set_committed_version(committed_version);
+        return new EngineCloneTask(_clone_req, _master_info, 0, &_error_msgs, &_tablet_infos,
+                                   &_status);
+    }
+
+    std::vector<int64_t> _tablet_ids;
+    TCloneReq _clone_req;
+    TMasterInfo _master_info;
+    std::vector<std::string> _error_msgs;
+    std::vector<TTabletInfo> _tablet_infos;
+    AgentStatus _status;
+};
+
+TEST_F(EngineCloneTaskTest, keep_base_rowsets) {
+    TabletSharedPtr src = create_tablet(16001);
+    TabletSharedPtr dst = create_tablet(16002);
+    ASSERT_NE(nullptr, src);
+    ASSERT_NE(nullptr, dst);
+    load(src, 21001, 2, 10);
+    load(dst, 21002, 2, 10);
+    load(src, 21003, 3, 20);
+    RowsetSharedPtr local_rowset = dst->get_rowset_by_version({2, 2});
+
+    std::unique_ptr<EngineCloneTask> task(new_task(dst, 3));
+    task->_capture_base_rowsets(dst.get());
+    // versions 0-1 and 2
+    ASSERT_EQ(2, task->_base_rowsets.size());
+    std::string clone_dir = download(src, dst, task.get());
+    ASSERT_EQ(1, task->_skipped_base_rowsets.size());
+    ASSERT_EQ(OLAP_SUCCESS, task->_finish_clone(dst.get(), clone_dir, 3, false));
+
+    // the local rowset of version 2 is kept, version 3 is cloned
+    ASSERT_EQ(3, dst->max_version().second);
+    ASSERT_EQ(local_rowset->rowset_id(), dst->get_rowset_by_version({2, 2})->rowset_id());
+    ASSERT_EQ(20, dst->get_rowset_by_version({3, 3})->num_rows());
+    ASSERT_FALSE(FileUtils::check_exist(clone_dir));
+    check_files(dst);
+}
+
+TEST_F(EngineCloneTaskTest, link_compacted_base_rowsets) {
+    TabletSharedPtr src = create_tablet(16003);
+    TabletSharedPtr dst = create_tablet(16004);
+    ASSERT_NE(nullptr, src);
+    ASSERT_NE(nullptr, dst);
+    load(src, 21004, 2, 10);
+    load(dst, 21005, 2, 10);
+    load(src, 21006, 3, 20);
+    RowsetSharedPtr local_rowset = dst->get_rowset_by_version({2, 2});
+
+    std::unique_ptr<EngineCloneTask> task(new_task(dst, 3));
+    task->_capture_base_rowsets(dst.get());
+    std::string clone_dir = download(src, dst, task.get());
+    ASSERT_EQ(1, task->_skipped_base_rowsets.size());
+    // the local rowset of version 2 is gone before the clone locks the tablet
+    {
+        std::lock_guard<std::mutex> update_lock(*dst->get_rowset_update_lock());
+        WriteLock wrlock(dst->get_header_lock_ptr());
+        ASSERT_EQ(OLAP_SUCCESS, dst->revise_tablet_meta({}, {Version(2, 2)}));
+    }
+    ASSERT_EQ(nullptr, dst->get_rowset_by_version({2, 2}));
+    ASSERT_EQ(OLAP_SUCCESS, task->_finish_clone(dst.get(), clone_dir, 3, false));
+
+    // the files of the base rowset are linked as a new rowset of version 2
+    RowsetSharedPtr rowset = dst->get_rowset_by_version({2, 2});
+    ASSERT_NE(nullptr, rowset);
+    ASSERT_NE(local_rowset->rowset_id(), rowset->rowset_id());
+    ASSERT_EQ(10, rowset->num_rows());
+    ASSERT_EQ(20, dst->get_rowset_by_version({3, 3})->num_rows());
+    check_files(dst, local_rowset->rowset_id().to_string());
+}
+
+} // namespace doris
+
+int main(int argc, char** argv) {
+    std::string conffile = std::string(getenv("DORIS_HOME")) + "/conf/be.conf";
+    if (!doris::config::init(conffile.c_str(), false)) {
+        fprintf(stderr, "error read config file. \n");
+        return -1;
+    }
+    testing::InitGoogleTest(&argc, argv);
+    doris::CpuInfo::init();
+    doris::set_up();
+    int ret = RUN_ALL_TESTS();
+    doris::tear_down();
+    google::protobuf::ShutdownProtobufLibrary();
+    return ret;
+}
@@ -76,6 +76,32 @@ TEST_F(FileBlockManagerTest, NormalTest) {
     rblock->close();
 }
 
+TEST_F(FileBlockManagerTest, OpenFromFileCache) {
+    fs::BlockManagerOptions bm_opts;
+    bm_opts.read_only = false;
+    bm_opts.enable_metric = false;
+    Env* env = Env::Default();
+    std::unique_ptr<fs::FileBlockManager> fbm(new fs::FileBlockManager(env, std::move(bm_opts)));
+
+    std::unique_ptr<fs::WritableBlock> wblock;
+    std::string fname = kBlockManagerDir + "/test_cached_file";
+    fs::CreateBlockOptions wblock_opts({fname});
+    ASSERT_TRUE(fbm->create_block(wblock_opts, &wblock).ok());
+    wblock->append("abc");
+    wblock->close();
+
+    std::unique_ptr<fs::ReadableBlock> rblock1;
+    bool opened = false;
+    ASSERT_TRUE(fbm->open_block(fname, &rblock1, &opened).ok());
+    ASSERT_TRUE(opened);
+    // the file is in the file cache now
+    std::unique_ptr<fs::ReadableBlock> rblock2;
+    ASSERT_TRUE(fbm->open_block(fname, &rblock2, &opened).ok());
+    ASSERT_FALSE(opened);
+    rblock1->close();
+    rblock2->close();
+}
+
 } // namespace doris
 
 int main(int argc, char** argv) {
@@ -0,0 +1,128 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/fs/ssd_block_cache.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "common/config.h"
+#include "env/env.h"
+#include "util/file_utils.h"
+#include "util/slice.h"
+
+namespace doris {
+
+class SsdBlockCacheTest : public testing::Test {
+protected:
+    const std::string kTestDir = "./ut_dir/ssd_block_cache";
+    const std::string kDataDir = kTestDir + "/data";
+    const std::string kCacheDir = kTestDir + "/cache";
+
+    void SetUp() override {
+        if (FileUtils::check_exist(kTestDir)) {
+            ASSERT_TRUE(FileUtils::remove_all(kTestDir).ok());
+        }
+        ASSERT_TRUE(FileUtils::create_dir(kDataDir).ok());
+    }
+
+    void TearDown() override {
+        if (FileUtils::check_exist(kTestDir)) {
+            ASSERT_TRUE(FileUtils::remove_all(kTestDir).ok());
+        }
+    }
+
+    void write_file(const std::string& fname, const std::string& data) {
+        std::unique_ptr<WritableFile> file;
+        ASSERT_TRUE(Env::Default()->new_writable_file(fname, &file).ok());
+        ASSERT_TRUE(file->append(data).ok());
+        ASSERT_TRUE(file->close().ok());
+    }
+
+    size_t num_cached_blocks() {
+        std::vector<std::string> files;
+        EXPECT_TRUE(FileUtils::list_files(Env::Default(), kCacheDir, &files).ok());
+        return files.size();
+    }
+};
+
+TEST_F(SsdBlockCacheTest, ReadThroughCache) {
+    config::ssd_cache_admit_on_second_access = true;
+    // 3 blocks of 4096 bytes
+    fs::SsdBlockCache cache(kCacheDir, 1024 * 1024, 4096);
+    ASSERT_TRUE(cache.init().ok());
+    cache.add_cached_root(kDataDir);
+
+    std::string fname = kDataDir + "/test_file";
+    std::string data;
+    for (int i = 0; i < 10000; ++i) {
+        data.push_back('a' + i % 26);
+    }
+    write_file(fname, data);
+    ASSERT_TRUE(cache.is_cached_file(fname));
+    ASSERT_FALSE(cache.is_cached_file(kTestDir + "/other_file"));
+
+    std::unique_ptr<RandomAccessFile> file;
+    ASSERT_TRUE(Env::Default()->new_random_access_file(fname, &file).ok());
+
+    // read across the boundaries of all blocks
+    std::string buf1(100, '\0');
+    std::string buf2(9000, '\0');
+    Slice slices[2] = {Slice(buf1), Slice(buf2)};
+    ASSERT_TRUE(cache.readv(fname, file.get(), data.size(), 900, slices, 2).ok());
+    ASSERT_EQ(data.substr(900, 100), buf1);
+    ASSERT_EQ(data.substr(1000, 9000), buf2);
+    // not admitted on the first access
+    ASSERT_EQ(0, num_cached_blocks());
+
+    ASSERT_TRUE(cache.readv(fname, file.get(), data.size(), 900, slices, 2).ok());
+    ASSERT_EQ(3, num_cached_blocks());
+
+    // served by the cached blocks
+    std::string buf3(200, '\0');
+    Slice slice(buf3);
+    ASSERT_TRUE(cache.readv(fname, file.get(), data.size(), 4000, &slice, 1).ok());
+    ASSERT_EQ(data.substr(4000, 200), buf3);
+}
+
+TEST_F(SsdBlockCacheTest, InsertFile) {
+    fs::SsdBlockCache cache(kCacheDir, 1024 * 1024, 4096);
+    ASSERT_TRUE(cache.init().ok());
+    cache.add_cached_root(kDataDir);
+
+    std::string fname = kDataDir + "/test_file";
+    std::string data(5000, 'x');
+    write_file(fname, data);
+    ASSERT_TRUE(cache.insert_file(fname).ok());
+    ASSERT_EQ(2, num_cached_blocks());
+
+    // the file is removed, reads are served by the cache
+    ASSERT_TRUE(FileUtils::remove(fname).ok());
+    std::string buf(5000, '\0');
+    Slice slice(buf);
+    ASSERT_TRUE(cache.readv(fname, nullptr, data.size(), 0, &slice, 1).ok());
+    ASSERT_EQ(data, buf);
+}
+
+} // namespace doris
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -156,6 +156,60 @@ TEST(GenericIteratorsTest, Merge) {
     delete iter;
 }
 
+TEST(GenericIteratorsTest, RowSources) {
+    auto schema = create_schema();
+    std::vector<RowwiseIterator*> inputs;
+
+    inputs.push_back(new_auto_increment_iterator(schema, 100));
+    inputs.push_back(new_auto_increment_iterator(schema, 200));
+    inputs.push_back(new_auto_increment_iterator(schema, 300));
+
+    std::vector<uint16_t> row_sources;
+    auto merge_iter = new_merge_iterator(std::move(inputs), &row_sources);
+    StorageReadOptions opts;
+    auto st = merge_iter->init(opts);
+    ASSERT_TRUE(st.ok());
+
+    std::vector<int16_t> merged_values;
+    RowBlockV2 block(schema, 128);
+    do {
+        block.clear();
+        st = merge_iter->next_batch(&block);
+        for (int i = 0; i < block.num_rows(); ++i) {
+            merged_values.push_back(*(int16_t*)block.row(i).cell_ptr(0));
+        }
+    } while (st.ok());
+    ASSERT_TRUE(st.is_end_of_file());
+    ASSERT_EQ(600, row_sources.size());
+    delete merge_iter;
+
+    // replay the merge with the same inputs
+    inputs.clear();
+    inputs.push_back(new_auto_increment_iterator(schema, 100));
+    inputs.push_back(new_auto_increment_iterator(schema, 200));
+    inputs.push_back(new_auto_increment_iterator(schema, 300));
+    auto iter = new_row_sources_iterator(std::move(inputs), &row_sources);
+    st = iter->init(opts);
+    ASSERT_TRUE(st.ok());
+
+    size_t row_count = 0;
+    do {
+        block.clear();
+        st = iter->next_batch(&block);
+        for (int i = 0; i < block.num_rows(); ++i) {
+            auto row = block.row(i);
+            ASSERT_EQ(merged_values[row_count], *(int16_t*)row.cell_ptr(0));
+            ASSERT_EQ(merged_values[row_count] + 1, *(int32_t*)row.cell_ptr(1));
+            ASSERT_EQ(merged_values[row_count] + 2, *(int64_t*)row.cell_ptr(2));
+            row_count++;
+        }
+    } while (st.ok());
+    ASSERT_TRUE(st.is_end_of_file());
+    ASSERT_EQ(600, row_count);
+
+    delete iter;
+}
+
 } // namespace doris
 
 int main(int argc, char** argv) {
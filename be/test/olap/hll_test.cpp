@@ -19,6 +19,9 @@
 
 #include <gtest/gtest.h>
 
+#include <string>
+#include <vector>
+
 #include "util/hash_util.hpp"
 #include "util/slice.h"
 
@@ -192,6 +195,42 @@ TEST_F(TestHll, Normal) {
     }
 }
 
+// merging a serialized value is the same as merging its deserialized HyperLogLog
+TEST_F(TestHll, MergeSerialized) {
+    HyperLogLog explicit_hll;
+    HyperLogLog sparse_hll;
+    HyperLogLog full_hll;
+    for (int i = 0; i < 100; ++i) {
+        explicit_hll.update(hash(i));
+    }
+    for (int i = 0; i < 1000; ++i) {
+        sparse_hll.update(hash(i + 1000));
+    }
+    std::vector<uint64_t> hash_values;
+    for (int i = 0; i < 100000; ++i) {
+        hash_values.push_back(hash(i + 10000));
+    }
+    full_hll.update(hash_values.data(), hash_values.size());
+
+    std::vector<HyperLogLog*> hlls = {&explicit_hll, &sparse_hll, &full_hll};
+    std::vector<std::string> serialized;
+    for (HyperLogLog* hll : hlls) {
+        std::string buf(hll->max_serialized_size(), '\0');
+        buf.resize(hll->serialize((uint8_t*)buf.data()));
+        serialized.push_back(buf);
+    }
+    for (const std::string& dst : serialized) {
+        for (const std::string& src : serialized) {
+            Slice src_slice(src.data(), src.size());
+            HyperLogLog expected(Slice(dst.data(), dst.size()));
+            expected.merge(HyperLogLog(src_slice));
+            HyperLogLog hll(Slice(dst.data(), dst.size()));
+            hll.merge(src_slice);
+            ASSERT_EQ(expected.estimate_cardinality(), hll.estimate_cardinality());
+        }
+    }
+}
+
 TEST_F(TestHll, InvalidPtr) {
     {
         HyperLogLog hll(Slice((char*)nullptr, 0));
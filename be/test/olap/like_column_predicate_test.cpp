@@ -0,0 +1,125 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/like_column_predicate.h"
+
+#include <gtest/gtest.h>
+
+#include "olap/field.h"
+#include "olap/row_block2.h"
+#include "olap/schema.h"
+#include "olap/tablet_schema.h"
+#include "util/logging.h"
+
+namespace doris {
+
+class TestLikeColumnPredicate : public testing::Test {
+public:
+    void SetTabletSchema(const std::string& type, bool is_allow_null,
+                         TabletSchema* tablet_schema) {
+        TabletSchemaPB tablet_schema_pb;
+        ColumnPB* column = tablet_schema_pb.add_column();
+        column->set_unique_id(1);
+        column->set_name("STRING_COLUMN");
+        column->set_type(type);
+        column->set_is_key(true);
+        column->set_is_nullable(is_allow_null);
+        column->set_length(16);
+        column->set_aggregation("NONE");
+        tablet_schema->init_from_pb(tablet_schema_pb);
+    }
+};
+
+TEST_F(TestLikeColumnPredicate, match) {
+    LikeColumnPredicate substring(0, "%foo%", false);
+    ASSERT_TRUE(substring.match(Slice("foo")));
+    ASSERT_TRUE(substring.match(Slice("a foo b")));
+    ASSERT_FALSE(substring.match(Slice("fo o")));
+    ASSERT_FALSE(substring.match(Slice("")));
+
+    LikeColumnPredicate prefix(0, "foo%", false);
+    ASSERT_TRUE(prefix.match(Slice("foobar")));
+    ASSERT_FALSE(prefix.match(Slice("barfoo")));
+
+    LikeColumnPredicate suffix(0, "%foo", false);
+    ASSERT_TRUE(suffix.match(Slice("barfoo")));
+    ASSERT_TRUE(suffix.match(Slice("foofoo")));
+    ASSERT_FALSE(suffix.match(Slice("foobar")));
+
+    LikeColumnPredicate exact(0, "foo", false);
+    ASSERT_TRUE(exact.match(Slice("foo")));
+    ASSERT_FALSE(exact.match(Slice("foo ")));
+
+    // backtracking to a later occurrence of the literal after '%'
+    LikeColumnPredicate multi(0, "%ab%abc", false);
+    ASSERT_TRUE(multi.match(Slice("ababab abc")));
+    ASSERT_FALSE(multi.match(Slice("abc ab")));
+
+    LikeColumnPredicate any_char(0, "a_c%", false);
+    ASSERT_TRUE(any_char.match(Slice("abc")));
+    ASSERT_TRUE(any_char.match(Slice("a\xe4\xb8\xad" "cd")));
+    ASSERT_FALSE(any_char.match(Slice("ac")));
+    ASSERT_FALSE(any_char.match(Slice("abbc")));
+
+    LikeColumnPredicate escaped(0, "100\\%%", false);
+    ASSERT_TRUE(escaped.match(Slice("100% sure")));
+    ASSERT_FALSE(escaped.match(Slice("1000")));
+
+    LikeColumnPredicate any(0, "%", false);
+    ASSERT_TRUE(any.match(Slice("")));
+    ASSERT_TRUE(any.match(Slice("foo")));
+
+    // padding of CHAR is not part of the value
+    LikeColumnPredicate char_suffix(0, "%foo", true);
+    ASSERT_TRUE(char_suffix.match(Slice("foo\0\0\0", 6)));
+}
+
+TEST_F(TestLikeColumnPredicate, evaluate_column_block) {
+    TabletSchema tablet_schema;
+    SetTabletSchema("VARCHAR", true, &tablet_schema);
+    Schema schema(tablet_schema);
+    const int size = 6;
+    RowBlockV2 block(schema, size);
+    ColumnBlock column = block.column_block(0);
+    const char* values[size] = {"foo", "a foo", nullptr, "bar", "food", "fo"};
+    for (int i = 0; i < size; ++i) {
+        column.set_is_null(i, values[i] == nullptr);
+        if (values[i] != nullptr) {
+            *reinterpret_cast<Slice*>(column.mutable_cell_ptr(i)) = Slice(values[i]);
+        }
+    }
+
+    LikeColumnPredicate pred(0, "%foo%", false);
+    uint16_t sel[size];
+    for (int i = 0; i < size; ++i) {
+        sel[i] = i;
+    }
+    uint16_t selected_size = size;
+    pred.evaluate(&column, sel, &selected_size);
+    ASSERT_EQ(3, selected_size);
+    ASSERT_EQ(0, sel[0]);
+    ASSERT_EQ(1, sel[1]);
+    ASSERT_EQ(4, sel[2]);
+}
+
+} // namespace doris
+
+int main(int argc, char** argv) {
+    doris::init_glog("be-test");
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,100 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+#include "olap/loser_tree.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace doris {
+
+// Merge sorted runs, an exhausted run is after all others.
+class RunsMerger {
+public:
+    explicit RunsMerger(const std::vector<std::vector<int>>& runs)
+            : _runs(runs), _pos(runs.size(), 0) {}
+
+    bool less(int a, int b) const { return value(a) < value(b); }
+
+    int value(int run) const {
+        return _pos[run] < _runs[run].size() ? _runs[run][_pos[run]]
+                                             : std::numeric_limits<int>::max();
+    }
+
+    std::vector<int> merge() {
+        auto less = [this](int a, int b) { return this->less(a, b); };
+        LoserTree<decltype(less)> tree(less);
+        tree.init(_runs.size());
+        std::vector<int> result;
+        while (value(tree.winner()) != std::numeric_limits<int>::max()) {
+            int winner = tree.winner();
+            int runner_up = tree.runner_up();
+            if (runner_up >= 0) {
+                // the runner-up is the first of the others
+                for (int i = 0; i < _runs.size(); ++i) {
+                    if (i != winner) {
+                        EXPECT_LE(value(runner_up), value(i));
+                    }
+                }
+            }
+            result.push_back(value(winner));
+            ++_pos[winner];
+            tree.replay();
+        }
+        return result;
+    }
+
+private:
+    std::vector<std::vector<int>> _runs;
+    std::vector<size_t> _pos;
+};
+
+TEST(LoserTreeTest, MergeRuns) {
+    std::mt19937 rng(0);
+    for (int num_runs = 1; num_runs <= 9; ++num_runs) {
+        std::vector<std::vector<int>> runs(num_runs);
+        std::vector<int> expected;
+        for (auto& run : runs) {
+            int size = rng() % 100;
+            for (int i = 0; i < size; ++i) {
+                run.push_back(rng() % 1000);
+            }
+            std::sort(run.begin(), run.end());
+            expected.insert(expected.end(), run.begin(), run.end());
+        }
+        std::sort(expected.begin(), expected.end());
+        RunsMerger merger(runs);
+        ASSERT_EQ(expected, merger.merge());
+    }
+}
+
+TEST(LoserTreeTest, NonOverlappingRuns) {
+    std::vector<std::vector<int>> runs = {{20, 21, 22}, {0, 1, 2}, {}, {10, 11}};
+    RunsMerger merger(runs);
+    std::vector<int> expected = {0, 1, 2, 10, 11, 20, 21, 22};
+    ASSERT_EQ(expected, merger.merge());
+}
+
+} // namespace doris
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
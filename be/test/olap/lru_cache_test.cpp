@@ -19,6 +19,8 @@
 
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <thread>
 #include <vector>
 
 #include "util/logging.h"
@@ -72,7 +74,11 @@ public:
     std::vector<int> _deleted_values;
     Cache* _cache;
 
-    CacheTest() : _cache(new_lru_cache("test", kCacheSize)) { _s_current = this; }
+    CacheTest() : CacheTest(LRUCacheType::LRU) {}
+
+    explicit CacheTest(LRUCacheType type) : _cache(new_lru_cache("test", kCacheSize, type)) {
+        _s_current = this;
+    }
 
     ~CacheTest() { delete _cache; }
 
@@ -111,6 +117,14 @@ public:
 };
 CacheTest* CacheTest::_s_current;
 
+class ClockCacheTest : public CacheTest {
+public:
+    ClockCacheTest() : CacheTest(LRUCacheType::CLOCK) {}
+
+    // Deleter doesn't record the entries, for entries freed by other threads
+    static void NoopDeleter(const CacheKey& key, void* v) {}
+};
+
 TEST_F(CacheTest, HitAndMiss) {
     ASSERT_EQ(-1, Lookup(100));
 
@@ -255,6 +269,169 @@ TEST_F(CacheTest, Usage) {
     ASSERT_EQ(950, cache.get_usage());
 }
 
+TEST_F(ClockCacheTest, HitAndMiss) {
+    ASSERT_EQ(-1, Lookup(100));
+
+    Insert(100, 101, 1);
+    ASSERT_EQ(101, Lookup(100));
+    ASSERT_EQ(-1, Lookup(200));
+
+    Insert(200, 201, 1);
+    Insert(100, 102, 1);
+    ASSERT_EQ(102, Lookup(100));
+    ASSERT_EQ(201, Lookup(200));
+
+    ASSERT_EQ(1, _deleted_keys.size());
+    ASSERT_EQ(100, _deleted_keys[0]);
+    ASSERT_EQ(101, _deleted_values[0]);
+
+    Erase(100);
+    ASSERT_EQ(-1, Lookup(100));
+    ASSERT_EQ(2, _deleted_keys.size());
+}
+
+TEST_F(ClockCacheTest, EntriesArePinned) {
+    Insert(100, 101, 1);
+    std::string result1;
+    Cache::Handle* h1 = _cache->lookup(EncodeKey(&result1, 100));
+    ASSERT_EQ(101, DecodeValue(_cache->value(h1)));
+
+    Erase(100);
+    ASSERT_EQ(-1, Lookup(100));
+    ASSERT_EQ(0, _deleted_keys.size());
+
+    // a pinned entry is not evicted, and is freed by the last release
+    for (int i = 0; i < kCacheSize * 2; i++) {
+        Insert(1000 + i, 2000 + i, 1);
+    }
+    ASSERT_EQ(101, DecodeValue(_cache->value(h1)));
+    _cache->release(h1);
+    ASSERT_EQ(100, _deleted_keys.back());
+    ASSERT_EQ(101, _deleted_values.back());
+}
+
+TEST_F(ClockCacheTest, EvictionPolicy) {
+    Insert(100, 101, 1);
+    Insert(200, 201, 1);
+    InsertDurable(300, 301, 1);
+
+    // Entry referenced since the last sweep must be kept around. Unlike LRU,
+    // CLOCK degrades to FIFO if all entries are referenced between sweeps.
+    for (int i = 0; i < kCacheSize + 100; i++) {
+        Insert(1000 + i, 2000 + i, 1);
+        ASSERT_EQ(101, Lookup(100));
+    }
+
+    ASSERT_EQ(101, Lookup(100));
+    ASSERT_EQ(-1, Lookup(200));
+    ASSERT_EQ(301, Lookup(300));
+}
+
+TEST_F(ClockCacheTest, HeavyEntries) {
+    const int kLight = 1;
+    const int kHeavy = 10;
+    int added = 0;
+    int index = 0;
+    while (added < 2 * kCacheSize) {
+        const int weight = (index & 1) ? kLight : kHeavy;
+        Insert(index, 1000 + index, weight);
+        added += weight;
+        index++;
+    }
+
+    int cached_weight = 0;
+    for (int i = 0; i < index; i++) {
+        const int weight = (i & 1 ? kLight : kHeavy);
+        int r = Lookup(i);
+        if (r >= 0) {
+            cached_weight += weight;
+            ASSERT_EQ(1000 + i, r);
+        }
+    }
+    ASSERT_LE(cached_weight, kCacheSize + kCacheSize / 10);
+}
+
+TEST_F(ClockCacheTest, ConcurrentLookups) {
+    for (int i = 0; i < 100; i++) {
+        Insert(i, 1000 + i, 1);
+    }
+    std::atomic<int> num_hits(0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; t++) {
+        threads.emplace_back([this, &num_hits]() {
+            for (int n = 0; n < 1000; n++) {
+                for (int i = 0; i < 100; i++) {
+                    std::string result;
+                    Cache::Handle* h = _cache->lookup(EncodeKey(&result, i));
+                    if (h != nullptr) {
+                        ++num_hits;
+                        _cache->release(h);
+                    }
+                }
+            }
+        });
+    }
+    // a writer changes the shards concurrently, without evicting the hot entries
+    std::thread writer([this]() {
+        for (int n = 0; n < 10000; n++) {
+            std::string result;
+            CacheKey key = EncodeKey(&result, 10000 + n);
+            Cache::Handle* h =
+                    _cache->insert(key, EncodeValue(n), 1, &ClockCacheTest::NoopDeleter);
+            _cache->erase(key);
+            _cache->release(h);
+        }
+    });
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    writer.join();
+    ASSERT_EQ(8 * 1000 * 100, num_hits);
+    ASSERT_EQ(0, _deleted_keys.size());
+}
+
+static void insert_ClockCache(ClockCache& cache, const CacheKey& key, int value,
+                              CachePriority priority) {
+    uint32_t hash = key.hash(key.data(), key.size(), 0);
+    cache.release(cache.insert(key, hash, EncodeValue(value), value, &deleter, priority));
+}
+
+TEST_F(ClockCacheTest, Usage) {
+    ClockCache cache;
+    cache.set_capacity(1000);
+
+    CacheKey key1("100");
+    insert_ClockCache(cache, key1, 100, CachePriority::NORMAL);
+    ASSERT_EQ(100, cache.get_usage());
+
+    CacheKey key2("200");
+    insert_ClockCache(cache, key2, 200, CachePriority::DURABLE);
+    ASSERT_EQ(300, cache.get_usage());
+
+    CacheKey key3("300");
+    insert_ClockCache(cache, key3, 300, CachePriority::NORMAL);
+    CacheKey key4("400");
+    insert_ClockCache(cache, key4, 400, CachePriority::NORMAL);
+    ASSERT_EQ(1000, cache.get_usage());
+
+    // 300 was referenced and gets a second chance, 100 and 400 are evicted
+    uint32_t hash3 = key3.hash(key3.data(), key3.size(), 0);
+    cache.release(cache.lookup(key3, hash3));
+    CacheKey key5("500");
+    insert_ClockCache(cache, key5, 500, CachePriority::NORMAL);
+    ASSERT_EQ(1000, cache.get_usage());
+    ASSERT_EQ(2, cache.get_evict_count());
+
+    // durable entry is evicted after all the normal ones
+    CacheKey key7("950");
+    insert_ClockCache(cache, key7, 950, CachePriority::DURABLE);
+    ASSERT_EQ(950, cache.get_usage());
+    ASSERT_EQ(5, cache.get_evict_count());
+
+    ASSERT_EQ(1, cache.prune());
+    ASSERT_EQ(0, cache.get_usage());
+}
+
 TEST_F(CacheTest, HeavyEntries) {
     // Add a bunch of light and heavy entries and then count the combined
     // size of items still in the cache, which must be approximately the
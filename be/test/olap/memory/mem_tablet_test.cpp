@@ -21,6 +21,8 @@
 
 #include "olap/memory/mem_tablet_scan.h"
 #include "olap/memory/write_txn.h"
+#include "olap/row_cursor.h"
+#include "olap/rowset/rowset_writer.h"
 #include "olap/tablet_meta.h"
 
 namespace doris {
@@ -33,13 +35,7 @@ struct TData {
     int8_t city;
 };
 
-TEST(MemTablet, writescan) {
-    const int num_insert = 2000000;
-    const int insert_per_write = 500000;
-    const int num_update = 10000;
-    const int update_time = 3;
-    scoped_refptr<Schema> sc;
-    ASSERT_TRUE(Schema::create("id int,uv int,pv int,city tinyint null", &sc).ok());
+static void create_tablet(const scoped_refptr<Schema>& sc, std::shared_ptr<MemTablet>* tablet) {
     std::unordered_map<uint32_t, uint32_t> col_idx_to_unique_id;
     std::vector<TColumn> columns(sc->num_columns());
     for (size_t i = 0; i < sc->num_columns(); i++) {
@@ -69,8 +65,19 @@ TEST(MemTablet, writescan) {
     TabletMetaSharedPtr tablet_meta(
             new TabletMeta(1, 1, 1, 1, 1, tschema, static_cast<uint32_t>(sc->cid_size()),
                            col_idx_to_unique_id, TabletUid(1, 1), TTabletType::TABLET_TYPE_MEMORY));
-    std::shared_ptr<MemTablet> tablet = MemTablet::create_tablet_from_meta(tablet_meta, nullptr);
-    ASSERT_TRUE(tablet->init().ok());
+    *tablet = MemTablet::create_tablet_from_meta(tablet_meta, nullptr);
+    ASSERT_TRUE((*tablet)->init().ok());
+}
+
+TEST(MemTablet, writescan) {
+    const int num_insert = 2000000;
+    const int insert_per_write = 500000;
+    const int num_update = 10000;
+    const int update_time = 3;
+    scoped_refptr<Schema> sc;
+    ASSERT_TRUE(Schema::create("id int,uv int,pv int,city tinyint null", &sc).ok());
+    std::shared_ptr<MemTablet> tablet;
+    create_tablet(sc, &tablet);
 
     uint64_t cur_version = 0;
     std::vector<TData> alldata(num_insert);
@@ -183,6 +190,95 @@ TEST(MemTablet, writescan) {
     }
 }
 
+// Collects rows written by MemTablet::flush()
+class TestRowsetWriter : public RowsetWriter {
+public:
+    OLAPStatus init(const RowsetWriterContext& rowset_writer_context) override {
+        return OLAP_SUCCESS;
+    }
+    OLAPStatus add_row(const RowCursor& row) override {
+        TData data;
+        data.id = *reinterpret_cast<const int32_t*>(row.cell_ptr(0));
+        data.uv = *reinterpret_cast<const int32_t*>(row.cell_ptr(1));
+        data.pv = *reinterpret_cast<const int32_t*>(row.cell_ptr(2));
+        data.city = row.is_null(3) ? -1 : *reinterpret_cast<const int8_t*>(row.cell_ptr(3));
+        rows.push_back(data);
+        return OLAP_SUCCESS;
+    }
+    OLAPStatus add_row(const ContiguousRow& row) override { return OLAP_ERR_FUNC_NOT_IMPLEMENTED; }
+    OLAPStatus add_rowset(RowsetSharedPtr rowset) override { return OLAP_ERR_FUNC_NOT_IMPLEMENTED; }
+    OLAPStatus add_rowset_for_linked_schema_change(RowsetSharedPtr rowset,
+                                                   const SchemaMapping& schema_mapping) override {
+        return OLAP_ERR_FUNC_NOT_IMPLEMENTED;
+    }
+    OLAPStatus flush() override {
+        ++num_flushes;
+        return OLAP_SUCCESS;
+    }
+    RowsetSharedPtr build() override { return nullptr; }
+    Version version() override { return Version(); }
+    int64_t num_rows() override { return rows.size(); }
+    RowsetId rowset_id() override { return RowsetId(); }
+    RowsetTypePB type() override { return BETA_ROWSET; }
+
+    std::vector<TData> rows;
+    int num_flushes = 0;
+};
+
+TEST(MemTablet, flush) {
+    scoped_refptr<Schema> sc;
+    ASSERT_TRUE(Schema::create("id int,uv int,pv int,city tinyint null", &sc).ok());
+    std::shared_ptr<MemTablet> tablet;
+    create_tablet(sc, &tablet);
+
+    // insert ids in descending order, then update some of them
+    const int num_rows = 1000;
+    for (int round = 0; round < 2; ++round) {
+        std::unique_ptr<WriteTxn> wtx;
+        ASSERT_TRUE(tablet->create_write_txn(&wtx).ok());
+        PartialRowWriter writer(wtx->get_schema_ptr());
+        ASSERT_TRUE(writer.start_batch(num_rows + 1, num_rows * 32).ok());
+        for (int i = num_rows - 1; i >= 0; i -= round + 1) {
+            int id = i;
+            int uv = i + round;
+            int pv = i * 2;
+            int8_t city = i % 100;
+            ASSERT_TRUE(writer.start_row().ok());
+            ASSERT_TRUE(writer.set("id", &id).ok());
+            ASSERT_TRUE(writer.set("uv", &uv).ok());
+            ASSERT_TRUE(writer.set("pv", &pv).ok());
+            ASSERT_TRUE(writer.set("city", i % 2 == 0 ? nullptr : &city).ok());
+            ASSERT_TRUE(writer.end_row().ok());
+        }
+        std::vector<uint8_t> wtxn_buff;
+        ASSERT_TRUE(writer.finish_batch(&wtxn_buff).ok());
+        ASSERT_TRUE(wtx->new_batch()->load(std::move(wtxn_buff)).ok());
+        ASSERT_TRUE(tablet->commit_write_txn(wtx.get(), round + 1).ok());
+    }
+
+    // version 1 only has the inserted rows
+    TestRowsetWriter writer1;
+    ASSERT_TRUE(tablet->flush(1, &writer1).ok());
+    ASSERT_EQ(1, writer1.num_flushes);
+    ASSERT_EQ((size_t)num_rows, writer1.rows.size());
+    for (int i = 0; i < num_rows; ++i) {
+        ASSERT_EQ(i, writer1.rows[i].id);
+        ASSERT_EQ(i, writer1.rows[i].uv);
+    }
+
+    // version 2 sees the updates
+    TestRowsetWriter writer2;
+    ASSERT_TRUE(tablet->flush(2, &writer2).ok());
+    ASSERT_EQ((size_t)num_rows, writer2.rows.size());
+    for (int i = 0; i < num_rows; ++i) {
+        const TData& row = writer2.rows[i];
+        ASSERT_EQ(i, row.id);
+        ASSERT_EQ((num_rows - 1 - i) % 2 == 0 ? i + 1 : i, row.uv);
+        ASSERT_EQ(i * 2, row.pv);
+        ASSERT_EQ(i % 2 == 0 ? -1 : i % 100, row.city);
+    }
+}
+
 } // namespace memory
 } // namespace doris
 
@@ -0,0 +1,200 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "olap/memtable.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <tuple>
+#include <vector>
+
+#include "common/config.h"
+#include "olap/row.h"
+#include "olap/schema.h"
+#include "olap/tablet_schema.h"
+#include "olap/tablet_schema_helper.h"
+#include "runtime/descriptor_helper.h"
+#include "runtime/descriptors.h"
+#include "runtime/mem_pool.h"
+#include "runtime/mem_tracker.h"
+#include "runtime/tuple.h"
+
+namespace doris {
+
+// (k1, k2, v), a null k1 is std::numeric_limits<int64_t>::min()
+using Row = std::tuple<int64_t, int32_t, int32_t>;
+using Rows = std::vector<Row>;
+
+static const int64_t kNullKey = std::numeric_limits<int64_t>::min();
+
+class MemTableTest : public testing::Test {
+protected:
+    void SetUp() override { _sort_on_flush = config::memtable_sort_on_flush; }
+
+    void TearDown() override { config::memtable_sort_on_flush = _sort_on_flush; }
+
+    // Insert `rows` into a memtable of (k1 int null, k2 int, v int) with key (k1, k2) and
+    // return the rows it writes on flush
+    Rows flush(KeysType keys_type, bool sort_on_flush, const Rows& rows) {
+        FieldAggregationMethod agg_method = OLAP_FIELD_AGGREGATION_NONE;
+        if (keys_type == AGG_KEYS) {
+            agg_method = OLAP_FIELD_AGGREGATION_SUM;
+        } else if (keys_type == UNIQUE_KEYS) {
+            agg_method = OLAP_FIELD_AGGREGATION_REPLACE;
+        }
+        TabletSchema tablet_schema;
+        tablet_schema._keys_type = keys_type;
+        tablet_schema._cols.push_back(create_int_key(0, true));
+        tablet_schema._cols.push_back(create_int_key(1, false));
+        tablet_schema._cols.push_back(create_int_value(2, agg_method, false));
+        tablet_schema._num_columns = 3;
+        tablet_schema._num_key_columns = 2;
+        tablet_schema._num_short_key_columns = 2;
+        Schema schema(tablet_schema);
+
+        TDescriptorTableBuilder dtb;
+        TTupleDescriptorBuilder tuple_builder;
+        tuple_builder.add_slot(
+                TSlotDescriptorBuilder().type(TYPE_INT).column_name("k1").column_pos(0).build());
+        tuple_builder.add_slot(TSlotDescriptorBuilder()
+                                       .type(TYPE_INT)
+                                       .nullable(false)
+                                       .column_name("k2")
+                                       .column_pos(1)
+                                       .build());
+        tuple_builder.add_slot(TSlotDescriptorBuilder()
+                                       .type(TYPE_INT)
+                                       .nullable(false)
+                                       .column_name("v")
+                                       .column_pos(2)
+                                       .build());
+        tuple_builder.build(&dtb);
+        ObjectPool obj_pool;
+        DescriptorTbl* desc_tbl = nullptr;
+        DescriptorTbl::create(&obj_pool, dtb.desc_tbl(), &desc_tbl);
+        TupleDescriptor* tuple_desc = desc_tbl->get_tuple_descriptor(0);
+        const std::vector<SlotDescriptor*>& slots = tuple_desc->slots();
+
+        config::memtable_sort_on_flush = sort_on_flush;
+        std::shared_ptr<MemTracker> tracker(new MemTracker(-1, "memtable test"));
+        MemTable memtable(10001, &schema, &tablet_schema, &slots, tuple_desc, keys_type,
+                          nullptr, tracker);
+        MemPool pool(tracker.get());
+        for (auto& row : rows) {
+            Tuple* tuple = reinterpret_cast<Tuple*>(pool.allocate(tuple_desc->byte_size()));
+            memset(tuple, 0, tuple_desc->byte_size());
+            if (std::get<0>(row) == kNullKey) {
+                tuple->set_null(slots[0]->null_indicator_offset());
+            } else {
+                *(int32_t*)tuple->get_slot(slots[0]->tuple_offset()) = std::get<0>(row);
+            }
+            *(int32_t*)tuple->get_slot(slots[1]->tuple_offset()) = std::get<1>(row);
+            *(int32_t*)tuple->get_slot(slots[2]->tuple_offset()) = std::get<2>(row);
+            memtable.insert(tuple);
+        }
+
+        Rows flushed;
+        auto add_row = [&flushed](const ContiguousRow& row) {
+            auto k1 = row.cell(0);
+            flushed.emplace_back(k1.is_null() ? kNullKey : *(const int32_t*)k1.cell_ptr(),
+                                 *(const int32_t*)row.cell(1).cell_ptr(),
+                                 *(const int32_t*)row.cell(2).cell_ptr());
+            return OLAP_SUCCESS;
+        };
+        EXPECT_EQ(OLAP_SUCCESS, memtable.write_rows(add_row));
+        return flushed;
+    }
+
+    // `num_rows` rows with many equal keys, negative and null k1 included
+    static Rows random_rows(size_t num_rows) {
+        std::mt19937 rng(20261015);
+        Rows rows;
+        for (size_t i = 0; i < num_rows; ++i) {
+            int64_t k1 = static_cast<int64_t>(rng() % 201) - 100;
+            if (rng() % 50 == 0) {
+                k1 = kNullKey;
+            }
+            rows.emplace_back(k1, rng() % 4, rng() % 1000);
+        }
+        return rows;
+    }
+
+    bool _sort_on_flush = false;
+};
+
+TEST_F(MemTableTest, sort_on_flush_as_skiplist) {
+    // fewer and more rows than those radix sorted
+    for (size_t num_rows : {100, 5000}) {
+        Rows rows = random_rows(num_rows);
+        for (KeysType keys_type : {DUP_KEYS, UNIQUE_KEYS, AGG_KEYS}) {
+            Rows expected = flush(keys_type, false, rows);
+            Rows actual = flush(keys_type, true, rows);
+            ASSERT_EQ(expected, actual) << "keys_type=" << keys_type << " rows=" << num_rows;
+            ASSERT_TRUE(std::is_sorted(actual.begin(), actual.end(),
+                                       [](const Row& lhs, const Row& rhs) {
+                                           return std::make_pair(std::get<0>(lhs),
+                                                                 std::get<1>(lhs)) <
+                                                  std::make_pair(std::get<0>(rhs),
+                                                                 std::get<1>(rhs));
+                                       }));
+            if (keys_type == DUP_KEYS) {
+                ASSERT_EQ(num_rows, actual.size());
+            }
+        }
+    }
+}
+
+TEST_F(MemTableTest, sort_on_flush_keeps_insertion_order) {
+    // the keys of the rows with equal prefixes of k1 are sorted by k2, and the rows with
+    // equal keys keep the order they are inserted in
+    Rows rows;
+    for (int32_t v = 0; v < 300; ++v) {
+        rows.emplace_back(1 - v % 3, v % 2, v);
+    }
+    Rows dup_rows = flush(DUP_KEYS, true, rows);
+    ASSERT_EQ(300, dup_rows.size());
+    for (size_t i = 1; i < dup_rows.size(); ++i) {
+        if (std::get<0>(dup_rows[i]) == std::get<0>(dup_rows[i - 1]) &&
+            std::get<1>(dup_rows[i]) == std::get<1>(dup_rows[i - 1])) {
+            ASSERT_LT(std::get<2>(dup_rows[i - 1]), std::get<2>(dup_rows[i]));
+        }
+    }
+    // REPLACE keeps the value of the last row of a key
+    ASSERT_EQ(Rows({Row(-1, 0, 296), Row(-1, 1, 299), Row(0, 0, 298), Row(0, 1, 295),
+                    Row(1, 0, 294), Row(1, 1, 297)}),
+              flush(UNIQUE_KEYS, true, rows));
+}
+
+TEST_F(MemTableTest, sort_on_flush_sorted_input) {
+    Rows rows = {Row(kNullKey, 0, 1), Row(kNullKey, 0, 2), Row(-5, 1, 3), Row(0, 0, 4),
+                 Row(0, 0, 5),        Row(7, 2, 6)};
+    ASSERT_EQ(rows, flush(DUP_KEYS, true, rows));
+    ASSERT_EQ(Rows({Row(kNullKey, 0, 3), Row(-5, 1, 3), Row(0, 0, 9), Row(7, 2, 6)}),
+              flush(AGG_KEYS, true, rows));
+}
+
+} // namespace doris
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -22,6 +22,8 @@
 #include <boost/filesystem.hpp>
 #include <sstream>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "olap/olap_define.h"
 #include "util/file_utils.h"
@@ -118,6 +120,52 @@ TEST_F(OlapMetaTest, TestIterate) {
     ASSERT_EQ(OLAP_SUCCESS, s);
 }
 
+TEST_F(OlapMetaTest, TestWriteBatch) {
+    OLAPStatus s = _meta->put(META_COLUMN_FAMILY_INDEX, "key_0", "value_0");
+    ASSERT_EQ(OLAP_SUCCESS, s);
+    std::vector<OlapMeta::WriteOp> ops;
+    ops.push_back({META_COLUMN_FAMILY_INDEX, "key_0", "", true});
+    ops.push_back({META_COLUMN_FAMILY_INDEX, "key_1", "value_1", false});
+    ops.push_back({META_COLUMN_FAMILY_INDEX, "key_2", "value_2", false});
+    s = _meta->write_batch(ops);
+    ASSERT_EQ(OLAP_SUCCESS, s);
+
+    std::string value_get;
+    s = _meta->get(META_COLUMN_FAMILY_INDEX, "key_0", &value_get);
+    ASSERT_EQ(OLAP_ERR_META_KEY_NOT_FOUND, s);
+    s = _meta->get(META_COLUMN_FAMILY_INDEX, "key_1", &value_get);
+    ASSERT_EQ(OLAP_SUCCESS, s);
+    ASSERT_EQ("value_1", value_get);
+    s = _meta->get(META_COLUMN_FAMILY_INDEX, "key_2", &value_get);
+    ASSERT_EQ(OLAP_SUCCESS, s);
+    ASSERT_EQ("value_2", value_get);
+}
+
+TEST_F(OlapMetaTest, TestConcurrentPut) {
+    const int num_threads = 8;
+    const int num_keys = 100;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; ++t) {
+        threads.emplace_back([this, t]() {
+            for (int i = 0; i < num_keys; ++i) {
+                std::string key = "key_" + std::to_string(t) + "_" + std::to_string(i);
+                ASSERT_EQ(OLAP_SUCCESS, _meta->put(META_COLUMN_FAMILY_INDEX, key, key));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (int t = 0; t < num_threads; ++t) {
+        for (int i = 0; i < num_keys; ++i) {
+            std::string key = "key_" + std::to_string(t) + "_" + std::to_string(i);
+            std::string value_get;
+            ASSERT_EQ(OLAP_SUCCESS, _meta->get(META_COLUMN_FAMILY_INDEX, key, &value_get));
+            ASSERT_EQ(key, value_get);
+        }
+    }
+}
+
 } // namespace doris
 
 int main(int argc, char** argv) {
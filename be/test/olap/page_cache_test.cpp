@@ -19,6 +19,8 @@
 
 #include <gtest/gtest.h>
 
+#include "common/config.h"
+
 namespace doris {
 
 class StoragePageCacheTest : public testing::Test {
@@ -28,21 +30,21 @@ public:
 };
 
 TEST(StoragePageCacheTest, normal) {
-    StoragePageCache cache(kNumShards * 2048);
+    StoragePageCache cache(kNumShards * 2048, 0);
 
-    StoragePageCache::CacheKey key("abc", 0);
-    StoragePageCache::CacheKey memory_key("mem", 0);
+    StoragePageCache::CacheKey key(cache.file_id("abc"), 0);
+    StoragePageCache::CacheKey memory_key(cache.file_id("mem"), 0);
 
     {
         // insert normal page
         char* buf = new char[1024];
         PageCacheHandle handle;
         Slice data(buf, 1024);
-        cache.insert(key, data, &handle, false);
+        cache.insert(key, data, &handle, segment_v2::DATA_PAGE, false);
 
         ASSERT_EQ(handle.data().data, buf);
 
-        auto found = cache.lookup(key, &handle);
+        auto found = cache.lookup(key, &handle, segment_v2::DATA_PAGE);
         ASSERT_TRUE(found);
         ASSERT_EQ(buf, handle.data().data);
     }
@@ -52,38 +54,85 @@ TEST(StoragePageCacheTest, normal) {
         char* buf = new char[1024];
         PageCacheHandle handle;
         Slice data(buf, 1024);
-        cache.insert(memory_key, data, &handle, true);
+        cache.insert(memory_key, data, &handle, segment_v2::DATA_PAGE, true);
 
         ASSERT_EQ(handle.data().data, buf);
 
-        auto found = cache.lookup(memory_key, &handle);
+        auto found = cache.lookup(memory_key, &handle, segment_v2::DATA_PAGE);
         ASSERT_TRUE(found);
     }
 
     // put too many page to eliminate first page
     for (int i = 0; i < 10 * kNumShards; ++i) {
-        StoragePageCache::CacheKey key("bcd", i);
+        StoragePageCache::CacheKey key(cache.file_id("bcd"), i);
         PageCacheHandle handle;
         Slice data(new char[1024], 1024);
-        cache.insert(key, data, &handle, false);
+        cache.insert(key, data, &handle, segment_v2::DATA_PAGE, false);
     }
 
     // cache miss
     {
         PageCacheHandle handle;
-        StoragePageCache::CacheKey miss_key("abc", 1);
-        auto found = cache.lookup(miss_key, &handle);
+        StoragePageCache::CacheKey miss_key(cache.file_id("abc"), 1);
+        auto found = cache.lookup(miss_key, &handle, segment_v2::DATA_PAGE);
         ASSERT_FALSE(found);
     }
 
     // cache miss for eliminated key
     {
         PageCacheHandle handle;
-        auto found = cache.lookup(key, &handle);
+        auto found = cache.lookup(key, &handle, segment_v2::DATA_PAGE);
         ASSERT_FALSE(found);
     }
 }
 
+TEST(StoragePageCacheTest, file_id) {
+    StoragePageCache cache(kNumShards * 2048, 10);
+
+    uint64_t id = cache.file_id("abc");
+    ASSERT_NE(0, id);
+    ASSERT_EQ(id, cache.file_id("abc"));
+    ASSERT_NE(id, cache.file_id("abcd"));
+}
+
+TEST(StoragePageCacheTest, index_and_data_pages) {
+    StoragePageCache cache(kNumShards * 2048 * 2, 50);
+
+    StoragePageCache::CacheKey index_key(cache.file_id("abc"), 0);
+    {
+        PageCacheHandle handle;
+        Slice data(new char[1024], 1024);
+        cache.insert(index_key, data, &handle, segment_v2::INDEX_PAGE, false);
+    }
+    // data pages don't evict index pages
+    for (int i = 0; i < 10 * kNumShards; ++i) {
+        StoragePageCache::CacheKey key(cache.file_id("bcd"), i);
+        PageCacheHandle handle;
+        Slice data(new char[1024], 1024);
+        cache.insert(key, data, &handle, segment_v2::DATA_PAGE, false);
+    }
+    PageCacheHandle handle;
+    ASSERT_TRUE(cache.lookup(index_key, &handle, segment_v2::INDEX_PAGE));
+    ASSERT_FALSE(cache.lookup(index_key, &handle, segment_v2::DATA_PAGE));
+}
+
+TEST(StoragePageCacheTest, admission) {
+    StoragePageCache cache(kNumShards * 2048, 10);
+    StoragePageCache::CacheKey key(cache.file_id("abc"), 0);
+
+    config::storage_page_cache_admit_on_second_access = true;
+    ASSERT_TRUE(cache.admit(key, segment_v2::INDEX_PAGE, false));
+    ASSERT_TRUE(cache.admit(key, segment_v2::DATA_PAGE, true));
+    // data page is admitted on the second access
+    ASSERT_FALSE(cache.admit(key, segment_v2::DATA_PAGE, false));
+    ASSERT_TRUE(cache.admit(key, segment_v2::DATA_PAGE, false));
+    ASSERT_FALSE(cache.admit(key, segment_v2::DATA_PAGE, false));
+
+    config::storage_page_cache_admit_on_second_access = false;
+    StoragePageCache::CacheKey other_key(cache.file_id("abc"), 1);
+    ASSERT_TRUE(cache.admit(other_key, segment_v2::DATA_PAGE, false));
+}
+
 } // namespace doris
 
 int main(int argc, char** argv) {
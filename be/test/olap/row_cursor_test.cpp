@@ -567,6 +567,109 @@ TEST_F(TestRowCursor, AggregateWithNull) {
     ASSERT_TRUE(is_null_varchar);
 }
 
+TEST_F(TestRowCursor, AggregateIfNotNull) {
+    TabletSchema tablet_schema;
+    set_tablet_schema_for_cmp_and_aggregate(&tablet_schema);
+
+    RowCursor row;
+    OLAPStatus res = row.init(tablet_schema);
+    ASSERT_EQ(res, OLAP_SUCCESS);
+    row.allocate_memory_for_string_type(tablet_schema);
+
+    RowCursor left;
+    res = left.init(tablet_schema);
+    Slice l_char("well");
+    int32_t l_int = 10;
+    int128_t l_largeint = (int128_t)(1) << 100;
+    double l_double = 8.8;
+    decimal12_t l_decimal(11, 22);
+    Slice l_varchar("beijing");
+    left.set_field_content(0, reinterpret_cast<char*>(&l_char), _mem_pool.get());
+    left.set_field_content(1, reinterpret_cast<char*>(&l_int), _mem_pool.get());
+    left.set_field_content(2, reinterpret_cast<char*>(&l_largeint), _mem_pool.get());
+    left.set_field_content(3, reinterpret_cast<char*>(&l_double), _mem_pool.get());
+    left.set_field_content(4, reinterpret_cast<char*>(&l_decimal), _mem_pool.get());
+    left.set_field_content(5, reinterpret_cast<char*>(&l_varchar), _mem_pool.get());
+
+    std::shared_ptr<MemTracker> tracker(new MemTracker(-1));
+    std::unique_ptr<MemPool> mem_pool(new MemPool(tracker.get()));
+    ObjectPool agg_object_pool;
+    init_row_with_others(&row, left, mem_pool.get(), &agg_object_pool);
+
+    // a row of partial columns, only the double column is loaded
+    RowCursor right;
+    res = right.init(tablet_schema);
+    Slice r_char("well");
+    int32_t r_int = 10;
+    double r_double = 5.5;
+    right.set_field_content(0, reinterpret_cast<char*>(&r_char), _mem_pool.get());
+    right.set_field_content(1, reinterpret_cast<char*>(&r_int), _mem_pool.get());
+    right.set_null(2);
+    right.set_field_content(3, reinterpret_cast<char*>(&r_double), _mem_pool.get());
+    right.set_null(4);
+    right.set_null(5);
+
+    agg_update_row_if_not_null(&row, right, mem_pool.get());
+
+    int128_t agg_value = *reinterpret_cast<int128_t*>(row.cell_ptr(2));
+    ASSERT_TRUE(agg_value == l_largeint);
+    double agg_double = *reinterpret_cast<double*>(row.cell_ptr(3));
+    ASSERT_TRUE(agg_double == r_double);
+    decimal12_t agg_decimal = *reinterpret_cast<decimal12_t*>(row.cell_ptr(4));
+    ASSERT_TRUE(agg_decimal == l_decimal);
+    Slice* agg_varchar = reinterpret_cast<Slice*>(row.cell_ptr(5));
+    ASSERT_EQ(agg_varchar->compare(l_varchar), 0);
+}
+
+TEST_F(TestRowCursor, FillNullCells) {
+    TabletSchema tablet_schema;
+    set_tablet_schema_for_cmp_and_aggregate(&tablet_schema);
+
+    RowCursor row;
+    OLAPStatus res = row.init(tablet_schema);
+    ASSERT_EQ(res, OLAP_SUCCESS);
+    row.allocate_memory_for_string_type(tablet_schema);
+
+    // the newer row of partial columns, only the largeint and varchar columns are loaded
+    RowCursor newer;
+    res = newer.init(tablet_schema);
+    Slice n_char("well");
+    int32_t n_int = 10;
+    int128_t n_largeint = 7;
+    Slice n_varchar("beijing");
+    newer.set_field_content(0, reinterpret_cast<char*>(&n_char), _mem_pool.get());
+    newer.set_field_content(1, reinterpret_cast<char*>(&n_int), _mem_pool.get());
+    newer.set_field_content(2, reinterpret_cast<char*>(&n_largeint), _mem_pool.get());
+    newer.set_null(3);
+    newer.set_null(4);
+    newer.set_field_content(5, reinterpret_cast<char*>(&n_varchar), _mem_pool.get());
+    direct_copy_row(&row, newer);
+
+    RowCursor older;
+    res = older.init(tablet_schema);
+    int128_t o_largeint = 8;
+    double o_double = 5.5;
+    Slice o_varchar("shenzhen");
+    older.set_field_content(0, reinterpret_cast<char*>(&n_char), _mem_pool.get());
+    older.set_field_content(1, reinterpret_cast<char*>(&n_int), _mem_pool.get());
+    older.set_field_content(2, reinterpret_cast<char*>(&o_largeint), _mem_pool.get());
+    older.set_field_content(3, reinterpret_cast<char*>(&o_double), _mem_pool.get());
+    older.set_null(4);
+    older.set_field_content(5, reinterpret_cast<char*>(&o_varchar), _mem_pool.get());
+
+    std::vector<uint32_t> value_cids = {2, 3, 4, 5};
+    fill_null_cells(value_cids, &row, older);
+
+    int128_t largeint = *reinterpret_cast<int128_t*>(row.cell_ptr(2));
+    ASSERT_TRUE(largeint == n_largeint);
+    ASSERT_FALSE(row.is_null(3));
+    double double_value = *reinterpret_cast<double*>(row.cell_ptr(3));
+    ASSERT_TRUE(double_value == o_double);
+    ASSERT_TRUE(row.is_null(4));
+    Slice* varchar = reinterpret_cast<Slice*>(row.cell_ptr(5));
+    ASSERT_EQ(varchar->compare(n_varchar), 0);
+}
+
 } // namespace doris
 
 int main(int argc, char** argv) {
@@ -0,0 +1,150 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/row_merge_funcs.h"
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "olap/row.h"
+#include "olap/row_cursor.h"
+#include "olap/tablet_schema.h"
+
+namespace doris {
+
+class RowMergeFuncsTest : public testing::Test {
+public:
+    RowMergeFuncsTest() {
+        TabletSchemaPB schema_pb;
+        add_column(&schema_pb, "INT", true, "", 4);
+        add_column(&schema_pb, "VARCHAR", true, "", 16);
+        add_column(&schema_pb, "DATE", true, "", 3);
+        add_column(&schema_pb, "BIGINT", false, "SUM", 8);
+        add_column(&schema_pb, "INT", false, "MIN", 4);
+        add_column(&schema_pb, "DOUBLE", false, "MAX", 8);
+        add_column(&schema_pb, "LARGEINT", false, "SUM", 16);
+        add_column(&schema_pb, "DECIMAL", false, "REPLACE", 12);
+        add_column(&schema_pb, "SMALLINT", false, "REPLACE_IF_NOT_NULL", 2);
+        // a MIN of decimal is done by its Field
+        add_column(&schema_pb, "DECIMAL", false, "MIN", 12);
+        _tablet_schema.init_from_pb(schema_pb);
+        _key_cids = {2, 1, 0};
+        _value_cids = {3, 4, 5, 6, 7, 8, 9};
+        _funcs.init(_tablet_schema, _key_cids, _value_cids);
+    }
+
+    void add_column(TabletSchemaPB* schema_pb, const std::string& type, bool is_key,
+                    const std::string& aggregation, int32_t length) {
+        ColumnPB* column = schema_pb->add_column();
+        column->set_unique_id(schema_pb->column_size());
+        column->set_name("c" + std::to_string(schema_pb->column_size()));
+        column->set_type(type);
+        column->set_is_key(is_key);
+        column->set_is_nullable(true);
+        column->set_length(length);
+        if (!is_key) {
+            column->set_aggregation(aggregation);
+        }
+        if (type == "DECIMAL") {
+            column->set_precision(27);
+            column->set_frac(9);
+        }
+    }
+
+    // Random values of a few distinct ones, so the keys of rows are often equal
+    void random_row(RowCursor* row) {
+        static const char* kStrings[] = {"a", "ab", "b"};
+        for (uint32_t cid = 0; cid < _tablet_schema.num_columns(); ++cid) {
+            auto cell = row->cell(cid);
+            cell.set_is_null(_rng() % 4 == 0);
+            int64_t value = _rng() % 3 - 1;
+            char* ptr = (char*)cell.mutable_cell_ptr();
+            switch (_tablet_schema.column(cid).type()) {
+            case OLAP_FIELD_TYPE_VARCHAR: {
+                const char* str = kStrings[_rng() % 3];
+                *(Slice*)ptr = Slice(str, strlen(str));
+                break;
+            }
+            case OLAP_FIELD_TYPE_DOUBLE:
+                *(double*)ptr = value * 0.5;
+                break;
+            case OLAP_FIELD_TYPE_DECIMAL:
+                *(decimal12_t*)ptr = decimal12_t(value, (int32_t)(_rng() % 3));
+                break;
+            default:
+                size_t size = row->schema()->column(cid)->size();
+                memset(ptr, value < 0 ? 0xff : 0, size);
+                memcpy(ptr, &value, std::min(sizeof(value), size));
+                break;
+            }
+        }
+    }
+
+protected:
+    TabletSchema _tablet_schema;
+    std::vector<uint32_t> _key_cids;
+    std::vector<uint32_t> _value_cids;
+    RowMergeFuncs _funcs;
+    std::mt19937 _rng {1};
+};
+
+TEST_F(RowMergeFuncsTest, SameAsFields) {
+    RowCursor lhs;
+    RowCursor rhs;
+    RowCursor expected;
+    ASSERT_EQ(OLAP_SUCCESS, lhs.init(_tablet_schema));
+    ASSERT_EQ(OLAP_SUCCESS, rhs.init(_tablet_schema));
+    ASSERT_EQ(OLAP_SUCCESS, expected.init(_tablet_schema));
+    int num_equal = 0;
+    for (int i = 0; i < 10000; ++i) {
+        random_row(&lhs);
+        random_row(&rhs);
+        bool equal = equal_row(_key_cids, lhs, rhs);
+        ASSERT_EQ(equal, _funcs.equal(lhs, rhs)) << i;
+        num_equal += equal;
+
+        for (uint32_t cid : _value_cids) {
+            auto dst_cell = expected.cell(cid);
+            auto src_cell = lhs.cell(cid);
+            dst_cell.set_is_null(src_cell.is_null());
+            memcpy(dst_cell.mutable_cell_ptr(), src_cell.cell_ptr(),
+                   lhs.schema()->column(cid)->size());
+        }
+        agg_update_row(_value_cids, &expected, rhs);
+        _funcs.agg_update(&lhs, rhs);
+        for (uint32_t cid : _value_cids) {
+            ASSERT_EQ(expected.cell(cid).is_null(), lhs.cell(cid).is_null()) << i;
+            if (!lhs.cell(cid).is_null()) {
+                ASSERT_TRUE(lhs.schema()->column(cid)->equal(expected.cell(cid), lhs.cell(cid)))
+                        << i << " " << cid;
+            }
+        }
+    }
+    // both of the equal and the unequal keys are checked
+    ASSERT_GT(num_equal, 0);
+    ASSERT_LT(num_equal, 10000);
+}
+
+} // namespace doris
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
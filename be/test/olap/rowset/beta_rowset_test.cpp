@@ -348,12 +348,36 @@ TEST_F(BetaRowsetTest, BasicFunctionTest) {
             delete predicate;
         }
     }
+    { // test split range by short key index
+        RowCursor start_key;
+        ASSERT_EQ(OLAP_SUCCESS, start_key.init(tablet_schema, 2));
+        start_key.allocate_memory_for_string_type(tablet_schema);
+        start_key.build_min_key();
+        RowCursor end_key;
+        ASSERT_EQ(OLAP_SUCCESS, end_key.init(tablet_schema, 2));
+        end_key.allocate_memory_for_string_type(tablet_schema);
+        end_key.build_max_key();
+
+        // every segment has 4 row blocks, split at the 2nd, 3rd and 4th of them
+        std::vector<OlapTuple> ranges;
+        s = rowset->split_range(start_key, end_key, 1024, &ranges);
+        ASSERT_EQ(OLAP_SUCCESS, s);
+        ASSERT_EQ(8, ranges.size());
+        ASSERT_EQ(start_key.to_tuple().get_value(0), ranges[0].get_value(0));
+        ASSERT_EQ(end_key.to_tuple().get_value(0), ranges[7].get_value(0));
+        for (int i = 1; i < 7; i += 2) {
+            uint32_t k1 = 1024 * 10 * (i / 2 + 1);
+            ASSERT_EQ(std::to_string(k1), ranges[i].get_value(0));
+            ASSERT_EQ(std::to_string(k1 * 10), ranges[i].get_value(1));
+            ASSERT_EQ(ranges[i].get_value(0), ranges[i + 1].get_value(0));
+        }
+    }
 }
 
 } // namespace doris
 
 int main(int argc, char** argv) {
-    doris::StoragePageCache::create_global_cache(1 << 30);
+    doris::StoragePageCache::create_global_cache(1 << 30, 10);
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
 }
@@ -212,6 +212,62 @@ TEST_F(BinaryDictPageTest, TestBySmallDataSize) {
     test_by_small_data_size(slices);
 }
 
+TEST_F(BinaryDictPageTest, TestDictCodes) {
+    std::vector<Slice> slices;
+    slices.emplace_back("apple");
+    slices.emplace_back("banana");
+    slices.emplace_back("apple");
+    slices.emplace_back("cherry");
+    slices.emplace_back("banana");
+
+    PageBuilderOptions options;
+    options.data_page_size = 256 * 1024;
+    options.dict_page_size = 256 * 1024;
+    BinaryDictPageBuilder page_builder(options);
+    size_t count = slices.size();
+    ASSERT_TRUE(page_builder.add(reinterpret_cast<const uint8_t*>(&slices[0]), &count).ok());
+    OwnedSlice s = page_builder.finish();
+
+    OwnedSlice dict_slice;
+    ASSERT_TRUE(page_builder.get_dictionary_page(&dict_slice).ok());
+    PageDecoderOptions dict_decoder_options;
+    BinaryPlainPageDecoder dict_page_decoder(dict_slice.slice(), dict_decoder_options);
+    ASSERT_TRUE(dict_page_decoder.init().ok());
+    ASSERT_EQ(3, dict_page_decoder.count());
+    std::vector<Slice> dict_words;
+    for (size_t i = 0; i < dict_page_decoder.count(); ++i) {
+        dict_words.push_back(dict_page_decoder.string_at_index(i));
+    }
+
+    PageDecoderOptions decoder_options;
+    BinaryDictPageDecoder page_decoder(s.slice(), decoder_options);
+    page_decoder.set_dict_decoder(&dict_page_decoder, dict_words.data(), 1);
+    ASSERT_TRUE(page_decoder.init().ok());
+
+    auto tracker = std::make_shared<MemTracker>();
+    MemPool pool(tracker.get());
+    TypeInfo* type_info = get_scalar_type_info(OLAP_FIELD_TYPE_VARCHAR);
+    size_t size = slices.size();
+    std::unique_ptr<ColumnVectorBatch> cvb;
+    ColumnVectorBatch::create(size, false, type_info, nullptr, &cvb);
+    ColumnBlock column_block(cvb.get(), &pool);
+    ColumnBlockView block_view(&column_block);
+    ASSERT_TRUE(page_decoder.next_batch(&size, &block_view).ok());
+    ASSERT_EQ(slices.size(), size);
+
+    ASSERT_EQ(1, cvb->dict_id());
+    ASSERT_EQ(dict_words.data(), cvb->dict_words());
+    ASSERT_EQ(3, cvb->dict_size());
+    Slice* values = reinterpret_cast<Slice*>(column_block.data());
+    for (size_t i = 0; i < size; ++i) {
+        ASSERT_EQ(slices[i], values[i]);
+        ASSERT_EQ(slices[i], cvb->dict_words()[cvb->dict_codes()[i]]);
+    }
+
+    cvb->reset_dict();
+    ASSERT_EQ(nullptr, cvb->dict_words());
+}
+
 TEST_F(BinaryDictPageTest, TestEncodingRatio) {
     std::vector<Slice> slices;
     std::vector<std::string> src_strings;
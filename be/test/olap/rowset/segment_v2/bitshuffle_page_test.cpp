@@ -302,6 +302,57 @@ TEST_F(BitShufflePageTest, TestBitShuffleInt32BlockEncoderMaxNumberSequence) {
             ints.get(), size);
 }
 
+TEST_F(BitShufflePageTest, TestBitShuffleInt64DecodeInBatches) {
+    const size_t size = 1001;
+    std::unique_ptr<int64_t[]> ints(new int64_t[size]);
+    for (int i = 0; i < size; i++) {
+        ints.get()[i] = random();
+    }
+    PageBuilderOptions options;
+    options.data_page_size = 256 * 1024;
+    segment_v2::BitshufflePageBuilder<OLAP_FIELD_TYPE_BIGINT> page_builder(options);
+    size_t num_added = size;
+    page_builder.add(reinterpret_cast<const uint8_t*>(ints.get()), &num_added);
+    OwnedSlice s = page_builder.finish();
+
+    auto tracker = std::make_shared<MemTracker>();
+    MemPool pool(tracker.get());
+    // capacity of the first block can't hold the padding, the second one can
+    for (size_t capacity : {size, size + 7}) {
+        for (size_t batch_size : {size_t(100), size}) {
+            segment_v2::PageDecoderOptions decoder_options;
+            segment_v2::BitShufflePageDecoder<OLAP_FIELD_TYPE_BIGINT> page_decoder(
+                    s.slice(), decoder_options);
+            ASSERT_TRUE(page_decoder.init().ok());
+
+            std::unique_ptr<ColumnVectorBatch> cvb;
+            ColumnVectorBatch::create(capacity, false,
+                                      get_scalar_type_info(OLAP_FIELD_TYPE_BIGINT), nullptr, &cvb);
+            ColumnBlock block(cvb.get(), &pool);
+            ColumnBlockView column_block_view(&block);
+            size_t num_read = 0;
+            while (num_read < size) {
+                size_t n = batch_size;
+                ASSERT_TRUE(page_decoder.next_batch(&n, &column_block_view).ok());
+                ASSERT_GT(n, 0);
+                column_block_view.advance(n);
+                num_read += n;
+            }
+            ASSERT_EQ(size, num_read);
+            const int64_t* values = reinterpret_cast<const int64_t*>(block.data());
+            for (int i = 0; i < size; i++) {
+                ASSERT_EQ(ints.get()[i], values[i]);
+            }
+
+            // seek back after the page is read at once
+            ASSERT_TRUE(page_decoder.seek_to_position_in_page(500).ok());
+            int64_t ret;
+            copy_one<OLAP_FIELD_TYPE_BIGINT>(&page_decoder, &ret);
+            ASSERT_EQ(ints.get()[500], ret);
+        }
+    }
+}
+
 TEST_F(BitShufflePageTest, TestBitShuffleFloatBlockEncoderSeekValue) {
     const uint32_t size = 1000;
     std::unique_ptr<float[]> floats(new float[size]);
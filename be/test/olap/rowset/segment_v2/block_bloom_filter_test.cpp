@@ -17,9 +17,12 @@
 
 #include <gtest/gtest.h>
 
+#include <cstring>
 #include <memory>
+#include <vector>
 
 #include "olap/rowset/segment_v2/bloom_filter.h"
+#include "util/cpu_info.h"
 
 namespace doris {
 namespace segment_v2 {
@@ -174,10 +177,87 @@ TEST_F(BlockBloomFilterTest, slice) {
     ASSERT_FALSE(bf->test_bytes(s.data, s.size));
 }
 
+// Test for the batch probe
+TEST_F(BlockBloomFilterTest, batch) {
+    std::unique_ptr<BloomFilter> bf;
+    auto st = BloomFilter::create(BLOCK_BLOOM_FILTER, &bf);
+    ASSERT_TRUE(st.ok());
+    st = bf->init(_expected_num, _fpp, HASH_MURMUR3_X64_64);
+    ASSERT_TRUE(st.ok());
+
+    int num = 1024;
+    std::vector<uint64_t> hashes;
+    for (int32_t i = 0; i < num * 2; ++i) {
+        hashes.push_back(bf->hash((char*)&i, sizeof(int32_t)));
+    }
+    for (int i = 0; i < num; ++i) {
+        bf->add_hash(hashes[i]);
+    }
+
+    std::unique_ptr<bool[]> results(new bool[hashes.size()]);
+    bf->test_hashes(hashes.data(), hashes.size(), results.get());
+    int false_count = 0;
+    for (int i = 0; i < num * 2; ++i) {
+        ASSERT_EQ(bf->test_hash(hashes[i]), results[i]);
+        if (i < num) {
+            ASSERT_TRUE(results[i]);
+        } else {
+            false_count += results[i];
+        }
+    }
+    ASSERT_LE((double)false_count / num, _fpp);
+
+    // the bits set by a hash are the same with or without SIMD, which keeps the
+    // bloom filters written before readable
+    bf->reset();
+    uint64_t hash = 0x0000000312345678;
+    bf->add_hash(hash);
+    const uint32_t salt[8] = {0x47b6137b, 0x44974d91, 0x8824ad5b, 0xa2b7289d,
+                              0x705495c7, 0x2df1424b, 0x9efc4947, 0x5c6bfb31};
+    uint32_t block_index = 3 & (bf->num_bytes() / 32 - 1);
+    const uint32_t* block = (const uint32_t*)(bf->data() + block_index * 32);
+    for (int i = 0; i < 8; ++i) {
+        ASSERT_EQ(1U << ((0x12345678U * salt[i]) >> 27), block[i]);
+    }
+}
+
+// The AVX2 and the default implementations, chosen by the CPU, set the same bits
+TEST_F(BlockBloomFilterTest, without_avx2) {
+    std::unique_ptr<BloomFilter> bf;
+    std::unique_ptr<BloomFilter> default_bf;
+    ASSERT_TRUE(BloomFilter::create(BLOCK_BLOOM_FILTER, &bf).ok());
+    ASSERT_TRUE(BloomFilter::create(BLOCK_BLOOM_FILTER, &default_bf).ok());
+    ASSERT_TRUE(bf->init(_expected_num, _fpp, HASH_MURMUR3_X64_64).ok());
+    ASSERT_TRUE(default_bf->init(_expected_num, _fpp, HASH_MURMUR3_X64_64).ok());
+
+    std::vector<uint64_t> hashes;
+    for (int32_t i = 0; i < 2048; ++i) {
+        hashes.push_back(bf->hash((char*)&i, sizeof(int32_t)));
+    }
+    for (int i = 0; i < 1024; ++i) {
+        bf->add_hash(hashes[i]);
+    }
+    std::vector<bool> results;
+    for (uint64_t hash : hashes) {
+        results.push_back(bf->test_hash(hash));
+    }
+
+    CpuInfo::TempDisable disable_avx2(CpuInfo::AVX2);
+    for (int i = 0; i < 1024; ++i) {
+        default_bf->add_hash(hashes[i]);
+    }
+    ASSERT_EQ(bf->size(), default_bf->size());
+    ASSERT_EQ(0, memcmp(bf->data(), default_bf->data(), bf->size()));
+    for (size_t i = 0; i < hashes.size(); ++i) {
+        ASSERT_EQ(results[i], default_bf->test_hash(hashes[i])) << i;
+    }
+}
+
 } // namespace segment_v2
 } // namespace doris
 
 int main(int argc, char** argv) {
+    doris::CpuInfo::init();
     testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
 }
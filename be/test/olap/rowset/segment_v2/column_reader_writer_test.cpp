@@ -27,6 +27,7 @@
 #include "olap/olap_common.h"
 #include "olap/rowset/segment_v2/column_reader.h"
 #include "olap/rowset/segment_v2/column_writer.h"
+#include "olap/rowset/segment_v2/decoded_page_cache.h"
 #include "olap/tablet_schema_helper.h"
 #include "olap/types.h"
 #include "runtime/mem_pool.h"
@@ -66,7 +67,7 @@ private:
 
 template <FieldType type, EncodingTypePB encoding>
 void test_nullable_data(uint8_t* src_data, uint8_t* src_is_null, int num_rows,
-                        std::string test_name) {
+                        std::string test_name, bool kept_in_memory = false) {
     using Type = typename TypeTraits<type>::CppType;
     Type* src = (Type*)src_data;
 
@@ -124,9 +125,12 @@ void test_nullable_data(uint8_t* src_data, uint8_t* src_is_null, int num_rows,
     {
         // read and check
         ColumnReaderOptions reader_opts;
+        reader_opts.kept_in_memory = kept_in_memory;
         std::unique_ptr<ColumnReader> reader;
         auto st = ColumnReader::create(reader_opts, meta, num_rows, fname, &reader);
         ASSERT_TRUE(st.ok());
+        ASSERT_EQ(kept_in_memory && DecodedPageCache::is_supported_type(type),
+                  reader->use_decoded_page_cache());
 
         ColumnIterator* iter = nullptr;
         st = reader->new_iterator(&iter);
@@ -570,6 +574,36 @@ TEST_F(ColumnReaderWriterTest, test_nullable) {
     delete[] double_vals;
 }
 
+TEST_F(ColumnReaderWriterTest, test_decoded_page_cache) {
+    size_t num_uint8_rows = 1024 * 1024;
+    uint8_t* is_null = new uint8_t[num_uint8_rows];
+    uint8_t* val = new uint8_t[num_uint8_rows];
+    for (int i = 0; i < num_uint8_rows; ++i) {
+        val[i] = i;
+        BitmapChange(is_null, i, (i % 4) == 0);
+    }
+
+    // pages decoded by the sequential read are read from the cache after seeks
+    test_nullable_data<OLAP_FIELD_TYPE_INT, BIT_SHUFFLE>(val, is_null, num_uint8_rows / 4,
+                                                         "decoded_int_bs", true);
+    test_nullable_data<OLAP_FIELD_TYPE_BIGINT, PLAIN_ENCODING>(val, is_null, num_uint8_rows / 8,
+                                                               "decoded_bigint_plain", true);
+    // string columns are not cached
+    Slice* slice_vals = new Slice[256];
+    char* raw = new char[256 * 8];
+    for (int i = 0; i < 256; ++i) {
+        snprintf(raw + i * 8, 8, "%d", i);
+        slice_vals[i] = Slice(raw + i * 8, strlen(raw + i * 8));
+    }
+    test_nullable_data<OLAP_FIELD_TYPE_VARCHAR, DICT_ENCODING>((uint8_t*)slice_vals, is_null, 256,
+                                                               "decoded_varchar_dict", true);
+
+    delete[] val;
+    delete[] is_null;
+    delete[] slice_vals;
+    delete[] raw;
+}
+
 TEST_F(ColumnReaderWriterTest, test_types) {
     size_t num_uint8_rows = 1024 * 1024;
     uint8_t* is_null = new uint8_t[num_uint8_rows];
@@ -672,7 +706,8 @@ TEST_F(ColumnReaderWriterTest, test_default_value) {
 } // namespace doris
 
 int main(int argc, char** argv) {
-    doris::StoragePageCache::create_global_cache(1 << 30);
+    doris::StoragePageCache::create_global_cache(1 << 30, 10);
+    doris::segment_v2::DecodedPageCache::create_global_cache(1 << 30);
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
 }
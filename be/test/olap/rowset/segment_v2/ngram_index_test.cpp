@@ -0,0 +1,133 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "olap/fs/block_manager.h"
+#include "olap/fs/fs_util.h"
+#include "olap/like_column_predicate.h"
+#include "olap/page_cache.h"
+#include "olap/rowset/segment_v2/ngram_index_reader.h"
+#include "olap/rowset/segment_v2/ngram_index_writer.h"
+#include "olap/types.h"
+#include "util/file_utils.h"
+
+namespace doris {
+namespace segment_v2 {
+
+class NGramIndexTest : public testing::Test {
+public:
+    const std::string kTestDir = "./ut_dir/ngram_index_test";
+
+    void SetUp() override {
+        if (FileUtils::check_exist(kTestDir)) {
+            ASSERT_TRUE(FileUtils::remove_all(kTestDir).ok());
+        }
+        ASSERT_TRUE(FileUtils::create_dir(kTestDir).ok());
+    }
+    void TearDown() override {
+        if (FileUtils::check_exist(kTestDir)) {
+            ASSERT_TRUE(FileUtils::remove_all(kTestDir).ok());
+        }
+    }
+};
+
+// rows: "hello world", null, "say hello", "world peace", "hi", "yellow"
+static void write_index_file(const std::string& file_name, ColumnIndexMetaPB* meta) {
+    std::unique_ptr<fs::WritableBlock> wblock;
+    fs::CreateBlockOptions opts({file_name});
+    ASSERT_TRUE(fs::fs_util::block_manager()->create_block(opts, &wblock).ok());
+
+    std::unique_ptr<NGramIndexWriter> writer;
+    ASSERT_TRUE(
+            NGramIndexWriter::create(get_type_info(OLAP_FIELD_TYPE_VARCHAR), 3, &writer).ok());
+    Slice values1[] = {Slice("hello world")};
+    writer->add_values(values1, 1);
+    writer->add_nulls(1);
+    Slice values2[] = {Slice("say hello"), Slice("world peace"), Slice("hi"), Slice("yellow")};
+    writer->add_values(values2, 4);
+    ASSERT_TRUE(writer->finish(wblock.get(), meta).ok());
+    ASSERT_EQ(NGRAM_INDEX, meta->type());
+    ASSERT_EQ(3, meta->ngram_index().gram_size());
+    ASSERT_TRUE(wblock->close().ok());
+}
+
+TEST_F(NGramIndexTest, test_filter_rows) {
+    std::string file_name = kTestDir + "/filter_rows";
+    ColumnIndexMetaPB meta;
+    write_index_file(file_name, &meta);
+
+    NGramIndexReader reader(file_name, &meta.ngram_index());
+    ASSERT_TRUE(reader.load(true, false).ok());
+    NGramIndexIterator* iter = nullptr;
+    ASSERT_TRUE(reader.new_iterator(&iter).ok());
+    std::unique_ptr<NGramIndexIterator> iter_holder(iter);
+
+    {
+        Roaring rows;
+        rows.addRange(0, 6);
+        ASSERT_TRUE(iter->filter_rows_containing(Slice("hello"), &rows).ok());
+        ASSERT_TRUE(Roaring::bitmapOf(2, 0, 2) == rows);
+    }
+    {
+        // "ello" is in "yellow" too
+        Roaring rows;
+        rows.addRange(0, 6);
+        ASSERT_TRUE(iter->filter_rows_containing(Slice("ello"), &rows).ok());
+        ASSERT_TRUE(Roaring::bitmapOf(3, 0, 2, 5) == rows);
+    }
+    {
+        Roaring rows;
+        rows.addRange(0, 6);
+        ASSERT_TRUE(iter->filter_rows_containing(Slice("xyz"), &rows).ok());
+        ASSERT_TRUE(rows.isEmpty());
+    }
+    {
+        // shorter than a gram, nothing is removed
+        Roaring rows;
+        rows.addRange(0, 6);
+        ASSERT_TRUE(iter->filter_rows_containing(Slice("hi"), &rows).ok());
+        ASSERT_EQ(6, rows.cardinality());
+    }
+    {
+        // all the grams "wor", "orl" and "rld" are only in rows 0 and 3
+        LikeColumnPredicate pred(0, "%world%", false);
+        Roaring rows;
+        rows.addRange(0, 6);
+        ASSERT_TRUE(pred.evaluate_ngram_index(iter, &rows).ok());
+        ASSERT_TRUE(Roaring::bitmapOf(2, 0, 3) == rows);
+    }
+    {
+        LikeColumnPredicate pred(0, "hello%peace", false);
+        Roaring rows;
+        rows.addRange(0, 6);
+        ASSERT_TRUE(pred.evaluate_ngram_index(iter, &rows).ok());
+        ASSERT_TRUE(rows.isEmpty());
+    }
+}
+
+} // namespace segment_v2
+} // namespace doris
+
+int main(int argc, char** argv) {
+    doris::StoragePageCache::create_global_cache(1 << 30, 10);
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
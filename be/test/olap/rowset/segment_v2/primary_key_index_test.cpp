@@ -0,0 +1,124 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+#include "olap/rowset/segment_v2/primary_key_index.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+
+#include "olap/fs/block_manager.h"
+#include "olap/fs/fs_util.h"
+#include "olap/page_cache.h"
+#include "runtime/mem_pool.h"
+#include "runtime/mem_tracker.h"
+#include "util/file_utils.h"
+
+namespace doris {
+namespace segment_v2 {
+
+class PrimaryKeyIndexTest : public testing::Test {
+public:
+    const std::string kTestDir = "./ut_dir/primary_key_index_test";
+
+    void SetUp() override {
+        if (FileUtils::check_exist(kTestDir)) {
+            ASSERT_TRUE(FileUtils::remove_all(kTestDir).ok());
+        }
+        ASSERT_TRUE(FileUtils::create_dir(kTestDir).ok());
+    }
+    void TearDown() override {
+        if (FileUtils::check_exist(kTestDir)) {
+            ASSERT_TRUE(FileUtils::remove_all(kTestDir).ok());
+        }
+    }
+};
+
+static std::string make_key(int i) {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "key_%08d", i);
+    return buf;
+}
+
+TEST_F(PrimaryKeyIndexTest, lookup_and_read) {
+    std::string filename = kTestDir + "/lookup_and_read";
+    // even keys only, so that odd keys are absent
+    const int num_rows = 10000;
+    PrimaryKeyIndexMetaPB index_meta;
+    {
+        std::unique_ptr<fs::WritableBlock> wblock;
+        fs::CreateBlockOptions opts({filename});
+        ASSERT_TRUE(fs::fs_util::block_manager()->create_block(opts, &wblock).ok());
+        PrimaryKeyIndexBuilder builder(wblock.get());
+        ASSERT_TRUE(builder.init().ok());
+        for (int i = 0; i < num_rows; ++i) {
+            std::string key = make_key(i * 2);
+            ASSERT_TRUE(builder.add_item(key).ok());
+        }
+        ASSERT_EQ(num_rows, builder.num_rows());
+        ASSERT_TRUE(builder.finalize(&index_meta).ok());
+        ASSERT_TRUE(wblock->close().ok());
+    }
+    ASSERT_EQ(make_key(0), index_meta.min_key());
+    ASSERT_EQ(make_key((num_rows - 1) * 2), index_meta.max_key());
+
+    PrimaryKeyIndexReader reader;
+    ASSERT_TRUE(reader.parse(filename, index_meta).ok());
+    ASSERT_EQ(num_rows, reader.num_rows());
+    std::unique_ptr<IndexedColumnIterator> iter;
+    ASSERT_TRUE(reader.new_iterator(&iter).ok());
+
+    for (int i = 0; i < num_rows; i += 7) {
+        rowid_t row_id = 0;
+        std::string key = make_key(i * 2);
+        ASSERT_TRUE(reader.lookup_row_id(iter.get(), key, &row_id).ok());
+        ASSERT_EQ(i, row_id);
+
+        key = make_key(i * 2 + 1);
+        ASSERT_TRUE(reader.lookup_row_id(iter.get(), key, &row_id).is_not_found());
+    }
+    // out of the range of the index
+    std::string key = "a";
+    rowid_t row_id = 0;
+    ASSERT_FALSE(reader.may_contain(key));
+    ASSERT_TRUE(reader.lookup_row_id(iter.get(), key, &row_id).is_not_found());
+    key = "z";
+    ASSERT_TRUE(reader.lookup_row_id(iter.get(), key, &row_id).is_not_found());
+
+    auto tracker = std::make_shared<MemTracker>();
+    MemPool pool(tracker.get());
+    std::vector<Slice> keys;
+    size_t n = 1024;
+    ASSERT_TRUE(reader.read_keys(iter.get(), num_rows - 100, &n, &pool, &keys).ok());
+    ASSERT_EQ(100, n);
+    ASSERT_EQ(100, keys.size());
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_EQ(make_key((num_rows - 100 + i) * 2), keys[i].to_string());
+    }
+    n = 1024;
+    ASSERT_TRUE(reader.read_keys(iter.get(), num_rows, &n, &pool, &keys).ok());
+    ASSERT_EQ(0, n);
+}
+
+} // namespace segment_v2
+} // namespace doris
+
+int main(int argc, char** argv) {
+    doris::StoragePageCache::create_global_cache(1 << 30, 10);
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
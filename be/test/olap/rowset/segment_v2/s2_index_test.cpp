@@ -0,0 +1,185 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <gtest/gtest.h>
+#include <s2/s2cell_id.h>
+#include <s2/s2latlng.h>
+
+#include <string>
+#include <vector>
+
+#include "geo/geo_types.h"
+#include "olap/fs/block_manager.h"
+#include "olap/fs/fs_util.h"
+#include "olap/page_cache.h"
+#include "olap/rowset/segment_v2/s2_index_reader.h"
+#include "olap/rowset/segment_v2/s2_index_writer.h"
+#include "olap/s2_column_predicate.h"
+#include "util/file_utils.h"
+
+namespace doris {
+namespace segment_v2 {
+
+class S2IndexTest : public testing::Test {
+public:
+    const std::string kTestDir = "./ut_dir/s2_index_test";
+
+    void SetUp() override {
+        if (FileUtils::check_exist(kTestDir)) {
+            ASSERT_TRUE(FileUtils::remove_all(kTestDir).ok());
+        }
+        ASSERT_TRUE(FileUtils::create_dir(kTestDir).ok());
+    }
+    void TearDown() override {
+        if (FileUtils::check_exist(kTestDir)) {
+            ASSERT_TRUE(FileUtils::remove_all(kTestDir).ok());
+        }
+    }
+};
+
+static const int32_t kLatUniqueId = 2;
+
+// rows of (lng, lat): (116.40, 39.90), null, (116.41, 39.91), (121.47, 31.23),
+// (200, 10) out of range, (116.0, 40.3)
+static void write_index_file(const std::string& file_name, ColumnIndexMetaPB* meta) {
+    std::unique_ptr<fs::WritableBlock> wblock;
+    fs::CreateBlockOptions opts({file_name});
+    ASSERT_TRUE(fs::fs_util::block_manager()->create_block(opts, &wblock).ok());
+
+    std::unique_ptr<S2IndexWriter> writer;
+    ASSERT_TRUE(S2IndexWriter::create(16, kLatUniqueId, &writer).ok());
+    double lngs[] = {116.40, 0, 116.41, 121.47, 200, 116.0};
+    double lats[] = {39.90, 0, 39.91, 31.23, 10, 40.3};
+    for (int i = 0; i < 6; ++i) {
+        if (i == 1) {
+            writer->add_point(nullptr, &lats[i]);
+        } else {
+            writer->add_point(&lngs[i], &lats[i]);
+        }
+    }
+    ASSERT_TRUE(writer->finish(wblock.get(), meta).ok());
+    ASSERT_EQ(S2_INDEX, meta->type());
+    ASSERT_EQ(16, meta->s2_index().level());
+    ASSERT_EQ(kLatUniqueId, meta->s2_index().lat_column_unique_id());
+    ASSERT_TRUE(meta->s2_index().cells().has_null());
+    ASSERT_TRUE(wblock->close().ok());
+}
+
+static std::string encode_wkt(const std::string& wkt) {
+    GeoParseStatus status;
+    std::unique_ptr<GeoShape> shape(GeoShape::from_wkt(wkt.data(), wkt.size(), &status));
+    EXPECT_TRUE(shape != nullptr);
+    std::string buf;
+    shape->encode_to(&buf);
+    return buf;
+}
+
+TEST_F(S2IndexTest, test_cell_key) {
+    S2CellId leaf(S2LatLng::FromDegrees(39.90, 116.40));
+    S2CellId cell = leaf.parent(10);
+    // the keys of the cells of level 16 in a cell of level 10 are a range
+    int64_t lo = S2IndexWriter::cell_key(cell.range_min(), 16);
+    int64_t hi = S2IndexWriter::cell_key(cell.range_max(), 16);
+    ASSERT_EQ((1 << 12) - 1, hi - lo);
+    int64_t key = S2IndexWriter::cell_key(leaf, 16);
+    ASSERT_TRUE(lo <= key && key <= hi);
+    ASSERT_EQ(key, S2IndexWriter::cell_key(leaf.parent(16), 16));
+    ASSERT_LT(key, S2IndexWriter::cell_key(leaf.parent(16).next(), 16));
+    ASSERT_GE(S2IndexWriter::cell_key(S2CellId::Begin(30), 30), 0);
+    ASSERT_GE(S2IndexWriter::cell_key(S2CellId::End(30).prev(), 30), 0);
+}
+
+TEST_F(S2IndexTest, test_filter_rows) {
+    std::string file_name = kTestDir + "/filter_rows";
+    ColumnIndexMetaPB meta;
+    write_index_file(file_name, &meta);
+
+    S2IndexReader reader(file_name, &meta.s2_index());
+    ASSERT_TRUE(reader.load(true, false).ok());
+    S2IndexIterator* iter = nullptr;
+    ASSERT_TRUE(reader.new_iterator(&iter).ok());
+    std::unique_ptr<S2IndexIterator> iter_holder(iter);
+    ASSERT_EQ(16, iter->level());
+
+    {
+        // a cell of level 8 is about 40km wide
+        std::vector<S2CellId> cells {S2CellId(S2LatLng::FromDegrees(31.23, 121.47)).parent(8)};
+        Roaring rows;
+        rows.addRange(0, 6);
+        ASSERT_TRUE(iter->filter_rows_in_cells(cells, &rows).ok());
+        ASSERT_TRUE(Roaring::bitmapOf(1, 3) == rows);
+    }
+    {
+        // cells of a higher level than the index
+        std::vector<S2CellId> cells {S2CellId(S2LatLng::FromDegrees(39.90, 116.40)),
+                                     S2CellId(S2LatLng::FromDegrees(31.23, 121.47)).parent(20)};
+        Roaring rows;
+        rows.addRange(0, 6);
+        ASSERT_TRUE(iter->filter_rows_in_cells(cells, &rows).ok());
+        ASSERT_TRUE(Roaring::bitmapOf(2, 0, 3) == rows);
+    }
+    {
+        // the whole earth, rows without a point are removed
+        std::vector<S2CellId> cells;
+        for (int face = 0; face < 6; ++face) {
+            cells.push_back(S2CellId::FromFace(face));
+        }
+        Roaring rows;
+        rows.addRange(0, 6);
+        ASSERT_TRUE(iter->filter_rows_in_cells(cells, &rows).ok());
+        ASSERT_TRUE(Roaring::bitmapOf(4, 0, 2, 3, 5) == rows);
+    }
+    {
+        S2ColumnPredicate pred(0, kLatUniqueId,
+                               encode_wkt("POLYGON ((116.35 39.85, 116.45 39.85, 116.45 39.95, "
+                                          "116.35 39.95, 116.35 39.85))"));
+        Roaring rows;
+        rows.addRange(0, 6);
+        ASSERT_TRUE(pred.evaluate_s2_index(iter, &rows).ok());
+        ASSERT_TRUE(Roaring::bitmapOf(2, 0, 2) == rows);
+    }
+    {
+        GeoCircle circle;
+        ASSERT_EQ(GEO_PARSE_OK, circle.init(116.40, 39.90, 2000));
+        std::string buf;
+        circle.encode_to(&buf);
+        S2ColumnPredicate pred(0, kLatUniqueId, buf);
+        Roaring rows;
+        rows.addRange(0, 6);
+        ASSERT_TRUE(pred.evaluate_s2_index(iter, &rows).ok());
+        ASSERT_TRUE(Roaring::bitmapOf(2, 0, 2) == rows);
+    }
+    {
+        // the index is built with another latitude column
+        S2ColumnPredicate pred(0, kLatUniqueId + 1,
+                               encode_wkt("POLYGON ((116.35 39.85, 116.45 39.85, 116.45 39.95, "
+                                          "116.35 39.95, 116.35 39.85))"));
+        Roaring rows;
+        rows.addRange(0, 6);
+        ASSERT_TRUE(pred.evaluate_s2_index(iter, &rows).ok());
+        ASSERT_EQ(6, rows.cardinality());
+    }
+}
+
+} // namespace segment_v2
+} // namespace doris
+
+int main(int argc, char** argv) {
+    doris::StoragePageCache::create_global_cache(1 << 30, 10);
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
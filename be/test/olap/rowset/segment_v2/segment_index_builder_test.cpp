@@ -0,0 +1,181 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/rowset/segment_v2/segment_index_builder.h"
+
+#include <gtest/gtest.h>
+
+#include "olap/fs/block_manager.h"
+#include "olap/fs/fs_util.h"
+#include "olap/page_cache.h"
+#include "olap/row_cursor.h"
+#include "olap/rowset/segment_v2/bitmap_index_reader.h"
+#include "olap/rowset/segment_v2/bloom_filter.h"
+#include "olap/rowset/segment_v2/bloom_filter_index_reader.h"
+#include "olap/rowset/segment_v2/column_reader.h"
+#include "olap/rowset/segment_v2/segment.h"
+#include "olap/rowset/segment_v2/segment_writer.h"
+#include "olap/tablet_schema_helper.h"
+#include "util/file_utils.h"
+
+namespace doris {
+namespace segment_v2 {
+
+class SegmentIndexBuilderTest : public testing::Test {
+protected:
+    void SetUp() override {
+        if (FileUtils::check_exist(kSegmentDir)) {
+            ASSERT_TRUE(FileUtils::remove_all(kSegmentDir).ok());
+        }
+        ASSERT_TRUE(FileUtils::create_dir(kSegmentDir).ok());
+    }
+
+    void TearDown() override {
+        if (FileUtils::check_exist(kSegmentDir)) {
+            ASSERT_TRUE(FileUtils::remove_all(kSegmentDir).ok());
+        }
+    }
+
+    TabletSchema create_schema(bool with_indexes) {
+        TabletSchema schema;
+        schema._cols.push_back(create_int_key(1));
+        schema._cols.push_back(create_int_value(2, OLAP_FIELD_AGGREGATION_REPLACE, true, "",
+                                                with_indexes, with_indexes));
+        schema._num_columns = 2;
+        schema._num_key_columns = 1;
+        schema._num_short_key_columns = 1;
+        schema.init_field_index_for_test();
+        return schema;
+    }
+
+    // Write rows whose value of column 2 is null every 7 rows, and rid % 100 otherwise
+    void write_segment(const TabletSchema& schema, const std::string& fname, size_t num_rows) {
+        std::unique_ptr<fs::WritableBlock> wblock;
+        fs::CreateBlockOptions block_opts({fname});
+        ASSERT_TRUE(fs::fs_util::block_manager()->create_block(block_opts, &wblock).ok());
+        SegmentWriterOptions opts;
+        SegmentWriter writer(wblock.get(), 0, &schema, opts);
+        ASSERT_TRUE(writer.init(10).ok());
+
+        RowCursor row;
+        ASSERT_EQ(OLAP_SUCCESS, row.init(schema));
+        for (size_t rid = 0; rid < num_rows; ++rid) {
+            RowCursorCell key = row.cell(0);
+            key.set_not_null();
+            *(int32_t*)key.mutable_cell_ptr() = rid;
+            RowCursorCell value = row.cell(1);
+            if (rid % 7 == 0) {
+                value.set_null();
+            } else {
+                value.set_not_null();
+                *(int32_t*)value.mutable_cell_ptr() = rid % 100;
+            }
+            ASSERT_TRUE(writer.append_row(row).ok());
+        }
+        uint64_t file_size = 0;
+        uint64_t index_size = 0;
+        ASSERT_TRUE(writer.finalize(&file_size, &index_size).ok());
+        ASSERT_TRUE(wblock->close().ok());
+    }
+
+    const std::string kSegmentDir = "./ut_dir/segment_index_builder_test";
+};
+
+TEST_F(SegmentIndexBuilderTest, BuildIndexFile) {
+    TabletSchema old_schema = create_schema(false);
+    TabletSchema new_schema = create_schema(true);
+    std::string fname = kSegmentDir + "/seg_0.dat";
+    const size_t num_rows = 100000;
+    write_segment(old_schema, fname, num_rows);
+    ASSERT_EQ(kSegmentDir + "/seg_0.idx", Segment::index_file_name(fname));
+
+    std::shared_ptr<Segment> segment;
+    ASSERT_TRUE(Segment::open(fname, 0, &old_schema, &segment).ok());
+    ASSERT_FALSE(SegmentIndexBuilder(segment, &old_schema).need_build());
+
+    ASSERT_TRUE(Segment::open(fname, 0, &new_schema, &segment).ok());
+    ASSERT_FALSE(segment->_column_readers[1]->has_bitmap_index());
+    SegmentIndexBuilder builder(segment, &new_schema);
+    ASSERT_TRUE(builder.need_build());
+    ASSERT_TRUE(builder.build().ok());
+    // an index file is never rewritten
+    ASSERT_FALSE(FileUtils::check_exist(Segment::index_file_name(fname) + ".tmp"));
+
+    ASSERT_TRUE(Segment::open(fname, 0, &new_schema, &segment).ok());
+    ASSERT_FALSE(SegmentIndexBuilder(segment, &new_schema).need_build());
+    ASSERT_TRUE(SegmentIndexBuilder(segment, &new_schema).build().is_already_exist());
+    ASSERT_EQ(1, segment->index_footer().columns_size());
+    ColumnReader* reader = segment->_column_readers[1].get();
+    ASSERT_TRUE(reader->has_bitmap_index());
+    ASSERT_TRUE(reader->has_bloom_filter_index());
+    ASSERT_FALSE(segment->_column_readers[0]->has_bitmap_index());
+
+    // the bitmap of value 42
+    {
+        BitmapIndexIterator* raw_iter = nullptr;
+        ASSERT_TRUE(segment->new_bitmap_index_iterator(1, &raw_iter).ok());
+        std::unique_ptr<BitmapIndexIterator> iter(raw_iter);
+        int32_t value = 42;
+        bool exact_match = false;
+        ASSERT_TRUE(iter->seek_dictionary(&value, &exact_match).ok());
+        ASSERT_TRUE(exact_match);
+        Roaring bitmap;
+        ASSERT_TRUE(iter->read_bitmap(iter->current_ordinal(), &bitmap).ok());
+        size_t expected = 0;
+        for (size_t rid = 0; rid < num_rows; ++rid) {
+            bool match = rid % 7 != 0 && rid % 100 == 42;
+            ASSERT_EQ(match, bitmap.contains(rid)) << rid;
+            expected += match;
+        }
+        ASSERT_EQ(expected, bitmap.cardinality());
+
+        Roaring null_bitmap;
+        ASSERT_TRUE(iter->read_null_bitmap(&null_bitmap).ok());
+        ASSERT_EQ((num_rows + 6) / 7, null_bitmap.cardinality());
+    }
+
+    // a bloom filter of each data page with the values of the page
+    {
+        std::vector<ordinal_t> page_ordinals;
+        ASSERT_TRUE(reader->get_page_first_ordinals(&page_ordinals).ok());
+        ASSERT_GT(page_ordinals.size(), 1);
+        page_ordinals.push_back(num_rows);
+        std::unique_ptr<BloomFilterIndexIterator> bf_iter;
+        ASSERT_TRUE(reader->_bloom_filter_index->new_iterator(&bf_iter).ok());
+        for (size_t page = 0; page + 1 < page_ordinals.size(); ++page) {
+            std::unique_ptr<BloomFilter> bf;
+            ASSERT_TRUE(bf_iter->read_bloom_filter(page, &bf).ok());
+            for (ordinal_t rid = page_ordinals[page]; rid < page_ordinals[page + 1]; ++rid) {
+                if (rid % 7 == 0) {
+                    ASSERT_TRUE(bf->has_null());
+                } else {
+                    int32_t value = rid % 100;
+                    ASSERT_TRUE(bf->test_bytes((char*)&value, sizeof(value))) << rid;
+                }
+            }
+        }
+    }
+}
+
+} // namespace segment_v2
+} // namespace doris
+
+int main(int argc, char** argv) {
+    doris::StoragePageCache::create_global_cache(1 << 30, 10);
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -23,13 +23,16 @@
 #include <functional>
 #include <iostream>
 
+#include "common/config.h"
 #include "common/logging.h"
 #include "gutil/strings/substitute.h"
+#include "olap/block_filter.h"
 #include "olap/comparison_predicate.h"
 #include "olap/fs/block_manager.h"
 #include "olap/fs/fs_util.h"
 #include "olap/in_list_predicate.h"
 #include "olap/olap_common.h"
+#include "olap/row.h"
 #include "olap/row_block.h"
 #include "olap/row_block2.h"
 #include "olap/row_cursor.h"
@@ -38,9 +41,11 @@
 #include "olap/tablet_schema.h"
 #include "olap/tablet_schema_helper.h"
 #include "olap/types.h"
+#include "olap/wrapper_field.h"
 #include "runtime/mem_pool.h"
 #include "runtime/mem_tracker.h"
 #include "util/file_utils.h"
+#include "util/threadpool.h"
 
 namespace doris {
 namespace segment_v2 {
@@ -144,6 +149,29 @@ private:
     const std::string kSegmentDir = "./ut_dir/segment_test";
 };
 
+// keep rows whose int column `cid` is a multiple of `divisor`
+class ModBlockFilter : public BlockFilter {
+public:
+    ModBlockFilter(ColumnId cid, int divisor) : _column_ids({cid}), _divisor(divisor) {}
+
+    const std::vector<ColumnId>& column_ids() const override { return _column_ids; }
+
+    Status evaluate(const RowBlockV2& block, uint16_t* sel, uint16_t* size) override {
+        auto column_block = block.column_block(_column_ids[0]);
+        uint16_t new_size = 0;
+        for (uint16_t i = 0; i < *size; ++i) {
+            sel[new_size] = sel[i];
+            new_size += (*(const int32_t*)column_block.cell_ptr(sel[i]) % _divisor == 0);
+        }
+        *size = new_size;
+        return Status::OK();
+    }
+
+private:
+    std::vector<ColumnId> _column_ids;
+    int _divisor;
+};
+
 TEST_F(SegmentReaderWriterTest, normal) {
     TabletSchema tablet_schema = create_schema(
             {create_int_key(1), create_int_key(2), create_int_value(3), create_int_value(4)});
@@ -345,6 +373,46 @@ TEST_F(SegmentReaderWriterTest, LazyMaterialization) {
             auto row = block.row(block.selection_vector()[0]);
             ASSERT_EQ("[10,100]", row.debug_string());
         }
+        {
+            // lazy enabled when block filters read a subset of returned columns:
+            // select c1, c2 where c1 % 7 = 0;
+            Schema read_schema(tablet_schema);
+            std::unique_ptr<ColumnPredicate> predicate(new EqualPredicate<int32_t>(1, 210));
+            const std::vector<ColumnPredicate*> predicates = {predicate.get()};
+            ModBlockFilter filter(0, 7);
+            const std::vector<BlockFilter*> filters = {&filter};
+
+            OlapReaderStatistics stats;
+            StorageReadOptions read_opts;
+            read_opts.block_filters = &filters;
+            read_opts.stats = &stats;
+
+            std::unique_ptr<RowwiseIterator> iter;
+            ASSERT_TRUE(segment->new_iterator(read_schema, read_opts, &iter).ok());
+
+            RowBlockV2 block(read_schema, 1024);
+            ASSERT_TRUE(iter->next_batch(&block).ok());
+            ASSERT_TRUE(iter->is_lazy_materialization_read());
+            ASSERT_EQ(15, block.selected_size());
+            ASSERT_EQ(85, stats.rows_block_filter_filtered);
+            for (int i = 0; i < block.selected_size(); ++i) {
+                auto row = block.row(block.selection_vector()[i]);
+                ASSERT_EQ(strings::Substitute("[$0,$1]", i * 7, i * 70), row.debug_string());
+            }
+
+            // column predicates are evaluated first:
+            // select c1, c2 where c1 % 7 = 0 and c2 = 210;
+            read_opts.column_predicates = &predicates;
+            stats = OlapReaderStatistics();
+            ASSERT_TRUE(segment->new_iterator(read_schema, read_opts, &iter).ok());
+            block.clear();
+            ASSERT_TRUE(iter->next_batch(&block).ok());
+            ASSERT_TRUE(iter->is_lazy_materialization_read());
+            ASSERT_EQ(1, block.selected_size());
+            ASSERT_EQ(99, stats.rows_vec_cond_filtered);
+            ASSERT_EQ(0, stats.rows_block_filter_filtered);
+            ASSERT_EQ("[21,210]", block.row(block.selection_vector()[0]).debug_string());
+        }
         {
             // lazy disabled when no predicate:
             // select c2
@@ -401,6 +469,368 @@ TEST_F(SegmentReaderWriterTest, LazyMaterialization) {
     }
 }
 
+TEST_F(SegmentReaderWriterTest, ReadAhead) {
+    TabletSchema tablet_schema = create_schema({create_int_key(1), create_int_value(2)});
+    const int num_rows = 100000;
+    shared_ptr<Segment> segment;
+    build_segment(SegmentWriterOptions(), tablet_schema, tablet_schema, num_rows,
+                  DefaultIntGenerator, &segment);
+
+    std::unique_ptr<ThreadPool> pool;
+    ASSERT_TRUE(ThreadPoolBuilder("ReadAheadTest").set_max_threads(2).build(&pool).ok());
+    auto read_rows = [&](const std::vector<ColumnPredicate*>* predicates,
+                         std::vector<std::string>* rows, OlapReaderStatistics* stats) {
+        Schema read_schema(tablet_schema);
+        StorageReadOptions read_opts;
+        read_opts.column_predicates = predicates;
+        read_opts.stats = stats;
+        read_opts.read_ahead_pool = pool.get();
+        read_opts.read_ahead_pages = 2;
+        std::unique_ptr<RowwiseIterator> iter;
+        ASSERT_TRUE(segment->new_iterator(read_schema, read_opts, &iter).ok());
+        RowBlockV2 block(read_schema, 1024);
+        while (true) {
+            block.clear();
+            auto st = iter->next_batch(&block);
+            if (st.is_end_of_file()) {
+                break;
+            }
+            ASSERT_TRUE(st.ok());
+            for (int i = 0; i < block.selected_size(); ++i) {
+                rows->push_back(block.row(block.selection_vector()[i]).debug_string());
+            }
+        }
+    };
+
+    {
+        // select c1, c2
+        std::vector<std::string> rows;
+        OlapReaderStatistics stats;
+        read_rows(nullptr, &rows, &stats);
+        ASSERT_EQ(num_rows, rows.size());
+        for (int i = 0; i < num_rows; ++i) {
+            ASSERT_EQ(strings::Substitute("[$0,$1]", i * 10, i * 10 + 1), rows[i]);
+        }
+        ASSERT_GT(stats.read_ahead_pages_num, 0);
+    }
+    {
+        // select c1, c2 where c1 >= 800000, pages pruned by zone map are not read ahead
+        std::unique_ptr<ColumnPredicate> predicate(
+                new GreaterEqualPredicate<int32_t>(0, 800000));
+        const std::vector<ColumnPredicate*> predicates = {predicate.get()};
+        std::vector<std::string> rows;
+        OlapReaderStatistics stats;
+        read_rows(&predicates, &rows, &stats);
+        ASSERT_EQ(num_rows - 80000, rows.size());
+        for (int i = 0; i < rows.size(); ++i) {
+            int rid = i + 80000;
+            ASSERT_EQ(strings::Substitute("[$0,$1]", rid * 10, rid * 10 + 1), rows[i]);
+        }
+    }
+}
+
+TEST_F(SegmentReaderWriterTest, CompressionType) {
+    TabletColumn value_column = create_int_value(3);
+    value_column._compression_type = NO_COMPRESSION;
+    TabletSchema tablet_schema = create_schema(
+            {create_int_key(1), create_int_key(2), value_column, create_int_value(4)});
+    tablet_schema._compression_type = ZSTD;
+    tablet_schema._compression_level = 3;
+
+    SegmentWriterOptions opts;
+    opts.num_rows_per_block = 10;
+
+    shared_ptr<Segment> segment;
+    build_segment(opts, tablet_schema, tablet_schema, 4096, DefaultIntGenerator, &segment);
+    ASSERT_EQ(ZSTD, segment->footer().columns(0).compression());
+    ASSERT_EQ(ZSTD, segment->footer().columns(1).compression());
+    ASSERT_EQ(NO_COMPRESSION, segment->footer().columns(2).compression());
+    ASSERT_EQ(ZSTD, segment->footer().columns(3).compression());
+
+    Schema schema(tablet_schema);
+    OlapReaderStatistics stats;
+    StorageReadOptions read_opts;
+    read_opts.stats = &stats;
+    std::unique_ptr<RowwiseIterator> iter;
+    ASSERT_TRUE(segment->new_iterator(schema, read_opts, &iter).ok());
+
+    RowBlockV2 block(schema, 1024);
+    int rowid = 0;
+    while (rowid < 4096) {
+        block.clear();
+        ASSERT_TRUE(iter->next_batch(&block).ok());
+        ASSERT_EQ(1024, block.num_rows());
+        for (int j = 0; j < block.schema()->column_ids().size(); ++j) {
+            auto cid = block.schema()->column_ids()[j];
+            auto column_block = block.column_block(j);
+            for (int i = 0; i < block.num_rows(); ++i) {
+                ASSERT_EQ((rowid + i) * 10 + cid, *(int*)column_block.cell_ptr(i));
+            }
+        }
+        rowid += block.num_rows();
+    }
+    ASSERT_TRUE(iter->next_batch(&block).is_end_of_file());
+}
+
+TEST_F(SegmentReaderWriterTest, AdaptiveEncoding) {
+    config::enable_adaptive_encoding = true;
+    TabletSchema tablet_schema = create_schema(
+            {create_int_key(1), create_int_key(2), create_int_value(3), create_int_value(4)});
+
+    SegmentWriterOptions opts;
+    opts.num_rows_per_block = 10;
+
+    // column 4 is the same value, with a null every 7 rows
+    shared_ptr<Segment> segment;
+    build_segment(
+            opts, tablet_schema, tablet_schema, 64 * 1024,
+            [](size_t rid, int cid, int block_id, RowCursorCell& cell) {
+                if (cid == 3 && rid % 7 == 0) {
+                    cell.set_null();
+                    return;
+                }
+                cell.set_not_null();
+                *(int*)cell.mutable_cell_ptr() = cid == 3 ? 42 : rid * 10 + cid;
+            },
+            &segment);
+    config::enable_adaptive_encoding = false;
+
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_NE(DEFAULT_ENCODING, segment->footer().columns(i).encoding());
+    }
+    ASSERT_NE(PLAIN_ENCODING, segment->footer().columns(2).encoding());
+    ASSERT_NE(PLAIN_ENCODING, segment->footer().columns(3).encoding());
+
+    Schema schema(tablet_schema);
+    OlapReaderStatistics stats;
+    StorageReadOptions read_opts;
+    read_opts.stats = &stats;
+    std::unique_ptr<RowwiseIterator> iter;
+    ASSERT_TRUE(segment->new_iterator(schema, read_opts, &iter).ok());
+
+    RowBlockV2 block(schema, 1024);
+    int rowid = 0;
+    while (rowid < 64 * 1024) {
+        block.clear();
+        ASSERT_TRUE(iter->next_batch(&block).ok());
+        ASSERT_EQ(1024, block.num_rows());
+        for (int j = 0; j < block.schema()->column_ids().size(); ++j) {
+            auto cid = block.schema()->column_ids()[j];
+            auto column_block = block.column_block(j);
+            for (int i = 0; i < block.num_rows(); ++i) {
+                if (cid == 3) {
+                    ASSERT_EQ((rowid + i) % 7 == 0, column_block.is_null(i));
+                    if (!column_block.is_null(i)) {
+                        ASSERT_EQ(42, *(int*)column_block.cell_ptr(i));
+                    }
+                } else {
+                    ASSERT_FALSE(column_block.is_null(i));
+                    ASSERT_EQ((rowid + i) * 10 + cid, *(int*)column_block.cell_ptr(i));
+                }
+            }
+        }
+        rowid += block.num_rows();
+    }
+    ASSERT_TRUE(iter->next_batch(&block).is_end_of_file());
+}
+
+TEST_F(SegmentReaderWriterTest, TestGetMinMax) {
+    TabletSchema tablet_schema =
+            create_schema({create_int_key(1), create_int_key(2), create_int_value(3)});
+
+    SegmentWriterOptions opts;
+    opts.num_rows_per_block = 10;
+
+    std::shared_ptr<Segment> segment;
+    // column 1 has nulls and column 2 is all null
+    build_segment(
+            opts, tablet_schema, tablet_schema, 4096,
+            [](size_t rid, int cid, int block_id, RowCursorCell& cell) {
+                if (cid == 2 || (cid == 1 && rid % 3 == 0)) {
+                    cell.set_null();
+                    return;
+                }
+                cell.set_not_null();
+                *(int*)cell.mutable_cell_ptr() = rid * 10 + cid;
+            },
+            &segment);
+
+    std::unique_ptr<WrapperField> min_value(WrapperField::create(tablet_schema.column(0)));
+    std::unique_ptr<WrapperField> max_value(WrapperField::create(tablet_schema.column(0)));
+    ASSERT_TRUE(segment->get_min_max(0, min_value.get(), max_value.get()).ok());
+    ASSERT_FALSE(min_value->is_null());
+    ASSERT_EQ(0, *(int*)min_value->cell_ptr());
+    ASSERT_EQ(40950, *(int*)max_value->cell_ptr());
+
+    // null is not the min value
+    ASSERT_TRUE(segment->get_min_max(1, min_value.get(), max_value.get()).ok());
+    ASSERT_FALSE(min_value->is_null());
+    ASSERT_EQ(11, *(int*)min_value->cell_ptr());
+    ASSERT_EQ(40941, *(int*)max_value->cell_ptr());
+
+    ASSERT_TRUE(segment->get_min_max(2, min_value.get(), max_value.get()).ok());
+    ASSERT_TRUE(min_value->is_null());
+    ASSERT_TRUE(max_value->is_null());
+
+    ASSERT_FALSE(segment->get_min_max(3, min_value.get(), max_value.get()).ok());
+}
+
+TEST_F(SegmentReaderWriterTest, AppendBlock) {
+    TabletSchema tablet_schema =
+            create_schema({create_int_key(1), create_int_key(2), create_int_value(3)});
+
+    SegmentWriterOptions opts;
+    opts.num_rows_per_block = 10;
+
+    std::shared_ptr<Segment> segment;
+    // column 2 has nulls
+    build_segment(
+            opts, tablet_schema, tablet_schema, 4096,
+            [](size_t rid, int cid, int block_id, RowCursorCell& cell) {
+                if (cid == 2 && rid % 3 == 0) {
+                    cell.set_null();
+                    return;
+                }
+                cell.set_not_null();
+                *(int*)cell.mutable_cell_ptr() = rid * 10 + cid;
+            },
+            &segment);
+
+    // copy all rows of segment to a new segment by blocks, every block is appended in two parts
+    Schema schema(tablet_schema);
+    OlapReaderStatistics stats;
+    StorageReadOptions read_opts;
+    read_opts.stats = &stats;
+    std::string filename = "./ut_dir/segment_test/append_block.dat";
+    std::unique_ptr<fs::WritableBlock> wblock;
+    fs::CreateBlockOptions block_opts({filename});
+    ASSERT_TRUE(fs::fs_util::block_manager()->create_block(block_opts, &wblock).ok());
+    SegmentWriter writer(wblock.get(), 0, &tablet_schema, opts);
+    ASSERT_TRUE(writer.init(10).ok());
+    {
+        std::unique_ptr<RowwiseIterator> iter;
+        ASSERT_TRUE(segment->new_iterator(schema, read_opts, &iter).ok());
+        RowBlockV2 block(schema, 1000);
+        Status st;
+        do {
+            block.clear();
+            st = iter->next_batch(&block);
+            if (st.ok()) {
+                size_t half = block.num_rows() / 2;
+                ASSERT_TRUE(writer.append_block(block, 0, half).ok());
+                ASSERT_TRUE(writer.append_block(block, half, block.num_rows() - half).ok());
+            }
+        } while (st.ok());
+        ASSERT_TRUE(st.is_end_of_file());
+    }
+    uint64_t file_size, index_size;
+    ASSERT_TRUE(writer.finalize(&file_size, &index_size).ok());
+    ASSERT_TRUE(wblock->close().ok());
+
+    std::shared_ptr<Segment> copied;
+    ASSERT_TRUE(Segment::open(filename, 0, &tablet_schema, &copied).ok());
+    ASSERT_EQ(4096, copied->num_rows());
+    std::unique_ptr<RowwiseIterator> iter;
+    ASSERT_TRUE(copied->new_iterator(schema, read_opts, &iter).ok());
+    RowBlockV2 block(schema, 1024);
+    int rowid = 0;
+    while (rowid < 4096) {
+        block.clear();
+        ASSERT_TRUE(iter->next_batch(&block).ok());
+        for (int i = 0; i < block.num_rows(); ++i, ++rowid) {
+            for (int cid = 0; cid < 3; ++cid) {
+                auto column_block = block.column_block(cid);
+                if (cid == 2 && rowid % 3 == 0) {
+                    ASSERT_TRUE(column_block.is_null(i));
+                } else {
+                    ASSERT_FALSE(column_block.is_null(i));
+                    ASSERT_EQ(rowid * 10 + cid, *(int*)column_block.cell_ptr(i));
+                }
+            }
+        }
+    }
+
+    // short key index is built from the appended rows
+    StorageReadOptions seek_opts;
+    seek_opts.stats = &stats;
+    std::unique_ptr<RowCursor> lower_bound(new RowCursor());
+    lower_bound->init(tablet_schema, 1);
+    lower_bound->cell(0).set_not_null();
+    *(int*)lower_bound->cell(0).mutable_cell_ptr() = 20000;
+    seek_opts.key_ranges.emplace_back(lower_bound.get(), true, nullptr, false);
+    ASSERT_TRUE(copied->new_iterator(schema, seek_opts, &iter).ok());
+    block.clear();
+    ASSERT_TRUE(iter->next_batch(&block).ok());
+    ASSERT_EQ(20000, *(int*)block.column_block(0).cell_ptr(0));
+}
+
+TEST_F(SegmentReaderWriterTest, AppendRows) {
+    TabletSchema tablet_schema =
+            create_schema({create_int_key(1), create_int_key(2), create_int_value(3)});
+    Schema schema(tablet_schema);
+    const int num_rows = 4096;
+    std::vector<char> buf(num_rows * schema.schema_size());
+    std::vector<ContiguousRow> rows;
+    for (int rid = 0; rid < num_rows; ++rid) {
+        rows.emplace_back(&schema, &buf[rid * schema.schema_size()]);
+        for (int cid = 0; cid < 3; ++cid) {
+            RowCursorCell cell = rows.back().cell(cid);
+            if (cid == 2 && rid % 3 == 0) {
+                cell.set_null();
+                continue;
+            }
+            cell.set_not_null();
+            *(int*)cell.mutable_cell_ptr() = rid * 10 + cid;
+        }
+    }
+
+    // the columns are appended in parallel, in batches of different sizes
+    std::unique_ptr<ThreadPool> pool;
+    ASSERT_TRUE(ThreadPoolBuilder("ColumnEncodeTest").set_max_threads(2).build(&pool).ok());
+    SegmentWriterOptions opts;
+    opts.num_rows_per_block = 10;
+    opts.column_encode_pool = pool.get();
+    std::string filename = "./ut_dir/segment_test/append_rows.dat";
+    std::unique_ptr<fs::WritableBlock> wblock;
+    fs::CreateBlockOptions block_opts({filename});
+    ASSERT_TRUE(fs::fs_util::block_manager()->create_block(block_opts, &wblock).ok());
+    SegmentWriter writer(wblock.get(), 0, &tablet_schema, opts);
+    ASSERT_TRUE(writer.init(10).ok());
+    ASSERT_TRUE(writer.append_rows(&rows[0], 1).ok());
+    ASSERT_TRUE(writer.append_rows(&rows[1], 1000).ok());
+    ASSERT_TRUE(writer.append_rows(&rows[1001], num_rows - 1001).ok());
+    ASSERT_EQ(num_rows, writer.num_rows_written());
+    uint64_t file_size, index_size;
+    ASSERT_TRUE(writer.finalize(&file_size, &index_size).ok());
+    ASSERT_TRUE(wblock->close().ok());
+
+    std::shared_ptr<Segment> segment;
+    ASSERT_TRUE(Segment::open(filename, 0, &tablet_schema, &segment).ok());
+    ASSERT_EQ(num_rows, segment->num_rows());
+    OlapReaderStatistics stats;
+    StorageReadOptions read_opts;
+    read_opts.stats = &stats;
+    std::unique_ptr<RowwiseIterator> iter;
+    ASSERT_TRUE(segment->new_iterator(schema, read_opts, &iter).ok());
+    RowBlockV2 block(schema, 1024);
+    int rowid = 0;
+    while (rowid < num_rows) {
+        block.clear();
+        ASSERT_TRUE(iter->next_batch(&block).ok());
+        for (int i = 0; i < block.num_rows(); ++i, ++rowid) {
+            for (int cid = 0; cid < 3; ++cid) {
+                auto column_block = block.column_block(cid);
+                if (cid == 2 && rowid % 3 == 0) {
+                    ASSERT_TRUE(column_block.is_null(i));
+                } else {
+                    ASSERT_FALSE(column_block.is_null(i));
+                    ASSERT_EQ(rowid * 10 + cid, *(int*)column_block.cell_ptr(i));
+                }
+            }
+        }
+    }
+}
+
 TEST_F(SegmentReaderWriterTest, TestIndex) {
     TabletSchema tablet_schema = create_schema({create_int_key(1), create_int_key(2, true, true),
                                                 create_int_key(3), create_int_value(4)});
@@ -564,6 +994,72 @@ TEST_F(SegmentReaderWriterTest, TestIndex) {
             ASSERT_TRUE(iter->next_batch(&block).is_end_of_file());
             ASSERT_EQ(0, block.num_rows());
         }
+        // test delete predicate evaluated on blocks
+        {
+            // deletes the first 100 rows, part of the first page
+            TCondition delete_condition;
+            delete_condition.__set_column_name("1");
+            delete_condition.__set_condition_op("<");
+            std::vector<std::string> vals = {"1000"};
+            delete_condition.__set_condition_values(vals);
+            std::shared_ptr<Conditions> delete_conditions(new Conditions());
+            delete_conditions->set_tablet_schema(&tablet_schema);
+            ASSERT_EQ(OLAP_SUCCESS, delete_conditions->append_condition(delete_condition));
+
+            OlapReaderStatistics del_stats;
+            StorageReadOptions read_opts;
+            read_opts.stats = &del_stats;
+            read_opts.delete_conditions.push_back(delete_conditions.get());
+
+            std::unique_ptr<RowwiseIterator> iter;
+            segment->new_iterator(schema, read_opts, &iter);
+
+            RowBlockV2 block(schema, 1024);
+            int rows_read = 0;
+            while (true) {
+                block.clear();
+                auto st = iter->next_batch(&block);
+                if (st.is_end_of_file()) {
+                    break;
+                }
+                ASSERT_TRUE(st.ok());
+                ASSERT_EQ(DEL_NOT_SATISFIED, block.delete_state());
+                auto column_block = block.column_block(0);
+                for (int i = 0; i < block.selected_size(); ++i) {
+                    uint16_t idx = block.selection_vector()[i];
+                    ASSERT_GE(*(int*)column_block.cell_ptr(idx), 1000);
+                }
+                rows_read += block.selected_size();
+            }
+            ASSERT_EQ(64 * 1024 - 100, rows_read);
+            ASSERT_EQ(100, del_stats.rows_del_filtered);
+        }
+        // test segment pruned by delete predicate which deletes all rows
+        {
+            TCondition delete_condition;
+            delete_condition.__set_column_name("3");
+            delete_condition.__set_condition_op(">=");
+            std::vector<std::string> vals = {"0"};
+            delete_condition.__set_condition_values(vals);
+            std::shared_ptr<Conditions> delete_conditions(new Conditions());
+            delete_conditions->set_tablet_schema(&tablet_schema);
+            ASSERT_EQ(OLAP_SUCCESS, delete_conditions->append_condition(delete_condition));
+
+            StorageReadOptions read_opts;
+            read_opts.stats = &stats;
+            ASSERT_FALSE(segment->can_be_pruned(read_opts));
+            read_opts.delete_conditions.push_back(delete_conditions.get());
+            ASSERT_TRUE(segment->can_be_pruned(read_opts));
+
+            int64_t filtered_segment_number = stats.filtered_segment_number;
+            std::unique_ptr<RowwiseIterator> iter;
+            segment->new_iterator(schema, read_opts, &iter);
+            ASSERT_EQ(filtered_segment_number + 1, stats.filtered_segment_number);
+
+            RowBlockV2 block(schema, 1024);
+            ASSERT_TRUE(iter->next_batch(&block).is_end_of_file());
+            ASSERT_EQ(0, block.num_rows());
+        }
         // test bloom filter
         {
             StorageReadOptions read_opts;
@@ -1132,6 +1628,75 @@ TEST_F(SegmentReaderWriterTest, TestBitmapPredicate) {
             } while (st.ok());
             ASSERT_EQ(read_opts.stats->raw_rows_read, 4094);
         }
+
+        // test where v1 >= 100 and v1 <= 200, the range is served by the bitmap index
+        {
+            std::vector<ColumnPredicate*> column_predicates;
+            std::unique_ptr<ColumnPredicate> predicate(new GreaterEqualPredicate<int32_t>(0, 100));
+            std::unique_ptr<ColumnPredicate> predicate2(new LessEqualPredicate<int32_t>(0, 200));
+            column_predicates.emplace_back(predicate.get());
+            column_predicates.emplace_back(predicate2.get());
+
+            StorageReadOptions read_opts;
+            OlapReaderStatistics stats;
+            read_opts.column_predicates = &column_predicates;
+            read_opts.stats = &stats;
+
+            std::unique_ptr<RowwiseIterator> iter;
+            segment->new_iterator(schema, read_opts, &iter);
+
+            RowBlockV2 block(schema, 1024);
+            ASSERT_TRUE(iter->next_batch(&block).ok());
+            ASSERT_EQ(11, block.num_rows());
+            ASSERT_EQ(11, read_opts.stats->raw_rows_read);
+            ASSERT_EQ(4096 - 11, read_opts.stats->rows_bitmap_index_filtered);
+        }
+
+        // test where v1 > 100, the range is too wide to use the bitmap index
+        {
+            std::vector<ColumnPredicate*> column_predicates;
+            std::unique_ptr<ColumnPredicate> predicate(new GreaterPredicate<int32_t>(0, 100));
+            column_predicates.emplace_back(predicate.get());
+
+            StorageReadOptions read_opts;
+            OlapReaderStatistics stats;
+            read_opts.column_predicates = &column_predicates;
+            read_opts.stats = &stats;
+
+            std::unique_ptr<RowwiseIterator> iter;
+            segment->new_iterator(schema, read_opts, &iter);
+
+            RowBlockV2 block(schema, 1024);
+            int rows = 0;
+            Status st;
+            do {
+                block.clear();
+                st = iter->next_batch(&block);
+                rows += block.selected_size();
+            } while (st.ok());
+            ASSERT_EQ(4096 - 11, rows);
+            ASSERT_EQ(4096, read_opts.stats->raw_rows_read);
+            ASSERT_EQ(0, read_opts.stats->rows_bitmap_index_filtered);
+        }
+
+        // test where v1 > 40950, no value is in the range
+        {
+            std::vector<ColumnPredicate*> column_predicates;
+            std::unique_ptr<ColumnPredicate> predicate(new GreaterPredicate<int32_t>(0, 40950));
+            column_predicates.emplace_back(predicate.get());
+
+            StorageReadOptions read_opts;
+            OlapReaderStatistics stats;
+            read_opts.column_predicates = &column_predicates;
+            read_opts.stats = &stats;
+
+            std::unique_ptr<RowwiseIterator> iter;
+            segment->new_iterator(schema, read_opts, &iter);
+
+            RowBlockV2 block(schema, 1024);
+            ASSERT_TRUE(iter->next_batch(&block).is_end_of_file());
+            ASSERT_EQ(0, read_opts.stats->raw_rows_read);
+        }
     }
 }
 
@@ -1157,7 +1722,7 @@ TEST_F(SegmentReaderWriterTest, TestBloomFilterIndexUniqueModel) {
 } // namespace doris
 
 int main(int argc, char** argv) {
-    doris::StoragePageCache::create_global_cache(1 << 30);
+    doris::StoragePageCache::create_global_cache(1 << 30, 10);
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
 }
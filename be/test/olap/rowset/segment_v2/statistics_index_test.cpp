@@ -0,0 +1,122 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/rowset/segment_v2/statistics_index.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "olap/fs/block_manager.h"
+#include "olap/fs/fs_util.h"
+#include "olap/hll.h"
+#include "olap/page_cache.h"
+#include "olap/tablet_schema_helper.h"
+#include "util/file_utils.h"
+
+namespace doris {
+namespace segment_v2 {
+
+class StatisticsIndexTest : public testing::Test {
+public:
+    const std::string kTestDir = "./ut_dir/statistics_index_test";
+
+    void SetUp() override {
+        if (FileUtils::check_exist(kTestDir)) {
+            ASSERT_TRUE(FileUtils::remove_all(kTestDir).ok());
+        }
+        ASSERT_TRUE(FileUtils::create_dir(kTestDir).ok());
+    }
+    void TearDown() override {
+        if (FileUtils::check_exist(kTestDir)) {
+            ASSERT_TRUE(FileUtils::remove_all(kTestDir).ok());
+        }
+    }
+
+    void write_index(const std::string& filename, StatisticsIndexWriter* writer,
+                     ColumnIndexMetaPB* index_meta) {
+        std::unique_ptr<fs::WritableBlock> wblock;
+        fs::CreateBlockOptions opts({filename});
+        ASSERT_TRUE(fs::fs_util::block_manager()->create_block(opts, &wblock).ok());
+        ASSERT_TRUE(writer->finish(wblock.get(), index_meta).ok());
+        ASSERT_EQ(STATISTICS_INDEX, index_meta->type());
+        ASSERT_TRUE(wblock->close().ok());
+    }
+};
+
+TEST_F(StatisticsIndexTest, IntColumn) {
+    std::string filename = kTestDir + "/IntColumn";
+    TabletColumn int_column = create_int_key(0);
+    std::unique_ptr<Field> field(FieldFactory::create(int_column));
+
+    StatisticsIndexWriter writer(field.get());
+    std::vector<int32_t> values;
+    for (int32_t i = 0; i < 10000; ++i) {
+        values.push_back(i % 1000);
+    }
+    writer.add_values(values.data(), 3000);
+    writer.add_nulls(7);
+    writer.add_values(values.data() + 3000, values.size() - 3000);
+    writer.add_nulls(3);
+    ColumnIndexMetaPB index_meta;
+    write_index(filename, &writer, &index_meta);
+
+    StatisticsIndexReader reader(filename, &index_meta.statistics_index());
+    ASSERT_EQ(10, reader.null_count());
+    std::string ndv_sketch;
+    ASSERT_TRUE(reader.read_ndv_sketch(true, &ndv_sketch).ok());
+    Slice ndv_sketch_slice(ndv_sketch);
+    HyperLogLog hll(ndv_sketch_slice);
+    ASSERT_NEAR(1000, hll.estimate_cardinality(), 1000 * 0.05);
+}
+
+TEST_F(StatisticsIndexTest, MergeVarcharColumns) {
+    TabletColumn varchar_column = create_varchar_key(0);
+    std::unique_ptr<Field> field(FieldFactory::create(varchar_column));
+
+    // both segments have the values of [500, 1000)
+    HyperLogLog merged;
+    for (int segment = 0; segment < 2; ++segment) {
+        std::string filename = kTestDir + "/MergeVarcharColumns_" + std::to_string(segment);
+        StatisticsIndexWriter writer(field.get());
+        for (int i = segment * 500; i < segment * 500 + 1000; ++i) {
+            std::string value = "value_" + std::to_string(i);
+            Slice slice(value);
+            writer.add_values(&slice, 1);
+        }
+        ColumnIndexMetaPB index_meta;
+        write_index(filename, &writer, &index_meta);
+
+        StatisticsIndexReader reader(filename, &index_meta.statistics_index());
+        ASSERT_EQ(0, reader.null_count());
+        std::string ndv_sketch;
+        ASSERT_TRUE(reader.read_ndv_sketch(false, &ndv_sketch).ok());
+        merged.merge(Slice(ndv_sketch));
+    }
+    ASSERT_NEAR(1500, merged.estimate_cardinality(), 1500 * 0.05);
+}
+
+} // namespace segment_v2
+} // namespace doris
+
+int main(int argc, char** argv) {
+    doris::StoragePageCache::create_global_cache(1 << 30, 10);
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,115 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/s2_column_predicate.h"
+
+#include <gtest/gtest.h>
+
+#include "geo/geo_types.h"
+#include "olap/field.h"
+#include "olap/row_block2.h"
+#include "olap/schema.h"
+#include "olap/tablet_schema.h"
+#include "util/logging.h"
+
+namespace doris {
+
+class TestS2ColumnPredicate : public testing::Test {
+public:
+    void SetTabletSchema(TabletSchema* tablet_schema) {
+        TabletSchemaPB tablet_schema_pb;
+        ColumnPB* column = tablet_schema_pb.add_column();
+        column->set_unique_id(1);
+        column->set_name("LNG_COLUMN");
+        column->set_type("DOUBLE");
+        column->set_is_key(false);
+        column->set_is_nullable(true);
+        column->set_length(8);
+        column->set_aggregation("NONE");
+        tablet_schema->init_from_pb(tablet_schema_pb);
+    }
+
+    std::string encode_wkt(const std::string& wkt) {
+        GeoParseStatus status;
+        std::unique_ptr<GeoShape> shape(GeoShape::from_wkt(wkt.data(), wkt.size(), &status));
+        EXPECT_TRUE(shape != nullptr);
+        std::string buf;
+        shape->encode_to(&buf);
+        return buf;
+    }
+};
+
+TEST_F(TestS2ColumnPredicate, may_contain) {
+    S2ColumnPredicate pred(0, 2,
+                           encode_wkt("POLYGON ((116.35 39.85, 116.45 39.85, 116.45 39.95, "
+                                      "116.35 39.95, 116.35 39.85))"));
+    ASSERT_TRUE(pred.may_contain(116.40));
+    ASSERT_TRUE(pred.may_contain(116.35));
+    ASSERT_FALSE(pred.may_contain(116.30));
+    ASSERT_FALSE(pred.may_contain(-116.40));
+    ASSERT_FALSE(pred.may_contain(200));
+
+    // the bound of a polygon crossing the antimeridian wraps around
+    S2ColumnPredicate antimeridian(
+            0, 2, encode_wkt("POLYGON ((179 -1, -179 -1, -179 1, 179 1, 179 -1))"));
+    ASSERT_TRUE(antimeridian.may_contain(180));
+    ASSERT_TRUE(antimeridian.may_contain(-180));
+    ASSERT_TRUE(antimeridian.may_contain(179.5));
+    ASSERT_FALSE(antimeridian.may_contain(0));
+
+    // nothing is known of a shape which can't be decoded, but points out of range
+    S2ColumnPredicate invalid(0, 2, "invalid");
+    ASSERT_TRUE(invalid.may_contain(-30));
+    ASSERT_FALSE(invalid.may_contain(-181));
+}
+
+TEST_F(TestS2ColumnPredicate, evaluate_column_block) {
+    TabletSchema tablet_schema;
+    SetTabletSchema(&tablet_schema);
+    Schema schema(tablet_schema);
+    const int size = 5;
+    RowBlockV2 block(schema, size);
+    ColumnBlock column = block.column_block(0);
+    double values[size] = {116.40, 0, 121.47, 116.44, 116.0};
+    for (int i = 0; i < size; ++i) {
+        column.set_is_null(i, i == 1);
+        *reinterpret_cast<double*>(column.mutable_cell_ptr(i)) = values[i];
+    }
+
+    GeoCircle circle;
+    ASSERT_EQ(GEO_PARSE_OK, circle.init(116.40, 39.90, 10000));
+    std::string buf;
+    circle.encode_to(&buf);
+    S2ColumnPredicate pred(0, 2, buf);
+    uint16_t sel[size];
+    for (int i = 0; i < size; ++i) {
+        sel[i] = i;
+    }
+    uint16_t selected_size = size;
+    pred.evaluate(&column, sel, &selected_size);
+    ASSERT_EQ(2, selected_size);
+    ASSERT_EQ(0, sel[0]);
+    ASSERT_EQ(3, sel[1]);
+}
+
+} // namespace doris
+
+int main(int argc, char** argv) {
+    doris::init_glog("be-test");
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
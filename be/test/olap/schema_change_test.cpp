@@ -17,18 +17,35 @@
 #include "olap/schema_change.h"
 
 #include <gtest/gtest.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
+#include <map>
+
+#include "gen_cpp/AgentService_types.h"
+#include "gen_cpp/Descriptors_types.h"
 #include "olap/byte_buffer.h"
+#include "olap/delta_writer.h"
 #include "olap/field.h"
 #include "olap/olap_common.h"
 #include "olap/olap_define.h"
 #include "olap/row_block.h"
 #include "olap/row_cursor.h"
+#include "olap/rowset/beta_rowset.h"
 #include "olap/rowset/column_reader.h"
 #include "olap/rowset/column_writer.h"
+#include "olap/storage_engine.h"
 #include "olap/stream_name.h"
+#include "olap/tablet.h"
+#include "olap/task/engine_publish_version_task.h"
+#include "runtime/descriptor_helper.h"
+#include "runtime/descriptors.h"
+#include "runtime/exec_env.h"
 #include "runtime/mem_pool.h"
+#include "runtime/tuple.h"
 #include "runtime/vectorized_row_batch.h"
+#include "util/cpu_info.h"
+#include "util/file_utils.h"
 #include "util/logging.h"
 
 using std::string;
@@ -946,6 +963,231 @@ TEST_F(TestColumn, ConvertCharToCount) {
     auto dst = mv_row_cursor.cell_ptr(1);
     ASSERT_EQ(*(int64_t*)dst, 1);
 }
+
+static const int64_t kPartitionId = 32001;
+static const int32_t kBaseSchemaHash = 270068392;
+static const int32_t kNewSchemaHash = 270068393;
+
+// Schema changes of tablets with delete predicates, run by process_alter_tablet_v2()
+class SchemaChangeDeleteTest : public testing::Test {
+public:
+    static void SetUpTestCase() {
+        char buffer[1024];
+        getcwd(buffer, sizeof(buffer));
+        config::storage_root_path = std::string(buffer) + "/data_schema_change_test";
+        FileUtils::remove_all(config::storage_root_path);
+        FileUtils::create_dir(config::storage_root_path);
+        std::vector<StorePath> paths;
+        paths.emplace_back(config::storage_root_path, -1);
+
+        EngineOptions options;
+        options.store_paths = paths;
+        Status s = StorageEngine::open(options, &_s_engine);
+        ASSERT_TRUE(s.ok()) << s.to_string();
+        ExecEnv::GetInstance()->set_storage_engine(_s_engine);
+        _s_mem_tracker.reset(new MemTracker(-1, "schema change delete test"));
+    }
+
+    static void TearDownTestCase() {
+        if (_s_engine != nullptr) {
+            _s_engine->stop();
+            delete _s_engine;
+            _s_engine = nullptr;
+        }
+        FileUtils::remove_all(config::storage_root_path);
+    }
+
+    void TearDown() override {
+        for (auto& tablet : _tablets) {
+            _s_engine->tablet_manager()->drop_tablet(tablet.first, tablet.second);
+        }
+    }
+
+protected:
+    // (k1 int, v1 int) duplicate key (k1), and (v2 int) if 'with_v2' and (v1 int) if
+    // 'with_v1'. A tablet of 'base_tablet_id' is the base of a schema change.
+    TabletSharedPtr create_tablet(int64_t tablet_id, int32_t schema_hash, bool with_v1,
+                                  bool with_v2, int64_t base_tablet_id = 0) {
+        TCreateTabletReq request;
+        request.tablet_id = tablet_id;
+        request.__set_version(1);
+        request.__set_version_hash(0);
+        request.__set_storage_format(TStorageFormat::V2);
+        request.tablet_schema.schema_hash = schema_hash;
+        request.tablet_schema.short_key_column_count = 1;
+        request.tablet_schema.keys_type = TKeysType::DUP_KEYS;
+        request.tablet_schema.storage_type = TStorageType::COLUMN;
+        if (base_tablet_id > 0) {
+            request.__set_base_tablet_id(base_tablet_id);
+            request.__set_base_schema_hash(kBaseSchemaHash);
+        }
+
+        TColumn k1;
+        k1.column_name = "k1";
+        k1.__set_is_key(true);
+        k1.column_type.type = TPrimitiveType::INT;
+        request.tablet_schema.columns.push_back(k1);
+        for (auto& name : {"v1", "v2"}) {
+            if (name == std::string("v1") ? !with_v1 : !with_v2) {
+                continue;
+            }
+            TColumn v;
+            v.column_name = name;
+            v.__set_is_key(false);
+            v.__set_is_allow_null(true);
+            v.column_type.type = TPrimitiveType::INT;
+            v.__set_aggregation_type(TAggregationType::NONE);
+            request.tablet_schema.columns.push_back(v);
+        }
+
+        EXPECT_EQ(OLAP_SUCCESS, _s_engine->create_tablet(request));
+        _tablets.emplace_back(tablet_id, schema_hash);
+        return _s_engine->tablet_manager()->get_tablet(tablet_id, schema_hash);
+    }
+
+    // Load the rows (k, k * 10) of the keys in [begin, end) into the base tablet by txn
+    // 'txn_id' and publish them as 'version'. If 'delete_predicate' is given, the rowset is empty and deletes by it.
+    void load(const TabletSharedPtr& tablet, int64_t txn_id, int64_t version, int32_t begin,
+              int32_t end, const std::string& delete_predicate = "") {
+        TDescriptorTableBuilder dtb;
+        TTupleDescriptorBuilder tuple_builder;
+        tuple_builder.add_slot(
+                TSlotDescriptorBuilder().type(TYPE_INT).column_name("k1").column_pos(0).build());
+        tuple_builder.add_slot(
+                TSlotDescriptorBuilder().type(TYPE_INT).column_name("v1").column_pos(1).build());
+        tuple_builder.build(&dtb);
+        ObjectPool obj_pool;
+        DescriptorTbl* desc_tbl = nullptr;
+        DescriptorTbl::create(&obj_pool, dtb.desc_tbl(), &desc_tbl);
+        TupleDescriptor* tuple_desc = desc_tbl->get_tuple_descriptor(0);
+        const std::vector<SlotDescriptor*>& slots = tuple_desc->slots();
+
+        PUniqueId load_id;
+        load_id.set_hi(tablet->tablet_id());
+        load_id.set_lo(txn_id);
+        WriteRequest write_req = {tablet->tablet_id(), kBaseSchemaHash, WriteType::LOAD,
+                                  txn_id,              kPartitionId,    load_id,
+                                  false,               tuple_desc,      &slots};
+        DeltaWriter* delta_writer = nullptr;
+        DeltaWriter::open(&write_req, _s_mem_tracker, &delta_writer);
+        ASSERT_NE(nullptr, delta_writer);
+        std::unique_ptr<DeltaWriter> delta_writer_guard(delta_writer);
+
+        MemTracker tracker;
+        MemPool pool(&tracker);
+        for (int32_t k = begin; k < end; ++k) {
+            Tuple* tuple = reinterpret_cast<Tuple*>(pool.allocate(tuple_desc->byte_size()));
+            memset(tuple, 0, tuple_desc->byte_size());
+            *(int32_t*)(tuple->get_slot(slots[0]->tuple_offset())) = k;
+            *(int32_t*)(tuple->get_slot(slots[1]->tuple_offset())) = k * 10;
+            ASSERT_EQ(OLAP_SUCCESS, delta_writer->write(tuple));
+        }
+        ASSERT_EQ(OLAP_SUCCESS, delta_writer->close());
+        ASSERT_EQ(OLAP_SUCCESS, delta_writer->close_wait(nullptr));
+
+        if (!delete_predicate.empty()) {
+            std::map<TabletInfo, RowsetSharedPtr> tablet_related_rs;
+            _s_engine->txn_manager()->get_txn_related_tablets(txn_id, kPartitionId,
+                                                              &tablet_related_rs);
+            ASSERT_EQ(1, tablet_related_rs.size());
+            DeletePredicatePB predicate;
+            predicate.set_version(-1);
+            predicate.add_sub_predicates(delete_predicate);
+            tablet_related_rs.begin()->second->rowset_meta()->set_delete_predicate(predicate);
+        }
+
+        TPublishVersionRequest req;
+        TPartitionVersionInfo par_ver_info;
+        par_ver_info.partition_id = kPartitionId;
+        par_ver_info.version = version;
+        par_ver_info.version_hash = 0;
+        req.transaction_id = txn_id;
+        req.partition_version_infos.push_back(par_ver_info);
+        std::vector<TTabletId> error_tablet_ids;
+        EnginePublishVersionTask task(req, &error_tablet_ids);
+        ASSERT_EQ(OLAP_SUCCESS, _s_engine->execute_task(&task));
+    }
+
+    // Alter 'base' to 'new_tablet' up to version 4
+    void alter(const TabletSharedPtr& base, const TabletSharedPtr& new_tablet) {
+        TAlterTabletReqV2 request;
+        request.base_tablet_id = base->tablet_id();
+        request.base_schema_hash = kBaseSchemaHash;
+        request.new_tablet_id = new_tablet->tablet_id();
+        request.new_schema_hash = kNewSchemaHash;
+        request.__set_alter_version(4);
+        request.__set_alter_version_hash(0);
+        SchemaChangeHandler handler;
+        ASSERT_EQ(OLAP_SUCCESS, handler.process_alter_tablet_v2(request));
+    }
+
+    // Whether the segment of version 2 of 'new_tablet' is a link to that of 'base'
+    static bool linked(const TabletSharedPtr& base, const TabletSharedPtr& new_tablet) {
+        RowsetSharedPtr base_rowset = base->get_rowset_by_version({2, 2});
+        RowsetSharedPtr new_rowset = new_tablet->get_rowset_by_version({2, 2});
+        EXPECT_NE(nullptr, new_rowset);
+        if (new_rowset == nullptr) {
+            return false;
+        }
+        struct stat base_stat;
+        struct stat new_stat;
+        EXPECT_EQ(0, stat(BetaRowset::segment_file_path(base->tablet_path(),
+                                                         base_rowset->rowset_id(), 0)
+                                  .c_str(),
+                          &base_stat));
+        EXPECT_EQ(0, stat(BetaRowset::segment_file_path(new_tablet->tablet_path(),
+                                                         new_rowset->rowset_id(), 0)
+                                  .c_str(),
+                          &new_stat));
+        return base_stat.st_ino == new_stat.st_ino;
+    }
+
+    static StorageEngine* _s_engine;
+    static std::shared_ptr<MemTracker> _s_mem_tracker;
+    std::vector<std::pair<int64_t, int32_t>> _tablets;
+};
+
+StorageEngine* SchemaChangeDeleteTest::_s_engine = nullptr;
+std::shared_ptr<MemTracker> SchemaChangeDeleteTest::_s_mem_tracker = nullptr;
+
+TEST_F(SchemaChangeDeleteTest, link_with_delete_predicate) {
+    TabletSharedPtr base = create_tablet(17001, kBaseSchemaHash, true, false);
+    ASSERT_NE(nullptr, base);
+    load(base, 22001, 2, 0, 10);
+    load(base, 22002, 3, 0, 0, "k1>=5");
+    load(base, 22003, 4, 10, 20);
+    // the added column doesn't affect the predicate
+    TabletSharedPtr new_tablet = create_tablet(17002, kNewSchemaHash, true, true, 17001);
+    ASSERT_NE(nullptr, new_tablet);
+    alter(base, new_tablet);
+
+    // the rowsets are linked, the rows deleted by version 3 are still in version 2
+    ASSERT_TRUE(linked(base, new_tablet));
+    ASSERT_EQ(10, new_tablet->get_rowset_by_version({2, 2})->num_rows());
+    RowsetSharedPtr delete_rowset = new_tablet->get_rowset_by_version({3, 3});
+    ASSERT_NE(nullptr, delete_rowset);
+    ASSERT_TRUE(delete_rowset->rowset_meta()->has_delete_predicate());
+    ASSERT_EQ(3, delete_rowset->rowset_meta()->delete_predicate().version());
+    ASSERT_EQ(1, new_tablet->delete_predicates().size());
+}
+
+TEST_F(SchemaChangeDeleteTest, rewrite_with_delete_predicate_of_dropped_column) {
+    TabletSharedPtr base = create_tablet(17003, kBaseSchemaHash, true, false);
+    ASSERT_NE(nullptr, base);
+    load(base, 22004, 2, 0, 10);
+    load(base, 22005, 3, 0, 0, "v1>=50");
+    load(base, 22006, 4, 10, 20);
+    // v1 is dropped, so the predicate can't be kept
+    TabletSharedPtr new_tablet = create_tablet(17004, kNewSchemaHash, false, true, 17003);
+    ASSERT_NE(nullptr, new_tablet);
+    alter(base, new_tablet);
+
+    // the rows deleted by version 3 are dropped from version 2 by the rewrite
+    ASSERT_FALSE(linked(base, new_tablet));
+    ASSERT_EQ(5, new_tablet->get_rowset_by_version({2, 2})->num_rows());
+    ASSERT_EQ(0, new_tablet->delete_predicates().size());
+}
+
 } // namespace doris
 
 int main(int argc, char** argv) {
@@ -955,6 +1197,7 @@ int main(int argc, char** argv) {
         return -1;
     }
     doris::init_glog("be-test");
+    doris::CpuInfo::init();
     int ret = doris::OLAP_SUCCESS;
     testing::InitGoogleTest(&argc, argv);
     ret = RUN_ALL_TESTS();
@@ -0,0 +1,45 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/segment_cache.h"
+
+#include <gtest/gtest.h>
+
+namespace doris {
+
+class SegmentCacheTest : public testing::Test {};
+
+TEST_F(SegmentCacheTest, normal) {
+    SegmentCache cache(1024 * 1024);
+    SegmentCache::Segments segments;
+    ASSERT_FALSE(cache.lookup("/path/rowset1", &segments));
+
+    cache.insert("/path/rowset1", segments);
+    ASSERT_TRUE(cache.lookup("/path/rowset1", &segments));
+    ASSERT_TRUE(segments.empty());
+    ASSERT_FALSE(cache.lookup("/other_path/rowset1", &segments));
+
+    cache.erase("/path/rowset1");
+    ASSERT_FALSE(cache.lookup("/path/rowset1", &segments));
+}
+
+} // namespace doris
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
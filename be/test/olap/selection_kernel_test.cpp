@@ -0,0 +1,124 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/selection_kernel.h"
+
+#include <gtest/gtest.h>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "util/cpu_info.h"
+
+namespace doris {
+
+class SelectionKernelTest : public testing::Test {
+public:
+    SelectionKernelTest() {}
+    virtual ~SelectionKernelTest() {}
+};
+
+// the obvious scalar loop the kernels must agree with
+template <class T, class Op>
+static std::vector<uint16_t> expected_selection(const std::vector<T>& data,
+                                                const std::vector<bool>& is_null, T value) {
+    Op op;
+    std::vector<uint16_t> sel;
+    for (uint16_t i = 0; i < data.size(); ++i) {
+        if (!is_null[i] && op(data[i], value)) {
+            sel.push_back(i);
+        }
+    }
+    return sel;
+}
+
+template <class T, class Op>
+static void check_dense(uint16_t size, bool nullable) {
+    std::vector<T> data(size);
+    std::vector<bool> is_null(size, false);
+    std::unique_ptr<bool[]> null_signs(new bool[size]);
+    for (uint16_t i = 0; i < size; ++i) {
+        // runs of selected and filtered rows, mixed with scattered ones
+        data[i] = static_cast<T>((i / 16) % 2 == 0 ? i % 7 : 100);
+        is_null[i] = nullable && (i % 5 == 0);
+        null_signs[i] = is_null[i];
+    }
+    T value = 3;
+    std::vector<uint16_t> expected = expected_selection<T, Op>(data, is_null, value);
+
+    std::vector<uint16_t> sel(size);
+    uint16_t new_size = selection_kernel::evaluate_dense<T, Op>(
+            data.data(), nullable ? null_signs.get() : nullptr, size, value, sel.data());
+    ASSERT_EQ(expected.size(), new_size);
+    for (uint16_t i = 0; i < new_size; ++i) {
+        ASSERT_EQ(expected[i], sel[i]);
+    }
+}
+
+TEST_F(SelectionKernelTest, is_dense) {
+    uint16_t sel[] = {0, 1, 2, 3};
+    ASSERT_TRUE(selection_kernel::is_dense(sel, 4));
+    ASSERT_FALSE(selection_kernel::is_dense(sel, 0));
+    uint16_t sparse[] = {0, 2, 3, 5};
+    ASSERT_FALSE(selection_kernel::is_dense(sparse, 4));
+}
+
+TEST_F(SelectionKernelTest, mask_to_selection) {
+    uint8_t mask[19] = {1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1};
+    uint16_t sel[19];
+    uint16_t size = selection_kernel::mask_to_selection(mask, 19, 100, sel);
+    ASSERT_EQ(10, size);
+    for (uint16_t i = 0; i < 8; ++i) {
+        ASSERT_EQ(100 + i, sel[i]);
+    }
+    ASSERT_EQ(117, sel[8]);
+    ASSERT_EQ(118, sel[9]);
+}
+
+TEST_F(SelectionKernelTest, evaluate_dense) {
+    for (uint16_t size : {1, 7, 8, 1000, 1024, 3000}) {
+        for (bool nullable : {false, true}) {
+            check_dense<int8_t, std::equal_to<int8_t>>(size, nullable);
+            check_dense<int16_t, std::not_equal_to<int16_t>>(size, nullable);
+            check_dense<int32_t, std::less<int32_t>>(size, nullable);
+            check_dense<int64_t, std::less_equal<int64_t>>(size, nullable);
+            check_dense<uint64_t, std::greater<uint64_t>>(size, nullable);
+            check_dense<double, std::greater_equal<double>>(size, nullable);
+        }
+    }
+}
+
+TEST_F(SelectionKernelTest, evaluate_dense_without_avx2) {
+    CpuInfo::TempDisable disable_avx2(CpuInfo::AVX2);
+    check_dense<int32_t, std::less<int32_t>>(1024, true);
+    check_dense<float, std::equal_to<float>>(1500, false);
+}
+
+TEST_F(SelectionKernelTest, evaluate_dense_without_avx512) {
+    CpuInfo::TempDisable disable_avx512(CpuInfo::AVX512F);
+    check_dense<int16_t, std::greater<int16_t>>(1024, true);
+    check_dense<double, std::not_equal_to<double>>(1500, false);
+}
+
+} // namespace doris
+
+int main(int argc, char** argv) {
+    doris::CpuInfo::init();
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -19,6 +19,8 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+
 #include "olap/row_cursor.h"
 #include "olap/tablet_schema_helper.h"
 #include "util/debug_util.h"
@@ -93,6 +95,46 @@ TEST_F(ShortKeyIndexTest, builder) {
     }
 }
 
+TEST_F(ShortKeyIndexTest, long_keys) {
+    // keys longer than the prefixes, sharing the prefixes, and being prefixes of others
+    std::vector<std::string> keys;
+    std::string long_prefix(40, 'a');
+    for (int i = 100; i < 400; i += 3) {
+        keys.push_back(long_prefix + std::to_string(i));
+        keys.push_back(std::string(1, 'b') + std::to_string(i));
+        keys.push_back(std::string(1, 'b') + std::to_string(i) + std::string(1, '\0'));
+    }
+    std::sort(keys.begin(), keys.end());
+    ShortKeyIndexBuilder builder(0, 1024, 3);
+    for (auto& key : keys) {
+        builder.add_item(key);
+    }
+    std::vector<Slice> slices;
+    segment_v2::PageFooterPB footer;
+    ASSERT_TRUE(builder.finalize(keys.size() * 1024, &slices, &footer).ok());
+    ASSERT_EQ(3, footer.short_key_page_footer().num_key_columns());
+    std::string buf;
+    for (auto& slice : slices) {
+        buf.append(slice.data, slice.size);
+    }
+    ShortKeyIndexDecoder decoder;
+    ASSERT_TRUE(decoder.parse(buf, footer.short_key_page_footer()).ok());
+    ASSERT_EQ(3, decoder.num_key_columns());
+
+    std::vector<std::string> targets = {"", "a", long_prefix, "b", "b10", "b100"};
+    for (int i = 99; i < 401; ++i) {
+        targets.push_back(long_prefix + std::to_string(i));
+        targets.push_back(std::string(1, 'b') + std::to_string(i));
+        targets.push_back(std::string(1, 'b') + std::to_string(i) + std::string(1, '\0'));
+    }
+    for (auto& target : targets) {
+        auto expected = std::lower_bound(keys.begin(), keys.end(), target) - keys.begin();
+        ASSERT_EQ(expected, decoder.lower_bound(target).ordinal()) << target;
+        expected = std::upper_bound(keys.begin(), keys.end(), target) - keys.begin();
+        ASSERT_EQ(expected, decoder.upper_bound(target).ordinal()) << target;
+    }
+}
+
 TEST_F(ShortKeyIndexTest, encode) {
     TabletSchema tablet_schema;
     tablet_schema._cols.push_back(create_int_key(0));
@@ -180,6 +180,47 @@ TEST_F(SkipTest, InsertWithHintNoneDupModel) {
     }
 }
 
+TEST_F(SkipTest, FindAtTail) {
+    std::shared_ptr<MemTracker> tracker(new MemTracker(-1));
+    std::unique_ptr<MemPool> mem_pool(new MemPool(tracker.get()));
+
+    TestComparator cmp;
+    SkipList<Key, TestComparator> list(cmp, mem_pool.get(), false);
+    SkipList<Key, TestComparator>::Hint hint;
+    bool is_exist = false;
+    // ascending keys with duplicates are appended without searching
+    for (Key key = 0; key < 2000; key++) {
+        ASSERT_TRUE(list.FindAtTail(key / 2, &hint, &is_exist));
+        ASSERT_EQ(key % 2 == 1, is_exist);
+        if (!is_exist) {
+            list.InsertWithHint(key / 2, is_exist, &hint);
+        }
+    }
+    ASSERT_FALSE(list.FindAtTail(500, &hint, &is_exist));
+
+    // the tail is kept by the searching inserts as well
+    bool overwritten = false;
+    list.Insert(5000, &overwritten);
+    list.Insert(2500, &overwritten);
+    ASSERT_FALSE(list.FindAtTail(4999, &hint, &is_exist));
+    ASSERT_TRUE(list.FindAtTail(5001, &hint, &is_exist));
+    list.InsertWithHint(5001, is_exist, &hint);
+
+    SkipList<Key, TestComparator>::Iterator iter(&list);
+    iter.SeekToFirst();
+    for (Key key = 0; key < 1000; key++) {
+        ASSERT_TRUE(iter.Valid());
+        ASSERT_EQ(key, iter.key());
+        iter.Next();
+    }
+    for (Key key : {2500, 5000, 5001}) {
+        ASSERT_TRUE(iter.Valid());
+        ASSERT_EQ(key, iter.key());
+        iter.Next();
+    }
+    ASSERT_FALSE(iter.Valid());
+}
+
 // We want to make sure that with a single writer and multiple
 // concurrent readers (with no synchronization other than when a
 // reader's iterator is created), the reader always observes all the
@@ -0,0 +1,88 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/tablet_column_statistics.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "olap/tablet_schema_helper.h"
+
+namespace doris {
+
+class TabletColumnStatisticsTest : public testing::Test {
+public:
+    void add_page(int32_t min, int32_t max, uint32_t num_rows) {
+        TabletColumnStatisticsCollector::PageRange page;
+        page.min.reset(WrapperField::create(_column));
+        page.max.reset(WrapperField::create(_column));
+        ASSERT_EQ(OLAP_SUCCESS, page.min->from_string(std::to_string(min)));
+        ASSERT_EQ(OLAP_SUCCESS, page.max->from_string(std::to_string(max)));
+        page.num_rows = num_rows;
+        _pages.push_back(std::move(page));
+    }
+
+protected:
+    TabletColumn _column = create_int_key(0);
+    std::vector<TabletColumnStatisticsCollector::PageRange> _pages;
+};
+
+TEST_F(TabletColumnStatisticsTest, EquiHeightBuckets) {
+    // pages of two segments, which are merged in the order of values
+    for (int32_t i = 0; i < 10; ++i) {
+        add_page(i * 100, i * 100 + 99, 1000);
+    }
+    for (int32_t i = 9; i >= 0; --i) {
+        add_page(i * 100 + 50, i * 100 + 149, 1000);
+    }
+    std::vector<THistogramBucket> histogram;
+    TabletColumnStatisticsCollector::build_histogram(&_pages, 5, &histogram);
+    ASSERT_EQ(5, histogram.size());
+    // the pages of a bucket overlap the ones of the next bucket
+    for (int i = 0; i < 5; ++i) {
+        ASSERT_EQ(std::to_string(i * 200), histogram[i].lower) << i;
+        ASSERT_EQ(std::to_string(i * 200 + 249), histogram[i].upper) << i;
+        ASSERT_EQ(4000, histogram[i].count) << i;
+    }
+}
+
+TEST_F(TabletColumnStatisticsTest, FewerPagesThanBuckets) {
+    add_page(-5, 5, 10);
+    add_page(-20, -10, 30);
+    std::vector<THistogramBucket> histogram;
+    TabletColumnStatisticsCollector::build_histogram(&_pages, 64, &histogram);
+    ASSERT_EQ(2, histogram.size());
+    ASSERT_EQ("-20", histogram[0].lower);
+    ASSERT_EQ("-10", histogram[0].upper);
+    ASSERT_EQ(30, histogram[0].count);
+    ASSERT_EQ("-5", histogram[1].lower);
+    ASSERT_EQ("5", histogram[1].upper);
+    ASSERT_EQ(10, histogram[1].count);
+
+    _pages.clear();
+    TabletColumnStatisticsCollector::build_histogram(&_pages, 64, &histogram);
+    ASSERT_TRUE(histogram.empty());
+}
+
+} // namespace doris
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,445 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gen_cpp/AgentService_types.h"
+#include "gen_cpp/Descriptors_types.h"
+#include "olap/delta_writer.h"
+#include "olap/iterators.h"
+#include "olap/row_block2.h"
+#include "olap/rowset/beta_rowset.h"
+#include "olap/schema.h"
+#include "olap/storage_engine.h"
+#include "olap/tablet.h"
+#include "olap/task/engine_publish_version_task.h"
+#include "runtime/descriptor_helper.h"
+#include "runtime/descriptors.h"
+#include "runtime/exec_env.h"
+#include "runtime/mem_pool.h"
+#include "runtime/mem_tracker.h"
+#include "runtime/tuple.h"
+#include "util/cpu_info.h"
+#include "util/file_utils.h"
+
+namespace doris {
+
+static const uint32_t MAX_PATH_LEN = 1024;
+static const int64_t kPartitionId = 30001;
+static const int32_t kSchemaHash = 270068390;
+
+static StorageEngine* k_engine = nullptr;
+static std::shared_ptr<MemTracker> k_mem_tracker = nullptr;
+
+using Rows = std::vector<std::pair<int32_t, int32_t>>;
+
+static void set_up() {
+    char buffer[MAX_PATH_LEN];
+    getcwd(buffer, MAX_PATH_LEN);
+    config::storage_root_path = std::string(buffer) + "/data_tablet_delete_bitmap_test";
+    FileUtils::remove_all(config::storage_root_path);
+    FileUtils::create_dir(config::storage_root_path);
+    std::vector<StorePath> paths;
+    paths.emplace_back(config::storage_root_path, -1);
+
+    EngineOptions options;
+    options.store_paths = paths;
+    Status s = StorageEngine::open(options, &k_engine);
+    ASSERT_TRUE(s.ok()) << s.to_string();
+    ExecEnv::GetInstance()->set_storage_engine(k_engine);
+    k_mem_tracker.reset(new MemTracker(-1, "tablet delete bitmap test"));
+}
+
+static void tear_down() {
+    if (k_engine != nullptr) {
+        k_engine->stop();
+        delete k_engine;
+        k_engine = nullptr;
+    }
+    FileUtils::remove_all(config::storage_root_path);
+}
+
+class TabletDeleteBitmapTest : public testing::Test {
+protected:
+    // (k1 int, v1 int) unique key (k1)
+    TabletSharedPtr create_tablet(int64_t tablet_id, bool merge_on_write = true) {
+        TCreateTabletReq request;
+        request.tablet_id = tablet_id;
+        request.__set_version(1);
+        request.__set_version_hash(0);
+        request.__set_storage_format(TStorageFormat::V2);
+        request.tablet_schema.schema_hash = kSchemaHash;
+        request.tablet_schema.short_key_column_count = 1;
+        request.tablet_schema.keys_type = TKeysType::UNIQUE_KEYS;
+        request.tablet_schema.storage_type = TStorageType::COLUMN;
+        request.tablet_schema.__set_enable_unique_key_merge_on_write(merge_on_write);
+
+        TColumn k1;
+        k1.column_name = "k1";
+        k1.__set_is_key(true);
+        k1.column_type.type = TPrimitiveType::INT;
+        request.tablet_schema.columns.push_back(k1);
+
+        TColumn v1;
+        v1.column_name = "v1";
+        v1.__set_is_key(false);
+        v1.column_type.type = TPrimitiveType::INT;
+        v1.__set_aggregation_type(TAggregationType::REPLACE);
+        request.tablet_schema.columns.push_back(v1);
+
+        EXPECT_EQ(OLAP_SUCCESS, k_engine->create_tablet(request));
+        _tablet_ids.push_back(tablet_id);
+        return k_engine->tablet_manager()->get_tablet(tablet_id, kSchemaHash);
+    }
+
+    void TearDown() override {
+        for (int64_t tablet_id : _tablet_ids) {
+            k_engine->tablet_manager()->drop_tablet(tablet_id, kSchemaHash);
+        }
+    }
+
+    // Load `rows` into the tablet by txn `txn_id` of kPartitionId, not published
+    void write_rows(const TabletSharedPtr& tablet, int64_t txn_id, const Rows& rows) {
+        TDescriptorTableBuilder dtb;
+        TTupleDescriptorBuilder tuple_builder;
+        tuple_builder.add_slot(
+                TSlotDescriptorBuilder().type(TYPE_INT).column_name("k1").column_pos(0).build());
+        tuple_builder.add_slot(
+                TSlotDescriptorBuilder().type(TYPE_INT).column_name("v1").column_pos(1).build());
+        tuple_builder.build(&dtb);
+        ObjectPool obj_pool;
+        DescriptorTbl* desc_tbl = nullptr;
+        DescriptorTbl::create(&obj_pool, dtb.desc_tbl(), &desc_tbl);
+        TupleDescriptor* tuple_desc = desc_tbl->get_tuple_descriptor(0);
+        const std::vector<SlotDescriptor*>& slots = tuple_desc->slots();
+
+        PUniqueId load_id;
+        load_id.set_hi(tablet->tablet_id());
+        load_id.set_lo(txn_id);
+        WriteRequest write_req = {tablet->tablet_id(), kSchemaHash, WriteType::LOAD,
+                                  txn_id,              kPartitionId, load_id,
+                                  false,               tuple_desc,   &slots};
+        DeltaWriter* delta_writer = nullptr;
+        DeltaWriter::open(&write_req, k_mem_tracker, &delta_writer);
+        ASSERT_NE(nullptr, delta_writer);
+        std::unique_ptr<DeltaWriter> delta_writer_guard(delta_writer);
+
+        MemTracker tracker;
+        MemPool pool(&tracker);
+        for (auto& row : rows) {
+            Tuple* tuple = reinterpret_cast<Tuple*>(pool.allocate(tuple_desc->byte_size()));
+            memset(tuple, 0, tuple_desc->byte_size());
+            *(int32_t*)(tuple->get_slot(slots[0]->tuple_offset())) = row.first;
+            *(int32_t*)(tuple->get_slot(slots[1]->tuple_offset())) = row.second;
+            ASSERT_EQ(OLAP_SUCCESS, delta_writer->write(tuple));
+        }
+        ASSERT_EQ(OLAP_SUCCESS, delta_writer->close());
+        ASSERT_EQ(OLAP_SUCCESS, delta_writer->close_wait(nullptr));
+    }
+
+    // Write an empty rowset by txn `txn_id` which deletes the rows of k1 >= `min_key` by
+    // bitmap
+    void write_delete(const TabletSharedPtr& tablet, int64_t txn_id, int32_t min_key) {
+        write_rows(tablet, txn_id, {});
+        std::map<TabletInfo, RowsetSharedPtr> tablet_related_rs;
+        k_engine->txn_manager()->get_txn_related_tablets(txn_id, kPartitionId,
+                                                         &tablet_related_rs);
+        ASSERT_EQ(1, tablet_related_rs.size());
+        RowsetMetaSharedPtr rs_meta = tablet_related_rs.begin()->second->rowset_meta();
+        rs_meta->set_delete_predicate(delete_predicate(min_key, -1));
+    }
+
+    static DeletePredicatePB delete_predicate(int32_t min_key, int64_t version) {
+        DeletePredicatePB delete_predicate;
+        delete_predicate.set_version(version);
+        delete_predicate.add_sub_predicates("k1>=" + std::to_string(min_key));
+        delete_predicate.set_by_bitmap(true);
+        return delete_predicate;
+    }
+
+    // Publish the txns of kPartitionId as the versions in one batch
+    std::vector<OLAPStatus> publish(const std::vector<std::pair<int64_t, int64_t>>& txn_versions) {
+        std::vector<TPublishVersionRequest> reqs(txn_versions.size());
+        std::vector<std::vector<TTabletId>> error_tablet_ids(txn_versions.size());
+        std::vector<const TPublishVersionRequest*> req_ptrs;
+        std::vector<std::vector<TTabletId>*> error_tablet_id_ptrs;
+        for (size_t i = 0; i < txn_versions.size(); ++i) {
+            TPartitionVersionInfo par_ver_info;
+            par_ver_info.partition_id = kPartitionId;
+            par_ver_info.version = txn_versions[i].second;
+            par_ver_info.version_hash = 0;
+            reqs[i].transaction_id = txn_versions[i].first;
+            reqs[i].partition_version_infos.push_back(par_ver_info);
+            req_ptrs.push_back(&reqs[i]);
+            error_tablet_id_ptrs.push_back(&error_tablet_ids[i]);
+        }
+        EnginePublishVersionTask task(req_ptrs, error_tablet_id_ptrs);
+        OLAPStatus res = k_engine->execute_task(&task);
+        if (task.results().empty()) {
+            return std::vector<OLAPStatus>(txn_versions.size(), res);
+        }
+        return task.results();
+    }
+
+    // Load `rows` and publish them as `version`
+    void load(const TabletSharedPtr& tablet, int64_t txn_id, int64_t version, const Rows& rows) {
+        write_rows(tablet, txn_id, rows);
+        ASSERT_EQ(std::vector<OLAPStatus>({OLAP_SUCCESS}), publish({{txn_id, version}}));
+    }
+
+    // The rows of the tablet at `version` which are not deleted, ordered by key. A key
+    // replaced but not marked in the delete bitmap is returned more than once.
+    Rows read_rows(const TabletSharedPtr& tablet, int64_t version) {
+        std::vector<RowsetSharedPtr> rowsets;
+        {
+            ReadLock rdlock(tablet->get_header_lock_ptr());
+            EXPECT_EQ(OLAP_SUCCESS,
+                      tablet->capture_consistent_rowsets(Version(0, version), &rowsets));
+        }
+        Schema schema(tablet->tablet_schema());
+        RowBlockV2 block(schema, 1024);
+        Rows rows;
+        for (auto& rowset : rowsets) {
+            std::vector<segment_v2::SegmentSharedPtr> segments;
+            EXPECT_EQ(OLAP_SUCCESS,
+                      std::static_pointer_cast<BetaRowset>(rowset)->load_segments(&segments));
+            for (auto& segment : segments) {
+                OlapReaderStatistics stats;
+                StorageReadOptions opts;
+                opts.stats = &stats;
+                opts.delete_bitmap = &tablet->tablet_meta()->delete_bitmap();
+                opts.rowset_id = rowset->rowset_id();
+                opts.delete_bitmap_version = version;
+                std::unique_ptr<RowwiseIterator> iter;
+                EXPECT_TRUE(segment->new_iterator(schema, opts, &iter).ok());
+                while (true) {
+                    block.clear();
+                    Status st = iter->next_batch(&block);
+                    if (st.is_end_of_file()) {
+                        break;
+                    }
+                    EXPECT_TRUE(st.ok()) << st.to_string();
+                    for (uint16_t i = 0; i < block.selected_size(); ++i) {
+                        RowBlockRow row = block.row(block.selection_vector()[i]);
+                        rows.emplace_back(*(const int32_t*)row.cell_ptr(0),
+                                          *(const int32_t*)row.cell_ptr(1));
+                    }
+                }
+            }
+        }
+        std::sort(rows.begin(), rows.end());
+        return rows;
+    }
+
+    // Link the files of `rowset` of another tablet into `tablet` as a new rowset, as a clone
+    // downloads them. The rowset ids of `src_delete_bitmap` are converted to the new ones in
+    // `delete_bitmap` if it's given.
+    RowsetMetaSharedPtr link_rowset(const TabletSharedPtr& tablet, const RowsetSharedPtr& rowset,
+                                    const DeleteBitmap& src_delete_bitmap,
+                                    DeleteBitmap* delete_bitmap) {
+        RowsetId rowset_id = k_engine->next_rowset_id();
+        EXPECT_EQ(OLAP_SUCCESS, rowset->link_files_to(tablet->tablet_path(), rowset_id));
+        RowsetMetaPB rs_meta_pb;
+        rowset->rowset_meta()->to_rowset_pb(&rs_meta_pb);
+        RowsetMetaSharedPtr rs_meta(new RowsetMeta());
+        rs_meta->init_from_pb(rs_meta_pb);
+        rs_meta->set_rowset_id(rowset_id);
+        rs_meta->set_tablet_id(tablet->tablet_id());
+        rs_meta->set_tablet_uid(tablet->tablet_uid());
+        if (delete_bitmap != nullptr) {
+            DeleteBitmapPB delete_bitmap_pb;
+            src_delete_bitmap.to_pb(&delete_bitmap_pb);
+            for (int i = 0; i < delete_bitmap_pb.rowset_ids_size(); ++i) {
+                if (delete_bitmap_pb.rowset_ids(i) == rowset->rowset_id().to_string()) {
+                    delete_bitmap_pb.set_rowset_ids(i, rowset_id.to_string());
+                }
+            }
+            DeleteBitmap converted;
+            converted.init_from_pb(delete_bitmap_pb);
+            delete_bitmap->merge(converted, rowset_id);
+        }
+        return rs_meta;
+    }
+
+    // Clone `rs_metas` into `tablet` as EngineCloneTask does
+    OLAPStatus clone(const TabletSharedPtr& tablet,
+                     const std::vector<RowsetMetaSharedPtr>& rs_metas,
+                     const DeleteBitmap* cloned_delete_bitmap) {
+        std::lock_guard<std::mutex> update_lock(*tablet->get_rowset_update_lock());
+        WriteLock wrlock(tablet->get_header_lock_ptr());
+        return tablet->revise_tablet_meta(rs_metas, {}, cloned_delete_bitmap);
+    }
+
+    std::vector<int64_t> _tablet_ids;
+};
+
+TEST_F(TabletDeleteBitmapTest, incremental_clone) {
+    TabletSharedPtr src = create_tablet(15001);
+    TabletSharedPtr dst = create_tablet(15002);
+    ASSERT_NE(nullptr, src);
+    ASSERT_NE(nullptr, dst);
+    load(src, 20001, 2, {{1, 10}, {2, 20}});
+    load(dst, 20002, 2, {{1, 10}, {2, 20}});
+    load(src, 20003, 3, {{1, 11}});
+    load(src, 20004, 4, {{2, 21}, {3, 30}});
+    ASSERT_EQ(Rows({{1, 11}, {2, 21}, {3, 30}}), read_rows(src, 4));
+
+    // versions 3 and 4 are missed by dst
+    std::vector<RowsetMetaSharedPtr> rs_metas;
+    for (int64_t version = 3; version <= 4; ++version) {
+        rs_metas.push_back(link_rowset(dst, src->get_rowset_by_version({version, version}),
+                                       src->tablet_meta()->delete_bitmap(), nullptr));
+    }
+    ASSERT_EQ(OLAP_SUCCESS, clone(dst, rs_metas, nullptr));
+
+    // the keys of the local version 2 are replaced by the cloned versions
+    ASSERT_EQ(Rows({{1, 10}, {2, 20}}), read_rows(dst, 2));
+    ASSERT_EQ(Rows({{1, 11}, {2, 20}}), read_rows(dst, 3));
+    ASSERT_EQ(Rows({{1, 11}, {2, 21}, {3, 30}}), read_rows(dst, 4));
+}
+
+TEST_F(TabletDeleteBitmapTest, full_clone) {
+    TabletSharedPtr src = create_tablet(15003);
+    TabletSharedPtr dst = create_tablet(15004);
+    ASSERT_NE(nullptr, src);
+    ASSERT_NE(nullptr, dst);
+    load(src, 20011, 2, {{1, 10}, {2, 20}});
+    load(dst, 20012, 2, {{1, 10}, {2, 20}});
+    load(src, 20013, 3, {{1, 11}});
+    load(src, 20014, 4, {{1, 12}, {2, 22}});
+
+    // dst keeps its version 2, versions 3 and 4 are cloned with the delete bitmap of src,
+    // in which version 4 replaces key 1 of version 3
+    DeleteBitmap cloned_delete_bitmap;
+    std::vector<RowsetMetaSharedPtr> rs_metas;
+    for (int64_t version = 3; version <= 4; ++version) {
+        rs_metas.push_back(link_rowset(dst, src->get_rowset_by_version({version, version}),
+                                       src->tablet_meta()->delete_bitmap(),
+                                       &cloned_delete_bitmap));
+    }
+    ASSERT_FALSE(cloned_delete_bitmap.empty());
+    ASSERT_EQ(OLAP_SUCCESS, clone(dst, rs_metas, &cloned_delete_bitmap));
+
+    ASSERT_EQ(Rows({{1, 10}, {2, 20}}), read_rows(dst, 2));
+    ASSERT_EQ(Rows({{1, 11}, {2, 20}}), read_rows(dst, 3));
+    ASSERT_EQ(Rows({{1, 12}, {2, 22}}), read_rows(dst, 4));
+}
+
+TEST_F(TabletDeleteBitmapTest, publish_in_order) {
+    TabletSharedPtr tablet = create_tablet(15005);
+    ASSERT_NE(nullptr, tablet);
+    write_rows(tablet, 20021, {{1, 10}, {2, 20}});
+    write_rows(tablet, 20022, {{1, 11}});
+
+    // version 3 waits for version 2, and its txn is not published
+    ASSERT_EQ(std::vector<OLAPStatus>({OLAP_ERR_PUBLISH_VERSION_NOT_CONTINUOUS}),
+              publish({{20022, 3}}));
+    ASSERT_EQ(1, tablet->max_version().second);
+
+    ASSERT_EQ(std::vector<OLAPStatus>({OLAP_SUCCESS}), publish({{20021, 2}}));
+    ASSERT_EQ(std::vector<OLAPStatus>({OLAP_SUCCESS}), publish({{20022, 3}}));
+    // published again
+    ASSERT_EQ(std::vector<OLAPStatus>({OLAP_SUCCESS}), publish({{20022, 3}}));
+    ASSERT_EQ(Rows({{1, 10}, {2, 20}}), read_rows(tablet, 2));
+    ASSERT_EQ(Rows({{1, 11}, {2, 20}}), read_rows(tablet, 3));
+}
+
+TEST_F(TabletDeleteBitmapTest, publish_batch_in_order) {
+    std::vector<TabletSharedPtr> tablets = {create_tablet(15006), create_tablet(15007)};
+    for (auto& tablet : tablets) {
+        ASSERT_NE(nullptr, tablet);
+        write_rows(tablet, 20031, {{1, 10}, {2, 20}});
+        write_rows(tablet, 20032, {{1, 11}});
+        write_rows(tablet, 20033, {{2, 21}});
+    }
+
+    // the txns of a tablet in one batch are published by version, whatever their order
+    ASSERT_EQ(std::vector<OLAPStatus>({OLAP_SUCCESS, OLAP_SUCCESS, OLAP_SUCCESS}),
+              publish({{20033, 4}, {20031, 2}, {20032, 3}}));
+    for (auto& tablet : tablets) {
+        ASSERT_EQ(4, tablet->max_version().second);
+        ASSERT_EQ(Rows({{1, 10}, {2, 20}}), read_rows(tablet, 2));
+        ASSERT_EQ(Rows({{1, 11}, {2, 20}}), read_rows(tablet, 3));
+        ASSERT_EQ(Rows({{1, 11}, {2, 21}}), read_rows(tablet, 4));
+    }
+}
+
+TEST_F(TabletDeleteBitmapTest, calc_delete_bitmap_by_predicate) {
+    TabletSharedPtr tablet = create_tablet(15008, false);
+    ASSERT_NE(nullptr, tablet);
+    load(tablet, 20041, 2, {{1, 10}, {2, 20}, {3, 30}});
+    load(tablet, 20042, 3, {{4, 40}});
+    load(tablet, 20043, 4, {{5, 50}});
+    RowsetSharedPtr rowset2 = tablet->get_rowset_by_version({2, 2});
+    RowsetSharedPtr rowset3 = tablet->get_rowset_by_version({3, 3});
+    RowsetSharedPtr rowset4 = tablet->get_rowset_by_version({4, 4});
+
+    // the rowsets not older than the delete are not marked
+    DeleteBitmap delete_bitmap;
+    ASSERT_EQ(OLAP_SUCCESS, Tablet::calc_delete_bitmap_by_predicate(
+                                    tablet->tablet_schema(), delete_predicate(2, 4),
+                                    {rowset2, rowset3, rowset4}, &delete_bitmap));
+    Roaring rows;
+    delete_bitmap.get_agg(rowset2->rowset_id(), 0, 4, &rows);
+    ASSERT_EQ(Roaring::bitmapOf(2, 1, 2), rows);
+    delete_bitmap.get_agg(rowset2->rowset_id(), 0, 3, &rows);
+    ASSERT_TRUE(rows.isEmpty());
+    delete_bitmap.get_agg(rowset3->rowset_id(), 0, 4, &rows);
+    ASSERT_EQ(Roaring::bitmapOf(1, 0), rows);
+    ASSERT_FALSE(delete_bitmap.contains(rowset4->rowset_id()));
+}
+
+TEST_F(TabletDeleteBitmapTest, delete_by_bitmap_published_before_load) {
+    TabletSharedPtr tablet = create_tablet(15009, false);
+    ASSERT_NE(nullptr, tablet);
+    write_rows(tablet, 20051, {{1, 10}, {2, 20}});
+    write_delete(tablet, 20052, 2);
+    write_rows(tablet, 20053, {{3, 30}});
+
+    // the delete of version 3 is published first, then the load of version 2 older than it
+    ASSERT_EQ(std::vector<OLAPStatus>({OLAP_SUCCESS}), publish({{20052, 3}}));
+    ASSERT_EQ(std::vector<OLAPStatus>({OLAP_SUCCESS}), publish({{20051, 2}}));
+    ASSERT_EQ(std::vector<OLAPStatus>({OLAP_SUCCESS}), publish({{20053, 4}}));
+
+    ASSERT_EQ(Rows({{1, 10}, {2, 20}}), read_rows(tablet, 2));
+    ASSERT_EQ(Rows({{1, 10}}), read_rows(tablet, 3));
+    ASSERT_EQ(Rows({{1, 10}, {3, 30}}), read_rows(tablet, 4));
+}
+
+} // namespace doris
+
+int main(int argc, char** argv) {
+    std::string conffile = std::string(getenv("DORIS_HOME")) + "/conf/be.conf";
+    if (!doris::config::init(conffile.c_str(), false)) {
+        fprintf(stderr, "error read config file. \n");
+        return -1;
+    }
+    testing::InitGoogleTest(&argc, argv);
+    doris::CpuInfo::init();
+    doris::set_up();
+    int ret = RUN_ALL_TESTS();
+    doris::tear_down();
+    google::protobuf::ShutdownProtobufLibrary();
+    return ret;
+}
@@ -41,6 +41,79 @@ TEST(TabletMetaTest, SaveAndParse) {
     ASSERT_EQ(old_tablet_meta, new_tablet_meta);
 }
 
+TEST(TabletMetaTest, DeleteBitmap) {
+    RowsetId rowset1;
+    rowset1.init(1);
+    RowsetId rowset2;
+    rowset2.init(2);
+
+    DeleteBitmap delete_bitmap;
+    ASSERT_TRUE(delete_bitmap.empty());
+    // rows of segment 0 of rowset1 replaced by version 3 and 5
+    delete_bitmap.add({rowset1, 0, 3}, 1);
+    delete_bitmap.add({rowset1, 0, 3}, 2);
+    delete_bitmap.add({rowset1, 0, 5}, 4);
+    delete_bitmap.add({rowset1, 1, 3}, 7);
+    DeleteBitmap other;
+    other.add({rowset2, 0, 5}, 9);
+    other.add({rowset1, 0, 5}, 8);
+    delete_bitmap.merge(other);
+    ASSERT_TRUE(delete_bitmap.contains(rowset1));
+    ASSERT_TRUE(delete_bitmap.contains(rowset2));
+    RowsetId rowset3;
+    rowset3.init(3);
+    ASSERT_FALSE(delete_bitmap.contains(rowset3));
+
+    Roaring bitmap;
+    delete_bitmap.get_agg(rowset1, 0, 2, &bitmap);
+    ASSERT_TRUE(bitmap.isEmpty());
+    delete_bitmap.get_agg(rowset1, 0, 4, &bitmap);
+    ASSERT_EQ(Roaring::bitmapOf(2, 1, 2), bitmap);
+    delete_bitmap.get_agg(rowset1, 0, 5, &bitmap);
+    ASSERT_EQ(Roaring::bitmapOf(4, 1, 2, 4, 8), bitmap);
+    delete_bitmap.get_agg(rowset1, 1, 10, &bitmap);
+    ASSERT_EQ(Roaring::bitmapOf(1, 7), bitmap);
+    delete_bitmap.get_agg(rowset2, 0, 10, &bitmap);
+    ASSERT_EQ(Roaring::bitmapOf(1, 9), bitmap);
+
+    DeleteBitmapPB delete_bitmap_pb;
+    delete_bitmap.to_pb(&delete_bitmap_pb);
+    DeleteBitmap parsed;
+    parsed.init_from_pb(delete_bitmap_pb);
+    parsed.get_agg(rowset1, 0, 5, &bitmap);
+    ASSERT_EQ(Roaring::bitmapOf(4, 1, 2, 4, 8), bitmap);
+
+    parsed.remove(rowset1);
+    parsed.get_agg(rowset1, 0, 5, &bitmap);
+    ASSERT_TRUE(bitmap.isEmpty());
+    parsed.get_agg(rowset2, 0, 5, &bitmap);
+    ASSERT_EQ(Roaring::bitmapOf(1, 9), bitmap);
+    parsed.remove(rowset2);
+    ASSERT_TRUE(parsed.empty());
+}
+
+TEST(TabletMetaTest, ClearDeleteByBitmap) {
+    TabletMeta tablet_meta(1, 2, 3, 4, 5, TTabletSchema(), 6, {{7, 8}}, UniqueId(9, 10),
+                           TTabletType::TABLET_TYPE_DISK);
+    RowsetMetaSharedPtr rs_meta(new RowsetMeta());
+    rs_meta->set_version({3, 3});
+    DeletePredicatePB delete_predicate;
+    delete_predicate.set_version(-1);
+    delete_predicate.add_sub_predicates("k1=1");
+    delete_predicate.set_by_bitmap(true);
+    rs_meta->set_delete_predicate(delete_predicate);
+    ASSERT_EQ(OLAP_SUCCESS, tablet_meta.add_rs_meta(rs_meta));
+
+    DelPredicateArray delete_predicates = tablet_meta.delete_predicates();
+    ASSERT_EQ(1, delete_predicates.size());
+    ASSERT_EQ(3, delete_predicates.Get(0).version());
+    ASSERT_TRUE(delete_predicates.Get(0).by_bitmap());
+
+    tablet_meta.clear_delete_by_bitmap();
+    ASSERT_FALSE(tablet_meta.delete_predicates().Get(0).by_bitmap());
+    ASSERT_FALSE(rs_meta->delete_predicate().by_bitmap());
+}
+
 } // namespace doris
 
 int main(int argc, char** argv) {
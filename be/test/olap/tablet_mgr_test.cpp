@@ -257,6 +257,68 @@ TEST_F(TabletMgrTest, DropTablet) {
     ASSERT_TRUE(!dir_exist);
 }
 
+TEST_F(TabletMgrTest, IncrementalReport) {
+    TColumnType col_type;
+    col_type.__set_type(TPrimitiveType::SMALLINT);
+    TColumn col1;
+    col1.__set_column_name("col1");
+    col1.__set_column_type(col_type);
+    col1.__set_is_key(true);
+    std::vector<TColumn> cols;
+    cols.push_back(col1);
+    TTabletSchema tablet_schema;
+    tablet_schema.__set_short_key_column_count(1);
+    tablet_schema.__set_schema_hash(3333);
+    tablet_schema.__set_keys_type(TKeysType::AGG_KEYS);
+    tablet_schema.__set_storage_type(TStorageType::COLUMN);
+    tablet_schema.__set_columns(cols);
+    TCreateTabletReq create_tablet_req;
+    create_tablet_req.__set_tablet_schema(tablet_schema);
+    create_tablet_req.__set_tablet_id(111);
+    create_tablet_req.__set_version(2);
+    create_tablet_req.__set_version_hash(3333);
+    std::vector<DataDir*> data_dirs;
+    data_dirs.push_back(_data_dir);
+    ASSERT_EQ(OLAP_SUCCESS, _tablet_mgr->create_tablet(create_tablet_req, data_dirs));
+    create_tablet_req.__set_tablet_id(112);
+    ASSERT_EQ(OLAP_SUCCESS, _tablet_mgr->create_tablet(create_tablet_req, data_dirs));
+
+    // no accepted report yet, a full report is built
+    std::map<TTabletId, TTablet> tablets_info;
+    bool incremental = true;
+    ASSERT_EQ(OLAP_SUCCESS, _tablet_mgr->report_all_tablets_info(&tablets_info, &incremental));
+    ASSERT_FALSE(incremental);
+    ASSERT_EQ(2, tablets_info.size());
+    _tablet_mgr->finish_tablets_report(true);
+
+    // nothing changed
+    tablets_info.clear();
+    incremental = true;
+    ASSERT_EQ(OLAP_SUCCESS, _tablet_mgr->report_all_tablets_info(&tablets_info, &incremental));
+    ASSERT_TRUE(incremental);
+    ASSERT_EQ(0, tablets_info.size());
+    _tablet_mgr->finish_tablets_report(true);
+
+    // a dropped tablet needs a full report
+    ASSERT_EQ(OLAP_SUCCESS, _tablet_mgr->drop_tablet(112, 3333, false));
+    tablets_info.clear();
+    incremental = true;
+    ASSERT_EQ(OLAP_SUCCESS, _tablet_mgr->report_all_tablets_info(&tablets_info, &incremental));
+    ASSERT_FALSE(incremental);
+    ASSERT_EQ(1, tablets_info.size());
+    ASSERT_EQ(1, tablets_info.count(111));
+    // the report is not accepted, the next report is still a full one
+    _tablet_mgr->finish_tablets_report(false);
+    tablets_info.clear();
+    incremental = true;
+    ASSERT_EQ(OLAP_SUCCESS, _tablet_mgr->report_all_tablets_info(&tablets_info, &incremental));
+    ASSERT_FALSE(incremental);
+    ASSERT_EQ(1, tablets_info.size());
+    _tablet_mgr->finish_tablets_report(true);
+
+    ASSERT_EQ(OLAP_SUCCESS, _tablet_mgr->drop_tablet(111, 3333, false));
+}
+
 TEST_F(TabletMgrTest, GetRowsetId) {
     // normal case
     {
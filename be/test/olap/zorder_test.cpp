@@ -0,0 +1,115 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/zorder.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "olap/row.h"
+#include "olap/schema.h"
+
+namespace doris {
+
+class ZOrderSorterTest : public testing::Test {
+public:
+    ZOrderSorterTest() {
+        std::vector<TabletColumn> columns;
+        columns.emplace_back(OLAP_FIELD_AGGREGATION_NONE, OLAP_FIELD_TYPE_INT, true);
+        columns.emplace_back(OLAP_FIELD_AGGREGATION_NONE, OLAP_FIELD_TYPE_INT, true);
+        columns.emplace_back(OLAP_FIELD_AGGREGATION_NONE, OLAP_FIELD_TYPE_INT, true);
+        _schema.reset(new Schema(columns, 1));
+    }
+
+    char* new_row(int32_t c0, int32_t c1, int32_t c2) {
+        _buffers.emplace_back(_schema->schema_size());
+        char* row = _buffers.back().data();
+        ContiguousRow dst_row(_schema.get(), row);
+        int32_t values[] = {c0, c1, c2};
+        for (uint32_t cid = 0; cid < 3; ++cid) {
+            auto cell = dst_row.cell(cid);
+            cell.set_not_null();
+            *(int32_t*)cell.mutable_cell_ptr() = values[cid];
+        }
+        return row;
+    }
+
+    int32_t value(const char* row, uint32_t cid) {
+        ContiguousRow src_row(_schema.get(), row);
+        return *(const int32_t*)src_row.cell(cid).cell_ptr();
+    }
+
+protected:
+    std::unique_ptr<Schema> _schema;
+    std::vector<std::vector<char>> _buffers;
+};
+
+TEST_F(ZOrderSorterTest, TwoColumns) {
+    std::vector<char*> rows;
+    _buffers.reserve(16);
+    for (int32_t x = 0; x < 4; ++x) {
+        for (int32_t y = 0; y < 4; ++y) {
+            // offset values, which are normalized by the min of the rows
+            rows.push_back(new_row(0, 1000 + x, -20 + y));
+        }
+    }
+    std::mt19937 rng(1);
+    std::shuffle(rows.begin(), rows.end(), rng);
+
+    ZOrderSorter sorter(_schema.get(), {1, 2});
+    sorter.sort(&rows);
+    ASSERT_EQ(16, rows.size());
+    for (int32_t i = 0; i < 16; ++i) {
+        // the bits of column 1 come before the bits of column 2
+        int32_t x = ((i >> 3) & 1) << 1 | ((i >> 1) & 1);
+        int32_t y = ((i >> 2) & 1) << 1 | (i & 1);
+        ASSERT_EQ(1000 + x, value(rows[i], 1)) << i;
+        ASSERT_EQ(-20 + y, value(rows[i], 2)) << i;
+    }
+}
+
+TEST_F(ZOrderSorterTest, Stable) {
+    std::vector<char*> rows;
+    _buffers.reserve(1000);
+    for (int32_t i = 0; i < 1000; ++i) {
+        rows.push_back(new_row(i, i % 3, i % 5));
+    }
+
+    ZOrderSorter sorter(_schema.get(), {1, 2});
+    sorter.sort(&rows);
+    for (size_t i = 1; i < rows.size(); ++i) {
+        int32_t prev_x = value(rows[i - 1], 1);
+        int32_t prev_y = value(rows[i - 1], 2);
+        int32_t x = value(rows[i], 1);
+        int32_t y = value(rows[i], 2);
+        if (prev_x == x && prev_y == y) {
+            // rows of the same z-value keep their order
+            ASSERT_LT(value(rows[i - 1], 0), value(rows[i], 0));
+        }
+    }
+}
+
+} // namespace doris
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,204 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "common/config.h"
+#include "runtime/buffered_block_mgr2.h"
+#include "runtime/disk_io_mgr.h"
+#include "runtime/exec_env.h"
+#include "runtime/mem_tracker.h"
+#include "runtime/runtime_state.h"
+#include "runtime/tmp_file_mgr.h"
+#include "util/cpu_info.h"
+#include "util/disk_info.h"
+#include "util/file_utils.h"
+#include "util/logging.h"
+#include "util/monotime.h"
+
+namespace doris {
+
+static const std::string kScratchDir = "./be/test/runtime/test_data/buffered_block_mgr2_scratch";
+static const int kBlockSize = 64 * 1024;
+
+// Spills blocks through a block mgr of two buffers with a single scratch dir, so the
+// blocks are written as soon as they're unpinned and read back when their buffers are
+// taken by other blocks.
+class BufferedBlockMgr2CompressionTest : public testing::Test {
+public:
+    static void SetUpTestCase() {
+        ExecEnv* env = ExecEnv::GetInstance();
+        env->_disk_io_mgr = new DiskIoMgr();
+        ASSERT_TRUE(env->_disk_io_mgr->init(MemTracker::CreateTracker(-1, "DiskIoMgr")).ok());
+        FileUtils::remove_all(kScratchDir);
+        ASSERT_TRUE(FileUtils::create_dir(kScratchDir).ok());
+        env->_tmp_file_mgr = new TmpFileMgr();
+        ASSERT_TRUE(env->_tmp_file_mgr->init_custom({kScratchDir}, false).ok());
+    }
+
+    static void TearDownTestCase() {
+        ExecEnv* env = ExecEnv::GetInstance();
+        SAFE_DELETE(env->_tmp_file_mgr);
+        SAFE_DELETE(env->_disk_io_mgr);
+        FileUtils::remove_all(kScratchDir);
+    }
+
+    void SetUp() override {
+        TQueryOptions query_options;
+        query_options.__set_enable_spilling(true);
+        _state.reset(new RuntimeState(TUniqueId(), query_options, TQueryGlobals(),
+                                      ExecEnv::GetInstance()));
+        _tracker = std::make_shared<MemTracker>();
+        ASSERT_TRUE(BufferedBlockMgr2::create(_state.get(), _tracker, _state->runtime_profile(),
+                                              ExecEnv::GetInstance()->tmp_file_mgr(),
+                                              2 * kBlockSize, kBlockSize, &_block_mgr)
+                            .ok());
+        // the buffers of the blocks are reserved, the compression buffers exceed the limit
+        ASSERT_TRUE(_block_mgr->register_client(2, _tracker, _state.get(), &_client).ok());
+    }
+
+    void TearDown() override {
+        _block_mgr.reset();
+        _state.reset();
+    }
+
+protected:
+    BufferedBlockMgr2::Block* new_block() {
+        BufferedBlockMgr2::Block* block = nullptr;
+        EXPECT_TRUE(_block_mgr->get_new_block(_client, nullptr, &block).ok());
+        EXPECT_TRUE(block != nullptr);
+        return block;
+    }
+
+    void wait_for_writes() {
+        RuntimeProfile::Counter* writes_outstanding =
+                _block_mgr->profile()->get_counter("BlockWritesOutstanding");
+        for (int i = 0; i < 500 && writes_outstanding->value() != 0; ++i) {
+            SleepFor(MonoDelta::FromMilliseconds(10));
+        }
+        ASSERT_EQ(0, writes_outstanding->value());
+    }
+
+    int64_t counter(const std::string& name) {
+        return _block_mgr->profile()->get_counter(name)->value();
+    }
+
+    // Unpins the blocks, evicts them by getting two other blocks and pins them again.
+    void spill_and_read_back(const std::vector<BufferedBlockMgr2::Block*>& blocks) {
+        for (auto block : blocks) {
+            ASSERT_TRUE(block->unpin().ok());
+        }
+        wait_for_writes();
+        BufferedBlockMgr2::Block* other_block = new_block();
+        BufferedBlockMgr2::Block* another_block = new_block();
+        for (auto block : blocks) {
+            ASSERT_TRUE(block->_buffer_desc == nullptr) << block->debug_string();
+        }
+        other_block->del();
+        another_block->del();
+        for (auto block : blocks) {
+            bool pinned = false;
+            ASSERT_TRUE(block->pin(&pinned).ok());
+            ASSERT_TRUE(pinned);
+        }
+        // both were read from the scratch file
+        ASSERT_EQ(0, counter("BufferedPins"));
+    }
+
+    std::unique_ptr<RuntimeState> _state;
+    std::shared_ptr<MemTracker> _tracker;
+    boost::shared_ptr<BufferedBlockMgr2> _block_mgr;
+    BufferedBlockMgr2::Client* _client = nullptr;
+};
+
+TEST_F(BufferedBlockMgr2CompressionTest, round_trip) {
+    ASSERT_TRUE(config::compress_spilled_blocks);
+    // a block of a repeated pattern, and a block of random bytes that LZ4 can't shrink
+    std::vector<uint8_t> compressible(kBlockSize);
+    for (int i = 0; i < kBlockSize; ++i) {
+        compressible[i] = i % 7;
+    }
+    std::vector<uint8_t> incompressible(kBlockSize);
+    std::mt19937 random(42);
+    for (int i = 0; i < kBlockSize; ++i) {
+        incompressible[i] = random();
+    }
+    BufferedBlockMgr2::Block* compressible_block = new_block();
+    memcpy(compressible_block->allocate<uint8_t>(kBlockSize), compressible.data(), kBlockSize);
+    BufferedBlockMgr2::Block* incompressible_block = new_block();
+    memcpy(incompressible_block->allocate<uint8_t>(kBlockSize), incompressible.data(),
+           kBlockSize);
+
+    spill_and_read_back({compressible_block, incompressible_block});
+    ASSERT_GT(compressible_block->_compressed_len, 0);
+    ASSERT_LT(compressible_block->_compressed_len, kBlockSize);
+    ASSERT_EQ(0, incompressible_block->_compressed_len);
+    ASSERT_EQ(kBlockSize, counter("BytesCompressed"));
+    ASSERT_EQ(compressible_block->_compressed_len + kBlockSize, counter("BytesWritten"));
+
+    ASSERT_EQ(kBlockSize, compressible_block->valid_data_len());
+    ASSERT_EQ(0, memcmp(compressible.data(), compressible_block->buffer(), kBlockSize));
+    ASSERT_EQ(kBlockSize, incompressible_block->valid_data_len());
+    ASSERT_EQ(0, memcmp(incompressible.data(), incompressible_block->buffer(), kBlockSize));
+    compressible_block->del();
+    incompressible_block->del();
+}
+
+TEST_F(BufferedBlockMgr2CompressionTest, partial_blocks) {
+    // only the valid data of the blocks is compressed and restored
+    const int len = kBlockSize / 3;
+    BufferedBlockMgr2::Block* block = new_block();
+    uint8_t* data = block->allocate<uint8_t>(len);
+    for (int i = 0; i < len; ++i) {
+        data[i] = i / 100;
+    }
+    BufferedBlockMgr2::Block* other_block = new_block();
+    data = other_block->allocate<uint8_t>(len + 1);
+    for (int i = 0; i < len + 1; ++i) {
+        data[i] = i % 13;
+    }
+
+    spill_and_read_back({block, other_block});
+    ASSERT_GT(block->_compressed_len, 0);
+    ASSERT_GT(other_block->_compressed_len, 0);
+    ASSERT_EQ(2 * len + 1, counter("BytesCompressed"));
+    ASSERT_EQ(len, block->valid_data_len());
+    ASSERT_EQ(len + 1, other_block->valid_data_len());
+    for (int i = 0; i < len; ++i) {
+        ASSERT_EQ(i / 100 % 256, block->buffer()[i]) << i;
+    }
+    for (int i = 0; i < len + 1; ++i) {
+        ASSERT_EQ(i % 13, other_block->buffer()[i]) << i;
+    }
+    block->del();
+    other_block->del();
+}
+
+} // namespace doris
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    doris::init_glog("be-test");
+    doris::CpuInfo::init();
+    doris::DiskInfo::init();
+    return RUN_ALL_TESTS();
+}
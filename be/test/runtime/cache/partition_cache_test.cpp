@@ -273,6 +273,29 @@ TEST_F(PartitionCacheTest, fetch_data_overdue) {
     clear();
 }
 
+TEST_F(PartitionCacheTest, fetch_sql_keys_of_shards) {
+    init_default();
+    init_batch_data(64, 1, 2);
+
+    for (int i = 1; i <= 64; i++) {
+        PFetchCacheRequest fetch_request;
+        PFetchCacheResult fetch_result;
+        set_sql_key(fetch_request.mutable_sql_key(), i, i);
+        PCacheParam* p1 = fetch_request.add_params();
+        p1->set_partition_key(2);
+        p1->set_last_version(2);
+        p1->set_last_version_time(2);
+        _cache->fetch(&fetch_request, &fetch_result);
+        ASSERT_TRUE(fetch_result.status() == PCacheStatus::CACHE_OK);
+        ASSERT_EQ(fetch_result.values_size(), 1);
+    }
+
+    _clear_request->set_clear_type(PClearType::CLEAR_ALL);
+    _cache->clear(_clear_request, _clear_response);
+    ASSERT_EQ(_cache->get_cache_size(), 0);
+    clear();
+}
+
 TEST_F(PartitionCacheTest, prune_data) {
     init(1, 1);
     init_batch_data(129, 1, 1024);                        // 16*1024*128=2M
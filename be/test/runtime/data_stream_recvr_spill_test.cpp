@@ -0,0 +1,204 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/config.h"
+#include "gen_cpp/data.pb.h"
+#include "runtime/data_stream_mgr.h"
+#include "runtime/data_stream_recvr.h"
+#include "runtime/descriptor_helper.h"
+#include "runtime/descriptors.h"
+#include "runtime/exec_env.h"
+#include "runtime/row_batch.h"
+#include "runtime/runtime_state.h"
+#include "runtime/tmp_file_mgr.h"
+#include "runtime/tuple.h"
+#include "runtime/tuple_row.h"
+#include "util/cpu_info.h"
+#include "util/disk_info.h"
+#include "util/file_utils.h"
+#include "util/logging.h"
+
+namespace doris {
+
+static const std::string kScratchDir = "./be/test/runtime/test_data/data_stream_recvr_scratch";
+static const int kNumRowsPerBatch = 100;
+
+// Counts the acks of the batches sent to a receiver
+class CountingClosure : public google::protobuf::Closure {
+public:
+    void Run() override { ++count; }
+
+    std::atomic<int> count {0};
+};
+
+// Sends more batches to a spilling receiver than its buffer holds, so all but the first
+// are spilled, and reads them back.
+class DataStreamRecvrSpillTest : public testing::Test {
+public:
+    static void SetUpTestCase() {
+        ExecEnv* env = ExecEnv::GetInstance();
+        FileUtils::remove_all(kScratchDir);
+        ASSERT_TRUE(FileUtils::create_dir(kScratchDir).ok());
+        env->_tmp_file_mgr = new TmpFileMgr();
+        ASSERT_TRUE(env->_tmp_file_mgr->init_custom({kScratchDir}, false).ok());
+    }
+
+    static void TearDownTestCase() {
+        ExecEnv* env = ExecEnv::GetInstance();
+        SAFE_DELETE(env->_tmp_file_mgr);
+        FileUtils::remove_all(kScratchDir);
+    }
+
+    void SetUp() override {
+        _state.reset(new RuntimeState(TUniqueId(), TQueryOptions(), TQueryGlobals(),
+                                      ExecEnv::GetInstance()));
+        ASSERT_TRUE(_state->init_mem_trackers(TUniqueId()).ok());
+
+        TDescriptorTableBuilder dtb;
+        TTupleDescriptorBuilder tuple_builder;
+        tuple_builder.add_slot(TSlotDescriptorBuilder()
+                                       .type(TYPE_INT)
+                                       .column_name("k")
+                                       .column_pos(0)
+                                       .nullable(false)
+                                       .build());
+        tuple_builder.build(&dtb);
+        ASSERT_TRUE(DescriptorTbl::create(&_obj_pool, dtb.desc_tbl(), &_desc_tbl).ok());
+        _row_desc.reset(new RowDescriptor(*_desc_tbl, {0}, {false}));
+        _profile.reset(new RuntimeProfile("DataStreamRecvrSpillTest"));
+
+        // a buffer smaller than a batch
+        _old_buffer_size = config::exchg_node_buffer_size_bytes;
+        config::exchg_node_buffer_size_bytes = 1;
+        _recvr = _stream_mgr.create_recvr(_state.get(), *_row_desc, TUniqueId(), 1, 1,
+                                          config::exchg_node_buffer_size_bytes,
+                                          _profile.get(), false, nullptr, true);
+    }
+
+    void TearDown() override {
+        _recvr->close();
+        _recvr.reset();
+        config::exchg_node_buffer_size_bytes = _old_buffer_size;
+        _state.reset();
+    }
+
+protected:
+    // Sends the batch of the keys from 'begin' as the packet 'packet_seq'
+    void send(int begin, int64_t packet_seq) {
+        RowBatch batch(*_row_desc, kNumRowsPerBatch, _state->instance_mem_tracker().get());
+        const SlotDescriptor* slot = _desc_tbl->get_tuple_descriptor(0)->slots()[0];
+        int tuple_size = _desc_tbl->get_tuple_descriptor(0)->byte_size();
+        for (int i = 0; i < kNumRowsPerBatch; ++i) {
+            int idx = batch.add_row();
+            TupleRow* row = batch.get_row(idx);
+            Tuple* tuple = Tuple::create(tuple_size, batch.tuple_data_pool());
+            *reinterpret_cast<int32_t*>(tuple->get_slot(slot->tuple_offset())) = begin + i;
+            row->set_tuple(0, tuple);
+            batch.commit_last_row();
+        }
+        PRowBatch pb_batch;
+        batch.serialize(&pb_batch);
+        butil::IOBuf attachment;
+        google::protobuf::Closure* done = &_acks;
+        _recvr->add_batch(pb_batch, &attachment, 0, 0, packet_seq, &done);
+        if (done != nullptr) {
+            done->Run();
+        }
+    }
+
+    // Gets the next batch and checks that it has the keys from 'begin'
+    void check_next(int begin) {
+        RowBatch* batch = nullptr;
+        ASSERT_TRUE(_recvr->get_batch(&batch).ok());
+        ASSERT_TRUE(batch != nullptr);
+        ASSERT_EQ(kNumRowsPerBatch, batch->num_rows());
+        const SlotDescriptor* slot = _desc_tbl->get_tuple_descriptor(0)->slots()[0];
+        for (int i = 0; i < kNumRowsPerBatch; ++i) {
+            Tuple* tuple = batch->get_row(i)->get_tuple(0);
+            ASSERT_EQ(begin + i,
+                      *reinterpret_cast<int32_t*>(tuple->get_slot(slot->tuple_offset())));
+        }
+    }
+
+    int64_t counter(const std::string& name) { return _profile->get_counter(name)->value(); }
+
+    ObjectPool _obj_pool;
+    DescriptorTbl* _desc_tbl = nullptr;
+    std::unique_ptr<RowDescriptor> _row_desc;
+    std::unique_ptr<RuntimeState> _state;
+    std::unique_ptr<RuntimeProfile> _profile;
+    DataStreamMgr _stream_mgr;
+    boost::shared_ptr<DataStreamRecvr> _recvr;
+    CountingClosure _acks;
+    int32_t _old_buffer_size = 0;
+};
+
+TEST_F(DataStreamRecvrSpillTest, read_back) {
+    const int num_batches = 10;
+    for (int i = 0; i < num_batches; ++i) {
+        send(i * kNumRowsPerBatch, i);
+    }
+    // the first batch is queued in memory and its ack withheld, the others are spilled
+    ASSERT_EQ(num_batches - 1, _acks.count);
+    ASSERT_GT(counter("BytesSpilled"), 0);
+    _recvr->remove_sender(0, 0);
+
+    for (int i = 0; i < num_batches; ++i) {
+        check_next(i * kNumRowsPerBatch);
+    }
+    RowBatch* batch = nullptr;
+    ASSERT_TRUE(_recvr->get_batch(&batch).ok());
+    ASSERT_TRUE(batch == nullptr);
+    ASSERT_EQ(num_batches, _acks.count);
+}
+
+TEST_F(DataStreamRecvrSpillTest, concurrent_read_back) {
+    // the batches are read back while later ones are being spilled
+    const int num_batches = 200;
+    std::thread sender([this, num_batches]() {
+        for (int i = 0; i < num_batches; ++i) {
+            send(i * kNumRowsPerBatch, i);
+        }
+        _recvr->remove_sender(0, 0);
+    });
+    for (int i = 0; i < num_batches; ++i) {
+        check_next(i * kNumRowsPerBatch);
+    }
+    RowBatch* batch = nullptr;
+    ASSERT_TRUE(_recvr->get_batch(&batch).ok());
+    ASSERT_TRUE(batch == nullptr);
+    sender.join();
+    ASSERT_EQ(num_batches, _acks.count);
+}
+
+} // namespace doris
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    doris::init_glog("be-test");
+    doris::CpuInfo::init();
+    doris::DiskInfo::init();
+    return RUN_ALL_TESTS();
+}
@@ -943,6 +943,45 @@ TEST_F(DateTimeValueTest, calc_daynr) {
 }
 
 // Construct from int value
+TEST_F(DateTimeValueTest, from_date_daynr_repeated) {
+    char str[MAX_DTVALUE_STR_LEN];
+    DateTimeValue value;
+    DateTimeValue other;
+    // the last day is reused
+    ASSERT_TRUE(value.from_date_daynr(737642));
+    ASSERT_TRUE(other.from_date_daynr(737642));
+    ASSERT_TRUE(value == other);
+    value.to_string(str);
+    ASSERT_STREQ("2019-08-06", str);
+    ASSERT_TRUE(value.from_date_daynr(737643));
+    value.to_string(str);
+    ASSERT_STREQ("2019-08-07", str);
+    ASSERT_EQ(737643, value.daynr());
+    ASSERT_FALSE(value.from_date_daynr(0));
+}
+
+TEST_F(DateTimeValueTest, from_fixed_format_str) {
+    char str[MAX_DTVALUE_STR_LEN];
+    DateTimeValue value;
+    ASSERT_TRUE(value.from_date_str("2020-02-29", 10));
+    value.to_string(str);
+    ASSERT_STREQ("2020-02-29", str);
+
+    ASSERT_TRUE(value.from_date_str("1988-02-01 12:23:34", 19));
+    value.to_string(str);
+    ASSERT_STREQ("1988-02-01 12:23:34", str);
+
+    ASSERT_FALSE(value.from_date_str("2019-02-29", 10));
+    ASSERT_FALSE(value.from_date_str("2020-13-01", 10));
+    ASSERT_FALSE(value.from_date_str("2020-01-01 24:00:00", 19));
+    ASSERT_FALSE(value.from_date_str("2020-01-01 00:60:00", 19));
+
+    // other delimiters go through the general parser
+    ASSERT_TRUE(value.from_date_str("2020/01/02 03.04.05", 19));
+    value.to_string(str);
+    ASSERT_STREQ("2020-01-02 03:04:05", str);
+}
+
 TEST_F(DateTimeValueTest, from_time_str) {
     // Used to check
     char str[MAX_DTVALUE_STR_LEN];
@@ -99,6 +99,24 @@ TEST_F(ExternalScanContextMgrTest, clear_context) {
     ASSERT_TRUE(!st.ok());
     ASSERT_TRUE(result == nullptr);
 }
+
+TEST_F(ExternalScanContextMgrTest, get_next_abnormal) {
+    ExternalScanContextMgr context_mgr(&_exec_env);
+    bool eos = false;
+    std::string rows;
+    Status st = context_mgr.get_next("not_exist", 0, &eos, &rows);
+    ASSERT_TRUE(st.is_not_found());
+
+    std::shared_ptr<ScanContext> context;
+    st = context_mgr.create_scan_context(&context);
+    ASSERT_TRUE(st.ok());
+    context->offset = 10;
+    // a retried call sends the offset of the batch fetched before
+    st = context_mgr.get_next(context->context_id, 5, &eos, &rows);
+    ASSERT_TRUE(st.is_not_found());
+    ASSERT_TRUE(rows.empty());
+    ASSERT_EQ(10, context->offset);
+}
 } // namespace doris
 
 int main(int argc, char** argv) {
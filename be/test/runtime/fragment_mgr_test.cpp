@@ -30,6 +30,7 @@ namespace doris {
 static Status s_prepare_status;
 static Status s_open_status;
 static int s_abort_cnt;
+static int s_prepare_with_fragment_cnt;
 // Mock used for this unittest
 PlanFragmentExecutor::PlanFragmentExecutor(ExecEnv* exec_env,
                                            const report_status_callback& report_status_cb)
@@ -39,6 +40,9 @@ PlanFragmentExecutor::~PlanFragmentExecutor() {}
 
 Status PlanFragmentExecutor::prepare(const TExecPlanFragmentParams& request,
                                      const QueryFragmentsCtx* batch_ctx) {
+    if (request.__isset.fragment) {
+        s_prepare_with_fragment_cnt++;
+    }
     return s_prepare_status;
 }
 
@@ -94,6 +98,25 @@ TEST_F(FragmentMgrTest, AddNormal) {
     }
 }
 
+TEST_F(FragmentMgrTest, ExecBatch) {
+    s_prepare_with_fragment_cnt = 0;
+    FragmentMgr mgr(nullptr);
+    TExecPlanFragmentParamsList params_list;
+    for (int i = 0; i < 4; ++i) {
+        TExecPlanFragmentParams params;
+        params.params.fragment_instance_id = TUniqueId();
+        params.params.fragment_instance_id.__set_hi(100 + i);
+        params.params.fragment_instance_id.__set_lo(200);
+        if (i == 0) {
+            params.__set_fragment(TPlanFragment());
+        }
+        params_list.paramsList.push_back(params);
+    }
+    ASSERT_TRUE(mgr.exec_plan_fragments(&params_list).ok());
+    // the instances without a fragment share the one of the first
+    ASSERT_EQ(4, s_prepare_with_fragment_cnt);
+}
+
 TEST_F(FragmentMgrTest, CancelNormal) {
     FragmentMgr mgr(nullptr);
     TExecPlanFragmentParams params;
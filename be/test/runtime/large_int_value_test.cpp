@@ -90,6 +90,40 @@ TEST_F(LargeIntValueTest, largeint_to_string) {
     }
 }
 
+TEST_F(LargeIntValueTest, largeint_to_string_chunks) {
+    // around the boundaries of the 19 digits split at a time
+    __int128 ten_pow_19 = LargeIntValue::TEN_POW_19;
+    ASSERT_EQ("0", LargeIntValue::to_string(0));
+    ASSERT_EQ("-1", LargeIntValue::to_string(-1));
+    ASSERT_EQ("99", LargeIntValue::to_string(99));
+    ASSERT_EQ("-100", LargeIntValue::to_string(-100));
+    ASSERT_EQ("18446744073709551615",
+              LargeIntValue::to_string(std::numeric_limits<uint64_t>::max()));
+    ASSERT_EQ("18446744073709551616",
+              LargeIntValue::to_string((__int128)std::numeric_limits<uint64_t>::max() + 1));
+    ASSERT_EQ("100000000000000000000000000000000000000",
+              LargeIntValue::to_string(ten_pow_19 * ten_pow_19 * 10));
+    ASSERT_EQ("-100000000000000000000000000000000000001",
+              LargeIntValue::to_string(-ten_pow_19 * ten_pow_19 * 10 - 1));
+
+    char buf[40];
+    int len = sizeof(buf);
+    char* str = LargeIntValue::to_string(ten_pow_19 * 1000 + 7, buf, &len);
+    ASSERT_EQ("10000000000000000000007", std::string(str, len));
+}
+
+TEST_F(LargeIntValueTest, div_mod_uint64) {
+    uint64_t remainder = 0;
+    ASSERT_TRUE(div_mod_uint64(12345, 100, &remainder) == 123);
+    ASSERT_EQ(45ULL, remainder);
+    unsigned __int128 value =
+            ((unsigned __int128)0x123456789abcdefULL << 64) | 0xfedcba987654321ULL;
+    ASSERT_TRUE(div_mod_uint64(value, 1000000000, &remainder) == value / 1000000000);
+    ASSERT_EQ((uint64_t)(value % 1000000000), remainder);
+    ASSERT_TRUE(div_mod_uint64(value, 3, &remainder) == value / 3);
+    ASSERT_EQ((uint64_t)(value % 3), remainder);
+}
+
 } // end namespace doris
 
 int main(int argc, char** argv) {
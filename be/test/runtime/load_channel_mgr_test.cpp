@@ -43,13 +43,20 @@ OLAPStatus open_status;
 OLAPStatus add_status;
 OLAPStatus close_status;
 int64_t wait_lock_time_ns;
+// bytes consumed by each row written, and the tablets whose memtables were flushed
+int64_t row_mem_consumption;
+std::vector<int64_t> flushed_tablets;
 
 // mock
 DeltaWriter::DeltaWriter(WriteRequest* req, const std::shared_ptr<MemTracker>& mem_tracker,
                          StorageEngine* storage_engine)
-        : _req(*req) {}
+        : _req(*req) {
+    _mem_tracker = MemTracker::CreateTracker(-1, "DeltaWriter", mem_tracker);
+}
 
-DeltaWriter::~DeltaWriter() {}
+DeltaWriter::~DeltaWriter() {
+    _mem_tracker->Release(_mem_tracker->consumption());
+}
 
 OLAPStatus DeltaWriter::init() {
     return OLAP_SUCCESS;
@@ -70,6 +77,7 @@ OLAPStatus DeltaWriter::write(Tuple* tuple) {
     } else {
         _k_tablet_recorder[_req.tablet_id]++;
     }
+    _mem_tracker->Consume(row_mem_consumption);
     return add_status;
 }
 
@@ -89,6 +97,20 @@ OLAPStatus DeltaWriter::flush_memtable_and_wait() {
     return OLAP_SUCCESS;
 }
 
+OLAPStatus DeltaWriter::flush_memtable() {
+    flushed_tablets.push_back(_req.tablet_id);
+    _mem_tracker->Release(_mem_tracker->consumption());
+    return OLAP_SUCCESS;
+}
+
+OLAPStatus DeltaWriter::wait_flush() {
+    return OLAP_SUCCESS;
+}
+
+int64_t DeltaWriter::memtable_consumption() const {
+    return _mem_tracker->consumption();
+}
+
 int64_t DeltaWriter::partition_id() const {
     return 1L;
 }
@@ -105,6 +127,8 @@ public:
         open_status = OLAP_SUCCESS;
         add_status = OLAP_SUCCESS;
         close_status = OLAP_SUCCESS;
+        row_mem_consumption = 0;
+        flushed_tablets.clear();
         config::streaming_load_rpc_max_alive_time_sec = 120;
     }
 
@@ -702,6 +726,89 @@ TEST_F(LoadChannelMgrTest, duplicate_packet) {
     ASSERT_EQ(_k_tablet_recorder[21], 1);
 }
 
+TEST_F(LoadChannelMgrTest, flush_largest_memtables) {
+    ExecEnv env;
+    LoadChannelMgr mgr;
+    // total load mem limit is 80000
+    mgr.init(100000);
+    row_mem_consumption = 10000;
+
+    auto tdesc_tbl = create_descriptor_table();
+    ObjectPool obj_pool;
+    DescriptorTbl* desc_tbl = nullptr;
+    DescriptorTbl::create(&obj_pool, tdesc_tbl, &desc_tbl);
+    auto tuple_desc = desc_tbl->get_tuple_descriptor(0);
+    RowDescriptor row_desc(*desc_tbl, {0}, {false});
+    auto tracker = std::make_shared<MemTracker>();
+    PUniqueId load_id;
+    load_id.set_hi(2);
+    load_id.set_lo(3);
+    {
+        PTabletWriterOpenRequest request;
+        request.set_allocated_id(&load_id);
+        request.set_index_id(4);
+        request.set_txn_id(1);
+        create_schema(desc_tbl, request.mutable_schema());
+        for (int i = 0; i < 3; ++i) {
+            auto tablet = request.add_tablets();
+            tablet->set_partition_id(10 + i);
+            tablet->set_tablet_id(20 + i);
+        }
+        request.set_num_senders(1);
+        request.set_need_gen_rollup(false);
+        auto st = mgr.open(request);
+        request.release_id();
+        ASSERT_TRUE(st.ok());
+    }
+
+    auto add_batch = [&](int64_t packet_seq, const std::vector<int64_t>& tablet_ids) {
+        PTabletWriterAddBatchRequest request;
+        request.set_allocated_id(&load_id);
+        request.set_index_id(4);
+        request.set_sender_id(0);
+        request.set_eos(false);
+        request.set_packet_seq(packet_seq);
+
+        RowBatch row_batch(row_desc, 1024, tracker.get());
+        for (auto tablet_id : tablet_ids) {
+            request.add_tablet_ids(tablet_id);
+            auto id = row_batch.add_row();
+            auto tuple = (Tuple*)row_batch.tuple_data_pool()->allocate(tuple_desc->byte_size());
+            row_batch.get_row(id)->set_tuple(0, tuple);
+            memset(tuple, 0, tuple_desc->byte_size());
+            row_batch.commit_last_row();
+        }
+        row_batch.serialize(request.mutable_row_batch());
+        google::protobuf::RepeatedPtrField<PTabletInfo> tablet_vec;
+        auto st = mgr.add_batch(request, &tablet_vec, &wait_lock_time_ns);
+        request.release_id();
+        return st;
+    };
+
+    // memtables of tablet 20, 21, 22 consume 50000, 30000 and 10000 bytes
+    ASSERT_TRUE(add_batch(0, {20, 20, 20, 20, 20, 21, 21, 22}).ok());
+    ASSERT_TRUE(add_batch(1, {21}).ok());
+    ASSERT_TRUE(flushed_tablets.empty());
+
+    // the limit is exceeded, only the largest memtable is flushed because it is enough to reduce
+    // the consumption to the low water mark 40000
+    config::load_process_low_water_percent = 50;
+    ASSERT_TRUE(add_batch(2, {22}).ok());
+    ASSERT_EQ(1, flushed_tablets.size());
+    ASSERT_EQ(20, flushed_tablets[0]);
+
+    // 10000 + 30000 + 20000 bytes are under the limit
+    ASSERT_TRUE(add_batch(3, {20}).ok());
+    ASSERT_EQ(1, flushed_tablets.size());
+
+    // 20000 + 30000 + 40000 bytes, flush 22 and 21 to reach the low water mark
+    ASSERT_TRUE(add_batch(4, {20, 22, 22}).ok());
+    ASSERT_TRUE(add_batch(5, {}).ok());
+    ASSERT_EQ(3, flushed_tablets.size());
+    ASSERT_EQ(22, flushed_tablets[1]);
+    ASSERT_EQ(21, flushed_tablets[2]);
+}
+
 } // namespace doris
 
 int main(int argc, char* argv[]) {
@@ -36,6 +36,24 @@ TEST(ChunkAllocatorTest, Normal) {
         ChunkAllocator::instance()->free(chunk);
     }
 }
+
+TEST(ChunkAllocatorTest, NumaNode) {
+    config::use_mmap_allocate_chunk = true;
+    Chunk chunk;
+    ASSERT_TRUE(ChunkAllocator::instance()->allocate(4096, &chunk));
+    std::string node_id = std::to_string(CpuInfo::get_numa_node_of_core(chunk.core_id));
+    ChunkAllocator::instance()->free(chunk);
+
+    // the freed chunk is reserved by the node of its core
+    auto registry = DorisMetrics::instance()->metric_registry();
+    auto entity = registry->get_entity("chunk_allocator.numa_node_" + node_id,
+                                       {{"numa_node", node_id}});
+    ASSERT_TRUE(entity != nullptr);
+    registry->trigger_all_hooks(true);
+    auto reserved_bytes = static_cast<IntGauge*>(entity->get_metric("chunk_pool_reserved_bytes"));
+    ASSERT_TRUE(reserved_bytes != nullptr);
+    ASSERT_GE(reserved_bytes->value(), 4096);
+}
 } // namespace doris
 
 int main(int argc, char** argv) {
@@ -0,0 +1,65 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "runtime/resource_group_mgr.h"
+
+#include <gtest/gtest.h>
+
+#include "runtime/mem_tracker.h"
+#include "util/fair_thread_pool.h"
+#include "util/logging.h"
+
+namespace doris {
+
+TEST(ResourceGroupMgrTest, Parse) {
+    auto process_tracker = MemTracker::CreateTracker(-1, "ResourceGroupMgrTest");
+    ResourceGroupMgr mgr;
+    ASSERT_TRUE(mgr.init(" etl : scan_threads=2, mem_limit=1G, max_queries=1; dashboard",
+                         process_tracker, nullptr)
+                        .ok());
+
+    ResourceGroup* etl = mgr.get("etl");
+    ASSERT_NE(nullptr, etl);
+    ASSERT_NE(nullptr, etl->scan_thread_pool());
+    ASSERT_TRUE(etl->cgroup().empty());
+    ASSERT_EQ(1024L * 1024 * 1024, etl->mem_tracker()->limit());
+    ASSERT_EQ(process_tracker.get(), etl->mem_tracker()->parent().get());
+
+    ResourceGroup* dashboard = mgr.get("dashboard");
+    ASSERT_NE(nullptr, dashboard);
+    ASSERT_EQ(nullptr, dashboard->scan_thread_pool());
+    ASSERT_FALSE(dashboard->mem_tracker()->has_limit());
+
+    ASSERT_EQ(nullptr, mgr.get("adhoc"));
+}
+
+TEST(ResourceGroupMgrTest, InvalidConfig) {
+    auto process_tracker = MemTracker::CreateTracker(-1, "ResourceGroupMgrTest");
+    ASSERT_FALSE(ResourceGroupMgr().init("etl:scan_threads=x", process_tracker, nullptr).ok());
+    ASSERT_FALSE(ResourceGroupMgr().init("etl:io_shares=10", process_tracker, nullptr).ok());
+    ASSERT_FALSE(ResourceGroupMgr().init("etl:mem_limit", process_tracker, nullptr).ok());
+    ASSERT_FALSE(ResourceGroupMgr().init("etl;etl", process_tracker, nullptr).ok());
+    ASSERT_FALSE(ResourceGroupMgr().init(":max_queries=1", process_tracker, nullptr).ok());
+}
+
+} // namespace doris
+
+int main(int argc, char** argv) {
+    doris::init_glog("be-test");
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
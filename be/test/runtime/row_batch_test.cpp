@@ -0,0 +1,234 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "runtime/row_batch.h"
+
+#include "service/brpc.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "common/config.h"
+#include "common/object_pool.h"
+#include "gen_cpp/data.pb.h"
+#include "runtime/descriptor_helper.h"
+#include "runtime/descriptors.h"
+#include "runtime/mem_tracker.h"
+#include "runtime/string_value.h"
+#include "runtime/tuple_row.h"
+#include "util/iobuf_util.h"
+
+namespace doris {
+
+class RowBatchTest : public testing::Test {
+public:
+    RowBatchTest() {}
+
+protected:
+    void SetUp() override {
+        TDescriptorTableBuilder dtb;
+        TTupleDescriptorBuilder tuple_builder;
+        tuple_builder.add_slot(
+                TSlotDescriptorBuilder().type(TYPE_INT).column_name("c1").column_pos(0).build());
+        tuple_builder.add_slot(
+                TSlotDescriptorBuilder().string_type(64).column_name("c2").column_pos(1).build());
+        tuple_builder.build(&dtb);
+        DescriptorTbl::create(&_obj_pool, dtb.desc_tbl(), &_desc_tbl);
+        _tuple_desc = _desc_tbl->get_tuple_descriptor(0);
+        _row_desc.reset(new RowDescriptor(*_desc_tbl, {0}, {false}));
+        _tracker = std::make_shared<MemTracker>();
+    }
+
+    void fill(RowBatch* batch, int num_rows) {
+        for (int i = 0; i < num_rows; ++i) {
+            auto id = batch->add_row();
+            auto tuple = (Tuple*)batch->tuple_data_pool()->allocate(_tuple_desc->byte_size());
+            memset(tuple, 0, _tuple_desc->byte_size());
+            *(int32_t*)tuple->get_slot(_tuple_desc->slots()[0]->tuple_offset()) = i;
+            std::string str = "value_" + std::to_string(i % 10);
+            auto slot = (StringValue*)tuple->get_slot(_tuple_desc->slots()[1]->tuple_offset());
+            slot->ptr = (char*)batch->tuple_data_pool()->allocate(str.size());
+            slot->len = str.size();
+            memcpy(slot->ptr, str.data(), str.size());
+            batch->get_row(id)->set_tuple(0, tuple);
+            batch->commit_last_row();
+        }
+    }
+
+    void check(const PRowBatch& pbatch, int num_rows) {
+        RowBatch batch(*_row_desc, pbatch, _tracker.get());
+        ASSERT_EQ(num_rows, batch.num_rows());
+        for (int i = 0; i < num_rows; ++i) {
+            Tuple* tuple = batch.get_row(i)->get_tuple(0);
+            ASSERT_EQ(i, *(int32_t*)tuple->get_slot(_tuple_desc->slots()[0]->tuple_offset()));
+            auto slot = (StringValue*)tuple->get_slot(_tuple_desc->slots()[1]->tuple_offset());
+            ASSERT_EQ("value_" + std::to_string(i % 10), slot->to_string());
+        }
+    }
+
+    ObjectPool _obj_pool;
+    DescriptorTbl* _desc_tbl = nullptr;
+    TupleDescriptor* _tuple_desc = nullptr;
+    std::unique_ptr<RowDescriptor> _row_desc;
+    std::shared_ptr<MemTracker> _tracker;
+};
+
+TEST_F(RowBatchTest, serialize_with_compress_type) {
+    segment_v2::CompressionTypePB types[] = {
+            segment_v2::CompressionTypePB::NO_COMPRESSION, segment_v2::CompressionTypePB::SNAPPY,
+            segment_v2::CompressionTypePB::LZ4, segment_v2::CompressionTypePB::ZSTD};
+    for (auto type : types) {
+        RowBatch batch(*_row_desc, 1024, _tracker.get());
+        fill(&batch, 1024);
+        PRowBatch pbatch;
+        int uncompressed_size = batch.serialize(&pbatch, type);
+        if (type == segment_v2::CompressionTypePB::NO_COMPRESSION) {
+            ASSERT_FALSE(pbatch.is_compressed());
+        } else {
+            ASSERT_TRUE(pbatch.is_compressed());
+            ASSERT_LT(pbatch.tuple_data().size(), uncompressed_size);
+        }
+        // snappy is the legacy codec and not recorded
+        if (type == segment_v2::CompressionTypePB::LZ4 ||
+            type == segment_v2::CompressionTypePB::ZSTD) {
+            ASSERT_EQ(type, pbatch.compress_type());
+        } else {
+            ASSERT_FALSE(pbatch.has_compress_type());
+        }
+        check(pbatch, 1024);
+    }
+}
+
+TEST_F(RowBatchTest, reuse_pb_batch) {
+    PRowBatch pbatch;
+    {
+        RowBatch batch(*_row_desc, 1024, _tracker.get());
+        fill(&batch, 1024);
+        batch.serialize(&pbatch, segment_v2::CompressionTypePB::LZ4);
+        ASSERT_TRUE(pbatch.has_compress_type());
+    }
+    {
+        RowBatch batch(*_row_desc, 1024, _tracker.get());
+        fill(&batch, 100);
+        batch.serialize(&pbatch, segment_v2::CompressionTypePB::SNAPPY);
+        ASSERT_FALSE(pbatch.has_compress_type());
+        check(pbatch, 100);
+    }
+}
+
+TEST_F(RowBatchTest, deep_copy_to) {
+    RowBatch batch(*_row_desc, 1024, _tracker.get());
+    fill(&batch, 100);
+    auto dst_tracker = std::make_shared<MemTracker>();
+    RowBatch dst(*_row_desc, batch.capacity(), dst_tracker.get());
+    batch.deep_copy_to(&dst);
+    ASSERT_EQ(100, batch.num_rows());
+    batch.reset();
+
+    PRowBatch pbatch;
+    dst.serialize(&pbatch, segment_v2::CompressionTypePB::NO_COMPRESSION);
+    check(pbatch, 100);
+}
+
+TEST_F(RowBatchTest, tuple_data_in_attachment) {
+    segment_v2::CompressionTypePB types[] = {segment_v2::CompressionTypePB::NO_COMPRESSION,
+                                             segment_v2::CompressionTypePB::SNAPPY,
+                                             segment_v2::CompressionTypePB::LZ4};
+    for (auto type : types) {
+        RowBatch batch(*_row_desc, 1024, _tracker.get());
+        fill(&batch, 1024);
+        PRowBatch pbatch;
+        batch.serialize(&pbatch, type);
+        std::string tuple_data = pbatch.tuple_data();
+        pbatch.set_tuple_data_in_attachment(true);
+
+        // one block, as on the sender
+        butil::IOBuf attachment;
+        move_string_to_iobuf(pbatch.mutable_tuple_data(), &attachment);
+        ASSERT_TRUE(pbatch.tuple_data().empty());
+        ASSERT_EQ(tuple_data, attachment.to_string());
+        {
+            RowBatch batch(*_row_desc, pbatch, &attachment, _tracker.get());
+            ASSERT_EQ(1024, batch.num_rows());
+        }
+
+        // many blocks, as on the receiver
+        butil::IOBuf received;
+        for (size_t i = 0; i < tuple_data.size(); i += 1000) {
+            received.append(tuple_data.data() + i, std::min<size_t>(1000, tuple_data.size() - i));
+        }
+        if (type == segment_v2::CompressionTypePB::NO_COMPRESSION) {
+            ASSERT_GT(received.backing_block_num(), 1);
+        }
+        RowBatch received_batch(*_row_desc, pbatch, &received, _tracker.get());
+        ASSERT_EQ(1024, received_batch.num_rows());
+        for (int i = 0; i < 1024; ++i) {
+            Tuple* tuple = received_batch.get_row(i)->get_tuple(0);
+            ASSERT_EQ(i, *(int32_t*)tuple->get_slot(_tuple_desc->slots()[0]->tuple_offset()));
+            auto slot = (StringValue*)tuple->get_slot(_tuple_desc->slots()[1]->tuple_offset());
+            ASSERT_EQ("value_" + std::to_string(i % 10), slot->to_string());
+        }
+    }
+}
+
+TEST_F(RowBatchTest, deserialize_in_place) {
+    config::deserialize_row_batch_in_place = true;
+    PRowBatch pbatch;
+    {
+        RowBatch batch(*_row_desc, 1024, _tracker.get());
+        fill(&batch, 1024);
+        batch.serialize(&pbatch, segment_v2::CompressionTypePB::NO_COMPRESSION);
+    }
+    pbatch.set_tuple_data_in_attachment(true);
+    std::unique_ptr<butil::IOBuf> attachment(new butil::IOBuf());
+    move_string_to_iobuf(pbatch.mutable_tuple_data(), attachment.get());
+    ASSERT_EQ(1, attachment->backing_block_num());
+    const char* received = attachment->backing_block(0).data();
+    size_t received_size = attachment->size();
+
+    RowBatch dst(*_row_desc, 1024, _tracker.get());
+    {
+        std::unique_ptr<RowBatch> batch(
+                new RowBatch(*_row_desc, pbatch, attachment.get(), _tracker.get()));
+        ASSERT_EQ(1024, batch->num_rows());
+        // the tuples and strings point into the received buffer
+        auto tuple = (const char*)batch->get_row(0)->get_tuple(0);
+        ASSERT_TRUE(tuple >= received && tuple < received + received_size);
+        auto slot = (StringValue*)batch->get_row(0)->get_tuple(0)->get_slot(
+                _tuple_desc->slots()[1]->tuple_offset());
+        ASSERT_TRUE(slot->ptr >= received && slot->ptr < received + received_size);
+        // the buffer is kept by the batch whichever owns its resources
+        dst.acquire_state(batch.get());
+    }
+    attachment.reset();
+    ASSERT_EQ(1024, dst.num_rows());
+    for (int i = 0; i < 1024; ++i) {
+        Tuple* tuple = dst.get_row(i)->get_tuple(0);
+        ASSERT_EQ(i, *(int32_t*)tuple->get_slot(_tuple_desc->slots()[0]->tuple_offset()));
+        auto slot = (StringValue*)tuple->get_slot(_tuple_desc->slots()[1]->tuple_offset());
+        ASSERT_EQ("value_" + std::to_string(i % 10), slot->to_string());
+    }
+    config::deserialize_row_batch_in_place = false;
+}
+
+} // namespace doris
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
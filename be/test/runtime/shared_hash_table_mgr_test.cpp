@@ -0,0 +1,112 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "runtime/shared_hash_table_mgr.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "util/logging.h"
+
+namespace doris {
+
+TEST(SharedHashTableMgrTest, GetAndRelease) {
+    SharedHashTableMgr mgr;
+    TUniqueId query_id;
+    query_id.hi = 1;
+    query_id.lo = 2;
+    TUniqueId other_query_id;
+    other_query_id.hi = 1;
+    other_query_id.lo = 3;
+
+    std::shared_ptr<SharedHashTable> first = mgr.get(query_id, 1);
+    std::shared_ptr<SharedHashTable> second = mgr.get(query_id, 1);
+    ASSERT_EQ(first, second);
+    // other joins and other queries don't share it
+    std::shared_ptr<SharedHashTable> other_node = mgr.get(query_id, 2);
+    std::shared_ptr<SharedHashTable> other_query = mgr.get(other_query_id, 1);
+    ASSERT_NE(first, other_node);
+    ASSERT_NE(first, other_query);
+
+    first->building = true;
+    mgr.release(query_id, 1, &first);
+    ASSERT_EQ(nullptr, first);
+    // held by the second instance
+    std::shared_ptr<SharedHashTable> third = mgr.get(query_id, 1);
+    ASSERT_EQ(second, third);
+    ASSERT_TRUE(third->building);
+    mgr.release(query_id, 1, &second);
+    mgr.release(query_id, 1, &third);
+    mgr.release(query_id, 2, &other_node);
+    mgr.release(other_query_id, 1, &other_query);
+    ASSERT_TRUE(mgr._tables.empty());
+
+    // a later query of the same id builds its table again
+    std::shared_ptr<SharedHashTable> again = mgr.get(query_id, 1);
+    ASSERT_FALSE(again->building);
+    mgr.release(query_id, 1, &again);
+}
+
+TEST(SharedHashTableMgrTest, ConcurrentInstances) {
+    SharedHashTableMgr mgr;
+    TUniqueId query_id;
+    const int num_instances = 16;
+    const int num_nodes = 4;
+    std::vector<std::shared_ptr<SharedHashTable>> tables(num_instances * num_nodes);
+    std::vector<int> builders(num_instances * num_nodes, 0);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < num_instances; ++i) {
+        threads.emplace_back([&, i]() {
+            for (int node = 0; node < num_nodes; ++node) {
+                std::shared_ptr<SharedHashTable> table = mgr.get(query_id, node);
+                {
+                    std::lock_guard<std::mutex> l(table->lock);
+                    builders[i * num_nodes + node] = !table->building;
+                    table->building = true;
+                }
+                tables[i * num_nodes + node] = table;
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    // one instance builds the table of each join, the others share it
+    for (int node = 0; node < num_nodes; ++node) {
+        int num_builders = 0;
+        for (int i = 0; i < num_instances; ++i) {
+            ASSERT_EQ(tables[node], tables[i * num_nodes + node]);
+            num_builders += builders[i * num_nodes + node];
+        }
+        ASSERT_EQ(1, num_builders);
+    }
+    for (int i = 0; i < num_instances * num_nodes; ++i) {
+        mgr.release(query_id, i % num_nodes, &tables[i]);
+    }
+    ASSERT_TRUE(mgr._tables.empty());
+}
+
+} // namespace doris
+
+int main(int argc, char** argv) {
+    doris::init_glog("be-test");
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
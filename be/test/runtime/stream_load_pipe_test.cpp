@@ -19,7 +19,9 @@
 
 #include <gtest/gtest.h>
 
+#include <string>
 #include <thread>
+#include <vector>
 
 #include "util/monotime.h"
 
@@ -255,6 +257,28 @@ TEST_F(StreamLoadPipeTest, close) {
     t1.join();
 }
 
+TEST_F(StreamLoadPipeTest, read_line_chunk) {
+    StreamLoadPipe pipe(1024, 64);
+    std::string data = "a\nbb\nccc\ndddddddddd\ne";
+    ASSERT_TRUE(pipe.append_and_flush(data.data(), data.size()).ok());
+    ASSERT_TRUE(pipe.finish().ok());
+
+    // a chunk ends at the last line delimiter, a longer line makes a larger chunk
+    std::vector<std::string> expected = {"a\nbb\n", "ccc\n", "dddddddddd\n", "e"};
+    for (int64_t i = 0; i < expected.size(); ++i) {
+        int64_t seq = -1;
+        ByteBufferPtr chunk;
+        ASSERT_TRUE(pipe.read_line_chunk('\n', 6, &seq, &chunk).ok());
+        ASSERT_TRUE(chunk != nullptr);
+        ASSERT_EQ(i, seq);
+        ASSERT_EQ(expected[i], std::string(chunk->ptr, chunk->remaining()));
+    }
+    int64_t seq = -1;
+    ByteBufferPtr chunk;
+    ASSERT_TRUE(pipe.read_line_chunk('\n', 6, &seq, &chunk).ok());
+    ASSERT_TRUE(chunk == nullptr);
+}
+
 } // namespace doris
 
 int main(int argc, char* argv[]) {
@@ -0,0 +1,72 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "runtime/string_search.hpp"
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <string>
+
+namespace doris {
+
+static int search(const std::string& pattern, const std::string& str) {
+    StringValue pattern_value(pattern);
+    StringValue str_value(str);
+    return StringSearch(&pattern_value).search(&str_value);
+}
+
+TEST(StringSearchTest, basic) {
+    ASSERT_EQ(-1, search("", "abc"));
+    ASSERT_EQ(1, search("b", "abc"));
+    ASSERT_EQ(0, search("abc", "abc"));
+    ASSERT_EQ(-1, search("abcd", "abc"));
+    ASSERT_EQ(-1, search("ac", "abc"));
+    std::string url = "http://www.example.com/path/to/some/page.html?query=1&utm_source=x";
+    ASSERT_EQ(url.find("utm_source"), search("utm_source", url));
+    ASSERT_EQ(url.find('?'), search("?", url));
+    ASSERT_EQ(-1, search("utm_campaign", url));
+    // matches in the tail that doesn't fill a register
+    ASSERT_EQ(url.size() - 2, search("=x", url));
+}
+
+TEST(StringSearchTest, same_as_find) {
+    std::mt19937 rng(0);
+    // a small alphabet has many partial matches
+    std::uniform_int_distribution<int> ch('a', 'c');
+    for (int iter = 0; iter < 2000; ++iter) {
+        std::string str(rng() % 100, 'a');
+        for (char& c : str) {
+            c = ch(rng);
+        }
+        std::string pattern(1 + rng() % 6, 'a');
+        for (char& c : pattern) {
+            c = ch(rng);
+        }
+        size_t expected = str.find(pattern);
+        int pos = search(pattern, str);
+        ASSERT_EQ(expected == std::string::npos ? -1 : static_cast<int>(expected), pos)
+                << "pattern=" << pattern << " str=" << str;
+    }
+}
+
+} // namespace doris
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
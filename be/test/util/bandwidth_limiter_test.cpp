@@ -0,0 +1,85 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "util/bandwidth_limiter.h"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+#include "util/time.h"
+
+namespace doris {
+
+TEST(BandwidthLimiterTest, Unlimited) {
+    BandwidthLimiter limiter;
+    int64_t start = MonotonicMillis();
+    for (int i = 0; i < 100; ++i) {
+        limiter.acquire(1024 * 1024 * 1024);
+    }
+    ASSERT_LT(MonotonicMillis() - start, 100);
+}
+
+TEST(BandwidthLimiterTest, Rate) {
+    // 10 MB at 20 MB/s takes about 0.5s, the first MB passes at once
+    BandwidthLimiter limiter(20 * 1024 * 1024);
+    int64_t start = MonotonicMillis();
+    for (int i = 0; i < 10; ++i) {
+        limiter.acquire(1024 * 1024);
+    }
+    int64_t elapsed_ms = MonotonicMillis() - start;
+    ASSERT_GE(elapsed_ms, 400);
+    ASSERT_LT(elapsed_ms, 2000);
+}
+
+TEST(BandwidthLimiterTest, SharedByThreads) {
+    BandwidthLimiter limiter(40 * 1024 * 1024);
+    int64_t start = MonotonicMillis();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&limiter]() {
+            for (int i = 0; i < 5; ++i) {
+                limiter.acquire(1024 * 1024);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    // 20 MB at 40 MB/s in total
+    int64_t elapsed_ms = MonotonicMillis() - start;
+    ASSERT_GE(elapsed_ms, 400);
+    ASSERT_LT(elapsed_ms, 2000);
+}
+
+TEST(BandwidthLimiterTest, SetRate) {
+    BandwidthLimiter limiter(1024);
+    limiter.set_rate(0);
+    int64_t start = MonotonicMillis();
+    limiter.acquire(1024 * 1024);
+    limiter.acquire(1024 * 1024);
+    ASSERT_LT(MonotonicMillis() - start, 100);
+}
+
+} // namespace doris
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -65,6 +65,40 @@ TEST(BitmapValueTest, bitmap_union) {
     ASSERT_EQ(5, bitmap2.cardinality());
 }
 
+TEST(BitmapValueTest, bitmap_fastunion) {
+    BitmapValue empty;
+    BitmapValue single(1024);
+    BitmapValue single_high(1ULL << 40);
+    BitmapValue bitmap({1024, 1025, 1026});
+    BitmapValue bitmap_high({1ULL << 40, (1ULL << 40) + 1});
+
+    BitmapValue empty2;
+    empty2.fastunion({&empty});
+    ASSERT_EQ(0, empty2.cardinality());
+    empty2.fastunion({&single, &single, &empty});
+    ASSERT_EQ(1, empty2.cardinality());
+
+    BitmapValue single3(2048);
+    BitmapValue singles;
+    singles.fastunion({&single, &single_high, &single3});
+    ASSERT_EQ(3, singles.cardinality());
+
+    BitmapValue single2(7);
+    single2.fastunion({&bitmap, &bitmap_high, &single});
+    ASSERT_EQ(6, single2.cardinality());
+    ASSERT_TRUE(single2.contains(7));
+    ASSERT_TRUE(single2.contains((1ULL << 40) + 1));
+
+    // same as unioning one by one
+    BitmapValue expected({1, 2, 3});
+    expected |= bitmap;
+    expected |= single_high;
+    expected |= bitmap_high;
+    BitmapValue bitmap2({1, 2, 3});
+    bitmap2.fastunion({&bitmap, &single_high, &bitmap_high});
+    ASSERT_EQ(expected.to_string(), bitmap2.to_string());
+}
+
 TEST(BitmapValueTest, bitmap_intersect) {
     BitmapValue empty;
     BitmapValue single(1024);
@@ -101,6 +101,7 @@ TEST_F(BlockCompressionTest, single) {
     test_single_slice(segment_v2::CompressionTypePB::ZLIB);
     test_single_slice(segment_v2::CompressionTypePB::LZ4);
     test_single_slice(segment_v2::CompressionTypePB::LZ4F);
+    test_single_slice(segment_v2::CompressionTypePB::ZSTD);
 }
 
 void test_multi_slices(segment_v2::CompressionTypePB type) {
@@ -151,11 +152,34 @@ void test_multi_slices(segment_v2::CompressionTypePB type) {
     }
 }
 
+TEST_F(BlockCompressionTest, zstd_level) {
+    auto orig = generate_str(100000);
+    int levels[] = {-1, 0, 1, 9, 19, 100};
+    for (auto level : levels) {
+        const BlockCompressionCodec* codec = nullptr;
+        auto st = get_block_compression_codec(segment_v2::CompressionTypePB::ZSTD, level, &codec);
+        ASSERT_TRUE(st.ok());
+        std::string compressed;
+        compressed.resize(codec->max_compressed_len(orig.size()));
+        Slice compressed_slice(compressed);
+        st = codec->compress(orig, &compressed_slice);
+        ASSERT_TRUE(st.ok());
+
+        std::string uncompressed;
+        uncompressed.resize(orig.size());
+        Slice uncompressed_slice(uncompressed);
+        st = codec->decompress(compressed_slice, &uncompressed_slice);
+        ASSERT_TRUE(st.ok());
+        ASSERT_EQ(orig, uncompressed);
+    }
+}
+
 TEST_F(BlockCompressionTest, multi) {
     test_multi_slices(segment_v2::CompressionTypePB::SNAPPY);
     test_multi_slices(segment_v2::CompressionTypePB::ZLIB);
     test_multi_slices(segment_v2::CompressionTypePB::LZ4);
     test_multi_slices(segment_v2::CompressionTypePB::LZ4F);
+    test_multi_slices(segment_v2::CompressionTypePB::ZSTD);
 }
 
 } // namespace doris
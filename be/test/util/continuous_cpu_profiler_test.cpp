@@ -0,0 +1,83 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "util/continuous_cpu_profiler.h"
+
+#include <gtest/gtest.h>
+
+#include "util/time.h"
+
+namespace doris {
+
+static void burn_cpu() {
+    volatile uint64_t sum = 0;
+    for (int i = 0; i < 100 * 1000 * 1000; ++i) {
+        sum = sum + i;
+    }
+}
+
+TEST(ContinuousCpuProfilerTest, TaggedSamples) {
+    ContinuousCpuProfiler* profiler = ContinuousCpuProfiler::instance();
+    ASSERT_FALSE(profiler->start(0, 100).ok());
+    ASSERT_FALSE(profiler->started());
+    ASSERT_TRUE(profiler->start(1, 1000).ok());
+    ASSERT_TRUE(profiler->started());
+    ASSERT_FALSE(profiler->start(1, 1000).ok());
+
+    TUniqueId query_id;
+    query_id.hi = 1;
+    query_id.lo = 2;
+    int64_t start_ms = UnixMillis();
+    {
+        ScopedCpuProfilerTag tag(query_id, ContinuousCpuProfiler::SCANNER);
+        burn_cpu();
+    }
+    burn_cpu();
+    int64_t end_ms = UnixMillis();
+
+    std::vector<ContinuousCpuProfiler::Sample> samples;
+    profiler->get_samples(start_ms, end_ms, &query_id, "", &samples);
+    ASSERT_FALSE(samples.empty());
+    for (const auto& sample : samples) {
+        ASSERT_STREQ(ContinuousCpuProfiler::SCANNER, sample.tag.role);
+        ASSERT_EQ(2, sample.tag.query_id_lo);
+        ASSERT_GE(sample.timestamp_ms, start_ms);
+        ASSERT_GT(sample.depth, 0);
+    }
+
+    // the tag is restored at the end of the scope
+    samples.clear();
+    profiler->get_samples(start_ms, end_ms, nullptr, "other", &samples);
+    ASSERT_FALSE(samples.empty());
+    for (const auto& sample : samples) {
+        ASSERT_EQ(0, sample.tag.query_id_hi);
+    }
+
+    samples.clear();
+    profiler->get_samples(start_ms, end_ms, nullptr, ContinuousCpuProfiler::COMPACTION,
+                          &samples);
+    ASSERT_TRUE(samples.empty());
+    profiler->get_samples(end_ms + 1000, end_ms + 2000, nullptr, "", &samples);
+    ASSERT_TRUE(samples.empty());
+}
+
+} // namespace doris
+
+int main(int argc, char* argv[]) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
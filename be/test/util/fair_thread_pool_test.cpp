@@ -0,0 +1,133 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "util/fair_thread_pool.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace doris {
+
+TEST(FairThreadPoolTest, RunAllTasks) {
+    std::atomic<int> count(0);
+    RuntimeProfile::Counter wait_timer(TUnit::TIME_NS);
+    {
+        FairThreadPool pool(4, 1024);
+        for (int i = 0; i < 1000; ++i) {
+            FairThreadPool::Task task;
+            task.work_function = [&count]() { ++count; };
+            task.queue_wait_timer = &wait_timer;
+            ASSERT_TRUE(pool.offer(UniqueId(i % 7, 0), task));
+        }
+        while (count < 1000) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        ASSERT_EQ(0, pool.get_queue_size());
+        ASSERT_EQ(0, pool.num_groups());
+        pool.shutdown();
+        FairThreadPool::Task task;
+        task.work_function = [&count]() { ++count; };
+        ASSERT_FALSE(pool.offer(UniqueId(0, 0), task));
+    }
+    ASSERT_EQ(1000, count);
+}
+
+TEST(FairThreadPoolTest, GroupsAreServedRoundRobin) {
+    FairThreadPool pool(1, 1024);
+
+    // block the only worker until all tasks are offered
+    std::mutex lock;
+    std::condition_variable cv;
+    bool started = false;
+    bool released = false;
+    FairThreadPool::Task blocker;
+    blocker.work_function = [&]() {
+        std::unique_lock<std::mutex> l(lock);
+        started = true;
+        cv.notify_all();
+        cv.wait(l, [&]() { return released; });
+    };
+    ASSERT_TRUE(pool.offer(UniqueId(0, 0), blocker));
+    {
+        std::unique_lock<std::mutex> l(lock);
+        cv.wait(l, [&]() { return started; });
+    }
+
+    // a heavy group offers many tasks before a light group offers one
+    std::vector<int> order;
+    for (int i = 0; i < 100; ++i) {
+        FairThreadPool::Task task;
+        task.work_function = [&order]() { order.push_back(1); };
+        ASSERT_TRUE(pool.offer(UniqueId(1, 0), task));
+    }
+    FairThreadPool::Task light;
+    light.work_function = [&order]() { order.push_back(2); };
+    ASSERT_TRUE(pool.offer(UniqueId(2, 0), light));
+    ASSERT_EQ(2, pool.num_groups());
+
+    {
+        std::lock_guard<std::mutex> l(lock);
+        released = true;
+    }
+    cv.notify_all();
+    while (pool.get_queue_size() > 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    pool.shutdown();
+    pool.join();
+
+    ASSERT_EQ(101, order.size());
+    // the light task doesn't wait for all tasks of the heavy group
+    auto pos = std::find(order.begin(), order.end(), 2) - order.begin();
+    ASSERT_LT(pos, 2);
+}
+
+TEST(FairThreadPoolTest, IdleWorkerSteals) {
+    FairThreadPool pool(2, 1024);
+    std::atomic<int> count(0);
+    std::mutex lock;
+    std::vector<std::thread::id> thread_ids;
+    for (int i = 0; i < 64; ++i) {
+        FairThreadPool::Task task;
+        task.work_function = [&]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            std::lock_guard<std::mutex> l(lock);
+            thread_ids.push_back(std::this_thread::get_id());
+            ++count;
+        };
+        ASSERT_TRUE(pool.offer(UniqueId(i, 0), task));
+    }
+    while (count < 64) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    std::sort(thread_ids.begin(), thread_ids.end());
+    ASSERT_EQ(2, std::unique(thread_ids.begin(), thread_ids.end()) - thread_ids.begin());
+}
+
+} // namespace doris
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -19,6 +19,11 @@
 
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
 #include "env/env.h"
 
 namespace doris {
@@ -63,6 +68,45 @@ TEST_F(FileCacheTest, normal) {
     ASSERT_EQ(file_handle.file(), file_handle2.file());
 }
 
+TEST_F(FileCacheTest, lookup_or_open) {
+    std::atomic<int> num_opens(0);
+    auto open_func = [this, &num_opens](std::unique_ptr<RandomAccessFile>* file) {
+        ++num_opens;
+        // make concurrent misses overlap
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        return Env::Default()->new_random_access_file(_file_exist, file);
+    };
+
+    std::vector<RandomAccessFile*> files(8, nullptr);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < files.size(); ++i) {
+        threads.emplace_back([this, i, &open_func, &files]() {
+            OpenedFileHandle<RandomAccessFile> file_handle;
+            ASSERT_TRUE(_file_cache->lookup_or_open(_file_exist, open_func, &file_handle).ok());
+            files[i] = file_handle.file();
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    ASSERT_EQ(1, num_opens);
+    for (auto file : files) {
+        ASSERT_EQ(files[0], file);
+    }
+
+    // opening a missing file fails
+    OpenedFileHandle<RandomAccessFile> file_handle;
+    bool opened = true;
+    auto st = _file_cache->lookup_or_open(
+            "file_not_exist",
+            [](std::unique_ptr<RandomAccessFile>* file) {
+                return Env::Default()->new_random_access_file("file_not_exist", file);
+            },
+            &file_handle, &opened);
+    ASSERT_FALSE(st.ok());
+    ASSERT_FALSE(opened);
+}
+
 } // namespace doris
 
 int main(int argc, char* argv[]) {
@@ -0,0 +1,58 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "util/huge_page_util.h"
+
+#include <gtest/gtest.h>
+#include <sys/mman.h>
+
+#include <cstring>
+
+#include "common/config.h"
+
+namespace doris {
+
+TEST(HugePageUtilTest, use_huge_pages) {
+    config::madvise_huge_pages = false;
+    ASSERT_FALSE(HugePageUtil::use_huge_pages(HugePageUtil::HUGE_PAGE_SIZE));
+    config::madvise_huge_pages = true;
+    ASSERT_TRUE(HugePageUtil::use_huge_pages(HugePageUtil::HUGE_PAGE_SIZE));
+    ASSERT_TRUE(HugePageUtil::use_huge_pages(4 * HugePageUtil::HUGE_PAGE_SIZE));
+    ASSERT_FALSE(HugePageUtil::use_huge_pages(1024 * 1024));
+    ASSERT_FALSE(HugePageUtil::use_huge_pages(0));
+}
+
+TEST(HugePageUtilTest, map) {
+    config::madvise_huge_pages = true;
+    // without pages reserved by hugetlbfs, it falls back to transparent huge pages
+    for (bool use_hugetlb_pages : {false, true}) {
+        config::use_hugetlb_pages = use_hugetlb_pages;
+        int64_t len = 2 * HugePageUtil::HUGE_PAGE_SIZE;
+        uint8_t* mem = HugePageUtil::map(len);
+        ASSERT_TRUE(mem != nullptr);
+        ASSERT_EQ(0, reinterpret_cast<uintptr_t>(mem) % HugePageUtil::HUGE_PAGE_SIZE);
+        memset(mem, 1, len);
+        ASSERT_EQ(0, munmap(mem, len));
+    }
+}
+
+} // namespace doris
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,61 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "util/iobuf_util.h"
+
+#include "service/brpc.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+namespace doris {
+
+TEST(IOBufUtilTest, MoveString) {
+    std::string expected(100000, 'a');
+    for (int i = 0; i < expected.size(); ++i) {
+        expected[i] = 'a' + i % 26;
+    }
+    std::string str = expected;
+    const char* data = str.data();
+
+    butil::IOBuf buf;
+    buf.append("head");
+    move_string_to_iobuf(&str, &buf);
+    ASSERT_TRUE(str.empty());
+    ASSERT_EQ(2, buf.backing_block_num());
+    // not copied
+    ASSERT_EQ(data, buf.backing_block(1).data());
+
+    // the data lives as long as any IOBuf references it
+    butil::IOBuf shared;
+    shared.append(buf);
+    buf.clear();
+    ASSERT_EQ("head" + expected, shared.to_string());
+    shared.clear();
+
+    std::string empty;
+    move_string_to_iobuf(&empty, &buf);
+    ASSERT_TRUE(buf.empty());
+}
+
+} // namespace doris
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
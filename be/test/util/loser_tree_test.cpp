@@ -0,0 +1,109 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "util/loser_tree.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace doris {
+
+class LoserTreeTest : public testing::Test {
+public:
+    struct RunLess {
+        LoserTreeTest* test;
+        bool operator()(int lhs, int rhs) const {
+            ++test->_num_compares;
+            return test->current(lhs) < test->current(rhs);
+        }
+    };
+
+    int current(int run) const { return _runs[run][_pos[run]]; }
+
+    // merges _runs and checks the output
+    void merge() {
+        std::vector<int> expected;
+        for (auto& run : _runs) {
+            expected.insert(expected.end(), run.begin(), run.end());
+        }
+        std::sort(expected.begin(), expected.end());
+
+        _pos.assign(_runs.size(), 0);
+        _num_compares = 0;
+        LoserTree<RunLess> tree(RunLess{this});
+        tree.init(_runs.size());
+        std::vector<int> output;
+        while (tree.winner() >= 0) {
+            int run = tree.winner();
+            output.push_back(current(run));
+            ++_pos[run];
+            tree.update_winner(_pos[run] == _runs[run].size());
+        }
+        ASSERT_EQ(expected, output);
+    }
+
+protected:
+    std::vector<std::vector<int>> _runs;
+    std::vector<size_t> _pos;
+    int64_t _num_compares = 0;
+};
+
+TEST_F(LoserTreeTest, Empty) {
+    LoserTree<RunLess> tree(RunLess{this});
+    tree.init(0);
+    ASSERT_EQ(-1, tree.winner());
+}
+
+TEST_F(LoserTreeTest, RandomRuns) {
+    std::mt19937 rng(0);
+    for (int num_runs : {1, 2, 3, 7, 8, 100, 200}) {
+        _runs.clear();
+        for (int i = 0; i < num_runs; ++i) {
+            std::vector<int> run(1 + rng() % 50);
+            for (auto& v : run) {
+                v = rng() % 1000;
+            }
+            std::sort(run.begin(), run.end());
+            _runs.push_back(run);
+        }
+        merge();
+    }
+}
+
+TEST_F(LoserTreeTest, RangeRuns) {
+    // each run holds a range of the output, the merge costs about one comparison
+    // per element
+    for (int i = 0; i < 64; ++i) {
+        std::vector<int> run;
+        for (int j = 0; j < 1000; ++j) {
+            run.push_back(i * 1000 + j);
+        }
+        _runs.push_back(run);
+    }
+    merge();
+    ASSERT_LT(_num_compares, 2 * 64 * 1000);
+}
+
+} // namespace doris
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -405,6 +405,96 @@ test_registry_cpu{mode="guest"} 58
         registry.deregister_entity(entity);
     }
 }
+
+TEST_F(MetricsTest, HistogramBuckets) {
+    for (int64_t value = 0; value < 100000; ++value) {
+        int index = HistogramMetric::bucket_index(value);
+        ASSERT_LE(value, HistogramMetric::bucket_upper_bound(index));
+        if (index > 0) {
+            ASSERT_GT(value, HistogramMetric::bucket_upper_bound(index - 1));
+        }
+    }
+    int last = HistogramMetric::NUM_BUCKETS - 1;
+    ASSERT_EQ(1L << 40, HistogramMetric::bucket_upper_bound(last));
+    ASSERT_EQ(last, HistogramMetric::bucket_index(1L << 40));
+    ASSERT_EQ(last, HistogramMetric::bucket_index(1L << 50));
+}
+
+TEST_F(MetricsTest, Histogram) {
+    HistogramMetric histogram;
+    ASSERT_EQ(0, histogram.count());
+    ASSERT_EQ(0, histogram.percentile(99));
+    for (int i = 1; i <= 1000; ++i) {
+        histogram.add(i);
+    }
+    ASSERT_EQ(1000, histogram.count());
+    ASSERT_EQ(500500, histogram.sum());
+    ASSERT_EQ(1, histogram.percentile(0));
+    // within a quarter of the exact ones
+    ASSERT_NEAR(500, histogram.percentile(50), 125);
+    ASSERT_NEAR(990, histogram.percentile(99), 250);
+    ASSERT_LE(histogram.percentile(50), histogram.percentile(90));
+    ASSERT_LE(histogram.percentile(90), histogram.percentile(99));
+    ASSERT_EQ("count=1000 sum=500500 p50=500 p90=900 p99=1011 p999=1024",
+              histogram.to_string());
+
+    // the percentiles of the values added after a copy of the counts
+    int64_t last_counts[HistogramMetric::NUM_BUCKETS];
+    histogram.get_counts(last_counts);
+    for (int i = 0; i < 100; ++i) {
+        histogram.add(100000);
+    }
+    int64_t counts[HistogramMetric::NUM_BUCKETS];
+    histogram.get_counts(counts);
+    for (int i = 0; i < HistogramMetric::NUM_BUCKETS; ++i) {
+        counts[i] -= last_counts[i];
+    }
+    ASSERT_NEAR(100000, HistogramMetric::percentile_of_counts(counts, 50), 25000);
+    ASSERT_EQ(histogram.percentile(50), HistogramMetric::percentile_of_counts(last_counts, 50));
+
+    // multi-thread
+    HistogramMetric mt_histogram;
+    std::vector<std::thread> updaters;
+    for (int i = 0; i < 8; ++i) {
+        updaters.emplace_back([&mt_histogram]() {
+            for (int j = 0; j < 100000; ++j) {
+                mt_histogram.add(j % 100);
+            }
+        });
+    }
+    for (auto& updater : updaters) {
+        updater.join();
+    }
+    ASSERT_EQ(8 * 100000, mt_histogram.count());
+}
+
+TEST_F(MetricsTest, HistogramOutput) {
+    MetricRegistry registry("test_registry");
+    auto entity = registry.register_entity("test_entity");
+    MetricPrototype latency_type(MetricType::HISTOGRAM, MetricUnit::MICROSECONDS, "latency_us",
+                                 "", "rpc_latency_us", {{"method", "get"}});
+    HistogramMetric* latency =
+            (HistogramMetric*)entity->register_metric<HistogramMetric>(&latency_type);
+    latency->add(1);
+    latency->add(3);
+    latency->add(6);
+
+    ASSERT_EQ(R"(# TYPE test_registry_rpc_latency_us histogram
+test_registry_rpc_latency_us_bucket{method="get",le="1"} 1
+test_registry_rpc_latency_us_bucket{method="get",le="2"} 1
+test_registry_rpc_latency_us_bucket{method="get",le="4"} 2
+test_registry_rpc_latency_us_bucket{method="get",le="8"} 3
+test_registry_rpc_latency_us_bucket{method="get",le="+Inf"} 3
+test_registry_rpc_latency_us_sum{method="get"} 10
+test_registry_rpc_latency_us_count{method="get"} 3
+)",
+              registry.to_prometheus());
+    ASSERT_EQ(
+            R"([{"tags":{"metric":"rpc_latency_us","method":"get"},"unit":"microseconds","value":{"count":3,"sum":10,"p50":3,"p90":6,"p99":6,"p999":6}}])",
+            registry.to_json());
+    registry.deregister_entity(entity);
+}
+
 } // namespace doris
 
 int main(int argc, char** argv) {
@@ -0,0 +1,77 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "util/stopwatch.hpp"
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include "util/runtime_profile.h"
+
+namespace doris {
+
+static void burn_cpu(uint64_t ns) {
+    MonotonicStopWatch watch;
+    watch.start();
+    volatile uint64_t sum = 0;
+    while (watch.elapsed_time() < ns) {
+        sum = sum + 1;
+    }
+}
+
+TEST(StopWatchTest, ThreadCpuTimeSkipsSleep) {
+    MonotonicStopWatch wall_watch;
+    ThreadCpuStopWatch cpu_watch;
+    wall_watch.start();
+    cpu_watch.start();
+    usleep(200 * 1000);
+    cpu_watch.stop();
+    wall_watch.stop();
+    ASSERT_GE(wall_watch.elapsed_time(), 200 * 1000 * 1000L);
+    ASSERT_LT(cpu_watch.elapsed_time(), 100 * 1000 * 1000L);
+}
+
+TEST(StopWatchTest, ThreadCpuTimeCountsWork) {
+    ThreadCpuStopWatch cpu_watch;
+    cpu_watch.start();
+    burn_cpu(50 * 1000 * 1000L);
+    cpu_watch.stop();
+    ASSERT_GE(cpu_watch.elapsed_time(), 25 * 1000 * 1000L);
+}
+
+TEST(StopWatchTest, ScopedCpuTimer) {
+    RuntimeProfile profile("profile");
+    RuntimeProfile::Counter* wall_timer = ADD_TIMER(&profile, "WallTime");
+    RuntimeProfile::Counter* cpu_timer = ADD_TIMER(&profile, "CpuTime");
+    {
+        SCOPED_TIMER(wall_timer);
+        SCOPED_CPU_TIMER(cpu_timer);
+        burn_cpu(20 * 1000 * 1000L);
+        usleep(100 * 1000);
+    }
+    ASSERT_GT(cpu_timer->value(), 0);
+    ASSERT_LT(cpu_timer->value(), wall_timer->value());
+    // a null counter is ignored
+    SCOPED_CPU_TIMER(nullptr);
+}
+
+} // namespace doris
+
+int main(int argc, char* argv[]) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -212,6 +212,22 @@ TEST(StringToInt, InvalidLeadingTrailing) {
     test_int_value<int8_t>("   ", 0, StringParser::PARSE_FAILURE);
 }
 
+TEST(StringToInt, EightDigitChunks) {
+    // digits are parsed 8 at a time, with the rest or a non digit one by one
+    test_int_value<int32_t>("12345678", 12345678, StringParser::PARSE_SUCCESS);
+    test_int_value<int32_t>("-123456789", -123456789, StringParser::PARSE_SUCCESS);
+    test_int_value<int64_t>("1234567890123456", 1234567890123456LL, StringParser::PARSE_SUCCESS);
+    test_int_value<int64_t>("000000001234567890", 1234567890, StringParser::PARSE_SUCCESS);
+    test_int_value<int64_t>("+99999999999999999", 99999999999999999LL,
+                            StringParser::PARSE_SUCCESS);
+    test_int_value<int32_t>("1234567x", 0, StringParser::PARSE_FAILURE);
+    test_int_value<int32_t>("12345678x", 0, StringParser::PARSE_FAILURE);
+    test_int_value<int64_t>("1234567890123:56", 0, StringParser::PARSE_FAILURE);
+    test_int_value<int64_t>("12345678 9", 0, StringParser::PARSE_FAILURE);
+    test_unsigned_int_value<uint64_t>("1234567890123456789", 1234567890123456789ULL,
+                                      StringParser::PARSE_SUCCESS);
+}
+
 TEST(StringToInt, Limit) {
     test_int_value<int8_t>("127", 127, StringParser::PARSE_SUCCESS);
     test_int_value<int8_t>("-128", -128, StringParser::PARSE_SUCCESS);
@@ -20,6 +20,7 @@
 #include <gtest/gtest.h>
 
 #include <random>
+#include <vector>
 
 namespace doris {
 
@@ -244,6 +245,48 @@ TEST_F(TDigestTest, Montonicity) {
     }
 }
 
+TEST_F(TDigestTest, MergeSerialized) {
+    std::uniform_real_distribution<> reals(-1.0, 1.0);
+    std::mt19937 gen(0);
+    std::vector<TDigest> digests;
+    digests.reserve(10);
+    std::vector<std::vector<uint8_t>> serialized;
+    for (int i = 0; i < 10; i++) {
+        std::vector<float> values(20000);
+        for (auto& value : values) {
+            value = reals(gen);
+        }
+        digests.emplace_back(1000);
+        digests.back().add(values.data(), values.size());
+        serialized.emplace_back(digests.back().serialized_size());
+        digests.back().serialize(serialized.back().data());
+    }
+
+    TDigest unserialized(1000);
+    unserialized.unserialize(serialized[0].data());
+    EXPECT_EQ(digests[0].quantile(0.5), unserialized.quantile(0.5));
+
+    // the same as merging the unserialized t-digests one by one
+    TDigest expected(1000);
+    TDigest merged(1000);
+    for (auto& s : serialized) {
+        TDigest digest(1000);
+        digest.unserialize(s.data());
+        expected.merge(&digest);
+        merged.merge(std::vector<const uint8_t*>{s.data()});
+    }
+    TDigest batch_merged(1000);
+    std::vector<const uint8_t*> all;
+    for (auto& s : serialized) {
+        all.push_back(s.data());
+    }
+    batch_merged.merge(all);
+    for (double q : {0.0, 0.01, 0.5, 0.99, 1.0}) {
+        EXPECT_EQ(expected.quantile(q), merged.quantile(q)) << q;
+        EXPECT_NEAR(expected.quantile(q), batch_merged.quantile(q), 0.01) << q;
+    }
+}
+
 } // namespace doris
 
 int main(int argc, char** argv) {
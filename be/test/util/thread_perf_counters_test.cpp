@@ -0,0 +1,91 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "util/thread_perf_counters.h"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+namespace doris {
+
+static void burn_cpu() {
+    volatile uint64_t sum = 0;
+    for (int i = 0; i < 10 * 1000 * 1000; ++i) {
+        sum = sum + i;
+    }
+}
+
+TEST(ThreadPerfCountersTest, CountInScope) {
+    RuntimeProfile profile("profile");
+    ThreadPerfCounters counters(&profile, "");
+    ASSERT_NE(nullptr, profile.get_counter("PerfCpuCycles"));
+    ASSERT_NE(nullptr, profile.get_counter("PerfBranchMisses"));
+    if (!ThreadPerfCounters::start_thread_events()) {
+        // the machine, e.g. a vm, can't count any of the events
+        LOG(INFO) << "no hardware events to count";
+        return;
+    }
+    // the events of a thread are counted once at a time
+    ASSERT_FALSE(ThreadPerfCounters::start_thread_events());
+    burn_cpu();
+    counters.stop_thread_events();
+    int64_t instructions = profile.get_counter("PerfInstructions")->value();
+    ASSERT_GT(profile.get_counter("PerfCpuCycles")->value() + instructions, 0);
+
+    // the counts of the scopes are added up
+    {
+        SCOPED_PERF_COUNTERS(&counters);
+        burn_cpu();
+    }
+    if (instructions > 0) {
+        ASSERT_GT(profile.get_counter("PerfInstructions")->value(), instructions);
+    }
+}
+
+TEST(ThreadPerfCountersTest, NullCounters) {
+    RuntimeProfile profile("profile");
+    ThreadPerfCounters counters(&profile, "Scanner");
+    ASSERT_NE(nullptr, profile.get_counter("ScannerPerfCacheMisses"));
+    SCOPED_PERF_COUNTERS(nullptr);
+    // the scope doesn't count the events of the thread
+    if (ThreadPerfCounters::start_thread_events()) {
+        counters.stop_thread_events();
+    }
+}
+
+TEST(ThreadPerfCountersTest, CountPerThread) {
+    RuntimeProfile profile("profile");
+    ThreadPerfCounters counters(&profile, "");
+    auto count = [&counters]() {
+        SCOPED_PERF_COUNTERS(&counters);
+        burn_cpu();
+    };
+    SCOPED_PERF_COUNTERS(&counters);
+    // the other threads count their own events while this one counts its
+    std::thread t1(count);
+    std::thread t2(count);
+    t1.join();
+    t2.join();
+}
+
+} // namespace doris
+
+int main(int argc, char* argv[]) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
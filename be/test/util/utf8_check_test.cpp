@@ -19,6 +19,11 @@
 
 #include <gtest/gtest.h>
 
+#include <cstring>
+#include <string>
+
+#include "util/cpu_info.h"
+
 namespace doris {
 
 struct test {
@@ -106,6 +111,17 @@ TEST_F(Utf8CheckTest, abnormal) {
     }
 }
 
+// The default implementation, which the CPUs without AVX2 use
+TEST_F(Utf8CheckTest, without_avx2) {
+    CpuInfo::TempDisable disable_avx2(CpuInfo::AVX2);
+    for (const auto& t : pos) {
+        ASSERT_TRUE(validate_utf8(t.data, t.len));
+    }
+    for (const auto& t : neg) {
+        ASSERT_FALSE(validate_utf8(t.data, t.len));
+    }
+}
+
 TEST_F(Utf8CheckTest, naive) {
     for (int i = 0; i < sizeof(pos) / sizeof(pos[0]); ++i) {
         ASSERT_TRUE(validate_utf8_naive(pos[i].data, pos[i].len));
@@ -116,9 +132,26 @@ TEST_F(Utf8CheckTest, naive) {
     }
 }
 
+TEST_F(Utf8CheckTest, ascii) {
+    std::string str = "0123456789abcdefghijklmnopqrstuvwxyz\x7f";
+    for (int len = 0; len <= str.size(); ++len) {
+        ASSERT_TRUE(validate_ascii(str.data(), len));
+        ASSERT_TRUE(validate_ascii_naive(str.data(), len));
+    }
+    // a non ascii byte in each position, in the simd registers and in the tail
+    for (int i = 0; i < str.size(); ++i) {
+        std::string non_ascii = str;
+        non_ascii[i] = '\x80';
+        ASSERT_FALSE(validate_ascii(non_ascii.data(), non_ascii.size()));
+        ASSERT_FALSE(validate_ascii_naive(non_ascii.data(), non_ascii.size()));
+    }
+    ASSERT_FALSE(validate_ascii("你好", strlen("你好")));
+}
+
 } // namespace doris
 
 int main(int argc, char* argv[]) {
+    doris::CpuInfo::init();
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
 }
@@ -137,6 +137,12 @@ fi
 if [[ -z ${WITH_LZO} ]]; then
     WITH_LZO=OFF
 fi
+if [[ -z ${BUILD_BENCHMARK} ]]; then
+    BUILD_BENCHMARK=OFF
+fi
+if [[ -z ${USE_AVX2} ]]; then
+    USE_AVX2=OFF
+fi
 
 echo "Get params:
     BUILD_BE            -- $BUILD_BE
@@ -147,6 +153,8 @@ echo "Get params:
     RUN_UT              -- $RUN_UT
     WITH_MYSQL          -- $WITH_MYSQL
     WITH_LZO            -- $WITH_LZO
+    BUILD_BENCHMARK     -- $BUILD_BENCHMARK
+    USE_AVX2            -- $USE_AVX2
 "
 
 # Clean and build generated code
@@ -171,7 +179,7 @@ if [ ${BUILD_BE} -eq 1 ] ; then
     fi
     mkdir -p ${CMAKE_BUILD_DIR}
     cd ${CMAKE_BUILD_DIR}
-    ${CMAKE_CMD} -DCMAKE_BUILD_TYPE=${CMAKE_BUILD_TYPE} -DMAKE_TEST=OFF -DWITH_MYSQL=${WITH_MYSQL} -DWITH_LZO=${WITH_LZO} ../
+    ${CMAKE_CMD} -DCMAKE_BUILD_TYPE=${CMAKE_BUILD_TYPE} -DMAKE_TEST=OFF -DWITH_MYSQL=${WITH_MYSQL} -DWITH_LZO=${WITH_LZO} -DBUILD_BENCHMARK=${BUILD_BENCHMARK} -DUSE_AVX2=${USE_AVX2} ../
     make -j${PARALLEL}
     make install
     cd ${DORIS_HOME}
@@ -174,6 +174,19 @@ public class Alter {
                     "Table[" + olapTable.getName() + "]'s state is not NORMAL. Do not allow doing ALTER ops");
         }
 
+        if ((currentAlterOps.hasSchemaChangeOp() || currentAlterOps.hasRollupOp())
+                && olapTable.getEnableUniqueKeyMergeOnWrite()) {
+            throw new DdlException("Schema change and rollup of merge-on-write table["
+                    + olapTable.getName() + "] are not supported");
+        }
+
+        // the rows of the base tablets are not sorted by keys, which schema change and rollup rely on
+        if ((currentAlterOps.hasSchemaChangeOp() || currentAlterOps.hasRollupOp())
+                && !olapTable.getClusteringColumns().isEmpty()) {
+            throw new DdlException("Schema change and rollup of clustered table["
+                    + olapTable.getName() + "] are not supported");
+        }
+
         boolean needProcessOutsideDatabaseLock = false;
         if (currentAlterOps.hasSchemaChangeOp()) {
             // if modify storage type to v2, do schema change to convert all related tablets to segment v2 format
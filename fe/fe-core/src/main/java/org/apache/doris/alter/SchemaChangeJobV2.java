@@ -260,6 +260,7 @@ public class SchemaChangeJobV2 extends AlterJobV2 {
                             if (this.storageFormat != null) {
                                 createReplicaTask.setStorageFormat(this.storageFormat);
                             }
+                            createReplicaTask.setCompression(tbl.getCompressionType(), tbl.getCompressionLevel());
 
                             batchTask.addTask(createReplicaTask);
                         } // end for rollupReplicas
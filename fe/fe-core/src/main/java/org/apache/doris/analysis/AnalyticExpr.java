@@ -210,14 +210,6 @@ public class AnalyticExpr extends Expr {
         return fn.functionName().equalsIgnoreCase(LEAD) || fn.functionName().equalsIgnoreCase(LAG);
     }
 
-    static private boolean isMinMax(Function fn) {
-        if (!isAnalyticFn(fn)) {
-            return false;
-        }
-
-        return fn.functionName().equalsIgnoreCase(MIN) || fn.functionName().equalsIgnoreCase(MAX);
-    }
-
     static private boolean isRankingFn(Function fn) {
         if (!isAnalyticFn(fn)) {
             return false;
@@ -476,15 +468,6 @@ public class AnalyticExpr extends Expr {
 
         standardize(analyzer);
 
-        // min/max is not currently supported on sliding windows (i.e. start bound is not
-        // unbounded).
-        if (window != null && isMinMax(fn) &&
-                window.getLeftBoundary().getType() != BoundaryType.UNBOUNDED_PRECEDING) {
-            throw new AnalysisException(
-                "'" + getFnCall().toSql() + "' is only supported with an "
-                + "UNBOUNDED PRECEDING start bound.");
-        }
-
         setChildren();
     }
 
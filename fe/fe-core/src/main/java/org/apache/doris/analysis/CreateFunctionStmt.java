@@ -48,6 +48,7 @@ public class CreateFunctionStmt extends DdlStmt {
     public static final String SYMBOL_KEY = "symbol";
     public static final String PREPARE_SYMBOL_KEY = "prepare_fn";
     public static final String CLOSE_SYMBOL_KEY = "close_fn";
+    public static final String BATCH_SYMBOL_KEY = "batch_fn";
     public static final String MD5_CHECKSUM = "md5";
     public static final String INIT_KEY = "init_fn";
     public static final String UPDATE_KEY = "update_fn";
@@ -56,6 +57,7 @@ public class CreateFunctionStmt extends DdlStmt {
     public static final String FINALIZE_KEY = "finalize_fn";
     public static final String GET_VALUE_KEY = "get_value_fn";
     public static final String REMOVE_KEY = "remove_fn";
+    public static final String UPDATE_BATCH_KEY = "update_batch_fn";
 
     private final FunctionName functionName;
     private final boolean isAggregate;
@@ -178,6 +180,7 @@ public class CreateFunctionStmt extends DdlStmt {
                 .updateFnSymbol(updateFnSymbol).mergeFnSymbol(mergeFnSymbol)
                 .serializeFnSymbol(properties.get(SERIALIZE_KEY)).finalizeFnSymbol(properties.get(FINALIZE_KEY))
                 .getValueFnSymbol(properties.get(GET_VALUE_KEY)).removeFnSymbol(properties.get(REMOVE_KEY))
+                .updateBatchFnSymbol(properties.get(UPDATE_BATCH_KEY))
                 .build();
         function.setChecksum(checksum);
     }
@@ -189,10 +192,16 @@ public class CreateFunctionStmt extends DdlStmt {
         }
         String prepareFnSymbol = properties.get(PREPARE_SYMBOL_KEY);
         String closeFnSymbol = properties.get(CLOSE_SYMBOL_KEY);
-        function = ScalarFunction.createUdf(
+        String batchFnSymbol = properties.get(BATCH_SYMBOL_KEY);
+        if (batchFnSymbol != null && argsDef.isVariadic()) {
+            throw new AnalysisException("Variadic function can't have 'batch_fn'");
+        }
+        ScalarFunction scalarFunction = ScalarFunction.createUdf(
                 functionName, argsDef.getArgTypes(),
                 returnType.getType(), argsDef.isVariadic(),
                 objectFile, symbol, prepareFnSymbol, closeFnSymbol);
+        scalarFunction.setBatchFnSymbol(batchFnSymbol);
+        function = scalarFunction;
         function.setChecksum(checksum);
     }
 
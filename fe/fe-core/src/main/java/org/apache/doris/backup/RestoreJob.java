@@ -784,6 +784,9 @@ public class RestoreJob extends AbstractJob {
                             localTbl.isInMemory(),
                             localTbl.getPartitionInfo().getTabletType(restorePart.getId()));
                     task.setInRestoreMode(true);
+                    task.setCompression(localTbl.getCompressionType(), localTbl.getCompressionLevel());
+                    task.setEnableUniqueKeyMergeOnWrite(localTbl.getEnableUniqueKeyMergeOnWrite());
+                    task.setClusteringColumns(localTbl.getClusteringColumns(restoredIdx.getId()));
                     batchTask.addTask(task);
                 }
             }
@@ -26,6 +26,7 @@ import org.apache.doris.analysis.CreateFunctionStmt;
 
 import org.apache.doris.analysis.FunctionName;
 import org.apache.doris.analysis.HdfsURI;
+import org.apache.doris.common.FeMetaVersion;
 import org.apache.doris.thrift.TAggregateFunction;
 import org.apache.doris.thrift.TFunction;
 import org.apache.doris.thrift.TFunctionBinaryType;
@@ -60,6 +61,8 @@ public class AggregateFunction extends Function {
     private String getValueFnSymbol;
     private String removeFnSymbol;
     private String finalizeFnSymbol;
+    // The batch form of the update function, see UdaUpdateBatch in be/src/udf/udf.h
+    private String updateBatchFnSymbol;
 
     private static String BE_BUILTINS_CLASS = "AggregateFunctions";
 
@@ -245,6 +248,7 @@ public class AggregateFunction extends Function {
         String mergeFnSymbol;
         String removeFnSymbol;
         String getValueFnSymbol;
+        String updateBatchFnSymbol;
 
         private AggregateFunctionBuilder(TFunctionBinaryType binaryType) {
             this.binaryType = binaryType;
@@ -319,12 +323,18 @@ public class AggregateFunction extends Function {
             return this;
         }
 
+        public AggregateFunctionBuilder updateBatchFnSymbol(String symbol) {
+            this.updateBatchFnSymbol = symbol;
+            return this;
+        }
+
         public AggregateFunction build() {
             AggregateFunction fn = new AggregateFunction(name, argTypes, retType, hasVarArgs, intermediateType,
                     objectFile, initFnSymbol, updateFnSymbol, mergeFnSymbol,
                     serializeFnSymbol, finalizeFnSymbol,
                     getValueFnSymbol, removeFnSymbol);
             fn.setBinaryType(binaryType);
+            fn.setUpdateBatchFnSymbol(updateBatchFnSymbol);
             return fn;
         }
     }
@@ -336,6 +346,7 @@ public class AggregateFunction extends Function {
     public String getGetValueFnSymbol() { return getValueFnSymbol; }
     public String getRemoveFnSymbol() { return removeFnSymbol; }
     public String getFinalizeFnSymbol() { return finalizeFnSymbol; }
+    public String getUpdateBatchFnSymbol() { return updateBatchFnSymbol; }
     public boolean ignoresDistinct() { return ignoresDistinct; }
     public boolean isAnalyticFn() { return isAnalyticFn; }
     public boolean isAggregateFn() { return isAggregateFn; }
@@ -352,6 +363,7 @@ public class AggregateFunction extends Function {
     public void setMergeFnSymbol(String fn) { mergeFnSymbol = fn; }
     public void setGetValueFnSymbol(String fn) { getValueFnSymbol = fn; }
     public void setRemoveFnSymbol(String fn) { removeFnSymbol = fn; }
+    public void setUpdateBatchFnSymbol(String fn) { updateBatchFnSymbol = fn; }
     public void setFinalizeFnSymbol(String fn) { finalizeFnSymbol = fn; }
     public void setIntermediateType(Type t) { intermediateType = t; }
 
@@ -399,6 +411,9 @@ public class AggregateFunction extends Function {
         if (finalizeFnSymbol  != null) {
             aggFn.setFinalizeFnSymbol(finalizeFnSymbol);
         }
+        if (updateBatchFnSymbol != null) {
+            aggFn.setUpdateBatchFnSymbol(updateBatchFnSymbol);
+        }
         if (intermediateType != null) {
             aggFn.setIntermediateType(intermediateType.toThrift());
         } else {
@@ -433,6 +448,7 @@ public class AggregateFunction extends Function {
         output.writeBoolean(isAnalyticFn);
         output.writeBoolean(isAggregateFn);
         output.writeBoolean(returnsNonNullOnEmpty);
+        writeOptionString(output, updateBatchFnSymbol);
     }
 
     public void readFields(DataInput input) throws IOException {
@@ -452,6 +468,9 @@ public class AggregateFunction extends Function {
         isAnalyticFn = input.readBoolean();
         isAggregateFn = input.readBoolean();
         returnsNonNullOnEmpty = input.readBoolean();
+        if (Catalog.getCurrentCatalogJournalVersion() >= FeMetaVersion.VERSION_94) {
+            updateBatchFnSymbol = readOptionStringOrNull(input);
+        }
     }
 
     @Override
@@ -472,6 +491,9 @@ public class AggregateFunction extends Function {
         if (removeFnSymbol != null) {
             properties.put(CreateFunctionStmt.REMOVE_KEY, removeFnSymbol);
         }
+        if (updateBatchFnSymbol != null) {
+            properties.put(CreateFunctionStmt.UPDATE_BATCH_KEY, updateBatchFnSymbol);
+        }
         return new Gson().toJson(properties);
     }
 }
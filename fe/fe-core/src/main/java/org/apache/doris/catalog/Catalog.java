@@ -3237,6 +3237,10 @@ public class Catalog {
                     tabletIdSet, olapTable.getCopiedIndexes(),
                     singlePartitionDesc.isInMemory(),
                     olapTable.getStorageFormat(),
+                    olapTable.getCompressionType(),
+                    olapTable.getCompressionLevel(),
+                    olapTable.getEnableUniqueKeyMergeOnWrite(),
+                    olapTable.getClusteringColumns(),
                     singlePartitionDesc.getTabletType()
                     );
 
@@ -3460,6 +3464,10 @@ public class Catalog {
                                                  List<Index> indexes,
                                                  boolean isInMemory,
                                                  TStorageFormat storageFormat,
+                                                 String compressionType,
+                                                 int compressionLevel,
+                                                 boolean enableUniqueKeyMergeOnWrite,
+                                                 List<String> clusteringColumns,
                                                  TTabletType tabletType) throws DdlException {
         // create base index first.
         Preconditions.checkArgument(baseIndexId != -1);
@@ -3528,6 +3536,12 @@ public class Catalog {
                             isInMemory,
                             tabletType);
                     task.setStorageFormat(storageFormat);
+                    task.setCompression(compressionType, compressionLevel);
+                    task.setEnableUniqueKeyMergeOnWrite(enableUniqueKeyMergeOnWrite);
+                    // only the tablets of the base index are clustered
+                    if (indexId == baseIndexId) {
+                        task.setClusteringColumns(clusteringColumns);
+                    }
                     batchTask.addTask(task);
                     // add to AgentTaskQueue for handling finish report.
                     // not for resending task
@@ -3794,6 +3808,52 @@ public class Catalog {
         }
         olapTable.setStorageFormat(storageFormat);
 
+        // get compression of segment v2 pages
+        String compressionType;
+        int compressionLevel;
+        try {
+            compressionType = PropertyAnalyzer.analyzeCompressionType(properties);
+            compressionLevel = PropertyAnalyzer.analyzeCompressionLevel(properties, compressionType);
+        } catch (AnalysisException e) {
+            throw new DdlException(e.getMessage());
+        }
+        if (!compressionType.isEmpty()) {
+            olapTable.setCompression(compressionType, compressionLevel);
+        }
+
+        // merge-on-write of unique key table
+        boolean enableUniqueKeyMergeOnWrite = PropertyAnalyzer.analyzeBooleanProp(properties,
+                PropertyAnalyzer.PROPERTIES_ENABLE_UNIQUE_KEY_MERGE_ON_WRITE, false);
+        if (enableUniqueKeyMergeOnWrite) {
+            if (keysType != KeysType.UNIQUE_KEYS) {
+                throw new DdlException("merge-on-write is only supported by unique key tables");
+            }
+            if (storageFormat == TStorageFormat.V1) {
+                throw new DdlException("merge-on-write is not supported by storage format V1");
+            }
+            if (olapTable.hasSequenceCol()) {
+                throw new DdlException("merge-on-write is not supported with sequence column");
+            }
+            olapTable.setEnableUniqueKeyMergeOnWrite(true);
+        }
+
+        // Z-order clustering of duplicate key table
+        List<String> clusteringColumns;
+        try {
+            clusteringColumns = PropertyAnalyzer.analyzeClusteringColumns(properties, baseSchema);
+        } catch (AnalysisException e) {
+            throw new DdlException(e.getMessage());
+        }
+        if (!clusteringColumns.isEmpty()) {
+            if (keysType != KeysType.DUP_KEYS) {
+                throw new DdlException("clustering columns are only supported by duplicate key tables");
+            }
+            if (storageFormat == TStorageFormat.V1) {
+                throw new DdlException("clustering columns are not supported by storage format V1");
+            }
+            olapTable.setClusteringColumns(clusteringColumns);
+        }
+
         // a set to record every new tablet created when create table
         // if failed in any step, use this set to do clear things
         Set<Long> tabletIdSet = new HashSet<Long>();
@@ -3815,7 +3875,8 @@ public class Catalog {
                         partitionInfo.getReplicationNum(partitionId),
                         versionInfo, bfColumns, bfFpp,
                         tabletIdSet, olapTable.getCopiedIndexes(),
-                        isInMemory, storageFormat, tabletType);
+                        isInMemory, storageFormat, compressionType, compressionLevel,
+                        enableUniqueKeyMergeOnWrite, clusteringColumns, tabletType);
                 olapTable.addPartition(partition);
             } else if (partitionInfo.getType() == PartitionType.RANGE) {
                 try {
@@ -3843,7 +3904,8 @@ public class Catalog {
                             partitionInfo.getReplicationNum(entry.getValue()),
                             versionInfo, bfColumns, bfFpp,
                             tabletIdSet, olapTable.getCopiedIndexes(),
-                            isInMemory, storageFormat,
+                            isInMemory, storageFormat, compressionType, compressionLevel,
+                            enableUniqueKeyMergeOnWrite, clusteringColumns,
                             rangePartitionInfo.getTabletType(entry.getValue()));
                     olapTable.addPartition(partition);
                 }
@@ -4108,6 +4170,28 @@ public class Catalog {
             sb.append(",\n\"").append(PropertyAnalyzer.PROPERTIES_STORAGE_FORMAT).append("\" = \"");
             sb.append(olapTable.getStorageFormat()).append("\"");
 
+            // compression
+            if (!olapTable.getCompressionType().isEmpty()) {
+                sb.append(",\n\"").append(PropertyAnalyzer.PROPERTIES_COMPRESSION).append("\" = \"");
+                sb.append(olapTable.getCompressionType()).append("\"");
+                if (olapTable.getCompressionLevel() > 0) {
+                    sb.append(",\n\"").append(PropertyAnalyzer.PROPERTIES_COMPRESSION_LEVEL).append("\" = \"");
+                    sb.append(olapTable.getCompressionLevel()).append("\"");
+                }
+            }
+
+            // merge-on-write
+            if (olapTable.getEnableUniqueKeyMergeOnWrite()) {
+                sb.append(",\n\"").append(PropertyAnalyzer.PROPERTIES_ENABLE_UNIQUE_KEY_MERGE_ON_WRITE)
+                        .append("\" = \"true\"");
+            }
+
+            // clustering columns
+            if (!olapTable.getClusteringColumns().isEmpty()) {
+                sb.append(",\n\"").append(PropertyAnalyzer.PROPERTIES_CLUSTERING_COLUMNS).append("\" = \"")
+                        .append(Joiner.on(",").join(olapTable.getClusteringColumns())).append("\"");
+            }
+
             sb.append("\n)");
         } else if (table.getType() == TableType.MYSQL) {
             MysqlTable mysqlTable = (MysqlTable) table;
@@ -6429,6 +6513,10 @@ public class Catalog {
                         copiedTbl.getCopiedIndexes(),
                         copiedTbl.isInMemory(),
                         copiedTbl.getStorageFormat(),
+                        copiedTbl.getCompressionType(),
+                        copiedTbl.getCompressionLevel(),
+                        copiedTbl.getEnableUniqueKeyMergeOnWrite(),
+                        copiedTbl.getClusteringColumns(),
                         copiedTbl.getPartitionInfo().getTabletType(oldPartitionId));
                 newPartitions.add(newPartition);
             }
@@ -1641,6 +1641,73 @@ public class OlapTable extends Table {
         return tableProperty.getStorageFormat();
     }
 
+    public void setCompression(String compressionType, int compressionLevel) {
+        if (tableProperty == null) {
+            tableProperty = new TableProperty(new HashMap<>());
+        }
+        tableProperty.modifyTableProperties(PropertyAnalyzer.PROPERTIES_COMPRESSION, compressionType);
+        tableProperty.modifyTableProperties(PropertyAnalyzer.PROPERTIES_COMPRESSION_LEVEL,
+                String.valueOf(compressionLevel));
+        tableProperty.buildCompression();
+    }
+
+    public String getCompressionType() {
+        if (tableProperty == null) {
+            return "";
+        }
+        return tableProperty.getCompressionType();
+    }
+
+    public int getCompressionLevel() {
+        if (tableProperty == null) {
+            return 0;
+        }
+        return tableProperty.getCompressionLevel();
+    }
+
+    public void setEnableUniqueKeyMergeOnWrite(boolean enable) {
+        if (tableProperty == null) {
+            tableProperty = new TableProperty(new HashMap<>());
+        }
+        tableProperty.modifyTableProperties(PropertyAnalyzer.PROPERTIES_ENABLE_UNIQUE_KEY_MERGE_ON_WRITE,
+                Boolean.valueOf(enable).toString());
+        tableProperty.buildEnableUniqueKeyMergeOnWrite();
+    }
+
+    public boolean getEnableUniqueKeyMergeOnWrite() {
+        if (tableProperty == null) {
+            return false;
+        }
+        return tableProperty.getEnableUniqueKeyMergeOnWrite();
+    }
+
+    public void setClusteringColumns(List<String> clusteringColumns) {
+        if (tableProperty == null) {
+            tableProperty = new TableProperty(new HashMap<>());
+        }
+        tableProperty.modifyTableProperties(PropertyAnalyzer.PROPERTIES_CLUSTERING_COLUMNS,
+                String.join(",", clusteringColumns));
+        tableProperty.buildClusteringColumns();
+    }
+
+    public List<String> getClusteringColumns() {
+        if (tableProperty == null) {
+            return Lists.newArrayList();
+        }
+        return tableProperty.getClusteringColumns();
+    }
+
+    /**
+     * Returns the clustering columns of the tablets of the index, only the base index is clustered.
+     * The rows of a clustered tablet are sorted by the Z-order of these columns instead of the keys.
+     */
+    public List<String> getClusteringColumns(long indexId) {
+        if (indexId != baseIndexId) {
+            return Lists.newArrayList();
+        }
+        return getClusteringColumns();
+    }
+
     // For non partitioned table:
     //   The table's distribute hash columns need to be a subset of the aggregate columns.
     //
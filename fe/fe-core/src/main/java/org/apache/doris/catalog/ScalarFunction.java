@@ -26,6 +26,7 @@ import com.google.gson.Gson;
 import org.apache.doris.analysis.CreateFunctionStmt;
 import org.apache.doris.analysis.FunctionName;
 import org.apache.doris.analysis.HdfsURI;
+import org.apache.doris.common.FeMetaVersion;
 import org.apache.doris.common.io.Text;
 import org.apache.doris.thrift.TFunction;
 import org.apache.doris.thrift.TFunctionBinaryType;
@@ -52,6 +53,8 @@ public class ScalarFunction extends Function {
     private String symbolName;
     private String prepareFnSymbol;
     private String closeFnSymbol;
+    // The batch form of the function, see UdfBatch in be/src/udf/udf.h
+    private String batchFnSymbol;
 
     // Only used for serialization
     protected ScalarFunction() {
@@ -248,10 +251,12 @@ public class ScalarFunction extends Function {
     public void setSymbolName(String s) { symbolName = s; }
     public void setPrepareFnSymbol(String s) { prepareFnSymbol = s; }
     public void setCloseFnSymbol(String s) { closeFnSymbol = s; }
+    public void setBatchFnSymbol(String s) { batchFnSymbol = s; }
 
     public String getSymbolName() { return symbolName; }
     public String getPrepareFnSymbol() { return prepareFnSymbol; }
     public String getCloseFnSymbol() { return closeFnSymbol; }
+    public String getBatchFnSymbol() { return batchFnSymbol; }
 
     @Override
     public String toSql(boolean ifNotExists) {
@@ -275,6 +280,9 @@ public class ScalarFunction extends Function {
         if (closeFnSymbol != null) {
             fn.getScalarFn().setCloseFnSymbol(closeFnSymbol);
         }
+        if (batchFnSymbol != null) {
+            fn.getScalarFn().setBatchFnSymbol(batchFnSymbol);
+        }
         return fn;
     }
 
@@ -288,6 +296,7 @@ public class ScalarFunction extends Function {
         Text.writeString(output, symbolName);
         writeOptionString(output, prepareFnSymbol);
         writeOptionString(output, closeFnSymbol);
+        writeOptionString(output, batchFnSymbol);
     }
 
     public void readFields(DataInput input) throws IOException {
@@ -299,6 +308,11 @@ public class ScalarFunction extends Function {
         if (input.readBoolean()) {
             closeFnSymbol = Text.readString(input);
         }
+        if (Catalog.getCurrentCatalogJournalVersion() >= FeMetaVersion.VERSION_94) {
+            if (input.readBoolean()) {
+                batchFnSymbol = Text.readString(input);
+            }
+        }
     }
 
     @Override
@@ -307,6 +321,9 @@ public class ScalarFunction extends Function {
         properties.put(CreateFunctionStmt.OBJECT_FILE_KEY, getLocation() == null ? "" : getLocation().toString());
         properties.put(CreateFunctionStmt.MD5_CHECKSUM, checksum);
         properties.put(CreateFunctionStmt.SYMBOL_KEY, symbolName);
+        if (batchFnSymbol != null) {
+            properties.put(CreateFunctionStmt.BATCH_SYMBOL_KEY, batchFnSymbol);
+        }
         return new Gson().toJson(properties);
     }
 }
@@ -25,6 +25,7 @@ import org.apache.doris.persist.OperationType;
 import org.apache.doris.persist.gson.GsonUtils;
 import org.apache.doris.thrift.TStorageFormat;
 
+import com.google.common.collect.Lists;
 import com.google.common.collect.Maps;
 import com.google.gson.annotations.SerializedName;
 
@@ -32,6 +33,7 @@ import java.io.DataInput;
 import java.io.DataOutput;
 import java.io.IOException;
 import java.util.HashMap;
+import java.util.List;
 import java.util.Map;
 
 /**  TableProperty contains additional information about OlapTable
@@ -61,6 +63,19 @@ public class TableProperty implements Writable {
      */
     private TStorageFormat storageFormat = TStorageFormat.DEFAULT;
 
+    /*
+     * codec of the segment v2 pages written by BE, empty means the default of BE (LZ4F).
+     * compressionLevel is only used by ZSTD, 0 means the default level.
+     */
+    private String compressionType = "";
+    private int compressionLevel = 0;
+
+    // whether the replaced rows of this unique key table are marked deleted on load
+    private boolean enableUniqueKeyMergeOnWrite = false;
+
+    // columns whose Z-order the rows of this duplicate key table are sorted by, empty if sorted by keys
+    private List<String> clusteringColumns = Lists.newArrayList();
+
     public TableProperty(Map<String, String> properties) {
         this.properties = properties;
     }
@@ -118,6 +133,30 @@ public class TableProperty implements Writable {
         return this;
     }
 
+    public TableProperty buildCompression() {
+        compressionType = properties.getOrDefault(PropertyAnalyzer.PROPERTIES_COMPRESSION, "");
+        compressionLevel = Integer.parseInt(properties.getOrDefault(PropertyAnalyzer.PROPERTIES_COMPRESSION_LEVEL,
+                "0"));
+        return this;
+    }
+
+    public TableProperty buildEnableUniqueKeyMergeOnWrite() {
+        enableUniqueKeyMergeOnWrite = Boolean.parseBoolean(properties.getOrDefault(
+                PropertyAnalyzer.PROPERTIES_ENABLE_UNIQUE_KEY_MERGE_ON_WRITE, "false"));
+        return this;
+    }
+
+    public TableProperty buildClusteringColumns() {
+        clusteringColumns = Lists.newArrayList();
+        String clusteringColumnsStr = properties.getOrDefault(PropertyAnalyzer.PROPERTIES_CLUSTERING_COLUMNS, "");
+        for (String column : clusteringColumnsStr.split(",")) {
+            if (!column.isEmpty()) {
+                clusteringColumns.add(column);
+            }
+        }
+        return this;
+    }
+
     public void modifyTableProperties(Map<String, String> modifyProperties) {
         properties.putAll(modifyProperties);
     }
@@ -146,6 +185,22 @@ public class TableProperty implements Writable {
         return storageFormat;
     }
 
+    public String getCompressionType() {
+        return compressionType;
+    }
+
+    public int getCompressionLevel() {
+        return compressionLevel;
+    }
+
+    public boolean getEnableUniqueKeyMergeOnWrite() {
+        return enableUniqueKeyMergeOnWrite;
+    }
+
+    public List<String> getClusteringColumns() {
+        return clusteringColumns;
+    }
+
     @Override
     public void write(DataOutput out) throws IOException {
         Text.writeString(out, GsonUtils.GSON.toJson(this));
@@ -156,6 +211,9 @@ public class TableProperty implements Writable {
                 .buildDynamicProperty()
                 .buildReplicationNum()
                 .buildInMemory()
-                .buildStorageFormat();
+                .buildStorageFormat()
+                .buildCompression()
+                .buildEnableUniqueKeyMergeOnWrite()
+                .buildClusteringColumns();
     }
 }
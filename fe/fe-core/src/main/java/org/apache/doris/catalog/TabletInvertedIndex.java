@@ -106,7 +106,9 @@ public class TabletInvertedIndex {
         this.lock.writeLock().unlock();
     }
 
-    public void tabletReport(long backendId, Map<Long, TTablet> backendTablets,
+    // if isIncremental is true, backendTablets only contains the changed tablets of the backend,
+    // and the tablets not in it are not treated as dropped.
+    public void tabletReport(long backendId, Map<Long, TTablet> backendTablets, boolean isIncremental,
                              final HashMap<Long, TStorageMedium> storageMediumMap,
                              ListMultimap<Long, Long> tabletSyncMap,
                              ListMultimap<Long, Long> tabletDeleteFromMeta,
@@ -237,7 +239,7 @@ public class TabletInvertedIndex {
                                 foundTabletsWithInvalidSchema.put(tabletId, backendTabletInfo);
                             } // end for be tablet info
                         }
-                    }  else {
+                    } else if (!isIncremental) {
                         // 2. (meta - be)
                         // may need delete from meta
                         LOG.debug("backend[{}] does not report tablet[{}-{}]", backendId, tabletId, tabletMeta);
@@ -921,6 +921,13 @@ public class Config extends ConfigBase {
      */
     @ConfField(mutable = true)
     public static long remote_fragment_exec_timeout_ms = 5000; // 5 sec
+
+    /**
+     * If true, the instances of a fragment on the same backend are started by one rpc, which
+     * carries the plan of the fragment once. Backends of older versions don't support it.
+     */
+    @ConfField(mutable = true)
+    public static boolean enable_batch_plan_fragment_dispatch = true;
     
     /**
      * The number of query retries. 
@@ -198,6 +198,8 @@ public final class FeMetaVersion {
     public static final int VERSION_92 = 92;
     //jira: 4863 for load job support udf
     public static final int VERSION_93 = 93;
+    // batch symbols of udf and uda
+    public static final int VERSION_94 = 94;
     // note: when increment meta version, should assign the latest version to VERSION_CURRENT
-    public static final int VERSION_CURRENT = VERSION_93;
+    public static final int VERSION_CURRENT = VERSION_94;
 }
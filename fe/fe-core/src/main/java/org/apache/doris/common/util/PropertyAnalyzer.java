@@ -36,6 +36,8 @@ import org.apache.doris.thrift.TTabletType;
 
 import com.google.common.base.Preconditions;
 import com.google.common.base.Strings;
+import com.google.common.collect.ImmutableSet;
+import com.google.common.collect.Lists;
 import com.google.common.collect.Sets;
 
 import org.apache.logging.log4j.LogManager;
@@ -82,6 +84,34 @@ public class PropertyAnalyzer {
 
     public static final String PROPERTIES_INMEMORY = "in_memory";
 
+    /*
+     * codec of the segment v2 pages written by BE, and the level of ZSTD:
+     * "compression" = "zstd", "compression_level" = "9"
+     */
+    public static final String PROPERTIES_COMPRESSION = "compression";
+    public static final String PROPERTIES_COMPRESSION_LEVEL = "compression_level";
+    private static final ImmutableSet<String> COMPRESSION_TYPES = ImmutableSet.of(
+            "NO_COMPRESSION", "SNAPPY", "LZ4", "LZ4F", "ZLIB", "ZSTD");
+
+    /*
+     * rows of a unique key table replaced by later loads are marked deleted on load,
+     * instead of being merged by the queries: "enable_unique_key_merge_on_write" = "true"
+     */
+    public static final String PROPERTIES_ENABLE_UNIQUE_KEY_MERGE_ON_WRITE = "enable_unique_key_merge_on_write";
+
+    /*
+     * rows of the segments of a duplicate key table are sorted by the Z-order of 2 to 4 columns
+     * instead of the keys, so that filters on any of them prune pages: "clustering_columns" = "k1,v1"
+     */
+    public static final String PROPERTIES_CLUSTERING_COLUMNS = "clustering_columns";
+    public static final int MIN_CLUSTERING_COLUMNS = 2;
+    public static final int MAX_CLUSTERING_COLUMNS = 4;
+    // types whose values BE encodes in comparable bytes
+    private static final ImmutableSet<PrimitiveType> CLUSTERING_COLUMN_TYPES = ImmutableSet.of(
+            PrimitiveType.BOOLEAN, PrimitiveType.TINYINT, PrimitiveType.SMALLINT, PrimitiveType.INT,
+            PrimitiveType.BIGINT, PrimitiveType.LARGEINT, PrimitiveType.DATE, PrimitiveType.DATETIME,
+            PrimitiveType.DECIMALV2, PrimitiveType.CHAR, PrimitiveType.VARCHAR);
+
     public static final String PROPERTIES_TABLET_TYPE = "tablet_type";
 
     public static final String PROPERTIES_STRICT_RANGE = "strict_range";
@@ -354,6 +384,47 @@ public class PropertyAnalyzer {
         return bfColumns;
     }
 
+    // Returns the names of the clustering columns in the order of the property, empty if it's not set
+    public static List<String> analyzeClusteringColumns(Map<String, String> properties, List<Column> columns)
+            throws AnalysisException {
+        List<String> clusteringColumns = Lists.newArrayList();
+        if (properties == null || !properties.containsKey(PROPERTIES_CLUSTERING_COLUMNS)) {
+            return clusteringColumns;
+        }
+        String clusteringColumnsStr = properties.remove(PROPERTIES_CLUSTERING_COLUMNS);
+        if (Strings.isNullOrEmpty(clusteringColumnsStr)) {
+            return clusteringColumns;
+        }
+        Set<String> clusteringColumnSet = Sets.newTreeSet(String.CASE_INSENSITIVE_ORDER);
+        for (String clusteringColumn : clusteringColumnsStr.split(COMMA_SEPARATOR)) {
+            clusteringColumn = clusteringColumn.trim();
+            Column found = null;
+            for (Column column : columns) {
+                if (column.getName().equalsIgnoreCase(clusteringColumn)) {
+                    found = column;
+                    break;
+                }
+            }
+            if (found == null) {
+                throw new AnalysisException("Clustering column does not exist in table. invalid column: "
+                        + clusteringColumn);
+            }
+            if (!CLUSTERING_COLUMN_TYPES.contains(found.getDataType())) {
+                throw new AnalysisException(found.getDataType() + " is not supported as clustering column. "
+                        + "invalid column: " + clusteringColumn);
+            }
+            if (!clusteringColumnSet.add(clusteringColumn)) {
+                throw new AnalysisException("Reduplicated clustering column: " + clusteringColumn);
+            }
+            clusteringColumns.add(found.getName());
+        }
+        if (clusteringColumns.size() < MIN_CLUSTERING_COLUMNS || clusteringColumns.size() > MAX_CLUSTERING_COLUMNS) {
+            throw new AnalysisException("The number of clustering columns must be between "
+                    + MIN_CLUSTERING_COLUMNS + " and " + MAX_CLUSTERING_COLUMNS);
+        }
+        return clusteringColumns;
+    }
+
     public static double analyzeBloomFilterFpp(Map<String, String> properties) throws AnalysisException {
         double bfFpp = 0;
         if (properties != null && properties.containsKey(PROPERTIES_BF_FPP)) {
@@ -425,6 +496,45 @@ public class PropertyAnalyzer {
         }
     }
 
+    // analyzeCompressionType will parse the codec of segment v2 pages from properties,
+    // return an empty string if it is not set, which means the default codec of BE
+    public static String analyzeCompressionType(Map<String, String> properties) throws AnalysisException {
+        if (properties == null || !properties.containsKey(PROPERTIES_COMPRESSION)) {
+            return "";
+        }
+        String compressionType = properties.remove(PROPERTIES_COMPRESSION).toUpperCase();
+        if (compressionType.equals("NONE")) {
+            compressionType = "NO_COMPRESSION";
+        }
+        if (!COMPRESSION_TYPES.contains(compressionType)) {
+            throw new AnalysisException("unknown compression: " + compressionType
+                    + ", valid values are " + COMPRESSION_TYPES);
+        }
+        return compressionType;
+    }
+
+    // analyzeCompressionLevel will parse the level of compression type ZSTD, 0 means the default level
+    public static int analyzeCompressionLevel(Map<String, String> properties, String compressionType)
+            throws AnalysisException {
+        if (properties == null || !properties.containsKey(PROPERTIES_COMPRESSION_LEVEL)) {
+            return 0;
+        }
+        String levelStr = properties.remove(PROPERTIES_COMPRESSION_LEVEL);
+        int level;
+        try {
+            level = Integer.parseInt(levelStr);
+        } catch (NumberFormatException e) {
+            throw new AnalysisException("invalid compression level: " + levelStr);
+        }
+        if (!compressionType.equals("ZSTD")) {
+            throw new AnalysisException("compression level is only supported by ZSTD");
+        }
+        if (level < 1 || level > 22) {
+            throw new AnalysisException("compression level of ZSTD should be in [1, 22]: " + level);
+        }
+        return level;
+    }
+
     // analyze common boolean properties, such as "in_memory" = "false"
     public static boolean analyzeBooleanProp(Map<String, String> properties, String propKey, boolean defaultVal) {
         if (properties != null && properties.containsKey(propKey)) {
@@ -583,6 +583,10 @@ public abstract class RoutineLoadJob extends AbstractTxnStateChangeCallback impl
         return !Strings.isNullOrEmpty(sequenceCol);
     }
 
+    public boolean isPartialColumns() {
+        return false;
+    }
+
     public int getSizeOfRoutineLoadTaskInfoList() {
         readLock();
         try {
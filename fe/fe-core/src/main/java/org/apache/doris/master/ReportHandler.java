@@ -112,6 +112,7 @@ public class ReportHandler extends Daemon {
         TMasterResult result = new TMasterResult();
         TStatus tStatus = new TStatus(TStatusCode.OK);
         result.setStatus(tStatus);
+        result.setSupportIncrementalTabletReport(true);
 
         // get backend
         TBackend tBackend = request.getBackend();
@@ -131,6 +132,7 @@ public class ReportHandler extends Daemon {
         Map<String, TDisk> disks = null;
         Map<Long, TTablet> tablets = null;
         long reportVersion = -1;
+        boolean isIncrementalTabletReport = false;
 
         String reportType = "";
         if (request.isSetTasks()) {
@@ -154,11 +156,27 @@ public class ReportHandler extends Daemon {
             reportType += "tablet";
         }
 
+        if (tablets != null && request.isSetIsIncrementalTabletReport()
+                && request.isIsIncrementalTabletReport()) {
+            // an out of date incremental report is rejected, so that the backend reports
+            // the changes in it again, instead of treating them as reported
+            long backendReportVersion = Catalog.getCurrentSystemInfo().getBackendReportVersion(beId);
+            if (reportVersion < backendReportVersion) {
+                tStatus.setStatusCode(TStatusCode.INTERNAL_ERROR);
+                tStatus.setErrorMsgs(Lists.newArrayList("out of date incremental tablet report version "
+                        + reportVersion + ", current report version " + backendReportVersion));
+                return result;
+            }
+            isIncrementalTabletReport = true;
+            reportType += "(incremental)";
+        }
+
         if (request.isSetTabletMaxCompactionScore()) {
             backend.setTabletMaxCompactionScore(request.getTabletMaxCompactionScore());
         }
 
-        ReportTask reportTask = new ReportTask(beId, tasks, disks, tablets, reportVersion);
+        ReportTask reportTask = new ReportTask(beId, tasks, disks, tablets, reportVersion,
+                isIncrementalTabletReport);
         try {
             putToQueue(reportTask);
         } catch (Exception e) {
@@ -204,15 +222,18 @@ public class ReportHandler extends Daemon {
         private Map<String, TDisk> disks;
         private Map<Long, TTablet> tablets;
         private long reportVersion;
+        private boolean isIncrementalTabletReport;
 
         public ReportTask(long beId, Map<TTaskType, Set<Long>> tasks,
                           Map<String, TDisk> disks,
-                          Map<Long, TTablet> tablets, long reportVersion) {
+                          Map<Long, TTablet> tablets, long reportVersion,
+                          boolean isIncrementalTabletReport) {
             this.beId = beId;
             this.tasks = tasks;
             this.disks = disks;
             this.tablets = tablets;
             this.reportVersion = reportVersion;
+            this.isIncrementalTabletReport = isIncrementalTabletReport;
         }
 
         @Override
@@ -229,16 +250,17 @@ public class ReportHandler extends Daemon {
                     LOG.warn("out of date report version {} from backend[{}]. current report version[{}]",
                             reportVersion, beId, backendReportVersion);
                 } else {
-                    ReportHandler.tabletReport(beId, tablets, reportVersion);
+                    ReportHandler.tabletReport(beId, tablets, reportVersion, isIncrementalTabletReport);
                 }
             }
         }
     }
 
-    private static void tabletReport(long backendId, Map<Long, TTablet> backendTablets, long backendReportVersion) {
+    private static void tabletReport(long backendId, Map<Long, TTablet> backendTablets, long backendReportVersion,
+                                     boolean isIncremental) {
         long start = System.currentTimeMillis();
-        LOG.info("backend[{}] reports {} tablet(s). report version: {}",
-                backendId, backendTablets.size(), backendReportVersion);
+        LOG.info("backend[{}] reports {} tablet(s). report version: {}, incremental: {}",
+                backendId, backendTablets.size(), backendReportVersion, isIncremental);
 
         // storage medium map
         HashMap<Long, TStorageMedium> storageMediumMap = Catalog.getCurrentCatalog().getPartitionIdToStorageMediumMap();
@@ -264,7 +286,7 @@ public class ReportHandler extends Daemon {
         Set<Pair<Long, Integer>> tabletWithoutPartitionId = Sets.newHashSet();
 
         // 1. do the diff. find out (intersection) / (be - meta) / (meta - be)
-        Catalog.getCurrentInvertedIndex().tabletReport(backendId, backendTablets, storageMediumMap,
+        Catalog.getCurrentInvertedIndex().tabletReport(backendId, backendTablets, isIncremental, storageMediumMap,
                 tabletSyncMap,
                 tabletDeleteFromMeta,
                 foundTabletsWithValidSchema,
@@ -595,6 +617,11 @@ public class ReportHandler extends Daemon {
                                             olapTable.isInMemory(),
                                             olapTable.getPartitionInfo().getTabletType(partitionId));
                                     createReplicaTask.setIsRecoverTask(true);
+                                    createReplicaTask.setCompression(olapTable.getCompressionType(),
+                                            olapTable.getCompressionLevel());
+                                    createReplicaTask.setEnableUniqueKeyMergeOnWrite(
+                                            olapTable.getEnableUniqueKeyMergeOnWrite());
+                                    createReplicaTask.setClusteringColumns(olapTable.getClusteringColumns(indexId));
                                     createReplicaBatchTask.addTask(createReplicaTask);
                                 } else {
                                     // just set this replica as bad
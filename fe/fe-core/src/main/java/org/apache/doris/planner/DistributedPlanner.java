@@ -24,6 +24,7 @@ import org.apache.doris.analysis.InsertStmt;
 import org.apache.doris.analysis.JoinOperator;
 import org.apache.doris.analysis.QueryStmt;
 import org.apache.doris.analysis.SlotDescriptor;
+import org.apache.doris.analysis.SlotRef;
 import org.apache.doris.catalog.Catalog;
 import org.apache.doris.catalog.ColocateTableIndex;
 import org.apache.doris.catalog.ColocateTableIndex.GroupId;
@@ -34,6 +35,7 @@ import org.apache.doris.catalog.OlapTable;
 import org.apache.doris.catalog.Table;
 import org.apache.doris.common.AnalysisException;
 import org.apache.doris.common.Config;
+import org.apache.doris.common.Pair;
 import org.apache.doris.common.UserException;
 import org.apache.doris.qe.ConnectContext;
 import org.apache.doris.thrift.TPartitionType;
@@ -383,7 +385,8 @@ public class DistributedPlanner {
             //node.setDistributionMode(HashJoinNode.DistributionMode.PARTITIONED);
             node.setChild(0, leftChildFragment.getPlanRoot());
             node.setChild(1, rightChildFragment.getPlanRoot());
-            leftChildFragment.setPlanRoot(node);
+            MergeJoinNode mergeJoinNode = createMergeJoinNode(node);
+            leftChildFragment.setPlanRoot(mergeJoinNode != null ? mergeJoinNode : node);
             fragments.remove(rightChildFragment);
             return leftChildFragment;
         } else {
@@ -520,6 +523,72 @@ public class DistributedPlanner {
         return false;
     }
 
+    /**
+     * Returns a merge join to replace the colocate join 'node' if both its children can return rows ordered by
+     * the equi-join columns, or null. That is an inner join of two olap scans whose equi-join conjuncts are on
+     * the first key columns of their selected indexes, at the same positions on both sides. Each instance of
+     * the scans merges the rows of its tablets in the order of those keys, so no hash table is built.
+     */
+    private MergeJoinNode createMergeJoinNode(HashJoinNode node) {
+        if (ConnectContext.get() == null || !ConnectContext.get().getSessionVariable().isEnableMergeJoin()
+                || !node.getJoinOp().isInnerJoin()
+                || !(node.getChild(0) instanceof OlapScanNode) || !(node.getChild(1) instanceof OlapScanNode)) {
+            return null;
+        }
+        OlapScanNode leftScan = (OlapScanNode) node.getChild(0);
+        OlapScanNode rightScan = (OlapScanNode) node.getChild(1);
+        List<Column> leftKeys = leftScan.getKeyColumnsOfSelectedIndex();
+        List<Column> rightKeys = rightScan.getKeyColumnsOfSelectedIndex();
+        List<BinaryPredicate> eqJoinConjuncts = node.getEqJoinConjuncts();
+        int numKeys = eqJoinConjuncts.size();
+        if (numKeys == 0 || numKeys > leftKeys.size() || numKeys > rightKeys.size()) {
+            return null;
+        }
+
+        // the conjunct on the i-th key columns at i
+        List<Pair<Expr, Expr>> cmpConjuncts = Lists.newArrayList();
+        for (int i = 0; i < numKeys; ++i) {
+            cmpConjuncts.add(null);
+        }
+        for (BinaryPredicate eqJoinPredicate : eqJoinConjuncts) {
+            Expr lhs = eqJoinPredicate.getChild(0);
+            Expr rhs = eqJoinPredicate.getChild(1);
+            if (eqJoinPredicate.getOp() != BinaryPredicate.Operator.EQ || !(lhs instanceof SlotRef)
+                    || !(rhs instanceof SlotRef) || !lhs.getType().equals(rhs.getType())) {
+                return null;
+            }
+            int keyIndex = getKeyIndex(leftScan, leftKeys, ((SlotRef) lhs).getDesc());
+            if (keyIndex < 0 || keyIndex >= numKeys || cmpConjuncts.get(keyIndex) != null
+                    || keyIndex != getKeyIndex(rightScan, rightKeys, ((SlotRef) rhs).getDesc())) {
+                return null;
+            }
+            cmpConjuncts.set(keyIndex, new Pair<Expr, Expr>(lhs, rhs));
+        }
+
+        leftScan.setNumOrderedKeys(numKeys);
+        rightScan.setNumOrderedKeys(numKeys);
+        MergeJoinNode mergeJoinNode = new MergeJoinNode(node.getId(), leftScan, rightScan, cmpConjuncts,
+                node.getOtherJoinConjuncts());
+        mergeJoinNode.addConjuncts(node.getConjuncts());
+        mergeJoinNode.setLimit(node.getLimit());
+        mergeJoinNode.setOutputSmap(node.getOutputSmap());
+        mergeJoinNode.cardinality = node.cardinality;
+        return mergeJoinNode;
+    }
+
+    // Returns the index in 'keyColumns' of the key column read by 'slot' of 'scanNode', or -1.
+    private int getKeyIndex(OlapScanNode scanNode, List<Column> keyColumns, SlotDescriptor slot) {
+        if (slot.getColumn() == null || !slot.getParent().getId().equals(scanNode.getTupleIds().get(0))) {
+            return -1;
+        }
+        for (int i = 0; i < keyColumns.size(); ++i) {
+            if (keyColumns.get(i).getName().equalsIgnoreCase(slot.getColumn().getName())) {
+                return i;
+            }
+        }
+        return -1;
+    }
+
     private boolean canBucketShuffleJoin(HashJoinNode node, PlanFragment leftChildFragment,
                                    List<Expr> rhsHashExprs) {
         if (!ConnectContext.get().getSessionVariable().isEnableBucketShuffleJoin()) {
@@ -103,6 +103,10 @@ public class HashJoinNode extends PlanNode {
         return eqJoinConjuncts;
     }
 
+    public List<Expr> getOtherJoinConjuncts() {
+        return otherJoinConjuncts;
+    }
+
     public JoinOperator getJoinOp() {
         return joinOp;
     }
@@ -269,6 +273,7 @@ public class HashJoinNode extends PlanNode {
             msg.hash_join_node.addToOtherJoinConjuncts(e.treeToThrift());
         }
         msg.hash_join_node.setIsPushDown(isPushDown);
+        msg.hash_join_node.setIsBroadcastJoin(distrMode == DistributionMode.BROADCAST);
     }
 
     @Override
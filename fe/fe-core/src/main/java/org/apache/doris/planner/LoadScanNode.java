@@ -51,6 +51,8 @@ public abstract class LoadScanNode extends ScanNode {
 
     protected Expr deleteCondition;
     protected LoadTask.MergeType mergeType = LoadTask.MergeType.APPEND;
+    // the value columns not loaded are null, which leaves their values unchanged
+    protected boolean partialColumns = false;
     protected int numInstances;
 
     public LoadScanNode(PlanNodeId id, TupleDescriptor desc, String planNodeName) {
@@ -129,7 +131,13 @@ public abstract class LoadScanNode extends ScanNode {
                     expr = new SlotRef(srcSlotDesc);
                 } else {
                     Column column = destSlotDesc.getColumn();
-                    if (column.getDefaultValue() != null) {
+                    if (partialColumns && !column.isKey() && column.isVisible()) {
+                        if (!column.isAllowNull()) {
+                            throw new AnalysisException("column not loaded by a partial columns load must be "
+                                    + "nullable, column=" + column.getName());
+                        }
+                        expr = NullLiteral.create(column.getType());
+                    } else if (column.getDefaultValue() != null) {
                         expr = new StringLiteral(destSlotDesc.getColumn().getDefaultValue());
                     } else {
                         if (column.isAllowNull()) {
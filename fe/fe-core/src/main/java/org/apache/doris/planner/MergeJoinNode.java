@@ -36,9 +36,9 @@ import org.apache.logging.log4j.Logger;
 import java.util.List;
 
 /**
- * Merge join between left child and right child.
- * The right child must be a leaf node, ie, can only materialize
- * a single input tuple.
+ * Inner merge join between left child and right child.
+ * Both children must return rows ordered ascending by the exprs of cmpConjuncts, in
+ * that order, which is the case for olap scans with ordered keys.
  */
 public class MergeJoinNode extends PlanNode {
     private final static Logger LOG = LogManager.getLogger(MergeJoinNode.class);
@@ -61,12 +61,9 @@ public class MergeJoinNode extends PlanNode {
         children.add(outer);
         children.add(inner);
 
-        // Inherits all the nullable tuple from the children
-        // Mark tuples that form the "nullable" side of the outer join as nullable.
+        // Inherits all the nullable tuple from the children, only inner joins are merged
         nullableTupleIds.addAll(inner.getNullableTupleIds());
         nullableTupleIds.addAll(outer.getNullableTupleIds());
-        nullableTupleIds.addAll(outer.getTupleIds());
-        nullableTupleIds.addAll(inner.getTupleIds());
     }
 
     public List<Pair<Expr, Expr>> getCmpConjuncts() {
@@ -120,7 +117,7 @@ public class MergeJoinNode extends PlanNode {
             msg.merge_join_node.addToCmpConjuncts(eqJoinCondition);
         }
         for (Expr e : otherJoinConjuncts) {
-            msg.hash_join_node.addToOtherJoinConjuncts(e.treeToThrift());
+            msg.merge_join_node.addToOtherJoinConjuncts(e.treeToThrift());
         }
     }
 
@@ -130,7 +127,7 @@ public class MergeJoinNode extends PlanNode {
           (distrMode != DistributionMode.NONE) ? (" (" + distrMode.toString() + ")") : "";
         StringBuilder output = new StringBuilder().append(
           detailPrefix + "join op: MERGE JOIN" + distrModeStr + "\n").append(
-          detailPrefix + "hash predicates:\n");
+          detailPrefix + "merge predicates:\n");
         for (Pair<Expr, Expr> entry : cmpConjuncts) {
             output.append(detailPrefix + "  " +
               entry.first.toSql() + " = " + entry.second.toSql() + "\n");
@@ -61,6 +61,7 @@ import org.apache.doris.thrift.TPaloScanRange;
 import org.apache.doris.thrift.TPlanNode;
 import org.apache.doris.thrift.TPlanNodeType;
 import org.apache.doris.thrift.TPrimitiveType;
+import org.apache.doris.thrift.TPushAggOp;
 import org.apache.doris.thrift.TScanRange;
 import org.apache.doris.thrift.TScanRangeLocation;
 import org.apache.doris.thrift.TScanRangeLocations;
@@ -111,6 +112,13 @@ public class OlapScanNode extends ScanNode {
     private String reasonOfPreAggregation = null;
     private boolean canTurnOnPreAggr = true;
     private boolean forceOpenPreAgg = false;
+    // aggregation without grouping which BE may answer from segment row counts and zone maps
+    private TPushAggOp pushDownAggNoGroupingOp = TPushAggOp.NONE;
+    // columns the TOP-N right above orders by and the number of rows it needs, see getSortLimit()
+    private List<Column> sortLimitColumns = null;
+    private long sortLimit = -1;
+    // the number of key columns the rows have to be ordered by, for a merge join above
+    private int numOrderedKeys = 0;
     private OlapTable olapTable = null;
     private long selectedTabletsNum = 0;
     private long totalTabletsNum = 0;
@@ -152,6 +160,67 @@ public class OlapScanNode extends ScanNode {
         this.canTurnOnPreAggr = canChangePreAggr;
     }
 
+    public TPushAggOp getPushDownAggNoGroupingOp() {
+        return pushDownAggNoGroupingOp;
+    }
+
+    public void setPushDownAggNoGroupingOp(TPushAggOp pushDownAggNoGroupingOp) {
+        this.pushDownAggNoGroupingOp = pushDownAggNoGroupingOp;
+    }
+
+    public void setSortLimit(List<Column> orderingColumns, long sortLimit) {
+        this.sortLimitColumns = orderingColumns;
+        this.sortLimit = sortLimit;
+    }
+
+    /**
+     * Returns the number of rows each scanner has to return in key order for the TOP-N right above, or -1 if
+     * all rows have to be returned. The TOP-N must order by a prefix of the key columns of the selected index,
+     * ascending with nulls first, which is the order the rows are stored in.
+     */
+    public long getSortLimit() {
+        if (sortLimit == -1 || selectedIndexId == -1 || !olapTable.getClusteringColumns(selectedIndexId).isEmpty()) {
+            return -1;
+        }
+        KeysType keysType = olapTable.getKeysTypeByIndexId(selectedIndexId);
+        if (keysType != KeysType.DUP_KEYS && keysType != KeysType.AGG_KEYS) {
+            return -1;
+        }
+        List<Column> schema = olapTable.getSchemaByIndexId(selectedIndexId);
+        if (sortLimitColumns.isEmpty() || sortLimitColumns.size() > schema.size()) {
+            return -1;
+        }
+        for (int i = 0; i < sortLimitColumns.size(); ++i) {
+            Column keyColumn = schema.get(i);
+            if (!keyColumn.isKey() || !keyColumn.getName().equalsIgnoreCase(sortLimitColumns.get(i).getName())) {
+                return -1;
+            }
+        }
+        return sortLimit;
+    }
+
+    /**
+     * Returns the key columns of the selected index, the order the rows of each tablet are stored in.
+     * Empty if the rows are clustered by other columns instead.
+     */
+    public List<Column> getKeyColumnsOfSelectedIndex() {
+        List<Column> keyColumns = new ArrayList<Column>();
+        if (selectedIndexId == -1 || !olapTable.getClusteringColumns(selectedIndexId).isEmpty()) {
+            return keyColumns;
+        }
+        for (Column col : olapTable.getSchemaByIndexId(selectedIndexId)) {
+            if (!col.isKey()) {
+                break;
+            }
+            keyColumns.add(col);
+        }
+        return keyColumns;
+    }
+
+    public void setNumOrderedKeys(int numOrderedKeys) {
+        this.numOrderedKeys = numOrderedKeys;
+    }
+
     public boolean getForceOpenPreAgg() {
         return forceOpenPreAgg;
     }
@@ -562,6 +631,15 @@ public class OlapScanNode extends ScanNode {
         } else {
             output.append(prefix).append("PREAGGREGATION: OFF. Reason: ").append(reasonOfPreAggregation).append("\n");
         }
+        if (pushDownAggNoGroupingOp != TPushAggOp.NONE) {
+            output.append(prefix).append("PUSHAGGOP: ").append(pushDownAggNoGroupingOp).append("\n");
+        }
+        if (getSortLimit() != -1) {
+            output.append(prefix).append("SORTLIMIT: ").append(getSortLimit()).append("\n");
+        }
+        if (numOrderedKeys > 0) {
+            output.append(prefix).append("ORDEREDKEYS: ").append(numOrderedKeys).append("\n");
+        }
         if (!conjuncts.isEmpty()) {
             output.append(prefix).append("PREDICATES: ").append(
                     getExplainString(conjuncts)).append("\n");
@@ -615,14 +693,9 @@ public class OlapScanNode extends ScanNode {
     protected void toThrift(TPlanNode msg) {
         List<String> keyColumnNames = new ArrayList<String>();
         List<TPrimitiveType> keyColumnTypes = new ArrayList<TPrimitiveType>();
-        if (selectedIndexId != -1) {
-            for (Column col : olapTable.getSchemaByIndexId(selectedIndexId)) {
-                if (!col.isKey()) {
-                    break;
-                }
-                keyColumnNames.add(col.getName());
-                keyColumnTypes.add(col.getDataType().toThrift());
-            }
+        for (Column col : getKeyColumnsOfSelectedIndex()) {
+            keyColumnNames.add(col.getName());
+            keyColumnTypes.add(col.getDataType().toThrift());
         }
         msg.node_type = TPlanNodeType.OLAP_SCAN_NODE;
         msg.olap_scan_node =
@@ -630,6 +703,15 @@ public class OlapScanNode extends ScanNode {
         if (null != sortColumn) {
             msg.olap_scan_node.setSortColumn(sortColumn);
         }
+        if (pushDownAggNoGroupingOp != TPushAggOp.NONE) {
+            msg.olap_scan_node.setPushDownAggTypeOpt(pushDownAggNoGroupingOp);
+        }
+        if (getSortLimit() != -1) {
+            msg.olap_scan_node.setSortLimit(getSortLimit());
+        }
+        if (numOrderedKeys > 0) {
+            msg.olap_scan_node.setNumOrderedKeys(numOrderedKeys);
+        }
     }
 
     // export some tablets
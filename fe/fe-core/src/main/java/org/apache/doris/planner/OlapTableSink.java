@@ -107,6 +107,10 @@ public class OlapTableSink extends DataSink {
         }
     }
 
+    public void setPartialColumns(boolean partialColumns) {
+        tDataSink.getOlapTableSink().setPartialColumns(partialColumns);
+    }
+
     public void updateLoadId(TUniqueId newLoadId) {
         tDataSink.getOlapTableSink().setLoadId(newLoadId);
     }
@@ -43,6 +43,7 @@ import org.apache.doris.analysis.SetOperationStmt;
 import org.apache.doris.analysis.SlotDescriptor;
 import org.apache.doris.analysis.SlotId;
 import org.apache.doris.analysis.SlotRef;
+import org.apache.doris.analysis.SortInfo;
 import org.apache.doris.analysis.TableRef;
 import org.apache.doris.analysis.TupleDescriptor;
 import org.apache.doris.analysis.TupleId;
@@ -51,13 +52,16 @@ import org.apache.doris.catalog.AggregateFunction;
 import org.apache.doris.catalog.AggregateType;
 import org.apache.doris.catalog.Column;
 import org.apache.doris.catalog.FunctionSet;
+import org.apache.doris.catalog.KeysType;
 import org.apache.doris.catalog.MysqlTable;
 import org.apache.doris.catalog.OdbcTable;
 import org.apache.doris.catalog.Table;
+import org.apache.doris.catalog.Type;
 import org.apache.doris.common.AnalysisException;
 import org.apache.doris.common.FeConstants;
 import org.apache.doris.common.Reference;
 import org.apache.doris.common.UserException;
+import org.apache.doris.thrift.TPushAggOp;
 
 import com.google.common.base.Preconditions;
 import com.google.common.base.Predicate;
@@ -270,6 +274,9 @@ public class SingleNodePlanner {
             }
             Preconditions.checkState(root.hasValidStats());
             root.init(analyzer);
+            if (useTopN && limit != -1) {
+                pushDownSortLimit((SortNode) root);
+            }
             // TODO chenhao, before merge ValueTransferGraph, force evaluate conjuncts
             // from SelectStmt outside
             root = addUnassignedConjuncts(analyzer, root);
@@ -349,6 +356,106 @@ public class SingleNodePlanner {
         return selectNode;
     }
 
+    /**
+     * Let BE answer count(*), count(col), min(col) and max(col) without grouping over a DUP_KEYS table
+     * from the row counts and zone maps of segments, e.g. select count(*), min(ts), max(ts) from tbl.
+     * Rows are not filtered, so there must be no predicate. BE still falls back to read rows if a tablet
+     * has delete predicates or segments without zone maps.
+     */
+    private void pushDownAggNoGrouping(AggregateInfo aggInfo, SelectStmt selectStmt, PlanNode root) {
+        if (!(root instanceof OlapScanNode) || selectStmt.getTableRefs().size() != 1 || aggInfo == null
+                || aggInfo.isDistinctAgg() || !aggInfo.getGroupingExprs().isEmpty()) {
+            return;
+        }
+        OlapScanNode olapNode = (OlapScanNode) root;
+        if (olapNode.getOlapTable().getKeysType() != KeysType.DUP_KEYS
+                || !olapNode.getConjuncts().isEmpty() || olapNode.hasLimit()) {
+            return;
+        }
+        boolean hasCount = false;
+        boolean hasMinMax = false;
+        for (FunctionCallExpr aggExpr : aggInfo.getAggregateExprs()) {
+            String fnName = aggExpr.getFnName().getFunction();
+            if (fnName.equalsIgnoreCase(FunctionSet.COUNT) && aggExpr.getParams().isStar()) {
+                hasCount = true;
+                continue;
+            }
+            if (aggExpr.getChildren().size() != 1 || !(aggExpr.getChild(0) instanceof SlotRef)) {
+                return;
+            }
+            Column column = ((SlotRef) aggExpr.getChild(0)).getDesc().getColumn();
+            if (column == null) {
+                return;
+            }
+            if (fnName.equalsIgnoreCase(FunctionSet.COUNT)) {
+                // the rows returned by BE are not null
+                if (column.isAllowNull()) {
+                    return;
+                }
+                hasCount = true;
+            } else if (fnName.equalsIgnoreCase("min") || fnName.equalsIgnoreCase("max")) {
+                // floating point values in zone maps are not exact
+                Type type = column.getType();
+                if (!type.isFixedPointType() && !type.isDecimalV2() && !type.isDateType()
+                        && !type.isStringType()) {
+                    return;
+                }
+                hasMinMax = true;
+            } else {
+                return;
+            }
+        }
+        if (hasCount && hasMinMax) {
+            olapNode.setPushDownAggNoGroupingOp(TPushAggOp.MIX);
+        } else if (hasCount) {
+            olapNode.setPushDownAggNoGroupingOp(TPushAggOp.COUNT);
+        } else if (hasMinMax) {
+            olapNode.setPushDownAggNoGroupingOp(TPushAggOp.MINMAX);
+        }
+    }
+
+    /**
+     * Let the scanners of an OlapScanNode right below a TOP-N stop after offset + limit rows,
+     * e.g. select * from tbl order by k1, k2 limit 100, since they can return rows in the order of the key columns.
+     * OlapScanNode checks if the ordering columns are a prefix of the key columns of its selected index.
+     */
+    private void pushDownSortLimit(SortNode sortNode) {
+        if (!(sortNode.getChild(0) instanceof OlapScanNode)) {
+            return;
+        }
+        OlapScanNode olapNode = (OlapScanNode) sortNode.getChild(0);
+        SortInfo sortInfo = sortNode.getSortInfo();
+        List<SlotDescriptor> sortSlots = sortInfo.getSortTupleDescriptor().getSlots();
+        List<Expr> sortSlotExprs = sortInfo.getSortTupleSlotExprs();
+        List<Column> orderingColumns = Lists.newArrayList();
+        for (int i = 0; i < sortInfo.getOrderingExprs().size(); ++i) {
+            // rows are stored in ascending order with nulls first
+            if (!sortInfo.getIsAscOrder().get(i) || !sortInfo.getNullsFirst().get(i)) {
+                return;
+            }
+            Expr orderingExpr = sortInfo.getOrderingExprs().get(i);
+            if (!(orderingExpr instanceof SlotRef)) {
+                return;
+            }
+            SlotDescriptor slotDesc = ((SlotRef) orderingExpr).getDesc();
+            int sortSlotIdx = sortSlots.indexOf(slotDesc);
+            if (sortSlotIdx != -1 && sortSlotExprs != null) {
+                // the ordering expr refers to the sort tuple, take the scan slot materialized into it
+                Expr sourceExpr = sortSlotExprs.get(sortSlotIdx);
+                if (!(sourceExpr instanceof SlotRef)) {
+                    return;
+                }
+                slotDesc = ((SlotRef) sourceExpr).getDesc();
+            }
+            if (!slotDesc.getParent().getId().equals(olapNode.getTupleIds().get(0))
+                    || slotDesc.getColumn() == null) {
+                return;
+            }
+            orderingColumns.add(slotDesc.getColumn());
+        }
+        olapNode.setSortLimit(orderingColumns, sortNode.getLimit() + sortNode.getOffset());
+    }
+
     private void turnOffPreAgg(AggregateInfo aggInfo, SelectStmt selectStmt, Analyzer analyzer, PlanNode root) {
         String turnOffReason = null;
         do {
@@ -703,6 +810,7 @@ public class SingleNodePlanner {
         AggregateInfo aggInfo = selectStmt.getAggInfo();
 
         turnOffPreAgg(aggInfo, selectStmt, analyzer, root);
+        pushDownAggNoGrouping(aggInfo, selectStmt, root);
 
         if (root instanceof OlapScanNode) {
             OlapScanNode olapNode = (OlapScanNode) root;
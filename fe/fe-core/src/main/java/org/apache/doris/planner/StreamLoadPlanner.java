@@ -111,6 +111,11 @@ public class StreamLoadPlanner {
         if (!destTable.hasSequenceCol() && taskInfo.hasSequenceCol()) {
             throw new UserException("There is no sequence column in the table " + destTable.getName());
         }
+        if (taskInfo.isPartialColumns() && (destTable.getKeysType() != KeysType.UNIQUE_KEYS
+                || destTable.getEnableUniqueKeyMergeOnWrite() || destTable.hasSequenceCol())) {
+            throw new AnalysisException("partial columns load is only supported in unique tables "
+                    + "without merge-on-write or sequence column.");
+        }
         resetAnalyzer();
         // construct tuple descriptor, used for scanNode and dataSink
         TupleDescriptor tupleDesc = descTable.createTupleDescriptor("DstTableTuple");
@@ -136,6 +141,7 @@ public class StreamLoadPlanner {
         List<Long> partitionIds = getAllPartitionIds();
         OlapTableSink olapTableSink = new OlapTableSink(destTable, tupleDesc, partitionIds);
         olapTableSink.init(loadId, taskInfo.getTxnId(), db.getId(), taskInfo.getTimeout());
+        olapTableSink.setPartialColumns(taskInfo.isPartialColumns());
         olapTableSink.complete();
 
         // for stream load, we only need one fragment, ScanNode -> DataSink.
@@ -122,6 +122,7 @@ public class StreamLoadScanNode extends LoadScanNode {
 
         deleteCondition = taskInfo.getDeleteCondition();
         mergeType = taskInfo.getMergeType();
+        partialColumns = taskInfo.isPartialColumns();
 
         computeStats(analyzer);
         createDefaultSmap(analyzer);
@@ -40,6 +40,7 @@ import org.apache.doris.planner.ExceptNode;
 import org.apache.doris.planner.ExchangeNode;
 import org.apache.doris.planner.HashJoinNode;
 import org.apache.doris.planner.IntersectNode;
+import org.apache.doris.planner.MergeJoinNode;
 import org.apache.doris.planner.OlapScanNode;
 import org.apache.doris.planner.PlanFragment;
 import org.apache.doris.planner.PlanFragmentId;
@@ -63,6 +64,7 @@ import org.apache.doris.thrift.PaloInternalServiceVersion;
 import org.apache.doris.thrift.TDescriptorTable;
 import org.apache.doris.thrift.TEsScanRange;
 import org.apache.doris.thrift.TExecPlanFragmentParams;
+import org.apache.doris.thrift.TExecPlanFragmentParamsList;
 import org.apache.doris.thrift.TLoadErrorHubInfo;
 import org.apache.doris.thrift.TNetworkAddress;
 import org.apache.doris.thrift.TPaloScanRange;
@@ -489,6 +491,8 @@ public class Coordinator {
                     needCheckBackendState = true;
                 }
 
+                // the instances on each backend, started by one rpc if batched
+                Map<TNetworkAddress, List<BackendExecState>> hostToExecStates = Maps.newLinkedHashMap();
                 int instanceId = 0;
                 for (TExecPlanFragmentParams tParam : tParams) {
                     BackendExecState execState = new BackendExecState(fragment.getFragmentId(), instanceId++,
@@ -506,10 +510,21 @@ public class Coordinator {
                                     fragment.getFragmentId().asInt(), jobId);
                         }
                     }
-                    futures.add(Pair.create(execState, execState.execRemoteFragmentAsync()));
+                    if (Config.enable_batch_plan_fragment_dispatch) {
+                        hostToExecStates.computeIfAbsent(execState.address, k -> Lists.newArrayList())
+                                .add(execState);
+                    } else {
+                        futures.add(Pair.create(execState, execState.execRemoteFragmentAsync()));
+                    }
 
                     backendIdx++;
                 }
+                for (List<BackendExecState> execStates : hostToExecStates.values()) {
+                    Future<PExecPlanFragmentResult> future = execRemoteFragmentsAsync(execStates);
+                    for (BackendExecState execState : execStates) {
+                        futures.add(Pair.create(execState, future));
+                    }
+                }
 
                 for (Pair<BackendExecState, Future<PExecPlanFragmentResult>> pair : futures) {
                     TStatusCode code;
@@ -573,6 +588,69 @@ public class Coordinator {
         }
     }
 
+    // Starts the instances of a fragment on the same backend by one rpc. The backend prepares
+    // them in order, so the plan and the common components are only sent with the first one.
+    private Future<PExecPlanFragmentResult> execRemoteFragmentsAsync(List<BackendExecState> execStates)
+            throws TException {
+        BackendExecState first = execStates.get(0);
+        TExecPlanFragmentParamsList paramsList = new TExecPlanFragmentParamsList();
+        for (BackendExecState execState : execStates) {
+            if (execState != first) {
+                execState.rpcParams.unsetFragment();
+                execState.rpcParams.unsetDescTbl();
+                execState.rpcParams.unsetCoord();
+                execState.rpcParams.unsetQueryGlobals();
+                execState.rpcParams.unsetResourceInfo();
+                execState.rpcParams.setIsSimplifiedParam(true);
+            }
+            execState.initiated = true;
+            paramsList.addToParamsList(execState.rpcParams);
+        }
+        TNetworkAddress brpcAddress = new TNetworkAddress(first.backend.getHost(), first.backend.getBrpcPort());
+        try {
+            return BackendServiceProxy.getInstance().execPlanFragmentsAsync(brpcAddress, paramsList);
+        } catch (RpcException e) {
+            return rpcErrorFuture(e);
+        }
+    }
+
+    // a completed future with the error of 'e', so that the following logic will cancel the fragment.
+    private static Future<PExecPlanFragmentResult> rpcErrorFuture(RpcException e) {
+        return new Future<PExecPlanFragmentResult>() {
+            @Override
+            public boolean cancel(boolean mayInterruptIfRunning) {
+                return false;
+            }
+
+            @Override
+            public boolean isCancelled() {
+                return false;
+            }
+
+            @Override
+            public boolean isDone() {
+                return true;
+            }
+
+            @Override
+            public PExecPlanFragmentResult get() {
+                PExecPlanFragmentResult result = new PExecPlanFragmentResult();
+                PStatus pStatus = new PStatus();
+                pStatus.error_msgs = Lists.newArrayList();
+                pStatus.error_msgs.add(e.getMessage());
+                // use THRIFT_RPC_ERROR so that this BE will be added to the blacklist later.
+                pStatus.status_code = TStatusCode.THRIFT_RPC_ERROR.getValue();
+                result.status = pStatus;
+                return result;
+            }
+
+            @Override
+            public PExecPlanFragmentResult get(long timeout, TimeUnit unit) {
+                return get();
+            }
+        };
+    }
+
     public List<String> getExportFiles() {
         return exportFiles;
     }
@@ -1121,6 +1199,11 @@ public class Coordinator {
             }
         }
 
+        if (node instanceof MergeJoinNode) {
+            colocateFragmentIds.add(node.getFragmentId().asInt());
+            return true;
+        }
+
         for (PlanNode childNode : node.getChildren()) {
             return isColocateJoin(childNode);
         }
@@ -1810,39 +1893,7 @@ public class Coordinator {
             } catch (RpcException e) {
                 // DO NOT throw exception here, return a complete future with error code,
                 // so that the following logic will cancel the fragment.
-                return new Future<PExecPlanFragmentResult>() {
-                    @Override
-                    public boolean cancel(boolean mayInterruptIfRunning) {
-                        return false;
-                    }
-
-                    @Override
-                    public boolean isCancelled() {
-                        return false;
-                    }
-
-                    @Override
-                    public boolean isDone() {
-                        return true;
-                    }
-
-                    @Override
-                    public PExecPlanFragmentResult get() {
-                        PExecPlanFragmentResult result = new PExecPlanFragmentResult();
-                        PStatus pStatus = new PStatus();
-                        pStatus.error_msgs = Lists.newArrayList();
-                        pStatus.error_msgs.add(e.getMessage());
-                        // use THRIFT_RPC_ERROR so that this BE will be added to the blacklist later.
-                        pStatus.status_code = TStatusCode.THRIFT_RPC_ERROR.getValue();
-                        result.status = pStatus;
-                        return result;
-                    }
-
-                    @Override
-                    public PExecPlanFragmentResult get(long timeout, TimeUnit unit) {
-                        return get();
-                    }
-                };
+                return rpcErrorFuture(e);
             }
         }
 
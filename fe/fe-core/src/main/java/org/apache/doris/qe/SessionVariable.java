@@ -72,6 +72,7 @@ public class SessionVariable implements Serializable, Writable {
     public static final String DISABLE_STREAMING_PREAGGREGATIONS = "disable_streaming_preaggregations";
     public static final String DISABLE_COLOCATE_JOIN = "disable_colocate_join";
     public static final String ENABLE_BUCKET_SHUFFLE_JOIN = "enable_bucket_shuffle_join";
+    public static final String ENABLE_MERGE_JOIN = "enable_merge_join";
     public static final String PARALLEL_FRAGMENT_EXEC_INSTANCE_NUM = "parallel_fragment_exec_instance_num";
     public static final String ENABLE_INSERT_STRICT = "enable_insert_strict";
     public static final String ENABLE_SPILLING = "enable_spilling";
@@ -108,6 +109,15 @@ public class SessionVariable implements Serializable, Writable {
     public static final String MAX_SCAN_KEY_NUM = "max_scan_key_num";
     public static final String MAX_PUSHDOWN_CONDITIONS_PER_COLUMN = "max_pushdown_conditions_per_column";
 
+    public static final String EXCHANGE_COMPRESS_TYPE = "exchange_compress_type";
+    public static final String EXCHANGE_COMPRESS_LEVEL = "exchange_compress_level";
+    public static final String ENABLE_ADAPTIVE_EXCHANGE_COMPRESS = "enable_adaptive_exchange_compress";
+
+    // not RESOURCE_VARIABLE, which is the resource group of the user on FE
+    public static final String EXEC_RESOURCE_GROUP = "exec_resource_group";
+
+    public static final String ENABLE_PERF_COUNTERS = "enable_perf_counters";
+
     // max memory used on every backend.
     @VariableMgr.VarAttr(name = EXEC_MEM_LIMIT)
     public long maxExecMemByte = 2147483648L;
@@ -219,6 +229,10 @@ public class SessionVariable implements Serializable, Writable {
     @VariableMgr.VarAttr(name = ENABLE_BUCKET_SHUFFLE_JOIN)
     private boolean enableBucketShuffleJoin = false;
 
+    // Replace colocate inner joins on the first key columns of both tables by merge joins
+    @VariableMgr.VarAttr(name = ENABLE_MERGE_JOIN)
+    private boolean enableMergeJoin = false;
+
     @VariableMgr.VarAttr(name = PREFER_JOIN_METHOD)
     private String preferJoinMethod = "broadcast";
 
@@ -270,6 +284,22 @@ public class SessionVariable implements Serializable, Writable {
     @VariableMgr.VarAttr(name = SHOW_HIDDEN_COLUMNS, flag = VariableMgr.SESSION_ONLY)
     private boolean showHiddenColumns = false;
 
+    // codec of the row batches sent by exchange, empty means BE will use its config value
+    @VariableMgr.VarAttr(name = EXCHANGE_COMPRESS_TYPE)
+    private String exchangeCompressType = "";
+    // only used by ZSTD, 0 means the default level
+    @VariableMgr.VarAttr(name = EXCHANGE_COMPRESS_LEVEL)
+    private int exchangeCompressLevel = 0;
+    // skip compression for receivers on the same BE and for poorly compressed batches
+    @VariableMgr.VarAttr(name = ENABLE_ADAPTIVE_EXCHANGE_COMPRESS)
+    private boolean enableAdaptiveExchangeCompress = false;
+    // resource group of the queries on BE, empty means none, see BE config `resource_groups`
+    @VariableMgr.VarAttr(name = EXEC_RESOURCE_GROUP)
+    private String execResourceGroup = "";
+    // count hardware events like cycles and cache misses of the query in its profile
+    @VariableMgr.VarAttr(name = ENABLE_PERF_COUNTERS)
+    private boolean enablePerfCounters = false;
+
     public long getMaxExecMemByte() {
         return maxExecMemByte;
     }
@@ -422,6 +452,10 @@ public class SessionVariable implements Serializable, Writable {
         return enableBucketShuffleJoin;
     }
 
+    public boolean isEnableMergeJoin() {
+        return enableMergeJoin;
+    }
+
     public String getPreferJoinMethod() {return preferJoinMethod; }
 
     public void setPreferJoinMethod(String preferJoinMethod) {this.preferJoinMethod = preferJoinMethod; }
@@ -520,6 +554,46 @@ public class SessionVariable implements Serializable, Writable {
         this.maxPushdownConditionsPerColumn = maxPushdownConditionsPerColumn;
     }
 
+    public String getExchangeCompressType() {
+        return exchangeCompressType;
+    }
+
+    public void setExchangeCompressType(String exchangeCompressType) {
+        this.exchangeCompressType = exchangeCompressType;
+    }
+
+    public int getExchangeCompressLevel() {
+        return exchangeCompressLevel;
+    }
+
+    public void setExchangeCompressLevel(int exchangeCompressLevel) {
+        this.exchangeCompressLevel = exchangeCompressLevel;
+    }
+
+    public boolean isEnableAdaptiveExchangeCompress() {
+        return enableAdaptiveExchangeCompress;
+    }
+
+    public void setEnableAdaptiveExchangeCompress(boolean enableAdaptiveExchangeCompress) {
+        this.enableAdaptiveExchangeCompress = enableAdaptiveExchangeCompress;
+    }
+
+    public String getExecResourceGroup() {
+        return execResourceGroup;
+    }
+
+    public void setExecResourceGroup(String execResourceGroup) {
+        this.execResourceGroup = execResourceGroup;
+    }
+
+    public boolean isEnablePerfCounters() {
+        return enablePerfCounters;
+    }
+
+    public void setEnablePerfCounters(boolean enablePerfCounters) {
+        this.enablePerfCounters = enablePerfCounters;
+    }
+
     public boolean showHiddenColumns() {
         return showHiddenColumns;
     }
@@ -556,6 +630,15 @@ public class SessionVariable implements Serializable, Writable {
             tResult.setMaxPushdownConditionsPerColumn(maxPushdownConditionsPerColumn);
         }
         tResult.setEnableSpilling(enableSpilling);
+        if (!exchangeCompressType.isEmpty()) {
+            tResult.setExchangeCompressType(exchangeCompressType.toUpperCase());
+        }
+        tResult.setExchangeCompressLevel(exchangeCompressLevel);
+        tResult.setEnableAdaptiveExchangeCompress(enableAdaptiveExchangeCompress);
+        if (!execResourceGroup.isEmpty()) {
+            tResult.setResourceGroup(execResourceGroup);
+        }
+        tResult.setEnablePerfCounters(enablePerfCounters);
         return tResult;
     }
 
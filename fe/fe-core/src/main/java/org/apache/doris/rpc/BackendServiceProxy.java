@@ -34,6 +34,7 @@ import org.apache.doris.proto.PTriggerProfileReportResult;
 import org.apache.doris.proto.PUniqueId;
 import org.apache.doris.proto.PUpdateCacheRequest;
 import org.apache.doris.thrift.TExecPlanFragmentParams;
+import org.apache.doris.thrift.TExecPlanFragmentParamsList;
 import org.apache.doris.thrift.TNetworkAddress;
 import org.apache.doris.thrift.TUniqueId;
 
@@ -99,9 +100,24 @@ public class BackendServiceProxy {
             throws TException, RpcException {
         final PExecPlanFragmentRequest pRequest = new PExecPlanFragmentRequest();
         pRequest.setRequest(tRequest);
+        return execPlanFragmentAsync(address, pRequest, false);
+    }
+
+    // start the instances of a fragment on the same backend by one rpc
+    public Future<PExecPlanFragmentResult> execPlanFragmentsAsync(
+            TNetworkAddress address, TExecPlanFragmentParamsList tRequest)
+            throws TException, RpcException {
+        final PExecPlanFragmentRequest pRequest = new PExecPlanFragmentRequest();
+        pRequest.setRequest(tRequest);
+        return execPlanFragmentAsync(address, pRequest, true);
+    }
+
+    private Future<PExecPlanFragmentResult> execPlanFragmentAsync(
+            TNetworkAddress address, PExecPlanFragmentRequest pRequest, boolean isBatch)
+            throws RpcException {
         try {
             final PBackendService service = getProxy(address);
-            return service.execPlanFragmentAsync(pRequest);
+            return isBatch ? service.execPlanFragmentsAsync(pRequest) : service.execPlanFragmentAsync(pRequest);
         } catch (NoSuchElementException e) {
             try {
                 // retry
@@ -111,7 +127,7 @@ public class BackendServiceProxy {
                     // do nothing
                 }
                 final PBackendService service = getProxy(address);
-                return service.execPlanFragmentAsync(pRequest);
+                return isBatch ? service.execPlanFragmentsAsync(pRequest) : service.execPlanFragmentAsync(pRequest);
             } catch (NoSuchElementException noSuchElementException) {
                 LOG.warn("Execute plan fragment retry failed, address={}:{}",
                         address.getHostname(), address.getPort(), noSuchElementException);
@@ -34,6 +34,8 @@ import org.apache.doris.thrift.TTabletSchema;
 import org.apache.doris.thrift.TTabletType;
 import org.apache.doris.thrift.TTaskType;
 
+import com.google.common.base.Strings;
+
 import org.apache.commons.collections.CollectionUtils;
 import org.apache.logging.log4j.LogManager;
 import org.apache.logging.log4j.Logger;
@@ -79,6 +81,15 @@ public class CreateReplicaTask extends AgentTask {
 
     private TStorageFormat storageFormat = null;
 
+    // codec of segment v2 pages, empty means the default of BE
+    private String compressionType = "";
+    private int compressionLevel = 0;
+
+    private boolean enableUniqueKeyMergeOnWrite = false;
+
+    // names of the columns whose Z-order the rows are sorted by, empty if sorted by keys
+    private List<String> clusteringColumns = null;
+
     // true if this task is created by recover request(See comment of Config.recover_with_empty_tablet)
     private boolean isRecoverTask = false;
 
@@ -156,6 +167,19 @@ public class CreateReplicaTask extends AgentTask {
         this.storageFormat = storageFormat;
     }
 
+    public void setCompression(String compressionType, int compressionLevel) {
+        this.compressionType = compressionType;
+        this.compressionLevel = compressionLevel;
+    }
+
+    public void setEnableUniqueKeyMergeOnWrite(boolean enableUniqueKeyMergeOnWrite) {
+        this.enableUniqueKeyMergeOnWrite = enableUniqueKeyMergeOnWrite;
+    }
+
+    public void setClusteringColumns(List<String> clusteringColumns) {
+        this.clusteringColumns = clusteringColumns;
+    }
+
     public TCreateTabletReq toThrift() {
         TCreateTabletReq createTabletReq = new TCreateTabletReq();
         createTabletReq.setTabletId(tabletId);
@@ -206,6 +230,25 @@ public class CreateReplicaTask extends AgentTask {
             tSchema.setBloomFilterFpp(bfFpp);
         }
         tSchema.setIsInMemory(isInMemory);
+        if (!Strings.isNullOrEmpty(compressionType)) {
+            tSchema.setCompressionType(compressionType);
+            tSchema.setCompressionLevel(compressionLevel);
+        }
+        if (enableUniqueKeyMergeOnWrite) {
+            tSchema.setEnableUniqueKeyMergeOnWrite(true);
+        }
+        if (CollectionUtils.isNotEmpty(clusteringColumns)) {
+            List<Integer> clusteringColumnIdxs = new ArrayList<>();
+            for (String clusteringColumn : clusteringColumns) {
+                for (int i = 0; i < columns.size(); i++) {
+                    if (columns.get(i).getName().equalsIgnoreCase(clusteringColumn)) {
+                        clusteringColumnIdxs.add(i);
+                        break;
+                    }
+                }
+            }
+            tSchema.setClusteringColumnIdxs(clusteringColumnIdxs);
+        }
         createTabletReq.setTabletSchema(tSchema);
 
         createTabletReq.setVersion(version);
@@ -74,6 +74,8 @@ public class StreamLoadTask implements LoadTaskInfo {
     private LoadTask.MergeType mergeType = LoadTask.MergeType.APPEND; // default is all data is load no delete
     private Expr deleteCondition;
     private String sequenceCol;
+    // the load only updates its columns of a unique table, the others are left unchanged
+    private boolean partialColumns = false;
 
     public StreamLoadTask(TUniqueId id, long txnId, TFileType fileType, TFileFormatType formatType) {
         this.id = id;
@@ -172,6 +174,10 @@ public class StreamLoadTask implements LoadTaskInfo {
         return !Strings.isNullOrEmpty(sequenceCol);
     }
 
+    public boolean isPartialColumns() {
+        return partialColumns;
+    }
+
     public static StreamLoadTask fromTStreamLoadPutRequest(TStreamLoadPutRequest request, Database db) throws UserException {
         StreamLoadTask streamLoadTask = new StreamLoadTask(request.getLoadId(), request.getTxnId(),
                                                            request.getFileType(), request.getFormatType());
@@ -251,6 +257,9 @@ public class StreamLoadTask implements LoadTaskInfo {
             // add expr for sequence column
             columnExprDescs.add(new ImportColumnDesc(Column.SEQUENCE_COL, new SlotRef(null, sequenceCol)));
         }
+        if (request.isSetPartialColumns()) {
+            partialColumns = request.isPartialColumns();
+        }
     }
 
     // used for stream load
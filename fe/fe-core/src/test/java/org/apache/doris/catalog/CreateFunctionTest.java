@@ -21,6 +21,7 @@ import org.apache.doris.analysis.CreateDbStmt;
 import org.apache.doris.analysis.CreateFunctionStmt;
 import org.apache.doris.analysis.Expr;
 import org.apache.doris.analysis.FunctionCallExpr;
+import org.apache.doris.common.AnalysisException;
 import org.apache.doris.common.FeConstants;
 import org.apache.doris.common.jmockit.Deencapsulation;
 import org.apache.doris.planner.PlanFragment;
@@ -29,6 +30,7 @@ import org.apache.doris.planner.UnionNode;
 import org.apache.doris.qe.ConnectContext;
 import org.apache.doris.qe.QueryState;
 import org.apache.doris.qe.StmtExecutor;
+import org.apache.doris.thrift.TFunction;
 import org.apache.doris.utframe.UtFrameUtils;
 
 import org.junit.AfterClass;
@@ -104,4 +106,39 @@ public class CreateFunctionTest {
         Assert.assertEquals(1, constExprLists.get(0).size());
         Assert.assertTrue(constExprLists.get(0).get(0) instanceof FunctionCallExpr);
     }
+
+    @Test
+    public void testBatchFn() throws Exception {
+        ConnectContext ctx = UtFrameUtils.createDefaultCtx();
+        String createDbStmtStr = "create database db2;";
+        CreateDbStmt createDbStmt = (CreateDbStmt) UtFrameUtils.parseAndAnalyzeStmt(createDbStmtStr, ctx);
+        Catalog.getCurrentCatalog().createDb(createDbStmt);
+        Database db = Catalog.getCurrentCatalog().getDb("default_cluster:db2");
+
+        String createFuncStr = "create function db2.my_add(INT, INT) RETURNS INT properties\n" +
+                "(\n" +
+                "\"symbol\" = \"_ZN9doris_udf6AddUdfEPNS_15FunctionContextERKNS_6IntValES4_\",\n" +
+                "\"batch_fn\" = \"_ZN9doris_udf11AddUdfBatchEPNS_15FunctionContextEiPKiPKPKNS_6AnyValEPS5_\",\n" +
+                "\"object_file\" = \"http://127.0.0.1:8008/libcmy_udf.so\"\n" +
+                ");";
+        CreateFunctionStmt createFunctionStmt =
+                (CreateFunctionStmt) UtFrameUtils.parseAndAnalyzeStmt(createFuncStr, ctx);
+        Catalog.getCurrentCatalog().createFunction(createFunctionStmt);
+        List<Function> functions = db.getFunctions();
+        Assert.assertEquals(1, functions.size());
+        TFunction fn = functions.get(0).toThrift();
+        Assert.assertEquals("_ZN9doris_udf11AddUdfBatchEPNS_15FunctionContextEiPKiPKPKNS_6AnyValEPS5_",
+                fn.getScalarFn().getBatchFnSymbol());
+
+        // variadic functions have no batch form
+        String createVariadicFuncStr = "create function db2.my_concat(VARCHAR(1024), ...) RETURNS VARCHAR(1024)"
+                + " properties (\"symbol\" = \"my_concat\", \"batch_fn\" = \"my_concat_batch\","
+                + " \"object_file\" = \"http://127.0.0.1:8008/libcmy_udf.so\");";
+        try {
+            UtFrameUtils.parseAndAnalyzeStmt(createVariadicFuncStr, ctx);
+            Assert.fail();
+        } catch (AnalysisException e) {
+            Assert.assertTrue(e.getMessage().contains("batch_fn"));
+        }
+    }
 }
@@ -26,6 +26,8 @@ import org.apache.doris.common.ExceptionChecker;
 import org.apache.doris.qe.ConnectContext;
 import org.apache.doris.utframe.UtFrameUtils;
 
+import com.google.common.collect.Lists;
+
 import org.junit.AfterClass;
 import org.junit.Assert;
 import org.junit.BeforeClass;
@@ -109,6 +111,22 @@ public class CreateTableTest {
                         + "distributed by hash(k2) buckets 1\n" + "properties('replication_num' = '1',\n"
                         + "'function_column.sequence_type' = 'int');"));
 
+        ExceptionChecker
+                .expectThrowsNoException(() -> createTable("create table test.tbl9\n" + "(k1 int, k2 int)\n"
+                        + "distributed by hash(k1) buckets 1\n"
+                        + "properties('replication_num' = '1', 'compression' = 'zstd', 'compression_level' = '9');"));
+
+        ExceptionChecker
+                .expectThrowsNoException(() -> createTable("create table test.tbl10\n" + "(k1 int, k2 int, v1 int)\n"
+                        + "unique key(k1, k2)\n" + "distributed by hash(k1) buckets 1\n"
+                        + "properties('replication_num' = '1', 'enable_unique_key_merge_on_write' = 'true');"));
+
+        ExceptionChecker
+                .expectThrowsNoException(() -> createTable("create table test.tbl11\n"
+                        + "(k1 int, k2 varchar(10), v1 datetime, v2 double)\n"
+                        + "duplicate key(k1, k2)\n" + "distributed by hash(k1) buckets 1\n"
+                        + "properties('replication_num' = '1', 'clustering_columns' = 'K2, v1');"));
+
         Database db = Catalog.getCurrentCatalog().getDb("default_cluster:test");
         OlapTable tbl6 = (OlapTable) db.getTable("tbl6");
         Assert.assertTrue(tbl6.getColumn("k1").isKey());
@@ -125,6 +143,21 @@ public class CreateTableTest {
         Assert.assertTrue(tbl8.getColumn("k2").isKey());
         Assert.assertFalse(tbl8.getColumn("v1").isKey());
         Assert.assertTrue(tbl8.getColumn(Column.SEQUENCE_COL).getAggregationType() == AggregateType.REPLACE);
+
+        OlapTable tbl9 = (OlapTable) db.getTable("tbl9");
+        Assert.assertEquals("ZSTD", tbl9.getCompressionType());
+        Assert.assertEquals(9, tbl9.getCompressionLevel());
+        Assert.assertEquals("", tbl8.getCompressionType());
+
+        OlapTable tbl10 = (OlapTable) db.getTable("tbl10");
+        Assert.assertTrue(tbl10.getEnableUniqueKeyMergeOnWrite());
+        Assert.assertFalse(tbl8.getEnableUniqueKeyMergeOnWrite());
+
+        OlapTable tbl11 = (OlapTable) db.getTable("tbl11");
+        Assert.assertEquals(Lists.newArrayList("k2", "v1"), tbl11.getClusteringColumns());
+        Assert.assertEquals(Lists.newArrayList("k2", "v1"), tbl11.getClusteringColumns(tbl11.getBaseIndexId()));
+        Assert.assertTrue(tbl11.getClusteringColumns(tbl11.getBaseIndexId() + 1).isEmpty());
+        Assert.assertTrue(tbl8.getClusteringColumns().isEmpty());
     }
 
     @Test
@@ -167,6 +200,40 @@ public class CreateTableTest {
                                 + "duplicate key(k1, k2, k3)\n" + "distributed by hash(k1) buckets 1\n"
                                 + "properties('replication_num' = '1');"));
 
+        ExceptionChecker.expectThrowsWithMsg(DdlException.class, "unknown compression: LZO",
+                () -> createTable("create table test.atbl8\n" + "(k1 int, k2 int)\n"
+                        + "distributed by hash(k1) buckets 1\n"
+                        + "properties('replication_num' = '1', 'compression' = 'lzo');"));
+
+        ExceptionChecker.expectThrowsWithMsg(DdlException.class, "compression level is only supported by ZSTD",
+                () -> createTable("create table test.atbl8\n" + "(k1 int, k2 int)\n"
+                        + "distributed by hash(k1) buckets 1\n"
+                        + "properties('replication_num' = '1', 'compression' = 'lz4', 'compression_level' = '3');"));
+
+        ExceptionChecker.expectThrowsWithMsg(DdlException.class,
+                "merge-on-write is only supported by unique key tables",
+                () -> createTable("create table test.atbl8\n" + "(k1 int, k2 int)\n"
+                        + "duplicate key(k1)\n" + "distributed by hash(k1) buckets 1\n"
+                        + "properties('replication_num' = '1', 'enable_unique_key_merge_on_write' = 'true');"));
+
+        ExceptionChecker.expectThrowsWithMsg(DdlException.class,
+                "clustering columns are only supported by duplicate key tables",
+                () -> createTable("create table test.atbl9\n" + "(k1 int, k2 int, v1 int)\n"
+                        + "unique key(k1)\n" + "distributed by hash(k1) buckets 1\n"
+                        + "properties('replication_num' = '1', 'clustering_columns' = 'k2,v1');"));
+
+        ExceptionChecker.expectThrowsWithMsg(DdlException.class,
+                "DOUBLE is not supported as clustering column",
+                () -> createTable("create table test.atbl9\n" + "(k1 int, k2 int, v1 double)\n"
+                        + "duplicate key(k1)\n" + "distributed by hash(k1) buckets 1\n"
+                        + "properties('replication_num' = '1', 'clustering_columns' = 'k2,v1');"));
+
+        ExceptionChecker.expectThrowsWithMsg(DdlException.class,
+                "The number of clustering columns must be between 2 and 4",
+                () -> createTable("create table test.atbl9\n" + "(k1 int, k2 int, v1 int)\n"
+                        + "duplicate key(k1)\n" + "distributed by hash(k1) buckets 1\n"
+                        + "properties('replication_num' = '1', 'clustering_columns' = 'k2');"));
+
         ConfigBase.setMutableConfig("enable_strict_storage_medium_check", "true");
         ExceptionChecker
                 .expectThrowsWithMsg(DdlException.class, "Failed to find enough host with storage medium is SSD in all backends. need: 1",
@@ -1381,6 +1381,99 @@ public class QueryPlanTest {
         explainString = UtFrameUtils.getSQLPlanOrErrorMsg(connectContext, "EXPLAIN " + sql);
         Assert.assertTrue(explainString.contains("PREDICATES: `date` IN ('2020-10-30 00:00:00')"));
     }
-}
 
+    @Test
+    public void testPushDownAggNoGrouping() throws Exception {
+        connectContext.setDatabase("default_cluster:test");
+        String sql = "select count(*), min(dt), max(value) from join1";
+        String explainString = UtFrameUtils.getSQLPlanOrErrorMsg(connectContext, "EXPLAIN " + sql);
+        Assert.assertTrue(explainString.contains("PUSHAGGOP: MIX"));
+
+        sql = "select min(dt), max(id) from join1";
+        explainString = UtFrameUtils.getSQLPlanOrErrorMsg(connectContext, "EXPLAIN " + sql);
+        Assert.assertTrue(explainString.contains("PUSHAGGOP: MINMAX"));
+
+        sql = "select count(*) from join1";
+        explainString = UtFrameUtils.getSQLPlanOrErrorMsg(connectContext, "EXPLAIN " + sql);
+        Assert.assertTrue(explainString.contains("PUSHAGGOP: COUNT"));
 
+        // rows have to be read
+        sql = "select count(*) from join1 where id > 1";
+        explainString = UtFrameUtils.getSQLPlanOrErrorMsg(connectContext, "EXPLAIN " + sql);
+        Assert.assertFalse(explainString.contains("PUSHAGGOP"));
+        sql = "select dt, max(id) from join1 group by dt";
+        explainString = UtFrameUtils.getSQLPlanOrErrorMsg(connectContext, "EXPLAIN " + sql);
+        Assert.assertFalse(explainString.contains("PUSHAGGOP"));
+        sql = "select count(*), sum(id) from join1";
+        explainString = UtFrameUtils.getSQLPlanOrErrorMsg(connectContext, "EXPLAIN " + sql);
+        Assert.assertFalse(explainString.contains("PUSHAGGOP"));
+        sql = "select count(distinct id) from join1";
+        explainString = UtFrameUtils.getSQLPlanOrErrorMsg(connectContext, "EXPLAIN " + sql);
+        Assert.assertFalse(explainString.contains("PUSHAGGOP"));
+    }
+
+    @Test
+    public void testPushDownSortLimit() throws Exception {
+        connectContext.setDatabase("default_cluster:test");
+        String sql = "select * from join1 order by dt, id limit 10 offset 5";
+        String explainString = UtFrameUtils.getSQLPlanOrErrorMsg(connectContext, "EXPLAIN " + sql);
+        Assert.assertTrue(explainString.contains("SORTLIMIT: 15"));
+
+        sql = "select * from join1 where value = 'a' order by dt limit 10";
+        explainString = UtFrameUtils.getSQLPlanOrErrorMsg(connectContext, "EXPLAIN " + sql);
+        Assert.assertTrue(explainString.contains("SORTLIMIT: 10"));
+
+        // not the order rows are stored in
+        sql = "select * from join1 order by id limit 10";
+        explainString = UtFrameUtils.getSQLPlanOrErrorMsg(connectContext, "EXPLAIN " + sql);
+        Assert.assertFalse(explainString.contains("SORTLIMIT"));
+        sql = "select * from join1 order by dt desc limit 10";
+        explainString = UtFrameUtils.getSQLPlanOrErrorMsg(connectContext, "EXPLAIN " + sql);
+        Assert.assertFalse(explainString.contains("SORTLIMIT"));
+        sql = "select * from join1 order by dt nulls last limit 10";
+        explainString = UtFrameUtils.getSQLPlanOrErrorMsg(connectContext, "EXPLAIN " + sql);
+        Assert.assertFalse(explainString.contains("SORTLIMIT"));
+        sql = "select * from join1 order by dt + 1 limit 10";
+        explainString = UtFrameUtils.getSQLPlanOrErrorMsg(connectContext, "EXPLAIN " + sql);
+        Assert.assertFalse(explainString.contains("SORTLIMIT"));
+        sql = "select dt, count(*) from join1 group by dt order by dt limit 10";
+        explainString = UtFrameUtils.getSQLPlanOrErrorMsg(connectContext, "EXPLAIN " + sql);
+        Assert.assertFalse(explainString.contains("SORTLIMIT"));
+    }
+
+    @Test
+    public void testMinMaxOnSlidingWindow() throws Exception {
+        connectContext.setDatabase("default_cluster:test");
+        String sql = "select dt, max(id) over (partition by value order by dt "
+                + "rows between 2 preceding and current row) from join1";
+        String explainString = UtFrameUtils.getSQLPlanOrErrorMsg(connectContext, "EXPLAIN " + sql);
+        Assert.assertTrue(explainString.contains("window: ROWS BETWEEN 2 PRECEDING AND CURRENT ROW"));
+
+        sql = "select dt, min(value) over (order by dt rows between 1 following and 3 following) "
+                + "from join1";
+        explainString = UtFrameUtils.getSQLPlanOrErrorMsg(connectContext, "EXPLAIN " + sql);
+        Assert.assertTrue(explainString.contains("window: ROWS BETWEEN 1 FOLLOWING AND 3 FOLLOWING"));
+    }
+
+    @Test
+    public void testMergeJoin() throws Exception {
+        FeConstants.runningUnitTest = true;
+        Deencapsulation.setField(connectContext.getSessionVariable(), "enableMergeJoin", true);
+
+        String queryStr = "explain select * from test.colocate1 t1, test.colocate2 t2 where t1.k2 = t2.k2 and t1.k1 = t2.k1";
+        String explainString = UtFrameUtils.getSQLPlanOrErrorMsg(connectContext, queryStr);
+        Assert.assertTrue(explainString.contains("join op: MERGE JOIN"));
+        Assert.assertTrue(explainString.contains("ORDEREDKEYS: 2"));
+
+        // only inner joins are merged
+        queryStr = "explain select * from test.colocate1 t1 left join test.colocate2 t2 on t1.k1 = t2.k1 and t1.k2 = t2.k2";
+        explainString = UtFrameUtils.getSQLPlanOrErrorMsg(connectContext, queryStr);
+        Assert.assertTrue(explainString.contains("colocate: true"));
+        Assert.assertFalse(explainString.contains("MERGE JOIN"));
+
+        Deencapsulation.setField(connectContext.getSessionVariable(), "enableMergeJoin", false);
+        queryStr = "explain select * from test.colocate1 t1, test.colocate2 t2 where t1.k1 = t2.k1 and t1.k2 = t2.k2";
+        explainString = UtFrameUtils.getSQLPlanOrErrorMsg(connectContext, queryStr);
+        Assert.assertFalse(explainString.contains("MERGE JOIN"));
+    }
+}
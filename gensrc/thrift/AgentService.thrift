@@ -35,6 +35,8 @@ struct TColumn {
     7: optional bool is_bloom_filter_column
     8: optional Exprs.TExpr define_expr
     9: optional bool visible = true
+    // codec of segment v2 pages of this column, if not set, use the one of TTabletSchema
+    10: optional string compression_type
 }
 
 struct TTabletSchema {
@@ -48,6 +50,17 @@ struct TTabletSchema {
     8: optional bool is_in_memory
     9: optional i32 delete_sign_idx = -1
     10: optional i32 sequence_col_idx = -1
+    // codec of segment v2 pages, one of NO_COMPRESSION, SNAPPY, LZ4, LZ4F, ZLIB and ZSTD.
+    // If not set, LZ4F is used.
+    11: optional string compression_type
+    // compression level of compression_type, only ZSTD supports it. 0 means default.
+    12: optional i32 compression_level = 0
+    // only for UNIQUE_KEYS, if true, rows replaced by a load are marked in delete bitmap
+    // when the load is published, so that reads don't need to merge rowsets
+    13: optional bool enable_unique_key_merge_on_write = false
+    // only for DUP_KEYS, indexes in columns of the 2 to 4 columns whose Z-order the rows of
+    // a segment are sorted by instead of the keys
+    14: optional list<i32> clustering_column_idxs
 }
 
 // this enum stands for different storage format in src_backends
@@ -206,6 +219,13 @@ struct TSnapshotRequest {
     // if all nodes has been upgraded, it can be removed.
     8: optional bool allow_incremental_clone
     9: optional i32 preferred_snapshot_version = Types.TPREFER_SNAPSHOT_REQ_VERSION
+    // the rowsets of a previous snapshot of the tablet kept by the requester, by the ids in
+    // its header. A full snapshot of TSNAPSHOT_REQ_VERSION2 doesn't link their files, but
+    // its header still lists them.
+    10: optional list<string> base_rowset_ids
+    // the versions of the rowsets the requester has, the start and end version of each in
+    // turn. The files of beta rowsets of the same versions are not linked either.
+    11: optional list<Types.TVersion> base_versions
 }
 
 struct TReleaseSnapshotRequest {
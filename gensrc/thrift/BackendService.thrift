@@ -29,10 +29,31 @@ struct TExportTaskRequest {
     1: required PaloInternalService.TExecPlanFragmentParams params
 }
 
+struct THistogramBucket {
+    1: required string lower
+    2: required string upper
+    // approximate number of rows in [lower, upper]
+    3: required i64 count
+}
+
+struct TColumnStatistics {
+    1: required string column_name
+    // approximate number of distinct not-null values
+    2: optional i64 ndv
+    3: optional i64 null_count
+    4: optional string min_value
+    5: optional string max_value
+    // equi-height buckets in the order of values, which may overlap
+    6: optional list<THistogramBucket> histogram
+}
+
 struct TTabletStat {
     1: required i64 tablet_id
     2: optional i64 data_size
     3: optional i64 row_num
+    // the version whose rows column_stats are collected from
+    4: optional i64 column_stats_version
+    5: optional list<TColumnStatistics> column_stats
 }
 
 struct TTabletStatResult {
@@ -122,6 +122,7 @@ struct TOlapTableSink {
     12: required Descriptors.TOlapTableLocationParam location
     13: required Descriptors.TPaloNodesInfo nodes_info
     14: optional i64 load_channel_timeout_s // the timeout of load channels in second
+    15: optional bool partial_columns // the rows only update the columns of the load
 }
 
 struct TDataSink {
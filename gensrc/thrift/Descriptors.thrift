@@ -100,7 +100,10 @@ enum THdfsCompression {
 }
 
 enum TIndexType {
-  BITMAP
+  BITMAP,
+  NGRAM,
+  // columns are the longitude and the latitude columns of the points
+  S2
 }
 
 // Mapping from names defined by Avro to the enum.
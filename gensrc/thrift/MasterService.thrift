@@ -89,11 +89,16 @@ struct TReportRequest {
     // the max compaction score of all tablets on a backend,
     // this field should be set along with tablet report
     8: optional i64 tablet_max_compaction_score
+    // if true, 'tablets' only contains the tablets changed since the last accepted tablet report,
+    // the tablets not in it are unchanged rather than dropped
+    9: optional bool is_incremental_tablet_report
 }
 
 struct TMasterResult {
     // required in V1
     1: required Status.TStatus status
+    // set by FE that accepts incremental tablet reports
+    2: optional bool support_incremental_tablet_report
 }
 
 // Now we only support CPU share.
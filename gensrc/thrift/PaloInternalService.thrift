@@ -138,6 +138,19 @@ struct TQueryOptions {
   30: optional i32 max_pushdown_conditions_per_column
   // whether enable spilling to disk
   31: optional bool enable_spilling = false;
+  // codec to compress the row batches sent by exchange, one of NO_COMPRESSION, SNAPPY,
+  // LZ4, LZ4F, ZLIB and ZSTD. If not set, see BE config `compress_rowbatches`.
+  32: optional string exchange_compress_type
+  // compression level of exchange_compress_type, only ZSTD supports it. 0 means default.
+  33: optional i32 exchange_compress_level = 0
+  // if true, exchange skips compression for receivers on the same Backend, and for a
+  // while after a row batch didn't compress well.
+  34: optional bool enable_adaptive_exchange_compress = false
+  // name of the resource group to run the query in, see BE config `resource_groups`.
+  35: optional string resource_group
+  // count the hardware events, e.g. cycles and cache misses, of the threads running the
+  // fragment instances and their scanners in the profile
+  36: optional bool enable_perf_counters = false
 }
     
 
@@ -270,6 +283,13 @@ struct TExecPlanFragmentParams {
   16: optional bool is_simplified_param
 }
 
+// The instances of a fragment on one BE, started by one exec_plan_fragments rpc. Only the
+// first one carries the fragment, the others share it. They're prepared in order, so the
+// @Common components may be set in the first one only.
+struct TExecPlanFragmentParamsList {
+  1: optional list<TExecPlanFragmentParams> paramsList
+}
+
 struct TExecPlanFragmentResult {
   // required in V1
   1: optional Status.TStatus status
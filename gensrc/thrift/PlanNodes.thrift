@@ -308,12 +308,30 @@ struct TMetaScanNode {
   5: optional string user
 }
 
+// Aggregation without grouping which the storage of a DUP_KEYS table answers by itself
+enum TPushAggOp {
+  NONE = 0,
+  // only min/max, answered from segment zone maps
+  MINMAX = 1,
+  // only count, answered from segment row counts
+  COUNT = 2,
+  // both of above
+  MIX = 3
+}
+
 struct TOlapScanNode {
   1: required Types.TTupleId tuple_id
   2: required list<string> key_column_name
   3: required list<Types.TPrimitiveType> key_column_type
   4: required bool is_preaggregation
   5: optional string sort_column
+  6: optional TPushAggOp push_down_agg_type_opt
+  // Set if a TOP-N right above orders by a prefix of the key columns: each scanner
+  // reads rows in key order and stops after this many rows
+  7: optional i64 sort_limit
+  // Set if a merge join right above needs the rows ordered by the first num_ordered_keys
+  // key columns: each scanner reads rows in key order and the scan merges them
+  8: optional i32 num_ordered_keys
 }
 struct TEqJoinCondition {
   // left-hand side of "<a> = <b>"
@@ -358,6 +376,10 @@ struct THashJoinNode {
   // If true, this join node can (but may choose not to) generate slot filters
   // after constructing the build side that can be applied to the probe side.
   5: optional bool add_probe_filters
+
+  // If true, the build side is broadcast to all the instances of this join, so the
+  // instances on one backend can share one hash table
+  6: optional bool is_broadcast_join
 }
 
 struct TMergeJoinNode {
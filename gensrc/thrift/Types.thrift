@@ -253,6 +253,8 @@ struct TScalarFunction {
     1: required string symbol
     2: optional string prepare_fn_symbol
     3: optional string close_fn_symbol
+    // Symbol of the batch form of the function, see UdfBatch in udf/udf.h
+    4: optional string batch_fn_symbol
 }
 
 struct TAggregateFunction {
@@ -265,6 +267,8 @@ struct TAggregateFunction {
   8: optional string get_value_fn_symbol
   9: optional string remove_fn_symbol
   10: optional bool is_analytic_only_fn = false
+  // Symbol of the batch form of the update function, see UdaUpdateBatch in udf/udf.h
+  11: optional string update_batch_fn_symbol
 }
 
 // Represents a function in the Catalog.
@@ -582,6 +582,7 @@ build_arrow() {
     else
         cp -rf ./zstd_ep-install/lib/libzstd.a $TP_INSTALL_DIR/lib64/libzstd.a
     fi
+    cp -rf ./zstd_ep-install/include/zstd.h $TP_INSTALL_DIR/include/zstd.h
     cp -rf ./double-conversion_ep/src/double-conversion_ep/lib/libdouble-conversion.a $TP_INSTALL_DIR/lib64/libdouble-conversion.a
 }
 
@@ -698,6 +699,21 @@ build_cctz() {
     make -j$PARALLEL && make install
 }
 
+# google benchmark
+build_benchmark() {
+    check_if_source_exist $BENCHMARK_SOURCE
+    cd $TP_SOURCE_DIR/$BENCHMARK_SOURCE
+    mkdir -p $BUILD_DIR && cd $BUILD_DIR
+    rm -rf CMakeCache.txt CMakeFiles/
+    $CMAKE_CMD -DCMAKE_INSTALL_PREFIX=$TP_INSTALL_DIR \
+    -DCMAKE_INSTALL_LIBDIR=lib \
+    -DCMAKE_BUILD_TYPE=Release \
+    -DCMAKE_POSITION_INDEPENDENT_CODE=On \
+    -DBENCHMARK_ENABLE_TESTING=OFF \
+    -DBENCHMARK_ENABLE_GTEST_TESTS=OFF ../
+    make -j$PARALLEL && make install
+}
+
 # all js and csss related
 build_js_and_css() {
     check_if_source_exist $DATATABLES_SOURCE
@@ -750,6 +766,7 @@ build_bitshuffle
 build_croaringbitmap
 build_orc
 build_cctz
+build_benchmark
 build_js_and_css
 
 echo "Finihsed to build all thirdparties"